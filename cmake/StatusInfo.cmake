@@ -42,5 +42,11 @@ if(BUILD_TOOLS)
 else()
     message("Build tools           : No")
 endif()
+
+if(BUILD_BENCHMARKS)
+    message("Build benchmarks      : Yes")
+else()
+    message("Build benchmarks      : No (default)")
+endif()
 message("")
 message("===================================================")
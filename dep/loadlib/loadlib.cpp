@@ -2,6 +2,9 @@
 
 #include "loadlib.h"
 #include <cstdio>
+#include <algorithm>
+#include <cctype>
+#include <mutex>
 
 u_map_fcc MverMagic = { {'R','E','V','M'} };
 
@@ -169,6 +172,19 @@ FileChunk* FileChunk::GetSubChunk(std::string const& name)
 // list of mpq files for lookup most recent file version
 ArchiveSet gOpenArchives;
 
+// archive holding the newest version of each file asked for, NULL if none has it,
+// so the patch chain is searched once per file and not on every open
+static std::map<std::string, HANDLE> gNewestFileArchive;
+static std::mutex gNewestFileArchiveLock;
+
+static std::string GetArchiveIndexKey(char const* filename)
+{
+    std::string key = filename;
+    std::replace(key.begin(), key.end(), '/', '\\');
+    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    return key;
+}
+
 ArchiveSetBounds GetArchivesBounds()
 {
     return ArchiveSetBounds(gOpenArchives.begin(), gOpenArchives.end());
@@ -183,6 +199,11 @@ bool OpenArchive(char const* mpqFileName, HANDLE* mpqHandlePtr /*= NULL*/)
 
     gOpenArchives.push_back(mpqHandle);
 
+    {
+        std::lock_guard<std::mutex> guard(gNewestFileArchiveLock);
+        gNewestFileArchive.clear();
+    }
+
     if (mpqHandlePtr)
         *mpqHandlePtr = mpqHandle;
 
@@ -191,14 +212,32 @@ bool OpenArchive(char const* mpqFileName, HANDLE* mpqHandlePtr /*= NULL*/)
 
 bool OpenNewestFile(char const* filename, HANDLE* fileHandlerPtr)
 {
+    std::string key = GetArchiveIndexKey(filename);
+
+    std::lock_guard<std::mutex> guard(gNewestFileArchiveLock);
+    std::map<std::string, HANDLE>::const_iterator known = gNewestFileArchive.find(key);
+    if (known != gNewestFileArchive.end())
+    {
+        if (!known->second)
+            return false;
+
+        if (SFileOpenFileEx(known->second, filename, SFILE_OPEN_FROM_MPQ, fileHandlerPtr))
+            return true;
+    }
+
+    HANDLE newest = NULL;
     for (ArchiveSet::const_reverse_iterator i = gOpenArchives.rbegin(); i != gOpenArchives.rend(); ++i)
     {
         // always prefer get updated file version
         if (SFileOpenFileEx(*i, filename, SFILE_OPEN_FROM_MPQ, fileHandlerPtr))
-            return true;
+        {
+            newest = *i;
+            break;
+        }
     }
 
-    return false;
+    gNewestFileArchive[key] = newest;
+    return newest != NULL;
 }
 
 bool ExtractFile(char const* mpq_name, std::string const& filename)
@@ -236,6 +275,9 @@ void CloseArchives()
     for (ArchiveSet::const_iterator i = gOpenArchives.begin(); i != gOpenArchives.end(); ++i)
         SFileCloseArchive(*i);
     gOpenArchives.clear();
+
+    std::lock_guard<std::mutex> guard(gNewestFileArchiveLock);
+    gNewestFileArchive.clear();
 }
 
 FileLoader::FileLoader()
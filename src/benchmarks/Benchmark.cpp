@@ -0,0 +1,141 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "Benchmark.h"
+
+#include <algorithm>
+
+namespace
+{
+    struct RegisteredBenchmark
+    {
+        char const* name;
+        BenchmarkFunction function;
+    };
+
+    // filled by the static registrars, before main runs
+    std::vector<RegisteredBenchmark>& GetRegistry()
+    {
+        static std::vector<RegisteredBenchmark> registry;
+        return registry;
+    }
+
+    bool CompareByName(RegisteredBenchmark const& a, RegisteredBenchmark const& b)
+    {
+        return strcmp(a.name, b.name) < 0;
+    }
+}
+
+BenchmarkRegistrar::BenchmarkRegistrar(char const* name, BenchmarkFunction function)
+{
+    RegisteredBenchmark benchmark;
+    benchmark.name = name;
+    benchmark.function = function;
+    GetRegistry().push_back(benchmark);
+}
+
+BenchmarkState::BenchmarkState(BenchmarkSettings const& settings)
+    : m_settings(settings), m_started(false), m_iterations(0), m_nextCheck(0), m_elapsedNs(0.0), m_bytesPerIteration(0)
+{
+}
+
+bool BenchmarkState::CheckTime()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    // the first call ends the setup of the benchmark
+    if (!m_started)
+    {
+        m_started = true;
+        m_start = now;
+        m_nextCheck = m_iterations = 1;
+        return true;
+    }
+
+    double minTimeNs = double(m_settings.minTime) * 1000000.0;
+    m_elapsedNs = double(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start).count());
+    if (m_elapsedNs >= minTimeNs)
+    {
+        return false;
+    }
+
+    // the clock is read less often the faster the loop turns out to be, without overshooting the time much
+    double remaining = (minTimeNs - m_elapsedNs) * double(m_iterations) / std::max(m_elapsedNs, 1.0);
+    m_nextCheck = m_iterations + std::max<uint64>(1, std::min<uint64>(m_iterations, uint64(remaining) + 1));
+    ++m_iterations;
+    return true;
+}
+
+void RunBenchmarks(BenchmarkSettings const& settings, std::vector<BenchmarkResult>& results)
+{
+    std::vector<RegisteredBenchmark> benchmarks = GetRegistry();
+    std::sort(benchmarks.begin(), benchmarks.end(), CompareByName);
+
+    for (std::vector<RegisteredBenchmark>::const_iterator itr = benchmarks.begin(); itr != benchmarks.end(); ++itr)
+    {
+        if (!settings.filter.empty() && std::string(itr->name).find(settings.filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        BenchmarkResult result;
+        result.name = itr->name;
+        result.iterations = 0;
+        result.nsPerIteration = 0.0;
+        result.minNsPerIteration = 0.0;
+        result.bytesPerIteration = 0;
+
+        std::vector<double> times;
+        for (uint32 i = 0; i < settings.repetitions; ++i)
+        {
+            BenchmarkState state(settings);
+            itr->function(state);
+
+            if (!state.GetSkipReason().empty())
+            {
+                result.skipReason = state.GetSkipReason();
+                break;
+            }
+
+            if (!state.GetIterations())
+            {
+                continue;
+            }
+
+            times.push_back(state.GetElapsedNs() / double(state.GetIterations()));
+            result.iterations += state.GetIterations();
+            result.bytesPerIteration = state.GetBytesPerIteration();
+        }
+
+        if (!times.empty())
+        {
+            std::sort(times.begin(), times.end());
+            result.nsPerIteration = times[times.size() / 2];
+            result.minNsPerIteration = times.front();
+        }
+
+        results.push_back(result);
+    }
+}
@@ -0,0 +1,147 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_H_BENCHMARK
+#define MANGOS_H_BENCHMARK
+
+#include "Common.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/// Settings shared by all benchmarks of a run
+struct BenchmarkSettings
+{
+    BenchmarkSettings() : minTime(500), repetitions(3), mapId(0), posX(-9449.0f), posY(64.0f) {}
+
+    uint32 minTime;                                         // ms each repetition runs at least
+    uint32 repetitions;
+    std::string filter;                                     // only benchmarks with this in their name
+    std::string dataDir;                                    // holds vmaps/ and mmaps/, empty skips the recorded data
+    uint32 mapId;                                           // the recorded data around this position is used
+    float posX;
+    float posY;
+};
+
+/// One benchmark run, the benchmark does its setup and then loops `while (state.KeepRunning())`
+class BenchmarkState
+{
+    public:
+        explicit BenchmarkState(BenchmarkSettings const& settings);
+
+        bool KeepRunning()
+        {
+            if (m_iterations < m_nextCheck)
+            {
+                ++m_iterations;
+                return true;
+            }
+
+            return CheckTime();
+        }
+
+        /// processed bytes per iteration, reported as throughput
+        void SetBytesPerIteration(uint64 bytes) { m_bytesPerIteration = bytes; }
+        /// the benchmark cannot run, for example without the recorded data
+        void Skip(std::string const& reason) { m_skipReason = reason; }
+
+        BenchmarkSettings const& GetSettings() const { return m_settings; }
+        uint64 GetIterations() const { return m_iterations; }
+        double GetElapsedNs() const { return m_elapsedNs; }
+        uint64 GetBytesPerIteration() const { return m_bytesPerIteration; }
+        std::string const& GetSkipReason() const { return m_skipReason; }
+
+    private:
+        bool CheckTime();
+
+        BenchmarkSettings const& m_settings;
+        std::chrono::steady_clock::time_point m_start;
+        bool m_started;
+        uint64 m_iterations;
+        uint64 m_nextCheck;
+        double m_elapsedNs;
+        uint64 m_bytesPerIteration;
+        std::string m_skipReason;
+};
+
+typedef void (*BenchmarkFunction)(BenchmarkState& state);
+
+/// Keeps the compiler from dropping a computation whose result is otherwise unused
+template<class T>
+inline void DoNotOptimize(T const& value)
+{
+#if defined(_MSC_VER)
+    static volatile char const* sink;
+    sink = reinterpret_cast<char const*>(&value);
+#else
+    asm volatile("" : : "r"(&value) : "memory");
+#endif
+}
+
+/// Deterministic numbers, so every build is measured on the same data
+class BenchmarkRandom
+{
+    public:
+        explicit BenchmarkRandom(uint32 seed) : m_state(seed) {}
+
+        uint32 Next()
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return m_state >> 8;
+        }
+
+        float Range(float min, float max) { return min + (max - min) * float(Next() & 0xFFFF) / float(0xFFFF); }
+
+    private:
+        uint32 m_state;
+};
+
+/// Adds a benchmark to the list of the run, used through BENCHMARK
+struct BenchmarkRegistrar
+{
+    BenchmarkRegistrar(char const* name, BenchmarkFunction function);
+};
+
+#define BENCHMARK(name)                                                         \
+    static void Benchmark_##name(BenchmarkState& state);                        \
+    static BenchmarkRegistrar BenchmarkRegistrar_##name(#name, Benchmark_##name); \
+    static void Benchmark_##name(BenchmarkState& state)
+
+/// Result of one benchmark, the median repetition
+struct BenchmarkResult
+{
+    std::string name;
+    uint64 iterations;
+    double nsPerIteration;
+    double minNsPerIteration;
+    uint64 bytesPerIteration;
+    std::string skipReason;
+};
+
+/// Runs the registered benchmarks matching the filter
+void RunBenchmarks(BenchmarkSettings const& settings, std::vector<BenchmarkResult>& results);
+
+#endif
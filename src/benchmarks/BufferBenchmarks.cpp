@@ -0,0 +1,178 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "Benchmark.h"
+#include "ByteBuffer.h"
+#include "WorldPacket.h"
+#include "UpdateData.h"
+#include "ObjectGuid.h"
+#include "Opcodes.h"
+#include "World.h"
+
+namespace
+{
+    const uint32 FIELDS_PER_RECORD = 64;
+
+    void WriteRecord(ByteBuffer& buffer, uint32 seed)
+    {
+        for (uint32 i = 0; i < FIELDS_PER_RECORD; i += 4)
+        {
+            buffer << uint32(seed + i);
+            buffer << float(seed) * 0.5f;
+            buffer << (uint64(seed) << 32 | i);
+            buffer << uint8(i);
+        }
+        buffer << "synthetic record";
+    }
+
+    // a values update of a creature: packed guid, the update mask and the changed fields
+    void WriteValuesUpdate(UpdateData& data, uint32 counter)
+    {
+        ByteBuffer& buffer = data.GetBuffer();
+        ObjectGuid guid(HIGHGUID_UNIT, uint32(3000 + counter % 50), counter);
+
+        buffer << uint8(UPDATETYPE_VALUES);
+        buffer << guid.WriteAsPacked();
+
+        const uint8 maskBlocks = 6;
+        buffer << maskBlocks;
+        for (uint8 i = 0; i < maskBlocks; ++i)
+        {
+            buffer << uint32(i == 1 ? 0x00F0000F : (i == 4 ? 0x00000300 : 0));
+        }
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            buffer << uint32(1000 + counter * 7 + i);
+        }
+
+        data.AddUpdateBlock();
+    }
+}
+
+BENCHMARK(ByteBuffer_WriteRecord)
+{
+    ByteBuffer buffer(1024);
+    uint32 seed = 0;
+    while (state.KeepRunning())
+    {
+        buffer.clear();
+        WriteRecord(buffer, ++seed);
+        DoNotOptimize(buffer.contents());
+    }
+    state.SetBytesPerIteration(buffer.wpos());
+}
+
+BENCHMARK(ByteBuffer_ReadRecord)
+{
+    ByteBuffer buffer(1024);
+    WriteRecord(buffer, 1);
+
+    while (state.KeepRunning())
+    {
+        buffer.rpos(0);
+        uint64 sum = 0;
+        for (uint32 i = 0; i < FIELDS_PER_RECORD; i += 4)
+        {
+            sum += buffer.read<uint32>();
+            sum += uint64(buffer.read<float>());
+            sum += buffer.read<uint64>();
+            sum += buffer.read<uint8>();
+        }
+        std::string text;
+        buffer >> text;
+        sum += text.size();
+        DoNotOptimize(sum);
+    }
+    state.SetBytesPerIteration(buffer.wpos());
+}
+
+// the spline packet of a creature walking a path of 10 points
+BENCHMARK(WorldPacket_MonsterMove)
+{
+    ObjectGuid guid(HIGHGUID_UNIT, uint32(3000), uint32(12345));
+    WorldPacket data;
+    uint32 counter = 0;
+
+    while (state.KeepRunning())
+    {
+        data.Initialize(SMSG_MONSTER_MOVE, 8 + 4 * 3 + 4 + 1 + 4 + 4 + 4 + 10 * 4 * 3);
+        data << guid.WriteAsPacked();
+        data << float(-9449.0f) << float(64.0f) << float(56.0f);
+        data << uint32(++counter);
+        data << uint8(0);
+        data << uint32(0x100);
+        data << uint32(2500);
+        data << uint32(10);
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            data << float(-9449.0f + i) << float(64.0f + i) << float(56.0f);
+        }
+        DoNotOptimize(data.contents());
+    }
+    state.SetBytesPerIteration(data.wpos());
+}
+
+// one small update, sent without compression
+BENCHMARK(UpdateData_BuildSingle)
+{
+    sWorld.setConfig(CONFIG_UINT32_COMPRESSION, 1);
+    UpdateData data;
+    WorldPacket packet;
+    uint32 counter = 0;
+
+    while (state.KeepRunning())
+    {
+        data.Clear();
+        WriteValuesUpdate(data, ++counter);
+        packet.clear();
+        data.BuildPacket(&packet);
+        DoNotOptimize(packet.contents());
+    }
+    state.SetBytesPerIteration(packet.wpos());
+}
+
+// the updates a player gets per tick in a crowded place, built and compressed
+BENCHMARK(UpdateData_BuildCompressed)
+{
+    sWorld.setConfig(CONFIG_UINT32_COMPRESSION, 1);
+    UpdateData data;
+    WorldPacket packet;
+    uint32 counter = 0;
+    uint64 bytes = 0;
+
+    while (state.KeepRunning())
+    {
+        data.Clear();
+        for (uint32 i = 0; i < 50; ++i)
+        {
+            WriteValuesUpdate(data, ++counter);
+        }
+        bytes = data.GetBuffer().wpos();
+        packet.clear();
+        data.BuildPacket(&packet);
+        DoNotOptimize(packet.contents());
+    }
+    state.SetBytesPerIteration(bytes);
+}
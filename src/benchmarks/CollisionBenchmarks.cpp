@@ -0,0 +1,176 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "Benchmark.h"
+#include "BIH.h"
+#include "VMapFactory.h"
+#include "IVMapManager.h"
+#include "GridDefines.h"
+
+namespace
+{
+    struct BoxBounds
+    {
+        static void getBounds(G3D::AABox const& box, G3D::AABox& out) { out = box; }
+    };
+
+    // slab test against the boxes the tree hands out, like the model tests of the map trees
+    struct BoxRayCallback
+    {
+        explicit BoxRayCallback(std::vector<G3D::AABox> const& boxes) : m_boxes(boxes), hit(false) {}
+
+        bool operator()(G3D::Ray const& ray, uint32 index, float& maxDist, bool /*stopAtFirst*/)
+        {
+            G3D::AABox const& box = m_boxes[index];
+            float tMin = 0.0f;
+            float tMax = maxDist;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                float inv = ray.invDirection()[axis];
+                float t0 = (box.low()[axis] - ray.origin()[axis]) * inv;
+                float t1 = (box.high()[axis] - ray.origin()[axis]) * inv;
+                if (t0 > t1)
+                {
+                    std::swap(t0, t1);
+                }
+                tMin = std::max(tMin, t0);
+                tMax = std::min(tMax, t1);
+                if (tMin > tMax)
+                {
+                    return false;
+                }
+            }
+
+            maxDist = tMin;
+            hit = true;
+            return true;
+        }
+
+        std::vector<G3D::AABox> const& m_boxes;
+        bool hit;
+    };
+
+    // 2D grid of a recorded map position, as TerrainInfo::GetGrid computes it
+    void GetGrid(BenchmarkSettings const& settings, int& gx, int& gy)
+    {
+        gx = int(32 - settings.posX / SIZE_OF_GRIDS);
+        gy = int(32 - settings.posY / SIZE_OF_GRIDS);
+    }
+}
+
+// LoS rays through a tree of 20000 boxes spread like the models of a busy map tile
+BENCHMARK(BIH_LineOfSight)
+{
+    BenchmarkRandom random(3);
+    std::vector<G3D::AABox> boxes;
+    for (uint32 i = 0; i < 20000; ++i)
+    {
+        G3D::Vector3 low(random.Range(0.0f, 533.0f), random.Range(0.0f, 533.0f), random.Range(0.0f, 40.0f));
+        G3D::Vector3 size(random.Range(0.5f, 8.0f), random.Range(0.5f, 8.0f), random.Range(0.5f, 12.0f));
+        boxes.push_back(G3D::AABox(low, low + size));
+    }
+
+    BIH tree;
+    tree.build(boxes, BoxBounds::getBounds);
+
+    std::vector<G3D::Ray> rays;
+    std::vector<float> distances;
+    for (uint32 i = 0; i < 1024; ++i)
+    {
+        G3D::Vector3 from(random.Range(0.0f, 533.0f), random.Range(0.0f, 533.0f), random.Range(0.0f, 40.0f));
+        G3D::Vector3 to = from + G3D::Vector3(random.Range(-60.0f, 60.0f), random.Range(-60.0f, 60.0f), random.Range(-10.0f, 10.0f));
+        float distance = (to - from).magnitude();
+        rays.push_back(G3D::Ray::fromOriginAndDirection(from, (to - from) / distance));
+        distances.push_back(distance);
+    }
+
+    uint32 index = 0;
+    uint32 hits = 0;
+    while (state.KeepRunning())
+    {
+        BoxRayCallback callback(boxes);
+        float distance = distances[index];
+        tree.intersectRay(rays[index], callback, distance, true);
+        hits += callback.hit ? 1 : 0;
+        index = (index + 1) & 1023;
+    }
+    DoNotOptimize(hits);
+}
+
+// LoS between points around the recorded position, through the vmaps of its grid
+BENCHMARK(VMap_LineOfSight)
+{
+    BenchmarkSettings const& settings = state.GetSettings();
+    if (settings.dataDir.empty())
+    {
+        state.Skip("no data folder");
+        return;
+    }
+
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    vmgr->setEnableLineOfSightCalc(true);
+    vmgr->setEnableHeightCalc(true);
+
+    int gx, gy;
+    GetGrid(settings, gx, gy);
+    if (vmgr->loadMap((settings.dataDir + "vmaps").c_str(), settings.mapId, gx, gy) != VMAP::VMAP_LOAD_RESULT_OK)
+    {
+        state.Skip("no vmap for the position");
+        return;
+    }
+
+    // segments between standing positions, the heights come from the vmap itself
+    BenchmarkRandom random(4);
+    std::vector<G3D::Vector3> points;
+    for (uint32 tries = 0; tries < 4096 && points.size() < 512; ++tries)
+    {
+        float x = settings.posX + random.Range(-80.0f, 80.0f);
+        float y = settings.posY + random.Range(-80.0f, 80.0f);
+        float z = vmgr->getHeight(settings.mapId, x, y, 500.0f, 1000.0f);
+        if (z > VMAP_INVALID_HEIGHT)
+        {
+            points.push_back(G3D::Vector3(x, y, z + 2.0f));
+        }
+    }
+
+    if (points.size() < 2)
+    {
+        state.Skip("no vmap height around the position");
+        return;
+    }
+
+    uint32 index = 0;
+    uint32 visible = 0;
+    while (state.KeepRunning())
+    {
+        G3D::Vector3 const& from = points[index % points.size()];
+        G3D::Vector3 const& to = points[(index * 7 + 1) % points.size()];
+        visible += vmgr->isInLineOfSight(settings.mapId, from.x, from.y, from.z, to.x, to.y, to.z) ? 1 : 0;
+        ++index;
+    }
+    DoNotOptimize(visible);
+
+    vmgr->unloadMap(settings.mapId, gx, gy);
+}
@@ -0,0 +1,105 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "Benchmark.h"
+#include "EventProcessor.h"
+
+namespace
+{
+    // fires every period until the processor is destroyed, like the periodic events of units
+    class PeriodicEvent : public BasicEvent
+    {
+        public:
+            PeriodicEvent(EventProcessor& processor, uint32 period, uint64& counter)
+                : m_processor(processor), m_period(period), m_counter(counter) {}
+
+            bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+            {
+                ++m_counter;
+                m_processor.AddEvent(this, m_processor.CalculateTime(m_period));
+                return false;
+            }
+
+        private:
+            EventProcessor& m_processor;
+            uint32 m_period;
+            uint64& m_counter;
+    };
+
+    class OneShotEvent : public BasicEvent
+    {
+        public:
+            explicit OneShotEvent(uint64& counter) : m_counter(counter) {}
+
+            bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+            {
+                ++m_counter;
+                return true;
+            }
+
+        private:
+            uint64& m_counter;
+    };
+}
+
+// a processor with 1000 periodic events advanced by one map tick
+BENCHMARK(EventProcessor_UpdatePeriodic)
+{
+    BenchmarkRandom random(1);
+    uint64 executed = 0;
+    EventProcessor processor;
+    for (uint32 i = 0; i < 1000; ++i)
+    {
+        uint32 period = 100 + random.Next() % 5000;
+        processor.AddEvent(new PeriodicEvent(processor, period, executed), processor.CalculateTime(random.Next() % period));
+    }
+
+    while (state.KeepRunning())
+    {
+        processor.Update(50);
+    }
+    DoNotOptimize(executed);
+}
+
+// spell and aura style events added, executed within the next ticks and deleted
+BENCHMARK(EventProcessor_AddExecute)
+{
+    BenchmarkRandom random(2);
+    uint64 executed = 0;
+    EventProcessor processor;
+
+    while (state.KeepRunning())
+    {
+        for (uint32 i = 0; i < 100; ++i)
+        {
+            processor.AddEvent(new OneShotEvent(executed), processor.CalculateTime(random.Next() % 200));
+        }
+        for (uint32 i = 0; i < 5; ++i)
+        {
+            processor.Update(50);
+        }
+    }
+    DoNotOptimize(executed);
+}
@@ -0,0 +1,193 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "Benchmark.h"
+#include "MoveMapSharedDefines.h"
+#include "GridDefines.h"
+#include "PathFinder.h"
+
+#include "DetourNavMesh.h"
+#include "DetourNavMeshQuery.h"
+#include "DetourAlloc.h"
+
+#include <cstdio>
+
+namespace
+{
+    /// The navmesh of one grid read like MMapManager reads it, freed with the mesh
+    dtNavMesh* LoadGridMesh(BenchmarkSettings const& settings, std::string& error)
+    {
+        int gx = int(32 - settings.posX / SIZE_OF_GRIDS);
+        int gy = int(32 - settings.posY / SIZE_OF_GRIDS);
+
+        char fileName[1024];
+        snprintf(fileName, sizeof(fileName), "%smmaps/%03u.mmap", settings.dataDir.c_str(), settings.mapId);
+        FILE* file = fopen(fileName, "rb");
+        if (!file)
+        {
+            error = std::string("cannot open ") + fileName;
+            return NULL;
+        }
+
+        dtNavMeshParams params;
+        bool read = fread(&params, sizeof(dtNavMeshParams), 1, file) == 1;
+        fclose(file);
+
+        dtNavMesh* mesh = dtAllocNavMesh();
+        if (!read || dtStatusFailed(mesh->init(&params)))
+        {
+            error = std::string("bad navmesh parameters in ") + fileName;
+            dtFreeNavMesh(mesh);
+            return NULL;
+        }
+
+        snprintf(fileName, sizeof(fileName), "%smmaps/%03u%02i%02i.mmtile", settings.dataDir.c_str(), settings.mapId, gx, gy);
+        file = fopen(fileName, "rb");
+        if (!file)
+        {
+            error = std::string("cannot open ") + fileName;
+            dtFreeNavMesh(mesh);
+            return NULL;
+        }
+
+        MmapTileHeader header;
+        unsigned char* data = NULL;
+        if (fread(&header, sizeof(MmapTileHeader), 1, file) == 1 && header.mmapMagic == MMAP_MAGIC && header.mmapVersion == MMAP_VERSION)
+        {
+            data = (unsigned char*)dtAlloc(header.size, DT_ALLOC_PERM);
+            if (fread(data, header.size, 1, file) != 1)
+            {
+                dtFree(data);
+                data = NULL;
+            }
+        }
+        fclose(file);
+
+        if (!data || dtStatusFailed(mesh->addTile(data, header.size, DT_TILE_FREE_DATA, 0, NULL)))
+        {
+            error = std::string("bad tile ") + fileName;
+            if (data)
+            {
+                dtFree(data);
+            }
+            dtFreeNavMesh(mesh);
+            return NULL;
+        }
+
+        return mesh;
+    }
+
+    BenchmarkRandom* s_navRandom = NULL;
+
+    float NavRandom()
+    {
+        return float(s_navRandom->Next() & 0xFFFF) / float(0x10000);
+    }
+}
+
+// the detour queries of PathFinder::calculate between random points of the recorded grid
+BENCHMARK(NavMesh_FindPath)
+{
+    BenchmarkSettings const& settings = state.GetSettings();
+    if (settings.dataDir.empty())
+    {
+        state.Skip("no data folder");
+        return;
+    }
+
+    std::string error;
+    dtNavMesh* mesh = LoadGridMesh(settings, error);
+    if (!mesh)
+    {
+        state.Skip(error);
+        return;
+    }
+
+    dtNavMeshQuery* query = dtAllocNavMeshQuery();
+    query->init(mesh, 1024);
+
+    dtQueryFilter filter;
+    filter.setIncludeFlags(NAV_GROUND | NAV_WATER);
+    filter.setExcludeFlags(0);
+
+    BenchmarkRandom random(5);
+    s_navRandom = &random;
+
+    std::vector<float> points;
+    for (uint32 i = 0; i < 512; ++i)
+    {
+        dtPolyRef ref;
+        float point[VERTEX_SIZE];
+        if (dtStatusSucceed(query->findRandomPoint(&filter, NavRandom, &ref, point)))
+        {
+            points.insert(points.end(), point, point + VERTEX_SIZE);
+        }
+    }
+    s_navRandom = NULL;
+
+    size_t pointCount = points.size() / VERTEX_SIZE;
+    if (pointCount < 2)
+    {
+        state.Skip("no walkable polygons in the grid");
+        dtFreeNavMeshQuery(query);
+        dtFreeNavMesh(mesh);
+        return;
+    }
+
+    float extents[VERTEX_SIZE] = {3.0f, 5.0f, 3.0f};
+    dtPolyRef polys[MAX_PATH_LENGTH];
+    float pathPoints[MAX_POINT_PATH_LENGTH * VERTEX_SIZE];
+    uint32 index = 0;
+    uint64 found = 0;
+
+    while (state.KeepRunning())
+    {
+        float const* start = &points[(index % pointCount) * VERTEX_SIZE];
+        float const* end = &points[((index * 13 + 1) % pointCount) * VERTEX_SIZE];
+        ++index;
+
+        dtPolyRef startRef, endRef;
+        float startPoint[VERTEX_SIZE], endPoint[VERTEX_SIZE];
+        if (dtStatusFailed(query->findNearestPoly(start, extents, &filter, &startRef, startPoint)) ||
+            dtStatusFailed(query->findNearestPoly(end, extents, &filter, &endRef, endPoint)))
+        {
+            continue;
+        }
+
+        int polyLength = 0;
+        query->findPath(startRef, endRef, startPoint, endPoint, &filter, polys, &polyLength, MAX_PATH_LENGTH);
+
+        int pointLength = 0;
+        if (polyLength)
+        {
+            query->findStraightPath(startPoint, endPoint, polys, polyLength, pathPoints, NULL, NULL, &pointLength, MAX_POINT_PATH_LENGTH);
+        }
+        found += pointLength;
+    }
+    DoNotOptimize(found);
+
+    dtFreeNavMeshQuery(query);
+    dtFreeNavMesh(mesh);
+}
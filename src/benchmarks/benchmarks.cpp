@@ -0,0 +1,210 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "Benchmark.h"
+#include "GitRevision.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+void printUsage(char* prg)
+{
+    printf(" Usage: %s [OPTION]\n\n", prg);
+    printf(" Time the hot paths of the core on synthetic and recorded data.\n");
+    printf("   -h, --help                        show the usage\n");
+    printf("   -f, --filter <text>               only run benchmarks with text in their name\n");
+    printf("   -t, --time <ms>                   minimum time of a repetition (default 500)\n");
+    printf("   -r, --repetitions <n>             repetitions, the median is reported (default 3)\n");
+    printf("   -d, --data <dir>                  data folder with vmaps/ and mmaps/ for the recorded data\n");
+    printf("   -p, --position <map> <x> <y>      recorded data around this position (default 0 -9449 64)\n");
+    printf("   -o, --output <file>               write the results as JSON\n");
+    printf("   -c, --compare <file>              compare with the JSON results of another build\n");
+    printf("\n");
+    printf(" Example:\n");
+    printf("   %s -d /opt/mangos/data -o after.json -c before.json\n", prg);
+}
+
+bool handleArgs(int argc, char** argv, BenchmarkSettings& settings, char const*& outputFile, char const*& compareFile)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--filter") == 0) && i + 1 < argc)
+        {
+            settings.filter = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--time") == 0) && i + 1 < argc)
+        {
+            settings.minTime = uint32(std::max(atoi(argv[++i]), 1));
+        }
+        else if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--repetitions") == 0) && i + 1 < argc)
+        {
+            settings.repetitions = uint32(std::max(atoi(argv[++i]), 1));
+        }
+        else if ((strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--data") == 0) && i + 1 < argc)
+        {
+            settings.dataDir = argv[++i];
+            if (!settings.dataDir.empty() && settings.dataDir[settings.dataDir.size() - 1] != '/' && settings.dataDir[settings.dataDir.size() - 1] != '\\')
+            {
+                settings.dataDir += '/';
+            }
+        }
+        else if ((strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--position") == 0) && i + 3 < argc)
+        {
+            settings.mapId = uint32(atoi(argv[++i]));
+            settings.posX = float(atof(argv[++i]));
+            settings.posY = float(atof(argv[++i]));
+        }
+        else if ((strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) && i + 1 < argc)
+        {
+            outputFile = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--compare") == 0) && i + 1 < argc)
+        {
+            compareFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+        {
+            printUsage(argv[0]);
+            exit(1);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// one benchmark per line, as written by writeResults
+static void readBaseline(char const* fileName, std::map<std::string, double>& baseline)
+{
+    FILE* file = fopen(fileName, "r");
+    if (!file)
+    {
+        printf(" Cannot open %s for the comparison\n", fileName);
+        return;
+    }
+
+    char line[512];
+    while (fgets(line, sizeof(line), file))
+    {
+        char name[256];
+        double ns;
+        char const* start = strstr(line, "{\"name\": \"");
+        char const* time = strstr(line, "\"ns_per_op\": ");
+        if (start && time && sscanf(start, "{\"name\": \"%255[^\"]\"", name) == 1 && sscanf(time, "\"ns_per_op\": %lf", &ns) == 1)
+        {
+            baseline[name] = ns;
+        }
+    }
+
+    fclose(file);
+}
+
+static bool writeResults(char const* fileName, BenchmarkSettings const& settings, std::vector<BenchmarkResult> const& results)
+{
+    FILE* file = fopen(fileName, "w");
+    if (!file)
+    {
+        return false;
+    }
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"revision\": \"%s\",\n", GitRevision::GetHash());
+    fprintf(file, "  \"date\": \"%s\",\n", GitRevision::GetDate());
+    fprintf(file, "  \"min_time_ms\": %u,\n", settings.minTime);
+    fprintf(file, "  \"repetitions\": %u,\n", settings.repetitions);
+    fprintf(file, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        BenchmarkResult const& result = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"iterations\": " UI64FMTD ", \"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, \"bytes_per_op\": " UI64FMTD ", \"skipped\": \"%s\"}%s\n",
+                result.name.c_str(), result.iterations, result.nsPerIteration, result.minNsPerIteration, result.bytesPerIteration,
+                result.skipReason.c_str(), i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkSettings settings;
+    char const* outputFile = NULL;
+    char const* compareFile = NULL;
+
+    if (!handleArgs(argc, argv, settings, outputFile, compareFile))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::map<std::string, double> baseline;
+    if (compareFile)
+    {
+        readBaseline(compareFile, baseline);
+    }
+
+    std::vector<BenchmarkResult> results;
+    RunBenchmarks(settings, results);
+
+    printf(" %-36s %14s %14s %12s %9s\n", "benchmark", "ns/op", "min ns/op", "MB/s", "change");
+    for (std::vector<BenchmarkResult>::const_iterator itr = results.begin(); itr != results.end(); ++itr)
+    {
+        if (!itr->skipReason.empty())
+        {
+            printf(" %-36s skipped: %s\n", itr->name.c_str(), itr->skipReason.c_str());
+            continue;
+        }
+
+        char throughput[32] = "-";
+        if (itr->bytesPerIteration && itr->nsPerIteration > 0.0)
+        {
+            snprintf(throughput, sizeof(throughput), "%.1f", double(itr->bytesPerIteration) * 1000.0 / itr->nsPerIteration);
+        }
+
+        char change[32] = "-";
+        std::map<std::string, double>::const_iterator old = baseline.find(itr->name);
+        if (old != baseline.end() && old->second > 0.0)
+        {
+            snprintf(change, sizeof(change), "%+.1f%%", (itr->nsPerIteration - old->second) * 100.0 / old->second);
+        }
+
+        printf(" %-36s %14.1f %14.1f %12s %9s\n", itr->name.c_str(), itr->nsPerIteration, itr->minNsPerIteration, throughput, change);
+    }
+
+    if (outputFile && !writeResults(outputFile, settings, results))
+    {
+        printf(" Cannot write the results to %s\n", outputFile);
+        return 1;
+    }
+
+    return 0;
+}
@@ -531,6 +531,7 @@ void AuctionBotConfig::GetConfigFromFile()
 
     setConfig(CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_BOOST      , "AuctionHouseBot.ItemsPerCycle.Boost"         , 75);
     setConfig(CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_NORMAL     , "AuctionHouseBot.ItemsPerCycle.Normal"        , 20);
+    setConfig(CONFIG_UINT32_AHBOT_UPDATE_TIME_BUDGET         , "AuctionHouseBot.UpdateTimeBudget"            , 10);
 
     setConfig(CONFIG_UINT32_AHBOT_ITEM_MIN_ITEM_LEVEL        , "AuctionHouseBot.Items.ItemLevel.Min"         , 0);
     setConfig(CONFIG_UINT32_AHBOT_ITEM_MAX_ITEM_LEVEL        , "AuctionHouseBot.Items.ItemLevel.Max"         , 0);
@@ -971,6 +972,7 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config)
     PrepareListOfEntry(config);
 
     time_t Now = time(NULL);
+    uint32 startTime = getMSTime();
     uint32 BuyCycles;
     if (config.CheckedEntry.size() > sAuctionBotConfig.GetItemPerCycleBoost())
     {
@@ -1002,7 +1004,8 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config)
             continue;
         }
 
-        if (BuyCycles == 0)
+        // entries not checked in this cycle are the first ones due in the next
+        if (BuyCycles == 0 || sAuctionBotConfig.IsUpdateTimeBudgetExceeded(startTime))
         {
             break;
         }
@@ -1919,9 +1922,15 @@ void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
 
     RandomArray randArray;
     std::vector<std::vector<uint32> > ItemsAdded(MAX_AUCTION_QUALITY, std::vector<uint32> (MAX_ITEM_CLASS));
+    uint32 startTime = getMSTime();
+
+    // items and auctions of the whole cycle are saved in one transaction
+    CharacterDatabase.BeginTransaction();
+
     // Main loop
     // getRandomArray will give what categories of items should be added (return true if there is at least 1 items missed)
-    while (getRandomArray(config, randArray, ItemsAdded) && (items > 0))
+    // items still missing when the time budget runs out are added in the next cycle
+    while (getRandomArray(config, randArray, ItemsAdded) && (items > 0) && !sAuctionBotConfig.IsUpdateTimeBudgetExceeded(startTime))
     {
         --items;
 
@@ -1951,7 +1960,7 @@ void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
         if (!item)
         {
             sLog.outError("AHBot: Item::CreateItem() returned NULL for item %u (stack: %u)", itemID, stackCount);
-            return;
+            break;
         }
 
         uint32 buyoutPrice;
@@ -1970,6 +1979,8 @@ void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
 
         auctionHouse->AddAuctionByGuid(ahEntry, item, urand(config.GetMinTime(), config.GetMaxTime()) * HOUR, bidPrice, buyoutPrice, sAuctionBotConfig.GetAHBotId());
     }
+
+    CharacterDatabase.CommitTransaction();
 }
 
 bool AuctionBotSeller::Update(AuctionHouseType houseType)
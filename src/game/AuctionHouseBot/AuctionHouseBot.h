@@ -74,6 +74,7 @@ enum AuctionBotConfigUInt32Values
     CONFIG_UINT32_AHBOT_MINTIME,
     CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_BOOST,
     CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_NORMAL,
+    CONFIG_UINT32_AHBOT_UPDATE_TIME_BUDGET,
     CONFIG_UINT32_AHBOT_ALLIANCE_ITEM_AMOUNT_RATIO,
     CONFIG_UINT32_AHBOT_HORDE_ITEM_AMOUNT_RATIO,
     CONFIG_UINT32_AHBOT_NEUTRAL_ITEM_AMOUNT_RATIO,
@@ -262,6 +263,18 @@ class AuctionBotConfig
          * @return uint32
          */
         uint32      GetItemPerCycleNormal() const { return m_ItemsPerCycleNormal; }
+        /**
+         * @brief Checks if a seller/buyer cycle started at startTime has used up its time budget,
+         * the remaining work is then left for the next cycle.
+         *
+         * @param startTime the getMSTime() at the start of the cycle
+         * @return bool true if the cycle should stop now, false otherwise
+         */
+        bool        IsUpdateTimeBudgetExceeded(uint32 startTime) const
+        {
+            uint32 budget = getConfig(CONFIG_UINT32_AHBOT_UPDATE_TIME_BUDGET);
+            return budget && GetMSTimeDiffToNow(startTime) >= budget;
+        }
         /**
          * @brief Reloads the AhBot config.
          *
@@ -220,6 +220,8 @@ BattleGround::BattleGround()
     m_InvitedAlliance   = 0;
     m_InvitedHorde      = 0;
     m_Winner            = TEAM_NONE;
+    m_pvpLogDataDirty   = true;
+    m_pvpLogDataBuildTime = 0;
     m_StartTime         = 0;
     m_Events            = 0;
     m_Name              = "";
@@ -1145,6 +1147,7 @@ void BattleGround::RemovePlayerAtLeave(ObjectGuid guid, bool Transport, bool Sen
     {
         delete itr2->second;                                // delete player's score
         m_PlayerScores.erase(itr2);
+        InvalidatePvpLogData();
     }
 
     Player* plr = sObjectMgr.GetPlayer(guid);
@@ -1263,6 +1266,7 @@ void BattleGround::Reset()
         delete itr->second;
     }
     m_PlayerScores.clear();
+    InvalidatePvpLogData();
 }
 
 /// <summary>
@@ -1298,6 +1302,7 @@ void BattleGround::AddPlayer(Player* plr)
     }
 
     // score struct must be created in inherited class
+    InvalidatePvpLogData();
 
     ObjectGuid guid = plr->GetObjectGuid();
     Team team = plr->GetBGTeam();
@@ -1473,6 +1478,8 @@ void BattleGround::UpdatePlayerScore(Player* Source, uint32 type, uint32 value)
         return;
     }
 
+    InvalidatePvpLogData();
+
     switch (type)
     {
         case SCORE_KILLING_BLOWS:                           // Killing blows
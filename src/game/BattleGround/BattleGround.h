@@ -116,6 +116,7 @@ enum BattleGroundTimeIntervals
     INVITATION_REMIND_TIME          = 60000,                // ms
     INVITE_ACCEPT_WAIT_TIME         = 80000,                // ms
     TIME_TO_AUTOREMOVE              = 120000,               // ms
+    PVP_LOG_DATA_REBUILD_INTERVAL   = 1000,                 // ms
     MAX_OFFLINE_TIME                = 300,                  // secs
     RESPAWN_ONE_DAY                 = 86400,                // secs
     RESPAWN_IMMEDIATELY             = 0,                    // secs
@@ -515,7 +516,7 @@ class BattleGround
          *
          * @param Status
          */
-        void SetStatus(BattleGroundStatus Status) { m_Status = Status; }
+        void SetStatus(BattleGroundStatus Status) { m_Status = Status; m_pvpLogDataDirty = true; }
         /**
          * @brief
          *
@@ -558,7 +559,7 @@ class BattleGround
          *
          * @param winner
          */
-        void SetWinner(Team winner)         { m_Winner = winner; }
+        void SetWinner(Team winner)         { m_Winner = winner; m_pvpLogDataDirty = true; }
 
         /**
          * @brief
@@ -682,6 +683,42 @@ class BattleGround
          */
         uint32 GetPlayerScoresSize() const { return m_PlayerScores.size(); }
 
+        /**
+         * @brief Marks the cached scoreboard as outdated, call after changing m_PlayerScores
+         *
+         */
+        void InvalidatePvpLogData() { m_pvpLogDataDirty = true; }
+        /**
+         * @brief Whether the cached MSG_PVP_LOG_DATA body can be sent as it is
+         *
+         * Changed scores are picked up at most every PVP_LOG_DATA_REBUILD_INTERVAL while the
+         * match runs, the final scoreboard is always rebuilt.
+         *
+         * @param now
+         * @return bool
+         */
+        bool IsPvpLogDataCacheValid(uint32 now) const
+        {
+            if (m_pvpLogData.empty())
+            {
+                return false;
+            }
+
+            return !m_pvpLogDataDirty || (m_Status != STATUS_WAIT_LEAVE && getMSTimeDiff(m_pvpLogDataBuildTime, now) < PVP_LOG_DATA_REBUILD_INTERVAL);
+        }
+        /**
+         * @brief
+         *
+         * @return ByteBuffer
+         */
+        ByteBuffer& GetPvpLogDataCache() { return m_pvpLogData; }
+        /**
+         * @brief
+         *
+         * @param now
+         */
+        void SetPvpLogDataBuilt(uint32 now) { m_pvpLogDataDirty = false; m_pvpLogDataBuildTime = now; }
+
         /**
          * @brief
          *
@@ -1316,6 +1353,9 @@ class BattleGround
         BattleGroundBracketId m_BracketId; /**< TODO */
         bool   m_InBGFreeSlotQueue;                         /**< used to make sure that BG is only once inserted into the BattleGroundMgr.BGFreeSlotQueue[bgTypeId] deque */
         Team   m_Winner;                                    /**< 0=alliance, 1=horde, 2=none */
+        ByteBuffer m_pvpLogData;                            /**< cached body of MSG_PVP_LOG_DATA */
+        bool   m_pvpLogDataDirty;                           /**< scores changed since m_pvpLogData was built */
+        uint32 m_pvpLogDataBuildTime;                       /**< ms time of the last build */
         int32  m_StartDelayTime; /**< TODO */
         bool   m_PrematureCountDown; /**< TODO */
         uint32 m_PrematureCountDownTimer; /**< TODO */
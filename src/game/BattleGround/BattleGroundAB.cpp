@@ -661,6 +661,8 @@ void BattleGroundAB::UpdatePlayerScore(Player* source, uint32 type, uint32 value
         return;
     }
 
+    InvalidatePvpLogData();
+
     switch (type)
     {
         case SCORE_BASES_ASSAULTED:
@@ -443,6 +443,8 @@ void BattleGroundAV::UpdatePlayerScore(Player* source, uint32 type, uint32 value
         return;
     }
 
+    InvalidatePvpLogData();
+
     switch (type)
     {
         case SCORE_GRAVEYARDS_ASSAULTED:
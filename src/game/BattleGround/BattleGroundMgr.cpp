@@ -54,6 +54,14 @@ INSTANTIATE_SINGLETON_1(BattleGroundMgr);
 
 BattleGroundQueue::BattleGroundQueue()
 {
+    for (uint8 i = 0; i < MAX_BATTLEGROUND_BRACKETS; ++i)
+    {
+        for (uint8 j = 0; j < BG_QUEUE_GROUP_TYPES_COUNT; ++j)
+        {
+            m_WaitingPlayerCount[i][j] = 0;
+        }
+    }
+
     for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
     {
         for (uint8 j = 0; j < MAX_BATTLEGROUND_BRACKETS; ++j)
@@ -82,6 +90,11 @@ BattleGroundQueue::~BattleGroundQueue()
             m_QueuedGroups[i][j].clear();
         }
     }
+    for (InvitedGroupsSet::iterator itr = m_InvitedGroups.begin(); itr != m_InvitedGroups.end(); ++itr)
+    {
+        delete(*itr);
+    }
+    m_InvitedGroups.clear();
 }
 
 /*********************************************************/
@@ -167,6 +180,7 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* grp, BattleGr
     ginfo->JoinTime                  = GameTime::GetGameTimeMS();
     ginfo->RemoveInviteTime          = 0;
     ginfo->GroupTeam                 = leader->GetTeam();
+    ginfo->BracketId                 = bracketId;
 
     ginfo->Players.clear();
 
@@ -214,7 +228,9 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* grp, BattleGr
         }
 
         // add GroupInfo to m_QueuedGroups
-        m_QueuedGroups[bracketId][index].push_back(ginfo);
+        ginfo->QueueIndex = index;
+        ginfo->QueuePosition = m_QueuedGroups[bracketId][index].insert(m_QueuedGroups[bracketId][index].end(), ginfo);
+        m_WaitingPlayerCount[bracketId][index] += ginfo->Players.size();
 
         // announce to world, this code needs mutex
         if (!isPremade && sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN))
@@ -223,20 +239,9 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* grp, BattleGr
             {
                 char const* bgName = bg->GetName();
                 uint32 MinPlayers = bg->GetMinPlayersPerTeam();
-                uint32 qHorde = 0;
-                uint32 qAlliance = 0;
+                uint32 qHorde = m_WaitingPlayerCount[bracketId][BG_QUEUE_NORMAL_HORDE];
+                uint32 qAlliance = m_WaitingPlayerCount[bracketId][BG_QUEUE_NORMAL_ALLIANCE];
                 uint32 q_min_level = leader->GetMinLevelForBattleGroundBracketId(bracketId, BgTypeId);
-                GroupsQueueType::const_iterator itr;
-                for (itr = m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].begin(); itr != m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].end(); ++itr)
-                    if (!(*itr)->IsInvitedToBGInstanceGUID)
-                    {
-                        qAlliance += (*itr)->Players.size();
-                    }
-                for (itr = m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].begin(); itr != m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].end(); ++itr)
-                    if (!(*itr)->IsInvitedToBGInstanceGUID)
-                    {
-                        qHorde += (*itr)->Players.size();
-                    }
 
                 // Show queue status to player only (when joining queue)
                 if (sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN) == 1)
@@ -306,7 +311,6 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // Player *plr = sObjectMgr.GetPlayer(guid);
     // ACE_Guard<ACE_Recursive_Thread_Mutex> guard(m_Lock);
 
-    int32 bracket_id = -1;                                  // signed for proper for-loop finish
     QueuedPlayersMap::iterator itr;
 
     // remove player from map, if he's there
@@ -318,38 +322,9 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     }
 
     GroupQueueInfo* group = itr->second.GroupInfo;
-    GroupsQueueType::iterator group_itr, group_itr_tmp;
-    // mostly people with the highest levels are in battlegrounds, thats why
-    // we count from MAX_BATTLEGROUND_QUEUES - 1 to 0
-    // variable index removes useless searching in other team's queue
-    uint32 index = BattleGround::GetTeamIndexByTeamId(group->GroupTeam);
 
-    for (int8 bracket_id_tmp = MAX_BATTLEGROUND_BRACKETS - 1; bracket_id_tmp >= 0 && bracket_id == -1; --bracket_id_tmp)
-    {
-        // we must check premade and normal team's queue - because when players from premade are joining bg,
-        // they leave groupinfo so we can't use its players size to find out index
-        for (uint8 j = index; j < BG_QUEUE_GROUP_TYPES_COUNT; j += BG_QUEUE_NORMAL_ALLIANCE)
-        {
-            for (group_itr_tmp = m_QueuedGroups[bracket_id_tmp][j].begin(); group_itr_tmp != m_QueuedGroups[bracket_id_tmp][j].end(); ++group_itr_tmp)
-            {
-                if ((*group_itr_tmp) == group)
-                {
-                    bracket_id = bracket_id_tmp;
-                    group_itr = group_itr_tmp;
-                    // we must store index to be able to erase iterator
-                    index = j;
-                    break;
-                }
-            }
-        }
-    }
-    // player can't be in queue without group, but just in case
-    if (bracket_id == -1)
-    {
-        sLog.outError("BattleGroundQueue: ERROR Can not find groupinfo for %s", guid.GetString().c_str());
-        return;
-    }
-    DEBUG_LOG("BattleGroundQueue: Removing %s, from bracket_id %u", guid.GetString().c_str(), (uint32)bracket_id);
+    // the group knows its queue, no need to search all brackets for it
+    DEBUG_LOG("BattleGroundQueue: Removing %s, from bracket_id %u", guid.GetString().c_str(), (uint32)group->BracketId);
 
     // ALL variables are correctly set
     // We can ignore leveling up in queue - it should not cause crash
@@ -361,6 +336,11 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     if (pitr != group->Players.end())
     {
         group->Players.erase(pitr);
+
+        if (!group->IsInvitedToBGInstanceGUID)
+        {
+            --m_WaitingPlayerCount[group->BracketId][group->QueueIndex];
+        }
     }
 
     // if invited to bg, and should decrease invited count, then do it
@@ -379,7 +359,14 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // remove group queue info if needed
     if (group->Players.empty())
     {
-        m_QueuedGroups[bracket_id][index].erase(group_itr);
+        if (group->IsInvitedToBGInstanceGUID)
+        {
+            m_InvitedGroups.erase(group);
+        }
+        else
+        {
+            m_QueuedGroups[group->BracketId][group->QueueIndex].erase(group->QueuePosition);
+        }
         delete group;
     }
 }
@@ -419,6 +406,12 @@ bool BattleGroundQueue::InviteGroupToBG(GroupQueueInfo* ginfo, BattleGround* bg,
         // not yet invited
         // set invitation
         ginfo->IsInvitedToBGInstanceGUID = bg->GetInstanceID();
+
+        // invited groups no longer take part in match making, take them out of the queue scans
+        m_QueuedGroups[ginfo->BracketId][ginfo->QueueIndex].erase(ginfo->QueuePosition);
+        m_WaitingPlayerCount[ginfo->BracketId][ginfo->QueueIndex] -= ginfo->Players.size();
+        m_InvitedGroups.insert(ginfo);
+
         BattleGroundTypeId bgTypeId = bg->GetTypeID();
         BattleGroundQueueTypeId bgQueueTypeId = BattleGroundMgr::BGQueueTypeId(bgTypeId);
         BattleGroundBracketId bracket_id = bg->GetBracketId();
@@ -572,56 +565,44 @@ bool BattleGroundQueue::CheckPremadeMatch(BattleGroundBracketId bracket_id, uint
     if (!m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].empty() && !m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].empty())
     {
         // start premade match
-        // if groups aren't invited
-        GroupsQueueType::const_iterator ali_group, horde_group;
-        for (ali_group = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].begin(); ali_group != m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].end(); ++ali_group)
-            if (!(*ali_group)->IsInvitedToBGInstanceGUID)
-            {
-                break;
-            }
-        for (horde_group = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].begin(); horde_group != m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].end(); ++horde_group)
-            if (!(*horde_group)->IsInvitedToBGInstanceGUID)
-            {
-                break;
-            }
-
-        if (ali_group != m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].end() && horde_group != m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].end())
+        // queues hold only not invited groups
+        m_SelectionPools[TEAM_INDEX_ALLIANCE].AddGroup(m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].front(), MaxPlayersPerTeam);
+        m_SelectionPools[TEAM_INDEX_HORDE].AddGroup(m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].front(), MaxPlayersPerTeam);
+        // add groups/players from normal queue to size of bigger group
+        uint32 maxPlayers = std::max(m_SelectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount(), m_SelectionPools[TEAM_INDEX_HORDE].GetPlayerCount());
+        GroupsQueueType::const_iterator itr;
+        for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
         {
-            m_SelectionPools[TEAM_INDEX_ALLIANCE].AddGroup((*ali_group), MaxPlayersPerTeam);
-            m_SelectionPools[TEAM_INDEX_HORDE].AddGroup((*horde_group), MaxPlayersPerTeam);
-            // add groups/players from normal queue to size of bigger group
-            uint32 maxPlayers = std::max(m_SelectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount(), m_SelectionPools[TEAM_INDEX_HORDE].GetPlayerCount());
-            GroupsQueueType::const_iterator itr;
-            for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
+            for (itr = m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].begin(); itr != m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].end(); ++itr)
             {
-                for (itr = m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].begin(); itr != m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].end(); ++itr)
+                // if itr can join BG and player count is less that maxPlayers, then add group to selectionpool
+                if (!m_SelectionPools[i].AddGroup((*itr), maxPlayers))
                 {
-                    // if itr can join BG and player count is less that maxPlayers, then add group to selectionpool
-                    if (!(*itr)->IsInvitedToBGInstanceGUID && !m_SelectionPools[i].AddGroup((*itr), maxPlayers))
-                    {
-                        break;
-                    }
+                    break;
                 }
             }
-            // premade selection pools are set
-            return true;
         }
+        // premade selection pools are set
+        return true;
     }
     // now check if we can move group from Premade queue to normal queue (timer has expired) or group size lowered!!
-    // this could be 2 cycles but i'm checking only first team in queue - it can cause problem -
-    // if first is invited to BG and seconds timer expired, but we can ignore it, because players have only 80 seconds to click to enter bg
-    // and when they click or after 80 seconds the queue info is removed from queue
+    // only the first group of each queue is checked, it is the longest waiting one
     uint32 time_before = GameTime::GetGameTimeMS() - sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_PREMADE_GROUP_WAIT_FOR_MATCH);
     for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
     {
         if (!m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE + i].empty())
         {
             GroupsQueueType::iterator itr = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE + i].begin();
-            if (!(*itr)->IsInvitedToBGInstanceGUID && ((*itr)->JoinTime < time_before || (*itr)->Players.size() < MinPlayersPerTeam))
+            GroupQueueInfo* ginfo = *itr;
+            if (ginfo->JoinTime < time_before || ginfo->Players.size() < MinPlayersPerTeam)
             {
                 // we must insert group to normal queue and erase pointer from premade queue
-                m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].push_front((*itr));
                 m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE + i].erase(itr);
+                m_WaitingPlayerCount[bracket_id][BG_QUEUE_PREMADE_ALLIANCE + i] -= ginfo->Players.size();
+
+                ginfo->QueueIndex = BG_QUEUE_NORMAL_ALLIANCE + i;
+                ginfo->QueuePosition = m_QueuedGroups[bracket_id][ginfo->QueueIndex].insert(m_QueuedGroups[bracket_id][ginfo->QueueIndex].begin(), ginfo);
+                m_WaitingPlayerCount[bracket_id][ginfo->QueueIndex] += ginfo->Players.size();
             }
         }
     }
@@ -638,13 +619,10 @@ bool BattleGroundQueue::CheckNormalMatch(BattleGroundBracketId bracket_id, uint3
         itr_team[i] = m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].begin();
         for (; itr_team[i] != m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].end(); ++(itr_team[i]))
         {
-            if (!(*(itr_team[i]))->IsInvitedToBGInstanceGUID)
+            m_SelectionPools[i].AddGroup(*(itr_team[i]), maxPlayers);
+            if (m_SelectionPools[i].GetPlayerCount() >= minPlayers)
             {
-                m_SelectionPools[i].AddGroup(*(itr_team[i]), maxPlayers);
-                if (m_SelectionPools[i].GetPlayerCount() >= minPlayers)
-                {
-                    break;
-                }
+                break;
             }
         }
     }
@@ -661,11 +639,10 @@ bool BattleGroundQueue::CheckNormalMatch(BattleGroundBracketId bracket_id, uint3
         ++(itr_team[j]);                                    // this will not cause a crash, because for cycle above reached break;
         for (; itr_team[j] != m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + j].end(); ++(itr_team[j]))
         {
-            if (!(*(itr_team[j]))->IsInvitedToBGInstanceGUID)
-                if (!m_SelectionPools[j].AddGroup(*(itr_team[j]), m_SelectionPools[(j + 1) % PVP_TEAM_COUNT].GetPlayerCount()))
-                {
-                    break;
-                }
+            if (!m_SelectionPools[j].AddGroup(*(itr_team[j]), m_SelectionPools[(j + 1) % PVP_TEAM_COUNT].GetPlayerCount()))
+            {
+                break;
+            }
         }
         // do not allow to start bg with more than 2 players more on 1 faction
         if (abs((int32)(m_SelectionPools[TEAM_INDEX_HORDE].GetPlayerCount() - m_SelectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount())) > 2)
@@ -1001,59 +978,73 @@ void BattleGroundMgr::BuildBattleGroundStatusPacket(WorldPacket* data, BattleGro
 
 void BattleGroundMgr::BuildPvpLogDataPacket(WorldPacket* data, BattleGround* bg)
 {
-    data->Initialize(MSG_PVP_LOG_DATA, (1 + 4 + 40 * bg->GetPlayerScoresSize()));
+    // clients poll the scoreboard while it is open, serve the cached body unless the scores changed
+    uint32 now = getMSTime();
+    ByteBuffer& cache = bg->GetPvpLogDataCache();
+    if (!bg->IsPvpLogDataCacheValid(now))
+    {
+        cache.clear();
+        BuildPvpLogData(cache, bg);
+        bg->SetPvpLogDataBuilt(now);
+    }
 
+    data->Initialize(MSG_PVP_LOG_DATA, cache.size());
+    data->append(cache);
+}
+
+void BattleGroundMgr::BuildPvpLogData(ByteBuffer& buffer, BattleGround* bg)
+{
     if (bg->GetStatus() != STATUS_WAIT_LEAVE)
     {
-        *data << uint8(0);                                  // bg not ended
+        buffer << uint8(0);                                 // bg not ended
     }
     else
     {
-        *data << uint8(1);                                  // bg ended
-        *data << uint8(bg->GetWinner());                    // who win
+        buffer << uint8(1);                                 // bg ended
+        buffer << uint8(bg->GetWinner());                   // who win
     }
 
-    *data << (uint32)(bg->GetPlayerScoresSize());
+    buffer << (uint32)(bg->GetPlayerScoresSize());
 
     for (BattleGround::BattleGroundScoreMap::const_iterator itr = bg->GetPlayerScoresBegin(); itr != bg->GetPlayerScoresEnd(); ++itr)
     {
         const BattleGroundScore* score = itr->second;
 
-        *data << ObjectGuid(itr->first);
+        buffer << ObjectGuid(itr->first);
 
         Player* plr = sObjectMgr.GetPlayer(itr->first);
 
-        *data << uint32(plr ? plr->GetHonorRankInfo().visualRank : 0);
-        *data << uint32(itr->second->KillingBlows);
-        *data << uint32(itr->second->HonorableKills);
-        *data << uint32(itr->second->Deaths);
-        *data << uint32(itr->second->BonusHonor);
+        buffer << uint32(plr ? plr->GetHonorRankInfo().visualRank : 0);
+        buffer << uint32(itr->second->KillingBlows);
+        buffer << uint32(itr->second->HonorableKills);
+        buffer << uint32(itr->second->Deaths);
+        buffer << uint32(itr->second->BonusHonor);
 
         switch (bg->GetTypeID())                            // battleground specific things
         {
             case BATTLEGROUND_AV:
-                *data << (uint32)0x00000007;                // count of next fields
-                *data << (uint32)((BattleGroundAVScore*)score)->GraveyardsAssaulted;  // GraveyardsAssaulted
-                *data << (uint32)((BattleGroundAVScore*)score)->GraveyardsDefended;   // GraveyardsDefended
-                *data << (uint32)((BattleGroundAVScore*)score)->TowersAssaulted;      // TowersAssaulted
-                *data << (uint32)((BattleGroundAVScore*)score)->TowersDefended;       // TowersDefended
-                *data << (uint32)((BattleGroundAVScore*)score)->SecondaryObjectives;  // Mines Taken
-                *data << (uint32)((BattleGroundAVScore*)score)->LieutnantCount;       // Lieutnant kills
-                *data << (uint32)((BattleGroundAVScore*)score)->SecondaryNPC;         // Secondary unit summons
+                buffer << (uint32)0x00000007;               // count of next fields
+                buffer << (uint32)((BattleGroundAVScore*)score)->GraveyardsAssaulted; // GraveyardsAssaulted
+                buffer << (uint32)((BattleGroundAVScore*)score)->GraveyardsDefended;  // GraveyardsDefended
+                buffer << (uint32)((BattleGroundAVScore*)score)->TowersAssaulted;     // TowersAssaulted
+                buffer << (uint32)((BattleGroundAVScore*)score)->TowersDefended;      // TowersDefended
+                buffer << (uint32)((BattleGroundAVScore*)score)->SecondaryObjectives; // Mines Taken
+                buffer << (uint32)((BattleGroundAVScore*)score)->LieutnantCount;      // Lieutnant kills
+                buffer << (uint32)((BattleGroundAVScore*)score)->SecondaryNPC;        // Secondary unit summons
                 break;
             case BATTLEGROUND_WS:
-                *data << (uint32)0x00000002;                // count of next fields
-                *data << (uint32)((BattleGroundWGScore*)score)->FlagCaptures;         // flag captures
-                *data << (uint32)((BattleGroundWGScore*)score)->FlagReturns;          // flag returns
+                buffer << (uint32)0x00000002;               // count of next fields
+                buffer << (uint32)((BattleGroundWGScore*)score)->FlagCaptures;        // flag captures
+                buffer << (uint32)((BattleGroundWGScore*)score)->FlagReturns;         // flag returns
                 break;
             case BATTLEGROUND_AB:
-                *data << (uint32)0x00000002;                // count of next fields
-                *data << (uint32)((BattleGroundABScore*)score)->BasesAssaulted;       // bases asssulted
-                *data << (uint32)((BattleGroundABScore*)score)->BasesDefended;        // bases defended
+                buffer << (uint32)0x00000002;               // count of next fields
+                buffer << (uint32)((BattleGroundABScore*)score)->BasesAssaulted;      // bases asssulted
+                buffer << (uint32)((BattleGroundABScore*)score)->BasesDefended;       // bases defended
                 break;
             default:
                 DEBUG_LOG("Unhandled MSG_PVP_LOG_DATA for BG id %u", bg->GetTypeID());
-                *data << (uint32)0;
+                buffer << (uint32)0;
                 break;
         }
     }
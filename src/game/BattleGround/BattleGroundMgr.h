@@ -89,6 +89,9 @@ struct GroupQueueInfo
     uint32  JoinTime;                                       /**< time when group was added */
     uint32  RemoveInviteTime;                               /**< time when we will remove invite for players in group */
     uint32  IsInvitedToBGInstanceGUID;                      /**< was invited to certain BG */
+    BattleGroundBracketId BracketId;                        /**< bracket of the queue holding the group */
+    uint8   QueueIndex;                                     /**< BattleGroundQueueGroupTypes of the queue holding the group */
+    std::list<GroupQueueInfo*>::iterator QueuePosition;     /**< position in that queue while not invited yet */
 };
 
 /**
@@ -238,7 +241,15 @@ class BattleGroundQueue
              BG_QUEUE_NORMAL_ALLIANCE   is used for normal (or small) alliance groups or non-rated arena matches
              BG_QUEUE_NORMAL_HORDE      is used for normal (or small) horde groups or non-rated arena matches
         */
-        GroupsQueueType m_QueuedGroups[MAX_BATTLEGROUND_BRACKETS][BG_QUEUE_GROUP_TYPES_COUNT]; /**< TODO */
+        GroupsQueueType m_QueuedGroups[MAX_BATTLEGROUND_BRACKETS][BG_QUEUE_GROUP_TYPES_COUNT]; /**< groups still waiting for an invite */
+        uint32 m_WaitingPlayerCount[MAX_BATTLEGROUND_BRACKETS][BG_QUEUE_GROUP_TYPES_COUNT]; /**< players of the groups in m_QueuedGroups */
+
+        /**
+         * @brief invited groups leave m_QueuedGroups, they are kept here until their players entered the bg or the invite expired
+         *
+         */
+        typedef std::set<GroupQueueInfo*> InvitedGroupsSet;
+        InvitedGroupsSet m_InvitedGroups;
 
         /**
          * @brief class to select and invite groups to bg
@@ -467,6 +478,13 @@ class BattleGroundMgr
          * @param bg
          */
         void BuildPvpLogDataPacket(WorldPacket* data, BattleGround* bg);
+        /**
+         * @brief Writes the scoreboard into buffer, BuildPvpLogDataPacket caches the result per battleground
+         *
+         * @param buffer
+         * @param bg
+         */
+        void BuildPvpLogData(ByteBuffer& buffer, BattleGround* bg);
         /**
          * @brief
          *
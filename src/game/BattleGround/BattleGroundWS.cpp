@@ -616,6 +616,8 @@ void BattleGroundWS::UpdatePlayerScore(Player* source, uint32 type, uint32 value
         return;
     }
 
+    InvalidatePvpLogData();
+
     switch (type)
     {
         case SCORE_FLAG_CAPTURES:                           // flags captured
@@ -183,6 +183,7 @@ bool ChatHandler::HandleGuildRankCommand(char* args)
     }
 
     slot->ChangeRank(newrank);
+    targetGuild->InvalidateRoster();
     return true;
 }
 
@@ -179,6 +179,7 @@ bool ChatHandler::HandleInstanceSaveDataCommand(char* /*args*/)
     }
 
     iData->SaveToDB();
+    iData->FlushSaveToDB();
     return true;
 }
 
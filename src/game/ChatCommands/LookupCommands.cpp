@@ -30,6 +30,7 @@
 #include "ObjectMgr.h"
 #include "SQLStorages.h"
 #include "Util.h"
+#include "LookupNameIndex.h"
 
  /**********************************************************************
       CommandTable : lookupCommandTable
@@ -190,43 +191,28 @@ bool ChatHandler::HandleLookupAreaCommand(char* args)
     wstrToLower(wnamepart);
 
     // Search in AreaTable.dbc
-    for (uint32 areaid = 0; areaid <= sAreaStore.GetNumRows(); ++areaid)
+    LookupNameListPtr areaNames = sLookupNameIndex.Get(LOOKUP_NAME_AREA, -1);
+    for (LookupNameList::const_iterator itr = areaNames->begin(); itr != areaNames->end(); ++itr)
     {
-        AreaTableEntry const* areaEntry = sAreaStore.LookupEntry(areaid);
+        AreaTableEntry const* areaEntry = sAreaStore.LookupEntry(itr->Id);
         if (areaEntry)
         {
             int loc = GetSessionDbcLocale();
-            std::string name = areaEntry->area_name[loc];
-            if (name.empty())
+            if (itr->Names[loc].empty())
             {
                 continue;
             }
 
-            if (!Utf8FitTo(name, wnamepart))
+            if (itr->Names[loc].find(wnamepart) == std::wstring::npos)
             {
-                loc = 0;
-                for (; loc < MAX_LOCALE; ++loc)
-                {
-                    if (loc == GetSessionDbcLocale())
-                    {
-                        continue;
-                    }
-
-                    name = areaEntry->area_name[loc];
-                    if (name.empty())
-                    {
-                        continue;
-                    }
-
-                    if (Utf8FitTo(name, wnamepart))
-                    {
-                        break;
-                    }
-                }
+                int found = itr->Match(wnamepart);
+                loc = found < 0 ? MAX_LOCALE : found;
             }
 
             if (loc < MAX_LOCALE)
             {
+                std::string name = areaEntry->area_name[loc];
+
                 // send area in "id - [name]" format
                 std::ostringstream ss;
                 if (m_session)
@@ -704,25 +690,18 @@ bool ChatHandler::HandleLookupItemCommand(char* args)
 
     uint32 counter = 0;
 
+    int loc_idx = GetSessionDbLocaleIndex();
+
     // Search in `item_template`
-    for (uint32 id = 0; id < sItemStorage.GetMaxEntry(); ++id)
+    LookupNameListPtr itemNames = sLookupNameIndex.Get(LOOKUP_NAME_ITEM, loc_idx);
+    for (LookupNameList::const_iterator itr = itemNames->begin(); itr != itemNames->end(); ++itr)
     {
-        ItemPrototype const* pProto = sItemStorage.LookupEntry<ItemPrototype >(id);
-        if (!pProto)
+        if (itr->Match(wnamepart) < 0)                      // locale name first, then the default one
         {
             continue;
         }
 
-        int loc_idx = GetSessionDbLocaleIndex();
-
-        std::string name;                                   // "" for let later only single time check default locale name directly
-        sObjectMgr.GetItemLocaleStrings(id, loc_idx, &name);
-        if ((name.empty() || !Utf8FitTo(name, wnamepart)) && !Utf8FitTo(pProto->Name1, wnamepart))
-        {
-            continue;
-        }
-
-        ShowItemListHelper(id, loc_idx, pl);
+        ShowItemListHelper(itr->Id, loc_idx, pl);
         ++counter;
     }
 
@@ -933,39 +912,22 @@ bool ChatHandler::HandleLookupSpellCommand(char* args)
     uint32 counter = 0;                                     // Counter for figure out that we found smth.
 
     // Search in Spell.dbc
-    for (uint32 id = 0; id < sSpellStore.GetNumRows(); ++id)
+    LookupNameListPtr spellNames = sLookupNameIndex.Get(LOOKUP_NAME_SPELL, -1);
+    for (LookupNameList::const_iterator itr = spellNames->begin(); itr != spellNames->end(); ++itr)
     {
-        SpellEntry const* spellInfo = sSpellStore.LookupEntry(id);
+        SpellEntry const* spellInfo = sSpellStore.LookupEntry(itr->Id);
         if (spellInfo)
         {
             int loc = GetSessionDbcLocale();
-            std::string name = spellInfo->SpellName[loc];
-            if (name.empty())
+            if (itr->Names[loc].empty())
             {
                 continue;
             }
 
-            if (!Utf8FitTo(name, wnamepart))
+            if (itr->Names[loc].find(wnamepart) == std::wstring::npos)
             {
-                loc = 0;
-                for (; loc < MAX_LOCALE; ++loc)
-                {
-                    if (loc == GetSessionDbcLocale())
-                    {
-                        continue;
-                    }
-
-                    name = spellInfo->SpellName[loc];
-                    if (name.empty())
-                    {
-                        continue;
-                    }
-
-                    if (Utf8FitTo(name, wnamepart))
-                    {
-                        break;
-                    }
-                }
+                int found = itr->Match(wnamepart);
+                loc = found < 0 ? MAX_LOCALE : found;
             }
 
             if (loc < MAX_LOCALE)
@@ -1007,20 +969,15 @@ bool ChatHandler::HandleLookupQuestCommand(char* args)
 
     int loc_idx = GetSessionDbLocaleIndex();
 
-    ObjectMgr::QuestMap const& qTemplates = sObjectMgr.GetQuestTemplates();
-    for (ObjectMgr::QuestMap::const_iterator iter = qTemplates.begin(); iter != qTemplates.end(); ++iter)
+    LookupNameListPtr questNames = sLookupNameIndex.Get(LOOKUP_NAME_QUEST, loc_idx);
+    for (LookupNameList::const_iterator itr = questNames->begin(); itr != questNames->end(); ++itr)
     {
-        Quest* qinfo = iter->second;
-
-        std::string title;                                  // "" for avoid repeating check default locale
-        sObjectMgr.GetQuestLocaleStrings(qinfo->GetQuestId(), loc_idx, &title);
-
-        if ((title.empty() || !Utf8FitTo(title, wnamepart)) && !Utf8FitTo(qinfo->GetTitle(), wnamepart))
+        if (itr->Match(wnamepart) < 0)                      // locale title first, then the default one
         {
             continue;
         }
 
-        ShowQuestListHelper(qinfo->GetQuestId(), loc_idx, target);
+        ShowQuestListHelper(itr->Id, loc_idx, target);
         ++counter;
     }
 
@@ -1052,25 +1009,23 @@ bool ChatHandler::HandleLookupCreatureCommand(char* args)
 
     uint32 counter = 0;
 
-    for (uint32 id = 0; id < sCreatureStorage.GetMaxEntry(); ++id)
+    int loc_idx = GetSessionDbLocaleIndex();
+
+    LookupNameListPtr creatureNames = sLookupNameIndex.Get(LOOKUP_NAME_CREATURE, loc_idx);
+    for (LookupNameList::const_iterator itr = creatureNames->begin(); itr != creatureNames->end(); ++itr)
     {
-        CreatureInfo const* cInfo = sCreatureStorage.LookupEntry<CreatureInfo>(id);
-        if (!cInfo)
+        CreatureInfo const* cInfo = sCreatureStorage.LookupEntry<CreatureInfo>(itr->Id);
+        int found = itr->Match(wnamepart);
+        if (!cInfo || found < 0)
         {
             continue;
         }
 
-        int loc_idx = GetSessionDbLocaleIndex();
-
-        char const* name = "";                              // "" for avoid repeating check for default locale
-        sObjectMgr.GetCreatureLocaleStrings(id, loc_idx, &name);
-        if (!*name || !Utf8FitTo(name, wnamepart))
+        uint32 id = itr->Id;
+        char const* name = cInfo->Name;
+        if (found == 0)                                     // matched the locale name
         {
-            name = cInfo->Name;
-            if (!Utf8FitTo(name, wnamepart))
-            {
-                continue;
-            }
+            sObjectMgr.GetCreatureLocaleStrings(id, loc_idx, &name);
         }
 
         if (m_session)
@@ -382,3 +382,12 @@ bool ChatHandler::HandleSendMassMoneyCommand(char* args)
     return true;
 }
 
+
+bool ChatHandler::HandleSendMassStatusCommand(char* /*args*/)
+{
+    uint32 tasks, mails, needTime;
+    sMassMailMgr.GetStatistic(tasks, mails, needTime);
+
+    PSendSysMessage("Mass mail tasks queued: %u, mails left to send: %u, estimated time: %u sec.", tasks, mails, needTime);
+    return true;
+}
@@ -254,3 +254,75 @@ bool ChatHandler::HandlePDumpWriteCommand(char* args)
 
     return true;
 }
+
+bool ChatHandler::HandlePDumpWriteBinaryCommand(char* args)
+{
+    char* file = ExtractQuotedOrLiteralArg(&args);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::vector<uint32> lowguids;
+    while (char* p2 = ExtractLiteralArg(&args))
+    {
+        uint32 lowguid;
+        ObjectGuid guid;
+        // character name can't start from number
+        if (!ExtractUInt32(&p2, lowguid))
+        {
+            std::string name = ExtractPlayerNameFromLink(&p2);
+            if (name.empty())
+            {
+                SendSysMessage(LANG_PLAYER_NOT_FOUND);
+                SetSentErrorMessage(true);
+                return false;
+            }
+
+            guid = sObjectMgr.GetPlayerGuidByName(name);
+            if (!guid)
+            {
+                PSendSysMessage(LANG_PLAYER_NOT_FOUND);
+                SetSentErrorMessage(true);
+                return false;
+            }
+
+            lowguid = guid.GetCounter();
+        }
+        else
+        {
+            guid = ObjectGuid(HIGHGUID_PLAYER, lowguid);
+        }
+
+        if (!sObjectMgr.GetPlayerAccountIdByGUID(guid))
+        {
+            PSendSysMessage(LANG_PLAYER_NOT_FOUND);
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        lowguids.push_back(lowguid);
+    }
+
+    if (lowguids.empty())
+    {
+        return false;
+    }
+
+    switch (PlayerDumpWriter().WriteBinaryDump(file, lowguids))
+    {
+        case DUMP_SUCCESS:
+            PSendSysMessage(LANG_COMMAND_EXPORT_SUCCESS);
+            break;
+        case DUMP_FILE_OPEN_ERROR:
+            PSendSysMessage(LANG_FILE_OPEN_FAIL, file);
+            SetSentErrorMessage(true);
+            return false;
+        default:
+            PSendSysMessage(LANG_COMMAND_EXPORT_FAILED);
+            SetSentErrorMessage(true);
+            return false;
+    }
+
+    return true;
+}
@@ -28,6 +28,9 @@
 #include "AccountMgr.h"
 #include "ObjectMgr.h"
 #include "SQLStorages.h"
+#include "CharacterLoginCache.h"
+#include "CharEnumCache.h"
+#include "PlayerNameCache.h"
 
 
 
@@ -165,6 +168,8 @@ bool ChatHandler::HandleCharacterRenameCommand(char* args)
         std::string oldNameLink = playerLink(target_name);
 
         PSendSysMessage(LANG_RENAME_PLAYER_GUID, oldNameLink.c_str(), target_guid.GetCounter());
+        sCharacterLoginCache.Invalidate(target_guid.GetCounter());
+        sCharEnumCache.InvalidateCharacter(target_guid.GetCounter());
         CharacterDatabase.PExecute("UPDATE `characters` SET `at_login` = `at_login` | '1' WHERE `guid` = '%u'", target_guid.GetCounter());
     }
 
@@ -361,6 +366,7 @@ void ChatHandler::HandleCharacterDeletedRestoreHelper(DeletedInfo const& delInfo
 
     CharacterDatabase.PExecute("UPDATE `characters` SET `name`='%s', `account`='%u', `deleteDate`=NULL, `deleteInfos_Name`=NULL, `deleteInfos_Account`=NULL WHERE `deleteDate` IS NOT NULL AND `guid` = %u",
                                delInfo.name.c_str(), delInfo.accountId, delInfo.lowguid);
+    sPlayerNameCache.Rename(delInfo.lowguid, delInfo.name);
 }
 
 /**
@@ -568,6 +574,8 @@ void ChatHandler::HandleCharacterLevel(Player* player, ObjectGuid player_guid, u
     else
     {
         // update level and XP at level, all other will be updated at loading
+        sCharacterLoginCache.Invalidate(player_guid.GetCounter());
+        sCharEnumCache.InvalidateCharacter(player_guid.GetCounter());
         CharacterDatabase.PExecute("UPDATE `characters` SET `level` = '%u', `xp` = 0 WHERE `guid` = '%u'", newlevel, player_guid.GetCounter());
     }
 }
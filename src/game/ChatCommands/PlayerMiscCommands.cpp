@@ -28,6 +28,7 @@
 #include "Mail.h"
 #include "Player.h"
 #include "ObjectAccessor.h"
+#include "CharacterLoginCache.h"
 
  /**********************************************************************
      CommandTable : commandTable
@@ -175,6 +176,7 @@ bool ChatHandler::HandleResetSpellsCommand(char* args)
     }
     else
     {
+        sCharacterLoginCache.Invalidate(target_guid.GetCounter());
         CharacterDatabase.PExecute("UPDATE `characters` SET `at_login` = `at_login` | '%u' WHERE `guid` = '%u'", uint32(AT_LOGIN_RESET_SPELLS), target_guid.GetCounter());
         PSendSysMessage(LANG_RESET_SPELLS_OFFLINE, target_name.c_str());
     }
@@ -206,6 +208,7 @@ bool ChatHandler::HandleResetTalentsCommand(char* args)
     else if (target_guid)
     {
         uint32 at_flags = AT_LOGIN_RESET_TALENTS;
+        sCharacterLoginCache.Invalidate(target_guid.GetCounter());
         CharacterDatabase.PExecute("UPDATE `characters` SET `at_login` = `at_login` | '%u' WHERE `guid` = '%u'", at_flags, target_guid.GetCounter());
         std::string nameLink = playerLink(target_name);
         PSendSysMessage(LANG_RESET_TALENTS_OFFLINE, nameLink.c_str());
@@ -254,6 +257,7 @@ bool ChatHandler::HandleResetAllCommand(char* args)
         return false;
     }
 
+    sCharacterLoginCache.Clear();
     CharacterDatabase.PExecute("UPDATE `characters` SET `at_login` = `at_login` | '%u' WHERE (`at_login` & '%u') = '0'", atLogin, atLogin);
     sObjectAccessor.DoForAllPlayers([&atLogin](Player* plr) { plr->SetAtLoginFlag(atLogin); });
     return true;
@@ -630,6 +634,9 @@ bool ChatHandler::HandleResetMailCommand(char* args)
         senderGuid = from_sender_guid;
     }
 
+    // deleted mails drop their items at save
+    player->LoadMailedItems();
+
     for (PlayerMails::iterator itr = player->GetMailBegin(); itr != player->GetMailEnd(); ++itr)
     {
         // Flag the mail as "deleted"
@@ -92,7 +92,8 @@ bool ChatHandler::HandlePoolSpawnsCommand(char* args)
 
     SpawnedPoolData const& spawns = mapState->GetSpawnedPoolData();
 
-    SpawnedPoolObjects const& crSpawns = spawns.GetSpawnedCreatures();
+    SpawnedPoolObjects crSpawns;
+    spawns.GetSpawnedGuids<Creature>(crSpawns);
     for (SpawnedPoolObjects::const_iterator itr = crSpawns.begin(); itr != crSpawns.end(); ++itr)
         if (!pool_id || pool_id == sPoolMgr.IsPartOfAPool<Creature>(*itr))
             if (CreatureData const* data = sObjectMgr.GetCreatureData(*itr))
@@ -100,7 +101,8 @@ bool ChatHandler::HandlePoolSpawnsCommand(char* args)
                     PSendSysMessage(LANG_CREATURE_LIST_CHAT, *itr, PrepareStringNpcOrGoSpawnInformation<Creature>(*itr).c_str(),
                                     *itr, info->Name, data->posX, data->posY, data->posZ, data->mapid);
 
-    SpawnedPoolObjects const& goSpawns = spawns.GetSpawnedGameobjects();
+    SpawnedPoolObjects goSpawns;
+    spawns.GetSpawnedGuids<GameObject>(goSpawns);
     for (SpawnedPoolObjects::const_iterator itr = goSpawns.begin(); itr != goSpawns.end(); ++itr)
         if (!pool_id || pool_id == sPoolMgr.IsPartOfAPool<GameObject>(*itr))
             if (GameObjectData const* data = sObjectMgr.GetGOData(*itr))
@@ -151,7 +153,6 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
     }
 
     PoolGroup<Creature> const& poolCreatures = sPoolMgr.GetPoolCreatures(pool_id);
-    SpawnedPoolObjects const* crSpawns = spawns ? &spawns->GetSpawnedCreatures() : NULL;
 
     PoolObjectList const& poolCreaturesEx = poolCreatures.GetExplicitlyChanced();
     if (!poolCreaturesEx.empty())
@@ -163,7 +164,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
             {
                 if (CreatureInfo const* info = ObjectMgr::GetCreatureTemplate(data->id))
                 {
-                    char const* active = crSpawns && crSpawns->find(itr->guid) != crSpawns->end() ? active_str.c_str() : "";
+                    char const* active = spawns && spawns->IsSpawnedObject<Creature>(*itr) ? active_str.c_str() : "";
                     if (m_session)
                         PSendSysMessage(LANG_POOL_CHANCE_CREATURE_LIST_CHAT, itr->guid, PrepareStringNpcOrGoSpawnInformation<Creature>(itr->guid).c_str(),
                                         itr->guid, info->Name, data->posX, data->posY, data->posZ, data->mapid, itr->chance, active);
@@ -185,7 +186,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
             {
                 if (CreatureInfo const* info = ObjectMgr::GetCreatureTemplate(data->id))
                 {
-                    char const* active = crSpawns && crSpawns->find(itr->guid) != crSpawns->end() ? active_str.c_str() : "";
+                    char const* active = spawns && spawns->IsSpawnedObject<Creature>(*itr) ? active_str.c_str() : "";
                     if (m_session)
                         PSendSysMessage(LANG_POOL_CREATURE_LIST_CHAT, itr->guid, PrepareStringNpcOrGoSpawnInformation<Creature>(itr->guid).c_str(),
                                         itr->guid, info->Name, data->posX, data->posY, data->posZ, data->mapid, active);
@@ -198,7 +199,6 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
     }
 
     PoolGroup<GameObject> const& poolGameObjects = sPoolMgr.GetPoolGameObjects(pool_id);
-    SpawnedPoolObjects const* goSpawns = spawns ? &spawns->GetSpawnedGameobjects() : NULL;
 
     PoolObjectList const& poolGameObjectsEx = poolGameObjects.GetExplicitlyChanced();
     if (!poolGameObjectsEx.empty())
@@ -210,7 +210,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
             {
                 if (GameObjectInfo const* info = ObjectMgr::GetGameObjectInfo(data->id))
                 {
-                    char const* active = goSpawns && goSpawns->find(itr->guid) != goSpawns->end() ? active_str.c_str() : "";
+                    char const* active = spawns && spawns->IsSpawnedObject<GameObject>(*itr) ? active_str.c_str() : "";
                     if (m_session)
                         PSendSysMessage(LANG_POOL_CHANCE_GO_LIST_CHAT, itr->guid, PrepareStringNpcOrGoSpawnInformation<GameObject>(itr->guid).c_str(),
                                         itr->guid, info->name, data->posX, data->posY, data->posZ, data->mapid, itr->chance, active);
@@ -232,7 +232,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
             {
                 if (GameObjectInfo const* info = ObjectMgr::GetGameObjectInfo(data->id))
                 {
-                    char const* active = goSpawns && goSpawns->find(itr->guid) != goSpawns->end() ? active_str.c_str() : "";
+                    char const* active = spawns && spawns->IsSpawnedObject<GameObject>(*itr) ? active_str.c_str() : "";
                     if (m_session)
                         PSendSysMessage(LANG_POOL_GO_LIST_CHAT, itr->guid, PrepareStringNpcOrGoSpawnInformation<GameObject>(itr->guid).c_str(),
                                         itr->guid, info->name, data->posX, data->posY, data->posZ, data->mapid, active);
@@ -245,7 +245,6 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
     }
 
     PoolGroup<Pool> const& poolPools = sPoolMgr.GetPoolPools(pool_id);
-    SpawnedPoolPools const* poolSpawns = spawns ? &spawns->GetSpawnedPools() : NULL;
 
     PoolObjectList const& poolPoolsEx = poolPools.GetExplicitlyChanced();
     if (!poolPoolsEx.empty())
@@ -254,7 +253,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
         for (PoolObjectList::const_iterator itr = poolPoolsEx.begin(); itr != poolPoolsEx.end(); ++itr)
         {
             PoolTemplateData const& itr_template = sPoolMgr.GetPoolTemplate(itr->guid);
-            char const* active = poolSpawns && poolSpawns->find(itr->guid) != poolSpawns->end() ? active_str.c_str() : "";
+            char const* active = spawns && spawns->IsSpawnedObject<Pool>(*itr) ? active_str.c_str() : "";
             if (m_session)
                 PSendSysMessage(LANG_POOL_CHANCE_POOL_LIST_CHAT, itr->guid,
                                 itr->guid, itr_template.description.c_str(), itr_template.AutoSpawn ? 1 : 0, itr_template.MaxLimit,
@@ -275,7 +274,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
         for (PoolObjectList::const_iterator itr = poolPoolsEq.begin(); itr != poolPoolsEq.end(); ++itr)
         {
             PoolTemplateData const& itr_template = sPoolMgr.GetPoolTemplate(itr->guid);
-            char const* active = poolSpawns && poolSpawns->find(itr->guid) != poolSpawns->end() ? active_str.c_str() : "";
+            char const* active = spawns && spawns->IsSpawnedObject<Pool>(*itr) ? active_str.c_str() : "";
             if (m_session)
                 PSendSysMessage(LANG_POOL_POOL_LIST_CHAT, itr->guid,
                                 itr->guid, itr_template.description.c_str(), itr_template.AutoSpawn ? 1 : 0, itr_template.MaxLimit,
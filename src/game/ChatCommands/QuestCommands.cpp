@@ -130,6 +130,8 @@ bool ChatHandler::HandleQuestRemoveCommand(char* args)
 
     // reset rewarded for restart repeatable quest
     player->getQuestStatusMap()[entry].m_rewarded = false;
+    player->InvalidateQuestGiverStatus();
+    player->InvalidateConditionResults();
 
     SendSysMessage(LANG_COMMAND_QUEST_REMOVED);
     return true;
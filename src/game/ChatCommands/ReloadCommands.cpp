@@ -32,6 +32,8 @@
 #include "BattleGroundMgr.h"
 #include "ItemEnchantmentMgr.h"
 #include "CommandMgr.h"
+#include "QueryResponseCache.h"
+#include "LookupNameIndex.h"
 
  /**********************************************************************
      CommandTable : commandTable
@@ -65,6 +67,8 @@ bool ChatHandler::HandleReloadAllSpellCommand(char* /*args*/)
     HandleReloadSpellThreatsCommand((char*)"a");
     HandleReloadSpellPetAurasCommand((char*)"a");
     HandleReloadSpellLinkedCommand((char*)"a");
+
+    sSpellMgr.LoadSpellClassifiers();
     return true;
 }
 
@@ -101,8 +105,22 @@ bool ChatHandler::HandleReloadAllAreaCommand(char* /*args*/)
     return true;
 }
 
-bool ChatHandler::HandleReloadAllLootCommand(char* /*args*/)
+bool ChatHandler::HandleReloadAllLootCommand(char* args)
 {
+    if (ExtractLiteralArg(&args, "delta"))
+    {
+        if (!StartLootTablesDeltaReload())
+        {
+            SendSysMessage("Previous loot tables reload is still in progress.");
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        sLog.outString("Re-Loading Loot Tables in background...");
+        SendGlobalSysMessage("DB tables `*_loot_template` are reloading in background, only changed templates will be replaced.", SEC_MODERATOR);
+        return true;
+    }
+
     sLog.outString("Re-Loading Loot Tables...");
     LoadLootTables();
     SendGlobalSysMessage("DB tables `*_loot_template` reloaded.", SEC_MODERATOR);
@@ -197,6 +215,7 @@ bool ChatHandler::HandleReloadConfigCommand(char* /*args*/)
     sLog.outString("Re-Loading config settings...");
     sWorld.LoadConfigSettings(true);
     sMapMgr.InitializeVisibilityDistanceInfo();
+    sQueryResponseCache.Clear(QUERY_RESPONSE_ITEM);         // mount level requirements
     SendGlobalSysMessage("World config settings reloaded.", SEC_MODERATOR);
     return true;
 }
@@ -307,6 +326,7 @@ bool ChatHandler::HandleReloadQuestTemplateCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Quest Templates...");
     sObjectMgr.LoadQuests();
+    sLookupNameIndex.Clear(LOOKUP_NAME_QUEST);
     SendGlobalSysMessage("DB table `quest_template` (quest definitions) reloaded.", SEC_MODERATOR);
 
     /// dependent also from `gameobject` but this table not reloaded anyway
@@ -408,6 +428,7 @@ bool ChatHandler::HandleReloadNpcTextCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading `npc_text` Table!");
     sObjectMgr.LoadGossipText();
+    sQueryResponseCache.Clear(QUERY_RESPONSE_NPC_TEXT);
     SendGlobalSysMessage("DB table `npc_text` reloaded.", SEC_MODERATOR);
     return true;
 }
@@ -591,6 +612,7 @@ bool ChatHandler::HandleReloadPageTextsCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Page Texts...");
     sObjectMgr.LoadPageTexts();
+    sQueryResponseCache.Clear(QUERY_RESPONSE_PAGE_TEXT);
     SendGlobalSysMessage("DB table `page_texts` reloaded.", SEC_MODERATOR);
     return true;
 }
@@ -864,6 +886,8 @@ bool ChatHandler::HandleReloadLocalesCreatureCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Creature ...");
     sObjectMgr.LoadCreatureLocales();
+    sQueryResponseCache.Clear(QUERY_RESPONSE_CREATURE);
+    sLookupNameIndex.Clear(LOOKUP_NAME_CREATURE);
     SendGlobalSysMessage("DB table `locales_creature` reloaded.", SEC_MODERATOR);
     return true;
 }
@@ -872,6 +896,7 @@ bool ChatHandler::HandleReloadLocalesGameobjectCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Gameobject ... ");
     sObjectMgr.LoadGameObjectLocales();
+    sQueryResponseCache.Clear(QUERY_RESPONSE_GAMEOBJECT);
     SendGlobalSysMessage("DB table `locales_gameobject` reloaded.", SEC_MODERATOR);
     return true;
 }
@@ -888,6 +913,8 @@ bool ChatHandler::HandleReloadLocalesItemCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Item ... ");
     sObjectMgr.LoadItemLocales();
+    sQueryResponseCache.Clear(QUERY_RESPONSE_ITEM);
+    sLookupNameIndex.Clear(LOOKUP_NAME_ITEM);
     SendGlobalSysMessage("DB table `locales_item` reloaded.", SEC_MODERATOR);
     return true;
 }
@@ -896,6 +923,7 @@ bool ChatHandler::HandleReloadLocalesNpcTextCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales NPC Text ... ");
     sObjectMgr.LoadGossipTextLocales();
+    sQueryResponseCache.Clear(QUERY_RESPONSE_NPC_TEXT);
     SendGlobalSysMessage("DB table `locales_npc_text` reloaded.", SEC_MODERATOR);
     return true;
 }
@@ -912,6 +940,7 @@ bool ChatHandler::HandleReloadLocalesPageTextCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Page Text ... ");
     sObjectMgr.LoadPageTextLocales();
+    sQueryResponseCache.Clear(QUERY_RESPONSE_PAGE_TEXT);
     SendGlobalSysMessage("DB table `locales_page_text` reloaded.", SEC_MODERATOR);
     return true;
 }
@@ -928,6 +957,7 @@ bool ChatHandler::HandleReloadLocalesQuestCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Quest ... ");
     sObjectMgr.LoadQuestLocales();
+    sLookupNameIndex.Clear(LOOKUP_NAME_QUEST);
     SendGlobalSysMessage("DB table `locales_quest` reloaded.", SEC_MODERATOR);
     return true;
 }
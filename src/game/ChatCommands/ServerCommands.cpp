@@ -35,6 +35,18 @@
 #include "Util.h"
 #include <MapPersistentStateMgr.h>
 #include <ObjectAccessor.h>
+#include "MapManager.h"
+#include "WorldSocket.h"
+#include "WorldSocketMgr.h"
+#include "CharacterDatabaseCleaner.h"
+#include "DisableMgr.h"
+#include "CreatureLinkingMgr.h"
+#include "MemoryUsage.h"
+
+#ifdef ENABLE_ELUNA
+#include "LuaEngine.h"
+#endif /* ENABLE_ELUNA */
+#include "Utilities/ObjectPool.h"
 
  /**********************************************************************
      CommandTable : serverCommandTable
@@ -360,6 +372,419 @@ bool ChatHandler::HandleServerCorpsesCommand(char* /*args*/)
     return true;
 }
 
+bool ChatHandler::HandleServerCleanCharactersCommand(char* args)
+{
+    uint32 flags = CharacterDatabaseCleaner::CLEANING_FLAGS_ALL;
+    if (*args && !ExtractUInt32(&args, flags))
+    {
+        return false;
+    }
+
+    // the passes run in the background, their results go to the server log
+    if (!CharacterDatabaseCleaner::StartBackgroundCleaning(flags))
+    {
+        PSendSysMessage("Character database cleaning is already running."); // ToDo: move to language string
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Character database cleaning started (flags 0x%X).", flags); // ToDo: move to language string
+    return true;
+}
+
+static bool MapUpdateTimeGreater(Map const* a, Map const* b)
+{
+    return a->GetUpdateTime().GetPhase(MAP_UPDATE_PHASE_TOTAL).GetPercentile(99) > b->GetUpdateTime().GetPhase(MAP_UPDATE_PHASE_TOTAL).GetPercentile(99);
+}
+
+/// Show per phase update times of the maps with the slowest ticks
+bool ChatHandler::HandleServerPerfMapsCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10))
+    {
+        return false;
+    }
+
+    std::vector<Map const*> maps;
+    MapManager::MapMapSnapshot snapshot = sMapMgr.Maps();
+    MapManager::MapMapType const& mapList = *snapshot;
+    for (MapManager::MapMapType::const_iterator itr = mapList.begin(); itr != mapList.end(); ++itr)
+    {
+        if (itr->second->GetUpdateTime().GetPhase(MAP_UPDATE_PHASE_TOTAL).GetCount())
+        {
+            maps.push_back(itr->second);
+        }
+    }
+
+    std::sort(maps.begin(), maps.end(), MapUpdateTimeGreater);
+
+    if (maps.size() > count)
+    {
+        maps.resize(count);
+    }
+
+    PSendSysMessage("Map update times in microseconds (p50 / p99 / max), slowest %u maps:", uint32(maps.size()));
+
+    for (std::vector<Map const*>::const_iterator itr = maps.begin(); itr != maps.end(); ++itr)
+    {
+        Map const* map = *itr;
+        MapUpdateTime const& updateTime = map->GetUpdateTime();
+
+        PSendSysMessage("Map %u instance %u (%s), players %u, ticks %u every %u ms, script steps pending %u executed %u", map->GetId(), map->GetInstanceId(), map->GetMapName(),
+                        map->GetPlayers().getSize(), updateTime.GetPhase(MAP_UPDATE_PHASE_TOTAL).GetCount(), map->GetAverageTickInterval(),
+                        uint32(map->GetScriptSchedule().size()), map->GetScriptSchedule().GetExecutedCount());
+
+        for (uint32 phase = 0; phase < MAX_MAP_UPDATE_PHASE; ++phase)
+        {
+            UpdateTimeHistogram const& histogram = updateTime.GetPhase(MapUpdatePhase(phase));
+            PSendSysMessage("  %-12s %8u / %8u / %8u", MapUpdateTime::GetPhaseName(MapUpdatePhase(phase)),
+                            histogram.GetPercentile(50), histogram.GetPercentile(99), histogram.GetMax());
+        }
+
+        LineOfSightCache const& losCache = map->GetLineOfSightCache();
+        uint32 losChecks = losCache.GetHits() + losCache.GetMisses();
+        PSendSysMessage("  line of sight cache: %u of %u checks hit (%u%%)", losCache.GetHits(), losChecks,
+                        losChecks ? uint32(uint64(losCache.GetHits()) * 100 / losChecks) : 0);
+
+        DynamicMapTree const& dynTree = map->GetDynamicTree();
+        PSendSysMessage("  dynamic tree: %u models, %u refits, %u rebuilds, " UI64FMTD " us", uint32(dynTree.size()),
+                        dynTree.GetRefitCount(), dynTree.GetRebuildCount(), dynTree.GetMaintenanceTime());
+    }
+
+    std::vector<ObjectPool const*> pools;
+    ObjectPool::GetPools(pools);
+
+    for (std::vector<ObjectPool const*>::const_iterator itr = pools.begin(); itr != pools.end(); ++itr)
+    {
+        ObjectPool::Stats stats;
+        (*itr)->GetStats(stats);
+
+        uint64 pooled = stats.hits + stats.misses;
+        PSendSysMessage("%s pool: " UI64FMTD " hits, " UI64FMTD " misses (%.1f%% hit rate), " UI64FMTD " above " SIZEFMTD " bytes.",
+                        (*itr)->GetName(), stats.hits, stats.misses, pooled ? stats.hits * 100.0 / pooled : 0.0,
+                        stats.oversized, (*itr)->GetMaxSize());
+    }
+
+    uint64 disableChecks, disableLookups;
+    DisableMgr::GetLookupCounts(disableChecks, disableLookups);
+    PSendSysMessage("Disable checks: " UI64FMTD ", " UI64FMTD " past the entry bits.", disableChecks, disableLookups);
+    PSendSysMessage("Creature linking checks: " UI64FMTD ", " UI64FMTD " past the entry and guid bits.",
+                    sCreatureLinkingMgr.GetCheckCount(), sCreatureLinkingMgr.GetLookupCount());
+
+    return true;
+}
+
+typedef std::pair<uint64, Map*> MapMemoryUsage;
+
+static bool MapMemoryUsageGreater(MapMemoryUsage const& a, MapMemoryUsage const& b)
+{
+    return a.first > b.first;
+}
+
+bool ChatHandler::HandleServerPerfMemoryCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10))
+    {
+        return false;
+    }
+
+    MemoryUsageList entries;
+    MemoryUsage::Collect(entries);
+
+    PSendSysMessage("Approximate memory, structures only: " UI64FMTD " KB", MemoryUsage::GetTotalBytes(entries) / 1024);
+    for (MemoryUsageList::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
+    {
+        if (itr->sized)
+        {
+            PSendSysMessage("  %-28s %8u entries %10u KB", itr->owner, uint32(itr->count), uint32(itr->bytes / 1024));
+        }
+        else
+        {
+            PSendSysMessage("  %-28s %8u entries", itr->owner, uint32(itr->count));
+        }
+    }
+
+    std::vector<MapMemoryUsage> maps;
+    MapManager::MapMapSnapshot snapshot = sMapMgr.Maps();
+    MapManager::MapMapType const& mapList = *snapshot;
+    for (MapManager::MapMapType::const_iterator itr = mapList.begin(); itr != mapList.end(); ++itr)
+    {
+        MemoryUsageList mapEntries;
+        MemoryUsage::CollectMap(itr->second, mapEntries);
+        maps.push_back(MapMemoryUsage(MemoryUsage::GetTotalBytes(mapEntries), itr->second));
+    }
+
+    std::sort(maps.begin(), maps.end(), MapMemoryUsageGreater);
+
+    if (maps.size() > count)
+    {
+        maps.resize(count);
+    }
+
+    PSendSysMessage("Largest %u maps:", uint32(maps.size()));
+    for (std::vector<MapMemoryUsage>::const_iterator itr = maps.begin(); itr != maps.end(); ++itr)
+    {
+        Map* map = itr->second;
+        PSendSysMessage("Map %u instance %u (%s), %u KB", map->GetId(), map->GetInstanceId(), map->GetMapName(), uint32(itr->first / 1024));
+
+        MemoryUsageList mapEntries;
+        MemoryUsage::CollectMap(map, mapEntries);
+
+        std::ostringstream line;
+        for (MemoryUsageList::const_iterator entry = mapEntries.begin(); entry != mapEntries.end(); ++entry)
+        {
+            line << (entry == mapEntries.begin() ? "  " : ", ") << entry->count << " " << entry->owner;
+        }
+
+        SendSysMessage(line.str().c_str());
+    }
+
+    return true;
+}
+
+bool ChatHandler::HandleServerPerfNetCommand(char* /*args*/)
+{
+    if (!sWorldSocketMgr->GetOutRingSize())
+    {
+        SendSysMessage("Output ring disabled (Network.OutRing = 0), sockets use the copying output buffer.");
+    }
+    else
+    {
+        PSendSysMessage("Output ring: %d packets per socket, %ld packets overflowed to the socket queue.",
+                        sWorldSocketMgr->GetOutRingSize(), sWorldSocketMgr->GetOutRingOverflowCount());
+    }
+
+    PacketBufferPool::Stats stats;
+    PacketBufferPool::GetStats(stats);
+
+    uint64 pooled = stats.hits + stats.misses;
+    PSendSysMessage("Packet buffers: " UI64FMTD " pool hits, " UI64FMTD " misses (%.1f%% hit rate), " UI64FMTD " above " SIZEFMTD " bytes.",
+                    stats.hits, stats.misses, pooled ? stats.hits * 100.0 / pooled : 0.0,
+                    stats.oversized, PacketBufferPool::MAX_POOLED_SIZE);
+    return true;
+}
+
+/// Show the statements waiting for each async database connection
+static void ShowAsyncQueueSizes(ChatHandler* handler, char const* name, Database const& db)
+{
+    std::vector<uint32> sizes;
+    db.GetAsyncQueueSizes(sizes);
+
+    std::ostringstream ss;
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        ss << (i ? " " : "") << sizes[i];
+    }
+
+    handler->PSendSysMessage("%s database: %u async connections, queued statements: %s", name, uint32(sizes.size()), ss.str().c_str());
+
+    uint32 statements;
+    uint64 hits;
+    db.GetFormatStmtStats(statements, hits);
+
+    handler->PSendSysMessage("%s database: %u format strings prepared, " UI64FMTD " executions through them", name, statements, hits);
+
+    uint32 buffered;
+    uint64 coalesced;
+    db.GetCoalescedStats(buffered, coalesced);
+
+    handler->PSendSysMessage("%s database: %u write-behind statements buffered, " UI64FMTD " replaced by a later one", name, buffered, coalesced);
+}
+
+bool ChatHandler::HandleServerPerfDbCommand(char* /*args*/)
+{
+    ShowAsyncQueueSizes(this, "Character", CharacterDatabase);
+    ShowAsyncQueueSizes(this, "World", WorldDatabase);
+    ShowAsyncQueueSizes(this, "Login", LoginDatabase);
+    return true;
+}
+
+#ifdef ENABLE_ELUNA
+/// Show the Lua functions with the highest total time, recorded with Eluna.Profiling
+bool ChatHandler::HandleServerPerfLuaCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 20))
+    {
+        return false;
+    }
+
+    if (!sEluna || !sEluna->IsProfiling())
+    {
+        SendSysMessage("Lua function times are not recorded (Eluna.Profiling = false).");
+        return true;
+    }
+
+    std::vector<Eluna::ProfileEntry> entries;
+    sEluna->GetProfileEntries(entries);
+
+    if (entries.size() > count)
+    {
+        entries.resize(count);
+    }
+
+    PSendSysMessage("Lua memory in use: %u KB. Lua function times in microseconds (calls / total / avg / max / allocated bytes), top %u:",
+                    sEluna->GetMemoryUsage(), uint32(entries.size()));
+
+    for (std::vector<Eluna::ProfileEntry>::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
+    {
+        PSendSysMessage("  %s event %d: %u / " UI64FMTD " / %u / %u / " UI64FMTD, itr->function.c_str(), itr->eventId,
+                        itr->calls, itr->totalUs, itr->calls ? uint32(itr->totalUs / itr->calls) : 0, itr->maxUs, itr->allocatedBytes);
+    }
+
+    return true;
+}
+#endif /* ENABLE_ELUNA */
+
+/// Show the client opcodes with the highest total handler time
+bool ChatHandler::HandleServerPerfOpcodesCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 20))
+    {
+        return false;
+    }
+
+    if (!sWorld.getConfig(CONFIG_BOOL_OPCODE_PERF))
+    {
+        SendSysMessage("Opcode handler times are not recorded (OpcodePerf = 0).");
+        return true;
+    }
+
+    std::vector<OpcodeUpdateTime::OpcodeEntry> entries;
+    sOpcodeUpdateTime.Collect(entries);
+
+    if (entries.size() > count)
+    {
+        entries.resize(count);
+    }
+
+    PSendSysMessage("Opcode handler times in microseconds (calls / total / avg / p99 / max), top %u:", uint32(entries.size()));
+
+    for (std::vector<OpcodeUpdateTime::OpcodeEntry>::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
+    {
+        UpdateTimeHistogram const& histogram = itr->histogram;
+        PSendSysMessage("  %s (0x%.4X) %u / " UI64FMTD " / %u / %u / %u", LookupOpcodeName(itr->opcode), itr->opcode,
+                        histogram.GetCount(), histogram.GetTotal(), histogram.GetAverage(), histogram.GetPercentile(99), histogram.GetMax());
+    }
+
+    return true;
+}
+
+/// Show the accounts with the highest total handler time, of their open sessions and those closed since the last reset
+bool ChatHandler::HandleServerPerfAccountsCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 20))
+    {
+        return false;
+    }
+
+    World::AccountTrafficMap accounts;
+    sWorld.GetAccountTraffic(accounts);
+
+    std::vector<std::pair<uint32, SessionTraffic> > entries(accounts.begin(), accounts.end());
+    std::sort(entries.begin(), entries.end(), [](std::pair<uint32, SessionTraffic> const& a, std::pair<uint32, SessionTraffic> const& b)
+    {
+        return a.second.handlerUs != b.second.handlerUs ? a.second.handlerUs > b.second.handlerUs : a.second.packetsIn > b.second.packetsIn;
+    });
+
+    if (entries.size() > count)
+    {
+        entries.resize(count);
+    }
+
+    if (!sWorld.getConfig(CONFIG_BOOL_OPCODE_PERF))
+    {
+        SendSysMessage("Opcode handler times are not recorded (OpcodePerf = 0).");
+    }
+
+    PSendSysMessage("Accounts (sessions / handler us / packets in / bytes in / packets out / bytes out / send queue peak), top %u:", uint32(entries.size()));
+
+    for (std::vector<std::pair<uint32, SessionTraffic> >::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
+    {
+        SessionTraffic const& traffic = itr->second;
+        PSendSysMessage("  %u%s %u / " UI64FMTD " / " UI64FMTD " / " UI64FMTD " / " UI64FMTD " / " UI64FMTD " / %u", itr->first,
+                        sWorld.FindSession(itr->first) ? " (online)" : "", traffic.sessions, traffic.handlerUs,
+                        traffic.packetsIn, traffic.bytesIn, traffic.packetsOut, traffic.bytesOut, traffic.sendQueuePeak);
+    }
+
+    return true;
+}
+
+bool ChatHandler::HandleServerPerfResetCommand(char* /*args*/)
+{
+    MapManager::MapMapSnapshot snapshot = sMapMgr.Maps();
+    MapManager::MapMapType const& mapList = *snapshot;
+    for (MapManager::MapMapType::const_iterator itr = mapList.begin(); itr != mapList.end(); ++itr)
+    {
+        itr->second->ResetUpdateTime();
+    }
+
+    sOpcodeUpdateTime.Reset();
+    sWorld.ResetSessionTraffic();
+    DisableMgr::ResetLookupCounts();
+    sCreatureLinkingMgr.ResetLookupCounts();
+
+    CharacterDatabase.ResetStmtTimings();
+    WorldDatabase.ResetStmtTimings();
+    LoginDatabase.ResetStmtTimings();
+
+#ifdef ENABLE_ELUNA
+    if (sEluna)
+    {
+        sEluna->ResetProfile();
+    }
+#endif /* ENABLE_ELUNA */
+
+    SendSysMessage("Map update, opcode handler, session traffic, prepared statement and Lua function times and lookup counts reset.");
+    return true;
+}
+
+/// Show the prepared statements of one database with the highest total execution time
+static void ShowStmtTimings(ChatHandler* handler, char const* name, Database const& db, uint32 count)
+{
+    std::vector<Database::StmtTiming> timings;
+    db.GetStmtTimings(timings);
+
+    std::sort(timings.begin(), timings.end(), [](Database::StmtTiming const& a, Database::StmtTiming const& b) { return a.totalUs > b.totalUs; });
+
+    if (timings.size() > count)
+    {
+        timings.resize(count);
+    }
+
+    handler->PSendSysMessage("%s database prepared statements in microseconds (calls / total / avg / max), top %u:", name, uint32(timings.size()));
+
+    for (std::vector<Database::StmtTiming>::const_iterator itr = timings.begin(); itr != timings.end(); ++itr)
+    {
+        handler->PSendSysMessage("  #%i %u / " UI64FMTD " / %u / %u: %s", itr->index, itr->calls, itr->totalUs,
+                                 uint32(itr->totalUs / itr->calls), itr->maxUs, db.GetStmtString(itr->index).c_str());
+    }
+}
+
+bool ChatHandler::HandleServerPerfSqlCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10))
+    {
+        return false;
+    }
+
+    if (!sConfig.GetBoolDefault("SqlStatementTimings", false))
+    {
+        SendSysMessage("Prepared statement times are not recorded (SqlStatementTimings = 0).");
+        return true;
+    }
+
+    ShowStmtTimings(this, "Character", CharacterDatabase, count);
+    ShowStmtTimings(this, "World", WorldDatabase, count);
+    ShowStmtTimings(this, "Login", LoginDatabase, count);
+    return true;
+}
+
 bool ChatHandler::HandleServerResetAllRaidCommand(char* args)
 {
     PSendSysMessage("Global raid instances reset, all players in raid instances will be teleported to homebind!");
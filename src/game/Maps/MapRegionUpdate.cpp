@@ -0,0 +1,190 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "MapRegionUpdate.h"
+#include "Map.h"
+#include "Player.h"
+#include "GridDefines.h"
+
+#include <ace/Guard_T.h>
+
+MapRegionUpdateJob::MapRegionUpdateJob(Map& map, uint32 diff)
+    : m_map(map), m_diff(diff), m_nextRegion(0), m_lock(), m_condition(m_lock), m_finishedRegions(0)
+{
+}
+
+bool MapRegionUpdateJob::BuildRegions()
+{
+    std::vector<WorldObject*> sources;
+
+    for (MapRefManager::iterator itr = m_map.m_mapRefManager.begin(); itr != m_map.m_mapRefManager.end(); ++itr)
+    {
+        Player* plr = itr->getSource();
+        if (plr && plr->IsInWorld() && plr->IsPositionValid())
+        {
+            sources.push_back(plr);
+        }
+    }
+
+    for (Map::ActiveNonPlayers::const_iterator itr = m_map.m_activeNonPlayers.begin(); itr != m_map.m_activeNonPlayers.end(); ++itr)
+    {
+        if ((*itr) && (*itr)->IsInWorld() && (*itr)->IsPositionValid())
+        {
+            sources.push_back(*itr);
+        }
+    }
+
+    if (sources.size() < 2)
+    {
+        return false;
+    }
+
+    // objects in grids closer than this may see or act on each other (chase, spells) within one tick
+    int32 gap = int32(ceil(3.0f * m_map.GetVisibilityDistance() / SIZE_OF_GRIDS)) + 1;
+
+    // collect the distinct grids holding update sources
+    std::map<uint32, size_t> gridIndex;
+    std::vector<GridPair> grids;
+    std::vector<size_t> sourceGrid(sources.size());
+
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        GridPair p = MaNGOS::ComputeGridPair(sources[i]->GetPositionX(), sources[i]->GetPositionY());
+        uint32 key = p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord;
+
+        std::map<uint32, size_t>::const_iterator found = gridIndex.find(key);
+        if (found == gridIndex.end())
+        {
+            found = gridIndex.insert(std::make_pair(key, grids.size())).first;
+            grids.push_back(p);
+        }
+
+        sourceGrid[i] = found->second;
+    }
+
+    if (grids.size() < 2)
+    {
+        return false;
+    }
+
+    // union-find over the grids, swept along x so only nearby columns are compared; the map
+    // keys above are ordered by x already, so the grid list is sorted by x_coord
+    std::vector<size_t> parent(grids.size());
+    for (size_t i = 0; i < parent.size(); ++i)
+    {
+        parent[i] = i;
+    }
+
+    struct Root
+    {
+        static size_t Find(std::vector<size_t>& parent, size_t i)
+        {
+            while (parent[i] != i)
+            {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+            }
+            return i;
+        }
+    };
+
+    std::vector<size_t> order;
+    order.reserve(gridIndex.size());
+    for (std::map<uint32, size_t>::const_iterator itr = gridIndex.begin(); itr != gridIndex.end(); ++itr)
+    {
+        order.push_back(itr->second);
+    }
+
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        GridPair const& a = grids[order[i]];
+        for (size_t j = i + 1; j < order.size(); ++j)
+        {
+            GridPair const& b = grids[order[j]];
+            if (int32(b.x_coord) - int32(a.x_coord) > gap)
+            {
+                break;
+            }
+
+            if (abs(int32(b.y_coord) - int32(a.y_coord)) <= gap)
+            {
+                size_t rootA = Root::Find(parent, order[i]);
+                size_t rootB = Root::Find(parent, order[j]);
+                if (rootA != rootB)
+                {
+                    parent[rootB] = rootA;
+                }
+            }
+        }
+    }
+
+    std::map<size_t, size_t> regionOfRoot;
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        size_t root = Root::Find(parent, sourceGrid[i]);
+
+        std::map<size_t, size_t>::const_iterator found = regionOfRoot.find(root);
+        if (found == regionOfRoot.end())
+        {
+            found = regionOfRoot.insert(std::make_pair(root, m_regions.size())).first;
+            m_regions.push_back(Region());
+        }
+
+        m_regions[found->second].push_back(sources[i]);
+    }
+
+    return m_regions.size() > 1;
+}
+
+void MapRegionUpdateJob::run()
+{
+    RefreshTickMSTime();                                    // helper threads sample their own tick time
+
+    for (;;)
+    {
+        size_t index = size_t(++m_nextRegion - 1);
+        if (index >= m_regions.size())
+        {
+            break;
+        }
+
+        m_map.UpdateRegion(m_regions[index], m_diff, *m_map.m_regionCellMarks[index]);
+
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        if (++m_finishedRegions == m_regions.size())
+        {
+            m_condition.broadcast();
+        }
+    }
+}
+
+void MapRegionUpdateJob::WaitForCompletion()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    while (m_finishedRegions < m_regions.size())
+    {
+        m_condition.wait();
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef _MAP_REGION_UPDATE_H_INCLUDED
+#define _MAP_REGION_UPDATE_H_INCLUDED
+
+#include "Common.h"
+#include "Threading.h"
+
+#include <ace/Method_Request.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+
+class Map;
+class WorldObject;
+
+/**
+ * One tick of a parallel region update of a map, see Map::UpdateActiveCellsByRegions.
+ *
+ * run() may be entered by any number of threads, each takes the next region not yet
+ * claimed until all regions are done. The job is reference counted because helper
+ * requests can be dequeued by the pool after the owning map already moved on.
+ */
+class MapRegionUpdateJob : public ACE_Based::Runnable
+{
+    public:
+        typedef std::vector<WorldObject*> Region;
+
+        class HelperRequest : public ACE_Method_Request
+        {
+            public:
+                explicit HelperRequest(MapRegionUpdateJob* job) : m_job(job) { m_job->incReference(); }
+                ~HelperRequest() { m_job->decReference(); }
+
+                int call() override
+                {
+                    m_job->run();
+                    return 0;
+                }
+
+            private:
+                MapRegionUpdateJob* m_job;
+        };
+
+        MapRegionUpdateJob(Map& map, uint32 diff);
+
+        // group the players and active objects of the map, false if there is nothing to split
+        bool BuildRegions();
+        size_t GetRegionCount() const { return m_regions.size(); }
+
+        void run() override;
+        void WaitForCompletion();
+
+    private:
+        Map& m_map;
+        uint32 m_diff;
+        std::vector<Region> m_regions;
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nextRegion;
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_condition;
+        size_t m_finishedRegions;
+};
+
+#endif //_MAP_REGION_UPDATE_H_INCLUDED
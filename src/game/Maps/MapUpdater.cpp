@@ -26,6 +26,7 @@
 #include "DelayExecutor.h"
 #include "Map.h"
 #include "DatabaseEnv.h"
+#include "Timer.h"
 
 #include <ace/Guard_T.h>
 #include <ace/Method_Request.h>
@@ -47,14 +48,17 @@ class MapUpdateRequest : public ACE_Method_Request
 
         virtual int call()
         {
+            uint32 startTime = getMSTime();
             m_map.Update (m_diff);
+            m_map.SetLastUpdateDuration(GetMSTimeDiffToNow(startTime));
             m_updater.update_finished();
             return 0;
         }
 };
 
 MapUpdater::MapUpdater():
-m_executor(), m_mutex(), m_condition(m_mutex), pending_requests(0)
+m_executor(), m_stealingExecutor(), m_scheduler(MAP_UPDATE_SCHEDULER_QUEUE), m_threadCount(0),
+m_mutex(), m_condition(m_mutex), pending_requests(0)
 {
 }
 
@@ -63,8 +67,18 @@ MapUpdater::~MapUpdater()
     deactivate();
 }
 
-int MapUpdater::activate(size_t num_threads)
+int MapUpdater::activate(size_t num_threads, MapUpdateScheduler scheduler, std::string const& cpus)
 {
+    m_scheduler = scheduler;
+    m_threadCount = num_threads;
+
+    if (m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING)
+    {
+        m_stealingExecutor.set_affinity(cpus);
+        return m_stealingExecutor._activate((int)num_threads);
+    }
+
+    m_executor.set_affinity(cpus);
     return m_executor._activate((int)num_threads);
 }
 
@@ -72,11 +86,22 @@ int MapUpdater::deactivate()
 {
     wait();
 
+    if (m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING)
+    {
+        return m_stealingExecutor.deactivate();
+    }
+
     return m_executor.deactivate();
 }
 
 int MapUpdater::wait()
 {
+    // work stealing backend holds the scheduled maps back until the whole tick is known
+    if (m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING)
+    {
+        m_stealingExecutor.dispatch();
+    }
+
     ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, -1);
 
     while (pending_requests > 0)
@@ -91,7 +116,29 @@ int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
 
     ++pending_requests;
 
-    if (m_executor.execute(new MapUpdateRequest(map, *this, diff)) == -1)
+    int result;
+    if (m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING)
+    {
+        // continents keep their worker so their grids stay in the caches (and memory node) of the same CPU
+        int worker = -1;
+        if (map.IsContinent())
+        {
+            std::map<uint32, int>::const_iterator itr = m_stickyWorkers.find(map.GetId());
+            if (itr == m_stickyWorkers.end())
+            {
+                itr = m_stickyWorkers.insert(std::make_pair(map.GetId(), int(m_stickyWorkers.size() % m_threadCount))).first;
+            }
+            worker = itr->second;
+        }
+
+        result = m_stealingExecutor.execute(new MapUpdateRequest(map, *this, diff), map.GetLastUpdateDuration(), worker);
+    }
+    else
+    {
+        result = m_executor.execute(new MapUpdateRequest(map, *this, diff));
+    }
+
+    if (result == -1)
     {
         ACE_DEBUG((LM_ERROR, ACE_TEXT("(%t) \n"), ACE_TEXT("Failed to schedule Map Update")));
 
@@ -102,8 +149,23 @@ int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
     return 0;
 }
 
+int MapUpdater::schedule_task(ACE_Method_Request* rq)
+{
+    if (m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING)
+    {
+        return m_stealingExecutor.execute_now(rq);
+    }
+
+    return m_executor.execute(rq);
+}
+
 bool MapUpdater::activated()
 {
+    if (m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING)
+    {
+        return m_stealingExecutor.activated();
+    }
+
     return m_executor.activated();
 }
 
@@ -29,9 +29,20 @@
 #include <ace/Condition_Thread_Mutex.h>
 
 #include "DelayExecutor.h"
+#include "WorkStealingExecutor.h"
+
+#include <map>
+#include <string>
 
 class Map;
 
+enum MapUpdateScheduler
+{
+    MAP_UPDATE_SCHEDULER_QUEUE          = 0,                // single shared activation queue (DelayExecutor)
+    MAP_UPDATE_SCHEDULER_WORK_STEALING  = 1,                // per-thread deques, most expensive maps first
+    MAX_MAP_UPDATE_SCHEDULER
+};
+
 class MapUpdater
 {
     public:
@@ -43,9 +54,15 @@ class MapUpdater
 
         int schedule_update(Map& map, ACE_UINT32 diff);
 
+        // run a request on the update threads without waiting for it in wait()
+        int schedule_task(ACE_Method_Request* rq);
+
+        size_t thread_count() const { return m_threadCount; }
+
         int wait();
 
-        int activate(size_t num_threads);
+        // cpus: CPU list the update threads are pinned to, empty to leave them to the OS
+        int activate(size_t num_threads, MapUpdateScheduler scheduler = MAP_UPDATE_SCHEDULER_QUEUE, std::string const& cpus = "");
 
         int deactivate();
 
@@ -54,9 +71,13 @@ class MapUpdater
     private:
 
         DelayExecutor m_executor;
+        WorkStealingExecutor m_stealingExecutor;
+        MapUpdateScheduler m_scheduler;
+        size_t m_threadCount;
         ACE_Thread_Mutex m_mutex;
         ACE_Condition_Thread_Mutex m_condition;
         size_t pending_requests;
+        std::map<uint32, int> m_stickyWorkers;              // continent map id -> worker it is always queued at
 
         void update_finished();
 };
@@ -0,0 +1,63 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "SessionUpdate.h"
+#include "WorldSession.h"
+
+#include <ace/Guard_T.h>
+
+SessionUpdateJob::SessionUpdateJob()
+    : m_nextSession(0), m_lock(), m_condition(m_lock), m_finishedSessions(0)
+{
+}
+
+void SessionUpdateJob::run()
+{
+    for (;;)
+    {
+        size_t index = size_t(++m_nextSession - 1);
+        if (index >= m_sessions.size())
+        {
+            break;
+        }
+
+        m_sessions[index]->UpdateSessionSafe();
+
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        if (++m_finishedSessions == m_sessions.size())
+        {
+            m_condition.broadcast();
+        }
+    }
+}
+
+void SessionUpdateJob::WaitForCompletion()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    while (m_finishedSessions < m_sessions.size())
+    {
+        m_condition.wait();
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef _SESSION_UPDATE_H_INCLUDED
+#define _SESSION_UPDATE_H_INCLUDED
+
+#include "Common.h"
+#include "Threading.h"
+
+#include <ace/Method_Request.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+
+class WorldSession;
+
+/**
+ * Handles the session-safe packets (see PROCESS_SESSIONSAFE) of all sessions in the
+ * parallel phase of World::UpdateSessions.
+ *
+ * run() may be entered by any number of threads, each taking the next session not yet
+ * claimed, so a session is only ever handled by one thread. Everything else stays in the
+ * serial pass that follows. The job is reference counted because helper requests can be
+ * dequeued after the world thread moved on.
+ */
+class SessionUpdateJob : public ACE_Based::Runnable
+{
+    public:
+        class HelperRequest : public ACE_Method_Request
+        {
+            public:
+                explicit HelperRequest(SessionUpdateJob* job) : m_job(job) { m_job->incReference(); }
+                ~HelperRequest() { m_job->decReference(); }
+
+                int call() override
+                {
+                    m_job->run();
+                    return 0;
+                }
+
+            private:
+                SessionUpdateJob* m_job;
+        };
+
+        SessionUpdateJob();
+
+        void AddSession(WorldSession* session) { m_sessions.push_back(session); }
+        size_t GetSessionCount() const { return m_sessions.size(); }
+        void Reserve(size_t count) { m_sessions.reserve(count); }
+
+        void run() override;
+        void WaitForCompletion();
+
+    private:
+        std::vector<WorldSession*> m_sessions;
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nextSession;
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_condition;
+        size_t m_finishedSessions;
+};
+
+#endif //_SESSION_UPDATE_H_INCLUDED
@@ -0,0 +1,96 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef _UPDATE_PACKET_BUILD_H_INCLUDED
+#define _UPDATE_PACKET_BUILD_H_INCLUDED
+
+#include "Common.h"
+#include "Threading.h"
+#include "WorldPacket.h"
+
+#include <ace/Method_Request.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+
+class Player;
+class UpdateData;
+
+/**
+ * Builds (and compresses) the update object packets of one Map::SendObjectUpdates call.
+ *
+ * The update blocks are collected by the map thread first, run() then turns them into
+ * packets and may be entered by any number of threads, each taking the next receiver not
+ * yet claimed. Sending stays on the map thread, see Map::SendObjectUpdates. The job is
+ * reference counted because helper requests can be dequeued after the map moved on.
+ */
+class UpdatePacketBuildJob : public ACE_Based::Runnable
+{
+    public:
+        class HelperRequest : public ACE_Method_Request
+        {
+            public:
+                explicit HelperRequest(UpdatePacketBuildJob* job) : m_job(job) { m_job->incReference(); }
+                ~HelperRequest() { m_job->decReference(); }
+
+                int call() override
+                {
+                    m_job->run();
+                    return 0;
+                }
+
+            private:
+                UpdatePacketBuildJob* m_job;
+        };
+
+        struct Entry
+        {
+            Entry(Player* p, UpdateData* d) : player(p), data(d) {}
+
+            Player* player;
+            UpdateData* data;                               // owned by the caller, must outlive WaitForCompletion()
+            WorldPacket packet;
+        };
+
+        UpdatePacketBuildJob();
+
+        void AddReceiver(Player* player, UpdateData* data) { m_entries.push_back(Entry(player, data)); }
+        size_t GetReceiverCount() const { return m_entries.size(); }
+
+        // only valid after WaitForCompletion()
+        std::vector<Entry>& GetEntries() { return m_entries; }
+
+        void run() override;
+        void WaitForCompletion();
+
+    private:
+        std::vector<Entry> m_entries;
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nextEntry;
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_condition;
+        size_t m_finishedEntries;
+};
+
+#endif //_UPDATE_PACKET_BUILD_H_INCLUDED
@@ -527,6 +527,8 @@ void MotionMaster::MoveFlyOrLand(uint32 id, float x, float y, float z, bool lift
 
 void MotionMaster::Mutate(MovementGenerator* m)
 {
+    m_owner->WakeUp();
+
     if (!empty())
     {
         switch (top()->GetMovementGeneratorType())
@@ -24,11 +24,29 @@
 
 #include "MovementGenerator.h"
 #include "Unit.h"
+#include "Utilities/ObjectPool.h"
 
 MovementGenerator::~MovementGenerator()
 {
 }
 
+static ObjectPool& GetMovementGeneratorPool()
+{
+    // never destroyed, see ObjectPool; big enough for all generators of the core
+    static ObjectPool* pool = new ObjectPool("MovementGenerator", 128);
+    return *pool;
+}
+
+void* MovementGenerator::operator new(size_t size)
+{
+    return GetMovementGeneratorPool().Allocate(size);
+}
+
+void MovementGenerator::operator delete(void* ptr, size_t size)
+{
+    GetMovementGeneratorPool().Release(ptr, size);
+}
+
 bool MovementGenerator::IsActive(Unit& u)
 {
     // When movement generator list modified from Update movegen object erase delayed,
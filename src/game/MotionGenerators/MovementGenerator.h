@@ -39,6 +39,10 @@ class MovementGenerator
     public:
         virtual ~MovementGenerator();
 
+        // every motion master push creates a generator, keep them in per thread free lists
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         // called before adding movement generator to motion stack
         virtual void Initialize(Unit&) = 0;
         // called aftre remove movement generator from motion stack
@@ -30,6 +30,64 @@
 #include "Map.h"
 #include "PathFinder.h"
 #include "Log.h"
+#include "Metrics.h"
+
+////////////////// PathCache //////////////////
+PathCache::Entry* PathCache::GetSlot(dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter)
+{
+    uint32 hash = uint32(startPoly) * 0x9E3779B1 ^ uint32(endPoly) * 0x85EBCA6B ^ filter.getIncludeFlags() ^ (uint32(filter.getExcludeFlags()) << 16);
+    return &m_entries[(hash ^ (hash >> 16)) & (PATH_CACHE_SIZE - 1)];
+}
+
+bool PathCache::Find(dtNavMesh const* navMesh, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef* path, uint32& length)
+{
+    MapRegionGuard guard(m_map);
+
+    if (m_entries.empty())
+    {
+        return false;
+    }
+
+    Entry const* entry = GetSlot(startPoly, endPoly, filter);
+    if (entry->startPoly != startPoly || entry->endPoly != endPoly || entry->includeFlags != filter.getIncludeFlags() ||
+        entry->excludeFlags != filter.getExcludeFlags() || getMSTimeDiff(entry->time, getTickMSTime()) > PATH_CACHE_TIME)
+    {
+        return false;
+    }
+
+    // a tile on the way was unloaded or replaced since
+    for (uint32 i = 0; i < entry->length; ++i)
+    {
+        if (!navMesh->isValidPolyRef(entry->path[i]))
+        {
+            return false;
+        }
+    }
+
+    memcpy(path, entry->path, entry->length * sizeof(dtPolyRef));
+    length = entry->length;
+    return true;
+}
+
+void PathCache::Store(dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef const* path, uint32 length)
+{
+    MapRegionGuard guard(m_map);
+
+    if (m_entries.empty())
+    {
+        // value initialized, all slots empty
+        m_entries.resize(PATH_CACHE_SIZE);
+    }
+
+    Entry* entry = GetSlot(startPoly, endPoly, filter);
+    entry->startPoly = startPoly;
+    entry->endPoly = endPoly;
+    entry->includeFlags = filter.getIncludeFlags();
+    entry->excludeFlags = filter.getExcludeFlags();
+    entry->time = getTickMSTime();
+    entry->length = std::min<uint32>(length, MAX_PATH_LENGTH);
+    memcpy(entry->path, path, entry->length * sizeof(dtPolyRef));
+}
 
 ////////////////// PathFinder //////////////////
 PathFinder::PathFinder(const Unit* owner) :
@@ -40,6 +98,7 @@ PathFinder::PathFinder(const Unit* owner) :
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathFinder for %s \n", m_sourceUnit->GetGuidStr().c_str());
 
     memset(m_pathPolyRefs, 0, sizeof(m_pathPolyRefs));
+    memset(m_pathEndPoint, 0, sizeof(m_pathEndPoint));
 
     uint32 mapId = m_sourceUnit->GetMapId();
 
@@ -47,7 +106,6 @@ PathFinder::PathFinder(const Unit* owner) :
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
         m_navMesh = mmap->GetNavMesh(mapId);
-        m_navMeshQuery = mmap->GetNavMeshQuery(mapId, m_sourceUnit->GetInstanceId());
     }
 
     createFilter();
@@ -60,6 +118,9 @@ PathFinder::~PathFinder()
 
 bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest)
 {
+    static MetricCounter& calculateMetric = sMetrics.GetCounter("mangos_path_calculations_total", "Path calculations requested");
+    calculateMetric.Inc();
+
     float x, y, z;
     m_sourceUnit->GetPosition(x, y, z);
 
@@ -76,6 +137,9 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
 
     m_forceDestination = forceDest;
 
+    // queries are per thread, the owner may be updated by another map thread than at the last calculate()
+    m_navMeshQuery = m_navMesh ? MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(m_sourceUnit->GetMapId()) : NULL;
+
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %s \n", m_sourceUnit->GetGuidStr().c_str());
 
     // make sure navMesh works - we can run on map w/o mmap
@@ -276,6 +340,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
 
         m_pathPolyRefs[0] = startPoly;
         m_polyLength = 1;
+        dtVcopy(m_pathEndPoint, endPoint);
 
         m_type = farFromPoly ? PATHFIND_INCOMPLETE : PATHFIND_NORMAL;
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: path type %d for %s\n", m_type, m_sourceUnit->GetGuidStr().c_str());
@@ -329,6 +394,19 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // so we have atleast part of poly-path ready
 
         m_polyLength -= pathStartIndex;
+        memmove(m_pathPolyRefs, m_pathPolyRefs + pathStartIndex, m_polyLength * sizeof(dtPolyRef));
+
+        // target moved only a bit: slide the path end after it, no search needed
+        if (moveTargetAlongSurface(endPoly, endPoint))
+        {
+            DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: path end moved along surface, m_polyLength=%u for %s\n",
+                             m_polyLength, m_sourceUnit->GetGuidStr().c_str());
+
+            m_type = (m_type & PATHFIND_INCOMPLETE) ? PATHFIND_INCOMPLETE : PATHFIND_NORMAL;
+            dtVcopy(m_pathEndPoint, endPoint);
+            BuildPointPath(startPoint, endPoint);
+            return;
+        }
 
         // try to adjust the suffix of the path instead of recalculating entire length
         // at given interval the target can not get too far from its last location
@@ -338,7 +416,6 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // take ~80% of the original length
         // TODO : play with the values here
         uint32 prefixPolyLength = uint32(m_polyLength * 0.8f + 0.5f);
-        memmove(m_pathPolyRefs, m_pathPolyRefs + pathStartIndex, prefixPolyLength * sizeof(dtPolyRef));
 
         dtPolyRef suffixStartPoly = m_pathPolyRefs[prefixPolyLength - 1];
 
@@ -398,23 +475,38 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // free and invalidate old path data
         clear();
 
-        dtResult = m_navMeshQuery->findPath(
-                       startPoly,          // start polygon
-                       endPoly,            // end polygon
-                       startPoint,         // start position
-                       endPoint,           // end position
-                       &m_filter,           // polygon search filter
-                       m_pathPolyRefs,     // [out] path
-                       (int*)&m_polyLength,
-                       MAX_PATH_LENGTH);   // max number of polygons in output path
-
-        if (!m_polyLength || dtStatusFailed(dtResult))
+        // another unit may have searched the same polygons just before
+        PathCache& cache = m_sourceUnit->GetMap()->GetPathCache();
+        if (cache.Find(m_navMesh, startPoly, endPoly, m_filter, m_pathPolyRefs, m_polyLength))
         {
-            // only happens if we passed bad data to findPath(), or navmesh is messed up
-            sLog.outError("Path Build failed: 0 length path for %s", m_sourceUnit->GetGuidStr().c_str());
-            BuildShortcut();
-            m_type = PATHFIND_NOPATH;
-            return;
+            DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: cached poly path for %s\n", m_sourceUnit->GetGuidStr().c_str());
+        }
+        else
+        {
+            dtResult = m_navMeshQuery->findPath(
+                           startPoly,          // start polygon
+                           endPoly,            // end polygon
+                           startPoint,         // start position
+                           endPoint,           // end position
+                           &m_filter,           // polygon search filter
+                           m_pathPolyRefs,     // [out] path
+                           (int*)&m_polyLength,
+                           MAX_PATH_LENGTH);   // max number of polygons in output path
+
+            if (!m_polyLength || dtStatusFailed(dtResult))
+            {
+                // only happens if we passed bad data to findPath(), or navmesh is messed up
+                sLog.outError("Path Build failed: 0 length path for %s", m_sourceUnit->GetGuidStr().c_str());
+                BuildShortcut();
+                m_type = PATHFIND_NOPATH;
+                return;
+            }
+
+            // partial paths depend on the exact end point, only complete ones are shared
+            if (m_pathPolyRefs[m_polyLength - 1] == endPoly)
+            {
+                cache.Store(startPoly, endPoly, m_filter, m_pathPolyRefs, m_polyLength);
+            }
         }
     }
 
@@ -429,9 +521,34 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     }
 
     // generate the point-path out of our up-to-date poly-path
+    dtVcopy(m_pathEndPoint, endPoint);
     BuildPointPath(startPoint, endPoint);
 }
 
+bool PathFinder::moveTargetAlongSurface(dtPolyRef endPoly, const float* endPoint)
+{
+    if (!m_polyLength || dtVdistSqr(m_pathEndPoint, endPoint) > PATH_REUSE_TARGET_MOVE * PATH_REUSE_TARGET_MOVE)
+    {
+        return false;
+    }
+
+    // same as dtPathCorridor::moveTargetPosition, walk from the old end towards the new one
+    float result[VERTEX_SIZE];
+    dtPolyRef visited[PATH_REUSE_MAX_VISITED];
+    int nvisited = 0;
+    dtStatus dtResult = m_navMeshQuery->moveAlongSurface(m_pathPolyRefs[m_polyLength - 1], m_pathEndPoint, endPoint, &m_filter,
+                        result, visited, &nvisited, PATH_REUSE_MAX_VISITED);
+
+    // the walk stops at walls and ledges, then the target is not reachable that way
+    if (dtStatusFailed(dtResult) || !nvisited || visited[nvisited - 1] != endPoly)
+    {
+        return false;
+    }
+
+    m_polyLength = fixupCorridorEnd(m_pathPolyRefs, m_polyLength, MAX_PATH_LENGTH, visited, nvisited);
+    return true;
+}
+
 void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
 {
     float pathPoints[MAX_POINT_PATH_LENGTH * VERTEX_SIZE];
@@ -653,6 +770,49 @@ uint32 PathFinder::fixupCorridor(dtPolyRef* path, uint32 npath, uint32 maxPath,
     return req + size;
 }
 
+uint32 PathFinder::fixupCorridorEnd(dtPolyRef* path, uint32 npath, uint32 maxPath,
+                                    const dtPolyRef* visited, uint32 nvisited)
+{
+    int32 furthestPath = -1;
+    int32 furthestVisited = -1;
+
+    // Find the first path polygon the end walked over, the target may have moved back along the path.
+    for (uint32 i = 0; i < npath; ++i)
+    {
+        bool found = false;
+        for (int32 j = nvisited - 1; j >= 0; --j)
+        {
+            if (path[i] == visited[j])
+            {
+                furthestPath = i;
+                furthestVisited = j;
+                found = true;
+            }
+        }
+        if (found)
+        {
+            break;
+        }
+    }
+
+    // If no intersection found just return current path.
+    if (furthestPath == -1 || furthestVisited == -1)
+    {
+        return npath;
+    }
+
+    // Concatenate paths.
+    uint32 ppos = furthestPath + 1;
+    uint32 vpos = furthestVisited + 1;
+    uint32 count = std::min(nvisited - vpos, maxPath - ppos);
+    if (count)
+    {
+        memcpy(path + ppos, visited + vpos, count * sizeof(dtPolyRef));
+    }
+
+    return ppos + count;
+}
+
 bool PathFinder::getSteerTarget(const float* startPos, const float* endPos,
                                 float minTargetDist, const dtPolyRef* path, uint32 pathSize,
                                 float* steerPos, unsigned char& steerPosFlag, dtPolyRef& steerPosRef)
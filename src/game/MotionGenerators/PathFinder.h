@@ -35,6 +35,7 @@ using Movement::Vector3;
 using Movement::PointsArray;
 
 class Unit;
+class Map;
 
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
@@ -49,6 +50,47 @@ class Unit;
 #define VERTEX_SIZE       3
 #define INVALID_POLYREF   0
 
+// a target that moved less than this from the end of the old path gets the path end slid after it
+#define PATH_REUSE_TARGET_MOVE  10.0f
+#define PATH_REUSE_MAX_VISITED  16
+
+#define PATH_CACHE_SIZE         64      // power of two
+#define PATH_CACHE_TIME         5000    // ms a cached poly path is reused
+
+/**
+ * Recently found poly paths of one map, keyed on start/end polygon and filter.
+ *
+ * Units of a pack chasing the same target mostly stand on the same polygon,
+ * so the search of the first one is reused by the others. Entries are checked
+ * against the navmesh before use, polys of unloaded tiles are invalid. Access
+ * is serialized with MapRegionGuard while grid regions update in parallel.
+ */
+class PathCache
+{
+    public:
+        explicit PathCache(Map const* map) : m_map(map) {}
+
+        bool Find(dtNavMesh const* navMesh, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef* path, uint32& length);
+        void Store(dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef const* path, uint32 length);
+
+    private:
+        struct Entry
+        {
+            dtPolyRef startPoly;
+            dtPolyRef endPoly;
+            uint16 includeFlags;
+            uint16 excludeFlags;
+            uint32 time;
+            uint32 length;
+            dtPolyRef path[MAX_PATH_LENGTH];
+        };
+
+        Entry* GetSlot(dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter);
+
+        Map const* m_map;
+        std::vector<Entry> m_entries;                       // allocated at the first stored path
+};
+
 enum PathType
 {
     PATHFIND_BLANK          = 0x0000,   // path not built yet
@@ -93,6 +135,7 @@ class PathFinder
         bool           m_useStraightPath;  // type of path will be generated
         bool           m_forceDestination; // when set, we will always arrive at given point
         uint32         m_pointPathLimit;   // limit point path size; min(this, MAX_POINT_PATH_LENGTH)
+        float          m_pathEndPoint[VERTEX_SIZE]; // end of the current poly path, detour coordinates
 
         Vector3        m_startPosition;    // {x, y, z} of current location
         Vector3        m_endPosition;      // {x, y, z} of the destination
@@ -100,7 +143,7 @@ class PathFinder
 
         const Unit* const       m_sourceUnit;       // the unit that is moving
         const dtNavMesh*        m_navMesh;          // the nav mesh
-        const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
+        const dtNavMeshQuery*   m_navMeshQuery;     // the calling thread's nav mesh query, taken again by every calculate()
 
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
 
@@ -133,6 +176,9 @@ class PathFinder
         // smooth path aux functions
         uint32 fixupCorridor(dtPolyRef* path, uint32 npath, uint32 maxPath,
                              const dtPolyRef* visited, uint32 nvisited);
+        uint32 fixupCorridorEnd(dtPolyRef* path, uint32 npath, uint32 maxPath,
+                                const dtPolyRef* visited, uint32 nvisited);
+        bool moveTargetAlongSurface(dtPolyRef endPoly, const float* endPoint);
         bool getSteerTarget(const float* startPos, const float* endPos, float minTargetDist,
                             const dtPolyRef* path, uint32 pathSize, float* steerPos,
                             unsigned char& steerPosFlag, dtPolyRef& steerPosRef);
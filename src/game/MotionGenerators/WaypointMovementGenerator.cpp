@@ -74,10 +74,22 @@ void WaypointMovementGenerator<Creature>::LoadPath(Creature& creature, int32 pat
         return;
     }
     // Initialize the i_currentNode to point to the first node
-    i_currentNode = i_path->begin()->first;
+    i_currentNode = i_path->At(0).first;
+    m_currentIndex = 0;
     m_lastReachedWaypoint = 0;
 }
 
+size_t WaypointMovementGenerator<Creature>::GetCurrentIndex()
+{
+    // Nodes added or removed with .wp commands shift the array, so revalidate the cached position
+    if (m_currentIndex >= i_path->size() || i_path->At(m_currentIndex).first != i_currentNode)
+    {
+        m_currentIndex = i_path->IndexOf(i_currentNode);
+    }
+
+    return m_currentIndex;
+}
+
 void WaypointMovementGenerator<Creature>::Initialize(Creature& creature)
 {
     creature.addUnitState(UNIT_STAT_ROAMING);
@@ -128,9 +140,9 @@ void WaypointMovementGenerator<Creature>::OnArrived(Creature& creature)
     creature.clearUnitState(UNIT_STAT_ROAMING_MOVE);
     m_isArrivalDone = true;
 
-    WaypointPath::const_iterator currPoint = i_path->find(i_currentNode);
-    MANGOS_ASSERT(currPoint != i_path->end());
-    WaypointNode const& node = currPoint->second;
+    size_t currIndex = GetCurrentIndex();
+    MANGOS_ASSERT(currIndex < i_path->size());
+    WaypointNode const& node = i_path->At(currIndex).second;
 
     if (node.script_id)
     {
@@ -218,10 +230,10 @@ void WaypointMovementGenerator<Creature>::StartMove(Creature& creature)
         return;
     }
 
-    WaypointPath::const_iterator currPoint = i_path->find(i_currentNode);
-    MANGOS_ASSERT(currPoint != i_path->end());
+    size_t currIndex = GetCurrentIndex();
+    MANGOS_ASSERT(currIndex < i_path->size());
 
-    if (WaypointBehavior* behavior = currPoint->second.behavior)
+    if (WaypointBehavior* behavior = i_path->At(currIndex).second.behavior)
     {
         if (behavior->model2 != 0)
         {
@@ -233,11 +245,11 @@ void WaypointMovementGenerator<Creature>::StartMove(Creature& creature)
     if (m_isArrivalDone)
     {
         bool reachedLast = false;
-        ++currPoint;
-        if (currPoint == i_path->end())
+        ++currIndex;
+        if (currIndex == i_path->size())
         {
             reachedLast = true;
-            currPoint = i_path->begin();
+            currIndex = 0;
         }
 
         // Inform AI
@@ -245,11 +257,11 @@ void WaypointMovementGenerator<Creature>::StartMove(Creature& creature)
         {
             if (!reachedLast)
             {
-                creature.AI()->MovementInform(EXTERNAL_WAYPOINT_MOVE_START + m_pathId, currPoint->first);
+                creature.AI()->MovementInform(EXTERNAL_WAYPOINT_MOVE_START + m_pathId, i_path->At(currIndex).first);
             }
             else
             {
-                creature.AI()->MovementInform(EXTERNAL_WAYPOINT_FINISHED_LAST + m_pathId, currPoint->first);
+                creature.AI()->MovementInform(EXTERNAL_WAYPOINT_FINISHED_LAST + m_pathId, i_path->At(currIndex).first);
             }
 
             if (creature.IsDead() || !creature.IsInWorld()) // Might have happened with above calls
@@ -258,14 +270,15 @@ void WaypointMovementGenerator<Creature>::StartMove(Creature& creature)
             }
         }
 
-        i_currentNode = currPoint->first;
+        i_currentNode = i_path->At(currIndex).first;
+        m_currentIndex = currIndex;
     }
 
     m_isArrivalDone = false;
 
     creature.addUnitState(UNIT_STAT_ROAMING_MOVE);
 
-    WaypointNode const& nextNode = currPoint->second;;
+    WaypointNode const& nextNode = i_path->At(currIndex).second;
     Movement::MoveSplineInit init(creature);
     init.MoveTo(nextNode.x, nextNode.y, nextNode.z, true);
 
@@ -405,8 +418,8 @@ bool WaypointMovementGenerator<Creature>::SetNextWaypoint(uint32 pointId)
         return false;
     }
 
-    WaypointPath::const_iterator currPoint = i_path->find(pointId);
-    if (currPoint == i_path->end())
+    size_t index = i_path->IndexOf(pointId);
+    if (index == i_path->size())
     {
         return false;
     }
@@ -419,6 +432,7 @@ bool WaypointMovementGenerator<Creature>::SetNextWaypoint(uint32 pointId)
 
     // Set the point
     i_currentNode = pointId;
+    m_currentIndex = index;
     return true;
 }
 
@@ -70,7 +70,7 @@ class WaypointMovementGenerator<Creature>
       public PathMovementBase<Creature, WaypointPath const*>
 {
     public:
-        WaypointMovementGenerator(Creature&) : i_nextMoveTime(0), m_isArrivalDone(false), m_lastReachedWaypoint(0) {}
+        WaypointMovementGenerator(Creature&) : i_nextMoveTime(0), m_isArrivalDone(false), m_lastReachedWaypoint(0), m_currentIndex(0) {}
         ~WaypointMovementGenerator() { i_path = NULL; }
         void Initialize(Creature& u);
         void Interrupt(Creature&);
@@ -99,9 +99,12 @@ class WaypointMovementGenerator<Creature>
         void OnArrived(Creature&);
         void StartMove(Creature&);
 
+        size_t GetCurrentIndex();
+
         TimeTracker i_nextMoveTime;
         bool m_isArrivalDone;
         uint32 m_lastReachedWaypoint;
+        size_t m_currentIndex;                              // position of i_currentNode in i_path
 
         int32 m_pathId;
         WaypointPathOrigin m_PathOrigin;
@@ -127,7 +130,7 @@ class FlightPathMovementGenerator
         bool Update(Player&, const uint32&);
         MovementGeneratorType GetMovementGeneratorType() const override { return FLIGHT_MOTION_TYPE; }
 
-        TaxiPathNodeList const& GetPath() { return *i_path; }
+        TaxiPathNodeList const& GetPath() const { return *i_path; }
         uint32 GetPathAtMapEnd() const;
         bool HasArrived() const { return (i_currentNode >= i_path->size()); }
         void SetCurrentNodeAfterTeleport();
@@ -49,6 +49,7 @@ class AggressorAI : public CreatureAI
         bool IsVisible(Unit*) const override;
 
         void UpdateAI(const uint32) override;
+        bool CanSleep() const override { return true; }
         static int Permissible(const Creature*);
 
     private:
@@ -61,6 +61,33 @@ AuctionHouseMgr::~AuctionHouseMgr()
     }
 }
 
+std::wstring const& AuctionHouseMgr::GetItemSearchName(ItemPrototype const* proto, int loc_idx)
+{
+    uint64 key = (uint64(uint32(loc_idx + 1)) << 32) | proto->ItemId;
+
+    ItemSearchNameMap::const_iterator itr = mItemSearchNames.find(key);
+    if (itr != mItemSearchNames.end())
+    {
+        return itr->second;
+    }
+
+    std::string name = proto->Name1;
+    sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
+
+    // a name that can't be converted is stored empty and never matches a search
+    std::wstring& wname = mItemSearchNames[key];
+    if (Utf8toWStr(name, wname))
+    {
+        wstrToLower(wname);
+    }
+    else
+    {
+        wname.clear();
+    }
+
+    return wname;
+}
+
 AuctionHouseObject* AuctionHouseMgr::GetAuctionsMap(AuctionHouseEntry const* house)
 {
     if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
@@ -592,6 +619,7 @@ void AuctionHouseObject::Update()
 
                 old->second->DeleteFromDB();
                 sAuctionMgr.RemoveAItem(old->second->itemGuidLow);
+                RemoveFromIndex(old->second);
                 delete old->second;
                 AuctionsMap.erase(old);
                 continue;
@@ -639,24 +667,33 @@ void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player
 {
     int loc_idx = player->GetSession()->GetSessionDbLocaleIndex();
 
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+    // only the item entries of the searched class/subclass are visited
+    AuctionClassIndex::const_iterator classBegin = m_classIndex.begin();
+    AuctionClassIndex::const_iterator classEnd = m_classIndex.end();
+    if (itemClass != 0xffffffff)
     {
-        AuctionEntry* Aentry = itr->second;
-        Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (!item)
+        if (itemSubClass != 0xffffffff)
         {
-            continue;
-        }
-
-        {
-            ItemPrototype const* proto = item->GetProto();
-
-            if (itemClass != 0xffffffff && proto->Class != itemClass)
+            classBegin = m_classIndex.find(ClassIndexKey(itemClass, itemSubClass));
+            classEnd = classBegin;
+            if (classEnd != m_classIndex.end())
             {
-                continue;
+                ++classEnd;
             }
+        }
+        else
+        {
+            classBegin = m_classIndex.lower_bound(ClassIndexKey(itemClass, 0));
+            classEnd = m_classIndex.lower_bound(ClassIndexKey(itemClass + 1, 0));
+        }
+    }
 
-            if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
+    for (AuctionClassIndex::const_iterator classItr = classBegin; classItr != classEnd; ++classItr)
+    {
+        for (std::set<uint32>::const_iterator entryItr = classItr->second.begin(); entryItr != classItr->second.end(); ++entryItr)
+        {
+            ItemPrototype const* proto = sObjectMgr.GetItemPrototype(*entryItr);
+            if (!proto)
             {
                 continue;
             }
@@ -676,41 +713,115 @@ void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player
                 continue;
             }
 
-            if (usable != 0x00)
+            if (usable != 0x00 && proto->Class == ITEM_CLASS_RECIPE)
             {
-                if (player->CanUseItem(item) != EQUIP_ERR_OK)
-                {
-                    continue;
-                }
-
-                if (proto->Class == ITEM_CLASS_RECIPE)
+                if (SpellEntry const* spell = sSpellStore.LookupEntry(proto->Spells[0].SpellId))
                 {
-                    if (SpellEntry const* spell = sSpellStore.LookupEntry(proto->Spells[0].SpellId))
+                    if (player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
                     {
-                        if (player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
-                        {
-                            continue;
-                        }
+                        continue;
                     }
                 }
             }
 
-            std::string name = proto->Name1;
-            sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
+            if (!wsearchedname.empty() && sAuctionMgr.GetItemSearchName(proto, loc_idx).find(wsearchedname) == std::wstring::npos)
+            {
+                continue;
+            }
 
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
+            AuctionTemplateIndex::const_iterator templateItr = m_templateIndex.find(*entryItr);
+            if (templateItr == m_templateIndex.end())
             {
                 continue;
             }
 
-            if (count < 50 && totalcount >= listfrom)
+            AuctionEntryMap const& auctions = templateItr->second;
+
+            // without the per item usable check whole entries outside the requested page are only counted
+            if (usable == 0x00 && (count >= 50 || totalcount + auctions.size() <= listfrom))
             {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
+                totalcount += auctions.size();
+                continue;
+            }
+
+            for (AuctionEntryMap::const_iterator itr = auctions.begin(); itr != auctions.end(); ++itr)
+            {
+                AuctionEntry* Aentry = itr->second;
+                Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
+                if (!item)
+                {
+                    continue;
+                }
+
+                if (usable != 0x00 && player->CanUseItem(item) != EQUIP_ERR_OK)
+                {
+                    continue;
+                }
+
+                if (count < 50 && totalcount >= listfrom)
+                {
+                    ++count;
+                    Aentry->BuildAuctionInfo(data);
+                }
+
+                ++totalcount;
             }
         }
+    }
+}
+
+void AuctionHouseObject::AddAuction(AuctionEntry* ah)
+{
+    MANGOS_ASSERT(ah);
+    AuctionsMap[ah->Id] = ah;
+
+    if (ItemPrototype const* proto = sObjectMgr.GetItemPrototype(ah->itemTemplate))
+    {
+        m_templateIndex[ah->itemTemplate][ah->Id] = ah;
+        m_classIndex[ClassIndexKey(proto->Class, proto->SubClass)].insert(ah->itemTemplate);
+    }
+}
+
+bool AuctionHouseObject::RemoveAuction(uint32 id)
+{
+    AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+    if (itr == AuctionsMap.end())
+    {
+        return false;
+    }
 
-        ++totalcount;
+    RemoveFromIndex(itr->second);
+    AuctionsMap.erase(itr);
+    return true;
+}
+
+void AuctionHouseObject::RemoveFromIndex(AuctionEntry const* ah)
+{
+    AuctionTemplateIndex::iterator templateItr = m_templateIndex.find(ah->itemTemplate);
+    if (templateItr == m_templateIndex.end())
+    {
+        return;
+    }
+
+    templateItr->second.erase(ah->Id);
+    if (!templateItr->second.empty())
+    {
+        return;
+    }
+
+    m_templateIndex.erase(templateItr);
+
+    if (ItemPrototype const* proto = sObjectMgr.GetItemPrototype(ah->itemTemplate))
+    {
+        AuctionClassIndex::iterator classItr = m_classIndex.find(ClassIndexKey(proto->Class, proto->SubClass));
+        if (classItr != m_classIndex.end())
+        {
+            classItr->second.erase(ah->itemTemplate);
+            if (classItr->second.empty())
+            {
+                m_classIndex.erase(classItr);
+            }
+        }
     }
 }
 
@@ -785,13 +896,10 @@ AuctionEntry* AuctionHouseObject::AddAuctionByGuid(AuctionHouseEntry const* auct
 
     sAuctionMgr.AddAItem(newItem);
 
-    CharacterDatabase.BeginTransaction();
-
+    // the caller batches the writes of several auctions in one transaction
     newItem->SaveToDB();
     AH->SaveToDB();
 
-    CharacterDatabase.CommitTransaction();
-
     return AH;
 }
 
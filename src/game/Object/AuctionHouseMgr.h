@@ -48,6 +48,7 @@
 
 class Item;
 class Player;
+struct ItemPrototype;
 class Unit;
 class WorldPacket;
 
@@ -121,16 +122,17 @@ class AuctionHouseObject
         typedef std::map<uint32, AuctionEntry*> AuctionEntryMap;
         typedef std::pair<AuctionEntryMap::const_iterator, AuctionEntryMap::const_iterator> AuctionEntryMapBounds;
 
+        /// auctions of each item entry, so search filters are checked once per item prototype
+        typedef std::map<uint32, AuctionEntryMap> AuctionTemplateIndex;
+        /// item entries on sale for each ClassIndexKey(class, subclass)
+        typedef std::map<uint32, std::set<uint32> > AuctionClassIndex;
+
         uint32 GetCount() { return AuctionsMap.size(); }
 
         AuctionEntryMap const& GetAuctions() const { return AuctionsMap; }
         AuctionEntryMapBounds GetAuctionsBounds() const {return AuctionEntryMapBounds(AuctionsMap.begin(), AuctionsMap.end()); }
 
-        void AddAuction(AuctionEntry* ah)
-        {
-            MANGOS_ASSERT(ah);
-            AuctionsMap[ah->Id] = ah;
-        }
+        void AddAuction(AuctionEntry* ah);
 
         AuctionEntry* GetAuction(uint32 id) const
         {
@@ -138,10 +140,7 @@ class AuctionHouseObject
             return itr != AuctionsMap.end() ? itr->second : NULL;
         }
 
-        bool RemoveAuction(uint32 id)
-        {
-            return AuctionsMap.erase(id);
-        }
+        bool RemoveAuction(uint32 id);
 
         void Update();
 
@@ -152,9 +151,16 @@ class AuctionHouseObject
                                    uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality,
                                    uint32& count, uint32& totalcount);
         AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout = 0, uint32 deposit = 0, Player* pl = NULL);
+        // saves without opening a transaction, callers batch several auctions in one
         AuctionEntry* AddAuctionByGuid(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout, uint32 lowguid);
     private:
+        static uint32 ClassIndexKey(uint32 itemClass, uint32 itemSubClass) { return (itemClass << 16) | itemSubClass; }
+
+        void RemoveFromIndex(AuctionEntry const* ah);
+
         AuctionEntryMap AuctionsMap;
+        AuctionTemplateIndex m_templateIndex;
+        AuctionClassIndex m_classIndex;
 };
 
 /**
@@ -201,6 +207,9 @@ class AuctionHouseMgr
         static uint32 GetAuctionHouseTeam(AuctionHouseEntry const* house);
         static AuctionHouseEntry const* GetAuctionHouseEntry(Unit* unit);
 
+        // lower case item name used by the auction search, cached since item names do not change at runtime
+        std::wstring const& GetItemSearchName(ItemPrototype const* proto, int loc_idx);
+
     public:
         // load first auction items, because of check if item exists, when loading
         void LoadAuctionItems();
@@ -215,6 +224,9 @@ class AuctionHouseMgr
         AuctionHouseObject  mAuctions[MAX_AUCTION_HOUSE_TYPE];
 
         ItemMap             mAitems;
+
+        typedef UNORDERED_MAP<uint64, std::wstring> ItemSearchNameMap;
+        ItemSearchNameMap   mItemSearchNames;
 };
 
 /// Convenience define to access the singleton object for the Auction House Manager
@@ -29,7 +29,7 @@
 #include "Errors.h"
 #include "Player.h"
 
-Camera::Camera(Player* pl) : m_owner(*pl), m_source(pl)
+Camera::Camera(Player* pl) : m_owner(*pl), m_source(pl), m_visibilityPending(false)
 {
     m_source->GetViewPoint().Attach(this);
 }
@@ -149,18 +149,66 @@ void Camera::UpdateVisibilityOf(WorldObject* target)
     m_owner.UpdateVisibilityOf(m_source, target);
 }
 
-void Camera::UpdateVisibilityOf(WorldObject* target, UpdateData& data, std::set<WorldObject*>& vis)
+void Camera::UpdateVisibilityOf(WorldObject* target, UpdateData& data, std::vector<WorldObject*>& vis)
 {
     m_owner.UpdateVisibilityOf(m_source, target, data, vis);
 }
 
 void Camera::UpdateVisibilityForOwner()
 {
+    m_visibilityPending = false;
+
     MaNGOS::VisibleNotifier notifier(*this);
     Cell::VisitAllObjects(m_source, notifier, m_source->GetMap()->GetVisibilityDistance(), false);
     notifier.Notify();
 }
 
+void Camera::UpdateVisibilityForOwner(std::vector<WorldObject*> const& objects)
+{
+    m_visibilityPending = false;
+
+    MaNGOS::VisibleNotifier notifier(*this);
+    notifier.Visit(objects);
+    notifier.Notify();
+}
+
+void Camera::RequestVisibilityUpdate()
+{
+    if (m_visibilityPending)
+    {
+        return;
+    }
+
+    m_visibilityPending = true;
+    m_source->GetMap()->AddPendingCamera(&m_owner);
+}
+
+uint64 Camera::GetVisibilityAreaKey() const
+{
+    // the cells Cell::VisitAllObjects walks depend only on the standing cell and the cell area of the radius
+    float x = m_source->GetPositionX();
+    float y = m_source->GetPositionY();
+    float radius = std::min(m_source->GetMap()->GetVisibilityDistance() + m_source->GetObjectBoundingRadius(), 333.0f);
+
+    CellPair standing = MaNGOS::ComputeCellPair(x, y);
+    if (standing.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+    {
+        return ~uint64(0);
+    }
+
+    CellArea area = Cell::CalculateCellArea(x, y, radius);
+
+    return uint64(standing.x_coord) | (uint64(standing.y_coord) << 10) |
+           (uint64(area.low_bound.x_coord) << 20) | (uint64(area.low_bound.y_coord) << 30) |
+           (uint64(area.high_bound.x_coord) << 40) | (uint64(area.high_bound.y_coord) << 50);
+}
+
+void Camera::GatherVisibleObjects(std::vector<WorldObject*>& objects) const
+{
+    MaNGOS::VisibleObjectsGatherer gatherer(objects);
+    Cell::VisitAllObjects(m_source, gatherer, m_source->GetMap()->GetVisibilityDistance(), false);
+}
+
 //////////////////
 
 ViewPoint::~ViewPoint()
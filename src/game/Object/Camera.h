@@ -54,13 +54,23 @@ class Camera
         // set view to camera's owner
         void ResetView(bool update_far_sight_field = true);
 
-        void UpdateVisibilityOf(WorldObject* obj, UpdateData& d, std::set<WorldObject*>& vis);
+        void UpdateVisibilityOf(WorldObject* obj, UpdateData& d, std::vector<WorldObject*>& vis);
         void UpdateVisibilityOf(WorldObject* obj);
 
         void ReceivePacket(WorldPacket* data);
 
         // updates visibility of worldobjects around viewpoint for camera's owner
         void UpdateVisibilityForOwner();
+        // same, for objects already gathered around an equal visibility area, see GetVisibilityAreaKey
+        void UpdateVisibilityForOwner(std::vector<WorldObject*> const& objects);
+
+        // queues UpdateVisibilityForOwner to the map update, repeated requests in one tick run a single pass
+        void RequestVisibilityUpdate();
+        bool IsVisibilityUpdatePending() const { return m_visibilityPending; }
+
+        // cameras with equal keys visit the same cells around their viewpoints
+        uint64 GetVisibilityAreaKey() const;
+        void GatherVisibleObjects(std::vector<WorldObject*>& objects) const;
 
     private:
         // called when viewpoint changes visibility state
@@ -71,6 +81,7 @@ class Camera
 
         Player& m_owner;
         WorldObject* m_source;
+        bool m_visibilityPending;
 
         void UpdateForCurrentViewPoint();
 
@@ -139,7 +150,7 @@ class ViewPoint
 
         void Call_UpdateVisibilityForOwner()
         {
-            CameraCall(&Camera::UpdateVisibilityForOwner);
+            CameraCall(&Camera::RequestVisibilityUpdate);
         }
 };
 
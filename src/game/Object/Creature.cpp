@@ -51,9 +51,11 @@
 #include "GridNotifiersImpl.h"
 #include "CellImpl.h"
 #include "movement/MoveSplineInit.h"
+#include "movement/MoveSpline.h"
 #include "CreatureLinkingMgr.h"
 #include "DisableMgr.h"
 #include "MovementGenerator.h"
+#include "Utilities/ObjectPool.h"
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
 #endif /* ENABLE_ELUNA */
@@ -151,8 +153,9 @@ Creature::Creature(CreatureSubtype subtype) : Unit(),
     loot(this),
     lootForPickPocketed(false), lootForBody(false), lootForSkin(false),
     m_groupLootTimer(0), m_groupLootId(0),
-    m_lootMoney(0), m_lootGroupRecipientId(0),
-    m_corpseRemoveTime(0), m_respawnTime(0), m_respawnDelay(25), m_corpseDelay(60), m_aggroDelay(0), m_respawnradius(5.0f),
+    m_lootMoney(0), m_lootGroupRecipientId(0), m_bodyLootSeed(0),
+    m_corpseRemoveTime(0), m_respawnTime(0), m_respawnDelay(25), m_corpseDelay(60), m_aggroDelay(0),
+    m_lodTimer(0), m_lodInterval(0), m_lodUpdateDiff(0), m_lodTimeDiff(0), m_lodHidden(false), m_sleeping(false), m_respawnradius(5.0f),
     m_subtype(subtype), m_defaultMovementType(IDLE_MOTION_TYPE), m_equipmentId(0),
     m_AlreadyCallAssistance(false), m_AlreadySearchedAssistance(false),
     m_AI_locked(false), m_IsDeadByDefault(false), m_temporaryFactionFlags(TEMPFACTION_NONE),
@@ -189,6 +192,23 @@ Creature::~Creature()
     i_AI = NULL;
 }
 
+static ObjectPool& GetCreaturePool()
+{
+    // never destroyed, see ObjectPool; covers pets, totems and summons as well
+    static ObjectPool* pool = new ObjectPool("Creature", 16 * 1024, 64, 64);
+    return *pool;
+}
+
+void* Creature::operator new(size_t size)
+{
+    return GetCreaturePool().Allocate(size);
+}
+
+void Creature::operator delete(void* ptr, size_t size)
+{
+    GetCreaturePool().Release(ptr, size);
+}
+
 void Creature::AddToWorld()
 {
 #ifdef ENABLE_ELUNA
@@ -198,6 +218,7 @@ void Creature::AddToWorld()
     ///- Register the creature for guid lookup
     if (!IsInWorld() && GetObjectGuid().IsCreature())
     {
+        MapRegionGuard guard(GetMap());
         GetMap()->GetObjectsStore().insert<Creature>(GetObjectGuid(), (Creature*)this);
     }
 
@@ -230,6 +251,7 @@ void Creature::RemoveFromWorld()
     ///- Remove the creature from the accessor
     if (IsInWorld() && GetObjectGuid().IsCreature())
     {
+        MapRegionGuard guard(GetMap());
         GetMap()->GetObjectsStore().erase<Creature>(GetObjectGuid(), (Creature*)NULL);
     }
 
@@ -419,9 +441,15 @@ bool Creature::InitEntry(uint32 Entry, Team team, CreatureData const* data /*=NU
     // check if we need to add swimming movement. TODO: i thing movement flags should be computed automatically at each movement of creature so we need a sort of UpdateMovementFlags() method
     if (cinfo->InhabitType & INHABIT_WATER &&                                   // check inhabit type water
         data &&                                                                 // check if there is data to get creature spawn pos
-        !(cinfo->ExtraFlags & CREATURE_FLAG_EXTRA_WALK_IN_WATER) &&             // check if creature is forced to walk (crabs, giant,...)
-        GetMap()->GetTerrain()->IsSwimmable(data->posX, data->posY, data->posZ, minfo->bounding_radius))  // check if creature is in water and have enough space to swim
-        m_movementInfo.AddMovementFlag(MOVEFLAG_SWIMMING);                      // add swimming movement
+        !(cinfo->ExtraFlags & CREATURE_FLAG_EXTRA_WALK_IN_WATER))               // check if creature is forced to walk (crabs, giant,...)
+    {
+        // check if creature is in water and have enough space to swim
+        CreatureSpawnHint const* hint = sObjectMgr.GetCreatureSpawnHint(GetGUIDLow(), data);
+        if (hint ? hint->swimDepth > minfo->bounding_radius : GetMap()->GetTerrain()->IsSwimmable(data->posX, data->posY, data->posZ, minfo->bounding_radius))
+        {
+            m_movementInfo.AddMovementFlag(MOVEFLAG_SWIMMING);                  // add swimming movement
+        }
+    }
 
     // checked at loading
     m_defaultMovementType = MovementGeneratorType(cinfo->MovementType);
@@ -588,8 +616,185 @@ uint32 Creature::ChooseDisplayId(const CreatureInfo* cinfo, const CreatureData*
     return display_id;
 }
 
+#define CREATURE_LOD_CHECK_TIME 1000
+
+bool Creature::IsLodExempt() const
+{
+    return IsActiveObject() || IsInCombat() || IsInEvadeMode() || !GetCharmerOrOwnerGuid().IsEmpty() ||
+           IsWorldBoss() || GetScriptId() || sWorld.isCreatureLodExempt(GetEntry());
+}
+
+bool Creature::IsMotionFrozen() const
+{
+    if (!m_lodHidden)
+    {
+        return false;
+    }
+
+    // only wandering around nobody can see, anything else has to go on
+    MovementGeneratorType type = i_motionMaster.GetCurrentMovementGeneratorType();
+    return type == IDLE_MOTION_TYPE || type == RANDOM_MOTION_TYPE;
+}
+
+// Returns false if this update is skipped. Otherwise the diffs hold all the time since the last real update.
+bool Creature::UpdateLevelOfDetail(uint32& update_diff, uint32& diff)
+{
+    uint32 farInterval = sWorld.getConfig(CONFIG_UINT32_CREATURE_LOD_FAR_INTERVAL);
+    if (!farInterval || IsLodExempt())
+    {
+        update_diff += m_lodUpdateDiff;
+        diff += m_lodTimeDiff;
+        m_lodUpdateDiff = 0;
+        m_lodTimeDiff = 0;
+        m_lodInterval = 0;
+        m_lodHidden = false;
+        m_lodTimer = 0;
+        return true;
+    }
+
+    if (m_lodTimer <= update_diff)
+    {
+        float nearDist = sWorld.getConfig(CONFIG_FLOAT_CREATURE_LOD_NEAR_DISTANCE);
+        float range = std::max(nearDist, GetMap()->GetVisibilityDistance());
+
+        MaNGOS::NearestCameraDistWorker worker(this, range);
+        Cell::VisitWorldObjects(this, worker, range);
+
+        m_lodHidden = !worker.i_found;
+        if (worker.i_dist < nearDist)
+        {
+            m_lodInterval = 0;
+        }
+        else if (m_lodHidden && sWorld.getConfig(CONFIG_UINT32_CREATURE_LOD_HIDDEN_INTERVAL))
+        {
+            m_lodInterval = sWorld.getConfig(CONFIG_UINT32_CREATURE_LOD_HIDDEN_INTERVAL);
+        }
+        else
+        {
+            m_lodInterval = farInterval;
+        }
+
+        m_lodTimer = CREATURE_LOD_CHECK_TIME;
+    }
+    else
+    {
+        m_lodTimer -= update_diff;
+    }
+
+    m_lodUpdateDiff += update_diff;
+    m_lodTimeDiff += diff;
+
+    if (m_lodUpdateDiff < m_lodInterval)
+    {
+        return false;
+    }
+
+    update_diff = m_lodUpdateDiff;
+    diff = m_lodTimeDiff;
+    m_lodUpdateDiff = 0;
+    m_lodTimeDiff = 0;
+    return true;
+}
+
+// True if an update would change nothing until some outside event happens
+bool Creature::CanSleep()
+{
+    if (!sWorld.getConfig(CONFIG_BOOL_CREATURE_IDLE_SLEEP) || IsLodExempt())
+    {
+        return false;
+    }
+
+    // lua scripts can add timed events at any time without waking the creature
+    if (sWorld.getConfig(CONFIG_BOOL_ELUNA_ENABLED))
+    {
+        return false;
+    }
+
+    if (m_subtype != CREATURE_SUBTYPE_GENERIC || m_IsDeadByDefault || m_aggroDelay || m_lastManaUseTimer)
+    {
+        return false;
+    }
+
+    if (getVictim() || !GetThreatManager().isThreatListEmpty() || !GetHostileRefManager().isEmpty())
+    {
+        return false;
+    }
+
+    if (GetHealth() < GetMaxHealth() || GetPower(GetPowerType()) < GetMaxPower(GetPowerType()))
+    {
+        return false;
+    }
+
+    if (!m_Events.Empty() || !m_deletedAuras.empty() || !m_deletedHolders.empty())
+    {
+        return false;
+    }
+
+    for (uint32 i = 0; i < CURRENT_MAX_SPELL; ++i)
+    {
+        if (GetCurrentSpell(i))
+        {
+            return false;
+        }
+    }
+
+    for (uint32 i = 0; i < MAX_REACTIVE; ++i)
+    {
+        if (m_reactiveTimer[i])
+        {
+            return false;
+        }
+    }
+
+    // auras running out or ticking need updates
+    for (SpellAuraHolderMap::const_iterator itr = m_spellAuraHolders.begin(); itr != m_spellAuraHolders.end(); ++itr)
+    {
+        SpellAuraHolder* holder = itr->second;
+        if (!holder->IsPermanent() || holder->IsAreaAura())
+        {
+            return false;
+        }
+
+        for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+        {
+            if (Aura* aura = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
+            {
+                if (aura->IsPeriodic())
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    if (i_motionMaster.GetCurrentMovementGeneratorType() != IDLE_MOTION_TYPE || !movespline->Finalized())
+    {
+        return false;
+    }
+
+    return AI() && AI()->CanSleep();
+}
+
+void Creature::WakeUp()
+{
+    if (!m_sleeping)
+    {
+        return;
+    }
+
+    m_sleeping = false;
+    // the time spent asleep is not handed to the first update
+    ResetUpdateTracker();
+}
+
 void Creature::Update(uint32 update_diff, uint32 diff)
 {
+    // far away creatures are updated less often, with the skipped time added up
+    if (!UpdateLevelOfDetail(update_diff, diff))
+    {
+        return;
+    }
+
     switch (m_deathState)
     {
         case JUST_ALIVED:
@@ -742,6 +947,11 @@ void Creature::Update(uint32 update_diff, uint32 diff)
                 break;
             }
             RegenerateAll(update_diff);
+
+            if (CanSleep())
+            {
+                m_sleeping = true;
+            }
             break;
         }
         default:
@@ -951,6 +1161,8 @@ bool Creature::AIM_Initialize()
         return false;
     }
 
+    WakeUp();
+
     CreatureAI* oldAI = i_AI;
     i_motionMaster.Initialize();
     i_AI = FactorySelector::selectAI(this);
@@ -974,6 +1186,15 @@ bool Creature::Create(uint32 guidlow, CreatureCreatePos& cPos, CreatureInfo cons
         return false;
     }
 
+    // the area of an unmoved DB spawn point is known in advance
+    if (data && GetPositionX() == data->posX && GetPositionY() == data->posY && GetPositionZ() == data->posZ)
+    {
+        if (CreatureSpawnHint const* hint = sObjectMgr.GetCreatureSpawnHint(guidlow, data))
+        {
+            SetAreaFlagHint(hint->areaFlag, hint->outdoors);
+        }
+    }
+
     // Notify the outdoor pvp script
     if (OutdoorPvP* outdoorPvP = sOutdoorPvPMgr.GetScript(GetZoneId()))
     {
@@ -1173,6 +1394,8 @@ void Creature::PrepareBodyLootState()
         // have normal loot
         if (GetCreatureInfo()->MaxLootGold > 0 || GetCreatureInfo()->LootId || (GetCreatureType() != CREATURE_TYPE_CRITTER && (GetCreatureInfo()->SkinningLootId && sWorld.getConfig(CONFIG_BOOL_CORPSE_EMPTY_LOOT_SHOW))))
         {
+            // the loot is rolled at the first loot request only, most corpses are never opened
+            m_bodyLootSeed = rand32();
             SetFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE);
             return;
         }
@@ -1648,13 +1871,14 @@ bool Creature::LoadFromDB(uint32 guidlow, Map* map)
     m_deathState = m_IsDeadByDefault ? DEAD : ALIVE;
 
     m_respawnTime  = map->GetPersistentState()->GetCreatureRespawnTime(GetGUIDLow());
+    CreatureSpawnHint const* hint = sObjectMgr.GetCreatureSpawnHint(guidlow, data);
 
     if (m_respawnTime > time(NULL))                         // not ready to respawn
     {
         m_deathState = DEAD;
         if (CanFly())
         {
-            float tz = GetMap()->GetTerrain()->GetHeightStatic(data->posX, data->posY, data->posZ, false);
+            float tz = hint ? hint->groundZ : GetMap()->GetTerrain()->GetHeightStatic(data->posX, data->posY, data->posZ, false);
             if (data->posZ - tz > 0.1)
             {
                 Relocate(data->posX, data->posY, tz);
@@ -1688,7 +1912,7 @@ bool Creature::LoadFromDB(uint32 guidlow, Map* map)
             // Just set to dead, so need to relocate like above
             if (CanFly())
             {
-                float tz = GetMap()->GetTerrain()->GetHeightStatic(data->posX, data->posY, data->posZ, false);
+                float tz = hint ? hint->groundZ : GetMap()->GetTerrain()->GetHeightStatic(data->posX, data->posY, data->posZ, false);
                 if (data->posZ - tz > 0.1)
                 {
                     Relocate(data->posX, data->posY, tz);
@@ -1879,6 +2103,8 @@ float Creature::GetAttackDistance(Unit const* pl) const
 
 void Creature::SetDeathState(DeathState s)
 {
+    WakeUp();
+
     if ((s == JUST_DIED && !m_IsDeadByDefault) || (s == JUST_ALIVED && m_IsDeadByDefault))
     {
         m_corpseRemoveTime = time(NULL) + m_corpseDelay; // the max/default time for corpse decay (before creature is looted/AllLootRemovedFromCorpse() is called)
@@ -2828,7 +3054,12 @@ std::string Creature::GetScriptName() const
 uint32 Creature::GetScriptId() const
 {
     // scripts bound to DB guid have priority over ones bound to creature entry
-    return sScriptMgr.GetBoundScriptId(SCRIPTED_UNIT, -int32(GetGUIDLow())) ? sScriptMgr.GetBoundScriptId(SCRIPTED_UNIT, -int32(GetGUIDLow())) : sScriptMgr.GetBoundScriptId(SCRIPTED_UNIT, GetEntry());
+    if (uint32 scriptId = sScriptMgr.GetBoundScriptId(SCRIPTED_UNIT, -int32(GetGUIDLow())))
+    {
+        return scriptId;
+    }
+
+    return sScriptMgr.GetBoundScriptId(SCRIPTED_UNIT, GetEntry());
 }
 
 VendorItemData const* Creature::GetVendorItems() const
@@ -31,6 +31,7 @@
 #include "LootMgr.h"
 #include "DBCEnums.h"
 #include "Cell.h"
+#include "Utilities/InternedString.h"
 
 #include <list>
 
@@ -239,6 +240,24 @@ struct CreatureData
     }
 };
 
+// terrain at the spawn point, precomputed by the spawn-hints tool to spare the queries of spawning
+struct CreatureSpawnHint
+{
+    float posX;                                             // spawn point the hint was computed for
+    float posY;
+    float posZ;
+    float groundZ;                                          // GetHeightStatic() without vmaps
+    float swimDepth;                                        // liquid above the ground, 0 out of liquid
+    uint16 areaFlag;
+    bool outdoors;
+
+    // the spawn point may have been moved since the hints were made
+    bool IsFor(CreatureData const* data) const
+    {
+        return fabs(data->posX - posX) < 0.05f && fabs(data->posY - posY) < 0.05f && fabs(data->posZ - posZ) < 0.05f;
+    }
+};
+
 enum SplineFlags
 {
     SPLINEFLAG_WALKMODE     = 0x0000100,
@@ -288,19 +307,19 @@ struct CreatureModelInfo
 
 struct CreatureLocale
 {
-    std::vector<std::string> Name;
-    std::vector<std::string> SubName;
+    std::vector<InternedString> Name;
+    std::vector<InternedString> SubName;
 };
 
 struct GossipMenuItemsLocale
 {
-    std::vector<std::string> OptionText;
-    std::vector<std::string> BoxText;
+    std::vector<InternedString> OptionText;
+    std::vector<InternedString> BoxText;
 };
 
 struct PointOfInterestLocale
 {
-    std::vector<std::string> IconName;
+    std::vector<InternedString> IconName;
 };
 
 enum InhabitTypeValues
@@ -519,6 +538,10 @@ class Creature : public Unit
         explicit Creature(CreatureSubtype subtype = CREATURE_SUBTYPE_GENERIC);
         virtual ~Creature();
 
+        // despawned creatures and their subclasses leave their memory to the next spawn of this thread
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         void AddToWorld() override;
         void RemoveFromWorld() override;
 
@@ -532,6 +555,11 @@ class Creature : public Unit
         char const* GetSubName() const { return GetCreatureInfo()->SubName; }
 
         void Update(uint32 update_diff, uint32 time) override;  // overwrite Unit::Update
+        bool IsMotionFrozen() const override;
+
+        // idle creatures are left out of the grid update until something wakes them
+        bool IsSleeping() const { return m_sleeping; }
+        void WakeUp() override;
 
         virtual void RegenerateAll(uint32 update_diff);
         uint32 GetEquipmentId() const { return m_equipmentId; }
@@ -693,6 +721,14 @@ class Creature : public Unit
         */
         void PrepareBodyLootState();
 
+        /**
+        * Seed drawn at death for the body loot. The loot itself is only rolled when the corpse is
+        * first opened, the seed makes the result the same as if it was rolled at the kill.
+        *
+        * \return uint32 Seed for seed_thread_rand().
+        */
+        uint32 GetBodyLootSeed() const { return m_bodyLootSeed; }
+
         /**
         * function returning the GUID of the loot recipient (a player GUID).
         *
@@ -849,6 +885,10 @@ class Creature : public Unit
     protected:
         bool MeetsSelectAttackingRequirement(Unit* pTarget, SpellEntry const* pSpellInfo, uint32 selectFlags) const;
 
+        bool IsLodExempt() const;
+        bool UpdateLevelOfDetail(uint32& update_diff, uint32& diff);
+        bool CanSleep();
+
         bool CreateFromProto(uint32 guidlow, CreatureInfo const* cinfo, Team team, const CreatureData* data = NULL, GameEventCreatureData const* eventData = NULL);
         bool InitEntry(uint32 entry, Team team = ALLIANCE, const CreatureData* data = NULL, GameEventCreatureData const* eventData = NULL);
 
@@ -862,6 +902,7 @@ class Creature : public Unit
         uint32 m_lootMoney;
         ObjectGuid m_lootRecipientGuid;                     // player who will have rights for looting if m_lootGroupRecipient==0 or group disbanded
         uint32 m_lootGroupRecipientId;                      // group who will have rights for looting if set and exist
+        uint32 m_bodyLootSeed;                              // drawn in PrepareBodyLootState, used when the loot is rolled
 
         /// Timers
         time_t m_corpseRemoveTime;                          // (secs) time for death or corpse disappearance
@@ -869,6 +910,14 @@ class Creature : public Unit
         uint32 m_respawnDelay;                              // (secs) delay between corpse disappearance and respawning
         uint32 m_corpseDelay;                               // (secs) delay between death and corpse disappearance
         uint32 m_aggroDelay;                                // (msecs)delay between respawn and aggro due to movement
+
+        /// Level of detail, far away creatures are updated less often
+        uint32 m_lodTimer;                                  // (msecs) time until the distance to the observers is checked again
+        uint32 m_lodInterval;                               // (msecs) update interval of the current tier, 0 for every tick
+        uint32 m_lodUpdateDiff;                             // (msecs) update_diff added up while updates were skipped
+        uint32 m_lodTimeDiff;                               // (msecs) time_diff added up while updates were skipped
+        bool m_lodHidden;                                   // no observer in visibility range
+        bool m_sleeping;                                    // idle, skipped by the grid update until woken up
         float m_respawnradius;
 
         time_t m_killedTime;                                // Exact time of the death.
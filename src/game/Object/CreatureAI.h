@@ -308,6 +308,12 @@ class CreatureAI
 
         ///== State checks =================================
 
+        /**
+         * Check if the AI has nothing to do while the creature idles out of combat
+         * Note: Only AIs without own timers may return true, a sleeping creature gets no UpdateAI calls
+         */
+        virtual bool CanSleep() const { return false; }
+
         /**
          * Check if unit is visible for MoveInLineOfSight
          * Note: This check is by default only the state-depending (visibility, range), NOT LineOfSight
@@ -128,6 +128,13 @@ CreatureEventAI::CreatureEventAI(Creature* c) : CreatureAI(c),
         }
         else
         {
+            // built by the manager from the same events, copied along for the same reason
+            CreatureEventAI_EventIndex_Map::const_iterator indexItr = sEventAIMgr.GetCreatureEventAIIndexMap().find(m_creature->GetEntry());
+            if (indexItr != sEventAIMgr.GetCreatureEventAIIndexMap().end())
+            {
+                m_EventIndex = indexItr->second;
+            }
+
             m_CreatureEventAIList.reserve(events_count);
             for (CreatureEventAI_Event_Vec::const_iterator i = (*creatureEventsItr).second.begin(); i != (*creatureEventsItr).second.end(); ++i)
             {
@@ -161,28 +168,22 @@ CreatureEventAI::CreatureEventAI(Creature* c) : CreatureAI(c),
     DEBUG_FILTER_LOG(LOG_FILTER_EVENT_AI_DEV, "CreatureEventAI: Event type %u (script %u) triggered for %s (invoked by %s)",    \
                      pHolder.Event.event_type, pHolder.Event.event_id, m_creature->GetGuidStr().c_str(), pActionInvoker ? pActionInvoker->GetGuidStr().c_str() : "<no invoker>")
 
-inline bool IsTimerBasedEvent(EventAI_Type type)
+inline void UpdateEventTimer(CreatureEventAIHolder& holder, uint32 diff, uint8 phase)
 {
-    switch (type)
+    if (holder.Time)
     {
-        case EVENT_T_TIMER_IN_COMBAT:
-        case EVENT_T_TIMER_OOC:
-        case EVENT_T_TIMER_GENERIC:
-        case EVENT_T_MANA:
-        case EVENT_T_HP:
-        case EVENT_T_TARGET_HP:
-        case EVENT_T_TARGET_CASTING:
-        case EVENT_T_FRIENDLY_HP:
-        case EVENT_T_FRIENDLY_IS_CC:
-        case EVENT_T_AURA:
-        case EVENT_T_TARGET_AURA:
-        case EVENT_T_MISSING_AURA:
-        case EVENT_T_TARGET_MISSING_AURA:
-        case EVENT_T_RANGE:
-        case EVENT_T_ENERGY:
-            return true;
-        default:
-            return false;
+        if (holder.Time > diff)
+        {
+            // Do not decrement timers if event cannot trigger in this phase
+            if (!(holder.Event.event_inverse_phase_mask & (1 << phase)))
+            {
+                holder.Time -= diff;
+            }
+        }
+        else
+        {
+            holder.Time = 0;
+        }
     }
 }
 
@@ -550,6 +551,14 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
             break;
     }
 
+    // timers of events triggered by hooks are only counted down while in the queue
+    if (pHolder.Time && !pHolder.TimerQueued && !IsTimerBasedEvent(pHolder.Event.event_type))
+    {
+        pHolder.TimerQueued = true;
+        m_TimerQueue.push_back(&pHolder - &m_CreatureEventAIList[0]);
+        m_creature->WakeUp();
+    }
+
     // Disable non-repeatable events
     if (!(pHolder.Event.event_flags & EFLAG_REPEATABLE))
     {
@@ -1273,20 +1282,23 @@ void CreatureEventAI::JustRespawned()                       // NOTE that this is
 {
     Reset();
 
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    // Reset generic timer
+    for (uint32 i = FirstEventOfType(EVENT_T_TIMER_GENERIC); i < EndEventOfType(EVENT_T_TIMER_GENERIC); ++i)
     {
-        // Reset generic timer
-        if (i->Event.event_type == EVENT_T_TIMER_GENERIC)
+        CreatureEventAIHolder& holder = EventOfType(i);
+        if (holder.UpdateRepeatTimer(m_creature, holder.Event.timer.initialMin, holder.Event.timer.initialMax))
         {
-            if (i->UpdateRepeatTimer(m_creature, i->Event.timer.initialMin, i->Event.timer.initialMax))
-            {
-                i->Enabled = true;
-            }
+            holder.Enabled = true;
         }
-        // Handle Spawned Events
-        else if (SpawnedEventConditionsCheck(i->Event))
+    }
+
+    // Handle Spawned Events
+    for (uint32 i = FirstEventOfType(EVENT_T_SPAWNED); i < EndEventOfType(EVENT_T_SPAWNED); ++i)
+    {
+        CreatureEventAIHolder& holder = EventOfType(i);
+        if (SpawnedEventConditionsCheck(holder.Event))
         {
-            ProcessEvent(*i);
+            ProcessEvent(holder);
         }
     }
 }
@@ -1298,38 +1310,23 @@ void CreatureEventAI::Reset()
     m_EventDiff = 0;
     m_throwAIEventStep = 0;
 
-    // Reset all events to enabled
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    // Reset all out of combat timers
+    // TODO: verify if other events previously disabled (ex. aggro yell) should be enabled here with their time set to 0, instead of enable this in void Aggro()
+    for (uint32 i = FirstEventOfType(EVENT_T_TIMER_OOC); i < EndEventOfType(EVENT_T_TIMER_OOC); ++i)
     {
-        CreatureEventAI_Event const& event = i->Event;
-        switch (event.event_type)
+        CreatureEventAIHolder& holder = EventOfType(i);
+        if (holder.UpdateRepeatTimer(m_creature, holder.Event.timer.initialMin, holder.Event.timer.initialMax))
         {
-                // Reset all out of combat timers
-            case EVENT_T_TIMER_OOC:
-            {
-                if (i->UpdateRepeatTimer(m_creature, event.timer.initialMin, event.timer.initialMax))
-                {
-                    i->Enabled = true;
-                }
-                break;
-            }
-            default:
-            // TODO: enable below code line / verify this is correct to enable events previously disabled (ex. aggro yell), instead of enable this in void Aggro()
-            //i->Enabled = true;
-            //i->Time = 0;
-            break;
+            holder.Enabled = true;
         }
     }
 }
 
 void CreatureEventAI::JustReachedHome()
 {
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint32 i = FirstEventOfType(EVENT_T_REACHED_HOME); i < EndEventOfType(EVENT_T_REACHED_HOME); ++i)
     {
-        if (i->Event.event_type == EVENT_T_REACHED_HOME)
-        {
-            ProcessEvent(*i);
-        }
+        ProcessEvent(EventOfType(i));
     }
 
     Reset();
@@ -1352,12 +1349,9 @@ void CreatureEventAI::EnterEvadeMode()
     SetSpellsList(m_creature->GetCreatureInfo()->SpellListId);
 
     // Handle Evade events
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint32 i = FirstEventOfType(EVENT_T_EVADE); i < EndEventOfType(EVENT_T_EVADE); ++i)
     {
-        if (i->Event.event_type == EVENT_T_EVADE)
-        {
-            ProcessEvent(*i);
-        }
+        ProcessEvent(EventOfType(i));
     }
     m_creature->ResetPlayerDamageReq();
 }
@@ -1381,12 +1375,9 @@ void CreatureEventAI::JustDied(Unit* killer)
     }
 
     // Handle On Death events
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint32 i = FirstEventOfType(EVENT_T_DEATH); i < EndEventOfType(EVENT_T_DEATH); ++i)
     {
-        if (i->Event.event_type == EVENT_T_DEATH)
-        {
-            ProcessEvent(*i, killer);
-        }
+        ProcessEvent(EventOfType(i), killer);
     }
 
     // reset phase after any death state events
@@ -1400,45 +1391,33 @@ void CreatureEventAI::KilledUnit(Unit* victim)
         return;
     }
 
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint32 i = FirstEventOfType(EVENT_T_KILL); i < EndEventOfType(EVENT_T_KILL); ++i)
     {
-        if (i->Event.event_type == EVENT_T_KILL)
-        {
-            ProcessEvent(*i, victim);
-        }
+        ProcessEvent(EventOfType(i), victim);
     }
 }
 
 void CreatureEventAI::JustSummoned(Creature* pUnit)
 {
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint32 i = FirstEventOfType(EVENT_T_SUMMONED_UNIT); i < EndEventOfType(EVENT_T_SUMMONED_UNIT); ++i)
     {
-        if (i->Event.event_type == EVENT_T_SUMMONED_UNIT)
-        {
-            ProcessEvent(*i, pUnit);
-        }
+        ProcessEvent(EventOfType(i), pUnit);
     }
 }
 
 void CreatureEventAI::SummonedCreatureJustDied(Creature* pUnit)
 {
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint32 i = FirstEventOfType(EVENT_T_SUMMONED_JUST_DIED); i < EndEventOfType(EVENT_T_SUMMONED_JUST_DIED); ++i)
     {
-        if (i->Event.event_type == EVENT_T_SUMMONED_JUST_DIED)
-        {
-            ProcessEvent(*i, pUnit);
-        }
+        ProcessEvent(EventOfType(i), pUnit);
     }
 }
 
 void CreatureEventAI::SummonedCreatureDespawn(Creature* pUnit)
 {
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint32 i = FirstEventOfType(EVENT_T_SUMMONED_JUST_DESPAWN); i < EndEventOfType(EVENT_T_SUMMONED_JUST_DESPAWN); ++i)
     {
-        if (i->Event.event_type == EVENT_T_SUMMONED_JUST_DESPAWN)
-        {
-            ProcessEvent(*i, pUnit);
-        }
+        ProcessEvent(EventOfType(i), pUnit);
     }
 }
 
@@ -1446,13 +1425,13 @@ void CreatureEventAI::ReceiveAIEvent(AIEventType eventType, Creature* pSender, U
 {
     MANGOS_ASSERT(pSender);
 
-    for (CreatureEventAIList::iterator itr = m_CreatureEventAIList.begin(); itr != m_CreatureEventAIList.end(); ++itr)
+    for (uint32 i = FirstEventOfType(EVENT_T_RECEIVE_AI_EVENT); i < EndEventOfType(EVENT_T_RECEIVE_AI_EVENT); ++i)
     {
-        if (itr->Event.event_type == EVENT_T_RECEIVE_AI_EVENT &&
-            itr->Event.receiveAIEvent.eventType == eventType && (!itr->Event.receiveAIEvent.senderEntry || itr->Event.receiveAIEvent.senderEntry == pSender->GetEntry()))
-            {
-                ProcessEvent(*itr, pInvoker, pSender);
-            }
+        CreatureEventAIHolder& holder = EventOfType(i);
+        if (holder.Event.receiveAIEvent.eventType == eventType && (!holder.Event.receiveAIEvent.senderEntry || holder.Event.receiveAIEvent.senderEntry == pSender->GetEntry()))
+        {
+            ProcessEvent(holder, pInvoker, pSender);
+        }
     }
 }
 
@@ -1514,22 +1493,21 @@ void CreatureEventAI::MoveInLineOfSight(Unit* who)
     // Check for OOC LOS Event
     if (m_HasOOCLoSEvent && !m_creature->getVictim())
     {
-        for (CreatureEventAIList::iterator itr = m_CreatureEventAIList.begin(); itr != m_CreatureEventAIList.end(); ++itr)
+        for (uint32 i = FirstEventOfType(EVENT_T_OOC_LOS); i < EndEventOfType(EVENT_T_OOC_LOS); ++i)
         {
-            if (itr->Event.event_type == EVENT_T_OOC_LOS)
-            {
-                // can trigger if closer than fMaxAllowedRange
-                float fMaxAllowedRange = (float)itr->Event.ooc_los.maxRange;
+            CreatureEventAIHolder& holder = EventOfType(i);
+
+            // can trigger if closer than fMaxAllowedRange
+            float fMaxAllowedRange = (float)holder.Event.ooc_los.maxRange;
 
-                // if friendly event && who is not hostile OR hostile event && who is hostile
-                if ((itr->Event.ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
-                    ((!itr->Event.ooc_los.noHostile) && m_creature->IsHostileTo(who)))
+            // if friendly event && who is not hostile OR hostile event && who is hostile
+            if ((holder.Event.ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
+                ((!holder.Event.ooc_los.noHostile) && m_creature->IsHostileTo(who)))
+            {
+                // if range is ok and we are actually in LOS
+                if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
                 {
-                    // if range is ok and we are actually in LOS
-                    if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
-                    {
-                        ProcessEvent(*itr, who);
-                    }
+                    ProcessEvent(holder, who);
                 }
             }
         }
@@ -1567,17 +1545,16 @@ void CreatureEventAI::MoveInLineOfSight(Unit* who)
 
 void CreatureEventAI::SpellHit(Unit* pUnit, const SpellEntry* pSpell)
 {
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint32 i = FirstEventOfType(EVENT_T_SPELLHIT); i < EndEventOfType(EVENT_T_SPELLHIT); ++i)
     {
-        if (i->Event.event_type == EVENT_T_SPELLHIT)
+        CreatureEventAIHolder& holder = EventOfType(i);
+
+        // If spell id matches (or no spell id) & if spell school matches (or no spell school)
+        if (!holder.Event.spell_hit.spellId || pSpell->Id == holder.Event.spell_hit.spellId)
         {
-            // If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            if (!i->Event.spell_hit.spellId || pSpell->Id == i->Event.spell_hit.spellId)
+            if (GetSchoolMask(pSpell->School) & holder.Event.spell_hit.schoolMask)
             {
-                if (GetSchoolMask(pSpell->School) & i->Event.spell_hit.schoolMask)
-                {
-                    ProcessEvent(*i, pUnit);
-                }
+                ProcessEvent(holder, pUnit);
             }
         }
     }
@@ -1593,36 +1570,36 @@ void CreatureEventAI::UpdateAI(const uint32 diff)
     {
         m_EventDiff += diff;
 
-        // Check for time based events
-        for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+        // Decrement repeat timers of events triggered by hooks, drop the expired ones
+        for (uint32 i = 0; i < m_TimerQueue.size();)
         {
-            // Decrement Timers
-            if (i->Time)
+            CreatureEventAIHolder& holder = m_CreatureEventAIList[m_TimerQueue[i]];
+            UpdateEventTimer(holder, m_EventDiff, m_Phase);
+
+            if (holder.Time)
             {
-                if (i->Time > m_EventDiff)
-                {
-                    // Do not decrement timers if event cannot trigger in this phase
-                    if (!(i->Event.event_inverse_phase_mask & (1 << m_Phase)))
-                    {
-                        i->Time -= m_EventDiff;
-                    }
-                }
-                else
-                {
-                    i->Time = 0;
-                }
+                ++i;
+                continue;
             }
 
+            holder.TimerQueued = false;
+            m_TimerQueue[i] = m_TimerQueue.back();
+            m_TimerQueue.pop_back();
+        }
+
+        // Check for time based events
+        for (std::vector<uint16>::const_iterator itr = m_EventIndex.timerBased.begin(); itr != m_EventIndex.timerBased.end(); ++itr)
+        {
+            CreatureEventAIHolder& holder = m_CreatureEventAIList[*itr];
+            UpdateEventTimer(holder, m_EventDiff, m_Phase);
+
             // Skip processing of events that have time remaining or are disabled
-            if (!(i->Enabled) || i->Time)
+            if (!(holder.Enabled) || holder.Time)
             {
                 continue;
             }
 
-            if (IsTimerBasedEvent(i->Event.event_type))
-            {
-                ProcessEvent(*i);
-            }
+            ProcessEvent(holder);
         }
 
         m_EventDiff = 0;
@@ -1646,6 +1623,26 @@ void CreatureEventAI::UpdateAI(const uint32 diff)
     }
 }
 
+bool CreatureEventAI::CanSleep() const
+{
+    if (!m_TimerQueue.empty())
+    {
+        return false;
+    }
+
+    // out of combat timers and checks need UpdateAI calls
+    for (std::vector<uint16>::const_iterator itr = m_EventIndex.timerBased.begin(); itr != m_EventIndex.timerBased.end(); ++itr)
+    {
+        CreatureEventAIHolder const& holder = m_CreatureEventAIList[*itr];
+        if (holder.Enabled && !IsCombatOnlyTimerEvent(holder.Event.event_type))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool CreatureEventAI::IsVisible(Unit* pl) const
 {
     return m_creature->IsWithinDist(pl, sWorld.getConfig(CONFIG_FLOAT_SIGHT_MONSTER))
@@ -1789,21 +1786,19 @@ void CreatureEventAI::DoFindFriendlyMissingBuff(std::list<Creature*>& _list, flo
 
 void CreatureEventAI::ReceiveEmote(Player* pPlayer, uint32 text_emote)
 {
-    for (CreatureEventAIList::iterator itr = m_CreatureEventAIList.begin(); itr != m_CreatureEventAIList.end(); ++itr)
+    for (uint32 i = FirstEventOfType(EVENT_T_RECEIVE_EMOTE); i < EndEventOfType(EVENT_T_RECEIVE_EMOTE); ++i)
     {
-        if (itr->Event.event_type == EVENT_T_RECEIVE_EMOTE)
+        CreatureEventAIHolder& holder = EventOfType(i);
+        if (holder.Event.receive_emote.emoteId != text_emote)
         {
-            if (itr->Event.receive_emote.emoteId != text_emote)
-            {
-                continue;
-            }
+            continue;
+        }
 
-            PlayerCondition pcon(0, itr->Event.receive_emote.condition, itr->Event.receive_emote.conditionValue1, itr->Event.receive_emote.conditionValue2);
-            if (pcon.Meets(pPlayer, m_creature->GetMap(), m_creature, CONDITION_FROM_EVENTAI))
-            {
-                DEBUG_FILTER_LOG(LOG_FILTER_AI_AND_MOVEGENSS, "CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
-                ProcessEvent(*itr, pPlayer);
-            }
+        PlayerCondition pcon(0, holder.Event.receive_emote.condition, holder.Event.receive_emote.conditionValue1, holder.Event.receive_emote.conditionValue2);
+        if (pcon.Meets(pPlayer, m_creature->GetMap(), m_creature, CONDITION_FROM_EVENTAI))
+        {
+            DEBUG_FILTER_LOG(LOG_FILTER_AI_AND_MOVEGENSS, "CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
+            ProcessEvent(holder, pPlayer);
         }
     }
 }
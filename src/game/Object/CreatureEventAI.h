@@ -617,6 +617,65 @@ struct CreatureEventAI_Event
 typedef std::vector<CreatureEventAI_Event> CreatureEventAI_Event_Vec;
 typedef UNORDERED_MAP<uint32, CreatureEventAI_Event_Vec > CreatureEventAI_Event_Map;
 
+// Events checked by polling from UpdateAI, all others are triggered by their hook
+inline bool IsTimerBasedEvent(EventAI_Type type)
+{
+    switch (type)
+    {
+        case EVENT_T_TIMER_IN_COMBAT:
+        case EVENT_T_TIMER_OOC:
+        case EVENT_T_TIMER_GENERIC:
+        case EVENT_T_MANA:
+        case EVENT_T_HP:
+        case EVENT_T_TARGET_HP:
+        case EVENT_T_TARGET_CASTING:
+        case EVENT_T_FRIENDLY_HP:
+        case EVENT_T_FRIENDLY_IS_CC:
+        case EVENT_T_AURA:
+        case EVENT_T_TARGET_AURA:
+        case EVENT_T_MISSING_AURA:
+        case EVENT_T_TARGET_MISSING_AURA:
+        case EVENT_T_RANGE:
+        case EVENT_T_ENERGY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Polled events that can only trigger while in combat
+inline bool IsCombatOnlyTimerEvent(EventAI_Type type)
+{
+    switch (type)
+    {
+        case EVENT_T_TIMER_IN_COMBAT:
+        case EVENT_T_MANA:
+        case EVENT_T_HP:
+        case EVENT_T_TARGET_HP:
+        case EVENT_T_TARGET_CASTING:
+        case EVENT_T_TARGET_AURA:
+        case EVENT_T_TARGET_MISSING_AURA:
+        case EVENT_T_RANGE:
+        case EVENT_T_ENERGY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Positions of the events of one creature in its event list, so a hook only
+// visits the events of its own type. Events of one type keep table order.
+struct CreatureEventAI_EventIndex
+{
+    CreatureEventAI_EventIndex() { memset(typeStart, 0, sizeof(typeStart)); }
+
+    std::vector<uint16> byType;                             // positions grouped by event type
+    uint16 typeStart[EVENT_T_END + 1];                      // events of type t are byType[typeStart[t]] .. byType[typeStart[t + 1] - 1]
+    std::vector<uint16> timerBased;                         // positions of the events polled from UpdateAI, in table order
+};
+
+typedef UNORDERED_MAP<uint32, CreatureEventAI_EventIndex> CreatureEventAI_EventIndex_Map;
+
 struct CreatureEventAI_Summon
 {
     uint32 id;
@@ -633,11 +692,12 @@ typedef UNORDERED_MAP<uint32, CreatureEventAI_Summon> CreatureEventAI_Summon_Map
 
 struct CreatureEventAIHolder
 {
-    CreatureEventAIHolder(CreatureEventAI_Event p) : Event(p), Time(0), Enabled(true) {}
+    CreatureEventAIHolder(CreatureEventAI_Event p) : Event(p), Time(0), Enabled(true), TimerQueued(false) {}
 
     CreatureEventAI_Event Event;
     uint32 Time;
     bool Enabled;
+    bool TimerQueued;                                       // hook triggered event waiting in the repeat timer queue
 
     // helper
     bool UpdateRepeatTimer(Creature* creature, uint32 repeatMin, uint32 repeatMax);
@@ -670,6 +730,7 @@ class CreatureEventAI : public CreatureAI
         void DamageTaken(Unit* done_by, uint32& damage) override;
         void HealedBy(Unit* healer, uint32& healedAmount) override;
         void UpdateAI(const uint32 diff) override;
+        bool CanSleep() const override;
         bool IsVisible(Unit*) const override;
         void ReceiveEmote(Player* pPlayer, uint32 text_emote) override;
         void SummonedCreatureJustDied(Creature* unit) override;
@@ -687,6 +748,10 @@ class CreatureEventAI : public CreatureAI
 
         bool SpawnedEventConditionsCheck(CreatureEventAI_Event const& event);
 
+        uint32 FirstEventOfType(EventAI_Type type) const { return m_EventIndex.typeStart[type]; }
+        uint32 EndEventOfType(EventAI_Type type) const { return m_EventIndex.typeStart[type + 1]; }
+        CreatureEventAIHolder& EventOfType(uint32 i) { return m_CreatureEventAIList[m_EventIndex.byType[i]]; }
+
         Unit* DoSelectLowestHpFriendly(float range, uint32 MinHPDiff);
         void DoFindFriendlyMissingBuff(std::list<Creature*>& _list, float range, uint32 spellid);
         void DoFindFriendlyCC(std::list<Creature*>& _list, float range);
@@ -704,6 +769,8 @@ class CreatureEventAI : public CreatureAI
         // Variables used by Events themselves
         typedef std::vector<CreatureEventAIHolder> CreatureEventAIList;
         CreatureEventAIList m_CreatureEventAIList;          // Holder for events (stores enabled, time, and eventid)
+        CreatureEventAI_EventIndex m_EventIndex;            // m_CreatureEventAIList grouped by event type
+        std::vector<uint16> m_TimerQueue;                   // hook triggered events with a running repeat timer
 
         uint8  m_Phase;                                     // Current phase, max 32 phases
         bool   m_MeleeEnabled;                              // If we allow melee auto attack
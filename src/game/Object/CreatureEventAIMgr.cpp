@@ -266,11 +266,57 @@ bool IsValidTargetType(EventAI_Type eventType, EventAI_ActionType actionType, ui
     }
 }
 
+// -------------------
+// Positions refer to the event list built by CreatureEventAI, which skips the debug only events in release builds
+void CreatureEventAIMgr::BuildEventIndex(CreatureEventAI_Event_Vec const& events, CreatureEventAI_EventIndex& index)
+{
+    std::vector<uint16> eventTypes;
+    eventTypes.reserve(events.size());
+
+    for (CreatureEventAI_Event_Vec::const_iterator itr = events.begin(); itr != events.end(); ++itr)
+    {
+#ifndef MANGOS_DEBUG
+        if (itr->event_flags & EFLAG_DEBUG_ONLY)
+        {
+            continue;
+        }
+#endif
+        eventTypes.push_back(itr->event_type);
+    }
+
+    // counting sort by type, stable so events of one type stay in table order
+    memset(index.typeStart, 0, sizeof(index.typeStart));
+    for (uint32 i = 0; i < eventTypes.size(); ++i)
+    {
+        ++index.typeStart[eventTypes[i] + 1];
+    }
+
+    for (uint32 type = 0; type < EVENT_T_END; ++type)
+    {
+        index.typeStart[type + 1] += index.typeStart[type];
+    }
+
+    std::vector<uint16> next(index.typeStart, index.typeStart + EVENT_T_END);
+    index.byType.resize(eventTypes.size());
+    index.timerBased.clear();
+
+    for (uint32 i = 0; i < eventTypes.size(); ++i)
+    {
+        index.byType[next[eventTypes[i]]++] = i;
+
+        if (IsTimerBasedEvent(EventAI_Type(eventTypes[i])))
+        {
+            index.timerBased.push_back(i);
+        }
+    }
+}
+
 // -------------------
 void CreatureEventAIMgr::LoadCreatureEventAI_Scripts()
 {
     // Drop Existing EventAI List
     m_CreatureEventAI_Event_Map.clear();
+    m_CreatureEventAI_EventIndex_Map.clear();
     std::set<int32> usedTextIds;
 
     // Gather event data
@@ -1070,6 +1116,12 @@ void CreatureEventAIMgr::LoadCreatureEventAI_Scripts()
         delete result;
         m_usedTextsAmount = usedTextIds.size();
 
+        // group the events of each creature by type for the AI hooks
+        for (CreatureEventAI_Event_Map::const_iterator itr = m_CreatureEventAI_Event_Map.begin(); itr != m_CreatureEventAI_Event_Map.end(); ++itr)
+        {
+            BuildEventIndex(itr->second, m_CreatureEventAI_EventIndex_Map[itr->first]);
+        }
+
         // post check
         for (uint32 i = 1; i < sCreatureStorage.GetMaxEntry(); ++i)
         {
@@ -39,13 +39,16 @@ class CreatureEventAIMgr
         void LoadCreatureEventAI_Scripts();
 
         CreatureEventAI_Event_Map  const& GetCreatureEventAIMap()       const { return m_CreatureEventAI_Event_Map; }
+        CreatureEventAI_EventIndex_Map const& GetCreatureEventAIIndexMap() const { return m_CreatureEventAI_EventIndex_Map; }
         CreatureEventAI_Summon_Map const& GetCreatureEventAISummonMap() const { return m_CreatureEventAI_Summon_Map; }
 
     private:
         void CheckUnusedAITexts();
         void CheckUnusedAISummons();
+        void BuildEventIndex(CreatureEventAI_Event_Vec const& events, CreatureEventAI_EventIndex& index);
 
         CreatureEventAI_Event_Map  m_CreatureEventAI_Event_Map;
+        CreatureEventAI_EventIndex_Map m_CreatureEventAI_EventIndex_Map;
         CreatureEventAI_Summon_Map m_CreatureEventAI_Summon_Map;
 
         uint32 m_usedTextsAmount;
@@ -118,7 +118,13 @@ namespace MaNGOS
             return prk;
         }
 
-        inline HonorScores GenerateScores(HonorStandingList standingList, uint32 team)
+        // honor of the player at a 1 based standing position, 0 past the end of the list
+        inline float HonorAtStandingPosition(HonorStandingList const& standingList, uint32 position)
+        {
+            return position && position <= standingList.size() ? standingList[position - 1].honorPoints : 0.0f;
+        }
+
+        inline HonorScores GenerateScores(HonorStandingList const& standingList)
         {
             HonorScores sc;
 
@@ -160,7 +166,6 @@ namespace MaNGOS
 
             // the X values for each breakpoint are found from the CP scores
             // of the players around that point in the WS scores
-            HonorStanding* tempSt;
             float honor;
 
             // initialize CP array
@@ -169,22 +174,18 @@ namespace MaNGOS
             for (uint8 i = 1; i <= 13; i++)
             {
                 honor = 0.0f;
-                tempSt = sObjectMgr.GetHonorStandingByPosition(sc.BRK[i], team);
-                if (tempSt)
+                uint32 position = uint32(sc.BRK[i]);
+                if (position && position <= standingList.size())
                 {
-                    honor += tempSt->honorPoints;
-                    tempSt = sObjectMgr.GetHonorStandingByPosition(sc.BRK[i] + 1, team);
-                    if (tempSt)
-                    {
-                        honor += tempSt->honorPoints;
-                    }
+                    honor += HonorAtStandingPosition(standingList, position);
+                    honor += HonorAtStandingPosition(standingList, position + 1);
                 }
 
                 sc.FX[i] = honor ? honor / 2 : 0;
             }
 
             // set the high point if FX full filled before
-            sc.FX[14] = sc.FX[13] ? standingList.begin()->honorPoints : 0;   // top scorer
+            sc.FX[14] = sc.FX[13] ? HonorAtStandingPosition(standingList, 1) : 0;   // top scorer
 
             return sc;
         }
@@ -49,6 +49,7 @@
 #include "CreatureAISelector.h"
 #include "SQLStorages.h"
 #include "GameObjectAI.h"
+#include "Utilities/ObjectPool.h"
 #include <memory>
 
 #ifdef ENABLE_ELUNA
@@ -99,6 +100,23 @@ GameObject::~GameObject()
     delete m_model;
 }
 
+static ObjectPool& GetGameObjectPool()
+{
+    // never destroyed, see ObjectPool; covers transports as well
+    static ObjectPool* pool = new ObjectPool("GameObject", 2048, 16, 128);
+    return *pool;
+}
+
+void* GameObject::operator new(size_t size)
+{
+    return GetGameObjectPool().Allocate(size);
+}
+
+void GameObject::operator delete(void* ptr, size_t size)
+{
+    GetGameObjectPool().Release(ptr, size);
+}
+
 void GameObject::AddToWorld()
 {
 #ifdef ENABLE_ELUNA
@@ -108,6 +126,7 @@ void GameObject::AddToWorld()
     ///- Register the gameobject for guid lookup
     if (!IsInWorld())
     {
+        MapRegionGuard guard(GetMap());
         GetMap()->GetObjectsStore().insert<GameObject>(GetObjectGuid(), (GameObject*)this);
     }
 
@@ -164,6 +183,7 @@ void GameObject::RemoveFromWorld()
             GetMap()->RemoveGameObjectModel(*m_model);
         }
 
+        MapRegionGuard guard(GetMap());
         GetMap()->GetObjectsStore().erase<GameObject>(GetObjectGuid(), (GameObject*)NULL);
     }
 
@@ -2053,6 +2073,11 @@ void GameObject::SetQuaternion(G3D::Quat const& q)
     if (m_model)
     {
         m_model->UpdateRotation(q);
+
+        if (IsInWorld() && GetMap()->ContainsGameObjectModel(*m_model))
+        {
+            GetMap()->RefitGameObjectModel(*m_model);
+        }
     }
 }
 
@@ -2338,6 +2363,22 @@ void GameObject::UpdateCollisionState() const
     }
 
     m_model->SetCollidable(IsCollisionEnabled());
+    GetMap()->InvalidateLineOfSightCache();
+}
+
+void GameObject::UpdateModelPosition()
+{
+    if (!m_model)
+    {
+        return;
+    }
+
+    m_model->UpdatePosition(G3D::Vector3(GetPositionX(), GetPositionY(), GetPositionZ()));
+
+    if (IsInWorld() && GetMap()->ContainsGameObjectModel(*m_model))
+    {
+        GetMap()->RefitGameObjectModel(*m_model);
+    }
 }
 
 void GameObject::UpdateModel()
@@ -2566,6 +2607,12 @@ void GameObject::TickCapturePoint()
 {
     // TODO: On retail: Ticks every 5.2 seconds. slider value increase when new player enters on tick
 
+    // nobody can be capturing when the zone of the point has no players and none were capturing before
+    if (m_UniqueUsers.empty() && !GetMap()->GetPlayersInZone(GetZoneId()))
+    {
+        return;
+    }
+
     GameObjectInfo const* info = GetGOInfo();
     float radius = info->capturePoint.radius;
 
@@ -2770,7 +2817,13 @@ void GameObject::TickCapturePoint()
 
 uint32 GameObject::GetScriptId()
 {
-    return sScriptMgr.GetBoundScriptId(SCRIPTED_GAMEOBJECT, -int32(GetGUIDLow())) ? sScriptMgr.GetBoundScriptId(SCRIPTED_GAMEOBJECT, -int32(GetGUIDLow())) : sScriptMgr.GetBoundScriptId(SCRIPTED_GAMEOBJECT, GetEntry());
+    // scripts bound to DB guid have priority over ones bound to gameobject entry
+    if (uint32 scriptId = sScriptMgr.GetBoundScriptId(SCRIPTED_GAMEOBJECT, -int32(GetGUIDLow())))
+    {
+        return scriptId;
+    }
+
+    return sScriptMgr.GetBoundScriptId(SCRIPTED_GAMEOBJECT, GetEntry());
 }
 
 float GameObject::GetInteractionDistance() const
@@ -30,6 +30,7 @@
 #include "Object.h"
 #include "LootMgr.h"
 #include "Utilities/EventProcessor.h"
+#include "Utilities/InternedString.h"
 #include <memory>
 
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
@@ -477,7 +478,7 @@ struct GameObjectInfo
 
 struct GameObjectLocale
 {
-    std::vector<std::string> Name;
+    std::vector<InternedString> Name;
 };
 
 // client side GO show states
@@ -560,6 +561,10 @@ class GameObject : public WorldObject
         explicit GameObject();
         ~GameObject();
 
+        // despawned gameobjects leave their memory to the next spawn of this thread
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         void AddToWorld() override;
         void RemoveFromWorld() override;
 
@@ -779,6 +784,8 @@ class GameObject : public WorldObject
 
         std::unique_ptr<GameObjectAI> m_AI;
 
+        void UpdateModelPosition();                         // moves the model in Map's dynamic collision tree after a relocation
+
     private:
         void SwitchDoorOrButton(bool activate, bool alternative = false);
         void TickCapturePoint();
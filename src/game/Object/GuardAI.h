@@ -50,6 +50,7 @@ class GuardAI : public CreatureAI
         bool IsVisible(Unit*) const override;
 
         void UpdateAI(const uint32) override;
+        bool CanSleep() const override { return true; }
         static int Permissible(const Creature*);
 
     private:
@@ -35,6 +35,8 @@
 #include "Util.h"
 #include "Language.h"
 #include "World.h"
+#include "CharacterLoginCache.h"
+#include "CharEnumCache.h"
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
 #endif /* ENABLE_ELUNA */
@@ -105,6 +107,9 @@ Guild::Guild()
     m_CreatedDay = 0;
 
     m_GuildEventLogNextGuid = 0;
+
+    m_rosterBuildTime = 0;
+    m_rosterValid = false;
 }
 
 Guild::~Guild()
@@ -178,6 +183,8 @@ void Guild::CreateDefaultGuildRanks(int locale_idx)
 
 bool Guild::AddMember(ObjectGuid plGuid, uint32 plRank)
 {
+    InvalidateRoster();
+
     Player* pl = sObjectMgr.GetPlayer(plGuid);
     if (pl)
     {
@@ -272,6 +279,8 @@ bool Guild::AddMember(ObjectGuid plGuid, uint32 plRank)
 
 void Guild::SetMOTD(std::string motd)
 {
+    InvalidateRoster();
+
     MOTD = motd;
 
     // motd now can be used for encoding to DB
@@ -286,6 +295,8 @@ void Guild::SetMOTD(std::string motd)
 
 void Guild::SetGINFO(std::string ginfo)
 {
+    InvalidateRoster();
+
     GINFO = ginfo;
 
     // ginfo now can be used for encoding to DB
@@ -533,6 +544,8 @@ bool Guild::LoadMembersFromDB(QueryResult* guildMembersResult)
 
 void Guild::SetLeader(ObjectGuid guid)
 {
+    InvalidateRoster();
+
     MemberSlot* slot = GetMemberSlot(guid);
     if (!slot)
     {
@@ -555,8 +568,14 @@ void Guild::SetLeader(ObjectGuid guid)
  */
 bool Guild::DelMember(ObjectGuid guid, bool isDisbanding)
 {
+    InvalidateRoster();
+
     uint32 lowguid = guid.GetCounter();
 
+    // the member may be offline with a prefetched login
+    sCharacterLoginCache.Invalidate(lowguid);
+    sCharEnumCache.InvalidateCharacter(lowguid);
+
     // guild master can be deleted when loading guild and guid doesn't exist in characters table
     // or when he is removed from guild by gm command
     if (m_LeaderGuid == guid && !isDisbanding)
@@ -627,6 +646,8 @@ bool Guild::DelMember(ObjectGuid guid, bool isDisbanding)
 
 bool Guild::ChangeMemberRank(ObjectGuid guid, uint8 newRank)
 {
+    InvalidateRoster();
+
     if (newRank <= GetLowestRank())                    // Validate rank (allow only existing ranks)
         if (MemberSlot* member = GetMemberSlot(guid))
         {
@@ -692,12 +713,15 @@ void Guild::BroadcastToOfficers(WorldSession* session, const std::string& msg, u
 
 void Guild::BroadcastPacket(WorldPacket* packet)
 {
+    // one payload for all members
+    SharedWorldPacket shared;
+
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         Player* player = sObjectAccessor.FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
         if (player)
         {
-            player->GetSession()->SendPacket(packet);
+            player->GetSession()->SendPacket(packet, shared);
         }
     }
 }
@@ -736,11 +760,14 @@ void Guild::CreateRank(std::string name_, uint32 rights)
 
 void Guild::AddRank(const std::string& name_, uint32 rights)
 {
+    InvalidateRoster();
     m_Ranks.push_back(RankInfo(name_, rights));
 }
 
 void Guild::DelRank()
 {
+    InvalidateRoster();
+
     // client won't allow to have less than GUILD_RANKS_MIN_COUNT ranks in guild
     if (m_Ranks.size() <= GUILD_RANKS_MIN_COUNT)
     {
@@ -790,6 +817,8 @@ void Guild::SetRankName(uint32 rankId, std::string name_)
 
 void Guild::SetRankRights(uint32 rankId, uint32 rights)
 {
+    InvalidateRoster();
+
     if (rankId >= m_Ranks.size())
     {
         return;
@@ -830,9 +859,31 @@ void Guild::Disband()
 }
 
 void Guild::Roster(WorldSession* session /*= NULL*/)
+{
+    time_t now = time(NULL);
+    if (!m_rosterValid || now >= m_rosterBuildTime + GUILD_ROSTER_CACHE_TIME)
+    {
+        BuildRoster(m_rosterPacket);
+        m_rosterShared.reset();
+        m_rosterBuildTime = now;
+        m_rosterValid = true;
+    }
+
+    if (session)
+    {
+        session->SendPacket(&m_rosterPacket, m_rosterShared);
+    }
+    else
+    {
+        BroadcastPacket(&m_rosterPacket);
+    }
+    DEBUG_LOG("WORLD: Sent (SMSG_GUILD_ROSTER)");
+}
+
+void Guild::BuildRoster(WorldPacket& data) const
 {
     // we can only guess size
-    WorldPacket data(SMSG_GUILD_ROSTER, (4 + MOTD.length() + 1 + GINFO.length() + 1 + 4 + m_Ranks.size() * 4 + members.size() * 50));
+    data.Initialize(SMSG_GUILD_ROSTER, (4 + MOTD.length() + 1 + GINFO.length() + 1 + 4 + m_Ranks.size() * 4 + members.size() * 50));
     data << uint32(members.size());
     data << MOTD;
     data << GINFO;
@@ -871,15 +922,6 @@ void Guild::Roster(WorldSession* session /*= NULL*/)
             data << itr->second.OFFnote;
         }
     }
-    if (session)
-    {
-        session->SendPacket(&data);
-    }
-    else
-    {
-        BroadcastPacket(&data);
-    }
-    DEBUG_LOG("WORLD: Sent (SMSG_GUILD_ROSTER)");
 }
 
 void Guild::Query(WorldSession* session)
@@ -1072,6 +1114,9 @@ void Guild::BroadcastEvent(GuildEvents event, ObjectGuid guid, char const* str1
         data << guid;
     }
 
+    // every event (sign on/off, promotion, join, leave, ...) changes something shown in the roster
+    InvalidateRoster();
+
     BroadcastPacket(&data);
 
     DEBUG_LOG("WORLD: Sent SMSG_GUILD_EVENT");
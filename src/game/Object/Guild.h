@@ -29,12 +29,14 @@
 #include "Item.h"
 #include "ObjectAccessor.h"
 #include "SharedDefines.h"
+#include "WorldPacket.h"
 
 class Item;
 
 #define GUILD_RANK_NONE         0xFF
 #define GUILD_RANKS_MIN_COUNT   5
 #define GUILD_RANKS_MAX_COUNT   10
+#define GUILD_ROSTER_CACHE_TIME 10                          // seconds, level and zone of online members are not tracked otherwise
 
 enum GuildDefaultRanks
 {
@@ -295,6 +297,7 @@ class Guild
         }
 
         void Roster(WorldSession* session = NULL);          // NULL = broadcast
+        void InvalidateRoster() { m_rosterValid = false; }  // call when members, ranks, notes or online state change
         void Query(WorldSession* session);
 
         // Guild EventLog
@@ -333,5 +336,12 @@ class Guild
 
     private:
         void UpdateAccountsNumber() { m_accountsNumber = 0;}// mark for lazy calculation at request in GetAccountsNumber
+        void BuildRoster(WorldPacket& data) const;
+
+        // serialized roster sent to every requester until invalidated or older than GUILD_ROSTER_CACHE_TIME
+        WorldPacket m_rosterPacket;
+        SharedWorldPacket m_rosterShared;
+        time_t m_rosterBuildTime;
+        bool m_rosterValid;
 };
 #endif
@@ -45,10 +45,71 @@ struct EnchStoreItem
 };
 
 typedef std::vector<EnchStoreItem> EnchStoreList;
-typedef UNORDERED_MAP<uint32, EnchStoreList> EnchantmentStore;
+
+// alias table of the enchantments of one entry, picks one with a single roll
+struct EnchAliasTable
+{
+    std::vector<uint32> ench;
+    std::vector<double> prob;                               // chance to keep column i instead of taking its alias
+    std::vector<uint32> alias;
+};
+
+typedef UNORDERED_MAP<uint32, EnchAliasTable> EnchantmentStore;
 
 static EnchantmentStore RandomItemEnch;
 
+/**
+ * Builds the alias table (Vose's method) of the enchantments of one entry.
+ *
+ * The weights are what the cumulative roll over `chance` used to select:
+ * chances past a total of 100% are cut off, and a total below 100% is
+ * scaled up as the re-roll in that case did.
+ */
+static void BuildEnchAliasTable(EnchStoreList const& list, EnchAliasTable& table)
+{
+    std::vector<double> weights;
+    weights.reserve(list.size());
+
+    double total = 0.0;
+    for (EnchStoreList::const_iterator itr = list.begin(); itr != list.end() && total < 100.0; ++itr)
+    {
+        double weight = std::min(double(itr->chance), 100.0 - total);
+        table.ench.push_back(itr->ench);
+        weights.push_back(weight);
+        total += weight;
+    }
+
+    size_t n = weights.size();
+    table.prob.assign(n, 1.0);
+    table.alias.resize(n);
+
+    std::vector<uint32> small, large;
+    for (size_t i = 0; i < n; ++i)
+    {
+        table.alias[i] = uint32(i);
+        weights[i] = weights[i] * n / total;
+        (weights[i] < 1.0 ? small : large).push_back(uint32(i));
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        uint32 less = small.back();
+        uint32 more = large.back();
+        small.pop_back();
+
+        table.prob[less] = weights[less];
+        table.alias[less] = more;
+
+        weights[more] -= 1.0 - weights[less];
+        if (weights[more] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // whatever is left is 1.0 up to rounding, already set
+}
+
 void LoadRandomEnchantmentsTable()
 {
     RandomItemEnch.clear();                                 // for reload case
@@ -60,6 +121,8 @@ void LoadRandomEnchantmentsTable()
     {
         BarGoLink bar(result->GetRowCount());
 
+        UNORDERED_MAP<uint32, EnchStoreList> lists;
+
         do
         {
             Field* fields = result->Fetch();
@@ -71,7 +134,7 @@ void LoadRandomEnchantmentsTable()
 
             if (chance > 0.000001f && chance <= 100.0f)
             {
-                RandomItemEnch[entry].push_back(EnchStoreItem(ench, chance));
+                lists[entry].push_back(EnchStoreItem(ench, chance));
             }
 
             ++count;
@@ -80,6 +143,11 @@ void LoadRandomEnchantmentsTable()
 
         delete result;
 
+        for (UNORDERED_MAP<uint32, EnchStoreList>::const_iterator itr = lists.begin(); itr != lists.end(); ++itr)
+        {
+            BuildEnchAliasTable(itr->second, RandomItemEnch[itr->first]);
+        }
+
         sLog.outString(">> Loaded %u Item Enchantment definitions", count);
     }
     else
@@ -104,33 +172,11 @@ uint32 GetItemEnchantMod(uint32 entry)
         return 0;
     }
 
-    double dRoll = rand_chance();
-    float fCount = 0;
-
-    const EnchStoreList &enchantList = tab->second;
-    for (EnchStoreList::const_iterator ench_iter = enchantList.begin(); ench_iter != enchantList.end(); ++ench_iter)
-    {
-        fCount += ench_iter->chance;
-
-        if (fCount > dRoll)
-        {
-            return ench_iter->ench;
-        }
-    }
-
-    // we could get here only if sum of all enchantment chances is lower than 100%
-    dRoll = (irand(0, (int)floor(fCount * 100) + 1)) / 100;
-    fCount = 0;
+    EnchAliasTable const& table = tab->second;
 
-    for (EnchStoreList::const_iterator ench_iter = enchantList.begin(); ench_iter != enchantList.end(); ++ench_iter)
-    {
-        fCount += ench_iter->chance;
-
-        if (fCount > dRoll)
-        {
-            return ench_iter->ench;
-        }
-    }
+    // one roll, the integer part picks the column and the fraction decides between it and its alias
+    double roll = rand_norm() * table.ench.size();
+    size_t column = std::min(size_t(roll), table.ench.size() - 1);
 
-    return 0;
+    return roll - column < table.prob[column] ? table.ench[column] : table.ench[table.alias[column]];
 }
@@ -26,6 +26,7 @@
 #define MANGOS_H_ITEMPROTOTYPE
 
 #include "Common.h"
+#include "Utilities/InternedString.h"
 
 enum ItemModType
 {
@@ -519,8 +520,8 @@ struct ItemPrototype
 
 struct ItemLocale
 {
-    std::vector<std::string> Name;
-    std::vector<std::string> Description;
+    std::vector<InternedString> Name;
+    std::vector<InternedString> Description;
 };
 
 #endif
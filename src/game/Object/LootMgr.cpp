@@ -34,6 +34,12 @@
 #include "DisableMgr.h"
 #include "ItemEnchantmentMgr.h"
 
+#include <ace/Task.h>
+#include <ace/Atomic_Op.h>
+
+// groups with at least that many entries are rolled through an alias table
+#define LOOT_GROUP_ALIAS_MIN_ENTRIES 8
+
 static eConfigFloatValues const qualityToRate[MAX_ITEM_QUALITY] =
 {
     CONFIG_FLOAT_RATE_DROP_ITEM_POOR,                       // ITEM_QUALITY_POOR
@@ -83,10 +89,16 @@ class LootTemplate::LootGroup                               // A set of loot def
 
         void Verify(LootStore const& lootstore, uint32 id, uint32 group_id) const;
         void CheckLootRefs(LootIdSet* ref_set) const;
+        void Compile();                                     // Builds the alias table for Roll (after loading stage)
+        bool IsSameAs(LootGroup const& other) const;        // Same entries in the same order
     private:
         LootStoreItemList ExplicitlyChanced;                // Entries with chances defined in DB
         LootStoreItemList EqualChanced;                     // Zero chances - every entry takes the same chance
 
+        // Alias table over ExplicitlyChanced, EqualChanced and the empty drop, in that order
+        std::vector<float> AliasChance;
+        std::vector<uint32> AliasOutcome;
+
         LootStoreItem const* Roll() const;                  // Rolls an item from the group, returns NULL if all miss their chances
 };
 
@@ -113,19 +125,43 @@ void LootStore::Verify() const
 // Loads a *_loot_template DB table into loot store
 // All checks of the loaded template are called from here, no error reports at loot generation required
 void LootStore::LoadLootTable()
+{
+    // Clearing store (for reloading case)
+    Clear();
+
+    uint32 count = ReadLootTable(m_LootTemplates);
+
+    if (count)
+    {
+        sLog.outString(">> Loaded %u loot definitions (" SIZEFMTD " templates) from table %s", count, m_LootTemplates.size(), GetName());
+        sLog.outString();
+    }
+    else
+    {
+        sLog.outString();
+        sLog.outErrorDb(">> Loaded 0 loot definitions. DB table `%s` is empty.", GetName());
+    }
+}
+
+uint32 LootStore::ReadLootTable(LootTemplateMap& templates) const
 {
     LootTemplateMap::const_iterator tab;
     uint32 count = 0;
 
-    // Clearing store (for reloading case)
-    Clear();
+    uint32 rowCount = 0;
+    if (QueryResult* result = WorldDatabase.PQuery("SELECT COUNT(*) FROM `%s`", GetName()))
+    {
+        rowCount = (*result)[0].GetUInt32();
+        delete result;
+    }
 
-    //                                                 0      1     2                    3        4              5         6
-    QueryResult* result = WorldDatabase.PQuery("SELECT `entry`, `item`, `ChanceOrQuestChance`, `groupid`, `mincountOrRef`, `maxcount`, `condition_id` FROM `%s`", GetName());
+    // loot tables are big, the rows are read as they are checked instead of being buffered first
+    //                                                       0      1     2                    3        4              5         6
+    QueryResult* result = WorldDatabase.PQueryStream("SELECT `entry`, `item`, `ChanceOrQuestChance`, `groupid`, `mincountOrRef`, `maxcount`, `condition_id` FROM `%s`", GetName());
 
     if (result)
     {
-        BarGoLink bar(result->GetRowCount());
+        BarGoLink bar(rowCount);
 
         do
         {
@@ -171,13 +207,13 @@ void LootStore::LoadLootTable()
 
             // Looking for the template of the entry
             // often entries are put together
-            if (m_LootTemplates.empty() || tab->first != entry)
+            if (templates.empty() || tab->first != entry)
             {
                 // Searching the template (in case template Id changed)
-                tab = m_LootTemplates.find(entry);
-                if (tab == m_LootTemplates.end())
+                tab = templates.find(entry);
+                if (tab == templates.end())
                 {
-                    std::pair< LootTemplateMap::iterator, bool > pr = m_LootTemplates.insert(LootTemplateMap::value_type(entry, new LootTemplate));
+                    std::pair< LootTemplateMap::iterator, bool > pr = templates.insert(LootTemplateMap::value_type(entry, new LootTemplate));
                     tab = pr.first;
                 }
             }
@@ -192,16 +228,57 @@ void LootStore::LoadLootTable()
 
         delete result;
 
-        Verify();                                           // Checks validity of the loot store
+        // Checks validity of the read templates
+        for (LootTemplateMap::const_iterator tab = templates.begin(); tab != templates.end(); ++tab)
+        {
+            tab->second->Verify(*this, tab->first);
+            tab->second->Compile();
+        }
+    }
 
-        sLog.outString(">> Loaded %u loot definitions (" SIZEFMTD " templates) from table %s", count, m_LootTemplates.size(), GetName());
-        sLog.outString();
+    return count;
+}
+
+void LootStore::ApplyLootTable(LootTemplateMap& templates, uint32& changed, uint32& removed)
+{
+    changed = 0;
+    removed = 0;
+
+    for (LootTemplateMap::iterator itr = m_LootTemplates.begin(); itr != m_LootTemplates.end();)
+    {
+        if (templates.find(itr->first) == templates.end())
+        {
+            delete itr->second;
+            m_LootTemplates.erase(itr++);
+            ++removed;
+        }
+        else
+        {
+            ++itr;
+        }
     }
-    else
+
+    for (LootTemplateMap::iterator itr = templates.begin(); itr != templates.end(); ++itr)
     {
-        sLog.outString();
-        sLog.outErrorDb(">> Loaded 0 loot definitions. DB table `%s` is empty.", GetName());
+        LootTemplateMap::iterator loaded = m_LootTemplates.find(itr->first);
+        if (loaded == m_LootTemplates.end())
+        {
+            m_LootTemplates[itr->first] = itr->second;
+            ++changed;
+        }
+        else if (!loaded->second->IsSameAs(*itr->second))
+        {
+            delete loaded->second;
+            loaded->second = itr->second;
+            ++changed;
+        }
+        else
+        {
+            delete itr->second;
+        }
     }
+
+    templates.clear();
 }
 
 bool LootStore::HaveQuestLootFor(uint32 loot_id) const
@@ -326,6 +403,13 @@ bool LootStoreItem::Roll(bool rate) const
 }
 
 // Checks correctness of values
+bool LootStoreItem::operator==(LootStoreItem const& other) const
+{
+    return itemid == other.itemid && chance == other.chance && mincountOrRef == other.mincountOrRef &&
+           group == other.group && needs_quest == other.needs_quest && maxcount == other.maxcount &&
+           conditionId == other.conditionId;
+}
+
 bool LootStoreItem::IsValid(LootStore const& store, uint32 entry) const
 {
     if (group >= 1 << 7)                                    // it stored in 7 bit field
@@ -1022,6 +1106,25 @@ void LootTemplate::LootGroup::AddEntry(LootStoreItem& item)
 // Rolls an item from the group, returns NULL if all miss their chances
 LootStoreItem const* LootTemplate::LootGroup::Roll() const
 {
+    if (!AliasOutcome.empty())                              // Same odds as below, at the cost of a single pick
+    {
+        uint32 slot = urand(0, AliasOutcome.size() - 1);
+        uint32 outcome = rand_norm_f() < AliasChance[slot] ? slot : AliasOutcome[slot];
+
+        if (outcome < ExplicitlyChanced.size())
+        {
+            return &ExplicitlyChanced[outcome];
+        }
+
+        outcome -= ExplicitlyChanced.size();
+        if (outcome < EqualChanced.size())
+        {
+            return &EqualChanced[outcome];
+        }
+
+        return NULL;
+    }
+
     if (!ExplicitlyChanced.empty())                         // First explicitly chanced entries are checked
     {
         float Roll = rand_chance_f();
@@ -1188,6 +1291,74 @@ void LootTemplate::LootGroup::Verify(LootStore const& lootstore, uint32 id, uint
     }
 }
 
+bool LootTemplate::LootGroup::IsSameAs(LootGroup const& other) const
+{
+    return ExplicitlyChanced == other.ExplicitlyChanced && EqualChanced == other.EqualChanced;
+}
+
+// Builds the alias table (Vose) giving every outcome the odds of the sequential roll
+void LootTemplate::LootGroup::Compile()
+{
+    AliasChance.clear();
+    AliasOutcome.clear();
+
+    if (ExplicitlyChanced.size() + EqualChanced.size() < LOOT_GROUP_ALIAS_MIN_ENTRIES)
+    {
+        return;
+    }
+
+    // an explicit entry takes the part of the 100% roll left by the entries before it
+    std::vector<double> weights;
+    double left = 100.0;
+    for (LootStoreItemList::const_iterator itr = ExplicitlyChanced.begin(); itr != ExplicitlyChanced.end(); ++itr)
+    {
+        double weight = std::max(0.0, std::min(double(itr->chance), left));
+        weights.push_back(weight);
+        left -= weight;
+    }
+
+    for (LootStoreItemList::const_iterator itr = EqualChanced.begin(); itr != EqualChanced.end(); ++itr)
+    {
+        weights.push_back(left / EqualChanced.size());
+    }
+
+    if (EqualChanced.empty())
+    {
+        weights.push_back(left);                            // empty drop
+    }
+
+    uint32 count = weights.size();
+    std::vector<double> scaled(count);
+    std::vector<uint32> small, large;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        scaled[i] = weights[i] * count / 100.0;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    AliasChance.assign(count, 1.0f);
+    AliasOutcome.resize(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        AliasOutcome[i] = i;
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        uint32 less = small.back();
+        small.pop_back();
+        uint32 more = large.back();
+        large.pop_back();
+
+        AliasChance[less] = float(scaled[less]);
+        AliasOutcome[less] = more;
+
+        scaled[more] -= 1.0 - scaled[less];
+        (scaled[more] < 1.0 ? small : large).push_back(more);
+    }
+    // whatever is left over is 1.0 up to rounding and keeps its own outcome
+}
+
 void LootTemplate::LootGroup::CheckLootRefs(LootIdSet* ref_set) const
 {
     for (LootStoreItemList::const_iterator ieItr = ExplicitlyChanced.begin(); ieItr != ExplicitlyChanced.end(); ++ieItr)
@@ -1242,6 +1413,15 @@ void LootTemplate::AddEntry(LootStoreItem& item)
     }
 }
 
+// Prepares the groups for rolling (after loading stage)
+void LootTemplate::Compile()
+{
+    for (LootGroups::iterator i = Groups.begin(); i != Groups.end(); ++i)
+    {
+        i->Compile();
+    }
+}
+
 // Rolls for every item in the template and adds the rolled items the the loot
 void LootTemplate::Process(Loot& loot, LootStore const& store, bool rate, uint8 groupId) const
 {
@@ -1486,6 +1666,24 @@ void LootTemplate::Verify(LootStore const& lootstore, uint32 id) const
     // TODO: References validity checks
 }
 
+bool LootTemplate::IsSameAs(LootTemplate const& other) const
+{
+    if (Entries != other.Entries || Groups.size() != other.Groups.size())
+    {
+        return false;
+    }
+
+    for (uint32 i = 0; i < Groups.size(); ++i)
+    {
+        if (!Groups[i].IsSameAs(other.Groups[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void LootTemplate::CheckLootRefs(LootIdSet* ref_set) const
 {
     for (LootStoreItemList::const_iterator ieItr = Entries.begin(); ieItr != Entries.end(); ++ieItr)
@@ -1758,3 +1956,104 @@ void LoadLootTemplates_Reference()
     // output error for any still listed ids (not referenced from any loot table)
     LootTemplates_Reference.ReportUnusedIds(ids_set);
 }
+
+static LootStore* const s_deltaReloadStores[] =
+{
+    &LootTemplates_Creature,
+    &LootTemplates_Fishing,
+    &LootTemplates_Gameobject,
+    &LootTemplates_Item,
+    &LootTemplates_Mail,
+    &LootTemplates_Pickpocketing,
+    &LootTemplates_Skinning,
+    &LootTemplates_Disenchant,
+    &LootTemplates_Reference
+};
+
+#define MAX_DELTA_RELOAD_STORES (sizeof(s_deltaReloadStores) / sizeof(s_deltaReloadStores[0]))
+
+// Reads every loot table into its own template map, the world thread swaps the result in later
+class LootTablesReloadTask : public ACE_Task_Base
+{
+    public:
+        LootTablesReloadTask() : m_finished(0) {}
+
+        virtual int svc()
+        {
+            for (uint32 i = 0; i < MAX_DELTA_RELOAD_STORES; ++i)
+            {
+                s_deltaReloadStores[i]->ReadLootTable(m_templates[i]);
+            }
+
+            m_finished = 1;
+            return 0;
+        }
+
+        bool IsFinished() const { return m_finished.value() != 0; }
+
+        void Apply()
+        {
+            uint32 totalChanged = 0;
+            uint32 totalRemoved = 0;
+
+            for (uint32 i = 0; i < MAX_DELTA_RELOAD_STORES; ++i)
+            {
+                uint32 changed, removed;
+                s_deltaReloadStores[i]->ApplyLootTable(m_templates[i], changed, removed);
+
+                if (changed || removed)
+                {
+                    sLog.outString("Table %s: %u templates changed, %u removed", s_deltaReloadStores[i]->GetName(), changed, removed);
+                }
+
+                totalChanged += changed;
+                totalRemoved += removed;
+            }
+
+            // references may point into any of the swapped stores
+            for (uint32 i = 0; i < MAX_DELTA_RELOAD_STORES; ++i)
+            {
+                s_deltaReloadStores[i]->CheckLootRefs();
+            }
+
+            sLog.outString(">> Delta reload of loot tables applied: %u templates changed, %u removed", totalChanged, totalRemoved);
+        }
+
+    private:
+        LootTemplateMap m_templates[MAX_DELTA_RELOAD_STORES];
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_finished;
+};
+
+static LootTablesReloadTask* s_lootTablesReloadTask = NULL;
+
+bool StartLootTablesDeltaReload()
+{
+    if (s_lootTablesReloadTask)
+    {
+        return false;
+    }
+
+    s_lootTablesReloadTask = new LootTablesReloadTask();
+
+    if (s_lootTablesReloadTask->activate(THR_NEW_LWP | THR_JOINABLE) == -1)
+    {
+        sLog.outError("Can't start the loot tables reload thread, loading in the world thread");
+        s_lootTablesReloadTask->svc();
+    }
+
+    return true;
+}
+
+void UpdateLootTablesDeltaReload()
+{
+    if (!s_lootTablesReloadTask || !s_lootTablesReloadTask->IsFinished())
+    {
+        return;
+    }
+
+    s_lootTablesReloadTask->wait();
+    s_lootTablesReloadTask->Apply();
+
+    delete s_lootTablesReloadTask;
+    s_lootTablesReloadTask = NULL;
+}
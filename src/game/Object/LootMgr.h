@@ -92,6 +92,8 @@ struct LootStoreItem
     bool Roll(bool rate) const;                             // Checks if the entry takes it's chance (at loot generation)
     bool IsValid(LootStore const& store, uint32 entry) const;
     // Checks correctness of values
+
+    bool operator==(LootStoreItem const& other) const;      // Same DB row content, used by delta reload
 };
 
 struct LootItem
@@ -185,6 +187,12 @@ class LootStore
         char const* GetName() const { return m_name; }
         char const* GetEntryName() const { return m_entryName; }
         bool IsRatesAllowed() const { return m_ratesAllowed; }
+        size_t GetTemplateCount() const { return m_LootTemplates.size(); }
+
+        // Reads, verifies and compiles the DB table into templates without touching the loaded ones, safe outside the world thread
+        uint32 ReadLootTable(LootTemplateMap& templates) const;
+        // Keeps the loaded templates equal to the read ones and replaces the rest, takes ownership of templates
+        void ApplyLootTable(LootTemplateMap& templates, uint32& changed, uint32& removed);
     protected:
         void LoadLootTable();
         void Clear();
@@ -203,6 +211,8 @@ class LootTemplate
     public:
         // Adds an entry to the group (at loading stage)
         void AddEntry(LootStoreItem& item);
+        // Prepares the groups for rolling (after loading stage)
+        void Compile();
         // Rolls for every item in the template and adds the rolled items the the loot
         void Process(Loot& loot, LootStore const& store, bool rate, uint8 GroupId = 0) const;
 
@@ -234,6 +244,8 @@ class LootTemplate
         // Checks integrity of the template
         void Verify(LootStore const& store, uint32 Id) const;
         void CheckLootRefs(LootIdSet* ref_set) const;
+        // True if both templates were loaded from the same DB rows
+        bool IsSameAs(LootTemplate const& other) const;
     private:
         LootStoreItemList Entries;                          // not grouped only
         LootGroups        Groups;                           // groups have own (optimised) processing, grouped entries go there
@@ -413,4 +425,9 @@ inline void LoadLootTables()
     LoadLootTemplates_Reference();
 }
 
+// Starts reading all loot tables on a background thread, false if the previous reload is not applied yet
+bool StartLootTablesDeltaReload();
+// Swaps in the templates changed by a finished background reload, must be called from the world thread
+void UpdateLootTablesDeltaReload();
+
 #endif
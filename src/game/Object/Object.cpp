@@ -61,6 +61,7 @@ Object::Object()
 
     m_inWorld           = false;
     m_objectUpdated     = false;
+    m_clientUpdateIndex = CLIENT_UPDATE_INDEX_NONE;
 }
 
 Object::~Object()
@@ -86,7 +87,7 @@ void Object::_InitValues()
     m_uint32Values = new uint32[ m_valuesCount ];
     memset(m_uint32Values, 0, m_valuesCount * sizeof(uint32));
 
-    m_changedValues.resize(m_valuesCount, false);
+    m_changedValues.SetCount(m_valuesCount);
 
     m_objectUpdated = false;
 }
@@ -356,186 +357,171 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     // 2 specialized loops for speed optimization in non-unit case
     if (isType(TYPEMASK_UNIT))                              // unit (creature/player) case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->FindNextBit(0); index < m_valuesCount; index = updateMask->FindNextBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            if (index == UNIT_NPC_FLAGS)
             {
-                if (index == UNIT_NPC_FLAGS)
-                {
-                    uint32 appendValue = m_uint32Values[index];
+                uint32 appendValue = m_uint32Values[index];
 
-                    if (GetTypeId() == TYPEID_UNIT)
+                if (GetTypeId() == TYPEID_UNIT)
+                {
+                    if (appendValue & UNIT_NPC_FLAG_TRAINER)
                     {
-                        if (appendValue & UNIT_NPC_FLAG_TRAINER)
+                        if (!((Creature*)this)->IsTrainerOf(target, false))
                         {
-                            if (!((Creature*)this)->IsTrainerOf(target, false))
-                            {
-                                appendValue &= ~UNIT_NPC_FLAG_TRAINER;
-                            }
+                            appendValue &= ~UNIT_NPC_FLAG_TRAINER;
                         }
+                    }
 
-                        if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
+                    if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
+                    {
+                        if (target->getClass() != CLASS_HUNTER)
                         {
-                            if (target->getClass() != CLASS_HUNTER)
-                            {
-                                appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
-                            }
+                            appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
                         }
                     }
-
-                    *data << uint32(appendValue);
-                }
-                // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-                else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
-                {
-                    // convert from float to uint32 and send
-                    *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
                 }
 
-                // there are some float values which may be negative or can't get negative due to other checks
-                else if ((index >= PLAYER_FIELD_NEGSTAT0    && index <= PLAYER_FIELD_NEGSTAT4) ||
-                         (index >= PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
-                         (index >= PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
-                         (index >= PLAYER_FIELD_POSSTAT0    && index <= PLAYER_FIELD_POSSTAT4))
-                {
-                    *data << uint32(m_floatValues[index]);
-                }
+                *data << uint32(appendValue);
+            }
+            // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+            else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
+            {
+                // convert from float to uint32 and send
+                *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+            }
 
-                // Gamemasters should be always able to select units - remove not selectable flag
-                else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
-                {
-                    *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
-                }
-                /* Hide loot animation for players that aren't permitted to loot the corpse */
-                else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
-                {
-                    uint32 send_value = m_uint32Values[index];
+            // there are some float values which may be negative or can't get negative due to other checks
+            else if ((index >= PLAYER_FIELD_NEGSTAT0    && index <= PLAYER_FIELD_NEGSTAT4) ||
+                     (index >= PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
+                     (index >= PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
+                     (index >= PLAYER_FIELD_POSSTAT0    && index <= PLAYER_FIELD_POSSTAT4))
+            {
+                *data << uint32(m_floatValues[index]);
+            }
 
-                    /* Initiate pointer to creature so we can check loot */
-                    if (Creature* my_creature = (Creature*)this)
+            // Gamemasters should be always able to select units - remove not selectable flag
+            else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
+            {
+                *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
+            }
+            /* Hide loot animation for players that aren't permitted to loot the corpse */
+            else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
+            {
+                uint32 send_value = m_uint32Values[index];
+
+                /* Initiate pointer to creature so we can check loot */
+                if (Creature* my_creature = (Creature*)this)
+                {
+                    /* If the creature is NOT fully looted */
+                    if (!my_creature->loot.isLooted())
                     {
-                        /* If the creature is NOT fully looted */
-                        if (!my_creature->loot.isLooted())
+                        /* If the lootable flag is NOT set */
+                        if (!(send_value & UNIT_DYNFLAG_LOOTABLE))
                         {
-                            /* If the lootable flag is NOT set */
-                            if (!(send_value & UNIT_DYNFLAG_LOOTABLE))
-                            {
-                                /* Update it on the creature */
-                                my_creature->SetFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE);
-                                /* Update it in the packet */
-                                send_value = send_value | UNIT_DYNFLAG_LOOTABLE;
-                            }
+                            /* Update it on the creature */
+                            my_creature->SetFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE);
+                            /* Update it in the packet */
+                            send_value = send_value | UNIT_DYNFLAG_LOOTABLE;
                         }
                     }
-                    /* If we're not allowed to loot the target, destroy the lootable flag */
-                    if (!target->isAllowedToLoot((Creature*)this))
+                }
+                /* If we're not allowed to loot the target, destroy the lootable flag */
+                if (!target->isAllowedToLoot((Creature*)this))
+                {
+                    if (send_value & UNIT_DYNFLAG_LOOTABLE)
                     {
-                        if (send_value & UNIT_DYNFLAG_LOOTABLE)
-                        {
-                            send_value = send_value & ~UNIT_DYNFLAG_LOOTABLE;
-                        }
+                        send_value = send_value & ~UNIT_DYNFLAG_LOOTABLE;
                     }
+                }
 
-                    /* If we are allowed to loot it and mob is tapped by us, destroy the tapped flag */
-                    bool is_tapped = target->IsTappedByMeOrMyGroup((Creature*)this);
+                /* If we are allowed to loot it and mob is tapped by us, destroy the tapped flag */
+                bool is_tapped = target->IsTappedByMeOrMyGroup((Creature*)this);
 
-                    /* If the creature has tapped flag but is tapped by us, remove the flag */
-                    if (send_value & UNIT_DYNFLAG_TAPPED && is_tapped)
-                    {
-                        send_value = send_value & ~UNIT_DYNFLAG_TAPPED;
-                    }
+                /* If the creature has tapped flag but is tapped by us, remove the flag */
+                if (send_value & UNIT_DYNFLAG_TAPPED && is_tapped)
+                {
+                    send_value = send_value & ~UNIT_DYNFLAG_TAPPED;
+                }
 
-                    // Checking SPELL_AURA_EMPATHY and caster
-                    if (send_value & UNIT_DYNFLAG_SPECIALINFO && ((Unit*)this)->IsAlive())
+                // Checking SPELL_AURA_EMPATHY and caster
+                if (send_value & UNIT_DYNFLAG_SPECIALINFO && ((Unit*)this)->IsAlive())
+                {
+                    bool bIsEmpathy = false;
+                    bool bIsCaster = false;
+                    Unit::AuraList const& mAuraEmpathy = ((Unit*)this)->GetAurasByType(SPELL_AURA_EMPATHY);
+                    for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
                     {
-                        bool bIsEmpathy = false;
-                        bool bIsCaster = false;
-                        Unit::AuraList const& mAuraEmpathy = ((Unit*)this)->GetAurasByType(SPELL_AURA_EMPATHY);
-                        for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
+                        bIsEmpathy = true; // Empathy by aura set
+                        if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
                         {
-                            bIsEmpathy = true; // Empathy by aura set
-                            if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
-                            {
-                                bIsCaster = true; // target is the caster of an empathy aura
-                            }
-                        }
-                        if (bIsEmpathy && !bIsCaster) // Empathy by aura, but target is not the caster
-                        {
-                            send_value &= ~UNIT_DYNFLAG_SPECIALINFO;
+                            bIsCaster = true; // target is the caster of an empathy aura
                         }
                     }
-
-                    *data << send_value;
-                }
-                else                                        // Unhandled index, just send
-                {
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[index];
+                    if (bIsEmpathy && !bIsCaster) // Empathy by aura, but target is not the caster
+                    {
+                        send_value &= ~UNIT_DYNFLAG_SPECIALINFO;
+                    }
                 }
+
+                *data << send_value;
+            }
+            else                                        // Unhandled index, just send
+            {
+                // send in current format (float as float, uint32 as uint32)
+                *data << m_uint32Values[index];
             }
         }
     }
     else if (isType(TYPEMASK_GAMEOBJECT))                   // gameobject case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->FindNextBit(0); index < m_valuesCount; index = updateMask->FindNextBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            // send in current format (float as float, uint32 as uint32)
+            if (index == GAMEOBJECT_DYN_FLAGS)
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYN_FLAGS)
+                if (IsActivateToQuest)
                 {
-                    if (IsActivateToQuest)
-                    {
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_QUESTGIVER:
-                            case GAMEOBJECT_TYPE_CHEST:
-                            case GAMEOBJECT_TYPE_GENERIC:
-                            case GAMEOBJECT_TYPE_SPELL_FOCUS:
-                            case GAMEOBJECT_TYPE_GOOBER:
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
-                                *data << uint16(0);
-                                break;
-                            default:
-                                *data << uint32(0);         // unknown, not happen.
-                                break;
-                        }
-                    }
-                    else
+                    switch (((GameObject*)this)->GetGoType())
                     {
-                        // disable quest object
-                        *data << uint32(0);
+                        case GAMEOBJECT_TYPE_QUESTGIVER:
+                        case GAMEOBJECT_TYPE_CHEST:
+                        case GAMEOBJECT_TYPE_GENERIC:
+                        case GAMEOBJECT_TYPE_SPELL_FOCUS:
+                        case GAMEOBJECT_TYPE_GOOBER:
+                            *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
+                            *data << uint16(0);
+                            break;
+                        default:
+                            *data << uint32(0);         // unknown, not happen.
+                            break;
                     }
                 }
                 else
                 {
-                    *data << m_uint32Values[index];          // other cases
+                    // disable quest object
+                    *data << uint32(0);
                 }
             }
+            else
+            {
+                *data << m_uint32Values[index];          // other cases
+            }
         }
     }
     else                                                    // other objects case (no special index checks)
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->FindNextBit(0); index < m_valuesCount; index = updateMask->FindNextBit(index + 1))
         {
-            if (updateMask->GetBit(index))
-            {
-                // send in current format (float as float, uint32 as uint32)
-                *data << m_uint32Values[index];
-            }
+            // send in current format (float as float, uint32 as uint32)
+            *data << m_uint32Values[index];
         }
     }
 }
 
 void Object::ClearUpdateMask(bool remove)
 {
-    if (m_uint32Values)
-    {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
-        {
-            m_changedValues[index] = false;
-        }
-    }
+    m_changedValues.Clear();
 
     if (m_objectUpdated)
     {
@@ -573,11 +559,7 @@ bool Object::LoadValues(const char* data)
 
 void Object::_SetUpdateBits(UpdateMask* updateMask, Player* /*target*/) const
 {
-    for (uint16 index = 0; index < m_valuesCount; ++index)
-        if (m_changedValues[index])
-        {
-            updateMask->SetBit(index);
-        }
+    *updateMask |= m_changedValues;
 }
 
 void Object::_SetCreateBits(UpdateMask* updateMask, Player* /*target*/) const
@@ -596,7 +578,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
     if (m_int32Values[index] != value)
     {
         m_int32Values[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -608,7 +590,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     if (m_uint32Values[index] != value)
     {
         m_uint32Values[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -618,7 +600,7 @@ void Object::UpdateUInt32Value(uint16 index, uint32 value)
     MANGOS_ASSERT(index < m_valuesCount || PrintIndexError(index, true));
 
     m_uint32Values[index] = value;
-    m_changedValues[index] = true;
+    m_changedValues.SetBit(index);
 }
 
 void Object::SetUInt64Value(uint16 index, const uint64& value)
@@ -628,8 +610,8 @@ void Object::SetUInt64Value(uint16 index, const uint64& value)
     {
         m_uint32Values[index] = *((uint32*)&value);
         m_uint32Values[index + 1] = *(((uint32*)&value) + 1);
-        m_changedValues[index] = true;
-        m_changedValues[index + 1] = true;
+        m_changedValues.SetBit(index);
+        m_changedValues.SetBit(index + 1);
         MarkForClientUpdate();
     }
 }
@@ -641,7 +623,7 @@ void Object::SetFloatValue(uint16 index, float value)
     if (m_floatValues[index] != value)
     {
         m_floatValues[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -660,7 +642,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -679,7 +661,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 16));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -744,13 +726,13 @@ void Object::MarkFlagUpdateForClient(uint16 index)
 {
     MANGOS_ASSERT(index < m_valuesCount || PrintIndexError(index, true));
 
-    m_changedValues[index] = true;
+    m_changedValues.SetBit(index);
     MarkForClientUpdate();
 }
 
 void Object::ForceValuesUpdateAtIndex(uint16 index)
 {
-    m_changedValues[index] = true;
+    m_changedValues.SetBit(index);
     if (m_inWorld && !m_objectUpdated)
     {
         AddToClientUpdateList();
@@ -767,7 +749,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -781,7 +763,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -799,7 +781,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     if (!(uint8(m_uint32Values[index] >> (offset * 8)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -817,7 +799,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     if (uint8(m_uint32Values[index] >> (offset * 8)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -829,7 +811,7 @@ void Object::SetShortFlag(uint16 index, bool highpart, uint16 newFlag)
     if (!(uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -841,7 +823,7 @@ void Object::RemoveShortFlag(uint16 index, bool highpart, uint16 oldFlag)
     if (uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -864,6 +846,12 @@ bool Object::PrintEntryError(char const* descr) const
 
 void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players)
 {
+    // bots and players without a socket would drop the packet anyway
+    if (!pl->GetSession()->IsPacketWanted(SMSG_UPDATE_OBJECT))
+    {
+        return;
+    }
+
     UpdateDataMapType::iterator iter = update_players.find(pl);
 
     if (iter == update_players.end())
@@ -912,7 +900,8 @@ WorldObject::WorldObject() :
 #endif /* ENABLE_ELUNA */
     m_currMap(NULL),
     m_mapId(0), m_InstanceId(0),
-    m_isActiveObject(false)
+    m_isActiveObject(false),
+    m_areaFlagCache(0)
 {
 }
 
@@ -976,19 +965,62 @@ void WorldObject::SetOrientation(float orientation)
     }
 }
 
+// zone/area lookups are repeated for the same spot many times per tick, the result is kept per object for a small cell
+#define AREA_CACHE_CELL_SIZE        (SIZE_OF_GRIDS / 128.0f)    // ~4.2 yards, the resolution of the liquid map
+#define AREA_CACHE_HEIGHT_BAND      4.0f
+
+#define AREA_CACHE_VALID            (uint64(1) << 63)
+#define AREA_CACHE_OUTDOORS         (uint64(1) << 16)
+#define AREA_CACHE_KEY_MASK         (~uint64(0) << 23)
+
+static uint64 AreaCacheKey(float x, float y, float z)
+{
+    // 14 bits per cell coordinate and 12 bits of height band cover every valid position
+    uint64 cellX = uint64(int32(floor(x / AREA_CACHE_CELL_SIZE)) + 0x2000) & 0x3FFF;
+    uint64 cellY = uint64(int32(floor(y / AREA_CACHE_CELL_SIZE)) + 0x2000) & 0x3FFF;
+    uint64 band = uint64(int32(floor(z / AREA_CACHE_HEIGHT_BAND)) + 0x800) & 0xFFF;
+    return AREA_CACHE_VALID | (cellX << 49) | (cellY << 35) | (band << 23);
+}
+
+uint16 WorldObject::GetAreaFlag(bool* isOutdoors) const
+{
+    uint64 key = AreaCacheKey(m_position.x, m_position.y, m_position.z);
+
+    uint64 cached = m_areaFlagCache.load(std::memory_order_relaxed);
+    if ((cached & AREA_CACHE_KEY_MASK) != key)
+    {
+        bool outdoors;
+        uint16 areaFlag = GetMap()->GetTerrain()->GetAreaFlag(m_position.x, m_position.y, m_position.z, &outdoors);
+        cached = key | (outdoors ? AREA_CACHE_OUTDOORS : 0) | areaFlag;
+        m_areaFlagCache.store(cached, std::memory_order_relaxed);
+    }
+
+    if (isOutdoors)
+    {
+        *isOutdoors = (cached & AREA_CACHE_OUTDOORS) != 0;
+    }
+    return uint16(cached & 0xFFFF);
+}
+
+void WorldObject::SetAreaFlagHint(uint16 areaFlag, bool isOutdoors)
+{
+    uint64 key = AreaCacheKey(m_position.x, m_position.y, m_position.z);
+    m_areaFlagCache.store(key | (isOutdoors ? AREA_CACHE_OUTDOORS : 0) | areaFlag, std::memory_order_relaxed);
+}
+
 uint32 WorldObject::GetZoneId() const
 {
-    return GetMap()->GetTerrain()->GetZoneId(m_position.x, m_position.y, m_position.z);
+    return TerrainManager::GetZoneIdByAreaFlag(GetAreaFlag(), m_mapId);
 }
 
 uint32 WorldObject::GetAreaId() const
 {
-    return GetMap()->GetTerrain()->GetAreaId(m_position.x, m_position.y, m_position.z);
+    return TerrainManager::GetAreaIdByAreaFlag(GetAreaFlag(), m_mapId);
 }
 
 void WorldObject::GetZoneAndAreaId(uint32& zoneid, uint32& areaid) const
 {
-    GetMap()->GetTerrain()->GetZoneAndAreaId(zoneid, areaid, m_position.x, m_position.y, m_position.z);
+    TerrainManager::GetZoneAndAreaIdByAreaFlag(zoneid, areaid, GetAreaFlag(), m_mapId);
 }
 
 InstanceData* WorldObject::GetInstanceData() const
@@ -1578,6 +1610,8 @@ void WorldObject::SetMap(Map* map)
     // lets save current map's Id/instanceId
     m_mapId = map->GetId();
     m_InstanceId = map->GetInstanceId();
+    // the same cell on another map has other areas
+    m_areaFlagCache.store(0, std::memory_order_relaxed);
 
 #ifdef ENABLE_ELUNA
     if (!elunaEvents)
@@ -29,11 +29,13 @@
 #include "ByteBuffer.h"
 #include "UpdateFields.h"
 #include "UpdateData.h"
+#include "UpdateMask.h"
 #include "ObjectGuid.h"
 #include "Camera.h"
 #include "GameTime.h"
 
 #include <set>
+#include <atomic>
 
 #define CONTACT_DISTANCE            0.5f
 #define INTERACTION_DISTANCE        5.0f
@@ -51,6 +53,8 @@
 
 #define MAX_STEALTH_DETECT_RANGE    45.0f
 
+#define CLIENT_UPDATE_INDEX_NONE    0xFFFFFFFF              // object is not queued in any map's client update list
+
 enum TempSpawnType
 {
     TEMPSPAWN_MANUAL_DESPAWN               = 0,             // despawns when UnSummon() is called
@@ -74,7 +78,6 @@ class Player;
 class Unit;
 class Group;
 class Map;
-class UpdateMask;
 class InstanceData;
 class TerrainInfo;
 #ifdef ENABLE_ELUNA
@@ -461,7 +464,7 @@ class Object
             float*  m_floatValues;
         };
 
-        std::vector<bool> m_changedValues;
+        UpdateMask m_changedValues;
         std::map<uint32, uint32> m_plrSpecificFlags;
 
         uint16 m_valuesCount;
@@ -469,11 +472,15 @@ class Object
         bool m_objectUpdated;
 
     private:
+        friend class Map;                                   // maintains m_clientUpdateIndex
+
         bool m_inWorld;
         bool m_isNewObject;
 
         PackedGuid m_PackGUID;
 
+        uint32 m_clientUpdateIndex;                         // slot in the owning map's client update list, or CLIENT_UPDATE_INDEX_NONE
+
         Object(const Object&);                              // prevent generation copy constructor
         Object& operator=(Object const&);                   // prevent generation assigment operator
 
@@ -583,6 +590,10 @@ class WorldObject : public Object
         uint32 GetZoneId() const;
         uint32 GetAreaId() const;
         void GetZoneAndAreaId(uint32& zoneid, uint32& areaid) const;
+        // area flag at the current position, served from a cache while the object stays in the same area cell and height band
+        uint16 GetAreaFlag(bool* isOutdoors = NULL) const;
+        // fills the area cache for the current position with a known area, e.g. from the spawn hints
+        void SetAreaFlagHint(uint16 areaFlag, bool isOutdoors);
 
         InstanceData* GetInstanceData() const;
 
@@ -701,6 +712,9 @@ class WorldObject : public Object
         void SetLocationInstanceId(uint32 _instanceId) { m_InstanceId = _instanceId; }
 
         virtual void StopGroupLoot() {}
+
+        // next update only gets the time passed from now on
+        void ResetUpdateTracker() { m_updateTracker.Reset(); }
         /**
          * @brief 游戏对象名称
         */
@@ -716,6 +730,9 @@ class WorldObject : public Object
         ViewPoint m_viewPoint;
         WorldUpdateCounter m_updateTracker;
         bool m_isActiveObject;
+
+        // area flag, outdoor state and the area cell/height band they were resolved in, packed so other threads read it whole
+        mutable std::atomic<uint64> m_areaFlagCache;
 };
 
 // Helper functions to cast between different Object pointers. Useful when unsure that your object* is valid at all.
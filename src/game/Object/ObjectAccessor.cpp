@@ -41,17 +41,18 @@
 INSTANTIATE_SINGLETON_2(ObjectAccessor, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(ObjectAccessor, ACE_Recursive_Thread_Mutex);
 
-ObjectAccessor::ObjectAccessor() : i_playerMap(), i_corpseMap(), i_corpseGuard()
+ObjectAccessor::ObjectAccessor() : i_player2corpse(), i_playerMap(), i_corpseMap(), i_corpseCellGuard()
 {
 }
 
 ObjectAccessor::~ObjectAccessor()
 {
-    for (Player2CorpsesMapType::const_iterator itr = i_player2corpse.begin(); itr != i_player2corpse.end(); ++itr)
+    i_player2corpse.FindIf([](Corpse* corpse)
     {
-        itr->second->RemoveFromWorld();
-        delete itr->second;
-    }
+        corpse->RemoveFromWorld();
+        delete corpse;
+        return false;
+    });
 }
 
 Unit*
@@ -108,13 +109,10 @@ Player* ObjectAccessor::FindPlayer(ObjectGuid guid, bool inWorld /*= true*/)
 
 Player* ObjectAccessor::FindPlayerByName(const char* name)
 {
-    ACE_READ_GUARD_RETURN(HashMapHolder<Player>::LockType, guard, i_playerMap.GetLock(), nullptr)
-    for (auto& iter : i_playerMap.GetContainer())
-        if (iter.second->IsInWorld() && (::strcmp(name, iter.second->GetName()) == 0))
-        {
-            return iter.second;
-        }
-    return nullptr;
+    return i_playerMap.FindIf([name](Player* player)
+    {
+        return player->IsInWorld() && ::strcmp(name, player->GetName()) == 0;
+    });
 }
 
 //This method should not be here
@@ -146,77 +144,73 @@ void ObjectAccessor::KickPlayer(ObjectGuid guid)
 
 Corpse* ObjectAccessor::GetCorpseForPlayerGUID(ObjectGuid guid)
 {
-    ACE_GUARD_RETURN(LockType, guard, i_corpseGuard, nullptr)
-
-    Player2CorpsesMapType::iterator iter = i_player2corpse.find(guid);
-
-    if (iter == i_player2corpse.end())
-    {
-        return nullptr;
-    }
-
-    MANGOS_ASSERT(iter->second->GetType() != CORPSE_BONES);
-    return iter->second;
+    Corpse* corpse = i_player2corpse.Find(guid);
+    MANGOS_ASSERT(!corpse || corpse->GetType() != CORPSE_BONES);
+    return corpse;
 }
 
-void ObjectAccessor::RemoveCorpse(Corpse* corpse)
+bool ObjectAccessor::RemoveCorpse(Corpse* corpse)
 {
     MANGOS_ASSERT(corpse && corpse->GetType() != CORPSE_BONES);
 
-    ACE_GUARD(LockType, guard, i_corpseGuard)
-
-    Player2CorpsesMapType::iterator iter = i_player2corpse.find(corpse->GetOwnerGuid());
-    if (iter == i_player2corpse.end())
+    // only the thread that takes the corpse out of the index goes on to clean it up
+    if (!i_player2corpse.Remove(corpse->GetOwnerGuid()))
     {
-        return;
+        return false;
     }
 
     // build mapid*cellid -> guid_set map
     CellPair cell_pair = MaNGOS::ComputeCellPair(corpse->GetPositionX(), corpse->GetPositionY());
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-    sObjectMgr.DeleteCorpseCellData(corpse->GetMapId(), cell_id, corpse->GetOwnerGuid().GetCounter());
+    {
+        ACE_GUARD_RETURN(LockType, guard, i_corpseCellGuard, true)
+        sObjectMgr.DeleteCorpseCellData(corpse->GetMapId(), cell_id, corpse->GetOwnerGuid().GetCounter());
+    }
     corpse->RemoveFromWorld();
 
-    i_player2corpse.erase(iter);
+    return true;
 }
 
 void ObjectAccessor::AddCorpse(Corpse* corpse)
 {
     MANGOS_ASSERT(corpse && corpse->GetType() != CORPSE_BONES);
 
-    ACE_GUARD(LockType, guard, i_corpseGuard)
-
-    MANGOS_ASSERT(i_player2corpse.find(corpse->GetOwnerGuid()) == i_player2corpse.end());
-    i_player2corpse[corpse->GetOwnerGuid()] = corpse;
+    MANGOS_ASSERT(!i_player2corpse.Find(corpse->GetOwnerGuid()));
+    i_player2corpse.Insert(corpse->GetOwnerGuid(), corpse);
 
     // build mapid*cellid -> guid_set map
     CellPair cell_pair = MaNGOS::ComputeCellPair(corpse->GetPositionX(), corpse->GetPositionY());
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
+    ACE_GUARD(LockType, guard, i_corpseCellGuard)
     sObjectMgr.AddCorpseCellData(corpse->GetMapId(), cell_id, corpse->GetOwnerGuid().GetCounter(), corpse->GetInstanceId());
 }
 
 void ObjectAccessor::AddCorpsesToGrid(GridPair const& gridpair, GridType& grid, Map* map)
 {
-    ACE_GUARD(LockType, guard, i_corpseGuard)
-
-    for (Player2CorpsesMapType::iterator iter = i_player2corpse.begin(); iter != i_player2corpse.end(); ++iter)
-      if (iter->second->GetGrid() == gridpair)
-      {
-          // verify, if the corpse in our instance (add only corpses which are)
-          if (map->Instanceable())
-          {
-              if (iter->second->GetInstanceId() == map->GetInstanceId())
-              {
-                  grid.AddWorldObject(iter->second);
-              }
-          }
-          else
-          {
-              grid.AddWorldObject(iter->second);
-          }
-      }
+    // walks the owner index one shard at a time, so deaths on other maps are not held up by the grid load
+    i_player2corpse.FindIf([&](Corpse* corpse)
+    {
+        if (corpse->GetGrid() != gridpair)
+        {
+            return false;
+        }
+
+        // verify, if the corpse in our instance (add only corpses which are)
+        if (map->Instanceable())
+        {
+            if (corpse->GetInstanceId() == map->GetInstanceId())
+            {
+                grid.AddWorldObject(corpse);
+            }
+        }
+        else
+        {
+            grid.AddWorldObject(corpse);
+        }
+        return false;
+    });
 }
 
 Corpse* ObjectAccessor::ConvertCorpseForPlayer(ObjectGuid player_guid, bool insignia)
@@ -232,8 +226,11 @@ Corpse* ObjectAccessor::ConvertCorpseForPlayer(ObjectGuid player_guid, bool insi
 
     DEBUG_LOG("Deleting Corpse and spawning bones.");
 
-    // remove corpse from player_guid -> corpse map
-    RemoveCorpse(corpse);
+    // remove corpse from player_guid -> corpse map, another thread may have converted it already
+    if (!RemoveCorpse(corpse))
+    {
+        return nullptr;
+    }
 
     // remove resurrectable corpse from grid object registry (loaded state checked into call)
     // do not load the map if it's not loaded
@@ -292,18 +289,21 @@ Corpse* ObjectAccessor::ConvertCorpseForPlayer(ObjectGuid player_guid, bool insi
 void ObjectAccessor::RemoveOldCorpses()
 {
     time_t now = time(nullptr);
-    Player2CorpsesMapType::iterator next;
-    for (Player2CorpsesMapType::iterator itr = i_player2corpse.begin(); itr != i_player2corpse.end(); itr = next)
-    {
-        next = itr;
-        ++next;
 
-        if (!itr->second->IsExpired(now))
+    // collect first, converting takes the index shard locks for writing
+    std::vector<ObjectGuid> expired;
+    i_player2corpse.FindIf([&](Corpse* corpse)
+    {
+        if (corpse->IsExpired(now))
         {
-            continue;
+            expired.push_back(corpse->GetOwnerGuid());
         }
+        return false;
+    });
 
-        ConvertCorpseForPlayer(itr->first);
+    for (std::vector<ObjectGuid>::const_iterator itr = expired.begin(); itr != expired.end(); ++itr)
+    {
+        ConvertCorpseForPlayer(*itr);
     }
 }
 
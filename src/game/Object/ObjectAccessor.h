@@ -51,44 +51,81 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
         ObjectAccessor(const ObjectAccessor&);
         ObjectAccessor& operator=(const ObjectAccessor&);
 
+        /**
+         * Guid to object map split into shards by guid counter, each shard
+         * with its own lock, so lookups from different threads rarely touch
+         * the same lock. Iteration locks one shard at a time.
+         */
         template <class T>
         struct HashMapHolder
         {
             using MapType = std::unordered_map<ObjectGuid, T*>;
             using LockType = ACE_RW_Thread_Mutex;
 
-            HashMapHolder() : i_lock(nullptr), m_objectMap() {}
+            static const uint32 SHARD_COUNT = 16;           // must be a power of two
 
-            void Insert(T* o)
+            struct Shard
             {
-                ACE_WRITE_GUARD(LockType, guard, i_lock)
-                m_objectMap[o->GetObjectGuid()] = o;
+                Shard() : i_lock(nullptr), m_objectMap() {}
+
+                LockType i_lock;
+                MapType  m_objectMap;
+                char _cache_guard[64];                      // keep neighbour shard locks off this cache line
+            };
+
+            HashMapHolder() {}
+
+            void Insert(T* o) { Insert(o->GetObjectGuid(), o); }
+            void Remove(T* o) { Remove(o->GetObjectGuid()); }
+
+            // Keyed variants, for indexes not keyed by the object's own guid
+            void Insert(ObjectGuid key, T* o)
+            {
+                Shard& shard = GetShard(key);
+                ACE_WRITE_GUARD(LockType, guard, shard.i_lock)
+                shard.m_objectMap[key] = o;
             }
 
-            void Remove(T* o)
+            // Returns false if nothing was stored under the key, so concurrent removers can tell who won
+            bool Remove(ObjectGuid key)
             {
-                ACE_WRITE_GUARD(LockType, guard, i_lock)
-                m_objectMap.erase(o->GetObjectGuid());
+                Shard& shard = GetShard(key);
+                ACE_WRITE_GUARD_RETURN(LockType, guard, shard.i_lock, false)
+                return shard.m_objectMap.erase(key) != 0;
             }
 
             T* Find(ObjectGuid guid)
             {
-                ACE_READ_GUARD_RETURN (LockType, guard, i_lock, nullptr)
-                auto itr = m_objectMap.find(guid);
-                return (itr != m_objectMap.end()) ? itr->second : nullptr;
+                Shard& shard = GetShard(guid);
+                ACE_READ_GUARD_RETURN (LockType, guard, shard.i_lock, nullptr)
+                auto itr = shard.m_objectMap.find(guid);
+                return (itr != shard.m_objectMap.end()) ? itr->second : nullptr;
             }
 
-            inline MapType& GetContainer() { return m_objectMap; }
-            inline LockType& GetLock() { return i_lock; }
+            // Calls f for every stored object until it returns true, holding only the lock of the shard being walked
+            template<typename F>
+            T* FindIf(F&& f)
+            {
+                for (uint32 i = 0; i < SHARD_COUNT; ++i)
+                {
+                    ACE_READ_GUARD_RETURN(LockType, guard, m_shards[i].i_lock, nullptr)
+                    for (auto& iter : m_shards[i].m_objectMap)
+                    {
+                        if (iter.second != nullptr && f(iter.second))
+                        {
+                            return iter.second;
+                        }
+                    }
+                }
+                return nullptr;
+            }
 
-            LockType i_lock;
-            MapType  m_objectMap;
-            char _cache_guard[512];
+            inline Shard& GetShard(ObjectGuid guid) { return m_shards[guid.GetCounter() & (SHARD_COUNT - 1)]; }
 
+            Shard m_shards[SHARD_COUNT];
         };
 
-        using Player2CorpsesMapType = std::unordered_map<ObjectGuid, Corpse*>;
-        using LockType = ACE_Recursive_Thread_Mutex;
+        using LockType = ACE_Thread_Mutex;
 
     public:
 
@@ -107,7 +144,7 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
         Corpse* FindCorpse(ObjectGuid guid);
         Corpse* GetCorpseForPlayerGUID(ObjectGuid guid);
         Corpse* GetCorpseInMap(ObjectGuid guid, uint32 mapid);
-        void RemoveCorpse(Corpse* corpse);
+        bool RemoveCorpse(Corpse* corpse);
         void AddCorpse(Corpse* corpse);
         void AddCorpsesToGrid(GridPair const& gridpair, GridType& grid, Map* map);
         Corpse* ConvertCorpseForPlayer(ObjectGuid player_guid, bool insignia = false);
@@ -122,21 +159,14 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
         template<typename F>
         void DoForAllPlayers(F&& f)
         {
-            ACE_READ_GUARD(HashMapHolder<Player>::LockType, g, i_playerMap.GetLock())
-            for (auto& iter : i_playerMap.GetContainer())
-            {
-                if(iter.second != nullptr)
-                {
-                    std::forward<F>(f)(iter.second);
-                }
-            }
+            i_playerMap.FindIf([&f](Player* player) { f(player); return false; });
         }
 
     private:
-        Player2CorpsesMapType  i_player2corpse;
+        HashMapHolder<Corpse>  i_player2corpse;             // keyed by owner guid
         HashMapHolder<Player>  i_playerMap;
         HashMapHolder<Corpse>  i_corpseMap;
-        LockType i_corpseGuard;
+        LockType i_corpseCellGuard;                         // only guards the corpse cell data in ObjectMgr
 };
 
 #define sObjectAccessor ObjectAccessor::Instance()
@@ -81,6 +81,19 @@ uint32 ObjectGuidGenerator<high>::Generate()
     return m_nextGuid++;
 }
 
+template<HighGuid high>
+uint32 ObjectGuidGenerator<high>::GenerateRange(uint32 count)
+{
+    if (m_nextGuid >= ObjectGuid::GetMaxCounter(high) - count)
+    {
+        sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", ObjectGuid::GetTypeName(high));
+        World::StopNow(ERROR_EXIT_CODE);
+    }
+    uint32 first = m_nextGuid;
+    m_nextGuid += count;
+    return first;
+}
+
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid)
 {
     buf << uint64(guid.GetRawValue());
@@ -113,3 +126,5 @@ template uint32 ObjectGuidGenerator<HIGHGUID_UNIT>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_PET>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_DYNAMICOBJECT>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_CORPSE>::Generate();
+template uint32 ObjectGuidGenerator<HIGHGUID_ITEM>::GenerateRange(uint32 count);
+template uint32 ObjectGuidGenerator<HIGHGUID_CORPSE>::GenerateRange(uint32 count);
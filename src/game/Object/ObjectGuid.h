@@ -232,6 +232,8 @@ class ObjectGuidGenerator
     public:                                                 // modifiers
         void Set(uint32 val) { m_nextGuid = val; }
         uint32 Generate();
+        // reserves count consecutive guids at once, returns the first of them
+        uint32 GenerateRange(uint32 count);
 
     public:                                                 // accessors
         uint32 GetNextAfterMaxUsed() const { return m_nextGuid; }
@@ -240,6 +242,24 @@ class ObjectGuidGenerator
         uint32 m_nextGuid;
 };
 
+// block of guids reserved by ObjectGuidGenerator::GenerateRange, handed out by its owner without locking
+class ObjectGuidLease
+{
+    public:                                                 // constructors
+        ObjectGuidLease() : m_nextGuid(0), m_endGuid(0) {}
+
+    public:                                                 // modifiers
+        void Assign(uint32 first, uint32 count) { m_nextGuid = first; m_endGuid = first + count; }
+        uint32 Take() { return m_nextGuid++; }
+
+    public:                                                 // accessors
+        bool IsEmpty() const { return m_nextGuid == m_endGuid; }
+
+    private:                                                // fields
+        uint32 m_nextGuid;
+        uint32 m_endGuid;
+};
+
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid);
 ByteBuffer& operator>> (ByteBuffer& buf, ObjectGuid&       guid);
 
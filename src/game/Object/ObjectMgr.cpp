@@ -51,10 +51,17 @@
 #include "GridNotifiersImpl.h"
 #include "CellImpl.h"
 #include "DisableMgr.h"
+#include "CharacterLoginCache.h"
+#include "PlayerNameCache.h"
 
 #include "ItemEnchantmentMgr.h"
+#include "VMapFactory.h"
+#include "VMapManager2.h"
 #include <limits>
 
+#include <ace/Task.h>
+#include <ace/Atomic_Op.h>
+
 INSTANTIATE_SINGLETON_1(ObjectMgr);
 
 bool normalizePlayerName(std::string& name)
@@ -212,7 +219,10 @@ ObjectMgr::ObjectMgr() :
     m_GroupIds("Group ids"),
     m_FirstTemporaryCreatureGuid(1),
     m_FirstTemporaryGameObjectGuid(1),
-    DBCLocaleIndex(LOCALE_enUS)
+    m_guidLeases(new ACE_TSS<ObjectGuidLeases>()),
+    DBCLocaleIndex(LOCALE_enUS),
+    m_questGiverStatusGeneration(0),
+    m_conditionGeneration(0)
 {
 }
 
@@ -262,6 +272,8 @@ ObjectMgr::~ObjectMgr()
     {
         itr->second.Clear();
     }
+
+    delete m_guidLeases;
 }
 
 Group* ObjectMgr::GetGroupById(uint32 id) const
@@ -275,7 +287,7 @@ Group* ObjectMgr::GetGroupById(uint32 id) const
     return NULL;
 }
 
-void ObjectMgr::AddLocaleString(std::string const& s, LocaleConstant locale, StringVector& data)
+void ObjectMgr::AddLocaleString(std::string const& s, LocaleConstant locale, std::vector<InternedString>& data)
 {
     if (!s.empty())
     {
@@ -1360,8 +1372,10 @@ void ObjectMgr::LoadCreatureSpells()
 void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
-    //                                                0                       1   2    3
-    QueryResult* result = WorldDatabase.Query("SELECT `creature`.`guid`, `creature`.`id`, `map`, `modelid`,"
+    // replayed from the storage snapshot while none of the tables changed
+    QueryResult* result = QueryWithSnapshot(WorldDatabase, "creature", "iiiiiffffifiiiiiiii", "`creature`, `game_event_creature`, `pool_creature`, `pool_creature_template`",
+                          //          0                       1   2    3
+                          "SELECT `creature`.`guid`, `creature`.`id`, `map`, `modelid`,"
                           //   4             5           6           7           8            9              10         11
                           "`equipment_id`, `position_x`, `position_y`, `position_z`, `orientation`, `spawntimesecs`, `spawndist`, `currentwaypoint`,"
                           //   12         13       14          15            16
@@ -1519,13 +1533,25 @@ void ObjectMgr::LoadCreatures()
     sLog.outString();
 }
 
+static bool HasCellGuid(CellGuidRange const& range, uint32 guid)
+{
+    return std::binary_search(range.first, range.second, guid);
+}
+
 void ObjectMgr::AddCreatureToGrid(uint32 guid, CreatureData const* data)
 {
     CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
     CellObjectGuids& cell_guids = mMapObjectGuids[data->mapid][cell_id];
-    cell_guids.creatures.insert(guid);
+    if (HasCellGuid(GetCellStaticCreatureGuids(data->mapid, cell_id), guid))
+    {
+        cell_guids.hiddenCreatures.erase(guid);
+    }
+    else
+    {
+        cell_guids.creatures.insert(guid);
+    }
 }
 
 void ObjectMgr::RemoveCreatureFromGrid(uint32 guid, CreatureData const* data)
@@ -1534,13 +1560,142 @@ void ObjectMgr::RemoveCreatureFromGrid(uint32 guid, CreatureData const* data)
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
     CellObjectGuids& cell_guids = mMapObjectGuids[data->mapid][cell_id];
-    cell_guids.creatures.erase(guid);
+    if (HasCellGuid(GetCellStaticCreatureGuids(data->mapid, cell_id), guid))
+    {
+        cell_guids.hiddenCreatures.insert(guid);
+    }
+    else
+    {
+        cell_guids.creatures.erase(guid);
+    }
+}
+
+// layout of the file written by src/tools/Extractor_projects/spawn-hints
+#define SPAWN_HINTS_MAGIC           "SPHT"
+#define SPAWN_HINTS_VERSION_MAGIC   "h1.0"
+
+#define SPAWN_HINT_AREA_INFO        0x0001
+#define SPAWN_HINT_LIQUID           0x0002
+
+struct SpawnHintsFileHeader
+{
+    uint32 magic;
+    uint32 versionMagic;
+    uint32 mapVersionMagic;
+    uint32 count;
+};
+
+struct SpawnHintRecord
+{
+    uint32 guid;
+    uint32 mapId;
+    float x;
+    float y;
+    float z;
+    float groundZ;
+    float liquidLevel;
+    float liquidGround;
+    uint32 mogpFlags;
+    int32 adtId;
+    int32 rootId;
+    int32 groupId;
+    uint16 gridArea;
+    uint16 flags;
+};
+
+void ObjectMgr::LoadCreatureSpawnHints()
+{
+    mCreatureSpawnHintMap.clear();
+
+    std::string filename = sWorld.GetDataPath() + "spawnhints.dat";
+    FILE* in = fopen(filename.c_str(), "rb");
+    if (!in)
+    {
+        sLog.outString(">> No spawn hints in %s, creatures query the terrain when spawned", filename.c_str());
+        sLog.outString();
+        return;
+    }
+
+    SpawnHintsFileHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        header.magic != *((uint32 const*)(SPAWN_HINTS_MAGIC)) ||
+        header.versionMagic != *((uint32 const*)(SPAWN_HINTS_VERSION_MAGIC)) ||
+        header.mapVersionMagic != *((uint32 const*)(MAP_VERSION_MAGIC)))
+    {
+        sLog.outError("Spawn hints file '%s' is broken or was made for other map files, not used.", filename.c_str());
+        fclose(in);
+        return;
+    }
+
+    // the tool assumes the server's vmap height calculation
+    if (!VMAP::VMapFactory::createOrGetVMapManager()->isHeightCalcEnabled())
+    {
+        sLog.outString(">> Spawn hints not used, vmap height is disabled");
+        sLog.outString();
+        fclose(in);
+        return;
+    }
+
+    uint32 stale = 0;
+    BarGoLink bar(header.count);
+
+    SpawnHintRecord record;
+    for (uint32 i = 0; i < header.count && fread(&record, sizeof(record), 1, in) == 1; ++i)
+    {
+        bar.step();
+
+        // spawns removed from the DB or moved to another map since the hints were made
+        CreatureData const* data = GetCreatureData(record.guid);
+        if (!data || data->mapid != record.mapId ||
+            DisableMgr::IsVMAPDisabledFor(record.mapId, VMAP::VMAP_DISABLE_AREAFLAG | VMAP::VMAP_DISABLE_HEIGHT | VMAP::VMAP_DISABLE_LIQUIDSTATUS))
+        {
+            ++stale;
+            continue;
+        }
+
+        CreatureSpawnHint hint;
+        hint.posX = record.x;
+        hint.posY = record.y;
+        hint.posZ = record.z;
+        hint.groundZ = record.groundZ;
+        hint.swimDepth = (record.flags & SPAWN_HINT_LIQUID) ? record.liquidLevel - record.liquidGround : 0.0f;
+
+        // same choice as TerrainInfo::GetAreaFlag()
+        hint.areaFlag = record.gridArea;
+        hint.outdoors = true;
+        if (record.flags & SPAWN_HINT_AREA_INFO)
+        {
+            hint.outdoors = (record.mogpFlags & 0x8000) != 0;
+            if (WMOAreaTableEntry const* wmoEntry = GetWMOAreaTableEntryByTripple(record.rootId, record.adtId, record.groupId))
+            {
+                if (AreaTableEntry const* atEntry = GetAreaEntryByAreaID(wmoEntry->areaId))
+                {
+                    hint.areaFlag = atEntry->exploreFlag;
+                }
+            }
+        }
+
+        if (!hint.IsFor(data))
+        {
+            ++stale;
+            continue;
+        }
+
+        mCreatureSpawnHintMap[record.guid] = hint;
+    }
+
+    fclose(in);
+
+    sLog.outString(">> Loaded %u creature spawn hints, %u stale or disabled ones skipped", uint32(mCreatureSpawnHintMap.size()), stale);
+    sLog.outString();
 }
 
 void ObjectMgr::LoadGameObjects()
 {
-    //                                                           0                1              2               3                      4                      5                      6
-    QueryResult* result = WorldDatabase.Query("SELECT `gameobject`.`guid`, `gameobject`.`id`, `gameobject`.`map`, `gameobject`.`position_x`, `gameobject`.`position_y`, `gameobject`.`position_z`, `gameobject`.`orientation`, "
+    // replayed from the storage snapshot while none of the tables changed
+    QueryResult* result = QueryWithSnapshot(WorldDatabase, "gameobject", "iiiffffffffiiiiii", "`gameobject`, `game_event_gameobject`, `pool_gameobject`, `pool_gameobject_template`",
+                          //          0                1              2               3                      4                      5                      6
+                          "SELECT `gameobject`.`guid`, `gameobject`.`id`, `gameobject`.`map`, `gameobject`.`position_x`, `gameobject`.`position_y`, `gameobject`.`position_z`, `gameobject`.`orientation`, "
                           //          7                     8                     9                     10                    11                        12                       13
                           "`gameobject`.`rotation0`, `gameobject`.`rotation1`, `gameobject`.`rotation2`, `gameobject`.`rotation3`, `gameobject`.`spawntimesecs`, `gameobject`.`animprogress`, `gameobject`.`state`, "
                           //                      14                      15                                   16
@@ -1683,7 +1838,14 @@ void ObjectMgr::AddGameobjectToGrid(uint32 guid, GameObjectData const* data)
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
     CellObjectGuids& cell_guids = mMapObjectGuids[data->mapid][cell_id];
-    cell_guids.gameobjects.insert(guid);
+    if (HasCellGuid(GetCellStaticGameobjectGuids(data->mapid, cell_id), guid))
+    {
+        cell_guids.hiddenGameobjects.erase(guid);
+    }
+    else
+    {
+        cell_guids.gameobjects.insert(guid);
+    }
 }
 
 void ObjectMgr::RemoveGameobjectFromGrid(uint32 guid, GameObjectData const* data)
@@ -1692,7 +1854,142 @@ void ObjectMgr::RemoveGameobjectFromGrid(uint32 guid, GameObjectData const* data
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
     CellObjectGuids& cell_guids = mMapObjectGuids[data->mapid][cell_id];
-    cell_guids.gameobjects.erase(guid);
+    if (HasCellGuid(GetCellStaticGameobjectGuids(data->mapid, cell_id), guid))
+    {
+        cell_guids.hiddenGameobjects.insert(guid);
+    }
+    else
+    {
+        cell_guids.gameobjects.erase(guid);
+    }
+}
+
+CellObjectGuids const& ObjectMgr::GetCellObjectGuids(uint16 mapid, uint32 cell_id) const
+{
+    static CellObjectGuids const empty;
+
+    MapObjectGuids::const_iterator mapItr = mMapObjectGuids.find(mapid);
+    if (mapItr == mMapObjectGuids.end())
+    {
+        return empty;
+    }
+
+    CellObjectGuidsMap::const_iterator cellItr = mapItr->second.find(cell_id);
+    return cellItr != mapItr->second.end() ? cellItr->second : empty;
+}
+
+static bool CellSpawnRangeLess(CellSpawnRange const& range, uint32 cell_id)
+{
+    return range.cell_id < cell_id;
+}
+
+static CellSpawnRange const* FindCellSpawnRange(MapSpawnIndexMap const& spawnIndex, uint16 mapid, uint32 cell_id, uint32 const*& guids)
+{
+    MapSpawnIndexMap::const_iterator mapItr = spawnIndex.find(mapid);
+    if (mapItr == spawnIndex.end())
+    {
+        return NULL;
+    }
+
+    MapSpawnIndex const& index = mapItr->second;
+    std::vector<CellSpawnRange>::const_iterator cellItr = std::lower_bound(index.cells.begin(), index.cells.end(), cell_id, CellSpawnRangeLess);
+    if (cellItr == index.cells.end() || cellItr->cell_id != cell_id)
+    {
+        return NULL;
+    }
+
+    guids = &index.guids[0];
+    return &*cellItr;
+}
+
+CellGuidRange ObjectMgr::GetCellStaticCreatureGuids(uint16 mapid, uint32 cell_id) const
+{
+    uint32 const* guids = NULL;
+    if (CellSpawnRange const* range = FindCellSpawnRange(mMapSpawnIndex, mapid, cell_id, guids))
+    {
+        return CellGuidRange(guids + range->creatures, guids + range->gameobjects);
+    }
+
+    return CellGuidRange(NULL, NULL);
+}
+
+CellGuidRange ObjectMgr::GetCellStaticGameobjectGuids(uint16 mapid, uint32 cell_id) const
+{
+    uint32 const* guids = NULL;
+    if (CellSpawnRange const* range = FindCellSpawnRange(mMapSpawnIndex, mapid, cell_id, guids))
+    {
+        return CellGuidRange(guids + range->gameobjects, guids + range->end);
+    }
+
+    return CellGuidRange(NULL, NULL);
+}
+
+void ObjectMgr::BuildCellSpawnIndex()
+{
+    uint32 count = 0;
+    uint32 cells = 0;
+
+    for (MapObjectGuids::iterator mapItr = mMapObjectGuids.begin(); mapItr != mMapObjectGuids.end(); ++mapItr)
+    {
+        std::vector<uint32> cellIds;
+        size_t guidCount = 0;
+        for (CellObjectGuidsMap::const_iterator cellItr = mapItr->second.begin(); cellItr != mapItr->second.end(); ++cellItr)
+        {
+            if (!cellItr->second.creatures.empty() || !cellItr->second.gameobjects.empty())
+            {
+                cellIds.push_back(cellItr->first);
+                guidCount += cellItr->second.creatures.size() + cellItr->second.gameobjects.size();
+            }
+        }
+
+        if (cellIds.empty())
+        {
+            continue;
+        }
+
+        std::sort(cellIds.begin(), cellIds.end());
+
+        MapSpawnIndex& index = mMapSpawnIndex[mapItr->first];
+        index.cells.reserve(cellIds.size());
+        index.guids.reserve(guidCount);
+
+        for (std::vector<uint32>::const_iterator idItr = cellIds.begin(); idItr != cellIds.end(); ++idItr)
+        {
+            CellObjectGuids& cell_guids = mapItr->second[*idItr];
+
+            // the sets are ordered, so are the guids of each cell
+            CellSpawnRange range;
+            range.cell_id = *idItr;
+            range.creatures = index.guids.size();
+            index.guids.insert(index.guids.end(), cell_guids.creatures.begin(), cell_guids.creatures.end());
+            range.gameobjects = index.guids.size();
+            index.guids.insert(index.guids.end(), cell_guids.gameobjects.begin(), cell_guids.gameobjects.end());
+            range.end = index.guids.size();
+            index.cells.push_back(range);
+
+            CellGuidSet().swap(cell_guids.creatures);
+            CellGuidSet().swap(cell_guids.gameobjects);
+        }
+
+        count += guidCount;
+        cells += cellIds.size();
+
+        // cells left without any state, cells with corpses stay
+        for (CellObjectGuidsMap::iterator cellItr = mapItr->second.begin(); cellItr != mapItr->second.end();)
+        {
+            if (cellItr->second.corpses.empty() && cellItr->second.hiddenCreatures.empty() && cellItr->second.hiddenGameobjects.empty())
+            {
+                mapItr->second.erase(cellItr++);
+            }
+            else
+            {
+                ++cellItr;
+            }
+        }
+    }
+
+    sLog.outString(">> Indexed %u static spawns in %u cells", count, cells);
+    sLog.outString();
 }
 
 // name must be checked to correctness (if received) before call this function
@@ -1725,6 +2022,11 @@ bool ObjectMgr::GetPlayerNameByGUID(ObjectGuid guid, std::string& name) const
 
     uint32 lowguid = guid.GetCounter();
 
+    if (sPlayerNameCache.IsLoaded())
+    {
+        return sPlayerNameCache.GetName(lowguid, name);
+    }
+
     QueryResult* result = CharacterDatabase.PQuery("SELECT `name` FROM `characters` WHERE `guid` = '%u'", lowguid);
 
     if (result)
@@ -3060,210 +3362,259 @@ void ObjectMgr::LoadPlayerInfo()
         }
     }
 }
-void ObjectMgr::LoadStandingList(uint32 dateBegin)
+void ObjectMgr::LoadStandingList(uint32 dateBegin, HonorStandingList& allyList, HonorStandingList& hordeList)
 {
-    HonorStanding Standing;
+    allyList.clear();
+    hordeList.clear();
 
-    // needed for reload case
-    AllyHonorStandingList.clear();
-    HordeHonorStandingList.clear();
+    // one ordered pass over the week, with the character values the distribution needs
+    // you need to reach CONFIG_UINT32_MIN_HONOR_KILLS (kills with victim set) to be added in standing list
+    QueryResult* result = CharacterDatabase.PQuery("SELECT `cp`.`guid`, SUM(`cp`.`honor`) AS `honor_sum`, SUM(`cp`.`victim` > 0) AS `kills`, "
+                          "`c`.`race`, `c`.`stored_honor_rating`, `c`.`stored_honorable_kills` "
+                          "FROM `character_honor_cp` `cp` JOIN `characters` `c` ON `c`.`guid` = `cp`.`guid` "
+                          "WHERE `cp`.`TYPE` = %u AND `cp`.`date` BETWEEN %u AND %u AND `cp`.`used`=0 "
+                          "GROUP BY `cp`.`guid`, `c`.`race`, `c`.`stored_honor_rating`, `c`.`stored_honorable_kills` "
+                          "HAVING `kills` >= %u ORDER BY `honor_sum` DESC",
+                          HONORABLE, dateBegin, dateBegin + 7, sWorld.getConfig(CONFIG_UINT32_MIN_HONOR_KILLS));
+    if (!result)
+    {
+        return;
+    }
 
-    uint32 guid, kills, side;
+    HonorStanding standing;
 
-    Field* fields = NULL;
-    QueryResult* result2 = NULL;
-    // this query create an ordered standing list
-    QueryResult* result = CharacterDatabase.PQuery("SELECT `guid`,SUM(`honor`) as honor_sum FROM `character_honor_cp` WHERE `TYPE` = %u AND `date` BETWEEN %u AND %u AND `used`=0 GROUP BY `guid` ORDER BY `honor_sum` DESC", HONORABLE, dateBegin, dateBegin + 7);
-    if (result)
+    do
     {
-        BarGoLink bar(result->GetRowCount());
+        Field* fields = result->Fetch();
 
-        do
+        standing.guid                 = fields[0].GetUInt32();
+        standing.honorPoints          = fields[1].GetFloat();
+        standing.honorKills           = fields[2].GetUInt32();
+        standing.storedRankPoints     = fields[4].GetFloat();
+        standing.storedHonorableKills = fields[5].GetUInt32();
+
+        switch (Player::TeamForRace(fields[3].GetUInt8()))
         {
-            fields = result->Fetch();
-            guid  = fields[0].GetUInt32();
-            side = GetPlayerTeamByGUID(ObjectGuid(HIGHGUID_PLAYER, guid));
+            case ALLIANCE: allyList.push_back(standing); break;
+            case HORDE:    hordeList.push_back(standing); break;
+            default: break;
+        }
+    }
+    while (result->NextRow());
 
-            kills = 0;
-            // kills count with victim setted ( not zero value )
-            result2 = CharacterDatabase.PQuery("SELECT COUNT(*) FROM `character_honor_cp` WHERE `guid` = %u AND `victim`>0 AND `TYPE` = %u AND `date` BETWEEN %u AND %u AND `used`=0", guid, HONORABLE, dateBegin, dateBegin + 7);
-            if (result2)
-            {
-                kills = result2->Fetch()->GetUInt32();
-            }
+    delete result;
 
-            // you need to reach CONFIG_UINT32_MIN_HONOR_KILLS to be added in standing list
-            if (kills < sWorld.getConfig(CONFIG_UINT32_MIN_HONOR_KILLS))
-            {
-                continue;
-            }
+    // make sure all things are sorted
+    std::stable_sort(allyList.begin(), allyList.end());
+    std::stable_sort(hordeList.begin(), hordeList.end());
+}
 
-            Standing.guid = guid;
-            Standing.honorPoints = fields[1].GetUInt32();
-            Standing.honorKills = kills;
+// Recomputes the weekly honor standings in its own thread, the world thread swaps the result in later
+class HonorStandingTask : public ACE_Task_Base
+{
+    public:
+        HonorStandingTask(uint32 dateTop, bool flush) : m_dateTop(dateTop), m_flush(flush), m_finished(0) {}
 
-            if (side == ALLIANCE)
-            {
-                AllyHonorStandingList.push_back(Standing);
-            }
-            else if (side == HORDE)
+        virtual int svc()
+        {
+            if (m_flush)
             {
-                HordeHonorStandingList.push_back(Standing);
+                ObjectMgr::FlushRankPoints(m_dateTop);
             }
 
-            bar.step();
+            uint32 lastWeekBegin = m_dateTop - 7;
+            ObjectMgr::LoadStandingList(lastWeekBegin, m_allyList, m_hordeList);
+
+            // distribution of RP earning without flushing table
+            ObjectMgr::DistributeRankPoints(m_allyList, lastWeekBegin);
+            ObjectMgr::DistributeRankPoints(m_hordeList, lastWeekBegin);
+
+            m_finished = 1;
+            return 0;
         }
-        while (result->NextRow());
 
-        delete result;
-        delete result2;
+        bool IsFinished() const { return m_finished.value() != 0; }
+
+        HonorStandingList& GetAllyList() { return m_allyList; }
+        HonorStandingList& GetHordeList() { return m_hordeList; }
+
+    private:
+        uint32 m_dateTop;
+        bool m_flush;
+        HonorStandingList m_allyList;
+        HonorStandingList m_hordeList;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_finished;
+};
+
+static HonorStandingTask* s_honorStandingTask = NULL;
+
+bool ObjectMgr::StartHonorStandingUpdate(uint32 dateTop, bool flush)
+{
+    if (s_honorStandingTask)
+    {
+        sLog.outError("Honor standing update for %u requested while another one is running, skipped", dateTop);
+        return false;
+    }
+
+    s_honorStandingTask = new HonorStandingTask(dateTop, flush);
 
-        // make sure all things are sorted
-        AllyHonorStandingList.sort();
-        HordeHonorStandingList.sort();
+    if (s_honorStandingTask->activate(THR_NEW_LWP | THR_JOINABLE) == -1)
+    {
+        sLog.outError("Can't start the honor standing thread, computing in the world thread");
+        s_honorStandingTask->svc();
     }
+
+    return true;
 }
 
-void ObjectMgr::LoadStandingList()
+static void BuildStandingPositions(HonorStandingList const& list, HonorStandingPositionMap& positions)
 {
+    positions.clear();
+    positions.reserve(list.size());
 
-    uint32 LastWeekBegin = sWorld.GetDateLastMaintenanceDay() - 7;
-    LoadStandingList(LastWeekBegin);
+    for (uint32 i = 0; i < list.size(); ++i)
+    {
+        positions[list[i].guid] = i + 1;
+    }
+}
 
-    // distribution of RP earning without flushing table
-    DistributeRankPoints(ALLIANCE, LastWeekBegin);
-    DistributeRankPoints(HORDE, LastWeekBegin);
+bool ObjectMgr::UpdateHonorStandingTask(bool wait /*= false*/)
+{
+    if (!s_honorStandingTask || (!wait && !s_honorStandingTask->IsFinished()))
+    {
+        return false;
+    }
+
+    s_honorStandingTask->wait();
+
+    AllyHonorStandingList.swap(s_honorStandingTask->GetAllyList());
+    HordeHonorStandingList.swap(s_honorStandingTask->GetHordeList());
+    BuildStandingPositions(AllyHonorStandingList, m_allyStandingPositions);
+    BuildStandingPositions(HordeHonorStandingList, m_hordeStandingPositions);
+
+    delete s_honorStandingTask;
+    s_honorStandingTask = NULL;
+
+    // the stored ranks of offline characters have changed too
+    sCharacterLoginCache.Clear();
 
-    sLog.outString();
     sLog.outString(">> Loaded %lu Horde and %lu Ally honor standing definitions", HordeHonorStandingList.size(), AllyHonorStandingList.size());
+    return true;
+}
+
+void ObjectMgr::LoadStandingList()
+{
+    // a maintenance started with the server already computes the same standings
+    if (!s_honorStandingTask)
+    {
+        StartHonorStandingUpdate(sWorld.GetDateLastMaintenanceDay(), false);
+    }
+
+    UpdateHonorStandingTask(true);
+    sLog.outString();
 }
 
 void ObjectMgr::FlushRankPoints(uint32 dateTop)
 {
     // FLUSH CP
-    QueryResult* result = CharacterDatabase.PQuery("SELECT `date` FROM `character_honor_cp` WHERE `TYPE` = %u AND `date` <= %u AND `used`=0 GROUP BY `date` ORDER BY `date` DESC", HONORABLE, dateTop);
+    QueryResult* result = CharacterDatabase.PQuery("SELECT MIN(`date`) FROM `character_honor_cp` WHERE `TYPE` = %u AND `date` <= %u AND `used`=0", HONORABLE, dateTop);
     if (result)
     {
-        uint32 date;
-        bool flush;
-        uint32 WeekBegin = dateTop - 7;
-        // search latest non-processed date if the server has been offline for different weeks
-        do
+        uint32 date = result->Fetch()->GetUInt32();
+        delete result;
+
+        if (date)
         {
-            date = result->Fetch()->GetUInt32();
+            HonorStandingList allyList;
+            HonorStandingList hordeList;
+
+            uint32 WeekBegin = dateTop - 7;
+            // search latest non-processed date if the server has been offline for different weeks
             while (WeekBegin && date < WeekBegin)
             {
                 WeekBegin -= 7;
             }
-        }
-        while (result->NextRow());
 
-        // start to flush from latest non-processed date to up
-        while (WeekBegin <= dateTop)
-        {
-            LoadStandingList(WeekBegin);
+            // start to flush from latest non-processed date to up
+            while (WeekBegin <= dateTop)
+            {
+                LoadStandingList(WeekBegin, allyList, hordeList);
 
-            flush = WeekBegin <= dateTop - 7; // flush only with date < lastweek
+                bool flush = WeekBegin <= dateTop - 7; // flush only with date < lastweek
 
-            DistributeRankPoints(ALLIANCE, WeekBegin, flush);
-            DistributeRankPoints(HORDE, WeekBegin, flush);
+                DistributeRankPoints(allyList, WeekBegin, flush);
+                DistributeRankPoints(hordeList, WeekBegin, flush);
 
-            WeekBegin += 7;
+                WeekBegin += 7;
+            }
         }
-
-        delete result;
     }
 
     // FLUSH KILLS
-    static SqlStatementID updHonorable;
-    static SqlStatementID updDishonorable;
-    // process only HK ( victim_type > 0 )
-    result = CharacterDatabase.PQuery("SELECT `guid`,`TYPE`,COUNT(*) AS kills FROM `character_honor_cp` WHERE `date` <= %u AND `victim_type`>0 AND `used`=0 GROUP BY `guid`,`type`", dateTop - 7);
-    if (result)
-    {
-        CharacterDatabase.BeginTransaction();
-        uint32 guid, kills;
-        uint8 type;
-        Field* fields = NULL;
-        do
-        {
-            fields = result->Fetch();
-            guid   = fields[0].GetUInt32();
-            type   = fields[1].GetUInt8();
-            kills  = fields[2].GetUInt32();
-
-            if (type == HONORABLE)
-            {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(updHonorable, "UPDATE `characters` SET `stored_honorable_kills` = (`stored_honorable_kills` + ?) WHERE `guid` = ?");
-                stmt.PExecute(kills, guid);
-            }
-            else if (type == DISHONORABLE)
-            {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(updDishonorable, "UPDATE `characters` SET `stored_dishonorable_kills` = (`stored_dishonorable_kills` + ?) WHERE `guid` = ?");
-                stmt.PExecute(kills, guid);
-            }
-        }
-        while (result->NextRow());
+    // process only HK ( victim_type > 0 ), changes the honor of offline characters too
+    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.PExecute("UPDATE `characters` `c` JOIN "
+                               "(SELECT `guid`, SUM(`TYPE` = %u) AS `honorable`, SUM(`TYPE` = %u) AS `dishonorable` FROM `character_honor_cp` "
+                               "WHERE `date` <= %u AND `victim_type`>0 AND `used`=0 GROUP BY `guid`) `k` ON `k`.`guid` = `c`.`guid` "
+                               "SET `c`.`stored_honorable_kills` = `c`.`stored_honorable_kills` + `k`.`honorable`, "
+                               "`c`.`stored_dishonorable_kills` = `c`.`stored_dishonorable_kills` + `k`.`dishonorable`",
+                               HONORABLE, DISHONORABLE, dateTop - 7);
 
-        // cleaning ALL cp before dateTop
-        CharacterDatabase.PExecute("DELETE FROM `character_honor_cp` WHERE `date` <= %u", dateTop - 7);
-        CharacterDatabase.CommitTransaction();
-        delete result;
-    }
-    else
-    {
-        CharacterDatabase.PExecute("DELETE FROM `character_honor_cp` WHERE `date` <= %u AND `used`=1", dateTop - 7);
-    }
+    // cleaning ALL cp before dateTop
+    CharacterDatabase.PExecute("DELETE FROM `character_honor_cp` WHERE `date` <= %u", dateTop - 7);
+    CharacterDatabase.CommitTransactionDirect();
 
     sLog.outString();
     sLog.outString(">> Flushed all ranking points");
 }
 
-void ObjectMgr::DistributeRankPoints(uint32 team, uint32 dateBegin , bool flush /*false*/)
+void ObjectMgr::DistributeRankPoints(HonorStandingList& list, uint32 dateBegin, bool flush /*false*/)
 {
-    float RP;
-    uint32 HK;
-
-    HonorStandingList list = GetStandingListBySide(team);
-
     if (list.empty())
     {
         return;
     }
 
-    HonorScores scores = MaNGOS::Honor::GenerateScores(list, team);
+    HonorScores scores = MaNGOS::Honor::GenerateScores(list);
 
-    Field* fields = NULL;
-    QueryResult* result = NULL;
-    for (HonorStandingList::iterator itr = list.begin(); itr != list.end() ; ++itr)
+    if (flush)
     {
-        RP = 0;
-        result = CharacterDatabase.PQuery("SELECT `stored_honor_rating`,`stored_honorable_kills` FROM `characters` WHERE `guid` = %u ", itr->guid);
-        if (!result)
+        CharacterDatabase.BeginTransaction();
+    }
+
+    std::ostringstream usedGuids;
+    uint32 usedCount = 0;
+
+    for (HonorStandingList::iterator itr = list.begin(); itr != list.end(); ++itr)
+    {
+        itr->rpEarning = MaNGOS::Honor::CalculateRpEarning(itr->honorPoints, scores);
+
+        if (!flush)
         {
-            continue; // not cleaned table?
+            continue;
         }
 
-        fields = result->Fetch();
-        RP = fields[0].GetFloat();
-        HK = fields[1].GetUInt32();
-
-        itr->rpEarning = MaNGOS::Honor::CalculateRpEarning(itr->GetInfo()->honorPoints, scores);
-        RP             = MaNGOS::Honor::CalculateRpDecay(itr->rpEarning, RP);
+        float RP = MaNGOS::Honor::CalculateRpDecay(itr->rpEarning, itr->storedRankPoints);
+        CharacterDatabase.PExecute("UPDATE `characters` SET `stored_honor_rating` = %f , `stored_honorable_kills` = %u WHERE `guid` = %u", finiteAlways(RP + itr->rpEarning), itr->storedHonorableKills + itr->honorKills, itr->guid);
 
-        if (flush)
+        // the week's CP rows are marked used per batch of characters instead of per character
+        usedGuids << (usedCount ? "," : "") << itr->guid;
+        if (++usedCount == 500 || itr + 1 == list.end())
         {
-            CharacterDatabase.BeginTransaction();
-            CharacterDatabase.PExecute("UPDATE `character_honor_cp` SET `used`=1 WHERE `guid` = %u AND `TYPE` = %u AND `date` BETWEEN %u AND %u", itr->guid, HONORABLE, dateBegin, dateBegin + 7);
-            CharacterDatabase.PExecute("UPDATE `characters` SET `stored_honor_rating` = %f , `stored_honorable_kills` = %u WHERE `guid` = %u", finiteAlways(RP + itr->rpEarning), HK + itr->honorKills, itr->guid);
-            CharacterDatabase.CommitTransaction();
+            CharacterDatabase.PExecute("UPDATE `character_honor_cp` SET `used`=1 WHERE `TYPE` = %u AND `date` BETWEEN %u AND %u AND `guid` IN (%s)", HONORABLE, dateBegin, dateBegin + 7, usedGuids.str().c_str());
+            usedGuids.str("");
+            usedCount = 0;
         }
     }
 
-    delete result;
+    if (flush)
+    {
+        // written before the next week is read, the reads and writes all happen on this thread
+        CharacterDatabase.CommitTransactionDirect();
+    }
 }
 
-HonorStandingList ObjectMgr::GetStandingListBySide(uint32 side)
+HonorStandingList const& ObjectMgr::GetStandingListBySide(uint32 side) const
 {
     switch (side)
     {
@@ -3273,52 +3624,22 @@ HonorStandingList ObjectMgr::GetStandingListBySide(uint32 side)
     }
 }
 
-HonorStanding* ObjectMgr::GetHonorStandingByGUID(uint32 guid, uint32 side)
+HonorStanding const* ObjectMgr::GetHonorStandingByGUID(uint32 guid, uint32 side) const
 {
-    HonorStandingList standingList = sObjectMgr.GetStandingListBySide(side);
-
-    for (HonorStandingList::iterator itr = standingList.begin(); itr != standingList.end() ; ++itr)
-        if (itr->guid == guid)
-        {
-            return itr->GetInfo();
-        }
-
-    return 0;
+    return GetHonorStandingByPosition(GetHonorStandingPositionByGUID(guid, side), side);
 }
 
-
-HonorStanding* ObjectMgr::GetHonorStandingByPosition(uint32 position, uint32 side)
+HonorStanding const* ObjectMgr::GetHonorStandingByPosition(uint32 position, uint32 side) const
 {
-    HonorStandingList standingList = sObjectMgr.GetStandingListBySide(side);
-    uint32 pos = 1;
-
-    for (HonorStandingList::iterator itr = standingList.begin(); itr != standingList.end() ; ++itr)
-    {
-        if (pos == position)
-        {
-            return itr->GetInfo();
-        }
-        pos++;
-    }
-
-    return 0;
+    HonorStandingList const& standingList = GetStandingListBySide(side);
+    return position && position <= standingList.size() ? &standingList[position - 1] : NULL;
 }
 
-uint32 ObjectMgr::GetHonorStandingPositionByGUID(uint32 guid, uint32 side)
+uint32 ObjectMgr::GetHonorStandingPositionByGUID(uint32 guid, uint32 side) const
 {
-    HonorStandingList standingList = sObjectMgr.GetStandingListBySide(side);
-    uint32 pos = 1;
-
-    for (HonorStandingList::iterator itr = standingList.begin(); itr != standingList.end() ; ++itr)
-    {
-        if (itr->guid == guid)
-        {
-            return pos;
-        }
-        pos++;
-    }
-
-    return 0;
+    HonorStandingPositionMap const& positions = side == HORDE ? m_hordeStandingPositions : m_allyStandingPositions;
+    HonorStandingPositionMap::const_iterator itr = positions.find(guid);
+    return itr != positions.end() ? itr->second : 0;
 }
 
 void ObjectMgr::GetPlayerClassLevelInfo(uint32 class_, uint32 level, PlayerClassLevelInfo* info) const
@@ -4290,6 +4611,31 @@ void ObjectMgr::LoadQuests()
         }
     }
 
+    m_questRequiredSkills.clear();
+    m_questRequiredFactions.clear();
+
+    for (QuestMap::const_iterator itr = mQuestTemplates.begin(); itr != mQuestTemplates.end(); ++itr)
+    {
+        Quest const* qinfo = itr->second;
+
+        if (qinfo->GetRequiredSkill())
+        {
+            m_questRequiredSkills.insert(qinfo->GetRequiredSkill());
+        }
+
+        if (qinfo->GetRequiredMinRepFaction())
+        {
+            m_questRequiredFactions.insert(qinfo->GetRequiredMinRepFaction());
+        }
+
+        if (qinfo->GetRequiredMaxRepFaction())
+        {
+            m_questRequiredFactions.insert(qinfo->GetRequiredMaxRepFaction());
+        }
+    }
+
+    InvalidateQuestGiverStatus();
+
     sLog.outString(">> Loaded " SIZEFMTD " quests definitions", mQuestTemplates.size());
     sLog.outString();
 }
@@ -4834,6 +5180,15 @@ void ObjectMgr::LoadConditions()
         }
     }
 
+    m_playerStateConditions.assign(sConditionStorage.GetMaxEntry(), false);
+    for (uint32 i = 0; i < sConditionStorage.GetMaxEntry(); ++i)
+    {
+        m_playerStateConditions[i] = PlayerCondition::DependsOnlyOnPlayerState(i);
+    }
+
+    // results cached by players are outdated on reload
+    m_conditionGeneration.fetch_add(1, std::memory_order_relaxed);
+
     sLog.outString(">> Loaded %u Condition definitions", sConditionStorage.GetRecordCount());
     sLog.outString();
 }
@@ -4988,7 +5343,32 @@ void ObjectMgr::LoadGossipTextLocales()
     sLog.outString();
 }
 
-// not very fast function but it is called only once a day, or on starting-up
+// executes "<prefix> (id, id, ...)" for the given ids, split into statements of a bounded length
+static void ExecuteForIdList(char const* prefix, std::vector<uint32> const& ids)
+{
+    static const size_t MAX_IDS_PER_STATEMENT = 1000;
+
+    for (size_t first = 0; first < ids.size(); first += MAX_IDS_PER_STATEMENT)
+    {
+        size_t last = std::min(ids.size(), first + MAX_IDS_PER_STATEMENT);
+
+        std::ostringstream ss;
+        ss << prefix << " (";
+        for (size_t i = first; i < last; ++i)
+        {
+            if (i != first)
+            {
+                ss << ",";
+            }
+            ss << ids[i];
+        }
+        ss << ")";
+
+        CharacterDatabase.Execute(ss.str().c_str());
+    }
+}
+
+// called only once a day, or on starting-up, all deletes are done as set based statements
 /// @param serverUp true if the server is already running, false when the server is started
 void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
 {
@@ -5003,8 +5383,8 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
     {
         CharacterDatabase.PExecute("DELETE FROM `mail` WHERE `expire_time` < '" UI64FMTD "' AND `has_items` = '0' AND `body` = ''", (uint64)basetime);
     }
-    //                                                     0  1           2      3        4          5         6           7   8       9
-    QueryResult* result = CharacterDatabase.PQuery("SELECT `id`,`messageType`,`sender`,`receiver`,`has_items`,`expire_time`,`cod`,`checked`,`mailTemplateId` FROM `mail` WHERE `expire_time` < '" UI64FMTD "'", (uint64)basetime);
+    //                                                     0  1           2      3        4          5
+    QueryResult* result = CharacterDatabase.PQuery("SELECT `id`,`messageType`,`sender`,`receiver`,`has_items`,`checked` FROM `mail` WHERE `expire_time` < '" UI64FMTD "'", (uint64)basetime);
     if (!result)
     {
         BarGoLink bar(1);
@@ -5014,97 +5394,92 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
         return;                                             // any mails need to be returned or deleted
     }
 
-    // std::ostringstream delitems, delmails; // will be here for optimization
-    // bool deletemail = false, deleteitem = false;
-    // delitems << "DELETE FROM `item_instance` WHERE `guid` IN ( ";
-    // delmails << "DELETE FROM `mail` WHERE `id` IN ( "
+    // items of all expired mails in one go instead of a query per mail
+    typedef std::map<uint32, std::vector<uint32> > MailItemGuidsMap;
+    MailItemGuidsMap mailItems;
+    if (QueryResult* resultItems = CharacterDatabase.PQuery("SELECT `mail_id`,`item_guid` FROM `mail_items` JOIN `mail` ON `mail_id` = `id` WHERE `expire_time` < '" UI64FMTD "'", (uint64)basetime))
+    {
+        do
+        {
+            Field* fields2 = resultItems->Fetch();
+            mailItems[fields2[0].GetUInt32()].push_back(fields2[1].GetUInt32());
+        }
+        while (resultItems->NextRow());
+
+        delete resultItems;
+    }
+
+    std::vector<uint32> deletedMails;
+    std::vector<uint32> deletedItems;
 
     BarGoLink bar(result->GetRowCount());
     uint32 count = 0;
     Field* fields;
 
+    CharacterDatabase.BeginTransaction();
+
     do
     {
         bar.step();
 
         fields = result->Fetch();
-        Mail* m = new Mail;
-        m->messageID = fields[0].GetUInt32();
-        m->messageType = fields[1].GetUInt8();
-        m->sender = fields[2].GetUInt32();
-        m->receiverGuid = ObjectGuid(HIGHGUID_PLAYER, fields[3].GetUInt32());
+        uint32 messageID = fields[0].GetUInt32();
+        uint8 messageType = fields[1].GetUInt8();
+        uint32 sender = fields[2].GetUInt32();
+        ObjectGuid receiverGuid = ObjectGuid(HIGHGUID_PLAYER, fields[3].GetUInt32());
         bool has_items = fields[4].GetBool();
-        m->expire_time = (time_t)fields[5].GetUInt64();
-        m->deliver_time = 0;
-        m->COD = fields[6].GetUInt32();
-        m->checked = fields[7].GetUInt32();
-        m->mailTemplateId = fields[8].GetInt16();
+        uint32 checked = fields[5].GetUInt32();
 
-        Player* pl = 0;
-        if (serverUp)
-        {
-            pl = GetPlayer(m->receiverGuid);
-        }
-        if (pl)
+        if (serverUp && GetPlayer(receiverGuid))
         {
             // this code will run very improbably (the time is between 4 and 5 am, in game is online a player, who has old mail
             // his in mailbox and he has already listed his mails )
-            delete m;
             continue;
         }
         // delete or return mail:
         if (has_items)
         {
-            QueryResult* resultItems = CharacterDatabase.PQuery("SELECT `item_guid`,`item_template` FROM `mail_items` WHERE `mail_id`='%u'", m->messageID);
-            if (resultItems)
-            {
-                do
-                {
-                    Field* fields2 = resultItems->Fetch();
-
-                    uint32 item_guid_low = fields2[0].GetUInt32();
-                    uint32 item_template = fields2[1].GetUInt32();
-
-                    m->AddItem(item_guid_low, item_template);
-                }
-                while (resultItems->NextRow());
+            MailItemGuidsMap::const_iterator itemsItr = mailItems.find(messageID);
 
-                delete resultItems;
-            }
             // if it is mail from non-player, or if it's already return mail, it shouldn't be returned, but deleted
-            if (m->messageType != MAIL_NORMAL || (m->checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
+            if (messageType != MAIL_NORMAL || (checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
             {
                 // mail open and then not returned
-                for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
+                if (itemsItr != mailItems.end())
                 {
-                    CharacterDatabase.PExecute("DELETE FROM `item_instance` WHERE `guid` = '%u'", itr2->item_guid);
+                    deletedItems.insert(deletedItems.end(), itemsItr->second.begin(), itemsItr->second.end());
                 }
             }
             else
             {
                 // mail will be returned:
                 CharacterDatabase.PExecute("UPDATE `mail` SET `sender` = '%u', `receiver` = '%u', `expire_time` = '" UI64FMTD "', `deliver_time` = '" UI64FMTD "', `cod` = '0', `checked` = '%u' WHERE `id` = '%u'",
-                                           m->receiverGuid.GetCounter(), m->sender, (uint64)(basetime + 30 * DAY), (uint64)basetime, MAIL_CHECK_MASK_RETURNED, m->messageID);
-                for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
+                                           receiverGuid.GetCounter(), sender, (uint64)(basetime + 30 * DAY), (uint64)basetime, MAIL_CHECK_MASK_RETURNED, messageID);
+                if (itemsItr != mailItems.end())
                 {
                     // update receiver in mail items for its proper delivery, and in instance_item for avoid lost item at sender delete
-                    CharacterDatabase.PExecute("UPDATE `mail_items` SET `receiver` = %u WHERE `item_guid` = '%u'", m->sender, itr2->item_guid);
-                    CharacterDatabase.PExecute("UPDATE `item_instance` SET `owner_guid` = %u WHERE `guid` = '%u'", m->sender, itr2->item_guid);
+                    CharacterDatabase.PExecute("UPDATE `mail_items` SET `receiver` = %u WHERE `mail_id` = '%u'", sender, messageID);
+
+                    std::ostringstream ss;
+                    ss << "UPDATE `item_instance` SET `owner_guid` = " << sender << " WHERE `guid` IN";
+                    ExecuteForIdList(ss.str().c_str(), itemsItr->second);
                 }
-                delete m;
                 continue;
             }
         }
 
-        // deletemail = true;
-        // delmails << m->messageID << ", ";
-        CharacterDatabase.PExecute("DELETE FROM `mail` WHERE `id` = '%u'", m->messageID);
-        delete m;
+        deletedMails.push_back(messageID);
         ++count;
     }
     while (result->NextRow());
     delete result;
 
+    ExecuteForIdList("DELETE FROM `item_instance` WHERE `guid` IN", deletedItems);
+    ExecuteForIdList("DELETE FROM `mail_items` WHERE `mail_id` IN", deletedMails);
+    ExecuteForIdList("DELETE FROM `mail` WHERE `id` IN", deletedMails);
+
+    CharacterDatabase.CommitTransaction();
+
     sLog.outString(">> Loaded %u mails", count);
     sLog.outString();
 }
@@ -5887,6 +6262,35 @@ void ObjectMgr::SetHighestGuids()
     m_FirstTemporaryGameObjectGuid += sWorld.getConfig(CONFIG_UINT32_GUID_RESERVE_SIZE_GAMEOBJECT);
 }
 
+// guids of a block not used up before shutdown are simply skipped after the restart
+enum
+{
+    ITEM_GUID_LEASE_SIZE   = 64,
+    CORPSE_GUID_LEASE_SIZE = 8
+};
+
+uint32 ObjectMgr::GenerateItemLowGuid()
+{
+    ObjectGuidLease& lease = (*m_guidLeases)->items;
+    if (lease.IsEmpty())
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_guidLeaseLock, 0);
+        lease.Assign(m_ItemGuids.GenerateRange(ITEM_GUID_LEASE_SIZE), ITEM_GUID_LEASE_SIZE);
+    }
+    return lease.Take();
+}
+
+uint32 ObjectMgr::GenerateCorpseLowGuid()
+{
+    ObjectGuidLease& lease = (*m_guidLeases)->corpses;
+    if (lease.IsEmpty())
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_guidLeaseLock, 0);
+        lease.Assign(m_CorpseGuids.GenerateRange(CORPSE_GUID_LEASE_SIZE), CORPSE_GUID_LEASE_SIZE);
+    }
+    return lease.Take();
+}
+
 void ObjectMgr::LoadGameObjectLocales()
 {
     mGameObjectLocaleMap.clear();                           // need for reload case
@@ -6568,7 +6972,7 @@ void ObjectMgr::LoadReputationOnKill()
 
 void ObjectMgr::LoadReputationSpilloverTemplate()
 {
-    m_RepSpilloverTemplateMap.clear();                      // for reload case
+    m_RepSpilloverStore.clear();                            // for reload case
 
     uint32 count = 0;
     QueryResult* result = WorldDatabase.Query("SELECT `faction`, `faction1`, `rate_1`, `rank_1`, `faction2`, `rate_2`, `rank_2`, `faction3`, `rate_3`, `rank_3`, `faction4`, `rate_4`, `rank_4` FROM `reputation_spillover_template`");
@@ -6582,6 +6986,8 @@ void ObjectMgr::LoadReputationSpilloverTemplate()
         return;
     }
 
+    m_RepSpilloverStore.resize(sFactionStore.GetNumRows());
+
     BarGoLink bar(result->GetRowCount());
 
     do
@@ -6621,6 +7027,9 @@ void ObjectMgr::LoadReputationSpilloverTemplate()
             continue;
         }
 
+        // only the valid targets are kept, so applying the spillover needs no further lookups
+        RepSpilloverList spillover;
+
         for (uint32 i = 0; i < MAX_SPILLOVER_FACTIONS; ++i)
         {
             if (repTemplate.faction[i])
@@ -6644,35 +7053,16 @@ void ObjectMgr::LoadReputationSpilloverTemplate()
                     sLog.outErrorDb("Rank %u used in `reputation_spillover_template` for spillover faction %u is not valid, skipping", repTemplate.faction_rank[i], repTemplate.faction[i]);
                     continue;
                 }
-            }
-        }
 
-        FactionEntry const* factionEntry0 = sFactionStore.LookupEntry(repTemplate.faction[0]);
-        if (repTemplate.faction[0] && !factionEntry0)
-        {
-            sLog.outErrorDb("Faction (faction.dbc) %u does not exist but is used in `reputation_spillover_template`", repTemplate.faction[0]);
-            continue;
-        }
-        FactionEntry const* factionEntry1 = sFactionStore.LookupEntry(repTemplate.faction[1]);
-        if (repTemplate.faction[1] && !factionEntry1)
-        {
-            sLog.outErrorDb("Faction (faction.dbc) %u does not exist but is used in `reputation_spillover_template`", repTemplate.faction[1]);
-            continue;
-        }
-        FactionEntry const* factionEntry2 = sFactionStore.LookupEntry(repTemplate.faction[2]);
-        if (repTemplate.faction[2] && !factionEntry2)
-        {
-            sLog.outErrorDb("Faction (faction.dbc) %u does not exist but is used in `reputation_spillover_template`", repTemplate.faction[2]);
-            continue;
-        }
-        FactionEntry const* factionEntry3 = sFactionStore.LookupEntry(repTemplate.faction[3]);
-        if (repTemplate.faction[3] && !factionEntry3)
-        {
-            sLog.outErrorDb("Faction (faction.dbc) %u does not exist but is used in `reputation_spillover_template`", repTemplate.faction[3]);
-            continue;
+                RepSpilloverEntry entry;
+                entry.faction = factionSpillover;
+                entry.rate = repTemplate.faction_rate[i];
+                entry.rank = ReputationRank(repTemplate.faction_rank[i]);
+                spillover.push_back(entry);
+            }
         }
 
-        m_RepSpilloverTemplateMap[factionId] = repTemplate;
+        m_RepSpilloverStore[factionId].swap(spillover);
 
         ++count;
     }
@@ -6778,6 +7168,7 @@ void ObjectMgr::DeleteCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_
 void ObjectMgr::LoadQuestRelationsHelper(QuestRelationsMap& map, QuestActor actor, QuestRole role)
 {
     map.clear();                                            // need for reload case
+    InvalidateQuestGiverStatus();
 
     uint32 count = 0;
 
@@ -8377,6 +8768,42 @@ bool PlayerCondition::CanBeUsedWithoutPlayer(uint16 entry)
     }
 }
 
+bool PlayerCondition::DependsOnlyOnPlayerState(uint16 entry)
+{
+    PlayerCondition const* condition = sConditionStorage.LookupEntry<PlayerCondition>(entry);
+    if (!condition)
+    {
+        return false;
+    }
+
+    switch (condition->m_condition)
+    {
+        case CONDITION_NOT:
+            return DependsOnlyOnPlayerState(condition->m_value1);
+        case CONDITION_AND:
+        case CONDITION_OR:
+            return DependsOnlyOnPlayerState(condition->m_value1) && DependsOnlyOnPlayerState(condition->m_value2);
+        // fixed for a character
+        case CONDITION_NONE:
+        case CONDITION_TEAM:
+        case CONDITION_RACE_CLASS:
+        case CONDITION_GENDER:
+        // level, skill, reputation, quest, spell and honor rank changes clear the cache of the player
+        case CONDITION_LEVEL:
+        case CONDITION_SKILL:
+        case CONDITION_SKILL_BELOW:
+        case CONDITION_REPUTATION_RANK_MIN:
+        case CONDITION_REPUTATION_RANK_MAX:
+        case CONDITION_QUESTREWARDED:
+        case CONDITION_QUEST_NONE:
+        case CONDITION_SPELL:
+        case CONDITION_PVP_RANK:
+            return true;
+        default:
+            return false;
+    }
+}
+
 SkillRangeType GetSkillRangeType(SkillLineEntry const* pSkill, bool racial)
 {
     switch (pSkill->categoryId)
@@ -43,6 +43,10 @@
 
 #include <map>
 #include <limits>
+#include <atomic>
+
+#include <ace/TSS_T.h>
+#include <ace/Thread_Mutex.h>
 
 class Group;
 class Item;
@@ -97,15 +101,36 @@ struct AreaTrigger
 };
 
 typedef std::map < uint32/*player guid*/, uint32/*instance*/ > CellCorpseSet;
+// spawn changes on top of the static spawn index below, and all spawns until it is built
 struct CellObjectGuids
 {
     CellGuidSet creatures;
     CellGuidSet gameobjects;
+    CellGuidSet hiddenCreatures;                            // static spawns removed from the grid
+    CellGuidSet hiddenGameobjects;
     CellCorpseSet corpses;
 };
 typedef UNORDERED_MAP < uint32/*cell_id*/, CellObjectGuids > CellObjectGuidsMap;
 typedef UNORDERED_MAP < uint32/*mapid*/, CellObjectGuidsMap > MapObjectGuids;
 
+// static DB spawns of a cell, as positions in MapSpawnIndex::guids
+struct CellSpawnRange
+{
+    uint32 cell_id;
+    uint32 creatures;                                       // first creature guid
+    uint32 gameobjects;                                     // first gameobject guid, end of the creatures
+    uint32 end;                                             // end of the gameobjects
+};
+
+// static DB spawns of a map, cells sorted by id and guids sorted within each cell
+struct MapSpawnIndex
+{
+    std::vector<CellSpawnRange> cells;
+    std::vector<uint32> guids;
+};
+typedef UNORDERED_MAP < uint32/*mapid*/, MapSpawnIndex > MapSpawnIndexMap;
+typedef std::pair<uint32 const*, uint32 const*> CellGuidRange;
+
 // mangos string ranges
 #define MIN_MANGOS_STRING_ID           1                    // 'mangos_string'
 #define MAX_MANGOS_STRING_ID           2000000000
@@ -121,7 +146,7 @@ struct MangosStringLocale
 {
     MangosStringLocale() : SoundId(0), Type(0), LanguageId(LANG_UNIVERSAL), Emote(0) { }
 
-    std::vector<std::string> Content;                       // 0 -> default, i -> i-1 locale index
+    std::vector<InternedString> Content;                       // 0 -> default, i -> i-1 locale index
     uint32 SoundId;
     uint8  Type;
     Language LanguageId;
@@ -131,6 +156,8 @@ struct MangosStringLocale
 typedef UNORDERED_MAP<uint32 /*guid*/, CreatureData> CreatureDataMap;
 typedef CreatureDataMap::value_type CreatureDataPair;
 
+typedef UNORDERED_MAP<uint32 /*guid*/, CreatureSpawnHint> CreatureSpawnHintMap;
+
 typedef std::multimap<uint32 /*mapId*/, uint32 /*guid*/> ActiveCreatureGuidsOnMap;
 typedef std::multimap<uint32 /*mapId*/, uint32 /*guid*/> LocalTransportGuidsOnMap;
 
@@ -235,6 +262,16 @@ struct RepSpilloverTemplate
     uint32 faction_rank[MAX_SPILLOVER_FACTIONS];
 };
 
+// validated spillover target of a RepSpilloverTemplate, resolved once at load
+struct RepSpilloverEntry
+{
+    FactionEntry const* faction;
+    float rate;
+    ReputationRank rank;                                    // spillover applies up to and including this rank
+};
+
+typedef std::vector<RepSpilloverEntry> RepSpilloverList;
+
 struct PointOfInterest
 {
     uint32 entry;
@@ -409,6 +446,9 @@ class PlayerCondition
 
         static bool CanBeUsedWithoutPlayer(uint16 entry);
 
+        // true if the result depends only on player state that invalidates Player::IsMeetingGossipCondition
+        static bool DependsOnlyOnPlayerState(uint16 entry);
+
         // Checks if the player meets the condition
         // if the param entry is not null, it will be filled at return as follows:
         //  - if function fails, entry will contain the first faulty condition
@@ -469,12 +509,16 @@ class HonorStanding
             honorKills  = 0;
             guid        = 0;
             rpEarning   = 0;
+            storedRankPoints = 0;
+            storedHonorableKills = 0;
         }
 
         float honorPoints;
         uint32 honorKills;
         uint32 guid;
         float rpEarning;
+        float storedRankPoints;                             // `characters` values when the standing was read
+        uint32 storedHonorableKills;
 
         HonorStanding* GetInfo()
         {
@@ -484,7 +528,8 @@ class HonorStanding
 
 bool operator < (const HonorStanding& lhs, const HonorStanding& rhs);
 
-typedef std::list<HonorStanding> HonorStandingList;
+typedef std::vector<HonorStanding> HonorStandingList;     // ordered by honor, position 1 first
+typedef UNORDERED_MAP<uint32, uint32> HonorStandingPositionMap; // guid -> position
 
 template<typename T>
 class IdGenerator
@@ -526,7 +571,7 @@ class ObjectMgr
 
         typedef UNORDERED_MAP<uint32, RepRewardRate > RepRewardRateMap;
         typedef UNORDERED_MAP<uint32, ReputationOnKillEntry> RepOnKillMap;
-        typedef UNORDERED_MAP<uint32, RepSpilloverTemplate> RepSpilloverTemplateMap;
+        typedef std::vector<RepSpilloverList> RepSpilloverStore;  // indexed by faction id
 
         typedef UNORDERED_MAP<uint32, PointOfInterest> PointOfInterestMap;
 
@@ -595,6 +640,14 @@ class ObjectMgr
             return mQuestTemplates;
         }
 
+        // quest giver dialog status cached by players is valid while this does not change, see Player::GetCachedQuestGiverStatus
+        uint32 GetQuestGiverStatusGeneration() const { return m_questGiverStatusGeneration.load(std::memory_order_relaxed); }
+        // quest activity, availability or relations changed for everyone (game events, disables, reloads)
+        void InvalidateQuestGiverStatus() { m_questGiverStatusGeneration.fetch_add(1, std::memory_order_relaxed); }
+        // skills and factions some quest requires a value of, changes of others do not affect quest availability
+        bool IsQuestRequiredSkill(uint32 skillId) const { return m_questRequiredSkills.find(skillId) != m_questRequiredSkills.end(); }
+        bool IsQuestRequiredFaction(uint32 factionId) const { return m_questRequiredFactions.find(factionId) != m_questRequiredFactions.end(); }
+
         uint32 GetQuestForAreaTrigger(uint32 Trigger_ID) const
         {
             QuestAreaTriggerMap::const_iterator itr = mQuestAreaTriggerMap.find(Trigger_ID);
@@ -656,12 +709,11 @@ class ObjectMgr
             return NULL;
         }
 
-        RepSpilloverTemplate const* GetRepSpilloverTemplate(uint32 factionId) const
+        RepSpilloverList const* GetRepSpillover(uint32 factionId) const
         {
-            RepSpilloverTemplateMap::const_iterator itr = m_RepSpilloverTemplateMap.find(factionId);
-            if (itr != m_RepSpilloverTemplateMap.end())
+            if (factionId < m_RepSpilloverStore.size() && !m_RepSpilloverStore[factionId].empty())
             {
-                return &itr->second;
+                return &m_RepSpilloverStore[factionId];
             }
 
             return NULL;
@@ -724,6 +776,7 @@ class ObjectMgr
         void LoadCreatureLocales();
         void LoadCreatureTemplates();
         void LoadCreatures();
+        void LoadCreatureSpawnHints();
         void LoadCreatureAddons();
         void LoadCreatureClassLvlStats();
         void LoadCreatureModelInfo();
@@ -799,16 +852,22 @@ class ObjectMgr
             return itr != mFishingBaseForArea.end() ? itr->second : 0;
         }
 
-        static HonorStanding* GetHonorStandingByGUID(uint32 guid, uint32 side);
-        static HonorStanding* GetHonorStandingByPosition(uint32 position, uint32 side);
-        HonorStandingList GetStandingListBySide(uint32 side);
-        uint32 GetHonorStandingPositionByGUID(uint32 guid, uint32 side);
-        void UpdateHonorStandingByGuid(uint32 guid, HonorStanding standing, uint32 side) ;
-        void FlushRankPoints(uint32 dateTop);
-        void DistributeRankPoints(uint32 team, uint32 dateBegin , bool flush = false);
-        void LoadStandingList(uint32 dateBegin);
+        HonorStanding const* GetHonorStandingByGUID(uint32 guid, uint32 side) const;
+        HonorStanding const* GetHonorStandingByPosition(uint32 position, uint32 side) const;
+        HonorStandingList const& GetStandingListBySide(uint32 side) const;
+        uint32 GetHonorStandingPositionByGUID(uint32 guid, uint32 side) const;
+
+        // the weekly standing work only touches the lists passed to it and the character DB, see HonorStandingTask
+        static void FlushRankPoints(uint32 dateTop);
+        static void DistributeRankPoints(HonorStandingList& list, uint32 dateBegin, bool flush = false);
+        static void LoadStandingList(uint32 dateBegin, HonorStandingList& allyList, HonorStandingList& hordeList);
         void LoadStandingList();
 
+        // recomputes the standings of the week before dateTop in a background thread, flushing older weeks first if asked
+        bool StartHonorStandingUpdate(uint32 dateTop, bool flush);
+        // installs the result of a finished update, true if one was installed
+        bool UpdateHonorStandingTask(bool wait = false);
+
         void ReturnOrDeleteOldMails(bool serverUp);
 
         void SetHighestGuids();
@@ -845,14 +904,9 @@ class ObjectMgr
         {
             return m_CharGuids.Generate();
         }
-        uint32 GenerateItemLowGuid()
-        {
-            return m_ItemGuids.Generate();
-        }
-        uint32 GenerateCorpseLowGuid()
-        {
-            return m_CorpseGuids.Generate();
-        }
+        // map threads create items and corpses in parallel, each thread takes its guids from a block of its own
+        uint32 GenerateItemLowGuid();
+        uint32 GenerateCorpseLowGuid();
 
         uint32 GenerateAuctionID()
         {
@@ -907,6 +961,17 @@ class ObjectMgr
             return dataPair ? &dataPair->second : NULL;
         }
 
+        // NULL when the hints don't cover the spawn or it was moved since
+        CreatureSpawnHint const* GetCreatureSpawnHint(uint32 guid, CreatureData const* data) const
+        {
+            CreatureSpawnHintMap::const_iterator itr = mCreatureSpawnHintMap.find(guid);
+            if (itr == mCreatureSpawnHintMap.end() || !itr->second.IsFor(data))
+            {
+                return NULL;
+            }
+            return &itr->second;
+        }
+
         CreatureData& NewOrExistCreatureData(uint32 guid)
         {
             return mCreatureDataMap[guid];
@@ -1036,6 +1101,8 @@ class ObjectMgr
             return &*itr;
         }
 
+        GameObjectDataMap const* GetGameObjectDataMap() const { return &mGameObjectDataMap; }
+
         GameObjectData const* GetGOData(uint32 guid) const
         {
             GameObjectDataPair const* dataPair = GetGODataPair(guid);
@@ -1083,10 +1150,12 @@ class ObjectMgr
         void SetDBCLocaleIndex(uint32 lang) { DBCLocaleIndex = GetIndexForLocale(LocaleConstant(lang)); }
 
         // global grid objects state (static DB spawns, global spawn mods from gameevent system)
-        CellObjectGuids const& GetCellObjectGuids(uint16 mapid, uint32 cell_id)
-        {
-            return mMapObjectGuids[mapid][cell_id];
-        }
+        CellObjectGuids const& GetCellObjectGuids(uint16 mapid, uint32 cell_id) const;
+        CellGuidRange GetCellStaticCreatureGuids(uint16 mapid, uint32 cell_id) const;
+        CellGuidRange GetCellStaticGameobjectGuids(uint16 mapid, uint32 cell_id) const;
+
+        // moves the spawns loaded so far into the static index, once after loading; later changes stay in CellObjectGuids
+        void BuildCellSpawnIndex();
 
         // modifiers for global grid objects state (static DB spawns, global spawn mods from gameevent system)
         // Don't must be used for modify instance specific spawn state modifications
@@ -1112,6 +1181,11 @@ class ObjectMgr
         // Check if a player meets condition conditionId
         bool IsPlayerMeetToCondition(uint16 conditionId, Player const* pPlayer, Map const* map, WorldObject const* source, ConditionSource conditionSourceType, ConditionEntry* entry = NULL) const;
 
+        // conditions whose results players may keep until their state changes, see Player::IsMeetingGossipCondition
+        bool IsPlayerStateCondition(uint16 conditionId) const { return conditionId < m_playerStateConditions.size() && m_playerStateConditions[conditionId]; }
+        // cached condition results of players are valid while this does not change
+        uint32 GetConditionGeneration() const { return m_conditionGeneration.load(std::memory_order_relaxed); }
+
         GameTele const* GetGameTele(uint32 id) const
         {
             GameTeleMap::const_iterator itr = m_GameTeleMap.find(id);
@@ -1189,8 +1263,8 @@ class ObjectMgr
         bool RemoveVendorItem(uint32 entry, uint32 item);
         bool IsVendorItemValid(bool isTemplate, char const* tableName, uint32 vendor_entry, uint32 item, uint32 maxcount, uint32 ptime, uint16 conditionId, Player* pl = NULL, std::set<uint32>* skip_vendors = NULL) const;
 
-        static void AddLocaleString(std::string const& s, LocaleConstant locale, StringVector& data);
-        static inline void GetLocaleString(const StringVector& data, int loc_idx, std::string& value)
+        static void AddLocaleString(std::string const& s, LocaleConstant locale, std::vector<InternedString>& data);
+        static inline void GetLocaleString(std::vector<InternedString> const& data, int loc_idx, std::string& value)
         {
             if (data.size() > size_t(loc_idx) && !data[loc_idx].empty())
             {
@@ -1284,6 +1358,15 @@ class ObjectMgr
         ObjectGuidGenerator<HIGHGUID_ITEM>       m_ItemGuids;
         ObjectGuidGenerator<HIGHGUID_CORPSE>     m_CorpseGuids;
 
+        // blocks of item and corpse guids reserved by the current thread
+        struct ObjectGuidLeases
+        {
+            ObjectGuidLease items;
+            ObjectGuidLease corpses;
+        };
+        ACE_TSS<ObjectGuidLeases>* m_guidLeases;
+        ACE_Thread_Mutex m_guidLeaseLock;                   // only taken to reserve the next block
+
         QuestMap            mQuestTemplates;
 
         typedef UNORDERED_MAP<uint32, GossipText> GossipTextMap;
@@ -1301,7 +1384,7 @@ class ObjectMgr
 
         RepRewardRateMap    m_RepRewardRateMap;
         RepOnKillMap        mRepOnKill;
-        RepSpilloverTemplateMap m_RepSpilloverTemplateMap;
+        RepSpilloverStore   m_RepSpilloverStore;
 
         GossipMenusMap      m_mGossipMenusMap;
         GossipMenuItemsMap  m_mGossipMenuItemsMap;
@@ -1326,6 +1409,12 @@ class ObjectMgr
 
         ExclusiveQuestGroupsMap m_ExclusiveQuestGroups;
 
+        std::atomic<uint32>     m_questGiverStatusGeneration;
+        std::vector<bool>       m_playerStateConditions;
+        std::atomic<uint32>     m_conditionGeneration;
+        std::set<uint32>        m_questRequiredSkills;
+        std::set<uint32>        m_questRequiredFactions;
+
         QuestRelationsMap       m_CreatureQuestRelations;
         QuestRelationsMap       m_CreatureQuestInvolvedRelations;
         QuestRelationsMap       m_GOQuestRelations;
@@ -1364,6 +1453,8 @@ class ObjectMgr
         // Standing System
         HonorStandingList HordeHonorStandingList;
         HonorStandingList AllyHonorStandingList;
+        HonorStandingPositionMap m_hordeStandingPositions;
+        HonorStandingPositionMap m_allyStandingPositions;
 
         typedef std::map<uint32, std::vector<std::string> > HalfNameMap;
         HalfNameMap PetHalfName0;
@@ -1374,9 +1465,11 @@ class ObjectMgr
         CreatureClassLvlStats m_creatureClassLvlStats[DEFAULT_MAX_CREATURE_LEVEL + 1][MAX_CREATURE_CLASS];
 
         MapObjectGuids mMapObjectGuids;
+        MapSpawnIndexMap mMapSpawnIndex;
         ActiveCreatureGuidsOnMap m_activeCreatures;
         LocalTransportGuidsOnMap m_localTransports;
         CreatureDataMap mCreatureDataMap;
+        CreatureSpawnHintMap mCreatureSpawnHintMap;
         CreatureLocaleMap mCreatureLocaleMap;
         CreatureSpellsMap m_CreatureSpellsMap;
         GameObjectDataMap mGameObjectDataMap;
@@ -0,0 +1,170 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_PACKEDAURALIST
+#define MANGOS_H_PACKEDAURALIST
+
+#include "Common.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+class Aura;
+
+/**
+ * Flat list of the auras of one aura type on a unit, see Unit::GetAurasByType.
+ *
+ * The auras are kept in one contiguous array so the frequent walks during
+ * damage, stat, proc and movement calculation stay in cache, and applying an
+ * aura reuses the array capacity instead of allocating a list node.
+ *
+ * Iterators are positions in the array, not pointers: appending while a walk
+ * is in progress does not invalidate them, and removing an aura only clears
+ * its slot, which iteration skips. The cleared slots are squeezed out by
+ * compact(), which the owner calls only where no walk can be in progress.
+ * The order of the remaining auras is always the order they were added in.
+ */
+class PackedAuraList
+{
+    public:
+        typedef Aura* value_type;
+
+        class const_iterator
+        {
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef Aura* value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef Aura* const* pointer;
+                typedef Aura* const& reference;
+
+                const_iterator() : m_list(NULL), m_index(0) {}
+                const_iterator(PackedAuraList const* list, size_t index) : m_list(list), m_index(index) {}
+
+                reference operator*() const { return m_list->m_slots[m_index]; }
+                pointer operator->() const { return &m_list->m_slots[m_index]; }
+
+                const_iterator& operator++()
+                {
+                    ++m_index;
+                    m_index = m_list->SkipForward(m_index);
+                    return *this;
+                }
+                const_iterator operator++(int) { const_iterator tmp = *this; ++*this; return tmp; }
+
+                const_iterator& operator--()
+                {
+                    m_index = m_list->SkipBackward(m_index);
+                    return *this;
+                }
+                const_iterator operator--(int) { const_iterator tmp = *this; --*this; return tmp; }
+
+                bool operator==(const_iterator const& other) const { return m_index == other.m_index && m_list == other.m_list; }
+                bool operator!=(const_iterator const& other) const { return !(*this == other); }
+
+            private:
+                PackedAuraList const* m_list;
+                size_t m_index;
+        };
+
+        // the list is changed through push_back/remove only, so both iterator kinds are the same
+        typedef const_iterator iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef const_reverse_iterator reverse_iterator;
+
+        PackedAuraList() : m_count(0) {}
+
+        const_iterator begin() const { return const_iterator(this, SkipForward(0)); }
+        const_iterator end() const { return const_iterator(this, m_slots.size()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        bool empty() const { return m_count == 0; }
+        size_t size() const { return m_count; }
+        Aura* front() const { return *begin(); }
+
+        void push_back(Aura* aura)
+        {
+            m_slots.push_back(aura);
+            ++m_count;
+        }
+
+        // clears the slots holding aura, returns true if the list has to be compacted afterwards
+        bool remove(Aura* aura)
+        {
+            bool found = false;
+            for (std::vector<Aura*>::iterator itr = m_slots.begin(); itr != m_slots.end(); ++itr)
+            {
+                if (*itr == aura)
+                {
+                    *itr = NULL;
+                    --m_count;
+                    found = true;
+                }
+            }
+            return found;
+        }
+
+        // drop the cleared slots, invalidates every iterator of this list
+        void compact()
+        {
+            if (m_count == m_slots.size())
+            {
+                return;
+            }
+            m_slots.erase(std::remove(m_slots.begin(), m_slots.end(), (Aura*)NULL), m_slots.end());
+        }
+
+        void clear()
+        {
+            m_slots.clear();
+            m_count = 0;
+        }
+
+    private:
+        size_t SkipForward(size_t index) const
+        {
+            while (index < m_slots.size() && !m_slots[index])
+            {
+                ++index;
+            }
+            return index;
+        }
+
+        size_t SkipBackward(size_t index) const
+        {
+            do
+            {
+                --index;
+            }
+            while (index > 0 && !m_slots[index]);
+            return index;
+        }
+
+        std::vector<Aura*> m_slots;
+        size_t m_count;
+};
+
+#endif
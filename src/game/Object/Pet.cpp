@@ -85,6 +85,7 @@ void Pet::AddToWorld()
     ///- Register the pet for guid lookup
     if (!IsInWorld())
     {
+        MapRegionGuard guard(GetMap());
         GetMap()->GetObjectsStore().insert<Pet>(GetObjectGuid(), (Pet*)this);
     }
 
@@ -96,6 +97,7 @@ void Pet::RemoveFromWorld()
     ///- Remove the pet from the accessor
     if (IsInWorld())
     {
+        MapRegionGuard guard(GetMap());
         GetMap()->GetObjectsStore().erase<Pet>(GetObjectGuid(), (Pet*)NULL);
     }
 
@@ -443,12 +445,89 @@ void Pet::SavePetToDB(PetSaveMode mode)
             RemoveAllAuras();
         }
 
+        std::ostringstream abdata;
+        for (uint32 i = ACTION_BAR_INDEX_START; i < ACTION_BAR_INDEX_END; ++i)
+        {
+            abdata << uint32(m_charmInfo->GetActionBarEntry(i)->GetType()) << " "
+                   << uint32(m_charmInfo->GetActionBarEntry(i)->GetAction()) << " ";
+        };
+
+        // save spells the pet can teach to it's Master
+        std::ostringstream teachdata;
+        {
+            int i = 0;
+            for (TeachSpellMap::const_iterator itr = m_teachspells.begin(); i < 4 && itr != m_teachspells.end(); ++i, ++itr)
+            {
+                teachdata << itr->first << " " << itr->second << " ";
+            }
+            for (; i < 4; ++i)
+            {
+                teachdata << uint32(0) << " " << uint32(0) << " ";
+            }
+        }
+
+        // compare every section with its last save, an unchanged pet is not written at all
+        bool saveSpells = _HasUnsavedSpells();
+
+        std::ostringstream cooldownData;
+        time_t curTime = time(NULL);
+        for (CreatureSpellCooldowns::iterator itr = m_CreatureSpellCooldowns.begin(); itr != m_CreatureSpellCooldowns.end();)
+        {
+            if (itr->second <= curTime)
+            {
+                m_CreatureSpellCooldowns.erase(itr++);
+            }
+            else
+            {
+                cooldownData << itr->first << " " << uint64(itr->second) << " ";
+                ++itr;
+            }
+        }
+        bool saveCooldowns = cooldownData.str() != m_savedCooldownData;
+
+        PetAuraSaveRows auraRows;
+        _CollectAuraSaveRows(auraRows);
+        std::string auraData(auraRows.empty() ? NULL : reinterpret_cast<char const*>(&auraRows[0]), auraRows.size() * sizeof(PetAuraSaveRow));
+        bool saveAuras = auraData != m_savedAuraData;
+
+        std::ostringstream rowData;
+        rowData << GetEntry() << " " << GetNativeDisplayId() << " " << getLevel() << " " << GetUInt32Value(UNIT_FIELD_PETEXPERIENCE) << " "
+                << uint32(m_charmInfo->GetReactState()) << " " << m_loyaltyPoints << " " << GetLoyaltyLevel() << " " << m_TrainingPoints << " "
+                << uint32(mode) << " " << uint32(HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_RENAME) ? 0 : 1) << " " << curhealth << " " << curpower << " "
+                << GetPower(POWER_HAPPINESS) << " " << m_resetTalentsCost << " " << uint64(m_resetTalentsTime) << " "
+                << GetUInt32Value(UNIT_CREATED_BY_SPELL) << " " << uint32(getPetType()) << " "
+                << abdata.str() << "|" << teachdata.str() << "|" << m_name;
+        // `savetime` is the base of the saved aura durations, so new auras rewrite the row as well
+        bool saveRow = saveAuras || rowData.str() != m_savedRowData;
+
+        if (!saveSpells && !saveCooldowns && !saveRow)
+        {
+            return;
+        }
+
         // save pet's data as one single transaction
         CharacterDatabase.BeginTransaction();
-        _SaveSpells();
-        _SaveSpellCooldowns();
-        _SaveAuras();
+        if (saveSpells)
+        {
+            _SaveSpells();
+        }
+        if (saveCooldowns)
+        {
+            _SaveSpellCooldowns();
+            m_savedCooldownData = cooldownData.str();
+        }
+        if (saveAuras)
+        {
+            _SaveAuras(auraRows);
+            m_savedAuraData.swap(auraData);
+        }
 
+        if (!saveRow)
+        {
+            CharacterDatabase.CommitTransaction();
+            return;
+        }
+        m_savedRowData = rowData.str();
 
         uint32 ownerLow = GetOwnerGuid().GetCounter();
         // remove current data
@@ -497,30 +576,9 @@ void Pet::SavePetToDB(PetSaveMode mode)
         savePet.addUInt32((curhealth));
         savePet.addUInt32(curpower);
         savePet.addUInt32(GetPower(POWER_HAPPINESS));
-
-        std::ostringstream ss;
-        for (uint32 i = ACTION_BAR_INDEX_START; i < ACTION_BAR_INDEX_END; ++i)
-        {
-            ss << uint32(m_charmInfo->GetActionBarEntry(i)->GetType()) << " "
-               << uint32(m_charmInfo->GetActionBarEntry(i)->GetAction()) << " ";
-        };
-        savePet.addString(ss);
-
-        // save spells the pet can teach to it's Master
-        {
-            int i = 0;
-            for (TeachSpellMap::const_iterator itr = m_teachspells.begin(); i < 4 && itr != m_teachspells.end(); ++i, ++itr)
-            {
-                ss << itr->first << " " << itr->second << " ";
-            }
-            for (; i < 4; ++i)
-            {
-                ss << uint32(0) << " " << uint32(0) << " ";
-            }
-        }
-        savePet.addString(ss);
-
-        savePet.addUInt64(uint64(time(NULL)));
+        savePet.addString(abdata);
+        savePet.addString(teachdata);
+        savePet.addUInt64(uint64(curTime));
         savePet.addUInt32(uint32(m_resetTalentsCost));
         savePet.addUInt64(uint64(m_resetTalentsTime));
         savePet.addUInt32(GetUInt32Value(UNIT_CREATED_BY_SPELL));
@@ -1521,21 +1579,11 @@ void Pet::_SaveSpellCooldowns()
     SqlStatement stmt = CharacterDatabase.CreateStatement(delSpellCD, "DELETE FROM `pet_spell_cooldown` WHERE `guid` = ?");
     stmt.PExecute(m_charmInfo->GetPetNumber());
 
-    time_t curTime = time(NULL);
-
-    // remove oudated and save active
-    for (CreatureSpellCooldowns::iterator itr = m_CreatureSpellCooldowns.begin(); itr != m_CreatureSpellCooldowns.end();)
+    // outdated cooldowns are already removed by SavePetToDB
+    for (CreatureSpellCooldowns::const_iterator itr = m_CreatureSpellCooldowns.begin(); itr != m_CreatureSpellCooldowns.end(); ++itr)
     {
-        if (itr->second <= curTime)
-        {
-            m_CreatureSpellCooldowns.erase(itr++);
-        }
-        else
-        {
-            stmt = CharacterDatabase.CreateStatement(insSpellCD, "INSERT INTO `pet_spell_cooldown` (`guid`,`spell`,`time`) VALUES (?, ?, ?)");
-            stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first, uint64(itr->second));
-            ++itr;
-        }
+        stmt = CharacterDatabase.CreateStatement(insSpellCD, "INSERT INTO `pet_spell_cooldown` (`guid`,`spell`,`time`) VALUES (?, ?, ?)");
+        stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first, uint64(itr->second));
     }
 }
 
@@ -1557,11 +1605,25 @@ void Pet::_LoadSpells()
     }
 }
 
+bool Pet::_HasUnsavedSpells() const
+{
+    for (PetSpellMap::const_iterator itr = m_spells.begin(); itr != m_spells.end(); ++itr)
+    {
+        if (itr->second.state != PETSPELL_UNCHANGED && itr->second.type != PETSPELL_FAMILY)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void Pet::_SaveSpells()
 {
     static SqlStatementID delSpell ;
     static SqlStatementID insSpell ;
 
+    // all deletes first, so that the inserts follow each other and the transaction sends them as one multi-row INSERT
     for (PetSpellMap::iterator itr = m_spells.begin(), next = m_spells.begin(); itr != m_spells.end(); itr = next)
     {
         ++next;
@@ -1572,32 +1634,29 @@ void Pet::_SaveSpells()
             continue;
         }
 
-        switch (itr->second.state)
+        if (itr->second.state == PETSPELL_REMOVED || itr->second.state == PETSPELL_CHANGED)
         {
-            case PETSPELL_REMOVED:
+            SqlStatement stmt = CharacterDatabase.CreateStatement(delSpell, "DELETE FROM `pet_spell` WHERE `guid` = ? AND `spell` = ?");
+            stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first);
+
+            if (itr->second.state == PETSPELL_REMOVED)
             {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(delSpell, "DELETE FROM `pet_spell` WHERE `guid` = ? AND `spell` = ?");
-                stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first);
                 m_spells.erase(itr);
             }
+        }
+    }
+
+    for (PetSpellMap::iterator itr = m_spells.begin(); itr != m_spells.end(); ++itr)
+    {
+        if (itr->second.type == PETSPELL_FAMILY)
+        {
             continue;
-            case PETSPELL_CHANGED:
-            {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(delSpell, "DELETE FROM `pet_spell` WHERE `guid` = ? AND `spell` = ?");
-                stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first);
+        }
 
-                stmt = CharacterDatabase.CreateStatement(insSpell, "INSERT INTO `pet_spell` (`guid`,`spell`,`active`) VALUES (?, ?, ?)");
-                stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first, uint32(itr->second.active));
-            }
-            break;
-            case PETSPELL_NEW:
-            {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(insSpell, "INSERT INTO `pet_spell` (`guid`,`spell`,`active`) VALUES (?, ?, ?)");
-                stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first, uint32(itr->second.active));
-            }
-            break;
-            case PETSPELL_UNCHANGED:
-                continue;
+        if (itr->second.state == PETSPELL_CHANGED || itr->second.state == PETSPELL_NEW)
+        {
+            SqlStatement stmt = CharacterDatabase.CreateStatement(insSpell, "INSERT INTO `pet_spell` (`guid`,`spell`,`active`) VALUES (?, ?, ?)");
+            stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first, uint32(itr->second.active));
         }
 
         itr->second.state = PETSPELL_UNCHANGED;
@@ -1716,25 +1775,10 @@ void Pet::_LoadAuras(uint32 timediff)
     }
 }
 
-void Pet::_SaveAuras()
+void Pet::_CollectAuraSaveRows(PetAuraSaveRows& rows) const
 {
-    static SqlStatementID delAuras ;
-    static SqlStatementID insAuras ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delAuras, "DELETE FROM `pet_aura` WHERE `guid` = ?");
-    stmt.PExecute(m_charmInfo->GetPetNumber());
-
     SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
 
-    if (auraHolders.empty())
-    {
-        return;
-    }
-
-    stmt = CharacterDatabase.CreateStatement(insAuras, "INSERT INTO `pet_aura` (`guid`, `caster_guid`, `item_guid`, `spell`, `stackcount`, `remaincharges`, "
-            "`basepoints0`, `basepoints1`, `basepoints2`, `periodictime0`, `periodictime1`, `periodictime2`, `maxduration`, `remaintime`, `effIndexMask`) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
-
     for (SpellAuraHolderMap::const_iterator itr = auraHolders.begin(); itr != auraHolders.end(); ++itr)
     {
         SpellAuraHolder* holder = itr->second;
@@ -1755,15 +1799,11 @@ void Pet::_SaveAuras()
         // do not save single target holders (unless they were cast by the player)
         if (save && !holder->IsPassive() && !IsChanneledSpell(holder->GetSpellProto()) && (holder->GetCasterGuid() == GetObjectGuid() || holder->GetTrackedAuraType() != TRACK_AURA_TYPE_NOT_TRACKED))
         {
-            int32  damage[MAX_EFFECT_INDEX];
-            uint32 periodicTime[MAX_EFFECT_INDEX];
-            uint32 effIndexMask = 0;
+            PetAuraSaveRow row;
+            memset(&row, 0, sizeof(row));
 
             for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
             {
-                damage[i] = 0;
-                periodicTime[i] = 0;
-
                 if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
                 {
                     // don't save not own area auras
@@ -1772,39 +1812,69 @@ void Pet::_SaveAuras()
                         continue;
                     }
 
-                    damage[i] = aur->GetModifier()->m_amount;
-                    periodicTime[i] = aur->GetModifier()->periodictime;
-                    effIndexMask |= (1 << i);
+                    row.damage[i] = aur->GetModifier()->m_amount;
+                    row.periodicTime[i] = aur->GetModifier()->periodictime;
+                    row.effIndexMask |= (1 << i);
                 }
             }
 
-            if (!effIndexMask)
+            if (!row.effIndexMask)
             {
                 continue;
             }
 
-            stmt.addUInt32(m_charmInfo->GetPetNumber());
-            stmt.addUInt64(holder->GetCasterGuid().GetRawValue());
-            stmt.addUInt32(holder->GetCastItemGuid().GetCounter());
-            stmt.addUInt32(holder->GetId());
-            stmt.addUInt32(holder->GetStackAmount());
-            stmt.addUInt8(holder->GetAuraCharges());
+            row.casterGuid = holder->GetCasterGuid().GetRawValue();
+            row.itemGuid = holder->GetCastItemGuid().GetCounter();
+            row.spell = holder->GetId();
+            row.stackCount = holder->GetStackAmount();
+            row.charges = holder->GetAuraCharges();
+            row.maxDuration = holder->GetAuraMaxDuration();
+            row.remainTime = holder->GetAuraDuration();
+            rows.push_back(row);
+        }
+    }
+}
 
-            for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-            {
-                stmt.addInt32(damage[i]);
-            }
+void Pet::_SaveAuras(PetAuraSaveRows const& rows)
+{
+    static SqlStatementID delAuras ;
+    static SqlStatementID insAuras ;
 
-            for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-            {
-                stmt.addUInt32(periodicTime[i]);
-            }
+    SqlStatement stmt = CharacterDatabase.CreateStatement(delAuras, "DELETE FROM `pet_aura` WHERE `guid` = ?");
+    stmt.PExecute(m_charmInfo->GetPetNumber());
 
-            stmt.addInt32(holder->GetAuraMaxDuration());
-            stmt.addInt32(holder->GetAuraDuration());
-            stmt.addUInt32(effIndexMask);
-            stmt.Execute();
+    if (rows.empty())
+    {
+        return;
+    }
+
+    stmt = CharacterDatabase.CreateStatement(insAuras, "INSERT INTO `pet_aura` (`guid`, `caster_guid`, `item_guid`, `spell`, `stackcount`, `remaincharges`, "
+            "`basepoints0`, `basepoints1`, `basepoints2`, `periodictime0`, `periodictime1`, `periodictime2`, `maxduration`, `remaintime`, `effIndexMask`) "
+            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+    for (PetAuraSaveRows::const_iterator itr = rows.begin(); itr != rows.end(); ++itr)
+    {
+        stmt.addUInt32(m_charmInfo->GetPetNumber());
+        stmt.addUInt64(itr->casterGuid);
+        stmt.addUInt32(itr->itemGuid);
+        stmt.addUInt32(itr->spell);
+        stmt.addUInt32(itr->stackCount);
+        stmt.addUInt8(uint8(itr->charges));
+
+        for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+        {
+            stmt.addInt32(itr->damage[i]);
         }
+
+        for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+        {
+            stmt.addUInt32(itr->periodicTime[i]);
+        }
+
+        stmt.addInt32(itr->maxDuration);
+        stmt.addInt32(itr->remainTime);
+        stmt.addUInt32(itr->effIndexMask);
+        stmt.Execute();
     }
 }
 
@@ -144,7 +144,23 @@ enum PetNameInvalidReason
     PET_NAME_DECLENSION_DOESNT_MATCH_BASE_NAME              = 16
 };
 
+// one `pet_aura` row, zero filled so that rows can be compared bytewise
+struct PetAuraSaveRow
+{
+    uint64 casterGuid;
+    uint32 itemGuid;
+    uint32 spell;
+    uint32 stackCount;
+    uint32 charges;
+    int32  damage[MAX_EFFECT_INDEX];
+    uint32 periodicTime[MAX_EFFECT_INDEX];
+    int32  maxDuration;
+    int32  remainTime;
+    uint32 effIndexMask;
+};
+
 typedef UNORDERED_MAP<uint32, PetSpell> PetSpellMap;
+typedef std::vector<PetAuraSaveRow> PetAuraSaveRows;
 typedef std::map<uint32, uint32> TeachSpellMap;
 typedef std::vector<uint32> AutoSpellList;
 
@@ -265,8 +281,10 @@ class Pet : public Creature
         void _LoadSpellCooldowns();
         void _SaveSpellCooldowns();
         void _LoadAuras(uint32 timediff);
-        void _SaveAuras();
+        void _CollectAuraSaveRows(PetAuraSaveRows& rows) const;
+        void _SaveAuras(PetAuraSaveRows const& rows);
         void _LoadSpells();
+        bool _HasUnsavedSpells() const;
         void _SaveSpells();
 
         bool addSpell(uint32 spell_id, ActiveStates active = ACT_DECIDE, PetSpellState state = PETSPELL_NEW, PetSpellType type = PETSPELL_NORMAL);
@@ -311,6 +329,11 @@ class Pet : public Creature
     private:
         PetModeFlags m_petModeFlags;
 
+        // contents of the sections at the last save, SavePetToDB rewrites only the changed ones
+        std::string m_savedRowData;
+        std::string m_savedCooldownData;
+        std::string m_savedAuraData;
+
         void SaveToDB(uint32) override                      // overwrited of Creature::SaveToDB     - don't must be called
         {
             MANGOS_ASSERT(false);
@@ -67,6 +67,9 @@
 #include "DBCStores.h"
 #include "SQLStorages.h"
 #include "DisableMgr.h"
+#include "CharacterLoginCache.h"
+#include "CharEnumCache.h"
+#include "PlayerNameCache.h"
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
 #endif /* ENABLE_ELUNA */
@@ -481,6 +484,7 @@ Player::Player(WorldSession* session): Unit(), m_mover(this), m_camera(this), m_
     // group is initialized in the reference constructor
     SetGroupInvite(NULL);
     m_groupUpdateMask = 0;
+    m_groupUpdateTimer = 0;
     m_auraUpdateMask = 0;
 
     ClearHonorInfo();
@@ -526,8 +530,6 @@ Player::Player(WorldSession* session): Unit(), m_mover(this), m_camera(this), m_
 
     m_swingErrorMsg = 0;
 
-    m_DetectInvTimer = 1 * IN_MILLISECONDS;
-
     for (int j = 0; j < PLAYER_MAX_BATTLEGROUND_QUEUES; ++j)
     {
         m_bgBattleGroundQueueID[j].bgQueueTypeId  = BATTLEGROUND_QUEUE_NONE;
@@ -554,7 +556,12 @@ Player::Player(WorldSession* session): Unit(), m_mover(this), m_camera(this), m_
     //////////////////// Rest System/////////////////////
 
     m_mailsUpdated = false;
+    m_mailedItemsLoaded = false;
     unReadMails = 0;
+
+    m_savedAurasHash = 0;
+    m_savedSpellCooldownsHash = 0;
+    m_savedStatsHash = 0;
     m_nextMailDelivereTime = 0;
 
     m_resetTalentsCost = 0;
@@ -590,6 +597,9 @@ Player::Player(WorldSession* session): Unit(), m_mover(this), m_camera(this), m_
 
     m_lastFallTime = 0;
     m_lastFallZ = 0;
+
+    m_questGiverStatusGeneration = 0;
+    m_conditionResultsGeneration = 0;
 #ifdef ENABLE_PLAYERBOTS
     m_playerbotAI = NULL;
     m_playerbotMgr = NULL;
@@ -675,6 +685,7 @@ bool Player::Create(uint32 guidlow, const std::string& name, uint8 race, uint8 c
     // FIXME: outfitId not used in player creating
 
     Object::_Create(guidlow, 0, HIGHGUID_PLAYER);
+    m_updateScheduler.Initialize(guidlow);
 
     m_name = name;
 
@@ -1295,6 +1306,12 @@ void Player::Update(uint32 update_diff, uint32 p_time)
     Unit::Update(update_diff, p_time);
     SetCanDelayTeleport(false);
 
+    // movement of others that waited for the end of its window
+    m_movementCoalescer.Update(this);
+
+    // reputation changed by the kills and rewards since the last update
+    m_reputationMgr.SendPendingStates();
+
     // Update player only attacks
     if (uint32 ranged_att = getAttackTimer(RANGED_ATTACK))
     {
@@ -1303,18 +1320,37 @@ void Player::Update(uint32 update_diff, uint32 p_time)
 
     time_t now = time(NULL);
 
-    UpdatePvPFlag(now);
-
-    UpdateContestedPvP(update_diff);
+    // periodic checks, each runs once per its interval with the time passed since its previous run
+    uint32 elapsed;
 
-    UpdateDuelFlag(now);
+    if (m_updateScheduler.Update(PLAYER_UPDATE_TASK_PVP_FLAGS, update_diff, elapsed))
+    {
+        UpdatePvPFlag(now);
+        UpdateContestedPvP(elapsed);
+    }
 
-    CheckDuelDistance(now);
+    if (m_updateScheduler.Update(PLAYER_UPDATE_TASK_DUEL, update_diff, elapsed) && duel)
+    {
+        UpdateDuelFlag(now);
+        CheckDuelDistance(now);
+    }
 
-    // Update items that have just a limited lifetime
-    if (now > m_Last_tick)
+    if (m_updateScheduler.Update(PLAYER_UPDATE_TASK_DURATIONS, update_diff, elapsed))
     {
-        UpdateItemDuration(uint32(now - m_Last_tick));
+        // Update items that have just a limited lifetime
+        if (now > m_Last_tick)
+        {
+            UpdateItemDuration(uint32(now - m_Last_tick));
+
+            // Played time
+            uint32 playedElapsed = uint32(now - m_Last_tick);
+            m_Played_time[PLAYED_TIME_TOTAL] += playedElapsed;  // Total played time
+            m_Played_time[PLAYED_TIME_LEVEL] += playedElapsed;  // Level played time
+            m_Last_tick = now;
+        }
+
+        UpdateEnchantTime(elapsed);
+        UpdateHomebindTime(elapsed);
     }
 
     if (!m_timedquests.empty())
@@ -1355,9 +1391,10 @@ void Player::Update(uint32 update_diff, uint32 p_time)
                 RemoveAurasWithInterruptFlags(AURA_INTERRUPT_FLAG_ENTER_PVP_COMBAT);
             }
         }
-    }// Speed collect rest bonus (section/in hour)
+    }
 
-    if (HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING))
+    // Speed collect rest bonus (section/in hour)
+    if (m_updateScheduler.Update(PLAYER_UPDATE_TASK_REST, update_diff, elapsed) && HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING))
     {
         if (GetTimeInnEnter() > 0)                          // Freeze update
         {
@@ -1467,26 +1504,9 @@ void Player::Update(uint32 update_diff, uint32 p_time)
     HandleDrowning(update_diff);
 
     // Handle detect stealth players
-    if (m_DetectInvTimer > 0)
-    {
-        if (update_diff >= m_DetectInvTimer)
-        {
-            HandleStealthedUnitsDetection();
-            m_DetectInvTimer = 3000;
-        }
-        else
-        {
-            m_DetectInvTimer -= update_diff;
-        }
-    }
-
-    // Played time
-    if (now > m_Last_tick)
+    if (m_updateScheduler.Update(PLAYER_UPDATE_TASK_STEALTH_DETECT, update_diff, elapsed))
     {
-        uint32 elapsed = uint32(now - m_Last_tick);
-        m_Played_time[PLAYED_TIME_TOTAL] += elapsed;        // Total played time
-        m_Played_time[PLAYED_TIME_LEVEL] += elapsed;        // Level played time
-        m_Last_tick = now;
+        HandleStealthedUnitsDetection();
     }
 
     if (m_drunk)
@@ -1514,11 +1534,16 @@ void Player::Update(uint32 update_diff, uint32 p_time)
         }
     }
 
-    UpdateEnchantTime(update_diff);
-    UpdateHomebindTime(update_diff);
-
-    // Group update
-    SendUpdateToOutOfRangeGroupMembers();
+    // Group update, changes are collected in m_groupUpdateMask until the delay expires
+    if (m_groupUpdateTimer <= update_diff)
+    {
+        SendUpdateToOutOfRangeGroupMembers();
+        m_groupUpdateTimer = sWorld.getConfig(CONFIG_UINT32_GROUP_MEMBER_UPDATE_DELAY);
+    }
+    else
+    {
+        m_groupUpdateTimer -= update_diff;
+    }
     if (IsHasDelayedTeleport())
     {
         TeleportTo(m_teleport_dest, m_teleport_options);
@@ -2712,6 +2737,8 @@ void Player::GiveLevel(uint32 level)
     }
     SetLevel(level);
     UpdateSkillsForLevel();
+    InvalidateQuestGiverStatus();
+    InvalidateConditionResults();
 
     // save base values (bonuses already included in stored stats
     for (int i = STAT_STRENGTH; i < MAX_STATS; ++i)
@@ -2827,6 +2854,8 @@ void Player::InitStatsForLevel(bool reapplyMods)
     SetUInt32Value(UNIT_FIELD_AURASTATE, 0);
 
     UpdateSkillsForLevel();
+    InvalidateQuestGiverStatus();
+    InvalidateConditionResults();
 
     // set default cast time multiplier
     SetFloatValue(UNIT_MOD_CAST_SPEED, 1.0f);
@@ -3168,6 +3197,8 @@ bool Player::addSpell(uint32 spell_id, bool active, bool learning, bool dependen
         return false;
     }
 
+    InvalidateConditionResults();
+
     if (!SpellMgr::IsSpellValid(spellInfo, this, false))
     {
         // do character spell book cleanup (all characters)
@@ -3597,6 +3628,8 @@ void Player::removeSpell(uint32 spell_id, bool disabled, bool learn_low_rank)
         return;
     }
 
+    InvalidateConditionResults();
+
     // unlearn non talent higher ranks (recursive)
     SpellChainMapNext const& nextMap = sSpellMgr.GetSpellChainNext();
     for (SpellChainMapNext::const_iterator itr2 = nextMap.lower_bound(spell_id); itr2 != nextMap.upper_bound(spell_id); ++itr2)
@@ -3898,18 +3931,46 @@ void Player::_LoadSpellCooldowns(QueryResult* result)
     }
 }
 
+/**
+ * Compares the rows a save section would write with the ones written last time.
+ * Returns false when they are the same, else stores the new fingerprint and
+ * returns true so the caller rewrites the section.
+ */
+static bool UpdateSaveSectionHash(uint64& savedHash, ByteBuffer const& rows)
+{
+    // FNV-1a, 0 is reserved for a section not written yet
+    uint64 hash = UI64LIT(14695981039346656037);
+    for (size_t i = 0; i < rows.wpos(); ++i)
+    {
+        hash ^= rows.contents()[i];
+        hash *= UI64LIT(1099511628211);
+    }
+
+    if (!hash)
+    {
+        hash = 1;
+    }
+
+    if (hash == savedHash)
+    {
+        return false;
+    }
+
+    savedHash = hash;
+    return true;
+}
+
 void Player::_SaveSpellCooldowns()
 {
     static SqlStatementID deleteSpellCooldown ;
     static SqlStatementID insertSpellCooldown ;
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM `character_spell_cooldown` WHERE `guid` = ?");
-    stmt.PExecute(GetGUIDLow());
-
     time_t curTime = time(NULL);
     time_t infTime = curTime + infinityCooldownDelayCheck;
 
-    // remove outdated and save active
+    ByteBuffer rows;
+
+    // remove outdated and collect active
     for (SpellCooldowns::iterator itr = m_spellCooldowns.begin(); itr != m_spellCooldowns.end();)
     {
         if (itr->second.end <= curTime)
@@ -3918,8 +3979,7 @@ void Player::_SaveSpellCooldowns()
         }
         else if (itr->second.end <= infTime)                // not save locked cooldowns, it will be reset or set at reload
         {
-            stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO `character_spell_cooldown` (`guid`,`spell`,`item`,`time`) VALUES( ?, ?, ?, ?)");
-            stmt.PExecute(GetGUIDLow(), itr->first, itr->second.itemid, uint64(itr->second.end));
+            rows << uint32(itr->first) << uint32(itr->second.itemid) << uint64(itr->second.end);
             ++itr;
         }
         else
@@ -3927,6 +3987,25 @@ void Player::_SaveSpellCooldowns()
             ++itr;
         }
     }
+
+    // the stored cooldowns are still up to date
+    if (!UpdateSaveSectionHash(m_savedSpellCooldownsHash, rows))
+    {
+        return;
+    }
+
+    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM `character_spell_cooldown` WHERE `guid` = ?");
+    stmt.PExecute(GetGUIDLow());
+
+    while (rows.rpos() < rows.wpos())
+    {
+        uint32 spellId, itemId;
+        uint64 end;
+        rows >> spellId >> itemId >> end;
+
+        stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO `character_spell_cooldown` (`guid`,`spell`,`item`,`time`) VALUES( ?, ?, ?, ?)");
+        stmt.PExecute(GetGUIDLow(), spellId, itemId, end);
+    }
 }
 
 uint32 Player::resetTalentsCost() const
@@ -4068,9 +4147,9 @@ void Player::_SetCreateBits(UpdateMask* updateMask, Player* target) const
     }
     else
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateVisualBits.FindNextBit(0); index < m_valuesCount; index = updateVisualBits.FindNextBit(index + 1))
         {
-            if (GetUInt32Value(index) != 0 && updateVisualBits.GetBit(index))
+            if (GetUInt32Value(index) != 0)
             {
                 updateMask->SetBit(index);
             }
@@ -4377,6 +4456,12 @@ TrainerSpellState Player::GetTrainerSpellState(TrainerSpell const* trainer_spell
  */
 void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRealmChars, bool deleteFinally)
 {
+    sCharacterLoginCache.Invalidate(playerguid.GetCounter());
+    sCharEnumCache.InvalidateAccount(accountId);
+
+    // keep the deletion in order with the saves of the character
+    SqlOrderingGuard ordering(CharacterDatabase, playerguid.GetCounter());
+
     //Make sure to delete unresolved tickets so they don't take up place in the open tickets list
     CharacterDatabase.PExecute("DELETE FROM `character_ticket` "
                                "WHERE `resolved` = 0 AND `guid` = %u",
@@ -4436,6 +4521,8 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
             // completely remove from the database
         case 0:
         {
+            sPlayerNameCache.Remove(lowguid, false);
+
             // return back all mails with COD and Item                  0    1             2                3        4         5      6       7
             QueryResult* resultMail = CharacterDatabase.PQuery("SELECT `id`,`messageType`,`mailTemplateId`,`sender`,`subject`,`body`,`money`,`has_items` FROM `mail` WHERE `receiver`='%u' AND `has_items`<>0 AND `cod`<>0", lowguid);
             if (resultMail)
@@ -4592,6 +4679,7 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
         }
         // The character gets unlinked from the account, the name gets freed up and appears as deleted ingame
         case 1:
+            sPlayerNameCache.Remove(lowguid, true);
             CharacterDatabase.PExecute("UPDATE `characters` SET `deleteInfos_Name`=`name`, `deleteInfos_Account`=`account`, `deleteDate`='" UI64FMTD "', `name`='', `account`=0 WHERE `guid`=%u", uint64(time(NULL)), lowguid);
             break;
         default:
@@ -5240,6 +5328,11 @@ void Player::LeftChannel(Channel* c)
     m_channels.remove(c);
 }
 
+bool Player::IsInChannel(Channel const* c) const
+{
+    return std::find(m_channels.begin(), m_channels.end(), c) != m_channels.end();
+}
+
 void Player::CleanupChannels()
 {
     while (!m_channels.empty())
@@ -5671,6 +5764,13 @@ bool Player::UpdateSkill(uint32 skill_id, uint32 step)
             skillStatus.uState = SKILL_CHANGED;
         }
 
+        InvalidateConditionResults();
+
+        if (sObjectMgr.IsQuestRequiredSkill(skill_id))
+        {
+            InvalidateQuestGiverStatus();
+        }
+
         return true;
     }
 
@@ -5820,6 +5920,13 @@ bool Player::UpdateSkillPro(uint16 SkillId, int32 Chance, uint32 step)
             skillStatus.uState = SKILL_CHANGED;
         }
 
+        InvalidateConditionResults();
+
+        if (sObjectMgr.IsQuestRequiredSkill(SkillId))
+        {
+            InvalidateQuestGiverStatus();
+        }
+
         DEBUG_LOG("Player::UpdateSkillPro Chance=%3.1f%% taken", Chance / 10.0);
         return true;
     }
@@ -5927,6 +6034,13 @@ void Player::ModifySkillBonus(uint32 skillid, int32 val, bool talent)
 
     uint32 bonusIndex = PLAYER_SKILL_BONUS_INDEX(itr->second.pos);
 
+    InvalidateConditionResults();
+
+    if (sObjectMgr.IsQuestRequiredSkill(skillid))
+    {
+        InvalidateQuestGiverStatus();
+    }
+
     uint32 bonus_val = GetUInt32Value(bonusIndex);
     int16 temp_bonus = SKILL_TEMP_BONUS(bonus_val);
     int16 perm_bonus = SKILL_PERM_BONUS(bonus_val);
@@ -6043,6 +6157,13 @@ void Player::SetSkill(uint16 id, uint16 currVal, uint16 maxVal, uint16 step /*=0
         return;
     }
 
+    InvalidateConditionResults();
+
+    if (sObjectMgr.IsQuestRequiredSkill(id))
+    {
+        InvalidateQuestGiverStatus();
+    }
+
     SkillStatusMap::iterator itr = mSkillStatus.find(id);
 
     // has skill
@@ -6621,7 +6742,7 @@ void Player::CheckAreaExploreAndOutdoor()
     }
 
     bool isOutdoor;
-    uint16 areaFlag = GetMap()->GetTerrain()->GetAreaFlag(GetPositionX(), GetPositionY(), GetPositionZ(), &isOutdoor);
+    uint16 areaFlag = GetAreaFlag(&isOutdoor);
 
     if (isOutdoor)
     {
@@ -7026,7 +7147,7 @@ void Player::UpdateHonor()
     SetHonorLastWeekStandingPos(sObjectMgr.GetHonorStandingPositionByGUID(GetGUIDLow(), GetTeam()));
 
     // RANK POINTS
-    HonorStanding* standing = sObjectMgr.GetHonorStandingByGUID(GetGUIDLow(), GetTeam());
+    HonorStanding const* standing = sObjectMgr.GetHonorStandingByGUID(GetGUIDLow(), GetTeam());
     float rankP = GetStoredHonor();
     if (standing)
     {
@@ -7405,6 +7526,11 @@ void Player::UpdateZone(uint32 newZone, uint32 newArea)
     m_zoneUpdateId    = newZone;
     m_zoneUpdateTimer = ZONE_UPDATE_INTERVAL;
 
+    if (IsInWorld())
+    {
+        GetMap()->SetPlayerZone(this, newZone);
+    }
+
     // zone changed, so area changed as well, update it
     UpdateArea(newArea);
 
@@ -8218,6 +8344,8 @@ void Player::_RemoveAllItemMods()
 {
     DEBUG_LOG("_RemoveAllItemMods start.");
 
+    StatUpdateBatch statBatch(this);
+
     for (int i = 0; i < INVENTORY_SLOT_BAG_END; ++i)
     {
         if (m_items[i])
@@ -8280,6 +8408,8 @@ void Player::_ApplyAllItemMods()
 {
     DEBUG_LOG("_ApplyAllItemMods start.");
 
+    StatUpdateBatch statBatch(this);
+
     for (int i = 0; i < INVENTORY_SLOT_BAG_END; ++i)
     {
         if (m_items[i])
@@ -8730,6 +8860,10 @@ void Player::SendLoot(ObjectGuid guid, LootType loot_type)
                     creature->lootForBody = true;
                     loot->clear();
 
+                    // rolled from the seed of the kill, so the time the corpse is opened does not matter
+                    uint32 nextSeed = rand32();
+                    seed_thread_rand(creature->GetBodyLootSeed());
+
                     if (uint32 lootid = creatureInfo->LootId)
                     {
                         loot->FillLoot(lootid, LootTemplates_Creature, recipient, false);
@@ -8737,6 +8871,8 @@ void Player::SendLoot(ObjectGuid guid, LootType loot_type)
 
                     loot->generateMoneyLoot(creatureInfo->MinLootGold, creatureInfo->MaxLootGold);
 
+                    seed_thread_rand(nextSeed);
+
                     if (Group* group = creature->GetGroupLootRecipient())
                     {
                         group->UpdateLooterGuid(creature, true);
@@ -9491,51 +9627,122 @@ InventoryResult Player::CanUnequipItems(uint32 item, uint32 count) const
     return res;
 }
 
-uint32 Player::GetItemCount(uint32 item, bool inBankAlso, Item* skipItem) const
+// where an indexed item counts for the entry queries, the slot ranges they used to walk
+enum ItemIndexPlace
 {
-    uint32 count = 0;
-    for (int i = EQUIPMENT_SLOT_START; i < INVENTORY_SLOT_ITEM_END; ++i)
+    ITEM_INDEX_PLACE_INVENTORY,                             // equipment, backpack, equipped bags and their contents
+    ITEM_INDEX_PLACE_KEYRING,
+    ITEM_INDEX_PLACE_BANK,                                  // bank slots and bank bag contents
+    ITEM_INDEX_PLACE_NONE                                   // bank bags themselves
+};
+
+static ItemIndexPlace GetItemIndexPlace(Item const* pItem)
+{
+    uint8 bag = pItem->GetBagSlot();
+    uint8 slot = pItem->GetSlot();
+
+    if (bag == INVENTORY_SLOT_BAG_0)
     {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem != skipItem &&  pItem->GetEntry() == item)
+        if (slot < INVENTORY_SLOT_ITEM_END)
         {
-            count += pItem->GetCount();
+            return ITEM_INDEX_PLACE_INVENTORY;
+        }
+        if (slot >= KEYRING_SLOT_START && slot < KEYRING_SLOT_END)
+        {
+            return ITEM_INDEX_PLACE_KEYRING;
+        }
+        if (slot >= BANK_SLOT_ITEM_START && slot < BANK_SLOT_ITEM_END)
+        {
+            return ITEM_INDEX_PLACE_BANK;
         }
+        return ITEM_INDEX_PLACE_NONE;
     }
-    for (int i = KEYRING_SLOT_START; i < KEYRING_SLOT_END; ++i)
+
+    if (bag >= INVENTORY_SLOT_BAG_START && bag < INVENTORY_SLOT_BAG_END)
     {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem != skipItem && pItem->GetEntry() == item)
+        return ITEM_INDEX_PLACE_INVENTORY;
+    }
+    if (bag >= BANK_SLOT_BAG_START && bag < BANK_SLOT_BAG_END)
+    {
+        return ITEM_INDEX_PLACE_BANK;
+    }
+    return ITEM_INDEX_PLACE_NONE;
+}
+
+void Player::IndexItem(Item* pItem)
+{
+    std::vector<Item*>& items = m_itemsByEntry[pItem->GetEntry()];
+    if (std::find(items.begin(), items.end(), pItem) == items.end())
+    {
+        items.push_back(pItem);
+    }
+
+    if (pItem->IsBag())
+    {
+        Bag* pBag = (Bag*)pItem;
+        for (uint32 i = 0; i < pBag->GetBagSize(); ++i)
         {
-            count += pItem->GetCount();
+            if (Item* bagItem = pBag->GetItemByPos(i))
+            {
+                IndexItem(bagItem);
+            }
         }
     }
-    for (int i = INVENTORY_SLOT_BAG_START; i < INVENTORY_SLOT_BAG_END; ++i)
+}
+
+void Player::UnindexItem(Item* pItem)
+{
+    ItemEntryIndex::iterator itr = m_itemsByEntry.find(pItem->GetEntry());
+    if (itr != m_itemsByEntry.end())
     {
-        Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pBag)
+        std::vector<Item*>& items = itr->second;
+        std::vector<Item*>::iterator found = std::find(items.begin(), items.end(), pItem);
+        if (found != items.end())
+        {
+            *found = items.back();
+            items.pop_back();
+        }
+
+        if (items.empty())
         {
-            count += pBag->GetItemCount(item, skipItem);
+            m_itemsByEntry.erase(itr);
         }
     }
 
-    if (inBankAlso)
+    if (pItem->IsBag())
     {
-        for (int i = BANK_SLOT_ITEM_START; i < BANK_SLOT_ITEM_END; ++i)
+        Bag* pBag = (Bag*)pItem;
+        for (uint32 i = 0; i < pBag->GetBagSize(); ++i)
         {
-            Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-            if (pItem && pItem != skipItem && pItem->GetEntry() == item)
+            if (Item* bagItem = pBag->GetItemByPos(i))
             {
-                count += pItem->GetCount();
+                UnindexItem(bagItem);
             }
         }
-        for (int i = BANK_SLOT_BAG_START; i < BANK_SLOT_BAG_END; ++i)
+    }
+}
+
+uint32 Player::GetItemCount(uint32 item, bool inBankAlso, Item* skipItem) const
+{
+    ItemEntryIndex::const_iterator itr = m_itemsByEntry.find(item);
+    if (itr == m_itemsByEntry.end())
+    {
+        return 0;
+    }
+
+    uint32 count = 0;
+    for (std::vector<Item*>::const_iterator iter = itr->second.begin(); iter != itr->second.end(); ++iter)
+    {
+        Item* pItem = *iter;
+        if (pItem == skipItem)
         {
-            Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-            if (pBag)
-            {
-                count += pBag->GetItemCount(item, skipItem);
-            }
+            continue;
+        }
+
+        ItemIndexPlace place = GetItemIndexPlace(pItem);
+        if (place == ITEM_INDEX_PLACE_INVENTORY || place == ITEM_INDEX_PLACE_KEYRING || (inBankAlso && place == ITEM_INDEX_PLACE_BANK))
+        {
+            count += pItem->GetCount();
         }
     }
 
@@ -9544,21 +9751,32 @@ uint32 Player::GetItemCount(uint32 item, bool inBankAlso, Item* skipItem) const
 
 Item* Player::GetItemByEntry(uint32 item) const
 {
-     for (int i = EQUIPMENT_SLOT_START; i < INVENTORY_SLOT_ITEM_END; ++i)
-        if (Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-            if (pItem->GetEntry() == item)
-            {
-                return pItem;
-            }
+    ItemEntryIndex::const_iterator itr = m_itemsByEntry.find(item);
+    if (itr == m_itemsByEntry.end())
+    {
+        return NULL;
+    }
 
-    for (int i = INVENTORY_SLOT_BAG_START; i < INVENTORY_SLOT_BAG_END; ++i)
-        if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-            if (Item* itemPtr = pBag->GetItemByEntry(item))
-            {
-                return itemPtr;
-            }
+    // the first one in slot order, backpack before bags
+    Item* first = NULL;
+    uint32 firstPos = 0;
+    for (std::vector<Item*>::const_iterator iter = itr->second.begin(); iter != itr->second.end(); ++iter)
+    {
+        Item* pItem = *iter;
+        if (GetItemIndexPlace(pItem) != ITEM_INDEX_PLACE_INVENTORY)
+        {
+            continue;
+        }
 
-    return NULL;
+        uint32 pos = pItem->GetBagSlot() == INVENTORY_SLOT_BAG_0 ? pItem->GetSlot() : ((uint32(pItem->GetBagSlot()) + 1) << 8) | pItem->GetSlot();
+        if (!first || pos < firstPos)
+        {
+            first = pItem;
+            firstPos = pos;
+        }
+    }
+
+    return first;
 }
 
 Item* Player::GetItemByGuid(ObjectGuid guid) const
@@ -9861,23 +10079,23 @@ bool Player::IsValidPos(uint8 bag, uint8 slot, bool explicit_pos) const
 
 bool Player::HasItemCount(uint32 item, uint32 count, bool inBankAlso) const
 {
+    ItemEntryIndex::const_iterator itr = m_itemsByEntry.find(item);
+    if (itr == m_itemsByEntry.end())
+    {
+        return false;
+    }
+
     uint32 tempcount = 0;
-    for (int i = EQUIPMENT_SLOT_START; i < INVENTORY_SLOT_ITEM_END; ++i)
+    for (std::vector<Item*>::const_iterator iter = itr->second.begin(); iter != itr->second.end(); ++iter)
     {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
+        Item* pItem = *iter;
+        if (pItem->IsInTrade())
         {
-            tempcount += pItem->GetCount();
-            if (tempcount >= count)
-            {
-                return true;
-            }
+            continue;
         }
-    }
-    for (int i = KEYRING_SLOT_START; i < KEYRING_SLOT_END; ++i)
-    {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
+
+        ItemIndexPlace place = GetItemIndexPlace(pItem);
+        if (place == ITEM_INDEX_PLACE_INVENTORY || place == ITEM_INDEX_PLACE_KEYRING || (inBankAlso && place == ITEM_INDEX_PLACE_BANK))
         {
             tempcount += pItem->GetCount();
             if (tempcount >= count)
@@ -9886,58 +10104,6 @@ bool Player::HasItemCount(uint32 item, uint32 count, bool inBankAlso) const
             }
         }
     }
-    for (int i = INVENTORY_SLOT_BAG_START; i < INVENTORY_SLOT_BAG_END; ++i)
-    {
-        if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-        {
-            for (uint32 j = 0; j < pBag->GetBagSize(); ++j)
-            {
-                Item* pItem = GetItemByPos(i, j);
-                if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
-                {
-                    tempcount += pItem->GetCount();
-                    if (tempcount >= count)
-                    {
-                        return true;
-                    }
-                }
-            }
-        }
-    }
-
-    if (inBankAlso)
-    {
-        for (int i = BANK_SLOT_ITEM_START; i < BANK_SLOT_ITEM_END; ++i)
-        {
-            Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-            if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
-            {
-                tempcount += pItem->GetCount();
-                if (tempcount >= count)
-                {
-                    return true;
-                }
-            }
-        }
-        for (int i = BANK_SLOT_BAG_START; i < BANK_SLOT_BAG_END; ++i)
-        {
-            if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-            {
-                for (uint32 j = 0; j < pBag->GetBagSize(); ++j)
-                {
-                    Item* pItem = GetItemByPos(i, j);
-                    if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
-                    {
-                        tempcount += pItem->GetCount();
-                        if (tempcount >= count)
-                        {
-                            return true;
-                        }
-                    }
-                }
-            }
-        }
-    }
 
     return false;
 }
@@ -11792,6 +11958,7 @@ Item* Player::_StoreItem(uint16 pos, Item* pItem, uint32 count, bool clone, bool
 
             pItem->SetSlot(slot);
             pItem->SetContainer(NULL);
+            IndexItem(pItem);
 
             if (IsInWorld() && update)
             {
@@ -11804,6 +11971,7 @@ Item* Player::_StoreItem(uint16 pos, Item* pItem, uint32 count, bool clone, bool
         else if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, bag))
         {
             pBag->StoreItem(slot, pItem);
+            IndexItem(pItem);
             if (IsInWorld() && update)
             {
                 pItem->AddToWorld();
@@ -12048,6 +12216,7 @@ void Player::VisualizeItem(uint8 slot, Item* pItem)
     pItem->SetGuidValue(ITEM_FIELD_OWNER, GetObjectGuid());
     pItem->SetSlot(slot);
     pItem->SetContainer(NULL);
+    IndexItem(pItem);
 
     if (slot < EQUIPMENT_SLOT_END)
     {
@@ -12115,6 +12284,7 @@ void Player::RemoveItem(uint8 bag, uint8 slot, bool update)
                 pBag->RemoveItem(slot);
             }
         }
+        UnindexItem(pItem);
         pItem->SetGuidValue(ITEM_FIELD_CONTAINED, ObjectGuid());
         // pItem->SetGuidValue(ITEM_FIELD_OWNER, ObjectGuid()); not clear owner at remove (it will be set at store). This used in mail and auction code
         pItem->SetSlot(NULL_SLOT);
@@ -12230,6 +12400,7 @@ void Player::DestroyItem(uint8 bag, uint8 slot, bool update)
         {
             pBag->RemoveItem(slot);
         }
+        UnindexItem(pItem);
 
         if (IsInWorld() && update)
         {
@@ -13628,7 +13799,7 @@ void Player::PrepareGossipMenu(WorldObject* pSource, uint32 menuId)
         bool hasMenuItem = true;
         bool isGMSkipConditionCheck = false;
 
-        if (gossipMenu.conditionId && !sObjectMgr.IsPlayerMeetToCondition(gossipMenu.conditionId, this, GetMap(), pSource, CONDITION_FROM_GOSSIP_OPTION))
+        if (gossipMenu.conditionId && !IsMeetingGossipCondition(gossipMenu.conditionId, pSource, true))
         {
             if (isGameMaster())                             // Let GM always see menu items regardless of conditions
             {
@@ -14013,7 +14184,7 @@ uint32 Player::GetGossipTextId(uint32 menuId, WorldObject* pSource)
         // Take the text that has the highest conditionId of all fitting
         // No condition and no text with condition found OR higher and fitting condition found
         if ((!gossipMenu.conditionId && !lastConditionId) ||
-            (gossipMenu.conditionId > lastConditionId && sObjectMgr.IsPlayerMeetToCondition(gossipMenu.conditionId, this, GetMap(), pSource, CONDITION_FROM_GOSSIP_MENU)))
+            (gossipMenu.conditionId > lastConditionId && IsMeetingGossipCondition(gossipMenu.conditionId, pSource, false)))
         {
             lastConditionId = gossipMenu.conditionId;
             textId = gossipMenu.text_id;
@@ -14868,6 +15039,9 @@ void Player::RewardQuest(Quest const* pQuest, uint32 reward, Object* questGiver,
         q_status.uState = QUEST_CHANGED;
     }
 
+    InvalidateQuestGiverStatus();
+    InvalidateConditionResults();
+
     if (announce)
     {
         SendQuestReward(pQuest, xp);
@@ -15983,6 +16157,13 @@ void Player::MoneyChanged(uint32 count)
 
 void Player::ReputationChanged(FactionEntry const* factionEntry)
 {
+    InvalidateConditionResults();
+
+    if (sObjectMgr.IsQuestRequiredFaction(factionEntry->ID))
+    {
+        InvalidateQuestGiverStatus();
+    }
+
     for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
     {
         if (uint32 questid = GetQuestSlotQuestId(i))
@@ -16349,6 +16530,7 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
     }
 
     Object::_Create(guid.GetCounter(), 0, HIGHGUID_PLAYER);
+    m_updateScheduler.Initialize(guid.GetCounter());
 
     m_name = fields[2].GetCppString();
 
@@ -16421,6 +16603,7 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
         delete m_items[slot];
         m_items[slot] = NULL;
     }
+    m_itemsByEntry.clear();
 
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "Load Basic value of player %s is: ", m_name.c_str());
     outDebugStatsValues();
@@ -16705,7 +16888,6 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
 
     // Mail
     _LoadMails(holder->GetResult(PLAYER_LOGIN_QUERY_LOADMAILS));
-    _LoadMailedItems(holder->GetResult(PLAYER_LOGIN_QUERY_LOADMAILEDITEMS));
     UpdateNextMailTimeAndUnreads();
 
     _LoadAuras(holder->GetResult(PLAYER_LOGIN_QUERY_LOADAURAS), time_diff);
@@ -17494,6 +17676,18 @@ void Player::_LoadItemLoot(QueryResult* result)
     }
 }
 
+void Player::LoadMailedItems()
+{
+    if (m_mailedItemsLoaded)
+    {
+        return;
+    }
+
+    m_mailedItemsLoaded = true;
+
+    _LoadMailedItems(CharacterDatabase.PQuery("SELECT `data`, `mail_id`, `item_guid`, `item_template` FROM `mail_items` JOIN `item_instance` ON `item_guid` = `guid` WHERE `receiver` = '%u'", GetGUIDLow()));
+}
+
 // load mailed item which should receive current player
 void Player::_LoadMailedItems(QueryResult* result)
 {
@@ -17517,6 +17711,13 @@ void Player::_LoadMailedItems(QueryResult* result)
         {
             continue;
         }
+
+        // delivered or generated since login, already known
+        if (GetMItem(item_guid_low))
+        {
+            continue;
+        }
+
         mail->AddItem(item_guid_low, item_template);
 
         ItemPrototype const* proto = ObjectMgr::GetItemPrototype(item_template);
@@ -18122,6 +18323,9 @@ void Player::SaveToDB()
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     outDebugStatsValues();
 
+    // saves of different characters may be written in parallel
+    SqlOrderingGuard ordering(CharacterDatabase, GetGUIDLow());
+
     CharacterDatabase.BeginTransaction();
 
     UpdateHonor();
@@ -18382,19 +18586,9 @@ void Player::_SaveAuras()
     static SqlStatementID deleteAuras ;
     static SqlStatementID insertAuras ;
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM `character_aura` WHERE `guid` = ?");
-    stmt.PExecute(GetGUIDLow());
-
     SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
 
-    if (auraHolders.empty())
-    {
-        return;
-    }
-
-    stmt = CharacterDatabase.CreateStatement(insertAuras, "INSERT INTO `character_aura` (`guid`, `caster_guid`, `item_guid`, `spell`, `stackcount`, `remaincharges`, "
-            "`basepoints0`, `basepoints1`, `basepoints2`, `periodictime0`, `periodictime1`, `periodictime2`, `maxduration`, `remaintime`, `effIndexMask`) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    ByteBuffer rows;
 
     for (SpellAuraHolderMap::const_iterator itr = auraHolders.begin(); itr != auraHolders.end(); ++itr)
     {
@@ -18434,29 +18628,70 @@ void Player::_SaveAuras()
                 continue;
             }
 
-            stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt64(holder->GetCasterGuid().GetRawValue());
-            stmt.addUInt32(holder->GetCastItemGuid().GetCounter());
-            stmt.addUInt32(holder->GetId());
-            stmt.addUInt32(holder->GetStackAmount());
-            stmt.addUInt8(holder->GetAuraCharges());
+            rows << uint64(holder->GetCasterGuid().GetRawValue());
+            rows << uint32(holder->GetCastItemGuid().GetCounter());
+            rows << uint32(holder->GetId());
+            rows << uint32(holder->GetStackAmount());
+            rows << uint8(holder->GetAuraCharges());
 
             for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
             {
-                stmt.addInt32(damage[i]);
+                rows << int32(damage[i]);
             }
 
             for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
             {
-                stmt.addUInt32(periodicTime[i]);
+                rows << uint32(periodicTime[i]);
             }
 
-            stmt.addInt32(holder->GetAuraMaxDuration());
-            stmt.addInt32(holder->GetAuraDuration());
-            stmt.addUInt32(effIndexMask);
-            stmt.Execute();
+            rows << int32(holder->GetAuraMaxDuration());
+            rows << int32(holder->GetAuraDuration());
+            rows << uint32(effIndexMask);
         }
     }
+
+    // the stored auras are still up to date
+    if (!UpdateSaveSectionHash(m_savedAurasHash, rows))
+    {
+        return;
+    }
+
+    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM `character_aura` WHERE `guid` = ?");
+    stmt.PExecute(GetGUIDLow());
+
+    if (rows.empty())
+    {
+        return;
+    }
+
+    stmt = CharacterDatabase.CreateStatement(insertAuras, "INSERT INTO `character_aura` (`guid`, `caster_guid`, `item_guid`, `spell`, `stackcount`, `remaincharges`, "
+            "`basepoints0`, `basepoints1`, `basepoints2`, `periodictime0`, `periodictime1`, `periodictime2`, `maxduration`, `remaintime`, `effIndexMask`) "
+            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+    while (rows.rpos() < rows.wpos())
+    {
+        stmt.addUInt32(GetGUIDLow());
+        stmt.addUInt64(rows.read<uint64>());                // caster_guid
+        stmt.addUInt32(rows.read<uint32>());                // item_guid
+        stmt.addUInt32(rows.read<uint32>());                // spell
+        stmt.addUInt32(rows.read<uint32>());                // stackcount
+        stmt.addUInt8(rows.read<uint8>());                  // remaincharges
+
+        for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+        {
+            stmt.addInt32(rows.read<int32>());              // basepoints
+        }
+
+        for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+        {
+            stmt.addUInt32(rows.read<uint32>());            // periodictime
+        }
+
+        stmt.addInt32(rows.read<int32>());                  // maxduration
+        stmt.addInt32(rows.read<int32>());                  // remaintime
+        stmt.addUInt32(rows.read<uint32>());                // effIndexMask
+        stmt.Execute();
+    }
 }
 
 void Player::_SaveInventory()
@@ -18849,6 +19084,35 @@ void Player::_SaveStats()
     static SqlStatementID delStats ;
     static SqlStatementID insertStats ;
 
+    ByteBuffer row;
+    row << uint32(GetMaxHealth());
+    for (int i = 0; i < MAX_POWERS; ++i)
+    {
+        row << uint32(GetMaxPower(Powers(i)));
+    }
+    for (int i = 0; i < MAX_STATS; ++i)
+    {
+        row << float(GetStat(Stats(i)));
+    }
+    // armor + school resistances
+    for (int i = 0; i < MAX_SPELL_SCHOOL; ++i)
+    {
+        row << uint32(GetResistance(SpellSchools(i)));
+    }
+    row << float(GetFloatValue(PLAYER_BLOCK_PERCENTAGE));
+    row << float(GetFloatValue(PLAYER_DODGE_PERCENTAGE));
+    row << float(GetFloatValue(PLAYER_PARRY_PERCENTAGE));
+    row << float(GetFloatValue(PLAYER_CRIT_PERCENTAGE));
+    row << float(GetFloatValue(PLAYER_RANGED_CRIT_PERCENTAGE));
+    row << uint32(GetUInt32Value(UNIT_FIELD_ATTACK_POWER));
+    row << uint32(GetUInt32Value(UNIT_FIELD_RANGED_ATTACK_POWER));
+
+    // the stored stats are still up to date
+    if (!UpdateSaveSectionHash(m_savedStatsHash, row))
+    {
+        return;
+    }
+
     SqlStatement stmt = CharacterDatabase.CreateStatement(delStats, "DELETE FROM `character_stats` WHERE `guid` = ?");
     stmt.PExecute(GetGUIDLow());
 
@@ -18858,27 +19122,26 @@ void Player::_SaveStats()
             "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
 
     stmt.addUInt32(GetGUIDLow());
-    stmt.addUInt32(GetMaxHealth());
+    stmt.addUInt32(row.read<uint32>());                     // maxhealth
     for (int i = 0; i < MAX_POWERS; ++i)
     {
-        stmt.addUInt32(GetMaxPower(Powers(i)));
+        stmt.addUInt32(row.read<uint32>());
     }
     for (int i = 0; i < MAX_STATS; ++i)
     {
-        stmt.addFloat(GetStat(Stats(i)));
+        stmt.addFloat(row.read<float>());
     }
     // armor + school resistances
     for (int i = 0; i < MAX_SPELL_SCHOOL; ++i)
     {
-        stmt.addUInt32(GetResistance(SpellSchools(i)));
+        stmt.addUInt32(row.read<uint32>());
+    }
+    for (int i = 0; i < 5; ++i)                             // block, dodge, parry, crit, ranged crit
+    {
+        stmt.addFloat(row.read<float>());
     }
-    stmt.addFloat(GetFloatValue(PLAYER_BLOCK_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_DODGE_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_PARRY_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_CRIT_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_RANGED_CRIT_PERCENTAGE));
-    stmt.addUInt32(GetUInt32Value(UNIT_FIELD_ATTACK_POWER));
-    stmt.addUInt32(GetUInt32Value(UNIT_FIELD_RANGED_ATTACK_POWER));
+    stmt.addUInt32(row.read<uint32>());                     // attack power
+    stmt.addUInt32(row.read<uint32>());                     // ranged attack power
 
     stmt.Execute();
 }
@@ -18964,6 +19227,9 @@ void Player::SendAttackSwingNotInRange()
 
 void Player::SavePositionInDB(ObjectGuid guid, uint32 mapid, float x, float y, float z, float o, uint32 zone)
 {
+    sCharacterLoginCache.Invalidate(guid.GetCounter());
+    sCharEnumCache.InvalidateCharacter(guid.GetCounter());
+
     std::ostringstream ss;
     ss << "UPDATE `characters` SET `position_x`='" << x << "',`position_y`='" << y
        << "',`position_z`='" << z << "',`orientation`='" << o << "',`map`='" << mapid
@@ -20792,7 +21058,7 @@ void Player::UpdateVisibilityOf(WorldObject const* viewPoint, WorldObject* targe
 }
 
 //4 params version (4p)
-void Player::UpdateVisibilityOf(WorldObject const* viewPoint, WorldObject* target, UpdateData& data, std::set<WorldObject*>& visibleNow)
+void Player::UpdateVisibilityOf(WorldObject const* viewPoint, WorldObject* target, UpdateData& data, std::vector<WorldObject*>& visibleNow)
 {
     if (HaveAtClient(target))
     {
@@ -20812,7 +21078,7 @@ void Player::UpdateVisibilityOf(WorldObject const* viewPoint, WorldObject* targe
     {
         if (target->IsVisibleForInState(this, viewPoint, false))
         {
-            visibleNow.insert(target);
+            visibleNow.push_back(target);
             target->BuildCreateUpdateBlockForPlayer(&data, this);
             if (GameObject* g = target->ToGameObject())
             {
@@ -21628,8 +21894,70 @@ bool Player::HasQuestForGO(int32 GOId) const
     return false;
 }
 
+static uint32 QuestGiverStatusKey(Object const* questgiver)
+{
+    return questgiver->GetTypeId() == TYPEID_GAMEOBJECT ? (questgiver->GetEntry() | 0x80000000) : questgiver->GetEntry();
+}
+
+bool Player::GetCachedQuestGiverStatus(Object const* questgiver, uint32& dialogStatus)
+{
+    uint32 generation = sObjectMgr.GetQuestGiverStatusGeneration();
+    if (generation != m_questGiverStatusGeneration)
+    {
+        m_questGiverStatus.clear();
+        m_questGiverStatusGeneration = generation;
+        return false;
+    }
+
+    QuestGiverStatusMap::const_iterator itr = m_questGiverStatus.find(QuestGiverStatusKey(questgiver));
+    if (itr == m_questGiverStatus.end())
+    {
+        return false;
+    }
+
+    dialogStatus = itr->second;
+    return true;
+}
+
+void Player::SetCachedQuestGiverStatus(Object const* questgiver, uint32 dialogStatus)
+{
+    m_questGiverStatus[QuestGiverStatusKey(questgiver)] = uint8(dialogStatus);
+}
+
+bool Player::IsMeetingGossipCondition(uint16 conditionId, WorldObject const* source, bool menuOption)
+{
+    ConditionSource sourceType = menuOption ? CONDITION_FROM_GOSSIP_OPTION : CONDITION_FROM_GOSSIP_MENU;
+
+    if (!sObjectMgr.IsPlayerStateCondition(conditionId))
+    {
+        return sObjectMgr.IsPlayerMeetToCondition(conditionId, this, GetMap(), source, sourceType);
+    }
+
+    uint32 generation = sObjectMgr.GetConditionGeneration();
+    if (generation != m_conditionResultsGeneration)
+    {
+        m_conditionResults.clear();
+        m_conditionResultsGeneration = generation;
+    }
+
+    // player state conditions do not look at the source, so one result serves every menu using the condition
+    ConditionResultMap::const_iterator itr = m_conditionResults.find(conditionId);
+    if (itr != m_conditionResults.end())
+    {
+        return itr->second;
+    }
+
+    bool result = sObjectMgr.IsPlayerMeetToCondition(conditionId, this, GetMap(), source, sourceType);
+    m_conditionResults[conditionId] = result;
+    return result;
+}
+
 void Player::UpdateForQuestWorldObjects()
 {
+    // every quest status change passes here
+    InvalidateQuestGiverStatus();
+    InvalidateConditionResults();
+
     if (m_clientGUIDs.empty())
     {
         return;
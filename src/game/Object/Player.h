@@ -44,6 +44,8 @@
 #include "SharedDefines.h"
 #include "Chat.h"
 #include "GMTicketMgr.h"
+#include "MovementCoalescer.h"
+#include "PlayerUpdateScheduler.h"
 
 #include<vector>
 
@@ -690,7 +692,6 @@ enum PlayerLoginQueryIndex
     PLAYER_LOGIN_QUERY_LOADBGDATA,
     PLAYER_LOGIN_QUERY_LOADSKILLS,
     PLAYER_LOGIN_QUERY_LOADMAILS,
-    PLAYER_LOGIN_QUERY_LOADMAILEDITEMS,
 
     MAX_PLAYER_LOGIN_QUERY
 };
@@ -1170,6 +1171,10 @@ class Player : public Unit
         uint32 GetItemCount(uint32 item, bool inBankAlso = false, Item* skipItem = NULL) const;
         Item* GetItemByGuid(ObjectGuid guid) const;
         Item* GetItemByEntry(uint32 item) const;            // only for special cases
+        // keep the items stored by the player (bags and their contents included) findable by entry, the
+        // entry queries above read the index; call UnindexItem before changing the entry of a stored item
+        void IndexItem(Item* pItem);
+        void UnindexItem(Item* pItem);
         Item* GetItemByPos(uint16 pos) const;
         Item* GetItemByPos(uint8 bag, uint8 slot) const;
         Item* GetWeaponForAttack(WeaponAttackType attackType) const
@@ -1440,6 +1445,17 @@ class Player : public Unit
         void UpdateForQuestWorldObjects();
         bool CanShareQuest(uint32 quest_id) const;
 
+        // quest giver dialog status computed by the core for this player, by giver entry, see WorldSession::getDialogStatus
+        bool GetCachedQuestGiverStatus(Object const* questgiver, uint32& dialogStatus);
+        void SetCachedQuestGiverStatus(Object const* questgiver, uint32 dialogStatus);
+        // quests, level, a quest required skill or reputation of the player changed
+        void InvalidateQuestGiverStatus() { m_questGiverStatus.clear(); }
+
+        // condition check of a gossip menu text or option, results of player state only conditions are kept until that state changes
+        bool IsMeetingGossipCondition(uint16 conditionId, WorldObject const* source, bool menuOption);
+        // quests, level, skills, reputation, spells or honor rank of the player changed
+        void InvalidateConditionResults() { m_conditionResults.clear(); }
+
         void SendQuestCompleteEvent(uint32 quest_id);
         void SendQuestReward(Quest const* pQuest, uint32 XP);
         void SendQuestFailed(uint32 quest_id);
@@ -1591,6 +1607,9 @@ class Player : public Unit
             return mMitems.erase(id) ? true : false;
         }
 
+        // mailed items are not part of the login, they are loaded at first mailbox access
+        void LoadMailedItems();
+
         void PetSpellInitialize();
         void CharmSpellInitialize();
         void PossessSpellInitialize();
@@ -1940,6 +1959,7 @@ class Player : public Unit
 
         void JoinedChannel(Channel* c);
         void LeftChannel(Channel* c);
+        bool IsInChannel(Channel const* c) const;
         void CleanupChannels();
         void UpdateLocalChannels(uint32 newZone);
         void LeaveLFGChannel();
@@ -2008,7 +2028,7 @@ class Player : public Unit
         uint32 CalculateTotalKills(Unit* Victim, uint32 fromDate, uint32 toDate) const;
         // Acessors of honor rank
         HonorRankInfo GetHonorRankInfo() const { return m_honor_rank; }
-        void SetHonorRankInfo(HonorRankInfo rank) { m_honor_rank = rank; }
+        void SetHonorRankInfo(HonorRankInfo rank) { m_honor_rank = rank; InvalidateConditionResults(); }
         // Acessors of total honor points
         void SetRankPoints(float rankPoints) { m_rank_points = rankPoints; }
         float GetRankPoints(void) const { return m_rank_points; }
@@ -2349,13 +2369,16 @@ class Player : public Unit
         bool IsVisibleGloballyFor(Player* pl) const;
 
         void UpdateVisibilityOf(WorldObject const* viewPoint, WorldObject* target);
-        void UpdateVisibilityOf(WorldObject const* viewPoint, WorldObject* target, UpdateData& data, std::set<WorldObject*>& visibleNow);
+        void UpdateVisibilityOf(WorldObject const* viewPoint, WorldObject* target, UpdateData& data, std::vector<WorldObject*>& visibleNow);
 
         // Stealth detection system
         void HandleStealthedUnitsDetection();
 
         Camera& GetCamera() { return m_camera; }
 
+        // movement packets of visible movers relayed to this player, see MovementCoalesce.Window
+        MovementCoalescer& GetMovementCoalescer() { return m_movementCoalescer; }
+
         uint8 m_forced_speed_changes[MAX_MOVE_TYPE];
 
         bool HasAtLoginFlag(AtLoginFlags f) const { return m_atLoginFlags & f; }
@@ -2544,6 +2567,9 @@ class Player : public Unit
         Item* m_items[PLAYER_SLOTS_COUNT];
         uint32 m_currentBuybackSlot;
 
+        typedef UNORDERED_MAP<uint32, std::vector<Item*> > ItemEntryIndex;
+        ItemEntryIndex m_itemsByEntry;                      // stored items by entry, buyback excluded, see IndexItem
+
         std::vector<Item*> m_itemUpdateQueue;
         bool m_itemUpdateQueueBlocked;
 
@@ -2555,11 +2581,20 @@ class Player : public Unit
 
         QuestStatusMap mQuestStatus;
 
+        typedef UNORDERED_MAP<uint32, uint8> QuestGiverStatusMap;
+        QuestGiverStatusMap m_questGiverStatus;             // high bit of the key set for gameobjects
+        uint32 m_questGiverStatusGeneration;                // ObjectMgr::GetQuestGiverStatusGeneration() m_questGiverStatus was built for
+
+        typedef UNORDERED_MAP<uint16, bool> ConditionResultMap;
+        ConditionResultMap m_conditionResults;
+        uint32 m_conditionResultsGeneration;                // ObjectMgr::GetConditionGeneration() m_conditionResults was built for
+
         SkillStatusMap mSkillStatus;
 
         uint32 m_GuildIdInvited;
 
         PlayerMails m_mail;
+        bool m_mailedItemsLoaded;
         PlayerSpellMap m_spells;
         SpellCooldowns m_spellCooldowns;
         /**
@@ -2627,6 +2662,11 @@ class Player : public Unit
         time_t m_resetTalentsTime;
         uint32 m_usedTalentCount;
 
+        // fingerprints of the rows last written by the sections saved as a whole, 0 until first written
+        uint64 m_savedAurasHash;
+        uint64 m_savedSpellCooldownsHash;
+        uint64 m_savedStatsHash;
+
         // Social
         PlayerSocial* m_social;
 
@@ -2635,6 +2675,7 @@ class Player : public Unit
         GroupReference m_originalGroup;
         Group* m_groupInvite;
         uint32 m_groupUpdateMask;
+        uint32 m_groupUpdateTimer;
         uint64 m_auraUpdateMask;
 
         ObjectGuid m_miniPetGuid;
@@ -2682,6 +2723,7 @@ class Player : public Unit
 
         Unit* m_mover;
         Camera m_camera;
+        MovementCoalescer m_movementCoalescer;
 
         GridReference<Player> m_gridRef;
         MapReference m_mapRef;
@@ -2718,7 +2760,7 @@ class Player : public Unit
         bool m_bHasDelayedTeleport;
         bool m_bHasBeenAliveAtDelayedTeleport;
 
-        uint32 m_DetectInvTimer;
+        PlayerUpdateScheduler m_updateScheduler;
 
         // Temporary removed pet cache
         uint32 m_temporaryUnsummonedPetNumber;
@@ -27,67 +27,428 @@
 #include "Database/DatabaseEnv.h"
 #include "World.h"
 #include "Log.h"
+#include "Metrics.h"
 
-PlayerLogger::PlayerLogger(ObjectGuid const & guid) : logActiveMask(0), playerGuid(guid.GetCounter())
+#include <ace/Task.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+#include <cstring>
+#include <deque>
+#include <sstream>
+
+#define PLAYER_LOG_DEFAULT_RECORDS  1024                    // ring size when Initialize gets no length
+#define PLAYER_LOG_INSERT_ROWS      256                     // rows of one multi-row INSERT
+#define PLAYER_LOG_QUEUE_BYTES      (4 * 1024 * 1024)       // writer backlog at which new records are dropped
+
+// packed record sizes, see the structs in PlayerLogger.h
+static uint32 const s_playerLogRecordSize[MAX_PLAYER_LOG_ENTITIES] =
 {
-    for (uint8 i = 0; i < MAX_PLAYER_LOG_ENTITIES; ++i)
+    10,                                                     // PLAYER_LOG_DAMAGE_GET
+    10,                                                     // PLAYER_LOG_DAMAGE_DONE
+    16,                                                     // PLAYER_LOG_LOOTING
+    14,                                                     // PLAYER_LOG_TRADE
+    12,                                                     // PLAYER_LOG_KILL
+    18,                                                     // PLAYER_LOG_POSITION
+    22,                                                     // PLAYER_LOG_PROGRESS
+};
+
+template<typename T>
+static inline void PutField(uint8*& pos, T value)
+{
+    memcpy(pos, &value, sizeof(T));
+    pos += sizeof(T);
+}
+
+template<typename T>
+static inline T GetField(uint8 const*& pos)
+{
+    T value;
+    memcpy(&value, pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+static void WritePosition(uint8*& pos, PlayerLogPosition const& log)
+{
+    PutField(pos, log.timestamp);
+    PutField(pos, log.x);
+    PutField(pos, log.y);
+    PutField(pos, log.z);
+    PutField(pos, log.map);
+}
+
+static void ReadPosition(uint8 const*& pos, PlayerLogPosition& log)
+{
+    log.timestamp = GetField<uint32>(pos);
+    log.x = GetField<float>(pos);
+    log.y = GetField<float>(pos);
+    log.z = GetField<float>(pos);
+    log.map = GetField<uint16>(pos);
+}
+
+PlayerLogRing::PlayerLogRing(uint32 _recordSize, uint32 _capacity) :
+    storage(size_t(_recordSize) * _capacity), recordSize(_recordSize), capacity(_capacity), head(0), count(0)
+{
+}
+
+uint8* PlayerLogRing::Append()
+{
+    MANGOS_ASSERT(count < capacity);
+    uint32 slot = (head + count) % capacity;
+    ++count;
+    return &storage[size_t(slot) * recordSize];
+}
+
+void PlayerLogRing::Truncate(uint32 maxRecords)
+{
+    if (count <= maxRecords)
     {
-        data[i] = NULL;
+        return;
     }
+
+    head = (head + count - maxRecords) % capacity;
+    count = maxRecords;
 }
 
-PlayerLogger::~PlayerLogger()
+void PlayerLogRing::CopyTo(std::vector<uint8>& out) const
 {
-    for (uint8 i = 0; i < MAX_PLAYER_LOG_ENTITIES; ++i)
+    if (!count)
     {
-        if (data[i])
+        return;
+    }
+
+    // at most two runs, the tail of the storage and its start
+    uint32 first = std::min(count, capacity - head);
+    uint8 const* base = &storage[0];
+    out.insert(out.end(), base + size_t(head) * recordSize, base + size_t(head + first) * recordSize);
+    out.insert(out.end(), base, base + size_t(count - first) * recordSize);
+}
+
+/**
+ * Stores shipped log records in the background.
+ *
+ * Loggers hand over the packed records of a ring with Push(), which only
+ * moves the buffer into the queue. The writer thread turns each chunk into
+ * multi-row INSERTs on the async connection, so neither the map threads nor
+ * the async DB queue get one statement per record. When the queued records
+ * exceed PLAYER_LOG_QUEUE_BYTES new chunks are dropped and counted instead
+ * of making the caller wait.
+ */
+class PlayerLogWriter : public ACE_Task_Base
+{
+    public:
+        struct Chunk
         {
-            data[i]->clear();
-            delete data[i];
+            uint32 playerGuid;
+            PlayerLogEntity entity;
+            uint64 timeBase;                                // server start, record timestamps are uptime
+            uint32 count;
+            std::vector<uint8> records;
+        };
+
+        PlayerLogWriter() : m_wakeCondition(m_lock), m_queuedBytes(0), m_stop(false), m_running(false)
+        {
+            memset(&m_stats, 0, sizeof(m_stats));
         }
+
+        // takes the records of chunk, false if they were dropped
+        bool Push(Chunk& chunk);
+        void Stop();
+        void GetStats(PlayerLogWriterStats& stats);
+
+        virtual int svc();
+
+    private:
+        void Write(Chunk const& chunk);
+        static void WriteRow(std::ostringstream& sql, Chunk const& chunk, uint8 const* record);
+
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_wakeCondition;
+        std::deque<Chunk> m_queue;
+        uint32 m_queuedBytes;
+        bool m_stop;
+        bool m_running;
+        PlayerLogWriterStats m_stats;                       // under m_lock
+};
+
+static PlayerLogWriter& GetPlayerLogWriter()
+{
+    static PlayerLogWriter writer;
+    return writer;
+}
+
+bool PlayerLogWriter::Push(Chunk& chunk)
+{
+    static MetricCounter& droppedMetric = sMetrics.GetCounter("mangos_playerlog_records_total", "Player log records by outcome", "state=\"dropped\"");
+    static MetricGauge& queuedMetric = sMetrics.GetGauge("mangos_playerlog_queue_bytes", "Player log record bytes waiting for the writer");
+
+    uint32 bytes = uint32(chunk.records.size());
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+    if (m_queuedBytes + bytes > PLAYER_LOG_QUEUE_BYTES)
+    {
+        m_stats.dropped += chunk.count;
+        droppedMetric.Inc(chunk.count);
+        return false;
     }
+
+    if (!m_running)
+    {
+        m_stop = false;
+        if (activate(THR_NEW_LWP | THR_JOINABLE) == -1)
+        {
+            sLog.outError("PlayerLogger: can't start the writer thread, %u records of player %u dropped", chunk.count, chunk.playerGuid);
+            m_stats.dropped += chunk.count;
+            droppedMetric.Inc(chunk.count);
+            return false;
+        }
+        m_running = true;
+    }
+
+    m_queue.push_back(Chunk());
+    Chunk& queued = m_queue.back();
+    queued.playerGuid = chunk.playerGuid;
+    queued.entity = chunk.entity;
+    queued.timeBase = chunk.timeBase;
+    queued.count = chunk.count;
+    queued.records.swap(chunk.records);
+
+    m_queuedBytes += bytes;
+    m_stats.queued += chunk.count;
+    if (m_queuedBytes > m_stats.peakBytes)
+    {
+        m_stats.peakBytes = m_queuedBytes;
+    }
+    queuedMetric.Set(m_queuedBytes);
+
+    m_wakeCondition.signal();
+    return true;
 }
 
-void PlayerLogger::Initialize(PlayerLogEntity entity, uint32 maxLength)
+void PlayerLogWriter::Stop()
 {
-    if (data[entity])
     {
-        data[entity]->clear();
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        if (!m_running)
+        {
+            return;
+        }
+
+        m_stop = true;
+        m_wakeCondition.signal();
     }
-    else
+
+    wait();
+
+    PlayerLogWriterStats stats;
+    GetStats(stats);
+    sLog.outString("PlayerLogger: writer stopped, " UI64FMTD " records stored in " UI64FMTD " statements, " UI64FMTD " dropped, " UI64FMTD " failed, queue peak %u bytes",
+        stats.written, stats.statements, stats.dropped, stats.failed, stats.peakBytes);
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+    m_running = false;
+}
+
+void PlayerLogWriter::GetStats(PlayerLogWriterStats& stats)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+    stats = m_stats;
+    stats.queuedBytes = m_queuedBytes;
+}
+
+int PlayerLogWriter::svc()
+{
+    static MetricGauge& queuedMetric = sMetrics.GetGauge("mangos_playerlog_queue_bytes", "Player log record bytes waiting for the writer");
+
+    std::deque<Chunk> work;
+    for (;;)
+    {
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, -1);
+            while (m_queue.empty() && !m_stop)
+            {
+                m_wakeCondition.wait();
+            }
+
+            // stop only once everything queued before it is written
+            if (m_queue.empty())
+            {
+                break;
+            }
+
+            work.swap(m_queue);
+            m_queuedBytes = 0;
+            queuedMetric.Set(0);
+        }
+
+        for (std::deque<Chunk>::const_iterator itr = work.begin(); itr != work.end(); ++itr)
+        {
+            Write(*itr);
+        }
+        work.clear();
+    }
+
+    return 0;
+}
+
+void PlayerLogWriter::Write(Chunk const& chunk)
+{
+    static MetricCounter& writtenMetric = sMetrics.GetCounter("mangos_playerlog_records_total", "Player log records by outcome", "state=\"written\"");
+    static MetricCounter& failedMetric = sMetrics.GetCounter("mangos_playerlog_records_total", "Player log records by outcome", "state=\"failed\"");
+
+    static char const* const s_insertHead[MAX_PLAYER_LOG_ENTITIES] =
     {
-        if (IsLoggingActive(entity))
-            sLog.outDebug("PlayerLogger: no data but activity flag set for log type %u!", entity);
-        switch (entity)
+        "INSERT INTO `playerlog_damage_get` (`guid`, `time`, `aggressor`, `isPlayer`, `damage`, `spell`) VALUES ",
+        "INSERT INTO `playerlog_damage_done` (`guid`, `time`, `victim`, `isPlayer`, `damage`, `spell`) VALUES ",
+        "INSERT INTO `playerlog_looting` (`guid`, `time`, `item`, `sourceType`, `sourceEntry`) VALUES ",
+        "INSERT INTO `playerlog_trading` (`guid`, `time`, `itemEntry`, `itemGuid`, `aquired`, `partner`) VALUES ",
+        "INSERT INTO `playerlog_killing` (`guid`, `time`, `iskill`, `entry`, `victimGuid`) VALUES ",
+        "INSERT INTO `playerlog_position` (`guid`, `time`, `map`, `posx`, `posy`, `posz`) VALUES ",
+        "INSERT INTO `playerlog_progress` (`guid`, `time`, `type`, `level`, `data`, `map`, `posx`, `posy`, `posz`) VALUES ",
+    };
+
+    uint32 recordSize = s_playerLogRecordSize[chunk.entity];
+    uint8 const* record = chunk.records.empty() ? NULL : &chunk.records[0];
+
+    for (uint32 first = 0; first < chunk.count; first += PLAYER_LOG_INSERT_ROWS)
+    {
+        uint32 rows = std::min(chunk.count - first, uint32(PLAYER_LOG_INSERT_ROWS));
+
+        std::ostringstream sql;
+        sql.precision(9);                                   // enough to restore any float position
+        sql << s_insertHead[chunk.entity];
+        for (uint32 i = 0; i < rows; ++i, record += recordSize)
         {
+            if (i)
+            {
+                sql << ", ";
+            }
+            WriteRow(sql, chunk, record);
+        }
+
+        bool result = CharacterDatabase.DirectExecute(sql.str().c_str());
+
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        ++m_stats.statements;
+        if (result)
+        {
+            m_stats.written += rows;
+            writtenMetric.Inc(rows);
+        }
+        else
+        {
+            m_stats.failed += rows;
+            failedMetric.Inc(rows);
+        }
+    }
+}
+
+void PlayerLogWriter::WriteRow(std::ostringstream& sql, Chunk const& chunk, uint8 const* record)
+{
+    sql << '(' << chunk.playerGuid << ", ";
+
+    switch (chunk.entity)
+    {
         case PLAYER_LOG_DAMAGE_GET:
         case PLAYER_LOG_DAMAGE_DONE:
-            data[entity] = (PlayerLogBaseType*)(new std::vector<PlayerLogDamage>);
+        {
+            PlayerLogDamage info(GetField<uint32>(record));
+            info.dmgUnit = GetField<uint16>(record);
+            info.damage = GetField<int16>(record);
+            info.spell = GetField<uint16>(record);
+            sql << (info.timestamp + chunk.timeBase) << ", " << info.GetId() << ", " << uint32(info.IsPlayer()) << ", " << info.damage << ", " << info.spell;
             break;
+        }
         case PLAYER_LOG_LOOTING:
-            data[entity] = (PlayerLogBaseType*)(new std::vector<PlayerLogLooting>);
+        {
+            PlayerLogLooting info(GetField<uint32>(record));
+            info.droppedBy = GetField<uint32>(record);
+            info.itemGuid = GetField<uint32>(record);
+            info.itemEntry = GetField<uint32>(record);
+            sql << (info.timestamp + chunk.timeBase) << ", " << info.GetItemEntry() << ", " << uint32(info.GetLootSourceType()) << ", " << info.droppedBy;
             break;
+        }
         case PLAYER_LOG_TRADE:
-            data[entity] = (PlayerLogBaseType*)(new std::vector<PlayerLogTrading>);
+        {
+            PlayerLogTrading info(GetField<uint32>(record));
+            info.itemGuid = GetField<uint32>(record);
+            info.itemEntry = GetField<uint32>(record);
+            info.partner = GetField<uint16>(record);
+            sql << (info.timestamp + chunk.timeBase) << ", " << info.GetItemEntry() << ", " << info.itemGuid << ", " << uint32(info.IsItemAquired()) << ", " << info.partner;
             break;
+        }
         case PLAYER_LOG_KILL:
-            data[entity] = (PlayerLogBaseType*)(new std::vector<PlayerLogKilling>);
+        {
+            PlayerLogKilling info(GetField<uint32>(record));
+            info.unitGuid = GetField<uint32>(record);
+            info.unitEntry = GetField<uint32>(record);
+            sql << (info.timestamp + chunk.timeBase) << ", " << uint32(info.IsKill()) << ", " << info.GetUnitEntry() << ", " << info.unitGuid;
             break;
+        }
         case PLAYER_LOG_POSITION:
-            data[entity] = (PlayerLogBaseType*)(new std::vector<PlayerLogPosition>);
+        {
+            PlayerLogPosition info(0);
+            ReadPosition(record, info);
+            sql << (info.timestamp + chunk.timeBase) << ", " << info.map << ", " << info.x << ", " << info.y << ", " << info.z;
             break;
+        }
         case PLAYER_LOG_PROGRESS:
-            data[entity] = (PlayerLogBaseType*)(new std::vector<PlayerLogProgress>);
-            break;
-        default:
-            sLog.outError("PlayerLogger: unknown logging type %u initiated, ignoring.", entity);
+        {
+            PlayerLogProgress info(0);
+            ReadPosition(record, info);
+            info.progressType = GetField<uint8>(record);
+            info.level = GetField<uint8>(record);
+            info.data = GetField<uint16>(record);
+            sql << (info.timestamp + chunk.timeBase) << ", " << uint32(info.progressType) << ", " << uint32(info.level) << ", " << info.data << ", "
+                << info.map << ", " << info.x << ", " << info.y << ", " << info.z;
             break;
         }
     }
-    if (maxLength)
+
+    sql << ')';
+}
+
+PlayerLogger::PlayerLogger(ObjectGuid const & guid) : logActiveMask(0), playerGuid(guid.GetCounter())
+{
+    for (uint8 i = 0; i < MAX_PLAYER_LOG_ENTITIES; ++i)
+    {
+        data[i] = NULL;
+    }
+}
+
+PlayerLogger::~PlayerLogger()
+{
+    for (uint8 i = 0; i < MAX_PLAYER_LOG_ENTITIES; ++i)
+    {
+        delete data[i];
+    }
+}
+
+void PlayerLogger::Initialize(PlayerLogEntity entity, uint32 maxLength)
+{
+    if (entity >= MAX_PLAYER_LOG_ENTITIES)
+    {
+        sLog.outError("PlayerLogger: unknown logging type %u initiated, ignoring.", entity);
+        return;
+    }
+
+    if (data[entity])
+    {
+        if (!maxLength || maxLength == data[entity]->GetCapacity())
+        {
+            data[entity]->Clear();
+            return;
+        }
+        delete data[entity];
+    }
+    else if (IsLoggingActive(entity))
     {
-        data[entity]->reserve(maxLength);
+        sLog.outDebug("PlayerLogger: no data but activity flag set for log type %u!", entity);
     }
+
+    data[entity] = new PlayerLogRing(s_playerLogRecordSize[entity], maxLength ? maxLength : PLAYER_LOG_DEFAULT_RECORDS);
 }
 
 void PlayerLogger::Clean(PlayerLogMask mask)
@@ -104,14 +465,13 @@ void PlayerLogger::Clean(PlayerLogMask mask)
             continue;
         }
         SetLogActiveMask(PlayerLogEntity(i), false);
-        data[i]->clear();
+        data[i]->Clear();
     }
 }
 
-bool PlayerLogger::SaveToDB(PlayerLogMask mask, bool removeSaved, bool insideTransaction)
+bool PlayerLogger::SaveToDB(PlayerLogMask mask, bool removeSaved)
 {
     bool written = false;
-    uint64 serverStart = uint64(sWorld.GetStartTime());
     for (uint8 i = 0; i < MAX_PLAYER_LOG_ENTITIES; ++i)
     {
         if ((mask & CalcLogMask(PlayerLogEntity(i))) == 0 || data[i] == NULL)
@@ -119,127 +479,59 @@ bool PlayerLogger::SaveToDB(PlayerLogMask mask, bool removeSaved, bool insideTra
             continue;
         }
 
-        if (!insideTransaction)
+        if (Ship(PlayerLogEntity(i), removeSaved))
         {
-            CharacterDatabase.BeginTransaction();
-        }
-        written = true;
-        for (uint8 id = 0; id < data[i]->size(); ++id)
-        {
-            switch (PlayerLogEntity(i))
-            {
-            case PLAYER_LOG_DAMAGE_GET:
-                {
-                PlayerLogDamage info = *(PlayerLogDamage*)(&data[i]->at(id));
-                static SqlStatementID dmgGetStmt;
-                SqlStatement stmt = CharacterDatabase.CreateStatement(dmgGetStmt, "INSERT INTO `playerlog_damage_get` SET `guid` = ?, `time` = ?, `aggressor` = ?, `isPlayer` = ?, `damage` = ?, `spell` = ?");
-                stmt.addUInt32(playerGuid);
-                stmt.addUInt64(info.timestamp + serverStart);
-                stmt.addUInt32(info.GetId());
-                stmt.addBool(info.IsPlayer());
-                stmt.addInt32(info.damage);
-                stmt.addUInt16(info.spell);
-                stmt.Execute();
-                }
-                break;
-            case PLAYER_LOG_DAMAGE_DONE:
-                {
-                PlayerLogDamage info = *(PlayerLogDamage*)(&data[i]->at(id));
-                static SqlStatementID dmgDoneStmt;
-                SqlStatement stmt = CharacterDatabase.CreateStatement(dmgDoneStmt, "INSERT INTO `playerlog_damage_done` SET `guid` = ?, `time` = ?, `victim` = ?, `isPlayer` = ?, `damage` = ?, `spell` = ?");
-                stmt.addUInt32(playerGuid);
-                stmt.addUInt64(info.timestamp + serverStart);
-                stmt.addUInt32(info.GetId());
-                stmt.addBool(info.IsPlayer());
-                stmt.addInt32(info.damage);
-                stmt.addUInt16(info.spell);
-                stmt.Execute();
-                }
-                break;
-            case PLAYER_LOG_LOOTING:
-                {
-                PlayerLogLooting info = *(PlayerLogLooting*)(&data[i]->at(id));
-                static SqlStatementID lootStmt;
-                SqlStatement stmt = CharacterDatabase.CreateStatement(lootStmt, "INSERT INTO `playerlog_looting` SET `guid` = ?, `time`= ?, `item` = ?, `sourceType` = ?, `sourceEntry` = ?");
-                stmt.addUInt32(playerGuid);
-                stmt.addUInt64(info.timestamp + serverStart);
-                stmt.addUInt32(info.GetItemEntry());
-                stmt.addUInt8(uint8(info.GetLootSourceType()));
-                stmt.addUInt32(info.droppedBy);
-                stmt.Execute();
-                }
-                break;
-            case PLAYER_LOG_TRADE:
-                {
-                PlayerLogTrading info = *(PlayerLogTrading*)(&data[i]->at(id));
-                static SqlStatementID tradeStmt;
-                SqlStatement stmt = CharacterDatabase.CreateStatement(tradeStmt, "INSERT INTO `playerlog_trading` SET `guid` = ?, `time`= ?, `itemEntry` = ?, `itemGuid` = ?, `aquired` = ?, `partner` = ?");
-                stmt.addUInt32(playerGuid);
-                stmt.addUInt64(info.timestamp + serverStart);
-                stmt.addUInt32(info.GetItemEntry());
-                stmt.addUInt32(info.itemGuid);
-                stmt.addBool(info.IsItemAquired());
-                stmt.addUInt16(info.partner);
-                stmt.Execute();
-                }
-                break;
-            case PLAYER_LOG_KILL:
-                {
-                PlayerLogKilling info = *(PlayerLogKilling*)(&data[i]->at(id));
-                static SqlStatementID killStmt;
-                SqlStatement stmt = CharacterDatabase.CreateStatement(killStmt, "INSERT INTO `playerlog_killing` SET `guid` = ?, `time`= ?, `iskill` = ?, `entry` = ?, `victimGuid` = ?");
-                stmt.addUInt32(playerGuid);
-                stmt.addUInt64(info.timestamp + serverStart);
-                stmt.addBool(info.IsKill());
-                stmt.addUInt32(info.GetUnitEntry());
-                stmt.addUInt32(info.unitGuid);
-                stmt.Execute();
-                }
-                break;
-            case PLAYER_LOG_POSITION:
-                {
-                PlayerLogPosition info = *(PlayerLogPosition*)(&data[i]->at(id));
-                static SqlStatementID posStmt;
-                SqlStatement stmt = CharacterDatabase.CreateStatement(posStmt, "INSERT INTO `playerlog_position` SET `guid` = ?, `time`= ?, `map` = ?, `posx` = ?, `posy` = ?, `posz` = ?");
-                stmt.addUInt32(playerGuid);
-                stmt.addUInt64(info.timestamp + serverStart);
-                stmt.addUInt16(info.map);
-                stmt.addFloat(info.x);
-                stmt.addFloat(info.y);
-                stmt.addFloat(info.z);
-                stmt.Execute();
-                }
-                break;
-            case PLAYER_LOG_PROGRESS:
-                {
-                PlayerLogProgress info = *(PlayerLogProgress*)(&data[i]->at(id));
-                static SqlStatementID progStmt;
-                SqlStatement stmt = CharacterDatabase.CreateStatement(progStmt, "INSERT INTO `playerlog_progress` SET `guid` = ?, `time` = ?, `type` = ?, `level` = ?, `data` = ?, `map` = ?, `posx` = ?, `posy` = ?, `posz` = ?");
-                stmt.addUInt32(playerGuid);
-                stmt.addUInt64(info.timestamp + serverStart);
-                stmt.addUInt8(info.progressType);
-                stmt.addUInt8(info.level);
-                stmt.addUInt16(info.data);
-                stmt.addUInt16(info.map);
-                stmt.addFloat(info.x);
-                stmt.addFloat(info.y);
-                stmt.addFloat(info.z);
-                stmt.Execute();
-                }
-            }
+            written = true;
         }
         Stop(PlayerLogEntity(i));
-        if (removeSaved)
-        {
-            data[i]->clear();
-        }
     }
-    if (written && !insideTransaction)
+
+    return written;
+}
+
+bool PlayerLogger::Ship(PlayerLogEntity entity, bool removeShipped)
+{
+    PlayerLogRing* ring = data[entity];
+    if (!ring->Size())
     {
-        CharacterDatabase.CommitTransaction();
+        return false;
     }
 
-    return written;
+    PlayerLogWriter::Chunk chunk;
+    chunk.playerGuid = playerGuid;
+    chunk.entity = entity;
+    chunk.timeBase = uint64(sWorld.GetStartTime());
+    chunk.count = ring->Size();
+    chunk.records.reserve(size_t(chunk.count) * s_playerLogRecordSize[entity]);
+    ring->CopyTo(chunk.records);
+
+    if (removeShipped)
+    {
+        ring->Clear();
+    }
+
+    return GetPlayerLogWriter().Push(chunk);
+}
+
+uint8* PlayerLogger::AppendRecord(PlayerLogEntity entity)
+{
+    PlayerLogRing* ring = data[entity];
+    if (ring->IsFull())
+    {
+        Ship(entity, true);
+    }
+
+    return ring->Append();
+}
+
+void PlayerLogger::StopWriter()
+{
+    GetPlayerLogWriter().Stop();
+}
+
+void PlayerLogger::GetWriterStats(PlayerLogWriterStats& stats)
+{
+    GetPlayerLogWriter().GetStats(stats);
 }
 
 void PlayerLogger::StartCombatLogging()
@@ -257,9 +549,9 @@ void PlayerLogger::StartLogging(PlayerLogEntity entity)
     }
     else
     {
-        if (data[entity]->size() > 0)
+        if (data[entity]->Size() > 0)
             sLog.outDebug("PlayerLogger: dropped old data for type %u player GUID %u!", entity, playerGuid);
-        data[entity]->clear();
+        data[entity]->Clear();
     }
 
     SetLogActiveMask(entity, true);
@@ -268,67 +560,19 @@ void PlayerLogger::StartLogging(PlayerLogEntity entity)
 uint32 PlayerLogger::Stop(PlayerLogEntity entity)
 {
     SetLogActiveMask(entity, false);
-    sLog.outDebug("PlayerLogger: logging type %u stopped for player %u at %lu records.", entity, playerGuid, data[entity]->size());
-    return data[entity]->size();
+    sLog.outDebug("PlayerLogger: logging type %u stopped for player %u at %u records.", entity, playerGuid, data[entity]->Size());
+    return data[entity]->Size();
 }
 
 void PlayerLogger::CheckAndTruncate(PlayerLogMask mask, uint32 maxRecords)
 {
     for (uint8 i = 0; i < MAX_PLAYER_LOG_ENTITIES; ++i)
     {
-        if ((mask & CalcLogMask(PlayerLogEntity(i))) == 0)
+        if ((mask & CalcLogMask(PlayerLogEntity(i))) == 0 || data[i] == NULL)
         {
             continue;
         }
-        if (data[i]->size() > maxRecords)
-        {
-            switch (PlayerLogEntity(i))
-            {
-            case PLAYER_LOG_DAMAGE_GET:
-            case PLAYER_LOG_DAMAGE_DONE:
-                {
-                std::vector<PlayerLogDamage>* v = (std::vector<PlayerLogDamage>*)data[i];
-                std::vector<PlayerLogDamage>::iterator itr = v->begin();
-                v->erase(itr, itr + v->size() - maxRecords);
-                }
-                break;
-            case PLAYER_LOG_LOOTING:
-                {
-                std::vector<PlayerLogLooting>* v = (std::vector<PlayerLogLooting>*)data[i];
-                std::vector<PlayerLogLooting>::iterator itr = v->begin();
-                v->erase(itr, itr + v->size() - maxRecords);
-                }
-                break;
-            case PLAYER_LOG_TRADE:
-                {
-                std::vector<PlayerLogTrading>* v = (std::vector<PlayerLogTrading>*)data[i];
-                std::vector<PlayerLogTrading>::iterator itr = v->begin();
-                v->erase(itr, itr + v->size() - maxRecords);
-                }
-                break;
-            case PLAYER_LOG_KILL:
-                {
-                std::vector<PlayerLogKilling>* v = (std::vector<PlayerLogKilling>*)data[i];
-                std::vector<PlayerLogKilling>::iterator itr = v->begin();
-                v->erase(itr, itr + v->size() - maxRecords);
-                }
-                break;
-            case PLAYER_LOG_POSITION:
-                {
-                std::vector<PlayerLogPosition>* v = (std::vector<PlayerLogPosition>*)data[i];
-                std::vector<PlayerLogPosition>::iterator itr = v->begin();
-                v->erase(itr, itr + v->size() - maxRecords);
-                }
-                break;
-            case PLAYER_LOG_PROGRESS:
-                {
-                std::vector<PlayerLogProgress>* v = (std::vector<PlayerLogProgress>*)data[i];
-                std::vector<PlayerLogProgress>::iterator itr = v->begin();
-                v->erase(itr, itr + v->size() - maxRecords);
-                }
-                break;
-            }
-        }
+        data[i]->Truncate(maxRecords);
     }
 }
 
@@ -343,7 +587,12 @@ void PlayerLogger::LogDamage(bool done, uint16 damage, uint16 heal, ObjectGuid c
     log.SetCreature(unitGuid.IsCreatureOrPet());
     log.damage = damage > 0 ? int16(damage) : -int16(heal);
     log.spell = spell;
-    ((std::vector<PlayerLogDamage>*)(data[done ? PLAYER_LOG_DAMAGE_DONE : PLAYER_LOG_DAMAGE_GET]))->push_back(log);
+
+    uint8* pos = AppendRecord(done ? PLAYER_LOG_DAMAGE_DONE : PLAYER_LOG_DAMAGE_GET);
+    PutField(pos, log.timestamp);
+    PutField(pos, log.dmgUnit);
+    PutField(pos, log.damage);
+    PutField(pos, log.spell);
 }
 
 void PlayerLogger::LogLooting(LootSourceType type, ObjectGuid const & droppedBy, ObjectGuid const & itemGuid, uint32 id)
@@ -357,7 +606,12 @@ void PlayerLogger::LogLooting(LootSourceType type, ObjectGuid const & droppedBy,
     log.SetLootSourceType(type);
     log.itemGuid = itemGuid.GetCounter();
     log.droppedBy = droppedBy.IsEmpty() ? id : droppedBy.GetEntry();
-    ((std::vector<PlayerLogLooting>*)(data[PLAYER_LOG_LOOTING]))->push_back(log);
+
+    uint8* pos = AppendRecord(PLAYER_LOG_LOOTING);
+    PutField(pos, log.timestamp);
+    PutField(pos, log.droppedBy);
+    PutField(pos, log.itemGuid);
+    PutField(pos, log.itemEntry);
 }
 
 void PlayerLogger::LogTrading(bool aquire, ObjectGuid const & partner, ObjectGuid const & itemGuid)
@@ -371,7 +625,12 @@ void PlayerLogger::LogTrading(bool aquire, ObjectGuid const & partner, ObjectGui
     log.SetItemAquired(aquire);
     log.itemGuid = itemGuid.GetCounter();
     log.partner = partner.GetCounter();
-    ((std::vector<PlayerLogTrading>*)(data[PLAYER_LOG_TRADE]))->push_back(log);
+
+    uint8* pos = AppendRecord(PLAYER_LOG_TRADE);
+    PutField(pos, log.timestamp);
+    PutField(pos, log.itemGuid);
+    PutField(pos, log.itemEntry);
+    PutField(pos, log.partner);
 }
 
 void PlayerLogger::LogKilling(bool killedEnemy, ObjectGuid const & unitGuid)
@@ -384,7 +643,11 @@ void PlayerLogger::LogKilling(bool killedEnemy, ObjectGuid const & unitGuid)
     log.unitEntry = unitGuid.GetEntry();
     log.SetKill(killedEnemy);
     log.unitGuid = unitGuid.GetCounter();
-    ((std::vector<PlayerLogKilling>*)(data[PLAYER_LOG_KILL]))->push_back(log);
+
+    uint8* pos = AppendRecord(PLAYER_LOG_KILL);
+    PutField(pos, log.timestamp);
+    PutField(pos, log.unitGuid);
+    PutField(pos, log.unitEntry);
 }
 
 void PlayerLogger::LogPosition()
@@ -397,7 +660,9 @@ void PlayerLogger::LogPosition()
     {
         PlayerLogPosition log = PlayerLogPosition(sWorld.GetUptime());
         FillPosition(&log, pl);
-        ((std::vector<PlayerLogPosition>*)(data[PLAYER_LOG_POSITION]))->push_back(log);
+
+        uint8* pos = AppendRecord(PLAYER_LOG_POSITION);
+        WritePosition(pos, log);
     }
 }
 
@@ -414,7 +679,12 @@ void PlayerLogger::LogProgress(ProgressType type, uint8 achieve, uint16 misc)
         log.level = achieve;
         log.data = misc;
         FillPosition(&log, pl);
-        ((std::vector<PlayerLogProgress>*)(data[PLAYER_LOG_PROGRESS]))->push_back(log);
+
+        uint8* pos = AppendRecord(PLAYER_LOG_PROGRESS);
+        WritePosition(pos, log);
+        PutField(pos, log.progressType);
+        PutField(pos, log.level);
+        PutField(pos, log.data);
     }
 }
 
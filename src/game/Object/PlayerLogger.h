@@ -69,7 +69,6 @@ struct PlayerLogBase
 
     PlayerLogBase(uint32 _time) : timestamp(_time) {}
 };
-typedef std::vector<PlayerLogBase> PlayerLogBaseType;
 
 struct PlayerLogDamage : public PlayerLogBase       // 10 bytes
 {
@@ -150,6 +149,50 @@ struct PlayerLogProgress : public PlayerLogPosition // 18+4=22 bytes
     PlayerLogProgress(uint32 _time) : PlayerLogPosition(_time) {}
 };
 
+/**
+ * Packed records of one log entity in a fixed size ring, oldest first.
+ *
+ * Records are stored without padding in the sizes noted at the structs
+ * above, the ring never reallocates once created.
+ */
+class PlayerLogRing
+{
+public:
+    PlayerLogRing(uint32 recordSize, uint32 capacity);
+
+    // slot for the next record, the caller must ship a full ring first
+    uint8* Append();
+
+    // drop the oldest records so that at most maxRecords remain
+    void Truncate(uint32 maxRecords);
+
+    void Clear() { head = 0; count = 0; }
+    bool IsFull() const { return count == capacity; }
+    uint32 Size() const { return count; }
+    uint32 GetCapacity() const { return capacity; }
+
+    // append the records, oldest first, to out
+    void CopyTo(std::vector<uint8>& out) const;
+
+private:
+    std::vector<uint8> storage;
+    uint32 recordSize;
+    uint32 capacity;
+    uint32 head;
+    uint32 count;
+};
+
+struct PlayerLogWriterStats
+{
+    uint64 queued;          // records handed to the writer
+    uint64 written;         // records stored in the DB
+    uint64 dropped;         // records dropped because the writer queue was full
+    uint64 failed;          // records of failed statements
+    uint64 statements;      // multi-row INSERTs executed
+    uint32 queuedBytes;     // record bytes currently waiting for the writer
+    uint32 peakBytes;       // highest queuedBytes seen
+};
+
 class PlayerLogger
 {
 public:
@@ -168,8 +211,8 @@ public:
     // remove entries of type PlayerLogEntity
     void Clean(PlayerLogMask);
 
-    // save to DB entries
-    bool SaveToDB(PlayerLogMask, bool removeSaved = true, bool insideTransaction = false);
+    // hand the entries to the background writer and stop logging them, false if nothing was queued
+    bool SaveToDB(PlayerLogMask, bool removeSaved = true);
 
     // start logging for PLAYER_LOG_DAMAGE
     void StartCombatLogging();
@@ -191,14 +234,23 @@ public:
     void LogPosition();
     void LogProgress(ProgressType type, uint8 achieve, uint16 misc = 0);
 
+    // background writer shared by all loggers, stopped at shutdown after everything queued is stored
+    static void StopWriter();
+    static void GetWriterStats(PlayerLogWriterStats& stats);
+
 private:
     inline void SetLogActiveMask(PlayerLogEntity entity, bool on);
     Player* GetPlayer() const;
     void FillPosition(PlayerLogPosition* log, Player* me);
 
+    // slot for a new record of entity, a full ring is shipped to the writer first
+    uint8* AppendRecord(PlayerLogEntity entity);
+    // queue the records of entity for the writer, false if there were none or they were dropped
+    bool Ship(PlayerLogEntity entity, bool removeShipped);
+
     uint32 playerGuid;
 
-    std::vector<PlayerLogBase>* data[MAX_PLAYER_LOG_ENTITIES];
+    PlayerLogRing* data[MAX_PLAYER_LOG_ENTITIES];
     uint8 logActiveMask;
 };
 
@@ -0,0 +1,72 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "PlayerUpdateScheduler.h"
+
+static uint32 const s_playerUpdateTaskInterval[MAX_PLAYER_UPDATE_TASKS] =
+{
+    500,                                                    // PLAYER_UPDATE_TASK_PVP_FLAGS
+    250,                                                    // PLAYER_UPDATE_TASK_DUEL
+    1000,                                                   // PLAYER_UPDATE_TASK_DURATIONS
+    1000,                                                   // PLAYER_UPDATE_TASK_REST
+    3000,                                                   // PLAYER_UPDATE_TASK_STEALTH_DETECT
+};
+
+uint32 PlayerUpdateScheduler::GetInterval(PlayerUpdateTask task)
+{
+    return s_playerUpdateTaskInterval[task];
+}
+
+void PlayerUpdateScheduler::Initialize(uint32 seed)
+{
+    for (int i = 0; i < MAX_PLAYER_UPDATE_TASKS; ++i)
+    {
+        // multiplicative hash, consecutive guids land far apart in the interval
+        uint32 offset = (seed * 2654435761u + uint32(i) * 40503u) % s_playerUpdateTaskInterval[i];
+
+        m_wait[i] = offset + 1;
+        m_elapsed[i] = 0;
+    }
+}
+
+bool PlayerUpdateScheduler::Update(PlayerUpdateTask task, uint32 diff, uint32& elapsed)
+{
+    m_elapsed[task] += diff;
+
+    if (m_wait[task] > diff)
+    {
+        m_wait[task] -= diff;
+        return false;
+    }
+
+    // keep the phase, a late run does not push the next one back
+    uint32 late = diff - m_wait[task];
+    uint32 interval = s_playerUpdateTaskInterval[task];
+    m_wait[task] = late < interval ? interval - late : 1;
+
+    elapsed = m_elapsed[task];
+    m_elapsed[task] = 0;
+    return true;
+}
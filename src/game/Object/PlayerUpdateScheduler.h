@@ -0,0 +1,67 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_H_PLAYER_UPDATE_SCHEDULER
+#define MANGOS_H_PLAYER_UPDATE_SCHEDULER
+
+#include "Common.h"
+
+// periodic checks of Player::Update that do not need to run every tick
+enum PlayerUpdateTask
+{
+    PLAYER_UPDATE_TASK_PVP_FLAGS        = 0,                // pvp flag timeout, contested pvp
+    PLAYER_UPDATE_TASK_DUEL             = 1,                // duel countdown and arbiter distance
+    PLAYER_UPDATE_TASK_DURATIONS        = 2,                // item and enchant durations, homebind timer, played time
+    PLAYER_UPDATE_TASK_REST             = 3,                // rest bonus while resting
+    PLAYER_UPDATE_TASK_STEALTH_DETECT   = 4,                // detection of nearby stealthed units
+    MAX_PLAYER_UPDATE_TASKS
+};
+
+/**
+ * Runs each PlayerUpdateTask once per its interval instead of every tick.
+ *
+ * The first run of a task is offset by a per player seed (the guid), so
+ * players entering the world together do not run the same task in the
+ * same tick and only a slice of them pays for a task in any one tick.
+ * A task that is due gets the real time since its previous run.
+ */
+class PlayerUpdateScheduler
+{
+    public:
+        PlayerUpdateScheduler() { Initialize(0); }
+
+        void Initialize(uint32 seed);
+
+        // true when task is due, elapsed is then set to the time (in milliseconds) since its previous run
+        bool Update(PlayerUpdateTask task, uint32 diff, uint32& elapsed);
+
+        static uint32 GetInterval(PlayerUpdateTask task);
+
+    private:
+        uint32 m_wait[MAX_PLAYER_UPDATE_TASKS];             // time left until the task is due
+        uint32 m_elapsed[MAX_PLAYER_UPDATE_TASKS];          // time since the previous run
+};
+
+#endif
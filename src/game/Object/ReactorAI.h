@@ -42,6 +42,7 @@ class ReactorAI : public CreatureAI
         bool IsVisible(Unit*) const override;
 
         void UpdateAI(const uint32) override;
+        bool CanSleep() const override { return true; }
         static int Permissible(const Creature*);
 
     private:
@@ -143,33 +143,40 @@ void ReputationMgr::SendForceReactions()
     m_player->SendDirectMessage(&data);
 }
 
-void ReputationMgr::SendState(FactionState const* faction)
+void ReputationMgr::SendPendingStates()
 {
-    uint32 count = 1;
+    if (!m_statesPending)
+    {
+        return;
+    }
+
+    m_statesPending = false;
+
+    uint32 count = 0;
 
     WorldPacket data(SMSG_SET_FACTION_STANDING, (16));      // last check 2.4.0
     size_t p_count = data.wpos();
     data << (uint32) count;                                 // placeholder
 
-    data << (uint32) faction->ReputationListID;
-    data << (uint32) faction->Standing;
-
     for (FactionStateList::iterator itr = m_factions.begin(); itr != m_factions.end(); ++itr)
     {
         FactionState &subFaction = itr->second;
         if (subFaction.needSend)
         {
             subFaction.needSend = false;
-            if (subFaction.ReputationListID != faction->ReputationListID)
-            {
-                data << uint32(subFaction.ReputationListID);
-                data << uint32(subFaction.Standing);
 
-                ++count;
-            }
+            data << uint32(subFaction.ReputationListID);
+            data << uint32(subFaction.Standing);
+
+            ++count;
         }
     }
 
+    if (!count)
+    {
+        return;
+    }
+
     data.put<uint32>(p_count, count);
     m_player->SendDirectMessage(&data);
 }
@@ -261,29 +268,23 @@ bool ReputationMgr::SetReputation(FactionEntry const* factionEntry, int32 standi
 
     bool res = false;
     // if spillover definition exists in DB, override DBC
-    if (const RepSpilloverTemplate* repTemplate = sObjectMgr.GetRepSpilloverTemplate(factionEntry->ID))
+    if (RepSpilloverList const* spillover = sObjectMgr.GetRepSpillover(factionEntry->ID))
     {
-        for (uint32 i = 0; i < MAX_SPILLOVER_FACTIONS; ++i)
+        for (RepSpilloverList::const_iterator itr = spillover->begin(); itr != spillover->end(); ++itr)
         {
-            if (repTemplate->faction[i])
+            if (GetRank(itr->faction) <= itr->rank)
             {
-                if (m_player->GetReputationRank(repTemplate->faction[i]) <= ReputationRank(repTemplate->faction_rank[i]))
-                {
-                    // bonuses are already given, so just modify standing by rate
-                    int32 spilloverRep = standing * repTemplate->faction_rate[i];
-                    SetOneFactionReputation(sFactionStore.LookupEntry(repTemplate->faction[i]), spilloverRep, incremental);
-                }
+                // bonuses are already given, so just modify standing by rate
+                int32 spilloverRep = standing * itr->rate;
+                SetOneFactionReputation(itr->faction, spilloverRep, incremental);
             }
         }
     }
     // spillover done, update faction itself
-    FactionStateList::iterator faction = m_factions.find(factionEntry->reputationListID);
-    if (faction != m_factions.end())
-    {
-        res = SetOneFactionReputation(factionEntry, standing, incremental);
-        // only this faction gets reported to client, even if it has no own visible standing
-        SendState(&faction->second);
-    }
+    res = SetOneFactionReputation(factionEntry, standing, incremental);
+
+    // the changed standings reach the client with the next player update, combined with any other changes until then
+    m_statesPending = true;
     return res;
 }
 
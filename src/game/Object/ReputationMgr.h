@@ -63,7 +63,7 @@ class QueryResult;
 class ReputationMgr
 {
     public:                                                 // constructors and global modifiers
-        explicit ReputationMgr(Player* owner) : m_player(owner) {}
+        explicit ReputationMgr(Player* owner) : m_player(owner), m_statesPending(false) {}
         ~ReputationMgr() {}
 
         void SaveToDB();
@@ -121,7 +121,8 @@ class ReputationMgr
     public:                                                 // senders
         void SendInitialReputations();
         void SendForceReactions();
-        void SendState(FactionState const* faction);
+        // sends all standings changed since the last call in one packet, called once per player update
+        void SendPendingStates();
 
     private:                                                // internal helper functions
         void Initialize();
@@ -136,6 +137,7 @@ class ReputationMgr
         Player* m_player;
         FactionStateList m_factions;
         ForcedReactions m_forcedReactions;
+        bool m_statesPending;                               // some standing changed since the last SendPendingStates
 };
 
 #endif
@@ -100,6 +100,11 @@ bool PlayerSocial::AddToSocialList(ObjectGuid friend_guid, bool ignore)
         fi.Flags |= flag;
         m_playerSocialMap[friend_guid.GetCounter()] = fi;
     }
+
+    if (flag & SOCIAL_FLAG_FRIEND)
+    {
+        sSocialMgr.AddFriendLister(friend_guid.GetCounter(), m_playerLowGuid);
+    }
     return true;
 }
 
@@ -118,6 +123,12 @@ void PlayerSocial::RemoveFromSocialList(ObjectGuid friend_guid, bool ignore)
     }
 
     itr->second.Flags &= ~flag;
+
+    if (flag & SOCIAL_FLAG_FRIEND)
+    {
+        sSocialMgr.RemoveFriendLister(friend_guid.GetCounter(), m_playerLowGuid);
+    }
+
     if (itr->second.Flags == 0)
     {
         CharacterDatabase.PExecute("DELETE FROM `character_social` WHERE `guid` = '%u' AND `friend` = '%u'", m_playerLowGuid, friend_guid.GetCounter());
@@ -232,6 +243,40 @@ SocialMgr::~SocialMgr()
 {
 }
 
+void SocialMgr::RemovePlayerSocial(uint32 guid)
+{
+    SocialMap::iterator itr = m_socialMap.find(guid);
+    if (itr == m_socialMap.end())
+    {
+        return;
+    }
+
+    for (PlayerSocialMap::const_iterator itr2 = itr->second.m_playerSocialMap.begin(); itr2 != itr->second.m_playerSocialMap.end(); ++itr2)
+    {
+        if (itr2->second.Flags & SOCIAL_FLAG_FRIEND)
+        {
+            RemoveFriendLister(itr2->first, guid);
+        }
+    }
+
+    m_socialMap.erase(itr);
+}
+
+void SocialMgr::RemoveFriendLister(uint32 friendGuid, uint32 listerGuid)
+{
+    FriendListerMap::iterator itr = m_friendListers.find(friendGuid);
+    if (itr == m_friendListers.end())
+    {
+        return;
+    }
+
+    itr->second.erase(listerGuid);
+    if (itr->second.empty())
+    {
+        m_friendListers.erase(itr);
+    }
+}
+
 void SocialMgr::GetFriendInfo(Player* player, uint32 friend_lowguid, FriendInfo& friendInfo)
 {
     if (!player)
@@ -332,22 +377,24 @@ void SocialMgr::BroadcastToFriendListers(Player* player, WorldPacket* packet)
     AccountTypes gmLevelInWhoList = AccountTypes(sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_IN_WHO_LIST));
     bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST);
 
-    for (SocialMap::const_iterator itr = m_socialMap.begin(); itr != m_socialMap.end(); ++itr)
+    FriendListerMap::const_iterator listers = m_friendListers.find(guid);
+    if (listers == m_friendListers.end())
+    {
+        return;
+    }
+
+    for (std::set<uint32>::const_iterator itr = listers->second.begin(); itr != listers->second.end(); ++itr)
     {
-        PlayerSocialMap::const_iterator itr2 = itr->second.m_playerSocialMap.find(guid);
-        if (itr2 != itr->second.m_playerSocialMap.end() && (itr2->second.Flags & SOCIAL_FLAG_FRIEND))
+        Player* pFriend = sObjectAccessor.FindPlayer(ObjectGuid(HIGHGUID_PLAYER, *itr));
+
+        // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
+        // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
+        if (pFriend && pFriend->IsInWorld() &&
+            (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
+             ((pFriend->GetTeam() == team || allowTwoSideWhoList) && security <= gmLevelInWhoList)) &&
+            player->IsVisibleGloballyFor(pFriend))
         {
-            Player* pFriend = sObjectAccessor.FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
-
-            // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
-            // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
-            if (pFriend && pFriend->IsInWorld() &&
-                (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
-                 ((pFriend->GetTeam() == team || allowTwoSideWhoList) && security <= gmLevelInWhoList)) &&
-                player->IsVisibleGloballyFor(pFriend))
-            {
-                pFriend->GetSession()->SendPacket(packet);
-            }
+            pFriend->GetSession()->SendPacket(packet);
         }
     }
 }
@@ -383,6 +430,11 @@ PlayerSocial* SocialMgr::LoadFromDB(QueryResult* result, ObjectGuid guid)
 
         social->m_playerSocialMap[friend_guid] = FriendInfo(flags);
 
+        if (flags & SOCIAL_FLAG_FRIEND)
+        {
+            AddFriendLister(friend_guid, guid.GetCounter());
+        }
+
         if (flags & SOCIAL_FLAG_IGNORED)
         {
             ++ignoreCounter;
@@ -141,7 +141,11 @@ class SocialMgr
         SocialMgr();
         ~SocialMgr();
         // Misc
-        void RemovePlayerSocial(uint32 guid) { m_socialMap.erase(guid); }
+        void RemovePlayerSocial(uint32 guid);
+
+        // reverse friend index, kept by PlayerSocial for the loaded (online) social lists
+        void AddFriendLister(uint32 friendGuid, uint32 listerGuid) { m_friendListers[friendGuid].insert(listerGuid); }
+        void RemoveFriendLister(uint32 friendGuid, uint32 listerGuid);
 
         void GetFriendInfo(Player* player, uint32 friendGUID, FriendInfo& friendInfo);
         // Packet management
@@ -151,7 +155,10 @@ class SocialMgr
         // Loading
         PlayerSocial* LoadFromDB(QueryResult* result, ObjectGuid guid);
     private:
+        typedef std::map<uint32, std::set<uint32> > FriendListerMap;
+
         SocialMap m_socialMap;
+        FriendListerMap m_friendListers;                    // friend low guid -> low guids of loaded socials that list it as friend
 };
 
 #define sSocialMgr MaNGOS::Singleton<SocialMgr>::Instance()
@@ -810,7 +810,7 @@ bool IsExplicitNegativeTarget(uint32 targetA)
     return false;
 }
 
-bool IsPositiveEffect(SpellEntry const* spellproto, SpellEffectIndex effIndex)
+static bool ComputePositiveEffect(SpellEntry const* spellproto, SpellEffectIndex effIndex)
 {
     //fast returns in some special cases
     switch (spellproto->Id)
@@ -1066,7 +1066,18 @@ bool IsPositiveSpell(uint32 spellId)
     return IsPositiveSpell(spellproto);
 }
 
-bool IsPositiveSpell(SpellEntry const* spellproto)
+bool IsPositiveEffect(SpellEntry const* spellproto, SpellEffectIndex effIndex)
+{
+    uint8 classifiers = sSpellMgr.GetSpellClassifiers(spellproto);
+    if (classifiers & SPELL_CLASSIFIER_CACHED)
+    {
+        return classifiers & (SPELL_CLASSIFIER_POSITIVE_EFFECT_0 << effIndex);
+    }
+
+    return ComputePositiveEffect(spellproto, effIndex);
+}
+
+static bool ComputePositiveSpell(SpellEntry const* spellproto)
 {
     // spells with at least one negative effect are considered negative
     // some self-applied spells have negative effects but in self casting case negative check ignored.
@@ -1078,7 +1089,41 @@ bool IsPositiveSpell(SpellEntry const* spellproto)
     return true;
 }
 
-bool IsSingleTargetSpell(SpellEntry const* spellInfo)
+bool IsPositiveSpell(SpellEntry const* spellproto)
+{
+    uint8 classifiers = sSpellMgr.GetSpellClassifiers(spellproto);
+    if (classifiers & SPELL_CLASSIFIER_CACHED)
+    {
+        return classifiers & SPELL_CLASSIFIER_POSITIVE;
+    }
+
+    return ComputePositiveSpell(spellproto);
+}
+
+static bool ComputeAreaOfEffectSpell(SpellEntry const* spellInfo)
+{
+    for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
+    {
+        if (IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetA[i])) || IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetB[i])))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool IsAreaOfEffectSpell(SpellEntry const* spellInfo)
+{
+    uint8 classifiers = sSpellMgr.GetSpellClassifiers(spellInfo);
+    if (classifiers & SPELL_CLASSIFIER_CACHED)
+    {
+        return classifiers & SPELL_CLASSIFIER_AREA_OF_EFFECT;
+    }
+
+    return ComputeAreaOfEffectSpell(spellInfo);
+}
+
+static bool ComputeSingleTargetSpell(SpellEntry const* spellInfo)
 {
     // hunter's mark and similar
     if (spellInfo->SpellVisual == 3239)
@@ -1142,6 +1187,17 @@ bool IsSingleTargetSpell(SpellEntry const* spellInfo)
     return false;
 }
 
+bool IsSingleTargetSpell(SpellEntry const* spellInfo)
+{
+    uint8 classifiers = sSpellMgr.GetSpellClassifiers(spellInfo);
+    if (classifiers & SPELL_CLASSIFIER_CACHED)
+    {
+        return classifiers & SPELL_CLASSIFIER_SINGLE_TARGET;
+    }
+
+    return ComputeSingleTargetSpell(spellInfo);
+}
+
 bool IsSingleTargetSpells(SpellEntry const* spellInfo1, SpellEntry const* spellInfo2)
 {
     // TODO - need better check
@@ -1530,6 +1586,7 @@ struct DoSpellProcEvent
 void SpellMgr::LoadSpellProcEvents()
 {
     mSpellProcEventMap.clear();                             // need for reload case
+    mSpellProcEventIndex.Clear();
 
     //                                                0      1           2                3                 4                 5                 6          7       8        9             10
     QueryResult* result = WorldDatabase.Query("SELECT `entry`, `SchoolMask`, `SpellFamilyName`, `SpellFamilyMask0`, `SpellFamilyMask1`, `SpellFamilyMask2`, `procFlags`, `procEx`, `ppmRate`, `CustomChance`, `Cooldown` FROM `spell_proc_event`");
@@ -1577,6 +1634,8 @@ void SpellMgr::LoadSpellProcEvents()
 
     delete result;
 
+    mSpellProcEventIndex.Build(mSpellProcEventMap);
+
     sLog.outString(">> Loaded %u extra spell proc event conditions +%u custom proc (inc. +%u custom ranks)",  rankHelper.worker.count, rankHelper.worker.customProc, rankHelper.customRank);
     sLog.outString();
 }
@@ -1593,6 +1652,7 @@ struct DoSpellProcItemEnchant
 void SpellMgr::LoadSpellProcItemEnchant()
 {
     mSpellProcItemEnchantMap.clear();                       // need for reload case
+    mSpellProcItemEnchantIndex.Clear();
 
     uint32 count = 0;
 
@@ -1647,6 +1707,8 @@ void SpellMgr::LoadSpellProcItemEnchant()
 
     delete result;
 
+    mSpellProcItemEnchantIndex.Build(mSpellProcItemEnchantMap);
+
     sLog.outString(">> Loaded %u proc item enchant definitions", count);
     sLog.outString();
 }
@@ -1663,6 +1725,7 @@ struct DoSpellBonuses
 void SpellMgr::LoadSpellBonuses()
 {
     mSpellBonusMap.clear();                             // need for reload case
+    mSpellBonusIndex.Clear();
     uint32 count = 0;
 
     QueryResult* result = WorldDatabase.Query("SELECT `entry`, `direct_bonus`, `one_hand_direct_bonus`, `two_hand_direct_bonus`, \
@@ -1864,6 +1927,8 @@ void SpellMgr::LoadSpellBonuses()
 
     delete result;
 
+    mSpellBonusIndex.Build(mSpellBonusMap);
+
     sLog.outString(">> Loaded %u extra spell bonus data",  count);
 }
 
@@ -2031,6 +2096,7 @@ bool SpellMgr::IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const* spellPr
 void SpellMgr::LoadSpellElixirs()
 {
     mSpellElixirs.clear();                                  // need for reload case
+    mSpellElixirIndex.Clear();
 
     uint32 count = 0;
 
@@ -2074,6 +2140,8 @@ void SpellMgr::LoadSpellElixirs()
 
     delete result;
 
+    mSpellElixirIndex.Build(mSpellElixirs);
+
     sLog.outString(">> Loaded %u spell elixir definitions", count);
     sLog.outString();
 }
@@ -2140,6 +2208,7 @@ struct DoSpellThreat
 void SpellMgr::LoadSpellThreats()
 {
     mSpellThreatMap.clear();                                // need for reload case
+    mSpellThreatIndex.Clear();
 
     //                                                0      1       2           3
     QueryResult* result = WorldDatabase.Query("SELECT `entry`, `Threat`, `multiplier`, `ap_bonus` FROM `spell_threat`");
@@ -2177,6 +2246,8 @@ void SpellMgr::LoadSpellThreats()
 
     delete result;
 
+    mSpellThreatIndex.Build(mSpellThreatMap);
+
     sLog.outString(">> Loaded %u spell threat entries", rankHelper.worker.count);
     sLog.outString();
 }
@@ -2216,6 +2287,55 @@ void SpellMgr::ModDBCSpellAttributes()
     }
 }
 
+void SpellMgr::LoadSpellClassifiers()
+{
+    // filled aside, the classifiers recurse into triggered spells and use the old cache meanwhile
+    std::vector<uint8> classifiers(sSpellStore.GetNumRows(), 0);
+    uint32 count = 0;
+
+    for (uint32 id = 0; id < sSpellStore.GetNumRows(); ++id)
+    {
+        SpellEntry const* spellInfo = sSpellStore.LookupEntry(id);
+        if (!spellInfo)
+        {
+            continue;
+        }
+
+        uint8 flags = SPELL_CLASSIFIER_CACHED;
+
+        if (ComputePositiveSpell(spellInfo))
+        {
+            flags |= SPELL_CLASSIFIER_POSITIVE;
+        }
+
+        for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
+        {
+            if (ComputePositiveEffect(spellInfo, SpellEffectIndex(i)))
+            {
+                flags |= SPELL_CLASSIFIER_POSITIVE_EFFECT_0 << i;
+            }
+        }
+
+        if (ComputeAreaOfEffectSpell(spellInfo))
+        {
+            flags |= SPELL_CLASSIFIER_AREA_OF_EFFECT;
+        }
+
+        if (ComputeSingleTargetSpell(spellInfo))
+        {
+            flags |= SPELL_CLASSIFIER_SINGLE_TARGET;
+        }
+
+        classifiers[id] = flags;
+        ++count;
+    }
+
+    mSpellClassifiers.swap(classifiers);
+
+    sLog.outString(">> Cached classifiers of %u spells", count);
+    sLog.outString();
+}
+
 bool SpellMgr::IsRankSpellDueToSpell(SpellEntry const* spellInfo_1, uint32 spellId_2) const
 {
     SpellEntry const* spellInfo_2 = sSpellStore.LookupEntry(spellId_2);
@@ -3422,6 +3542,7 @@ static void LoadSpellChains_AbilityHelper(SpellChainMap& chainMap, AbilitySpellP
 void SpellMgr::LoadSpellChains()
 {
     mSpellChains.clear();                                   // need for reload case
+    mSpellChainIndex.Clear();
     mSpellChainsNext.clear();                               // need for reload case
 
     // load known data for talents
@@ -3557,6 +3678,8 @@ void SpellMgr::LoadSpellChains()
         BarGoLink bar(1);
         bar.step();
 
+        mSpellChainIndex.Build(mSpellChains);
+
         sLog.outString(">> Loaded 0 spell chain records");
         sLog.outErrorDb("`spell_chains` table is empty!");
         sLog.outString();
@@ -3780,6 +3903,8 @@ void SpellMgr::LoadSpellChains()
         }
     }
 
+    mSpellChainIndex.Build(mSpellChains);
+
     sLog.outString(">> Loaded %u spell chain records (%u from DBC data with %u req field updates, and %u loaded from table)", dbc_count + new_count, dbc_count, req_count, new_count);
     sLog.outString();
 }
@@ -5120,6 +5245,7 @@ void SpellArea::ApplyOrRemoveSpellIfCan(Player* player, uint32 newZone, uint32 n
 void SpellMgr::LoadSpellAffects()
 {
     mSpellAffectMap.clear();                                // need for reload case
+    mSpellAffectIndex.Clear();
 
     uint32 count = 0;
 
@@ -5191,6 +5317,9 @@ void SpellMgr::LoadSpellAffects()
 
     delete result;
 
+    // keyed by (spell id << 8) + effect index
+    mSpellAffectIndex.Build(mSpellAffectMap, [](uint32 key) { return (key >> 8) * MAX_EFFECT_INDEX + (key & 0xFF); });
+
     sLog.outString();
     sLog.outString(">> Loaded %u spell affect definitions", count);
 
@@ -5230,6 +5359,7 @@ void SpellMgr::LoadSpellAffects()
 void SpellMgr::LoadFacingCasterFlags()
 {
     mSpellFacingFlagMap.clear();
+    mSpellFacingFlagIndex.Clear();
     uint32 count = 0;
 
     //                                                0              1
@@ -5268,6 +5398,8 @@ void SpellMgr::LoadFacingCasterFlags()
 
     delete result;
 
+    mSpellFacingFlagIndex.Build(mSpellFacingFlagMap);
+
     sLog.outString();
     sLog.outString(">> Loaded %u facing caster flags", count);
 }
@@ -37,6 +37,7 @@
 #include "Utilities/UnorderedMapSet.h"
 
 #include <map>
+#include <vector>
 
 class Player;
 class Spell;
@@ -233,6 +234,18 @@ inline bool IsNonCombatSpell(SpellEntry const* spellInfo)
     return spellInfo->HasAttribute(SPELL_ATTR_CANT_USED_IN_COMBAT);
 }
 
+// results of the classifier functions below, cached per spell by SpellMgr::LoadSpellClassifiers
+enum SpellClassifierFlags
+{
+    SPELL_CLASSIFIER_CACHED            = 0x01,              // other flags are valid
+    SPELL_CLASSIFIER_POSITIVE          = 0x02,
+    SPELL_CLASSIFIER_POSITIVE_EFFECT_0 = 0x04,              // shifted by the effect index
+    SPELL_CLASSIFIER_POSITIVE_EFFECT_1 = 0x08,
+    SPELL_CLASSIFIER_POSITIVE_EFFECT_2 = 0x10,
+    SPELL_CLASSIFIER_AREA_OF_EFFECT    = 0x20,
+    SPELL_CLASSIFIER_SINGLE_TARGET     = 0x40
+};
+
 bool IsPositiveSpell(uint32 spellId);
 bool IsPositiveSpell(SpellEntry const* spellproto);
 bool IsPositiveEffect(SpellEntry const* spellInfo, SpellEffectIndex effIndex);
@@ -457,22 +470,7 @@ inline bool IsSpellRemovedOnEvade(SpellEntry const* spellInfo)
 }
 
 
-inline bool IsAreaOfEffectSpell(SpellEntry const* spellInfo)
-{
-    if (IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetA[EFFECT_INDEX_0])) || IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetB[EFFECT_INDEX_0])))
-    {
-        return true;
-    }
-    if (IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetA[EFFECT_INDEX_1])) || IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetB[EFFECT_INDEX_1])))
-    {
-        return true;
-    }
-    if (IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetA[EFFECT_INDEX_2])) || IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetB[EFFECT_INDEX_2])))
-    {
-        return true;
-    }
-    return false;
-}
+bool IsAreaOfEffectSpell(SpellEntry const* spellInfo);
 
 inline bool IsAreaAuraEffect(uint32 effect)
 {
@@ -1061,6 +1059,45 @@ inline bool IsProfessionOrRidingSkill(uint32 skill)
 
 typedef std::map<uint32, uint32> SpellFacingFlagMap;
 
+/**
+ * Read only lookup of the entries of a spell table by spell id.
+ *
+ * The entries point into the map the table is loaded into, so the index is
+ * built again whenever the map was changed and cleared along with it.
+ */
+template<typename T>
+class SpellIdIndex
+{
+    public:
+        T const* Find(uint32 id) const { return id < m_entries.size() ? m_entries[id] : NULL; }
+
+        template<typename Map>
+        void Build(Map const& map) { Build(map, [](uint32 key) { return key; }); }
+
+        // toIndex maps a map key to the position used with Find
+        template<typename Map, typename KeyToIndex>
+        void Build(Map const& map, KeyToIndex toIndex)
+        {
+            uint32 size = 0;
+            for (typename Map::const_iterator itr = map.begin(); itr != map.end(); ++itr)
+            {
+                size = std::max(size, toIndex(itr->first) + 1);
+            }
+
+            std::vector<T const*>(size, static_cast<T const*>(NULL)).swap(m_entries);
+
+            for (typename Map::const_iterator itr = map.begin(); itr != map.end(); ++itr)
+            {
+                m_entries[toIndex(itr->first)] = &itr->second;
+            }
+        }
+
+        void Clear() { std::vector<T const*>().swap(m_entries); }
+
+    private:
+        std::vector<T const*> m_entries;
+};
+
 class SpellMgr
 {
         friend struct DoSpellBonuses;
@@ -1077,10 +1114,9 @@ class SpellMgr
         // Spell affects
         ClassFamilyMask GetSpellAffectMask(uint32 spellId, SpellEffectIndex effectId) const
         {
-            SpellAffectMap::const_iterator itr = mSpellAffectMap.find((spellId << 8) + effectId);
-            if (itr != mSpellAffectMap.end())
+            if (uint64 const* mask = mSpellAffectIndex.Find(spellId * MAX_EFFECT_INDEX + effectId))
             {
-                return ClassFamilyMask(itr->second);
+                return ClassFamilyMask(*mask);
             }
             if (SpellEntry const* spellEntry = sSpellStore.LookupEntry(spellId))
             {
@@ -1093,13 +1129,13 @@ class SpellMgr
 
         uint32 GetSpellElixirMask(uint32 spellid) const
         {
-            SpellElixirMap::const_iterator itr = mSpellElixirs.find(spellid);
-            if (itr == mSpellElixirs.end())
+            uint8 const* mask = mSpellElixirIndex.Find(spellid);
+            if (!mask)
             {
                 return 0x0;
             }
 
-            return itr->second;
+            return *mask;
         }
 
         SpellSpecific GetSpellElixirSpecific(uint32 spellid) const
@@ -1123,13 +1159,7 @@ class SpellMgr
 
         SpellThreatEntry const* GetSpellThreatEntry(uint32 spellid) const
         {
-            SpellThreatMap::const_iterator itr = mSpellThreatMap.find(spellid);
-            if (itr != mSpellThreatMap.end())
-            {
-                return &itr->second;
-            }
-
-            return NULL;
+            return mSpellThreatIndex.Find(spellid);
         }
 
         float GetSpellThreatMultiplier(SpellEntry const* spellInfo) const
@@ -1150,24 +1180,19 @@ class SpellMgr
         // Spell proc events
         SpellProcEventEntry const* GetSpellProcEvent(uint32 spellId) const
         {
-            SpellProcEventMap::const_iterator itr = mSpellProcEventMap.find(spellId);
-            if (itr != mSpellProcEventMap.end())
-            {
-                return &itr->second;
-            }
-            return NULL;
+            return mSpellProcEventIndex.Find(spellId);
         }
 
         // Spell procs from item enchants
         float GetItemEnchantProcChance(uint32 spellid) const
         {
-            SpellProcItemEnchantMap::const_iterator itr = mSpellProcItemEnchantMap.find(spellid);
-            if (itr == mSpellProcItemEnchantMap.end())
+            float const* chance = mSpellProcItemEnchantIndex.Find(spellid);
+            if (!chance)
             {
                 return 0.0f;
             }
 
-            return itr->second;
+            return *chance;
         }
 
         static bool IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const* spellProcEvent, uint32 EventProcFlag, SpellEntry const* procSpell, uint32 procFlags, uint32 procExtra);
@@ -1175,24 +1200,18 @@ class SpellMgr
         // Spell bonus data
         SpellBonusEntry const* GetSpellBonusData(uint32 spellId) const
         {
-            // Lookup data
-            SpellBonusMap::const_iterator itr = mSpellBonusMap.find(spellId);
-            if (itr != mSpellBonusMap.end())
-            {
-                return &itr->second;
-            }
-
-            return NULL;
+            return mSpellBonusIndex.Find(spellId);
         }
 
         uint32 GetSpellFacingFlag(uint32 spellId) const
         {
-            SpellFacingFlagMap::const_iterator itr =  mSpellFacingFlagMap.find(spellId);
-            if (itr != mSpellFacingFlagMap.end())
+            uint32 const* flags = mSpellFacingFlagIndex.Find(spellId);
+            if (!flags)
             {
-                return itr->second;
+                return 0x0;
             }
-            return 0x0;
+
+            return *flags;
         }
 
         // Spell target coordinates
@@ -1209,13 +1228,7 @@ class SpellMgr
         // Spell ranks chains
         SpellChainNode const* GetSpellChainNode(uint32 spell_id) const
         {
-            SpellChainMap::const_iterator itr = mSpellChains.find(spell_id);
-            if (itr == mSpellChains.end())
-            {
-                return NULL;
-            }
-
-            return &itr->second;
+            return mSpellChainIndex.Find(spell_id);
         }
 
         uint32 GetFirstSpellInChain(uint32 spell_id) const
@@ -1387,6 +1400,18 @@ class SpellMgr
 
         SpellLinkedSet GetSpellLinked(uint32 spell_id, SpellLinkedType type) const;
 
+        // Spell classifier cache, SpellClassifierFlags or 0 for spells not in it
+        uint8 GetSpellClassifiers(SpellEntry const* spellInfo) const
+        {
+            // a modified copy of a spell is not what was cached
+            if (spellInfo->Id < mSpellClassifiers.size() && sSpellStore.LookupEntry(spellInfo->Id) == spellInfo)
+            {
+                return mSpellClassifiers[spellInfo->Id];
+            }
+
+            return 0;
+        }
+
         // Modifiers
     public:
         static SpellMgr& Instance();
@@ -1415,6 +1440,9 @@ class SpellMgr
         // Edit DBC data spells at startup
         void ModDBCSpellAttributes();
 
+        // Cache classifier results, after the spell data is final
+        void LoadSpellClassifiers();
+
     private:
         SpellChainMap      mSpellChains;
         SpellChainMapNext  mSpellChainsNext;
@@ -1435,6 +1463,17 @@ class SpellMgr
         SpellAreaForAuraMap  mSpellAreaForAuraMap;
         SpellAreaForAreaMap  mSpellAreaForAreaMap;
         SpellFacingFlagMap  mSpellFacingFlagMap;
+        std::vector<uint8>  mSpellClassifiers;
+
+        // lookups of the hot tables above, built at the end of their Load function
+        SpellIdIndex<SpellChainNode>      mSpellChainIndex;
+        SpellIdIndex<uint64>              mSpellAffectIndex;
+        SpellIdIndex<uint8>               mSpellElixirIndex;
+        SpellIdIndex<SpellThreatEntry>    mSpellThreatIndex;
+        SpellIdIndex<SpellProcEventEntry> mSpellProcEventIndex;
+        SpellIdIndex<float>               mSpellProcItemEnchantIndex;
+        SpellIdIndex<SpellBonusEntry>     mSpellBonusIndex;
+        SpellIdIndex<uint32>              mSpellFacingFlagIndex;
 };
 
 #define sSpellMgr SpellMgr::Instance()
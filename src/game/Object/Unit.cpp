@@ -210,6 +210,8 @@ Unit::Unit() :
     // m_AurasCheck = 2000;
     // m_removeAuraTimer = 4;
     m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.end();
+    m_procAuraFlags = 0;
+    m_collectPeriodicAuraLogs = false;
     m_AuraFlags = 0;
 
     m_Visibility = VISIBILITY_ON;
@@ -219,6 +221,8 @@ Unit::Unit() :
     m_invisibilityMask = 0;
     m_transform = 0;
     m_canModifyStats = false;
+    m_statUpdateDeferDepth = 0;
+    m_dirtyStatMods = 0;
 
     for (int i = 0; i < MAX_SPELL_IMMUNITY; ++i)
     {
@@ -374,8 +378,11 @@ void Unit::Update(uint32 update_diff, uint32 p_time)
     {
         ModifyAuraState(AURA_STATE_HEALTHLESS_20_PERCENT, GetHealth() < GetMaxHealth() * 0.20f);
     }
-    UpdateSplineMovement(p_time);
-    i_motionMaster.UpdateMotion(p_time);
+    if (!IsMotionFrozen())
+    {
+        UpdateSplineMovement(p_time);
+        i_motionMaster.UpdateMotion(p_time);
+    }
 }
 
 bool Unit::UpdateMeleeAttackingState()
@@ -3540,12 +3547,15 @@ void Unit::_UpdateSpells(uint32 time)
 
     // update auras
     // m_AurasUpdateIterator can be updated in inderect called code at aura remove to skip next planned to update but removed auras
+    m_collectPeriodicAuraLogs = true;
     for (m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.begin(); m_spellAuraHoldersUpdateIterator != m_spellAuraHolders.end();)
     {
         SpellAuraHolder* i_holder = m_spellAuraHoldersUpdateIterator->second;
         ++m_spellAuraHoldersUpdateIterator;                 // need shift to next for allow update if need into aura update
         i_holder->UpdateHolder(time);
     }
+    m_collectPeriodicAuraLogs = false;
+    FlushPeriodicAuraLogs();
 
     // remove expired auras
     for (SpellAuraHolderMap::iterator iter = m_spellAuraHolders.begin(); iter != m_spellAuraHolders.end();)
@@ -3636,6 +3646,8 @@ void Unit::SetCurrentCastedSpell(Spell* pSpell)
         return;       // avoid breaking self
     }
 
+    WakeUp();
+
     // break same type spell if it is not delayed
     InterruptSpell(CSpellType, false);
 
@@ -4116,6 +4128,8 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
         return false;
     }
 
+    WakeUp();
+
     if (holder->GetTarget() != this)
     {
         sLog.outError("Holder (spell %u) add to spell aura holder list of %s (lowguid: %u) but spell aura holder target is %s (lowguid: %u)",
@@ -4272,6 +4286,7 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     // add aura, register in lists and arrays
     holder->_AddSpellAuraHolder();
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
+    AddProcAuraHolder(holder);
 
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
@@ -4839,6 +4854,7 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder* holder, AuraRemoveMode mode)
         if (itr->second == holder)
         {
             m_spellAuraHolders.erase(itr);
+            RemoveProcAuraHolder(holder);
             break;
         }
     }
@@ -4908,7 +4924,10 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
     // remove from list before mods removing (prevent cyclic calls, mods added before including to aura list - use reverse order)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
-        m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        if (m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur))
+        {
+            m_modAurasToCompact.push_back(Aur->GetModifier()->m_auraname);
+        }
     }
 
     // Set remove mode
@@ -4957,6 +4976,8 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
 
 void Unit::RemoveAllAuras(AuraRemoveMode mode /*= AURA_REMOVE_BY_DEFAULT*/)
 {
+    StatUpdateBatch statBatch(this);
+
     while (!m_spellAuraHolders.empty())
     {
         SpellAuraHolderMap::iterator iter = m_spellAuraHolders.begin();
@@ -4968,6 +4989,8 @@ void Unit::RemoveAllAurasOnDeath()
 {
     // used just after dieing to remove all visible auras
     // and disable the mods for the passive ones
+    StatUpdateBatch statBatch(this);
+
     for (SpellAuraHolderMap::iterator iter = m_spellAuraHolders.begin(); iter != m_spellAuraHolders.end();)
     {
         if (!iter->second->IsPassive() && !iter->second->IsDeathPersistent())
@@ -4987,6 +5010,8 @@ void Unit::RemoveAllAurasOnEvade()
     // used when evading to remove all auras except some special auras
    // Fly should not be removed on evade - neither should linked auras
    // Some cosmetic script auras should not be removed on evade either
+    StatUpdateBatch statBatch(this);
+
     for (SpellAuraHolderMap::iterator iter = m_spellAuraHolders.begin(); iter != m_spellAuraHolders.end();)
     {
         SpellEntry const* proto = iter->second->GetSpellProto();
@@ -5336,7 +5361,7 @@ void Unit::SendSpellNonMeleeDamageLog(SpellNonMeleeDamage* log)
     data << uint32(log->blocked);                           // blocked
     data << uint32(log->HitInfo);
     data << uint8(0);                                       // flag to use extend data
-    SendMessageToSet(&data, true);
+    SendCombatLogToSet(&data, log->target);
 }
 
 void Unit::SendSpellNonMeleeDamageLog(Unit* target, uint32 SpellID, uint32 Damage, SpellSchoolMask damageSchoolMask, uint32 AbsorbedDamage, uint32 Resist, bool PhysicalDamage, uint32 Blocked, bool CriticalHit)
@@ -5355,16 +5380,12 @@ void Unit::SendSpellNonMeleeDamageLog(Unit* target, uint32 SpellID, uint32 Damag
     SendSpellNonMeleeDamageLog(&log);
 }
 
-void Unit::SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo)
+// writes the per aura part of SMSG_PERIODICAURALOG, false for aura types the client has no log for
+static bool BuildPeriodicAuraLogEntry(WorldPacket& data, SpellPeriodicAuraLogInfo* pInfo)
 {
     Aura* aura = pInfo->aura;
     Modifier* mod = aura->GetModifier();
 
-    WorldPacket data(SMSG_PERIODICAURALOG, 30);
-    data << aura->GetTarget()->GetPackGUID();
-    data << aura->GetCasterGuid().WriteAsPacked();
-    data << uint32(aura->GetId());                          // spellId
-    data << uint32(1);                                      // count
     data << uint32(mod->m_auraname);                        // auraId
     switch (mod->m_auraname)
     {
@@ -5391,10 +5412,114 @@ void Unit::SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo)
             break;
         default:
             sLog.outError("Unit::SendPeriodicAuraLog: unknown aura %u", uint32(mod->m_auraname));
-            return;
+            return false;
+    }
+
+    return true;
+}
+
+void Unit::SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo)
+{
+    Aura* aura = pInfo->aura;
+    Unit* target = aura->GetTarget();
+
+    // during its aura update the target collects its logs, effects of one spell and caster go in one packet
+    if (target == this && m_collectPeriodicAuraLogs)
+    {
+        for (std::vector<PeriodicAuraLogBatch>::iterator itr = m_periodicAuraLogs.begin(); itr != m_periodicAuraLogs.end(); ++itr)
+        {
+            if (itr->spellId == aura->GetId() && itr->casterGuid == aura->GetCasterGuid())
+            {
+                size_t entryPos = itr->data.wpos();
+                if (BuildPeriodicAuraLogEntry(itr->data, pInfo))
+                {
+                    itr->data.put<uint32>(itr->countPos, ++itr->count);
+                }
+                else
+                {
+                    itr->data.resize(entryPos);
+                }
+                return;
+            }
+        }
+
+        m_periodicAuraLogs.resize(m_periodicAuraLogs.size() + 1);
+        PeriodicAuraLogBatch& batch = m_periodicAuraLogs.back();
+        batch.casterGuid = aura->GetCasterGuid();
+        batch.spellId = aura->GetId();
+        batch.count = 1;
+        batch.data.Initialize(SMSG_PERIODICAURALOG, 30);
+        batch.data << target->GetPackGUID();
+        batch.data << aura->GetCasterGuid().WriteAsPacked();
+        batch.data << uint32(aura->GetId());                // spellId
+        batch.countPos = batch.data.wpos();
+        batch.data << uint32(1);                            // count
+
+        if (!BuildPeriodicAuraLogEntry(batch.data, pInfo))
+        {
+            m_periodicAuraLogs.pop_back();
+        }
+        return;
+    }
+
+    WorldPacket data(SMSG_PERIODICAURALOG, 30);
+    data << target->GetPackGUID();
+    data << aura->GetCasterGuid().WriteAsPacked();
+    data << uint32(aura->GetId());                          // spellId
+    data << uint32(1);                                      // count
+
+    if (BuildPeriodicAuraLogEntry(data, pInfo))
+    {
+        target->SendCombatLogToSet(&data, aura->GetCaster());
+    }
+}
+
+void Unit::FlushPeriodicAuraLogs()
+{
+    if (m_periodicAuraLogs.empty())
+    {
+        return;
+    }
+
+    if (m_periodicAuraLogs.size() == 1)
+    {
+        Unit* caster = IsInWorld() ? GetMap()->GetUnit(m_periodicAuraLogs[0].casterGuid) : NULL;
+        SendCombatLogToSet(&m_periodicAuraLogs[0].data, caster);
+    }
+    else
+    {
+        std::vector<WorldPacket*> packets;
+        packets.reserve(m_periodicAuraLogs.size());
+        for (std::vector<PeriodicAuraLogBatch>::iterator itr = m_periodicAuraLogs.begin(); itr != m_periodicAuraLogs.end(); ++itr)
+        {
+            packets.push_back(&itr->data);
+        }
+
+        // several casters, the players among them are found by the distance check only
+        SendCombatLogToSet(&packets[0], packets.size(), NULL);
     }
 
-    aura->GetTarget()->SendMessageToSet(&data, true);
+    m_periodicAuraLogs.clear();
+}
+
+void Unit::SendCombatLogToSet(WorldPacket* const* data, size_t count, Unit const* target) const
+{
+    // if unit is in world, map for it already created!
+    if (IsInWorld())
+    {
+        GetMap()->CombatLogBroadcast(this, data, count, target);
+    }
+
+    // players get their own logs whatever they look at
+    if (GetTypeId() == TYPEID_PLAYER)
+    {
+        WorldSession* session = ((Player const*)this)->GetSession();
+        for (size_t i = 0; i < count; ++i)
+        {
+            SharedWorldPacket shared;
+            session->SendCombatLog(data[i], shared);
+        }
+    }
 }
 
 void Unit::ProcDamageAndSpell(Unit* pVictim, uint32 procAttacker, uint32 procVictim, uint32 procExtra, uint32 amount, WeaponAttackType attType, SpellEntry const* procSpell)
@@ -5461,7 +5586,7 @@ void Unit::SendAttackStateUpdate(CalcDamageInfo* damageInfo)
     data << uint32(0);                                      // spell id, seen with heroic strike and disarm as examples.
     // HITINFO_NOACTION normally set if spell
     data << uint32(damageInfo->blocked_amount);
-    SendMessageToSet(&data, true);  /**/
+    SendCombatLogToSet(&data, damageInfo->target);
 }
 
 void Unit::SendAttackStateUpdate(uint32 HitInfo, Unit* target, SpellSchoolMask damageSchoolMask, uint32 Damage, uint32 AbsorbDamage, uint32 Resist, VictimState TargetState, uint32 BlockedAmount)
@@ -6426,7 +6551,7 @@ void Unit::SendHealSpellLog(Unit* pVictim, uint32 SpellID, uint32 Damage, bool c
     data << uint32(SpellID);
     data << uint32(Damage);
     data << uint8(critical ? 1 : 0);
-    SendMessageToSet(&data, true);
+    SendCombatLogToSet(&data, pVictim);
 }
 
 void Unit::SendEnergizeSpellLog(Unit* pVictim, uint32 SpellID, uint32 Damage, Powers powertype)
@@ -6437,7 +6562,7 @@ void Unit::SendEnergizeSpellLog(Unit* pVictim, uint32 SpellID, uint32 Damage, Po
     data << uint32(SpellID);
     data << uint32(powertype);
     data << uint32(Damage);
-    SendMessageToSet(&data, true);
+    SendCombatLogToSet(&data, pVictim);
 }
 
 void Unit::EnergizeBySpell(Unit* pVictim, uint32 SpellID, uint32 Damage, Powers powertype)
@@ -7686,6 +7811,8 @@ void Unit::SetInCombatState(bool PvP, Unit* enemy)
         return;
     }
 
+    WakeUp();
+
     if (PvP)
     {
         m_CombatTimer = 5000;
@@ -8139,7 +8266,6 @@ void Unit::UpdateVisibilityAndView()
 
             if (!owner || !IsVisibleForOrDetect(owner, this, false))
             {
-                alist.erase(it);
                 RemoveAura(aura);
                 it = alist.begin();
             }
@@ -8472,6 +8598,7 @@ void Unit::AddThreat(Unit* pVictim, float threat /*= 0.0f*/, bool crit /*= false
     // Only mobs can manage threat lists
     if (CanHaveThreatList())
     {
+        WakeUp();
         m_ThreatManager.addThreat(pVictim, threat, crit, schoolMask, threatSpell);
     }
 }
@@ -9013,6 +9140,46 @@ bool Unit::HandleStatModifier(UnitMods unitMod, UnitModifierType modifierType, f
         return false;
     }
 
+    // health and power are read back right away by the aura handlers, never defer them
+    if (m_statUpdateDeferDepth && unitMod != UNIT_MOD_HEALTH && (unitMod < UNIT_MOD_POWER_START || unitMod >= UNIT_MOD_POWER_END))
+    {
+        m_dirtyStatMods |= 1 << unitMod;
+        return true;
+    }
+
+    UpdateStatsForAuraGroup(unitMod);
+    return true;
+}
+
+void Unit::ResumeStatUpdates()
+{
+    MANGOS_ASSERT(m_statUpdateDeferDepth);
+
+    if (--m_statUpdateDeferDepth)
+    {
+        return;
+    }
+
+    uint32 dirty = m_dirtyStatMods;
+    m_dirtyStatMods = 0;
+
+    if (!CanModifyStats())
+    {
+        return;
+    }
+
+    // in UnitMods order, so primary stats are done before the values derived from them
+    for (uint32 i = 0; dirty; ++i, dirty >>= 1)
+    {
+        if (dirty & 1)
+        {
+            UpdateStatsForAuraGroup(UnitMods(i));
+        }
+    }
+}
+
+void Unit::UpdateStatsForAuraGroup(UnitMods unitMod)
+{
     switch (unitMod)
     {
         case UNIT_MOD_STAT_STRENGTH:
@@ -9047,8 +9214,6 @@ bool Unit::HandleStatModifier(UnitMods unitMod, UnitModifierType modifierType, f
         default:
             break;
     }
-
-    return true;
 }
 
 float Unit::GetModifierValue(UnitMods unitMod, UnitModifierType modifierType) const
@@ -9211,6 +9376,12 @@ void Unit::SetHealth(uint32 val)
 
     SetUInt32Value(UNIT_FIELD_HEALTH, val);
 
+    // regeneration needs updates again
+    if (val < maxHealth)
+    {
+        WakeUp();
+    }
+
     // group update
     if (GetTypeId() == TYPEID_PLAYER)
     {
@@ -9286,6 +9457,11 @@ void Unit::SetPower(Powers power, uint32 val)
 
     SetStatInt32Value(UNIT_FIELD_POWER1 + power, val);
 
+    if (val < maxPower)
+    {
+        WakeUp();
+    }
+
     // group update
     if (GetTypeId() == TYPEID_PLAYER)
     {
@@ -9407,7 +9583,10 @@ void Unit::ApplyAuraProcTriggerDamage(Aura* aura, bool apply)
     }
     else
     {
-        tAuraProcTriggerDamage.remove(aura);
+        if (tAuraProcTriggerDamage.remove(aura))
+        {
+            m_modAurasToCompact.push_back(SPELL_AURA_PROC_TRIGGER_DAMAGE);
+        }
     }
 }
 
@@ -9858,26 +10037,39 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* pTarget, uint32 procFlag,
         }
     }
 
+    // none of the auras reacts to this event
+    if (!(procFlag & m_procAuraFlags))
+    {
+        return;
+    }
+
     RemoveSpellList removedSpells;
     ProcTriggeredList procTriggered;
-    // Fill procTriggered list
-    for (SpellAuraHolderMap::const_iterator itr = GetSpellAuraHolderMap().begin(); itr != GetSpellAuraHolderMap().end(); ++itr)
+    // Fill procTriggered list, only holders with a matching proc flag are candidates
+    for (size_t i = 0; i < m_procAuraHolders.size(); ++i)
     {
+        if (!(m_procAuraHolders[i].procFlags & procFlag))
+        {
+            continue;
+        }
+
+        SpellAuraHolder* holder = m_procAuraHolders[i].holder;
+
         // skip deleted auras (possible at recursive triggered call
-        if (itr->second->IsDeleted())
+        if (holder->IsDeleted())
         {
             continue;
         }
 
         SpellProcEventEntry const* spellProcEvent = NULL;
         // check if that aura is triggered by proc event (then it will be managed by proc handler)
-        if (!IsTriggeredAtSpellProcEvent(pTarget, itr->second, procSpell, procFlag, procExtra, attType, isVictim, spellProcEvent))
+        if (!IsTriggeredAtSpellProcEvent(pTarget, holder, procSpell, procFlag, procExtra, attType, isVictim, spellProcEvent))
         {
             continue;
         }
 
-        itr->second->SetInUse(true);                        // prevent holder deletion
-        procTriggered.push_back(ProcTriggeredData(spellProcEvent, itr->second));
+        holder->SetInUse(true);                             // prevent holder deletion
+        procTriggered.push_back(ProcTriggeredData(spellProcEvent, holder));
     }
 
     // Nothing found
@@ -11027,6 +11219,13 @@ void Unit::CleanupDeletedAuras()
         delete *itr;
     }
     m_deletedAuras.clear();
+
+    // no walk over an aura list can be in progress here, so the cleared slots can go
+    for (std::vector<uint32>::const_iterator itr = m_modAurasToCompact.begin(); itr != m_modAurasToCompact.end(); ++itr)
+    {
+        m_modAuras[*itr].compact();
+    }
+    m_modAurasToCompact.clear();
 }
 
 bool Unit::CheckAndIncreaseCastCounter()
@@ -46,6 +46,7 @@
 #include "WorldPacket.h"
 #include "Timer.h"
 #include "Log.h"
+#include "PackedAuraList.h"
 
 #include <list>
 
@@ -1142,8 +1143,9 @@ class Unit : public WorldObject
          * List of \ref Aura used in \ref Unit::GetAurasByType and more and also in the members
          * \ref Unit::m_modAuras and \ref Unit::m_deletedAuras
          * \see Aura
+         * \see PackedAuraList
          */
-        typedef std::list<Aura*> AuraList;
+        typedef PackedAuraList AuraList;
         /**
          * List of \ref DiminishingReturn used for calculation of the same thing.
          * \see DiminishingReturn
@@ -1220,6 +1222,11 @@ class Unit : public WorldObject
 
         void Update(uint32 update_diff, uint32 time) override;
 
+        // true while spline and motion master updates are held back
+        virtual bool IsMotionFrozen() const { return false; }
+        // resume updates of a unit that was taken out of the update for idling
+        virtual void WakeUp() {}
+
         /**
          * Updates the attack time for the given WeaponAttackType
          * @param type The type of weapon that we want to update the time for
@@ -2898,6 +2905,22 @@ class Unit : public WorldObject
          * \todo Is this actually for the combat log?
          */
         void SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo);
+        /**
+         * Sends the periodic aura logs collected during the aura update of this \ref Unit. Ticks
+         * of one caster and spell share a packet, all packets share one walk over the nearby cells.
+         * \see Unit::SendPeriodicAuraLog
+         */
+        void FlushPeriodicAuraLogs();
+        /**
+         * Sends combat log packets of this \ref Unit to the players around, like SendMessageToSet
+         * but held by the sessions until the map update ends when CombatLog.Batching is on.
+         * @param data the packets to send
+         * @param count how many packets data points to
+         * @param target the other side of the logged event, its player always gets the logs, may be NULL
+         * \see WorldSession::SendCombatLog
+         */
+        void SendCombatLogToSet(WorldPacket* const* data, size_t count, Unit const* target) const;
+        void SendCombatLogToSet(WorldPacket* data, Unit const* target) const { SendCombatLogToSet(&data, 1, target); }
         /**
          * Sends some data to the combat log about a spell that missed someone else. For more info
          * on what's sent see \ref OpcodesList::SMSG_SPELLLOGMISS
@@ -3529,6 +3552,9 @@ class Unit : public WorldObject
         Powers GetPowerTypeByAuraGroup(UnitMods unitMod) const;
         bool CanModifyStats() const { return m_canModifyStats; }
         void SetCanModifyStats(bool modifyStats) { m_canModifyStats = modifyStats; }
+        // while deferred HandleStatModifier only marks the changed groups, they are recalculated once when resumed
+        void DeferStatUpdates() { ++m_statUpdateDeferDepth; }
+        void ResumeStatUpdates();
         virtual bool UpdateStats(Stats stat) = 0;
         virtual bool UpdateAllStats() = 0;
         virtual void UpdateResistances(uint32 school) = 0;
@@ -3667,6 +3693,9 @@ class Unit : public WorldObject
         uint32 SpellCriticalHealingBonus(SpellEntry const* spellProto, uint32 damage, Unit* pVictim);
 
         bool IsTriggeredAtSpellProcEvent(Unit* pVictim, SpellAuraHolder* holder, SpellEntry const* procSpell, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, bool isVictim, SpellProcEventEntry const*& spellProcEvent);
+        // keep m_procAuraHolders in step with m_spellAuraHolders
+        void AddProcAuraHolder(SpellAuraHolder* holder);
+        void RemoveProcAuraHolder(SpellAuraHolder* holder);
         // Aura proc handlers
         SpellAuraProcResult HandleDummyAuraProc(Unit* pVictim, uint32 damage, Aura* triggeredByAura, SpellEntry const* procSpell, uint32 procFlag, uint32 procEx, uint32 cooldown);
         SpellAuraProcResult HandleHasteAuraProc(Unit* pVictim, uint32 damage, Aura* triggeredByAura, SpellEntry const* procSpell, uint32 procFlag, uint32 procEx, uint32 cooldown);
@@ -3835,6 +3864,29 @@ protected:
         AuraList m_deletedAuras;                            // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
 
+        // holders of m_spellAuraHolders that can proc at all, in the same order, with the proc flags they react to
+        struct ProcAuraHolderEntry
+        {
+            uint32 spellId;
+            uint32 procFlags;
+            SpellAuraHolder* holder;
+        };
+        typedef std::vector<ProcAuraHolderEntry> ProcAuraHolderList;
+        ProcAuraHolderList m_procAuraHolders;
+        uint32 m_procAuraFlags;                             // union of the procFlags in m_procAuraHolders
+
+        // SMSG_PERIODICAURALOG of ticks on this unit during its aura update, see FlushPeriodicAuraLogs
+        struct PeriodicAuraLogBatch
+        {
+            ObjectGuid casterGuid;
+            uint32 spellId;
+            size_t countPos;                                // position of the aura count in data
+            uint32 count;
+            WorldPacket data;
+        };
+        std::vector<PeriodicAuraLogBatch> m_periodicAuraLogs;
+        bool m_collectPeriodicAuraLogs;
+
         // Store Auras for which the target must be tracked
         TrackedAuraTargetMap m_trackedAuraTargets[MAX_TRACKED_AURA_TYPES];
 
@@ -3848,11 +3900,14 @@ protected:
         uint32 m_transform;
 
         AuraList m_modAuras[TOTAL_AURAS];
+        std::vector<uint32> m_modAurasToCompact;            // aura types with cleared slots in m_modAuras, compacted in CleanupDeletedAuras
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
         float m_weaponDamage[MAX_ATTACK][2];
         WeaponDamageInfo m_weaponDamageInfo;
 
         bool m_canModifyStats;
+        uint32 m_statUpdateDeferDepth;
+        uint32 m_dirtyStatMods;                             // (1 << UnitMods) of groups waiting for ResumeStatUpdates
         // std::list< spellEffectPair > AuraSpells[TOTAL_AURAS];  // TODO: use this if ok for mem
 
         float m_speed_rate[MAX_MOVE_TYPE];
@@ -3860,6 +3915,7 @@ protected:
         CharmInfo* m_charmInfo;
 
         virtual SpellSchoolMask GetMeleeDamageSchoolMask() const;
+        void UpdateStatsForAuraGroup(UnitMods unitMod);
 
         MotionMaster i_motionMaster;
 
@@ -4015,6 +4071,20 @@ bool Unit::CheckAllControlledUnits(Func const& func, uint32 controlledMask) cons
     return false;
 }
 
+/**
+ * Defers the stat recalculation of a unit for the lifetime of the object so a
+ * batch of aura or item changes recalculates every touched group only once.
+ */
+class StatUpdateBatch
+{
+    public:
+        explicit StatUpdateBatch(Unit* unit) : m_unit(unit) { m_unit->DeferStatUpdates(); }
+        ~StatUpdateBatch() { m_unit->ResumeStatUpdates(); }
+
+    private:
+        Unit* m_unit;
+};
+
 /** @} */
 
 #endif
@@ -28,6 +28,11 @@
 #include "Errors.h"
 #include "ByteBuffer.h"
 
+/**
+ * Bit per update field, stored in the same 32 bit blocks the client reads so
+ * that the mask can be written to a packet, copied and combined a block at a
+ * time.
+ */
 class UpdateMask
 {
     public:
@@ -41,30 +46,47 @@ class UpdateMask
 
         UpdateMask() : _fieldCount(0), _blockCount(0), _bits(NULL) { }
 
-        UpdateMask(UpdateMask const& right)
+        UpdateMask(UpdateMask const& right) : _fieldCount(0), _blockCount(0), _bits(NULL)
         {
             SetCount(right.GetCount());
-            memcpy(_bits, right._bits, sizeof(uint8) * _blockCount * 32);
+            memcpy(_bits, right._bits, sizeof(ClientUpdateMaskType) * _blockCount);
         }
 
         ~UpdateMask() { delete[] _bits; }
 
-        void SetBit(uint32 index) { _bits[index] = 1; }
-        void UnsetBit(uint32 index) { _bits[index] = 0; }
-        bool GetBit(uint32 index) const { return _bits[index] != 0; }
+        void SetBit(uint32 index) { _bits[index / CLIENT_UPDATE_MASK_BITS] |= ClientUpdateMaskType(1) << (index % CLIENT_UPDATE_MASK_BITS); }
+        void UnsetBit(uint32 index) { _bits[index / CLIENT_UPDATE_MASK_BITS] &= ~(ClientUpdateMaskType(1) << (index % CLIENT_UPDATE_MASK_BITS)); }
+        bool GetBit(uint32 index) const { return (_bits[index / CLIENT_UPDATE_MASK_BITS] & (ClientUpdateMaskType(1) << (index % CLIENT_UPDATE_MASK_BITS))) != 0; }
+
+        /// Lowest set bit at or above index, GetCount() if there is none
+        uint32 FindNextBit(uint32 index) const
+        {
+            if (index >= _fieldCount)
+            {
+                return _fieldCount;
+            }
+
+            uint32 block = index / CLIENT_UPDATE_MASK_BITS;
+            ClientUpdateMaskType maskPart = _bits[block] & (~ClientUpdateMaskType(0) << (index % CLIENT_UPDATE_MASK_BITS));
+
+            while (!maskPart)
+            {
+                if (++block >= _blockCount)
+                {
+                    return _fieldCount;
+                }
+
+                maskPart = _bits[block];
+            }
+
+            return block * CLIENT_UPDATE_MASK_BITS + LowestSetBit(maskPart);
+        }
 
         void AppendToPacket(ByteBuffer* data)
         {
             for (uint32 i = 0; i < GetBlockCount(); ++i)
             {
-                ClientUpdateMaskType maskPart = 0;
-                for (uint32 j = 0; j < CLIENT_UPDATE_MASK_BITS; ++j)
-                    if (_bits[CLIENT_UPDATE_MASK_BITS * i + j])
-                    {
-                        maskPart |= 1 << j;
-                    }
-
-                *data << maskPart;
+                *data << _bits[i];
             }
         }
 
@@ -78,15 +100,15 @@ class UpdateMask
             _fieldCount = valuesCount;
             _blockCount = (valuesCount + CLIENT_UPDATE_MASK_BITS - 1) / CLIENT_UPDATE_MASK_BITS;
 
-            _bits = new uint8[_blockCount * CLIENT_UPDATE_MASK_BITS];
-            memset(_bits, 0, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
+            _bits = new ClientUpdateMaskType[_blockCount];
+            memset(_bits, 0, sizeof(ClientUpdateMaskType) * _blockCount);
         }
 
         void Clear()
         {
             if (_bits)
             {
-                memset(_bits, 0, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
+                memset(_bits, 0, sizeof(ClientUpdateMaskType) * _blockCount);
             }
         }
 
@@ -98,25 +120,31 @@ class UpdateMask
             }
 
             SetCount(right.GetCount());
-            memcpy(_bits, right._bits, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
+            memcpy(_bits, right._bits, sizeof(ClientUpdateMaskType) * _blockCount);
             return *this;
         }
 
         UpdateMask& operator&=(UpdateMask const& right)
         {
             MANGOS_ASSERT(right.GetCount() <= GetCount());
-            for (uint32 i = 0; i < _fieldCount; ++i)
+            for (uint32 i = 0; i < right._blockCount; ++i)
             {
                 _bits[i] &= right._bits[i];
             }
 
+            // fields past the end of right are not set there
+            for (uint32 i = right._blockCount; i < _blockCount; ++i)
+            {
+                _bits[i] = 0;
+            }
+
             return *this;
         }
 
         UpdateMask& operator|=(UpdateMask const& right)
         {
             MANGOS_ASSERT(right.GetCount() <= GetCount());
-            for (uint32 i = 0; i < _fieldCount; ++i)
+            for (uint32 i = 0; i < right._blockCount; ++i)
             {
                 _bits[i] |= right._bits[i];
             }
@@ -132,8 +160,23 @@ class UpdateMask
         }
 
     private:
+        static uint32 LowestSetBit(ClientUpdateMaskType maskPart)
+        {
+#if defined(__GNUC__)
+            return __builtin_ctz(maskPart);
+#else
+            uint32 index = 0;
+            while (!(maskPart & 1))
+            {
+                maskPart >>= 1;
+                ++index;
+            }
+            return index;
+#endif
+        }
+
         uint32 _fieldCount;
         uint32 _blockCount;
-        uint8* _bits;
+        ClientUpdateMaskType* _bits;
 };
 #endif
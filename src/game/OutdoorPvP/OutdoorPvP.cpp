@@ -67,6 +67,21 @@ void OutdoorPvP::HandlePlayerLeaveZone(Player* player, bool isMainZone)
  */
 void OutdoorPvP::SendUpdateWorldState(uint32 field, uint32 value)
 {
+    // players entering the zone get the current values with the initial world states
+    std::pair<WorldStateValueMap::iterator, bool> res = m_sentWorldStates.insert(WorldStateValueMap::value_type(field, value));
+    if (!res.second)
+    {
+        if (res.first->second == value)
+        {
+            return;
+        }
+        res.first->second = value;
+    }
+
+    WorldPacket data(SMSG_UPDATE_WORLD_STATE, 8);
+    data << field;
+    data << value;
+
     for (GuidZoneMap::const_iterator itr = m_zonePlayers.begin(); itr != m_zonePlayers.end(); ++itr)
     {
         // only send world state update to main zone
@@ -77,7 +92,7 @@ void OutdoorPvP::SendUpdateWorldState(uint32 field, uint32 value)
 
         if (Player* player = sObjectMgr.GetPlayer(itr->first))
         {
-            player->SendUpdateWorldState(field, value);
+            player->GetSession()->SendPacket(&data);
         }
     }
 }
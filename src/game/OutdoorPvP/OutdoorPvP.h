@@ -215,7 +215,7 @@ class OutdoorPvP
         virtual void HandlePlayerKillInsideArea(Player* /*killer*/) {}
 
         /**
-         * @brief send world state update to all players present
+         * @brief send world state update to all players present, if the value changed
          *
          * @param field
          * @param value
@@ -270,6 +270,10 @@ class OutdoorPvP
         void RespawnGO(const WorldObject* objRef, ObjectGuid goGuid, bool respawn);
 
         GuidZoneMap m_zonePlayers; /**< store the players inside the area */
+
+    private:
+        typedef std::map<uint32 /*field*/, uint32 /*value*/> WorldStateValueMap;
+        WorldStateValueMap m_sentWorldStates; /**< last value sent to the zone per world state */
 };
 
 #endif
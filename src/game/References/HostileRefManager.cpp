@@ -28,6 +28,8 @@
 #include "DBCStructure.h"
 #include "SpellMgr.h"
 
+#include <algorithm>
+
 HostileRefManager::HostileRefManager(Unit* pOwner) : iOwner(pOwner)
 {
 }
@@ -150,6 +152,32 @@ void HostileRefManager::deleteReference(Unit* pCreature)
     }
 }
 
+//=================================================
+// delete the references of several Units, calling deleteReference
+// for each of them would walk the whole list once per Unit
+
+void HostileRefManager::deleteReferences(std::vector<Unit*>& pCreatures)
+{
+    if (pCreatures.empty())
+    {
+        return;
+    }
+
+    std::sort(pCreatures.begin(), pCreatures.end());
+
+    HostileReference* ref = getFirst();
+    while (ref)
+    {
+        HostileReference* nextRef = ref->next();
+        if (std::binary_search(pCreatures.begin(), pCreatures.end(), ref->getSource()->getOwner()))
+        {
+            ref->removeReference();
+            delete ref;
+        }
+        ref = nextRef;
+    }
+}
+
 //=================================================
 // set state for one reference, defined by Unit
 
@@ -28,6 +28,8 @@
 #include "Common.h"
 #include "Utilities/LinkedReference/RefManager.h"
 
+#include <vector>
+
 class Unit;
 class ThreatManager;
 class HostileReference;
@@ -69,6 +71,10 @@ class HostileRefManager : public RefManager<Unit, ThreatManager>
         // delete one reference, defined by Unit
         void deleteReference(Unit* pCreature);
 
+        // delete the references of several Units in one walk over the list
+        // the vector is sorted in place
+        void deleteReferences(std::vector<Unit*>& pCreatures);
+
     private:
         Unit* iOwner;                                       // owner of manager variable, back ref. to it, always exist
 };
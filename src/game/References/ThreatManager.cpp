@@ -31,6 +31,8 @@
 #include "ObjectAccessor.h"
 #include "UnitEvents.h"
 
+#include <algorithm>
+
 //==============================================================
 //================= ThreatCalcHelper ===========================
 //==============================================================
@@ -78,6 +80,8 @@ HostileReference::HostileReference(Unit* pUnit, ThreatManager* pThreatManager, f
     iUnitGuid = pUnit->GetObjectGuid();
     iOnline = true;
     iAccessible = true;
+    iHeapIndex = 0;
+    iHeapOrder = 0;
 }
 
 //============================================================
@@ -237,12 +241,188 @@ Unit* HostileReference::getSourceUnit()
 
 void ThreatContainer::clearReferences()
 {
-    for (ThreatList::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
+    for (std::vector<HostileReference*>::const_iterator i = iHeap.begin(); i != iHeap.end(); ++i)
     {
         (*i)->unlink();
         delete(*i);
     }
+    iHeap.clear();
     iThreatList.clear();
+    iDirty = false;
+}
+
+//============================================================
+// Heap order: higher threat first, equal threat in insertion order
+
+bool ThreatContainer::isHigher(HostileReference const* lhs, HostileReference const* rhs)
+{
+    if (lhs->getThreat() != rhs->getThreat())
+    {
+        return lhs->getThreat() > rhs->getThreat();
+    }
+
+    return lhs->iHeapOrder < rhs->iHeapOrder;
+}
+
+void ThreatContainer::place(uint32 index, HostileReference* pRef)
+{
+    iHeap[index] = pRef;
+    pRef->iHeapIndex = index;
+}
+
+void ThreatContainer::siftUp(uint32 index)
+{
+    HostileReference* ref = iHeap[index];
+    while (index > 0)
+    {
+        uint32 parent = (index - 1) / 2;
+        if (!isHigher(ref, iHeap[parent]))
+        {
+            break;
+        }
+
+        place(index, iHeap[parent]);
+        index = parent;
+    }
+    place(index, ref);
+}
+
+void ThreatContainer::siftDown(uint32 index)
+{
+    HostileReference* ref = iHeap[index];
+    uint32 size = iHeap.size();
+    for (;;)
+    {
+        uint32 child = 2 * index + 1;
+        if (child >= size)
+        {
+            break;
+        }
+
+        if (child + 1 < size && isHigher(iHeap[child + 1], iHeap[child]))
+        {
+            ++child;
+        }
+
+        if (!isHigher(iHeap[child], ref))
+        {
+            break;
+        }
+
+        place(index, iHeap[child]);
+        index = child;
+    }
+    place(index, ref);
+}
+
+//============================================================
+
+void ThreatContainer::addReference(HostileReference* pHostileReference)
+{
+    pHostileReference->iHeapOrder = iNextHeapOrder++;
+    iHeap.push_back(pHostileReference);
+    siftUp(iHeap.size() - 1);
+    iDirty = true;
+}
+
+//============================================================
+
+void ThreatContainer::remove(HostileReference* pRef)
+{
+    uint32 index = pRef->iHeapIndex;
+    if (index >= iHeap.size() || iHeap[index] != pRef)
+    {
+        return;                                             // not in this container
+    }
+
+    HostileReference* last = iHeap.back();
+    iHeap.pop_back();
+    if (last != pRef)
+    {
+        place(index, last);
+        update(last);
+    }
+    iDirty = true;
+}
+
+//============================================================
+
+void ThreatContainer::update(HostileReference* pRef)
+{
+    uint32 index = pRef->iHeapIndex;
+    if (index >= iHeap.size() || iHeap[index] != pRef)
+    {
+        return;
+    }
+
+    if (index > 0 && isHigher(pRef, iHeap[(index - 1) / 2]))
+    {
+        siftUp(index);
+    }
+    else
+    {
+        siftDown(index);
+    }
+    iDirty = true;
+}
+
+//============================================================
+
+ThreatList const& ThreatContainer::getThreatList() const
+{
+    if (iDirty)
+    {
+        iThreatList.assign(iHeap.begin(), iHeap.end());
+        std::sort(iThreatList.begin(), iThreatList.end(), isHigher);
+        iDirty = false;
+    }
+
+    return iThreatList;
+}
+
+//============================================================
+// Best first walk over the heap: the open set holds the heap positions whose
+// parents were already visited, kept as a heap itself. Visiting k references
+// costs O(k log k) no matter how long the threat list is.
+
+struct ThreatWalkOrder
+{
+    explicit ThreatWalkOrder(std::vector<HostileReference*> const& heap, bool (*higher)(HostileReference const*, HostileReference const*))
+        : iHeap(heap), iHigher(higher) {}
+
+    bool operator()(uint32 lhs, uint32 rhs) const { return iHigher(iHeap[rhs], iHeap[lhs]); }
+
+    std::vector<HostileReference*> const& iHeap;
+    bool (*iHigher)(HostileReference const*, HostileReference const*);
+};
+
+void ThreatContainer::walkStart()
+{
+    iWalkOpen.clear();
+    if (!iHeap.empty())
+    {
+        iWalkOpen.push_back(0);
+    }
+}
+
+void ThreatContainer::walkNext()
+{
+    ThreatWalkOrder order(iHeap, isHigher);
+
+    std::pop_heap(iWalkOpen.begin(), iWalkOpen.end(), order);
+    uint32 child = 2 * iWalkOpen.back() + 1;
+    iWalkOpen.pop_back();
+
+    for (uint32 last = child + 2; child < last && child < iHeap.size(); ++child)
+    {
+        iWalkOpen.push_back(child);
+        std::push_heap(iWalkOpen.begin(), iWalkOpen.end(), order);
+    }
+}
+
+bool ThreatContainer::walkAtLast() const
+{
+    return iWalkOpen.size() == 1 && 2 * iWalkOpen.front() + 1 >= iHeap.size();
 }
 
 //============================================================
@@ -251,7 +431,7 @@ HostileReference* ThreatContainer::getReferenceByTarget(Unit* pVictim)
 {
     HostileReference* result = NULL;
     ObjectGuid guid = pVictim->GetObjectGuid();
-    for (ThreatList::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
+    for (std::vector<HostileReference*>::const_iterator i = iHeap.begin(); i != iHeap.end(); ++i)
     {
         if ((*i)->getUnitGuid() == guid)
         {
@@ -294,26 +474,6 @@ void ThreatContainer::modifyThreatPercent(Unit* pVictim, int32 pPercent)
     }
 }
 
-//============================================================
-
-bool HostileReferenceSortPredicate(const HostileReference* lhs, const HostileReference* rhs)
-{
-    // std::list::sort ordering predicate must be: (Pred(x,y)&&Pred(y,x))==false
-    return lhs->getThreat() > rhs->getThreat();             // reverse sorting
-}
-
-//============================================================
-// Check if the list is dirty and sort if necessary
-
-void ThreatContainer::update()
-{
-    if (iDirty && iThreatList.size() > 1)
-    {
-        iThreatList.sort(HostileReferenceSortPredicate);
-    }
-    iDirty = false;
-}
-
 //============================================================
 // return the next best victim
 // could be the current victim
@@ -325,12 +485,13 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, Hostile
     bool onlySecondChoiceTargetsFound = false;
     bool checkedCurrentVictim = false;
 
-    ThreatList::const_iterator lastRef = iThreatList.end();
-    --lastRef;
+    // the references come in descending threat order straight from the heap,
+    // normally only the first one or two are looked at
+    walkStart();
 
-    for (ThreatList::const_iterator iter = iThreatList.begin(); iter != iThreatList.end() && !found;)
+    while (!walkDone() && !found)
     {
-        pCurrentRef = (*iter);
+        pCurrentRef = walkCurrent();
 
         Unit* pTarget = pCurrentRef->getTarget();
         MANGOS_ASSERT(pTarget);                             // if the ref has status online the target must be there!
@@ -340,15 +501,15 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, Hostile
         //     This prevents dropping valid targets due to 1.1 or 1.3 threat rule vs invalid current target
         if (!onlySecondChoiceTargetsFound && pAttacker->IsSecondChoiceTarget(pTarget, pCurrentRef == pCurrentVictim))
         {
-            if (iter != lastRef)
+            if (!walkAtLast())
             {
-                ++iter;
+                walkNext();
             }
             else
             {
                 // if we reached to this point, everyone in the threatlist is a second choice target. In such a situation the target with the highest threat should be attacked.
                 onlySecondChoiceTargetsFound = true;
-                iter = iThreatList.begin();
+                walkStart();
             }
 
             // current victim is a second choice target, so don't compare threat with it below
@@ -409,7 +570,7 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, Hostile
                 break;
             }
         }
-        ++iter;
+        walkNext();
     }
     if (!found)
     {
@@ -504,7 +665,6 @@ void ThreatManager::modifyThreatPercent(Unit* pVictim, int32 pPercent)
 
 Unit* ThreatManager::getHostileTarget()
 {
-    iThreatContainer.update();
     HostileReference* nextVictim = iThreatContainer.selectNextVictim((Creature*) getOwner(), getCurrentVictim());
     setCurrentVictim(nextVictim);
     return getCurrentVictim() != NULL ? getCurrentVictim()->getTarget() : NULL;
@@ -574,10 +734,14 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
     switch (threatRefStatusChangeEvent->getType())
     {
         case UEV_THREAT_REF_THREAT_CHANGE:
-            if ((getCurrentVictim() == hostileReference && threatRefStatusChangeEvent->getFValue() < 0.0f) ||
-                (getCurrentVictim() != hostileReference && threatRefStatusChangeEvent->getFValue() > 0.0f))
+            // the order in the threat list might have changed
+            if (hostileReference->isOnline())
             {
-                setDirty(true);                              // the order in the threat list might have changed
+                iThreatContainer.update(hostileReference);
+            }
+            else
+            {
+                iThreatOfflineContainer.update(hostileReference);
             }
             break;
         case UEV_THREAT_REF_ONLINE_STATUS:
@@ -586,26 +750,21 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
                 if (hostileReference == getCurrentVictim())
                 {
                     setCurrentVictim(NULL);
-                    setDirty(true);
                 }
                 iThreatContainer.remove(hostileReference);
                 iThreatOfflineContainer.addReference(hostileReference);
             }
             else
             {
-                if (getCurrentVictim() && hostileReference->getThreat() > (1.1f * getCurrentVictim()->getThreat()))
-                {
-                    setDirty(true);
-                }
-                iThreatContainer.addReference(hostileReference);
+                // removed first, the reference only remembers its place in one container
                 iThreatOfflineContainer.remove(hostileReference);
+                iThreatContainer.addReference(hostileReference);
             }
             break;
         case UEV_THREAT_REF_REMOVE_FROM_LIST:
             if (hostileReference == getCurrentVictim())
             {
                 setCurrentVictim(NULL);
-                setDirty(true);
             }
             if (hostileReference->isOnline())
             {
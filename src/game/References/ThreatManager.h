@@ -30,13 +30,14 @@
 #include "Utilities/LinkedReference/Reference.h"
 #include "UnitEvents.h"
 #include "ObjectGuid.h"
-#include <list>
+#include <vector>
 
 //==============================================================
 
 class Unit;
 class Creature;
 class ThreatManager;
+class ThreatContainer;
 struct SpellEntry;
 
 //==============================================================
@@ -124,6 +125,8 @@ class HostileReference : public Reference<Unit, ThreatManager>
         // Tell our refFrom (source) object, that the link is cut (Target destroyed)
         void sourceObjectDestroyLink() override;
     private:
+        friend class ThreatContainer;
+
         // Inform the source, that the status of that reference was changed
         void fireStatusChanged(ThreatRefStatusChangeEvent& pThreatRefStatusChangeEvent);
     private:
@@ -132,28 +135,48 @@ class HostileReference : public Reference<Unit, ThreatManager>
         ObjectGuid iUnitGuid;
         bool iOnline;
         bool iAccessible;
+        uint32 iHeapIndex;                                  // position in the heap of the container holding the reference
+        uint32 iHeapOrder;                                  // order of insertion into that container, breaks threat ties
 };
 
 //==============================================================
 class ThreatManager;
 
-typedef std::list<HostileReference*> ThreatList;
+typedef std::vector<HostileReference*> ThreatList;
 
+// The references are kept in a binary max heap by threat, so a threat change
+// costs O(log n) and the most hated reference is always at the top. The list
+// sorted by threat is only built when somebody asks for it.
 class ThreatContainer
 {
     private:
-        ThreatList iThreatList;
-        bool iDirty;
+        std::vector<HostileReference*> iHeap;
+        mutable ThreatList iThreatList;                     // iHeap sorted by threat, valid while not dirty
+        mutable bool iDirty;
+        uint32 iNextHeapOrder;
+        std::vector<uint32> iWalkOpen;                      // heap positions still to visit by the ordered walk
+
+        static bool isHigher(HostileReference const* lhs, HostileReference const* rhs);
+        void place(uint32 index, HostileReference* pRef);
+        void siftUp(uint32 index);
+        void siftDown(uint32 index);
+
+        // visit the heap in descending threat order, without sorting all of it
+        void walkStart();
+        void walkNext();
+        bool walkDone() const { return iWalkOpen.empty(); }
+        bool walkAtLast() const;
+        HostileReference* walkCurrent() const { return iHeap[iWalkOpen.front()]; }
     protected:
         friend class ThreatManager;
 
-        void remove(HostileReference* pRef) { iThreatList.remove(pRef); }
-        void addReference(HostileReference* pHostileReference) { iThreatList.push_back(pHostileReference); }
+        void remove(HostileReference* pRef);
+        void addReference(HostileReference* pHostileReference);
         void clearReferences();
-        // Sort the list if necessary
-        void update();
+        // Move the reference to its new place after its threat changed
+        void update(HostileReference* pRef);
     public:
-        ThreatContainer() { iDirty = false; }
+        ThreatContainer() : iDirty(false), iNextHeapOrder(0) {}
         ~ThreatContainer() { clearReferences(); }
 
         HostileReference* addThreat(Unit* pVictim, float pThreat);
@@ -166,13 +189,13 @@ class ThreatContainer
 
         bool isDirty() const { return iDirty; }
 
-        bool empty() const { return(iThreatList.empty()); }
+        bool empty() const { return(iHeap.empty()); }
 
-        HostileReference* getMostHated() { return iThreatList.empty() ? NULL : iThreatList.front(); }
+        HostileReference* getMostHated() { return iHeap.empty() ? NULL : iHeap.front(); }
 
         HostileReference* getReferenceByTarget(Unit* pVictim);
 
-        ThreatList const& getThreatList() const { return iThreatList; }
+        ThreatList const& getThreatList() const;
 };
 
 //=================================================
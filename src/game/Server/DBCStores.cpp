@@ -26,6 +26,8 @@
 #include "Policies/Singleton.h"
 #include "Log.h"
 #include "ProgressBar.h"
+#include "StartupProfiler.h"
+#include "Timer.h"
 #include "SharedDefines.h"
 
 #include "DBCfmt.h"
@@ -186,6 +188,8 @@ inline void LoadDBC(uint32& availableDbcLocales, BarGoLink& bar, StoreProblemLis
     // compatibility format and C++ structure sizes
     MANGOS_ASSERT(DBCFileLoader::GetFormatRecordSize(storage.GetFormat()) == sizeof(T) || LoadDBC_assert_print(DBCFileLoader::GetFormatRecordSize(storage.GetFormat()), sizeof(T), filename));
 
+    uint32 start = getMSTime();
+
     std::string dbc_filename = dbc_path + filename;
     if (storage.Load(dbc_filename.c_str()))
     {
@@ -203,6 +207,8 @@ inline void LoadDBC(uint32& availableDbcLocales, BarGoLink& bar, StoreProblemLis
                 availableDbcLocales &= ~(1 << i); // mark as not available for speedup next checks
             }
         }
+
+        sStartupProfiler.AddLoader(filename.c_str(), getMSTimeDiff(start, getMSTime()), storage.GetNumRows());
     }
     else
     {
@@ -115,7 +115,7 @@ void Opcodes::BuildOpcodeList()
     /*0x034*/  StoreOpcode(CMSG_AUTH_SRP6_PROOF,              "CMSG_AUTH_SRP6_PROOF",             STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     /*0x035*/  StoreOpcode(CMSG_AUTH_SRP6_RECODE,             "CMSG_AUTH_SRP6_RECODE",            STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     /*0x036*/  StoreOpcode(CMSG_CHAR_CREATE,                  "CMSG_CHAR_CREATE",                 STATUS_AUTHED,    PROCESS_THREADUNSAFE, &WorldSession::HandleCharCreateOpcode);
-    /*0x037*/  StoreOpcode(CMSG_CHAR_ENUM,                    "CMSG_CHAR_ENUM",                   STATUS_AUTHED,    PROCESS_THREADUNSAFE, &WorldSession::HandleCharEnumOpcode);
+    /*0x037*/  StoreOpcode(CMSG_CHAR_ENUM,                    "CMSG_CHAR_ENUM",                   STATUS_AUTHED,    PROCESS_SESSIONSAFE,  &WorldSession::HandleCharEnumOpcode);
     /*0x038*/  StoreOpcode(CMSG_CHAR_DELETE,                  "CMSG_CHAR_DELETE",                 STATUS_AUTHED,    PROCESS_THREADUNSAFE, &WorldSession::HandleCharDeleteOpcode);
     /*0x039*/  StoreOpcode(SMSG_AUTH_SRP6_RESPONSE,           "SMSG_AUTH_SRP6_RESPONSE",          STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*0x03A*/  StoreOpcode(SMSG_CHAR_CREATE,                  "SMSG_CHAR_CREATE",                 STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
@@ -140,19 +140,19 @@ void Opcodes::BuildOpcodeList()
     /*0x04D*/  StoreOpcode(SMSG_LOGOUT_COMPLETE,              "SMSG_LOGOUT_COMPLETE",             STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*[-ZERO] Need check */ /*0x04E*/  StoreOpcode(CMSG_LOGOUT_CANCEL,                "CMSG_LOGOUT_CANCEL",               STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleLogoutCancelOpcode);
     /*0x04F*/  StoreOpcode(SMSG_LOGOUT_CANCEL_ACK,            "SMSG_LOGOUT_CANCEL_ACK",           STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    /*[-ZERO] Need check */ /*0x050*/  StoreOpcode(CMSG_NAME_QUERY,                   "CMSG_NAME_QUERY",                  STATUS_AUTHED,    PROCESS_THREADUNSAFE, &WorldSession::HandleNameQueryOpcode);
+    /*[-ZERO] Need check */ /*0x050*/  StoreOpcode(CMSG_NAME_QUERY,                   "CMSG_NAME_QUERY",                  STATUS_AUTHED,    PROCESS_SESSIONSAFE,  &WorldSession::HandleNameQueryOpcode);
     /*0x051*/  StoreOpcode(SMSG_NAME_QUERY_RESPONSE,          "SMSG_NAME_QUERY_RESPONSE",         STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*[-ZERO] Need check */ /*0x052*/  StoreOpcode(CMSG_PET_NAME_QUERY,               "CMSG_PET_NAME_QUERY",              STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandlePetNameQueryOpcode);
     /*0x053*/  StoreOpcode(SMSG_PET_NAME_QUERY_RESPONSE,      "SMSG_PET_NAME_QUERY_RESPONSE",     STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    /*[-ZERO] Need check */ /*0x054*/  StoreOpcode(CMSG_GUILD_QUERY,                  "CMSG_GUILD_QUERY",                 STATUS_AUTHED,    PROCESS_THREADUNSAFE, &WorldSession::HandleGuildQueryOpcode);
+    /*[-ZERO] Need check */ /*0x054*/  StoreOpcode(CMSG_GUILD_QUERY,                  "CMSG_GUILD_QUERY",                 STATUS_AUTHED,    PROCESS_SESSIONSAFE,  &WorldSession::HandleGuildQueryOpcode);
     /*0x055*/  StoreOpcode(SMSG_GUILD_QUERY_RESPONSE,         "SMSG_GUILD_QUERY_RESPONSE",        STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*0x056*/  StoreOpcode(CMSG_ITEM_QUERY_SINGLE,            "CMSG_ITEM_QUERY_SINGLE",           STATUS_LOGGEDIN,  PROCESS_INPLACE,      &WorldSession::HandleItemQuerySingleOpcode);
     /*0x057*/  StoreOpcode(CMSG_ITEM_QUERY_MULTIPLE,          "CMSG_ITEM_QUERY_MULTIPLE",         STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     /*0x058*/  StoreOpcode(SMSG_ITEM_QUERY_SINGLE_RESPONSE,   "SMSG_ITEM_QUERY_SINGLE_RESPONSE",  STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*0x059*/  StoreOpcode(SMSG_ITEM_QUERY_MULTIPLE_RESPONSE, "SMSG_ITEM_QUERY_MULTIPLE_RESPONSE", STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    /*[-ZERO] Need check */ /*0x05A*/  StoreOpcode(CMSG_PAGE_TEXT_QUERY,              "CMSG_PAGE_TEXT_QUERY",             STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandlePageTextQueryOpcode);
+    /*[-ZERO] Need check */ /*0x05A*/  StoreOpcode(CMSG_PAGE_TEXT_QUERY,              "CMSG_PAGE_TEXT_QUERY",             STATUS_LOGGEDIN,  PROCESS_SESSIONSAFE,  &WorldSession::HandlePageTextQueryOpcode);
     /*0x05B*/  StoreOpcode(SMSG_PAGE_TEXT_QUERY_RESPONSE,     "SMSG_PAGE_TEXT_QUERY_RESPONSE",    STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    /*[-ZERO] Need check */ /*0x05C*/  StoreOpcode(CMSG_QUEST_QUERY,                  "CMSG_QUEST_QUERY",                 STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleQuestQueryOpcode);
+    /*[-ZERO] Need check */ /*0x05C*/  StoreOpcode(CMSG_QUEST_QUERY,                  "CMSG_QUEST_QUERY",                 STATUS_LOGGEDIN,  PROCESS_SESSIONSAFE,  &WorldSession::HandleQuestQueryOpcode);
     /*0x05D*/  StoreOpcode(SMSG_QUEST_QUERY_RESPONSE,         "SMSG_QUEST_QUERY_RESPONSE",        STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*[-ZERO] Need check */ /*0x05E*/  StoreOpcode(CMSG_GAMEOBJECT_QUERY,             "CMSG_GAMEOBJECT_QUERY",            STATUS_LOGGEDIN,  PROCESS_INPLACE,      &WorldSession::HandleGameObjectQueryOpcode);
     /*0x05F*/  StoreOpcode(SMSG_GAMEOBJECT_QUERY_RESPONSE,    "SMSG_GAMEOBJECT_QUERY_RESPONSE",   STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
@@ -314,9 +314,9 @@ void Opcodes::BuildOpcodeList()
     /*0x0FB*/  StoreOpcode(CMSG_NEXT_CINEMATIC_CAMERA,        "CMSG_NEXT_CINEMATIC_CAMERA",       STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleNextCinematicCamera);
     /*0x0FC*/  StoreOpcode(CMSG_COMPLETE_CINEMATIC,           "CMSG_COMPLETE_CINEMATIC",          STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleCompleteCinematic);
     /*0x0FD*/  StoreOpcode(SMSG_TUTORIAL_FLAGS,               "SMSG_TUTORIAL_FLAGS",              STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    /*0x0FE*/  StoreOpcode(CMSG_TUTORIAL_FLAG,                "CMSG_TUTORIAL_FLAG",               STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleTutorialFlagOpcode);
-    /*0x0FF*/  StoreOpcode(CMSG_TUTORIAL_CLEAR,               "CMSG_TUTORIAL_CLEAR",              STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleTutorialClearOpcode);
-    /*0x100*/  StoreOpcode(CMSG_TUTORIAL_RESET,               "CMSG_TUTORIAL_RESET",              STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleTutorialResetOpcode);
+    /*0x0FE*/  StoreOpcode(CMSG_TUTORIAL_FLAG,                "CMSG_TUTORIAL_FLAG",               STATUS_LOGGEDIN,  PROCESS_SESSIONSAFE,  &WorldSession::HandleTutorialFlagOpcode);
+    /*0x0FF*/  StoreOpcode(CMSG_TUTORIAL_CLEAR,               "CMSG_TUTORIAL_CLEAR",              STATUS_LOGGEDIN,  PROCESS_SESSIONSAFE,  &WorldSession::HandleTutorialClearOpcode);
+    /*0x100*/  StoreOpcode(CMSG_TUTORIAL_RESET,               "CMSG_TUTORIAL_RESET",              STATUS_LOGGEDIN,  PROCESS_SESSIONSAFE,  &WorldSession::HandleTutorialResetOpcode);
     /*0x101*/  StoreOpcode(CMSG_STANDSTATECHANGE,             "CMSG_STANDSTATECHANGE",            STATUS_LOGGEDIN,  PROCESS_THREADSAFE,   &WorldSession::HandleStandStateChangeOpcode);
     /*[-ZERO] Need check */ /*0x102*/  StoreOpcode(CMSG_EMOTE,                        "CMSG_EMOTE",                       STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleEmoteOpcode);
     /*0x103*/  StoreOpcode(SMSG_EMOTE,                        "SMSG_EMOTE",                       STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
@@ -580,8 +580,8 @@ void Opcodes::BuildOpcodeList()
     /*[-ZERO] Need check */ /*0x207*/  StoreOpcode(CMSG_GMTICKET_UPDATETEXT,          "CMSG_GMTICKET_UPDATETEXT",         STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleGMTicketUpdateTextOpcode);
     /*0x208*/  StoreOpcode(SMSG_GMTICKET_UPDATETEXT,          "SMSG_GMTICKET_UPDATETEXT",         STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*[-ZERO] Need check */ /*0x209*/  StoreOpcode(SMSG_ACCOUNT_DATA_TIMES,           "SMSG_ACCOUNT_DATA_TIMES",          STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    /*[-ZERO] Need check */ /*0x20A*/  StoreOpcode(CMSG_REQUEST_ACCOUNT_DATA,         "CMSG_REQUEST_ACCOUNT_DATA",        STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleRequestAccountData);
-    /*[-ZERO] Need check */ /*0x20B*/  StoreOpcode(CMSG_UPDATE_ACCOUNT_DATA,          "CMSG_UPDATE_ACCOUNT_DATA",         STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT, PROCESS_THREADUNSAFE, &WorldSession::HandleUpdateAccountData);
+    /*[-ZERO] Need check */ /*0x20A*/  StoreOpcode(CMSG_REQUEST_ACCOUNT_DATA,         "CMSG_REQUEST_ACCOUNT_DATA",        STATUS_LOGGEDIN,  PROCESS_SESSIONSAFE,  &WorldSession::HandleRequestAccountData);
+    /*[-ZERO] Need check */ /*0x20B*/  StoreOpcode(CMSG_UPDATE_ACCOUNT_DATA,          "CMSG_UPDATE_ACCOUNT_DATA",         STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT, PROCESS_SESSIONSAFE,  &WorldSession::HandleUpdateAccountData);
     /*0x20C*/  StoreOpcode(SMSG_UPDATE_ACCOUNT_DATA,          "SMSG_UPDATE_ACCOUNT_DATA",         STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*0x20D*/  StoreOpcode(SMSG_CLEAR_FAR_SIGHT_IMMEDIATE,    "SMSG_CLEAR_FAR_SIGHT_IMMEDIATE",   STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*[-ZERO] Need check */ /*0x20E*/  StoreOpcode(SMSG_POWERGAINLOG_OBSOLETE,        "SMSG_POWERGAINLOG_OBSOLETE",       STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
@@ -637,7 +637,7 @@ void Opcodes::BuildOpcodeList()
     /*0x240*/  StoreOpcode(SMSG_BATTLEFIELD_LOSE_OBSOLETE,    "SMSG_BATTLEFIELD_LOSE_OBSOLETE",   STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*0x241*/  StoreOpcode(CMSG_TAXICLEARNODE,                "CMSG_TAXICLEARNODE",               STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     /*0x242*/  StoreOpcode(CMSG_TAXIENABLENODE,               "CMSG_TAXIENABLENODE",              STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_NULL);
-    /*[-ZERO] Need check */ /*0x243*/  StoreOpcode(CMSG_ITEM_TEXT_QUERY,              "CMSG_ITEM_TEXT_QUERY",             STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleItemTextQuery);
+    /*[-ZERO] Need check */ /*0x243*/  StoreOpcode(CMSG_ITEM_TEXT_QUERY,              "CMSG_ITEM_TEXT_QUERY",             STATUS_LOGGEDIN,  PROCESS_SESSIONSAFE,  &WorldSession::HandleItemTextQuery);
     /*0x244*/  StoreOpcode(SMSG_ITEM_TEXT_QUERY_RESPONSE,     "SMSG_ITEM_TEXT_QUERY_RESPONSE",    STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*0x245*/  StoreOpcode(CMSG_MAIL_TAKE_MONEY,              "CMSG_MAIL_TAKE_MONEY",             STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleMailTakeMoney);
     /*0x246*/  StoreOpcode(CMSG_MAIL_TAKE_ITEM,               "CMSG_MAIL_TAKE_ITEM",              STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleMailTakeItem);
@@ -702,7 +702,7 @@ void Opcodes::BuildOpcodeList()
     /*0x281*/  StoreOpcode(CMSG_RESET_FACTION_CHEAT,          "CMSG_RESET_FACTION_CHEAT",         STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     /*[-ZERO] Need check */ /*0x282*/  StoreOpcode(CMSG_AUTOSTORE_BANK_ITEM,          "CMSG_AUTOSTORE_BANK_ITEM",         STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleAutoStoreBankItemOpcode);
     /*[-ZERO] Need check */ /*0x283*/  StoreOpcode(CMSG_AUTOBANK_ITEM,                "CMSG_AUTOBANK_ITEM",               STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleAutoBankItemOpcode);
-    /*0x284*/  StoreOpcode(MSG_QUERY_NEXT_MAIL_TIME,          "MSG_QUERY_NEXT_MAIL_TIME",         STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleQueryNextMailTime);
+    /*0x284*/  StoreOpcode(MSG_QUERY_NEXT_MAIL_TIME,          "MSG_QUERY_NEXT_MAIL_TIME",         STATUS_LOGGEDIN,  PROCESS_SESSIONSAFE,  &WorldSession::HandleQueryNextMailTime);
     /*0x285*/  StoreOpcode(SMSG_RECEIVED_MAIL,                "SMSG_RECEIVED_MAIL",               STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*0x286*/  StoreOpcode(SMSG_RAID_GROUP_ONLY,              "SMSG_RAID_GROUP_ONLY",             STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*0x287*/  StoreOpcode(CMSG_SET_DURABILITY_CHEAT,         "CMSG_SET_DURABILITY_CHEAT",        STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_NULL);
@@ -766,7 +766,7 @@ void Opcodes::BuildOpcodeList()
     /*0x2C1*/  StoreOpcode(MSG_PETITION_RENAME,               "MSG_PETITION_RENAME",              STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandlePetitionRenameOpcode);
     /*0x2C2*/  StoreOpcode(SMSG_INIT_WORLD_STATES,            "SMSG_INIT_WORLD_STATES",           STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*0x2C3*/  StoreOpcode(SMSG_UPDATE_WORLD_STATE,           "SMSG_UPDATE_WORLD_STATE",          STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    /*[-ZERO] Need check */ /*0x2C4*/  StoreOpcode(CMSG_ITEM_NAME_QUERY,              "CMSG_ITEM_NAME_QUERY",             STATUS_LOGGEDIN,  PROCESS_THREADUNSAFE, &WorldSession::HandleItemNameQueryOpcode);
+    /*[-ZERO] Need check */ /*0x2C4*/  StoreOpcode(CMSG_ITEM_NAME_QUERY,              "CMSG_ITEM_NAME_QUERY",             STATUS_LOGGEDIN,  PROCESS_SESSIONSAFE,  &WorldSession::HandleItemNameQueryOpcode);
     /*0x2C5*/  StoreOpcode(SMSG_ITEM_NAME_QUERY_RESPONSE,     "SMSG_ITEM_NAME_QUERY_RESPONSE",    STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*0x2C6*/  StoreOpcode(SMSG_PET_ACTION_FEEDBACK,          "SMSG_PET_ACTION_FEEDBACK",         STATUS_NEVER,     PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     /*[-ZERO] Need check */ /*0x2C7*/  StoreOpcode(CMSG_CHAR_RENAME,                  "CMSG_CHAR_RENAME",                 STATUS_AUTHED,    PROCESS_THREADUNSAFE, &WorldSession::HandleCharRenameOpcode);
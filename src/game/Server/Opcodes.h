@@ -982,12 +982,14 @@ enum SessionStatus
  * same function as we received it in, this is unusual, or it can be in:
  * - \ref World::UpdateSessions if it's not thread safe
  * - \ref Map::Update if it is thread safe
+ * - the parallel phase of \ref World::UpdateSessions if it only touches its own session
  */
 enum PacketProcessing
 {
     PROCESS_INPLACE = 0,   ///< process packet whenever we receive it - mostly for non-handled or non-implemented packets
     PROCESS_THREADUNSAFE,  ///< packet is not thread-safe - process it in \ref World::UpdateSessions
-    PROCESS_THREADSAFE     ///< packet is thread-safe - process it in \ref Map::Update
+    PROCESS_THREADSAFE,    ///< packet is thread-safe - process it in \ref Map::Update
+    PROCESS_SESSIONSAFE    ///< packet only changes its own session/player and reads static data - process it in \ref World::UpdateSessions, possibly in parallel with other sessions
 };
 
 class WorldPacket;
@@ -0,0 +1,65 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "SessionAccounting.h"
+
+void SessionTraffic::Add(SessionTraffic const& other)
+{
+    handlerUs += other.handlerUs;
+    packetsIn += other.packetsIn;
+    bytesIn += other.bytesIn;
+    packetsOut += other.packetsOut;
+    bytesOut += other.bytesOut;
+    sendQueuePeak = std::max(sendQueuePeak, other.sendQueuePeak);
+    sessions += other.sessions;
+}
+
+void SessionAccounting::UpdateSendQueuePeak(uint32 queued)
+{
+    uint32 peak = m_sendQueuePeak.load(std::memory_order_relaxed);
+    while (queued > peak && !m_sendQueuePeak.compare_exchange_weak(peak, queued, std::memory_order_relaxed))
+    {
+    }
+}
+
+void SessionAccounting::Get(SessionTraffic& traffic) const
+{
+    traffic.handlerUs = m_handlerUs.load(std::memory_order_relaxed);
+    traffic.packetsIn = m_packetsIn.load(std::memory_order_relaxed);
+    traffic.bytesIn = m_bytesIn.load(std::memory_order_relaxed);
+    traffic.packetsOut = m_packetsOut.load(std::memory_order_relaxed);
+    traffic.bytesOut = m_bytesOut.load(std::memory_order_relaxed);
+    traffic.sendQueuePeak = m_sendQueuePeak.load(std::memory_order_relaxed);
+    traffic.sessions = 1;
+}
+
+void SessionAccounting::Reset()
+{
+    m_handlerUs.store(0, std::memory_order_relaxed);
+    m_packetsIn.store(0, std::memory_order_relaxed);
+    m_bytesIn.store(0, std::memory_order_relaxed);
+    m_packetsOut.store(0, std::memory_order_relaxed);
+    m_bytesOut.store(0, std::memory_order_relaxed);
+    m_sendQueuePeak.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,90 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_SESSION_ACCOUNTING
+#define MANGOS_H_SESSION_ACCOUNTING
+
+#include "Common.h"
+
+#include <atomic>
+
+/// Resource use of a session or of all sessions of an account, see SessionAccounting
+struct SessionTraffic
+{
+    SessionTraffic() : handlerUs(0), packetsIn(0), bytesIn(0), packetsOut(0), bytesOut(0), sendQueuePeak(0), sessions(0) {}
+
+    /// Sums the counters, the send queue peak is the higher one
+    void Add(SessionTraffic const& other);
+
+    uint64 handlerUs;                                       ///< time spent in opcode handlers (OpcodePerf)
+    uint64 packetsIn;                                       ///< packets received, handled by the session
+    uint64 bytesIn;                                         ///< their payload bytes
+    uint64 packetsOut;                                      ///< packets sent
+    uint64 bytesOut;                                        ///< their payload bytes
+    uint32 sendQueuePeak;                                   ///< most packets waiting behind the socket output buffer
+    uint32 sessions;                                        ///< sessions summed up
+};
+
+/**
+ * @brief Cumulative counters of one session
+ *
+ * Written by the network thread receiving for the session, by the threads running
+ * its handlers and by every thread sending to it, hence the relaxed atomics. Read
+ * by the world thread for .server perf accounts and the SessionAccounting.* checks.
+ */
+class SessionAccounting
+{
+    public:
+        SessionAccounting() : m_handlerUs(0), m_packetsIn(0), m_bytesIn(0), m_packetsOut(0), m_bytesOut(0), m_sendQueuePeak(0) {}
+
+        void AddPacketIn(size_t bytes)
+        {
+            m_packetsIn.fetch_add(1, std::memory_order_relaxed);
+            m_bytesIn.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        void AddPacketOut(size_t bytes)
+        {
+            m_packetsOut.fetch_add(1, std::memory_order_relaxed);
+            m_bytesOut.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        /// Handler times are added by OpcodeUpdateTimer
+        std::atomic<uint64>& GetHandlerTime() { return m_handlerUs; }
+
+        void UpdateSendQueuePeak(uint32 queued);
+
+        void Get(SessionTraffic& traffic) const;
+        void Reset();
+
+    private:
+        std::atomic<uint64> m_handlerUs;
+        std::atomic<uint64> m_packetsIn;
+        std::atomic<uint64> m_bytesIn;
+        std::atomic<uint64> m_packetsOut;
+        std::atomic<uint64> m_bytesOut;
+        std::atomic<uint32> m_sendQueuePeak;
+};
+
+#endif
@@ -42,6 +42,10 @@
 #include "ObjectAccessor.h"
 #include "BattleGround/BattleGroundMgr.h"
 #include "SocialMgr.h"
+#include "WorldSocketMgr.h"
+#include "UpdateTime.h"
+#include "TickRecorder.h"
+#include "CharEnumCache.h"
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
 #endif /* ENABLE_ELUNA */
@@ -56,8 +60,8 @@
 // select opcodes appropriate for processing in Map::Update context for current session state
 static bool MapSessionFilterHelper(WorldSession* session, OpcodeHandler const& opHandle)
 {
-    // we do not process thread-unsafe packets
-    if (opHandle.packetProcessing == PROCESS_THREADUNSAFE)
+    // we do not process thread-unsafe packets, session-safe ones belong to World::UpdateSessions()
+    if (opHandle.packetProcessing == PROCESS_THREADUNSAFE || opHandle.packetProcessing == PROCESS_SESSIONSAFE)
     {
         return false;
     }
@@ -101,13 +105,19 @@ bool WorldSessionFilter::Process(WorldPacket* packet)
     return !MapSessionFilterHelper(m_pSession, opHandle);
 }
 
+// in-place packets are left to the serial pass, we do not know what they touch
+bool SessionSafeFilter::Process(WorldPacket* packet)
+{
+    return opcodeTable[packet->GetOpcode()].packetProcessing == PROCESS_SESSIONSAFE;
+}
+
 /// WorldSession constructor
 WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, time_t mute_time, LocaleConstant locale) :
     m_muteTime(mute_time),
     _player(NULL), m_Socket(sock), _security(sec), _accountId(id), _warden(NULL), _build(0), _logoutTime(0),
-    m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
+    m_inQueue(false), m_charEnumRequested(false), m_charEnumOrderingKey(0), m_queueSequence(0), m_queuePosition(0), m_offline(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetIndexForLocale(locale)),
-    m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED)
+    m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED), m_hasCombatLogs(false)
 {
     if (sock)
     {
@@ -128,11 +138,16 @@ WorldSession::~WorldSession()
     /// - If have unclosed socket, close it
     if (m_Socket)
     {
+        m_accounting.UpdateSendQueuePeak(m_Socket->GetSendQueuePeak());
         m_Socket->CloseSocket();
         m_Socket->RemoveReference();
         m_Socket = NULL;
     }
 
+    SessionTraffic traffic;
+    m_accounting.Get(traffic);
+    sWorld.AddClosedSessionTraffic(GetAccountId(), traffic);
+
     // Warden
     if (_warden)
     {
@@ -141,7 +156,7 @@ WorldSession::~WorldSession()
 
     ///- empty incoming packet queue
     WorldPacket* packet = NULL;
-    while (_recvQueue.next(packet))
+    while (NextPacket(packet))
     {
         delete packet;
     }
@@ -159,8 +174,31 @@ char const* WorldSession::GetPlayerName() const
     return GetPlayer() ? GetPlayer()->GetName() : "<none>";
 }
 
+bool WorldSession::IsPacketWanted(uint16 opcode) const
+{
+    if (m_Socket)
+    {
+        return true;
+    }
+
+#ifdef ENABLE_PLAYERBOTS
+    if (GetPlayer() && GetPlayer()->GetPlayerbotAI())
+    {
+        return GetPlayer()->GetPlayerbotAI()->IsBotOutgoingPacketHandled(opcode);
+    }
+#endif
+
+    return false;
+}
+
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet)
+{
+    SharedWorldPacket shared;
+    SendPacket(packet, shared);
+}
+
+void WorldSession::SendPacket(WorldPacket const* packet, SharedWorldPacket& shared)
 {
 #ifdef ENABLE_PLAYERBOTS
     if (GetPlayer()) {
@@ -180,6 +218,14 @@ void WorldSession::SendPacket(WorldPacket const* packet)
         return;
     }
 
+    // held combat logs were built before this packet
+    if (m_hasCombatLogs.load(std::memory_order_relaxed))
+    {
+        FlushCombatLogs();
+    }
+
+    m_accounting.AddPacketOut(packet->size());
+
 #ifdef MANGOS_DEBUG
 
     // Code for network use statistic
@@ -216,18 +262,147 @@ void WorldSession::SendPacket(WorldPacket const* packet)
 
 #endif                                                  // !MANGOS_DEBUG
 
-    if (m_Socket->SendPacket(*packet) == -1)
+    int result;
+    if (shared)
+    {
+        result = m_Socket->SendPacket(shared);
+    }
+    else if (sWorldSocketMgr->GetOutRingSize())
+    {
+        // the ring keeps a copy anyway, made once here for all later receivers of a broadcast
+        shared = std::make_shared<WorldPacket const>(*packet);
+        result = m_Socket->SendPacket(shared);
+    }
+    else
+    {
+        result = m_Socket->SendPacket(*packet);
+    }
+
+    if (result == -1)
     {
         m_Socket->CloseSocket();
     }
 }
 
-/// Add an incoming packet to the queue
+void WorldSession::SendCombatLog(WorldPacket const* packet, SharedWorldPacket& shared)
+{
+    bool hold = m_Socket && sWorld.getConfig(CONFIG_BOOL_COMBAT_LOG_BATCHING);
+
+#ifdef ENABLE_PLAYERBOTS
+    // the bot master hook has to see every packet as it is sent
+    if (GetPlayer() && GetPlayer()->GetPlayerbotMgr())
+    {
+        hold = false;
+    }
+#endif
+
+    if (!hold)
+    {
+        SendPacket(packet, shared);
+        return;
+    }
+
+    if (!shared)
+    {
+        shared = std::make_shared<WorldPacket const>(*packet);
+    }
+
+    m_accounting.AddPacketOut(packet->size());
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_combatLogLock);
+    m_combatLogs.push_back(shared);
+    m_hasCombatLogs.store(true, std::memory_order_relaxed);
+}
+
+void WorldSession::FlushCombatLogs()
+{
+    if (!m_hasCombatLogs.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    std::vector<SharedWorldPacket> logs;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_combatLogLock);
+        logs.swap(m_combatLogs);
+        m_hasCombatLogs.store(false, std::memory_order_relaxed);
+    }
+
+    if (m_Socket && m_Socket->SendPackets(logs) == -1)
+    {
+        m_Socket->CloseSocket();
+    }
+}
+
+/// Add a packet generated by the server to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
+    _injectedQueue.add(new_packet);
+}
+
+/// Add an incoming packet to the queue
+void WorldSession::QueueIncomingPacket(WorldPacket* new_packet)
+{
+    m_accounting.AddPacketIn(new_packet->size());
     _recvQueue.add(new_packet);
 }
 
+void WorldSession::GetTraffic(SessionTraffic& traffic) const
+{
+    m_accounting.Get(traffic);
+
+    if (m_Socket)
+    {
+        traffic.sendQueuePeak = std::max(traffic.sendQueuePeak, m_Socket->GetSendQueuePeak());
+    }
+}
+
+void WorldSession::GetTrafficSinceLastCheck(SessionTraffic& delta)
+{
+    // a peak reached between reading and resetting it is lost, fine for spotting outliers
+    uint32 sendQueuePeak = 0;
+    if (m_Socket)
+    {
+        sendQueuePeak = m_Socket->GetSendQueuePeak();
+        m_Socket->ResetSendQueuePeak();
+        m_accounting.UpdateSendQueuePeak(sendQueuePeak);
+    }
+
+    SessionTraffic traffic;
+    m_accounting.Get(traffic);
+
+    delta.handlerUs = traffic.handlerUs - m_lastTrafficCheck.handlerUs;
+    delta.packetsIn = traffic.packetsIn - m_lastTrafficCheck.packetsIn;
+    delta.bytesIn = traffic.bytesIn - m_lastTrafficCheck.bytesIn;
+    delta.packetsOut = traffic.packetsOut - m_lastTrafficCheck.packetsOut;
+    delta.bytesOut = traffic.bytesOut - m_lastTrafficCheck.bytesOut;
+    delta.sendQueuePeak = sendQueuePeak;
+    delta.sessions = 1;
+
+    m_lastTrafficCheck = traffic;
+}
+
+void WorldSession::ResetTraffic()
+{
+    m_accounting.Reset();
+    m_lastTrafficCheck = SessionTraffic();
+
+    if (m_Socket)
+    {
+        m_Socket->ResetSendQueuePeak();
+    }
+}
+
+bool WorldSession::NextPacket(WorldPacket*& packet)
+{
+    return _recvQueue.next(packet) || _injectedQueue.next(packet);
+}
+
+bool WorldSession::NextPacket(WorldPacket*& packet, PacketFilter& updater)
+{
+    return _recvQueue.next(packet, updater) || _injectedQueue.next(packet, updater);
+}
+
 /// Logging helper for unexpected opcodes
 void WorldSession::LogUnexpectedOpcode(WorldPacket* packet, const char* reason)
 {
@@ -247,12 +422,77 @@ void WorldSession::LogUnprocessedTail(WorldPacket* packet)
 }
 
 bool WorldSession::Update(PacketFilter& updater)
+{
+    ProcessPackets(updater);
+
+#ifdef ENABLE_PLAYERBOTS
+    if (GetPlayer() && GetPlayer()->GetPlayerbotMgr())
+    {
+        GetPlayer()->GetPlayerbotMgr()->UpdateSessions(0);
+    }
+#endif
+
+    // logs held for a player that left its map before the map flushed them
+    FlushCombatLogs();
+
+    ///- Cleanup socket pointer if need
+    if (m_Socket && m_Socket->IsClosed())
+    {
+        m_accounting.UpdateSendQueuePeak(m_Socket->GetSendQueuePeak());
+        m_Socket->RemoveReference();
+        m_Socket = NULL;
+    }
+
+    // Warden
+    if (m_Socket && !m_Socket->IsClosed() && _warden)
+    {
+        _warden->Update();
+    }
+
+    // check if we are safe to proceed with logout
+    // logout procedure should happen only in World::UpdateSessions() method!!!
+    if (updater.ProcessLogout())
+    {
+        ///- If necessary, log the player out
+        time_t currTime = time(NULL);
+        if ((!m_Socket && !m_offline) || (ShouldLogOut(currTime) && !m_playerLoading))
+        {
+            LogoutPlayer(true);
+        }
+
+        // Warden
+        if (m_Socket && GetPlayer() && _warden)
+        {
+            _warden->Update();
+        }
+
+        if (!m_Socket && !m_offline)
+        {
+            return false;                                    // Will remove this session from the world session map
+        }
+    }
+
+    return true;
+}
+
+void WorldSession::UpdateSessionSafe()
+{
+    SessionSafeFilter updater(this);
+    ProcessPackets(updater);
+}
+
+void WorldSession::ProcessPackets(PacketFilter& updater)
 {
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
     WorldPacket* packet = NULL;
-    while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet, updater))
+    while ((m_Socket ? !m_Socket->IsClosed() : m_offline) && NextPacket(packet, updater))
     {
+        if (sTickRecorder.IsActive())
+        {
+            sTickRecorder.PacketHandled(this, packet);
+        }
+
         /*#if 1
         sLog.outError( "MOEP: %s (0x%.4X)",
                         packet->GetOpcodeName(),
@@ -364,58 +604,13 @@ bool WorldSession::Update(PacketFilter& updater)
 
         delete packet;
     }
-
-#ifdef ENABLE_PLAYERBOTS
-    if (GetPlayer() && GetPlayer()->GetPlayerbotMgr())
-    {
-        GetPlayer()->GetPlayerbotMgr()->UpdateSessions(0);
-    }
-#endif
-
-    ///- Cleanup socket pointer if need
-    if (m_Socket && m_Socket->IsClosed())
-    {
-        m_Socket->RemoveReference();
-        m_Socket = NULL;
-    }
-
-    // Warden
-    if (m_Socket && !m_Socket->IsClosed() && _warden)
-    {
-        _warden->Update();
-    }
-
-    // check if we are safe to proceed with logout
-    // logout procedure should happen only in World::UpdateSessions() method!!!
-    if (updater.ProcessLogout())
-    {
-        ///- If necessary, log the player out
-        time_t currTime = time(NULL);
-        if (!m_Socket || (ShouldLogOut(currTime) && !m_playerLoading))
-        {
-            LogoutPlayer(true);
-        }
-
-        // Warden
-        if (m_Socket && GetPlayer() && _warden)
-        {
-            _warden->Update();
-        }
-
-        if (!m_Socket)
-        {
-            return false;                                    // Will remove this session from the world session map
-        }
-    }
-
-    return true;
 }
 
 #ifdef ENABLE_PLAYERBOTS
 void WorldSession::HandleBotPackets()
 {
     WorldPacket* packet;
-    while (_recvQueue.next(packet))
+    while (NextPacket(packet))
     {
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
         (this->*opHandle.handler)(*packet);
@@ -556,19 +751,14 @@ void WorldSession::LogoutPlayer(bool Save)
 #ifdef ENABLE_PLAYERBOTS
         if (!GetPlayer()->GetPlayerbotAI())
         {
-            static SqlStatementID id;
             // playerbot mod
             if (!_player->GetPlayerbotAI())
             {
-                SqlStatement stmt = LoginDatabase.CreateStatement(id, "UPDATE `account` SET `active_realm_id` = ? WHERE `id` = ?");
-                stmt.PExecute(uint32(0), GetAccountId());
+                LoginDatabase.PExecuteCoalesced("account.active_realm_id", GetAccountId(), "UPDATE `account` SET `active_realm_id` = 0 WHERE `id` = '%u'", GetAccountId());
             }
         }
 #else
-        static SqlStatementID id;
-
-        SqlStatement stmt = LoginDatabase.CreateStatement(id, "UPDATE `account` SET `active_realm_id` = ? WHERE `id` = ?");
-        stmt.PExecute(uint32(0), GetAccountId());
+        LoginDatabase.PExecuteCoalesced("account.active_realm_id", GetAccountId(), "UPDATE `account` SET `active_realm_id` = 0 WHERE `id` = '%u'", GetAccountId());
 #endif
         ///- If the player is in a guild, update the guild roster and broadcast a logout message to other guild members
         if (Guild* guild = sGuildMgr.GetGuildById(_player->GetGuildId()))
@@ -624,6 +814,8 @@ void WorldSession::LogoutPlayer(bool Save)
         sEluna->OnLogout(_player);
 #endif /* ENABLE_ELUNA */
 
+        ObjectGuid playerGuid = _player->GetObjectGuid();
+
         ///- Remove the player from the world
         // the player may not be in the world when logging out
         // e.g if he got disconnected during a transfer to another map
@@ -648,13 +840,21 @@ void WorldSession::LogoutPlayer(bool Save)
         ///- Since each account can only have one online character at any given time, ensure all characters for active account are marked as offline
         // No SQL injection as AccountId is uint32
 
-        static SqlStatementID updChars;
-#ifdef ENABLE_PLAYERBOTS
-        SqlStatement stmt = CharacterDatabase.CreateStatement(updChars, "UPDATE `characters` SET `online` = 0 WHERE `account` = ?");
-#else
-        stmt = CharacterDatabase.CreateStatement(updChars, "UPDATE `characters` SET `online` = 0 WHERE `account` = ?");
-#endif
-        stmt.PExecute(GetAccountId());
+        CharacterDatabase.PExecuteCoalesced("characters.online by account", GetAccountId(), "UPDATE `characters` SET `online` = 0 WHERE `account` = '%u'", GetAccountId());
+
+        ///- Read the saved state ahead for a quick relog (also after a disconnect), bots have no socket
+        if (Save && m_Socket)
+        {
+            PrefetchPlayerLogin(playerGuid);
+        }
+
+        ///- The character list changed while playing, it is read again after the save
+        sCharEnumCache.InvalidateAccount(GetAccountId());
+        m_charEnumOrderingKey = playerGuid.GetCounter();
+        if (m_Socket)
+        {
+            WarmCharEnum();
+        }
 
         DEBUG_LOG("SESSION: Sent SMSG_LOGOUT_COMPLETE Message");
     }
@@ -883,7 +1083,10 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* pac
         _player->SetCanDelayTeleport(true);
     }
 
-    (this->*opHandle.handler)(*packet);
+    {
+        OpcodeUpdateTimer timer(packet->GetOpcode(), sWorld.getConfig(CONFIG_BOOL_OPCODE_PERF), &m_accounting.GetHandlerTime());
+        (this->*opHandle.handler)(*packet);
+    }
 
     if (_player)
     {
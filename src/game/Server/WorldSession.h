@@ -30,11 +30,15 @@
 #define MANGOS_H_WORLDSESSION
 
 #include "Common.h"
+#include "LockedQueue/SPSCQueue.h"
 #include "Auth/BigNumber.h"
 #include "SharedDefines.h"
 #include "ObjectGuid.h"
 #include "AuctionHouseMgr.h"
 #include "Item.h"
+#include "SessionAccounting.h"
+
+#include <memory>
 
 struct ItemPrototype;
 struct AuctionEntry;
@@ -59,6 +63,8 @@ class WorldSession;
 
 struct OpcodeHandler;
 
+typedef std::shared_ptr<WorldPacket const> SharedWorldPacket;
+
 enum PartyOperation
 {
     PARTY_OP_INVITE = 0,
@@ -131,6 +137,21 @@ class WorldSessionFilter : public PacketFilter
         virtual bool Process(WorldPacket* packet) override;
 };
 
+// process only session-safe packets in the parallel phase of World::UpdateSessions()
+class SessionSafeFilter : public PacketFilter
+{
+    public:
+        explicit SessionSafeFilter(WorldSession* pSession) : PacketFilter(pSession) {}
+        ~SessionSafeFilter() {}
+
+        virtual bool Process(WorldPacket* packet) override;
+        // other sessions are updated at the same time, logout touches global data
+        virtual bool ProcessLogout() const override
+        {
+            return false;
+        }
+};
+
 /// Player session in the World
 class WorldSession
 {
@@ -157,6 +178,14 @@ class WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const* packet);
+        // packet sent to several sessions, shared keeps one immutable copy for all their sockets and is set by the first one needing it
+        void SendPacket(WorldPacket const* packet, SharedWorldPacket& shared);
+        // combat log packet, with CombatLog.Batching held back until FlushCombatLogs() or the next SendPacket so they keep their order
+        void SendCombatLog(WorldPacket const* packet, SharedWorldPacket& shared);
+        // hands the held combat logs to the socket in one go, called by the map at the end of its update
+        void FlushCombatLogs();
+        // false when nobody reads packets with this opcode (no socket, or a bot that ignores it), so building them can be skipped
+        bool IsPacketWanted(uint16 opcode) const;
         void SendNotification(const char* format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(int32 string_id, ...);
         void SendPetNameInvalid(uint32 error, const std::string& name);
@@ -195,11 +224,33 @@ class WorldSession
         // Warden
         void InitWarden(uint16 build, BigNumber* k, std::string const& os);
 
+        /// Session of mangosd --replay, its packets are handled without a socket
+        void SetOffline(bool state)
+        {
+            m_offline = state;
+        }
+
         /// Session in auth.queue currently
         void SetInQueue(bool state)
         {
             m_inQueue = state;
         }
+        bool IsInQueue() const { return m_inQueue; }
+
+        /// Sequence number and last sent position in the auth.queue, see World::AddQueuedSession
+        void SetQueueSlot(uint32 sequence, uint32 position)
+        {
+            m_queueSequence = sequence;
+            m_queuePosition = position;
+        }
+        uint32 GetQueueSequence() const { return m_queueSequence; }
+        uint32 GetQueuePosition() const { return m_queuePosition; }
+
+        /// Resource use since the session started (or the last .server perf reset)
+        void GetTraffic(SessionTraffic& traffic) const;
+        /// Resource use since the previous call, the send queue peak within that time only
+        void GetTrafficSinceLastCheck(SessionTraffic& delta);
+        void ResetTraffic();
 
         /// Is the user engaged in a log out process?
         bool isLogingOut() const
@@ -228,12 +279,20 @@ class WorldSession
          */
         void QueuePacket(WorldPacket* new_packet);
 
+        /**
+         * @brief Queue a packet received from the client, only called by the socket's reactor thread
+         * @param new_packet
+         */
+        void QueueIncomingPacket(WorldPacket* new_packet);
+
         /**
          * @brief Update the WorldSession (triggered by World update)
          * @param updater 
          * @return 
          */
         bool Update(PacketFilter& updater);
+        // handles the queued session-safe packets only, can run in parallel with other sessions
+        void UpdateSessionSafe();
 
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position);
@@ -364,8 +423,13 @@ class WorldSession
         void HandleCharDeleteOpcode(WorldPacket& recvPacket);
         void HandleCharCreateOpcode(WorldPacket& recvPacket);
         void HandlePlayerLoginOpcode(WorldPacket& recvPacket);
-        void HandleCharEnum(QueryResult* result);
+        void HandleCharEnum(QueryResult* result, uint32 serial);
+        // query the character list, sent if the client asked for it meanwhile, see CharEnumCache
+        void QueryCharEnum();
+        void WarmCharEnum();
         void HandlePlayerLogin(LoginQueryHolder* holder);
+        // read the login data of a character of this account ahead, see CharacterLoginCache
+        void PrefetchPlayerLogin(ObjectGuid playerGuid);
 
         // played time
         void HandlePlayedTime(WorldPacket& recvPacket);
@@ -650,6 +714,7 @@ class WorldSession
         void HandlePushQuestToParty(WorldPacket& recvPacket);
         void HandleQuestPushResult(WorldPacket& recvPacket);
 
+        bool readChatMessage(WorldPacket& recv_data, std::string& msg, uint32 lang);
         bool processChatmessageFurtherAfterSecurityChecks(std::string&, uint32);
         void SendPlayerNotFoundNotice(const std::string &name);
         void SendWrongFactionNotice();
@@ -758,6 +823,11 @@ class WorldSession
 
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet);
 
+        // next packet from the client queue, then from the server injected queue
+        bool NextPacket(WorldPacket*& packet);
+        bool NextPacket(WorldPacket*& packet, PacketFilter& updater);
+        void ProcessPackets(PacketFilter& updater);
+
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, const char* reason);
         void LogUnprocessedTail(WorldPacket* packet);
@@ -775,6 +845,11 @@ class WorldSession
 
         time_t _logoutTime;
         bool m_inQueue;                                     // session wait in auth.queue
+        bool m_charEnumRequested;                           // CMSG_CHAR_ENUM waits for a running query
+        uint32 m_charEnumOrderingKey;                       // character written last, the list is read after it
+        uint32 m_queueSequence;
+        uint32 m_queuePosition;
+        bool m_offline;                                     // no socket, fed by the tick replay
         bool m_playerLoading;                               // code processed in LoginPlayer
         bool m_playerLogout;                                // code processed in LogoutPlayer
         bool m_playerRecentlyLogout;
@@ -782,13 +857,25 @@ class WorldSession
         LocaleConstant m_sessionDbcLocale;
         int m_sessionDbLocaleIndex;
         uint32 m_latency;
+        SessionAccounting m_accounting;
+        SessionTraffic m_lastTrafficCheck;                  // totals at the last GetTrafficSinceLastCheck()
         uint32 m_Tutorials[8];
         TutorialDataState m_tutorialState;
         uint32 m_clientTimeDelay;
         /**
-         * @brief 客户端数据包队列，并发安全队列
+         * @brief 客户端数据包队列, the socket is the only producer and the session update the only consumer
+         */
+        ACE_Based::SPSCQueue<WorldPacket*> _recvQueue;
+        /**
+         * @brief packets queued by the server itself (bots, debug commands), any thread
+         */
+        ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> _injectedQueue;
+        /**
+         * @brief combat logs waiting for FlushCombatLogs(), already accounted as sent
          */
-        ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> _recvQueue;
+        std::vector<SharedWorldPacket> m_combatLogs;
+        ACE_Thread_Mutex m_combatLogLock;
+        std::atomic<bool> m_hasCombatLogs;                  // m_combatLogs is not empty, checked without the lock
 };
 #endif
 /// @}
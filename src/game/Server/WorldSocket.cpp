@@ -32,6 +32,8 @@
 #include <ace/OS_NS_string.h>
 #include <ace/Reactor.h>
 #include <ace/Auto_Ptr.h>
+#include <ace/OS_NS_sys_socket.h>
+#include <ace/os_include/sys/os_uio.h>
 
 #include "WorldSocket.h"
 #include "Common.h"
@@ -50,6 +52,7 @@
 #include "WorldSocketMgr.h"
 #include "Log.h"
 #include "DBCStores.h"
+#include "Metrics.h"
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
 #endif /* ENABLE_ELUNA */
@@ -89,11 +92,24 @@ WorldSocket::WorldSocket(void) :
     m_OutBufferLock(),
     m_OutBuffer(0),
     m_OutBufferSize(65536),
+    m_OutRingSize(0),
+    m_OutRingHead(0),
+    m_OutRingCount(0),
+    m_OutRingSent(0),
+    m_SendQueueSize(0),
+    m_SendQueuePeak(0),
     m_Seed(rand32())
 {
     reference_counting_policy().value(ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
 }
 
+/// Packets waiting in the per-socket overflow queues, summed over every socket.
+static MetricGauge& GetSendQueueMetric()
+{
+    static MetricGauge& gauge = sMetrics.GetGauge("mangos_socket_send_queue_packets", "Packets waiting in the socket send queues");
+    return gauge;
+}
+
 WorldSocket::~WorldSocket(void)
 {
     delete m_RecvWPct;
@@ -110,8 +126,22 @@ WorldSocket::~WorldSocket(void)
     WorldPacket* pct;
     while (m_PacketQueue.dequeue_head(pct) == 0)
     {
+        GetSendQueueMetric().Add(-1);
         delete pct;
     }
+
+    GetSendQueueMetric().Add(-int64(m_OutRingQueue.size()));
+}
+
+void WorldSocket::iAddSendQueueSize(int32 count)
+{
+    GetSendQueueMetric().Add(count);
+
+    m_SendQueueSize += count;
+    if (m_SendQueueSize > m_SendQueuePeak.load(std::memory_order_relaxed))
+    {
+        m_SendQueuePeak.store(m_SendQueueSize, std::memory_order_relaxed);
+    }
 }
 
 bool WorldSocket::IsClosed(void) const
@@ -148,13 +178,17 @@ int WorldSocket::SendPacket(const WorldPacket& pkt)
         return -1;
     }
 
-    WorldPacket pct = pkt;
+    if (!m_OutRing.empty())
+    {
+        // the only copy of the payload, it is handed to the kernel from here
+        return iSendRingPacket(std::make_shared<WorldPacket const>(pkt));
+    }
 
-    if (iSendPacket(pct) == -1)
+    if (iSendPacket(pkt) == -1)
     {
         WorldPacket* npct;
 
-        ACE_NEW_RETURN(npct, WorldPacket(pct), -1);
+        ACE_NEW_RETURN(npct, WorldPacket(pkt), -1);
 
         // NOTE maybe check of the size of the queue can be good ?
         // to make it bounded instead of unbounded
@@ -164,6 +198,117 @@ int WorldSocket::SendPacket(const WorldPacket& pkt)
             sLog.outError("WorldSocket::SendPacket: m_PacketQueue.enqueue_tail failed");
             return -1;
         }
+
+        iAddSendQueueSize(1);
+    }
+
+    if (reactor()->schedule_wakeup(this, ACE_Event_Handler::WRITE_MASK) == -1)
+    {
+        sLog.outError("SendPacket failed setting WRITE mask, peer = %s", GetRemoteAddress().c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
+int WorldSocket::SendPacket(const SharedWorldPacket& pkt)
+{
+    ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+
+    if (closing_)
+    {
+        return -1;
+    }
+
+    if (!m_OutRing.empty())
+    {
+        return iSendRingPacket(pkt);
+    }
+
+    if (iSendSharedPacket(pkt) == -1)
+    {
+        return -1;
+    }
+
+    if (reactor()->schedule_wakeup(this, ACE_Event_Handler::WRITE_MASK) == -1)
+    {
+        sLog.outError("SendPacket failed setting WRITE mask, peer = %s", GetRemoteAddress().c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
+int WorldSocket::SendPackets(const std::vector<SharedWorldPacket>& pkts)
+{
+    if (pkts.empty())
+    {
+        return 0;
+    }
+
+    ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+
+    if (closing_)
+    {
+        return -1;
+    }
+
+    for (std::vector<SharedWorldPacket>::const_iterator itr = pkts.begin(); itr != pkts.end(); ++itr)
+    {
+        if (!m_OutRing.empty())
+        {
+            if (!m_OutRingQueue.empty() || !iQueueRingPacket(*itr))
+            {
+                m_OutRingQueue.push_back(*itr);
+                iAddSendQueueSize(1);
+                sWorldSocketMgr->OnOutRingOverflow();
+            }
+        }
+        else if (iSendSharedPacket(*itr) == -1)
+        {
+            return -1;
+        }
+    }
+
+    // one wakeup for the whole batch
+    if (reactor()->schedule_wakeup(this, ACE_Event_Handler::WRITE_MASK) == -1)
+    {
+        sLog.outError("SendPackets failed setting WRITE mask, peer = %s", GetRemoteAddress().c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
+int WorldSocket::iSendSharedPacket(const SharedWorldPacket& pct)
+{
+    if (iSendPacket(*pct) == -1)
+    {
+        WorldPacket* npct;
+
+        ACE_NEW_RETURN(npct, WorldPacket(*pct), -1);
+
+        if (m_PacketQueue.enqueue_tail(npct) == -1)
+        {
+            delete npct;
+            sLog.outError("WorldSocket::SendPacket: m_PacketQueue.enqueue_tail failed");
+            return -1;
+        }
+
+        iAddSendQueueSize(1);
+    }
+
+    return 0;
+}
+
+int WorldSocket::iSendRingPacket(const SharedWorldPacket& pct)
+{
+    // packets already waiting keep their place, the header cipher must see them first
+    if (!m_OutRingQueue.empty() || !iQueueRingPacket(pct))
+    {
+        m_OutRingQueue.push_back(pct);
+        iAddSendQueueSize(1);
+        sWorldSocketMgr->OnOutRingOverflow();
     }
 
     if (reactor()->schedule_wakeup(this, ACE_Event_Handler::WRITE_MASK) == -1)
@@ -190,7 +335,7 @@ int WorldSocket::open(void* a)
     ACE_UNUSED_ARG(a);
 
     // Prevent double call to this func.
-    if (m_OutBuffer)
+    if (m_OutBuffer || !m_OutRing.empty())
     {
         return -1;
     }
@@ -201,8 +346,15 @@ int WorldSocket::open(void* a)
         return -1;
     }
 
-    // Allocate the buffer.
-    ACE_NEW_RETURN(m_OutBuffer, ACE_Message_Block(m_OutBufferSize), -1);
+    // Allocate the buffer or the ring, whichever output mode is configured.
+    if (m_OutRingSize)
+    {
+        m_OutRing.resize(m_OutRingSize);
+    }
+    else
+    {
+        ACE_NEW_RETURN(m_OutBuffer, ACE_Message_Block(m_OutBufferSize), -1);
+    }
 
     // Store peer address.
     ACE_INET_Addr remote_addr;
@@ -280,6 +432,11 @@ int WorldSocket::handle_output(ACE_HANDLE)
         return -1;
     }
 
+    if (!m_OutRing.empty())
+    {
+        return handle_output_ring();
+    }
+
     const size_t send_len = m_OutBuffer->length();
 
     if (send_len == 0)
@@ -330,6 +487,106 @@ int WorldSocket::handle_output(ACE_HANDLE)
     ACE_NOTREACHED(return 0);
 }
 
+int WorldSocket::handle_output_ring()
+{
+    // keep well below IOV_MAX, two entries per packet
+    static const size_t MAX_GATHER_PACKETS = 64;
+
+    iovec iov[MAX_GATHER_PACKETS * 2];
+    int iovcnt = 0;
+    size_t send_len = 0;
+    size_t skip = m_OutRingSent;
+
+    for (size_t i = 0; i < m_OutRingCount && i < MAX_GATHER_PACKETS; ++i)
+    {
+        OutRingEntry& entry = m_OutRing[(m_OutRingHead + i) % m_OutRing.size()];
+
+        // only the head entry can be partially sent
+        if (skip < sizeof(entry.header))
+        {
+            iov[iovcnt].iov_base = (char*)entry.header + skip;
+            iov[iovcnt].iov_len = sizeof(entry.header) - skip;
+            send_len += iov[iovcnt].iov_len;
+            ++iovcnt;
+            skip = 0;
+        }
+        else
+        {
+            skip -= sizeof(entry.header);
+        }
+
+        if (entry.packet->size() > skip)
+        {
+            iov[iovcnt].iov_base = (char*)entry.packet->contents() + skip;
+            iov[iovcnt].iov_len = entry.packet->size() - skip;
+            send_len += iov[iovcnt].iov_len;
+            ++iovcnt;
+        }
+
+        skip = 0;
+    }
+
+    if (send_len == 0)
+    {
+        reactor()->cancel_wakeup(this, ACE_Event_Handler::WRITE_MASK);
+        return 0;
+    }
+
+#ifdef MSG_NOSIGNAL
+    msghdr msg;
+    ACE_OS::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
+
+    ssize_t n = ACE_OS::sendmsg(peer().get_handle(), &msg, MSG_NOSIGNAL);
+#else
+    ssize_t n = peer().sendv(iov, iovcnt);
+#endif // MSG_NOSIGNAL
+
+    if (n == 0)
+    {
+        return -1;
+    }
+    else if (n == -1)
+    {
+        if (errno == EWOULDBLOCK || errno == EAGAIN)
+        {
+            return 0;
+        }
+        return -1;
+    }
+
+    // drop every packet that went out completely, remember how far the next one got
+    size_t sent = m_OutRingSent + static_cast<size_t>(n);
+
+    while (m_OutRingCount > 0)
+    {
+        OutRingEntry& entry = m_OutRing[m_OutRingHead];
+        size_t entry_len = sizeof(entry.header) + entry.packet->size();
+
+        if (sent < entry_len)
+        {
+            break;
+        }
+
+        sent -= entry_len;
+        entry.packet.reset();
+        m_OutRingHead = (m_OutRingHead + 1) % m_OutRing.size();
+        --m_OutRingCount;
+    }
+
+    m_OutRingSent = sent;
+
+    iFlushPacketQueueToRing();
+
+    if (m_OutRingCount == 0)
+    {
+        reactor()->cancel_wakeup(this, ACE_Event_Handler::WRITE_MASK);
+    }
+
+    return 0;
+}
+
 int WorldSocket::handle_close(ACE_HANDLE h, ACE_Reactor_Mask)
 {
     {
@@ -571,7 +828,7 @@ int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
                 {
                     // OK ,give the packet to WorldSession
                     aptr.release();
-                    m_Session->QueuePacket(new_pct);
+                    m_Session->QueueIncomingPacket(new_pct);
                     return 0;
                 }
                 else
@@ -945,6 +1202,43 @@ int WorldSocket::iSendPacket(const WorldPacket& pct)
     return 0;
 }
 
+bool WorldSocket::iQueueRingPacket(const SharedWorldPacket& pct)
+{
+    if (m_OutRingCount == m_OutRing.size())
+    {
+        return false;
+    }
+
+    OutRingEntry& entry = m_OutRing[(m_OutRingHead + m_OutRingCount) % m_OutRing.size()];
+
+    ServerPktHeader header;
+
+    header.cmd = pct->GetOpcode();
+
+    header.size = (uint16) pct->size() + 2;
+
+    EndianConvertReverse(header.size);
+    EndianConvert(header.cmd);
+
+    // encrypted now, packets enter the ring in the order they go out
+    m_Crypt.EncryptSend((uint8*) & header, sizeof(header));
+
+    memcpy(entry.header, &header, sizeof(header));
+    entry.packet = pct;
+    ++m_OutRingCount;
+
+    return true;
+}
+
+void WorldSocket::iFlushPacketQueueToRing()
+{
+    while (!m_OutRingQueue.empty() && iQueueRingPacket(m_OutRingQueue.front()))
+    {
+        m_OutRingQueue.pop_front();
+        iAddSendQueueSize(-1);
+    }
+}
+
 bool WorldSocket::iFlushPacketQueue()
 {
     WorldPacket* pct;
@@ -956,6 +1250,7 @@ bool WorldSocket::iFlushPacketQueue()
         {
             if (m_PacketQueue.enqueue_head(pct) == -1)
             {
+                iAddSendQueueSize(-1);
                 delete pct;
                 sLog.outError("WorldSocket::iFlushPacketQueue m_PacketQueue->enqueue_head");
                 return false;
@@ -965,6 +1260,7 @@ bool WorldSocket::iFlushPacketQueue()
         }
         else
         {
+            iAddSendQueueSize(-1);
             haveone = true;
             delete pct;
         }
@@ -49,8 +49,14 @@
 #include "Common.h"
 #include "Auth/AuthCrypt.h"
 
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
 class ACE_Message_Block;
 class WorldPacket;
+typedef std::shared_ptr<WorldPacket const> SharedWorldPacket;
 class WorldSession;
 class WorldSocket;
 
@@ -120,6 +126,20 @@ class WorldSocket : protected WorldHandler
         /// @return -1 of failure
         int SendPacket(const WorldPacket& pct);
 
+        /// Send a packet shared with other sockets, the payload is not copied if the output ring is used.
+        /// @param pct packet to send, must not be modified any more
+        /// @return -1 of failure
+        int SendPacket(const SharedWorldPacket& pct);
+
+        /// Send several shared packets in order, taking the output lock and waking the reactor once for all of them.
+        /// @param pkts packets to send, must not be modified any more
+        /// @return -1 of failure
+        int SendPackets(const std::vector<SharedWorldPacket>& pkts);
+
+        /// Most packets waiting behind the output buffer (or ring) at once since the last reset.
+        uint32 GetSendQueuePeak() const { return m_SendQueuePeak.load(std::memory_order_relaxed); }
+        void ResetSendQueuePeak() { m_SendQueuePeak.store(0, std::memory_order_relaxed); }
+
         /// Add reference to this object.
         long AddReference(void);
 
@@ -185,12 +205,36 @@ class WorldSocket : protected WorldHandler
         /// Need to be called with m_OutBufferLock lock held
         int iSendPacket(const WorldPacket& pct);
 
+        /// Write a shared packet to m_OutBuffer, or copy it to m_PacketQueue if there is no space
+        /// Need to be called with m_OutBufferLock lock held
+        int iSendSharedPacket(const SharedWorldPacket& pct);
+
         /// Flush m_PacketQueue if there are packets in it
         /// Need to be called with m_OutBufferLock lock held
         /// @return true if it wrote to the buffer ( AKA you need
         /// to mark the socket for output ).
         bool iFlushPacketQueue();
 
+        /// Put a packet into m_OutRing, or m_OutRingQueue if the ring is full or packets are waiting already
+        /// Need to be called with m_OutBufferLock lock held
+        int iSendRingPacket(const SharedWorldPacket& pct);
+
+        /// Put a packet into m_OutRing, return false if the ring is full
+        /// Need to be called with m_OutBufferLock lock held
+        bool iQueueRingPacket(const SharedWorldPacket& pct);
+
+        /// Move packets from m_OutRingQueue into m_OutRing while there is space
+        /// Need to be called with m_OutBufferLock lock held
+        void iFlushPacketQueueToRing();
+
+        /// handle_output() for the scatter-gather mode, sends the ring with one writev/sendmsg call
+        /// Need to be called with m_OutBufferLock lock held
+        int handle_output_ring();
+
+        /// Count packets entering (positive) or leaving the overflow queue, for the gauge and the peak
+        /// Need to be called with m_OutBufferLock lock held
+        void iAddSendQueueSize(int32 count);
+
     private:
         /// Time in which the last ping was received
         ACE_Time_Value m_LastPingTime;
@@ -237,6 +281,31 @@ class WorldSocket : protected WorldHandler
         /// this allows not-to kick player if its buffer is overflowed.
         PacketQueueT m_PacketQueue;
 
+        /// Packet queued in m_OutRing, written in place by writev/sendmsg.
+        struct OutRingEntry
+        {
+            uint8 header[4];                                ///< already encrypted ServerPktHeader
+            SharedWorldPacket packet;
+        };
+
+        /// Capacity of m_OutRing, 0 if m_OutBuffer is used (Network.OutRing).
+        size_t m_OutRingSize;
+
+        /// Fixed size ring of packets waiting for output, replaces m_OutBuffer if enabled.
+        std::vector<OutRingEntry> m_OutRing;
+        size_t m_OutRingHead;
+        size_t m_OutRingCount;
+
+        /// Bytes of the head entry (header included) sent already.
+        size_t m_OutRingSent;
+
+        /// Packets for which there was no space in m_OutRing, in order.
+        std::deque<SharedWorldPacket> m_OutRingQueue;
+
+        /// Packets in m_PacketQueue or m_OutRingQueue, and the most there were.
+        uint32 m_SendQueueSize;
+        std::atomic<uint32> m_SendQueuePeak;
+
         uint32 m_Seed;
 };
 
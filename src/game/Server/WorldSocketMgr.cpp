@@ -35,6 +35,7 @@
 
 #include <ace/ACE.h>
 #include <ace/TP_Reactor.h>
+#include <ace/Dev_Poll_Reactor.h>
 #include <ace/os_include/arpa/os_inet.h>
 #include <ace/os_include/netinet/os_tcp.h>
 #include <ace/os_include/sys/os_types.h>
@@ -43,17 +44,19 @@
 #include <set>
 
 WorldSocketMgr::WorldSocketMgr()
-  : m_SockOutKBuff(-1), m_SockOutUBuff(65536), m_UseNoDelay(true),
-    reactor_(NULL), acceptor_(NULL)
+  : m_SockOutKBuff(-1), m_SockOutUBuff(65536), m_SockOutRing(0), m_UseNoDelay(true),
+    m_OutRingOverflows(0), m_NextThread(0), m_NextReactor(0), acceptor_(NULL)
 {
 }
 
 WorldSocketMgr::~WorldSocketMgr()
 {
-    if (reactor_) delete reactor_;
+    for (std::vector<ACE_Reactor*>::iterator itr = m_Reactors.begin(); itr != m_Reactors.end(); ++itr)
     {
-        if (acceptor_) delete acceptor_;
+        delete *itr;
     }
+
+    if (acceptor_) delete acceptor_;
 }
 
 
@@ -61,7 +64,17 @@ int WorldSocketMgr::svc()
 {
     DEBUG_LOG("Starting Network Thread");
 
-    reactor_->run_reactor_event_loop();
+    std::string cpus = sConfig.GetStringDefault("ThreadAffinity.Network", "");
+    if (!ACE_Based::Thread::SetCurrentThreadAffinity(cpus))
+    {
+        sLog.outError("Network Thread: can't run on CPUs %s", cpus.c_str());
+    }
+
+    // all threads share the TP reactor, or each runs its own epoll reactor
+    ACE_Reactor* reactor = m_Reactors[size_t(++m_NextThread - 1) % m_Reactors.size()];
+    reactor->owner(ACE_Thread::self());
+
+    reactor->run_reactor_event_loop();
 
     DEBUG_LOG("Network Thread Exitting");
     return 0;
@@ -85,19 +98,49 @@ int WorldSocketMgr::StartNetwork(ACE_INET_Addr& addr)
         return -1;
     }
 
+    // 0 means copy into the Network.OutUBuff sized buffer
+    m_SockOutRing = sConfig.GetIntDefault("Network.OutRing", 0);
+    if (m_SockOutRing < 0)
+    {
+        sLog.outError("Network.OutRing is wrong in your config file");
+        return -1;
+    }
+
     // -1 means use default
     m_SockOutKBuff = sConfig.GetIntDefault("Network.OutKBuff", -1);
     m_UseNoDelay = sConfig.GetBoolDefault("Network.TcpNodelay", true);
 
+    int reactor_type = sConfig.GetIntDefault("Network.Reactor", 0);
+#if !defined(ACE_HAS_EVENT_POLL) && !defined(ACE_HAS_DEV_POLL)
+    if (reactor_type == 1)
+    {
+        sLog.outError("Network.Reactor = 1 needs epoll or /dev/poll support, using the shared reactor");
+        reactor_type = 0;
+    }
+#endif
+
     // 创建多线程Reactor
-    ACE_Reactor_Impl* imp = 0;
-    imp = new ACE_TP_Reactor();
-    imp->max_notify_iterations(128);
-    reactor_ = new ACE_Reactor(imp, 1);
+    if (reactor_type == 1)
+    {
+        // one reactor per thread, no handler repository or leader token shared between threads
+        for (int i = 0; i < num_threads; ++i)
+        {
+            ACE_Reactor_Impl* imp = new ACE_Dev_Poll_Reactor();
+            imp->max_notify_iterations(128);
+            m_Reactors.push_back(new ACE_Reactor(imp, 1));
+        }
+    }
+    else
+    {
+        ACE_Reactor_Impl* imp = new ACE_TP_Reactor();
+        imp->max_notify_iterations(128);
+        m_Reactors.push_back(new ACE_Reactor(imp, 1));
+    }
+
     // 设置客户端连接时处理
     acceptor_ = new WorldAcceptor;
     // 注册到对应Reactor
-    if (acceptor_->open(addr, reactor_, ACE_NONBLOCK) == -1)
+    if (acceptor_->open(addr, m_Reactors[0], ACE_NONBLOCK) == -1)
     {
         sLog.outError("Failed to open acceptor, check if the port is free");
         return -1;
@@ -115,9 +158,12 @@ int WorldSocketMgr::StartNetwork(ACE_INET_Addr& addr)
 void WorldSocketMgr::StopNetwork()
 {
     if (acceptor_) acceptor_->close();
+
+    for (std::vector<ACE_Reactor*>::iterator itr = m_Reactors.begin(); itr != m_Reactors.end(); ++itr)
     {
-        if (reactor_)  reactor_->end_reactor_event_loop();
+        (*itr)->end_reactor_event_loop();
     }
+
     wait();
 }
 
@@ -146,7 +192,9 @@ int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
     }
 
     sock->m_OutBufferSize = static_cast<size_t>(m_SockOutUBuff);
-    sock->reactor(reactor_);
+    sock->m_OutRingSize = static_cast<size_t>(m_SockOutRing);
+    // accepted on the first reactor, handled by the next one in turn
+    sock->reactor(m_Reactors[m_NextReactor++ % m_Reactors.size()]);
 
     return 0;
 }
@@ -37,10 +37,14 @@
 #include <ace/INET_Addr.h>
 #include <ace/Task.h>
 #include <ace/Acceptor.h>
+#include <ace/Atomic_Op.h>
+
+#include <vector>
 
 class WorldSocket;
 
-/// This is a pool of threads designed to be used by an ACE_TP_Reactor.
+/// This is a pool of threads designed to be used by an ACE_TP_Reactor shared by all of them,
+/// or with one epoll reactor per thread (Network.Reactor = 1), each owning a share of the sockets.
 /// Manages all sockets connected to peers
 
 class WorldSocketMgr : public ACE_Task_Base
@@ -51,6 +55,14 @@ class WorldSocketMgr : public ACE_Task_Base
         int StartNetwork(ACE_INET_Addr& addr);
         void StopNetwork();
 
+        /// Packets per socket in the scatter-gather output ring, 0 if the copying output buffer is used.
+        int GetOutRingSize() const { return m_SockOutRing; }
+
+        /// Packets that did not fit into the output ring of their socket since startup.
+        long GetOutRingOverflowCount() const { return m_OutRingOverflows.value(); }
+
+        void OnOutRingOverflow() { ++m_OutRingOverflows; }
+
     private:
         int OnSocketOpen(WorldSocket* sock);
         /*
@@ -64,9 +76,16 @@ class WorldSocketMgr : public ACE_Task_Base
     private:
         int m_SockOutKBuff;
         int m_SockOutUBuff;
+        int m_SockOutRing;
         bool m_UseNoDelay;
 
-        ACE_Reactor   *reactor_;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_OutRingOverflows;
+
+        /// Single ACE_TP_Reactor, or one ACE_Dev_Poll_Reactor per network thread, the first one runs the acceptor
+        std::vector<ACE_Reactor*> m_Reactors;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_NextThread;
+        size_t m_NextReactor;
+
         WorldAcceptor *acceptor_;
 };
 
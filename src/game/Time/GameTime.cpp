@@ -68,7 +68,7 @@ namespace GameTime
     void UpdateGameTimers()
     {
         GameTime = time(nullptr);
-        GameMSTime = getMSTime();
+        GameMSTime = RefreshTickMSTime();
         GameTimeSystemPoint = std::chrono::system_clock::now();
         GameTimeSteadyPoint = std::chrono::steady_clock::now();
     }
@@ -28,8 +28,15 @@
 #include "Timer.h"
 #include "Config.h"
 #include "Log.h"
+#include "Opcodes.h"
+#include "Metrics.h"
+
+#include <ace/TSS_T.h>
+
+#include <algorithm>
 
 WorldUpdateTime sWorldUpdateTime;
+OpcodeUpdateTime sOpcodeUpdateTime;
 
 UpdateTime::UpdateTime() : _averageUpdateTime(0), _totalUpdateTime(0), _updateTimeTableIndex(0), _maxUpdateTime(0),
     _maxUpdateTimeOfLastTable(0), _maxUpdateTimeOfCurrentTable(0), _updateTimeDataTable() { }
@@ -144,3 +151,258 @@ void WorldUpdateTime::RecordUpdateTimeDuration(std::string const& text)
 {
     _RecordUpdateTimeDuration(text, _recordUpdateTimeMin);
 }
+
+void UpdateTimeHistogram::Add(uint32 us)
+{
+    uint32 bucket = 0;
+    for (uint32 value = us >> 1; value && bucket < UPDATE_TIME_HISTOGRAM_BUCKETS - 1; value >>= 1)
+    {
+        ++bucket;
+    }
+
+    ++_buckets[bucket];
+    ++_count;
+    _total += us;
+
+    if (us > _max)
+    {
+        _max = us;
+    }
+}
+
+void UpdateTimeHistogram::Merge(UpdateTimeHistogram const& other)
+{
+    for (uint32 bucket = 0; bucket < UPDATE_TIME_HISTOGRAM_BUCKETS; ++bucket)
+    {
+        _buckets[bucket] += other._buckets[bucket];
+    }
+
+    _count += other._count;
+    _total += other._total;
+    _max = std::max(_max, other._max);
+}
+
+void UpdateTimeHistogram::Reset()
+{
+    _buckets.fill(0);
+    _count = 0;
+    _max = 0;
+    _total = 0;
+}
+
+uint32 UpdateTimeHistogram::GetPercentile(uint32 percent) const
+{
+    if (!_count)
+    {
+        return 0;
+    }
+
+    uint64 wanted = (uint64(_count) * percent + 99) / 100;
+    uint64 seen = 0;
+
+    for (uint32 bucket = 0; bucket < UPDATE_TIME_HISTOGRAM_BUCKETS; ++bucket)
+    {
+        seen += _buckets[bucket];
+        if (seen >= wanted)
+        {
+            uint64 upperBound = (uint64(2) << bucket) - 1;
+            return uint32(std::min<uint64>(upperBound, _max));
+        }
+    }
+
+    return _max;
+}
+
+void MapUpdateTime::Reset()
+{
+    for (UpdateTimeHistogram& phase : _phases)
+    {
+        phase.Reset();
+    }
+}
+
+char const* MapUpdateTime::GetPhaseName(MapUpdatePhase phase)
+{
+    switch (phase)
+    {
+        case MAP_UPDATE_PHASE_SESSIONS:     return "sessions";
+        case MAP_UPDATE_PHASE_PLAYERS:      return "players";
+        case MAP_UPDATE_PHASE_OBJECTS:      return "objects";
+        case MAP_UPDATE_PHASE_SEND_UPDATES: return "send updates";
+        case MAP_UPDATE_PHASE_GRID_STATES:  return "grid states";
+        case MAP_UPDATE_PHASE_SCRIPTS:      return "scripts";
+        case MAP_UPDATE_PHASE_TOTAL:        return "total";
+        default:                            return "unknown";
+    }
+}
+
+MapUpdatePhaseTimer::MapUpdatePhaseTimer(MapUpdateTime& updateTime, MetricHistogram* totalMetric) : _updateTime(updateTime),
+    _totalMetric(totalMetric), _start(std::chrono::steady_clock::now()), _last(_start) { }
+
+MapUpdatePhaseTimer::~MapUpdatePhaseTimer()
+{
+    using namespace std::chrono;
+
+    uint32 us = uint32(duration_cast<microseconds>(steady_clock::now() - _start).count());
+    _updateTime.Record(MAP_UPDATE_PHASE_TOTAL, us);
+
+    if (_totalMetric)
+    {
+        _totalMetric->Observe(us / 1000000.0);
+    }
+}
+
+void MapUpdatePhaseTimer::Record(MapUpdatePhase phase)
+{
+    using namespace std::chrono;
+
+    steady_clock::time_point now = steady_clock::now();
+    _updateTime.Record(phase, uint32(duration_cast<microseconds>(now - _last).count()));
+    _last = now;
+}
+
+namespace
+{
+    /// Histograms of one thread, registered while the thread lives so Collect can find them
+    struct OpcodeThreadTimes
+    {
+        OpcodeThreadTimes();
+        ~OpcodeThreadTimes();
+
+        uint32 generation;
+        std::array<UpdateTimeHistogram, NUM_MSG_TYPES> opcodes;
+    };
+
+    ACE_Thread_Mutex s_opcodeThreadTimesLock;
+    std::vector<OpcodeThreadTimes*> s_opcodeThreadTimes;
+
+    OpcodeThreadTimes::OpcodeThreadTimes() : generation(0)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, s_opcodeThreadTimesLock);
+        s_opcodeThreadTimes.push_back(this);
+    }
+
+    OpcodeThreadTimes::~OpcodeThreadTimes()
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, s_opcodeThreadTimesLock);
+        s_opcodeThreadTimes.erase(std::remove(s_opcodeThreadTimes.begin(), s_opcodeThreadTimes.end(), this), s_opcodeThreadTimes.end());
+    }
+
+    OpcodeThreadTimes* GetOpcodeThreadTimes()
+    {
+        // never destroyed, the per thread objects are released by ACE when their thread exits
+        static ACE_TSS<OpcodeThreadTimes>* times = new ACE_TSS<OpcodeThreadTimes>();
+        return *times;
+    }
+
+    bool OpcodeEntryGreaterTotal(OpcodeUpdateTime::OpcodeEntry const& left, OpcodeUpdateTime::OpcodeEntry const& right)
+    {
+        return left.histogram.GetTotal() > right.histogram.GetTotal();
+    }
+}
+
+OpcodeUpdateTime::OpcodeUpdateTime() : _generation(0) { }
+
+void OpcodeUpdateTime::Record(uint16 opcode, uint32 us)
+{
+    if (opcode >= NUM_MSG_TYPES)
+    {
+        return;
+    }
+
+    OpcodeThreadTimes* times = GetOpcodeThreadTimes();
+
+    uint32 generation = _generation.load(std::memory_order_relaxed);
+    if (times->generation != generation)
+    {
+        for (UpdateTimeHistogram& histogram : times->opcodes)
+        {
+            histogram.Reset();
+        }
+
+        times->generation = generation;
+    }
+
+    times->opcodes[opcode].Add(us);
+}
+
+void OpcodeUpdateTime::Reset()
+{
+    ++_generation;
+}
+
+void OpcodeUpdateTime::Collect(std::vector<OpcodeEntry>& entries) const
+{
+    std::vector<UpdateTimeHistogram> merged(NUM_MSG_TYPES);
+    uint32 generation = _generation.load(std::memory_order_relaxed);
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, s_opcodeThreadTimesLock);
+
+        // read while the owners keep writing, a slightly torn histogram is fine for statistics
+        for (OpcodeThreadTimes const* times : s_opcodeThreadTimes)
+        {
+            if (times->generation != generation)
+            {
+                continue;
+            }
+
+            for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+            {
+                if (times->opcodes[opcode].GetCount())
+                {
+                    merged[opcode].Merge(times->opcodes[opcode]);
+                }
+            }
+        }
+    }
+
+    entries.clear();
+
+    for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+    {
+        if (merged[opcode].GetCount())
+        {
+            OpcodeEntry entry;
+            entry.opcode = uint16(opcode);
+            entry.histogram = merged[opcode];
+            entries.push_back(entry);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), OpcodeEntryGreaterTotal);
+}
+
+void OpcodeUpdateTime::LogOpcodeTimes(uint32 count)
+{
+    std::vector<OpcodeEntry> entries;
+    Collect(entries);
+
+    for (uint32 i = 0; i < entries.size() && i < count; ++i)
+    {
+        OpcodeEntry const& entry = entries[i];
+        sLog.outString("Opcode %s (0x%.4X): calls %u, total " UI64FMTD " us, avg/p99/max %u/%u/%u us", LookupOpcodeName(entry.opcode), entry.opcode,
+                       entry.histogram.GetCount(), entry.histogram.GetTotal(),
+                       entry.histogram.GetAverage(), entry.histogram.GetPercentile(99), entry.histogram.GetMax());
+    }
+
+    Reset();
+}
+
+OpcodeUpdateTimer::~OpcodeUpdateTimer()
+{
+    using namespace std::chrono;
+
+    if (!_enabled)
+    {
+        return;
+    }
+
+    uint32 us = uint32(duration_cast<microseconds>(steady_clock::now() - _start).count());
+    sOpcodeUpdateTime.Record(_opcode, us);
+
+    if (_sessionTime)
+    {
+        _sessionTime->fetch_add(us, std::memory_order_relaxed);
+    }
+}
@@ -29,10 +29,14 @@
 #include "Timer.h"
 
 #include <array>
+#include <atomic>
 #include <string>
+#include <vector>
 
 #define AVG_DIFF_COUNT 500
 
+class MetricHistogram;
+
 class UpdateTime
 {
     using DiffTableArray = std::array<uint32, AVG_DIFF_COUNT>;
@@ -82,4 +86,125 @@ private:
 
 extern WorldUpdateTime sWorldUpdateTime;
 
+#define UPDATE_TIME_HISTOGRAM_BUCKETS 32
+
+/// Power of two buckets of update durations in microseconds, one writer and no locking
+class UpdateTimeHistogram
+{
+public:
+    UpdateTimeHistogram() { Reset(); }
+
+    void Add(uint32 us);
+    void Reset();
+    void Merge(UpdateTimeHistogram const& other);
+
+    uint32 GetCount() const { return _count; }
+    uint32 GetMax() const { return _max; }
+    uint32 GetAverage() const { return _count ? uint32(_total / _count) : 0; }
+    uint64 GetTotal() const { return _total; }
+    // upper bound of the bucket holding the given percentile, capped by the real maximum
+    uint32 GetPercentile(uint32 percent) const;
+
+private:
+    std::array<uint32, UPDATE_TIME_HISTOGRAM_BUCKETS> _buckets;
+    uint32 _count;
+    uint32 _max;
+    uint64 _total;
+};
+
+enum MapUpdatePhase
+{
+    MAP_UPDATE_PHASE_SESSIONS,                              // WorldSession::Update of the map's players
+    MAP_UPDATE_PHASE_PLAYERS,                               // player and local transport ticks
+    MAP_UPDATE_PHASE_OBJECTS,                               // cell visits around players and active objects
+    MAP_UPDATE_PHASE_SEND_UPDATES,                          // SendObjectUpdates
+    MAP_UPDATE_PHASE_GRID_STATES,                           // grid state machine
+    MAP_UPDATE_PHASE_SCRIPTS,                               // ScriptsProcess
+    MAP_UPDATE_PHASE_TOTAL,                                 // whole Map::Update
+    MAX_MAP_UPDATE_PHASE
+};
+
+/// Per map, per phase histograms of Map::Update, written by the map's update thread only
+class MapUpdateTime
+{
+public:
+    void Record(MapUpdatePhase phase, uint32 us) { _phases[phase].Add(us); }
+    UpdateTimeHistogram const& GetPhase(MapUpdatePhase phase) const { return _phases[phase]; }
+    void Reset();
+
+    static char const* GetPhaseName(MapUpdatePhase phase);
+
+private:
+    std::array<UpdateTimeHistogram, MAX_MAP_UPDATE_PHASE> _phases;
+};
+
+/// Measures consecutive phases of one Map::Update call, the total is recorded on destruction
+class MapUpdatePhaseTimer
+{
+public:
+    // the total is also observed by totalMetric (in seconds) if given
+    explicit MapUpdatePhaseTimer(MapUpdateTime& updateTime, MetricHistogram* totalMetric = NULL);
+    ~MapUpdatePhaseTimer();
+
+    // record the time since the previous phase ended (or the update started)
+    void Record(MapUpdatePhase phase);
+
+private:
+    MapUpdatePhaseTimer(MapUpdatePhaseTimer const&);
+    MapUpdatePhaseTimer& operator=(MapUpdatePhaseTimer const&);
+
+    MapUpdateTime& _updateTime;
+    MetricHistogram* _totalMetric;
+    std::chrono::steady_clock::time_point _start;
+    std::chrono::steady_clock::time_point _last;
+};
+
+/// Per opcode handler times, each thread running handlers writes its own histograms, merged on demand
+class OpcodeUpdateTime
+{
+public:
+    struct OpcodeEntry
+    {
+        uint16 opcode;
+        UpdateTimeHistogram histogram;
+    };
+
+    OpcodeUpdateTime();
+
+    void Record(uint16 opcode, uint32 us);
+    // discard all data, each thread drops its histograms on its next Record
+    void Reset();
+    // merged histograms of every opcode handled since the last reset, most total time first
+    void Collect(std::vector<OpcodeEntry>& entries) const;
+    void LogOpcodeTimes(uint32 count);
+
+private:
+    std::atomic<uint32> _generation;
+};
+
+extern OpcodeUpdateTime sOpcodeUpdateTime;
+
+/// Times one opcode handler call, recorded on destruction unless disabled, and added to sessionTime if given
+class OpcodeUpdateTimer
+{
+public:
+    OpcodeUpdateTimer(uint16 opcode, bool enabled, std::atomic<uint64>* sessionTime = NULL) : _opcode(opcode), _enabled(enabled), _sessionTime(sessionTime)
+    {
+        if (_enabled)
+        {
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+    ~OpcodeUpdateTimer();
+
+private:
+    OpcodeUpdateTimer(OpcodeUpdateTimer const&);
+    OpcodeUpdateTimer& operator=(OpcodeUpdateTimer const&);
+
+    uint16 _opcode;
+    bool _enabled;
+    std::atomic<uint64>* _sessionTime;
+    std::chrono::steady_clock::time_point _start;
+};
+
 #endif
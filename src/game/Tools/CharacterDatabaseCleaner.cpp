@@ -27,7 +27,121 @@
 #include "World.h"
 #include "Database/DatabaseEnv.h"
 #include "DBCStores.h"
-#include "ProgressBar.h"
+#include "Timer.h"
+
+#include <ace/Task.h>
+#include <ace/Thread_Mutex.h>
+
+namespace
+{
+    struct CleaningPass
+    {
+        uint32 flag;
+        char const* name;
+        uint32 (*func)();
+    };
+
+    CleaningPass const cleaningPasses[] =
+    {
+        { CharacterDatabaseCleaner::CLEANING_FLAG_SKILLS, "skills", &CharacterDatabaseCleaner::CleanCharacterSkills },
+        { CharacterDatabaseCleaner::CLEANING_FLAG_SPELLS, "spells", &CharacterDatabaseCleaner::CleanCharacterSpell },
+    };
+
+    // one thread per pass, the scans take different connections of the query pool
+    class CleaningThreads : public ACE_Task_Base
+    {
+        public:
+            CleaningThreads() : m_flags(0), m_next(0), m_running(0), m_removed(0), m_start(0) {}
+
+            bool Start(uint32 flags)
+            {
+                ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+                if (m_running)
+                {
+                    return false;
+                }
+
+                // threads of a finished run may still be on their way out
+                wait();
+
+                m_passes.clear();
+                for (size_t i = 0; i < countof(cleaningPasses); ++i)
+                {
+                    if (flags & cleaningPasses[i].flag)
+                    {
+                        m_passes.push_back(&cleaningPasses[i]);
+                    }
+                }
+
+                if (m_passes.empty())
+                {
+                    return true;
+                }
+
+                m_flags = flags;
+                m_next = 0;
+                m_removed = 0;
+                m_start = getMSTime();
+                m_running = uint32(m_passes.size());
+
+                if (activate(THR_NEW_LWP | THR_JOINABLE, int(m_passes.size())) != 0)
+                {
+                    sLog.outError("CharacterDatabaseCleaner: can't start cleaning threads");
+                    m_running = 0;
+                    return false;
+                }
+                return true;
+            }
+
+            bool IsRunning()
+            {
+                ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+                return m_running != 0;
+            }
+
+            int svc() override
+            {
+                CharacterDatabase.ThreadStart();
+
+                CleaningPass const* pass;
+                {
+                    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, -1);
+                    pass = m_passes[m_next++];
+                }
+
+                uint32 start = getMSTime();
+                uint32 removed = pass->func();
+                sLog.outString("Cleaning character %s done: %u rows removed in %u ms", pass->name, removed, getMSTimeDiff(start, getMSTime()));
+
+                {
+                    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, -1);
+
+                    m_removed += removed;
+                    if (--m_running == 0)
+                    {
+                        // the last pass clears the flags of the run
+                        CharacterDatabase.PExecute("UPDATE `saved_variables` SET `cleaning_flags` = `cleaning_flags` & ~%u", m_flags);
+                        sLog.outString("Character database cleaned: %u passes, %u rows removed in %u ms", uint32(m_passes.size()), m_removed, getMSTimeDiff(m_start, getMSTime()));
+                    }
+                }
+
+                CharacterDatabase.ThreadEnd();
+                return 0;
+            }
+
+        private:
+            ACE_Thread_Mutex m_lock;
+            std::vector<CleaningPass const*> m_passes;
+            uint32 m_flags;
+            size_t m_next;
+            uint32 m_running;
+            uint32 m_removed;
+            uint32 m_start;
+    };
+
+    CleaningThreads cleaningThreads;
+}
 
 void CharacterDatabaseCleaner::CleanDatabase()
 {
@@ -49,59 +163,76 @@ void CharacterDatabaseCleaner::CleanDatabase()
     delete result;
 
     // clean up
-    if (flags & CLEANING_FLAG_SKILLS)
-    {
-        CleanCharacterSkills();
-    }
-    if (flags & CLEANING_FLAG_SPELLS)
+    if (cleaningThreads.Start(flags))
     {
-        CleanCharacterSpell();
+        WaitCleaning();
     }
-    CharacterDatabase.Execute("UPDATE `saved_variables` SET `cleaning_flags` = 0");
 }
 
-void CharacterDatabaseCleaner::CheckUnique(const char* column, const char* table, bool (*check)(uint32))
+bool CharacterDatabaseCleaner::StartBackgroundCleaning(uint32 flags)
+{
+    return cleaningThreads.Start(flags);
+}
+
+bool CharacterDatabaseCleaner::IsCleaningRunning()
 {
-    QueryResult* result = CharacterDatabase.PQuery("SELECT DISTINCT `%s` FROM `%s`", column, table);
+    return cleaningThreads.IsRunning();
+}
+
+void CharacterDatabaseCleaner::WaitCleaning()
+{
+    cleaningThreads.wait();
+}
+
+uint32 CharacterDatabaseCleaner::CheckUnique(const char* column, const char* table, bool (*check)(uint32))
+{
+    // one grouped scan gives the distinct values and how many rows each of them has
+    QueryResult* result = CharacterDatabase.PQuery("SELECT `%s`, COUNT(*) FROM `%s` GROUP BY `%s`", column, table, column);
     if (!result)
     {
         sLog.outString("Table %s is empty.", table);
-        return;
+        return 0;
     }
 
-    bool found = false;
-    std::ostringstream ss;
-    BarGoLink bar(result->GetRowCount());
+    std::vector<uint32> invalid;
+    uint32 removed = 0;
     do
     {
-        bar.step();
-
         Field* fields = result->Fetch();
 
         uint32 id = fields[0].GetUInt32();
 
         if (!check(id))
         {
-            if (!found)
-            {
-                ss << "DELETE FROM `" << table << "` WHERE `" << column << "` IN (";
-                found = true;
-            }
-            else
-            {
-                ss << ",";
-            }
-            ss << id;
+            invalid.push_back(id);
+            removed += fields[1].GetUInt32();
         }
     }
     while (result->NextRow());
     delete result;
 
-    if (found)
+    // keep the statements short, a few hundred ids each
+    for (size_t i = 0; i < invalid.size(); i += 500)
     {
+        std::ostringstream ss;
+        ss << "DELETE FROM `" << table << "` WHERE `" << column << "` IN (";
+        for (size_t j = i; j < invalid.size() && j < i + 500; ++j)
+        {
+            if (j != i)
+            {
+                ss << ",";
+            }
+            ss << invalid[j];
+        }
         ss << ")";
         CharacterDatabase.Execute(ss.str().c_str());
     }
+
+    if (!invalid.empty())
+    {
+        sLog.outString("Table %s: %u invalid %s values, %u rows removed.", table, uint32(invalid.size()), column, removed);
+    }
+    return removed;
 }
 
 bool CharacterDatabaseCleaner::SkillCheck(uint32 skill)
@@ -109,9 +240,9 @@ bool CharacterDatabaseCleaner::SkillCheck(uint32 skill)
     return sSkillLineStore.LookupEntry(skill);
 }
 
-void CharacterDatabaseCleaner::CleanCharacterSkills()
+uint32 CharacterDatabaseCleaner::CleanCharacterSkills()
 {
-    CheckUnique("skill", "character_skills", &SkillCheck);
+    return CheckUnique("skill", "character_skills", &SkillCheck);
 }
 
 bool CharacterDatabaseCleaner::SpellCheck(uint32 spell_id)
@@ -119,7 +250,7 @@ bool CharacterDatabaseCleaner::SpellCheck(uint32 spell_id)
     return sSpellStore.LookupEntry(spell_id);
 }
 
-void CharacterDatabaseCleaner::CleanCharacterSpell()
+uint32 CharacterDatabaseCleaner::CleanCharacterSpell()
 {
-    CheckUnique("spell", "character_spell", &SpellCheck);
+    return CheckUnique("spell", "character_spell", &SpellCheck);
 }
@@ -33,18 +33,27 @@ namespace CharacterDatabaseCleaner
         CLEANING_FLAG_SKILLS                = 0x2,
         CLEANING_FLAG_SPELLS                = 0x4,
         // reserved for next version          0x8
+
+        CLEANING_FLAGS_ALL                  = CLEANING_FLAG_SKILLS | CLEANING_FLAG_SPELLS
     };
 
 
     void CleanDatabase();
 
-    void CheckUnique(const char* column, const char* table, bool (*check)(uint32));
+    /// runs the passes of flags on their own threads and connections, false while a run is still going
+    bool StartBackgroundCleaning(uint32 flags);
+    bool IsCleaningRunning();
+    /// waits for a background run to finish
+    void WaitCleaning();
+
+    /// returns the number of removed rows
+    uint32 CheckUnique(const char* column, const char* table, bool (*check)(uint32));
 
     bool SkillCheck(uint32 skill);
     bool SpellCheck(uint32 spell_id);
 
-    void CleanCharacterSkills();
-    void CleanCharacterSpell();
+    uint32 CleanCharacterSkills();
+    uint32 CleanCharacterSpell();
 }
 
 #endif
@@ -29,6 +29,7 @@
 #include "UpdateFields.h"
 #include "ObjectMgr.h"
 #include "AccountMgr.h"
+#include "PlayerNameCache.h"
 
 // Character Dump tables
 struct DumpTable
@@ -243,6 +244,235 @@ bool changetokGuid(std::string& str, int n, std::map<uint32, uint32>& guidMap, u
     return changetoknth(str, n, chritem, false, nonzero);
 }
 
+// Binary dump format, a stream of records:
+//   header      "MPDB", uint8 BINARY_DUMP_VERSION, string db version ("version.structure.X")
+//   'C'         starts the next character
+//   'T'         string table, varint column count, column names as strings: columns of the rows following
+//   'R'         one value per column: uint8 BinaryDumpValue, then an integer or a string
+//   'E'         end of the dump
+// integers are zigzag varints, strings a varint length and the bytes
+static const char BINARY_DUMP_MAGIC[4] = { 'M', 'P', 'D', 'B' };
+static const uint8 BINARY_DUMP_VERSION = 1;
+
+enum BinaryDumpValue
+{
+    BDV_NULL    = 0,
+    BDV_INTEGER = 1,
+    BDV_STRING  = 2
+};
+
+struct BinaryDumpField
+{
+    uint8 type;
+    int64 integer;
+    std::string text;
+};
+
+typedef std::vector<BinaryDumpField> BinaryDumpRow;
+
+static void WriteBinaryInteger(FILE* file, int64 value)
+{
+    uint64 zigzag = (uint64(value) << 1) ^ uint64(value >> 63);
+    do
+    {
+        uint8 byte = zigzag & 0x7F;
+        zigzag >>= 7;
+        fputc(zigzag ? byte | 0x80 : byte, file);
+    }
+    while (zigzag);
+}
+
+static void WriteBinaryString(FILE* file, char const* str, size_t size)
+{
+    WriteBinaryInteger(file, int64(size));
+    fwrite(str, 1, size, file);
+}
+
+static bool ReadBinaryInteger(FILE* file, int64& value)
+{
+    uint64 zigzag = 0;
+    for (uint32 shift = 0; shift < 64; shift += 7)
+    {
+        int byte = fgetc(file);
+        if (byte == EOF)
+        {
+            return false;
+        }
+
+        zigzag |= uint64(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            value = int64(zigzag >> 1) ^ -int64(zigzag & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ReadBinaryString(FILE* file, std::string& str)
+{
+    int64 size;
+    if (!ReadBinaryInteger(file, size) || size < 0 || size > MAX_QUERY_LEN)
+    {
+        return false;
+    }
+
+    str.resize(size_t(size));
+    return !size || fread(&str[0], 1, size_t(size), file) == size_t(size);
+}
+
+// integers are stored as such when the text converts back unchanged
+static bool IsDumpInteger(char const* value, int64& integer)
+{
+    char const* digits = value[0] == '-' ? value + 1 : value;
+    if (!digits[0] || (digits[0] == '0' && (digits[1] || digits != value)) || strlen(digits) > 18)
+    {
+        return false;
+    }
+
+    for (char const* c = digits; *c; ++c)
+    {
+        if (*c < '0' || *c > '9')
+        {
+            return false;
+        }
+    }
+
+    integer = strtoll(value, NULL, 10);
+    return true;
+}
+
+static void WriteBinaryRow(FILE* file, QueryResult* result)
+{
+    Field* fields = result->Fetch();
+
+    fputc('R', file);
+    for (uint32 i = 0; i < result->GetFieldCount(); ++i)
+    {
+        int64 integer;
+        char const* value = fields[i].GetString();
+        if (!value)
+        {
+            fputc(BDV_NULL, file);
+        }
+        else if (IsDumpInteger(value, integer))
+        {
+            fputc(BDV_INTEGER, file);
+            WriteBinaryInteger(file, integer);
+        }
+        else
+        {
+            fputc(BDV_STRING, file);
+            WriteBinaryString(file, value, strlen(value));
+        }
+    }
+}
+
+static bool ReadBinaryRow(FILE* file, BinaryDumpRow& row)
+{
+    for (BinaryDumpRow::iterator itr = row.begin(); itr != row.end(); ++itr)
+    {
+        int type = fgetc(file);
+        switch (type)
+        {
+            case BDV_NULL:
+                break;
+            case BDV_INTEGER:
+                if (!ReadBinaryInteger(file, itr->integer))
+                {
+                    return false;
+                }
+                break;
+            case BDV_STRING:
+                if (!ReadBinaryString(file, itr->text))
+                {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+        itr->type = uint8(type);
+    }
+    return true;
+}
+
+// n is 1-based like for the text dump helpers
+static bool SetDumpInteger(BinaryDumpRow& row, uint32 n, int64 value)
+{
+    if (n > row.size())
+    {
+        return false;
+    }
+
+    row[n - 1].type = BDV_INTEGER;
+    row[n - 1].integer = value;
+    return true;
+}
+
+static bool ChangeDumpGuid(BinaryDumpRow& row, uint32 n, std::map<uint32, uint32>& guidMap, uint32 hiGuid, bool nonzero = false)
+{
+    if (n > row.size() || row[n - 1].type != BDV_INTEGER)
+    {
+        return false;
+    }
+
+    if (nonzero && row[n - 1].integer == 0)
+    {
+        return true;                                         // not an error
+    }
+
+    row[n - 1].integer = registerNewGuid(uint32(row[n - 1].integer), guidMap, hiGuid);
+    return true;
+}
+
+static std::string CreateDumpString(std::string const& tableName, std::string const& columns, BinaryDumpRow const& row)
+{
+    std::ostringstream ss;
+    ss << "INSERT INTO `" << tableName << "` (" << columns << ") VALUES (";
+    for (uint32 i = 0; i < row.size(); ++i)
+    {
+        if (i != 0)
+        {
+            ss << ", ";
+        }
+
+        switch (row[i].type)
+        {
+            case BDV_NULL:
+                ss << "NULL";
+                break;
+            case BDV_INTEGER:
+                ss << "'" << row[i].integer << "'";
+                break;
+            default:
+            {
+                std::string s = row[i].text;
+                CharacterDatabase.escape_string(s);
+                ss << "'" << s << "'";
+                break;
+            }
+        }
+    }
+    ss << ");";
+    return ss.str();
+}
+
+// version and structure of the character DB, as compared by the loaders
+static std::string GetCharacterDBVersion()
+{
+    QueryResult* result = CharacterDatabase.Query("SELECT `version`, `structure` FROM `db_version` ORDER BY `version` DESC, `structure` DESC, `content` ASC LIMIT 1");
+    if (!result)
+    {
+        return "";
+    }
+
+    Field* fields = result->Fetch();
+    std::string dbversion = std::to_string(fields[0].GetInt16()) + "." + std::to_string(fields[1].GetInt16()) + ".X";
+    delete result;
+    return dbversion;
+}
+
 std::string CreateDumpString(char const* tableName, char const* tableColumnNamesAsChars, QueryResult* result)
 {
     if (!tableName || !result)
@@ -397,6 +627,17 @@ void PlayerDumpWriter::DumpTableContent(std::string& dump, uint32 guid, char con
             return;
         }
 
+        if (m_binaryOut)
+        {
+            fputc('T', m_binaryOut);
+            WriteBinaryString(m_binaryOut, tableTo, strlen(tableTo));
+            WriteBinaryInteger(m_binaryOut, int64(namesMap.size()));
+            for (QueryFieldNames::const_iterator itr = namesMap.begin(); itr != namesMap.end(); ++itr)
+            {
+                WriteBinaryString(m_binaryOut, itr->c_str(), itr->size());
+            }
+        }
+
         do
         {
             // collect guids
@@ -413,8 +654,15 @@ void PlayerDumpWriter::DumpTableContent(std::string& dump, uint32 guid, char con
                 default:                       break;
             }
 
-            dump += CreateDumpString(tableTo, tableColumnNamesStr.c_str(), result);
-            dump += "\n";
+            if (m_binaryOut)
+            {
+                WriteBinaryRow(m_binaryOut, result);
+            }
+            else
+            {
+                dump += CreateDumpString(tableTo, tableColumnNamesStr.c_str(), result);
+                dump += "\n";
+            }
         }
         while (result->NextRow());
 
@@ -479,32 +727,55 @@ DumpReturn PlayerDumpWriter::WriteDump(const std::string& file, uint32 guid)
     return DUMP_SUCCESS;
 }
 
-// Reading - High-level functions
-#define ROLLBACK(DR) {CharacterDatabase.RollbackTransaction(); fclose(fin); return (DR);}
-
-DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, std::string name, uint32 guid)
+DumpReturn PlayerDumpWriter::WriteBinaryDump(const std::string& file, std::vector<uint32> const& guids)
 {
-    // check character count
-    uint32 charcount = sAccountMgr.GetCharactersCount(account);
-    if (charcount >= 10)
+    std::string dbversion = GetCharacterDBVersion();
+    if (dbversion.empty())
     {
-        return DUMP_TOO_MANY_CHARS;
+        sLog.outError("Character DB not have 'db_version' table");
     }
 
-    FILE* fin = fopen(file.c_str(), "r");
-    if (!fin)
+    m_binaryOut = fopen(file.c_str(), "wb");
+    if (!m_binaryOut)
     {
         return DUMP_FILE_OPEN_ERROR;
     }
 
-    QueryResult* result;
-    char newguid[20], chraccount[20], newpetid[20], currpetid[20], lastpetid[20];
+    fwrite(BINARY_DUMP_MAGIC, 1, sizeof(BINARY_DUMP_MAGIC), m_binaryOut);
+    fputc(BINARY_DUMP_VERSION, m_binaryOut);
+    WriteBinaryString(m_binaryOut, dbversion.c_str(), dbversion.size());
+
+    std::string unused;
+    for (std::vector<uint32>::const_iterator guid = guids.begin(); guid != guids.end(); ++guid)
+    {
+        pets.clear();
+        mails.clear();
+        items.clear();
 
+        fputc('C', m_binaryOut);
+        for (DumpTable* itr = &dumpTables[0]; itr->isValid(); ++itr)
+        {
+            DumpTableContent(unused, *guid, itr->name, itr->name, itr->type);
+        }
+    }
+    fputc('E', m_binaryOut);
+
+    bool failed = ferror(m_binaryOut) != 0;
+    fclose(m_binaryOut);
+    m_binaryOut = NULL;
+    return failed ? DUMP_FILE_OPEN_ERROR : DUMP_SUCCESS;
+}
+
+// Reading - High-level functions
+#define ROLLBACK(DR) {CharacterDatabase.RollbackTransaction(); fclose(fin); return (DR);}
+
+void PlayerDumpReader::PrepareCharacter(uint32& guid, std::string& name, bool& incHighest)
+{
     // make sure the same guid doesn't already exist and is safe to use
-    bool incHighest = true;
+    incHighest = true;
     if (guid != 0 && guid < sObjectMgr.m_CharGuids.GetNextAfterMaxUsed())
     {
-        result = CharacterDatabase.PQuery("SELECT * FROM `characters` WHERE `guid` = '%u'", guid);
+        QueryResult* result = CharacterDatabase.PQuery("SELECT * FROM `characters` WHERE `guid` = '%u'", guid);
         if (result)
         {
             guid = sObjectMgr.m_CharGuids.GetNextAfterMaxUsed();
@@ -529,7 +800,7 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
     if (ObjectMgr::CheckPlayerName(name, true) == CHAR_NAME_SUCCESS)
     {
         CharacterDatabase.escape_string(name);              // for safe, we use name only for sql quearies anyway
-        result = CharacterDatabase.PQuery("SELECT * FROM `characters` WHERE `name` = '%s'", name.c_str());
+        QueryResult* result = CharacterDatabase.PQuery("SELECT * FROM `characters` WHERE `name` = '%s'", name.c_str());
         if (result)
         {
             name.clear();                                      // use the one from the dump
@@ -540,6 +811,42 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
     {
         name.clear();
     }
+}
+
+DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, std::string name, uint32 guid)
+{
+    // check character count
+    uint32 charcount = sAccountMgr.GetCharactersCount(account);
+    if (charcount >= 10)
+    {
+        return DUMP_TOO_MANY_CHARS;
+    }
+
+    FILE* fin = fopen(file.c_str(), "rb");
+    if (!fin)
+    {
+        return DUMP_FILE_OPEN_ERROR;
+    }
+
+    char magic[sizeof(BINARY_DUMP_MAGIC)];
+    if (fread(magic, 1, sizeof(magic), fin) == sizeof(magic) && !memcmp(magic, BINARY_DUMP_MAGIC, sizeof(magic)))
+    {
+        return LoadBinaryDump(fin, account, name, guid);
+    }
+
+    // text dump, read it again line by line
+    fclose(fin);
+    fin = fopen(file.c_str(), "r");
+    if (!fin)
+    {
+        return DUMP_FILE_OPEN_ERROR;
+    }
+
+    QueryResult* result;
+    char newguid[20], chraccount[20], newpetid[20], currpetid[20], lastpetid[20];
+
+    bool incHighest;
+    PrepareCharacter(guid, name, incHighest);
 
     // name encoded or empty
 
@@ -557,6 +864,9 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
     typedef PetIds::value_type PetIdsPair;
     PetIds petids;
 
+    std::string charName;
+    uint8 charRace = 0, charGender = 0, charClass = 0;
+
     CharacterDatabase.BeginTransaction();
     while (!feof(fin))
     {
@@ -686,6 +996,10 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                     }
                 }
 
+                charName = getnth(line, 3);
+                charRace = uint8(atoi(getnth(line, 4).c_str()));   // characters.race
+                charClass = uint8(atoi(getnth(line, 5).c_str()));  // characters.class
+                charGender = uint8(atoi(getnth(line, 6).c_str())); // characters.gender
                 break;
             }
             case DTT_INVENTORY:
@@ -859,7 +1173,279 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
         sObjectMgr.m_CharGuids.Set(sObjectMgr.m_CharGuids.GetNextAfterMaxUsed() + 1);
     }
 
+    sPlayerNameCache.Add(guid, charName, charRace, charGender, charClass);
+
     fclose(fin);
 
     return DUMP_SUCCESS;
 }
+
+DumpReturn PlayerDumpReader::LoadBinaryDump(FILE* fin, uint32 account, std::string name, uint32 guid)
+{
+    int version = fgetc(fin);
+    std::string dbversionInDumpFile;
+    if (version != BINARY_DUMP_VERSION || !ReadBinaryString(fin, dbversionInDumpFile))
+    {
+        fclose(fin);
+        return DUMP_FILE_BROKEN;
+    }
+
+    std::string dbversion = GetCharacterDBVersion();
+    if (!dbversion.empty() && dbversionInDumpFile != dbversion)
+    {
+        sLog.outError("LoadPlayerDump: Cannot load player dump - file version is %s, DB needs %s", dbversionInDumpFile.c_str(), dbversion.c_str());
+        fclose(fin);
+        return DUMP_DB_VERSION_MISMATCH;
+    }
+
+    // the DB count lags behind the queued transactions of earlier characters
+    uint32 charcount = sAccountMgr.GetCharactersCount(account);
+    bool inCharacter = false;
+    bool incHighest = false;
+
+    std::map<uint32, uint32> items;
+    std::map<uint32, uint32> mails;
+    std::map<uint32, uint32> petids;                        // old->new petid relation
+
+    std::string charName;
+    uint8 charRace = 0, charGender = 0, charClass = 0;
+
+    std::string tableName;
+    std::string columns;
+    DumpTableType type = DTT_CHARACTER;
+    BinaryDumpRow row;
+
+    for (;;)
+    {
+        int record = fgetc(fin);
+        if (record == EOF)
+        {
+            ROLLBACK(DUMP_UNEXPECTED_END);
+        }
+
+        if (record == 'C' || record == 'E')
+        {
+            if (inCharacter)
+            {
+                CharacterDatabase.CommitTransaction();
+
+                // FIXME: current code with post-updating guids not safe for future per-map threads
+                sObjectMgr.m_ItemGuids.Set(sObjectMgr.m_ItemGuids.GetNextAfterMaxUsed() + items.size());
+                sObjectMgr.m_MailIds.Set(sObjectMgr.m_MailIds.GetNextAfterMaxUsed() + mails.size());
+
+                if (incHighest)
+                {
+                    sObjectMgr.m_CharGuids.Set(sObjectMgr.m_CharGuids.GetNextAfterMaxUsed() + 1);
+                }
+
+                sPlayerNameCache.Add(guid, charName, charRace, charGender, charClass);
+
+                ++charcount;
+                inCharacter = false;
+
+                // name and guid were meant for the first character only
+                name.clear();
+                guid = 0;
+            }
+
+            if (record == 'E')
+            {
+                break;
+            }
+
+            if (charcount >= 10)
+            {
+                fclose(fin);
+                return DUMP_TOO_MANY_CHARS;
+            }
+
+            PrepareCharacter(guid, name, incHighest);
+            items.clear();
+            mails.clear();
+            petids.clear();
+            tableName.clear();
+
+            CharacterDatabase.BeginTransaction();
+            inCharacter = true;
+            continue;
+        }
+
+        if (!inCharacter)
+        {
+            ROLLBACK(DUMP_FILE_BROKEN);
+        }
+
+        if (record == 'T')
+        {
+            int64 count;
+            if (!ReadBinaryString(fin, tableName) || !ReadBinaryInteger(fin, count) || count <= 0)
+            {
+                ROLLBACK(DUMP_FILE_BROKEN);
+            }
+
+            DumpTable* dTable = &dumpTables[0];
+            for (; dTable->isValid(); ++dTable)
+            {
+                if (tableName == dTable->name)
+                {
+                    type = dTable->type;
+                    break;
+                }
+            }
+
+            if (!dTable->isValid())
+            {
+                sLog.outError("LoadPlayerDump: Unknown table: '%s'!", tableName.c_str());
+                ROLLBACK(DUMP_FILE_BROKEN);
+            }
+
+            columns.clear();
+            for (int64 i = 0; i < count; ++i)
+            {
+                std::string column;
+                if (!ReadBinaryString(fin, column))
+                {
+                    ROLLBACK(DUMP_FILE_BROKEN);
+                }
+
+                columns += (i ? ",`" : "`") + column + "`";
+            }
+
+            row.assign(size_t(count), BinaryDumpField());
+            continue;
+        }
+
+        if (record != 'R' || tableName.empty() || !ReadBinaryRow(fin, row))
+        {
+            ROLLBACK(DUMP_FILE_BROKEN);
+        }
+
+        // change the data to server values
+        bool changed = true;
+        switch (type)
+        {
+            case DTT_CHAR_TABLE:
+                changed = SetDumpInteger(row, 1, guid);     // character_*.guid update
+                break;
+
+            case DTT_CHARACTER:
+            {
+                changed = SetDumpInteger(row, 1, guid) &&   // characters.guid update
+                          SetDumpInteger(row, 2, account) && // characters.account update
+                          row.size() >= 35;
+                if (!changed)
+                {
+                    break;
+                }
+
+                if (name.empty())
+                {
+                    // check if the original name already exists
+                    std::string dumpName = row[2].text;     // characters.name
+                    CharacterDatabase.escape_string(dumpName);
+
+                    QueryResult* result = CharacterDatabase.PQuery("SELECT * FROM `characters` WHERE `name` = '%s'", dumpName.c_str());
+                    if (result)
+                    {
+                        delete result;
+                        changed = SetDumpInteger(row, 35, 1); // characters.at_login set to "rename on login"
+                    }
+                }
+                else
+                {
+                    row[2].type = BDV_STRING;               // characters.name update
+                    row[2].text = name;
+                }
+
+                charName = row[2].text;
+                charRace = uint8(row[3].integer);           // characters.race
+                charClass = uint8(row[4].integer);          // characters.class
+                charGender = uint8(row[5].integer);         // characters.gender
+                break;
+            }
+            case DTT_INVENTORY:
+                changed = SetDumpInteger(row, 1, guid) &&   // character_inventory.guid update
+                          ChangeDumpGuid(row, 2, items, sObjectMgr.m_ItemGuids.GetNextAfterMaxUsed(), true) && // character_inventory.bag update
+                          ChangeDumpGuid(row, 4, items, sObjectMgr.m_ItemGuids.GetNextAfterMaxUsed()); // character_inventory.item update
+                break;
+
+            case DTT_ITEM:
+            {
+                // item, owner, data field:item, owner guid
+                changed = ChangeDumpGuid(row, 1, items, sObjectMgr.m_ItemGuids.GetNextAfterMaxUsed()) && // item_instance.guid update
+                          SetDumpInteger(row, 2, guid) &&   // item_instance.owner_guid update
+                          row.size() >= 3 && row[2].type == BDV_STRING;
+                if (!changed)
+                {
+                    break;
+                }
+
+                char newguid[20];
+                snprintf(newguid, 20, "%u", guid);
+                std::string& vals = row[2].text;            // item_instance.data update
+                changed = changetokGuid(vals, OBJECT_FIELD_GUID + 1, items, sObjectMgr.m_ItemGuids.GetNextAfterMaxUsed()) &&
+                          changetoknth(vals, ITEM_FIELD_OWNER + 1, newguid);
+                break;
+            }
+            case DTT_ITEM_GIFT:
+                changed = SetDumpInteger(row, 1, guid) &&   // character_gifts.guid update
+                          ChangeDumpGuid(row, 2, items, sObjectMgr.m_ItemGuids.GetNextAfterMaxUsed()); // character_gifts.item_guid update
+                break;
+
+            case DTT_ITEM_LOOT:
+                changed = ChangeDumpGuid(row, 1, items, sObjectMgr.m_ItemGuids.GetNextAfterMaxUsed()) && // item_loot.guid update
+                          SetDumpInteger(row, 2, guid);     // item_loot.owner_guid update
+                break;
+
+            case DTT_PET:
+            {
+                if (row.empty() || row[0].type != BDV_INTEGER)
+                {
+                    changed = false;
+                    break;
+                }
+
+                // store a map of old pet id to new inserted pet id for use by pet tables
+                std::map<uint32, uint32>::const_iterator petids_iter = petids.find(uint32(row[0].integer));
+                if (petids_iter == petids.end())
+                {
+                    petids_iter = petids.insert(std::make_pair(uint32(row[0].integer), sObjectMgr.GeneratePetNumber())).first;
+                }
+
+                changed = SetDumpInteger(row, 1, petids_iter->second) && // character_pet.id update
+                          SetDumpInteger(row, 3, guid);     // character_pet.owner update
+                break;
+            }
+            case DTT_PET_TABLE:                             // pet_aura, pet_spell, pet_spell_cooldown
+            {
+                // lookup the pet id and match to new inserted pet id
+                std::map<uint32, uint32>::const_iterator petids_iter = row.empty() ? petids.end() : petids.find(uint32(row[0].integer));
+                changed = petids_iter != petids.end() &&
+                          SetDumpInteger(row, 1, petids_iter->second); // pet_*.guid -> petid in fact
+                break;
+            }
+            case DTT_MAIL:                                  // mail
+                changed = ChangeDumpGuid(row, 1, mails, sObjectMgr.m_MailIds.GetNextAfterMaxUsed()) && // mail.id update
+                          SetDumpInteger(row, 6, guid);     // mail.receiver update
+                break;
+
+            case DTT_MAIL_ITEM:                             // mail_items
+                changed = ChangeDumpGuid(row, 1, mails, sObjectMgr.m_MailIds.GetNextAfterMaxUsed()) && // mail_items.id
+                          ChangeDumpGuid(row, 2, items, sObjectMgr.m_ItemGuids.GetNextAfterMaxUsed()) && // mail_items.item_guid
+                          SetDumpInteger(row, 4, guid);     // mail_items.receiver
+                break;
+
+            default:
+                sLog.outError("Unknown dump table type: %u", type);
+                break;
+        }
+
+        if (!changed || !CharacterDatabase.Execute(CreateDumpString(tableName, columns, row).c_str()))
+        {
+            ROLLBACK(DUMP_FILE_BROKEN);
+        }
+    }
+
+    fclose(fin);
+    return DUMP_SUCCESS;
+}
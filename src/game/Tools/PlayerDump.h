@@ -26,6 +26,7 @@
 #define MANGOS_H_PLAYER_DUMP
 
 #include <set>
+#include <vector>
 
 enum DumpTableType
 {
@@ -74,13 +75,20 @@ class PlayerDump
 class PlayerDumpWriter : public PlayerDump
 {
     public:
-        PlayerDumpWriter() {}
+        PlayerDumpWriter() : m_binaryOut(NULL) {}
 
         std::string GetDump(uint32 guid);
         DumpReturn WriteDump(const std::string& file, uint32 guid);
+        /**
+         * Writes the characters into one binary dump, the rows are streamed to the file
+         * as they are read. PlayerDumpReader::LoadDump recognizes the format.
+         */
+        DumpReturn WriteBinaryDump(const std::string& file, std::vector<uint32> const& guids);
     private:
         typedef std::set<uint32> GUIDs;
 
+        FILE* m_binaryOut;                                  // rows go here instead of the text dump
+
         void DumpTableContent(std::string& dump, uint32 guid, char const* tableFrom, char const* tableTo, DumpTableType type);
         std::string GenerateWhereStr(char const* field, GUIDs const& guids, GUIDs::const_iterator& itr);
         std::string GenerateWhereStr(char const* field, uint32 guid);
@@ -95,7 +103,17 @@ class PlayerDumpReader : public PlayerDump
     public:
         PlayerDumpReader() {}
 
+        /**
+         * Loads a text or binary dump. Binary dumps may hold several characters, name and
+         * guid only apply to the first of them, the others get new guids.
+         */
         DumpReturn LoadDump(const std::string& file, uint32 account, std::string name, uint32 guid);
+
+    private:
+        DumpReturn LoadBinaryDump(FILE* fin, uint32 account, std::string name, uint32 guid);
+
+        /// picks the guid and name of a loaded character, an empty name keeps the dumped one
+        void PrepareCharacter(uint32& guid, std::string& name, bool& incHighest);
 };
 
 #endif
@@ -29,25 +29,32 @@
 #include "WorldSession.h"
 #include "Log.h"
 #include "Database/DatabaseEnv.h"
+#include "HMACSHA1.h"
+#include "Util.h"
 #include "WardenCheckMgr.h"
 #include "Warden.h"
 
-WardenCheckMgr::WardenCheckMgr() : m_lock(0), CheckStore(), CheckResultStore() { }
+// MODULE_CHECK seeds prepared per check, the requests pick one of them at random
+#define WARDEN_MODULE_SEEDS 16
+
+WardenCheckMgr::WardenCheckMgr() : m_lock(0), BuildCheckStore() { }
 
 WardenCheckMgr::~WardenCheckMgr()
 {
-    for (CheckMap::iterator it = CheckStore.begin(); it != CheckStore.end(); ++it)
+    for (BuildCheckMap::iterator build = BuildCheckStore.begin(); build != BuildCheckStore.end(); ++build)
     {
-        delete it->second;
-    }
+        for (std::map<uint16, WardenCheck*>::iterator it = build->second.Checks.begin(); it != build->second.Checks.end(); ++it)
+        {
+            delete it->second;
+        }
 
-    for (CheckResultMap::iterator it = CheckResultStore.begin(); it != CheckResultStore.end(); ++it)
-    {
-        delete it->second;
+        for (std::map<uint16, WardenCheckResult*>::iterator it = build->second.Results.begin(); it != build->second.Results.end(); ++it)
+        {
+            delete it->second;
+        }
     }
 
-    CheckStore.clear();
-    CheckResultStore.clear();
+    BuildCheckStore.clear();
 }
 
 void WardenCheckMgr::LoadWardenChecks()
@@ -106,6 +113,13 @@ void WardenCheckMgr::LoadWardenChecks()
             }
         }
 
+        // the request bytes are taken once here, BigNumber::AsByteArray rewrites a buffer inside the number
+        if (checkType == PAGE_CHECK_A || checkType == PAGE_CHECK_B || checkType == DRIVER_CHECK)
+        {
+            uint8 const* bytes = wardenCheck->Data.AsByteArray(0, false);
+            wardenCheck->DataBytes.assign(bytes, bytes + wardenCheck->Data.GetNumBytes());
+        }
+
         if (checkType == MEM_CHECK || checkType == PAGE_CHECK_A || checkType == PAGE_CHECK_B || checkType == PROC_CHECK)
         {
             wardenCheck->Address = address;
@@ -118,7 +132,35 @@ void WardenCheckMgr::LoadWardenChecks()
             wardenCheck->Str = str;
         }
 
-        CheckStore.insert(std::pair<uint16, WardenCheck*>(build, wardenCheck));
+        if (checkType == MODULE_CHECK)
+        {
+            wardenCheck->ModuleSeeds.resize(WARDEN_MODULE_SEEDS);
+            for (std::vector<WardenModuleSeed>::iterator seed = wardenCheck->ModuleSeeds.begin(); seed != wardenCheck->ModuleSeeds.end(); ++seed)
+            {
+                seed->Seed = rand32();
+                HMACSHA1 hmac(4, (uint8*)&seed->Seed);
+                hmac.UpdateData(wardenCheck->Str);
+                hmac.Finalize();
+                memcpy(seed->Digest, hmac.GetDigest(), sizeof(seed->Digest));
+            }
+        }
+
+        // a repeated id replaces the earlier row, as the last one was used before
+        WardenBuildChecks& buildChecks = BuildCheckStore[build];
+        WardenCheck*& stored = buildChecks.Checks[id];
+        if (stored)
+        {
+            delete stored;
+        }
+        else
+        {
+            if (checkType == MEM_CHECK || checkType == MODULE_CHECK)
+            {
+                buildChecks.MemCheckIds.push_back(id);
+            }
+            buildChecks.OtherCheckIds.push_back(id);
+        }
+        stored = wardenCheck;
 
         if (checkType == MPQ_CHECK || checkType == MEM_CHECK)
         {
@@ -135,7 +177,18 @@ void WardenCheckMgr::LoadWardenChecks()
                 wr->Result.SetBinary((uint8*)temp, len);
                 delete[] temp;
             }
-            CheckResultStore.insert(std::pair<uint16, WardenCheckResult*>(build, wr));
+
+            // compared with up to Length (MEM_CHECK) or 20 (MPQ_CHECK SHA1) reply bytes
+            uint8 const* bytes = wr->Result.AsByteArray(0, false);
+            wr->ResultBytes.assign(bytes, bytes + wr->Result.GetNumBytes());
+            if (wr->ResultBytes.size() < std::max<size_t>(length, 20))
+            {
+                wr->ResultBytes.resize(std::max<size_t>(length, 20), 0);
+            }
+
+            WardenCheckResult*& storedResult = buildChecks.Results[id];
+            delete storedResult;
+            storedResult = wr;
         }
 
         if (comment.empty())
@@ -192,9 +245,10 @@ void WardenCheckMgr::LoadWardenOverrides()
         else
         {
             bool found = false;
-            for (CheckMap::iterator it = CheckStore.begin(); it != CheckStore.end(); ++it)
+            for (BuildCheckMap::iterator build = BuildCheckStore.begin(); build != BuildCheckStore.end(); ++build)
             {
-                if (it->second->CheckId == checkId)
+                std::map<uint16, WardenCheck*>::iterator it = build->second.Checks.find(checkId);
+                if (it != build->second.Checks.end())
                 {
                     it->second->Action = WardenActions(action);
                     ++count;
@@ -212,53 +266,30 @@ void WardenCheckMgr::LoadWardenOverrides()
 
 WardenCheck* WardenCheckMgr::GetWardenDataById(uint16 build, uint16 id)
 {
-    WardenCheck* result = NULL;
-
-    ACE_READ_GUARD_RETURN(LOCK, g, m_lock, result)
-    for (CheckMap::iterator it = CheckStore.lower_bound(build); it != CheckStore.upper_bound(build); ++it)
-    {
-        if (it->second->CheckId == id)
-        {
-            result = it->second;
-        }
-    }
-
-    return result;
+    WardenBuildChecks const* checks = GetBuildChecks(build);
+    return checks ? const_cast<WardenCheck*>(checks->GetCheck(id)) : NULL;
 }
 
 WardenCheckResult* WardenCheckMgr::GetWardenResultById(uint16 build, uint16 id)
 {
-    WardenCheckResult* result = NULL;
-
-    ACE_READ_GUARD_RETURN(LOCK, g, m_lock, result)
-    for (CheckResultMap::iterator it = CheckResultStore.lower_bound(build); it != CheckResultStore.upper_bound(build); ++it)
-    {
-        if (it->second->Id == id)
-        {
-            result = it->second;
-        }
-    }
-
-    return result;
+    WardenBuildChecks const* checks = GetBuildChecks(build);
+    return checks ? const_cast<WardenCheckResult*>(checks->GetResult(id)) : NULL;
 }
 
 void WardenCheckMgr::GetWardenCheckIds(bool isMemCheck, uint16 build, std::list<uint16>& idl)
 {
     idl.clear(); //just to be sure
 
-    ACE_READ_GUARD(LOCK, g, m_lock)
-    for (CheckMap::iterator it = CheckStore.lower_bound(build); it != CheckStore.upper_bound(build); ++it)
+    if (WardenBuildChecks const* checks = GetBuildChecks(build))
     {
-        if (isMemCheck)
-        {
-            if ((it->second->Type == MEM_CHECK) || (it->second->Type == MODULE_CHECK))
-            {
-                idl.push_back(it->second->CheckId);
-            }
-        }
-        else
-        {
-            idl.push_back(it->second->CheckId);
-        }
+        std::vector<uint16> const& ids = isMemCheck ? checks->MemCheckIds : checks->OtherCheckIds;
+        idl.assign(ids.begin(), ids.end());
     }
 }
+
+WardenBuildChecks const* WardenCheckMgr::GetBuildChecks(uint16 build)
+{
+    ACE_READ_GUARD_RETURN(LOCK, g, m_lock, NULL)
+    BuildCheckMap::const_iterator itr = BuildCheckStore.find(build);
+    return itr != BuildCheckStore.end() ? &itr->second : NULL;
+}
@@ -27,6 +27,7 @@
 #define _WARDENCHECKMGR_H
 
 #include <map>
+#include <vector>
 #include "BigNumber.h"
 
 enum WardenActions
@@ -36,13 +37,22 @@ enum WardenActions
     WARDEN_ACTION_BAN
 };
 
+// a MODULE_CHECK seed with the HMAC of the module name under it
+struct WardenModuleSeed
+{
+    uint32 Seed;
+    uint8 Digest[20];
+};
+
 struct WardenCheck
 {
     uint8 Type;
     BigNumber Data;
+    std::vector<uint8> DataBytes;                           // Data as sent in requests, PAGE_CHECK, DRIVER_CHECK
     uint32 Address;                                         // PROC_CHECK, MEM_CHECK, PAGE_CHECK
     uint8 Length;                                           // PROC_CHECK, MEM_CHECK, PAGE_CHECK
     std::string Str;                                        // LUA, MPQ, DRIVER
+    std::vector<WardenModuleSeed> ModuleSeeds;              // MODULE_CHECK, one is picked per request
     std::string Comment;
     uint16 CheckId;
     enum WardenActions Action;
@@ -52,6 +62,28 @@ struct WardenCheckResult
 {
     uint16 Id;
     BigNumber Result;                                       // MEM_CHECK
+    std::vector<uint8> ResultBytes;                         // Result as replied by a clean client, MEM_CHECK, MPQ_CHECK
+};
+
+// the checks of one client build, built at loading and not changed afterwards
+struct WardenBuildChecks
+{
+    WardenCheck const* GetCheck(uint16 id) const
+    {
+        std::map<uint16, WardenCheck*>::const_iterator itr = Checks.find(id);
+        return itr != Checks.end() ? itr->second : NULL;
+    }
+
+    WardenCheckResult const* GetResult(uint16 id) const
+    {
+        std::map<uint16, WardenCheckResult*>::const_iterator itr = Results.find(id);
+        return itr != Results.end() ? itr->second : NULL;
+    }
+
+    std::map<uint16, WardenCheck*> Checks;
+    std::map<uint16, WardenCheckResult*> Results;
+    std::vector<uint16> MemCheckIds;                        // MEM_CHECK and MODULE_CHECK
+    std::vector<uint16> OtherCheckIds;                      // all checks
 };
 
 class WardenCheckMgr
@@ -70,18 +102,18 @@ class WardenCheckMgr
         WardenCheck* GetWardenDataById(uint16 /*build*/, uint16 /*id*/);
         WardenCheckResult* GetWardenResultById(uint16 /*build*/, uint16 /*id*/);
         void GetWardenCheckIds(bool isMemCheck /* true = MEM */, uint16 build, std::list<uint16>& list);
+        // all checks of a build, NULL if there are none; valid for the lifetime of the server
+        WardenBuildChecks const* GetBuildChecks(uint16 build);
 
         void LoadWardenChecks();
         void LoadWardenOverrides();
 
     private:
         typedef ACE_RW_Thread_Mutex LOCK;
-        typedef std::multimap< uint16, WardenCheck* > CheckMap;
-        typedef std::multimap< uint16, WardenCheckResult* > CheckResultMap;
+        typedef std::map< uint16, WardenBuildChecks > BuildCheckMap;
 
         LOCK           m_lock;
-        CheckMap       CheckStore;
-        CheckResultMap CheckResultStore;
+        BuildCheckMap  BuildCheckStore;
 
 };
 
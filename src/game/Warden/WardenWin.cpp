@@ -41,7 +41,7 @@
 #include "WardenCheckMgr.h"
 #include "GameTime.h"
 
-WardenWin::WardenWin() : Warden(), _serverTicks(0) {}
+WardenWin::WardenWin() : Warden(), _serverTicks(0), _checks(NULL) {}
 
 WardenWin::~WardenWin() { }
 
@@ -57,6 +57,7 @@ void WardenWin::Init(WorldSession* session, BigNumber* k)
 
     _inputCrypto.Init(_inputKey);
     _outputCrypto.Init(_outputKey);
+    _checks = sWardenCheckMgr->GetBuildChecks(_session->GetClientBuild());
     sLog.outWarden("Server side warden for client %u (build %u) initializing...", session->GetAccountId(), _session->GetClientBuild());
     sLog.outWarden("C->S Key: %s", ByteArrayToHexStr(_inputKey, 16).c_str());
     sLog.outWarden("S->C Key: %s", ByteArrayToHexStr(_outputKey, 16).c_str());
@@ -160,24 +161,32 @@ void WardenWin::HandleHashResult(ByteBuffer &buff)
     _previousTimestamp = GameTime::GetGameTimeMS();
 }
 
+void WardenWin::FillChecksTodo(std::vector<uint16> const& ids, std::vector<uint16>& todo)
+{
+    todo = ids;
+    for (size_t i = todo.size(); i > 1; --i)
+    {
+        std::swap(todo[i - 1], todo[urand(0, i - 1)]);
+    }
+}
+
 void WardenWin::RequestData()
 {
     sLog.outWarden("Request data");
 
-    uint16 build = _session->GetClientBuild();
     uint16 id = 0;
     uint8 type = 0;
-    WardenCheck* wd = NULL;
+    WardenCheck const* wd = NULL;
 
     // If all checks were done, fill the todo list again
-    if (_memChecksTodo.empty())
+    if (_memChecksTodo.empty() && _checks)
     {
-        sWardenCheckMgr->GetWardenCheckIds(true, build, _memChecksTodo);
+        FillChecksTodo(_checks->MemCheckIds, _memChecksTodo);
     }
 
-    if (_otherChecksTodo.empty())
+    if (_otherChecksTodo.empty() && _checks)
     {
-        sWardenCheckMgr->GetWardenCheckIds(false, build, _otherChecksTodo);
+        FillChecksTodo(_checks->OtherCheckIds, _otherChecksTodo);
     }
 
     _serverTicks = GameTime::GetGameTimeMS();
@@ -197,8 +206,11 @@ void WardenWin::RequestData()
         id = _memChecksTodo.back();
         _memChecksTodo.pop_back();
 
-        // Add the id to the list sent in this cycle
-        _currentChecks.push_back(id);
+        // Add the check to the list sent in this cycle
+        if (WardenCheck const* check = _checks->GetCheck(id))
+        {
+            _currentChecks.push_back(check);
+        }
     }
 
     ByteBuffer buff;
@@ -216,14 +228,14 @@ void WardenWin::RequestData()
         id = _otherChecksTodo.back();
         _otherChecksTodo.pop_back();
 
-        // Add the id to the list sent in this cycle
-        _currentChecks.push_back(id);
-
         // if we are here, the function is guaranteed to not return NULL
         // but ... who knows
-        wd = sWardenCheckMgr->GetWardenDataById(build, id);
+        wd = _checks->GetCheck(id);
         if (wd)
         {
+            // Add the check to the list sent in this cycle
+            _currentChecks.push_back(wd);
+
             switch (wd->Type)
             {
                 case MPQ_CHECK:
@@ -246,9 +258,9 @@ void WardenWin::RequestData()
 
     uint8 index = 1;
 
-    for (std::list<uint16>::iterator itr = _currentChecks.begin(); itr != _currentChecks.end(); ++itr)
+    for (std::vector<WardenCheck const*>::const_iterator itr = _currentChecks.begin(); itr != _currentChecks.end(); ++itr)
     {
-        wd = sWardenCheckMgr->GetWardenDataById(build, *itr);
+        wd = *itr;
 
         type = wd->Type;
         buff << uint8(type ^ xorByte);
@@ -264,7 +276,7 @@ void WardenWin::RequestData()
             case PAGE_CHECK_A:
             case PAGE_CHECK_B:
             {
-                buff.append(wd->Data.AsByteArray(0, false), wd->Data.GetNumBytes());
+                buff.append(wd->DataBytes.data(), wd->DataBytes.size());
                 buff << uint32(wd->Address);
                 buff << uint8(wd->Length);
                 break;
@@ -277,18 +289,16 @@ void WardenWin::RequestData()
             }
             case DRIVER_CHECK:
             {
-                buff.append(wd->Data.AsByteArray(0, false), wd->Data.GetNumBytes());
+                buff.append(wd->DataBytes.data(), wd->DataBytes.size());
                 buff << uint8(index++);
                 break;
             }
             case MODULE_CHECK:
             {
-                uint32 seed = rand32();
-                buff << uint32(seed);
-                HMACSHA1 hmac(4, (uint8*)&seed);
-                hmac.UpdateData(wd->Str);
-                hmac.Finalize();
-                buff.append(hmac.GetDigest(), hmac.GetLength());
+                // the seeds and their HMAC are prepared at loading
+                WardenModuleSeed const& seed = wd->ModuleSeeds[urand(0, wd->ModuleSeeds.size() - 1)];
+                buff << uint32(seed.Seed);
+                buff.append(seed.Digest, sizeof(seed.Digest));
                 break;
             }
             /*case PROC_CHECK:
@@ -316,9 +326,9 @@ void WardenWin::RequestData()
 
     std::stringstream stream;
     stream << "Sent check id's: ";
-    for (std::list<uint16>::iterator itr = _currentChecks.begin(); itr != _currentChecks.end(); ++itr)
+    for (std::vector<WardenCheck const*>::const_iterator itr = _currentChecks.begin(); itr != _currentChecks.end(); ++itr)
     {
-        stream << *itr << " ";
+        stream << (*itr)->CheckId << " ";
     }
 
     sLog.outWarden("%s", stream.str().c_str());
@@ -364,15 +374,16 @@ void WardenWin::HandleData(ByteBuffer &buff)
 
     }
 
-    WardenCheckResult* rs;
-    WardenCheck *rd;
+    WardenCheckResult const* rs;
+    WardenCheck const* rd;
     uint8 type;
     uint16 checkFailed = 0;
 
-    for (std::list<uint16>::iterator itr = _currentChecks.begin(); itr != _currentChecks.end(); ++itr)
+    for (std::vector<WardenCheck const*>::const_iterator itr = _currentChecks.begin(); itr != _currentChecks.end(); ++itr)
     {
-        rd = sWardenCheckMgr->GetWardenDataById(_session->GetClientBuild(), *itr);
-        rs = sWardenCheckMgr->GetWardenResultById(_session->GetClientBuild(), *itr);
+        rd = *itr;
+        rs = _checks->GetResult(rd->CheckId);
+        uint16 id = rd->CheckId;
 
         type = rd->Type;
         switch (type)
@@ -384,20 +395,20 @@ void WardenWin::HandleData(ByteBuffer &buff)
 
                 if (Mem_Result != 0)
                 {
-                    sLog.outWarden("RESULT MEM_CHECK not 0x00, CheckId %u account Id %u", *itr, _session->GetAccountId());
-                    checkFailed = *itr;
+                    sLog.outWarden("RESULT MEM_CHECK not 0x00, CheckId %u account Id %u", id, _session->GetAccountId());
+                    checkFailed = id;
                     continue;
                 }
-                if (memcmp(buff.contents() + buff.rpos(), rs->Result.AsByteArray(0, false), rd->Length) != 0)
+                if (memcmp(buff.contents() + buff.rpos(), rs->ResultBytes.data(), rd->Length) != 0)
                 {
-                    sLog.outWarden("RESULT MEM_CHECK fail CheckId %u account Id %u", *itr, _session->GetAccountId());
-                    checkFailed = *itr;
+                    sLog.outWarden("RESULT MEM_CHECK fail CheckId %u account Id %u", id, _session->GetAccountId());
+                    checkFailed = id;
                     buff.rpos(buff.rpos() + rd->Length);
                     continue;
                 }
 
                 buff.rpos(buff.rpos() + rd->Length);
-                sLog.outWarden("RESULT MEM_CHECK passed CheckId %u account Id %u", *itr, _session->GetAccountId());
+                sLog.outWarden("RESULT MEM_CHECK passed CheckId %u account Id %u", id, _session->GetAccountId());
                 break;
             }
             case PAGE_CHECK_A:
@@ -410,17 +421,17 @@ void WardenWin::HandleData(ByteBuffer &buff)
                 {
                     if (type == PAGE_CHECK_A || type == PAGE_CHECK_B)
                     {
-                        sLog.outWarden("RESULT PAGE_CHECK fail, CheckId %u account Id %u", *itr, _session->GetAccountId());
+                        sLog.outWarden("RESULT PAGE_CHECK fail, CheckId %u account Id %u", id, _session->GetAccountId());
                     }
                     if (type == MODULE_CHECK)
                     {
-                        sLog.outWarden("RESULT MODULE_CHECK fail, CheckId %u account Id %u", *itr, _session->GetAccountId());
+                        sLog.outWarden("RESULT MODULE_CHECK fail, CheckId %u account Id %u", id, _session->GetAccountId());
                     }
                     if (type == DRIVER_CHECK)
                     {
-                        sLog.outWarden("RESULT DRIVER_CHECK fail, CheckId %u account Id %u", *itr, _session->GetAccountId());
+                        sLog.outWarden("RESULT DRIVER_CHECK fail, CheckId %u account Id %u", id, _session->GetAccountId());
                     }
-                    checkFailed = *itr;
+                    checkFailed = id;
                     buff.rpos(buff.rpos() + 1);
                     continue;
                 }
@@ -428,15 +439,15 @@ void WardenWin::HandleData(ByteBuffer &buff)
                 buff.rpos(buff.rpos() + 1);
                 if (type == PAGE_CHECK_A || type == PAGE_CHECK_B)
                 {
-                    sLog.outWarden("RESULT PAGE_CHECK passed CheckId %u account Id %u", *itr, _session->GetAccountId());
+                    sLog.outWarden("RESULT PAGE_CHECK passed CheckId %u account Id %u", id, _session->GetAccountId());
                 }
                 else if (type == MODULE_CHECK)
                 {
-                    sLog.outWarden("RESULT MODULE_CHECK passed CheckId %u account Id %u", *itr, _session->GetAccountId());
+                    sLog.outWarden("RESULT MODULE_CHECK passed CheckId %u account Id %u", id, _session->GetAccountId());
                 }
                 else if (type == DRIVER_CHECK)
                 {
-                    sLog.outWarden("RESULT DRIVER_CHECK passed CheckId %u account Id %u", *itr, _session->GetAccountId());
+                    sLog.outWarden("RESULT DRIVER_CHECK passed CheckId %u account Id %u", id, _session->GetAccountId());
                 }
                 break;
             }
@@ -447,8 +458,8 @@ void WardenWin::HandleData(ByteBuffer &buff)
 
                 if (Lua_Result != 0)
                 {
-                    sLog.outWarden("RESULT LUA_STR_CHECK fail, CheckId %u account Id %u", *itr, _session->GetAccountId());
-                    checkFailed = *itr;
+                    sLog.outWarden("RESULT LUA_STR_CHECK fail, CheckId %u account Id %u", id, _session->GetAccountId());
+                    checkFailed = id;
                     continue;
                 }
 
@@ -464,7 +475,7 @@ void WardenWin::HandleData(ByteBuffer &buff)
                     delete[] str;
                 }
                 buff.rpos(buff.rpos() + luaStrLen);         // Skip string
-                sLog.outWarden("RESULT LUA_STR_CHECK passed, CheckId %u account Id %u", *itr, _session->GetAccountId());
+                sLog.outWarden("RESULT LUA_STR_CHECK passed, CheckId %u account Id %u", id, _session->GetAccountId());
                 break;
             }
             case MPQ_CHECK:
@@ -475,20 +486,20 @@ void WardenWin::HandleData(ByteBuffer &buff)
                 if (Mpq_Result != 0)
                 {
                     sLog.outWarden("RESULT MPQ_CHECK not 0x00 account id %u", _session->GetAccountId());
-                    checkFailed = *itr;
+                    checkFailed = id;
                     continue;
                 }
 
-                if (memcmp(buff.contents() + buff.rpos(), rs->Result.AsByteArray(0, false), 20) != 0) // SHA1
+                if (memcmp(buff.contents() + buff.rpos(), rs->ResultBytes.data(), 20) != 0) // SHA1
                 {
-                    sLog.outWarden("RESULT MPQ_CHECK fail, CheckId %u account Id %u", *itr, _session->GetAccountId());
-                    checkFailed = *itr;
+                    sLog.outWarden("RESULT MPQ_CHECK fail, CheckId %u account Id %u", id, _session->GetAccountId());
+                    checkFailed = id;
                     buff.rpos(buff.rpos() + 20);            // 20 bytes SHA1
                     continue;
                 }
 
                 buff.rpos(buff.rpos() + 20);                // 20 bytes SHA1
-                sLog.outWarden("RESULT MPQ_CHECK passed, CheckId %u account Id %u", *itr, _session->GetAccountId());
+                sLog.outWarden("RESULT MPQ_CHECK passed, CheckId %u account Id %u", id, _session->GetAccountId());
                 break;
             }
             default:                                        // Should never happen
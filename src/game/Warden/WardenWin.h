@@ -87,10 +87,14 @@ class WardenWin : public Warden
         void HandleData(ByteBuffer &buff) override;
 
     private:
+        // refill a todo list with all ids of a kind in random order
+        static void FillChecksTodo(std::vector<uint16> const& ids, std::vector<uint16>& todo);
+
         uint32 _serverTicks;
-        std::list<uint16> _otherChecksTodo;
-        std::list<uint16> _memChecksTodo;
-        std::list<uint16> _currentChecks;
+        WardenBuildChecks const* _checks;                   // checks of the client build, NULL if there are none
+        std::vector<uint16> _otherChecksTodo;
+        std::vector<uint16> _memChecksTodo;
+        std::vector<WardenCheck const*> _currentChecks;
 };
 
 #endif
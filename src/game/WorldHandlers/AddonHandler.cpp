@@ -98,15 +98,15 @@ bool AddonHandler::BuildAddonPacket(WorldPacket* Source, WorldPacket* Target)
 
         while (AddOnPacked.rpos() < AddOnPacked.size())
         {
-            std::string AddonNames;
             uint8 unk6;
             uint32 crc, unk7;
 
-            AddOnPacked >> AddonNames;
+            // name is not used, look at it in place instead of copying it out
+            ByteBufferView AddonNames = AddOnPacked.ReadCStringView();
 
             AddOnPacked >> crc >> unk7 >> unk6;
 
-            // sLog.outDebug("ADDON: Name:%s CRC:%x Unknown1 :%x Unknown2 :%x", AddonNames.c_str(), crc, unk7, unk6);
+            // sLog.outDebug("ADDON: Name:%s CRC:%x Unknown1 :%x Unknown2 :%x", AddonNames.str().c_str(), crc, unk7, unk6);
 
             *Target << (uint8)2;
 
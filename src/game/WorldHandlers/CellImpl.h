@@ -72,6 +72,12 @@ Cell::Visit(const CellPair& standing_cell, TypeContainerVisitor<T, CONTAINER> &v
         return;
     }
 
+    // nothing the visitor is interested in is stored in this container, or it already has its result
+    if (!TypeContainerVisitor<T, CONTAINER>::VISITS_CONTAINER || visitor.IsDone())
+    {
+        return;
+    }
+
     // no jokes here... Actually placing ASSERT() here was good idea, but
     // we had some problems with DynamicObjects, which pass radius = 0.0f (DB issue?)
     // maybe it is better to just return when radius <= 0.0f?
@@ -120,6 +126,11 @@ Cell::Visit(const CellPair& standing_cell, TypeContainerVisitor<T, CONTAINER> &v
             // lets skip standing cell since we already visited it
             if (cell_pair != standing_cell)
             {
+                if (visitor.IsDone())
+                {
+                    return;
+                }
+
                 Cell r_zone(cell_pair);
                 r_zone.data.Part.nocreate = data.Part.nocreate;
                 m.Visit(r_zone, visitor);
@@ -143,6 +154,11 @@ Cell::VisitCircle(TypeContainerVisitor<T, CONTAINER> &visitor, Map& m, const Cel
     {
         for (uint32 y = begin_cell.y_coord; y <= end_cell.y_coord; ++y)
         {
+            if (visitor.IsDone())
+            {
+                return;
+            }
+
             CellPair cell_pair(x, y);
             Cell r_zone(cell_pair);
             r_zone.data.Part.nocreate = data.Part.nocreate;
@@ -167,6 +183,11 @@ Cell::VisitCircle(TypeContainerVisitor<T, CONTAINER> &visitor, Map& m, const Cel
         y_start -= 1;
         for (uint32 y = y_start; y >= y_end; --y)
         {
+            if (visitor.IsDone())
+            {
+                return;
+            }
+
             // we visit cells symmetrically from both sides, heading from center to sides and from up to bottom
             // e.g. filling 2 trapezoids after filling central cell strip...
             CellPair cell_pair_left(x_start - step, y);
@@ -29,7 +29,7 @@
 #include "Chat.h"
 
 Channel::Channel(const std::string& name)
-    : m_announce(true), m_moderate(false), m_name(name), m_flags(0), m_channelId(0)
+    : m_announce(true), m_moderate(false), m_name(name), m_flags(0), m_channelId(0), m_memberCacheValid(false)
 {
     // set special flags if built-in channel
     ChatChannelsEntry const* ch = GetChannelEntryFor(name);
@@ -114,6 +114,7 @@ void Channel::Join(Player* player, const char* password)
     PlayerInfo& pinfo = m_players[guid];
     pinfo.player = guid;
     pinfo.flags = MEMBER_FLAG_NONE;
+    InvalidateMemberCache();
 
     MakeYouJoined(&data);
     SendToOne(&data, guid);
@@ -156,6 +157,8 @@ void Channel::Leave(Player* player, bool send)
     bool changeowner = m_players[guid].IsOwner();
 
     m_players.erase(guid);
+    InvalidateMemberCache();
+
     if (m_announce && (player->GetSession()->GetSecurity() < SEC_GAMEMASTER || !sWorld.getConfig(CONFIG_BOOL_SILENTLY_GM_JOIN_TO_CHANNEL)))
     {
         WorldPacket data;
@@ -235,6 +238,7 @@ void Channel::KickOrBan(Player* player, const char* targetName, bool ban)
 
     SendToAll(&data);
     m_players.erase(targetGuid);
+    InvalidateMemberCache();
     target->LeftChannel(this);
 
     if (changeowner)
@@ -726,16 +730,48 @@ void Channel::SetOwner(ObjectGuid guid, bool exclaim)
     }
 }
 
-void Channel::SendToAll(WorldPacket* data, ObjectGuid guid)
+std::vector<Player*> const& Channel::GetMemberCache()
 {
+    if (m_memberCacheValid)
+    {
+        return m_memberCache;
+    }
+
+    m_memberCache.clear();
+    m_memberCache.reserve(m_players.size());
+
     for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
     {
-        if (Player* plr = sObjectMgr.GetPlayer(i->first))
+        // only players that will call Leave before they are deleted, see Player::CleanupChannels
+        Player* plr = sObjectMgr.GetPlayer(i->first, false);
+        if (plr && plr->IsInChannel(this))
+        {
+            m_memberCache.push_back(plr);
+        }
+    }
+
+    m_memberCacheValid = true;
+    return m_memberCache;
+}
+
+void Channel::SendToAll(WorldPacket* data, ObjectGuid guid)
+{
+    std::vector<Player*> const& members = GetMemberCache();
+
+    // all members share the same packet buffer
+    SharedWorldPacket shared;
+
+    for (std::vector<Player*>::const_iterator i = members.begin(); i != members.end(); ++i)
+    {
+        Player* plr = *i;
+        if (!plr->IsInWorld())
+        {
+            continue;
+        }
+
+        if (!guid || !plr->GetSocial()->HasIgnore(guid))
         {
-            if (!guid || !plr->GetSocial()->HasIgnore(guid))
-            {
-                plr->GetSession()->SendPacket(data);
-            }
+            plr->GetSession()->SendPacket(data, shared);
         }
     }
 }
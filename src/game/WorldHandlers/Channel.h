@@ -31,6 +31,7 @@
 #include "Player.h"
 
 #include <map>
+#include <vector>
 
 enum ChatNotify
 {
@@ -275,6 +276,10 @@ class Channel
         void SendToOne(WorldPacket* data, ObjectGuid who);
 
         bool IsOn(ObjectGuid who) const { return m_players.find(who) != m_players.end(); }
+
+        // must follow every change of m_players membership
+        void InvalidateMemberCache() { m_memberCacheValid = false; }
+        std::vector<Player*> const& GetMemberCache();
         bool IsBanned(ObjectGuid guid) const { return m_banned.find(guid) != m_banned.end(); }
 
         uint8 GetPlayerFlags(ObjectGuid guid) const
@@ -326,5 +331,9 @@ class Channel
         typedef     std::map<ObjectGuid, PlayerInfo> PlayerList;
         PlayerList  m_players;
         GuidSet m_banned;
+
+        // players of m_players that are online, so a message does not look up every member
+        std::vector<Player*> m_memberCache;
+        bool        m_memberCacheValid;
 };
 #endif
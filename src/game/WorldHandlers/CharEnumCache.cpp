@@ -0,0 +1,200 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "CharEnumCache.h"
+#include "World.h"
+#include "Log.h"
+
+INSTANTIATE_SINGLETON_1(CharEnumCache);
+
+CharEnumCache::CharEnumCache() : m_nextSerial(0)
+{
+}
+
+CharEnumCache::~CharEnumCache()
+{
+    Clear();
+}
+
+bool CharEnumCache::IsEnabled() const
+{
+    return sWorld.getConfig(CONFIG_UINT32_CHAR_ENUM_CACHE_SIZE) != 0;
+}
+
+CharEnumCacheState CharEnumCache::Find(uint32 accountId, WorldPacket& data, uint32& lastPlayedGuid)
+{
+    if (!IsEnabled())
+    {
+        return CHAR_ENUM_NOT_CACHED;
+    }
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, CHAR_ENUM_NOT_CACHED);
+
+    EntryMap::iterator itr = m_entries.find(accountId);
+    if (itr == m_entries.end())
+    {
+        return CHAR_ENUM_NOT_CACHED;
+    }
+
+    // a query not answered within the expire time is given up as well
+    if (itr->second.updateTime + time_t(sWorld.getConfig(CONFIG_UINT32_CHAR_ENUM_CACHE_EXPIRE)) <= time(NULL))
+    {
+        Remove(itr);
+        return CHAR_ENUM_NOT_CACHED;
+    }
+
+    if (!itr->second.ready)
+    {
+        return CHAR_ENUM_QUERYING;
+    }
+
+    data = itr->second.packet;
+    lastPlayedGuid = itr->second.lastPlayedGuid;
+
+    DEBUG_LOG("CharEnumCache: character list of account %u sent from the cache", accountId);
+    return CHAR_ENUM_CACHED;
+}
+
+uint32 CharEnumCache::StartQuery(uint32 accountId)
+{
+    uint32 size = sWorld.getConfig(CONFIG_UINT32_CHAR_ENUM_CACHE_SIZE);
+    if (!size)
+    {
+        return 0;
+    }
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, 0);
+
+    EntryMap::iterator itr = m_entries.find(accountId);
+    if (itr != m_entries.end())
+    {
+        Remove(itr);
+    }
+
+    while (m_entries.size() >= size)
+    {
+        Remove(m_entries.find(m_lru.front()));
+    }
+
+    // 0 is the "not cached" serial
+    if (++m_nextSerial == 0)
+    {
+        ++m_nextSerial;
+    }
+
+    Entry& entry = m_entries[accountId];
+    entry.serial = m_nextSerial;
+    entry.updateTime = time(NULL);
+    entry.lru = m_lru.insert(m_lru.end(), accountId);
+
+    return entry.serial;
+}
+
+void CharEnumCache::Store(uint32 accountId, uint32 serial, WorldPacket const& data, uint32 lastPlayedGuid, std::vector<uint32> const& guids)
+{
+    if (!serial)
+    {
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    // invalidated or queried again while the query ran
+    EntryMap::iterator itr = m_entries.find(accountId);
+    if (itr == m_entries.end() || itr->second.serial != serial || itr->second.ready)
+    {
+        return;
+    }
+
+    Entry& entry = itr->second;
+    entry.ready = true;
+    entry.updateTime = time(NULL);
+    entry.lastPlayedGuid = lastPlayedGuid;
+    entry.packet = data;
+    entry.guids = guids;
+
+    for (std::vector<uint32>::const_iterator guid = guids.begin(); guid != guids.end(); ++guid)
+    {
+        m_characterAccounts[*guid] = accountId;
+    }
+}
+
+void CharEnumCache::Cancel(uint32 accountId, uint32 serial)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    EntryMap::iterator itr = m_entries.find(accountId);
+    if (itr != m_entries.end() && itr->second.serial == serial && !itr->second.ready)
+    {
+        Remove(itr);
+    }
+}
+
+void CharEnumCache::InvalidateAccount(uint32 accountId)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    EntryMap::iterator itr = m_entries.find(accountId);
+    if (itr != m_entries.end())
+    {
+        Remove(itr);
+    }
+}
+
+void CharEnumCache::InvalidateCharacter(uint32 guidLow)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    CharacterAccountMap::const_iterator account = m_characterAccounts.find(guidLow);
+    if (account == m_characterAccounts.end())
+    {
+        return;
+    }
+
+    EntryMap::iterator itr = m_entries.find(account->second);
+    if (itr != m_entries.end())
+    {
+        Remove(itr);
+    }
+}
+
+void CharEnumCache::Clear()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    m_entries.clear();
+    m_characterAccounts.clear();
+    m_lru.clear();
+}
+
+void CharEnumCache::Remove(EntryMap::iterator itr)
+{
+    for (std::vector<uint32>::const_iterator guid = itr->second.guids.begin(); guid != itr->second.guids.end(); ++guid)
+    {
+        m_characterAccounts.erase(*guid);
+    }
+
+    m_lru.erase(itr->second.lru);
+    m_entries.erase(itr);
+}
@@ -0,0 +1,154 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_CHAR_ENUM_CACHE
+#define MANGOS_H_CHAR_ENUM_CACHE
+
+#include <ace/Thread_Mutex.h>
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "WorldPacket.h"
+
+#include <list>
+#include <vector>
+
+enum CharEnumCacheState
+{
+    CHAR_ENUM_NOT_CACHED,                                   ///< the character list has to be queried
+    CHAR_ENUM_QUERYING,                                     ///< a query is running, its callback sends the list
+    CHAR_ENUM_CACHED                                        ///< the list is returned by Find
+};
+
+/**
+ * @brief Serialized SMSG_CHAR_ENUM packets of the accounts at the character screen
+ *
+ * The list is queried when realmd hands a session over (see World::AddSession_)
+ * and on the first CMSG_CHAR_ENUM, later requests of the account within
+ * CharEnumCache.Expire seconds are answered without the database. Code changing
+ * what the character list shows (level, zone, name flags, guild, equipment) has
+ * to call InvalidateAccount() or InvalidateCharacter(), logout always does.
+ *
+ * At most CharEnumCache.Size accounts are kept, the least recently added is
+ * dropped first.
+ */
+class CharEnumCache
+{
+    public:
+        CharEnumCache();
+        ~CharEnumCache();
+
+        /**
+         * @brief Whether character lists are cached at all
+         *
+         * @return bool
+         */
+        bool IsEnabled() const;
+
+        /**
+         * @brief Looks up the character list of an account
+         *
+         * @param accountId
+         * @param data receives the SMSG_CHAR_ENUM packet if cached
+         * @param lastPlayedGuid receives the character played last, 0 if none
+         * @return CharEnumCacheState
+         */
+        CharEnumCacheState Find(uint32 accountId, WorldPacket& data, uint32& lastPlayedGuid);
+
+        /**
+         * @brief Registers a character list query of an account
+         *
+         * @param accountId
+         * @return uint32 serial number to pass to Store, 0 if the cache is disabled
+         */
+        uint32 StartQuery(uint32 accountId);
+
+        /**
+         * @brief Stores a queried character list, dropped if the account was invalidated meanwhile
+         *
+         * @param accountId
+         * @param serial value returned by StartQuery
+         * @param data SMSG_CHAR_ENUM packet built from the query
+         * @param lastPlayedGuid character played last, 0 if none
+         * @param guids characters of the account, for InvalidateCharacter
+         */
+        void Store(uint32 accountId, uint32 serial, WorldPacket const& data, uint32 lastPlayedGuid, std::vector<uint32> const& guids);
+
+        /**
+         * @brief Forgets a query whose result is not stored, e.g. because the session is gone
+         *
+         * @param accountId
+         * @param serial value returned by StartQuery
+         */
+        void Cancel(uint32 accountId, uint32 serial);
+
+        /**
+         * @brief Drops the character list of an account and any query still running for it
+         *
+         * @param accountId
+         */
+        void InvalidateAccount(uint32 accountId);
+
+        /**
+         * @brief Drops the character list containing a character
+         *
+         * @param guidLow
+         */
+        void InvalidateCharacter(uint32 guidLow);
+
+        /**
+         * @brief Drops all character lists
+         *
+         */
+        void Clear();
+
+    private:
+        struct Entry
+        {
+            Entry() : serial(0), ready(false), updateTime(0), lastPlayedGuid(0) {}
+
+            uint32 serial;
+            bool ready;                                     ///< false while the query is running
+            time_t updateTime;                              ///< start of the query, then time of the result
+            uint32 lastPlayedGuid;
+            WorldPacket packet;
+            std::vector<uint32> guids;
+            std::list<uint32>::iterator lru;
+        };
+
+        typedef UNORDERED_MAP<uint32, Entry> EntryMap;
+        typedef UNORDERED_MAP<uint32, uint32> CharacterAccountMap;
+
+        void Remove(EntryMap::iterator itr);
+
+        ACE_Thread_Mutex m_lock;
+        EntryMap m_entries;
+        CharacterAccountMap m_characterAccounts;            ///< account of each character of a cached list
+        std::list<uint32> m_lru;                            ///< account ids, least recently added first
+        uint32 m_nextSerial;
+};
+
+#define sCharEnumCache MaNGOS::Singleton<CharEnumCache>::Instance()
+
+#endif
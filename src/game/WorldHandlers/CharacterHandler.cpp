@@ -47,6 +47,9 @@
 #include "SpellMgr.h"
 #include "GameTime.h"
 #include "Timer.h"
+#include "CharacterLoginCache.h"
+#include "CharEnumCache.h"
+#include "PlayerNameCache.h"
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
 #endif /* ENABLE_ELUNA */
@@ -124,7 +127,6 @@ bool LoginQueryHolder::Initialize()
     res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADBGDATA,          "SELECT `instance_id`, `team`, `join_x`, `join_y`, `join_z`, `join_o`, `join_map` FROM `character_battleground_data` WHERE `guid` = '%u'", m_guid.GetCounter());
     res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSKILLS,          "SELECT `skill`, `value`, `max` FROM `character_skills` WHERE `guid` = '%u'", m_guid.GetCounter());
     res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILS,           "SELECT `id`,`messageType`,`sender`,`receiver`,`subject`,`body`,`expire_time`,`deliver_time`,`money`,`cod`,`checked`,`stationery`,`mailTemplateId`,`has_items` FROM `mail` WHERE `receiver` = '%u' ORDER BY `id` DESC", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILEDITEMS,     "SELECT `data`, `mail_id`, `item_guid`, `item_template` FROM `mail_items` JOIN `item_instance` ON `item_guid` = `guid` WHERE `receiver` = '%u'", m_guid.GetCounter());
 
     return res;
 }
@@ -135,15 +137,25 @@ bool LoginQueryHolder::Initialize()
 class CharacterHandler
 {
     public:
-        void HandleCharEnumCallback(QueryResult* result, uint32 account)
+        void HandleCharEnumCallback(QueryResult* result, uint32 account, uint32 serial)
         {
             WorldSession* session = sWorld.FindSession(account);
             if (!session)
             {
+                // a later session of the account must not wait for this query
+                sCharEnumCache.Cancel(account, serial);
                 delete result;
                 return;
             }
-            session->HandleCharEnum(result);
+            session->HandleCharEnum(result, serial);
+        }
+        void HandleLoginPrefetchCallback(QueryResult* /*dummy*/, SqlQueryHolder* holder, uint32 serial)
+        {
+            if (!holder)
+            {
+                return;
+            }
+            sCharacterLoginCache.Store(((LoginQueryHolder*)holder)->GetGuid().GetCounter(), holder, serial);
         }
         void HandlePlayerLoginCallback(QueryResult * /*dummy*/, SqlQueryHolder* holder)
         {
@@ -244,17 +256,22 @@ void PlayerbotHolder::AddPlayerBot(uint64 playerGuid, uint32 masterAccountId)
         return;
     }
 
+    // bots always read the character themselves
+    sCharacterLoginCache.Invalidate(ObjectGuid(playerGuid).GetCounter());
+
     PlayerbotLoginQueryHolder *holder = new PlayerbotLoginQueryHolder(this, masterAccountId, accountId, ObjectGuid(playerGuid));
     if (!holder->Initialize())
     {
         delete holder;                                      // delete all unprocessed queries
         return;
     }
+    // loaded after the last save of the character
+    SqlOrderingGuard ordering(CharacterDatabase, ObjectGuid(playerGuid).GetCounter());
     CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandlePlayerBotLoginCallback, holder);
 }
 #endif
 
-void WorldSession::HandleCharEnum(QueryResult* result)
+void WorldSession::HandleCharEnum(QueryResult* result, uint32 serial)
 {
     WorldPacket data(SMSG_CHAR_ENUM, 100);                  // we guess size
 
@@ -262,6 +279,12 @@ void WorldSession::HandleCharEnum(QueryResult* result)
 
     data << num;
 
+    // the client selects the character played last, its login data is read ahead
+    uint32 lastPlayedGuid = 0;
+    uint64 lastLogoutTime = 0;
+
+    std::vector<uint32> guids;
+
     if (result)
     {
         do
@@ -271,6 +294,14 @@ void WorldSession::HandleCharEnum(QueryResult* result)
             if (Player::BuildEnumData(result, &data))
             {
                 ++num;
+                guids.push_back(guidlow);
+
+                uint64 logoutTime = (*result)[20].GetUInt64();
+                if (!lastPlayedGuid || logoutTime > lastLogoutTime)
+                {
+                    lastPlayedGuid = guidlow;
+                    lastLogoutTime = logoutTime;
+                }
             }
         }
         while (result->NextRow());
@@ -280,25 +311,102 @@ void WorldSession::HandleCharEnum(QueryResult* result)
 
     data.put<uint8>(0, num);
 
+    sCharEnumCache.Store(GetAccountId(), serial, data, lastPlayedGuid, guids);
+
+    // only read ahead, the client did not ask yet
+    if (!m_charEnumRequested)
+    {
+        return;
+    }
+
+    m_charEnumRequested = false;
+
     SendPacket(&data);
+
+    if (lastPlayedGuid)
+    {
+        PrefetchPlayerLogin(ObjectGuid(HIGHGUID_PLAYER, lastPlayedGuid));
+    }
 }
 
-void WorldSession::HandleCharEnumOpcode(WorldPacket & /*recv_data*/)
+void WorldSession::QueryCharEnum()
 {
+    uint32 serial = sCharEnumCache.StartQuery(GetAccountId());
+
+    // read after the last change of a character of this account
+    SqlOrderingGuard ordering(CharacterDatabase, m_charEnumOrderingKey);
+
     /// get all the data necessary for loading all characters (along with their pets) on the account
-    CharacterDatabase.AsyncPQuery(&chrHandler, &CharacterHandler::HandleCharEnumCallback, GetAccountId(),
+    CharacterDatabase.AsyncPQuery(&chrHandler, &CharacterHandler::HandleCharEnumCallback, GetAccountId(), serial,
                                   //           0               1                2                3                 4                  5                       6                        7
                                   "SELECT `characters`.`guid`, `characters`.`name`, `characters`.`race`, `characters`.`class`, `characters`.`gender`, `characters`.`playerBytes`, `characters`.`playerBytes2`, `characters`.`level`, "
                                   //   8                9               10                     11                     12                     13                    14
                                   "`characters`.`zone`, `characters`.`map`, `characters`.`position_x`, `characters`.`position_y`, `characters`.`position_z`, `guild_member`.`guildid`, `characters`.`playerFlags`, "
-                                  //  15                    16                   17                     18                   19
-                                  "`characters`.`at_login`, `character_pet`.`entry`, `character_pet`.`modelid`, `character_pet`.`level`, `characters`.`equipmentCache` "
+                                  //  15                    16                   17                     18                   19                          20
+                                  "`characters`.`at_login`, `character_pet`.`entry`, `character_pet`.`modelid`, `character_pet`.`level`, `characters`.`equipmentCache`, `characters`.`logout_time` "
                                   "FROM `characters` LEFT JOIN `character_pet` ON `characters`.`guid`=`character_pet`.`owner` AND `character_pet`.`slot`='%u' "
                                   "LEFT JOIN `guild_member` ON `characters`.`guid` = `guild_member`.`guid` "
                                   "WHERE `characters`.`account` = '%u' ORDER BY `characters`.`guid`",
                                   PET_SAVE_AS_CURRENT, GetAccountId());
 }
 
+void WorldSession::PrefetchPlayerLogin(ObjectGuid playerGuid)
+{
+    uint32 serial = sCharacterLoginCache.StartPrefetch(playerGuid.GetCounter(), GetAccountId());
+    if (!serial)
+    {
+        return;
+    }
+
+    LoginQueryHolder* holder = new LoginQueryHolder(GetAccountId(), playerGuid);
+    if (!holder->Initialize())
+    {
+        delete holder;                                      // delete all unprocessed queries
+        sCharacterLoginCache.Invalidate(playerGuid.GetCounter());
+        return;
+    }
+
+    // loaded after the last save of the character
+    SqlOrderingGuard ordering(CharacterDatabase, playerGuid.GetCounter());
+    CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandleLoginPrefetchCallback, holder, serial);
+}
+
+void WorldSession::HandleCharEnumOpcode(WorldPacket & /*recv_data*/)
+{
+    m_charEnumRequested = true;
+
+    WorldPacket data;
+    uint32 lastPlayedGuid = 0;
+    switch (sCharEnumCache.Find(GetAccountId(), data, lastPlayedGuid))
+    {
+        case CHAR_ENUM_CACHED:
+            m_charEnumRequested = false;
+            SendPacket(&data);
+            if (lastPlayedGuid)
+            {
+                PrefetchPlayerLogin(ObjectGuid(HIGHGUID_PLAYER, lastPlayedGuid));
+            }
+            return;
+        case CHAR_ENUM_QUERYING:
+            return;                                         // sent by the running query
+        default:
+            break;
+    }
+
+    QueryCharEnum();
+}
+
+/// Reads the character list ahead when realmd hands the session over
+void WorldSession::WarmCharEnum()
+{
+    WorldPacket data;
+    uint32 lastPlayedGuid = 0;
+    if (sCharEnumCache.IsEnabled() && sCharEnumCache.Find(GetAccountId(), data, lastPlayedGuid) == CHAR_ENUM_NOT_CACHED)
+    {
+        QueryCharEnum();
+    }
+}
+
 void WorldSession::HandleCharCreateOpcode(WorldPacket& recv_data)
 {
     std::string name;
@@ -486,8 +594,11 @@ void WorldSession::HandleCharCreateOpcode(WorldPacket& recv_data)
     pNewChar->SaveToDB();
     charcount += 1;
 
-    LoginDatabase.PExecute("DELETE FROM `realmcharacters` WHERE `acctid`= '%u' AND `realmid`= '%u'", GetAccountId(), realmID);
-    LoginDatabase.PExecute("INSERT INTO `realmcharacters` (`numchars`, `acctid`, `realmid`) VALUES (%u, %u, %u)",  charcount, GetAccountId(), realmID);
+    sCharEnumCache.InvalidateAccount(GetAccountId());
+    m_charEnumOrderingKey = pNewChar->GetGUIDLow();
+    sPlayerNameCache.Add(pNewChar->GetGUIDLow(), pNewChar->GetName(), race_, gender, class_);
+
+    LoginDatabase.PExecuteCoalesced("realmcharacters", GetAccountId(), "REPLACE INTO `realmcharacters` (`numchars`, `acctid`, `realmid`) VALUES (%u, %u, %u)", charcount, GetAccountId(), realmID);
 
     data << (uint8)CHAR_CREATE_SUCCESS;
     SendPacket(&data);
@@ -560,6 +671,7 @@ void WorldSession::HandleCharDeleteOpcode(WorldPacket& recv_data)
     }
 
     Player::DeleteFromDB(guid, GetAccountId());
+    m_charEnumOrderingKey = lowguid;
 
     WorldPacket data(SMSG_CHAR_DELETE, 1);
     data << (uint8)CHAR_DELETE_SUCCESS;
@@ -581,6 +693,13 @@ void WorldSession::HandlePlayerLoginOpcode(WorldPacket& recv_data)
 
     DEBUG_LOG("WORLD: Received opcode Player Logon Message");
 
+    // read ahead at the character list or the last logout
+    if (SqlQueryHolder* prefetched = sCharacterLoginCache.Take(playerGuid.GetCounter(), GetAccountId()))
+    {
+        chrHandler.HandlePlayerLoginCallback(NULL, prefetched);
+        return;
+    }
+
     LoginQueryHolder* holder = new LoginQueryHolder(GetAccountId(), playerGuid);
     if (!holder->Initialize())
     {
@@ -589,6 +708,8 @@ void WorldSession::HandlePlayerLoginOpcode(WorldPacket& recv_data)
         return;
     }
 
+    // loaded after the last save of the character
+    SqlOrderingGuard ordering(CharacterDatabase, playerGuid.GetCounter());
     CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandlePlayerLoginCallback, holder);
 }
 
@@ -787,19 +908,14 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
     /* Send packets that must be sent only after player is added to the map */
     pCurrChar->SendInitialPacketsAfterAddToMap();
 
-    /* Mark player as online in the database */
-    static SqlStatementID updChars;
-    static SqlStatementID updAccount;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(updChars, "UPDATE `characters` SET `online` = 1 WHERE `guid` = ?");
-    stmt.PExecute(pCurrChar->GetGUIDLow());
+    /* Mark player as online in the database, a quick relog only writes the final state */
+    CharacterDatabase.PExecuteCoalesced("characters.online", pCurrChar->GetGUIDLow(), "UPDATE `characters` SET `online` = 1 WHERE `guid` = '%u'", pCurrChar->GetGUIDLow());
 
 #ifdef ENABLE_PLAYERBOTS
     if (pCurrChar->GetSession()->GetRemoteAddress() != "bot")
     {
 #endif
-        stmt = LoginDatabase.CreateStatement(updAccount, "UPDATE `account` SET `active_realm_id` = ? WHERE `id` = ?");
-        stmt.PExecute(realmID, GetAccountId());
+        LoginDatabase.PExecuteCoalesced("account.active_realm_id", GetAccountId(), "UPDATE `account` SET `active_realm_id` = '%u' WHERE `id` = '%u'", realmID, GetAccountId());
 #ifdef ENABLE_PLAYERBOTS
     }
 #endif
@@ -1085,6 +1201,13 @@ void WorldSession::HandleChangePlayerNameOpcodeCallBack(QueryResult* result, uin
 
     delete result;
 
+    sCharacterLoginCache.Invalidate(guidLow);
+    sCharEnumCache.InvalidateAccount(accountId);
+    session->m_charEnumOrderingKey = guidLow;
+    sPlayerNameCache.Rename(guidLow, newname);
+
+    // ordered before the login queries of the character
+    SqlOrderingGuard ordering(CharacterDatabase, guidLow);
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.PExecute("UPDATE `characters` SET `name` = '%s', `at_login` = `at_login` & ~ %u WHERE `guid` ='%u'", newname.c_str(), uint32(AT_LOGIN_RENAME), guidLow);
     CharacterDatabase.CommitTransaction();
@@ -0,0 +1,161 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "CharacterLoginCache.h"
+#include "Database/DatabaseEnv.h"
+#include "World.h"
+#include "Log.h"
+
+INSTANTIATE_SINGLETON_1(CharacterLoginCache);
+
+CharacterLoginCache::CharacterLoginCache() : m_nextSerial(0)
+{
+}
+
+CharacterLoginCache::~CharacterLoginCache()
+{
+    Clear();
+}
+
+bool CharacterLoginCache::IsEnabled() const
+{
+    return sWorld.getConfig(CONFIG_UINT32_CHARACTER_LOGIN_CACHE_SIZE) != 0;
+}
+
+uint32 CharacterLoginCache::StartPrefetch(uint32 guidLow, uint32 accountId)
+{
+    uint32 size = sWorld.getConfig(CONFIG_UINT32_CHARACTER_LOGIN_CACHE_SIZE);
+    if (!size)
+    {
+        return 0;
+    }
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, 0);
+
+    EntryMap::iterator itr = m_entries.find(guidLow);
+    if (itr != m_entries.end())
+    {
+        // already running, or finished and not expired yet
+        if (itr->second.accountId == accountId && (!itr->second.holder ||
+                itr->second.readyTime + time_t(sWorld.getConfig(CONFIG_UINT32_CHARACTER_LOGIN_CACHE_EXPIRE)) > time(NULL)))
+        {
+            return 0;
+        }
+
+        Remove(itr);
+    }
+
+    while (m_entries.size() >= size)
+    {
+        Remove(m_entries.find(m_lru.front()));
+    }
+
+    // 0 is the "no prefetch" result
+    if (++m_nextSerial == 0)
+    {
+        ++m_nextSerial;
+    }
+
+    Entry& entry = m_entries[guidLow];
+    entry.accountId = accountId;
+    entry.serial = m_nextSerial;
+    entry.lru = m_lru.insert(m_lru.end(), guidLow);
+
+    return entry.serial;
+}
+
+void CharacterLoginCache::Store(uint32 guidLow, SqlQueryHolder* holder, uint32 serial)
+{
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+        EntryMap::iterator itr = m_entries.find(guidLow);
+        if (itr != m_entries.end() && itr->second.serial == serial && !itr->second.holder)
+        {
+            itr->second.holder = holder;
+            itr->second.readyTime = time(NULL);
+            return;
+        }
+    }
+
+    // invalidated or taken over by a login while the queries ran
+    delete holder;
+}
+
+SqlQueryHolder* CharacterLoginCache::Take(uint32 guidLow, uint32 accountId)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, NULL);
+
+    EntryMap::iterator itr = m_entries.find(guidLow);
+    if (itr == m_entries.end())
+    {
+        return NULL;
+    }
+
+    SqlQueryHolder* holder = NULL;
+
+    if (itr->second.holder && itr->second.accountId == accountId &&
+            itr->second.readyTime + time_t(sWorld.getConfig(CONFIG_UINT32_CHARACTER_LOGIN_CACHE_EXPIRE)) > time(NULL))
+    {
+        holder = itr->second.holder;
+        itr->second.holder = NULL;
+    }
+
+    // a running prefetch is dropped as well, the login reads the character itself
+    Remove(itr);
+
+    DEBUG_LOG("CharacterLoginCache: login of character %u %s", guidLow, holder ? "uses prefetched data" : "queries the database");
+    return holder;
+}
+
+void CharacterLoginCache::Invalidate(uint32 guidLow)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    EntryMap::iterator itr = m_entries.find(guidLow);
+    if (itr != m_entries.end())
+    {
+        Remove(itr);
+    }
+}
+
+void CharacterLoginCache::Clear()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    for (EntryMap::iterator itr = m_entries.begin(); itr != m_entries.end(); ++itr)
+    {
+        delete itr->second.holder;
+    }
+
+    m_entries.clear();
+    m_lru.clear();
+}
+
+void CharacterLoginCache::Remove(EntryMap::iterator itr)
+{
+    delete itr->second.holder;
+    m_lru.erase(itr->second.lru);
+    m_entries.erase(itr);
+}
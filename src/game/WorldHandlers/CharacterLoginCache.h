@@ -0,0 +1,127 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_CHARACTER_LOGIN_CACHE
+#define MANGOS_H_CHARACTER_LOGIN_CACHE
+
+#include <ace/Thread_Mutex.h>
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <list>
+
+class SqlQueryHolder;
+
+/**
+ * @brief Finished login query holders of characters that are about to log in
+ *
+ * A holder is read in advance when the character list of an account is sent
+ * (for the character played last) and right after a character logged out. A
+ * login of that character within CharacterLoginCache.Expire seconds takes the
+ * holder and skips the login queries. Code changing the database rows of an
+ * offline character has to call Invalidate() (or Clear() for changes of many
+ * characters), otherwise the login would load the former state.
+ *
+ * At most CharacterLoginCache.Size holders are kept, the least recently added
+ * is dropped first.
+ */
+class CharacterLoginCache
+{
+    public:
+        CharacterLoginCache();
+        ~CharacterLoginCache();
+
+        /**
+         * @brief Whether holders are prefetched at all
+         *
+         * @return bool
+         */
+        bool IsEnabled() const;
+
+        /**
+         * @brief Registers a prefetch for a character
+         *
+         * @param guidLow character to prefetch
+         * @param accountId account owning the character
+         * @return uint32 serial number to pass to Store, 0 if no prefetch is needed
+         */
+        uint32 StartPrefetch(uint32 guidLow, uint32 accountId);
+
+        /**
+         * @brief Stores a prefetched holder, deleted if the character was invalidated meanwhile
+         *
+         * @param guidLow character the holder was read for
+         * @param holder query holder of the prefetch
+         * @param serial value returned by StartPrefetch
+         */
+        void Store(uint32 guidLow, SqlQueryHolder* holder, uint32 serial);
+
+        /**
+         * @brief Removes and returns the prefetched holder of a character
+         *
+         * @param guidLow character logging in
+         * @param accountId account of the logging in session
+         * @return SqlQueryHolder finished holder or NULL if the login has to query the database
+         */
+        SqlQueryHolder* Take(uint32 guidLow, uint32 accountId);
+
+        /**
+         * @brief Drops the holder of a character and any prefetch still running for it
+         *
+         * @param guidLow
+         */
+        void Invalidate(uint32 guidLow);
+
+        /**
+         * @brief Drops all holders
+         *
+         */
+        void Clear();
+
+    private:
+        struct Entry
+        {
+            Entry() : holder(NULL), accountId(0), serial(0), readyTime(0) {}
+
+            SqlQueryHolder* holder;                         ///< NULL while the prefetch is running
+            uint32 accountId;
+            uint32 serial;
+            time_t readyTime;
+            std::list<uint32>::iterator lru;
+        };
+
+        typedef UNORDERED_MAP<uint32, Entry> EntryMap;
+
+        void Remove(EntryMap::iterator itr);
+
+        ACE_Thread_Mutex m_lock;
+        EntryMap m_entries;
+        std::list<uint32> m_lru;                            ///< character guids, least recently added first
+        uint32 m_nextSerial;
+};
+
+#define sCharacterLoginCache MaNGOS::Singleton<CharacterLoginCache>::Instance()
+
+#endif
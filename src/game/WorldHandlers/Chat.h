@@ -60,6 +60,7 @@ class ChatCommand
         bool (ChatHandler::* Handler)(char* args);
         std::string        Help;
         ChatCommand* ChildCommands;
+        bool               Concurrent;                      // console handler only reads static data or the DB, may run on the CLI command threads
 
         ChatCommand(
           const char* pName,
@@ -67,7 +68,8 @@ class ChatCommand
           bool pAllowConsole,
           bool (ChatHandler::* pHandler)(char* args),
           std::string pHelp,
-          ChatCommand* pChildCommands
+          ChatCommand* pChildCommands,
+          bool pConcurrent = false
         )
          : Id(-1)
         {
@@ -77,6 +79,7 @@ class ChatCommand
           Handler = pHandler;
           Help = pHelp;
           ChildCommands = pChildCommands;
+          Concurrent = pConcurrent;
         }
 };
 
@@ -451,6 +454,7 @@ class ChatHandler
 
         bool HandlePDumpLoadCommand(char* args);
         bool HandlePDumpWriteCommand(char* args);
+        bool HandlePDumpWriteBinaryCommand(char* args);
 
         bool HandlePoolListCommand(char* args);
         bool HandlePoolSpawnsCommand(char* args);
@@ -569,8 +573,10 @@ class ChatHandler
         bool HandleSendMassItemsCommand(char* args);
         bool HandleSendMassMailCommand(char* args);
         bool HandleSendMassMoneyCommand(char* args);
+        bool HandleSendMassStatusCommand(char* args);
 
         bool HandleServerCorpsesCommand(char* args);
+        bool HandleServerCleanCharactersCommand(char* args);
         bool HandleServerExitCommand(char* args);
         bool HandleServerIdleRestartCommand(char* args);
         bool HandleServerIdleShutDownCommand(char* args);
@@ -578,6 +584,17 @@ class ChatHandler
         bool HandleServerLogFilterCommand(char* args);
         bool HandleServerLogLevelCommand(char* args);
         bool HandleServerMotdCommand(char* args);
+        bool HandleServerPerfAccountsCommand(char* args);
+        bool HandleServerPerfDbCommand(char* args);
+#ifdef ENABLE_ELUNA
+        bool HandleServerPerfLuaCommand(char* args);
+#endif /* ENABLE_ELUNA */
+        bool HandleServerPerfMapsCommand(char* args);
+        bool HandleServerPerfMemoryCommand(char* args);
+        bool HandleServerPerfNetCommand(char* args);
+        bool HandleServerPerfOpcodesCommand(char* args);
+        bool HandleServerPerfResetCommand(char* args);
+        bool HandleServerPerfSqlCommand(char* args);
         bool HandleServerPLimitCommand(char* args);
         bool HandleServerResetAllRaidCommand(char* args);
         bool HandleServerRestartCommand(char* args);
@@ -81,6 +81,22 @@ bool WorldSession::processChatmessageFurtherAfterSecurityChecks(std::string& msg
     return true;
 }
 
+bool WorldSession::readChatMessage(WorldPacket& recv_data, std::string& msg, uint32 lang)
+{
+    // look at the message in place first, oversized ones are dropped before being copied
+    ByteBufferView view = recv_data.ReadCStringView();
+
+    //client can't send more than 255 character's, so if we break limit - that's cheater
+    if (lang != LANG_ADDON && view.size() > 255)
+    {
+        sLog.outError("Player %s (GUID: %u) tries send a chatmessage with more than 255 symbols", GetPlayer()->GetName(), GetPlayer()->GetGUIDLow());
+        return false;
+    }
+
+    view.assignTo(msg);
+    return true;
+}
+
 void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
 {
     uint32 type;
@@ -189,7 +205,10 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         case CHAT_MSG_YELL:
         {
             std::string msg;
-            recv_data >> msg;
+            if (!readChatMessage(recv_data, msg, lang))
+            {
+                return;
+            }
 
             if (msg.empty())
             {
@@ -247,7 +266,10 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         {
             std::string to, msg;
             recv_data >> to;
-            recv_data >> msg;
+            if (!readChatMessage(recv_data, msg, lang))
+            {
+                return;
+            }
 
             if (msg.empty())
             {
@@ -312,7 +334,10 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         case CHAT_MSG_PARTY:
         {
             std::string msg;
-            recv_data >> msg;
+            if (!readChatMessage(recv_data, msg, lang))
+            {
+                return;
+            }
 
             if (msg.empty())
             {
@@ -375,7 +400,10 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         case CHAT_MSG_GUILD:
         {
             std::string msg;
-            recv_data >> msg;
+            if (!readChatMessage(recv_data, msg, lang))
+            {
+                return;
+            }
 
             if (msg.empty())
             {
@@ -431,7 +459,10 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         case CHAT_MSG_OFFICER:
         {
             std::string msg;
-            recv_data >> msg;
+            if (!readChatMessage(recv_data, msg, lang))
+            {
+                return;
+            }
 
             if (msg.empty())
             {
@@ -472,7 +503,10 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         case CHAT_MSG_RAID:
         {
             std::string msg;
-            recv_data >> msg;
+            if (!readChatMessage(recv_data, msg, lang))
+            {
+                return;
+            }
 
             if (msg.empty())
             {
@@ -533,7 +567,10 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         case CHAT_MSG_RAID_LEADER:
         {
             std::string msg;
-            recv_data >> msg;
+            if (!readChatMessage(recv_data, msg, lang))
+            {
+                return;
+            }
 
             if (msg.empty())
             {
@@ -595,7 +632,10 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         case CHAT_MSG_RAID_WARNING:
         {
             std::string msg;
-            recv_data >> msg;
+            if (!readChatMessage(recv_data, msg, lang))
+            {
+                return;
+            }
 
             if (!processChatmessageFurtherAfterSecurityChecks(msg, lang))
             {
@@ -644,7 +684,10 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         case CHAT_MSG_BATTLEGROUND:
         {
             std::string msg;
-            recv_data >> msg;
+            if (!readChatMessage(recv_data, msg, lang))
+            {
+                return;
+            }
 
             if (!processChatmessageFurtherAfterSecurityChecks(msg, lang))
             {
@@ -679,7 +722,10 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         case CHAT_MSG_BATTLEGROUND_LEADER:
         {
             std::string msg;
-            recv_data >> msg;
+            if (!readChatMessage(recv_data, msg, lang))
+            {
+                return;
+            }
 
             if (!processChatmessageFurtherAfterSecurityChecks(msg, lang))
             {
@@ -715,7 +761,10 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         {
             std::string channel, msg;
             recv_data >> channel;
-            recv_data >> msg;
+            if (!readChatMessage(recv_data, msg, lang))
+            {
+                return;
+            }
 
             if (!processChatmessageFurtherAfterSecurityChecks(msg, lang))
             {
@@ -135,6 +135,7 @@ void CreatureLinkingMgr::LoadFromDB()
         sLog.outString(">> Table creature_linking is empty.");
         sLog.outString();
 
+        BuildLinkedBits();
         return;
     }
 
@@ -172,6 +173,55 @@ void CreatureLinkingMgr::LoadFromDB()
     sLog.outString();
 
     delete result;
+
+    BuildLinkedBits();
+}
+
+// Helper to set the bit of a key, growing the set as needed
+static void SetLinkedBit(std::vector<bool>& bits, uint32 key)
+{
+    if (key >= bits.size())
+    {
+        bits.resize(key + 1, false);
+    }
+    bits[key] = true;
+}
+
+void CreatureLinkingMgr::BuildLinkedBits()
+{
+    m_linkedEntries.clear();
+    m_linkedGuids.clear();
+
+    for (CreatureLinkingMap::const_iterator itr = m_creatureLinkingMap.begin(); itr != m_creatureLinkingMap.end(); ++itr)
+    {
+        SetLinkedBit(m_linkedEntries, itr->first);
+    }
+    for (UNORDERED_SET<uint32>::const_iterator itr = m_eventTriggers.begin(); itr != m_eventTriggers.end(); ++itr)
+    {
+        SetLinkedBit(m_linkedEntries, *itr);
+    }
+    for (CreatureLinkingMap::const_iterator itr = m_creatureLinkingGuidMap.begin(); itr != m_creatureLinkingGuidMap.end(); ++itr)
+    {
+        SetLinkedBit(m_linkedGuids, itr->first);
+    }
+    for (UNORDERED_SET<uint32>::const_iterator itr = m_eventGuidTriggers.begin(); itr != m_eventGuidTriggers.end(); ++itr)
+    {
+        SetLinkedBit(m_linkedGuids, *itr);
+    }
+}
+
+// This function checks the bits, false means the NPC is neither master nor slave of any link
+bool CreatureLinkingMgr::IsLinked(uint32 entry, uint32 lowGuid) const
+{
+    m_checkCount.fetch_add(1, std::memory_order_relaxed);
+
+    if ((entry < m_linkedEntries.size() && m_linkedEntries[entry]) || (lowGuid < m_linkedGuids.size() && m_linkedGuids[lowGuid]))
+    {
+        m_lookupCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
 }
 
 /** This function is used to check if a DB-Entry is valid
@@ -283,6 +333,11 @@ enum EventMask
 // This functions checks if the NPC has linked NPCs for dynamic action
 bool CreatureLinkingMgr::IsLinkedEventTrigger(Creature* pCreature) const
 {
+    if (!IsLinked(pCreature->GetEntry(), pCreature->GetGUIDLow()))
+    {
+        return false;
+    }
+
     // Entry case
     if (m_eventTriggers.find(pCreature->GetEntry()) != m_eventTriggers.end())
     {
@@ -296,7 +351,7 @@ bool CreatureLinkingMgr::IsLinkedEventTrigger(Creature* pCreature) const
     }
 
     // Also return true for npcs that trigger reverse actions, or for followers(needed in respawn)
-    if (CreatureLinkingInfo const* pInfo = GetLinkedTriggerInformation(pCreature))
+    if (CreatureLinkingInfo const* pInfo = FindLinkedTriggerInformation(pCreature->GetEntry(), pCreature->GetGUIDLow(), pCreature->GetMapId()))
     {
         return pInfo->linkingFlag & EVENT_MASK_TRIGGER_TO;
     }
@@ -328,6 +383,15 @@ CreatureLinkingInfo const* CreatureLinkingMgr::GetLinkedTriggerInformation(Creat
     return GetLinkedTriggerInformation(pCreature->GetEntry(), pCreature->GetGUIDLow(), pCreature->GetMapId());
 }
 CreatureLinkingInfo const* CreatureLinkingMgr::GetLinkedTriggerInformation(uint32 entry, uint32 lowGuid, uint32 mapId) const
+{
+    if (!IsLinked(entry, lowGuid))
+    {
+        return NULL;
+    }
+
+    return FindLinkedTriggerInformation(entry, lowGuid, mapId);
+}
+CreatureLinkingInfo const* CreatureLinkingMgr::FindLinkedTriggerInformation(uint32 entry, uint32 lowGuid, uint32 mapId) const
 {
     // guid case
     CreatureLinkingMapBounds bounds = m_creatureLinkingGuidMap.equal_range(lowGuid);
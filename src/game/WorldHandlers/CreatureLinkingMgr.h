@@ -45,6 +45,7 @@
 #include "Policies/Singleton.h"
 #include "ObjectGuid.h"
 #include <functional>
+#include <atomic>
 
 class Unit;
 class Creature;
@@ -105,11 +106,17 @@ struct CreatureLinkingInfo
 class CreatureLinkingMgr
 {
     public:                                                 // Constructors
-        CreatureLinkingMgr() {}
+        CreatureLinkingMgr() : m_checkCount(0), m_lookupCount(0) {}
 
     public:                                                 // Initialisation
         void LoadFromDB();
 
+    public:                                                 // Statistics
+        // checks made, and those of them that got past the entry/guid bits to the linking tables
+        uint64 GetCheckCount() const { return m_checkCount.load(std::memory_order_relaxed); }
+        uint64 GetLookupCount() const { return m_lookupCount.load(std::memory_order_relaxed); }
+        void ResetLookupCounts() { m_checkCount.store(0, std::memory_order_relaxed); m_lookupCount.store(0, std::memory_order_relaxed); }
+
     public:                                                 // Accessors
         // This functions checks if the NPC triggers actions for other NPCs
         bool IsLinkedEventTrigger(Creature* pCreature) const;
@@ -139,8 +146,19 @@ class CreatureLinkingMgr
         UNORDERED_SET<uint32> m_eventTriggers;              // master by entry
         UNORDERED_SET<uint32> m_eventGuidTriggers;          // master by guid
 
+        // Bit per entry/guid that is linked as master or slave, built at load:
+        // the creatures not linked at all end their checks at these bits
+        std::vector<bool> m_linkedEntries;
+        std::vector<bool> m_linkedGuids;
+
+        mutable std::atomic<uint64> m_checkCount;
+        mutable std::atomic<uint64> m_lookupCount;
+
         // Check-routine
         static bool IsLinkingEntryValid(uint32 slaveEntry, CreatureLinkingInfo* pInfo, bool byEntry);
+        void BuildLinkedBits();
+        bool IsLinked(uint32 entry, uint32 lowGuid) const;
+        CreatureLinkingInfo const* FindLinkedTriggerInformation(uint32 entry, uint32 lowGuid, uint32 mapId) const;
 };
 
 /**
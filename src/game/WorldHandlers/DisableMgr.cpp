@@ -26,6 +26,8 @@
 #include "World.h"
 #include "BattleGroundMgr.h"
 
+#include <atomic>
+
 namespace DisableMgr
 {
 
@@ -39,10 +41,34 @@ namespace
 
     // single disables here with optional data
     typedef std::map<uint32, DisableData> DisableTypeMap;
-    // global disable map by source
-    typedef std::map<DisableType, DisableTypeMap> DisableMap;
 
-    DisableMap m_DisableMap;
+    // disables by source, a fixed array so lookups from map threads never insert
+    DisableTypeMap m_DisableMap[MAX_DISABLE_TYPES];
+    // bit per entry of each source, set for disabled entries: most checks end at this bit
+    std::vector<bool> m_DisabledEntries[MAX_DISABLE_TYPES];
+
+    std::atomic<uint64> m_checkCount(0);
+    std::atomic<uint64> m_lookupCount(0);
+
+    void BuildDisabledEntries()
+    {
+        for (uint32 type = 0; type < MAX_DISABLE_TYPES; ++type)
+        {
+            std::vector<bool>& entries = m_DisabledEntries[type];
+            entries.clear();
+            if (m_DisableMap[type].empty())
+            {
+                continue;
+            }
+
+            // the map is ordered, so its last key is the highest entry
+            entries.resize(m_DisableMap[type].rbegin()->first + 1, false);
+            for (DisableTypeMap::const_iterator itr = m_DisableMap[type].begin(); itr != m_DisableMap[type].end(); ++itr)
+            {
+                entries[itr->first] = true;
+            }
+        }
+    }
 }
 
 #define CONTINUE if (newData) delete data; continue
@@ -50,13 +76,12 @@ namespace
 void LoadDisables()
 {
     // reload case
-    for (DisableMap::iterator itr = m_DisableMap.begin(); itr != m_DisableMap.end(); ++itr)
+    for (uint32 type = 0; type < MAX_DISABLE_TYPES; ++type)
     {
-        itr->second.clear();
+        m_DisableMap[type].clear();
+        m_DisabledEntries[type].clear();
     }
 
-    m_DisableMap.clear();
-
     QueryResult* result = WorldDatabase.Query("SELECT `sourceType`, `entry`, `flags`, `data` FROM `disables`");
 
     uint32 total_count = 0;
@@ -279,11 +304,16 @@ void LoadDisables()
     while (result->NextRow());
     delete result;
 
+    BuildDisabledEntries();
+
     sLog.outString(">> Loaded %u disables", total_count);
 }
 
 void CheckQuestDisables()
 {
+    // disabled quests are neither offered nor marked any more
+    sObjectMgr.InvalidateQuestGiverStatus();
+
     uint32 count = m_DisableMap[DISABLE_TYPE_QUEST].size();
     if (!count)
     {
@@ -312,11 +342,16 @@ void CheckQuestDisables()
 bool IsDisabledFor(DisableType type, uint32 entry, Unit const* unit, uint8 flags, uint32 adData)
 {
     MANGOS_ASSERT(type < MAX_DISABLE_TYPES);
-    if (m_DisableMap[type].empty())
+    m_checkCount.fetch_add(1, std::memory_order_relaxed);
+
+    std::vector<bool> const& entries = m_DisabledEntries[type];
+    if (entry >= entries.size() || !entries[entry])
     {
         return false;
     }
 
+    m_lookupCount.fetch_add(1, std::memory_order_relaxed);
+
     DisableTypeMap::iterator itr = m_DisableMap[type].find(entry);
     if (itr == m_DisableMap[type].end())    // not disabled
     {
@@ -442,4 +477,16 @@ bool IsPathfindingEnabled(uint32 mapId)
         && !IsDisabledFor(DISABLE_TYPE_MMAP, mapId);
 }
 
+void GetLookupCounts(uint64& checks, uint64& lookups)
+{
+    checks = m_checkCount.load(std::memory_order_relaxed);
+    lookups = m_lookupCount.load(std::memory_order_relaxed);
+}
+
+void ResetLookupCounts()
+{
+    m_checkCount.store(0, std::memory_order_relaxed);
+    m_lookupCount.store(0, std::memory_order_relaxed);
+}
+
 } // Namespace
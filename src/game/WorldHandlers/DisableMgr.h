@@ -66,6 +66,10 @@ namespace DisableMgr
     void CheckQuestDisables();
     bool IsVMAPDisabledFor(uint32 entry, uint8 flags);
     bool IsPathfindingEnabled(uint32 mapId);
+
+    // checks made, and those of them that got past the entry bit to the disable table
+    void GetLookupCounts(uint64& checks, uint64& lookups);
+    void ResetLookupCounts();
 }
 
 #endif //TRINITY_DISABLEMGR_H
@@ -602,6 +602,51 @@ void GameEventMgr::LoadFromDB()
         sLog.outString();
         sLog.outString(">> Loaded %u start/end game event mails", count);
     }
+
+    BuildMapSpawns();
+}
+
+void GameEventMgr::BuildMapSpawns()
+{
+    mGameEventMapSpawns.clear();
+    mGameEventMapSpawns.resize(mGameEventCreatureGuids.size());
+
+    for (size_t internal_event_id = 0; internal_event_id < mGameEventMapSpawns.size(); ++internal_event_id)
+    {
+        MapSpawnsList& spawns = mGameEventMapSpawns[internal_event_id];
+        std::map<uint32, size_t> mapIndex;                  // map id -> position in spawns
+
+        for (GuidList::const_iterator itr = mGameEventCreatureGuids[internal_event_id].begin(); itr != mGameEventCreatureGuids[internal_event_id].end(); ++itr)
+        {
+            if (CreatureData const* data = sObjectMgr.GetCreatureData(*itr))
+            {
+                std::map<uint32, size_t>::iterator index = mapIndex.insert(std::make_pair(data->mapid, spawns.size())).first;
+                if (index->second == spawns.size())
+                {
+                    spawns.push_back(GameEventMapSpawns(data->mapid));
+                }
+                spawns[index->second].creatures.push_back(*itr);
+            }
+        }
+
+        if (internal_event_id >= mGameEventGameobjectGuids.size())
+        {
+            continue;
+        }
+
+        for (GuidList::const_iterator itr = mGameEventGameobjectGuids[internal_event_id].begin(); itr != mGameEventGameobjectGuids[internal_event_id].end(); ++itr)
+        {
+            if (GameObjectData const* data = sObjectMgr.GetGOData(*itr))
+            {
+                std::map<uint32, size_t>::iterator index = mapIndex.insert(std::make_pair(data->mapid, spawns.size())).first;
+                if (index->second == spawns.size())
+                {
+                    spawns.push_back(GameEventMapSpawns(data->mapid));
+                }
+                spawns[index->second].gameobjects.push_back(*itr);
+            }
+        }
+    }
 }
 
 uint32 GameEventMgr::Initialize()                           // return the next event delay in ms
@@ -673,7 +718,9 @@ uint32 GameEventMgr::Update(ActiveEvents const* activeAtShutdown /*= NULL*/)
                 {
                     int16 event_nid = (-1) * (itr);
                     // spawn all negative ones for this event
-                    GameEventSpawn(event_nid);
+                    MapActionPlan plan;
+                    GameEventSpawn(event_nid, plan);
+                    QueueMapActions(plan);
                 }
             }
         }
@@ -693,13 +740,16 @@ void GameEventMgr::UnApplyEvent(uint16 event_id)
     CharacterDatabase.PExecute("DELETE FROM `game_event_status` WHERE `event` = %u", event_id);
 
     sLog.outString("GameEvent %u \"%s\" removed.", event_id, mGameEvent[event_id].description.c_str());
+    // all map changes of the event in one plan, each map applies its part in order over its next updates
+    MapActionPlan plan;
     // un-spawn positive event tagged objects
-    GameEventUnspawn(event_id);
+    GameEventUnspawn(event_id, plan);
     // spawn negative event tagget objects
     int16 event_nid = (-1) * event_id;
-    GameEventSpawn(event_nid);
+    GameEventSpawn(event_nid, plan);
     // restore equipment or model
-    UpdateCreatureData(event_id, false);
+    UpdateCreatureData(event_id, false, plan);
+    QueueMapActions(plan);
     // Remove quests that are events only to non event npc
     UpdateEventQuests(event_id, false);
     SendEventMails(event_nid);
@@ -716,13 +766,16 @@ void GameEventMgr::ApplyNewEvent(uint16 event_id, bool resume)
     }
 
     sLog.outString("GameEvent %u \"%s\" started.", event_id, mGameEvent[event_id].description.c_str());
+    // all map changes of the event in one plan, each map applies its part in order over its next updates
+    MapActionPlan plan;
     // spawn positive event tagget objects
-    GameEventSpawn(event_id);
+    GameEventSpawn(event_id, plan);
     // un-spawn negative event tagged objects
     int16 event_nid = (-1) * event_id;
-    GameEventUnspawn(event_nid);
+    GameEventUnspawn(event_nid, plan);
     // Change equipement or model
-    UpdateCreatureData(event_id, true);
+    UpdateCreatureData(event_id, true, plan);
+    QueueMapActions(plan);
     // Add quests that are events only to non event npc
     UpdateEventQuests(event_id, true);
 
@@ -733,22 +786,29 @@ void GameEventMgr::ApplyNewEvent(uint16 event_id, bool resume)
     }
 }
 
-void GameEventMgr::GameEventSpawn(int16 event_id)
+void GameEventMgr::GameEventSpawn(int16 event_id, MapActionPlan& plan)
 {
     int32 internal_event_id = mGameEvent.size() + event_id - 1;
 
-    if (internal_event_id < 0 || (size_t)internal_event_id >= mGameEventCreatureGuids.size())
+    if (internal_event_id < 0 || (size_t)internal_event_id >= mGameEventMapSpawns.size())
     {
-        sLog.outError("GameEventMgr::GameEventSpawn attempt access to out of range mGameEventCreatureGuids element %i (size: " SIZEFMTD ")", internal_event_id, mGameEventCreatureGuids.size());
+        sLog.outError("GameEventMgr::GameEventSpawn attempt access to out of range mGameEventMapSpawns element %i (size: " SIZEFMTD ")", internal_event_id, mGameEventMapSpawns.size());
         return;
     }
 
-    for (GuidList::iterator itr = mGameEventCreatureGuids[internal_event_id].begin(); itr != mGameEventCreatureGuids[internal_event_id].end(); ++itr)
+    MapSpawnsList const& spawns = mGameEventMapSpawns[internal_event_id];
+    for (MapSpawnsList::const_iterator map_itr = spawns.begin(); map_itr != spawns.end(); ++map_itr)
     {
-        // Add to correct cell
-        CreatureData const* data = sObjectMgr.GetCreatureData(*itr);
-        if (data)
+        GameEventMapActions& actions = plan[map_itr->mapId];
+
+        for (std::vector<uint32>::const_iterator itr = map_itr->creatures.begin(); itr != map_itr->creatures.end(); ++itr)
         {
+            CreatureData const* data = sObjectMgr.GetCreatureData(*itr);
+            if (!data)
+            {
+                continue;
+            }
+
             // negative event id for pool element meaning allow be used in next pool spawn
             if (event_id < 0)
             {
@@ -761,24 +821,20 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
                 }
             }
 
+            // Add to correct cell, grids loaded from now on spawn it themselves
             sObjectMgr.AddCreatureToGrid(*itr, data);
 
-            Creature::SpawnInMaps(*itr, data);
+            actions.push_back(GameEventMapAction(GAME_EVENT_SPAWN_CREATURE, *itr));
         }
-    }
 
-    if (internal_event_id < 0 || (size_t)internal_event_id >= mGameEventGameobjectGuids.size())
-    {
-        sLog.outError("GameEventMgr::GameEventSpawn attempt access to out of range mGameEventGameobjectGuids element %i (size: " SIZEFMTD ")", internal_event_id, mGameEventGameobjectGuids.size());
-        return;
-    }
-
-    for (GuidList::iterator itr = mGameEventGameobjectGuids[internal_event_id].begin(); itr != mGameEventGameobjectGuids[internal_event_id].end(); ++itr)
-    {
-        // Add to correct cell
-        GameObjectData const* data = sObjectMgr.GetGOData(*itr);
-        if (data)
+        for (std::vector<uint32>::const_iterator itr = map_itr->gameobjects.begin(); itr != map_itr->gameobjects.end(); ++itr)
         {
+            GameObjectData const* data = sObjectMgr.GetGOData(*itr);
+            if (!data)
+            {
+                continue;
+            }
+
             // negative event id for pool element meaning allow be used in next pool spawn
             if (event_id < 0)
             {
@@ -791,9 +847,10 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
                 }
             }
 
+            // Add to correct cell, grids loaded from now on spawn it themselves
             sObjectMgr.AddGameobjectToGrid(*itr, data);
 
-            GameObject::SpawnInMaps(*itr, data);
+            actions.push_back(GameEventMapAction(GAME_EVENT_SPAWN_GAMEOBJECT, *itr));
         }
     }
 
@@ -812,21 +869,29 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
     }
 }
 
-void GameEventMgr::GameEventUnspawn(int16 event_id)
+void GameEventMgr::GameEventUnspawn(int16 event_id, MapActionPlan& plan)
 {
     int32 internal_event_id = mGameEvent.size() + event_id - 1;
 
-    if (internal_event_id < 0 || (size_t)internal_event_id >= mGameEventCreatureGuids.size())
+    if (internal_event_id < 0 || (size_t)internal_event_id >= mGameEventMapSpawns.size())
     {
-        sLog.outError("GameEventMgr::GameEventUnspawn attempt access to out of range mGameEventCreatureGuids element %i (size: " SIZEFMTD ")", internal_event_id, mGameEventCreatureGuids.size());
+        sLog.outError("GameEventMgr::GameEventUnspawn attempt access to out of range mGameEventMapSpawns element %i (size: " SIZEFMTD ")", internal_event_id, mGameEventMapSpawns.size());
         return;
     }
 
-    for (GuidList::iterator itr = mGameEventCreatureGuids[internal_event_id].begin(); itr != mGameEventCreatureGuids[internal_event_id].end(); ++itr)
+    MapSpawnsList const& spawns = mGameEventMapSpawns[internal_event_id];
+    for (MapSpawnsList::const_iterator map_itr = spawns.begin(); map_itr != spawns.end(); ++map_itr)
     {
-        // Remove the creature from grid
-        if (CreatureData const* data = sObjectMgr.GetCreatureData(*itr))
+        GameEventMapActions& actions = plan[map_itr->mapId];
+
+        for (std::vector<uint32>::const_iterator itr = map_itr->creatures.begin(); itr != map_itr->creatures.end(); ++itr)
         {
+            CreatureData const* data = sObjectMgr.GetCreatureData(*itr);
+            if (!data)
+            {
+                continue;
+            }
+
             // negative event id for pool element meaning unspawn in pool and exclude for next spawns
             if (event_id < 0)
             {
@@ -842,21 +907,17 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
             sObjectMgr.RemoveCreatureFromGrid(*itr, data);
 
             // Remove spawned cases
-            Creature::AddToRemoveListInMaps(*itr, data);
+            actions.push_back(GameEventMapAction(GAME_EVENT_DESPAWN_CREATURE, *itr));
         }
-    }
 
-    if (internal_event_id < 0 || (size_t)internal_event_id >= mGameEventGameobjectGuids.size())
-    {
-        sLog.outError("GameEventMgr::GameEventUnspawn attempt access to out of range mGameEventGameobjectGuids element %i (size: " SIZEFMTD ")", internal_event_id, mGameEventGameobjectGuids.size());
-        return;
-    }
-
-    for (GuidList::iterator itr = mGameEventGameobjectGuids[internal_event_id].begin(); itr != mGameEventGameobjectGuids[internal_event_id].end(); ++itr)
-    {
-        // Remove the gameobject from grid
-        if (GameObjectData const* data = sObjectMgr.GetGOData(*itr))
+        for (std::vector<uint32>::const_iterator itr = map_itr->gameobjects.begin(); itr != map_itr->gameobjects.end(); ++itr)
         {
+            GameObjectData const* data = sObjectMgr.GetGOData(*itr);
+            if (!data)
+            {
+                continue;
+            }
+
             // negative event id for pool element meaning unspawn in pool and exclude for next spawns
             if (event_id < 0)
             {
@@ -872,7 +933,7 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
             sObjectMgr.RemoveGameobjectFromGrid(*itr, data);
 
             // Remove spawned cases
-            GameObject::AddToRemoveListInMaps(*itr, data);
+            actions.push_back(GameEventMapAction(GAME_EVENT_DESPAWN_GAMEOBJECT, *itr));
         }
     }
 
@@ -919,45 +980,125 @@ GameEventCreatureData const* GameEventMgr::GetCreatureUpdateDataForActiveEvent(u
     return NULL;
 }
 
-struct GameEventUpdateCreatureDataInMapsWorker
+void GameEventMgr::UpdateCreatureData(int16 event_id, bool activate, MapActionPlan& plan)
 {
-    GameEventUpdateCreatureDataInMapsWorker(ObjectGuid guid, CreatureData const* data, GameEventCreatureData* event_data, bool activate)
-        : i_guid(guid), i_data(data), i_event_data(event_data), i_activate(activate) {}
-
-    void operator()(Map* map)
+    for (GameEventCreatureDataList::iterator itr = mGameEventCreatureData[event_id].begin(); itr != mGameEventCreatureData[event_id].end(); ++itr)
     {
-        if (Creature* pCreature = map->GetCreature(i_guid))
+        CreatureData const* data = sObjectMgr.GetCreatureData(itr->first);
+        if (!data)
         {
-            pCreature->UpdateEntry(i_data->id, TEAM_NONE, i_data, i_activate ? i_event_data : NULL);
-
-            // spells not casted for event remove case (sent NULL into update), do it
-            if (!i_activate)
-            {
-                pCreature->ApplyGameEventSpells(i_event_data, false);
-            }
+            continue;
         }
+
+        // Update if spawned
+        plan[data->mapid].push_back(GameEventMapAction(GAME_EVENT_UPDATE_CREATURE_DATA, itr->first, &itr->second, activate));
+    }
+}
+
+struct GameEventQueueMapActionsWorker
+{
+    explicit GameEventQueueMapActionsWorker(GameEventMapActions const& actions) : i_actions(actions) {}
+
+    void operator()(Map* map)
+    {
+        map->AddGameEventActions(i_actions);
     }
 
-    ObjectGuid i_guid;
-    CreatureData const* i_data;
-    GameEventCreatureData* i_event_data;
-    bool i_activate;
+    GameEventMapActions const& i_actions;
 };
 
-void GameEventMgr::UpdateCreatureData(int16 event_id, bool activate)
+void GameEventMgr::QueueMapActions(MapActionPlan const& plan)
 {
-    for (GameEventCreatureDataList::iterator itr = mGameEventCreatureData[event_id].begin(); itr != mGameEventCreatureData[event_id].end(); ++itr)
+    for (MapActionPlan::const_iterator itr = plan.begin(); itr != plan.end(); ++itr)
     {
-        // Remove the creature from grid
-        CreatureData const* data = sObjectMgr.GetCreatureData(itr->first);
-        if (!data)
+        if (itr->second.empty())
         {
             continue;
         }
 
-        // Update if spawned
-        GameEventUpdateCreatureDataInMapsWorker worker(data->GetObjectGuid(itr->first), data, &itr->second, activate);
-        sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
+        GameEventQueueMapActionsWorker worker(itr->second);
+        sMapMgr.DoForAllMapsWithMapId(itr->first, worker);
+    }
+}
+
+void GameEventMgr::ApplyMapAction(Map* map, GameEventMapAction const& action)
+{
+    switch (action.type)
+    {
+        case GAME_EVENT_SPAWN_CREATURE:
+        {
+            CreatureData const* data = sObjectMgr.GetCreatureData(action.guid);
+            // We use spawn coords to spawn, a grid loaded since the event changed already has it
+            if (data && map->IsLoaded(data->posX, data->posY) && !map->GetCreature(data->GetObjectGuid(action.guid)))
+            {
+                Creature* pCreature = new Creature;
+                if (!pCreature->LoadFromDB(action.guid, map))
+                {
+                    delete pCreature;
+                }
+            }
+            break;
+        }
+        case GAME_EVENT_DESPAWN_CREATURE:
+        {
+            if (CreatureData const* data = sObjectMgr.GetCreatureData(action.guid))
+            {
+                if (Creature* pCreature = map->GetCreature(data->GetObjectGuid(action.guid)))
+                {
+                    pCreature->AddObjectToRemoveList();
+                }
+            }
+            break;
+        }
+        case GAME_EVENT_SPAWN_GAMEOBJECT:
+        {
+            GameObjectData const* data = sObjectMgr.GetGOData(action.guid);
+            // Spawn if necessary (loaded grids only)
+            if (data && map->IsLoaded(data->posX, data->posY) && !map->GetGameObject(ObjectGuid(HIGHGUID_GAMEOBJECT, data->id, action.guid)))
+            {
+                GameObject* pGameobject = new GameObject;
+                if (!pGameobject->LoadFromDB(action.guid, map))
+                {
+                    delete pGameobject;
+                }
+                else if (pGameobject->isSpawnedByDefault())
+                {
+                    map->Add(pGameobject);
+                }
+            }
+            break;
+        }
+        case GAME_EVENT_DESPAWN_GAMEOBJECT:
+        {
+            if (GameObjectData const* data = sObjectMgr.GetGOData(action.guid))
+            {
+                if (GameObject* pGameobject = map->GetGameObject(ObjectGuid(HIGHGUID_GAMEOBJECT, data->id, action.guid)))
+                {
+                    pGameobject->AddObjectToRemoveList();
+                }
+            }
+            break;
+        }
+        case GAME_EVENT_UPDATE_CREATURE_DATA:
+        {
+            CreatureData const* data = sObjectMgr.GetCreatureData(action.guid);
+            if (!data)
+            {
+                break;
+            }
+
+            if (Creature* pCreature = map->GetCreature(data->GetObjectGuid(action.guid)))
+            {
+                pCreature->UpdateEntry(data->id, TEAM_NONE, data, action.activate ? action.eventData : NULL);
+
+                // spells not casted for event remove case (sent NULL into update), do it
+                if (!action.activate)
+                {
+                    pCreature->ApplyGameEventSpells(action.eventData, false);
+                }
+            }
+            break;
+        }
     }
 }
 
@@ -975,6 +1116,11 @@ void GameEventMgr::UpdateEventQuests(uint16 event_id, bool Activate)
 
         const_cast<Quest*>(pQuest)->SetQuestActiveState(Activate);
     }
+
+    if (!mGameEventQuests[event_id].empty())
+    {
+        sObjectMgr.InvalidateQuestGiverStatus();
+    }
 }
 
 void GameEventMgr::SendEventMails(int16 event_id)
@@ -34,6 +34,7 @@
 
 class Creature;
 class GameObject;
+class Map;
 class MapPersistentState;
 
 struct GameEventData
@@ -72,6 +73,39 @@ struct GameEventMail
 
 typedef std::pair<uint32, GameEventCreatureData> GameEventCreatureDataPair;
 
+enum GameEventMapActionType
+{
+    GAME_EVENT_SPAWN_CREATURE,
+    GAME_EVENT_DESPAWN_CREATURE,
+    GAME_EVENT_SPAWN_GAMEOBJECT,
+    GAME_EVENT_DESPAWN_GAMEOBJECT,
+    GAME_EVENT_UPDATE_CREATURE_DATA,
+};
+
+// change of one static spawn queued to the maps by a starting or ending event, applied at the map update
+struct GameEventMapAction
+{
+    GameEventMapAction(GameEventMapActionType _type, uint32 _guid, GameEventCreatureData const* _eventData = NULL, bool _activate = false)
+        : type(_type), guid(_guid), eventData(_eventData), activate(_activate) {}
+
+    GameEventMapActionType type;
+    uint32 guid;                                            // db guid of the spawn
+    GameEventCreatureData const* eventData;                 // GAME_EVENT_UPDATE_CREATURE_DATA only
+    bool activate;                                          // GAME_EVENT_UPDATE_CREATURE_DATA only
+};
+
+typedef std::vector<GameEventMapAction> GameEventMapActions;
+
+// spawns of one event on one map, built at load so starting the event needs no grouping
+struct GameEventMapSpawns
+{
+    explicit GameEventMapSpawns(uint32 _mapId) : mapId(_mapId) {}
+
+    uint32 mapId;
+    std::vector<uint32> creatures;
+    std::vector<uint32> gameobjects;
+};
+
 class GameEventMgr
 {
     public:
@@ -96,12 +130,19 @@ class GameEventMgr
         int16 GetGameEventId(uint32 guid_or_poolid);
 
         GameEventCreatureData const* GetCreatureUpdateDataForActiveEvent(uint32 lowguid) const;
+
+        // applies one queued change on the map it was queued to, called from the map update
+        static void ApplyMapAction(Map* map, GameEventMapAction const& action);
     private:
+        typedef std::map<uint32, GameEventMapActions> MapActionPlan;
+
+        void BuildMapSpawns();
+        void QueueMapActions(MapActionPlan const& plan);
         void ApplyNewEvent(uint16 event_id, bool resume);
         void UnApplyEvent(uint16 event_id);
-        void GameEventSpawn(int16 event_id);
-        void GameEventUnspawn(int16 event_id);
-        void UpdateCreatureData(int16 event_id, bool activate);
+        void GameEventSpawn(int16 event_id, MapActionPlan& plan);
+        void GameEventUnspawn(int16 event_id, MapActionPlan& plan);
+        void UpdateCreatureData(int16 event_id, bool activate, MapActionPlan& plan);
         void UpdateEventQuests(uint16 event_id, bool activate);
         void SendEventMails(int16 event_id);
        // To implement for GameObjectAI - see code in CMangos
@@ -131,6 +172,8 @@ class GameEventMgr
 
         GameEventGuidMap  mGameEventCreatureGuids;          // events*2-1
         GameEventGuidMap  mGameEventGameobjectGuids;        // events*2-1
+        typedef std::vector<GameEventMapSpawns> MapSpawnsList;
+        std::vector<MapSpawnsList> mGameEventMapSpawns;     // events*2-1, the guid lists above grouped by map
         GameEventIdMap    mGameEventSpawnPoolIds;           // events size, only positive event case
         GameEventDataMap  mGameEvent;
         ActiveEvents m_ActiveEvents;
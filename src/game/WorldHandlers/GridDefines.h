@@ -63,6 +63,31 @@ class Camera;
 
 template <typename...Ts> struct TypeList;
 
+// bits of the object types stored in the grid containers, visitors limit their walk to them with a VISIT_MASK
+enum GridMapTypeMask
+{
+    GRID_MAP_TYPE_MASK_CAMERA           = 0x01,
+    GRID_MAP_TYPE_MASK_CORPSE           = 0x02,
+    GRID_MAP_TYPE_MASK_CREATURE         = 0x04,
+    GRID_MAP_TYPE_MASK_DYNAMICOBJECT    = 0x08,
+    GRID_MAP_TYPE_MASK_GAMEOBJECT       = 0x10,
+    GRID_MAP_TYPE_MASK_PLAYER           = 0x20,
+
+    GRID_MAP_TYPE_MASK_WORLDOBJECT      = GRID_MAP_TYPE_MASK_CORPSE | GRID_MAP_TYPE_MASK_CREATURE | GRID_MAP_TYPE_MASK_DYNAMICOBJECT |
+                                          GRID_MAP_TYPE_MASK_GAMEOBJECT | GRID_MAP_TYPE_MASK_PLAYER,
+    GRID_MAP_TYPE_MASK_UNIT             = GRID_MAP_TYPE_MASK_CREATURE | GRID_MAP_TYPE_MASK_PLAYER
+};
+
+namespace Meta
+{
+    template<> struct VisitTypeBit<Camera>          { static const uint32 value = GRID_MAP_TYPE_MASK_CAMERA; };
+    template<> struct VisitTypeBit<Corpse>          { static const uint32 value = GRID_MAP_TYPE_MASK_CORPSE; };
+    template<> struct VisitTypeBit<Creature>        { static const uint32 value = GRID_MAP_TYPE_MASK_CREATURE; };
+    template<> struct VisitTypeBit<DynamicObject>   { static const uint32 value = GRID_MAP_TYPE_MASK_DYNAMICOBJECT; };
+    template<> struct VisitTypeBit<GameObject>      { static const uint32 value = GRID_MAP_TYPE_MASK_GAMEOBJECT; };
+    template<> struct VisitTypeBit<Player>          { static const uint32 value = GRID_MAP_TYPE_MASK_PLAYER; };
+}
+
 // Creature used instead pet to simplify *::Visit templates (not required duplicate code for Creature->Pet case)
 // Cameras in world list just because linked with Player objects
 
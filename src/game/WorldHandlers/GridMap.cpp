@@ -34,15 +34,49 @@
 #include "Policies/Singleton.h"
 #include "Util.h"
 
+#include <ace/Mem_Map.h>
+
+#include <algorithm>
+
 char const* MAP_MAGIC         = "MAPS";
 char const* MAP_VERSION_MAGIC = "z1.5";
 char const* MAP_AREA_MAGIC    = "AREA";
 char const* MAP_HEIGHT_MAGIC  = "MHGT";
 char const* MAP_LIQUID_MAGIC  = "MLIQ";
 
+std::atomic<uint32> GridMap::s_heapGrids(0);
+std::atomic<uint64> GridMap::s_heapBytes(0);
+std::atomic<uint32> GridMap::s_mappedGrids(0);
+std::atomic<uint64> GridMap::s_mappedBytes(0);
+
 static uint16 holetab_h[4] = { 0x1111, 0x2222, 0x4444, 0x8888 };
 static uint16 holetab_v[4] = { 0x000F, 0x00F0, 0x0F00, 0xF000 };
 
+// Array of count T at offset inside the mapping, NULL if it does not fit or is not aligned for T
+template<typename T>
+static T* MappedArray(ACE_Mem_Map const& mapping, size_t offset, size_t count)
+{
+    if (offset % sizeof(T) != 0 || offset > mapping.size() || count > (mapping.size() - offset) / sizeof(T))
+    {
+        return NULL;
+    }
+
+    return reinterpret_cast<T*>(static_cast<char*>(mapping.addr()) + offset);
+}
+
+// Copy of a header at offset inside the mapping, headers might not be aligned
+template<typename T>
+static bool ReadMapped(ACE_Mem_Map const& mapping, size_t offset, T& data)
+{
+    if (offset > mapping.size() || sizeof(T) > mapping.size() - offset)
+    {
+        return false;
+    }
+
+    memcpy(&data, static_cast<char*>(mapping.addr()) + offset, sizeof(T));
+    return true;
+}
+
 GridMap::GridMap()
 {
     m_flags = 0;
@@ -68,6 +102,9 @@ GridMap::GridMap()
     m_liquidFlags = NULL;
     m_liquidEntry = NULL;
     m_liquid_map  = NULL;
+
+    m_mapping = NULL;
+    m_dataSize = 0;
 }
 
 GridMap::~GridMap()
@@ -80,6 +117,13 @@ bool GridMap::loadData(char* filename)
     // Unload old data if exist
     unloadData();
 
+    // errors are reported by the reading path below
+    if (sWorld.getConfig(CONFIG_BOOL_GRID_MAP_FILES_MAPPED) && loadMappedData(filename))
+    {
+        CountData(uint32(m_mapping->size()));
+        return true;
+    }
+
     GridMapFileHeader header;
     // Not return error if file not found
     FILE* in = fopen(filename, "rb");
@@ -126,6 +170,8 @@ bool GridMap::loadData(char* filename)
         }
 
         fclose(in);
+        // the sizes in the file are close to the arrays read from it
+        CountData(header.areaMapSize + header.holesSize + header.heightMapSize + header.liquidMapSize);
         return true;
     }
 
@@ -134,14 +180,61 @@ bool GridMap::loadData(char* filename)
     return false;
 }
 
+void GridMap::CountData(uint32 size)
+{
+    m_dataSize = size;
+    if (m_mapping)
+    {
+        ++s_mappedGrids;
+        s_mappedBytes += size;
+    }
+    else
+    {
+        ++s_heapGrids;
+        s_heapBytes += size;
+    }
+}
+
+void GridMap::GetMemoryUsage(uint32& heapGrids, uint64& heapBytes, uint32& mappedGrids, uint64& mappedBytes)
+{
+    heapGrids = s_heapGrids.load();
+    heapBytes = s_heapBytes.load();
+    mappedGrids = s_mappedGrids.load();
+    mappedBytes = s_mappedBytes.load();
+}
+
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_liquidEntry;
-    delete[] m_liquidFlags;
-    delete[] m_liquid_map;
+    if (m_dataSize)
+    {
+        if (m_mapping)
+        {
+            --s_mappedGrids;
+            s_mappedBytes -= m_dataSize;
+        }
+        else
+        {
+            --s_heapGrids;
+            s_heapBytes -= m_dataSize;
+        }
+
+        m_dataSize = 0;
+    }
+
+    if (m_mapping)
+    {
+        delete m_mapping;                                   // unmaps the file the data pointers point into
+        m_mapping = NULL;
+    }
+    else
+    {
+        delete[] m_area_map;
+        delete[] m_V9;
+        delete[] m_V8;
+        delete[] m_liquidEntry;
+        delete[] m_liquidFlags;
+        delete[] m_liquid_map;
+    }
 
     m_area_map = NULL;
     m_V9 = NULL;
@@ -152,6 +245,151 @@ void GridMap::unloadData()
     m_gridGetHeight = &GridMap::getHeightFromFlat;
 }
 
+bool GridMap::loadMappedData(char* filename)
+{
+    // read-only and shared: the pages come from the page cache, shared by every process using the file
+    m_mapping = new ACE_Mem_Map();
+    if (m_mapping->map(ACE_TEXT_CHAR_TO_TCHAR(filename), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) != 0)
+    {
+        delete m_mapping;
+        m_mapping = NULL;
+        return false;
+    }
+
+    // the mapping stays valid without the descriptor, loaded grids would hold one each otherwise
+    m_mapping->close_handle();
+
+    GridMapFileHeader header;
+    bool loaded = ReadMapped(*m_mapping, 0, header) &&
+                  header.mapMagic     == *((uint32 const*)(MAP_MAGIC)) &&
+                  header.versionMagic == *((uint32 const*)(MAP_VERSION_MAGIC)) &&
+                  IsAcceptableClientBuild(header.buildMagic) &&
+                  (!header.areaMapOffset || mapAreaData(header.areaMapOffset)) &&
+                  (!header.holesOffset || mapHolesData(header.holesOffset)) &&
+                  (!header.heightMapOffset || mapHeightData(header.heightMapOffset)) &&
+                  (!header.liquidMapOffset || mapGridMapLiquidData(header.liquidMapOffset));
+
+    if (!loaded)
+    {
+        unloadData();
+
+        // back to the defaults for the reading path
+        m_gridArea = 0;
+        m_gridHeight = INVALID_HEIGHT_VALUE;
+        memset(m_holes, 0, sizeof(m_holes));
+        m_liquidType = 0;
+        m_liquid_offX = 0;
+        m_liquid_offY = 0;
+        m_liquid_width = 0;
+        m_liquid_height = 0;
+        m_liquidLevel = INVALID_HEIGHT_VALUE;
+    }
+
+    return loaded;
+}
+
+bool GridMap::mapAreaData(uint32 offset)
+{
+    GridMapAreaHeader header;
+    if (!ReadMapped(*m_mapping, offset, header) || header.fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
+    {
+        return false;
+    }
+
+    m_gridArea = header.gridArea;
+    if (!(header.flags & MAP_AREA_NO_AREA))
+    {
+        m_area_map = MappedArray<uint16>(*m_mapping, offset + sizeof(header), 16 * 16);
+        return m_area_map != NULL;
+    }
+
+    return true;
+}
+
+bool GridMap::mapHeightData(uint32 offset)
+{
+    GridMapHeightHeader header;
+    if (!ReadMapped(*m_mapping, offset, header) || header.fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
+    {
+        return false;
+    }
+
+    m_gridHeight = header.gridHeight;
+    offset += sizeof(header);
+
+    if (header.flags & MAP_HEIGHT_NO_HEIGHT)
+    {
+        m_gridGetHeight = &GridMap::getHeightFromFlat;
+        return true;
+    }
+
+    if ((header.flags & MAP_HEIGHT_AS_INT16))
+    {
+        m_uint16_V9 = MappedArray<uint16>(*m_mapping, offset, 129 * 129);
+        m_uint16_V8 = MappedArray<uint16>(*m_mapping, offset + 129 * 129 * sizeof(uint16), 128 * 128);
+        m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
+        m_gridGetHeight = &GridMap::getHeightFromUint16;
+    }
+    else if ((header.flags & MAP_HEIGHT_AS_INT8))
+    {
+        m_uint8_V9 = MappedArray<uint8>(*m_mapping, offset, 129 * 129);
+        m_uint8_V8 = MappedArray<uint8>(*m_mapping, offset + 129 * 129 * sizeof(uint8), 128 * 128);
+        m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
+        m_gridGetHeight = &GridMap::getHeightFromUint8;
+    }
+    else
+    {
+        m_V9 = MappedArray<float>(*m_mapping, offset, 129 * 129);
+        m_V8 = MappedArray<float>(*m_mapping, offset + 129 * 129 * sizeof(float), 128 * 128);
+        m_gridGetHeight = &GridMap::getHeightFromFloat;
+    }
+
+    return m_V9 != NULL && m_V8 != NULL;
+}
+
+bool GridMap::mapHolesData(uint32 offset)
+{
+    return ReadMapped(*m_mapping, offset, m_holes);
+}
+
+bool GridMap::mapGridMapLiquidData(uint32 offset)
+{
+    GridMapLiquidHeader header;
+    if (!ReadMapped(*m_mapping, offset, header) || header.fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
+    {
+        return false;
+    }
+
+    m_liquidType    = header.liquidType;
+    m_liquid_offX   = header.offsetX;
+    m_liquid_offY   = header.offsetY;
+    m_liquid_width  = header.width;
+    m_liquid_height = header.height;
+    m_liquidLevel   = header.liquidLevel;
+
+    offset += sizeof(header);
+
+    if (!(header.flags & MAP_LIQUID_NO_TYPE))
+    {
+        m_liquidEntry = MappedArray<uint16>(*m_mapping, offset, 16 * 16);
+        m_liquidFlags = MappedArray<uint8>(*m_mapping, offset + 16 * 16 * sizeof(uint16), 16 * 16);
+        if (!m_liquidEntry || !m_liquidFlags)
+        {
+            return false;
+        }
+
+        offset += 16 * 16 * (sizeof(uint16) + sizeof(uint8));
+    }
+
+    if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
+    {
+        m_liquid_map = MappedArray<float>(*m_mapping, offset, m_liquid_width * m_liquid_height);
+        return m_liquid_map != NULL;
+    }
+
+    return true;
+}
+
 bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
 {
     GridMapAreaHeader header;
@@ -581,6 +819,36 @@ float GridMap::getHeightFromUint16(float x, float y) const
     return (float)((a * x) + (b * y) + c) * m_gridIntHeightMultiplier + m_gridHeight;
 }
 
+void GridMap::getHeights(float const* x, float const* y, float* heights, uint32 count) const
+{
+    // the loops call the height functions directly, so they can be inlined
+    if (m_gridGetHeight == &GridMap::getHeightFromFloat)
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            heights[i] = getHeightFromFloat(x[i], y[i]);
+        }
+    }
+    else if (m_gridGetHeight == &GridMap::getHeightFromUint16)
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            heights[i] = getHeightFromUint16(x[i], y[i]);
+        }
+    }
+    else if (m_gridGetHeight == &GridMap::getHeightFromUint8)
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            heights[i] = getHeightFromUint8(x[i], y[i]);
+        }
+    }
+    else
+    {
+        std::fill(heights, heights + count, m_gridHeight);
+    }
+}
+
 float GridMap::getLiquidLevel(float x, float y)
 {
     if (!m_liquid_map)
@@ -806,7 +1074,7 @@ bool GridMap::ExistVMap(uint32 mapid, int gx, int gy)
 }
 
 //////////////////////////////////////////////////////////////////////////
-TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid), m_refMutex(), m_mutex()
+TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid), m_LoadedGridCount(0), m_refMutex(), m_mutex()
 {
     for (int k = 0; k < MAX_NUMBER_OF_GRIDS; ++k)
     {
@@ -814,6 +1082,7 @@ TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid), m_refMutex(), m_mutex()
         {
             m_GridMaps[i][k] = NULL;
             m_GridRef[i][k] = 0;
+            m_PendingGrids[i][k] = false;
         }
     }
 
@@ -834,6 +1103,12 @@ TerrainInfo::~TerrainInfo()
             delete m_GridMaps[i][k];
         }
 
+    // read by the loader threads but never published
+    for (LoadedGridList::const_iterator itr = m_LoadedGrids.begin(); itr != m_LoadedGrids.end(); ++itr)
+    {
+        delete itr->second;
+    }
+
     VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId);
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId);
 }
@@ -936,9 +1211,6 @@ int TerrainInfo::UnrefGrid(const uint32& x, const uint32& y)
 float TerrainInfo::GetHeightStatic(float x, float y, float z, bool useVmaps/*=true*/, float maxSearchDist/*=DEFAULT_HEIGHT_SEARCH*/) const
 {
     float mapHeight = VMAP_INVALID_HEIGHT_VALUE;            // Store Height obtained by maps
-    float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;           // Store Height obtained by vmaps (in "corridor" of z (or slightly above z)
-
-    float z2 = z + 2.f;
 
     // find raw .map surface under Z coordinates (or well-defined above)
     if (GridMap* gmap = const_cast<TerrainInfo*>(this)->GetGrid(x, y))
@@ -946,6 +1218,75 @@ float TerrainInfo::GetHeightStatic(float x, float y, float z, bool useVmaps/*=tr
         mapHeight = gmap->getHeight(x, y);
     }
 
+    return SelectStaticHeight(x, y, z, mapHeight, useVmaps, maxSearchDist);
+}
+
+void TerrainInfo::GetHeightsStatic(float const* x, float const* y, float const* z, float* heights, uint32 count, bool useVmaps/*=true*/, float maxSearchDist/*=DEFAULT_HEIGHT_SEARCH*/) const
+{
+    // points ordered by grid, each grid is looked up once and evaluates its points in one run
+    std::vector<std::pair<uint32, uint32> > order(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint32 gx = uint32(32 - x[i] / SIZE_OF_GRIDS);
+        uint32 gy = uint32(32 - y[i] / SIZE_OF_GRIDS);
+        order[i] = std::make_pair(gx * MAX_NUMBER_OF_GRIDS + gy, i);
+    }
+
+    std::sort(order.begin(), order.end());
+
+    std::vector<float> runX, runY, runHeights;
+
+    for (uint32 begin = 0; begin < count;)
+    {
+        uint32 end = begin + 1;
+        while (end < count && order[end].first == order[begin].first)
+        {
+            ++end;
+        }
+
+        uint32 first = order[begin].second;
+        if (GridMap* gmap = const_cast<TerrainInfo*>(this)->GetGrid(x[first], y[first]))
+        {
+            runX.resize(end - begin);
+            runY.resize(end - begin);
+            runHeights.resize(end - begin);
+
+            for (uint32 i = begin; i < end; ++i)
+            {
+                runX[i - begin] = x[order[i].second];
+                runY[i - begin] = y[order[i].second];
+            }
+
+            gmap->getHeights(&runX[0], &runY[0], &runHeights[0], end - begin);
+
+            for (uint32 i = begin; i < end; ++i)
+            {
+                heights[order[i].second] = runHeights[i - begin];
+            }
+        }
+        else
+        {
+            for (uint32 i = begin; i < end; ++i)
+            {
+                heights[order[i].second] = VMAP_INVALID_HEIGHT_VALUE;
+            }
+        }
+
+        begin = end;
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        heights[i] = SelectStaticHeight(x[i], y[i], z[i], heights[i], useVmaps, maxSearchDist);
+    }
+}
+
+float TerrainInfo::SelectStaticHeight(float x, float y, float z, float mapHeight, bool useVmaps, float maxSearchDist) const
+{
+    float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;           // Store Height obtained by vmaps (in "corridor" of z (or slightly above z)
+
+    float z2 = z + 2.f;
+
     if (useVmaps)
     {
         VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
@@ -1291,47 +1632,160 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
         if (!m_GridMaps[x][y])
         {
-            GridMap* map = new GridMap();
+            m_GridMaps[x][y] = LoadGridMapFile(x, y);
+            LoadVMapAndMMap(x, y);
+        }
+    }
 
-            // map file name
-            int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
-            char* tmp = new char[len];
-            snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
+    return  m_GridMaps[x][y];
+}
 
-            if (!map->loadData(tmp))
-            {
-                sLog.outError("Error load map file: \n %s\n", tmp);
-                // ASSERT(false);
-            }
+GridMap* TerrainInfo::LoadGridMapFile(const uint32 x, const uint32 y) const
+{
+    GridMap* map = new GridMap();
 
-            delete[] tmp;
-            m_GridMaps[x][y] = map;
+    // map file name
+    int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
 
-            // load VMAPs for current map/grid...
-            const MapEntry* i_mapEntry = sMapStore.LookupEntry(m_mapId);
-            const char* mapName = i_mapEntry ? i_mapEntry->name[sWorld.GetDefaultDbcLocale()] : "UNNAMEDMAP\x0";
+    if (!map->loadData(tmp))
+    {
+        sLog.outError("Error load map file: \n %s\n", tmp);
+        // ASSERT(false);
+    }
 
-            int vmapLoadResult = VMAP::VMapFactory::createOrGetVMapManager()->loadMap((sWorld.GetDataPath() + "vmaps").c_str(),  m_mapId, x, y);
-            switch (vmapLoadResult)
-            {
-                case VMAP::VMAP_LOAD_RESULT_OK:
-                    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "VMAP loaded name:%s, id:%d, x:%d, y:%d (vmap rep.: x:%d, y:%d)", mapName, m_mapId, x, y, x, y);
-                    break;
-                case VMAP::VMAP_LOAD_RESULT_ERROR:
-                    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Could not load VMAP name:%s, id:%d, x:%d, y:%d (vmap rep.: x:%d, y:%d)", mapName, m_mapId, x, y, x, y);
-                    break;
-                case VMAP::VMAP_LOAD_RESULT_IGNORED:
-                    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Ignored VMAP name:%s, id:%d, x:%d, y:%d (vmap rep.: x:%d, y:%d)", mapName, m_mapId, x, y, x, y);
-                    break;
-            }
+    delete[] tmp;
+    return map;
+}
 
-            // load navmesh
-            MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y);
+void TerrainInfo::LoadVMapAndMMap(const uint32 x, const uint32 y)
+{
+    // load VMAPs for current map/grid...
+    const MapEntry* i_mapEntry = sMapStore.LookupEntry(m_mapId);
+    const char* mapName = i_mapEntry ? i_mapEntry->name[sWorld.GetDefaultDbcLocale()] : "UNNAMEDMAP\x0";
+
+    int vmapLoadResult = VMAP::VMapFactory::createOrGetVMapManager()->loadMap((sWorld.GetDataPath() + "vmaps").c_str(),  m_mapId, x, y);
+    switch (vmapLoadResult)
+    {
+        case VMAP::VMAP_LOAD_RESULT_OK:
+            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "VMAP loaded name:%s, id:%d, x:%d, y:%d (vmap rep.: x:%d, y:%d)", mapName, m_mapId, x, y, x, y);
+            break;
+        case VMAP::VMAP_LOAD_RESULT_ERROR:
+            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Could not load VMAP name:%s, id:%d, x:%d, y:%d (vmap rep.: x:%d, y:%d)", mapName, m_mapId, x, y, x, y);
+            break;
+        case VMAP::VMAP_LOAD_RESULT_IGNORED:
+            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Ignored VMAP name:%s, id:%d, x:%d, y:%d (vmap rep.: x:%d, y:%d)", mapName, m_mapId, x, y, x, y);
+            break;
+    }
+
+    // load navmesh
+    MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y);
+}
+
+/**
+ * Reads the GridMap file of one grid on a terrain loader thread.
+ *
+ * Only the GridMap is built here, vmap and mmap managers are not thread safe
+ * and get their tiles in PublishLoadedGrids on the map thread. Their files are
+ * read here as well though (vmap models and the navmesh tile), so the tile
+ * load at publish time only has to link the prefetched data.
+ */
+class GridMapLoadRequest : public ACE_Method_Request
+{
+    public:
+        GridMapLoadRequest(TerrainInfo& terrain, uint32 x, uint32 y) : m_terrain(terrain), m_x(x), m_y(y)
+        {
+            m_terrain.AddRef();
+        }
+
+        ~GridMapLoadRequest()
+        {
+            m_terrain.Release();
+        }
+
+        int call() override
+        {
+            GridMap* map = m_terrain.LoadGridMapFile(m_x, m_y);
+            m_terrain.PrefetchVMapAndMMap(m_x, m_y);
+            m_terrain.FinishLoadRequest(m_x, m_y, map);
+            return 0;
         }
+
+    private:
+        TerrainInfo& m_terrain;
+        uint32 m_x;
+        uint32 m_y;
+};
+
+void TerrainInfo::PrefetchVMapAndMMap(const uint32 x, const uint32 y) const
+{
+    VMAP::VMapFactory::createOrGetVMapManager()->prefetchMap((sWorld.GetDataPath() + "vmaps").c_str(), m_mapId, x, y);
+    MMAP::MMapFactory::createOrGetMMapManager()->prefetchTile(m_mapId, x, y);
+}
+
+void TerrainInfo::RequestLoad(const uint32 x, const uint32 y)
+{
+    MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
+    MANGOS_ASSERT(y < MAX_NUMBER_OF_GRIDS);
+
+    if (m_GridMaps[x][y] || m_PendingGrids[x][y] || !sTerrainMgr.IsLoaderActive())
+    {
+        return;
     }
 
-    return  m_GridMaps[x][y];
+    {
+        ACE_GUARD(LOCK_TYPE, lock, m_mutex)
+
+        if (m_GridMaps[x][y] || m_PendingGrids[x][y])
+        {
+            return;
+        }
+
+        m_PendingGrids[x][y] = true;
+    }
+
+    sTerrainMgr.ScheduleLoad(new GridMapLoadRequest(*this, x, y));
+}
+
+void TerrainInfo::FinishLoadRequest(const uint32 x, const uint32 y, GridMap* map)
+{
+    ACE_GUARD(LOCK_TYPE, lock, m_mutex)
+
+    m_LoadedGrids.push_back(std::make_pair(GridPair(x, y), map));
+    ++m_LoadedGridCount;
+}
+
+void TerrainInfo::PublishLoadedGrids()
+{
+    if (m_LoadedGridCount.value() == 0)
+    {
+        return;
+    }
+
+    ACE_GUARD(LOCK_TYPE, lock, m_mutex)
+
+    for (LoadedGridList::const_iterator itr = m_LoadedGrids.begin(); itr != m_LoadedGrids.end(); ++itr)
+    {
+        uint32 x = itr->first.x_coord;
+        uint32 y = itr->first.y_coord;
+
+        m_PendingGrids[x][y] = false;
+
+        // a map needed the grid before the loader was done and loaded it itself
+        if (m_GridMaps[x][y])
+        {
+            delete itr->second;
+            continue;
+        }
+
+        m_GridMaps[x][y] = itr->second;
+        LoadVMapAndMMap(x, y);
+    }
+
+    m_LoadedGrids.clear();
+    m_LoadedGridCount = 0;
 }
 
 float TerrainInfo::GetWaterLevel(float x, float y, float z, float* pGround /*= NULL*/) const
@@ -1371,14 +1825,42 @@ TerrainManager::TerrainManager() : m_mutex()
 
 TerrainManager::~TerrainManager()
 {
+    for (TerrainInfoList::iterator it = m_preloadedTerrain.begin(); it != m_preloadedTerrain.end(); ++it)
+    {
+        delete *it;
+    }
+
     for (TerrainDataMap::iterator it = i_TerrainMap.begin(); it != i_TerrainMap.end(); ++it)
     {
         delete it->second;
     }
 }
 
+void TerrainManager::Initialize()
+{
+    if (!m_preloadedTerrain.empty())
+    {
+        return;
+    }
+
+    // grid files are still read on demand, a TerrainInfo without grids is only its tables
+    m_preloadedTerrain.resize(sMapStore.GetNumRows(), NULL);
+    for (uint32 mapId = 0; mapId < sMapStore.GetNumRows(); ++mapId)
+    {
+        if (sMapStore.LookupEntry(mapId))
+        {
+            m_preloadedTerrain[mapId] = new TerrainInfo(mapId);
+        }
+    }
+}
+
 TerrainInfo* TerrainManager::LoadTerrain(const uint32 mapId)
 {
+    if (mapId < m_preloadedTerrain.size() && m_preloadedTerrain[mapId])
+    {
+        return m_preloadedTerrain[mapId];
+    }
+
     ACE_GUARD_RETURN(LOCK_TYPE, _guard, m_mutex, NULL)
 
     TerrainDataMap::const_iterator iter = i_TerrainMap.find(mapId);
@@ -1398,6 +1880,12 @@ void TerrainManager::UnloadTerrain(const uint32 mapId)
         return;
     }
 
+    // preloaded terrain is looked up without lock so it is kept, its unused grids are freed by CleanUpGrids
+    if (mapId < m_preloadedTerrain.size() && m_preloadedTerrain[mapId])
+    {
+        return;
+    }
+
     ACE_GUARD(LOCK_TYPE, _guard, m_mutex)
 
     TerrainDataMap::iterator iter = i_TerrainMap.find(mapId);
@@ -1413,22 +1901,65 @@ void TerrainManager::UnloadTerrain(const uint32 mapId)
     }
 }
 
+// prefetched vmap models and navmesh tiles not used by a tile load in this time are freed
+#define TERRAIN_PREFETCH_MAX_AGE (5 * MINUTE * IN_MILLISECONDS)
+
 void TerrainManager::Update(const uint32 diff)
 {
     // global garbage collection for GridMap objects and VMaps
+    for (TerrainInfoList::iterator iter = m_preloadedTerrain.begin(); iter != m_preloadedTerrain.end(); ++iter)
+    {
+        if (*iter)
+        {
+            (*iter)->CleanUpGrids(diff);
+        }
+    }
+
     for (TerrainDataMap::iterator iter = i_TerrainMap.begin(); iter != i_TerrainMap.end(); ++iter)
     {
         iter->second->CleanUpGrids(diff);
     }
+
+    // prefetched tiles of grids that were published while already loaded or unloaded again before use
+    if (m_loader.activated())
+    {
+        VMAP::VMapFactory::createOrGetVMapManager()->dropPrefetchedModels(TERRAIN_PREFETCH_MAX_AGE);
+        MMAP::MMapFactory::createOrGetMMapManager()->dropPrefetchedTiles(TERRAIN_PREFETCH_MAX_AGE);
+    }
+}
+
+void TerrainManager::ActivateLoader(uint32 num_threads, std::string const& cpus)
+{
+    m_loader.set_affinity(cpus);
+    if (num_threads > 0 && m_loader._activate(num_threads) == -1)
+    {
+        sLog.outError("TerrainManager: can't start %u terrain loader threads, grid terrain is loaded on the map threads", num_threads);
+    }
+}
+
+void TerrainManager::DeactivateLoader()
+{
+    if (m_loader.activated())
+    {
+        m_loader.deactivate();
+    }
 }
 
 void TerrainManager::UnloadAll()
 {
+    DeactivateLoader();
+
+    for (TerrainInfoList::iterator it = m_preloadedTerrain.begin(); it != m_preloadedTerrain.end(); ++it)
+    {
+        delete *it;
+    }
+
     for (TerrainDataMap::iterator it = i_TerrainMap.begin(); it != i_TerrainMap.end(); ++it)
     {
         delete it->second;
     }
 
+    m_preloadedTerrain.clear();
     i_TerrainMap.clear();
 }
 
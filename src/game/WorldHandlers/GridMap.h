@@ -28,7 +28,9 @@
 #include "Platform/Define.h"
 #include "Policies/Singleton.h"
 #include "GridDefines.h"
+#include "DelayExecutor.h"
 
+#include <atomic>
 #include <bitset>
 #include <list>
 
@@ -39,6 +41,9 @@ class InstanceData;
 class Group;
 class BattleGround;
 class Map;
+class ACE_Mem_Map;
+
+extern char const* MAP_VERSION_MAGIC;
 
 struct GridMapFileHeader
 {
@@ -158,6 +163,23 @@ class GridMap
         uint8* m_liquidFlags;
         float* m_liquid_map;
 
+        // read-only shared mapping of the .map file the data pointers point into, NULL if they own heap arrays
+        ACE_Mem_Map* m_mapping;
+        uint32 m_dataSize;                                  // bytes counted in the memory usage, 0 if none are
+
+        void CountData(uint32 size);
+
+        static std::atomic<uint32> s_heapGrids;
+        static std::atomic<uint64> s_heapBytes;
+        static std::atomic<uint32> s_mappedGrids;
+        static std::atomic<uint64> s_mappedBytes;
+
+        bool loadMappedData(char* filename);
+        bool mapAreaData(uint32 offset);
+        bool mapHeightData(uint32 offset);
+        bool mapGridMapLiquidData(uint32 offset);
+        bool mapHolesData(uint32 offset);
+
         bool loadAreaData(FILE* in, uint32 offset, uint32 size);
         bool loadHeightData(FILE* in, uint32 offset, uint32 size);
         bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
@@ -180,11 +202,16 @@ class GridMap
         bool loadData(char* filaname);
         void unloadData();
 
+        // grids holding their data on the heap and grids mapping their file, of all maps
+        static void GetMemoryUsage(uint32& heapGrids, uint64& heapBytes, uint32& mappedGrids, uint64& mappedBytes);
+
         static bool ExistMap(uint32 mapid, int gx, int gy);
         static bool ExistVMap(uint32 mapid, int gx, int gy);
 
         uint16 getArea(float x, float y);
         float getHeight(float x, float y) { return (this->*m_gridGetHeight)(x, y); }
+        // getHeight of count points of this grid, the height format is selected once for all of them
+        void getHeights(float const* x, float const* y, float* heights, uint32 count) const;
         float getLiquidLevel(float x, float y);
         uint8 getTerrainType(float x, float y);
         GridMapLiquidStatus getLiquidStatus(float x, float y, float z, uint8 ReqLiquidType, GridMapLiquidData* data = 0);
@@ -228,6 +255,8 @@ class TerrainInfo : public Referencable<AtomicLong>
         // TODO: move all terrain/vmaps data info query functions
         // from 'Map' class into this class
         float GetHeightStatic(float x, float y, float z, bool checkVMap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
+        // GetHeightStatic of count points, the .map heights are looked up grid by grid
+        void GetHeightsStatic(float const* x, float const* y, float const* z, float* heights, uint32 count, bool checkVMap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
         float GetWaterLevel(float x, float y, float z, float* pGround = NULL) const;
         float GetWaterOrGroundLevel(float x, float y, float z, float* pGround = NULL, bool swim = false) const;
         bool IsInWater(float x, float y, float z, GridMapLiquidData* data = 0) const;
@@ -255,16 +284,31 @@ class TerrainInfo : public Referencable<AtomicLong>
 
     protected:
         friend class Map;
+        friend class GridMapLoadRequest;
         // load/unload terrain data
         GridMap* Load(const uint32 x, const uint32 y);
         void Unload(const uint32 x, const uint32 y);
 
+        // queue reading the GridMap file of a grid on the terrain loader threads, no-op if loaded or queued already
+        void RequestLoad(const uint32 x, const uint32 y);
+        // the grid was requested and the loader threads have not published it yet
+        bool IsLoadPending(const uint32 x, const uint32 y) const { return m_PendingGrids[x][y]; }
+        // hand the GridMaps read by the loader threads to the grid table, called from the map update
+        void PublishLoadedGrids();
+
     private:
         TerrainInfo(const TerrainInfo&);
         TerrainInfo& operator=(const TerrainInfo&);
 
         GridMap* GetGrid(const float x, const float y);
+        // combines the .map height of a point with its vmap height
+        float SelectStaticHeight(float x, float y, float z, float mapHeight, bool useVmaps, float maxSearchDist) const;
         GridMap* LoadMapAndVMap(const uint32 x, const uint32 y);
+        GridMap* LoadGridMapFile(const uint32 x, const uint32 y) const;
+        // read the vmap models and navmesh tile of a grid for the later LoadVMapAndMMap, thread safe
+        void PrefetchVMapAndMMap(const uint32 x, const uint32 y) const;
+        void LoadVMapAndMMap(const uint32 x, const uint32 y);
+        void FinishLoadRequest(const uint32 x, const uint32 y, GridMap* map);
 
         int RefGrid(const uint32& x, const uint32& y);
         int UnrefGrid(const uint32& x, const uint32& y);
@@ -274,6 +318,12 @@ class TerrainInfo : public Referencable<AtomicLong>
         GridMap* m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
+        // grids requested from the loader threads, both guarded by m_mutex
+        bool m_PendingGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        typedef std::vector<std::pair<GridPair, GridMap*> > LoadedGridList;
+        LoadedGridList m_LoadedGrids;
+        AtomicLong m_LoadedGridCount;                       // lock-less check for PublishLoadedGrids
+
         // global garbage collection timer
         IntervalTimer i_timer;
 
@@ -290,12 +340,21 @@ class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLev
         friend class MaNGOS::OperatorNew<TerrainManager>;
 
     public:
+        // create the terrain of every map in Map.dbc, called once after the DBC stores are loaded
+        void Initialize();
+        // lock free for the maps created by Initialize, other map ids are created on demand under the lock
         TerrainInfo* LoadTerrain(const uint32 mapId);
         void UnloadTerrain(const uint32 mapId);
 
         void Update(const uint32 diff);
         void UnloadAll();
 
+        // start the threads reading GridMap files ahead of players, see Map::RequestGridsAround
+        void ActivateLoader(uint32 num_threads, std::string const& cpus = "");
+        void DeactivateLoader();
+        bool IsLoaderActive() { return m_loader.activated(); }
+        void ScheduleLoad(ACE_Method_Request* rq) { m_loader.execute(rq); }
+
         uint16 GetAreaFlag(uint32 mapid, float x, float y, float z) const
         {
             TerrainInfo* pData = const_cast<TerrainManager*>(this)->LoadTerrain(mapid);
@@ -327,7 +386,12 @@ class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLev
 
         typedef ACE_Thread_Mutex LOCK_TYPE;
         LOCK_TYPE m_mutex;
-        TerrainDataMap i_TerrainMap;
+
+        typedef std::vector<TerrainInfo*> TerrainInfoList;
+        TerrainInfoList m_preloadedTerrain;                 // indexed by map id, never changed after Initialize
+        TerrainDataMap i_TerrainMap;                        // map ids without Map.dbc entry, guarded by m_mutex
+
+        DelayExecutor m_loader;
 };
 
 #define sTerrainMgr TerrainManager::Instance()
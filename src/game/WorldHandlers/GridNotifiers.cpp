@@ -45,13 +45,19 @@ void VisibleChangesNotifier::Visit(CameraMapType& m)
 void VisibleNotifier::Notify()
 {
     Player& player = *i_camera.GetOwner();
-    // at this moment i_clientGUIDs have guids that not iterate at grid level checks
+
+    // sorted once instead of copying the client guid set before the grid pass and erasing every visited guid from it
+    std::sort(i_visitedGUIDs.begin(), i_visitedGUIDs.end());
+
+    // at this moment client guids not in i_visitedGUIDs were not iterated at grid level checks
     // but exist one case when this possible and object not out of range: transports
     if (Transport* transport = player.GetTransport())
     {
+        GuidVector passengerGUIDs;
         for (UnitSet::const_iterator itr = transport->GetPassengers().begin(); itr != transport->GetPassengers().end(); ++itr)
         {
-            if (i_clientGUIDs.find((*itr)->GetObjectGuid()) != i_clientGUIDs.end())
+            ObjectGuid guid = (*itr)->GetObjectGuid();
+            if (!std::binary_search(i_visitedGUIDs.begin(), i_visitedGUIDs.end(), guid) && player.m_clientGUIDs.find(guid) != player.m_clientGUIDs.end())
             {
                 // ignore far sight case
                 if(Player* p = (*itr)->ToPlayer())
@@ -59,14 +65,30 @@ void VisibleNotifier::Notify()
                     p->UpdateVisibilityOf(p, &player);
                 }
                 player.UpdateVisibilityOf(&player, (WorldObject*)(*itr), i_data, i_visibleNow);
-                i_clientGUIDs.erase((*itr)->GetObjectGuid());
+                passengerGUIDs.push_back(guid);
             }
         }
+
+        if (!passengerGUIDs.empty())
+        {
+            i_visitedGUIDs.insert(i_visitedGUIDs.end(), passengerGUIDs.begin(), passengerGUIDs.end());
+            std::sort(i_visitedGUIDs.begin(), i_visitedGUIDs.end());
+        }
+    }
+
+    // guids added to the client during the pass were visited, so this matches the client state before the pass
+    GuidSet outOfRange;
+    for (GuidSet::const_iterator itr = player.m_clientGUIDs.begin(); itr != player.m_clientGUIDs.end(); ++itr)
+    {
+        if (!std::binary_search(i_visitedGUIDs.begin(), i_visitedGUIDs.end(), *itr))
+        {
+            outOfRange.insert(outOfRange.end(), *itr);
+        }
     }
 
     // generate outOfRange for not iterate objects
-    i_data.AddOutOfRangeGUID(i_clientGUIDs);
-    for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end(); ++itr)
+    i_data.AddOutOfRangeGUID(outOfRange);
+    for (GuidSet::iterator itr = outOfRange.begin(); itr != outOfRange.end(); ++itr)
     {
         player.m_clientGUIDs.erase(*itr);
 
@@ -100,7 +122,7 @@ void VisibleNotifier::Notify()
     // Now do operations that required done at object visibility change to visible
 
     // send data at target visibility change (adding to client)
-    for (std::set<WorldObject*>::const_iterator vItr = i_visibleNow.begin(); vItr != i_visibleNow.end(); ++vItr)
+    for (std::vector<WorldObject*>::const_iterator vItr = i_visibleNow.begin(); vItr != i_visibleNow.end(); ++vItr)
     {
         // target aura duration for caster show only if target exist at caster client
         if ((*vItr) != &player && (*vItr)->isType(TYPEMASK_UNIT))
@@ -120,7 +142,7 @@ void MessageDeliverer::Visit(CameraMapType& m)
         {
             if (WorldSession* session = owner->GetSession())
             {
-                session->SendPacket(i_message);
+                session->SendPacket(i_message, i_shared);
             }
         }
     }
@@ -139,8 +161,23 @@ void MessageDelivererExcept::Visit(CameraMapType& m)
 
         if (WorldSession* session = owner->GetSession())
         {
-            session->SendPacket(i_message);
+            session->SendPacket(i_message, i_shared);
+        }
+    }
+}
+
+void MovementMessageDeliverer::Visit(CameraMapType& m)
+{
+    for (CameraMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        Player* owner = iter->getSource()->GetOwner();
+
+        if (owner == i_skipped_receiver)
+        {
+            continue;
         }
+
+        owner->GetMovementCoalescer().Relay(owner, &i_mover, i_message, i_shared);
     }
 }
 
@@ -150,7 +187,7 @@ void ObjectMessageDeliverer::Visit(CameraMapType& m)
     {
         if (WorldSession* session = iter->getSource()->GetOwner()->GetSession())
         {
-            session->SendPacket(i_message);
+            session->SendPacket(i_message, i_shared);
         }
     }
 }
@@ -167,7 +204,7 @@ void MessageDistDeliverer::Visit(CameraMapType& m)
         {
             if (WorldSession* session = owner->GetSession())
             {
-                session->SendPacket(i_message);
+                session->SendPacket(i_message, i_shared);
             }
         }
     }
@@ -181,7 +218,41 @@ void ObjectMessageDistDeliverer::Visit(CameraMapType& m)
         {
             if (WorldSession* session = iter->getSource()->GetOwner()->GetSession())
             {
-                session->SendPacket(i_message);
+                session->SendPacket(i_message, i_shared);
+            }
+        }
+    }
+}
+
+CombatLogDeliverer::CombatLogDeliverer(Unit const& source, Unit const* target, WorldPacket* const* msgs, size_t count, float dist)
+    : i_source(source), i_sourcePlayer(source.GetCharmerOrOwnerOrOwnGuid()), i_messages(msgs), i_count(count), i_shared(count), i_dist(dist)
+{
+    if (target)
+    {
+        i_targetPlayer = target->GetCharmerOrOwnerOrOwnGuid();
+    }
+}
+
+void CombatLogDeliverer::Visit(CameraMapType& m)
+{
+    for (CameraMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        Player* owner = iter->getSource()->GetOwner();
+
+        if (owner == &i_source)
+        {
+            continue;
+        }
+
+        if (!i_dist || iter->getSource()->GetBody()->IsWithinDist(&i_source, i_dist) ||
+            owner->GetObjectGuid() == i_sourcePlayer || owner->GetObjectGuid() == i_targetPlayer)
+        {
+            if (WorldSession* session = owner->GetSession())
+            {
+                for (size_t i = 0; i < i_count; ++i)
+                {
+                    session->SendCombatLog(i_messages[i], i_shared[i]);
+                }
             }
         }
     }
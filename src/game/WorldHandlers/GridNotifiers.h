@@ -40,15 +40,26 @@ namespace MaNGOS
     {
         Camera& i_camera;
         UpdateData i_data;
-        GuidSet i_clientGUIDs;
-        std::set<WorldObject*> i_visibleNow;
+        GuidVector i_visitedGUIDs;                          // checked at grid level, other client guids are out of range
+        std::vector<WorldObject*> i_visibleNow;
 
-        explicit VisibleNotifier(Camera& c) : i_camera(c), i_clientGUIDs(c.GetOwner()->m_clientGUIDs) {}
+        explicit VisibleNotifier(Camera& c) : i_camera(c) {}
         template<class T> void Visit(GridRefManager<T>& m);
         void Visit(CameraMapType& /*m*/) {}
+        void Visit(std::vector<WorldObject*> const& objects);
         void Notify(void);
     };
 
+    // collects what VisibleNotifier would visit, so cameras over the same cells share one grid walk
+    struct VisibleObjectsGatherer
+    {
+        std::vector<WorldObject*>& i_objects;
+
+        explicit VisibleObjectsGatherer(std::vector<WorldObject*>& objects) : i_objects(objects) {}
+        template<class T> void Visit(GridRefManager<T>& m);
+        void Visit(CameraMapType& /*m*/) {}
+    };
+
     struct VisibleChangesNotifier
     {
         WorldObject& i_object;
@@ -62,6 +73,7 @@ namespace MaNGOS
     {
         Player const& i_player;
         WorldPacket* i_message;
+        SharedWorldPacket i_shared;                         // one payload for all receiving sockets
         bool i_toSelf;
         MessageDeliverer(Player const& pl, WorldPacket* msg, bool to_self) : i_player(pl), i_message(msg), i_toSelf(to_self) {}
         void Visit(CameraMapType& m);
@@ -71,6 +83,7 @@ namespace MaNGOS
     struct MessageDelivererExcept
     {
         WorldPacket*  i_message;
+        SharedWorldPacket i_shared;
         Player const* i_skipped_receiver;
 
         MessageDelivererExcept(WorldPacket* msg, Player const* skipped)
@@ -80,9 +93,25 @@ namespace MaNGOS
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
 
+    // movement of i_mover, rate shaped per observer by MovementCoalescer
+    struct MovementMessageDeliverer
+    {
+        WorldObject const& i_mover;
+        WorldPacket* i_message;
+        SharedWorldPacket i_shared;
+        Player const* i_skipped_receiver;
+
+        MovementMessageDeliverer(WorldObject const& mover, WorldPacket* msg, Player const* skipped)
+            : i_mover(mover), i_message(msg), i_skipped_receiver(skipped) {}
+
+        void Visit(CameraMapType& m);
+        template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
+    };
+
     struct ObjectMessageDeliverer
     {
         WorldPacket* i_message;
+        SharedWorldPacket i_shared;
         explicit ObjectMessageDeliverer(WorldPacket* msg) : i_message(msg) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
@@ -92,6 +121,7 @@ namespace MaNGOS
     {
         Player const& i_player;
         WorldPacket* i_message;
+        SharedWorldPacket i_shared;
         bool i_toSelf;
         bool i_ownTeamOnly;
         float i_dist;
@@ -106,12 +136,28 @@ namespace MaNGOS
     {
         WorldObject const& i_object;
         WorldPacket* i_message;
+        SharedWorldPacket i_shared;
         float i_dist;
         ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket* msg, float dist) : i_object(obj), i_message(msg), i_dist(dist) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
 
+    // combat logs of i_source, sent through WorldSession::SendCombatLog; a player source is skipped, it sends to itself
+    struct CombatLogDeliverer
+    {
+        Unit const& i_source;
+        ObjectGuid i_sourcePlayer;                          // players always told about their own fights
+        ObjectGuid i_targetPlayer;
+        WorldPacket* const* i_messages;
+        size_t i_count;
+        std::vector<SharedWorldPacket> i_shared;            // one payload per message for all receiving sockets
+        float i_dist;
+        CombatLogDeliverer(Unit const& source, Unit const* target, WorldPacket* const* msgs, size_t count, float dist);
+        void Visit(CameraMapType& m);
+        template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
+    };
+
     struct ObjectUpdater
     {
         uint32 i_timeDiff;
@@ -171,12 +217,16 @@ namespace MaNGOS
     template<class Check>
     struct SomeSearcher
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_CREATURE;  // only the containers of these types are walked
+
         ResultType& i_result;
         Check & i_check;
 
         SomeSearcher(ResultType& result, Check & check)
             : i_phaseMask(check.GetFocusObject().GetPhaseMask()), i_result(result), i_check(check) {}
 
+        bool IsDone() const { return i_result != NULL; }     // optional, ends the walk early
+
         void Visit(CreatureMapType &m);
         {
             ..some code fast return if result found
@@ -206,11 +256,16 @@ namespace MaNGOS
     template<class Check>
     struct WorldObjectSearcher
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_WORLDOBJECT;
+
         WorldObject*& i_object;
         Check& i_check;
 
         WorldObjectSearcher(WorldObject*& result, Check& check) : i_object(result), i_check(check) {}
 
+        // stops the grid walk once the first match is found
+        bool IsDone() const { return i_object != NULL; }
+
         void Visit(GameObjectMapType& m);
         void Visit(PlayerMapType& m);
         void Visit(CreatureMapType& m);
@@ -223,6 +278,8 @@ namespace MaNGOS
     template<class Check>
     struct WorldObjectLastSearcher
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_WORLDOBJECT;
+
         WorldObject*& i_object;
         Check& i_check;
 
@@ -237,13 +294,15 @@ namespace MaNGOS
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
-    template<class Check>
+    template<class Check, class Container = std::list<WorldObject*> >
     struct WorldObjectListSearcher
     {
-        std::list<WorldObject*>& i_objects;
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_WORLDOBJECT;
+
+        Container& i_objects;
         Check& i_check;
 
-        WorldObjectListSearcher(std::list<WorldObject*>& objects, Check& check) : i_objects(objects), i_check(check) {}
+        WorldObjectListSearcher(Container& objects, Check& check) : i_objects(objects), i_check(check) {}
 
         void Visit(PlayerMapType& m);
         void Visit(CreatureMapType& m);
@@ -257,6 +316,8 @@ namespace MaNGOS
     template<class Do>
     struct WorldObjectWorker
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_WORLDOBJECT;
+
         Do const& i_do;
 
         explicit WorldObjectWorker(Do const& _do) : i_do(_do) {}
@@ -308,11 +369,16 @@ namespace MaNGOS
     template<class Check>
     struct GameObjectSearcher
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_GAMEOBJECT;
+
         GameObject*& i_object;
         Check& i_check;
 
         GameObjectSearcher(GameObject*& result, Check& check) : i_object(result), i_check(check) {}
 
+        // stops the grid walk once the first match is found
+        bool IsDone() const { return i_object != NULL; }
+
         void Visit(GameObjectMapType& m);
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
@@ -322,6 +388,8 @@ namespace MaNGOS
     template<class Check>
     struct GameObjectLastSearcher
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_GAMEOBJECT;
+
         GameObject*& i_object;
         Check& i_check;
 
@@ -332,13 +400,15 @@ namespace MaNGOS
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
-    template<class Check>
+    template<class Check, class Container = std::list<GameObject*> >
     struct GameObjectListSearcher
     {
-        std::list<GameObject*>& i_objects;
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_GAMEOBJECT;
+
+        Container& i_objects;
         Check& i_check;
 
-        GameObjectListSearcher(std::list<GameObject*>& objects, Check& check) : i_objects(objects), i_check(check) {}
+        GameObjectListSearcher(Container& objects, Check& check) : i_objects(objects), i_check(check) {}
 
         void Visit(GameObjectMapType& m);
 
@@ -351,11 +421,16 @@ namespace MaNGOS
     template<class Check>
     struct UnitSearcher
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_UNIT;
+
         Unit*& i_object;
         Check& i_check;
 
         UnitSearcher(Unit*& result, Check& check) : i_object(result), i_check(check) {}
 
+        // stops the grid walk once the first match is found
+        bool IsDone() const { return i_object != NULL; }
+
         void Visit(CreatureMapType& m);
         void Visit(PlayerMapType& m);
 
@@ -366,6 +441,8 @@ namespace MaNGOS
     template<class Check>
     struct UnitLastSearcher
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_UNIT;
+
         Unit*& i_object;
         Check& i_check;
 
@@ -378,13 +455,15 @@ namespace MaNGOS
     };
 
     // All accepted by Check units if any
-    template<class Check>
+    template<class Check, class Container = std::list<Unit*> >
     struct UnitListSearcher
     {
-        std::list<Unit*>& i_objects;
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_UNIT;
+
+        Container& i_objects;
         Check& i_check;
 
-        UnitListSearcher(std::list<Unit*>& objects, Check& check) : i_objects(objects), i_check(check) {}
+        UnitListSearcher(Container& objects, Check& check) : i_objects(objects), i_check(check) {}
 
         void Visit(PlayerMapType& m);
         void Visit(CreatureMapType& m);
@@ -396,6 +475,8 @@ namespace MaNGOS
     template<class Do>
     struct UnitWorker
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_UNIT;
+
         Do& i_do;
 
         explicit UnitWorker(Do& _do) : i_do(_do) {}
@@ -423,11 +504,16 @@ namespace MaNGOS
     template<class Check>
     struct CreatureSearcher
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_CREATURE;
+
         Creature*& i_object;
         Check& i_check;
 
         CreatureSearcher(Creature*& result, Check& check) : i_object(result), i_check(check) {}
 
+        // stops the grid walk once the first match is found
+        bool IsDone() const { return i_object != NULL; }
+
         void Visit(CreatureMapType& m);
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
@@ -437,6 +523,8 @@ namespace MaNGOS
     template<class Check>
     struct CreatureLastSearcher
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_CREATURE;
+
         Creature*& i_object;
         Check& i_check;
 
@@ -447,13 +535,15 @@ namespace MaNGOS
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
-    template<class Check>
+    template<class Check, class Container = std::list<Creature*> >
     struct CreatureListSearcher
     {
-        std::list<Creature*>& i_objects;
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_CREATURE;
+
+        Container& i_objects;
         Check& i_check;
 
-        CreatureListSearcher(std::list<Creature*>& objects, Check& check) : i_objects(objects), i_check(check) {}
+        CreatureListSearcher(Container& objects, Check& check) : i_objects(objects), i_check(check) {}
 
         void Visit(CreatureMapType& m);
 
@@ -463,6 +553,8 @@ namespace MaNGOS
     template<class Do>
     struct CreatureWorker
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_CREATURE;
+
         Do& i_do;
 
         CreatureWorker(WorldObject const* searcher, Do& _do) : i_do(_do) {}
@@ -483,23 +575,30 @@ namespace MaNGOS
     template<class Check>
     struct PlayerSearcher
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_PLAYER;
+
         Player*& i_object;
         Check& i_check;
 
         PlayerSearcher(Player*& result, Check& check) : i_object(result), i_check(check) {}
 
+        // stops the grid walk once the first match is found
+        bool IsDone() const { return i_object != NULL; }
+
         void Visit(PlayerMapType& m);
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
-    template<class Check>
+    template<class Check, class Container = std::list<Player*> >
     struct PlayerListSearcher
     {
-        std::list<Player*>& i_objects;
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_PLAYER;
+
+        Container& i_objects;
         Check& i_check;
 
-        PlayerListSearcher(std::list<Player*>& objects, Check& check)
+        PlayerListSearcher(Container& objects, Check& check)
             : i_objects(objects), i_check(check) {}
 
         void Visit(PlayerMapType& m);
@@ -510,6 +609,8 @@ namespace MaNGOS
     template<class Do>
     struct PlayerWorker
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_PLAYER;
+
         Do& i_do;
 
         explicit PlayerWorker(Do& _do) : i_do(_do) {}
@@ -528,6 +629,8 @@ namespace MaNGOS
     template<class Do>
     struct CameraDistWorker
     {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_CAMERA;
+
         WorldObject const* i_searcher;
         float i_dist;
         Do& i_do;
@@ -549,6 +652,33 @@ namespace MaNGOS
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
+    // Distance from the searcher to the nearest camera closer than i_dist
+    struct NearestCameraDistWorker
+    {
+        static const uint32 VISIT_MASK = GRID_MAP_TYPE_MASK_CAMERA;
+
+        WorldObject const* i_searcher;
+        float i_dist;
+        bool i_found;
+
+        NearestCameraDistWorker(WorldObject const* searcher, float _dist)
+            : i_searcher(searcher), i_dist(_dist), i_found(false) {}
+
+        void Visit(CameraMapType& m)
+        {
+            for (CameraMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+            {
+                float dist = itr->getSource()->GetBody()->GetDistance(i_searcher);
+                if (dist < i_dist)
+                {
+                    i_dist = dist;
+                    i_found = true;
+                }
+            }
+        }
+        template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
+    };
+
     // CHECKS && DO classes
 
     /* Model Check class:
@@ -40,7 +40,25 @@ inline void MaNGOS::VisibleNotifier::Visit(GridRefManager<T>& m)
     for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
         i_camera.UpdateVisibilityOf(iter->getSource(), i_data, i_visibleNow);
-        i_clientGUIDs.erase(iter->getSource()->GetObjectGuid());
+        i_visitedGUIDs.push_back(iter->getSource()->GetObjectGuid());
+    }
+}
+
+inline void MaNGOS::VisibleNotifier::Visit(std::vector<WorldObject*> const& objects)
+{
+    for (std::vector<WorldObject*>::const_iterator iter = objects.begin(); iter != objects.end(); ++iter)
+    {
+        i_camera.UpdateVisibilityOf(*iter, i_data, i_visibleNow);
+        i_visitedGUIDs.push_back((*iter)->GetObjectGuid());
+    }
+}
+
+template<class T>
+inline void MaNGOS::VisibleObjectsGatherer::Visit(GridRefManager<T>& m)
+{
+    for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        i_objects.push_back(iter->getSource());
     }
 }
 
@@ -48,7 +66,20 @@ inline void MaNGOS::ObjectUpdater::Visit(CreatureMapType& m)
 {
     for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
-        WorldObject::UpdateHelper helper(iter->getSource());
+        Creature* creature = iter->getSource();
+
+        // sleeping creatures only get updated again for events scheduled meanwhile
+        if (creature->IsSleeping())
+        {
+            if (creature->m_Events.Empty())
+            {
+                continue;
+            }
+
+            creature->WakeUp();
+        }
+
+        WorldObject::UpdateHelper helper(creature);
         helper.Update(i_timeDiff);
     }
 }
@@ -416,8 +447,8 @@ void MaNGOS::WorldObjectLastSearcher<Check>::Visit(DynamicObjectMapType& m)
     }
 }
 
-template<class Check>
-void MaNGOS::WorldObjectListSearcher<Check>::Visit(PlayerMapType& m)
+template<class Check, class Container>
+void MaNGOS::WorldObjectListSearcher<Check, Container>::Visit(PlayerMapType& m)
 {
     for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
@@ -426,8 +457,8 @@ void MaNGOS::WorldObjectListSearcher<Check>::Visit(PlayerMapType& m)
         }
 }
 
-template<class Check>
-void MaNGOS::WorldObjectListSearcher<Check>::Visit(CreatureMapType& m)
+template<class Check, class Container>
+void MaNGOS::WorldObjectListSearcher<Check, Container>::Visit(CreatureMapType& m)
 {
     for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
@@ -436,8 +467,8 @@ void MaNGOS::WorldObjectListSearcher<Check>::Visit(CreatureMapType& m)
         }
 }
 
-template<class Check>
-void MaNGOS::WorldObjectListSearcher<Check>::Visit(CorpseMapType& m)
+template<class Check, class Container>
+void MaNGOS::WorldObjectListSearcher<Check, Container>::Visit(CorpseMapType& m)
 {
     for (CorpseMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
@@ -446,8 +477,8 @@ void MaNGOS::WorldObjectListSearcher<Check>::Visit(CorpseMapType& m)
         }
 }
 
-template<class Check>
-void MaNGOS::WorldObjectListSearcher<Check>::Visit(GameObjectMapType& m)
+template<class Check, class Container>
+void MaNGOS::WorldObjectListSearcher<Check, Container>::Visit(GameObjectMapType& m)
 {
     for (GameObjectMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
@@ -456,8 +487,8 @@ void MaNGOS::WorldObjectListSearcher<Check>::Visit(GameObjectMapType& m)
         }
 }
 
-template<class Check>
-void MaNGOS::WorldObjectListSearcher<Check>::Visit(DynamicObjectMapType& m)
+template<class Check, class Container>
+void MaNGOS::WorldObjectListSearcher<Check, Container>::Visit(DynamicObjectMapType& m)
 {
     for (DynamicObjectMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
@@ -499,8 +530,8 @@ void MaNGOS::GameObjectLastSearcher<Check>::Visit(GameObjectMapType& m)
     }
 }
 
-template<class Check>
-void MaNGOS::GameObjectListSearcher<Check>::Visit(GameObjectMapType& m)
+template<class Check, class Container>
+void MaNGOS::GameObjectListSearcher<Check, Container>::Visit(GameObjectMapType& m)
 {
     for (GameObjectMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
@@ -573,8 +604,8 @@ void MaNGOS::UnitLastSearcher<Check>::Visit(PlayerMapType& m)
     }
 }
 
-template<class Check>
-void MaNGOS::UnitListSearcher<Check>::Visit(PlayerMapType& m)
+template<class Check, class Container>
+void MaNGOS::UnitListSearcher<Check, Container>::Visit(PlayerMapType& m)
 {
     for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
@@ -583,8 +614,8 @@ void MaNGOS::UnitListSearcher<Check>::Visit(PlayerMapType& m)
         }
 }
 
-template<class Check>
-void MaNGOS::UnitListSearcher<Check>::Visit(CreatureMapType& m)
+template<class Check, class Container>
+void MaNGOS::UnitListSearcher<Check, Container>::Visit(CreatureMapType& m)
 {
     for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
@@ -626,8 +657,8 @@ void MaNGOS::CreatureLastSearcher<Check>::Visit(CreatureMapType& m)
     }
 }
 
-template<class Check>
-void MaNGOS::CreatureListSearcher<Check>::Visit(CreatureMapType& m)
+template<class Check, class Container>
+void MaNGOS::CreatureListSearcher<Check, Container>::Visit(CreatureMapType& m)
 {
     for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
@@ -655,8 +686,8 @@ void MaNGOS::PlayerSearcher<Check>::Visit(PlayerMapType& m)
     }
 }
 
-template<class Check>
-void MaNGOS::PlayerListSearcher<Check>::Visit(PlayerMapType& m)
+template<class Check, class Container>
+void MaNGOS::PlayerListSearcher<Check, Container>::Visit(PlayerMapType& m)
 {
     for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
@@ -38,6 +38,7 @@
 #include "LootMgr.h"
 #include "LFGMgr.h"
 #include "LFGHandler.h"
+#include "CharacterLoginCache.h"
 
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
@@ -1468,16 +1469,21 @@ void Group::UpdatePlayerOutOfRange(Player* pPlayer)
     WorldPacket data;
     pPlayer->GetSession()->BuildPartyMemberStatsChangedPacket(pPlayer, &data);
 
+    // the same stats packet goes to every receiver, share one buffer
+    SharedWorldPacket shared;
+
     for (GroupReference* itr = GetFirstMember(); itr != NULL; itr = itr->next())
         if (Player* player = itr->getSource())
             if (player != pPlayer && !player->HaveAtClient(pPlayer))
             {
-                player->GetSession()->SendPacket(&data);
+                player->GetSession()->SendPacket(&data, shared);
             }
 }
 
 void Group::BroadcastPacket(WorldPacket* packet, bool ignorePlayersInBGRaid, int group, ObjectGuid ignore)
 {
+    SharedWorldPacket shared;
+
     for (GroupReference* itr = GetFirstMember(); itr != NULL; itr = itr->next())
     {
         Player* pl = itr->getSource();
@@ -1488,7 +1494,7 @@ void Group::BroadcastPacket(WorldPacket* packet, bool ignorePlayersInBGRaid, int
 
         if (pl->GetSession() && (group == -1 || itr->getSubGroup() == group))
         {
-            pl->GetSession()->SendPacket(packet);
+            pl->GetSession()->SendPacket(packet, shared);
         }
     }
 }
@@ -1620,6 +1626,9 @@ bool Group::_addMember(ObjectGuid guid, const char* name, bool isAssistant, uint
 
 bool Group::_removeMember(ObjectGuid guid)
 {
+    // the member may be offline with a prefetched login
+    sCharacterLoginCache.Invalidate(guid.GetCounter());
+
     Player* player = sObjectMgr.GetPlayer(guid);
     if (player)
     {
@@ -585,6 +585,7 @@ void WorldSession::HandleGuildSetPublicNoteOpcode(WorldPacket& recvPacket)
     recvPacket >> PNOTE;
 
     slot->SetPNOTE(PNOTE);
+    guild->InvalidateRoster();
 
     guild->Roster(this);
 }
@@ -624,6 +625,7 @@ void WorldSession::HandleGuildSetOfficerNoteOpcode(WorldPacket& recvPacket)
     recvPacket >> OFFNOTE;
 
     slot->SetOFFNOTE(OFFNOTE);
+    guild->InvalidateRoster();
 
     guild->Roster(this);
 }
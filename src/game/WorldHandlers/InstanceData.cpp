@@ -26,8 +26,15 @@
 #include "Database/DatabaseEnv.h"
 #include "Map.h"
 
-void InstanceData::SaveToDB() const
+void InstanceData::FlushSaveToDB()
 {
+    if (!m_saveRequested)
+    {
+        return;
+    }
+
+    m_saveRequested = false;
+
     // no reason to save BGs/Arenas
     if (instance->IsBattleGround())
     {
@@ -39,7 +46,16 @@ void InstanceData::SaveToDB() const
         return;
     }
 
+    // scripts request saves on every state change, many of them leave the data as it was
     std::string data = Save();
+    if (m_hasSavedData && data == m_savedData)
+    {
+        return;
+    }
+
+    m_savedData = data;
+    m_hasSavedData = true;
+
     CharacterDatabase.escape_string(data);
 
     if (instance->Instanceable())
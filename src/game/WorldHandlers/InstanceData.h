@@ -54,7 +54,7 @@ class InstanceData
 {
     public:
 
-        explicit InstanceData(Map* map) : instance(map) {}
+        explicit InstanceData(Map* map) : instance(map), m_saveRequested(false), m_hasSavedData(false) {}
         virtual ~InstanceData() {}
 
         Map* instance;
@@ -68,7 +68,11 @@ class InstanceData
         // When save is needed, this function generates the data
         virtual const char* Save() const { return ""; }
 
-        void SaveToDB() const;
+        // Requests a save, the data is written once at the end of the map update
+        void SaveToDB() const { m_saveRequested = true; }
+
+        // Writes the data if a save was requested and it changed since the last write
+        void FlushSaveToDB();
 
         // Called every map update
         virtual void Update(uint32 /*diff*/) {}
@@ -125,6 +129,11 @@ class InstanceData
         // This is used for such things are heroic loot
         // See ObjectMgr.h enum ConditionSource for possible values of conditionSourceType
         virtual bool CheckConditionCriteriaMeet(Player const* source, uint32 instance_condition_id, WorldObject const* conditionSource, uint32 conditionSourceType) const;
+
+    private:
+        mutable bool m_saveRequested;
+        bool m_hasSavedData;
+        std::string m_savedData;                            // data of the last write
 };
 
 #endif
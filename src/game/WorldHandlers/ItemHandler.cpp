@@ -33,6 +33,7 @@
 #include "UpdateData.h"
 #include "Chat.h"
 #include "World.h"
+#include "QueryResponseCache.h"
 
 void WorldSession::HandleSplitItemOpcode(WorldPacket& recv_data)
 {
@@ -332,6 +333,12 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
     {
         int loc_idx = GetSessionDbLocaleIndex();
 
+        if (SharedWorldPacket response = sQueryResponseCache.Find(QUERY_RESPONSE_ITEM, item, loc_idx))
+        {
+            SendPacket(response.get(), response);
+            return;
+        }
+
         std::string name = pProto->Name1;
         std::string description = pProto->Description;
         sObjectMgr.GetItemLocaleStrings(pProto->ItemId, loc_idx, &name, &description);
@@ -524,7 +531,9 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
         data << pProto->Area;
         data << pProto->Map;                                // Added in 1.12.x & 2.0.1 client branch
         data << pProto->BagFamily;
-        SendPacket(&data);
+
+        SharedWorldPacket response = sQueryResponseCache.Store(QUERY_RESPONSE_ITEM, item, loc_idx, data);
+        SendPacket(response.get(), response);
     }
     else
     {
@@ -1382,6 +1391,7 @@ void WorldSession::HandleWrapItemOpcode(WorldPacket& recv_data)
 
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.PExecute("INSERT INTO `character_gifts` VALUES ('%u', '%u', '%u', '%u')", item->GetOwnerGuid().GetCounter(), item->GetGUIDLow(), item->GetEntry(), item->GetUInt32Value(ITEM_FIELD_FLAGS));
+    _player->UnindexItem(item);
     item->SetEntry(gift->GetEntry());
 
     switch (item->GetEntry())
@@ -1393,6 +1403,7 @@ void WorldSession::HandleWrapItemOpcode(WorldPacket& recv_data)
         case 17307: item->SetEntry(17308); break;
         case 21830: item->SetEntry(21831); break;
     }
+    _player->IndexItem(item);
     item->SetGuidValue(ITEM_FIELD_GIFTCREATOR, _player->GetObjectGuid());
     item->SetUInt32Value(ITEM_FIELD_FLAGS, ITEM_DYNFLAG_WRAPPED);
     item->SetState(ITEM_CHANGED, _player);
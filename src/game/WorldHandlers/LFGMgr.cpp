@@ -79,6 +79,12 @@ void LFGQueue::AddToQueue(Player* leader, uint32 queAreaID)
     else if(!grp)
     {
         // Add player to queued players list
+        QueuedPlayersMap::iterator queued = m_QueuedPlayers.find(leader->GetObjectGuid());
+        if (queued != m_QueuedPlayers.end())
+        {
+            RemoveFromBucket(queued->first, queued->second);
+        }
+
         LFGPlayerQueueInfo& i_Player = m_QueuedPlayers[leader->GetObjectGuid()];
 
         i_Player.roleMask = CalculateRoles((Classes)leader->getClass());
@@ -86,6 +92,8 @@ void LFGQueue::AddToQueue(Player* leader, uint32 queAreaID)
         i_Player.areaId = queAreaID;
         i_Player.hasQueuePriority = false;
 
+        AddToBucket(leader->GetObjectGuid(), i_Player);
+
         leader->GetSession()->SendMeetingstoneSetqueue(queAreaID, MEETINGSTONE_STATUS_JOINED_QUEUE);
     }
     else                                                    // Player is in group, but it's not leader
@@ -109,7 +117,15 @@ void LFGQueue::RestoreOfflinePlayer(ObjectGuid plrGuid)
     if(offlinePlr != m_OfflinePlayers.end())
     {
         plr->GetSession()->SendMeetingstoneSetqueue(offlinePlr->second.areaId, MEETINGSTONE_STATUS_JOINED_QUEUE);
+
+        QueuedPlayersMap::iterator queued = m_QueuedPlayers.find(plrGuid);
+        if (queued != m_QueuedPlayers.end())
+        {
+            RemoveFromBucket(queued->first, queued->second);
+        }
+
         m_QueuedPlayers[plrGuid] = offlinePlr->second;
+        AddToBucket(plrGuid, offlinePlr->second);
         m_OfflinePlayers.erase(offlinePlr);
     }
     else
@@ -219,6 +235,7 @@ void LFGQueue::Update(uint32 diff)
         if(!plr ||!plr->IsInWorld())
         {
             m_OfflinePlayers[qPlayer->first] = qPlayer->second;
+            RemoveFromBucket(qPlayer->first, qPlayer->second);
             m_QueuedPlayers.erase(qPlayer);
             break;
         }
@@ -252,60 +269,57 @@ void LFGQueue::Update(uint32 diff)
                 break;
             }
 
-            // Iterate over QueuedPlayersMap to find suitable player to join group
-            for(QueuedPlayersMap::iterator qPlayer = m_QueuedPlayers.begin(); qPlayer != m_QueuedPlayers.end(); ++qPlayer)
+            // Iterate over the players queued for the same team and area to find suitable player to join group
+            QueueBucket const* bucket = GetBucket(qGroup->second.team, qGroup->second.areaId);
+            for (size_t i = 0; bucket && i < bucket->size(); ++i)
             {
+                QueuedPlayersMap::iterator qPlayer = m_QueuedPlayers.find((*bucket)[i]);
                 Player* plr = sObjectMgr.GetPlayer(qPlayer->first);
 
-                // Check here that players team and areaId they're in queue are same
-                if(qPlayer->second.team == qGroup->second.team &&
-                   qPlayer->second.areaId == qGroup->second.areaId)
+                // Check if player can perform tank role
+                if((canPerformRole(qPlayer->second.roleMask, LFG_ROLE_TANK) & qGroup->second.availableRoles) == LFG_ROLE_TANK)
                 {
-                    // Check if player can perform tank role
-                    if((canPerformRole(qPlayer->second.roleMask, LFG_ROLE_TANK) & qGroup->second.availableRoles) == LFG_ROLE_TANK)
+                    if(FindRoleToGroup(plr, grp, LFG_ROLE_TANK))
                     {
-                        if(FindRoleToGroup(plr, grp, LFG_ROLE_TANK))
-                        {
-                            break;
-                        }
-                        else
-                        {
-                            continue;
-                        }
+                        break;
                     }
-
-                    // Check if player can perform healer role
-                    if((canPerformRole(qPlayer->second.roleMask, LFG_ROLE_HEALER) & qGroup->second.availableRoles) == LFG_ROLE_HEALER)
+                    else
                     {
-                        if(FindRoleToGroup(plr, grp, LFG_ROLE_HEALER))
-                        {
-                            break;
-                        }
-                        else
-                        {
-                            continue;
-                        }
+                        continue;
                     }
+                }
 
-                    // Check if player can perform dps role
-                    if((canPerformRole(qPlayer->second.roleMask, LFG_ROLE_DPS) & qGroup->second.availableRoles) == LFG_ROLE_DPS)
+                // Check if player can perform healer role
+                if((canPerformRole(qPlayer->second.roleMask, LFG_ROLE_HEALER) & qGroup->second.availableRoles) == LFG_ROLE_HEALER)
+                {
+                    if(FindRoleToGroup(plr, grp, LFG_ROLE_HEALER))
                     {
-                        if(FindRoleToGroup(plr, grp, LFG_ROLE_DPS))
-                        {
-                            break;
-                        }
-                        else
-                        {
-                            continue;
-                        }
+                        break;
                     }
+                    else
+                    {
+                        continue;
+                    }
+                }
 
-                    // Check if group is full, no need to try to iterate same group if it's already full.
-                    if(grp->IsFull())
+                // Check if player can perform dps role
+                if((canPerformRole(qPlayer->second.roleMask, LFG_ROLE_DPS) & qGroup->second.availableRoles) == LFG_ROLE_DPS)
+                {
+                    if(FindRoleToGroup(plr, grp, LFG_ROLE_DPS))
                     {
-                        RemoveGroupFromQueue(qGroup->first, GROUP_SYSTEM_LEAVE);
                         break;
                     }
+                    else
+                    {
+                        continue;
+                    }
+                }
+
+                // Check if group is full, no need to try to iterate same group if it's already full.
+                if(grp->IsFull())
+                {
+                    RemoveGroupFromQueue(qGroup->first, GROUP_SYSTEM_LEAVE);
+                    break;
                 }
             }
 
@@ -336,48 +350,47 @@ void LFGQueue::Update(uint32 diff)
         {
             Group* newQueueGroup = new Group;
 
-            // Iterate of QueuedPlayersMap and pick first member to accompany leader.
-            for(QueuedPlayersMap::iterator nPlayer2 = m_QueuedPlayers.begin(); nPlayer2 != m_QueuedPlayers.end(); ++nPlayer2)
+            // Pick first member queued for the same team and area to accompany leader.
+            QueueBucket const* bucket = GetBucket(nPlayer1->second.team, nPlayer1->second.areaId);
+            for (size_t i = 0; bucket && i < bucket->size(); ++i)
             {
+                QueuedPlayersMap::iterator nPlayer2 = m_QueuedPlayers.find((*bucket)[i]);
+
                 if(nPlayer1->first == nPlayer2->first)
                 {
                     continue;
                 }
 
-                if(nPlayer1->second.team == nPlayer2->second.team &&
-                    nPlayer1->second.areaId == nPlayer2->second.areaId)
-                {
-                    Player* leader = sObjectMgr.GetPlayer(nPlayer1->first);
-                    Player* member = sObjectMgr.GetPlayer(nPlayer2->first);
-                    uint32 areaId = nPlayer1->second.areaId;
+                Player* leader = sObjectMgr.GetPlayer(nPlayer1->first);
+                Player* member = sObjectMgr.GetPlayer(nPlayer2->first);
+                uint32 areaId = nPlayer1->second.areaId;
 
-                    if(!newQueueGroup->IsCreated())
+                if(!newQueueGroup->IsCreated())
+                {
+                    if(newQueueGroup->Create(leader->GetObjectGuid(), leader->GetName()))
                     {
-                        if(newQueueGroup->Create(leader->GetObjectGuid(), leader->GetName()))
-                        {
-                            sObjectMgr.AddGroup(newQueueGroup);
-                        }
-                        else
-                        {
-                            return;
-                        }
+                        sObjectMgr.AddGroup(newQueueGroup);
+                    }
+                    else
+                    {
+                        return;
                     }
+                }
 
-                    WorldPacket data;
-                    BuildMemberAddedPacket(data, member->GetObjectGuid());
+                WorldPacket data;
+                BuildMemberAddedPacket(data, member->GetObjectGuid());
 
-                    leader->GetSession()->SendPacket(&data);
+                leader->GetSession()->SendPacket(&data);
 
-                    // Add member to the group. Leader is already added upon creation of group.
-                    newQueueGroup->AddMember(member->GetObjectGuid(), member->GetName(), GROUP_LFG);
+                // Add member to the group. Leader is already added upon creation of group.
+                newQueueGroup->AddMember(member->GetObjectGuid(), member->GetName(), GROUP_LFG);
 
-                    // Add this new group to GroupQueue now and remove players from PlayerQueue
-                    RemovePlayerFromQueue(nPlayer1->first, PLAYER_SYSTEM_LEAVE);
-                    RemovePlayerFromQueue(nPlayer2->first, PLAYER_SYSTEM_LEAVE);
-                    AddToQueue(leader, areaId);
+                // Add this new group to GroupQueue now and remove players from PlayerQueue
+                RemovePlayerFromQueue(nPlayer1->first, PLAYER_SYSTEM_LEAVE);
+                RemovePlayerFromQueue(nPlayer2->first, PLAYER_SYSTEM_LEAVE);
+                AddToQueue(leader, areaId);
 
-                    break;
-                }
+                break;
             }
         }
     }
@@ -400,9 +413,11 @@ bool LFGQueue::FindRoleToGroup(Player* plr, Group* grp, ClassRoles role)
         {
             bool hasBeenLongerInQueue = false;
 
-            // Iterate over QueuedPlayersMap to find if players have been longer in Queue.
-            for (QueuedPlayersMap::iterator qPlayer_loop = m_QueuedPlayers.begin(); qPlayer_loop != m_QueuedPlayers.end(); ++qPlayer_loop)
+            // Iterate over the players competing for the same group to find if players have been longer in Queue.
+            QueueBucket const* bucket = GetBucket(qPlayer->second.team, qPlayer->second.areaId);
+            for (size_t i = 0; bucket && i < bucket->size(); ++i)
             {
+                QueuedPlayersMap::const_iterator qPlayer_loop = m_QueuedPlayers.find((*bucket)[i]);
                 if (qPlayer->first == qPlayer_loop->first)
                 {
                     continue;
@@ -473,9 +488,11 @@ bool LFGQueue::FindRoleToGroup(Player* plr, Group* grp, ClassRoles role)
             bool hasFoundPriority = false;
             bool hasBeenLongerInQueue = false;
 
-            // Iterate over QueuedPlayersMap to find if players in queue have higher priority or they have been longer in Queue.
-            for (QueuedPlayersMap::iterator qPlayer_loop = m_QueuedPlayers.begin(); qPlayer_loop != m_QueuedPlayers.end(); ++qPlayer_loop)
+            // Iterate over the players competing for the same group to find if they have higher priority or they have been longer in Queue.
+            QueueBucket const* bucket = GetBucket(qPlayer->second.team, qPlayer->second.areaId);
+            for (size_t i = 0; bucket && i < bucket->size(); ++i)
             {
+                QueuedPlayersMap::const_iterator qPlayer_loop = m_QueuedPlayers.find((*bucket)[i]);
                 if (qPlayer->first == qPlayer_loop->first)
                 {
                     continue;
@@ -484,7 +501,7 @@ bool LFGQueue::FindRoleToGroup(Player* plr, Group* grp, ClassRoles role)
                 Player* m_loopMember = sObjectMgr.GetPlayer(qPlayer_loop->first);
 
                 // If there is anyone in group for class with higher priority then ignore current member.
-                if (getPriority((Classes)plr->getClass(), role) < getPriority((Classes)m_loopMember->getClass(), role))
+                if (m_loopMember && getPriority((Classes)plr->getClass(), role) < getPriority((Classes)m_loopMember->getClass(), role))
                 {
                     hasFoundPriority = true;
                 }
@@ -577,6 +594,7 @@ void LFGQueue::RemovePlayerFromQueue(ObjectGuid plrGuid, PlayerLeaveMethod leave
             plr->GetSession()->SendPacket(&data);
         }
 
+        RemoveFromBucket(qPlayer->first, qPlayer->second);
         m_QueuedPlayers.erase(qPlayer);
     }
 }
@@ -618,6 +636,54 @@ void LFGQueue::RemoveGroupFromQueue(uint32 groupId, GroupLeaveMethod leaveMethod
     }
 }
 
+LFGQueue::QueueBucket const* LFGQueue::GetBucket(uint32 team, uint32 areaId) const
+{
+    QueueBucketMap::const_iterator itr = m_PlayerBuckets.find(QueueBucketKey(team, areaId));
+    return itr != m_PlayerBuckets.end() ? &itr->second : NULL;
+}
+
+void LFGQueue::AddToBucket(ObjectGuid plrGuid, LFGPlayerQueueInfo const& info)
+{
+    m_PlayerBuckets[QueueBucketKey(info.team, info.areaId)].push_back(plrGuid);
+}
+
+void LFGQueue::RemoveFromBucket(ObjectGuid plrGuid, LFGPlayerQueueInfo const& info)
+{
+    QueueBucketMap::iterator itr = m_PlayerBuckets.find(QueueBucketKey(info.team, info.areaId));
+    if (itr == m_PlayerBuckets.end())
+    {
+        return;
+    }
+
+    QueueBucket::iterator pos = std::find(itr->second.begin(), itr->second.end(), plrGuid);
+    if (pos != itr->second.end())
+    {
+        itr->second.erase(pos);
+    }
+
+    if (itr->second.empty())
+    {
+        m_PlayerBuckets.erase(itr);
+    }
+}
+
+uint32 LFGQueue::findInArea(uint32 areaId) const
+{
+    uint32 m_QueueSize = 0;
+
+    if (QueueBucket const* bucket = GetBucket(ALLIANCE, areaId))
+    {
+        m_QueueSize += bucket->size();
+    }
+
+    if (QueueBucket const* bucket = GetBucket(HORDE, areaId))
+    {
+        m_QueueSize += bucket->size();
+    }
+
+    return m_QueueSize;
+}
+
 void LFGQueue::BuildSetQueuePacket(WorldPacket &data, uint32 areaId, uint8 status)
 {
     data.Initialize(SMSG_MEETINGSTONE_SETQUEUE, 5);
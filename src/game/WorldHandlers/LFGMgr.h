@@ -24,6 +24,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include "Policies/Singleton.h"
 #include "Common.h"
@@ -119,20 +120,17 @@ class LFGQueue
         typedef std::map<uint32, LFGGroupQueueInfo> QueuedGroupsMap;
         QueuedGroupsMap m_QueuedGroups;
 
-        uint32 findInArea(uint32 areaId)
-        {
-            uint32 m_QueueSize = 0;
+        // queued players by team and area in queue order, matching only looks at the compatible ones
+        typedef std::pair<uint32, uint32> QueueBucketKey;   // team, areaId
+        typedef std::vector<ObjectGuid> QueueBucket;
+        typedef std::map<QueueBucketKey, QueueBucket> QueueBucketMap;
+        QueueBucketMap m_PlayerBuckets;
 
-            for(QueuedPlayersMap::iterator itr = m_QueuedPlayers.begin(); itr != m_QueuedPlayers.end(); ++itr)
-            {
-                if(itr->second.areaId == areaId)
-                {
-                    ++m_QueueSize;
-                }
-            }
+        QueueBucket const* GetBucket(uint32 team, uint32 areaId) const;
+        void AddToBucket(ObjectGuid plrGuid, LFGPlayerQueueInfo const& info);
+        void RemoveFromBucket(ObjectGuid plrGuid, LFGPlayerQueueInfo const& info);
 
-            return m_QueueSize;
-        }
+        uint32 findInArea(uint32 areaId) const;
 };
 
 #define sLFGMgr MaNGOS::Singleton<LFGQueue>::Instance()
@@ -0,0 +1,116 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "LineOfSightCache.h"
+#include "Timer.h"
+
+#include <cmath>
+
+// slot layout: hash tag in the upper 40 bits, time stamp in 16 ms units below it, the result in bit 0
+#define LOS_CACHE_TAG_SHIFT     24
+#define LOS_CACHE_STAMP_MASK    0x7FFFFF
+#define LOS_CACHE_STAMP_UNIT    4                           // log2 of the stamp unit in ms
+
+uint32 LineOfSightCache::s_maxAge = 0;
+
+static inline int32 QuantizeCoord(float value)
+{
+    return int32(floor(value * LOS_CACHE_QUANTIZATION));
+}
+
+static inline uint64 MixHash(uint64 hash, uint64 value)
+{
+    hash ^= value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+static inline uint32 CurrentStamp()
+{
+    return (getTickMSTime() >> LOS_CACHE_STAMP_UNIT) & LOS_CACHE_STAMP_MASK;
+}
+
+LineOfSightCache::LineOfSightCache() : m_slots(LOS_CACHE_SLOTS), m_generation(0), m_hits(0), m_misses(0)
+{
+    for (size_t i = 0; i < m_slots.size(); ++i)
+    {
+        m_slots[i] = 0;
+    }
+}
+
+uint64 LineOfSightCache::Hash(float x1, float y1, float z1, float x2, float y2, float z2) const
+{
+    int32 a[3] = { QuantizeCoord(x1), QuantizeCoord(y1), QuantizeCoord(z1) };
+    int32 b[3] = { QuantizeCoord(x2), QuantizeCoord(y2), QuantizeCoord(z2) };
+
+    // line of sight is symmetric, the smaller endpoint goes first so A->B and B->A share a slot
+    bool swapped = a[0] > b[0] || (a[0] == b[0] && (a[1] > b[1] || (a[1] == b[1] && a[2] > b[2])));
+    int32 const* first = swapped ? b : a;
+    int32 const* second = swapped ? a : b;
+
+    uint64 hash = m_generation.load(std::memory_order_relaxed);
+    for (int i = 0; i < 3; ++i)
+    {
+        hash = MixHash(hash, uint32(first[i]));
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        hash = MixHash(hash, uint32(second[i]));
+    }
+
+    // finalizer, spreads the mixed bits over both the slot index and the tag
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+bool LineOfSightCache::Lookup(float x1, float y1, float z1, float x2, float y2, float z2, bool& result)
+{
+    uint64 hash = Hash(x1, y1, z1, x2, y2, z2);
+    uint64 entry = m_slots[hash & (LOS_CACHE_SLOTS - 1)].load(std::memory_order_relaxed);
+
+    if (entry && (entry >> LOS_CACHE_TAG_SHIFT) == (hash >> LOS_CACHE_TAG_SHIFT))
+    {
+        uint32 stamp = uint32(entry >> 1) & LOS_CACHE_STAMP_MASK;
+        uint32 age = ((CurrentStamp() - stamp) & LOS_CACHE_STAMP_MASK) << LOS_CACHE_STAMP_UNIT;
+
+        if (age <= s_maxAge)
+        {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            result = (entry & 1) != 0;
+            return true;
+        }
+    }
+
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void LineOfSightCache::Store(float x1, float y1, float z1, float x2, float y2, float z2, bool result)
+{
+    uint64 hash = Hash(x1, y1, z1, x2, y2, z2);
+    uint64 entry = ((hash >> LOS_CACHE_TAG_SHIFT) << LOS_CACHE_TAG_SHIFT) | (uint64(CurrentStamp()) << 1) | (result ? 1 : 0);
+
+    m_slots[hash & (LOS_CACHE_SLOTS - 1)].store(entry, std::memory_order_relaxed);
+}
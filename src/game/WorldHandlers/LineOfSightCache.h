@@ -0,0 +1,75 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_LINEOFSIGHTCACHE_H
+#define MANGOS_LINEOFSIGHTCACHE_H
+
+#include "Platform/Define.h"
+
+#include <atomic>
+#include <vector>
+
+#define LOS_CACHE_SLOTS         4096                        // power of two
+#define LOS_CACHE_QUANTIZATION  4.0f                        // cells per yard the endpoints are rounded to
+
+/**
+ * Short lived cache of line of sight results of one map.
+ *
+ * Endpoints are rounded to a 0.25 yard grid and the pair is hashed into a
+ * direct mapped table of single 64 bit words (hash tag, time stamp, result),
+ * so lookups and stores from the region update threads need no lock. A cached
+ * result is used for at most the configured time, Invalidate() drops all
+ * entries at once when a dynamic object (door etc.) changes its collision.
+ */
+class LineOfSightCache
+{
+    public:
+        LineOfSightCache();
+
+        // false on a miss, otherwise result holds the cached line of sight
+        bool Lookup(float x1, float y1, float z1, float x2, float y2, float z2, bool& result);
+        void Store(float x1, float y1, float z1, float x2, float y2, float z2, bool result);
+
+        void Invalidate() { ++m_generation; }
+
+        uint32 GetHits() const { return m_hits; }
+        uint32 GetMisses() const { return m_misses; }
+        void ResetCounters() { m_hits = 0; m_misses = 0; }
+
+        // 0 disables the cache of all maps
+        static void SetMaxAge(uint32 ms) { s_maxAge = ms; }
+        static bool IsEnabled() { return s_maxAge != 0; }
+
+    private:
+        uint64 Hash(float x1, float y1, float z1, float x2, float y2, float z2) const;
+
+        std::vector<std::atomic<uint64> > m_slots;
+        std::atomic<uint32> m_generation;
+        std::atomic<uint32> m_hits;
+        std::atomic<uint32> m_misses;
+
+        static uint32 s_maxAge;
+};
+
+#endif
@@ -0,0 +1,168 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "LookupNameIndex.h"
+#include "ObjectMgr.h"
+#include "SQLStorages.h"
+#include "DBCStores.h"
+#include "Util.h"
+
+#include <ace/Guard_T.h>
+
+INSTANTIATE_SINGLETON_1(LookupNameIndex);
+
+static std::wstring LowerName(std::string const& name)
+{
+    std::wstring wname;
+    if (name.empty() || !Utf8toWStr(name, wname))
+    {
+        return std::wstring();
+    }
+
+    wstrToLower(wname);
+    return wname;
+}
+
+LookupNameListPtr LookupNameIndex::Get(LookupNameType type, int locale)
+{
+    if (type == LOOKUP_NAME_SPELL || type == LOOKUP_NAME_AREA)
+    {
+        locale = -1;
+    }
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, LookupNameListPtr(Build(type, locale)));
+
+    // built under the lock, concurrent first lookups of a type wait for one build instead of each doing their own
+    LookupNameListPtr& list = m_lists[type][locale];
+    if (!list)
+    {
+        list.reset(Build(type, locale));
+    }
+
+    return list;
+}
+
+void LookupNameIndex::Clear(LookupNameType type)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    m_lists[type].clear();
+}
+
+LookupNameList* LookupNameIndex::Build(LookupNameType type, int locale)
+{
+    LookupNameList* list = new LookupNameList;
+    LookupNameEntry entry;
+
+    switch (type)
+    {
+        case LOOKUP_NAME_ITEM:
+        {
+            for (SQLStorageBase::SQLSIterator<ItemPrototype> itr = sItemStorage.getDataBegin<ItemPrototype>(); itr < sItemStorage.getDataEnd<ItemPrototype>(); ++itr)
+            {
+                std::string name;
+                sObjectMgr.GetItemLocaleStrings(itr->ItemId, locale, &name);
+
+                entry.Id = itr->ItemId;
+                entry.Names.assign(1, LowerName(name));
+                entry.Names.push_back(LowerName(itr->Name1));
+                list->push_back(entry);
+            }
+            break;
+        }
+        case LOOKUP_NAME_CREATURE:
+        {
+            for (SQLStorageBase::SQLSIterator<CreatureInfo> itr = sCreatureStorage.getDataBegin<CreatureInfo>(); itr < sCreatureStorage.getDataEnd<CreatureInfo>(); ++itr)
+            {
+                char const* name = "";
+                sObjectMgr.GetCreatureLocaleStrings(itr->Entry, locale, &name);
+
+                entry.Id = itr->Entry;
+                entry.Names.assign(1, LowerName(name));
+                entry.Names.push_back(LowerName(itr->Name));
+                list->push_back(entry);
+            }
+            break;
+        }
+        case LOOKUP_NAME_QUEST:
+        {
+            ObjectMgr::QuestMap const& qTemplates = sObjectMgr.GetQuestTemplates();
+            for (ObjectMgr::QuestMap::const_iterator itr = qTemplates.begin(); itr != qTemplates.end(); ++itr)
+            {
+                std::string title;
+                sObjectMgr.GetQuestLocaleStrings(itr->first, locale, &title);
+
+                entry.Id = itr->first;
+                entry.Names.assign(1, LowerName(title));
+                entry.Names.push_back(LowerName(itr->second->GetTitle()));
+                list->push_back(entry);
+            }
+            break;
+        }
+        case LOOKUP_NAME_SPELL:
+        {
+            for (uint32 id = 0; id < sSpellStore.GetNumRows(); ++id)
+            {
+                SpellEntry const* spellInfo = sSpellStore.LookupEntry(id);
+                if (!spellInfo)
+                {
+                    continue;
+                }
+
+                entry.Id = id;
+                entry.Names.resize(MAX_LOCALE);
+                for (int loc = 0; loc < MAX_LOCALE; ++loc)
+                {
+                    entry.Names[loc] = LowerName(spellInfo->SpellName[loc]);
+                }
+                list->push_back(entry);
+            }
+            break;
+        }
+        case LOOKUP_NAME_AREA:
+        {
+            for (uint32 id = 0; id < sAreaStore.GetNumRows(); ++id)
+            {
+                AreaTableEntry const* areaEntry = sAreaStore.LookupEntry(id);
+                if (!areaEntry)
+                {
+                    continue;
+                }
+
+                entry.Id = id;
+                entry.Names.resize(MAX_LOCALE);
+                for (int loc = 0; loc < MAX_LOCALE; ++loc)
+                {
+                    entry.Names[loc] = LowerName(areaEntry->area_name[loc]);
+                }
+                list->push_back(entry);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    return list;
+}
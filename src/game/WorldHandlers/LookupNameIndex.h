@@ -0,0 +1,117 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_LOOKUP_NAME_INDEX
+#define MANGOS_H_LOOKUP_NAME_INDEX
+
+#include <ace/Thread_Mutex.h>
+
+#include <memory>
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+enum LookupNameType
+{
+    LOOKUP_NAME_ITEM,                                       ///< `item_template` and `locales_item`
+    LOOKUP_NAME_CREATURE,                                   ///< `creature_template` and `locales_creature`
+    LOOKUP_NAME_QUEST,                                      ///< `quest_template` and `locales_quest`
+    LOOKUP_NAME_SPELL,                                      ///< Spell.dbc, all client locales
+    LOOKUP_NAME_AREA,                                       ///< AreaTable.dbc, all client locales
+    MAX_LOOKUP_NAME_TYPES
+};
+
+/**
+ * @brief One searchable entry, its names converted to lower case wide strings
+ *
+ * For the database types Names holds the name of the requested locale index
+ * (empty when there is none) followed by the default name. For the DBC types
+ * it holds the name of every client locale, indexed by LocaleConstant.
+ */
+struct LookupNameEntry
+{
+    uint32 Id;
+    std::vector<std::wstring> Names;
+
+    // index of the first non empty name containing the lower case search text, -1 for no match
+    int Match(std::wstring const& search, int first = 0) const
+    {
+        for (size_t i = first; i < Names.size(); ++i)
+        {
+            if (!Names[i].empty() && Names[i].find(search) != std::wstring::npos)
+            {
+                return int(i);
+            }
+        }
+        return -1;
+    }
+};
+
+typedef std::vector<LookupNameEntry> LookupNameList;
+typedef std::shared_ptr<LookupNameList const> LookupNameListPtr;
+
+/**
+ * @brief Lower cased names of the stores searched by the .lookup commands
+ *
+ * Converting and lower casing every name of a store on each lookup made the
+ * commands take a noticeable time on large stores. The lists are built on the
+ * first lookup of a type (and locale index), after that a lookup is a plain
+ * substring scan. Lookups may run on the CLI command threads, so the lists are
+ * handed out as shared pointers: a reload drops them with Clear() while a scan
+ * still holding the old list finishes on it.
+ */
+class LookupNameIndex
+{
+    public:
+        LookupNameIndex() {}
+
+        /**
+         * @brief Returns the name list of a type, building it if needed
+         *
+         * @param type
+         * @param locale locale index of the session, -1 for the default locale.
+         *               Ignored for the DBC types which always hold all locales.
+         * @return LookupNameListPtr
+         */
+        LookupNameListPtr Get(LookupNameType type, int locale);
+
+        /**
+         * @brief Drops the lists of a type, after a reload of its tables
+         *
+         * @param type
+         */
+        void Clear(LookupNameType type);
+
+    private:
+        typedef std::map<int, LookupNameListPtr> LocaleListMap;
+
+        static LookupNameList* Build(LookupNameType type, int locale);
+
+        ACE_Thread_Mutex m_lock;
+        LocaleListMap m_lists[MAX_LOOKUP_NAME_TYPES];
+};
+
+#define sLookupNameIndex MaNGOS::Singleton<LookupNameIndex>::Instance()
+
+#endif
@@ -47,6 +47,7 @@
 #include "BattleGround/BattleGroundMgr.h"
 #include "Item.h"
 #include "AuctionHouseMgr.h"
+#include "CharacterLoginCache.h"
 
 /**
  * Creates a new MailSender object.
@@ -278,6 +279,9 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
         return;
     }
 
+    // a prefetched login of the receiver would miss the new mail
+    sCharacterLoginCache.Invalidate(receiver.GetPlayerGuid().GetCounter());
+
     bool has_items = !m_items.empty();
 
     // generate mail template items for online player, for offline player items will generated at open
@@ -329,7 +333,12 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
     std::string safe_body = GetBody();
     CharacterDatabase.escape_string(safe_body);
 
-    CharacterDatabase.BeginTransaction();
+    // callers sending many mails (mass mailer) may already batch them in one transaction
+    bool ownTransaction = !CharacterDatabase.IsInTransaction();
+    if (ownTransaction)
+    {
+        CharacterDatabase.BeginTransaction();
+    }
     CharacterDatabase.PExecute("INSERT INTO `mail` (`id`,`messageType`,`stationery`,`mailTemplateId`,`sender`,`receiver`,`subject`,`body`,`has_items`,`expire_time`,`deliver_time`,`money`,`cod`,`checked`) "
                                "VALUES ('%u', '%u', '%u', '%u', '%u', '%u', '%s', '%s', '%u', '" UI64FMTD "','" UI64FMTD "', '%u', '%u', '%u')",
                                mailId, sender.GetMailMessageType(), sender.GetStationery(), GetMailTemplateId(), sender.GetSenderId(), receiver.GetPlayerGuid().GetCounter(), safe_subject.c_str(), safe_body.c_str(), (has_items ? 1 : 0), (uint64)expire_time, (uint64)deliver_time, m_money, m_COD, checked);
@@ -340,7 +349,10 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
         CharacterDatabase.PExecute("INSERT INTO `mail_items` (`mail_id`,`item_guid`,`item_template`,`receiver`) VALUES ('%u', '%u', '%u','%u')",
                                    mailId, item->GetGUIDLow(), item->GetEntry(), receiver.GetPlayerGuid().GetCounter());
     }
-    CharacterDatabase.CommitTransaction();
+    if (ownTransaction)
+    {
+        CharacterDatabase.CommitTransaction();
+    }
 
     // For online receiver update in game mail status and data
     if (pReceiver)
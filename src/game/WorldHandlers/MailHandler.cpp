@@ -70,6 +70,9 @@ bool WorldSession::CheckMailBox(ObjectGuid guid)
         return false;
     }
 
+    // mailbox is in use, its items are needed from now on
+    GetPlayer()->LoadMailedItems();
+
     return true;
 }
 
@@ -40,10 +40,17 @@
 #include "MapPersistentStateMgr.h"
 #include "VMapFactory.h"
 #include "MoveMap.h"
+#include "WaypointMovementGenerator.h"
+#include "PathFinder.h"
 #include "Chat.h"
 #include "Weather.h"
 #include "Transports.h"
 #include "ObjectGridLoader.h"
+#include "MapRegionUpdate.h"
+#include "UpdatePacketBuild.h"
+#include "Metrics.h"
+#include "Utilities/FrameArena.h"
+#include "TickRecorder.h"
 
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
@@ -57,13 +64,9 @@ Map::~Map()
 
     UnloadAll(true);
 
-    if (!m_scriptSchedule.empty())
-    {
-        sScriptMgr.DecreaseScheduledScriptCount(m_scriptSchedule.size());
-    }
-
     if (m_persistentState)
     {
+        m_persistentState->SaveRespawnTimesToDB();
         m_persistentState->SetUsedByMapState(NULL);          // field pointer can be deleted after this
     }
 
@@ -74,6 +77,11 @@ Map::~Map()
     }
 #endif /* ENABLE_ELUNA */
 
+    if (i_data)
+    {
+        i_data->FlushSaveToDB();
+    }
+
     delete i_data;
     i_data = NULL;
 
@@ -83,9 +91,6 @@ Map::~Map()
         delete *t;
     }
 
-    // unload instance specific navigation data
-    MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
-
     // release reference count
     if (m_TerrainData->Release())
     {
@@ -94,6 +99,14 @@ Map::~Map()
 
     delete m_weatherSystem;
     m_weatherSystem = NULL;
+
+    delete m_pathCache;
+    m_pathCache = NULL;
+
+    for (std::vector<CellMarks*>::iterator itr = m_regionCellMarks.begin(); itr != m_regionCellMarks.end(); ++itr)
+    {
+        delete *itr;
+    }
 }
 
 void Map::LoadMapAndVMap(int gx, int gy)
@@ -109,13 +122,130 @@ void Map::LoadMapAndVMap(int gx, int gy)
     }
 }
 
+void Map::RequestGridsAround(const Cell& cell)
+{
+    if (!sTerrainMgr.IsLoaderActive())
+    {
+        return;
+    }
+
+    for (int dx = -1; dx <= 1; ++dx)
+    {
+        for (int dy = -1; dy <= 1; ++dy)
+        {
+            int x = int(cell.GridX()) + dx;
+            int y = int(cell.GridY()) + dy;
+            if (x < 0 || y < 0 || x >= MAX_NUMBER_OF_GRIDS || y >= MAX_NUMBER_OF_GRIDS)
+            {
+                continue;
+            }
+
+            // z coord
+            int gx = (MAX_NUMBER_OF_GRIDS - 1) - x;
+            int gy = (MAX_NUMBER_OF_GRIDS - 1) - y;
+
+            if (!m_bLoadedGrids[gx][gy])
+            {
+                m_TerrainData->RequestLoad(gx, gy);
+            }
+        }
+    }
+}
+
+void Map::RequestGridsAhead(Player* player)
+{
+    float distance = float(sWorld.getConfig(CONFIG_UINT32_GRID_PREFETCH_DISTANCE));
+    if (!sTerrainMgr.IsLoaderActive() || distance <= 0.0f)
+    {
+        return;
+    }
+
+    if (player->IsTaxiFlying())
+    {
+        if (player->GetMotionMaster()->GetCurrentMovementGeneratorType() != FLIGHT_MOTION_TYPE)
+        {
+            return;
+        }
+
+        FlightPathMovementGenerator const* flight = static_cast<FlightPathMovementGenerator const*>(player->GetMotionMaster()->GetCurrent());
+        TaxiPathNodeList const& path = flight->GetPath();
+
+        // walk the remaining nodes on this map until the look ahead distance is used up
+        float lastX = player->GetPositionX();
+        float lastY = player->GetPositionY();
+        for (uint32 i = flight->GetCurrentNode(); i < path.size() && distance > 0.0f; ++i)
+        {
+            TaxiPathNodeEntry const& node = path[i];
+            if (node.mapid != GetId())
+            {
+                break;
+            }
+
+            distance -= sqrt((node.x - lastX) * (node.x - lastX) + (node.y - lastY) * (node.y - lastY));
+            lastX = node.x;
+            lastY = node.y;
+            RequestGridAt(node.x, node.y);
+        }
+        return;
+    }
+
+    if (!player->m_movementInfo.HasMovementFlag(MOVEFLAG_FORWARD))
+    {
+        return;
+    }
+
+    // half grid steps along the facing, so no grid on the line is skipped
+    float step = SIZE_OF_GRIDS / 2;
+    for (float d = step; d <= distance; d += step)
+    {
+        RequestGridAt(player->GetPositionX() + d * cos(player->GetOrientation()), player->GetPositionY() + d * sin(player->GetOrientation()));
+    }
+}
+
+void Map::RequestGridAt(float x, float y)
+{
+    if (!MaNGOS::IsValidMapCoord(x, y))
+    {
+        return;
+    }
+
+    GridPair p = MaNGOS::ComputeGridPair(x, y);
+
+    int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+
+    if (!m_bLoadedGrids[gx][gy])
+    {
+        m_TerrainData->RequestLoad(gx, gy);
+    }
+}
+
+bool Map::IsGridLoadPending(float x, float y) const
+{
+    GridPair p = MaNGOS::ComputeGridPair(x, y);
+
+    int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+
+    return !m_bLoadedGrids[gx][gy] && m_TerrainData->IsLoadPending(gx, gy);
+}
+
+static MetricGauge& GetLoadedGridsMetric()
+{
+    static MetricGauge& gauge = sMetrics.GetGauge("mangos_grids_loaded", "Grids loaded over all maps");
+    return gauge;
+}
+
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
     : i_mapEntry(sMapStore.LookupEntry(id)),
-      i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
+      i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0), m_respawnSaveTimer(0), m_loadedGridCount(0),
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(NULL),
       m_activeNonPlayersIter(m_activeNonPlayers.end()),
       i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-      i_data(NULL)
+      m_regionUpdateActive(false), i_data(NULL), m_lastUpdateDuration(0),
+      m_hibernating(false), m_wakeUpRequested(false), m_idleTime(0), m_hibernatedDiff(0),
+      m_skippedDiff(0), m_tickedTime(0),
+      m_tickMetric(&sMetrics.GetHistogram("mangos_map_tick_seconds", "Duration of one map update", Metrics::GetTickBuckets(), "map=\"" + std::to_string(id) + "\""))
 {
     m_CreatureGuids.Set(sObjectMgr.GetFirstTemporaryCreatureLowGuid());
     m_GameObjectGuids.Set(sObjectMgr.GetFirstTemporaryGameObjectLowGuid());
@@ -140,6 +270,7 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
     m_persistentState->SetUsedByMapState(this);
 
     m_weatherSystem = new WeatherSystem(this);
+    m_pathCache = new PathCache(this);
     i_transports.clear();
 #ifdef ENABLE_ELUNA
     sEluna->OnCreate(this);
@@ -252,6 +383,8 @@ Map::EnsureGridCreated(const GridPair& p)
     {
         setNGrid(new NGridType(p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord, p.x_coord, p.y_coord, i_gridExpiry, sWorld.getConfig(CONFIG_BOOL_GRID_UNLOAD)),
                  p.x_coord, p.y_coord);
+        GetLoadedGridsMetric().Add(1);
+        ++m_loadedGridCount;
 
         // build a linkage between this map and NGridType
         buildNGridLinkage(getNGrid(p.x_coord, p.y_coord));
@@ -303,6 +436,14 @@ Map::EnsureGridLoadedAtEnter(const Cell& cell, Player* player)
 
 bool Map::EnsureGridLoaded(const Cell& cell)
 {
+    if (getNGrid(cell.GridX(), cell.GridY()) && isGridObjectDataLoaded(cell.GridX(), cell.GridY()))
+    {
+        return false;
+    }
+
+    // grid creation links into the map wide grid list
+    MapRegionGuard guard(this);
+
     EnsureGridCreated(GridPair(cell.GridX(), cell.GridY()));
     NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -346,7 +487,10 @@ bool Map::Add(Player* player)
     CellPair p = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
     Cell cell(p);
     EnsureGridLoadedAtEnter(cell, player);
+    RequestGridsAround(cell);
     player->AddToWorld();
+    SetPlayerZone(player, player->GetZoneId());
+    sTickRecorder.PlayerEntered(this, player);
 
     SendInitSelf(player);
     SendInitTransports(player);
@@ -506,6 +650,35 @@ void Map::MessageDistBroadcast(WorldObject const* obj, WorldPacket* msg, float d
     cell.Visit(p, message, *this, *obj, dist);
 }
 
+void Map::CombatLogBroadcast(Unit const* source, WorldPacket* const* msgs, size_t count, Unit const* target)
+{
+    CellPair p = MaNGOS::ComputeCellPair(source->GetPositionX(), source->GetPositionY());
+
+    if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+    {
+        sLog.outError("Map::CombatLogBroadcast: Unit (GUID: %u TypeId: %u) have invalid coordinates X:%f Y:%f grid cell [%u:%u]", source->GetGUIDLow(), source->GetTypeId(), source->GetPositionX(), source->GetPositionY(), p.x_coord, p.y_coord);
+        return;
+    }
+
+    Cell cell(p);
+    cell.SetNoCreate();
+
+    if (!loaded(GridPair(cell.data.Part.grid_x, cell.data.Part.grid_y)))
+    {
+        return;
+    }
+
+    float dist = sWorld.getConfig(CONFIG_FLOAT_COMBAT_LOG_DISTANCE);
+    if (dist <= 0.0f || dist > GetVisibilityDistance())
+    {
+        dist = 0.0f;
+    }
+
+    MaNGOS::CombatLogDeliverer post_man(*source, target, msgs, count, dist);
+    TypeContainerVisitor<MaNGOS::CombatLogDeliverer, WorldTypeMapContainer > message(post_man);
+    cell.Visit(p, message, *this, *source, GetVisibilityDistance());
+}
+
 bool Map::loaded(const GridPair& p) const
 {
     return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
@@ -514,6 +687,14 @@ bool Map::loaded(const GridPair& p) const
 void Map::VisitNearbyCellsOf(WorldObject* obj,
                              TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor,
                              TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor)
+{
+    VisitNearbyCellsOf(obj, gridVisitor, worldVisitor, marked_cells);
+}
+
+void Map::VisitNearbyCellsOf(WorldObject* obj,
+                             TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor,
+                             TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor,
+                             CellMarks& marks)
 {
     // 如果世界对象坐标无效，忽略处理。
     if (!obj->IsPositionValid())
@@ -530,10 +711,10 @@ void Map::VisitNearbyCellsOf(WorldObject* obj,
             // 获取当前cell标识
             uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
             // 如果未更新，进行更新
-            if (!isCellMarked(cell_id))
+            if (!marks.test(cell_id))
             {
                 // 标记cell被更新
-                markCell(cell_id);
+                marks.set(cell_id);
                 // 获取当前cell坐标
                 CellPair pair(x, y);
                 // 创建cell
@@ -548,6 +729,14 @@ void Map::VisitNearbyCellsOf(WorldObject* obj,
 
 void Map::Update(const uint32& t_diff)
 {
+    MapUpdatePhaseTimer phaseTimer(m_updateTime, m_tickMetric);
+    FrameArena::Frame frame;                                // temporary containers of this update, reclaimed at its end
+    RefreshTickMSTime();                                    // tick time of this map thread for the update
+    sTickRecorder.BeginTick(this, t_diff);                  // before the first random draw of the update
+
+    // grid terrain read ahead by the loader threads becomes visible here, between two updates of the map
+    m_TerrainData->PublishLoadedGrids();
+
     m_dyn_tree.update(t_diff);
 
     /// update worldsessions for existing players
@@ -563,6 +752,8 @@ void Map::Update(const uint32& t_diff)
         }
     }
 
+    phaseTimer.Record(MAP_UPDATE_PHASE_SESSIONS);
+
     /// update players at tick
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -581,8 +772,202 @@ void Map::Update(const uint32& t_diff)
         helper.Update(t_diff);
     }
 
+    phaseTimer.Record(MAP_UPDATE_PHASE_PLAYERS);
+
     /// update active cells around players and active objects
+    if (!UpdateActiveCellsByRegions(t_diff))
+    {
+        UpdateActiveCells(t_diff);
+    }
+
+    /// visibility passes requested by the moves and updates above
+    UpdatePendingCameras();
+
+    phaseTimer.Record(MAP_UPDATE_PHASE_OBJECTS);
+
+    // Send world objects and item update field changes
+    SendObjectUpdates();
+
+    // combat logs of this tick, after the updates of the objects they are about
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        if (WorldSession* session = itr->getSource()->GetSession())
+        {
+            session->FlushCombatLogs();
+        }
+    }
+
+    phaseTimer.Record(MAP_UPDATE_PHASE_SEND_UPDATES);
+
+    // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
+    // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
+    if (!IsBattleGround())
+    {
+        for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
+        {
+            NGridType* grid = i->getSource();
+            GridInfo* info = i->getSource()->getGridInfoRef();
+            ++i;                                            // The update might delete the map and we need the next map before the iterator gets invalid
+            MANGOS_ASSERT(grid->GetGridState() >= 0 && grid->GetGridState() < MAX_GRID_STATE);
+            sMapMgr.UpdateGridState(grid->GetGridState(), *this, *grid, *info, grid->getX(), grid->getY(), t_diff);
+        }
+
+        UnloadGridsOverBudget();
+    }
+
+    phaseTimer.Record(MAP_UPDATE_PHASE_GRID_STATES);
+
+    ///- Apply spawn changes of started or ended game events
+    GameEventActionsProcess();
+
+    ///- Process necessary scripts
+    if (!m_scriptSchedule.empty())
+    {
+        ScriptsProcess();
+    }
+
+    phaseTimer.Record(MAP_UPDATE_PHASE_SCRIPTS);
+
+#ifdef ENABLE_ELUNA
+    sEluna->OnUpdate(this, t_diff);
+#endif /* ENABLE_ELUNA */
+
+    if (i_data)
+    {
+        i_data->Update(t_diff);
+
+        // all the saves requested during this update are written at once
+        i_data->FlushSaveToDB();
+    }
+
+    m_respawnSaveTimer += t_diff;
+    if (m_respawnSaveTimer >= sWorld.getConfig(CONFIG_UINT32_SAVE_RESPAWN_TIME_INTERVAL))
+    {
+        m_persistentState->SaveRespawnTimesToDB();
+        m_respawnSaveTimer = 0;
+    }
+
+    // 更新天气系统
+    m_weatherSystem->UpdateWeathers(t_diff);
+
+    sTickRecorder.EndTick(this);
+}
+
+bool Map::UpdateHibernation(uint32& diff)
+{
+    uint32 delay = sWorld.getConfig(CONFIG_UINT32_INSTANCE_HIBERNATION_DELAY);
+
+    // nobody inside, no wake up request and no db script due
+    bool idle = delay && CanHibernate() && !HavePlayers() && !m_wakeUpRequested &&
+                !m_scriptSchedule.HasDueActions(sWorld.GetGameTime()) && m_gameEventActions.empty();
+
+    m_wakeUpRequested = false;
+
+    if (m_hibernating)
+    {
+        uint32 maxDiff = sWorld.getConfig(CONFIG_UINT32_INSTANCE_HIBERNATION_MAX_DIFF);
+        m_hibernatedDiff = std::min(m_hibernatedDiff + diff, maxDiff);
+
+        if (idle)
+        {
+            return false;
+        }
+
+        DEBUG_LOG("MAP: Instance %u of map '%s' wakes up after hibernation", GetInstanceId(), GetMapName());
+
+        diff = std::max(diff, m_hibernatedDiff);
+        m_hibernating = false;
+        m_hibernatedDiff = 0;
+        m_idleTime = 0;
+        return true;
+    }
+
+    if (!idle)
+    {
+        m_idleTime = 0;
+        return true;
+    }
+
+    m_idleTime += diff;
+    if (m_idleTime >= delay)
+    {
+        DEBUG_LOG("MAP: Instance %u of map '%s' is hibernating", GetInstanceId(), GetMapName());
+        m_hibernating = true;
+    }
+
+    return true;
+}
+
+bool Map::HasActivity() const
+{
+    if (!m_gameEventActions.empty() || m_scriptSchedule.HasDueActions(sWorld.GetGameTime()))
+    {
+        return true;
+    }
+
+    for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player const* player = itr->getSource();
+        if (player->IsInCombat() || player->isMoving() || player->IsTaxiFlying())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Map::UpdateTickRate(uint32& diff)
+{
+    uint32 maxInterval = sWorld.getConfig(CONFIG_UINT32_MAP_UPDATE_ADAPTIVE_MAX_INTERVAL);
+
+    m_skippedDiff += diff;
+
+    // activity is checked at every manager tick, so a quiet map catches up as soon as something happens
+    if (maxInterval && m_skippedDiff < maxInterval && !HasActivity())
+    {
+        return false;
+    }
+
+    diff = m_skippedDiff;
+    m_skippedDiff = 0;
+    m_tickedTime += diff;
+    return true;
+}
+
+uint32 Map::GetAverageTickInterval() const
+{
+    uint32 ticks = m_updateTime.GetPhase(MAP_UPDATE_PHASE_TOTAL).GetCount();
+    return ticks ? uint32(m_tickedTime / ticks) : 0;
+}
+
+void Map::UpdateActiveCells(const uint32& t_diff)
+{
     resetMarkedCells();
+    m_activeCells.clear();
+
+    // collect the cells around all players and active objects first, players standing together share most of them
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* plr = itr->getSource();
+
+        // 玩家不存在或者玩家已经登出游戏，忽略
+        if (plr && plr->IsInWorld())
+        {
+            CollectNearbyCells(plr, marked_cells, m_activeCells);
+        }
+    }
+
+    for (ActiveNonPlayers::const_iterator itr = m_activeNonPlayers.begin(); itr != m_activeNonPlayers.end(); ++itr)
+    {
+        if ((*itr) && (*itr)->IsInWorld())
+        {
+            CollectNearbyCells(*itr, marked_cells, m_activeCells);
+        }
+    }
+
+    // then one pass over the occupied cells, in cell id order for better locality
+    std::sort(m_activeCells.begin(), m_activeCells.end());
 
     MaNGOS::ObjectUpdater updater(t_diff);
     // for creature
@@ -590,111 +975,338 @@ void Map::Update(const uint32& t_diff)
     // for pets
     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> world_object_update(updater);
 
+    for (std::vector<uint32>::const_iterator itr = m_activeCells.begin(); itr != m_activeCells.end(); ++itr)
+    {
+        CellPair pair(*itr % TOTAL_NUMBER_OF_CELLS_PER_MAP, *itr / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        Cell cell(pair);
+        cell.SetNoCreate();
+        Visit(cell, grid_object_update);
+        Visit(cell, world_object_update);
+    }
+
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
         Player* plr = m_mapRefIter->getSource();
+        if (plr && plr->IsInWorld())
+        {
+            RemoveFarHostileReferences(plr, grid_object_update, world_object_update);
+        }
+    }
+}
 
-        // 玩家不存在或者玩家已经登出游戏，忽略
-        if (!plr || !plr->IsInWorld())
+void Map::CollectNearbyCells(WorldObject* obj, CellMarks& marks, std::vector<uint32>& cells)
+{
+    if (!obj->IsPositionValid())
+    {
+        return;
+    }
+
+    CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    {
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+        {
+            uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+            if (!marks.test(cell_id))
+            {
+                marks.set(cell_id);
+                cells.push_back(cell_id);
+            }
+        }
+    }
+}
+
+void Map::RemoveFarHostileReferences(Player* plr,
+                                     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor,
+                                     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor)
+{
+    // Collect and remove references to creatures too far away from player's m_HostileRefManager
+    // Combat state will change on next tick, if case
+    if (IsDungeon() || !plr->IsInCombat())
+    {
+        return;
+    }
+
+    std::vector<Unit*> _removeList;
+    HostileRefManager& href = plr->GetHostileRefManager();
+    HostileReference* ref = href.getFirst();
+
+    while (ref)
+    {
+        if (Unit* unit = ref->getSource()->getOwner())
+            if (unit->ToCreature() && unit->GetMapId() == plr->GetMapId() && !unit->IsWithinDistInMap(plr, GetVisibilityDistance(), false))
+            {
+                _removeList.push_back(unit);
+            }
+
+        ref = ref->next();
+    }
+
+    for (std::vector<Unit*>::iterator it = _removeList.begin(); it != _removeList.end(); ++it)
+    {
+        (*it)->RemoveAurasByCaster(plr->GetObjectGuid());
+        (*it)->_removeAttacker(plr);
+        (*it)->GetHostileRefManager().deleteReference(plr);
+
+        VisitNearbyCellsOf(*it, gridVisitor, worldVisitor);
+    }
+
+    // one walk over the player's references for all of them
+    href.deleteReferences(_removeList);
+}
+
+void Map::AddPendingCamera(Player* player)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_pendingCamerasLock);
+    m_pendingCameras.push_back(player->GetObjectGuid());
+}
+
+/**
+ * Runs the visibility passes requested by Camera::RequestVisibilityUpdate.
+ *
+ * A camera moved several times in one tick is updated once. Cameras whose viewpoints
+ * visit the same cells share a single grid walk; the visibility checks themselves stay
+ * per camera since stealth, GM and group rules differ between the owners. The objects
+ * gathered stay valid for all cameras of a group because removal from the map is
+ * deferred to RemoveAllObjectsInRemoveList.
+ */
+void Map::UpdatePendingCameras()
+{
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_pendingCamerasLock);
+        if (m_pendingCameras.empty())
+        {
+            return;
+        }
+
+        m_pendingCamerasSwap.swap(m_pendingCameras);
+    }
+
+    typedef std::pair<uint64, Camera*> KeyedCamera;
+    std::vector<KeyedCamera> cameras;
+    cameras.reserve(m_pendingCamerasSwap.size());
+
+    for (GuidVector::const_iterator itr = m_pendingCamerasSwap.begin(); itr != m_pendingCamerasSwap.end(); ++itr)
+    {
+        // the owner may have left the map, or got a full update on re-adding, since the request
+        Player* player = GetPlayer(*itr);
+        if (!player || !player->IsInWorld() || !player->GetCamera().IsVisibilityUpdatePending())
         {
             continue;
         }
 
-        // 更新玩家可视范围内信息（AOI处理）
-        VisitNearbyCellsOf(plr, grid_object_update, world_object_update);
+        cameras.push_back(KeyedCamera(player->GetCamera().GetVisibilityAreaKey(), &player->GetCamera()));
+    }
+
+    m_pendingCamerasSwap.clear();
+
+    std::sort(cameras.begin(), cameras.end());
 
-        // Collect and remove references to creatures too far away from player's m_HostileRefManager
-        // Combat state will change on next tick, if case
-        if (!IsDungeon() && plr->IsInCombat())
+    for (std::vector<KeyedCamera>::const_iterator itr = cameras.begin(); itr != cameras.end();)
+    {
+        std::vector<KeyedCamera>::const_iterator groupEnd = itr + 1;
+        while (groupEnd != cameras.end() && groupEnd->first == itr->first)
         {
-            std::vector<Creature*> _removeList;
-            HostileRefManager& href = plr->GetHostileRefManager();
-            HostileReference* ref = href.getFirst();
+            ++groupEnd;
+        }
 
-            while (ref)
+        if (groupEnd - itr == 1 || itr->first == ~uint64(0))
+        {
+            for (; itr != groupEnd; ++itr)
             {
-                if (Unit* unit = ref->getSource()->getOwner())
-                    if (unit->ToCreature() && unit->GetMapId() == plr->GetMapId() && !unit->IsWithinDistInMap(plr, GetVisibilityDistance(), false))
-                    {
-                        _removeList.push_back(unit->ToCreature());
-                    }
-
-                ref = ref->next();
+                itr->second->UpdateVisibilityForOwner();
             }
+            continue;
+        }
 
-            for (std::vector<Creature*>::iterator it = _removeList.begin(); it != _removeList.end(); ++it)
-            {
-                (*it)->RemoveAurasByCaster(plr->GetObjectGuid());
-                (*it)->_removeAttacker(plr);
-                (*it)->GetHostileRefManager().deleteReference(plr);
+        m_sharedVisibleObjects.clear();
+        itr->second->GatherVisibleObjects(m_sharedVisibleObjects);
 
-                href.deleteReference(*it);
+        for (; itr != groupEnd; ++itr)
+        {
+            itr->second->UpdateVisibilityForOwner(m_sharedVisibleObjects);
+        }
+    }
 
-                VisitNearbyCellsOf(*it, grid_object_update, world_object_update);
-            }
+    m_sharedVisibleObjects.clear();
+}
+
+/**
+ * Parallel variant of UpdateActiveCells for large continents (MapUpdateParallelRegions).
+ *
+ * Players and active objects are grouped into regions whose grids are too far apart
+ * for their objects to interact within one tick. Each region visits its cells with its
+ * own cell marks on the map update threads, the map thread takes part itself so it
+ * never waits on a busy pool. Hostile reference cleanup can reach objects of another
+ * region and is therefore done serially once every region is finished.
+ *
+ * @return false when the map should be updated serially instead
+ */
+bool Map::UpdateActiveCellsByRegions(const uint32& t_diff)
+{
+    if (!sWorld.getConfig(CONFIG_BOOL_MAP_UPDATE_PARALLEL_REGIONS) || Instanceable())
+    {
+        return false;
+    }
+
+    // the job is shared with helper threads that may only get scheduled after this update is finished
+    MapRegionUpdateJob* job = new MapRegionUpdateJob(*this, t_diff);
+    job->incReference();
+
+    if (!job->BuildRegions())
+    {
+        job->decReference();
+        return false;
+    }
+
+    size_t regionCount = job->GetRegionCount();
+    while (m_regionCellMarks.size() < regionCount)
+    {
+        m_regionCellMarks.push_back(new CellMarks());
+    }
+
+    m_regionUpdateActive = true;
+
+    MapUpdater& mapUpdater = sMapMgr.GetMapUpdater(*this);
+    if (mapUpdater.activated())
+    {
+        size_t helpers = std::min(regionCount - 1, mapUpdater.thread_count());
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            mapUpdater.schedule_task(new MapRegionUpdateJob::HelperRequest(job));
+        }
+    }
+
+    job->run();
+    job->WaitForCompletion();
+
+    m_regionUpdateActive = false;
+
+    // merge phase: cells seen by any region count as updated for the serial part
+    resetMarkedCells();
+    for (size_t i = 0; i < regionCount; ++i)
+    {
+        marked_cells |= *m_regionCellMarks[i];
+    }
+
+    for (std::vector<std::pair<GameObjectModel const*, bool> >::const_iterator itr = m_deferredModelChanges.begin(); itr != m_deferredModelChanges.end(); ++itr)
+    {
+        if (itr->second)
+        {
+            m_dyn_tree.insert(*itr->first);
+        }
+        else
+        {
+            m_dyn_tree.remove(*itr->first);
         }
     }
-
-    // non-player active objects
-    if (!m_activeNonPlayers.empty())
+    for (std::vector<GameObjectModel const*>::const_iterator itr = m_deferredModelRefits.begin(); itr != m_deferredModelRefits.end(); ++itr)
     {
-        for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+        // the model may have been removed again in the same tick
+        if (m_dyn_tree.contains(**itr))
         {
-            WorldObject* obj = *m_activeNonPlayersIter;
-
-            // step before processing, in this case if Map::Remove remove next object we correctly
-            // step to next-next, and if we step to end() then newly added objects can wait next update.
-            ++m_activeNonPlayersIter;
+            m_dyn_tree.refit(**itr);
+        }
+    }
+    if (!m_deferredModelChanges.empty() || !m_deferredModelRefits.empty())
+    {
+        m_losCache.Invalidate();
+    }
+    m_deferredModelChanges.clear();
+    m_deferredModelRefits.clear();
 
-            // skip not in world
-            if (!obj || !obj->IsInWorld())
-            {
-                continue;
-            }
+    MaNGOS::ObjectUpdater updater(t_diff);
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> grid_object_update(updater);
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> world_object_update(updater);
 
-            VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    {
+        Player* plr = m_mapRefIter->getSource();
+        if (plr && plr->IsInWorld())
+        {
+            RemoveFarHostileReferences(plr, grid_object_update, world_object_update);
         }
     }
 
-    // Send world objects and item update field changes
-    SendObjectUpdates();
+    job->decReference();
+    return true;
+}
 
-    // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
-    // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
-    if (!IsBattleGround())
+void Map::UpdateRegion(std::vector<WorldObject*> const& objects, uint32 t_diff, CellMarks& marks)
+{
+    marks.reset();
+
+    MaNGOS::ObjectUpdater updater(t_diff);
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> grid_object_update(updater);
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> world_object_update(updater);
+
+    for (std::vector<WorldObject*>::const_iterator itr = objects.begin(); itr != objects.end(); ++itr)
     {
-        for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
+        if ((*itr)->IsInWorld())
         {
-            NGridType* grid = i->getSource();
-            GridInfo* info = i->getSource()->getGridInfoRef();
-            ++i;                                            // The update might delete the map and we need the next map before the iterator gets invalid
-            MANGOS_ASSERT(grid->GetGridState() >= 0 && grid->GetGridState() < MAX_GRID_STATE);
-            sMapMgr.UpdateGridState(grid->GetGridState(), *this, *grid, *info, grid->getX(), grid->getY(), t_diff);
+            VisitNearbyCellsOf(*itr, grid_object_update, world_object_update, marks);
         }
     }
+}
 
-    ///- Process necessary scripts
-    if (!m_scriptSchedule.empty())
+void Map::AddUpdateObject(Object* obj)
+{
+    MapRegionGuard guard(this);
+
+    if (obj->m_clientUpdateIndex != CLIENT_UPDATE_INDEX_NONE)
     {
-        ScriptsProcess();
+        return;
     }
 
-#ifdef ENABLE_ELUNA
-    sEluna->OnUpdate(this, t_diff);
-#endif /* ENABLE_ELUNA */
+    obj->m_clientUpdateIndex = uint32(i_objectsToClientUpdate.size());
+    i_objectsToClientUpdate.push_back(obj);
+}
 
-    if (i_data)
+void Map::RemoveUpdateObject(Object* obj)
+{
+    MapRegionGuard guard(this);
+
+    uint32 index = obj->m_clientUpdateIndex;
+    if (index == CLIENT_UPDATE_INDEX_NONE)
     {
-        i_data->Update(t_diff);
+        return;
     }
-    // 更新天气系统
-    m_weatherSystem->UpdateWeathers(t_diff);
+
+    // while SendObjectUpdates is draining, the slot can be in the list being processed
+    if (index < i_objectsToClientUpdate.size() && i_objectsToClientUpdate[index] == obj)
+    {
+        i_objectsToClientUpdate[index] = NULL;
+    }
+    else if (index < i_objectsToClientUpdateSwap.size() && i_objectsToClientUpdateSwap[index] == obj)
+    {
+        i_objectsToClientUpdateSwap[index] = NULL;
+    }
+    else
+    {
+        return;
+    }
+
+    obj->m_clientUpdateIndex = CLIENT_UPDATE_INDEX_NONE;
 }
 
 void Map::Remove(Player* player, bool remove)
 {
+    sTickRecorder.PlayerLeft(this, player);
+
+    PlayerZoneMap::iterator zoneItr = m_playerZones.find(player);
+    if (zoneItr != m_playerZones.end())
+    {
+        ZonePlayersMap::iterator playersItr = m_zonePlayers.find(zoneItr->second);
+        playersItr->second.erase(player);
+        if (playersItr->second.empty())
+        {
+            m_zonePlayers.erase(playersItr);
+        }
+        m_playerZones.erase(zoneItr);
+    }
+
 #ifdef ENABLE_ELUNA
     sEluna->OnPlayerLeave(this, player);
 #endif /* ENABLE_ELUNA */
@@ -842,8 +1454,11 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
         else
         {
             EnsureGridLoadedAtEnter(new_cell, player);
+            RequestGridsAround(new_cell);
         }
 
+        RequestGridsAhead(player);
+
         NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
         player->GetViewPoint().Event_GridChanged(&(*newGrid)(new_cell.CellX(), new_cell.CellY()));
     }
@@ -934,6 +1549,63 @@ bool Map::CreatureRespawnRelocation(Creature* c)
     }
 }
 
+// Grids unloaded early by one map update at most, the budget is reached over a few updates
+#define MAX_GRID_BUDGET_UNLOADS_PER_UPDATE 4
+
+static bool GridExpiresSooner(std::pair<Milliseconds, NGridType*> const& a, std::pair<Milliseconds, NGridType*> const& b)
+{
+    return a.first < b.first;
+}
+
+void Map::UnloadGridsOverBudget()
+{
+    uint32 mapBudget = sWorld.getConfig(CONFIG_UINT32_GRID_UNLOAD_MAP_BUDGET);
+    uint32 totalBudget = sWorld.getConfig(CONFIG_UINT32_GRID_UNLOAD_TOTAL_BUDGET);
+
+    uint32 excess = 0;
+    if (mapBudget && m_loadedGridCount > mapBudget)
+    {
+        excess = m_loadedGridCount - mapBudget;
+    }
+
+    int64 totalLoaded = GetLoadedGridsMetric().GetValue();
+    if (totalBudget && totalLoaded > int64(totalBudget))
+    {
+        excess = std::max(excess, uint32(totalLoaded - totalBudget));
+    }
+
+    if (!excess)
+    {
+        return;
+    }
+
+    // idle grids all got the full expiry when they went idle, so the one with the least left is the coldest
+    std::vector<std::pair<Milliseconds, NGridType*> > candidates;
+    for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
+    {
+        NGridType* grid = i->getSource();
+        if (grid->GetGridState() == GRID_STATE_REMOVAL && !grid->getGridInfoRef()->getUnloadLock())
+        {
+            candidates.push_back(std::make_pair(grid->getGridInfoRef()->getTimeTracker().GetExpiry(), grid));
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), GridExpiresSooner);
+
+    uint32 unloaded = 0;
+    uint32 maxUnloads = std::min<uint32>(excess, MAX_GRID_BUDGET_UNLOADS_PER_UPDATE);
+    for (size_t i = 0; i < candidates.size() && unloaded < maxUnloads; ++i)
+    {
+        uint32 x = candidates[i].second->getX();
+        uint32 y = candidates[i].second->getY();
+        if (UnloadGrid(x, y, false))
+        {
+            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Grid[%u,%u] of map %u unloaded early, %u grids loaded above the budget", x, y, i_id, excess - unloaded);
+            ++unloaded;
+        }
+    }
+}
+
 bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
 {
     NGridType* grid = getNGrid(x, y);
@@ -961,6 +1633,8 @@ bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
         unloader.UnloadN();
         delete getNGrid(x, y);
         setNGrid(NULL, x, y);
+        GetLoadedGridsMetric().Add(-1);
+        --m_loadedGridCount;
     }
 
     int gx = (MAX_NUMBER_OF_GRIDS - 1) - x;
@@ -1172,6 +1846,7 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 
     obj->CleanupsBeforeDelete();                            // remove or simplify at least cross referenced links
 
+    MapRegionGuard guard(this);
     i_objectsToRemove.insert(obj);
     // DEBUG_LOG("Object (GUID: %u TypeId: %u ) added to removing list.",obj->GetGUIDLow(),obj->GetTypeId());
 }
@@ -1243,16 +1918,45 @@ void Map::SendToPlayers(WorldPacket const* data) const
 
 bool Map::SendToPlayersInZone(WorldPacket const* data, uint32 zoneId) const
 {
-    bool foundPlayer = false;
-    for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    ZonePlayerSet const* players = GetPlayersInZone(zoneId);
+    if (!players)
+    {
+        return false;
+    }
+
+    for (ZonePlayerSet::const_iterator itr = players->begin(); itr != players->end(); ++itr)
+    {
+        (*itr)->GetSession()->SendPacket(data);
+    }
+    return true;
+}
+
+void Map::SetPlayerZone(Player* player, uint32 zoneId)
+{
+    std::pair<PlayerZoneMap::iterator, bool> res = m_playerZones.insert(PlayerZoneMap::value_type(player, zoneId));
+    if (!res.second)
     {
-        if (itr->getSource()->GetZoneId() == zoneId)
+        if (res.first->second == zoneId)
+        {
+            return;
+        }
+
+        ZonePlayersMap::iterator oldItr = m_zonePlayers.find(res.first->second);
+        oldItr->second.erase(player);
+        if (oldItr->second.empty())
         {
-            itr->getSource()->GetSession()->SendPacket(data);
-            foundPlayer = true;
+            m_zonePlayers.erase(oldItr);
         }
+        res.first->second = zoneId;
     }
-    return foundPlayer;
+
+    m_zonePlayers[zoneId].insert(player);
+}
+
+Map::ZonePlayerSet const* Map::GetPlayersInZone(uint32 zoneId) const
+{
+    ZonePlayersMap::const_iterator itr = m_zonePlayers.find(zoneId);
+    return itr != m_zonePlayers.end() ? &itr->second : NULL;
 }
 
 bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
@@ -1301,6 +2005,8 @@ bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    MapRegionGuard guard(this);
+
     m_activeNonPlayers.insert(obj);
     Cell cell = Cell(MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
     EnsureGridLoaded(cell);
@@ -1331,6 +2037,8 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
+    MapRegionGuard guard(this);
+
     // Map::Update for active object in proccess
     if (m_activeNonPlayersIter != m_activeNonPlayers.end())
     {
@@ -1710,6 +2418,8 @@ bool DungeonMap::Reset(InstanceResetMethod method)
         m_resetAfterUnload = true;
     }
 
+    WakeUp();
+
     return m_mapRefManager.isEmpty();
 }
 
@@ -1906,17 +2616,16 @@ bool Map::ScriptsStart(DBScriptType type, uint32 id, Object* source, Object* tar
     ObjectGuid targetGuid = target ? target->GetObjectGuid() : ObjectGuid();
     ObjectGuid ownerGuid  = source->isType(TYPEMASK_ITEM) ? ((Item*)source)->GetOwnerGuid() : ObjectGuid();
 
+    MapRegionGuard guard(this);
+
     if (execParams)                                         // Check if the execution should be uniquely
     {
-        for (ScriptScheduleMap::const_iterator searchItr = m_scriptSchedule.begin(); searchItr != m_scriptSchedule.end(); ++searchItr)
+        if (m_scriptSchedule.HasScript(type, id,
+                                       (execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_SOURCE) ? sourceGuid : ObjectGuid(),
+                                       (execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_TARGET) ? targetGuid : ObjectGuid(), ownerGuid))
         {
-            if (searchItr->second.IsSameScript(type, id,
-                                               (execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_SOURCE) ? sourceGuid : ObjectGuid(),
-                                               (execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_TARGET) ? targetGuid : ObjectGuid(), ownerGuid))
-            {
-                DEBUG_LOG("DB-SCRIPTS: Process table `dbscripts [type=%d]` id %u. Skip script as script already started for source %s, target %s - ScriptsStartParams %u", type, id, sourceGuid.GetString().c_str(), targetGuid.GetString().c_str(), execParams);
-                return true;
-            }
+            DEBUG_LOG("DB-SCRIPTS: Process table `dbscripts [type=%d]` id %u. Skip script as script already started for source %s, target %s - ScriptsStartParams %u", type, id, sourceGuid.GetString().c_str(), targetGuid.GetString().c_str(), execParams);
+            return true;
         }
     }
 
@@ -1926,9 +2635,7 @@ bool Map::ScriptsStart(DBScriptType type, uint32 id, Object* source, Object* tar
     {
         ScriptAction sa(type, this, sourceGuid, targetGuid, ownerGuid, &(*iter));
 
-        m_scriptSchedule.insert(ScriptScheduleMap::value_type(time_t(sWorld.GetGameTime() + iter->delay), sa));
-
-        sScriptMgr.IncreaseScheduledScriptsCount();
+        m_scriptSchedule.Add(time_t(sWorld.GetGameTime() + iter->delay), sa);
     }
 
     return true;
@@ -1945,9 +2652,8 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
 
     ScriptAction sa(DBS_INTERNAL, this, sourceGuid, targetGuid, ownerGuid, &script);
 
-    m_scriptSchedule.insert(ScriptScheduleMap::value_type(time_t(sWorld.GetGameTime() + delay), sa));
-
-    sScriptMgr.IncreaseScheduledScriptsCount();
+    MapRegionGuard guard(this);
+    m_scriptSchedule.Add(time_t(sWorld.GetGameTime() + delay), sa);
 }
 
 /// Process queued scripts
@@ -1959,39 +2665,42 @@ void Map::ScriptsProcess()
     }
 
     ///- Process overdue queued scripts
-    ScriptScheduleMap::iterator iter = m_scriptSchedule.begin();
-    // ok as multimap is a *sorted* associative container
-    while (!m_scriptSchedule.empty() && (iter->first <= sWorld.GetGameTime()))
+    m_scriptSchedule.Process(sWorld.GetGameTime());
+}
+
+void Map::AddGameEventActions(GameEventMapActions const& actions)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_gameEventActionsLock);
+
+    m_gameEventActions.insert(m_gameEventActions.end(), actions.begin(), actions.end());
+}
+
+/// Apply queued game event spawn changes, a limited amount per update
+void Map::GameEventActionsProcess()
+{
+    GameEventMapActions actions;
     {
-        if (iter->second.HandleScriptStep())
-        {
-            // Terminate following script steps of this script
-            DBScriptType type = iter->second.GetType();
-            uint32 id = iter->second.GetId();
-            ObjectGuid sourceGuid = iter->second.GetSourceGuid();
-            ObjectGuid targetGuid = iter->second.GetTargetGuid();
-            ObjectGuid ownerGuid = iter->second.GetOwnerGuid();
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_gameEventActionsLock);
 
-            for (ScriptScheduleMap::iterator rmItr = m_scriptSchedule.begin(); rmItr != m_scriptSchedule.end();)
-            {
-                if (rmItr->second.IsSameScript(type, id, sourceGuid, targetGuid, ownerGuid))
-                {
-                    m_scriptSchedule.erase(rmItr++);
-                    sScriptMgr.DecreaseScheduledScriptCount();
-                }
-                else
-                {
-                    ++rmItr;
-                }
-            }
-        }
-        else
+        if (m_gameEventActions.empty())
         {
-            m_scriptSchedule.erase(iter);
+            return;
+        }
 
-            sScriptMgr.DecreaseScheduledScriptCount();
+        size_t count = m_gameEventActions.size();
+        if (uint32 limit = sWorld.getConfig(CONFIG_UINT32_EVENT_MAP_SPAWNS_PER_UPDATE))
+        {
+            count = std::min(count, size_t(limit));
         }
-        iter = m_scriptSchedule.begin();
+
+        actions.assign(m_gameEventActions.begin(), m_gameEventActions.begin() + count);
+        m_gameEventActions.erase(m_gameEventActions.begin(), m_gameEventActions.begin() + count);
+    }
+
+    // applied without the lock, the world thread may queue the next event meanwhile
+    for (GameEventMapActions::const_iterator itr = actions.begin(); itr != actions.end(); ++itr)
+    {
+        GameEventMgr::ApplyMapAction(this, *itr);
     }
 }
 
@@ -2016,6 +2725,7 @@ Player* Map::GetPlayer(ObjectGuid guid)
  */
 Creature* Map::GetCreature(ObjectGuid guid)
 {
+    MapRegionGuard guard(this);
     return m_objectsStore.find<Creature>(guid, (Creature*)NULL);
 }
 
@@ -2026,6 +2736,7 @@ Creature* Map::GetCreature(ObjectGuid guid)
  */
 Pet* Map::GetPet(ObjectGuid guid)
 {
+    MapRegionGuard guard(this);
     return m_objectsStore.find<Pet>(guid, (Pet*)NULL);
 }
 
@@ -2066,6 +2777,7 @@ Creature* Map::GetAnyTypeCreature(ObjectGuid guid)
  */
 GameObject* Map::GetGameObject(ObjectGuid guid)
 {
+    MapRegionGuard guard(this);
     return m_objectsStore.find<GameObject>(guid, (GameObject*)NULL);
 }
 
@@ -2076,6 +2788,7 @@ GameObject* Map::GetGameObject(ObjectGuid guid)
  */
 DynamicObject* Map::GetDynamicObject(ObjectGuid guid)
 {
+    MapRegionGuard guard(this);
     return m_objectsStore.find<DynamicObject>(guid, (DynamicObject*)NULL);
 }
 
@@ -2127,11 +2840,26 @@ void Map::SendObjectUpdates()
 {
     UpdateDataMapType update_players;
 
+    // building update data can mark further objects, those land in the emptied list and are handled in the next pass
     while (!i_objectsToClientUpdate.empty())
     {
-        Object* obj = *i_objectsToClientUpdate.begin();
-        i_objectsToClientUpdate.erase(i_objectsToClientUpdate.begin());
-        obj->BuildUpdateData(update_players);
+        i_objectsToClientUpdateSwap.swap(i_objectsToClientUpdate);
+
+        for (std::vector<Object*>::const_iterator itr = i_objectsToClientUpdateSwap.begin(); itr != i_objectsToClientUpdateSwap.end(); ++itr)
+        {
+            if (Object* obj = *itr)
+            {
+                obj->m_clientUpdateIndex = CLIENT_UPDATE_INDEX_NONE;
+                obj->BuildUpdateData(update_players);
+            }
+        }
+
+        i_objectsToClientUpdateSwap.clear();
+    }
+
+    if (SendObjectUpdatesPipelined(update_players))
+    {
+        return;
     }
 
     WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
@@ -2143,9 +2871,55 @@ void Map::SendObjectUpdates()
     }
 }
 
+bool Map::SendObjectUpdatesPipelined(UpdateDataMapType& update_players)
+{
+    uint32 threshold = sWorld.getConfig(CONFIG_UINT32_MAP_UPDATE_PACKET_BUILD_THRESHOLD);
+    if (!threshold || update_players.size() < threshold)
+    {
+        return false;
+    }
+
+    MapUpdater& mapUpdater = sMapMgr.GetMapUpdater(*this);
+    if (!mapUpdater.activated())
+    {
+        return false;
+    }
+
+    // the job is shared with helper threads that may only get scheduled after this update is finished
+    UpdatePacketBuildJob* job = new UpdatePacketBuildJob();
+    job->incReference();
+
+    job->GetEntries().reserve(update_players.size());
+    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
+    {
+        job->AddReceiver(iter->first, &iter->second);
+    }
+
+    size_t helpers = std::min(job->GetReceiverCount() - 1, mapUpdater.thread_count());
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        mapUpdater.schedule_task(new UpdatePacketBuildJob::HelperRequest(job));
+    }
+
+    job->run();
+    job->WaitForCompletion();
+
+    // sessions (and the bot hooks in SendPacket) are not thread safe, so sending stays here
+    std::vector<UpdatePacketBuildJob::Entry>& entries = job->GetEntries();
+    for (std::vector<UpdatePacketBuildJob::Entry>::iterator itr = entries.begin(); itr != entries.end(); ++itr)
+    {
+        itr->player->GetSession()->SendPacket(&itr->packet);
+    }
+
+    job->decReference();
+    return true;
+}
+
 uint32 Map::GenerateLocalLowGuid(HighGuid guidhigh)
 {
     // TODO: for map local guid counters possible force reload map instead shutdown server at guid counter overflow
+    MapRegionGuard guard(this);
+
     switch (guidhigh)
     {
         case HIGHGUID_UNIT:
@@ -2258,12 +3032,14 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
     WorldPacket data(SMSG_PLAY_SOUND, 4);
     data << uint32(soundId);
 
-    Map::PlayerList const& pList = GetPlayers();
-    for (PlayerList::const_iterator itr = pList.begin(); itr != pList.end(); ++itr)
-        if (!zoneId || itr->getSource()->GetZoneId() == zoneId)
-        {
-            itr->getSource()->SendDirectMessage(&data);
-        }
+    if (zoneId)
+    {
+        SendToPlayersInZone(&data, zoneId);
+    }
+    else
+    {
+        SendToPlayers(&data);
+    }
 }
 
 /**
@@ -2271,8 +3047,71 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+    bool useCache = LineOfSightCache::IsEnabled();
+    bool result;
+
+    if (useCache && m_losCache.Lookup(srcX, srcY, srcZ, destX, destY, destZ, result))
+    {
+        return result;
+    }
+
+    result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
+             && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+
+    if (useCache)
+    {
+        m_losCache.Store(srcX, srcY, srcZ, destX, destY, destZ, result);
+    }
+
+    return result;
+}
+
+void Map::IsInLineOfSight(float const* from, float const* to, bool* results, uint32 count) const
+{
+    bool useCache = LineOfSightCache::IsEnabled();
+
+    // rays answered by the cache are left out of the batch
+    std::vector<uint32> misses;
+    misses.reserve(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (!useCache || !m_losCache.Lookup(from[i * 3], from[i * 3 + 1], from[i * 3 + 2], to[i * 3], to[i * 3 + 1], to[i * 3 + 2], results[i]))
+        {
+            misses.push_back(i);
+        }
+    }
+
+    if (misses.empty())
+    {
+        return;
+    }
+
+    std::vector<float> missFrom(misses.size() * 3);
+    std::vector<float> missTo(misses.size() * 3);
+    for (size_t j = 0; j < misses.size(); ++j)
+    {
+        std::copy(from + misses[j] * 3, from + misses[j] * 3 + 3, &missFrom[j * 3]);
+        std::copy(to + misses[j] * 3, to + misses[j] * 3 + 3, &missTo[j * 3]);
+    }
+
+    bool* missResults = new bool[misses.size()];
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), &missFrom[0], &missTo[0], missResults, uint32(misses.size()));
+
+    for (size_t j = 0; j < misses.size(); ++j)
+    {
+        float const* src = &missFrom[j * 3];
+        float const* dst = &missTo[j * 3];
+        bool result = missResults[j] && m_dyn_tree.isInLineOfSight(src[0], src[1], src[2], dst[0], dst[1], dst[2]);
+
+        if (useCache)
+        {
+            m_losCache.Store(src[0], src[1], src[2], dst[0], dst[1], dst[2], result);
+        }
+
+        results[misses[j]] = result;
+    }
+
+    delete[] missResults;
 }
 
 /**
@@ -2378,18 +3217,71 @@ float Map::GetHeight(float x, float y, float z) const
     return std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight));
 }
 
+void Map::GetHeights(float const* x, float const* y, float const* z, float* heights, uint32 count) const
+{
+    m_TerrainData->GetHeightsStatic(x, y, z, heights, count);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        float dynSearchHeight = 2.0f + (z[i] < heights[i] ? heights[i] : z[i]);
+        heights[i] = std::max<float>(heights[i], m_dyn_tree.getHeight(x[i], y[i], dynSearchHeight, dynSearchHeight - heights[i]));
+    }
+}
+
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
+    // regions keep reading the tree for line of sight, changes wait for the merge phase
+    if (IsUpdatingRegions())
+    {
+        MapRegionGuard guard(this);
+        m_deferredModelChanges.push_back(std::make_pair(&mdl, true));
+        return;
+    }
+
     m_dyn_tree.insert(mdl);
+    m_losCache.Invalidate();
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
+    if (IsUpdatingRegions())
+    {
+        MapRegionGuard guard(this);
+        m_deferredModelChanges.push_back(std::make_pair(&mdl, false));
+        return;
+    }
+
     m_dyn_tree.remove(mdl);
+    m_losCache.Invalidate();
+}
+
+void Map::RefitGameObjectModel(const GameObjectModel& mdl)
+{
+    if (IsUpdatingRegions())
+    {
+        MapRegionGuard guard(this);
+        m_deferredModelRefits.push_back(&mdl);
+        return;
+    }
+
+    m_dyn_tree.refit(mdl);
+    m_losCache.Invalidate();
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
 {
+    if (IsUpdatingRegions())
+    {
+        MapRegionGuard guard(this);
+        for (std::vector<std::pair<GameObjectModel const*, bool> >::const_reverse_iterator itr = m_deferredModelChanges.rbegin(); itr != m_deferredModelChanges.rend(); ++itr)
+        {
+            if (itr->first == &mdl)
+            {
+                return itr->second;
+            }
+        }
+    }
+
     return m_dyn_tree.contains(mdl);
 }
 
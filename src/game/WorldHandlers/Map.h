@@ -30,6 +30,7 @@
 #include "Policies/ThreadingModel.h"
 #include <ace/RW_Thread_Mutex.h>
 #include <ace/Thread_Mutex.h>
+#include <ace/Recursive_Thread_Mutex.h>
 
 #include "DBCStructure.h"
 #include "GridDefines.h"
@@ -42,6 +43,10 @@
 #include "ScriptMgr.h"
 #include "CreatureLinkingMgr.h"
 #include "DynamicTree.h"
+#include "LineOfSightCache.h"
+#include "UpdateTime.h"
+#include "ScriptSchedule.h"
+#include "GameEventMgr.h"
 
 #include <bitset>
 
@@ -59,9 +64,12 @@ struct ScriptInfo;
 class BattleGround;
 class GridMap;
 class GameObjectModel;
+class PathCache;
 class WeatherSystem;
 class Transport;
 
+class MapRegionUpdateJob;
+
 namespace MaNGOS { struct ObjectUpdater; }
 
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
@@ -99,6 +107,7 @@ class Map : public GridRefManager<NGridType>
         friend class MapReference;
         friend class ObjectGridLoader;
         friend class ObjectWorldLoader;
+        friend class MapRegionUpdateJob;
 
     protected:
         Map(uint32 id, time_t, uint32 InstanceId);
@@ -130,10 +139,40 @@ class Map : public GridRefManager<NGridType>
 
         virtual void Update(const uint32&);
 
+        // wall time of the last threaded Update() call, used by the map updater to order maps by cost
+        uint32 GetLastUpdateDuration() const { return m_lastUpdateDuration; }
+        void SetLastUpdateDuration(uint32 duration) { m_lastUpdateDuration = duration; }
+
+        // an idle instance that is not updated until woken up, see Instance.HibernationDelay
+        bool IsHibernating() const { return m_hibernating; }
+        // leave hibernation at the next MapManager update
+        void WakeUp() { m_wakeUpRequested = true; }
+        // called before every update, false if the update is skipped; on wake up diff is the clamped time slept
+        bool UpdateHibernation(uint32& diff);
+        // called after UpdateHibernation, false if a quiet map skips this update; diff then covers the skipped time,
+        // see MapUpdateAdaptiveMaxInterval
+        bool UpdateTickRate(uint32& diff);
+        // average time between the updates since the last ResetUpdateTime()
+        uint32 GetAverageTickInterval() const;
+
+        // spawn changes of a starting or ending game event, applied over the next updates, see Event.MapSpawnsPerUpdate
+        void AddGameEventActions(GameEventMapActions const& actions);
+
+        // per phase timing of Update(), see .server perf maps
+        MapUpdateTime const& GetUpdateTime() const { return m_updateTime; }
+        void ResetUpdateTime() { m_updateTime.Reset(); m_tickedTime = 0; m_scriptSchedule.ResetExecutedCount(); m_losCache.ResetCounters(); m_dyn_tree.ResetMaintenanceCounters(); }
+        ScriptSchedule const& GetScriptSchedule() const { return m_scriptSchedule; }
+        LineOfSightCache const& GetLineOfSightCache() const { return m_losCache; }
+        DynamicMapTree const& GetDynamicTree() const { return m_dyn_tree; }
+        // recent poly paths of units on this map, see PathFinder
+        PathCache& GetPathCache() const { return *m_pathCache; }
+
         void MessageBroadcast(Player const*, WorldPacket*, bool to_self);
         void MessageBroadcast(WorldObject const*, WorldPacket*);
         void MessageDistBroadcast(Player const*, WorldPacket*, float dist, bool to_self, bool own_team_only = false);
         void MessageDistBroadcast(WorldObject const*, WorldPacket*, float dist);
+        // combat logs of source, target may be NULL; CombatLog.Distance limits them for everyone but the players of source and target
+        void CombatLogBroadcast(Unit const* source, WorldPacket* const* msgs, size_t count, Unit const* target);
 
         float GetVisibilityDistance() const { return m_VisibleDistance; }
         // function for setting up visibility distance for maps on per-type/per-Id basis
@@ -156,10 +195,14 @@ class Map : public GridRefManager<NGridType>
             return loaded(p);
         }
 
+        // terrain of the grid was requested ahead of time and is still being read by the terrain loader threads
+        bool IsGridLoadPending(float x, float y) const;
+
         bool GetUnloadLock(const GridPair& p) const { return getNGrid(p.x_coord, p.y_coord)->getUnloadLock(); }
         void SetUnloadLock(const GridPair& p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadExplicitLock(on); }
         void ForceLoadGrid(float x, float y);
         bool UnloadGrid(const uint32& x, const uint32& y, bool pForce);
+        uint32 GetLoadedGridCount() const { return m_loadedGridCount; }
         virtual void UnloadAll(bool pForce);
 
         void ResetGridExpiry(NGridType& grid, float factor = 1) const
@@ -196,6 +239,8 @@ class Map : public GridRefManager<NGridType>
 
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, CellPair cellpair);
 
+        typedef std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> CellMarks;
+
         void resetMarkedCells() { marked_cells.reset(); }
         /**
          * @brief 地图cell是否被更新
@@ -218,6 +263,12 @@ class Map : public GridRefManager<NGridType>
         /// Send a Packet to all players in a zone. Return false if no player found
         bool SendToPlayersInZone(WorldPacket const* data, uint32 zoneId) const;
 
+        typedef std::set<Player*> ZonePlayerSet;
+        /// Move the player to another zone of the per zone player index
+        void SetPlayerZone(Player* player, uint32 zoneId);
+        /// Players of the map in a zone, NULL if there are none
+        ZonePlayerSet const* GetPlayersInZone(uint32 zoneId) const;
+
         typedef MapRefManager PlayerList;
         PlayerList const& GetPlayers() const { return m_mapRefManager; }
 
@@ -247,18 +298,18 @@ class Map : public GridRefManager<NGridType>
         Unit* GetUnit(ObjectGuid guid);                     // only use if sure that need objects at current map, specially for player case
         WorldObject* GetWorldObject(ObjectGuid guid);       // only use if sure that need objects at current map, specially for player case
 
-        using MapStoredObjectTypesContainer = TypeUnorderedMapContainer<ObjectGuid, TypeList<Creature, Pet, GameObject, DynamicObject>> ;
+        using MapStoredObjectTypesContainer = TypeCounterSlotContainer<ObjectGuid, TypeList<Creature, Pet, GameObject, DynamicObject>> ;
         MapStoredObjectTypesContainer& GetObjectsStore() { return m_objectsStore; }
 
-        void AddUpdateObject(Object* obj)
-        {
-            i_objectsToClientUpdate.insert(obj);
-        }
+        void AddUpdateObject(Object* obj);
+        void RemoveUpdateObject(Object* obj);
 
-        void RemoveUpdateObject(Object* obj)
-        {
-            i_objectsToClientUpdate.erase(obj);
-        }
+        // camera owners with a requested visibility update, processed once per tick by UpdatePendingCameras
+        void AddPendingCamera(Player* player);
+
+        // true while independent grid regions of this map are updated by several threads, see MapRegionGuard
+        bool IsUpdatingRegions() const { return m_regionUpdateActive; }
+        ACE_Recursive_Thread_Mutex& GetRegionLock() const { return m_regionLock; }
 
         // DynObjects currently
         uint32 GenerateLocalLowGuid(HighGuid guidhigh);
@@ -276,14 +327,22 @@ class Map : public GridRefManager<NGridType>
 
         // Dynamic VMaps
         float GetHeight(float x, float y, float z) const;
+        // GetHeight of count points, for callers testing many candidate positions at once
+        void GetHeights(float const* x, float const* y, float const* z, float* heights, uint32 count) const;
         bool GetHeightInRange(float x, float y, float& z, float maxSearchDist = 4.0f) const;
         bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2) const;
+        // IsInLineOfSight of count segments (x, y, z triplets in from/to), the static tree is queried for all at once
+        void IsInLineOfSight(float const* from, float const* to, bool* results, uint32 count) const;
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
         void InsertGameObjectModel(const GameObjectModel& mdl);
         void RemoveGameObjectModel(const GameObjectModel& mdl);
         bool ContainsGameObjectModel(const GameObjectModel& mdl) const;
+        // a contained model moved or turned, its cell tree is refitted instead of rebuilt
+        void RefitGameObjectModel(const GameObjectModel& mdl);
+        // a dynamic model changed its collision or orientation, cached line of sight results are no longer valid
+        void InvalidateLineOfSightCache() { m_losCache.Invalidate(); }
 
         // Get Holder for Creature Linking
         CreatureLinkingHolder* GetCreatureLinkingHolder() { return &m_creatureLinkingHolder; }
@@ -311,6 +370,11 @@ class Map : public GridRefManager<NGridType>
 
     private:
         void LoadMapAndVMap(int gx, int gy);
+        // ask the terrain loader threads for the grids next to the cell, see TerrainManager::ActivateLoader
+        void RequestGridsAround(const Cell& cell);
+        // ask the terrain loader threads for the grids the player reaches next on its taxi path or running straight on
+        void RequestGridsAhead(Player* player);
+        void RequestGridAt(float x, float y);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -323,6 +387,7 @@ class Map : public GridRefManager<NGridType>
 
         bool loaded(const GridPair&) const;
         void EnsureGridCreated(const GridPair&);
+        void UnloadGridsOverBudget();
         bool EnsureGridLoaded(Cell const&);
         void EnsureGridLoadedAtEnter(Cell const&, Player* player = nullptr);
 
@@ -344,6 +409,20 @@ class Map : public GridRefManager<NGridType>
         void VisitNearbyCellsOf(WorldObject* obj,
                                 TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor,
                                 TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
+        void VisitNearbyCellsOf(WorldObject* obj,
+                                TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor,
+                                TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor,
+                                CellMarks& marks);
+
+        void UpdateActiveCells(const uint32& t_diff);
+        void UpdatePendingCameras();
+        // add the not yet marked cells in visibility range of obj to cells
+        void CollectNearbyCells(WorldObject* obj, CellMarks& marks, std::vector<uint32>& cells);
+        bool UpdateActiveCellsByRegions(const uint32& t_diff);
+        void UpdateRegion(std::vector<WorldObject*> const& objects, uint32 t_diff, CellMarks& marks);
+        void RemoveFarHostileReferences(Player* plr,
+                                        TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor,
+                                        TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
 
         bool isGridObjectDataLoaded(uint32 x, uint32 y) const { return getNGrid(x, y)->isGridObjectDataLoaded(); }
         void setGridObjectDataLoaded(bool pLoaded, uint32 x, uint32 y) { getNGrid(x, y)->setGridObjectDataLoaded(pLoaded); }
@@ -355,15 +434,29 @@ class Map : public GridRefManager<NGridType>
         */
         void setNGrid(NGridType* grid, uint32 x, uint32 y);
         void ScriptsProcess();
+        void GameEventActionsProcess();
 
         void SendObjectUpdates();
-        std::set<Object*> i_objectsToClientUpdate;
+        // build and compress the packets on the map update threads, false if the serial path should be used
+        bool SendObjectUpdatesPipelined(UpdateDataMapType& update_players);
+
+        // objects with pending update fields, indexed by Object::m_clientUpdateIndex; removed entries are left as NULL
+        // and the storage is kept between ticks, so marking objects does not allocate in steady state
+        std::vector<Object*> i_objectsToClientUpdate;
+        std::vector<Object*> i_objectsToClientUpdateSwap;
 
     protected:
+        // maps whose update has no work without players, see UpdateHibernation
+        virtual bool CanHibernate() const { return false; }
+        // players fighting or moving, due db scripts or game event spawns, see UpdateTickRate
+        bool HasActivity() const;
+
         MapEntry const* i_mapEntry;
         uint32 i_id;
         uint32 i_InstanceId;
         uint32 m_unloadTimer;
+        uint32 m_respawnSaveTimer;                          // time since the respawn times were last written
+        uint32 m_loadedGridCount;
         float m_VisibleDistance;
         MapPersistentState* m_persistentState;
 
@@ -387,13 +480,35 @@ class Map : public GridRefManager<NGridType>
         /**
          * @brief 地图cell标记
         */
-        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        CellMarks marked_cells;
+
+        // parallel grid region update, see Map::UpdateActiveCellsByRegions
+        bool m_regionUpdateActive;
+        mutable ACE_Recursive_Thread_Mutex m_regionLock;
+        std::vector<CellMarks*> m_regionCellMarks;
+        std::vector<std::pair<GameObjectModel const*, bool> > m_deferredModelChanges;
+        std::vector<GameObjectModel const*> m_deferredModelRefits;
+
+        std::vector<uint32> m_activeCells;                  // cell ids updated this tick, kept to reuse the storage
+
+        ACE_Thread_Mutex m_pendingCamerasLock;              // relocations are reported from region update threads
+        GuidVector m_pendingCameras;
+        GuidVector m_pendingCamerasSwap;
+        std::vector<WorldObject*> m_sharedVisibleObjects;
 
         std::set<WorldObject*> i_objectsToRemove;
         std::set<Transport*> i_transports;
 
-        typedef std::multimap<time_t, ScriptAction> ScriptScheduleMap;
-        ScriptScheduleMap m_scriptSchedule;
+        // players by the zone they were last updated to, kept by Add/Remove and Player::UpdateZone
+        typedef UNORDERED_MAP<uint32, ZonePlayerSet> ZonePlayersMap;
+        typedef UNORDERED_MAP<Player*, uint32> PlayerZoneMap;
+        ZonePlayersMap m_zonePlayers;
+        PlayerZoneMap m_playerZones;
+
+        ScriptSchedule m_scriptSchedule;
+
+        ACE_Thread_Mutex m_gameEventActionsLock;
+        std::deque<GameEventMapAction> m_gameEventActions;
 
         InstanceData* i_data;
 
@@ -414,9 +529,22 @@ class Map : public GridRefManager<NGridType>
 
         // Dynamic Map tree object
         DynamicMapTree m_dyn_tree;
+        mutable LineOfSightCache m_losCache;
+        PathCache* m_pathCache;
 
         // WeatherSystem
         WeatherSystem* m_weatherSystem;
+
+        uint32 m_lastUpdateDuration;
+
+        bool m_hibernating;
+        bool m_wakeUpRequested;
+        uint32 m_idleTime;                                  // time without players before hibernation
+        uint32 m_hibernatedDiff;                            // time slept, handed to the first update after waking up
+        uint32 m_skippedDiff;                               // time of the updates skipped by a quiet map
+        uint64 m_tickedTime;                                // sum of the update diffs, for the effective tick rate
+        MapUpdateTime m_updateTime;
+        MetricHistogram* m_tickMetric;                      // shared by all instances of the map id
 };
 
 class WorldMap : public Map
@@ -454,6 +582,10 @@ class DungeonMap : public Map
         DungeonPersistentState* GetPersistanceState() const;
 
         virtual void InitVisibilityDistance() override;
+
+    protected:
+        bool CanHibernate() const override { return true; }
+
     private:
         bool m_resetAfterUnload;
         bool m_unloadWhenEmpty;
@@ -487,6 +619,36 @@ class BattleGroundMap : public Map
         BattleGround* m_bg;
 };
 
+/**
+ * Serializes access to map wide containers while Map::Update runs grid regions in
+ * parallel (MapUpdateParallelRegions), does nothing in the normal serial update.
+ */
+class MapRegionGuard
+{
+    public:
+        explicit MapRegionGuard(Map const* map) : m_lock(map && map->IsUpdatingRegions() ? &map->GetRegionLock() : NULL)
+        {
+            if (m_lock)
+            {
+                m_lock->acquire();
+            }
+        }
+
+        ~MapRegionGuard()
+        {
+            if (m_lock)
+            {
+                m_lock->release();
+            }
+        }
+
+    private:
+        MapRegionGuard(MapRegionGuard const&);
+        MapRegionGuard& operator=(MapRegionGuard const&);
+
+        ACE_Recursive_Thread_Mutex* m_lock;
+};
+
 template<class T, class CONTAINER>
 inline void
 Map::Visit(const Cell& cell, TypeContainerVisitor<T, CONTAINER>& visitor)
@@ -27,6 +27,7 @@
 #include "Policies/Singleton.h"
 #include "Database/DatabaseEnv.h"
 #include "Log.h"
+#include "Config/Config.h"
 #include "Transports.h"
 #include "GridDefines.h"
 #include "World.h"
@@ -38,7 +39,7 @@ INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(MapManager, ACE_Recursive_Thread_Mutex);
 
 MapManager::MapManager()
-    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN)), m_lock()
+    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN)), m_mapsView(new MapMapType()), i_perfLogTimer(0), m_lock()
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 }
@@ -62,12 +63,24 @@ void
 MapManager::Initialize()
 {
     int num_threads(sWorld.getConfig(CONFIG_UINT32_NUMTHREADS));
+    MapUpdateScheduler scheduler = MapUpdateScheduler(sWorld.getConfig(CONFIG_UINT32_MAP_UPDATE_SCHEDULER));
+    // the terrain loaders share the CPUs of the map threads, grid memory is then first touched on their memory node
+    std::string cpus = sConfig.GetStringDefault("ThreadAffinity.Maps", "");
     // Start mtmaps if needed.
-    if (num_threads > 0 && m_updater.activate(num_threads) == -1)
+    if (num_threads > 0 && m_updater.activate(num_threads, scheduler, cpus) == -1)
     {
         abort();
     }
 
+    // instances get their own threads so a busy raid night can't hold back the continents
+    int instance_threads(sWorld.getConfig(CONFIG_UINT32_INSTANCE_UPDATE_THREADS));
+    if (num_threads > 0 && instance_threads > 0 && m_instanceUpdater.activate(instance_threads, scheduler, sConfig.GetStringDefault("ThreadAffinity.Instances", cpus.c_str())) == -1)
+    {
+        abort();
+    }
+
+    sTerrainMgr.ActivateLoader(sWorld.getConfig(CONFIG_UINT32_GRID_LOADER_THREADS), cpus);
+
     InitStateMachine();
     InitMaxInstanceId();
 }
@@ -97,9 +110,15 @@ void MapManager::UpdateGridState(grid_state_t state, Map& map, NGridType& ngrid,
     si_GridStates[state]->Update(map, ngrid, ginfo, x, y, t_diff);
 }
 
+void MapManager::PublishMaps()
+{
+    std::atomic_store(&m_mapsView, MapMapSnapshot(new MapMapType(i_maps)));
+}
+
 void MapManager::InitializeVisibilityDistanceInfo()
 {
-    for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+    MapMapSnapshot maps = Maps();
+    for (MapMapType::const_iterator iter = maps->begin(); iter != maps->end(); ++iter)
     {
         (*iter).second->InitVisibilityDistance();
     }
@@ -137,6 +156,7 @@ Map* MapManager::CreateMap(uint32 id, const WorldObject* obj)
             m = new WorldMap(id, i_gridCleanUpDelay);
             // add map into container
             i_maps[MapID(id)] = m;
+            PublishMaps();
 
             LoadActiveEntities(m);
 
@@ -158,10 +178,10 @@ Map* MapManager::CreateBgMap(uint32 mapid, BattleGround* bg)
 
 Map* MapManager::FindMap(uint32 mapid, uint32 instanceId) const
 {
-    ACE_GUARD_RETURN(LOCK_TYPE, _guard, m_lock, NULL)
+    MapMapSnapshot maps = Maps();
 
-    MapMapType::const_iterator iter = i_maps.find(MapID(mapid, instanceId));
-    if (iter == i_maps.end())
+    MapMapType::const_iterator iter = maps->find(MapID(mapid, instanceId));
+    if (iter == maps->end())
     {
         return NULL;
     }
@@ -187,6 +207,7 @@ void MapManager::DeleteInstance(uint32 mapid, uint32 instanceId)
         if (pMap->Instanceable())
         {
             i_maps.erase(iter);
+            PublishMaps();
 
             pMap->UnloadAll(true);
             delete pMap;
@@ -202,22 +223,45 @@ void MapManager::Update(uint32 diff)
         return;
     }
 
-    for (MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end(); ++iter)
+    MapMapSnapshot maps = Maps();
+    for (MapMapType::const_iterator iter = maps->begin(); iter != maps->end(); ++iter)
     {
-        if (m_updater.activated())
+        uint32 mapDiff = (uint32)i_timer.GetCurrent();
+        if (!iter->second->UpdateHibernation(mapDiff) || !iter->second->UpdateTickRate(mapDiff))
+        {
+            continue;
+        }
+
+        MapUpdater& updater = GetMapUpdater(*iter->second);
+        if (updater.activated())
         {
-            m_updater.schedule_update(*iter->second, (uint32)i_timer.GetCurrent());
+            updater.schedule_update(*iter->second, mapDiff);
         }
         else
         {
-            iter->second->Update((uint32)i_timer.GetCurrent());
+            iter->second->Update(mapDiff);
         }
     }
 
+    if (m_instanceUpdater.activated())
+    {
+        m_instanceUpdater.wait();
+    }
+
     if (m_updater.activated())
     {
         m_updater.wait();
     }
+
+    if (uint32 perfLogInterval = sWorld.getConfig(CONFIG_UINT32_MAP_UPDATE_PERF_LOG_INTERVAL))
+    {
+        i_perfLogTimer += uint32(i_timer.GetCurrent());
+        if (i_perfLogTimer >= perfLogInterval)
+        {
+            i_perfLogTimer = 0;
+            LogMapUpdateTimes();
+        }
+    }
     // ���´��ͷ�ͧ
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
     {
@@ -226,30 +270,66 @@ void MapManager::Update(uint32 diff)
     }
 
     // remove all maps which can be unloaded
-    MapMapType::iterator iter = i_maps.begin();
-    while (iter != i_maps.end())
+    for (MapMapType::const_iterator iter = maps->begin(); iter != maps->end(); ++iter)
     {
         Map* pMap = iter->second;
         // check if map can be unloaded
         if (pMap->CanUnload((uint32)i_timer.GetCurrent()))
         {
             pMap->UnloadAll(true);
+
+            {
+                ACE_GUARD(LOCK_TYPE, _guard, m_lock)
+                i_maps.erase(iter->first);
+                PublishMaps();
+            }
+
             delete pMap;
+        }
+    }
 
-            i_maps.erase(iter++);
+    i_timer.SetCurrent(0);
+}
+
+void MapManager::LogMapUpdateTimes()
+{
+    MapMapSnapshot maps = Maps();
+    for (MapMapType::const_iterator iter = maps->begin(); iter != maps->end(); ++iter)
+    {
+        Map* map = iter->second;
+        MapUpdateTime const& updateTime = map->GetUpdateTime();
+        UpdateTimeHistogram const& total = updateTime.GetPhase(MAP_UPDATE_PHASE_TOTAL);
+
+        if (!total.GetCount())
+        {
+            continue;
         }
-        else
+
+        std::ostringstream phases;
+        for (uint32 phase = 0; phase < MAP_UPDATE_PHASE_TOTAL; ++phase)
         {
-            ++iter;
+            UpdateTimeHistogram const& histogram = updateTime.GetPhase(MapUpdatePhase(phase));
+            phases << " " << MapUpdateTime::GetPhaseName(MapUpdatePhase(phase)) << " " << histogram.GetPercentile(50)
+                   << "/" << histogram.GetPercentile(99) << "/" << histogram.GetMax();
         }
-    }
 
-    i_timer.SetCurrent(0);
+        LineOfSightCache const& losCache = map->GetLineOfSightCache();
+        DynamicMapTree const& dynTree = map->GetDynamicTree();
+
+        sLog.outString("Map %u instance %u: ticks %u every %u ms, total %u/%u/%u us,%s, script steps %u/%u, los cache %u/%u, dynamic tree %u/%u " UI64FMTD " us", map->GetId(), map->GetInstanceId(), total.GetCount(), map->GetAverageTickInterval(),
+                       total.GetPercentile(50), total.GetPercentile(99), total.GetMax(), phases.str().c_str(),
+                       uint32(map->GetScriptSchedule().size()), map->GetScriptSchedule().GetExecutedCount(),
+                       losCache.GetHits(), losCache.GetHits() + losCache.GetMisses(),
+                       dynTree.GetRefitCount(), dynTree.GetRebuildCount(), dynTree.GetMaintenanceTime());
+
+        map->ResetUpdateTime();
+    }
 }
 
 void MapManager::RemoveAllObjectsInRemoveList()
 {
-    for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+    MapMapSnapshot maps = Maps();
+    for (MapMapType::const_iterator iter = maps->begin(); iter != maps->end(); ++iter)
     {
         iter->second->RemoveAllObjectsInRemoveList();
     }
@@ -274,19 +354,30 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
-    for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+    MapMapSnapshot maps = Maps();
+    for (MapMapType::const_iterator iter = maps->begin(); iter != maps->end(); ++iter)
     {
         iter->second->UnloadAll(true);
     }
 
-    while (!i_maps.empty())
     {
-        delete i_maps.begin()->second;
-        i_maps.erase(i_maps.begin());
+        ACE_GUARD(LOCK_TYPE, _guard, m_lock)
+        i_maps.clear();
+        PublishMaps();
+    }
+
+    for (MapMapType::const_iterator iter = maps->begin(); iter != maps->end(); ++iter)
+    {
+        delete iter->second;
     }
 
     TerrainManager::Instance().UnloadAll();
 
+    if (m_instanceUpdater.activated())
+    {
+        m_instanceUpdater.deactivate();
+    }
+
     if (m_updater.activated())
     {
         m_updater.deactivate();
@@ -309,8 +400,8 @@ uint32 MapManager::GetNumInstances()
 {
     uint32 ret = 0;
 
-    ACE_GUARD_RETURN(LOCK_TYPE, _guard, m_lock, ret)
-    for (MapMapType::iterator itr = i_maps.begin(); itr != i_maps.end(); ++itr)
+    MapMapSnapshot maps = Maps();
+    for (MapMapType::const_iterator itr = maps->begin(); itr != maps->end(); ++itr)
     {
         Map* map = itr->second;
         if (!map->IsDungeon())
@@ -326,8 +417,8 @@ uint32 MapManager::GetNumPlayersInInstances()
 {
     uint32 ret = 0;
 
-    ACE_GUARD_RETURN(LOCK_TYPE, _guard, m_lock, ret)
-    for (MapMapType::iterator itr = i_maps.begin(); itr != i_maps.end(); ++itr)
+    MapMapSnapshot maps = Maps();
+    for (MapMapType::const_iterator itr = maps->begin(); itr != maps->end(); ++itr)
     {
         Map* map = itr->second;
         if (!map->IsDungeon())
@@ -380,6 +471,7 @@ Map* MapManager::CreateInstance(uint32 id, Player* player)
     if (pNewMap)
     {
         i_maps[MapID(id, NewInstanceId)] = pNewMap;
+        PublishMaps();
         map = pNewMap;
     }
 
@@ -423,6 +515,7 @@ BattleGroundMap* MapManager::CreateBattleGroundMap(uint32 id, uint32 InstanceId,
 
     // add map into map container
     i_maps[MapID(id, InstanceId)] = map;
+    PublishMaps();
 
     // BGs/Arenas not have saved instance data
     map->CreateInstanceData(false);
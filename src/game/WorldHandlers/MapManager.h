@@ -33,6 +33,8 @@
 #include "GridStates.h"
 #include "MapUpdater.h"
 
+#include <memory>
+
 class Transport;
 class BattleGround;
 
@@ -63,6 +65,7 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 
     public:
         typedef std::map<MapID, Map* > MapMapType;
+        typedef std::shared_ptr<MapMapType const> MapMapSnapshot;
 
         Map* CreateMap(uint32, const WorldObject* obj);
         Map* CreateBgMap(uint32 mapid, BattleGround* bg);
@@ -158,8 +161,13 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         uint32 GetNumPlayersInInstances();
 
 
-        // get list of all maps
-        const MapMapType& Maps() const { return i_maps; }
+        // get list of all maps, the returned snapshot stays valid while held but does not see later changes
+        MapMapSnapshot Maps() const { return std::atomic_load(&m_mapsView); }
+
+        // map update thread pool, also used by maps for parallel region updates
+        MapUpdater& GetMapUpdater() { return m_updater; }
+        // the pool that updates the map, its helper tasks are best run there as well
+        MapUpdater& GetMapUpdater(Map const& map) { return map.Instanceable() && m_instanceUpdater.activated() ? m_instanceUpdater : m_updater; }
 
         template<typename Do>
         void DoForAllMapsWithMapId(uint32 mapId, Do& _do);
@@ -181,15 +189,23 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         void InitStateMachine();
         void DeleteStateMachine();
         void LoadActiveEntities(Map* m);
+        void LogMapUpdateTimes();
 
         Map* CreateInstance(uint32 id, Player* player);
         DungeonMap* CreateDungeonMap(uint32 id, uint32 InstanceId, DungeonPersistentState* save = NULL);
         BattleGroundMap* CreateBattleGroundMap(uint32 id, uint32 InstanceId, BattleGround* bg);
+        void PublishMaps();
 
         uint32 i_gridCleanUpDelay;
+
+        // i_maps is only touched under m_lock; lookups read the immutable copy in m_mapsView,
+        // which PublishMaps() replaces after every change so readers never need the lock
         MapMapType i_maps;
+        MapMapSnapshot m_mapsView;
         IntervalTimer i_timer;
+        uint32 i_perfLogTimer;
         MapUpdater m_updater;
+        MapUpdater m_instanceUpdater;                       // dungeons and battlegrounds, if InstanceUpdateThreads is set
         uint32 i_MaxInstanceId;
 
         typedef ACE_Recursive_Thread_Mutex LOCK_TYPE;
@@ -199,8 +215,9 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 template<typename Do>
 inline void MapManager::DoForAllMapsWithMapId(uint32 mapId, Do& _do)
 {
-    MapMapType::const_iterator start = i_maps.lower_bound(MapID(mapId, 0));
-    MapMapType::const_iterator end   = i_maps.lower_bound(MapID(mapId + 1, 0));
+    MapMapSnapshot maps = Maps();
+    MapMapType::const_iterator start = maps->lower_bound(MapID(mapId, 0));
+    MapMapType::const_iterator end   = maps->lower_bound(MapID(mapId + 1, 0));
     for (MapMapType::const_iterator itr = start; itr != end; ++itr)
     {
         _do(itr->second);
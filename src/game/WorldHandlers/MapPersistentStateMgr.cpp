@@ -37,6 +37,7 @@
 #include "Group.h"
 #include "InstanceData.h"
 #include "ProgressBar.h"
+#include "CharacterLoginCache.h"
 #include <vector>
 
 INSTANTIATE_SINGLETON_1(MapPersistentStateManager);
@@ -54,6 +55,7 @@ MapPersistentState::MapPersistentState(uint16 MapId, uint32 InstanceId)
 
 MapPersistentState::~MapPersistentState()
 {
+    SaveRespawnTimesToDB();
 }
 
 MapEntry const* MapPersistentState::GetMapEntry() const
@@ -77,56 +79,82 @@ bool MapPersistentState::UnloadIfEmpty()
 
 void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
 {
-    SetCreatureRespawnTime(loguid, t);
-
     // BGs/Arenas always reset at server restart/unload, so no reason store in DB
-    if (GetMapEntry()->IsBattleGround())
+    if (!GetMapEntry()->IsBattleGround())
     {
-        return;
-    }
-
-    CharacterDatabase.BeginTransaction();
+        m_unsavedCreatureRespawnTimes[loguid] = t;
 
-    static SqlStatementID delSpawnTime ;
-    static SqlStatementID insSpawnTime ;
+        // without a map nothing writes the collected times later
+        if (!m_usedByMap || !sWorld.getConfig(CONFIG_UINT32_SAVE_RESPAWN_TIME_INTERVAL))
+        {
+            SaveRespawnTimesToDB();
+        }
+    }
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delSpawnTime, "DELETE FROM `creature_respawn` WHERE `guid` = ? AND `instance` = ?");
-    stmt.PExecute(loguid, m_instanceid);
+    SetCreatureRespawnTime(loguid, t);                      // state can be deleted at call
+}
 
-    if (t > sWorld.GetGameTime())
+void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
+{
+    // BGs/Arenas always reset at server restart/unload, so no reason store in DB
+    if (!GetMapEntry()->IsBattleGround())
     {
-        stmt = CharacterDatabase.CreateStatement(insSpawnTime, "INSERT INTO `creature_respawn` VALUES ( ?, ?, ? )");
-        stmt.PExecute(loguid, uint64(t), m_instanceid);
+        m_unsavedGORespawnTimes[loguid] = t;
+
+        // without a map nothing writes the collected times later
+        if (!m_usedByMap || !sWorld.getConfig(CONFIG_UINT32_SAVE_RESPAWN_TIME_INTERVAL))
+        {
+            SaveRespawnTimesToDB();
+        }
     }
 
-    CharacterDatabase.CommitTransaction();
+    SetGORespawnTime(loguid, t);                            // state can be deleted at call
 }
 
-void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
+void MapPersistentState::SaveRespawnTimesToDB()
 {
-    SetGORespawnTime(loguid, t);
-
-    // BGs/Arenas always reset at server restart/unload, so no reason store in DB
-    if (GetMapEntry()->IsBattleGround())
+    if (m_unsavedCreatureRespawnTimes.empty() && m_unsavedGORespawnTimes.empty())
     {
         return;
     }
 
+    static SqlStatementID delCreatureSpawnTime ;
+    static SqlStatementID insCreatureSpawnTime ;
+    static SqlStatementID delGOSpawnTime ;
+    static SqlStatementID insGOSpawnTime ;
+
+    time_t now = sWorld.GetGameTime();
+
     CharacterDatabase.BeginTransaction();
 
-    static SqlStatementID delSpawnTime ;
-    static SqlStatementID insSpawnTime ;
+    for (RespawnTimes::const_iterator itr = m_unsavedCreatureRespawnTimes.begin(); itr != m_unsavedCreatureRespawnTimes.end(); ++itr)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delCreatureSpawnTime, "DELETE FROM `creature_respawn` WHERE `guid` = ? AND `instance` = ?");
+        stmt.PExecute(itr->first, m_instanceid);
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delSpawnTime, "DELETE FROM `gameobject_respawn` WHERE `guid` = ? AND `instance` = ?");
-    stmt.PExecute(loguid, m_instanceid);
+        if (itr->second > now)
+        {
+            stmt = CharacterDatabase.CreateStatement(insCreatureSpawnTime, "INSERT INTO `creature_respawn` VALUES ( ?, ?, ? )");
+            stmt.PExecute(itr->first, uint64(itr->second), m_instanceid);
+        }
+    }
 
-    if (t > sWorld.GetGameTime())
+    for (RespawnTimes::const_iterator itr = m_unsavedGORespawnTimes.begin(); itr != m_unsavedGORespawnTimes.end(); ++itr)
     {
-        stmt = CharacterDatabase.CreateStatement(insSpawnTime, "INSERT INTO `gameobject_respawn` VALUES ( ?, ?, ? )");
-        stmt.PExecute(loguid, uint64(t), m_instanceid);
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delGOSpawnTime, "DELETE FROM `gameobject_respawn` WHERE `guid` = ? AND `instance` = ?");
+        stmt.PExecute(itr->first, m_instanceid);
+
+        if (itr->second > now)
+        {
+            stmt = CharacterDatabase.CreateStatement(insGOSpawnTime, "INSERT INTO `gameobject_respawn` VALUES ( ?, ?, ? )");
+            stmt.PExecute(itr->first, uint64(itr->second), m_instanceid);
+        }
     }
 
     CharacterDatabase.CommitTransaction();
+
+    m_unsavedCreatureRespawnTimes.clear();
+    m_unsavedGORespawnTimes.clear();
 }
 
 void MapPersistentState::SetCreatureRespawnTime(uint32 loguid, time_t t)
@@ -160,6 +188,10 @@ void MapPersistentState::ClearRespawnTimes()
     m_goRespawnTimes.clear();
     m_creatureRespawnTimes.clear();
 
+    // the rows are deleted by the caller, don't write them back
+    m_unsavedGORespawnTimes.clear();
+    m_unsavedCreatureRespawnTimes.clear();
+
     UnloadIfEmpty();
 }
 
@@ -718,6 +750,9 @@ void MapPersistentStateManager::DeleteInstanceFromDB(uint32 instanceid)
 {
     if (instanceid)
     {
+        // bound offline characters may have a prefetched login
+        sCharacterLoginCache.Clear();
+
         CharacterDatabase.BeginTransaction();
         CharacterDatabase.PExecute("DELETE FROM `instance` WHERE `id` = '%u'", instanceid);
         CharacterDatabase.PExecute("DELETE FROM `character_instance` WHERE `instance` = '%u'", instanceid);
@@ -976,6 +1011,7 @@ void MapPersistentStateManager::_ResetOrWarnAll(uint32 mapid, bool warn, uint32
         sMapMgr.DoForAllMapsWithMapId(mapid, worker);
 
         // delete them from the DB, even if not loaded
+        sCharacterLoginCache.Clear();
         CharacterDatabase.BeginTransaction();
         CharacterDatabase.PExecute("DELETE FROM `character_instance` USING `character_instance` LEFT JOIN `instance` ON `character_instance`.`instance` = `id` WHERE `map` = '%u'", mapid);
         CharacterDatabase.PExecute("DELETE FROM `group_instance` USING `group_instance` LEFT JOIN `instance` ON `group_instance`.`instance` = `id` WHERE `map` = '%u'", mapid);
@@ -103,6 +103,9 @@ class MapPersistentState
         }
         void SaveGORespawnTime(uint32 loguid, time_t t);
 
+        // writes the saved respawn times not yet in the database in one transaction
+        void SaveRespawnTimesToDB();
+
         // pool system
         void InitPools();
         virtual SpawnedPoolData& GetSpawnedPoolData() = 0;
@@ -137,6 +140,8 @@ class MapPersistentState
         // persistent data
         RespawnTimes m_creatureRespawnTimes;                // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
         RespawnTimes m_goRespawnTimes;                      // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
+        RespawnTimes m_unsavedCreatureRespawnTimes;         // saved since the last SaveRespawnTimesToDB
+        RespawnTimes m_unsavedGORespawnTimes;
         MapCellObjectGuidsMap m_gridObjectGuids;            // Single map copy specific grid spawn data, like pool spawns
 };
 
@@ -81,6 +81,11 @@ void MassMailMgr::AddMassMailTask(MailDraft* mailProto, const MailSender &sender
     CharacterDatabase.AsyncPQuery(&massMailerQueryHandler, &MassMailerQueryHandler::HandleQueryCallback, mailProto, sender, "%s", query);
 }
 
+static bool IsUpdateTimeBudgetExceeded(uint32 startTime, uint32 timeBudget)
+{
+    return timeBudget && GetMSTimeDiffToNow(startTime) >= timeBudget;
+}
+
 void MassMailMgr::Update(bool sendall /*= false*/)
 {
     if (m_massMails.empty())
@@ -89,12 +94,17 @@ void MassMailMgr::Update(bool sendall /*= false*/)
     }
 
     uint32 maxcount = sWorld.getConfig(CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK);
+    uint32 timeBudget = sendall ? 0 : sWorld.getConfig(CONFIG_UINT32_MASS_MAILER_UPDATE_TIME_BUDGET);
+    uint32 startTime = getMSTime();
+
+    // all mails of this tick go to the DB as one transaction instead of one per mail
+    CharacterDatabase.BeginTransaction();
 
     do
     {
         MassMail& task = m_massMails.front();
 
-        while (!task.m_receivers.empty() && (sendall || maxcount > 0))
+        while (!task.m_receivers.empty() && (sendall || maxcount > 0) && !IsUpdateTimeBudgetExceeded(startTime, timeBudget))
         {
             uint32 receiver_lowguid = *task.m_receivers.begin();
             task.m_receivers.erase(task.m_receivers.begin());
@@ -133,7 +143,9 @@ void MassMailMgr::Update(bool sendall /*= false*/)
             m_massMails.pop_front();
         }
     }
-    while (!m_massMails.empty() && (sendall || maxcount > 0));
+    while (!m_massMails.empty() && (sendall || maxcount > 0) && !IsUpdateTimeBudgetExceeded(startTime, timeBudget));
+
+    CharacterDatabase.CommitTransaction();
 }
 
 void MassMailMgr::GetStatistic(uint32& tasks, uint32& mails, uint32& needTime) const
@@ -0,0 +1,171 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "MemoryUsage.h"
+#include "Map.h"
+#include "MapManager.h"
+#include "GridMap.h"
+#include "Creature.h"
+#include "Pet.h"
+#include "GameObject.h"
+#include "DynamicObject.h"
+#include "Player.h"
+#include "ObjectMgr.h"
+#include "LootMgr.h"
+#include "SQLStorages.h"
+#include "VMapFactory.h"
+#include "VMapManager2.h"
+#include "MoveMap.h"
+#include "World.h"
+#include "WorldSession.h"
+
+// entries and buckets of an unordered map, a node holds the value and the next and cached hash
+template<class C>
+static uint64 HashContainerBytes(C const& container, size_t valueSize)
+{
+    return container.size() * (valueSize + 2 * sizeof(void*)) + container.bucket_count() * sizeof(void*);
+}
+
+static void AddStorage(MemoryUsageList& entries, SQLStorageBase const& storage, uint64 indexBytes)
+{
+    entries.push_back(MemoryUsageEntry(storage.GetTableName(), storage.GetRecordCount(), storage.GetDataSize() + indexBytes));
+}
+
+void MemoryUsage::CollectMap(Map* map, MemoryUsageList& entries)
+{
+    Map::MapStoredObjectTypesContainer& store = map->GetObjectsStore();
+
+    uint64 creatures = store.size((Creature*)NULL);
+    uint64 pets = store.size((Pet*)NULL);
+    uint64 gameObjects = store.size((GameObject*)NULL);
+    uint64 dynObjects = store.size((DynamicObject*)NULL);
+    uint64 players = map->GetPlayers().getSize();
+    uint64 grids = map->GetLoadedGridCount();
+
+    entries.push_back(MemoryUsageEntry("creatures", creatures, creatures * sizeof(Creature)));
+    entries.push_back(MemoryUsageEntry("pets", pets, pets * sizeof(Pet)));
+    entries.push_back(MemoryUsageEntry("gameobjects", gameObjects, gameObjects * sizeof(GameObject)));
+    entries.push_back(MemoryUsageEntry("dynamic objects", dynObjects, dynObjects * sizeof(DynamicObject)));
+    entries.push_back(MemoryUsageEntry("players", players, players * sizeof(Player)));
+    entries.push_back(MemoryUsageEntry("grids", grids, grids * sizeof(NGridType)));
+}
+
+void MemoryUsage::Collect(MemoryUsageList& entries)
+{
+    // per map kinds summed in the order CollectMap adds them
+    MemoryUsageList mapEntries;
+    size_t kinds = 0;
+
+    MapManager::MapMapSnapshot snapshot = sMapMgr.Maps();
+    MapManager::MapMapType const& mapList = *snapshot;
+    for (MapManager::MapMapType::const_iterator itr = mapList.begin(); itr != mapList.end(); ++itr)
+    {
+        MemoryUsageList single;
+        CollectMap(itr->second, single);
+
+        if (mapEntries.empty())
+        {
+            mapEntries = single;
+            kinds = single.size();
+            continue;
+        }
+
+        for (size_t i = 0; i < kinds; ++i)
+        {
+            mapEntries[i].count += single[i].count;
+            mapEntries[i].bytes += single[i].bytes;
+        }
+    }
+
+    entries.insert(entries.end(), mapEntries.begin(), mapEntries.end());
+
+    // the cells of all maps, a grid allocates a cell with its first object
+    uint32 cells = NGridType::GetCreatedCellCount();
+    entries.push_back(MemoryUsageEntry("grid cells", cells, uint64(cells) * sizeof(GridType)));
+
+    uint32 sessions = sWorld.GetActiveSessionCount() + sWorld.GetQueuedSessionCount();
+    entries.push_back(MemoryUsageEntry("sessions", sessions, uint64(sessions) * sizeof(WorldSession)));
+
+    uint32 heapGrids, mappedGrids;
+    uint64 heapBytes, mappedBytes;
+    GridMap::GetMemoryUsage(heapGrids, heapBytes, mappedGrids, mappedBytes);
+    entries.push_back(MemoryUsageEntry("terrain grids", heapGrids, heapBytes));
+    entries.push_back(MemoryUsageEntry("terrain grids mapped", mappedGrids, mappedBytes));
+
+    if (VMAP::VMapManager2* vmmgr2 = dynamic_cast<VMAP::VMapManager2*>(VMAP::VMapFactory::createOrGetVMapManager()))
+    {
+        uint32 loaded, prefetched;
+        vmmgr2->getModelCounts(loaded, prefetched);
+        entries.push_back(MemoryUsageEntry("vmap models", loaded, 0, false));
+        entries.push_back(MemoryUsageEntry("vmap models prefetched", prefetched, 0, false));
+    }
+
+    entries.push_back(MemoryUsageEntry("mmap tiles", MMAP::MMapFactory::createOrGetMMapManager()->getLoadedTilesCount(), 0, false));
+
+    SQLStorage const* storages[] = { &sCreatureStorage, &sCreatureDataAddonStorage, &sCreatureInfoAddonStorage, &sCreatureModelStorage,
+                                     &sEquipmentStorage, &sEquipmentStorageItem, &sEquipmentStorageRaw, &sPageTextStore,
+                                     &sItemStorage, &sInstanceTemplate, &sConditionStorage };
+    for (size_t i = 0; i < countof(storages); ++i)
+    {
+        // the index has a pointer for every entry up to the highest one
+        AddStorage(entries, *storages[i], uint64(storages[i]->GetMaxEntry()) * sizeof(char*));
+    }
+
+    SQLHashStorage const* hashStorages[] = { &sGOStorage, &sCreatureTemplateSpellsStorage };
+    for (size_t i = 0; i < countof(hashStorages); ++i)
+    {
+        AddStorage(entries, *hashStorages[i], uint64(hashStorages[i]->GetRecordCount()) * (sizeof(std::pair<uint32, char*>) + 2 * sizeof(void*)));
+    }
+
+    AddStorage(entries, sSpellScriptTargetStorage, 0);
+
+    CreatureDataMap const* creatureData = sObjectMgr.GetCreatureDataMap();
+    entries.push_back(MemoryUsageEntry("creature spawns", creatureData->size(), HashContainerBytes(*creatureData, sizeof(CreatureDataMap::value_type))));
+
+    GameObjectDataMap const* goData = sObjectMgr.GetGameObjectDataMap();
+    entries.push_back(MemoryUsageEntry("gameobject spawns", goData->size(), HashContainerBytes(*goData, sizeof(GameObjectDataMap::value_type))));
+
+    ObjectMgr::QuestMap const& quests = sObjectMgr.GetQuestTemplates();
+    entries.push_back(MemoryUsageEntry("quest templates", quests.size(),
+                                       HashContainerBytes(quests, sizeof(ObjectMgr::QuestMap::value_type)) + quests.size() * sizeof(Quest)));
+
+    LootStore const* lootStores[] = { &LootTemplates_Creature, &LootTemplates_Disenchant, &LootTemplates_Fishing, &LootTemplates_Gameobject,
+                                      &LootTemplates_Item, &LootTemplates_Mail, &LootTemplates_Pickpocketing, &LootTemplates_Skinning };
+    for (size_t i = 0; i < countof(lootStores); ++i)
+    {
+        entries.push_back(MemoryUsageEntry(lootStores[i]->GetName(), lootStores[i]->GetTemplateCount(), 0, false));
+    }
+}
+
+uint64 MemoryUsage::GetTotalBytes(MemoryUsageList const& entries)
+{
+    uint64 total = 0;
+    for (MemoryUsageList::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
+    {
+        total += itr->bytes;
+    }
+
+    return total;
+}
@@ -0,0 +1,73 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_H_MEMORY_USAGE
+#define MANGOS_H_MEMORY_USAGE
+
+#include "Common.h"
+
+#include <vector>
+
+class Map;
+
+/**
+ * @brief Memory held by one kind of object or one store
+ */
+struct MemoryUsageEntry
+{
+    MemoryUsageEntry(char const* _owner, uint64 _count, uint64 _bytes, bool _sized = true)
+        : owner(_owner), count(_count), bytes(_bytes), sized(_sized) {}
+
+    char const* owner;                                      // static name, used as metrics label
+    uint64 count;
+    uint64 bytes;
+    bool sized;                                             // false if only the count is known
+};
+
+typedef std::vector<MemoryUsageEntry> MemoryUsageList;
+
+/**
+ * @brief Approximate memory of the maps and the loaded stores, for .server perf memory and the metrics
+ *
+ * Sizes are the number of entries times the size of their structure plus the
+ * container node, memory an entry owns beyond that (strings, vectors, spell
+ * auras) is not counted. The vmap models, navmesh tiles and loot templates
+ * have no cheap size and report their count only.
+ *
+ * The objects of a map are counted from another thread while it updates, the
+ * counts can be off by the objects added or removed meanwhile.
+ */
+class MemoryUsage
+{
+    public:
+        // creatures, pets, game objects, dynamic objects, players and grids of one map
+        static void CollectMap(Map* map, MemoryUsageList& entries);
+        // the objects of all maps summed per kind, then the shared stores
+        static void Collect(MemoryUsageList& entries);
+
+        static uint64 GetTotalBytes(MemoryUsageList const& entries);
+};
+
+#endif
@@ -28,6 +28,9 @@
 #include "MoveMap.h"
 #include "MoveMapSharedDefines.h"
 
+#include <ace/Guard_T.h>
+#include <ace/TSS_T.h>
+
 namespace MMAP
 {
     // ######################## MMapFactory ########################
@@ -153,6 +156,11 @@ namespace MMAP
             delete i->second;
         }
 
+        for (PrefetchedTileMap::iterator i = prefetchedTiles.begin(); i != prefetchedTiles.end(); ++i)
+        {
+            dtFree(i->second.data);
+        }
+
         // by now we should not have maps loaded
         // if we had, tiles in MMapData->mmapLoadedTiles, their actual data is lost!
     }
@@ -208,7 +216,7 @@ namespace MMAP
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMapData: Loaded %03i.mmap", mapId);
 
         // store inside our map list
-        MMapData* mmap_data = new MMapData(mesh);
+        MMapData* mmap_data = new MMapData(mesh, ++lastMeshSerial);
         mmap_data->mmapLoadedTiles.clear();
 
         loadedMMaps.insert(std::pair<uint32, MMapData*>(mapId, mmap_data));
@@ -220,26 +228,8 @@ namespace MMAP
         return uint32(x << 16 | y);
     }
 
-    bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
+    unsigned char* MMapManager::readTileFile(uint32 mapId, int32 x, int32 y, uint32& size)
     {
-        // make sure the mmap is loaded and ready to load tiles
-        if (!loadMapData(mapId))
-        {
-            return false;
-        }
-
-        // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
-        MANGOS_ASSERT(mmap->navMesh);
-
-        // check if we already have this tile loaded
-        uint32 packedGridPos = packTileID(x, y);
-        if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
-        {
-            sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. %03u%02i%02i.mmtile", mapId, x, y);
-            return false;
-        }
-
         // load this tile :: mmaps/MMMXXYY.mmtile
         uint32 pathLen = sWorld.GetDataPath().length() + strlen("mmaps/%03i%02i%02i.mmtile") + 1;
         char* fileName = new char[pathLen];
@@ -250,7 +240,7 @@ namespace MMAP
         {
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "ERROR: MMAP:loadMap: Could not open mmtile file '%s'", fileName);
             delete[] fileName;
-            return false;
+            return NULL;
         }
         delete[] fileName;
 
@@ -262,14 +252,14 @@ namespace MMAP
         {
             sLog.outError("MMAP:loadMap: Could not load mmap %03u%02i%02i.mmtile", mapId, x, y);
             fclose(file);
-            return false;
+            return NULL;
         }
 
         if (fileHeader.mmapMagic != MMAP_MAGIC)
         {
             sLog.outError("MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
             fclose(file);
-            return false;
+            return NULL;
         }
 
         if (fileHeader.mmapVersion != MMAP_VERSION)
@@ -277,7 +267,7 @@ namespace MMAP
             sLog.outError("MMAP:loadMap: %03u%02i%02i.mmtile was built with generator v%i, expected v%i",
                           mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
             fclose(file);
-            return false;
+            return NULL;
         }
 
         unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
@@ -287,17 +277,109 @@ namespace MMAP
         if (!result)
         {
             sLog.outError("MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
+            dtFree(data);
             fclose(file);
-            return false;
+            return NULL;
         }
 
         fclose(file);
 
+        size = fileHeader.size;
+        return data;
+    }
+
+    void MMapManager::prefetchTile(uint32 mapId, int32 x, int32 y)
+    {
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, prefetchLock);
+            if (prefetchedTiles.find(packPrefetchID(mapId, x, y)) != prefetchedTiles.end())
+            {
+                return;
+            }
+        }
+
+        PrefetchedTile tile;
+        tile.data = readTileFile(mapId, x, y, tile.size);
+        if (!tile.data)
+        {
+            return;
+        }
+        tile.readTime = getMSTime();
+
+        ACE_GUARD(ACE_Thread_Mutex, guard, prefetchLock);
+        if (!prefetchedTiles.insert(PrefetchedTileMap::value_type(packPrefetchID(mapId, x, y), tile)).second)
+        {
+            dtFree(tile.data);
+        }
+    }
+
+    void MMapManager::dropPrefetchedTiles(uint32 maxAge)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, prefetchLock);
+
+        uint32 now = getMSTime();
+        for (PrefetchedTileMap::iterator itr = prefetchedTiles.begin(); itr != prefetchedTiles.end();)
+        {
+            if (getMSTimeDiff(itr->second.readTime, now) > maxAge)
+            {
+                dtFree(itr->second.data);
+                prefetchedTiles.erase(itr++);
+            }
+            else
+            {
+                ++itr;
+            }
+        }
+    }
+
+    bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
+    {
+        // make sure the mmap is loaded and ready to load tiles
+        if (!loadMapData(mapId))
+        {
+            return false;
+        }
+
+        // get this mmap data
+        MMapData* mmap = loadedMMaps[mapId];
+        MANGOS_ASSERT(mmap->navMesh);
+
+        // check if we already have this tile loaded
+        uint32 packedGridPos = packTileID(x, y);
+        if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
+        {
+            sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. %03u%02i%02i.mmtile", mapId, x, y);
+            return false;
+        }
+
+        // the tile file may have been read ahead by prefetchTile already
+        uint32 dataSize = 0;
+        unsigned char* data = NULL;
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, prefetchLock, false);
+            PrefetchedTileMap::iterator prefetched = prefetchedTiles.find(packPrefetchID(mapId, x, y));
+            if (prefetched != prefetchedTiles.end())
+            {
+                data = prefetched->second.data;
+                dataSize = prefetched->second.size;
+                prefetchedTiles.erase(prefetched);
+            }
+        }
+
+        if (!data)
+        {
+            data = readTileFile(mapId, x, y, dataSize);
+            if (!data)
+            {
+                return false;
+            }
+        }
+
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
+        dtStatus dtResult = mmap->navMesh->addTile(data, dataSize, DT_TILE_FREE_DATA, 0, &tileRef);
         if (dtStatusFailed(dtResult))
         {
             sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
@@ -389,67 +471,90 @@ namespace MMAP
         return true;
     }
 
-    bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
+    dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
-        // check if we have this map loaded
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
-            // file may not exist, therefore not loaded
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %03u", mapId);
-            return false;
+            return NULL;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-        {
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
-            return false;
-        }
+        return loadedMMaps[mapId]->navMesh;
+    }
 
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
+    /**
+     * Navmesh queries of one thread, one per map id.
+     *
+     * dtNavMeshQuery keeps its search state in the object, so every thread
+     * running path finding needs its own; a query borrowed for one map keeps
+     * its node pool and is only pointed at a new mesh when the map's navmesh
+     * was unloaded and loaded again.
+     */
+    class NavMeshQueryCache
+    {
+        public:
+            struct Entry
+            {
+                Entry() : serial(0), query(NULL) {}
 
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
+                uint32 serial;
+                dtNavMeshQuery* query;
+            };
 
-        return true;
+            ~NavMeshQueryCache()
+            {
+                for (UNORDERED_MAP<uint32, Entry>::iterator i = m_queries.begin(); i != m_queries.end(); ++i)
+                {
+                    dtFreeNavMeshQuery(i->second.query);
+                }
+            }
+
+            Entry& Get(uint32 mapId) { return m_queries[mapId]; }
+
+        private:
+            UNORDERED_MAP<uint32, Entry> m_queries;
+    };
+
+    static NavMeshQueryCache* GetNavMeshQueryCache()
+    {
+        // never destroyed, the per thread caches are released by ACE when their thread exits
+        static ACE_TSS<NavMeshQueryCache>* cache = new ACE_TSS<NavMeshQueryCache>();
+        return *cache;
     }
 
-    dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
+    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
         {
             return NULL;
         }
 
-        return loadedMMaps[mapId]->navMesh;
-    }
-
-    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
-    {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = itr->second;
+        NavMeshQueryCache::Entry& entry = GetNavMeshQueryCache()->Get(mapId);
+        if (entry.query && entry.serial == mmap->serial)
         {
-            return NULL;
+            return entry.query;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        if (!entry.query)
         {
             // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            MANGOS_ASSERT(query);
-            dtStatus dtResult = query->init(mmap->navMesh, 1024);
-            if (dtStatusFailed(dtResult))
-            {
-                dtFreeNavMeshQuery(query);
-                sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-                return NULL;
-            }
+            entry.query = dtAllocNavMeshQuery();
+            MANGOS_ASSERT(entry.query);
+        }
 
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
+        // keeps the node pool of a query made for an earlier mesh of the map
+        dtStatus dtResult = entry.query->init(mmap->navMesh, 1024);
+        if (dtStatusFailed(dtResult))
+        {
+            dtFreeNavMeshQuery(entry.query);
+            entry.query = NULL;
+            sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u", mapId);
+            return NULL;
         }
 
-        return mmap->navMeshQueries[instanceId];
+        entry.serial = mmap->serial;
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u", mapId);
+        return entry.query;
     }
 }
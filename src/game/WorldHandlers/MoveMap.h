@@ -32,6 +32,8 @@
 #include "Platform/Define.h"
 #include "Utilities/UnorderedMapSet.h"
 
+#include <ace/Thread_Mutex.h>
+
 class Unit;
 
 //  memory management
@@ -49,50 +51,57 @@ inline void dtCustomFree(void* ptr)
 namespace MMAP
 {
     typedef UNORDERED_MAP<uint32, dtTileRef> MMapTileSet;
-    typedef UNORDERED_MAP<uint32, dtNavMeshQuery*> NavMeshQuerySet;
 
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapData(dtNavMesh* mesh, uint32 meshSerial) : navMesh(mesh), serial(meshSerial) {}
         ~MMapData()
         {
-            for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
-            {
-                dtFreeNavMeshQuery(i->second);
-            }
-
             if (navMesh)
             {
                 dtFreeNavMesh(navMesh);
             }
         }
 
+        // one navmesh per map id, shared by all instances of the map
         dtNavMesh* navMesh;
-
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        // unique per created navmesh, per thread queries made for an unloaded mesh of the same map id are reinitialized
+        uint32 serial;
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
     };
 
 
     typedef UNORDERED_MAP<uint32, MMapData*> MMapDataSet;
 
+    // tile file read ahead of loadMap, the data is owned by the map until detour takes it
+    struct PrefetchedTile
+    {
+        unsigned char* data;
+        uint32 size;
+        uint32 readTime;
+    };
+
+    typedef UNORDERED_MAP<uint64, PrefetchedTile> PrefetchedTileMap;
+
     // singelton class
     // holds all all access to mmap loading unloading and meshes
     class MMapManager
     {
         public:
-            MMapManager() : loadedTiles(0) {}
+            MMapManager() : loadedTiles(0), lastMeshSerial(0) {}
             ~MMapManager();
 
             bool loadMap(uint32 mapId, int32 x, int32 y);
+            // read a tile file for a later loadMap, may be called from any thread
+            void prefetchTile(uint32 mapId, int32 x, int32 y);
+            // free prefetched tiles no loadMap used within maxAge milliseconds
+            void dropPrefetchedTiles(uint32 maxAge);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
-            bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
-            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // the returned [dtNavMeshQuery const*] belongs to the calling thread, don't keep it beyond the current update
+            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
@@ -100,9 +109,15 @@ namespace MMAP
         private:
             bool loadMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
+            static uint64 packPrefetchID(uint32 mapId, int32 x, int32 y) { return uint64(mapId) << 32 | uint32(x << 16 | y); }
+            static unsigned char* readTileFile(uint32 mapId, int32 x, int32 y, uint32& size);
 
             MMapDataSet loadedMMaps;
             uint32 loadedTiles;
+            uint32 lastMeshSerial;
+
+            ACE_Thread_Mutex prefetchLock;
+            PrefetchedTileMap prefetchedTiles;
     };
 
     // static class
@@ -0,0 +1,134 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "MovementCoalescer.h"
+#include "Player.h"
+#include "World.h"
+#include "Timer.h"
+
+bool MovementCoalescer::IsReplaceable(uint16 opcode)
+{
+    switch (opcode)
+    {
+        case MSG_MOVE_HEARTBEAT:
+        case MSG_MOVE_SET_FACING:
+        case MSG_MOVE_SET_PITCH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+MovementCoalescer::MoverState* MovementCoalescer::FindState(ObjectGuid const& mover)
+{
+    for (std::vector<MoverState>::iterator itr = m_movers.begin(); itr != m_movers.end(); ++itr)
+    {
+        if (itr->mover == mover)
+        {
+            return &*itr;
+        }
+    }
+
+    return NULL;
+}
+
+void MovementCoalescer::Relay(Player* observer, WorldObject const* mover, WorldPacket const* packet, SharedWorldPacket& shared)
+{
+    uint32 now = getTickMSTime();
+    MoverState* state = FindState(mover->GetObjectGuid());
+
+    if (IsReplaceable(packet->GetOpcode()))
+    {
+        uint32 window = sWorld.getConfig(CONFIG_UINT32_MOVEMENT_COALESCE_WINDOW);
+        if (!observer->IsWithinDist(mover, sWorld.getConfig(CONFIG_FLOAT_MOVEMENT_COALESCE_FAR_DISTANCE)))
+        {
+            window = std::max(window, sWorld.getConfig(CONFIG_UINT32_MOVEMENT_COALESCE_FAR_WINDOW));
+        }
+
+        if (state && getMSTimeDiff(state->lastSent, now) < window)
+        {
+            // keep only the latest state, it goes out when the window of the last send ends
+            state->pending = *packet;
+            state->dueTime = state->lastSent + window;
+            state->hasPending = true;
+            return;
+        }
+    }
+
+    if (!state)
+    {
+        m_movers.resize(m_movers.size() + 1);
+        state = &m_movers.back();
+        state->mover = mover->GetObjectGuid();
+    }
+
+    // anything else replaces a waiting state update of the same mover
+    state->hasPending = false;
+    state->pending.clear();
+    state->lastSent = now;
+
+    if (WorldSession* session = observer->GetSession())
+    {
+        session->SendPacket(packet, shared);
+    }
+}
+
+void MovementCoalescer::Update(Player* observer)
+{
+    if (m_movers.empty())
+    {
+        return;
+    }
+
+    uint32 now = getTickMSTime();
+    uint32 idleTime = std::max(sWorld.getConfig(CONFIG_UINT32_MOVEMENT_COALESCE_WINDOW), sWorld.getConfig(CONFIG_UINT32_MOVEMENT_COALESCE_FAR_WINDOW));
+
+    for (size_t i = 0; i < m_movers.size();)
+    {
+        MoverState& state = m_movers[i];
+
+        if (state.hasPending && int32(now - state.dueTime) >= 0)
+        {
+            // the mover may have left the observer's sight meanwhile
+            if (observer->m_clientGUIDs.find(state.mover) != observer->m_clientGUIDs.end())
+            {
+                observer->GetSession()->SendPacket(&state.pending);
+            }
+
+            state.hasPending = false;
+            state.pending.clear();
+            state.lastSent = now;
+        }
+
+        // forget movers that stopped sending, their next packet goes out at once
+        if (!state.hasPending && getMSTimeDiff(state.lastSent, now) > idleTime)
+        {
+            state = m_movers.back();
+            m_movers.pop_back();
+            continue;
+        }
+
+        ++i;
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_MOVEMENT_COALESCER
+#define MANGOS_H_MOVEMENT_COALESCER
+
+#include "Common.h"
+#include "ObjectGuid.h"
+#include "WorldPacket.h"
+
+#include <vector>
+
+class Player;
+class WorldObject;
+
+/**
+ * Rate shaping of the movement packets relayed to one observing player.
+ *
+ * Packets that only refresh a mover's state (heartbeat, facing, pitch) are
+ * sent at most once per window for each mover, a packet arriving earlier
+ * replaces the one waiting so only the latest state goes out. Observers
+ * farther than MovementCoalesce.FarDistance use the longer far window.
+ * Any other movement opcode (start, stop, jump, ...) is sent at once and
+ * drops the waiting state of its mover. Waiting packets are flushed by
+ * Update() from the observer's Player::Update, so they leave together.
+ */
+class MovementCoalescer
+{
+    public:
+        // opcodes that carry nothing but the mover's current state
+        static bool IsReplaceable(uint16 opcode);
+
+        void Relay(Player* observer, WorldObject const* mover, WorldPacket const* packet, SharedWorldPacket& shared);
+        void Update(Player* observer);
+        void Clear() { m_movers.clear(); }
+
+    private:
+        struct MoverState
+        {
+            ObjectGuid mover;
+            uint32 lastSent;
+            uint32 dueTime;
+            bool hasPending;
+            WorldPacket pending;
+        };
+
+        MoverState* FindState(ObjectGuid const& mover);
+
+        std::vector<MoverState> m_movers;
+};
+
+#endif
@@ -34,6 +34,9 @@
 #include "WaypointMovementGenerator.h"
 #include "MapPersistentStateMgr.h"
 #include "ObjectMgr.h"
+#include "World.h"
+#include "CellImpl.h"
+#include "GridNotifiersImpl.h"
 
 #define MOVEMENT_PACKET_TIME_DELAY 300
 
@@ -313,7 +316,16 @@ void WorldSession::HandleMovementOpcodes(WorldPacket& recv_data)
     WorldPacket data(opcode, uint16(recv_data.size() + 2));
     data << mover->GetPackGUID();             // write guid
     movementInfo.Write(data);                               // write data
-    mover->SendMessageToSetExcept(&data, _player);
+
+    if (sWorld.getConfig(CONFIG_UINT32_MOVEMENT_COALESCE_WINDOW))
+    {
+        MaNGOS::MovementMessageDeliverer notifier(*mover, &data, _player);
+        Cell::VisitWorldObjects(mover, notifier, mover->GetMap()->GetVisibilityDistance());
+    }
+    else
+    {
+        mover->SendMessageToSetExcept(&data, _player);
+    }
 }
 
 void WorldSession::HandleForceSpeedChangeAckOpcodes(WorldPacket& recv_data)
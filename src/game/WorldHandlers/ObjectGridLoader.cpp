@@ -111,15 +111,20 @@ template<> void addUnitState(Creature* obj, CellPair const& cell_pair)
     obj->SetCurrentCell(cell);
 }
 
-template <class T>
-void LoadHelper(CellGuidSet const& guid_set, CellPair& cell, GridRefManager<T>& /*m*/, uint32& count, Map* map, GridType& grid)
+template <class T, class GuidIterator>
+void LoadHelper(GuidIterator begin, GuidIterator end, CellGuidSet const* hidden, CellPair& cell, uint32& count, Map* map, GridType& grid)
 {
     BattleGround* bg = map->IsBattleGround() ? ((BattleGroundMap*)map)->GetBG() : nullptr;
 
-    for (CellGuidSet::const_iterator i_guid = guid_set.begin(); i_guid != guid_set.end(); ++i_guid)
+    for (GuidIterator i_guid = begin; i_guid != end; ++i_guid)
     {
         uint32 guid = *i_guid;
 
+        if (hidden && hidden->find(guid) != hidden->end())
+        {
+            continue;
+        }
+
         T* obj = new T;
         // sLog.outString("DEBUG: LoadHelper from table: %s for (guid: %u) Loading",table,guid);
         if (!obj->LoadFromDB(guid, map))
@@ -149,6 +154,18 @@ void LoadHelper(CellGuidSet const& guid_set, CellPair& cell, GridRefManager<T>&
     }
 }
 
+template <class T>
+void LoadHelper(CellGuidRange const& guids, CellGuidSet const& hidden, CellPair& cell, GridRefManager<T>& /*m*/, uint32& count, Map* map, GridType& grid)
+{
+    LoadHelper<T>(guids.first, guids.second, hidden.empty() ? NULL : &hidden, cell, count, map, grid);
+}
+
+template <class T>
+void LoadHelper(CellGuidSet const& guid_set, CellPair& cell, GridRefManager<T>& /*m*/, uint32& count, Map* map, GridType& grid)
+{
+    LoadHelper<T>(guid_set.begin(), guid_set.end(), NULL, cell, count, map, grid);
+}
+
 void LoadHelper(CellCorpseSet const& cell_corpses, CellPair& cell, CorpseMapType& /*m*/, uint32& count, Map* map, GridType& grid)
 {
     if (cell_corpses.empty())
@@ -196,6 +213,7 @@ ObjectGridLoader::Visit(GameObjectMapType& m)
     CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), cell_id);
 
     GridType& grid = (*i_map->getNGrid(i_cell.GridX(), i_cell.GridY()))(i_cell.CellX(), i_cell.CellY());
+    LoadHelper(sObjectMgr.GetCellStaticGameobjectGuids(i_map->GetId(), cell_id), cell_guids.hiddenGameobjects, cell_pair, m, i_gameObjects, i_map, grid);
     LoadHelper(cell_guids.gameobjects, cell_pair, m, i_gameObjects, i_map, grid);
     LoadHelper(i_map->GetPersistentState()->GetCellObjectGuids(cell_id).gameobjects, cell_pair, m, i_gameObjects, i_map, grid);
 }
@@ -211,6 +229,7 @@ ObjectGridLoader::Visit(CreatureMapType& m)
     CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), cell_id);
 
     GridType& grid = (*i_map->getNGrid(i_cell.GridX(), i_cell.GridY()))(i_cell.CellX(), i_cell.CellY());
+    LoadHelper(sObjectMgr.GetCellStaticCreatureGuids(i_map->GetId(), cell_id), cell_guids.hiddenCreatures, cell_pair, m, i_creatures, i_map, grid);
     LoadHelper(cell_guids.creatures, cell_pair, m, i_creatures, i_map, grid);
     LoadHelper(i_map->GetPersistentState()->GetCellObjectGuids(cell_id).creatures, cell_pair, m, i_creatures, i_map, grid);
 }
@@ -245,6 +264,29 @@ ObjectGridLoader::Load(GridType& grid)
     }
 }
 
+bool ObjectGridLoader::HasObjectsToLoad(uint32 cell_x, uint32 cell_y) const
+{
+    uint32 x = (i_cell.GridX() * MAX_NUMBER_OF_CELLS) + cell_x;
+    uint32 y = (i_cell.GridY() * MAX_NUMBER_OF_CELLS) + cell_y;
+    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+
+    CellGuidRange staticCreatures = sObjectMgr.GetCellStaticCreatureGuids(i_map->GetId(), cell_id);
+    CellGuidRange staticGameobjects = sObjectMgr.GetCellStaticGameobjectGuids(i_map->GetId(), cell_id);
+    if (staticCreatures.first != staticCreatures.second || staticGameobjects.first != staticGameobjects.second)
+    {
+        return true;
+    }
+
+    CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), cell_id);
+    if (!cell_guids.creatures.empty() || !cell_guids.gameobjects.empty() || !cell_guids.corpses.empty())
+    {
+        return true;
+    }
+
+    MapCellObjectGuids const& state_guids = i_map->GetPersistentState()->GetCellObjectGuids(cell_id);
+    return !state_guids.creatures.empty() || !state_guids.gameobjects.empty();
+}
+
 void ObjectGridLoader::LoadN(void)
 {
     i_gameObjects = 0; i_creatures = 0; i_corpses = 0;
@@ -257,7 +299,10 @@ void ObjectGridLoader::LoadN(void)
         for (unsigned int y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
         {
             i_cell.data.Part.cell_y = y;
-            loader.Load(i_grid(x, y), *this);
+            if (HasObjectsToLoad(x, y))
+            {
+                loader.Load(i_grid(x, y), *this);
+            }
         }
     }
     DEBUG_LOG("%u GameObjects, %u Creatures, and %u Corpses/Bones loaded for grid %u on map %u", i_gameObjects, i_creatures, i_corpses, i_grid.GetGridId(), i_map->GetId());
@@ -269,8 +314,11 @@ void ObjectGridUnloader::MoveToRespawnN()
     {
         for (unsigned int y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
         {
-            ObjectGridRespawnMover mover;
-            mover.Move(i_grid(x, y));
+            if (GridType* cell = i_grid.getCellIfCreated(x, y))
+            {
+                ObjectGridRespawnMover mover;
+                mover.Move(*cell);
+            }
         }
     }
 }
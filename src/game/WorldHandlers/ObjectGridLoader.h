@@ -54,6 +54,9 @@ class ObjectGridLoader
         void LoadN(void);
 
     private:
+        // the cell has spawns or corpses, other cells are not allocated at loading
+        bool HasObjectsToLoad(uint32 cell_x, uint32 cell_y) const;
+
         Cell i_cell;
         NGridType& i_grid;
         Map* i_map;
@@ -75,7 +78,10 @@ class ObjectGridUnloader
             {
                 for (unsigned int y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
                 {
-                    loader.Unload(i_grid(x, y), *this);
+                    if (GridType* cell = i_grid.getCellIfCreated(x, y))
+                    {
+                        loader.Unload(*cell, *this);
+                    }
                 }
             }
         }
@@ -98,7 +104,10 @@ class ObjectGridStoper
             {
                 for (unsigned int y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
                 {
-                    loader.Stop(i_grid(x, y), *this);
+                    if (GridType* cell = i_grid.getCellIfCreated(x, y))
+                    {
+                        loader.Stop(*cell, *this);
+                    }
                 }
             }
         }
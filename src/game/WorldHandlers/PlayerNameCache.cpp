@@ -0,0 +1,214 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "PlayerNameCache.h"
+#include "Database/DatabaseEnv.h"
+#include "ObjectGuid.h"
+#include "Opcodes.h"
+#include "World.h"
+#include "Log.h"
+#include "ProgressBar.h"
+
+#include <ace/Guard_T.h>
+
+INSTANTIATE_SINGLETON_1(PlayerNameCache);
+
+void PlayerNameCache::Load()
+{
+    if (!sWorld.getConfig(CONFIG_BOOL_PLAYER_NAME_CACHE))
+    {
+        sLog.outString(">> Player name cache disabled, name queries of offline characters read the database");
+        sLog.outString();
+        return;
+    }
+
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+
+    m_entries.clear();
+
+    //                                                    0       1       2       3         4
+    QueryResult* result = CharacterDatabase.Query("SELECT `guid`, `name`, `race`, `gender`, `class` FROM `characters`");
+    if (!result)
+    {
+        BarGoLink bar(1);
+        bar.step();
+
+        m_loaded = true;
+        sLog.outString(">> Loaded 0 player names");
+        sLog.outString();
+        return;
+    }
+
+    BarGoLink bar(result->GetRowCount());
+    m_entries.reserve(size_t(result->GetRowCount()));
+
+    do
+    {
+        bar.step();
+
+        Field* fields = result->Fetch();
+
+        Entry& entry = m_entries[fields[0].GetUInt32()];
+        entry.name = fields[1].GetCppString();
+        entry.race = fields[2].GetUInt8();
+        entry.gender = fields[3].GetUInt8();
+        entry.playerClass = fields[4].GetUInt8();
+    }
+    while (result->NextRow());
+
+    delete result;
+
+    m_loaded = true;
+    sLog.outString(">> Loaded " SIZEFMTD " player names", m_entries.size());
+    sLog.outString();
+}
+
+void PlayerNameCache::BuildNameQueryResponse(uint32 lowguid, Entry const& entry, WorldPacket& data)
+{
+    data.Initialize(SMSG_NAME_QUERY_RESPONSE, 8 + (entry.name.size() + 1) + 1 + 4 + 4 + 4);
+    data << ObjectGuid(HIGHGUID_PLAYER, lowguid);
+    data << entry.name;
+    data << uint8(0);                                       // realm name for cross realm BG usage
+
+    // a character in the deleted list is answered as by its database row
+    if (entry.name.empty())
+    {
+        data << uint32(0) << uint32(0) << uint32(0);
+        return;
+    }
+
+    data << uint32(entry.race);
+    data << uint32(entry.gender);
+    data << uint32(entry.playerClass);
+}
+
+SharedWorldPacket PlayerNameCache::GetNameQueryResponse(uint32 lowguid)
+{
+    Entry entry;
+    {
+        ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_lock, SharedWorldPacket());
+
+        EntryMap::const_iterator itr = m_entries.find(lowguid);
+        if (itr == m_entries.end())
+        {
+            return SharedWorldPacket();
+        }
+
+        if (itr->second.response)
+        {
+            return itr->second.response;
+        }
+
+        entry = itr->second;
+    }
+
+    WorldPacket data;
+    BuildNameQueryResponse(lowguid, entry, data);
+    SharedWorldPacket response = std::make_shared<WorldPacket const>(data);
+
+    ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_lock, response);
+
+    // keep it only if the character was not renamed or deleted meanwhile
+    EntryMap::iterator itr = m_entries.find(lowguid);
+    if (itr != m_entries.end() && !itr->second.response && itr->second.name == entry.name)
+    {
+        itr->second.response = response;
+    }
+
+    return response;
+}
+
+bool PlayerNameCache::GetName(uint32 lowguid, std::string& name) const
+{
+    ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_lock, false);
+
+    EntryMap::const_iterator itr = m_entries.find(lowguid);
+    if (itr == m_entries.end())
+    {
+        return false;
+    }
+
+    name = itr->second.name;
+    return true;
+}
+
+void PlayerNameCache::Add(uint32 lowguid, std::string const& name, uint8 race, uint8 gender, uint8 playerClass)
+{
+    if (!m_loaded)
+    {
+        return;
+    }
+
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+
+    Entry& entry = m_entries[lowguid];
+    entry.name = name;
+    entry.race = race;
+    entry.gender = gender;
+    entry.playerClass = playerClass;
+    entry.response.reset();
+}
+
+void PlayerNameCache::Rename(uint32 lowguid, std::string const& name)
+{
+    if (!m_loaded)
+    {
+        return;
+    }
+
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+
+    EntryMap::iterator itr = m_entries.find(lowguid);
+    if (itr == m_entries.end())
+    {
+        sLog.outError("PlayerNameCache: rename of unknown character %u to %s", lowguid, name.c_str());
+        return;
+    }
+
+    itr->second.name = name;
+    itr->second.response.reset();
+}
+
+void PlayerNameCache::Remove(uint32 lowguid, bool unlink)
+{
+    if (!m_loaded)
+    {
+        return;
+    }
+
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+
+    if (!unlink)
+    {
+        m_entries.erase(lowguid);
+        return;
+    }
+
+    EntryMap::iterator itr = m_entries.find(lowguid);
+    if (itr != m_entries.end())
+    {
+        itr->second.name.clear();
+        itr->second.response.reset();
+    }
+}
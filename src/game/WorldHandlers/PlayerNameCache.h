@@ -0,0 +1,128 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_PLAYER_NAME_CACHE
+#define MANGOS_H_PLAYER_NAME_CACHE
+
+#include <ace/RW_Thread_Mutex.h>
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "WorldPacket.h"
+
+/**
+ * @brief Name, race, gender and class of every character, for the name queries
+ *
+ * Loaded from the characters table at server start (PlayerNameCache in mangosd.conf)
+ * and kept up to date by character creation, rename, deletion, restore and player dump
+ * loading, so that CMSG_NAME_QUERY never waits for the database, also for offline
+ * characters. The SMSG_NAME_QUERY_RESPONSE of a character is built on its first query
+ * and then shared by all sessions asking for it. The name queries are handled on the
+ * network threads as well, hence the lock.
+ */
+class PlayerNameCache
+{
+    public:
+        PlayerNameCache() : m_loaded(false) {}
+
+        /**
+         * @brief Reads all characters, if enabled in the config
+         *
+         */
+        void Load();
+
+        /**
+         * @brief Whether the characters were loaded, only then the cache answers for all of them
+         *
+         * @return bool
+         */
+        bool IsLoaded() const { return m_loaded; }
+
+        /**
+         * @brief Returns the name query response of a character
+         *
+         * @param lowguid
+         * @return SharedWorldPacket NULL for an unknown character
+         */
+        SharedWorldPacket GetNameQueryResponse(uint32 lowguid);
+
+        /**
+         * @brief Returns the name of a character
+         *
+         * @param lowguid
+         * @param name empty for a character deleted into the deleted list
+         * @return bool false for an unknown character
+         */
+        bool GetName(uint32 lowguid, std::string& name) const;
+
+        /**
+         * @brief Adds a created or loaded character
+         *
+         * @param lowguid
+         * @param name
+         * @param race
+         * @param gender
+         * @param playerClass
+         */
+        void Add(uint32 lowguid, std::string const& name, uint8 race, uint8 gender, uint8 playerClass);
+
+        /**
+         * @brief Sets the name of a character, after a rename or a restore from the deleted list
+         *
+         * @param lowguid
+         * @param name
+         */
+        void Rename(uint32 lowguid, std::string const& name);
+
+        /**
+         * @brief Forgets a deleted character
+         *
+         * @param lowguid
+         * @param unlink true if the character is only moved into the deleted list, it keeps
+         *        its data then, answered like the database row with an empty name
+         */
+        void Remove(uint32 lowguid, bool unlink);
+
+    private:
+        struct Entry
+        {
+            std::string name;
+            uint8 race;
+            uint8 gender;
+            uint8 playerClass;
+            SharedWorldPacket response;                     ///< built on the first query
+        };
+
+        typedef UNORDERED_MAP<uint32, Entry> EntryMap;
+
+        static void BuildNameQueryResponse(uint32 lowguid, Entry const& entry, WorldPacket& data);
+
+        mutable ACE_RW_Thread_Mutex m_lock;
+        EntryMap m_entries;
+        bool m_loaded;
+};
+
+#define sPlayerNameCache MaNGOS::Singleton<PlayerNameCache>::Instance()
+
+#endif
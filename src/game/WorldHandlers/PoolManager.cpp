@@ -39,57 +39,101 @@ INSTANTIATE_SINGLETON_1(PoolManager);
 // Method that tell amount spawned objects/subpools
 uint32 SpawnedPoolData::GetSpawnedObjects(uint32 pool_id) const
 {
-    SpawnedPoolPools::const_iterator itr = mSpawnedPools.find(pool_id);
-    return itr != mSpawnedPools.end() ? itr->second : 0;
+    return pool_id < m_spawnedCounts.size() ? m_spawnedCounts[pool_id] : 0;
+}
+
+void SpawnedPoolData::SetBit(std::vector<bool>& bits, uint32 index, bool value)
+{
+    if (index >= bits.size())
+    {
+        if (!value || index == POOL_NO_SPAWN_INDEX)
+        {
+            return;
+        }
+
+        bits.resize(index + 1, false);
+    }
+
+    bits[index] = value;
+}
+
+// Counter of a pool, any change to it also lists the pool as spawned
+uint32& SpawnedPoolData::SpawnedCount(uint32 pool_id)
+{
+    if (pool_id >= m_spawnedCounts.size())
+    {
+        m_spawnedCounts.resize(pool_id + 1, 0);
+    }
+
+    SetBit(m_spawnedPools, pool_id, true);
+    return m_spawnedCounts[pool_id];
 }
 
 // Method that tell if a creature is spawned currently
 template<>
 bool SpawnedPoolData::IsSpawnedObject<Creature>(uint32 db_guid) const
 {
-    return mSpawnedCreatures.find(db_guid) != mSpawnedCreatures.end();
+    return TestBit(m_spawnedCreatures, sPoolMgr.GetSpawnIndex<Creature>(db_guid));
 }
 
 // Method that tell if a gameobject is spawned currently
 template<>
 bool SpawnedPoolData::IsSpawnedObject<GameObject>(uint32 db_guid) const
 {
-    return mSpawnedGameobjects.find(db_guid) != mSpawnedGameobjects.end();
+    return TestBit(m_spawnedGameobjects, sPoolMgr.GetSpawnIndex<GameObject>(db_guid));
 }
 
 // Method that tell if a pool is spawned currently
 template<>
 bool SpawnedPoolData::IsSpawnedObject<Pool>(uint32 sub_pool_id) const
 {
-    return mSpawnedPools.find(sub_pool_id) != mSpawnedPools.end();
+    return TestBit(m_spawnedPools, sub_pool_id);
 }
 
 template<>
-void SpawnedPoolData::AddSpawn<Creature>(uint32 db_guid, uint32 pool_id)
+bool SpawnedPoolData::IsSpawnedObject<Creature>(PoolObject const& obj) const
 {
-    mSpawnedCreatures.insert(db_guid);
-    ++mSpawnedPools[pool_id];
+    return TestBit(m_spawnedCreatures, obj.spawnIndex);
 }
 
 template<>
-void SpawnedPoolData::AddSpawn<GameObject>(uint32 db_guid, uint32 pool_id)
+bool SpawnedPoolData::IsSpawnedObject<GameObject>(PoolObject const& obj) const
 {
-    mSpawnedGameobjects.insert(db_guid);
-    ++mSpawnedPools[pool_id];
+    return TestBit(m_spawnedGameobjects, obj.spawnIndex);
 }
 
 template<>
-void SpawnedPoolData::AddSpawn<Pool>(uint32 sub_pool_id, uint32 pool_id)
+bool SpawnedPoolData::IsSpawnedObject<Pool>(PoolObject const& obj) const
 {
-    mSpawnedPools[sub_pool_id] = 0;
-    ++mSpawnedPools[pool_id];
+    return TestBit(m_spawnedPools, obj.guid);
 }
 
 template<>
-void SpawnedPoolData::RemoveSpawn<Creature>(uint32 db_guid, uint32 pool_id)
+void SpawnedPoolData::AddSpawn<Creature>(PoolObject const& obj, uint32 pool_id)
 {
-    mSpawnedCreatures.erase(db_guid);
-    uint32& val = mSpawnedPools[pool_id];
+    SetBit(m_spawnedCreatures, obj.spawnIndex, true);
+    ++SpawnedCount(pool_id);
+}
+
+template<>
+void SpawnedPoolData::AddSpawn<GameObject>(PoolObject const& obj, uint32 pool_id)
+{
+    SetBit(m_spawnedGameobjects, obj.spawnIndex, true);
+    ++SpawnedCount(pool_id);
+}
+
+template<>
+void SpawnedPoolData::AddSpawn<Pool>(PoolObject const& obj, uint32 pool_id)
+{
+    SpawnedCount(obj.guid) = 0;
+    ++SpawnedCount(pool_id);
+}
+
+template<>
+void SpawnedPoolData::RemoveSpawn<Creature>(PoolObject const& obj, uint32 pool_id)
+{
+    SetBit(m_spawnedCreatures, obj.spawnIndex, false);
+    uint32& val = SpawnedCount(pool_id);
     if (val > 0)
     {
         --val;
@@ -97,10 +141,10 @@ void SpawnedPoolData::RemoveSpawn<Creature>(uint32 db_guid, uint32 pool_id)
 }
 
 template<>
-void SpawnedPoolData::RemoveSpawn<GameObject>(uint32 db_guid, uint32 pool_id)
+void SpawnedPoolData::RemoveSpawn<GameObject>(PoolObject const& obj, uint32 pool_id)
 {
-    mSpawnedGameobjects.erase(db_guid);
-    uint32& val = mSpawnedPools[pool_id];
+    SetBit(m_spawnedGameobjects, obj.spawnIndex, false);
+    uint32& val = SpawnedCount(pool_id);
     if (val > 0)
     {
         --val;
@@ -108,16 +152,41 @@ void SpawnedPoolData::RemoveSpawn<GameObject>(uint32 db_guid, uint32 pool_id)
 }
 
 template<>
-void SpawnedPoolData::RemoveSpawn<Pool>(uint32 sub_pool_id, uint32 pool_id)
+void SpawnedPoolData::RemoveSpawn<Pool>(PoolObject const& obj, uint32 pool_id)
 {
-    mSpawnedPools.erase(sub_pool_id);
-    uint32& val = mSpawnedPools[pool_id];
+    SetBit(m_spawnedPools, obj.guid, false);
+    if (obj.guid < m_spawnedCounts.size())
+    {
+        m_spawnedCounts[obj.guid] = 0;
+    }
+
+    uint32& val = SpawnedCount(pool_id);
     if (val > 0)
     {
         --val;
     }
 }
 
+template<>
+void SpawnedPoolData::GetSpawnedGuids<Creature>(SpawnedPoolObjects& guids) const
+{
+    for (uint32 index = 0; index < m_spawnedCreatures.size(); ++index)
+        if (m_spawnedCreatures[index])
+        {
+            guids.push_back(sPoolMgr.GetSpawnIndexGuid<Creature>(index));
+        }
+}
+
+template<>
+void SpawnedPoolData::GetSpawnedGuids<GameObject>(SpawnedPoolObjects& guids) const
+{
+    for (uint32 index = 0; index < m_spawnedGameobjects.size(); ++index)
+        if (m_spawnedGameobjects[index])
+        {
+            guids.push_back(sPoolMgr.GetSpawnIndexGuid<GameObject>(index));
+        }
+}
+
 ////////////////////////////////////////////////////////////
 // Methods of class PoolObject
 template<>
@@ -220,6 +289,21 @@ void PoolGroup<T>::SetExcludeObject(uint32 guid, bool state)
 }
 
 
+// Method that stores the spawn index of each member, after all pools are loaded
+template <class T>
+void PoolGroup<T>::AssignSpawnIndexes()
+{
+    for (size_t i = 0; i < ExplicitlyChanced.size(); ++i)
+    {
+        ExplicitlyChanced[i].spawnIndex = sPoolMgr.GetSpawnIndex<T>(ExplicitlyChanced[i].guid);
+    }
+
+    for (size_t i = 0; i < EqualChanced.size(); ++i)
+    {
+        EqualChanced[i].spawnIndex = sPoolMgr.GetSpawnIndex<T>(EqualChanced[i].guid);
+    }
+}
+
 template <class T>
 PoolObject* PoolGroup<T>::RollOne(SpawnedPoolData& spawns, uint32 triggerFrom)
 {
@@ -232,7 +316,7 @@ PoolObject* PoolGroup<T>::RollOne(SpawnedPoolData& spawns, uint32 triggerFrom)
             roll -= ExplicitlyChanced[i].chance;
             // Triggering object is marked as spawned at this time and can be also rolled (respawn case)
             // so this need explicit check for this case
-            if (roll < 0 && !ExplicitlyChanced[i].exclude && (ExplicitlyChanced[i].guid == triggerFrom || !spawns.IsSpawnedObject<T>(ExplicitlyChanced[i].guid)))
+            if (roll < 0 && !ExplicitlyChanced[i].exclude && (ExplicitlyChanced[i].guid == triggerFrom || !spawns.IsSpawnedObject<T>(ExplicitlyChanced[i])))
             {
                 return &ExplicitlyChanced[i];
             }
@@ -244,7 +328,7 @@ PoolObject* PoolGroup<T>::RollOne(SpawnedPoolData& spawns, uint32 triggerFrom)
         int32 index = irand(0, EqualChanced.size() - 1);
         // Triggering object is marked as spawned at this time and can be also rolled (respawn case)
         // so this need explicit check for this case
-        if (!EqualChanced[index].exclude && (EqualChanced[index].guid == triggerFrom || !spawns.IsSpawnedObject<T>(EqualChanced[index].guid)))
+        if (!EqualChanced[index].exclude && (EqualChanced[index].guid == triggerFrom || !spawns.IsSpawnedObject<T>(EqualChanced[index])))
         {
             return &EqualChanced[index];
         }
@@ -262,13 +346,13 @@ void PoolGroup<T>::DespawnObject(MapPersistentState& mapState, uint32 guid)
     for (size_t i = 0; i < EqualChanced.size(); ++i)
     {
         // if spawned
-        if (mapState.GetSpawnedPoolData().IsSpawnedObject<T>(EqualChanced[i].guid))
+        if (mapState.GetSpawnedPoolData().IsSpawnedObject<T>(EqualChanced[i]))
         {
             // any or specially requested
             if (!guid || EqualChanced[i].guid == guid)
             {
                 Despawn1Object(mapState, EqualChanced[i].guid);
-                mapState.GetSpawnedPoolData().RemoveSpawn<T>(EqualChanced[i].guid, poolId);
+                mapState.GetSpawnedPoolData().RemoveSpawn<T>(EqualChanced[i], poolId);
             }
         }
     }
@@ -276,13 +360,13 @@ void PoolGroup<T>::DespawnObject(MapPersistentState& mapState, uint32 guid)
     for (size_t i = 0; i < ExplicitlyChanced.size(); ++i)
     {
         // spawned
-        if (mapState.GetSpawnedPoolData().IsSpawnedObject<T>(ExplicitlyChanced[i].guid))
+        if (mapState.GetSpawnedPoolData().IsSpawnedObject<T>(ExplicitlyChanced[i]))
         {
             // any or specially requested
             if (!guid || ExplicitlyChanced[i].guid == guid)
             {
                 Despawn1Object(mapState, ExplicitlyChanced[i].guid);
-                mapState.GetSpawnedPoolData().RemoveSpawn<T>(ExplicitlyChanced[i].guid, poolId);
+                mapState.GetSpawnedPoolData().RemoveSpawn<T>(ExplicitlyChanced[i], poolId);
             }
         }
     }
@@ -395,14 +479,14 @@ void PoolGroup<T>::SpawnObject(MapPersistentState& mapState, uint32 limit, uint3
 
         if (obj->guid == triggerFrom)
         {
-            MANGOS_ASSERT(spawns.IsSpawnedObject<T>(obj->guid));
+            MANGOS_ASSERT(spawns.IsSpawnedObject<T>(*obj));
             MANGOS_ASSERT(spawns.GetSpawnedObjects(poolId) > 0);
             ReSpawn1Object(mapState, obj);
             triggerFrom = 0;
             continue;
         }
 
-        spawns.AddSpawn<T>(obj->guid, poolId);
+        spawns.AddSpawn<T>(*obj, poolId);
         Spawn1Object(mapState, obj, instantly);
 
         if (triggerFrom)
@@ -1113,6 +1197,7 @@ void PoolManager::LoadFromDB()
 
             sLog.outString();
             sLog.outErrorDb(">> Loaded 0 gameobjects. DB table `gameobject` is empty.");
+            BuildSpawnIndexes();
             return;
         }
 
@@ -1194,6 +1279,39 @@ void PoolManager::LoadFromDB()
 
         sLog.outString(">> Loaded %u mining nodes", count);
         }
+
+    BuildSpawnIndexes();
+}
+
+void PoolManager::BuildSpawnIndexes()
+{
+    // search maps are ordered by guid, so the index vectors come out sorted
+    mCreatureSpawnIndex.clear();
+    mCreatureSpawnIndex.reserve(mCreatureSearchMap.size());
+    for (SearchMap::const_iterator itr = mCreatureSearchMap.begin(); itr != mCreatureSearchMap.end(); ++itr)
+    {
+        mCreatureSpawnIndex.push_back(itr->first);
+    }
+
+    mGameobjectSpawnIndex.clear();
+    mGameobjectSpawnIndex.reserve(mGameobjectSearchMap.size());
+    for (SearchMap::const_iterator itr = mGameobjectSearchMap.begin(); itr != mGameobjectSearchMap.end(); ++itr)
+    {
+        mGameobjectSpawnIndex.push_back(itr->first);
+    }
+
+    for (size_t pool_id = 0; pool_id < mPoolTemplate.size(); ++pool_id)
+    {
+        mPoolCreatureGroups[pool_id].AssignSpawnIndexes();
+        mPoolGameobjectGroups[pool_id].AssignSpawnIndexes();
+        mPoolPoolGroups[pool_id].AssignSpawnIndexes();
+    }
+}
+
+uint32 PoolManager::FindSpawnIndex(std::vector<uint32> const& guids, uint32 db_guid)
+{
+    std::vector<uint32>::const_iterator itr = std::lower_bound(guids.begin(), guids.end(), db_guid);
+    return itr != guids.end() && *itr == db_guid ? uint32(itr - guids.begin()) : POOL_NO_SPAWN_INDEX;
 }
 
 // The initialize method will spawn all pools not in an event and not in another pool
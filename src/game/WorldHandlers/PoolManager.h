@@ -33,6 +33,8 @@
 class MapPersistentState;
 struct MapEntry;
 
+#define POOL_NO_SPAWN_INDEX 0xFFFFFFFF                      // spawn index of a guid that is not part of any pool
+
 struct PoolTemplateData
 {
     PoolTemplateData() : mapEntry(NULL), MaxLimit(0), AutoSpawn(false) {}
@@ -56,8 +58,9 @@ struct PoolObject
     uint32  guid;
     float   chance;
     bool exclude;
+    uint32  spawnIndex;                                     // bit of the object in SpawnedPoolData, set at load by PoolManager
 
-    PoolObject(uint32 _guid, float _chance): guid(_guid), chance(fabs(_chance)), exclude(false) {}
+    PoolObject(uint32 _guid, float _chance): guid(_guid), chance(fabs(_chance)), exclude(false), spawnIndex(POOL_NO_SPAWN_INDEX) {}
 
     template<typename T>
     void CheckEventLinkAndReport(uint32 poolId, int16 event_id, std::map<uint32, int16> const& creature2event, std::map<uint32, int16> const& go2event) const;
@@ -67,35 +70,51 @@ class Pool                                                  // for Pool of Pool
 {
 };
 
-typedef std::set<uint32> SpawnedPoolObjects;
-typedef std::map<uint32, uint32> SpawnedPoolPools;
+typedef std::vector<uint32> SpawnedPoolObjects;
 
+/**
+ * Pool spawn state of one map persistent state (one shared by all non-instanceable maps).
+ *
+ * Pooled creatures and gameobjects are single bits at their spawn index (PoolObject::spawnIndex,
+ * dense over all pooled objects of the type), pools are bits at their pool id next to a counter of
+ * spawned members per pool id. The bits grow on first use, so the state of a map without pool
+ * spawns stays empty and the pool code paths only index vectors instead of searching trees.
+ */
 class SpawnedPoolData
 {
     public:
         SpawnedPoolData() : m_isInitialized(false) {}
 
+        // for callers that only know the db guid (or the pool id), looks up the spawn index
         template<typename T>
         bool IsSpawnedObject(uint32 db_guid_or_pool_id) const;
 
+        template<typename T>
+        bool IsSpawnedObject(PoolObject const& obj) const;
+
         uint32 GetSpawnedObjects(uint32 pool_id) const;
 
         template<typename T>
-        void AddSpawn(uint32 db_guid_or_pool_id, uint32 pool_id);
+        void AddSpawn(PoolObject const& obj, uint32 pool_id);
 
         template<typename T>
-        void RemoveSpawn(uint32 db_guid_or_pool_id, uint32 pool_id);
+        void RemoveSpawn(PoolObject const& obj, uint32 pool_id);
 
         bool IsInitialized() const { return m_isInitialized; }
         void SetInitialized() { m_isInitialized = true; }
 
-        SpawnedPoolObjects const& GetSpawnedCreatures() const { return mSpawnedCreatures; }
-        SpawnedPoolObjects const& GetSpawnedGameobjects() const { return mSpawnedGameobjects; }
-        SpawnedPoolPools const& GetSpawnedPools() const { return mSpawnedPools; }
+        // db guids of the spawned creatures or gameobjects
+        template<typename T>
+        void GetSpawnedGuids(SpawnedPoolObjects& guids) const;
     private:
-        SpawnedPoolObjects mSpawnedCreatures;
-        SpawnedPoolObjects mSpawnedGameobjects;
-        SpawnedPoolPools   mSpawnedPools;
+        static bool TestBit(std::vector<bool> const& bits, uint32 index) { return index < bits.size() && bits[index]; }
+        static void SetBit(std::vector<bool>& bits, uint32 index, bool value);
+        uint32& SpawnedCount(uint32 pool_id);
+
+        std::vector<bool> m_spawnedCreatures;               // by spawn index
+        std::vector<bool> m_spawnedGameobjects;             // by spawn index
+        std::vector<bool> m_spawnedPools;                   // by pool id, set for every pool that had spawn changes
+        std::vector<uint32> m_spawnedCounts;                // by pool id, spawned members
         bool m_isInitialized;
 };
 
@@ -117,6 +136,7 @@ class PoolGroup
         void Despawn1Object(MapPersistentState& mapState, uint32 guid);
         void SpawnObject(MapPersistentState& mapState, uint32 limit, uint32 triggerFrom, bool instantly);
         void SetExcludeObject(uint32 guid, bool state);
+        void AssignSpawnIndexes();
 
         void Spawn1Object(MapPersistentState& mapState, PoolObject* obj, bool instantly);
         void ReSpawn1Object(MapPersistentState& mapState, PoolObject* obj);
@@ -166,6 +186,14 @@ class PoolManager
         template<typename T>
         void SetExcludeObject(uint16 pool_id, uint32 db_guid_or_pool_id, bool state);
 
+        // bit of a pooled creature/gameobject in SpawnedPoolData (the pool id itself for pools), POOL_NO_SPAWN_INDEX if not pooled
+        template<typename T>
+        uint32 GetSpawnIndex(uint32 db_guid_or_pool_id) const;
+
+        // db guid of a spawn index
+        template<typename T>
+        uint32 GetSpawnIndexGuid(uint32 index) const;
+
         bool CheckPool(uint16 pool_id) const;
         void CheckEventLinkAndReport(uint16 pool_id, int16 event_id, std::map<uint32, int16> const& creature2event, std::map<uint32, int16> const& go2event) const;
 
@@ -196,6 +224,9 @@ class PoolManager
         template<typename T>
         void SpawnPoolGroup(MapPersistentState& mapState, uint16 pool_id, uint32 db_guid_or_pool_id, bool instantly);
 
+        void BuildSpawnIndexes();
+        static uint32 FindSpawnIndex(std::vector<uint32> const& guids, uint32 db_guid);
+
         uint16 max_pool_id;
 
         typedef std::vector<PoolGroup<Creature> >   PoolGroupCreatureMap;
@@ -213,6 +244,10 @@ class PoolManager
         SearchMap mCreatureSearchMap;
         SearchMap mGameobjectSearchMap;
         SearchMap mPoolSearchMap;
+
+        // sorted db guids of all pooled creatures/gameobjects, the position is the spawn index
+        std::vector<uint32> mCreatureSpawnIndex;
+        std::vector<uint32> mGameobjectSpawnIndex;
 };
 
 #define sPoolMgr MaNGOS::Singleton<PoolManager>::Instance()
@@ -256,4 +291,40 @@ inline uint16 PoolManager::IsPartOfAPool<Pool>(uint32 pool_id) const
     return 0;
 }
 
+template<>
+inline uint32 PoolManager::GetSpawnIndex<Creature>(uint32 db_guid) const
+{
+    return FindSpawnIndex(mCreatureSpawnIndex, db_guid);
+}
+
+template<>
+inline uint32 PoolManager::GetSpawnIndex<GameObject>(uint32 db_guid) const
+{
+    return FindSpawnIndex(mGameobjectSpawnIndex, db_guid);
+}
+
+template<>
+inline uint32 PoolManager::GetSpawnIndex<Pool>(uint32 pool_id) const
+{
+    return pool_id;
+}
+
+template<>
+inline uint32 PoolManager::GetSpawnIndexGuid<Creature>(uint32 index) const
+{
+    return mCreatureSpawnIndex[index];
+}
+
+template<>
+inline uint32 PoolManager::GetSpawnIndexGuid<GameObject>(uint32 index) const
+{
+    return mGameobjectSpawnIndex[index];
+}
+
+template<>
+inline uint32 PoolManager::GetSpawnIndexGuid<Pool>(uint32 index) const
+{
+    return index;
+}
+
 #endif
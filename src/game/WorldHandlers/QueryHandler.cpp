@@ -36,6 +36,8 @@
 #include "Player.h"
 #include "NPCHandler.h"
 #include "SQLStorages.h"
+#include "QueryResponseCache.h"
+#include "PlayerNameCache.h"
 
 void WorldSession::SendNameQueryOpcode(Player* p)
 {
@@ -109,6 +111,21 @@ void WorldSession::HandleNameQueryOpcode(WorldPacket& recv_data)
 
     recv_data >> guid;
 
+    // all characters are known then, unknown ones have no row either
+    if (sPlayerNameCache.IsLoaded())
+    {
+        if (!guid.IsPlayer())
+        {
+            return;
+        }
+
+        if (SharedWorldPacket response = sPlayerNameCache.GetNameQueryResponse(guid.GetCounter()))
+        {
+            SendPacket(response.get(), response);
+        }
+        return;
+    }
+
     Player* pChar = sObjectMgr.GetPlayer(guid);
 
     if (pChar)
@@ -145,43 +162,52 @@ void WorldSession::HandleCreatureQueryOpcode(WorldPacket& recv_data)
     {
         int loc_idx = GetSessionDbLocaleIndex();
 
-        char const* name = ci->Name;
-        char const* subName = ci->SubName;
-        sObjectMgr.GetCreatureLocaleStrings(entry, loc_idx, &name, &subName);
-
         DETAIL_LOG("WORLD: CMSG_CREATURE_QUERY '%s' - Entry: %u.", ci->Name, entry);
-        // guess size
-        WorldPacket data(SMSG_CREATURE_QUERY_RESPONSE, 100);
-        data << uint32(entry);                              // creature entry
-        data << name;
-        data << uint8(0) << uint8(0) << uint8(0);           // name2, name3, name4, always empty
-        data << subName;
-        data << uint32(ci->CreatureTypeFlags);              // flags
-        if (unit)
-        {
-            data << uint32(((unit->IsPet()) ? 0 : ci->CreatureType));  // CreatureType.dbc   wdbFeild8
-        }
-        else
+
+        // the response is built without a unit, its unit dependent fields are patched in a copy
+        SharedWorldPacket response = sQueryResponseCache.Find(QUERY_RESPONSE_CREATURE, entry, loc_idx);
+        if (!response)
         {
-            data << uint32(ci->CreatureType);
+            char const* name = ci->Name;
+            char const* subName = ci->SubName;
+            sObjectMgr.GetCreatureLocaleStrings(entry, loc_idx, &name, &subName);
+
+            // guess size
+            WorldPacket data(SMSG_CREATURE_QUERY_RESPONSE, 100);
+            data << uint32(entry);                          // creature entry
+            data << name;
+            data << uint8(0) << uint8(0) << uint8(0);       // name2, name3, name4, always empty
+            data << subName;
+            data << uint32(ci->CreatureTypeFlags);          // flags
+            data << uint32(ci->CreatureType);               // CreatureType.dbc   wdbFeild8
+            data << uint32(ci->Family);                     // CreatureFamily.dbc
+            data << uint32(ci->Rank);                       // Creature Rank (elite, boss, etc)
+            data << uint32(0);                              // unknown        wdbFeild11
+            data << uint32(ci->PetSpellDataId);             // Id from CreatureSpellData.dbc    wdbField12
+            data << uint32(Creature::ChooseDisplayId(ci));  // DisplayID      wdbFeild13, workaround, way to manage models must be fixed
+            data << uint8(ci->civilian);                    // wdbFeild14
+            data << uint8(ci->RacialLeader);
+
+            response = sQueryResponseCache.Store(QUERY_RESPONSE_CREATURE, entry, loc_idx, data);
         }
 
-        data << uint32(ci->Family);                         // CreatureFamily.dbc
-        data << uint32(ci->Rank);                           // Creature Rank (elite, boss, etc)
-        data << uint32(0);                                  // unknown        wdbFeild11
-        data << uint32(ci->PetSpellDataId);                 // Id from CreatureSpellData.dbc    wdbField12
-        if (unit)
+        // offsets of CreatureType and DisplayID, counted from the end past the strings
+        size_t const typePos = response->size() - 26;
+        size_t const displayPos = response->size() - 6;
+
+        uint32 creatureType = unit && unit->IsPet() ? 0 : ci->CreatureType;
+        uint32 displayId = unit ? unit->GetUInt32Value(UNIT_FIELD_DISPLAYID) : response->read<uint32>(displayPos);
+        if (creatureType != response->read<uint32>(typePos) || displayId != response->read<uint32>(displayPos))
         {
-            data << unit->GetUInt32Value(UNIT_FIELD_DISPLAYID);  // DisplayID      wdbFeild13
+            WorldPacket data(*response);
+            data.put<uint32>(typePos, creatureType);
+            data.put<uint32>(displayPos, displayId);
+            SendPacket(&data);
         }
         else
         {
-            data << uint32(Creature::ChooseDisplayId(ci));   // workaround, way to manage models must be fixed
+            SendPacket(response.get(), response);
         }
-
-        data << uint8(ci->civilian);                       // wdbFeild14
-        data << uint8(ci->RacialLeader);
-        SendPacket(&data);
         DEBUG_LOG("WORLD: Sent SMSG_CREATURE_QUERY_RESPONSE");
     }
     else
@@ -206,9 +232,16 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
     const GameObjectInfo* info = ObjectMgr::GetGameObjectInfo(entryID);
     if (info)
     {
+        int loc_idx = GetSessionDbLocaleIndex();
+
+        if (SharedWorldPacket response = sQueryResponseCache.Find(QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx))
+        {
+            SendPacket(response.get(), response);
+            return;
+        }
+
         std::string Name = info->name;
 
-        int loc_idx = GetSessionDbLocaleIndex();
         if (loc_idx >= 0)
         {
             GameObjectLocale const* gl = sObjectMgr.GetGameObjectLocale(entryID);
@@ -230,7 +263,8 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
         data << uint8(0);                           // one more name, client handles it a bit differently
         data.append(info->raw.data, 24);            // these are read as int32
         // data << float(info->size);               // [-ZERO] go size: not in Zero
-        SendPacket(&data);
+        SharedWorldPacket response = sQueryResponseCache.Store(QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx, data);
+        SendPacket(response.get(), response);
         DEBUG_LOG("WORLD: Sent SMSG_GAMEOBJECT_QUERY_RESPONSE");
     }
     else
@@ -308,6 +342,18 @@ void WorldSession::HandleNpcTextQueryOpcode(WorldPacket& recv_data)
 
     GossipText const* pGossip = sObjectMgr.GetGossipText(textID);
 
+    int loc_idx = GetSessionDbLocaleIndex();
+
+    if (pGossip)
+    {
+        if (SharedWorldPacket response = sQueryResponseCache.Find(QUERY_RESPONSE_NPC_TEXT, textID, loc_idx))
+        {
+            SendPacket(response.get(), response);
+            DEBUG_LOG("WORLD: Sent SMSG_NPC_TEXT_UPDATE");
+            return;
+        }
+    }
+
     WorldPacket data(SMSG_NPC_TEXT_UPDATE, 100);            // guess size
     data << textID;
 
@@ -336,8 +382,6 @@ void WorldSession::HandleNpcTextQueryOpcode(WorldPacket& recv_data)
             Text_1[i] = pGossip->Options[i].Text_1;
         }
 
-        int loc_idx = GetSessionDbLocaleIndex();
-
         sObjectMgr.GetNpcTextLocaleStringsAll(textID, loc_idx, &Text_0, &Text_1);
 
         for (int i = 0; i < MAX_GOSSIP_TEXT_OPTIONS; ++i)
@@ -372,7 +416,16 @@ void WorldSession::HandleNpcTextQueryOpcode(WorldPacket& recv_data)
         }
     }
 
-    SendPacket(&data);
+    // unknown text ids come from the client, they are not kept
+    if (pGossip)
+    {
+        SharedWorldPacket response = sQueryResponseCache.Store(QUERY_RESPONSE_NPC_TEXT, textID, loc_idx, data);
+        SendPacket(response.get(), response);
+    }
+    else
+    {
+        SendPacket(&data);
+    }
 
     DEBUG_LOG("WORLD: Sent SMSG_NPC_TEXT_UPDATE");
 }
@@ -385,41 +438,51 @@ void WorldSession::HandlePageTextQueryOpcode(WorldPacket& recv_data)
     recv_data >> pageID;
     recv_data.read_skip<uint64>();                          // guid
 
+    int loc_idx = GetSessionDbLocaleIndex();
+
     while (pageID)
     {
         PageText const* pPage = sPageTextStore.LookupEntry<PageText>(pageID);
-        // guess size
-        WorldPacket data(SMSG_PAGE_TEXT_QUERY_RESPONSE, 50);
-        data << pageID;
+        uint32 nextPageID = pPage ? pPage->Next_Page : 0;
 
-        if (!pPage)
-        {
-            data << "Item page missing.";
-            data << uint32(0);
-            pageID = 0;
-        }
-        else
+        SharedWorldPacket response = sQueryResponseCache.Find(QUERY_RESPONSE_PAGE_TEXT, pageID, loc_idx);
+        if (!response)
         {
-            std::string Text = pPage->Text;
+            // guess size
+            WorldPacket data(SMSG_PAGE_TEXT_QUERY_RESPONSE, 50);
+            data << pageID;
 
-            int loc_idx = GetSessionDbLocaleIndex();
-            if (loc_idx >= 0)
+            if (!pPage)
+            {
+                data << "Item page missing.";
+                data << uint32(0);
+            }
+            else
             {
-                PageTextLocale const* pl = sObjectMgr.GetPageTextLocale(pageID);
-                if (pl)
+                std::string Text = pPage->Text;
+
+                if (loc_idx >= 0)
                 {
-                    if (pl->Text.size() > size_t(loc_idx) && !pl->Text[loc_idx].empty())
+                    PageTextLocale const* pl = sObjectMgr.GetPageTextLocale(pageID);
+                    if (pl)
                     {
-                        Text = pl->Text[loc_idx];
+                        if (pl->Text.size() > size_t(loc_idx) && !pl->Text[loc_idx].empty())
+                        {
+                            Text = pl->Text[loc_idx];
+                        }
                     }
                 }
+
+                data << Text;
+                data << uint32(nextPageID);
             }
 
-            data << Text;
-            data << uint32(pPage->Next_Page);
-            pageID = pPage->Next_Page;
+            // unknown page ids come from the client, they are not kept
+            response = pPage ? sQueryResponseCache.Store(QUERY_RESPONSE_PAGE_TEXT, pageID, loc_idx, data) : std::make_shared<WorldPacket const>(data);
         }
-        SendPacket(&data);
+
+        SendPacket(response.get(), response);
+        pageID = nextPageID;
 
         DEBUG_LOG("WORLD: Sent SMSG_PAGE_TEXT_QUERY_RESPONSE");
     }
@@ -0,0 +1,81 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "QueryResponseCache.h"
+#include "World.h"
+
+#include <ace/Guard_T.h>
+
+INSTANTIATE_SINGLETON_1(QueryResponseCache);
+
+bool QueryResponseCache::IsEnabled() const
+{
+    return sWorld.getConfig(CONFIG_BOOL_QUERY_RESPONSE_CACHE);
+}
+
+SharedWorldPacket QueryResponseCache::Find(QueryResponseType type, uint32 entry, int locale) const
+{
+    if (!IsEnabled())
+    {
+        return SharedWorldPacket();
+    }
+
+    ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_lock, SharedWorldPacket());
+
+    ResponseMap::const_iterator itr = m_responses[type].find(MakeKey(entry, locale));
+    return itr != m_responses[type].end() ? itr->second : SharedWorldPacket();
+}
+
+SharedWorldPacket QueryResponseCache::Store(QueryResponseType type, uint32 entry, int locale, WorldPacket const& packet)
+{
+    SharedWorldPacket response = std::make_shared<WorldPacket const>(packet);
+
+    if (!IsEnabled())
+    {
+        return response;
+    }
+
+    ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_lock, response);
+
+    // another thread may have built it meanwhile, both are the same
+    m_responses[type][MakeKey(entry, locale)] = response;
+    return response;
+}
+
+void QueryResponseCache::Clear(QueryResponseType type)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+
+    m_responses[type].clear();
+}
+
+void QueryResponseCache::ClearAll()
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+
+    for (int i = 0; i < MAX_QUERY_RESPONSE_TYPES; ++i)
+    {
+        m_responses[i].clear();
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_QUERY_RESPONSE_CACHE
+#define MANGOS_H_QUERY_RESPONSE_CACHE
+
+#include <ace/RW_Thread_Mutex.h>
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "WorldPacket.h"
+
+enum QueryResponseType
+{
+    QUERY_RESPONSE_CREATURE,                                ///< SMSG_CREATURE_QUERY_RESPONSE
+    QUERY_RESPONSE_GAMEOBJECT,                              ///< SMSG_GAMEOBJECT_QUERY_RESPONSE
+    QUERY_RESPONSE_ITEM,                                    ///< SMSG_ITEM_QUERY_SINGLE_RESPONSE
+    QUERY_RESPONSE_NPC_TEXT,                                ///< SMSG_NPC_TEXT_UPDATE
+    QUERY_RESPONSE_PAGE_TEXT,                               ///< SMSG_PAGE_TEXT_QUERY_RESPONSE
+    MAX_QUERY_RESPONSE_TYPES
+};
+
+/**
+ * @brief Serialized responses of the template query opcodes, per entry and locale
+ *
+ * The responses only depend on the templates and their locales, so each one is
+ * built on the first query and then sent as the same shared packet to every
+ * session asking for it. The query handlers run on the network threads as well,
+ * hence the lock. Reloading a table the responses are built from has to call
+ * Clear() for the types using it.
+ */
+class QueryResponseCache
+{
+    public:
+        QueryResponseCache() {}
+
+        /**
+         * @brief Whether responses are cached at all (QueryResponseCache in mangosd.conf)
+         *
+         * @return bool
+         */
+        bool IsEnabled() const;
+
+        /**
+         * @brief Returns the cached response of an entry
+         *
+         * @param type
+         * @param entry
+         * @param locale locale index of the session, -1 for the default locale
+         * @return SharedWorldPacket NULL if the response has to be built
+         */
+        SharedWorldPacket Find(QueryResponseType type, uint32 entry, int locale) const;
+
+        /**
+         * @brief Keeps a built response for later queries
+         *
+         * @param type
+         * @param entry
+         * @param locale locale index of the session, -1 for the default locale
+         * @param packet the response
+         * @return SharedWorldPacket shared copy of the response to send
+         */
+        SharedWorldPacket Store(QueryResponseType type, uint32 entry, int locale, WorldPacket const& packet);
+
+        /**
+         * @brief Drops all responses of a type, after a reload of its tables
+         *
+         * @param type
+         */
+        void Clear(QueryResponseType type);
+
+        /**
+         * @brief Drops all responses
+         *
+         */
+        void ClearAll();
+
+    private:
+        typedef UNORDERED_MAP<uint64, SharedWorldPacket> ResponseMap;
+
+        static uint64 MakeKey(uint32 entry, int locale) { return (uint64(entry) << 8) | uint8(locale + 1); }
+
+        mutable ACE_RW_Thread_Mutex m_lock;
+        ResponseMap m_responses[MAX_QUERY_RESPONSE_TYPES];
+};
+
+#define sQueryResponseCache MaNGOS::Singleton<QueryResponseCache>::Instance()
+
+#endif
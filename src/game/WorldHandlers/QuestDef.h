@@ -27,6 +27,7 @@
 
 #include "Platform/Define.h"
 #include "Database/DatabaseEnv.h"
+#include "Utilities/InternedString.h"
 
 #include <vector>
 
@@ -181,13 +182,13 @@ struct QuestLocale
 {
     QuestLocale() { ObjectiveText.resize(QUEST_OBJECTIVES_COUNT); }
 
-    std::vector<std::string> Title;
-    std::vector<std::string> Details;
-    std::vector<std::string> Objectives;
-    std::vector<std::string> OfferRewardText;
-    std::vector<std::string> RequestItemsText;
-    std::vector<std::string> EndText;
-    std::vector< std::vector<std::string> > ObjectiveText;
+    std::vector<InternedString> Title;
+    std::vector<InternedString> Details;
+    std::vector<InternedString> Objectives;
+    std::vector<InternedString> OfferRewardText;
+    std::vector<InternedString> RequestItemsText;
+    std::vector<InternedString> EndText;
+    std::vector< std::vector<InternedString> > ObjectiveText;
 };
 
 // This Quest class provides a convenient way to access a few pretotaled (cached) quest details,
@@ -586,6 +586,12 @@ uint32 WorldSession::getDialogStatus(Player* pPlayer, Object* questgiver, uint32
 
     uint32 dialogStatus = defstatus;
 
+    // answered before since nothing it depends on changed
+    if (defstatus == DIALOG_STATUS_NONE && pPlayer->GetCachedQuestGiverStatus(questgiver, dialogStatus))
+    {
+        return dialogStatus;
+    }
+
     QuestRelationsMapBounds rbounds;                        // QuestRelations (quest-giver)
     QuestRelationsMapBounds irbounds;                       // InvolvedRelations (quest-finisher)
 
@@ -693,6 +699,11 @@ uint32 WorldSession::getDialogStatus(Player* pPlayer, Object* questgiver, uint32
         }
     }
 
+    if (defstatus == DIALOG_STATUS_NONE)
+    {
+        pPlayer->SetCachedQuestGiverStatus(questgiver, dialogStatus);
+    }
+
     return dialogStatus;
 }
 
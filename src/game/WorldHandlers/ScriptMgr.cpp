@@ -857,6 +857,8 @@ void ScriptMgr::LoadScripts(DBScriptType type)
             }
         }
 
+        tmp.PrepareBuddySearch();
+
         if (m_dbScripts[type].find(tmp.id) == m_dbScripts[type].end())
         {
             ScriptChain emptyVec;
@@ -1074,23 +1076,64 @@ bool ScriptAction::GetScriptCommandObject(const ObjectGuid guid, bool includeIte
     return true;
 }
 
+/// Resolve once at load how the buddy of this step is searched, so executing it does not have to
+void ScriptInfo::PrepareBuddySearch()
+{
+    buddyGuid.Clear();
+
+    if (!buddyEntry)
+    {
+        buddySearch = SCRIPT_BUDDY_NONE;
+    }
+    else if (data_flags & SCRIPT_FLAG_BUDDY_BY_GUID)
+    {
+        if (IsCreatureBuddy())
+        {
+            buddySearch = SCRIPT_BUDDY_CREATURE_BY_GUID;
+            if (CreatureInfo const* cinfo = ObjectMgr::GetCreatureTemplate(buddyEntry))
+            {
+                buddyGuid = cinfo->GetObjectGuid(searchRadiusOrGuid);
+            }
+        }
+        else
+        {
+            buddySearch = SCRIPT_BUDDY_GO_BY_GUID;
+            buddyGuid = ObjectGuid(HIGHGUID_GAMEOBJECT, buddyEntry, searchRadiusOrGuid);
+        }
+    }
+    else if (!IsCreatureBuddy())
+    {
+        buddySearch = SCRIPT_BUDDY_GAMEOBJECT;
+    }
+    else if (data_flags & SCRIPT_FLAG_BUDDY_IS_DESPAWNED)
+    {
+        buddySearch = SCRIPT_BUDDY_CREATURE_DESPAWNED;
+    }
+    else if (data_flags & SCRIPT_FLAG_BUDDY_IS_PET)
+    {
+        buddySearch = SCRIPT_BUDDY_CREATURE_OR_PET;
+    }
+    else
+    {
+        buddySearch = SCRIPT_BUDDY_CREATURE;
+    }
+}
+
 /// Select source and target for a script command
 /// Returns false iff an error happened
 bool ScriptAction::GetScriptProcessTargets(WorldObject* pOrigSource, WorldObject* pOrigTarget, WorldObject*& pFinalSource, WorldObject*& pFinalTarget)
 {
     WorldObject* pBuddy = NULL;
 
-    if (m_script->buddyEntry)
+    if (m_script->buddySearch != SCRIPT_BUDDY_NONE)
     {
-        if (m_script->data_flags & SCRIPT_FLAG_BUDDY_BY_GUID)
+        if (m_script->buddySearch == SCRIPT_BUDDY_CREATURE_BY_GUID || m_script->buddySearch == SCRIPT_BUDDY_GO_BY_GUID)
         {
-            if (m_script->IsCreatureBuddy())
+            if (m_script->buddySearch == SCRIPT_BUDDY_CREATURE_BY_GUID)
             {
-                CreatureInfo const* cinfo = ObjectMgr::GetCreatureTemplate(m_script->buddyEntry);
-
-                if (cinfo != NULL)
+                if (!m_script->buddyGuid.IsEmpty())
                 {
-                    pBuddy = m_map->GetCreature(cinfo->GetObjectGuid(m_script->searchRadiusOrGuid));
+                    pBuddy = m_map->GetCreature(m_script->buddyGuid);
 
                     if (pBuddy && !((Creature*)pBuddy)->IsAlive())
                     {
@@ -1106,8 +1149,7 @@ bool ScriptAction::GetScriptProcessTargets(WorldObject* pOrigSource, WorldObject
             }
             else
             {
-                // GameObjectInfo const* ginfo = ObjectMgr::GetGameObjectInfo(m_script->buddyEntry);
-                pBuddy = m_map->GetGameObject(ObjectGuid(HIGHGUID_GAMEOBJECT, m_script->buddyEntry, m_script->searchRadiusOrGuid));
+                pBuddy = m_map->GetGameObject(m_script->buddyGuid);
             }
             // TODO Maybe load related grid if not already done? How to handle multi-map case?
             if (!pBuddy)
@@ -1131,11 +1173,11 @@ bool ScriptAction::GetScriptProcessTargets(WorldObject* pOrigSource, WorldObject
                 pSearcher = pOrigTarget;
             }
 
-            if (m_script->IsCreatureBuddy())
+            if (m_script->buddySearch != SCRIPT_BUDDY_GAMEOBJECT)
             {
                 Creature* pCreatureBuddy = NULL;
 
-                if (m_script->data_flags & SCRIPT_FLAG_BUDDY_IS_DESPAWNED)
+                if (m_script->buddySearch == SCRIPT_BUDDY_CREATURE_DESPAWNED)
                 {
                     MaNGOS::AllCreaturesOfEntryInRangeCheck u_check(pSearcher, m_script->buddyEntry, m_script->searchRadiusOrGuid);
                     MaNGOS::CreatureLastSearcher<MaNGOS::AllCreaturesOfEntryInRangeCheck> searcher(pCreatureBuddy, u_check);
@@ -1146,7 +1188,7 @@ bool ScriptAction::GetScriptProcessTargets(WorldObject* pOrigSource, WorldObject
                     MaNGOS::NearestCreatureEntryWithLiveStateInObjectRangeCheck u_check(*pSearcher, m_script->buddyEntry, true, false, m_script->searchRadiusOrGuid, true);
                     MaNGOS::CreatureLastSearcher<MaNGOS::NearestCreatureEntryWithLiveStateInObjectRangeCheck> searcher(pCreatureBuddy, u_check);
 
-                    if (m_script->data_flags & SCRIPT_FLAG_BUDDY_IS_PET)
+                    if (m_script->buddySearch == SCRIPT_BUDDY_CREATURE_OR_PET)
                     {
                         Cell::VisitWorldObjects(pSearcher, searcher, m_script->searchRadiusOrGuid);
                     }
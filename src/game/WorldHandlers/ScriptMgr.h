@@ -198,6 +198,18 @@ enum ScriptInfoDataFlags
 };
 #define MAX_SCRIPT_FLAG_VALID               (2 * SCRIPT_FLAG_BUDDY_IS_DESPAWNED - 1)
 
+// How the buddy of a script step is found, resolved from buddy_entry, data_flags and command when loading
+enum ScriptBuddySearch
+{
+    SCRIPT_BUDDY_NONE                       = 0,            // no buddy_entry
+    SCRIPT_BUDDY_CREATURE_BY_GUID           = 1,            // buddyGuid of a creature
+    SCRIPT_BUDDY_GO_BY_GUID                 = 2,            // buddyGuid of a gameobject
+    SCRIPT_BUDDY_CREATURE_DESPAWNED         = 3,            // creature of any live state in grid range
+    SCRIPT_BUDDY_CREATURE_OR_PET            = 4,            // alive creature in world object range
+    SCRIPT_BUDDY_CREATURE                   = 5,            // alive creature in grid range
+    SCRIPT_BUDDY_GAMEOBJECT                 = 6,            // gameobject in grid range
+};
+
 struct ScriptInfo
 {
     uint32 id;
@@ -485,6 +497,12 @@ struct ScriptInfo
     float z;
     float o;
 
+    // filled by PrepareBuddySearch
+    ScriptBuddySearch buddySearch;
+    ObjectGuid buddyGuid;                                   // for searches by guid
+
+    void PrepareBuddySearch();
+
     // helpers
     uint32 GetGOGuid() const
     {
@@ -0,0 +1,161 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "ScriptSchedule.h"
+#include "Policies/Singleton.h"
+
+ScriptSchedule::ScriptSchedule() : m_processed(0), m_pending(0), m_executed(0)
+{
+}
+
+ScriptSchedule::~ScriptSchedule()
+{
+    if (m_pending)
+    {
+        sScriptMgr.DecreaseScheduledScriptCount(m_pending);
+    }
+}
+
+void ScriptSchedule::Add(time_t time, ScriptAction const& action)
+{
+    m_slots[time % SCRIPT_SCHEDULE_SLOTS].push_back(Entry(time, action));
+    ++m_pending;
+
+    sScriptMgr.IncreaseScheduledScriptsCount();
+}
+
+time_t ScriptSchedule::GetFirstPendingSecond(time_t now) const
+{
+    // the last processed second is visited again for steps added after that call within the same second
+    if (!m_processed || now - m_processed >= SCRIPT_SCHEDULE_SLOTS)
+    {
+        return now - SCRIPT_SCHEDULE_SLOTS + 1;
+    }
+
+    return m_processed;
+}
+
+void ScriptSchedule::Process(time_t now)
+{
+    time_t first = GetFirstPendingSecond(now);
+    m_processed = now;
+
+    for (time_t second = first; second <= now && m_pending; ++second)
+    {
+        Slot& slot = m_slots[second % SCRIPT_SCHEDULE_SLOTS];
+
+        // index based, running a step can append new steps to this slot
+        size_t kept = 0;
+        for (size_t i = 0; i < slot.size(); ++i)
+        {
+            if (!slot[i].active)
+            {
+                continue;
+            }
+
+            if (slot[i].time > now)
+            {
+                if (kept != i)
+                {
+                    slot[kept] = slot[i];
+                }
+                ++kept;
+                continue;
+            }
+
+            ScriptAction action = slot[i].action;
+            slot[i].active = false;
+            --m_pending;
+            ++m_executed;
+            sScriptMgr.DecreaseScheduledScriptCount();
+
+            if (action.HandleScriptStep())
+            {
+                // Terminate following script steps of this script
+                TerminateScript(action.GetType(), action.GetId(), action.GetSourceGuid(), action.GetTargetGuid(), action.GetOwnerGuid());
+            }
+        }
+
+        slot.erase(slot.begin() + kept, slot.end());
+    }
+}
+
+bool ScriptSchedule::HasScript(DBScriptType type, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid) const
+{
+    if (!m_pending)
+    {
+        return false;
+    }
+
+    for (uint32 i = 0; i < SCRIPT_SCHEDULE_SLOTS; ++i)
+    {
+        for (Slot::const_iterator itr = m_slots[i].begin(); itr != m_slots[i].end(); ++itr)
+        {
+            if (itr->active && itr->action.IsSameScript(type, id, sourceGuid, targetGuid, ownerGuid))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void ScriptSchedule::TerminateScript(DBScriptType type, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid)
+{
+    for (uint32 i = 0; i < SCRIPT_SCHEDULE_SLOTS && m_pending; ++i)
+    {
+        for (Slot::iterator itr = m_slots[i].begin(); itr != m_slots[i].end(); ++itr)
+        {
+            if (itr->active && itr->action.IsSameScript(type, id, sourceGuid, targetGuid, ownerGuid))
+            {
+                itr->active = false;
+                --m_pending;
+                sScriptMgr.DecreaseScheduledScriptCount();
+            }
+        }
+    }
+}
+
+bool ScriptSchedule::HasDueActions(time_t now) const
+{
+    if (!m_pending)
+    {
+        return false;
+    }
+
+    for (time_t second = GetFirstPendingSecond(now); second <= now; ++second)
+    {
+        Slot const& slot = m_slots[second % SCRIPT_SCHEDULE_SLOTS];
+        for (Slot::const_iterator itr = slot.begin(); itr != slot.end(); ++itr)
+        {
+            if (itr->active && itr->time <= now)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,87 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_SCRIPT_SCHEDULE
+#define MANGOS_H_SCRIPT_SCHEDULE
+
+#include "Common.h"
+#include "ScriptMgr.h"
+
+#define SCRIPT_SCHEDULE_SLOTS 256                           // one slot per second, later steps wait for their round
+
+/**
+ * Hashed timing wheel holding the pending db script steps of a map.
+ *
+ * A step is appended to the slot of its second, so adding does not allocate
+ * once the slot vectors have grown. Process() only looks at the slots of the
+ * seconds passed since the previous call. Steps due in the same second keep
+ * the order they were added in.
+ */
+class ScriptSchedule
+{
+    public:
+        ScriptSchedule();
+        ~ScriptSchedule();
+
+        void Add(time_t time, ScriptAction const& action);
+
+        // run all steps due at now, a step requesting termination drops the pending steps of its script
+        void Process(time_t now);
+
+        // a pending step belongs to the script, see ScriptAction::IsSameScript
+        bool HasScript(DBScriptType type, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid) const;
+        void TerminateScript(DBScriptType type, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid);
+
+        // a step is due at now, i.e. the next Process(now) has work
+        bool HasDueActions(time_t now) const;
+
+        bool empty() const { return m_pending == 0; }
+        size_t size() const { return m_pending; }
+
+        // steps run since the last reset, shown by .server perf maps
+        uint32 GetExecutedCount() const { return m_executed; }
+        void ResetExecutedCount() { m_executed = 0; }
+
+    private:
+        struct Entry
+        {
+            Entry(time_t t, ScriptAction const& a) : time(t), action(a), active(true) {}
+
+            time_t time;
+            ScriptAction action;
+            bool active;                                    // false once run or terminated, removed at the next visit of the slot
+        };
+
+        typedef std::vector<Entry> Slot;
+
+        // first second whose slot may still hold steps due at now
+        time_t GetFirstPendingSecond(time_t now) const;
+
+        Slot m_slots[SCRIPT_SCHEDULE_SLOTS];
+        time_t m_processed;                                 // second of the last Process() call, 0 before the first one
+        size_t m_pending;
+        uint32 m_executed;
+};
+
+#endif
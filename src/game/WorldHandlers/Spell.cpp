@@ -50,6 +50,7 @@
 #include "Chat.h"
 #include "SQLStorages.h"
 #include "DisableMgr.h"
+#include "Utilities/ObjectPool.h"
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
 #endif /* ENABLE_ELUNA */
@@ -321,6 +322,7 @@ Spell::Spell(Unit* caster, SpellEntry const* info, bool triggered, ObjectGuid or
     m_triggeredBySpellInfo = triggeredBy;
     m_caster = caster;
     m_selfContainer = NULL;
+    m_cacheAreaTargets = false;
     m_referencedFromCurrentSpell = false;
     m_executedCurrently = false;
     m_delayStart = 0;
@@ -419,6 +421,23 @@ Spell::~Spell()
 {
 }
 
+static ObjectPool& GetSpellPool()
+{
+    // never destroyed, see ObjectPool
+    static ObjectPool* pool = new ObjectPool("Spell", sizeof(Spell));
+    return *pool;
+}
+
+void* Spell::operator new(size_t size)
+{
+    return GetSpellPool().Allocate(size);
+}
+
+void Spell::operator delete(void* ptr, size_t size)
+{
+    GetSpellPool().Release(ptr, size);
+}
+
 template<typename T>
 WorldObject* Spell::FindCorpseUsing()
 {
@@ -446,6 +465,7 @@ void Spell::FillTargetMap()
     // TODO: ADD the correct target FILLS!!!!!!
 
     UnitList tmpUnitLists[MAX_EFFECT_INDEX];                // Stores the temporary Target Lists for each effect
+    m_cacheAreaTargets = true;                              // the area searches and line of sight checks are shared by the effects
     uint8 effToIndex[MAX_EFFECT_INDEX] = {0, 1, 2};         // Helper array, to link to another tmpUnitList, if the targets for both effects match
     for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
     {
@@ -705,11 +725,21 @@ void Spell::FillTargetMap()
             }
         }
 
-        for (UnitList::iterator itr = tmpUnitLists[effToIndex[i]].begin(); itr != tmpUnitLists[effToIndex[i]].end();)
+        // area targets query their line of sight in one batch
+        UnitList& targets = tmpUnitLists[effToIndex[i]];
+        bool* inLineOfSight = targets.size() > 1 ? new bool[targets.size()] : NULL;
+        if (inLineOfSight && !GetTargetsLineOfSight(targets, SpellEffectIndex(i), inLineOfSight))
+        {
+            delete[] inLineOfSight;
+            inLineOfSight = NULL;
+        }
+
+        uint32 targetIndex = 0;
+        for (UnitList::iterator itr = targets.begin(); itr != targets.end(); ++targetIndex)
         {
-            if (!CheckTarget(*itr, SpellEffectIndex(i)))
+            if (!CheckTarget(*itr, SpellEffectIndex(i), inLineOfSight ? &inLineOfSight[targetIndex] : NULL))
             {
-                itr = tmpUnitLists[effToIndex[i]].erase(itr);
+                itr = targets.erase(itr);
                 continue;
             }
             else
@@ -718,11 +748,17 @@ void Spell::FillTargetMap()
             }
         }
 
+        delete[] inLineOfSight;
+
         for (UnitList::const_iterator iunit = tmpUnitLists[effToIndex[i]].begin(); iunit != tmpUnitLists[effToIndex[i]].end(); ++iunit)
         {
             AddUnitTarget((*iunit), SpellEffectIndex(i));
         }
     }
+
+    m_cacheAreaTargets = false;
+    m_areaTargetSearches.clear();
+    m_lineOfSightCache.clear();
 }
 
 void Spell::prepareDataForTriggerSystem()
@@ -1814,7 +1850,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                 case TARGET_RANDOM_ENEMY_CHAIN_IN_AREA:
                 {
                     MaNGOS::AnyAoETargetUnitInObjectRangeCheck u_check(m_caster, max_range);
-                    MaNGOS::UnitListSearcher<MaNGOS::AnyAoETargetUnitInObjectRangeCheck> searcher(tempTargetUnitMap, u_check);
+                    MaNGOS::UnitListSearcher<MaNGOS::AnyAoETargetUnitInObjectRangeCheck, UnitList> searcher(tempTargetUnitMap, u_check);
                     Cell::VisitAllObjects(m_caster, searcher, max_range);
                     break;
                 }
@@ -1822,7 +1858,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                 case TARGET_RANDOM_FRIEND_CHAIN_IN_AREA:
                 {
                     MaNGOS::AnyFriendlyUnitInObjectRangeCheck u_check(m_caster, max_range);
-                    MaNGOS::UnitListSearcher<MaNGOS::AnyFriendlyUnitInObjectRangeCheck> searcher(tempTargetUnitMap, u_check);
+                    MaNGOS::UnitListSearcher<MaNGOS::AnyFriendlyUnitInObjectRangeCheck, UnitList> searcher(tempTargetUnitMap, u_check);
                     Cell::VisitAllObjects(m_caster, searcher, max_range);
                     break;
                 }
@@ -1927,7 +1963,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                 UnitList tempTargetUnitMap;
                 {
                     MaNGOS::AnyAoEVisibleTargetUnitInObjectRangeCheck u_check(pUnitTarget, originalCaster, max_range);
-                    MaNGOS::UnitListSearcher<MaNGOS::AnyAoEVisibleTargetUnitInObjectRangeCheck> searcher(tempTargetUnitMap, u_check);
+                    MaNGOS::UnitListSearcher<MaNGOS::AnyAoEVisibleTargetUnitInObjectRangeCheck, UnitList> searcher(tempTargetUnitMap, u_check);
                     Cell::VisitAllObjects(m_caster, searcher, max_range);
                 }
 
@@ -7488,7 +7524,101 @@ CurrentSpellTypes Spell::GetCurrentContainer()
     }
 }
 
-bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff)
+// Line of sight of every target to the casting object, as checked by the normal case of CheckTarget, false if that check is not used
+bool Spell::GetTargetsLineOfSight(UnitList const& targets, SpellEffectIndex eff, bool* inLineOfSight)
+{
+    if (DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_spellInfo->Id, NULL, SPELL_DISABLE_LOS))
+    {
+        return false;
+    }
+
+    switch (m_spellInfo->Effect[eff])
+    {
+        case SPELL_EFFECT_SUMMON_PLAYER:
+        case SPELL_EFFECT_DUMMY:
+        case SPELL_EFFECT_RESURRECT_NEW:
+            return false;
+        default:
+            break;
+    }
+
+    WorldObject* caster = GetCastingObject();
+    if (!caster)
+    {
+        return false;
+    }
+
+    float cx, cy, cz;
+    caster->GetPosition(cx, cy, cz);
+
+    std::vector<float> from, to;
+    std::vector<uint32> queried;
+    from.reserve(targets.size() * 3);
+    to.reserve(targets.size() * 3);
+
+    uint32 index = 0;
+    for (UnitList::const_iterator itr = targets.begin(); itr != targets.end(); ++itr, ++index)
+    {
+        // same as IsWithinLOSInMap: other maps are never in sight, eye height on both ends
+        inLineOfSight[index] = *itr == m_caster;
+        if (*itr == m_caster || !(*itr)->IsInMap(caster))
+        {
+            continue;
+        }
+
+        // already queried for another effect of this cast
+        if (m_cacheAreaTargets)
+        {
+            LineOfSightCache::const_iterator cached = m_lineOfSightCache.find(*itr);
+            if (cached != m_lineOfSightCache.end())
+            {
+                inLineOfSight[index] = cached->second;
+                continue;
+            }
+        }
+
+        float x, y, z;
+        (*itr)->GetPosition(x, y, z);
+
+        from.push_back(x);
+        from.push_back(y);
+        from.push_back(z + 2.0f);
+        to.push_back(cx);
+        to.push_back(cy);
+        to.push_back(cz + 2.0f);
+        queried.push_back(index);
+    }
+
+    if (!queried.empty())
+    {
+        bool* results = new bool[queried.size()];
+        caster->GetMap()->IsInLineOfSight(&from[0], &to[0], results, queried.size());
+
+        for (uint32 i = 0; i < queried.size(); ++i)
+        {
+            inLineOfSight[queried[i]] = results[i];
+        }
+
+        if (m_cacheAreaTargets)
+        {
+            uint32 i = 0;
+            index = 0;
+            for (UnitList::const_iterator itr = targets.begin(); itr != targets.end() && i < queried.size(); ++itr, ++index)
+            {
+                if (index == queried[i])
+                {
+                    m_lineOfSightCache[*itr] = results[i++];
+                }
+            }
+        }
+
+        delete[] results;
+    }
+
+    return true;
+}
+
+bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff, bool const* inLineOfSight)
 {
     // Check targets for creature type mask and remove not appropriate (skip explicit self target case, maybe need other explicit targets)
     if (m_spellInfo->EffectImplicitTargetA[eff] != TARGET_SELF)
@@ -7585,7 +7715,7 @@ bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff)
             // Get GO cast coordinates if original caster -> GO
             if (target != m_caster)
             if (WorldObject* caster = GetCastingObject())
-            if (!target->IsWithinLOSInMap(caster))
+            if (inLineOfSight ? !*inLineOfSight : !target->IsWithinLOSInMap(caster))
             {
                 return false;
             }
@@ -7863,7 +7993,41 @@ SpellCastResult Spell::CanOpenLock(SpellEffectIndex effIndex, uint32 lockId, Ski
 void Spell::FillAreaTargets(UnitList& targetUnitMap, float radius, SpellNotifyPushType pushType, SpellTargets spellTargets, WorldObject* originalCaster /*=NULL*/)
 {
     MaNGOS::SpellNotifierCreatureAndPlayer notifier(*this, targetUnitMap, radius, pushType, spellTargets, originalCaster);
+
+    if (!m_cacheAreaTargets)
+    {
+        Cell::VisitAllObjects(notifier.GetCenterX(), notifier.GetCenterY(), m_caster->GetMap(), notifier, radius);
+        return;
+    }
+
+    // only destination searches have a z center
+    float centerZ = pushType == PUSH_DEST_CENTER ? notifier.i_centerZ : 0.0f;
+
+    // effects of this cast searching the same area share one grid visit
+    for (AreaTargetSearchList::const_iterator itr = m_areaTargetSearches.begin(); itr != m_areaTargetSearches.end(); ++itr)
+    {
+        if (itr->pushType == pushType && itr->spellTargets == spellTargets && itr->radius == radius &&
+            itr->originalCaster == notifier.i_originalCaster &&
+            itr->centerX == notifier.GetCenterX() && itr->centerY == notifier.GetCenterY() && itr->centerZ == centerZ)
+        {
+            targetUnitMap.insert(targetUnitMap.end(), itr->targets.begin(), itr->targets.end());
+            return;
+        }
+    }
+
+    m_areaTargetSearches.push_back(AreaTargetSearch());
+    AreaTargetSearch& search = m_areaTargetSearches.back();
+    search.centerX = notifier.GetCenterX();
+    search.centerY = notifier.GetCenterY();
+    search.centerZ = centerZ;
+    search.radius = radius;
+    search.pushType = pushType;
+    search.spellTargets = spellTargets;
+    search.originalCaster = notifier.i_originalCaster;
+
+    notifier.i_data = &search.targets;
     Cell::VisitAllObjects(notifier.GetCenterX(), notifier.GetCenterY(), m_caster->GetMap(), notifier, radius);
+    targetUnitMap.insert(targetUnitMap.end(), search.targets.begin(), search.targets.end());
 }
 
 void Spell::FillRaidOrPartyTargets(UnitList& targetUnitMap, Unit* member, float radius, bool raid, bool withPets, bool withcaster)
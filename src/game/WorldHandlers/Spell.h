@@ -33,6 +33,7 @@
 #include "LootMgr.h"
 #include "Unit.h"
 #include "Player.h"
+#include "Utilities/FrameArena.h"
 
 class WorldSession;
 class WorldPacket;
@@ -319,6 +320,10 @@ class Spell
 
         Spell(Unit* caster, SpellEntry const* info, bool triggered, ObjectGuid originalCasterGUID = ObjectGuid(), SpellEntry const* triggeredBy = NULL);
         ~Spell();
+
+        // every cast creates a spell, keep them in per thread free lists
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
         /**
          * @brief ׼ͷż
          * @param targets Ŀ
@@ -378,7 +383,7 @@ class Spell
 
         template<typename T> WorldObject* FindCorpseUsing();
 
-        bool CheckTarget(Unit* target, SpellEffectIndex eff);
+        bool CheckTarget(Unit* target, SpellEffectIndex eff, bool const* inLineOfSight = NULL);
         bool CanAutoCast(Unit* target);
 
         static void  SendCastResult(Player* caster, SpellEntry const* spellInfo, SpellCastResult result);
@@ -465,12 +470,16 @@ class Spell
         void CleanupTargetList();
         void ClearCastItem();
 
-        typedef std::list<Unit*> UnitList;
+        // target lists are filled and dropped within one update, their nodes come from the map thread arena
+        typedef std::list<Unit*, FrameAllocator<Unit*> > UnitList;
 
         void SetSelfContainer(Spell** pCurrentContainer) { m_selfContainer = pCurrentContainer; }
         Spell** GetSelfContainer() { return m_selfContainer; }
 
     protected:
+        // batched line of sight of area targets for CheckTarget
+        bool GetTargetsLineOfSight(UnitList const& targets, SpellEffectIndex eff, bool* inLineOfSight);
+
         bool HasGlobalCooldown();
         void TriggerGlobalCooldown();
         /**
@@ -554,6 +563,23 @@ class Spell
         void SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList& targetUnitMap);
 
         void FillAreaTargets(UnitList& targetUnitMap, float radius, SpellNotifyPushType pushType, SpellTargets spellTargets, WorldObject* originalCaster = NULL);
+
+        // grid searches done while FillTargetMap runs, effects with the same search reuse the result
+        struct AreaTargetSearch
+        {
+            float centerX, centerY, centerZ;
+            float radius;
+            SpellNotifyPushType pushType;
+            SpellTargets spellTargets;
+            WorldObject* originalCaster;
+            UnitList targets;
+        };
+        typedef std::vector<AreaTargetSearch> AreaTargetSearchList;
+        typedef std::map<Unit const*, bool> LineOfSightCache;
+
+        bool m_cacheAreaTargets;                            // set while FillTargetMap runs
+        AreaTargetSearchList m_areaTargetSearches;
+        LineOfSightCache m_lineOfSightCache;                // the line of sight does not depend on the effect
         void FillRaidOrPartyTargets(UnitList& targetUnitMap, Unit* member, float radius, bool raid, bool withPets, bool withcaster);
 
         // Returns GUID either of the 1st target from the implicit target list, or of explicit one (selected victim)
@@ -2877,6 +2877,9 @@ void Spell::EffectDispel(SpellEffectIndex eff_idx)
         // Send success log and really remove auras
         if (!success_list.empty())
         {
+            // all dispelled auras recalculate the target stats once
+            StatUpdateBatch statBatch(unitTarget);
+
             int32 count = success_list.size();
             WorldPacket data(SMSG_SPELLDISPELLOG, 8 + 8 + 4 + 1 + 4 + count * 5);
             data << unitTarget->GetPackGUID();              // Victim GUID
@@ -4810,6 +4813,7 @@ static ScriptInfo generateActivateCommand()
     si.buddyEntry = 0;
     si.searchRadiusOrGuid = 0;
     si.data_flags = 0x00;
+    si.PrepareBuddySearch();
     return si;
 }
 
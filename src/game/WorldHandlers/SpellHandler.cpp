@@ -227,7 +227,9 @@ void WorldSession::HandleOpenItemOpcode(WorldPacket& recvPacket)
             uint32 flags = fields[1].GetUInt32();
 
             pItem->SetGuidValue(ITEM_FIELD_GIFTCREATOR, ObjectGuid());
+            pUser->UnindexItem(pItem);
             pItem->SetEntry(entry);
+            pUser->IndexItem(pItem);
             pItem->SetUInt32Value(ITEM_FIELD_FLAGS, flags);
             pItem->SetState(ITEM_CHANGED, pUser);
             delete result;
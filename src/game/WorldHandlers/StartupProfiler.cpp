@@ -0,0 +1,207 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "StartupProfiler.h"
+#include "Log.h"
+#include "Timer.h"
+#include "Utilities/ProgressBar.h"
+
+#include <ace/Guard_T.h>
+
+#include <stdio.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+INSTANTIATE_SINGLETON_1(StartupProfiler);
+
+// resident set size in KB, 0 where the platform gives no cheap way to read it
+static uint64 GetResidentMemory()
+{
+#if defined(__linux__)
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+    {
+        return 0;
+    }
+
+    unsigned long size = 0, resident = 0;
+    int read = fscanf(statm, "%lu %lu", &size, &resident);
+    fclose(statm);
+
+    if (read != 2)
+    {
+        return 0;
+    }
+
+    return uint64(resident) * uint64(sysconf(_SC_PAGESIZE)) / 1024;
+#else
+    return 0;
+#endif
+}
+
+// names are literals from the loaders, only quotes and backslashes need escaping
+static std::string JsonString(std::string const& str)
+{
+    std::string escaped = "\"";
+
+    for (std::string::const_iterator itr = str.begin(); itr != str.end(); ++itr)
+    {
+        if (*itr == '"' || *itr == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += *itr;
+    }
+
+    escaped += '"';
+    return escaped;
+}
+
+StartupProfiler::StartupProfiler() : m_enabled(false), m_inPhase(false), m_phaseStart(0), m_phaseRows(0), m_phaseRss(0), m_startRss(0), m_start(0)
+{
+}
+
+void StartupProfiler::Enable(std::string const& reportFile)
+{
+    m_enabled = true;
+    m_reportFile = reportFile;
+    m_start = getMSTime();
+    m_startRss = GetResidentMemory();
+}
+
+void StartupProfiler::BeginPhase(char const* name)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    EndPhase();
+
+    Phase phase;
+    phase.name = name;
+    phase.time = 0;
+    phase.rows = 0;
+    phase.rssGrowth = 0;
+    m_phases.push_back(phase);
+
+    m_inPhase = true;
+    m_phaseStart = getMSTime();
+    m_phaseRows = BarGoLink::GetTotalRowCount();
+    m_phaseRss = GetResidentMemory();
+}
+
+void StartupProfiler::EndPhase()
+{
+    if (!m_inPhase)
+    {
+        return;
+    }
+
+    Phase& phase = m_phases.back();
+    phase.time = getMSTimeDiff(m_phaseStart, getMSTime());
+    phase.rows = BarGoLink::GetTotalRowCount() - m_phaseRows;
+    phase.rssGrowth = int64(GetResidentMemory()) - int64(m_phaseRss);
+
+    m_inPhase = false;
+}
+
+void StartupProfiler::AddLoader(char const* name, uint32 time, int64 rows)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (!m_inPhase)
+    {
+        return;
+    }
+
+    Loader loader;
+    loader.name = name;
+    loader.time = time;
+    loader.rows = rows;
+    m_phases.back().loaders.push_back(loader);
+}
+
+bool StartupProfiler::WriteReport()
+{
+    if (!m_enabled)
+    {
+        return false;
+    }
+
+    EndPhase();
+
+    FILE* report = fopen(m_reportFile.c_str(), "w");
+    if (!report)
+    {
+        sLog.outError("Startup profile: can't write report file %s", m_reportFile.c_str());
+        return false;
+    }
+
+    uint64 rss = GetResidentMemory();
+
+    fprintf(report, "{\n");
+    fprintf(report, "  \"total_ms\": %u,\n", getMSTimeDiff(m_start, getMSTime()));
+    fprintf(report, "  \"rss_kb\": " UI64FMTD ",\n", rss);
+    fprintf(report, "  \"rss_growth_kb\": " SI64FMTD ",\n", int64(rss) - int64(m_startRss));
+    fprintf(report, "  \"phases\": [");
+
+    for (size_t i = 0; i < m_phases.size(); ++i)
+    {
+        Phase const& phase = m_phases[i];
+
+        fprintf(report, "%s\n    {\"name\": %s, \"ms\": %u, \"rows\": " SI64FMTD ", \"rss_growth_kb\": " SI64FMTD ", \"loaders\": [",
+                i ? "," : "", JsonString(phase.name).c_str(), phase.time, phase.rows, phase.rssGrowth);
+
+        for (size_t j = 0; j < phase.loaders.size(); ++j)
+        {
+            Loader const& loader = phase.loaders[j];
+
+            fprintf(report, "%s\n      {\"name\": %s, \"ms\": %u, \"rows\": ", j ? "," : "", JsonString(loader.name).c_str(), loader.time);
+            if (loader.rows < 0)
+            {
+                fprintf(report, "null}");
+            }
+            else
+            {
+                fprintf(report, SI64FMTD "}", loader.rows);
+            }
+        }
+
+        fprintf(report, "%s]}", phase.loaders.empty() ? "" : "\n    ");
+    }
+
+    fprintf(report, "\n  ]\n}\n");
+    fclose(report);
+
+    sLog.outString("Startup profile with " SIZEFMTD " phases written to %s", m_phases.size(), m_reportFile.c_str());
+    return true;
+}
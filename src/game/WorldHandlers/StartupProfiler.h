@@ -0,0 +1,116 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_STARTUP_PROFILER
+#define MANGOS_H_STARTUP_PROFILER
+
+#include <ace/Thread_Mutex.h>
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Measures the world loaders for the --startup-profile mode
+ *
+ * SetInitialWorldSettings splits the startup into phases, every phase keeps
+ * its wall time, the rows announced by the progress bars of its loaders and
+ * the growth of the resident memory. Loaders timed elsewhere (single DBC
+ * files, parallel template loaders) are added to the running phase. The
+ * result is written as JSON so startup runs can be compared by scripts.
+ */
+class StartupProfiler
+{
+    public:
+        StartupProfiler();
+
+        /**
+         * @brief Turns the profiling on, all calls are ignored otherwise
+         *
+         * @param reportFile file the report is written to
+         */
+        void Enable(std::string const& reportFile);
+        bool IsEnabled() const { return m_enabled; }
+
+        /**
+         * @brief Closes the running phase and starts the next one
+         *
+         * @param name name of the phase in the report
+         */
+        void BeginPhase(char const* name);
+
+        /**
+         * @brief Adds a loader measured by the caller to the running phase
+         *
+         * @param name name of the loader
+         * @param time ms spent in the loader
+         * @param rows rows loaded, negative if not known
+         */
+        void AddLoader(char const* name, uint32 time, int64 rows);
+
+        /**
+         * @brief Closes the running phase and writes the report
+         *
+         * @return false if the report file can't be written
+         */
+        bool WriteReport();
+
+    private:
+        struct Loader
+        {
+            std::string name;
+            uint32 time;
+            int64 rows;
+        };
+
+        struct Phase
+        {
+            std::string name;
+            uint32 time;
+            int64 rows;
+            int64 rssGrowth;                                // KB
+            std::vector<Loader> loaders;
+        };
+
+        void EndPhase();
+
+        bool m_enabled;
+        std::string m_reportFile;
+        std::vector<Phase> m_phases;
+
+        bool m_inPhase;
+        uint32 m_phaseStart;
+        long m_phaseRows;
+        uint64 m_phaseRss;
+        uint64 m_startRss;
+        uint32 m_start;
+
+        ACE_Thread_Mutex m_lock;                            // AddLoader is called from the loader threads
+};
+
+#define sStartupProfiler MaNGOS::Singleton<StartupProfiler>::Instance()
+
+#endif
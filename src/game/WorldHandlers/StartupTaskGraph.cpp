@@ -0,0 +1,200 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "StartupTaskGraph.h"
+#include "StartupProfiler.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+#include "Timer.h"
+#include "Utilities/ProgressBar.h"
+
+#include <algorithm>
+
+StartupTaskGraph::StartupTaskGraph() : m_done(0), m_threads(0), m_wallTime(0), m_condition(m_lock)
+{
+}
+
+void StartupTaskGraph::AddTask(const char* name, TaskFunc func, std::initializer_list<const char*> dependencies)
+{
+    Task task;
+    task.name = name;
+    task.func = func;
+    task.waitingFor = 0;
+    task.time = 0;
+
+    size_t index = m_tasks.size();
+
+    for (std::initializer_list<const char*>::const_iterator dep = dependencies.begin(); dep != dependencies.end(); ++dep)
+    {
+        bool found = false;
+        for (size_t i = 0; i < m_tasks.size(); ++i)
+        {
+            if (strcmp(m_tasks[i].name, *dep) == 0)
+            {
+                m_tasks[i].dependents.push_back(index);
+                ++task.waitingFor;
+                found = true;
+                break;
+            }
+        }
+
+        // only tasks added before can be depended on, so the graph never has a cycle
+        MANGOS_ASSERT(found && "startup task depends on an unknown task");
+    }
+
+    m_tasks.push_back(task);
+}
+
+void StartupTaskGraph::Run(uint32 threads)
+{
+    uint32 start = getMSTime();
+
+    if (threads <= 1 || m_tasks.size() < 2)
+    {
+        m_threads = 1;
+
+        for (size_t i = 0; i < m_tasks.size(); ++i)
+        {
+            RunTask(i);
+        }
+    }
+    else
+    {
+        m_threads = threads;
+        m_done = 0;
+
+        for (size_t i = 0; i < m_tasks.size(); ++i)
+        {
+            if (!m_tasks[i].waitingFor)
+            {
+                m_ready.insert(i);
+            }
+        }
+
+        // progress bars of concurrent loaders would overwrite each other
+        bool showProgress = BarGoLink::GetOutputState();
+        BarGoLink::SetOutputState(false);
+
+        if (activate(THR_NEW_LWP | THR_JOINABLE, int(threads)) == -1)
+        {
+            sLog.outError("StartupTaskGraph: can't start %u threads, loading in the main thread", threads);
+            m_threads = 1;
+
+            for (size_t i = 0; i < m_tasks.size(); ++i)
+            {
+                RunTask(i);
+            }
+        }
+        else
+        {
+            wait();
+        }
+
+        BarGoLink::SetOutputState(showProgress);
+    }
+
+    m_wallTime = getMSTimeDiff(start, getMSTime());
+}
+
+int StartupTaskGraph::svc()
+{
+    WorldDatabase.ThreadStart();
+
+    for (;;)
+    {
+        size_t index;
+
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, -1);
+
+            while (m_ready.empty() && m_done < m_tasks.size())
+            {
+                m_condition.wait();
+            }
+
+            if (m_ready.empty())
+            {
+                break;
+            }
+
+            index = *m_ready.begin();
+            m_ready.erase(m_ready.begin());
+        }
+
+        RunTask(index);
+
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, -1);
+
+        ++m_done;
+
+        std::vector<size_t> const& dependents = m_tasks[index].dependents;
+        for (size_t i = 0; i < dependents.size(); ++i)
+        {
+            if (--m_tasks[dependents[i]].waitingFor == 0)
+            {
+                m_ready.insert(dependents[i]);
+            }
+        }
+
+        m_condition.broadcast();
+    }
+
+    WorldDatabase.ThreadEnd();
+    return 0;
+}
+
+void StartupTaskGraph::RunTask(size_t index)
+{
+    Task& task = m_tasks[index];
+
+    uint32 start = getMSTime();
+    task.func();
+    task.time = getMSTimeDiff(start, getMSTime());
+
+    // rows of parallel tasks can't be told apart, the phase keeps their sum
+    sStartupProfiler.AddLoader(task.name, task.time, -1);
+}
+
+void StartupTaskGraph::LogTimings() const
+{
+    std::vector<size_t> order(m_tasks.size());
+    uint32 total = 0;
+
+    for (size_t i = 0; i < m_tasks.size(); ++i)
+    {
+        order[i] = i;
+        total += m_tasks[i].time;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return m_tasks[a].time > m_tasks[b].time; });
+
+    sLog.outString("Startup loaders: %u ms on %u thread(s), %u ms spent in the loaders", m_wallTime, m_threads, total);
+
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        sLog.outString("    %-32s %6u ms", m_tasks[order[i]].name, m_tasks[order[i]].time);
+    }
+
+    sLog.outString();
+}
@@ -0,0 +1,99 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_STARTUP_TASK_GRAPH
+#define MANGOS_H_STARTUP_TASK_GRAPH
+
+#include <ace/Task.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+#include "Common.h"
+
+#include <initializer_list>
+#include <set>
+#include <vector>
+
+/**
+ * @brief Runs startup loaders in dependency order, independent ones in parallel
+ *
+ * Every task names the tasks it needs to be finished before it may start,
+ * those have to be added before it. With more than one thread each worker
+ * takes the first task (in the order added) whose dependencies are done, so
+ * loaders waiting on the database overlap. The time spent in every task is
+ * kept for the startup timing report.
+ */
+class StartupTaskGraph : protected ACE_Task_Base
+{
+    public:
+        typedef void (*TaskFunc)();
+
+        StartupTaskGraph();
+
+        /**
+         * @brief Adds a loader task
+         *
+         * @param name name of the task, used by dependencies and the timing report
+         * @param func loader to run
+         * @param dependencies names of tasks added before, which have to finish before func runs
+         */
+        void AddTask(const char* name, TaskFunc func, std::initializer_list<const char*> dependencies = {});
+
+        /**
+         * @brief Runs all tasks and returns when they are done
+         *
+         * @param threads worker threads, with 1 or less the tasks run in the calling thread in the order added
+         */
+        void Run(uint32 threads);
+
+        /**
+         * @brief Logs the time spent in every task, slowest first
+         *
+         */
+        void LogTimings() const;
+
+    private:
+        struct Task
+        {
+            const char* name;
+            TaskFunc func;
+            std::vector<size_t> dependents;                 // tasks waiting on this one
+            uint32 waitingFor;                              // unfinished dependencies
+            uint32 time;                                    // ms spent in func
+        };
+
+        int svc() override;
+        void RunTask(size_t index);
+
+        std::vector<Task> m_tasks;
+        std::set<size_t> m_ready;                           // tasks with all dependencies done
+        size_t m_done;
+        uint32 m_threads;
+        uint32 m_wallTime;
+
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_condition;
+};
+
+#endif
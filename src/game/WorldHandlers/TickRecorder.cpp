@@ -0,0 +1,620 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "TickRecorder.h"
+#include "Database/DatabaseEnv.h"
+#include "GameTime.h"
+#include "Log.h"
+#include "Map.h"
+#include "MapManager.h"
+#include "Player.h"
+#include "Timer.h"
+#include "Util.h"
+#include "World.h"
+#include "WorldPacket.h"
+#include "WorldSession.h"
+
+#include <ace/Guard_T.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdio.h>
+#include <thread>
+
+INSTANTIATE_SINGLETON_1(TickRecorder);
+
+TickRecorder::TickRecorder() : m_active(false), m_mapId(0), m_instanceId(0), m_rotateTicks(0),
+    m_file(NULL), m_tick(0), m_fileTicks(0), m_inTick(false)
+{
+}
+
+void TickRecorder::Start(std::string const& file, uint32 mapId, uint32 instanceId, uint32 rotateTicks)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    CloseFile();
+
+    m_fileName = file;
+    m_mapId = mapId;
+    m_instanceId = instanceId;
+    m_rotateTicks = rotateTicks;
+    m_seeds.seed(std::random_device()());
+    m_active = true;
+
+    sLog.outString("Recording the updates of map %u instance %u to %s", mapId, instanceId, file.c_str());
+}
+
+void TickRecorder::Stop()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    m_active = false;
+    CloseFile();
+}
+
+bool TickRecorder::IsRecorded(Map const* map) const
+{
+    return map->GetId() == m_mapId && map->GetInstanceId() == m_instanceId;
+}
+
+void TickRecorder::BeginTick(Map* map, uint32 diff)
+{
+    if (!IsActive() || !IsRecorded(map))
+    {
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (!m_file || (m_rotateTicks && m_fileTicks >= m_rotateTicks))
+    {
+        if (!OpenFile(map))
+        {
+            m_active = false;
+            return;
+        }
+    }
+
+    ++m_tick;
+    ++m_fileTicks;
+    m_inTick = true;
+
+    // every update starts its draws over from a known seed
+    uint32 seed = m_seeds();
+    seed_thread_rand(seed);
+
+    m_buffer << uint8(RECORD_TICK) << m_tick << diff << seed;
+}
+
+void TickRecorder::EndTick(Map* map)
+{
+    if (!IsActive() || !IsRecorded(map))
+    {
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    m_inTick = false;
+    Flush();
+}
+
+void TickRecorder::PlayerEntered(Map* map, Player* player)
+{
+    if (!IsActive() || !IsRecorded(map))
+    {
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (m_file)
+    {
+        WriteEnter(player);
+    }
+}
+
+void TickRecorder::PlayerLeft(Map* map, Player* player)
+{
+    if (!IsActive() || !IsRecorded(map))
+    {
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (m_file)
+    {
+        m_buffer << uint8(RECORD_LEAVE) << GetRecordTick() << player->GetObjectGuid().GetRawValue();
+    }
+}
+
+void TickRecorder::PacketHandled(WorldSession* session, WorldPacket const* packet)
+{
+    Player* player = session->GetPlayer();
+    if (!player || !player->IsInWorld() || !IsRecorded(player->GetMap()))
+    {
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (!m_file)
+    {
+        return;
+    }
+
+    m_buffer << uint8(RECORD_PACKET) << GetRecordTick() << session->GetAccountId();
+    m_buffer << uint16(packet->GetOpcode()) << uint32(packet->size());
+    if (packet->size())
+    {
+        m_buffer.append(packet->contents(), packet->size());
+    }
+}
+
+bool TickRecorder::OpenFile(Map* map)
+{
+    CloseFile();
+
+    // the last capture stays around, a spike right after a rotation is still complete
+    std::string previous = m_fileName + ".prev";
+    remove(previous.c_str());
+    rename(m_fileName.c_str(), previous.c_str());
+
+    m_file = fopen(m_fileName.c_str(), "wb");
+    if (!m_file)
+    {
+        sLog.outError("TickRecorder: can't write %s, recording stopped", m_fileName.c_str());
+        return false;
+    }
+
+    m_tick = 0;
+    m_fileTicks = 0;
+    m_inTick = false;
+
+    m_buffer.clear();
+    m_buffer << FILE_MAGIC << FILE_VERSION << m_mapId << m_instanceId << uint64(time(NULL));
+
+    // the players already there enter at the first update of the file
+    Map::PlayerList const& players = map->GetPlayers();
+    for (Map::PlayerList::const_iterator itr = players.begin(); itr != players.end(); ++itr)
+    {
+        if (Player* player = itr->getSource())
+        {
+            WriteEnter(player);
+        }
+    }
+
+    return true;
+}
+
+void TickRecorder::CloseFile()
+{
+    if (!m_file)
+    {
+        return;
+    }
+
+    Flush();
+    fclose(m_file);
+    m_file = NULL;
+}
+
+void TickRecorder::Flush()
+{
+    if (m_file && m_buffer.size())
+    {
+        fwrite(m_buffer.contents(), 1, m_buffer.size(), m_file);
+        fflush(m_file);                                     // a crash must not take the spike with it
+    }
+
+    m_buffer.clear();
+}
+
+void TickRecorder::WriteEnter(Player* player)
+{
+    m_buffer << uint8(RECORD_ENTER) << GetRecordTick();
+    m_buffer << player->GetSession()->GetAccountId() << uint32(player->GetSession()->GetSecurity());
+    m_buffer << player->GetObjectGuid().GetRawValue();
+    m_buffer << player->GetPositionX() << player->GetPositionY() << player->GetPositionZ() << player->GetOrientation();
+}
+
+namespace
+{
+    struct ReplayEnter
+    {
+        uint32 account;
+        uint32 security;
+        ObjectGuid guid;
+        float x, y, z, o;
+    };
+
+    struct ReplayPacket
+    {
+        uint32 account;
+        WorldPacket* packet;
+    };
+
+    struct ReplayTick
+    {
+        ReplayTick() : diff(0), seed(0), recorded(false) {}
+
+        uint32 diff;
+        uint32 seed;
+        bool recorded;                                      // the update itself is in the capture
+        std::vector<ReplayEnter> enters;
+        std::vector<ObjectGuid> leaves;
+        std::vector<ReplayPacket> packets;
+    };
+
+    typedef std::map<uint32, WorldSession*> ReplaySessions;
+
+    ReplayTick& GetReplayTick(std::vector<ReplayTick>& ticks, uint32 tick)
+    {
+        if (tick >= ticks.size())
+        {
+            ticks.resize(tick + 1);
+        }
+
+        return ticks[tick];
+    }
+
+    // reads the capture, a file cut by a crash keeps the updates written before
+    bool ReadCapture(char const* file, uint32& mapId, uint32& instanceId, std::vector<ReplayTick>& ticks)
+    {
+        FILE* in = fopen(file, "rb");
+        if (!in)
+        {
+            sLog.outError("TickReplay: can't open %s", file);
+            return false;
+        }
+
+        ByteBuffer data;
+        uint8 chunk[64 * 1024];
+        size_t read;
+        while ((read = fread(chunk, 1, sizeof(chunk), in)) > 0)
+        {
+            data.append(chunk, read);
+        }
+        fclose(in);
+
+        try
+        {
+            uint32 magic, version;
+            uint64 startTime;
+            data >> magic >> version >> mapId >> instanceId >> startTime;
+
+            if (magic != TickRecorder::FILE_MAGIC || version != TickRecorder::FILE_VERSION)
+            {
+                sLog.outError("TickReplay: %s is not a capture of this version", file);
+                return false;
+            }
+
+            while (data.rpos() < data.size())
+            {
+                uint8 type;
+                uint32 tick;
+                data >> type >> tick;
+
+                switch (type)
+                {
+                    case TickRecorder::RECORD_TICK:
+                    {
+                        ReplayTick& replayTick = GetReplayTick(ticks, tick);
+                        data >> replayTick.diff >> replayTick.seed;
+                        replayTick.recorded = true;
+                        break;
+                    }
+                    case TickRecorder::RECORD_ENTER:
+                    {
+                        ReplayEnter enter;
+                        uint64 guid;
+                        data >> enter.account >> enter.security >> guid >> enter.x >> enter.y >> enter.z >> enter.o;
+                        enter.guid = ObjectGuid(guid);
+                        GetReplayTick(ticks, tick).enters.push_back(enter);
+                        break;
+                    }
+                    case TickRecorder::RECORD_LEAVE:
+                    {
+                        uint64 guid;
+                        data >> guid;
+                        GetReplayTick(ticks, tick).leaves.push_back(ObjectGuid(guid));
+                        break;
+                    }
+                    case TickRecorder::RECORD_PACKET:
+                    {
+                        ReplayPacket replayPacket;
+                        uint16 opcode;
+                        uint32 size;
+                        data >> replayPacket.account >> opcode >> size;
+                        if (data.rpos() + size > data.size())
+                        {
+                            throw ByteBufferException(false, data.rpos(), size, data.size());
+                        }
+
+                        replayPacket.packet = new WorldPacket(opcode, size);
+                        if (size)
+                        {
+                            replayPacket.packet->append(data.contents() + data.rpos(), size);
+                            data.read_skip(size);
+                        }
+                        GetReplayTick(ticks, tick).packets.push_back(replayPacket);
+                        break;
+                    }
+                    default:
+                        sLog.outError("TickReplay: unknown record %u in %s, the rest is skipped", uint32(type), file);
+                        return true;
+                }
+            }
+        }
+        catch (ByteBufferException&)
+        {
+            sLog.outError("TickReplay: %s ends in the middle of a record, the rest is skipped", file);
+        }
+
+        return true;
+    }
+
+    WorldSession* ReplayLogin(Map* map, ReplayEnter const& enter)
+    {
+        if (sWorld.FindSession(enter.account))
+        {
+            return NULL;                                    // already logged in by an earlier record
+        }
+
+        WorldSession* session = new WorldSession(enter.account, NULL, AccountTypes(enter.security), 0, LOCALE_enUS);
+        session->SetOffline(true);
+        sWorld.AddOfflineSession(session);
+
+        WorldPacket* login = new WorldPacket(CMSG_PLAYER_LOGIN, 8);
+        *login << enter.guid;
+        session->QueuePacket(login);
+
+        WorldSessionFilter filter(session);
+        session->Update(filter);
+
+        // the login waits for its queries, not counted in the update times
+        uint32 start = getMSTime();
+        while (session->PlayerLoading() && getMSTimeDiff(start, getMSTime()) < 30000)
+        {
+            CharacterDatabase.ProcessResultQueue();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        Player* player = session->GetPlayer();
+        if (!player || !player->IsInWorld() || player->GetMap() != map)
+        {
+            sLog.outError("TickReplay: %s is not on the replayed map after the login, skipped", enter.guid.GetString().c_str());
+            if (player)
+            {
+                session->LogoutPlayer(false);
+            }
+
+            sWorld.RemoveOfflineSession(enter.account);
+            delete session;
+            return NULL;
+        }
+
+        // the database has the last save, the capture the position at the entry
+        map->PlayerRelocation(player, enter.x, enter.y, enter.z, enter.o);
+        return session;
+    }
+
+    void ReplayLogout(ReplaySessions& sessions, uint32 account)
+    {
+        ReplaySessions::iterator itr = sessions.find(account);
+        if (itr == sessions.end())
+        {
+            return;
+        }
+
+        WorldSession* session = itr->second;
+        if (session->GetPlayer())
+        {
+            session->LogoutPlayer(false);
+        }
+
+        sWorld.RemoveOfflineSession(account);
+        delete session;
+        sessions.erase(itr);
+    }
+
+    uint32 ReplayAccountOf(ReplaySessions const& sessions, ObjectGuid guid)
+    {
+        for (ReplaySessions::const_iterator itr = sessions.begin(); itr != sessions.end(); ++itr)
+        {
+            if (itr->second->GetPlayer() && itr->second->GetPlayer()->GetObjectGuid() == guid)
+            {
+                return itr->first;
+            }
+        }
+
+        return 0;
+    }
+
+    double GetPercentile(std::vector<double> sorted, double fraction)
+    {
+        if (sorted.empty())
+        {
+            return 0.0;
+        }
+
+        size_t rank = size_t(fraction * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+}
+
+bool TickReplay::Run(char const* file)
+{
+    uint32 mapId = 0;
+    uint32 instanceId = 0;
+    std::vector<ReplayTick> ticks;
+
+    if (!ReadCapture(file, mapId, instanceId, ticks))
+    {
+        return false;
+    }
+
+    MapEntry const* entry = sMapStore.LookupEntry(mapId);
+    if (!entry || entry->Instanceable() || instanceId)
+    {
+        sLog.outError("TickReplay: map %u instance %u can't be replayed, only continents can be recreated", mapId, instanceId);
+        return false;
+    }
+
+    Map* map = sMapMgr.CreateMap(mapId, NULL);
+    if (!map)
+    {
+        return false;
+    }
+
+    sLog.outString("Replaying " SIZEFMTD " updates of map %u from %s", ticks.size() ? ticks.size() - 1 : 0, mapId, file);
+
+    ReplaySessions sessions;
+    std::vector<double> times;                              // ms per replayed update
+    std::vector<uint32> packetCounts;
+    uint64 packets = 0;
+
+    for (uint32 tick = 1; tick < ticks.size(); ++tick)
+    {
+        ReplayTick& replayTick = ticks[tick];
+
+        for (std::vector<ObjectGuid>::const_iterator itr = replayTick.leaves.begin(); itr != replayTick.leaves.end(); ++itr)
+        {
+            if (uint32 account = ReplayAccountOf(sessions, *itr))
+            {
+                ReplayLogout(sessions, account);
+            }
+        }
+
+        for (std::vector<ReplayEnter>::const_iterator itr = replayTick.enters.begin(); itr != replayTick.enters.end(); ++itr)
+        {
+            if (WorldSession* session = ReplayLogin(map, *itr))
+            {
+                sessions[itr->account] = session;
+            }
+        }
+
+        for (std::vector<ReplayPacket>::iterator itr = replayTick.packets.begin(); itr != replayTick.packets.end(); ++itr)
+        {
+            ReplaySessions::iterator session = sessions.find(itr->account);
+            if (session != sessions.end())
+            {
+                session->second->QueuePacket(itr->packet);
+                ++packets;
+            }
+            else
+            {
+                delete itr->packet;
+            }
+        }
+
+        if (!replayTick.recorded)
+        {
+            continue;                                       // the capture ends before this update
+        }
+
+        // the world thread handles its packets before the maps are updated
+        for (ReplaySessions::iterator itr = sessions.begin(); itr != sessions.end(); ++itr)
+        {
+            WorldSessionFilter filter(itr->second);
+            itr->second->Update(filter);
+        }
+
+        CharacterDatabase.ProcessResultQueue();
+        WorldDatabase.ProcessResultQueue();
+        GameTime::UpdateGameTimers();
+
+        seed_thread_rand(replayTick.seed);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        map->Update(replayTick.diff);
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        packetCounts.push_back(uint32(replayTick.packets.size()));
+    }
+
+    while (!sessions.empty())
+    {
+        ReplayLogout(sessions, sessions.begin()->first);
+    }
+
+    std::vector<double> sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        total += times[i];
+    }
+
+    double mean = times.empty() ? 0.0 : total / times.size();
+
+    sLog.outString("Replayed " SIZEFMTD " updates with " UI64FMTD " packets in %.0f ms", times.size(), packets, total);
+    sLog.outString("Update time: mean %.2f ms, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms", mean,
+                   GetPercentile(sorted, 0.50), GetPercentile(sorted, 0.95), GetPercentile(sorted, 0.99), sorted.empty() ? 0.0 : sorted.back());
+
+    // the slowest updates, to be looked at with a profiler
+    std::vector<size_t> slowest(times.size());
+    for (size_t i = 0; i < slowest.size(); ++i)
+    {
+        slowest[i] = i;
+    }
+    size_t shown = std::min<size_t>(5, slowest.size());
+    std::partial_sort(slowest.begin(), slowest.begin() + shown, slowest.end(), [&times](size_t a, size_t b) { return times[a] > times[b]; });
+    for (size_t i = 0; i < shown; ++i)
+    {
+        sLog.outString("  update " SIZEFMTD ": %.2f ms, %u packets", slowest[i] + 1, times[slowest[i]], packetCounts[slowest[i]]);
+    }
+
+    std::string reportFile = std::string(file) + ".json";
+    FILE* out = fopen(reportFile.c_str(), "w");
+    if (!out)
+    {
+        sLog.outError("TickReplay: can't write the report %s", reportFile.c_str());
+        return false;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"map\": %u,\n", mapId);
+    fprintf(out, "  \"updates\": " SIZEFMTD ",\n", times.size());
+    fprintf(out, "  \"packets\": " UI64FMTD ",\n", packets);
+    fprintf(out, "  \"total_ms\": %.3f,\n", total);
+    fprintf(out, "  \"mean_ms\": %.3f,\n", mean);
+    fprintf(out, "  \"p50_ms\": %.3f,\n", GetPercentile(sorted, 0.50));
+    fprintf(out, "  \"p95_ms\": %.3f,\n", GetPercentile(sorted, 0.95));
+    fprintf(out, "  \"p99_ms\": %.3f,\n", GetPercentile(sorted, 0.99));
+    fprintf(out, "  \"max_ms\": %.3f,\n", sorted.empty() ? 0.0 : sorted.back());
+    fprintf(out, "  \"update_ms\": [");
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        fprintf(out, "%s%.3f", i ? ", " : "", times[i]);
+    }
+    fprintf(out, "]\n}\n");
+    fclose(out);
+
+    sLog.outString("Replay report written to %s", reportFile.c_str());
+    return true;
+}
@@ -0,0 +1,149 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_H_TICK_RECORDER
+#define MANGOS_H_TICK_RECORDER
+
+#include <ace/Thread_Mutex.h>
+
+#include "Common.h"
+#include "ByteBuffer.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+#include <random>
+#include <string>
+
+class Map;
+class Player;
+class WorldPacket;
+class WorldSession;
+
+/**
+ * @brief Records the input of one map so a lag spike can be replayed offline
+ *
+ * While enabled, every update of the recorded map writes its diff and the seed
+ * its thread random generator restarts from, and every packet a player of the
+ * map sends is written with the update that handles it: packets handled by the
+ * map thread belong to the running update, packets handled by the world thread
+ * to the next one. Players entering and leaving the map are written too, so
+ * mangosd --replay can log them in and out at the same update.
+ *
+ * The capture restarts every Recorder.RotateTicks updates, the previous one is
+ * kept as <file>.prev, so the last minutes before a spike are always on disk.
+ *
+ * Only the map thread is made repeatable: the world thread, the region update
+ * jobs and the database keep their own timing, so a replay reproduces the load
+ * of the capture rather than every single roll.
+ */
+class TickRecorder
+{
+    public:
+        enum RecordType
+        {
+            RECORD_TICK         = 1,                        // tick, diff, seed
+            RECORD_ENTER        = 2,                        // tick, account, security, guid, x, y, z, o
+            RECORD_LEAVE        = 3,                        // tick, guid
+            RECORD_PACKET       = 4                         // tick, account, opcode, size, data
+        };
+
+        static const uint32 FILE_MAGIC = 0x4345524D;         // "MREC"
+        static const uint32 FILE_VERSION = 1;
+
+        TickRecorder();
+
+        /**
+         * @brief Starts recording the map at its next update
+         *
+         * @param file capture written to, the previous one is renamed to file.prev
+         * @param mapId map recorded
+         * @param instanceId instance recorded, 0 for continents
+         * @param rotateTicks updates per capture file, 0 to never rotate
+         */
+        void Start(std::string const& file, uint32 mapId, uint32 instanceId, uint32 rotateTicks);
+        void Stop();
+
+        bool IsActive() const { return m_active.load(std::memory_order_relaxed); }
+
+        // called by the map thread around Map::Update
+        void BeginTick(Map* map, uint32 diff);
+        void EndTick(Map* map);
+
+        // called when a player is added to or removed from a map
+        void PlayerEntered(Map* map, Player* player);
+        void PlayerLeft(Map* map, Player* player);
+
+        // called for every packet a session handles, before its handler
+        void PacketHandled(WorldSession* session, WorldPacket const* packet);
+
+    private:
+        bool IsRecorded(Map const* map) const;
+        bool OpenFile(Map* map);
+        void CloseFile();
+        void Flush();
+        uint32 GetRecordTick() const { return m_inTick ? m_tick : m_tick + 1; }
+        void WriteEnter(Player* player);
+
+        std::atomic<bool> m_active;
+        std::string m_fileName;
+        uint32 m_mapId;
+        uint32 m_instanceId;
+        uint32 m_rotateTicks;
+
+        FILE* m_file;
+        ByteBuffer m_buffer;                                // records since the last flush
+        uint32 m_tick;                                      // of the running or the last update
+        uint32 m_fileTicks;
+        bool m_inTick;
+        std::mt19937 m_seeds;
+
+        ACE_Thread_Mutex m_lock;                            // packets are also handled by the world thread
+};
+
+#define sTickRecorder MaNGOS::Singleton<TickRecorder>::Instance()
+
+/**
+ * @brief Replays a capture of the TickRecorder without network, for mangosd --replay
+ *
+ * The recorded players are logged in from the character database when they
+ * entered the map in the capture and put back at their recorded position, then
+ * every update gets the packets, the diff and the random seed of the capture.
+ * The update durations are printed and written as JSON next to the capture, so
+ * two builds can be compared on the same input. The characters are saved as
+ * usual, so use a copy of the character database.
+ */
+class TickReplay
+{
+    public:
+        /**
+         * @brief Replays the capture against the loaded world
+         *
+         * @param file capture of the TickRecorder
+         * @return false if the capture can't be read or its map can't be created
+         */
+        static bool Run(char const* file);
+};
+
+#endif
@@ -367,6 +367,7 @@ bool GlobalTransport::GenerateWaypoints()
     TaxiPathNodeList const& path = sTaxiPathNodesByPath[pathid];
 
     std::vector<keyFrame> keyFrames;
+    WayPointMap wayPoints;
     int mapChange = 0;
 
     m_mapsUsed.clear();
@@ -491,7 +492,7 @@ bool GlobalTransport::GenerateWaypoints()
     }
 
     WayPoint pos(keyFrames[0].node->mapid, keyFrames[0].node->x, keyFrames[0].node->y, keyFrames[0].node->z, teleport);
-    m_WayPoints[0] = pos;
+    wayPoints[0] = pos;
     t += keyFrames[0].node->delay * 1000;
 
     uint32 cM = keyFrames[0].node->mapid;
@@ -527,7 +528,7 @@ bool GlobalTransport::GenerateWaypoints()
                     pos = WayPoint(keyFrames[i].node->mapid, newX, newY, newZ, teleport);
                     if (teleport)
                     {
-                        m_WayPoints[t] = pos;
+                        wayPoints[t] = pos;
                     }
                 }
 
@@ -581,7 +582,7 @@ bool GlobalTransport::GenerateWaypoints()
         //        sLog.outString("T: %d, x: %f, y: %f, z: %f, t:%d", t, pos.x, pos.y, pos.z, teleport);
 
         // if (teleport)
-        m_WayPoints[t] = pos;
+        wayPoints[t] = pos;
 
         t += keyFrames[i + 1].node->delay * 1000;
         //        sLog.outString("------");
@@ -591,13 +592,23 @@ bool GlobalTransport::GenerateWaypoints()
 
     //    sLog.outDetail("    Generated %lu waypoints, total time %u.", (unsigned long)m_WayPoints.size(), timer);
 
-    m_next = m_WayPoints.begin();                           // will used in MoveToNextWayPoint for init m_curr
+    m_WayPoints.clear();
+    m_WayPoints.reserve(wayPoints.size());
+    for (WayPointMap::const_iterator itr = wayPoints.begin(); itr != wayPoints.end(); ++itr)
+    {
+        m_WayPoints.push_back(itr->second);
+        m_WayPoints.back().time = itr->first;
+    }
+
+    m_next = 0;                                             // will used in MoveToNextWayPoint for init m_curr
     MoveToNextWayPoint();                                   // m_curr -> first point
     MoveToNextWayPoint();                                   // skip first point
 
     m_pathTime = timer;
 
-    m_nextNodeTime = m_curr->first;
+    m_nextNodeTime = m_WayPoints[m_curr].time;
+
+    BuildTimeIndex();
 
     return true;
 }
@@ -607,10 +618,40 @@ void GlobalTransport::MoveToNextWayPoint()
     m_curr = m_next;
 
     ++m_next;
-    if (m_next == m_WayPoints.end())
+    if (m_next == m_WayPoints.size())
+    {
+        m_next = 0;
+    }
+}
+
+void GlobalTransport::BuildTimeIndex()
+{
+    m_timeIndex.assign(m_pathTime / TRANSPORT_TIME_INDEX_STEP + 1, 0);
+
+    size_t n = 0;
+    for (size_t i = 0; i < m_timeIndex.size(); ++i)
+    {
+        uint32 slotTime = i * TRANSPORT_TIME_INDEX_STEP;
+        while (n < m_WayPoints.size() && m_WayPoints[n].time < slotTime)
+        {
+            ++n;
+        }
+        m_timeIndex[i] = n;
+    }
+}
+
+size_t GlobalTransport::FindWayPoint(uint32 time) const
+{
+    // the index gives the first candidate, only the waypoints of one slot are walked from there
+    size_t slot = std::min<size_t>(time / TRANSPORT_TIME_INDEX_STEP, m_timeIndex.size() - 1);
+    size_t n = m_timeIndex[slot];
+    while (n < m_WayPoints.size() && m_WayPoints[n].time < time)
     {
-        m_next = m_WayPoints.begin();
+        ++n;
     }
+
+    // before any waypoint of this round the transport is still at the last one of the previous round
+    return n == 0 ? m_WayPoints.size() - 1 : n - 1;
 }
 
 void GlobalTransport::TeleportTransport(uint32 newMapid, float x, float y, float z)
@@ -657,28 +698,40 @@ void GlobalTransport::Update(uint32 /*update_diff*/, uint32 /*p_time*/)
     }
 
     m_timer = GameTime::GetGameTimeMS() % m_period;
-    while (((m_timer - m_curr->first) % m_pathTime) > ((m_next->first - m_curr->first) % m_pathTime))
+
+    // common case: still between the same two waypoints, nothing to do
+    size_t target = FindWayPoint(m_timer % m_pathTime);
+    if (target == m_curr)
+    {
+        return;
+    }
+
+    // walk every waypoint passed since the last update so teleports are never skipped
+    while (m_curr != target)
     {
         MoveToNextWayPoint();
 
+        WayPoint const& curr = m_WayPoints[m_curr];
+
         // first check help in case client-server transport coordinates de-synchronization
-        if (m_curr->second.mapid != GetMapId() || m_curr->second.teleport)
+        if (curr.mapid != GetMapId() || curr.teleport)
         {
-            TeleportTransport(m_curr->second.mapid, m_curr->second.x, m_curr->second.y, m_curr->second.z);
+            TeleportTransport(curr.mapid, curr.x, curr.y, curr.z);
         }
         else
         {
-            Relocate(m_curr->second.x, m_curr->second.y, m_curr->second.z);
+            Relocate(curr.x, curr.y, curr.z);
+            UpdateModelPosition();
         }
 
-        m_nextNodeTime = m_curr->first;
+        m_nextNodeTime = curr.time;
 
-        if (m_curr == m_WayPoints.begin())
+        if (m_curr == 0)
         {
             DETAIL_FILTER_LOG(LOG_FILTER_TRANSPORT_MOVES, " ************ BEGIN ************** %s", GetName());
         }
 
-        DETAIL_FILTER_LOG(LOG_FILTER_TRANSPORT_MOVES, "%s moved to %f %f %f %d", GetName(), m_curr->second.x, m_curr->second.y, m_curr->second.z, m_curr->second.mapid);
+        DETAIL_FILTER_LOG(LOG_FILTER_TRANSPORT_MOVES, "%s moved to %f %f %f %d", GetName(), curr.x, curr.y, curr.z, curr.mapid);
     }
 }
 
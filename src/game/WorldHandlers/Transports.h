@@ -64,6 +64,8 @@ class LocalTransport : public Transport
 };
 
 
+#define TRANSPORT_TIME_INDEX_STEP 1000                      // ms of path time per waypoint time index slot
+
 class GlobalTransport : public Transport
 {
     public:
@@ -79,13 +81,16 @@ class GlobalTransport : public Transport
         void TeleportTransport(uint32 newMapid, float x, float y, float z);
         void UpdateForMap(Map const* map);
         void MoveToNextWayPoint();                          // move m_next/m_cur to next points
+        void BuildTimeIndex();
+        size_t FindWayPoint(uint32 time) const;             // last waypoint reached at path time
 
     private:
         struct WayPoint
         {
-            WayPoint() : mapid(0), x(0), y(0), z(0), teleport(false) {}
+            WayPoint() : time(0), mapid(0), x(0), y(0), z(0), teleport(false) {}
             WayPoint(uint32 _mapid, float _x, float _y, float _z, bool _teleport) :
-                mapid(_mapid), x(_x), y(_y), z(_z), teleport(_teleport) {}
+                time(0), mapid(_mapid), x(_x), y(_y), z(_z), teleport(_teleport) {}
+            uint32 time;                                    // path time the point is reached at
             uint32 mapid;
             float x;
             float y;
@@ -95,9 +100,14 @@ class GlobalTransport : public Transport
 
         typedef std::map<uint32, WayPoint> WayPointMap;
 
-        WayPointMap m_WayPoints;
-        WayPointMap::const_iterator m_curr;
-        WayPointMap::const_iterator m_next;
+        typedef std::vector<WayPoint> WayPointList;
+
+        WayPointList m_WayPoints;                           // sorted by time
+        size_t m_curr;
+        size_t m_next;
+
+        // m_timeIndex[i] is the amount of waypoints reached before i * TRANSPORT_TIME_INDEX_STEP
+        std::vector<uint32> m_timeIndex;
 
         std::set<uint32> m_mapsUsed;
 
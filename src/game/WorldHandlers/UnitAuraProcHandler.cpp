@@ -231,6 +231,54 @@ pAuraProcHandler AuraProcHandler[TOTAL_AURAS] =
     &Unit::HandleNULLProc,                                  // 191 SPELL_AURA_USE_NORMAL_MOVEMENT_SPEED
 };
 
+// proc flags a holder reacts to, the same choice IsTriggeredAtSpellProcEvent makes
+static uint32 GetHolderProcFlags(SpellAuraHolder const* holder)
+{
+    SpellProcEventEntry const* spellProcEvent = sSpellMgr.GetSpellProcEvent(holder->GetId());
+    return spellProcEvent && spellProcEvent->procFlags ? spellProcEvent->procFlags : holder->GetSpellProto()->procFlags;
+}
+
+void Unit::AddProcAuraHolder(SpellAuraHolder* holder)
+{
+    uint32 procFlags = GetHolderProcFlags(holder);
+    if (!procFlags)
+    {
+        return;
+    }
+
+    // behind the holders of equal or lower spell id, the order m_spellAuraHolders has
+    ProcAuraHolderList::iterator itr = m_procAuraHolders.begin();
+    while (itr != m_procAuraHolders.end() && itr->spellId <= holder->GetId())
+    {
+        ++itr;
+    }
+
+    ProcAuraHolderEntry entry;
+    entry.spellId = holder->GetId();
+    entry.procFlags = procFlags;
+    entry.holder = holder;
+    m_procAuraHolders.insert(itr, entry);
+
+    m_procAuraFlags |= procFlags;
+}
+
+void Unit::RemoveProcAuraHolder(SpellAuraHolder* holder)
+{
+    m_procAuraFlags = 0;
+
+    for (ProcAuraHolderList::iterator itr = m_procAuraHolders.begin(); itr != m_procAuraHolders.end();)
+    {
+        if (itr->holder == holder)
+        {
+            itr = m_procAuraHolders.erase(itr);
+            continue;
+        }
+
+        m_procAuraFlags |= itr->procFlags;
+        ++itr;
+    }
+}
+
 bool Unit::IsTriggeredAtSpellProcEvent(Unit* pVictim, SpellAuraHolder* holder, SpellEntry const* procSpell, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, bool isVictim, SpellProcEventEntry const*& spellProcEvent)
 {
     SpellEntry const* spellProto = holder->GetSpellProto();
@@ -32,6 +32,78 @@
 #include "World.h"
 #include "ObjectGuid.h"
 
+#include <ace/TSS_T.h>
+
+namespace
+{
+    /// Deflate state kept by each thread building update packets, reset instead of set up again per packet
+    class UpdateCompressionStream
+    {
+        public:
+            UpdateCompressionStream() : m_level(-1)
+            {
+                m_stream.zalloc = (alloc_func)0;
+                m_stream.zfree = (free_func)0;
+                m_stream.opaque = (voidpf)0;
+            }
+
+            ~UpdateCompressionStream()
+            {
+                Close();
+            }
+
+            z_stream* Acquire(int level)
+            {
+                if (m_level == level)
+                {
+                    int z_res = deflateReset(&m_stream);
+                    if (z_res == Z_OK)
+                    {
+                        return &m_stream;
+                    }
+
+                    sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+                }
+
+                // first use on this thread, a changed CONFIG_UINT32_COMPRESSION or a failed reset
+                Close();
+
+                int z_res = deflateInit(&m_stream, level);
+                if (z_res != Z_OK)
+                {
+                    sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                    return NULL;
+                }
+
+                m_level = level;
+                return &m_stream;
+            }
+
+            // drop the state after an error, the next packet starts from a fresh deflateInit
+            void Close()
+            {
+                if (m_level < 0)
+                {
+                    return;
+                }
+
+                deflateEnd(&m_stream);
+                m_level = -1;
+            }
+
+        private:
+            z_stream m_stream;
+            int m_level;
+    };
+
+    UpdateCompressionStream* GetCompressionStream()
+    {
+        // never destroyed, the per thread streams are released by ACE when their thread exits
+        static ACE_TSS<UpdateCompressionStream>* stream = new ACE_TSS<UpdateCompressionStream>();
+        return *stream;
+    }
+}
+
 UpdateData::UpdateData() : m_blockCount(0)
 {
 }
@@ -48,58 +120,48 @@ void UpdateData::AddOutOfRangeGUID(ObjectGuid const& guid)
 
 void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
 {
-    z_stream c_stream;
-
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
+    UpdateCompressionStream* stream = GetCompressionStream();
 
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
+    z_stream* c_stream = stream->Acquire(sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    if (!c_stream)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
+        stream->Close();
         *dst_size = 0;
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
+        stream->Close();
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
+        stream->Close();
         *dst_size = 0;
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    *dst_size = c_stream.total_out;
+    *dst_size = c_stream->total_out;
 }
 
 bool UpdateData::BuildPacket(WorldPacket* packet, bool hasTransport)
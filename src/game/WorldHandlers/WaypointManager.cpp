@@ -128,7 +128,7 @@ void WaypointManager::Load()
         //                                   0   1      2           3           4           5         6
         result = WorldDatabase.Query("SELECT `id`, `point`, `position_x`, `position_y`, `position_z`, `waittime`, `script_id`,"
                                      //   7        8        9        10       11       12     13     14           15      16
-                                     "`textid1`, `textid2`, `textid3`, `textid4`, `textid5`, `emote`, `spell`, `orientation`, `model1`, `model2` FROM `creature_movement`");
+                                     "`textid1`, `textid2`, `textid3`, `textid4`, `textid5`, `emote`, `spell`, `orientation`, `model1`, `model2` FROM `creature_movement` ORDER BY `id`, `point`");
 
         BarGoLink bar(result->GetRowCount());
 
@@ -249,6 +249,11 @@ void WaypointManager::Load()
         }
         while (result->NextRow());
 
+        for (WaypointPathMap::iterator itr = m_pathMap.begin(); itr != m_pathMap.end(); ++itr)
+        {
+            itr->second.shrink_to_fit();
+        }
+
         if (!creatureNoMoveType.empty())
         {
             for (std::set<uint32>::const_iterator itr = creatureNoMoveType.begin(); itr != creatureNoMoveType.end(); ++itr)
@@ -305,7 +310,7 @@ void WaypointManager::Load()
         //                                   0      1      2           3           4           5         6
         result = WorldDatabase.Query("SELECT `entry`, `point`, `position_x`, `position_y`, `position_z`, `waittime`, `script_id`,"
                                      //   7        8        9        10       11       12     13     14           15      16
-                                     "`textid1`, `textid2`, `textid3`, `textid4`, `textid5`, `emote`, `spell`, `orientation`, `model1`, `model2` FROM `creature_movement_template`");
+                                     "`textid1`, `textid2`, `textid3`, `textid4`, `textid5`, `emote`, `spell`, `orientation`, `model1`, `model2` FROM `creature_movement_template` ORDER BY `entry`, `point`");
 
         BarGoLink bar(result->GetRowCount());
 
@@ -410,6 +415,11 @@ void WaypointManager::Load()
 
         delete result;
 
+        for (WaypointPathMap::iterator itr = m_pathTemplateMap.begin(); itr != m_pathTemplateMap.end(); ++itr)
+        {
+            itr->second.shrink_to_fit();
+        }
+
         sLog.outString(">> Loaded %u path templates with %u nodes and %u behaviors from waypoint templates", total_paths, total_nodes, total_behaviors);
         sLog.outString();
     }
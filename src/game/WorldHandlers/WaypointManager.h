@@ -28,6 +28,9 @@
 #include "Common.h"
 #include "Utilities/UnorderedMapSet.h"
 
+#include <algorithm>
+#include <vector>
+
 enum WaypointPathOrigin
 {
     PATH_NO_PATH            = 0,
@@ -65,7 +68,95 @@ struct WaypointNode
         : x(_x), y(_y), z(_z), orientation(_o), delay(_delay), script_id(_script_id), behavior(_behavior) {}
 };
 
-typedef std::map < uint32 /*pointId*/, WaypointNode > WaypointPath;
+/**
+ * A waypoint path stored as one contiguous array of (pointId, node) pairs kept
+ * sorted by pointId. Loaded paths are only read while creatures patrol, so this
+ * keeps the nodes of a path next to each other and lets movement generators
+ * step through them by index. The map-like interface is kept for the GM tools.
+ */
+class WaypointPath
+{
+    public:
+        typedef std::pair<uint32 /*pointId*/, WaypointNode> value_type;
+        typedef std::vector<value_type> NodeList;
+        typedef NodeList::iterator iterator;
+        typedef NodeList::const_iterator const_iterator;
+        typedef NodeList::reverse_iterator reverse_iterator;
+        typedef NodeList::const_reverse_iterator const_reverse_iterator;
+
+        iterator begin() { return m_nodes.begin(); }
+        iterator end() { return m_nodes.end(); }
+        const_iterator begin() const { return m_nodes.begin(); }
+        const_iterator end() const { return m_nodes.end(); }
+        reverse_iterator rbegin() { return m_nodes.rbegin(); }
+        reverse_iterator rend() { return m_nodes.rend(); }
+        const_reverse_iterator rbegin() const { return m_nodes.rbegin(); }
+        const_reverse_iterator rend() const { return m_nodes.rend(); }
+
+        bool empty() const { return m_nodes.empty(); }
+        size_t size() const { return m_nodes.size(); }
+        void clear() { m_nodes.clear(); }
+        void shrink_to_fit() { NodeList(m_nodes).swap(m_nodes); }
+
+        value_type const& At(size_t index) const { return m_nodes[index]; }
+
+        iterator lower_bound(uint32 pointId)
+        {
+            return std::lower_bound(m_nodes.begin(), m_nodes.end(), pointId, ComparePointId());
+        }
+        const_iterator lower_bound(uint32 pointId) const
+        {
+            return std::lower_bound(m_nodes.begin(), m_nodes.end(), pointId, ComparePointId());
+        }
+
+        iterator find(uint32 pointId)
+        {
+            iterator itr = lower_bound(pointId);
+            return itr != m_nodes.end() && itr->first == pointId ? itr : m_nodes.end();
+        }
+        const_iterator find(uint32 pointId) const
+        {
+            const_iterator itr = lower_bound(pointId);
+            return itr != m_nodes.end() && itr->first == pointId ? itr : m_nodes.end();
+        }
+
+        /// Returns the position of pointId in the array, or size() if the path does not contain it
+        size_t IndexOf(uint32 pointId) const { return find(pointId) - m_nodes.begin(); }
+
+        /// Node for pointId, inserted at its sorted position if missing. Appending in pointId order is O(1).
+        WaypointNode& operator[](uint32 pointId)
+        {
+            if (m_nodes.empty() || m_nodes.back().first < pointId)
+            {
+                m_nodes.push_back(value_type(pointId, WaypointNode()));
+                return m_nodes.back().second;
+            }
+
+            iterator itr = lower_bound(pointId);
+            if (itr == m_nodes.end() || itr->first != pointId)
+            {
+                itr = m_nodes.insert(itr, value_type(pointId, WaypointNode()));
+            }
+            return itr->second;
+        }
+
+        void erase(uint32 pointId)
+        {
+            iterator itr = find(pointId);
+            if (itr != m_nodes.end())
+            {
+                m_nodes.erase(itr);
+            }
+        }
+
+    private:
+        struct ComparePointId
+        {
+            bool operator()(value_type const& node, uint32 pointId) const { return node.first < pointId; }
+        };
+
+        NodeList m_nodes;
+};
 
 class WaypointManager
 {
@@ -67,6 +67,7 @@
 #include "Util.h"
 #include "AuctionHouseBot/AuctionHouseBot.h"
 #include "CharacterDatabaseCleaner.h"
+#include "PlayerLogger.h"
 #include "CreatureLinkingMgr.h"
 #include "Weather.h"
 #include "LFGMgr.h"
@@ -76,6 +77,13 @@
 #include "GitRevision.h"
 #include "UpdateTime.h"
 #include "GameTime.h"
+#include "StartupTaskGraph.h"
+#include "StartupProfiler.h"
+#include "Metrics.h"
+#include "SessionUpdate.h"
+#include "TickRecorder.h"
+#include "PlayerNameCache.h"
+#include "MemoryUsage.h"
 
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
@@ -117,6 +125,9 @@ uint32 World::m_relocation_ai_notify_delay    = 1000u;
 World::World()
 {
     m_playerLimit = 0;
+    m_queuedSessionCount = 0;
+    m_queueFrontSequence = 0;
+    m_queuePositionsChanged = false;
     m_allowMovement = true;
     m_ShutdownMask = 0;
     m_ShutdownTimer = 0;
@@ -183,8 +194,10 @@ World::~World()
 /// Cleanups before world stop
 void World::CleanupsBeforeStop()
 {
+    CharacterDatabaseCleaner::WaitCleaning();        // finish a background cleaning run before the DB goes away
     KickAll();                                       // save and kick all players
     UpdateSessions(1);                               // real players unload required UpdateSessions call
+    PlayerLogger::StopWriter();                      // store the player logs queued by the unloaded players
     sBattleGroundMgr.DeleteAllBattleGrounds();       // unload battleground templates before different singletons destroyed
 #ifdef ENABLE_ELUNA
     Eluna::Uninitialize();
@@ -224,6 +237,12 @@ bool World::RemoveSession(uint32 id)
     return true;
 }
 
+void World::AddOfflineSession(WorldSession* s)
+{
+    MANGOS_ASSERT(s && m_sessions.find(s->GetAccountId()) == m_sessions.end());
+    m_sessions[s->GetAccountId()] = s;
+}
+
 void World::AddSession(WorldSession* s)
 {
     addSessQueue.add(s);
@@ -294,6 +313,9 @@ World::AddSession_(WorldSession* s)
     packet << uint32(0);                                    // BillingTimeRested
     s->SendPacket(&packet);
 
+    // the client asks for the character list next
+    s->WarmCharEnum();
+
     UpdateMaxSessionCounters();
 
     // Updates the population
@@ -312,22 +334,17 @@ World::AddSession_(WorldSession* s)
     }
 }
 
+/// Position last sent to the session, refreshed by UpdateQueuePositions()
 int32 World::GetQueuedSessionPos(WorldSession* sess)
 {
-    uint32 position = 1;
-
-    for (Queue::const_iterator iter = m_QueuedSessions.begin(); iter != m_QueuedSessions.end(); ++iter, ++position)
-        if ((*iter) == sess)
-        {
-            return position;
-        }
-
-    return 0;
+    return sess->IsInQueue() ? sess->GetQueuePosition() : 0;
 }
 
 void World::AddQueuedSession(WorldSession* sess)
 {
+    // everyone in front of a new session is still waiting, so its position is exact
     sess->SetInQueue(true);
+    sess->SetQueueSlot(m_queueFrontSequence + m_QueuedSessions.size(), ++m_queuedSessionCount);
     m_QueuedSessions.push_back(sess);
 
     // [-ZERO] Possible wrong
@@ -346,53 +363,139 @@ bool World::RemoveQueuedSession(WorldSession* sess)
     // sessions count including queued to remove (if removed_session set)
     uint32 sessions = GetActiveSessionCount();
 
-    uint32 position = 1;
-    Queue::iterator iter = m_QueuedSessions.begin();
-
-    // search to remove and count skipped positions
-    bool found = false;
-
-    for (; iter != m_QueuedSessions.end(); ++iter, ++position)
+    bool found = sess->IsInQueue();
+    if (found)
     {
-        if (*iter == sess)
-        {
-            sess->SetInQueue(false);
-            iter = m_QueuedSessions.erase(iter);
-            found = true;                                   // removing queued session
-            break;
-        }
+        // leave an empty slot, the sessions behind keep their sequence numbers
+        m_QueuedSessions[sess->GetQueueSequence() - m_queueFrontSequence] = NULL;
+        sess->SetInQueue(false);
+        --m_queuedSessionCount;
+        m_queuePositionsChanged = true;
+        PopQueueFrontSlots();
     }
-
-    // iter point to next socked after removed or end()
-    // position store position of removed socket and then new position next socket after removed
-
     // if session not queued then we need decrease sessions count
-    if (!found && sessions)
+    else if (sessions)
     {
         --sessions;
     }
 
     // accept first in queue
-    if ((!m_playerLimit || (int32)sessions < m_playerLimit) && !m_QueuedSessions.empty())
+    if ((!m_playerLimit || (int32)sessions < m_playerLimit) && m_queuedSessionCount)
     {
         WorldSession* pop_sess = m_QueuedSessions.front();
         pop_sess->SetInQueue(false);
         pop_sess->SendAuthWaitQue(0);
+        pop_sess->WarmCharEnum();
         m_QueuedSessions.pop_front();
+        ++m_queueFrontSequence;
+        --m_queuedSessionCount;
+        m_queuePositionsChanged = true;
+        PopQueueFrontSlots();
+    }
+
+    // the new positions are sent in batches by UpdateQueuePositions()
+    return found;
+}
+
+/// Drops the empty slots at the front, so the front is always a waiting session
+void World::PopQueueFrontSlots()
+{
+    while (!m_QueuedSessions.empty() && !m_QueuedSessions.front())
+    {
+        m_QueuedSessions.pop_front();
+        ++m_queueFrontSequence;
+    }
+}
+
+/// Sends the changed positions to the waiting sessions and compacts the queue
+void World::UpdateQueuePositions()
+{
+    m_queuePositionsChanged = false;
+
+    uint32 position = 0;
+    Queue::iterator dest = m_QueuedSessions.begin();
+    for (Queue::iterator iter = m_QueuedSessions.begin(); iter != m_QueuedSessions.end(); ++iter)
+    {
+        WorldSession* sess = *iter;
+        if (!sess)
+        {
+            continue;
+        }
+
+        ++position;
+        if (sess->GetQueuePosition() != position)
+        {
+            sess->SendAuthWaitQue(position);
+        }
 
-        // update iter to point first queued socket or end() if queue is empty now
-        iter = m_QueuedSessions.begin();
-        position = 1;
+        sess->SetQueueSlot(m_queueFrontSequence + position - 1, position);
+        *dest++ = sess;
     }
 
-    // update position from iter to end()
-    // iter point to first not updated socket, position store new position
-    for (; iter != m_QueuedSessions.end(); ++iter, ++position)
+    m_QueuedSessions.erase(dest, m_QueuedSessions.end());
+}
+
+void World::AddClosedSessionTraffic(uint32 accountId, SessionTraffic const& traffic)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_closedSessionTrafficLock);
+    m_closedSessionTraffic[accountId].Add(traffic);
+}
+
+/// Sums the resource use per account, must be called from the world thread for the open sessions
+void World::GetAccountTraffic(AccountTrafficMap& accounts) const
+{
     {
-        (*iter)->SendAuthWaitQue(position);
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_closedSessionTrafficLock);
+        accounts = m_closedSessionTraffic;
     }
 
-    return found;
+    for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
+    {
+        SessionTraffic traffic;
+        itr->second->GetTraffic(traffic);
+        accounts[itr->first].Add(traffic);
+    }
+}
+
+void World::ResetSessionTraffic()
+{
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_closedSessionTrafficLock);
+        m_closedSessionTraffic.clear();
+    }
+
+    for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
+    {
+        itr->second->ResetTraffic();
+    }
+}
+
+/// Logs the sessions above one of the SessionAccounting.* limits within the last check interval
+void World::CheckSessionTraffic()
+{
+    uint64 interval = getConfig(CONFIG_UINT32_SESSION_ACCOUNTING_CHECK_INTERVAL);
+
+    // the limits are given per second
+    uint64 maxHandlerUs = getConfig(CONFIG_UINT32_SESSION_ACCOUNTING_MAX_HANDLER_TIME) * interval;
+    uint64 maxPacketsIn = getConfig(CONFIG_UINT32_SESSION_ACCOUNTING_MAX_PACKETS_IN) * interval / IN_MILLISECONDS;
+    uint64 maxBytesOut = getConfig(CONFIG_UINT32_SESSION_ACCOUNTING_MAX_BYTES_OUT) * interval / IN_MILLISECONDS;
+    uint32 maxSendQueue = getConfig(CONFIG_UINT32_SESSION_ACCOUNTING_MAX_SEND_QUEUE);
+
+    for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
+    {
+        WorldSession* session = itr->second;
+
+        SessionTraffic delta;
+        session->GetTrafficSinceLastCheck(delta);
+
+        if ((maxHandlerUs && delta.handlerUs > maxHandlerUs) || (maxPacketsIn && delta.packetsIn > maxPacketsIn) ||
+            (maxBytesOut && delta.bytesOut > maxBytesOut) || (maxSendQueue && delta.sendQueuePeak > maxSendQueue))
+        {
+            sLog.outError("Session of account %u (%s, player %s) in the last " UI64FMTD " ms: handlers " UI64FMTD " us, in " UI64FMTD " packets / " UI64FMTD " bytes, out " UI64FMTD " packets / " UI64FMTD " bytes, send queue peak %u",
+                          session->GetAccountId(), session->GetRemoteAddress().c_str(), session->GetPlayerName(), interval,
+                          delta.handlerUs, delta.packetsIn, delta.bytesIn, delta.packetsOut, delta.bytesOut, delta.sendQueuePeak);
+        }
+    }
 }
 
 /// Initialize config values
@@ -432,6 +535,7 @@ void World::LoadConfigSettings(bool reload)
 
     ///- Read the player limit and the Message of the day from the config file
     SetPlayerLimit(sConfig.GetIntDefault("PlayerLimit", DEFAULT_PLAYER_LIMIT), true);
+    setConfig(CONFIG_UINT32_PLAYER_QUEUE_UPDATE_INTERVAL, "PlayerQueueUpdateInterval", 5000);
     SetMotd(sConfig.GetStringDefault("Motd", "Welcome to the Massive Network Game Object Server."));
 
     ///- Read all rates from the config file
@@ -556,6 +660,54 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_UINT32_NUMTHREADS, "MapUpdateThreads", 2);
+    setConfigMinMax(CONFIG_UINT32_MAP_UPDATE_SCHEDULER, "MapUpdateScheduler", MAP_UPDATE_SCHEDULER_QUEUE, MAP_UPDATE_SCHEDULER_QUEUE, MAX_MAP_UPDATE_SCHEDULER - 1);
+    setConfig(CONFIG_UINT32_INSTANCE_UPDATE_THREADS, "InstanceUpdateThreads", 0);
+    setConfig(CONFIG_BOOL_MAP_UPDATE_PARALLEL_REGIONS, "MapUpdateParallelRegions", false);
+    setConfig(CONFIG_UINT32_MAP_UPDATE_PERF_LOG_INTERVAL, "MapUpdatePerfLogInterval", 0);
+    setConfig(CONFIG_UINT32_MAP_UPDATE_ADAPTIVE_MAX_INTERVAL, "MapUpdateAdaptiveMaxInterval", 0);
+    setConfig(CONFIG_UINT32_MAP_UPDATE_PACKET_BUILD_THRESHOLD, "MapUpdatePacketBuildThreshold", 0);
+    setConfig(CONFIG_UINT32_SESSION_UPDATE_PARALLEL_THRESHOLD, "SessionUpdateParallelThreshold", 0);
+    setConfig(CONFIG_UINT32_GRID_LOADER_THREADS, "GridLoaderThreads", 0);
+    setConfig(CONFIG_UINT32_GRID_PREFETCH_DISTANCE, "GridPrefetchDistance", 1066);
+    setConfig(CONFIG_BOOL_GRID_MAP_FILES_MAPPED, "GridMapFilesMapped", true);
+
+    setConfig(CONFIG_BOOL_OPCODE_PERF, "OpcodePerf", true);
+    setConfig(CONFIG_BOOL_QUERY_RESPONSE_CACHE, "QueryResponseCache", true);
+    setConfig(CONFIG_UINT32_OPCODE_PERF_LOG_INTERVAL, "OpcodePerfLogInterval", 0);
+
+    setConfig(CONFIG_UINT32_MOVEMENT_COALESCE_WINDOW, "MovementCoalesce.Window", 0);
+    setConfig(CONFIG_UINT32_MOVEMENT_COALESCE_FAR_WINDOW, "MovementCoalesce.FarWindow", 1000);
+    setConfigPos(CONFIG_FLOAT_MOVEMENT_COALESCE_FAR_DISTANCE, "MovementCoalesce.FarDistance", 40.0f);
+
+    setConfig(CONFIG_BOOL_COMBAT_LOG_BATCHING, "CombatLog.Batching", false);
+    setConfigPos(CONFIG_FLOAT_COMBAT_LOG_DISTANCE, "CombatLog.Distance", 0.0f);
+
+    setConfig(CONFIG_UINT32_STARTUP_LOADER_THREADS, "StartupLoaderThreads", 4);
+
+    setConfig(CONFIG_UINT32_CHARACTER_LOGIN_CACHE_SIZE, "CharacterLoginCache.Size", 0);
+    setConfig(CONFIG_UINT32_CHARACTER_LOGIN_CACHE_EXPIRE, "CharacterLoginCache.Expire", 60);
+    setConfig(CONFIG_UINT32_CHAR_ENUM_CACHE_SIZE, "CharEnumCache.Size", 0);
+    setConfig(CONFIG_UINT32_CHAR_ENUM_CACHE_EXPIRE, "CharEnumCache.Expire", 300);
+    setConfig(CONFIG_BOOL_PLAYER_NAME_CACHE, "PlayerNameCache", true);
+    setConfig(CONFIG_UINT32_SESSION_ACCOUNTING_CHECK_INTERVAL, "SessionAccounting.CheckInterval", 0);
+    setConfig(CONFIG_UINT32_SESSION_ACCOUNTING_MAX_HANDLER_TIME, "SessionAccounting.MaxHandlerTime", 50);
+    setConfig(CONFIG_UINT32_SESSION_ACCOUNTING_MAX_PACKETS_IN, "SessionAccounting.MaxPacketsIn", 100);
+    setConfig(CONFIG_UINT32_SESSION_ACCOUNTING_MAX_BYTES_OUT, "SessionAccounting.MaxBytesOut", 0);
+    setConfig(CONFIG_UINT32_SESSION_ACCOUNTING_MAX_SEND_QUEUE, "SessionAccounting.MaxSendQueue", 500);
+    setConfig(CONFIG_UINT32_CLI_COMMAND_THREADS, "CliCommandThreads", 0);
+    setConfig(CONFIG_UINT32_CLI_COMMAND_QUEUE_TIMEOUT, "CliCommandQueueTimeout", 60);
+    setConfig(CONFIG_UINT32_EVENT_MAP_SPAWNS_PER_UPDATE, "Event.MapSpawnsPerUpdate", 100);
+    setConfig(CONFIG_UINT32_SAVE_RESPAWN_TIME_INTERVAL, "SaveRespawnTimeInterval", 10000);
+    setConfig(CONFIG_UINT32_GRID_UNLOAD_MAP_BUDGET, "GridUnload.MapBudget", 0);
+    setConfig(CONFIG_UINT32_GRID_UNLOAD_TOTAL_BUDGET, "GridUnload.TotalBudget", 0);
+    if (reload)
+    {
+        m_timers[WUPDATE_OPCODE_TIMES].SetInterval(getConfig(CONFIG_UINT32_OPCODE_PERF_LOG_INTERVAL));
+        m_timers[WUPDATE_QUEUE_POSITIONS].SetInterval(getConfig(CONFIG_UINT32_PLAYER_QUEUE_UPDATE_INTERVAL));
+        m_timers[WUPDATE_SESSION_ACCOUNTING].SetInterval(getConfig(CONFIG_UINT32_SESSION_ACCOUNTING_CHECK_INTERVAL));
+    m_timers[WUPDATE_METRICS].SetInterval(IN_MILLISECONDS);
+        m_timers[WUPDATE_OPCODE_TIMES].Reset();
+    }
 
     setConfigMin(CONFIG_UINT32_INTERVAL_MAPUPDATE, "MapUpdateInterval", 100, MIN_MAP_UPDATE_DELAY);
     if (reload)
@@ -646,6 +798,8 @@ void World::LoadConfigSettings(bool reload)
 
     setConfig(CONFIG_UINT32_INSTANCE_RESET_TIME_HOUR, "Instance.ResetTimeHour", 4);
     setConfig(CONFIG_UINT32_INSTANCE_UNLOAD_DELAY,    "Instance.UnloadDelay", 30 * MINUTE * IN_MILLISECONDS);
+    setConfig(CONFIG_UINT32_INSTANCE_HIBERNATION_DELAY, "Instance.HibernationDelay", 0);
+    setConfigMin(CONFIG_UINT32_INSTANCE_HIBERNATION_MAX_DIFF, "Instance.HibernationMaxDiff", 10 * IN_MILLISECONDS, MIN_MAP_UPDATE_DELAY);
 
     setConfigMinMax(CONFIG_UINT32_MAX_PRIMARY_TRADE_SKILL, "MaxPrimaryTradeSkill", 2, 0, 10);
 
@@ -673,10 +827,12 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_GM_MAX_SPEED_FACTOR, "GM.MaxSpeedFactor", 10);
 
     setConfig(CONFIG_UINT32_GROUP_VISIBILITY, "Visibility.GroupMode", 0);
+    setConfig(CONFIG_UINT32_GROUP_MEMBER_UPDATE_DELAY, "Visibility.GroupMemberUpdateDelay", 1000);
 
     setConfig(CONFIG_UINT32_MAIL_DELIVERY_DELAY, "MailDeliveryDelay", HOUR);
 
     setConfigMin(CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK, "MassMailer.SendPerTick", 10, 1);
+    setConfig(CONFIG_UINT32_MASS_MAILER_UPDATE_TIME_BUDGET, "MassMailer.UpdateTimeBudget", 5);
 
     setConfig(CONFIG_UINT32_UPTIME_UPDATE, "UpdateUptimeInterval", 10);
     if (reload)
@@ -727,6 +883,10 @@ void World::LoadConfigSettings(bool reload)
 
     setConfigMinMax(CONFIG_INT32_QUEST_LOW_LEVEL_HIDE_DIFF, "Quests.LowLevelHideDiff", 4, -1, MAX_LEVEL);
     setConfigMinMax(CONFIG_INT32_QUEST_HIGH_LEVEL_HIDE_DIFF, "Quests.HighLevelHideDiff", 7, -1, MAX_LEVEL);
+    if (reload)
+    {
+        sObjectMgr.InvalidateQuestGiverStatus();
+    }
 
     setConfig(CONFIG_BOOL_QUEST_IGNORE_RAID, "Quests.IgnoreRaid", false);
 
@@ -759,6 +919,22 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_FLOAT_THREAT_RADIUS, "ThreatRadius", 100.0f);
     setConfigMin(CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY, "CreatureRespawnAggroDelay", 5000, 0);
 
+    setConfig(CONFIG_UINT32_CREATURE_LOD_FAR_INTERVAL, "CreatureLod.FarInterval", 0);
+    setConfig(CONFIG_UINT32_CREATURE_LOD_HIDDEN_INTERVAL, "CreatureLod.HiddenInterval", 0);
+    setConfigPos(CONFIG_FLOAT_CREATURE_LOD_NEAR_DISTANCE, "CreatureLod.NearDistance", 60.0f);
+    setConfig(CONFIG_BOOL_CREATURE_IDLE_SLEEP, "CreatureLod.IdleSleep", false);
+
+    m_configCreatureLodExemptEntries.clear();
+    std::string lodExemptEntries = sConfig.GetStringDefault("CreatureLod.ExemptEntries", "");
+    if (!lodExemptEntries.empty())
+    {
+        unsigned int pos = 0;
+        unsigned int id;
+        VMAP::VMapFactory::chompAndTrim(lodExemptEntries);
+        while (VMAP::VMapFactory::getNextId(lodExemptEntries, pos, id))
+            m_configCreatureLodExemptEntries.insert(id);
+    }
+
     setConfig(CONFIG_BOOL_BATTLEGROUND_CAST_DESERTER,                  "Battleground.CastDeserter", true);
     setConfigMinMax(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN,   "Battleground.QueueAnnouncer.Join", 0, 0, 2);
     setConfig(CONFIG_BOOL_BATTLEGROUND_QUEUE_ANNOUNCER_START,          "Battleground.QueueAnnouncer.Start", false);
@@ -928,6 +1104,8 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
+    setConfig(CONFIG_UINT32_VMAP_LOS_CACHE_TIME, "vmap.lineOfSightCacheTime", 500);
+    LineOfSightCache::SetMaxAge(getConfig(CONFIG_UINT32_VMAP_LOS_CACHE_TIME));
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
     std::string ignoreSpellIds = sConfig.GetStringDefault("vmap.ignoreSpellIds", "");
@@ -969,6 +1147,7 @@ void World::SetInitialWorldSettings()
     // 服务器启动时间
     uint32 startupBegin = GameTime::GetGameTimeMS();
 
+    sStartupProfiler.BeginPhase("Config and map files");
     ///- Initialize detour memory management
     dtAllocSetCustom(dtCustomAlloc, dtCustomFree);
 
@@ -995,6 +1174,7 @@ void World::SetInitialWorldSettings()
         exit(1);
     }
 
+    sStartupProfiler.BeginPhase("MaNGOS strings");
     ///- Loading strings. Getting no records means core load has to be canceled because no error message can be output.
     sLog.outString("Loading MaNGOS strings...");
     if (!sObjectMgr.LoadMangosStrings())
@@ -1014,12 +1194,15 @@ void World::SetInitialWorldSettings()
     // 重启以后移除骨头和尸体
     CharacterDatabase.PExecute("DELETE FROM `corpse` WHERE `corpse_type` = '0' OR `time` < (UNIX_TIMESTAMP()-'%u')", 3 * DAY);
 
+    sStartupProfiler.BeginPhase("DBC stores");
     // 加载DBC文件
     sLog.outString("Initialize DBC data stores...");
     LoadDBCStores(m_dataPath);
     DetectDBCLang();
+    sTerrainMgr.Initialize();                               // terrain handles of all maps, looked up without lock from here on
     sObjectMgr.SetDBCLocaleIndex(GetDefaultDbcLocale());    // Get once for all the locale index of DBC language (console/broadcasts)
 
+    sStartupProfiler.BeginPhase("Script names, instance and skill data");
     // 获取WorldDatabase中表script_binding所有ScriptName
     sLog.outString("Loading Script Names...");
     sScriptMgr.LoadScriptNames();
@@ -1033,6 +1216,7 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading SkillRaceClassInfoMultiMap Data...");
     sSpellMgr.LoadSkillRaceClassInfoMap();
 
+    sStartupProfiler.BeginPhase("Instance and group cleanup");
     ///- Clean up and pack instances
     sLog.outString("Cleaning up instances...");
     sMapPersistentStateMgr.CleanupInstances();              // must be called before `creature_respawn`/`gameobject_respawn` tables
@@ -1053,120 +1237,193 @@ void World::SetInitialWorldSettings()
     Eluna::Initialize();
 #endif /* ENABLE_ELUNA */
 
-    sLog.outString("Loading Page Texts...");
-    sObjectMgr.LoadPageTexts();
+    sStartupProfiler.BeginPhase("Template loaders");
+    ///- Template data loaders, independent ones run in parallel
+    StartupTaskGraph templateLoaders;
 
-    sLog.outString("Loading Game Object Templates...");     // must be after LoadPageTexts
-    sObjectMgr.LoadGameobjectInfo();
+    templateLoaders.AddTask("Spell data", []()
+    {
+        sLog.outString("Loading Spell Chain Data...");
+        sSpellMgr.LoadSpellChains();
 
-    sLog.outString("Loading GameObject models...");
-    LoadGameObjectModelList();
-    sLog.outString();
+        sLog.outString("Loading Spell Elixir types...");
+        sSpellMgr.LoadSpellElixirs();
 
-    sLog.outString("Loading Spell Chain Data...");
-    sSpellMgr.LoadSpellChains();
+        sLog.outString("Loading Spell Facing Flags...");
+        sSpellMgr.LoadFacingCasterFlags();
 
-    sLog.outString("Loading Spell Elixir types...");
-    sSpellMgr.LoadSpellElixirs();
+        sLog.outString("Loading Spell Learn Skills...");
+        sSpellMgr.LoadSpellLearnSkills();                   // must be after LoadSpellChains
 
-    sLog.outString("Loading Spell Facing Flags...");
-    sSpellMgr.LoadFacingCasterFlags();
+        sLog.outString("Loading Spell Learn Spells...");
+        sSpellMgr.LoadSpellLearnSpells();
 
-    sLog.outString("Loading Spell Learn Skills...");
-    sSpellMgr.LoadSpellLearnSkills();                       // must be after LoadSpellChains
+        sLog.outString("Loading Spell Proc Event conditions...");
+        sSpellMgr.LoadSpellProcEvents();
 
-    sLog.outString("Loading Spell Learn Spells...");
-    sSpellMgr.LoadSpellLearnSpells();
+        sLog.outString("Loading Spell Bonus Data...");
+        sSpellMgr.LoadSpellBonuses();
 
-    sLog.outString("Loading Spell Proc Event conditions...");
-    sSpellMgr.LoadSpellProcEvents();
+        sLog.outString("Loading Spell Proc Item Enchant...");
+        sSpellMgr.LoadSpellProcItemEnchant();               // must be after LoadSpellChains
 
-    sLog.outString("Loading Spell Bonus Data...");
-    sSpellMgr.LoadSpellBonuses();
+        sLog.outString("Loading Spell Linked definitions...");
+        sSpellMgr.LoadSpellLinked();                        // must be after LoadSpellChains
 
-    sLog.outString("Loading Spell Proc Item Enchant...");
-    sSpellMgr.LoadSpellProcItemEnchant();                   // must be after LoadSpellChains
+        sLog.outString("Loading Aggro Spells Definitions...");
+        sSpellMgr.LoadSpellThreats();
+    });
 
-    sLog.outString("Loading Spell Linked definitions...");
-    sSpellMgr.LoadSpellLinked();                            // must be after LoadSpellChains
+    templateLoaders.AddTask("Page Texts", []()
+    {
+        sLog.outString("Loading Page Texts...");
+        sObjectMgr.LoadPageTexts();
+    });
 
-    sLog.outString("Loading Aggro Spells Definitions...");
-    sSpellMgr.LoadSpellThreats();
+    templateLoaders.AddTask("Game Object Templates", []()
+    {
+        sLog.outString("Loading Game Object Templates...");
+        sObjectMgr.LoadGameobjectInfo();
+    }, { "Page Texts" });
 
-    sLog.outString("Loading NPC Texts...");
-    sObjectMgr.LoadGossipText();
+    templateLoaders.AddTask("GameObject models", []()
+    {
+        sLog.outString("Loading GameObject models...");
+        LoadGameObjectModelList();
+    });
 
-    sLog.outString("Loading Item Random Enchantments Table...");
-    LoadRandomEnchantmentsTable();
+    templateLoaders.AddTask("NPC Texts", []()
+    {
+        sLog.outString("Loading NPC Texts...");
+        sObjectMgr.LoadGossipText();
+    });
 
-    sLog.outString("Loading Disables...");                  // must be before loading quests and items
-    DisableMgr::LoadDisables();
+    templateLoaders.AddTask("Item Random Enchantments", []()
+    {
+        sLog.outString("Loading Item Random Enchantments Table...");
+        LoadRandomEnchantmentsTable();
+    });
 
-    sLog.outString("Loading Item Templates...");            // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    sObjectMgr.LoadItemPrototypes();
+    templateLoaders.AddTask("Disables", []()
+    {
+        sLog.outString("Loading Disables...");
+        DisableMgr::LoadDisables();
+    });
 
-    sLog.outString("Loading Creature Model Based Info Data...");
-    sObjectMgr.LoadCreatureModelInfo();
+    templateLoaders.AddTask("Item Templates", []()
+    {
+        sLog.outString("Loading Item Templates...");
+        sObjectMgr.LoadItemPrototypes();
+    }, { "Page Texts", "Item Random Enchantments", "Disables" });
 
-    sLog.outString("Loading Creature Items...");
-    sObjectMgr.LoadCreatureItemTemplates();
+    templateLoaders.AddTask("Creature Model Based Info", []()
+    {
+        sLog.outString("Loading Creature Model Based Info Data...");
+        sObjectMgr.LoadCreatureModelInfo();
+    });
+
+    templateLoaders.AddTask("Creature Equipment", []()
+    {
+        sLog.outString("Loading Creature Items...");
+        sObjectMgr.LoadCreatureItemTemplates();
 
-    sLog.outString("Loading Equipment templates...");
-    sObjectMgr.LoadEquipmentTemplates();
+        sLog.outString("Loading Equipment templates...");
+        sObjectMgr.LoadEquipmentTemplates();
+    });
 
-    sLog.outString("Loading Creature Stats...");
-    sObjectMgr.LoadCreatureClassLvlStats();
+    templateLoaders.AddTask("Creature Stats", []()
+    {
+        sLog.outString("Loading Creature Stats...");
+        sObjectMgr.LoadCreatureClassLvlStats();
+    });
+
+    templateLoaders.AddTask("Creature templates", []()
+    {
+        sLog.outString("Loading Creature templates...");
+        sObjectMgr.LoadCreatureTemplates();
+    }, { "Creature Model Based Info", "Creature Equipment", "Creature Stats" });
 
-    sLog.outString("Loading Creature templates...");
-    sObjectMgr.LoadCreatureTemplates();
+    templateLoaders.AddTask("Creature spells", []()
+    {
+        sLog.outString("Loading Creature template spells...");
+        sObjectMgr.LoadCreatureTemplateSpells();
 
-    sLog.outString("Loading Creature template spells...");
-    sObjectMgr.LoadCreatureTemplateSpells();
+        sLog.outString("Loading Creature spells...");
+        sObjectMgr.LoadCreatureSpells();
+    }, { "Creature templates" });
 
-    sLog.outString("Loading Creature spells...");
-    sObjectMgr.LoadCreatureSpells();
+    templateLoaders.AddTask("SpellsScriptTarget", []()
+    {
+        sLog.outString("Loading SpellsScriptTarget...");
+        sSpellMgr.LoadSpellScriptTarget();
+    }, { "Spell data", "Creature templates", "Game Object Templates" });
 
-    sLog.outString("Loading SpellsScriptTarget...");
-    sSpellMgr.LoadSpellScriptTarget();                      // must be after LoadCreatureTemplates and LoadGameobjectInfo
+    templateLoaders.AddTask("ItemRequiredTarget", []()
+    {
+        sLog.outString("Loading ItemRequiredTarget...");
+        sObjectMgr.LoadItemRequiredTarget();
+    }, { "Item Templates", "SpellsScriptTarget" });
 
-    sLog.outString("Loading ItemRequiredTarget...");
-    sObjectMgr.LoadItemRequiredTarget();
+    templateLoaders.AddTask("Reputation data", []()
+    {
+        sLog.outString("Loading Reputation Reward Rates...");
+        sObjectMgr.LoadReputationRewardRate();
 
-    sLog.outString("Loading Reputation Reward Rates...");
-    sObjectMgr.LoadReputationRewardRate();
+        sLog.outString("Loading Creature Reputation OnKill Data...");
+        sObjectMgr.LoadReputationOnKill();
 
-    sLog.outString("Loading Creature Reputation OnKill Data...");
-    sObjectMgr.LoadReputationOnKill();
+        sLog.outString("Loading Reputation Spillover Data...");
+        sObjectMgr.LoadReputationSpilloverTemplate();
+    }, { "Creature templates" });
 
-    sLog.outString("Loading Reputation Spillover Data...");
-    sObjectMgr.LoadReputationSpilloverTemplate();
+    templateLoaders.AddTask("Points Of Interest", []()
+    {
+        sLog.outString("Loading Points Of Interest Data...");
+        sObjectMgr.LoadPointsOfInterest();
+    });
 
-    sLog.outString("Loading Points Of Interest Data...");
-    sObjectMgr.LoadPointsOfInterest();
+    templateLoaders.AddTask("Pet Create Spells", []()
+    {
+        sLog.outString("Loading Pet Create Spells...");
+        sObjectMgr.LoadPetCreateSpells();
+    }, { "Creature templates" });
 
-    sLog.outString("Loading Pet Create Spells...");
-    sObjectMgr.LoadPetCreateSpells();
+    templateLoaders.Run(getConfig(CONFIG_UINT32_STARTUP_LOADER_THREADS));
+    templateLoaders.LogTimings();
 
+    sStartupProfiler.BeginPhase("Creatures");
     sLog.outString("Loading Creature Data...");
     sObjectMgr.LoadCreatures();
 
+    sLog.outString("Loading Creature Spawn Hints...");
+    sObjectMgr.LoadCreatureSpawnHints();                    // must be after LoadCreatures() and DisableMgr::LoadDisables()
+
     sLog.outString("Loading Creature Addon Data...");
     sObjectMgr.LoadCreatureAddons();                        // must be after LoadCreatureTemplates() and LoadCreatures()
     sLog.outString(">>> Creature Addon Data loaded");
     sLog.outString();
 
+    sStartupProfiler.BeginPhase("Gameobjects");
     sLog.outString("Loading Gameobject Data...");
     sObjectMgr.LoadGameObjects();
 
+    sStartupProfiler.BeginPhase("Static spawn index");
+    sLog.outString("Indexing static spawns...");
+    sObjectMgr.BuildCellSpawnIndex();                       // must be after LoadCreatures() and LoadGameObjects()
+
+    sStartupProfiler.BeginPhase("Creature linking");
     sLog.outString("Loading CreatureLinking Data...");      // must be after Creatures
     sCreatureLinkingMgr.LoadFromDB();
 
+    sStartupProfiler.BeginPhase("Pools");
     sLog.outString("Loading Objects Pooling Data...");
     sPoolMgr.LoadFromDB();
 
+    sStartupProfiler.BeginPhase("Weather");
     sLog.outString("Loading Weather Data...");
     sWeatherMgr.LoadWeatherZoneChances();
 
+    sStartupProfiler.BeginPhase("Quests");
     sLog.outString("Loading Quests...");
     sObjectMgr.LoadQuests();                                // must be loaded after DBCs, creature_template, item_template, gameobject tables
 
@@ -1178,15 +1435,18 @@ void World::SetInitialWorldSettings()
     sLog.outString("Checking Quest Disables...");
     DisableMgr::CheckQuestDisables();                       // must be after loading quests
 
+    sStartupProfiler.BeginPhase("Game events");
     sLog.outString("Loading Game Event Data...");           // must be after sPoolMgr.LoadFromDB and quests to properly load pool events and quests for events
     sGameEventMgr.LoadFromDB();
     sLog.outString(">>> Game Event Data loaded");
     sLog.outString();
 
+    sStartupProfiler.BeginPhase("Conditions");
     // Load Conditions
     sLog.outString("Loading Conditions...");
     sObjectMgr.LoadConditions();
 
+    sStartupProfiler.BeginPhase("Map persistent states and respawn times");
     sLog.outString("Creating map persistent states for non-instanceable maps...");     // must be after PackInstances(), LoadCreatures(), sPoolMgr.LoadFromDB(), sGameEventMgr.LoadFromDB();
     sMapPersistentStateMgr.InitWorldMaps();
     sLog.outString();
@@ -1197,6 +1457,7 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Gameobject Respawn Data...");   // must be after LoadGameObjects(), and sMapPersistentStateMgr.InitWorldMaps()
     sMapPersistentStateMgr.LoadGameobjectRespawnTimes();
 
+    sStartupProfiler.BeginPhase("Spell areas and area triggers");
     sLog.outString("Loading SpellArea Data...");            // must be after quest load
     sSpellMgr.LoadSpellAreas();
 
@@ -1223,6 +1484,7 @@ void World::SetInitialWorldSettings()
     sScriptMgr.LoadScriptBinding();
 #endif /* ENABLE_SD3 */
 
+    sStartupProfiler.BeginPhase("Graveyards and spell targets");
     sLog.outString("Loading Graveyard-zone links...");
     sObjectMgr.LoadGraveyardZones();
 
@@ -1235,6 +1497,7 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading spell pet auras...");
     sSpellMgr.LoadSpellPetAuras();
 
+    sStartupProfiler.BeginPhase("Player and pet data");
     sLog.outString("Loading Player Create Info & Level Stats...");
     sObjectMgr.LoadPlayerInfo();
     sLog.outString(">>> Player Create Info & Level Stats loaded");
@@ -1246,9 +1509,11 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Pet Name Parts...");
     sObjectMgr.LoadPetNames();
 
+    sStartupProfiler.BeginPhase("Character database cleanup");
     CharacterDatabaseCleaner::CleanDatabase();
     sLog.outString();
 
+    sStartupProfiler.BeginPhase("Pet stats and corpses");
     sLog.outString("Loading the max pet number...");
     sObjectMgr.LoadPetNumber();
 
@@ -1258,11 +1523,13 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Player Corpses...");
     sObjectMgr.LoadCorpses();
 
+    sStartupProfiler.BeginPhase("Loot tables");
     sLog.outString("Loading Loot Tables...");
     LoadLootTables();
     sLog.outString(">>> Loot Tables loaded");
     sLog.outString();
 
+    sStartupProfiler.BeginPhase("Gossip, vendors and trainers");
     sLog.outString("Loading Skill Fishing base level requirements...");
     sObjectMgr.LoadFishingBaseSkillLevel();
 
@@ -1279,15 +1546,21 @@ void World::SetInitialWorldSettings()
     sObjectMgr.LoadTrainerTemplates();                      // must be after load CreatureTemplate
     sObjectMgr.LoadTrainers();                              // must be after load CreatureTemplate, TrainerTemplate
 
+    sStartupProfiler.BeginPhase("Waypoints");
     sLog.outString("Loading Waypoint scripts...");          // before loading from creature_movement
     sScriptMgr.LoadDbScripts(DBS_ON_CREATURE_MOVEMENT);
 
     sLog.outString("Loading Waypoints...");
     sWaypointMgr.Load();
 
+    sStartupProfiler.BeginPhase("Spell attributes and classifiers");
     sLog.outString("Modifying in-memory dbc spell attributes...");
     sSpellMgr.ModDBCSpellAttributes();
 
+    sLog.outString("Caching spell classifiers...");
+    sSpellMgr.LoadSpellClassifiers();                       // must be after ModDBCSpellAttributes
+
+    sStartupProfiler.BeginPhase("Misc world tables");
     sLog.outString("Loading ReservedNames...");
     sObjectMgr.LoadReservedPlayersNames();
 
@@ -1303,6 +1576,7 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading GameTeleports...");
     sObjectMgr.LoadGameTele();
 
+    sStartupProfiler.BeginPhase("Localization strings");
     ///- Loading localization data
     sLog.outString("Loading Localization strings...");
     sObjectMgr.LoadCreatureLocales();                       // must be after CreatureInfo loading
@@ -1314,9 +1588,12 @@ void World::SetInitialWorldSettings()
     sObjectMgr.LoadGossipMenuItemsLocales();                // must be after gossip menu items loading
     sObjectMgr.LoadPointOfInterestLocales();                // must be after POI loading
     sCommandMgr.LoadCommandHelpLocale();
-    sLog.outString(">>> Localization strings loaded");
+    size_t internedStrings, internedBytes;
+    InternedString::GetStats(internedStrings, internedBytes);
+    sLog.outString(">>> Localization strings loaded (" SIZEFMTD " distinct strings, " SIZEFMTD " bytes)", internedStrings, internedBytes);
     sLog.outString();
 
+    sStartupProfiler.BeginPhase("Auctions, guilds, groups, mails and tickets");
     ///- Load dynamic data tables from the database
     sLog.outString("Loading Auctions...");
     sAuctionMgr.LoadAuctionItems();
@@ -1336,6 +1613,10 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading GM tickets...");
     sTicketMgr.LoadGMTickets();
 
+    sLog.outString("Loading player names...");
+    sPlayerNameCache.Load();
+
+    sStartupProfiler.BeginPhase("DB scripts");
     ///- Load and initialize DBScripts Engine
     sLog.outString("Loading DB-Scripts Engine...");
     sScriptMgr.LoadDbScripts(DBS_ON_QUEST_START);           // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
@@ -1351,6 +1632,7 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Scripts text locales...");      // must be after Load*Scripts calls
     sScriptMgr.LoadDbScriptStrings();
 
+    sStartupProfiler.BeginPhase("EventAI scripts");
     ///- Load and initialize EventAI Scripts
     sLog.outString("Loading CreatureEventAI Texts...");
     sEventAIMgr.LoadCreatureEventAI_Texts(false);           // false, will checked in LoadCreatureEventAI_Scripts
@@ -1361,6 +1643,7 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading CreatureEventAI Scripts...");
     sEventAIMgr.LoadCreatureEventAI_Scripts();
 
+    sStartupProfiler.BeginPhase("Script library");
     // 加载SD3脚本
     sLog.outString("Initializing Scripts...");
 #ifdef ENABLE_SD3
@@ -1384,6 +1667,7 @@ void World::SetInitialWorldSettings()
 #endif /* ENABLE_SD3 */
     sLog.outString();
 
+    sStartupProfiler.BeginPhase("Timers and static helpers");
     ///- Initialize game time and timers
     sLog.outString("Initialize game time and timers");
     m_gameTime = time(NULL);
@@ -1409,6 +1693,13 @@ void World::SetInitialWorldSettings()
     // for AhBot
     m_timers[WUPDATE_AHBOT].SetInterval(20 * IN_MILLISECONDS); // every 20 sec
 
+    m_timers[WUPDATE_OPCODE_TIMES].SetInterval(getConfig(CONFIG_UINT32_OPCODE_PERF_LOG_INTERVAL));
+
+    // positions of the login queue are sent at most once per interval
+    m_timers[WUPDATE_QUEUE_POSITIONS].SetInterval(getConfig(CONFIG_UINT32_PLAYER_QUEUE_UPDATE_INTERVAL));
+
+    m_timers[WUPDATE_SESSION_ACCOUNTING].SetInterval(getConfig(CONFIG_UINT32_SESSION_ACCOUNTING_CHECK_INTERVAL));
+
     // for AutoBroadcast
     sLog.outString("Starting AutoBroadcast System");
     if (m_broadcastEnable)
@@ -1438,6 +1729,7 @@ void World::SetInitialWorldSettings()
     AIRegistry::Initialize();
     Player::InitVisibleBits();
 
+    sStartupProfiler.BeginPhase("Map, battleground and outdoor PvP systems");
     ///- Initialize MapManager
     sLog.outString("Starting Map System");
     sMapMgr.Initialize();
@@ -1452,6 +1744,7 @@ void World::SetInitialWorldSettings()
     sOutdoorPvPMgr.InitOutdoorPvP();
 
 
+    sStartupProfiler.BeginPhase("Warden, bans, maintenance and standing");
     // Initialize Warden
     sLog.outString("Loading Warden Checks...");
     sWardenCheckMgr->LoadWardenChecks();
@@ -1471,11 +1764,13 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Honor Standing list...");
     sObjectMgr.LoadStandingList();
 
+    sStartupProfiler.BeginPhase("Game event start");
     sLog.outString("Starting Game Event system...");
     uint32 nextGameEvent = sGameEventMgr.Initialize();
     m_timers[WUPDATE_EVENTS].SetInterval(nextGameEvent);    // depend on next event
     sLog.outString();
 
+    sStartupProfiler.BeginPhase("Continents and transports");
     sLog.outString("Loading grids for active creatures and local transports...");
     sMapMgr.LoadContinents();
     sLog.outString();
@@ -1484,6 +1779,7 @@ void World::SetInitialWorldSettings()
     sMapMgr.LoadTransports();
     sLog.outString();
 
+    sStartupProfiler.BeginPhase("Old characters and AuctionHouseBot");
     // Delete all characters which have been deleted X days before
     Player::DeleteOldCharacters();
 
@@ -1491,6 +1787,8 @@ void World::SetInitialWorldSettings()
     sAuctionBot.Initialize();
     sLog.outString();
 
+    sStartupProfiler.BeginPhase("Eluna scripts and playerbots");
+
 #ifdef ENABLE_ELUNA
     ///- Run eluna scripts.
     // in multithread foreach: run scripts
@@ -1502,6 +1800,14 @@ void World::SetInitialWorldSettings()
     sPlayerbotAIConfig.Initialize();
 #endif
 
+    if (uint32 cliThreads = getConfig(CONFIG_UINT32_CLI_COMMAND_THREADS))
+    {
+        if (m_cliCommandExecutor._activate(cliThreads) == -1)
+        {
+            sLog.outError("Can't start %u CLI command threads, all console commands are run on the world thread", cliThreads);
+        }
+    }
+
     showFooter();
 
     uint32 startupDuration = GetMSTimeDiffToNow(startupBegin);
@@ -1647,6 +1953,10 @@ void World::DetectDBCLang()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    static MetricHistogram& tickMetric = sMetrics.GetHistogram("mangos_world_tick_seconds", "Duration of one world update", Metrics::GetTickBuckets());
+
+    std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now();
+
     ///- Update the different timers
     for (int i = 0; i < WUPDATE_COUNT; ++i)
     {
@@ -1718,6 +2028,30 @@ void World::Update(uint32 diff)
     /// <li> Handle session updates
     UpdateSessions(diff);
 
+    /// <li> Send the new login queue positions
+    if (m_timers[WUPDATE_QUEUE_POSITIONS].Passed())
+    {
+        m_timers[WUPDATE_QUEUE_POSITIONS].Reset();
+        if (m_queuePositionsChanged)
+        {
+            UpdateQueuePositions();
+        }
+    }
+
+    /// <li> Log the sessions using more than their share
+    if (getConfig(CONFIG_UINT32_SESSION_ACCOUNTING_CHECK_INTERVAL) && m_timers[WUPDATE_SESSION_ACCOUNTING].Passed())
+    {
+        m_timers[WUPDATE_SESSION_ACCOUNTING].Reset();
+        CheckSessionTraffic();
+    }
+
+    /// <li> Log the most expensive opcode handlers
+    if (getConfig(CONFIG_UINT32_OPCODE_PERF_LOG_INTERVAL) && m_timers[WUPDATE_OPCODE_TIMES].Passed())
+    {
+        m_timers[WUPDATE_OPCODE_TIMES].Reset();
+        sOpcodeUpdateTime.LogOpcodeTimes(20);
+    }
+
     /// <li> Update uptime table
     if (m_timers[WUPDATE_UPTIME].Passed())
     {
@@ -1750,6 +2084,15 @@ void World::Update(uint32 diff)
     // execute callbacks from sql queries that were queued recently
     UpdateResultQueue();
 
+    // swap in loot templates read by a background `.reload all_loot delta`, map threads are idle here
+    UpdateLootTablesDeltaReload();
+
+    // swap in the honor standings of a weekly maintenance, map threads are idle here
+    if (sObjectMgr.UpdateHonorStandingTask())
+    {
+        ServerMaintenanceFinish();
+    }
+
     ///- Erase corpses once every 20 minutes
     if (m_timers[WUPDATE_CORPSES].Passed())
     {
@@ -1779,7 +2122,6 @@ void World::Update(uint32 diff)
         if (GetDateToday() >= m_NextMaintenanceDate)
         {
             ServerMaintenanceStart();
-            sObjectMgr.LoadStandingList();
         }
         m_MaintenanceTimeChecker = 600000; // check 10 minutes
     }
@@ -1793,6 +2135,61 @@ void World::Update(uint32 diff)
 
     // cleanup unused GridMap objects as well as VMaps
     sTerrainMgr.Update(diff);
+
+    if (m_timers[WUPDATE_METRICS].Passed())
+    {
+        m_timers[WUPDATE_METRICS].Reset();
+        UpdateMetrics();
+    }
+
+    tickMetric.Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - tickStart).count());
+}
+
+void World::UpdateMetrics()
+{
+    static MetricGauge& activeSessions = sMetrics.GetGauge("mangos_sessions", "World sessions by state", "state=\"active\"");
+    static MetricGauge& queuedSessions = sMetrics.GetGauge("mangos_sessions", "World sessions by state", "state=\"queued\"");
+    static MetricGauge& mmapTiles = sMetrics.GetGauge("mangos_mmap_tiles_loaded", "Navigation mesh tiles loaded");
+    static MetricGauge& worldQueue = sMetrics.GetGauge("mangos_db_async_queue", "Statements waiting for the async database threads", "db=\"world\"");
+    static MetricGauge& characterQueue = sMetrics.GetGauge("mangos_db_async_queue", "Statements waiting for the async database threads", "db=\"character\"");
+    static MetricGauge& loginQueue = sMetrics.GetGauge("mangos_db_async_queue", "Statements waiting for the async database threads", "db=\"login\"");
+
+    activeSessions.Set(GetActiveSessionCount());
+    queuedSessions.Set(GetQueuedSessionCount());
+    mmapTiles.Set(MMAP::MMapFactory::createOrGetMMapManager()->getLoadedTilesCount());
+
+    struct
+    {
+        Database* database;
+        MetricGauge* gauge;
+    } const queues[] = { { &WorldDatabase, &worldQueue }, { &CharacterDatabase, &characterQueue }, { &LoginDatabase, &loginQueue } };
+
+    std::vector<uint32> sizes;
+    for (size_t i = 0; i < countof(queues); ++i)
+    {
+        queues[i].database->GetAsyncQueueSizes(sizes);
+
+        uint32 total = 0;
+        for (std::vector<uint32>::const_iterator itr = sizes.begin(); itr != sizes.end(); ++itr)
+        {
+            total += *itr;
+        }
+
+        queues[i].gauge->Set(total);
+    }
+
+    // the owners are a fixed set of names, the gauges are found again by their label
+    MemoryUsageList memory;
+    MemoryUsage::Collect(memory);
+    for (MemoryUsageList::const_iterator itr = memory.begin(); itr != memory.end(); ++itr)
+    {
+        std::string label = std::string("owner=\"") + itr->owner + "\"";
+        sMetrics.GetGauge("mangos_memory_entries", "Entries held per owner, see .server perf memory", label).Set(itr->count);
+        if (itr->sized)
+        {
+            sMetrics.GetGauge("mangos_memory_bytes", "Approximate bytes held per owner, see .server perf memory", label).Set(itr->bytes);
+        }
+    }
 }
 
 namespace MaNGOS
@@ -1952,7 +2349,17 @@ void World::SendDefenseMessage(uint32 zoneId, int32 textId)
 /// Kick (and save) all players
 void World::KickAll()
 {
-    m_QueuedSessions.clear();                               // prevent send queue update packet and login queued sessions
+    // prevent send queue update packet and login queued sessions
+    for (Queue::const_iterator itr = m_QueuedSessions.begin(); itr != m_QueuedSessions.end(); ++itr)
+    {
+        if (*itr)
+        {
+            (*itr)->SetInQueue(false);
+        }
+    }
+    m_QueuedSessions.clear();
+    m_queuedSessionCount = 0;
+    m_queuePositionsChanged = false;
 
     // session not removed at kick and will removed in next update tick
     for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
@@ -2208,6 +2615,34 @@ void World::UpdateSessions(uint32 /*diff*/)
         AddSession_(sess);
     }
 
+    ///- Handle the session-safe packets on the map update threads, the maps are not updated yet
+#if !defined(ENABLE_ELUNA) && !defined(ENABLE_PLAYERBOTS)
+    uint32 parallelThreshold = getConfig(CONFIG_UINT32_SESSION_UPDATE_PARALLEL_THRESHOLD);
+    MapUpdater& mapUpdater = sMapMgr.GetMapUpdater();
+    if (parallelThreshold && m_sessions.size() >= parallelThreshold && mapUpdater.activated() && !sTickRecorder.IsActive())
+    {
+        // the job is shared with helper threads that may only get scheduled after this update is finished
+        SessionUpdateJob* job = new SessionUpdateJob();
+        job->incReference();
+
+        job->Reserve(m_sessions.size());
+        for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
+        {
+            job->AddSession(itr->second);
+        }
+
+        size_t helpers = std::min(job->GetSessionCount() - 1, mapUpdater.thread_count());
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            mapUpdater.schedule_task(new SessionUpdateJob::HelperRequest(job));
+        }
+
+        job->run();
+        job->WaitForCompletion();
+        job->decReference();
+    }
+#endif
+
     ///- Then send an update signal to remaining ones
     for (SessionMap::iterator itr = m_sessions.begin(), next; itr != m_sessions.end(); itr = next)
     {
@@ -2236,17 +2671,20 @@ void World::ServerMaintenanceStart()
         m_NextMaintenanceDate += 7;
     }
 
-    // flushing rank points list ( standing must be reloaded after server maintenance )
-    sObjectMgr.FlushRankPoints(LastWeekEnd);
+    // flushing rank points list and reloading the standing, done in a background thread, see ServerMaintenanceFinish
+    sObjectMgr.StartHonorStandingUpdate(LastWeekEnd, true);
+
+    CharacterDatabase.PExecute("UPDATE `saved_variables` SET `NextMaintenanceDate` = '" UI64FMTD "'", uint64(m_NextMaintenanceDate));
+}
 
+void World::ServerMaintenanceFinish()
+{
     // save and update all online players
     for (SessionMap::iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
         if (itr->second->GetPlayer() && itr->second->GetPlayer()->IsInWorld())
         {
             itr->second->GetPlayer()->SaveToDB();
         }
-
-    CharacterDatabase.PExecute("UPDATE `saved_variables` SET `NextMaintenanceDate` = '" UI64FMTD "'", uint64(m_NextMaintenanceDate));
 }
 
 void World::InitServerMaintenanceCheck()
@@ -2273,24 +2711,101 @@ void World::InitServerMaintenanceCheck()
     DEBUG_LOG("Server maintenance check initialized.");
 }
 
+/// A read only CLI/RA/SOAP command waiting for a CLI command thread
+class CliCommandRequest : public ACE_Method_Request
+{
+    public:
+        explicit CliCommandRequest(CliCommandHolder* command) : m_command(command), m_queueTime(getMSTime()) {}
+
+        // not run (executor stopped or the queue refused it), the caller must not wait forever
+        ~CliCommandRequest()
+        {
+            if (m_command)
+            {
+                if (m_command->m_commandFinished)
+                {
+                    m_command->m_commandFinished(m_command->m_callbackArg, false);
+                }
+
+                delete m_command;
+            }
+        }
+
+        int call() override
+        {
+            CliCommandHolder* command = m_command;
+            m_command = NULL;
+
+            // a command that waited too long behind others is dropped, its caller has probably given up
+            uint32 timeout = sWorld.getConfig(CONFIG_UINT32_CLI_COMMAND_QUEUE_TIMEOUT) * IN_MILLISECONDS;
+            if (timeout && GetMSTimeDiffToNow(m_queueTime) > timeout)
+            {
+                if (command->m_print)
+                {
+                    command->m_print(command->m_callbackArg, "Command dropped, it waited too long for a CLI command thread\r\n");
+                }
+
+                if (command->m_commandFinished)
+                {
+                    command->m_commandFinished(command->m_callbackArg, false);
+                }
+
+                delete command;
+                return 0;
+            }
+
+            World::ExecuteCliCommand(command);
+            return 0;
+        }
+
+    private:
+        CliCommandHolder* m_command;
+        uint32 m_queueTime;
+};
+
 // This handles the issued and queued CLI/RA commands
 void World::ProcessCliCommands()
 {
     CliCommandHolder* command;
     while (cliCmdQueue.next(command))
     {
-        DEBUG_LOG("CLI command under processing...");
-        CliCommandHolder::Print* zprint = command->m_print;
-        void* callbackArg = command->m_callbackArg;
-        CliHandler handler(command->m_cliAccountId, command->m_cliAccessLevel, callbackArg, zprint);
-        handler.ParseCommands(command->m_command);
-
-        if (command->m_commandFinished)
+        // commands that only read static data or the DB don't hold up the world update
+        if (m_cliCommandExecutor.activated())
         {
-            command->m_commandFinished(callbackArg, !handler.HasSentErrorMessage());
+            CliHandler finder(command->m_cliAccountId, command->m_cliAccessLevel, NULL, NULL);
+            ChatCommand const* chatCommand = finder.FindCommand(command->m_command);
+            if (chatCommand && chatCommand->Concurrent)
+            {
+                m_cliCommandExecutor.execute(new CliCommandRequest(command));
+                continue;
+            }
         }
 
-        delete command;
+        ExecuteCliCommand(command);
+    }
+}
+
+void World::ExecuteCliCommand(CliCommandHolder* command)
+{
+    DEBUG_LOG("CLI command under processing...");
+    CliCommandHolder::Print* zprint = command->m_print;
+    void* callbackArg = command->m_callbackArg;
+    CliHandler handler(command->m_cliAccountId, command->m_cliAccessLevel, callbackArg, zprint);
+    handler.ParseCommands(command->m_command);
+
+    if (command->m_commandFinished)
+    {
+        command->m_commandFinished(callbackArg, !handler.HasSentErrorMessage());
+    }
+
+    delete command;
+}
+
+void World::StopCliCommandThreads()
+{
+    if (m_cliCommandExecutor.activated())
+    {
+        m_cliCommandExecutor.deactivate();
     }
 }
 
@@ -2320,10 +2835,8 @@ void World::_UpdateRealmCharCount(QueryResult* resultCharCount, uint32 accountId
         uint32 charCount = fields[0].GetUInt32();
         delete resultCharCount;
 
-        LoginDatabase.BeginTransaction();
-        LoginDatabase.PExecute("DELETE FROM `realmcharacters` WHERE `acctid`= '%u' AND `realmid` = '%u'", accountId, realmID);
-        LoginDatabase.PExecute("INSERT INTO `realmcharacters` (`numchars`, `acctid`, `realmid`) VALUES (%u, %u, %u)", charCount, accountId, realmID);
-        LoginDatabase.CommitTransaction();
+        // deleting several characters in a row only writes the last count
+        LoginDatabase.PExecuteCoalesced("realmcharacters", accountId, "REPLACE INTO `realmcharacters` (`numchars`, `acctid`, `realmid`) VALUES (%u, %u, %u)", charCount, accountId, realmID);
     }
 }
 
@@ -2346,8 +2859,8 @@ void World::SetPlayerLimit(int32 limit, bool needUpdate)
 
 void World::UpdateMaxSessionCounters()
 {
-    m_maxActiveSessionCount = std::max(m_maxActiveSessionCount, uint32(m_sessions.size() - m_QueuedSessions.size()));
-    m_maxQueuedSessionCount = std::max(m_maxQueuedSessionCount, uint32(m_QueuedSessions.size()));
+    m_maxActiveSessionCount = std::max(m_maxActiveSessionCount, uint32(m_sessions.size() - m_queuedSessionCount));
+    m_maxQueuedSessionCount = std::max(m_maxQueuedSessionCount, m_queuedSessionCount);
 }
 
 void World::LoadDBVersion()
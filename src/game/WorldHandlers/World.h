@@ -33,9 +33,12 @@
 #include "Timer.h"
 #include "Policies/Singleton.h"
 #include "SharedDefines.h"
+#include "SessionAccounting.h"
+#include "DelayExecutor.h"
 
 #include <set>
 #include <list>
+#include <deque>
 
 class Object;
 class ObjectGuid;
@@ -79,6 +82,10 @@ enum WorldTimers
     WUPDATE_EVENTS,
     WUPDATE_DELETECHARS,
     WUPDATE_AHBOT,
+    WUPDATE_OPCODE_TIMES,
+    WUPDATE_METRICS,
+    WUPDATE_QUEUE_POSITIONS,
+    WUPDATE_SESSION_ACCOUNTING,
     WUPDATE_COUNT
 };
 
@@ -111,6 +118,8 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MIN_HONOR_KILLS,
     CONFIG_UINT32_INSTANCE_RESET_TIME_HOUR,
     CONFIG_UINT32_INSTANCE_UNLOAD_DELAY,
+    CONFIG_UINT32_INSTANCE_HIBERNATION_DELAY,
+    CONFIG_UINT32_INSTANCE_HIBERNATION_MAX_DIFF,
     CONFIG_UINT32_MAX_SPELL_CASTS_IN_CHAIN,
     CONFIG_UINT32_MIN_TRAIN_MOUNT_LEVEL,
     CONFIG_UINT32_MOUNT_COST,
@@ -136,9 +145,12 @@ enum eConfigUInt32Values
     CONFIG_UINT32_GM_INVISIBLE_AURA,
     CONFIG_UINT32_GM_MAX_SPEED_FACTOR,
     CONFIG_UINT32_GROUP_VISIBILITY,
+    CONFIG_UINT32_GROUP_MEMBER_UPDATE_DELAY,
     CONFIG_UINT32_MAIL_DELIVERY_DELAY,
     CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK,
+    CONFIG_UINT32_MASS_MAILER_UPDATE_TIME_BUDGET,
     CONFIG_UINT32_UPTIME_UPDATE,
+    CONFIG_UINT32_PLAYER_QUEUE_UPDATE_INTERVAL,
     CONFIG_UINT32_AUCTION_DEPOSIT_MIN,
     CONFIG_UINT32_RATE_MINING_LOWER,
     CONFIG_UINT32_RATE_MINING_RARE,
@@ -187,9 +199,39 @@ enum eConfigUInt32Values
     CONFIG_UINT32_CHARDELETE_METHOD,
     CONFIG_UINT32_CHARDELETE_MIN_LEVEL,
     CONFIG_UINT32_NUMTHREADS,
+    CONFIG_UINT32_MAP_UPDATE_SCHEDULER,
+    CONFIG_UINT32_INSTANCE_UPDATE_THREADS,
+    CONFIG_UINT32_MAP_UPDATE_PERF_LOG_INTERVAL,
+    CONFIG_UINT32_MAP_UPDATE_ADAPTIVE_MAX_INTERVAL,
+    CONFIG_UINT32_MAP_UPDATE_PACKET_BUILD_THRESHOLD,
+    CONFIG_UINT32_SESSION_UPDATE_PARALLEL_THRESHOLD,
+    CONFIG_UINT32_GRID_LOADER_THREADS,
+    CONFIG_UINT32_GRID_PREFETCH_DISTANCE,
+    CONFIG_UINT32_VMAP_LOS_CACHE_TIME,
+    CONFIG_UINT32_OPCODE_PERF_LOG_INTERVAL,
+    CONFIG_UINT32_MOVEMENT_COALESCE_WINDOW,
+    CONFIG_UINT32_MOVEMENT_COALESCE_FAR_WINDOW,
+    CONFIG_UINT32_STARTUP_LOADER_THREADS,
+    CONFIG_UINT32_CHARACTER_LOGIN_CACHE_SIZE,
+    CONFIG_UINT32_CHARACTER_LOGIN_CACHE_EXPIRE,
+    CONFIG_UINT32_CHAR_ENUM_CACHE_SIZE,
+    CONFIG_UINT32_CHAR_ENUM_CACHE_EXPIRE,
+    CONFIG_UINT32_SESSION_ACCOUNTING_CHECK_INTERVAL,
+    CONFIG_UINT32_SESSION_ACCOUNTING_MAX_HANDLER_TIME,
+    CONFIG_UINT32_SESSION_ACCOUNTING_MAX_PACKETS_IN,
+    CONFIG_UINT32_SESSION_ACCOUNTING_MAX_BYTES_OUT,
+    CONFIG_UINT32_SESSION_ACCOUNTING_MAX_SEND_QUEUE,
+    CONFIG_UINT32_CLI_COMMAND_THREADS,
+    CONFIG_UINT32_CLI_COMMAND_QUEUE_TIMEOUT,
+    CONFIG_UINT32_EVENT_MAP_SPAWNS_PER_UPDATE,
+    CONFIG_UINT32_SAVE_RESPAWN_TIME_INTERVAL,
+    CONFIG_UINT32_GRID_UNLOAD_MAP_BUDGET,
+    CONFIG_UINT32_GRID_UNLOAD_TOTAL_BUDGET,
     CONFIG_UINT32_GUID_RESERVE_SIZE_CREATURE,
     CONFIG_UINT32_GUID_RESERVE_SIZE_GAMEOBJECT,
     CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY,
+    CONFIG_UINT32_CREATURE_LOD_FAR_INTERVAL,
+    CONFIG_UINT32_CREATURE_LOD_HIDDEN_INTERVAL,
     CONFIG_UINT32_MAX_WHOLIST_RETURNS,
     CONFIG_UINT32_LOG_WHISPERS,
     // Warden
@@ -288,8 +330,11 @@ enum eConfigFloatValues
     CONFIG_FLOAT_CREATURE_FAMILY_ASSISTANCE_RADIUS,
     CONFIG_FLOAT_GROUP_XP_DISTANCE,
     CONFIG_FLOAT_THREAT_RADIUS,
+    CONFIG_FLOAT_CREATURE_LOD_NEAR_DISTANCE,
     CONFIG_FLOAT_GHOST_RUN_SPEED_WORLD,
     CONFIG_FLOAT_GHOST_RUN_SPEED_BG,
+    CONFIG_FLOAT_MOVEMENT_COALESCE_FAR_DISTANCE,
+    CONFIG_FLOAT_COMBAT_LOG_DISTANCE,
 #ifdef ENABLE_PLAYERBOTS
     CONFIG_FLOAT_PLAYERBOT_MINDISTANCE,
     CONFIG_FLOAT_PLAYERBOT_MAXDISTANCE,
@@ -370,6 +415,13 @@ enum eConfigBoolValues
     CONFIG_BOOL_WARDEN_WIN_ENABLED,
     CONFIG_BOOL_WARDEN_OSX_ENABLED,
     CONFIG_BOOL_GM_TICKET_OFFLINE_CLOSING,
+    CONFIG_BOOL_MAP_UPDATE_PARALLEL_REGIONS,
+    CONFIG_BOOL_GRID_MAP_FILES_MAPPED,
+    CONFIG_BOOL_OPCODE_PERF,
+    CONFIG_BOOL_CREATURE_IDLE_SLEEP,
+    CONFIG_BOOL_QUERY_RESPONSE_CACHE,
+    CONFIG_BOOL_PLAYER_NAME_CACHE,
+    CONFIG_BOOL_COMBAT_LOG_BATCHING,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -461,12 +513,15 @@ class World
         WorldSession* FindSession(uint32 id) const;
         void AddSession(WorldSession* s);
         bool RemoveSession(uint32 id);
+        /// Sessions of mangosd --replay are listed for the lookups by account, the replay updates and deletes them
+        void AddOfflineSession(WorldSession* s);
+        void RemoveOfflineSession(uint32 id) { m_sessions.erase(id); }
         /// Get the number of current active sessions
         void UpdateMaxSessionCounters();
         const SessionMap& GetAllSessions() const { return m_sessions; }
         uint32 GetActiveAndQueuedSessionCount() const { return m_sessions.size(); }
-        uint32 GetActiveSessionCount() const { return m_sessions.size() - m_QueuedSessions.size(); }
-        uint32 GetQueuedSessionCount() const { return m_QueuedSessions.size(); }
+        uint32 GetActiveSessionCount() const { return m_sessions.size() - m_queuedSessionCount; }
+        uint32 GetQueuedSessionCount() const { return m_queuedSessionCount; }
         /// Get the maximum number of parallel sessions on the server since last reboot
         uint32 GetMaxQueuedSessionCount() const { return m_maxQueuedSessionCount; }
         uint32 GetMaxActiveSessionCount() const { return m_maxActiveSessionCount; }
@@ -479,10 +534,17 @@ class World
         void SetPlayerLimit(int32 limit, bool needUpdate = false);
 
         // player Queue
-        typedef std::list<WorldSession*> Queue;
+        typedef std::deque<WorldSession*> Queue;
         void AddQueuedSession(WorldSession*);
         bool RemoveQueuedSession(WorldSession* session);
         int32 GetQueuedSessionPos(WorldSession*);
+        void UpdateQueuePositions();
+
+        // resource use per account, of the closed sessions since the last reset and the open ones
+        typedef UNORDERED_MAP<uint32, SessionTraffic> AccountTrafficMap;
+        void AddClosedSessionTraffic(uint32 accountId, SessionTraffic const& traffic);
+        void GetAccountTraffic(AccountTrafficMap& accounts) const;
+        void ResetSessionTraffic();
 
         /// \todo Actions on m_allowMovement still to be implemented
         /// Is movement allowed?
@@ -576,6 +638,7 @@ class World
 
         /// Get configuration about force-loaded maps
         bool isForceLoadMap(uint32 id) const { return m_configForceLoadMapIds.find(id) != m_configForceLoadMapIds.end(); }
+        bool isCreatureLodExempt(uint32 entry) const { return m_configCreatureLodExemptEntries.find(entry) != m_configCreatureLodExemptEntries.end(); }
 
         /// Are we on a "Player versus Player" server?
         bool IsPvPRealm() { return (getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_PVP || getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_RPPVP || getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_FFA_PVP); }
@@ -600,13 +663,21 @@ class World
 
         void InitServerMaintenanceCheck();
         void ServerMaintenanceStart();
+        void ServerMaintenanceFinish();
 
         void ProcessCliCommands();
         void QueueCliCommand(CliCommandHolder* commandHolder) { cliCmdQueue.add(commandHolder); }
+        // runs a command and deletes the holder, on the world thread or for ChatCommand::Concurrent commands a CLI command thread
+        static void ExecuteCliCommand(CliCommandHolder* command);
+        // waits for the running CLI command threads, queued commands are run on the world thread from then on
+        void StopCliCommandThreads();
 
         void UpdateResultQueue();
         void InitResultQueue();
 
+        // refresh the gauges of sMetrics owned by the world thread
+        void UpdateMetrics();
+
         void UpdateRealmCharCount(uint32 accid);
 
         LocaleConstant GetAvailableDbcLocale(LocaleConstant locale) const { if (m_availableDbcLocaleMask & (1 << locale)) { return locale; } else { return m_defaultDbcLocale; } }
@@ -707,9 +778,20 @@ class World
 
         // CLI command holder to be thread safe
         ACE_Based::LockedQueue<CliCommandHolder*, ACE_Thread_Mutex> cliCmdQueue;
+        DelayExecutor m_cliCommandExecutor;                 // CliCommandThreads, for the read only commands
 
-        // Player Queue
+        // Player Queue, sessions are addressed by their sequence number minus the one of the front,
+        // the slot of a session that left before reaching the front is NULL until the next compaction
         Queue m_QueuedSessions;
+        uint32 m_queuedSessionCount;                        // sessions still waiting in m_QueuedSessions
+        uint32 m_queueFrontSequence;
+        bool m_queuePositionsChanged;                       // positions sent to the clients are outdated
+        void PopQueueFrontSlots();
+
+        // bot sessions are deleted outside of the world thread as well
+        AccountTrafficMap m_closedSessionTraffic;
+        mutable ACE_Thread_Mutex m_closedSessionTrafficLock;
+        void CheckSessionTraffic();
 
         // sessions that are added async
         void AddSession_(WorldSession* s);
@@ -720,6 +802,7 @@ class World
 
         // List of Maps that should be force-loaded on startup
         std::set<uint32> m_configForceLoadMapIds;
+        std::set<uint32> m_configCreatureLodExemptEntries;
 };
 
 extern uint32 realmID;
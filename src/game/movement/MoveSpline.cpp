@@ -23,6 +23,7 @@
  */
 
 #include "MoveSpline.h"
+#include "packet_builder.h"
 #include <sstream>
 #include "Log.h"
 #include "Unit.h"
@@ -163,6 +164,7 @@ namespace Movement
         m_Id = args.splineId;
         point_Idx_offset = args.path_Idx_offset;
         time_passed = 0;
+        create_path.clear();
 
         // detect Stop command
         if (splineflags.done)
@@ -172,9 +174,12 @@ namespace Movement
         }
 
         init_spline(args);
+
+        // built here and not on first use, update blocks for several observers may be written in parallel
+        PacketBuilder::WriteCreatePath(*this, create_path);
     }
 
-    MoveSpline::MoveSpline() : m_Id(0), time_passed(0), point_Idx(0), point_Idx_offset(0)
+    MoveSpline::MoveSpline() : m_Id(0), time_passed(0), point_Idx(0), point_Idx_offset(0), create_path(0)
     {
         splineflags.done = true;
     }
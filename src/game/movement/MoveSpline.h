@@ -27,6 +27,7 @@
 
 #include "spline.h"
 #include "MoveSplineInitArgs.h"
+#include "ByteBuffer.h"
 
 namespace Movement
 {
@@ -120,6 +121,8 @@ namespace Movement
             int32           point_Idx; /**< TODO */
             int32           point_Idx_offset; /**< TODO */
 
+            ByteBuffer      create_path; /**< path part of the create block, written once per launch and shared by all observers */
+
             /**
              * @brief
              *
@@ -27,8 +27,56 @@
 #include "packet_builder.h"
 #include "Unit.h"
 
+#include <ace/TSS_T.h>
+
 namespace Movement
 {
+    // path vectors of finished MoveSplineInit instances, per thread
+    class SplinePathCache
+    {
+        public:
+            enum
+            {
+                MAX_CACHED_PATHS    = 8,                    // nested inits on one thread are rare
+                MAX_CACHED_CAPACITY = 256,                  // longer paths are freed instead of kept
+                DEFAULT_CAPACITY    = 16
+            };
+
+            void Take(PointsArray& path)
+            {
+                if (m_paths.empty())
+                {
+                    path.reserve(DEFAULT_CAPACITY);
+                    return;
+                }
+
+                path.swap(m_paths.back());
+                m_paths.pop_back();
+            }
+
+            void Give(PointsArray& path)
+            {
+                if (m_paths.size() >= MAX_CACHED_PATHS || path.capacity() > MAX_CACHED_CAPACITY)
+                {
+                    return;
+                }
+
+                path.clear();
+                m_paths.push_back(PointsArray());
+                m_paths.back().swap(path);
+            }
+
+        private:
+            std::vector<PointsArray> m_paths;
+    };
+
+    static SplinePathCache* GetSplinePathCache()
+    {
+        // never destroyed, the per thread caches are destroyed by ACE when their thread exits
+        static ACE_TSS<SplinePathCache>* cache = new ACE_TSS<SplinePathCache>();
+        return *cache;
+    }
+
     UnitMoveType SelectSpeedType(uint32 moveFlags)
     {
         if (moveFlags & MOVEFLAG_SWIMMING)
@@ -58,6 +106,7 @@ namespace Movement
     int32 MoveSplineInit::Launch()
     {
         MoveSpline& move_spline = *unit.movespline;
+        unit.WakeUp();
 
         Vector3 real_position(unit.GetPositionX(), unit.GetPositionY(), unit.GetPositionZ());
         // there is a big chance that current position is unknown if current state is not finalized, need compute it
@@ -151,13 +200,20 @@ namespace Movement
         unit.SendMessageToSet(&data, true);
     }
 
-    MoveSplineInit::MoveSplineInit(Unit& m) : unit(m)
+    MoveSplineInit::MoveSplineInit(Unit& m) : args(0), unit(m)
     {
+        GetSplinePathCache()->Take(args.path);
+
         // mix existing state into new
         args.flags.runmode = !unit.m_movementInfo.HasMovementFlag(MOVEFLAG_WALK_MODE);
         args.flags.flying = unit.m_movementInfo.HasMovementFlag((MovementFlags)(MOVEFLAG_CAN_FLY | MOVEFLAG_FLYING | MOVEFLAG_LEVITATING));
     }
 
+    MoveSplineInit::~MoveSplineInit()
+    {
+        GetSplinePathCache()->Give(args.path);
+    }
+
     void MoveSplineInit::SetFacing(const Unit* target)
     {
         args.flags.EnableFacingTarget();
@@ -47,6 +47,12 @@ namespace Movement
              */
             explicit MoveSplineInit(Unit& m);
 
+            /**
+             * @brief Hands the path storage back for reuse by the next spline of this thread.
+             *
+             */
+            ~MoveSplineInit();
+
             /**
              * @brief Final pass of initialization that launches spline movement.
              *
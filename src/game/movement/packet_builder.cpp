@@ -147,6 +147,20 @@ namespace Movement
         }
 
         data << move_spline.timePassed();
+
+        // serialized once at launch, see MoveSpline::Initialize
+        if (!move_spline.create_path.empty())
+        {
+            data.append(move_spline.create_path);
+        }
+        else
+        {
+            WriteCreatePath(move_spline, data);
+        }
+    }
+
+    void PacketBuilder::WriteCreatePath(const MoveSpline& move_spline, ByteBuffer& data)
+    {
         data << move_spline.Duration();
         data << move_spline.GetId();
 
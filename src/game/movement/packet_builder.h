@@ -60,6 +60,13 @@ namespace Movement
              * @param data
              */
             static void WriteCreate(const MoveSpline& mov, ByteBuffer& data);
+            /**
+             * @brief writes the part of the create block that does not change while the spline runs
+             *
+             * @param mov
+             * @param data
+             */
+            static void WriteCreatePath(const MoveSpline& mov, ByteBuffer& data);
     };
 }
 #endif // MANGOSSERVER_PACKET_BUILDER_H
@@ -23,6 +23,7 @@
  */
 
 #include "BIH.h"
+#include "FileReader.h"
 
 void BIH::buildHierarchy(std::vector<uint32>& tempTree, buildData& dat, BuildStats& stats)
 {
@@ -286,20 +287,20 @@ bool BIH::WriteToFile(FILE* wf) const
     return check == (3 + 3 + 2 + treeSize + count);
 }
 
-bool BIH::ReadFromFile(FILE* rf)
+bool BIH::ReadFromFile(VMAP::FileReader& rf)
 {
     uint32 treeSize;
     Vector3 lo, hi;
     uint32 check = 0, count = 0;
-    check += fread(&lo, sizeof(float), 3, rf);
-    check += fread(&hi, sizeof(float), 3, rf);
+    check += rf.Read(&lo, sizeof(float), 3);
+    check += rf.Read(&hi, sizeof(float), 3);
     bounds = AABox(lo, hi);
-    check += fread(&treeSize, sizeof(uint32), 1, rf);
+    check += rf.Read(&treeSize, sizeof(uint32), 1);
     tree.resize(treeSize);
-    check += fread(&tree[0], sizeof(uint32), treeSize, rf);
-    check += fread(&count, sizeof(uint32), 1, rf);
+    check += rf.Read(&tree[0], sizeof(uint32), treeSize);
+    check += rf.Read(&count, sizeof(uint32), 1);
     objects.resize(count); // = new uint32[nObjects];
-    check += fread(&objects[0], sizeof(uint32), count, rf);
+    check += rf.Read(&objects[0], sizeof(uint32), count);
     return check == (3 + 3 + 2 + treeSize + count);
 }
 
@@ -37,7 +37,13 @@
 #include <limits>
 #include <cmath>
 
+namespace VMAP
+{
+    class FileReader;
+}
+
 #define MAX_STACK_SIZE 64
+#define BIH_PACKET_SIZE 4
 
 #ifdef _MSC_VER
 #define isnan(x) _isnan(x)
@@ -349,6 +355,266 @@ class BIH
             }
         }
 
+        template<typename RayCallback>
+        /**
+         * @brief Traverses up to BIH_PACKET_SIZE rays together, each stopping at its first hit
+         *
+         * Makes the same decisions as intersectRay with stopAtFirst for every ray,
+         * but walks every node once for all rays still passing through it. The
+         * direction signs of all rays have to be the same on every axis, so one
+         * front/back order is valid for the whole packet.
+         *
+         * @param rays rays of the packet
+         * @param count number of rays, at most BIH_PACKET_SIZE
+         * @param intersectCallback called for every ray and object of the leaves it reaches
+         * @param maxDist search distance of every ray
+         * @param hit set for every ray which hit an object within its distance
+         */
+        void intersectRayPacket(const Ray* rays, uint32 count, RayCallback& intersectCallback, const float* maxDist, bool* hit) const
+        {
+            float intervalMin[BIH_PACKET_SIZE];
+            float intervalMax[BIH_PACKET_SIZE];
+            uint32 active = 0;
+            uint32 hitMask = 0;
+
+            for (uint32 k = 0; k < count; ++k)
+            {
+                hit[k] = false;
+
+                // clip against the tree bounds, same as intersectRay
+                float tmin = -1.f;
+                float tmax = -1.f;
+                Vector3 const& org = rays[k].origin();
+                Vector3 const& dir = rays[k].direction();
+                Vector3 const& invDir = rays[k].invDirection();
+                bool outside = false;
+                for (int i = 0; i < 3 && !outside; ++i)
+                {
+                    if (G3D::fuzzyNe(dir[i], 0.0f))
+                    {
+                        float t1 = (bounds.low()[i]  - org[i]) * invDir[i];
+                        float t2 = (bounds.high()[i] - org[i]) * invDir[i];
+                        if (t1 > t2)
+                        {
+                            std::swap(t1, t2);
+                        }
+                        if (t1 > tmin)
+                        {
+                            tmin = t1;
+                        }
+                        if (t2 < tmax || tmax < 0.f)
+                        {
+                            tmax = t2;
+                        }
+                        outside = tmax <= 0 || tmin >= maxDist[k];
+                    }
+                }
+
+                if (outside || tmin > tmax)
+                {
+                    continue;
+                }
+
+                intervalMin[k] = std::max(tmin, 0.f);
+                intervalMax[k] = std::min(tmax, maxDist[k]);
+                active |= 1 << k;
+            }
+
+            if (!active)
+            {
+                return;
+            }
+
+            // shared by the packet, see the direction sign requirement
+            Vector3 const& dir = rays[0].direction();
+            uint32 offsetFront[3];
+            uint32 offsetBack[3];
+            uint32 offsetFront3[3];
+            uint32 offsetBack3[3];
+
+            for (int i = 0; i < 3; ++i)
+            {
+                offsetFront[i] = floatToRawIntBits(dir[i]) >> 31;
+                offsetBack[i] = offsetFront[i] ^ 1;
+                offsetFront3[i] = offsetFront[i] * 3;
+                offsetBack3[i] = offsetBack[i] * 3;
+
+                ++offsetFront[i];
+                ++offsetBack[i];
+            }
+
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true)
+            {
+                while (active)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = tn & (1 << 29);
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node
+                            float front = intBitsToFloat(tree[node + offsetFront[axis]]);
+                            float back = intBitsToFloat(tree[node + offsetBack[axis]]);
+                            uint32 frontMask = 0;
+                            uint32 backMask = 0;
+                            float backMin[BIH_PACKET_SIZE];
+                            for (uint32 k = 0; k < count; ++k)
+                            {
+                                if (!(active & (1 << k)))
+                                {
+                                    continue;
+                                }
+
+                                float tf = (front - rays[k].origin()[axis]) * rays[k].invDirection()[axis];
+                                float tb = (back - rays[k].origin()[axis]) * rays[k].invDirection()[axis];
+                                if (!(tf < intervalMin[k]))
+                                {
+                                    frontMask |= 1 << k;
+                                }
+                                if (!(tb > intervalMax[k]))
+                                {
+                                    backMask |= 1 << k;
+                                    backMin[k] = (tb >= intervalMin[k]) ? tb : intervalMin[k];
+                                }
+                                if (frontMask & (1 << k))
+                                {
+                                    // the back interval still needs the old upper bound
+                                    stack[stackPos].tfar[k] = intervalMax[k];
+                                    intervalMax[k] = (tf <= intervalMax[k]) ? tf : intervalMax[k];
+                                }
+                            }
+
+                            int backNode = offset + offsetBack3[axis];
+                            if (!frontMask)
+                            {
+                                // rays pass through far node only (or between the clip zones)
+                                for (uint32 k = 0; k < count; ++k)
+                                {
+                                    if (backMask & (1 << k))
+                                    {
+                                        intervalMin[k] = backMin[k];
+                                    }
+                                }
+                                node = backNode;
+                                active = backMask;
+                                continue;
+                            }
+
+                            if (backMask)
+                            {
+                                // push back node for the rays passing through it
+                                stack[stackPos].node = backNode;
+                                stack[stackPos].mask = backMask;
+                                for (uint32 k = 0; k < count; ++k)
+                                {
+                                    if (backMask & (1 << k))
+                                    {
+                                        stack[stackPos].tnear[k] = backMin[k];
+                                        if (!(frontMask & (1 << k)))
+                                        {
+                                            stack[stackPos].tfar[k] = intervalMax[k];
+                                        }
+                                    }
+                                }
+                                ++stackPos;
+                            }
+
+                            node = offset + offsetFront3[axis];
+                            active = frontMask;
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects
+                            int n = tree[node + 1];
+                            while (n > 0 && active)
+                            {
+                                for (uint32 k = 0; k < count; ++k)
+                                {
+                                    if (!(active & (1 << k)))
+                                    {
+                                        continue;
+                                    }
+
+                                    float distance = maxDist[k];
+                                    if (intersectCallback(rays[k], objects[offset], distance, true))
+                                    {
+                                        hit[k] = true;
+                                        hitMask |= 1 << k;
+                                        active &= ~(1 << k);
+                                    }
+                                }
+                                --n;
+                                ++offset;
+                            }
+
+                            if (hitMask == (1u << count) - 1)
+                            {
+                                return;
+                            }
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis > 2)
+                        {
+                            return;  // should not happen
+                        }
+                        float front = intBitsToFloat(tree[node + offsetFront[axis]]);
+                        float back = intBitsToFloat(tree[node + offsetBack[axis]]);
+                        for (uint32 k = 0; k < count; ++k)
+                        {
+                            if (!(active & (1 << k)))
+                            {
+                                continue;
+                            }
+
+                            float tf = (front - rays[k].origin()[axis]) * rays[k].invDirection()[axis];
+                            float tb = (back - rays[k].origin()[axis]) * rays[k].invDirection()[axis];
+                            intervalMin[k] = (tf >= intervalMin[k]) ? tf : intervalMin[k];
+                            intervalMax[k] = (tb <= intervalMax[k]) ? tb : intervalMax[k];
+                            if (intervalMin[k] > intervalMax[k])
+                            {
+                                active &= ~(1 << k);
+                            }
+                        }
+                        node = offset;
+                        continue;
+                    }
+                } // traversal loop
+
+                // move back up the stack, rays that hit something meanwhile are done
+                do
+                {
+                    if (stackPos == 0)
+                    {
+                        return;
+                    }
+                    --stackPos;
+                    active = stack[stackPos].mask & ~hitMask;
+                }
+                while (!active);
+
+                node = stack[stackPos].node;
+                for (uint32 k = 0; k < count; ++k)
+                {
+                    if (active & (1 << k))
+                    {
+                        intervalMin[k] = stack[stackPos].tnear[k];
+                        intervalMax[k] = stack[stackPos].tfar[k];
+                    }
+                }
+            }
+        }
+
         template<typename IsectCallback>
         /**
          * @brief
@@ -460,7 +726,35 @@ class BIH
          * @param rf
          * @return bool
          */
-        bool ReadFromFile(FILE* rf);
+        bool ReadFromFile(VMAP::FileReader& rf);
+
+        template< class BoundsFunc, class PrimArray >
+        /**
+         * @brief recompute the clip planes and the root bounds from the current
+         * primitive bounds, keeping the tree layout of the last build()
+         *
+         * The tree stays valid for any primitive movement, but gets less tight.
+         * The returned cost (area of the leaf boxes weighted by their primitive
+         * count, relative to the root area) is the same measure right after a
+         * build, so callers compare the two to decide when to rebuild.
+         *
+         * @param primitives the same array build() was given, entries may be NULL
+         * @param getBounds
+         * @return float
+         */
+        float refit(const PrimArray& primitives, BoundsFunc& getBounds)
+        {
+            AABox box;
+            float cost = 0.f;
+            if (!refitNode(0, primitives, getBounds, box, cost, 0))
+            {
+                return 0.f;
+            }
+
+            bounds = box;
+            float area = box.area();
+            return area > 0.f ? cost / area : 0.f;
+        }
 
     protected:
         std::vector<uint32> tree; /**< TODO */
@@ -489,6 +783,18 @@ class BIH
             float tfar; /**< TODO */
         };
 
+        /**
+         * @brief pending back node of intersectRayPacket, with the intervals of the rays in mask
+         *
+         */
+        struct PacketStackNode
+        {
+            uint32 node;
+            uint32 mask;
+            float tnear[BIH_PACKET_SIZE];
+            float tfar[BIH_PACKET_SIZE];
+        };
+
         /**
          * @brief
          *
@@ -571,6 +877,104 @@ class BIH
             tempTree[nodeIndex + 1] = right - left + 1;
         }
 
+        template< class BoundsFunc, class PrimArray >
+        /**
+         * @brief refit of one subtree, see refit()
+         *
+         * @return bool false if the subtree holds no primitive, box is not set then
+         */
+        bool refitNode(uint32 node, const PrimArray& primitives, BoundsFunc& getBounds, AABox& box, float& cost, int depth)
+        {
+            uint32 tn = tree[node];
+            uint32 axis = (tn & (3 << 30)) >> 30;
+            bool BVH2 = tn & (1 << 29);
+            uint32 offset = tn & ~(7 << 29);
+
+            if (axis == 3)
+            {
+                // leaf
+                bool filled = false;
+                uint32 count = tree[node + 1];
+                for (uint32 i = offset; i < offset + count && i < objects.size(); ++i)
+                {
+                    if (objects[i] >= primitives.size() || !primitives[objects[i]])
+                    {
+                        continue;
+                    }
+
+                    AABox primBox;
+                    getBounds(primitives[objects[i]], primBox);
+                    if (filled)
+                    {
+                        box.merge(primBox);
+                    }
+                    else
+                    {
+                        box = primBox;
+                        filled = true;
+                    }
+                }
+                if (filled)
+                {
+                    cost += box.area() * count;
+                }
+                return filled;
+            }
+
+            if (depth >= MAX_STACK_SIZE)
+            {
+                return false;
+            }
+
+            if (BVH2)
+            {
+                // single child, clipped on both sides
+                if (!refitNode(offset, primitives, getBounds, box, cost, depth + 1))
+                {
+                    tree[node + 1] = floatToRawIntBits(G3D::inf());
+                    tree[node + 2] = floatToRawIntBits(-G3D::inf());
+                    return false;
+                }
+                tree[node + 1] = floatToRawIntBits(box.low()[axis]);
+                tree[node + 2] = floatToRawIntBits(box.high()[axis]);
+                return true;
+            }
+
+            // an empty child was never allocated, the build marks it with an infinite clip plane
+            bool hasLeft = intBitsToFloat(tree[node + 1]) != -G3D::inf();
+            bool hasRight = intBitsToFloat(tree[node + 2]) != G3D::inf();
+
+            AABox leftBox, rightBox;
+            bool leftFilled = hasLeft && refitNode(offset, primitives, getBounds, leftBox, cost, depth + 1);
+            bool rightFilled = hasRight && refitNode(offset + 3, primitives, getBounds, rightBox, cost, depth + 1);
+
+            // a child that lost all its primitives keeps its slot and is just never entered again,
+            // its clip plane is pushed far out but not to infinity so it still counts as allocated
+            if (hasLeft)
+            {
+                tree[node + 1] = floatToRawIntBits(leftFilled ? leftBox.high()[axis] : -std::numeric_limits<float>::max());
+            }
+            if (hasRight)
+            {
+                tree[node + 2] = floatToRawIntBits(rightFilled ? rightBox.low()[axis] : std::numeric_limits<float>::max());
+            }
+
+            if (leftFilled && rightFilled)
+            {
+                box = leftBox;
+                box.merge(rightBox);
+            }
+            else if (leftFilled)
+            {
+                box = leftBox;
+            }
+            else if (rightFilled)
+            {
+                box = rightBox;
+            }
+            return leftFilled || rightFilled;
+        }
+
         /**
          * @brief
          *
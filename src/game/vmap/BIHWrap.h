@@ -109,6 +109,7 @@ class BIHWrap
         G3D::Table<const T*, uint32> m_obj2Idx; /**< TODO */
         G3D::Set<const T*> m_objects_to_push; /**< TODO */
         int unbalanced_times; /**< TODO */
+        float m_buildCost; /**< refit cost of the tree right after the last build */
 
     public:
 
@@ -116,7 +117,7 @@ class BIHWrap
          * @brief
          *
          */
-        BIHWrap() : unbalanced_times(0) {}
+        BIHWrap() : unbalanced_times(0), m_buildCost(0.f) {}
 
         /**
          * @brief
@@ -166,8 +167,44 @@ class BIHWrap
             m_objects_to_push.getMembers(m_objects);
 
             m_tree.build(m_objects, BoundsFunc::getBounds2);
+            m_buildCost = m_tree.refit(m_objects, BoundsFunc::getBounds2);
         }
 
+        /**
+         * @brief the bounds of a contained object changed, refit the tree to them
+         *
+         * A full rebuild is only scheduled once the refitted tree got more than
+         * maxCostGrowth times as expensive to traverse as it was after its build.
+         *
+         * @param obj
+         * @param maxCostGrowth
+         * @return bool true if a rebuild was scheduled
+         */
+        bool refit(const T& obj, float maxCostGrowth)
+        {
+            // pending changes rebuild the tree anyway, with the new bounds
+            if (unbalanced_times > 0 || !m_objects_to_push.contains(&obj))
+            {
+                return false;
+            }
+
+            float cost = m_tree.refit(m_objects, BoundsFunc::getBounds2);
+            if (cost <= m_buildCost * maxCostGrowth)
+            {
+                return false;
+            }
+
+            ++unbalanced_times;
+            return true;
+        }
+
+        /**
+         * @brief
+         *
+         * @return bool true if the next query or balance() rebuilds the tree
+         */
+        bool isUnbalanced() const { return unbalanced_times > 0; }
+
         template<typename RayCallback>
         /**
          * @brief
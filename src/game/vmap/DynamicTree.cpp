@@ -29,6 +29,8 @@
 #include "RegularGrid.h"
 #include "GameObjectModel.h"
 
+#include <chrono>
+
 template<> struct HashTrait< GameObjectModel>
 {
     static size_t hashCode(const GameObjectModel& g) { return (size_t)(void*)&g; }
@@ -48,6 +50,8 @@ template<> struct BoundsTrait< GameObjectModel>
 
 //int UNBALANCED_TIMES_LIMIT = 5;
 int CHECK_TREE_PERIOD = 200;
+// a refitted cell tree is rebuilt once it got this much more expensive to traverse than after its build
+float REFIT_MAX_COST_GROWTH = 1.5f;
 
 typedef RegularGrid2D<GameObjectModel, BIHWrap<GameObjectModel> > ParentTree;
 
@@ -58,7 +62,10 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
 
     DynTreeImpl() :
         rebalance_timer(CHECK_TREE_PERIOD),
-        unbalanced_times(0)
+        unbalanced_times(0),
+        maintenance_time(0),
+        refit_count(0),
+        rebuild_count(0)
     {
     }
 
@@ -74,10 +81,24 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
         ++unbalanced_times;
     }
 
+    void refit(const Model& mdl)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (base::refit(mdl, REFIT_MAX_COST_GROWTH))
+        {
+            ++unbalanced_times;
+        }
+        ++refit_count;
+        maintenance_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
     void balance()
     {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
         base::balance();
         unbalanced_times = 0;
+        ++rebuild_count;
+        maintenance_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
     }
 
     void update(uint32 difftime)
@@ -100,6 +121,10 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
 
     TimeTracker rebalance_timer;
     int unbalanced_times;
+
+    uint64 maintenance_time;
+    uint32 refit_count;
+    uint32 rebuild_count;
 };
 
 DynamicMapTree::DynamicMapTree() : impl(*new DynTreeImpl())
@@ -126,6 +151,11 @@ bool DynamicMapTree::contains(const GameObjectModel& mdl) const
     return impl.contains(mdl);
 }
 
+void DynamicMapTree::refit(const GameObjectModel& mdl)
+{
+    impl.refit(mdl);
+}
+
 void DynamicMapTree::balance()
 {
     impl.balance();
@@ -141,6 +171,28 @@ void DynamicMapTree::update(uint32 t_diff)
     impl.update(t_diff);
 }
 
+uint64 DynamicMapTree::GetMaintenanceTime() const
+{
+    return impl.maintenance_time;
+}
+
+uint32 DynamicMapTree::GetRefitCount() const
+{
+    return impl.refit_count;
+}
+
+uint32 DynamicMapTree::GetRebuildCount() const
+{
+    return impl.rebuild_count;
+}
+
+void DynamicMapTree::ResetMaintenanceCounters()
+{
+    impl.maintenance_time = 0;
+    impl.refit_count = 0;
+    impl.rebuild_count = 0;
+}
+
 struct DynamicTreeIntersectionCallback
 {
     bool did_hit;
@@ -131,6 +131,12 @@ class DynamicMapTree
          * @return bool
          */
         bool contains(const GameObjectModel&) const;
+        /**
+         * @brief the position or rotation of a contained model changed
+         *
+         * @param
+         */
+        void refit(const GameObjectModel&);
         /**
          * @brief
          *
@@ -149,6 +155,16 @@ class DynamicMapTree
          * @param diff
          */
         void update(uint32 diff);
+
+        /**
+         * @brief time spent rebuilding and refitting the tree since the last reset
+         *
+         * @return uint64 microseconds
+         */
+        uint64 GetMaintenanceTime() const;
+        uint32 GetRefitCount() const;
+        uint32 GetRebuildCount() const;
+        void ResetMaintenanceCounters();
     private:
         struct DynTreeImpl& impl; /**< TODO */
 };
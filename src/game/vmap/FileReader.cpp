@@ -0,0 +1,194 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "FileReader.h"
+#include "VMapDefinitions.h"
+
+#include <zlib.h>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace VMAP
+{
+    FileReader::FileReader() : iDataPos(0), iBlockPos(0), iPacked(false), iBroken(false)
+    {
+    }
+
+    bool FileReader::Open(const std::string& filename)
+    {
+        iData.clear();
+        iBlock.clear();
+        iDataPos = iBlockPos = 0;
+        iPacked = iBroken = false;
+
+        FILE* rf = fopen(filename.c_str(), "rb");
+        if (!rf)
+        {
+            return false;
+        }
+
+        fseek(rf, 0, SEEK_END);
+        long fileSize = ftell(rf);
+        fseek(rf, 0, SEEK_SET);
+        if (fileSize < 0)
+        {
+            fclose(rf);
+            return false;
+        }
+
+        iData.resize(size_t(fileSize));
+        bool success = fileSize == 0 || fread(&iData[0], 1, iData.size(), rf) == iData.size();
+        fclose(rf);
+        if (!success)
+        {
+            iData.clear();
+            return false;
+        }
+
+        if (iData.size() >= 8 && memcmp(&iData[0], VMAP_PACKED_MAGIC, 8) == 0)
+        {
+            iPacked = true;
+            iDataPos = 8;
+        }
+        else
+        {
+            // legacy file, the buffer is the content
+            iBlock.swap(iData);
+        }
+        return true;
+    }
+
+    bool FileReader::NextBlock()
+    {
+        if (!iPacked || iBroken || iDataPos + 2 * sizeof(uint32) > iData.size())
+        {
+            return false;
+        }
+
+        uint32 rawSize, packedSize;
+        memcpy(&rawSize, &iData[iDataPos], sizeof(uint32));
+        memcpy(&packedSize, &iData[iDataPos + sizeof(uint32)], sizeof(uint32));
+        iDataPos += 2 * sizeof(uint32);
+
+        if (rawSize == 0 || rawSize > VMAP_PACKED_BLOCK_SIZE || packedSize > iData.size() - iDataPos)
+        {
+            ERROR_LOG("FileReader: corrupted packed block header");
+            iBroken = true;
+            return false;
+        }
+
+        iBlock.resize(rawSize);
+        uLongf destLen = rawSize;
+        if (uncompress(&iBlock[0], &destLen, &iData[iDataPos], packedSize) != Z_OK || destLen != rawSize)
+        {
+            ERROR_LOG("FileReader: could not inflate packed block");
+            iBlock.clear();
+            iBroken = true;
+            return false;
+        }
+
+        iDataPos += packedSize;
+        iBlockPos = 0;
+        return true;
+    }
+
+    size_t FileReader::Read(void* dest, size_t size, size_t count)
+    {
+        if (!size || !count)
+        {
+            return 0;
+        }
+
+        uint8* out = static_cast<uint8*>(dest);
+        size_t wanted = size * count;
+        size_t done = 0;
+        while (done < wanted)
+        {
+            if (iBlockPos >= iBlock.size() && !NextBlock())
+            {
+                break;
+            }
+
+            size_t chunk = std::min(wanted - done, iBlock.size() - iBlockPos);
+            memcpy(out + done, &iBlock[iBlockPos], chunk);
+            iBlockPos += chunk;
+            done += chunk;
+        }
+        return done / size;
+    }
+
+    bool FileReader::Eof()
+    {
+        return iBlockPos >= iBlock.size() && (!iPacked || iBroken || iDataPos >= iData.size());
+    }
+
+    bool packFile(const std::string& filename)
+    {
+        FileReader reader;
+        if (!reader.Open(filename))
+        {
+            return false;
+        }
+        if (reader.IsPacked())
+        {
+            return true;
+        }
+
+        FILE* wf = fopen(filename.c_str(), "wb");
+        if (!wf)
+        {
+            return false;
+        }
+
+        bool success = fwrite(VMAP_PACKED_MAGIC, 1, 8, wf) == 8;
+
+        std::vector<uint8> raw(VMAP_PACKED_BLOCK_SIZE);
+        std::vector<uint8> packed(compressBound(VMAP_PACKED_BLOCK_SIZE));
+        while (success)
+        {
+            uint32 rawSize = reader.Read(&raw[0], 1, VMAP_PACKED_BLOCK_SIZE);
+            if (!rawSize)
+            {
+                break;
+            }
+
+            // fastest level, the files are packed once but inflated on every grid load
+            uLongf packedSize = packed.size();
+            if (compress2(&packed[0], &packedSize, &raw[0], rawSize, Z_BEST_SPEED) != Z_OK)
+            {
+                success = false;
+                break;
+            }
+
+            uint32 packedSize32 = uint32(packedSize);
+            success = fwrite(&rawSize, sizeof(uint32), 1, wf) == 1 &&
+                      fwrite(&packedSize32, sizeof(uint32), 1, wf) == 1 &&
+                      fwrite(&packed[0], 1, packedSize, wf) == packedSize;
+        }
+
+        fclose(wf);
+        return success;
+    }
+}
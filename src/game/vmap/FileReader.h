@@ -0,0 +1,99 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_VMAPFILEREADER
+#define MANGOS_H_VMAPFILEREADER
+
+#include "Platform/Define.h"
+
+#include <string>
+#include <vector>
+
+namespace VMAP
+{
+    const char VMAP_PACKED_MAGIC[] = "VMAPPACK";                /**< leads files written with packFile() */
+    const uint32 VMAP_PACKED_BLOCK_SIZE = 64 * 1024;            /**< uncompressed size of one packed block */
+
+    /**
+     * @brief Reads a whole vmap file with one bulk read and serves it with fread semantics
+     *
+     * Packed files are a VMAP_PACKED_MAGIC header followed by blocks of
+     * [uint32 raw size, uint32 packed size, zlib data]. The blocks are only
+     * inflated when the reader reaches them, one block buffer at a time.
+     * Files without the header are served as they are on disk, so the legacy
+     * format keeps loading unchanged.
+     */
+    class FileReader
+    {
+        public:
+            FileReader();
+
+            /**
+             * @brief read the complete file into memory
+             *
+             * @param filename
+             * @return bool false if the file can not be opened or read
+             */
+            bool Open(const std::string& filename);
+
+            /**
+             * @brief same contract as fread(), returns the number of complete items read
+             *
+             * @param dest
+             * @param size
+             * @param count
+             * @return size_t
+             */
+            size_t Read(void* dest, size_t size, size_t count);
+
+            /**
+             * @brief true when every byte of the file has been consumed or a block failed to decode
+             *
+             * @return bool
+             */
+            bool Eof();
+
+            bool IsPacked() const { return iPacked; }
+
+        private:
+            bool NextBlock();
+
+            std::vector<uint8> iData;           /**< file content as read from disk */
+            size_t iDataPos;
+            std::vector<uint8> iBlock;          /**< decoded block, the whole file for legacy files */
+            size_t iBlockPos;
+            bool iPacked;
+            bool iBroken;                       /**< a packed block failed to inflate */
+    };
+
+    /**
+     * @brief rewrite an existing file in the packed format, used by the TileAssembler
+     *
+     * @param filename
+     * @return bool
+     */
+    bool packFile(const std::string& filename);
+}
+
+#endif // MANGOS_H_VMAPFILEREADER
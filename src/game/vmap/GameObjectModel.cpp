@@ -159,6 +159,12 @@ void GameObjectModel::UpdateRotation(G3D::Quat const& q)
     iBound = rotated_bounds + iPos;
 }
 
+void GameObjectModel::UpdatePosition(G3D::Vector3 const& pos)
+{
+    iBound = iBound + (pos - iPos);
+    iPos = pos;
+}
+
 GameObjectModel* GameObjectModel::Create(const GameObject* const pGo)
 {
     const GameObjectDisplayInfoEntry* info = sGameObjectDisplayInfoStore.LookupEntry(pGo->GetDisplayId());
@@ -73,6 +73,7 @@ class GameObjectModel
 
         const G3D::Vector3& GetPosition() const { return iPos;}
         void UpdateRotation(G3D::Quat const& q);
+        void UpdatePosition(G3D::Vector3 const& pos);
         const GameObject* GetOwner() const { return iOwner; }
 
         void SetCollidable(bool enabled) { isCollidable = enabled; }
@@ -84,6 +84,21 @@ namespace VMAP
              * @return VMAPLoadResult
              */
             virtual VMAPLoadResult loadMap(const char* pBasePath, unsigned int pMapId, int x, int y) = 0;
+            /**
+             * @brief read the models of a map tile ahead of loadMap, may be called from any thread
+             *
+             * @param pBasePath
+             * @param pMapId
+             * @param x
+             * @param y
+             */
+            virtual void prefetchMap(const char* pBasePath, unsigned int pMapId, int x, int y) = 0;
+            /**
+             * @brief free prefetched models no loadMap used within maxAge milliseconds
+             *
+             * @param maxAge
+             */
+            virtual void dropPrefetchedModels(uint32 maxAge) = 0;
 
             /**
              * @brief
@@ -124,6 +139,16 @@ namespace VMAP
              * @return bool
              */
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+            /**
+             * @brief isInLineOfSight for count segments at once
+             *
+             * @param pMapId
+             * @param from x, y, z of every segment start (3 * count floats)
+             * @param to x, y, z of every segment end (3 * count floats)
+             * @param results set to the isInLineOfSight result of every segment
+             * @param count
+             */
+            virtual void isInLineOfSight(unsigned int pMapId, const float* from, const float* to, bool* results, uint32 count) = 0;
             /**
              * @brief
              *
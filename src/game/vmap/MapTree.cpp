@@ -26,6 +26,7 @@
 #include "ModelInstance.h"
 #include "VMapManager2.h"
 #include "VMapDefinitions.h"
+#include "FileReader.h"
 
 #include <string>
 #include <sstream>
@@ -191,6 +192,74 @@ namespace VMAP
         return true;
     }
     //=========================================================
+
+    void StaticMapTree::isInLineOfSight(const Vector3* pos1, const Vector3* pos2, bool* results, uint32 count) const
+    {
+        // rays sorted into the 8 direction octants, a packet needs one front/back order per axis
+        std::vector<uint32> octants[8];
+        std::vector<G3D::Ray> rays(count);
+        std::vector<float> distances(count);
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            results[i] = true;
+
+            // same special cases as the single segment check
+            if (pos1[i] == pos2[i])
+            {
+                continue;
+            }
+
+            float maxDist = (pos2[i] - pos1[i]).magnitude();
+            if (maxDist == std::numeric_limits<float>::max() ||
+                    maxDist == std::numeric_limits<float>::infinity())
+            {
+                results[i] = false;
+                continue;
+            }
+
+            MANGOS_ASSERT(maxDist < std::numeric_limits<float>::max());
+            if (maxDist < 1e-10f)
+            {
+                continue;
+            }
+
+            rays[i] = G3D::Ray::fromOriginAndDirection(pos1[i], (pos2[i] - pos1[i]) / maxDist);
+            distances[i] = maxDist;
+
+            Vector3 const& dir = rays[i].direction();
+            uint32 octant = (floatToRawIntBits(dir.x) >> 31) | ((floatToRawIntBits(dir.y) >> 31) << 1) | ((floatToRawIntBits(dir.z) >> 31) << 2);
+            octants[octant].push_back(i);
+        }
+
+        MapRayCallback intersectionCallBack(iTreeValues);
+
+        G3D::Ray packet[BIH_PACKET_SIZE];
+        float packetDist[BIH_PACKET_SIZE];
+        bool packetHit[BIH_PACKET_SIZE];
+
+        for (uint32 octant = 0; octant < 8; ++octant)
+        {
+            std::vector<uint32> const& indexes = octants[octant];
+            for (uint32 begin = 0; begin < indexes.size(); begin += BIH_PACKET_SIZE)
+            {
+                uint32 size = std::min<uint32>(BIH_PACKET_SIZE, indexes.size() - begin);
+                for (uint32 k = 0; k < size; ++k)
+                {
+                    packet[k] = rays[indexes[begin + k]];
+                    packetDist[k] = distances[indexes[begin + k]];
+                }
+
+                iTree.intersectRayPacket(packet, size, intersectionCallBack, packetDist, packetHit);
+
+                for (uint32 k = 0; k < size; ++k)
+                {
+                    results[indexes[begin + k]] = !packetHit[k];
+                }
+            }
+        }
+    }
+    //=========================================================
     /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
     Return the hit pos or the original dest pos
@@ -263,24 +332,23 @@ namespace VMAP
         }
         std::string fullname = basePath + VMapManager2::getMapFileName(mapID);
         bool success = true;
-        FILE* rf = fopen(fullname.c_str(), "rb");
-        if (!rf)
+        FileReader rf;
+        if (!rf.Open(fullname))
         {
             return false;
         }
         // TODO: check magic number when implemented...
         char tiled;
         char chunk[8];
-        if (!readChunk(rf, chunk, VMAP_MAGIC, 8) || fread(&tiled, sizeof(char), 1, rf) != 1)
+        if (!readChunk(rf, chunk, VMAP_MAGIC, 8) || rf.Read(&tiled, sizeof(char), 1) != 1)
         {
-            fclose(rf);
             return false;
         }
         if (tiled)
         {
             std::string tilefile = basePath + getTileFileName(mapID, tileX, tileY);
-            FILE* tf = fopen(tilefile.c_str(), "rb");
-            if (!tf)
+            FileReader tf;
+            if (!tf.Open(tilefile))
             {
                 success = false;
             }
@@ -290,10 +358,51 @@ namespace VMAP
                 {
                     success = false;
                 }
-                fclose(tf);
             }
         }
-        fclose(rf);
+        return success;
+    }
+
+    //=========================================================
+
+    bool StaticMapTree::ReadTileModels(const std::string& vmapPath, uint32 mapID, uint32 tileX, uint32 tileY, std::vector<std::pair<std::string, uint32> >& models)
+    {
+        std::string basePath = vmapPath;
+        if (basePath.length() > 0 && (basePath[basePath.length() - 1] != '/' || basePath[basePath.length() - 1] != '\\'))
+        {
+            basePath.append("/");
+        }
+
+        FileReader rf;
+        if (!rf.Open(basePath + VMapManager2::getMapFileName(mapID)))
+        {
+            return false;
+        }
+        char tiled;
+        char chunk[8];
+        bool success = readChunk(rf, chunk, VMAP_MAGIC, 8) && rf.Read(&tiled, sizeof(char), 1) == 1 && tiled;
+        if (!success)
+        {
+            return false;
+        }
+
+        FileReader tf;
+        if (!tf.Open(basePath + getTileFileName(mapID, tileX, tileY)))
+        {
+            return false;
+        }
+        uint32 numSpawns = 0;
+        success = readChunk(tf, chunk, VMAP_MAGIC, 8) && tf.Read(&numSpawns, sizeof(uint32), 1) == 1;
+        for (uint32 i = 0; i < numSpawns && success; ++i)
+        {
+            ModelSpawn spawn;
+            uint32 referencedVal;
+            success = ModelSpawn::ReadFromFile(tf, spawn) && tf.Read(&referencedVal, sizeof(uint32), 1) == 1;
+            if (success)
+            {
+                models.push_back(std::make_pair(spawn.name, spawn.flags));
+            }
+        }
         return success;
     }
 
@@ -304,8 +413,8 @@ namespace VMAP
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Initializing StaticMapTree '%s'", fname.c_str());
         bool success = true;
         std::string fullname = iBasePath + fname;
-        FILE* rf = fopen(fullname.c_str(), "rb");
-        if (!rf)
+        FileReader rf;
+        if (!rf.Open(fullname))
         {
             return false;
         }
@@ -318,7 +427,7 @@ namespace VMAP
                 success = false;
             }
             char tiled=0;
-            if (success && fread(&tiled, sizeof(char), 1, rf) != 1)
+            if (success && rf.Read(&tiled, sizeof(char), 1) != 1)
             {
                 success = false;
             }
@@ -364,8 +473,6 @@ namespace VMAP
                     ERROR_LOG("StaticMapTree::InitMap() could not acquire WorldModel pointer for '%s'!", spawn.name.c_str());
                 }
             }
-
-            fclose(rf);
         }
         return success;
     }
@@ -405,8 +512,8 @@ namespace VMAP
         bool result = true;
 
         std::string tilefile = iBasePath + getTileFileName(iMapID, tileX, tileY);
-        FILE* tf = fopen(tilefile.c_str(), "rb");
-        if (tf)
+        FileReader tf;
+        if (tf.Open(tilefile))
         {
             char chunk[8];
             if (!readChunk(tf, chunk, VMAP_MAGIC, 8))
@@ -414,7 +521,7 @@ namespace VMAP
                 result = false;
             }
             uint32 numSpawns = 0;
-            if (result && fread(&numSpawns, sizeof(uint32), 1, tf) != 1)
+            if (result && tf.Read(&numSpawns, sizeof(uint32), 1) != 1)
             {
                 result = false;
             }
@@ -435,7 +542,7 @@ namespace VMAP
                     // update tree
                     uint32 referencedVal;
 
-                    size_t fileRead = fread(&referencedVal, sizeof(uint32), 1, tf);
+                    size_t fileRead = tf.Read(&referencedVal, sizeof(uint32), 1);
                     if (!iLoadedSpawns.count(referencedVal) || fileRead <= 0)
                     {
                         if (referencedVal > iNTreeValues)
@@ -463,7 +570,6 @@ namespace VMAP
                 }
             }
             iLoadedTiles[packTileID(tileX, tileY)] = true;
-            fclose(tf);
         }
         else
         {
@@ -486,8 +592,8 @@ namespace VMAP
         if (tile->second) // file associated with tile
         {
             std::string tilefile = iBasePath + getTileFileName(iMapID, tileX, tileY);
-            FILE* tf = fopen(tilefile.c_str(), "rb");
-            if (tf)
+            FileReader tf;
+            if (tf.Open(tilefile))
             {
                 bool result = true;
                 char chunk[8];
@@ -496,7 +602,7 @@ namespace VMAP
                     result = false;
                 }
                 uint32 numSpawns;
-                if (fread(&numSpawns, sizeof(uint32), 1, tf) != 1)
+                if (tf.Read(&numSpawns, sizeof(uint32), 1) != 1)
                 {
                     result = false;
                 }
@@ -513,7 +619,7 @@ namespace VMAP
                         // update tree
                         uint32 referencedNode;
 
-                        size_t fileRead = fread(&referencedNode, sizeof(uint32), 1, tf);
+                        size_t fileRead = tf.Read(&referencedNode, sizeof(uint32), 1);
                         if (!iLoadedSpawns.count(referencedNode) || fileRead <= 0)
                         {
                             ERROR_LOG("Trying to unload non-referenced model '%s' (ID:%u)", spawn.name.c_str(), spawn.ID);
@@ -525,7 +631,6 @@ namespace VMAP
                         }
                     }
                 }
-                fclose(tf);
             }
         }
         iLoadedTiles.erase(tile);
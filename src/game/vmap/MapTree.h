@@ -129,6 +129,17 @@ namespace VMAP
              * @return bool
              */
             static bool CanLoadMap(const std::string& basePath, uint32 mapID, uint32 tileX, uint32 tileY);
+            /**
+             * @brief names and flags of the models spawned by a map tile, reads only the tile file
+             *
+             * @param basePath
+             * @param mapID
+             * @param tileX
+             * @param tileY
+             * @param models
+             * @return bool false if the map is not tiled or the tile can't be read
+             */
+            static bool ReadTileModels(const std::string& basePath, uint32 mapID, uint32 tileX, uint32 tileY, std::vector<std::pair<std::string, uint32> >& models);
 
             /**
              * @brief
@@ -151,6 +162,15 @@ namespace VMAP
              * @return bool
              */
             bool isInLineOfSight(const G3D::Vector3& pos1, const G3D::Vector3& pos2) const;
+            /**
+             * @brief isInLineOfSight of count segments, rays with the same direction signs are traversed as packets
+             *
+             * @param pos1 segment starts
+             * @param pos2 segment ends
+             * @param results
+             * @param count
+             */
+            void isInLineOfSight(const G3D::Vector3* pos1, const G3D::Vector3* pos2, bool* results, uint32 count) const;
             /**
              * @brief
              *
@@ -26,6 +26,7 @@
 #include "WorldModel.h"
 #include "MapTree.h"
 #include "VMapDefinitions.h"
+#include "FileReader.h"
 
 using G3D::Vector3;
 using G3D::Ray;
@@ -162,33 +163,29 @@ namespace VMAP
         return false;
     }
 
-    bool ModelSpawn::ReadFromFile(FILE* rf, ModelSpawn& spawn)
+    bool ModelSpawn::ReadFromFile(FileReader& rf, ModelSpawn& spawn)
     {
         uint32 check = 0, nameLen;
-        check += fread(&spawn.flags, sizeof(uint32), 1, rf);
+        check += rf.Read(&spawn.flags, sizeof(uint32), 1);
         // EoF?
         if (!check)
         {
-            if (ferror(rf))
-            {
-                ERROR_LOG("Error reading ModelSpawn!");
-            }
             return false;
         }
-        check += fread(&spawn.adtId, sizeof(uint16), 1, rf);
-        check += fread(&spawn.ID, sizeof(uint32), 1, rf);
-        check += fread(&spawn.iPos, sizeof(float), 3, rf);
-        check += fread(&spawn.iRot, sizeof(float), 3, rf);
-        check += fread(&spawn.iScale, sizeof(float), 1, rf);
+        check += rf.Read(&spawn.adtId, sizeof(uint16), 1);
+        check += rf.Read(&spawn.ID, sizeof(uint32), 1);
+        check += rf.Read(&spawn.iPos, sizeof(float), 3);
+        check += rf.Read(&spawn.iRot, sizeof(float), 3);
+        check += rf.Read(&spawn.iScale, sizeof(float), 1);
         bool has_bound = (spawn.flags & MOD_HAS_BOUND);
         if (has_bound) // only WMOs have bound in MPQ, only available after computation
         {
             Vector3 bLow, bHigh;
-            check += fread(&bLow, sizeof(float), 3, rf);
-            check += fread(&bHigh, sizeof(float), 3, rf);
+            check += rf.Read(&bLow, sizeof(float), 3);
+            check += rf.Read(&bHigh, sizeof(float), 3);
             spawn.iBound = G3D::AABox(bLow, bHigh);
         }
-        check += fread(&nameLen, sizeof(uint32), 1, rf);
+        check += rf.Read(&nameLen, sizeof(uint32), 1);
         if (check != uint32(has_bound ? 17 : 11))
         {
             ERROR_LOG("Error reading ModelSpawn!");
@@ -200,7 +197,7 @@ namespace VMAP
             ERROR_LOG("Error reading ModelSpawn, file name too long!");
             return false;
         }
-        check = fread(nameBuff, sizeof(char), nameLen, rf);
+        check = rf.Read(nameBuff, sizeof(char), nameLen);
         if (check != nameLen)
         {
             ERROR_LOG("Error reading name string of ModelSpawn!");
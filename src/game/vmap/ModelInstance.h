@@ -35,6 +35,7 @@
 
 namespace VMAP
 {
+    class FileReader;
     class WorldModel;
     struct AreaInfo;
     struct LocationInfo;
@@ -90,7 +91,7 @@ namespace VMAP
              * @param spawn
              * @return bool
              */
-            static bool ReadFromFile(FILE* rf, ModelSpawn& spawn);
+            static bool ReadFromFile(FileReader& rf, ModelSpawn& spawn);
             /**
              * @brief
              *
@@ -137,6 +137,29 @@ class RegularGrid2D
             memberTable.remove(&value);
         }
 
+        /**
+         * @brief the bounds of a contained value changed, moves it to its new cell if needed
+         *
+         * @param value
+         * @param maxCostGrowth passed to the node's refit()
+         * @return bool true if the value changed cell or its node has to be rebuilt
+         */
+        bool refit(const T& value, float maxCostGrowth)
+        {
+            Vector3 pos;
+            PositionFunc::getPosition(value, pos);
+            Node& node = getGridFor(pos.x, pos.y);
+            Node* current = memberTable[&value];
+            if (current != &node)
+            {
+                current->remove(value);
+                node.insert(value);
+                memberTable.set(&value, &node);
+                return true;
+            }
+            return node.refit(value, maxCostGrowth);
+        }
+
         /**
          * @brief
          *
@@ -25,11 +25,15 @@
 #include <set>
 #include <iomanip>
 #include <sstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
 
 #include "TileAssembler.h"
 #include "MapTree.h"
 #include "BIH.h"
 #include "VMapDefinitions.h"
+#include "FileReader.h"
 
 
 using G3D::Vector3;
@@ -53,6 +57,15 @@ namespace VMAP
         return memcmp(dest, compare, len) == 0;
     }
 
+    bool readChunk(FileReader& rf, char* dest, const char* compare, uint32 len)
+    {
+        if (rf.Read(dest, sizeof(char), len) != len)
+        {
+            return false;
+        }
+        return memcmp(dest, compare, len) == 0;
+    }
+
     Vector3 ModelPosition::transform(const Vector3& pIn) const
     {
         Vector3 out = pIn * iScale;
@@ -66,6 +79,10 @@ namespace VMAP
     {
         iCurrentUniqueNameId = 0;
         iFilterMethod = NULL;
+        iPackFiles = false;
+        iThreads = 1;
+        iMapTreeSeconds = 0.0;
+        iModelSeconds = 0.0;
         iSrcDir = pSrcDirName;
         iDestDir = pDestDirName;
         // mkdir(iDestDir);
@@ -85,6 +102,8 @@ namespace VMAP
             return false;
         }
 
+        std::chrono::steady_clock::time_point stageStart = std::chrono::steady_clock::now();
+
         // export Map data
         for (MapData::iterator map_iter = mapData.begin(); map_iter != mapData.end() && success; ++map_iter)
         {
@@ -167,6 +186,10 @@ namespace VMAP
             }
 
             fclose(mapfile);
+            if (success && iPackFiles)
+            {
+                success = packFile(mapfilename.str());
+            }
 
             // <====
 
@@ -215,24 +238,26 @@ namespace VMAP
                     }
                 }
                 fclose(tilefile);
+                if (success && iPackFiles)
+                {
+                    success = packFile(tilefilename.str());
+                }
             }
             // break; // test, extract only first map; TODO: remvoe this line
         }
+        iM2Vertices.clear();
+        iMapTreeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - stageStart).count();
 
         // add an object models, listed in temp_gameobject_models file
         exportGameobjectModels(RAW_VMAP_MAGIC);
 
         // export objects
         std::cout << "\nConverting Model Files" << std::endl;
-        for (std::set<std::string>::iterator mfile = spawnedModelFiles.begin(); mfile != spawnedModelFiles.end(); ++mfile)
+        if (success)
         {
-            std::cout << "Converting " << *mfile << std::endl;
-            if (!convertRawFile(*mfile, RAW_VMAP_MAGIC))
-            {
-                std::cout << "error converting " << *mfile << std::endl;
-                success = false;
-                break;
-            }
+            stageStart = std::chrono::steady_clock::now();
+            success = convertModelFiles(RAW_VMAP_MAGIC);
+            iModelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - stageStart).count();
         }
 
         // cleanup:
@@ -243,11 +268,47 @@ namespace VMAP
         return success;
     }
 
+    bool TileAssembler::convertModelFiles(const char *RAW_VMAP_MAGIC)
+    {
+        std::vector<std::string> files(spawnedModelFiles.begin(), spawnedModelFiles.end());
+        std::atomic<uint32> next(0);
+        std::atomic<bool> failed(false);
+
+        auto worker = [&]()
+        {
+            for (uint32 i = next++; i < files.size() && !failed; i = next++)
+            {
+                printf("Converting %s\n", files[i].c_str());
+                if (!convertRawFile(files[i], RAW_VMAP_MAGIC))
+                {
+                    printf("error converting %s\n", files[i].c_str());
+                    failed = true;
+                }
+            }
+        };
+
+        // the calling thread converts too
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < iThreads && i < files.size(); ++i)
+        {
+            threads.push_back(std::thread(worker));
+        }
+
+        worker();
+
+        for (uint32 i = 0; i < threads.size(); ++i)
+        {
+            threads[i].join();
+        }
+
+        return !failed;
+    }
+
     bool TileAssembler::readMapSpawns()
     {
         std::string fname = iSrcDir + "/dir_bin";
-        FILE* dirf = fopen(fname.c_str(), "rb");
-        if (!dirf)
+        FileReader dirf;
+        if (!dirf.Open(fname))
         {
             printf("Could not read dir_bin file!\n");
             return false;
@@ -256,16 +317,16 @@ namespace VMAP
         uint32 mapID, tileX, tileY;
         G3D::Vector3 v1, v2;
         ModelSpawn spawn;
-        while (!feof(dirf))
+        while (!dirf.Eof())
         {
             // read mapID, tileX, tileY, Flags, adtID, ID, Pos, Rot, Scale, Bound_lo, Bound_hi, name
-            uint32 check = fread(&mapID, sizeof(uint32), 1, dirf);
+            uint32 check = dirf.Read(&mapID, sizeof(uint32), 1);
             if (check == 0) // EoF...
             {
                 break;
             }
-            check += fread(&tileX, sizeof(uint32), 1, dirf);
-            check += fread(&tileY, sizeof(uint32), 1, dirf);
+            check += dirf.Read(&tileX, sizeof(uint32), 1);
+            check += dirf.Read(&tileY, sizeof(uint32), 1);
             if (!ModelSpawn::ReadFromFile(dirf, spawn))
             {
                 break;
@@ -285,55 +346,62 @@ namespace VMAP
             current->UniqueEntries.insert(pair<uint32, ModelSpawn>(spawn.ID, spawn));
             current->TileEntries.insert(pair<uint32, uint32>(StaticMapTree::packTileID(tileX, tileY), spawn.ID));
         }
-        bool success = (ferror(dirf) == 0);
-        fclose(dirf);
-        return success;
+        return true;
     }
 
     bool TileAssembler::calculateTransformedBound(ModelSpawn& spawn, const char *RAW_VMAP_MAGIC)
     {
-        std::string modelFilename = iSrcDir + "/" + spawn.name;
         ModelPosition modelPosition;
         modelPosition.iDir = spawn.iRot;
         modelPosition.iScale = spawn.iScale;
         modelPosition.init();
 
-        WorldModel_Raw raw_model;
-        if (!raw_model.Read(modelFilename.c_str(), RAW_VMAP_MAGIC))
+        // the same M2 is spawned many times, read its vertices only once
+        std::map<std::string, std::vector<Vector3> >::iterator cached = iM2Vertices.find(spawn.name);
+        if (cached == iM2Vertices.end())
         {
-            return false;
-        }
+            std::string modelFilename = iSrcDir + "/" + spawn.name;
+            WorldModel_Raw raw_model;
+            if (!raw_model.Read(modelFilename.c_str(), RAW_VMAP_MAGIC))
+            {
+                return false;
+            }
 
-        uint32 groups = raw_model.groupsArray.size();
-        if (groups != 1)
-        {
-            printf("Warning: '%s' does not seem to be a M2 model!\n", modelFilename.c_str());
+            uint32 groups = raw_model.groupsArray.size();
+            if (groups != 1)
+            {
+                printf("Warning: '%s' does not seem to be a M2 model!\n", modelFilename.c_str());
+            }
+
+            cached = iM2Vertices.insert(std::make_pair(spawn.name, std::vector<Vector3>())).first;
+            for (uint32 g = 0; g < groups; ++g) // should be only one for M2 files...
+            {
+                std::vector<Vector3>& vertices = raw_model.groupsArray[g].vertexArray;
+
+                if (vertices.empty())
+                {
+                    std::cout << "error: model '" << spawn.name << "' has no geometry!" << std::endl;
+                    continue;
+                }
+
+                cached->second.insert(cached->second.end(), vertices.begin(), vertices.end());
+            }
         }
 
         AABox modelBound;
         bool boundEmpty = true;
-        for (uint32 g = 0; g < groups; ++g) // should be only one for M2 files...
+        std::vector<Vector3>& vertices = cached->second;
+        uint32 nvectors = vertices.size();
+        for (uint32 i = 0; i < nvectors; ++i)
         {
-            std::vector<Vector3>& vertices = raw_model.groupsArray[g].vertexArray;
-
-            if (vertices.empty())
+            Vector3 v = modelPosition.transform(vertices[i]);
+            if (boundEmpty)
             {
-                std::cout << "error: model '" << spawn.name << "' has no geometry!" << std::endl;
-                continue;
+                modelBound = AABox(v, v), boundEmpty = false;
             }
-
-            uint32 nvectors = vertices.size();
-            for (uint32 i = 0; i < nvectors; ++i)
+            else
             {
-                Vector3 v = modelPosition.transform(vertices[i]);
-                if (boundEmpty)
-                {
-                    modelBound = AABox(v, v), boundEmpty = false;
-                }
-                else
-                {
-                    modelBound.merge(v);
-                }
+                modelBound.merge(v);
             }
         }
         spawn.iBound = modelBound + spawn.iPos;
@@ -384,7 +452,12 @@ namespace VMAP
             model.SetGroupModels(groupsArray);
         }
 
-        return model.WriteFile(iDestDir + "/" + pModelFilename + ".vmo");
+        std::string modelFilename = iDestDir + "/" + pModelFilename + ".vmo";
+        if (!model.WriteFile(modelFilename))
+        {
+            return false;
+        }
+        return !iPackFiles || packFile(modelFilename);
     }
 
     void TileAssembler::exportGameobjectModels(const char *RAW_VMAP_MAGIC)
@@ -172,6 +172,18 @@ namespace VMAP
             unsigned int iCurrentUniqueNameId; /**< TODO */
             MapData mapData; /**< TODO */
             std::set<std::string> spawnedModelFiles; /**< TODO */
+            bool iPackFiles; /**< write the final files in the packed (compressed) format */
+            unsigned int iThreads; /**< threads converting the model files */
+            std::map<std::string, std::vector<G3D::Vector3> > iM2Vertices; /**< vertices of M2 models already read for bounds */
+            double iMapTreeSeconds; /**< time spent on model bounds, BIH build and tile files */
+            double iModelSeconds; /**< time spent converting the model files */
+
+            /**
+             * @brief converts spawnedModelFiles on iThreads threads
+             *
+             * @return bool
+             */
+            bool convertModelFiles(const char *RAW_VMAP_MAGIC);
 
         public:
             /**
@@ -187,6 +199,26 @@ namespace VMAP
              */
             virtual ~TileAssembler();
 
+            /**
+             * @brief write .vmtree, .vmtile and .vmo files packed, see FileReader
+             *
+             * @param pack
+             */
+            void setPackFiles(bool pack) { iPackFiles = pack; }
+
+            /**
+             * @brief number of threads converting model files, each model is its own file so the result does not depend on it
+             *
+             * @param threads
+             */
+            void setThreads(unsigned int threads) { iThreads = threads ? threads : 1; }
+
+            /**
+             * @brief wall time of the map tree and model stages of the last convertWorld2()
+             */
+            double getMapTreeSeconds() const { return iMapTreeSeconds; }
+            double getModelSeconds() const { return iModelSeconds; }
+
             /**
              * @brief
              *
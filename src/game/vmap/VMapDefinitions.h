@@ -42,6 +42,19 @@ namespace VMAP
      * @return bool
      */
     bool readChunk(FILE* rf, char* dest, const char* compare, uint32 len);
+
+    class FileReader;
+
+    /**
+     * @brief same as above for files opened through a FileReader
+     *
+     * @param rf
+     * @param dest
+     * @param compare
+     * @param len
+     * @return bool
+     */
+    bool readChunk(FileReader& rf, char* dest, const char* compare, uint32 len);
 }
 
 #ifndef NO_CORE_FUNCS
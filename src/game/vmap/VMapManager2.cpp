@@ -30,6 +30,9 @@
 #include "ModelInstance.h"
 #include "WorldModel.h"
 #include "VMapDefinitions.h"
+#include "Timer.h"
+
+#include <ace/Guard_T.h>
 
 using G3D::Vector3;
 
@@ -53,6 +56,10 @@ namespace VMAP
         {
             delete i->second.getModel();
         }
+        for (PrefetchedModelMap::iterator i = iPrefetchedModels.begin(); i != iPrefetchedModels.end(); ++i)
+        {
+            delete i->second.first;
+        }
     }
 
     //=========================================================
@@ -96,6 +103,82 @@ namespace VMAP
         return result;
     }
 
+    //=========================================================
+
+    void VMapManager2::prefetchMap(const char* pBasePath, unsigned int pMapId, int x, int y)
+    {
+        if (!isMapLoadingEnabled())
+        {
+            return;
+        }
+
+        std::vector<std::pair<std::string, uint32> > models;
+        if (!StaticMapTree::ReadTileModels(pBasePath, pMapId, x, y, models))
+        {
+            return;
+        }
+
+        std::string basePath = pBasePath;
+        if (basePath.length() > 0 && (basePath[basePath.length() - 1] != '/' || basePath[basePath.length() - 1] != '\\'))
+        {
+            basePath.append("/");
+        }
+
+        for (std::vector<std::pair<std::string, uint32> >::const_iterator itr = models.begin(); itr != models.end(); ++itr)
+        {
+            {
+                ACE_GUARD(ACE_Thread_Mutex, guard, iPrefetchLock);
+                if (iLoadedModelFiles.find(itr->first) != iLoadedModelFiles.end() || iPrefetchedModels.find(itr->first) != iPrefetchedModels.end())
+                {
+                    continue;
+                }
+            }
+
+            // the file is read without the lock, a model read twice by two prefetches is dropped below
+            WorldModel* worldmodel = new WorldModel();
+            if (!worldmodel->ReadFile(basePath + itr->first + ".vmo"))
+            {
+                delete worldmodel;
+                continue;
+            }
+            worldmodel->Flags = itr->second;
+
+            ACE_GUARD(ACE_Thread_Mutex, guard, iPrefetchLock);
+            if (iLoadedModelFiles.find(itr->first) != iLoadedModelFiles.end() ||
+                !iPrefetchedModels.insert(PrefetchedModelMap::value_type(itr->first, std::make_pair(worldmodel, getMSTime()))).second)
+            {
+                delete worldmodel;
+            }
+        }
+    }
+
+    void VMapManager2::getModelCounts(uint32& loaded, uint32& prefetched)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, iPrefetchLock);
+
+        loaded = uint32(iLoadedModelFiles.size());
+        prefetched = uint32(iPrefetchedModels.size());
+    }
+
+    void VMapManager2::dropPrefetchedModels(uint32 maxAge)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, iPrefetchLock);
+
+        uint32 now = getMSTime();
+        for (PrefetchedModelMap::iterator itr = iPrefetchedModels.begin(); itr != iPrefetchedModels.end();)
+        {
+            if (getMSTimeDiff(itr->second.second, now) > maxAge)
+            {
+                delete itr->second.first;
+                iPrefetchedModels.erase(itr++);
+            }
+            else
+            {
+                ++itr;
+            }
+        }
+    }
+
     //=========================================================
     // load one tile (internal use only)
 
@@ -169,6 +252,32 @@ namespace VMAP
         }
         return result;
     }
+
+    void VMapManager2::isInLineOfSight(unsigned int pMapId, const float* from, const float* to, bool* results, uint32 count)
+    {
+        std::fill(results, results + count, true);
+
+        if (!isLineOfSightCalcEnabled() || IsVMAPDisabledForPtr(pMapId, VMAP_DISABLE_LOS))
+        {
+            return;
+        }
+
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+        {
+            return;
+        }
+
+        std::vector<Vector3> pos1(count);
+        std::vector<Vector3> pos2(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            pos1[i] = convertPositionToInternalRep(from[i * 3], from[i * 3 + 1], from[i * 3 + 2]);
+            pos2[i] = convertPositionToInternalRep(to[i * 3], to[i * 3 + 1], to[i * 3 + 2]);
+        }
+
+        instanceTree->second->isInLineOfSight(&pos1[0], &pos2[0], results, count);
+    }
     //=========================================================
     /**
     get the hit position and return true if we hit something
@@ -275,14 +384,26 @@ namespace VMAP
         ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
         if (model == iLoadedModelFiles.end())
         {
-            WorldModel* worldmodel = new WorldModel();
-            if (!worldmodel->ReadFile(basepath + filename + ".vmo"))
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, iPrefetchLock, NULL);
+
+            WorldModel* worldmodel = NULL;
+            PrefetchedModelMap::iterator prefetched = iPrefetchedModels.find(filename);
+            if (prefetched != iPrefetchedModels.end())
             {
-                ERROR_LOG("VMapManager2: could not load '%s%s.vmo'!", basepath.c_str(), filename.c_str());
-                delete worldmodel;
-                return NULL;
+                worldmodel = prefetched->second.first;
+                iPrefetchedModels.erase(prefetched);
+            }
+            else
+            {
+                worldmodel = new WorldModel();
+                if (!worldmodel->ReadFile(basepath + filename + ".vmo"))
+                {
+                    ERROR_LOG("VMapManager2: could not load '%s%s.vmo'!", basepath.c_str(), filename.c_str());
+                    delete worldmodel;
+                    return NULL;
+                }
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "VMapManager2: loading file '%s%s'.", basepath.c_str(), filename.c_str());
             }
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "VMapManager2: loading file '%s%s'.", basepath.c_str(), filename.c_str());
             worldmodel->Flags = flags;
             model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel())).first;
             model->second.setModel(worldmodel);
@@ -302,6 +423,7 @@ namespace VMAP
         if (model->second.decRefCount() == 0)
         {
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "VMapManager2: unloading file '%s'", filename.c_str());
+            ACE_GUARD(ACE_Thread_Mutex, guard, iPrefetchLock);
             delete model->second.getModel();
             iLoadedModelFiles.erase(model);
         }
@@ -29,6 +29,7 @@
 #include "Utilities/UnorderedMapSet.h"
 #include "Platform/Define.h"
 #include <G3D/Vector3.h>
+#include <ace/Thread_Mutex.h>
 
 //===========================================================
 
@@ -101,6 +102,11 @@ namespace VMAP
      *
      */
     typedef UNORDERED_MAP<std::string, ManagedModel> ModelFileMap;
+    /**
+     * @brief models read by prefetchMap and the time they were read, not yet used by a loaded tile
+     *
+     */
+    typedef UNORDERED_MAP<std::string, std::pair<WorldModel*, uint32> > PrefetchedModelMap;
 
     enum DisableTypes
     {
@@ -120,6 +126,9 @@ namespace VMAP
             // Tree to check collision
             ModelFileMap iLoadedModelFiles; /**< TODO */
             InstanceTreeMap iInstanceMapTrees; /**< TODO */
+            // guards iPrefetchedModels and adding/removing entries of iLoadedModelFiles, lookups of loaded models are not locked
+            ACE_Thread_Mutex iPrefetchLock;
+            PrefetchedModelMap iPrefetchedModels;
 
             /**
              * @brief
@@ -173,6 +182,28 @@ namespace VMAP
              * @return VMAPLoadResult
              */
             VMAPLoadResult loadMap(const char* pBasePath, unsigned int pMapId, int x, int y) override;
+            /**
+             * @brief
+             *
+             * @param pBasePath
+             * @param pMapId
+             * @param x
+             * @param y
+             */
+            void prefetchMap(const char* pBasePath, unsigned int pMapId, int x, int y) override;
+            /**
+             * @brief
+             *
+             * @param maxAge
+             */
+            void dropPrefetchedModels(uint32 maxAge) override;
+            /**
+             * @brief models loaded for tiles and prefetched models not yet used by a tile
+             *
+             * @param loaded
+             * @param prefetched
+             */
+            void getModelCounts(uint32& loaded, uint32& prefetched);
 
             /**
              * @brief
@@ -202,6 +233,16 @@ namespace VMAP
              * @return bool
              */
             bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) override;
+            /**
+             * @brief
+             *
+             * @param pMapId
+             * @param from
+             * @param to
+             * @param results
+             * @param count
+             */
+            void isInLineOfSight(unsigned int pMapId, const float* from, const float* to, bool* results, uint32 count) override;
             /**
             fill the hit pos and return true, if an object was hit
             */
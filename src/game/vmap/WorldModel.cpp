@@ -25,6 +25,7 @@
 #include "WorldModel.h"
 #include "VMapDefinitions.h"
 #include "MapTree.h"
+#include "FileReader.h"
 #include <string.h>
 
 using G3D::Vector3;
@@ -263,35 +264,35 @@ namespace VMAP
         return result;
     }
 
-    bool WmoLiquid::ReadFromFile(FILE* rf, WmoLiquid*& out)
+    bool WmoLiquid::ReadFromFile(FileReader& rf, WmoLiquid*& out)
     {
         bool result = true;
         WmoLiquid* liquid = new WmoLiquid();
-        if (result && fread(&liquid->iTilesX, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&liquid->iTilesX, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
-        if (result && fread(&liquid->iTilesY, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&liquid->iTilesY, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
-        if (result && fread(&liquid->iCorner, sizeof(Vector3), 1, rf) != 1)
+        if (result && rf.Read(&liquid->iCorner, sizeof(Vector3), 1) != 1)
         {
             result = false;
         }
-        if (result && fread(&liquid->iType, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&liquid->iType, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
         uint32 size = (liquid->iTilesX + 1) * (liquid->iTilesY + 1);
         liquid->iHeight = new float[size];
-        if (result && fread(liquid->iHeight, sizeof(float), size, rf) != size)
+        if (result && rf.Read(liquid->iHeight, sizeof(float), size) != size)
         {
             result = false;
         }
         size = liquid->iTilesX * liquid->iTilesY;
         liquid->iFlags = new uint8[size];
-        if (result && fread(liquid->iFlags, sizeof(uint8), size, rf) != size)
+        if (result && rf.Read(liquid->iFlags, sizeof(uint8), size) != size)
         {
             result = false;
         }
@@ -422,7 +423,7 @@ namespace VMAP
         return result;
     }
 
-    bool GroupModel::ReadFromFile(FILE* rf)
+    bool GroupModel::ReadFromFile(FileReader& rf)
     {
         char chunk[8];
         bool result = true;
@@ -433,15 +434,15 @@ namespace VMAP
         delete iLiquid;
         iLiquid = 0;
 
-        if (result && fread(&iBound, sizeof(G3D::AABox), 1, rf) != 1)
+        if (result && rf.Read(&iBound, sizeof(G3D::AABox), 1) != 1)
         {
             result = false;
         }
-        if (result && fread(&iMogpFlags, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&iMogpFlags, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
-        if (result && fread(&iGroupWMOID, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&iGroupWMOID, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
@@ -451,11 +452,11 @@ namespace VMAP
         {
             result = false;
         }
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&chunkSize, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
-        if (result && fread(&count, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&count, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
@@ -467,7 +468,7 @@ namespace VMAP
         {
             vertices.resize(count);
         }
-        if (result && fread(&vertices[0], sizeof(Vector3), count, rf) != count)
+        if (result && rf.Read(&vertices[0], sizeof(Vector3), count) != count)
         {
             result = false;
         }
@@ -477,11 +478,11 @@ namespace VMAP
         {
             result = false;
         }
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&chunkSize, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
-        if (result && fread(&count, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&count, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
@@ -491,7 +492,7 @@ namespace VMAP
             {
                 triangles.resize(count);
             }
-            if (result && fread(&triangles[0], sizeof(MeshTriangle), count, rf) != count)
+            if (result && rf.Read(&triangles[0], sizeof(MeshTriangle), count) != count)
             {
                 result = false;
             }
@@ -512,7 +513,7 @@ namespace VMAP
         {
             result = false;
         }
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&chunkSize, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
@@ -765,8 +766,8 @@ namespace VMAP
 
     bool WorldModel::ReadFile(const std::string& filename)
     {
-        FILE* rf = fopen(filename.c_str(), "rb");
-        if (!rf)
+        FileReader rf;
+        if (!rf.Open(filename))
         {
             return false;
         }
@@ -784,11 +785,11 @@ namespace VMAP
         {
             result = false;
         }
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&chunkSize, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
-        if (result && fread(&RootWMOID, sizeof(uint32), 1, rf) != 1)
+        if (result && rf.Read(&RootWMOID, sizeof(uint32), 1) != 1)
         {
             result = false;
         }
@@ -796,9 +797,9 @@ namespace VMAP
         // read group models
         if (result && readChunk(rf, chunk, "GMOD", 4))
         {
-            // if (fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
+            // if (rf.Read(&chunkSize, sizeof(uint32), 1) != 1) result = false;
 
-            if (result && fread(&count, sizeof(uint32), 1, rf) != 1)
+            if (result && rf.Read(&count, sizeof(uint32), 1) != 1)
             {
                 result = false;
             }
@@ -806,7 +807,7 @@ namespace VMAP
             {
                 groupModels.resize(count);
             }
-            // if (result && fread(&groupModels[0], sizeof(GroupModel), count, rf) != count) result = false;
+            // if (result && rf.Read(&groupModels[0], sizeof(GroupModel), count) != count) result = false;
             for (uint32 i = 0; i < count && result; ++i)
             {
                 result = groupModels[i].ReadFromFile(rf);
@@ -823,7 +824,6 @@ namespace VMAP
             }
         }
 
-        fclose(rf);
         return result;
     }
 }
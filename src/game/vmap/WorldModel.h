@@ -145,7 +145,7 @@ namespace VMAP
              * @param liquid
              * @return bool
              */
-            static bool ReadFromFile(FILE* rf, WmoLiquid*& liquid);
+            static bool ReadFromFile(FileReader& rf, WmoLiquid*& liquid);
         private:
             /**
              * @brief
@@ -256,7 +256,7 @@ namespace VMAP
              * @param rf
              * @return bool
              */
-            bool ReadFromFile(FILE* rf);
+            bool ReadFromFile(FileReader& rf);
             /**
              * @brief
              *
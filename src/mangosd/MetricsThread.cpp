@@ -0,0 +1,133 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+/// \addtogroup mangosd
+/// @{
+/// \file
+
+#include <ace/SOCK_Stream.h>
+#include <ace/Time_Value.h>
+
+#include "MetricsThread.h"
+
+#include "Log.h"
+#include "World.h"
+#include "Metrics.h"
+
+MetricsThread::MetricsThread(uint16 port, const char* host) : listen_addr(port, host)
+{
+}
+
+MetricsThread::~MetricsThread()
+{
+    m_Acceptor.close();
+}
+
+int MetricsThread::open(void* unused)
+{
+    if (m_Acceptor.open(listen_addr, 1) == -1)
+    {
+        sLog.outError("MaNGOS metrics can not bind to port %d on %s", listen_addr.get_port_number(), listen_addr.get_host_addr());
+        return -1;
+    }
+
+    activate();
+    return 0;
+}
+
+void MetricsThread::HandleConnection(ACE_SOCK_Stream& peer)
+{
+    // only the request line matters, the rest of the headers is ignored
+    char request[1024];
+    size_t received = 0;
+    ACE_Time_Value timeout(1);
+
+    while (received < sizeof(request) - 1)
+    {
+        ssize_t n = peer.recv(request + received, sizeof(request) - 1 - received, &timeout);
+        if (n <= 0)
+        {
+            break;
+        }
+
+        received += size_t(n);
+        request[received] = '\0';
+
+        if (strstr(request, "\r\n\r\n") || strstr(request, "\n\n"))
+        {
+            break;
+        }
+    }
+
+    request[received] = '\0';
+
+    std::string body;
+    char const* status;
+
+    if (strncmp(request, "GET /metrics ", 13) == 0 || strncmp(request, "GET / ", 6) == 0)
+    {
+        status = "200 OK";
+        sMetrics.Render(body);
+    }
+    else
+    {
+        status = "404 Not Found";
+        body = "Use GET /metrics\n";
+    }
+
+    char header[256];
+    int headerLen = snprintf(header, sizeof(header),
+                             "HTTP/1.0 %s\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " SIZEFMTD "\r\nConnection: close\r\n\r\n",
+                             status, body.size());
+
+    peer.send_n(header, headerLen, &timeout);
+    peer.send_n(body.c_str(), body.size(), &timeout);
+}
+
+int MetricsThread::svc()
+{
+    sLog.outString("Metrics Thread started (listening on %s:%d)",
+                   listen_addr.get_host_addr(),
+                   listen_addr.get_port_number());
+
+    while (!World::IsStopped())
+    {
+        ACE_SOCK_Stream peer;
+        ACE_Time_Value interval(0, 100000);
+
+        // the timeout lets the loop notice the shutdown
+        if (m_Acceptor.accept(peer, NULL, &interval) == -1)
+        {
+            continue;
+        }
+
+        HandleConnection(peer);
+        peer.close();
+    }
+
+    m_Acceptor.close();
+    sLog.outString("Metrics Thread stopped");
+    return 0;
+}
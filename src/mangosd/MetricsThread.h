@@ -0,0 +1,56 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+/// \addtogroup mangosd
+/// @{
+/// \file
+
+#ifndef MANGOS_H_METRICSTHREAD
+#define MANGOS_H_METRICSTHREAD
+
+#include <ace/SOCK_Acceptor.h>
+#include <ace/Task.h>
+#include <ace/INET_Addr.h>
+
+#include "Common.h"
+
+/// Minimal HTTP listener answering GET /metrics with the Prometheus text of sMetrics
+class MetricsThread : public ACE_Task_Base
+{
+    private:
+        ACE_SOCK_Acceptor m_Acceptor;
+        ACE_INET_Addr listen_addr;
+
+        void HandleConnection(ACE_SOCK_Stream& peer);
+
+    public:
+        explicit MetricsThread(uint16 port, const char* host);
+        virtual ~MetricsThread();
+
+        virtual int open(void* unused) override;
+        virtual int svc() override;
+};
+
+#endif
@@ -35,6 +35,7 @@
 #include "ObjectAccessor.h"
 #include "MapManager.h"
 #include "Database/DatabaseEnv.h"
+#include "Config/Config.h"
 
 #include <chrono>
 #include <thread>
@@ -79,6 +80,12 @@ int WorldThread::svc()
     uint32 realPrevTime = getMSTime();
     sLog.outString("World Updater Thread started (%dms min update interval)", WORLD_SLEEP_CONST);
 
+    std::string cpus = sConfig.GetStringDefault("ThreadAffinity.World", "");
+    if (!ACE_Based::Thread::SetCurrentThreadAffinity(cpus))
+    {
+        sLog.outError("World Updater Thread: can't run on CPUs %s", cpus.c_str());
+    }
+
     ///- While we have not World::m_stopEvent, update the world
     while (!World::IsStopped())
     {
@@ -111,6 +118,7 @@ int WorldThread::svc()
 #ifdef ENABLE_ELUNA
     sEluna->OnShutdown();
 #endif /* ENABLE_ELUNA */
+    sWorld.StopCliCommandThreads();                         // no console command may run while the world is torn down
     sWorld.KickAll();                                       // save and kick all players
     sWorld.UpdateSessions(1);                               // real players unload required UpdateSessions call
     sWorldSocketMgr->StopNetwork();
@@ -45,11 +45,14 @@
 #include "DBCStores.h"
 #include "MassMailMgr.h"
 #include "ScriptMgr.h"
+#include "StartupProfiler.h"
+#include "TickRecorder.h"
 
 #include "WorldThread.h"
 #include "CliThread.h"
 #include "AFThread.h"
 #include "RAThread.h"
+#include "MetricsThread.h"
 
 #ifdef ENABLE_SOAP
 #include "SOAP/SoapThread.h"
@@ -101,16 +104,19 @@ static bool start_db()
 	std::string dbstring = sConfig.GetStringDefault("WorldDatabaseInfo", "");
 	// 从配置文件获取WorldDatabase连接数量配置信息
 	int nConnections = sConfig.GetIntDefault("WorldDatabaseConnections", 1);
+	int nAsyncConnections = sConfig.GetIntDefault("WorldDatabaseAsyncConnections", 1);
+	// every parallel startup loader queries on its own connection
+	nConnections = std::max(nConnections, sConfig.GetIntDefault("StartupLoaderThreads", 4));
 	// 获取配置信息为空，返回false
 	if (dbstring.empty())
 	{
 		sLog.outError("Database not specified in configuration file");
 		return false;
 	}
-	sLog.outString("World Database total connections: %i", nConnections + 1);
+	sLog.outString("World Database total connections: %i", nConnections + nAsyncConnections);
 
 	// 初始化WorldDatabase数据库
-	if (!WorldDatabase.Initialize(dbstring.c_str(), nConnections))
+	if (!WorldDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
 	{
 		sLog.outError("Can not connect to world database %s", dbstring.c_str());
 		return false;
@@ -126,6 +132,7 @@ static bool start_db()
 	// 从配置文件获取Character Database信息
 	dbstring = sConfig.GetStringDefault("CharacterDatabaseInfo", "");
 	nConnections = sConfig.GetIntDefault("CharacterDatabaseConnections", 1);
+	nAsyncConnections = sConfig.GetIntDefault("CharacterDatabaseAsyncConnections", 1);
 	if (dbstring.empty())
 	{
 		sLog.outError("Character Database not specified in configuration file");
@@ -134,10 +141,10 @@ static bool start_db()
 		WorldDatabase.HaltDelayThread();
 		return false;
 	}
-	sLog.outString("Character Database total connections: %i", nConnections + 1);
+	sLog.outString("Character Database total connections: %i", nConnections + nAsyncConnections);
 
 	// 初始化Character Database
-	if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections))
+	if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
 	{
 		sLog.outError("Can not connect to Character database %s", dbstring.c_str());
 
@@ -158,6 +165,7 @@ static bool start_db()
 	// 从配置文件获取Realm database信息
 	dbstring = sConfig.GetStringDefault("LoginDatabaseInfo", "");
 	nConnections = sConfig.GetIntDefault("LoginDatabaseConnections", 1);
+	nAsyncConnections = sConfig.GetIntDefault("LoginDatabaseAsyncConnections", 1);
 	if (dbstring.empty())
 	{
 		sLog.outError("Login database not specified in configuration file");
@@ -169,8 +177,8 @@ static bool start_db()
 	}
 
 	// 初始化Realm database
-	sLog.outString("Login Database total connections: %i", nConnections + 1);
-	if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
+	sLog.outString("Login Database total connections: %i", nConnections + nAsyncConnections);
+	if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
 	{
 		sLog.outError("Can not connect to login database %s", dbstring.c_str());
 
@@ -265,6 +273,8 @@ static void usage(const char* prog)
 		"    -v, --version              print version and exist\n\r"
 		"    -c <config_file>           use config_file as configuration file\n\r"
 		"    -a, --ahbot <config_file>  use config_file as ahbot configuration file\n\r"
+		"    --startup-profile[=file]   time the world loaders, write a JSON report to file and exit\n\r"
+		"    --replay <file>            replay a capture of the tick recorder without network and exit\n\r"
 #ifdef WIN32
 		"    Running as service functions:\n\r"
 		"    -s run                     run as service\n\r"
@@ -295,8 +305,11 @@ int main(int argc, char** argv)
 	// 设置命令行选项
 	cmd_opts.long_option("version", 'v', ACE_Get_Opt::NO_ARG);
 	cmd_opts.long_option("ahbot", 'a', ACE_Get_Opt::ARG_REQUIRED);
+	cmd_opts.long_option("startup-profile", 'p', ACE_Get_Opt::ARG_OPTIONAL);
+	cmd_opts.long_option("replay", 'r', ACE_Get_Opt::ARG_REQUIRED);
 
 	char serviceDaemonMode = '\0';
+	char const* replayFile = NULL;
 	// 遍历命令行参数
 	int option;
 	while ((option = cmd_opts()) != EOF)
@@ -313,6 +326,16 @@ int main(int argc, char** argv)
 			cfg_file = cmd_opts.opt_arg();
 			break;
 		}
+		case 'p': {
+			// 启动性能分析模式，加载完成后写出报告并退出
+			sStartupProfiler.Enable(cmd_opts.opt_arg() ? cmd_opts.opt_arg() : "startup-profile.json");
+			break;
+		}
+		case 'r': {
+			// replay a capture offline, the world is loaded but not opened to clients
+			replayFile = cmd_opts.opt_arg();
+			break;
+		}
 		case 'v':{
 			// 输出版本信息
 			printf("%s\n", GitRevision::GetProjectRevision());
@@ -405,6 +428,9 @@ int main(int argc, char** argv)
 		break;
 }
 #endif
+	// the writer thread would not survive the fork above
+	sLog.StartAsyncWriter();
+
 	// 输出Git版本信息
 	sLog.outString("%s [world-daemon]", GitRevision::GetProjectRevision());
 	sLog.outString("%s", GitRevision::GetFullRevision());
@@ -455,6 +481,26 @@ int main(int argc, char** argv)
 	// 初始化世界
 	sWorld.SetInitialWorldSettings();
 
+	if (sStartupProfiler.IsEnabled())
+	{
+		return sStartupProfiler.WriteReport() ? 0 : 1;
+	}
+
+	if (replayFile)
+	{
+		CharacterDatabase.AllowAsyncTransactions();
+		WorldDatabase.AllowAsyncTransactions();
+		LoginDatabase.AllowAsyncTransactions();
+		return TickReplay::Run(replayFile) ? 0 : 1;
+	}
+
+	// capture the input of one map, for replaying a lag spike with --replay
+	if (sConfig.GetBoolDefault("Recorder.Enable", false))
+	{
+		sTickRecorder.Start(sConfig.GetStringDefault("Recorder.File", "tick-capture.bin"), sConfig.GetIntDefault("Recorder.Map", 0),
+			sConfig.GetIntDefault("Recorder.Instance", 0), sConfig.GetIntDefault("Recorder.RotateTicks", 12000));
+	}
+
 #ifndef _WIN32
 	detachDaemon();
 #endif
@@ -523,14 +569,32 @@ int main(int argc, char** argv)
 
 
 	//************************************************************************************************************************
-	// 4. Start the freeze catcher thread
+	// 4. Start the metrics listener thread, if enabled
+	//************************************************************************************************************************
+	MetricsThread* metricsThread = NULL;
+	if (sConfig.GetBoolDefault("Metrics.Enable", false))
+	{
+		port = sConfig.GetIntDefault("Metrics.Port", 9101);
+		host = sConfig.GetStringDefault("Metrics.IP", "127.0.0.1");
+
+		metricsThread = new MetricsThread(port, host.c_str());
+		if (metricsThread->open(0) == -1)
+		{
+			delete metricsThread;
+			metricsThread = NULL;
+		}
+	}
+
+
+	//************************************************************************************************************************
+	// 5. Start the freeze catcher thread
 	//************************************************************************************************************************
 	AntiFreezeThread* freezeThread = new AntiFreezeThread(1000 * sConfig.GetIntDefault("MaxCoreStuckTime", 0));
 	freezeThread->open(NULL);
 
 
 	//************************************************************************************************************************
-	// 5. Start the console thread
+	// 6. Start the console thread
 	//************************************************************************************************************************
 	CliThread* cliThread = NULL;
 #ifdef _WIN32
@@ -553,6 +617,7 @@ int main(int argc, char** argv)
 	}
 
 	ACE_Thread_Manager::instance()->wait();
+	sTickRecorder.Stop();
 	sLog.outString("Halting process...");
 
 	///- Stop freeze protection before shutdown tasks
@@ -566,6 +631,11 @@ int main(int argc, char** argv)
 		delete raThread;
 	}
 
+	if (metricsThread)
+	{
+		delete metricsThread;
+	}
+
 	delete worldThread;
 
 	///- Remove signal handling before leaving
@@ -597,6 +667,7 @@ int main(int argc, char** argv)
 	_set_abort_behavior(0, _WRITE_ABORT_MSG | _CALL_REPORTFAULT);
 #endif
 
+	sLog.StopAsyncWriter();
 	sLog.outString("Bye!");
 	return code;
 }
@@ -80,6 +80,9 @@ PlayerbotAI::PlayerbotAI(Player* bot) :
     currentState = BOT_STATE_NON_COMBAT;
 
     //masterIncomingPacketHandlers.AddHandler(CMSG_GAMEOBJ_REPORT_USE, "use game object");
+    // spread the strategy updates of bots logged in together over several ticks
+    nextAICheckDelay = urand(0, sPlayerbotAIConfig.idleReactDelay);
+
     masterIncomingPacketHandlers.AddHandler(CMSG_AREATRIGGER, "area trigger");
     masterIncomingPacketHandlers.AddHandler(CMSG_GAMEOBJ_USE, "use game object");
     masterIncomingPacketHandlers.AddHandler(CMSG_LOOT_ROLL, "loot roll");
@@ -183,6 +186,13 @@ void PlayerbotAI::UpdateAIInternal(uint32 elapsed)
     DoNextAction();
 }
 
+uint32 PlayerbotAI::GetReactDelay()
+{
+    // bots nobody plays with only need to think now and then
+    bool idle = !bot->IsInCombat() && chatCommands.empty() && (!master || master->GetPlayerbotAI());
+    return idle ? sPlayerbotAIConfig.idleReactDelay : sPlayerbotAIConfig.reactDelay;
+}
+
 void PlayerbotAI::HandleTeleportAck()
 {
     bot->GetMotionMaster()->Clear(true);
@@ -347,6 +357,19 @@ void PlayerbotAI::HandleBotOutgoingPacket(const WorldPacket& packet)
     }
 }
 
+bool PlayerbotAI::IsBotOutgoingPacketHandled(uint16 opcode) const
+{
+    switch (opcode)
+    {
+    case SMSG_CAST_FAILED:
+    case SMSG_SPELL_FAILURE:
+    case SMSG_SPELL_DELAYED:
+        return true;
+    default:
+        return botOutgoingPacketHandlers.HasHandler(opcode);
+    }
+}
+
 void PlayerbotAI::SpellInterrupted(uint32 spellid)
 {
     LastSpellCast& lastSpell = aiObjectContext->GetValue<LastSpellCast&>("last spell cast")->Get();
@@ -73,6 +73,7 @@ public:
     void AddHandler(uint16 opcode, string handler);
     void Handle(ExternalEventHelper &helper);
     void AddPacket(const WorldPacket& packet);
+    bool HasHandler(uint16 opcode) const { return handlers.find(opcode) != handlers.end(); }
 
 private:
     map<uint16, string> handlers;
@@ -111,8 +112,11 @@ public:
 public:
     virtual void UpdateAI(uint32 elapsed);
     virtual void UpdateAIInternal(uint32 elapsed);
+    virtual uint32 GetReactDelay();
     void HandleCommand(uint32 type, const string& text, Player& fromPlayer);
     void HandleBotOutgoingPacket(const WorldPacket& packet);
+    // whether HandleBotOutgoingPacket does anything with the opcode, the others need not be built for the bot
+    bool IsBotOutgoingPacketHandled(uint16 opcode) const;
     void HandleMasterIncomingPacket(const WorldPacket& packet);
     void HandleMasterOutgoingPacket(const WorldPacket& packet);
     void HandleTeleportAck();
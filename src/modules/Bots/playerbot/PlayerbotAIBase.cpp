@@ -54,10 +54,16 @@ bool PlayerbotAIBase::CanUpdateAI()
     return nextAICheckDelay < 100;
 }
 
+uint32 PlayerbotAIBase::GetReactDelay()
+{
+    return sPlayerbotAIConfig.reactDelay;
+}
+
 void PlayerbotAIBase::YieldThread()
 {
-    if (nextAICheckDelay < sPlayerbotAIConfig.reactDelay)
+    uint32 reactDelay = GetReactDelay();
+    if (nextAICheckDelay < reactDelay)
     {
-        nextAICheckDelay = sPlayerbotAIConfig.reactDelay;
+        nextAICheckDelay = reactDelay;
     }
 }
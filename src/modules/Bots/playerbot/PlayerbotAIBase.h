@@ -18,6 +18,8 @@ public:
     void YieldThread();
     virtual void UpdateAI(uint32 elapsed);
     virtual void UpdateAIInternal(uint32 elapsed) = 0;
+    // Minimum time until the next strategy update, see YieldThread
+    virtual uint32 GetReactDelay();
 
 protected:
     uint32 nextAICheckDelay;
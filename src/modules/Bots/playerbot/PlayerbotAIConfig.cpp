@@ -49,6 +49,7 @@ bool PlayerbotAIConfig::Initialize()
     globalCoolDown = (uint32) config.GetIntDefault("AiPlayerbot.GlobalCooldown", 500);
     maxWaitForMove = config.GetIntDefault("AiPlayerbot.MaxWaitForMove", 3000);
     reactDelay = (uint32) config.GetIntDefault("AiPlayerbot.ReactDelay", 100);
+    idleReactDelay = max(reactDelay, (uint32) config.GetIntDefault("AiPlayerbot.IdleReactDelay", 1000));
 
     sightDistance = config.GetFloatDefault("AiPlayerbot.SightDistance", 50.0f);
     spellDistance = config.GetFloatDefault("AiPlayerbot.SpellDistance", 30.0f);
@@ -96,6 +97,8 @@ bool PlayerbotAIConfig::Initialize()
     randomBotTeleportDistance = config.GetIntDefault("AiPlayerbot.RandomBotTeleportDistance", 1000);
     minRandomBotsPerInterval = config.GetIntDefault("AiPlayerbot.MinRandomBotsPerInterval", 50);
     maxRandomBotsPerInterval = config.GetIntDefault("AiPlayerbot.MaxRandomBotsPerInterval", 100);
+    randomBotMaxLoginsInFlight = max(1, config.GetIntDefault("AiPlayerbot.RandomBotMaxLoginsInFlight", 10));
+    randomBotLoginMaxTickTime = config.GetIntDefault("AiPlayerbot.RandomBotLoginMaxTickTime", 150);
     minRandomBotsPriceChangeInterval = config.GetIntDefault("AiPlayerbot.MinRandomBotsPriceChangeInterval", 2 * 3600);
     maxRandomBotsPriceChangeInterval = config.GetIntDefault("AiPlayerbot.MaxRandomBotsPriceChangeInterval", 48 * 3600);
     randomBotJoinLfg = config.GetBoolDefault("AiPlayerbot.RandomBotJoinLfg", true);
@@ -154,6 +157,10 @@ string PlayerbotAIConfig::GetValue(string name)
     {
         out << reactDelay;
     }
+    else if (name == "IdleReactDelay")
+    {
+        out << idleReactDelay;
+    }
 
     else if (name == "SightDistance")
     {
@@ -221,6 +228,10 @@ void PlayerbotAIConfig::SetValue(string name, string value)
     {
         out >> reactDelay;
     }
+    else if (name == "IdleReactDelay")
+    {
+        out >> idleReactDelay;
+    }
 
     else if (name == "SightDistance")
     {
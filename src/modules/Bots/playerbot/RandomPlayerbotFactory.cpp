@@ -10,6 +10,7 @@
 #include "Player.h"
 #include "RandomPlayerbotFactory.h"
 #include "SystemConfig.h"
+#include "PlayerNameCache.h"
 
 map<uint8, vector<uint8> > RandomPlayerbotFactory::availableRaces;
 
@@ -106,6 +107,7 @@ bool RandomPlayerbotFactory::CreateRandomBot(uint8 cls)
     player->setCinematic(2);
     player->SetAtLoginFlag(AT_LOGIN_NONE);
     player->SaveToDB();
+    sPlayerNameCache.Add(player->GetGUIDLow(), name, race, gender, cls);
 
     sLog.outDetail("Random bot created for account %d - name: \"%s\"; race: %u; class: %u; gender: %u; skin: %u; face: %u; hairStyle: %u; hairColor: %u; facialHair: %u; outfitId: %u",
             accountId, name.c_str(), race, cls, gender, skin, face, hairStyle, hairColor, facialHair, outfitId);
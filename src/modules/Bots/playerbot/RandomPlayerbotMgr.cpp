@@ -9,10 +9,11 @@
 #include "PlayerbotAI.h"
 #include "Player.h"
 #include "AiFactory.h"
+#include "UpdateTime.h"
 
 INSTANTIATE_SINGLETON_1(RandomPlayerbotMgr);
 
-RandomPlayerbotMgr::RandomPlayerbotMgr() : PlayerbotHolder(), processTicks(0)
+RandomPlayerbotMgr::RandomPlayerbotMgr() : PlayerbotHolder(), processTicks(0), eventCacheLoaded(false)
 {
 }
 
@@ -20,6 +21,83 @@ RandomPlayerbotMgr::~RandomPlayerbotMgr()
 {
 }
 
+void RandomPlayerbotMgr::UpdateAI(uint32 elapsed)
+{
+    ProcessLoginQueue();
+    PlayerbotHolder::UpdateAI(elapsed);
+}
+
+void RandomPlayerbotMgr::QueueLogin(uint32 bot)
+{
+    if (queuedLogins.insert(bot).second && loginsInFlight.find(bot) == loginsInFlight.end())
+    {
+        loginQueue.push_back(bot);
+    }
+}
+
+void RandomPlayerbotMgr::OnBotLoginInternal(Player * const bot)
+{
+    loginsInFlight.erase(bot->GetGUIDLow());
+}
+
+void RandomPlayerbotMgr::ProcessLoginQueue()
+{
+    if (loginQueue.empty() && loginsInFlight.empty() && randomizeQueue.empty())
+    {
+        return;
+    }
+
+    // logins that did not complete, e.g. the character failed to load
+    time_t now = time(0);
+    for (map<uint32, time_t>::iterator i = loginsInFlight.begin(); i != loginsInFlight.end();)
+    {
+        if (now - i->second > 60)
+        {
+            loginsInFlight.erase(i++);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    // leave the bots for later while the world tick is slow
+    if (sPlayerbotAIConfig.randomBotLoginMaxTickTime && sWorldUpdateTime.GetLastUpdateTime() > sPlayerbotAIConfig.randomBotLoginMaxTickTime)
+    {
+        return;
+    }
+
+    while (!loginQueue.empty() && loginsInFlight.size() < sPlayerbotAIConfig.randomBotMaxLoginsInFlight)
+    {
+        uint32 bot = loginQueue.front();
+        loginQueue.pop_front();
+        queuedLogins.erase(bot);
+
+        if (GetPlayerBot(bot))
+        {
+            continue;
+        }
+
+        sLog.outDetail("Bot %d logged in", bot);
+        loginsInFlight[bot] = now;
+        AddPlayerBot(bot, 0);
+    }
+
+    // randomization generates gear and talents, one bot per tick once all logins are done
+    if (loginQueue.empty() && loginsInFlight.empty() && !randomizeQueue.empty())
+    {
+        uint32 bot = randomizeQueue.front();
+        randomizeQueue.pop_front();
+
+        Player* player = GetPlayerBot(bot);
+        if (player && !player->GetGroup())
+        {
+            sLog.outDetail("Randomizing bot %d", bot);
+            Randomize(player);
+        }
+    }
+}
+
 void RandomPlayerbotMgr::UpdateAIInternal(uint32 elapsed)
 {
     SetNextCheckDelay(sPlayerbotAIConfig.randomBotUpdateInterval * 1000);
@@ -142,8 +220,7 @@ bool RandomPlayerbotMgr::ProcessBot(uint32 bot)
 
     if (!GetPlayerBot(bot))
     {
-        sLog.outDetail("Bot %d logged in", bot);
-        AddPlayerBot(bot, 0);
+        QueueLogin(bot);
         if (!GetEventValue(bot, "online"))
         {
             SetEventValue(bot, "online", 1, sPlayerbotAIConfig.minRandomBotInWorldTime);
@@ -195,8 +272,7 @@ bool RandomPlayerbotMgr::ProcessBot(uint32 bot)
     uint32 randomize = GetEventValue(bot, "randomize");
     if (!randomize)
     {
-        sLog.outDetail("Randomizing bot %d", bot);
-        Randomize(player);
+        randomizeQueue.push_back(bot);
         uint32 randomTime = urand(sPlayerbotAIConfig.minRandomBotRandomizeTime, sPlayerbotAIConfig.maxRandomBotRandomizeTime);
         ScheduleRandomize(bot, randomTime);
         return true;
@@ -507,18 +583,15 @@ list<uint32> RandomPlayerbotMgr::GetBots()
 {
     list<uint32> bots;
 
-    QueryResult* results = CharacterDatabase.Query(
-            "SELECT `bot` FROM `ai_playerbot_random_bots` WHERE `owner` = 0 AND `event` = 'add'");
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, eventCacheLock, bots);
+    LoadEventCache();
 
-    if (results)
+    for (map<uint32, BotEventMap>::const_iterator i = eventCache.begin(); i != eventCache.end(); ++i)
     {
-        do
+        if (i->second.find("add") != i->second.end())
         {
-            Field* fields = results->Fetch();
-            uint32 bot = fields[0].GetUInt32();
-            bots.push_back(bot);
-        } while (results->NextRow());
-        delete results;
+            bots.push_back(i->first);
+        }
     }
 
     return bots;
@@ -575,32 +648,113 @@ vector<uint32> RandomPlayerbotMgr::GetFreeBots(bool alliance)
     return guids;
 }
 
-uint32 RandomPlayerbotMgr::GetEventValue(uint32 bot, string event)
+void RandomPlayerbotMgr::LoadEventCache()
 {
-    uint32 value = 0;
+    if (eventCacheLoaded)
+    {
+        return;
+    }
 
-    QueryResult* results = CharacterDatabase.PQuery(
-            "SELECT `value`, `time`, `validIn` FROM `ai_playerbot_random_bots` WHERE `owner` = 0 AND `bot` = '%u' AND `event` = '%s'",
-            bot, event.c_str());
+    eventCache.clear();
+    eventCacheLoaded = true;
+
+    QueryResult* results = CharacterDatabase.Query(
+            "SELECT `bot`, `event`, `value`, `time`, `validIn` FROM `ai_playerbot_random_bots` WHERE `owner` = 0");
 
     if (results)
     {
-        Field* fields = results->Fetch();
-        value = fields[0].GetUInt32();
-        uint32 lastChangeTime = fields[1].GetUInt32();
-        uint32 validIn = fields[2].GetUInt32();
-        if ((time(0) - lastChangeTime) >= validIn)
+        do
         {
-            value = 0;
-        }
+            Field* fields = results->Fetch();
+            CachedEvent& cached = eventCache[fields[0].GetUInt32()][fields[1].GetCppString()];
+            cached.value = fields[2].GetUInt32();
+            cached.lastChangeTime = fields[3].GetUInt32();
+            cached.validIn = fields[4].GetUInt32();
+        } while (results->NextRow());
         delete results;
     }
+}
 
-    return value;
+void RandomPlayerbotMgr::SetEventValidIn(uint32 bot, string event, uint32 validIn)
+{
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, eventCacheLock);
+        LoadEventCache();
+
+        map<uint32, BotEventMap>::iterator events = eventCache.find(bot);
+        if (events != eventCache.end())
+        {
+            BotEventMap::iterator cached = events->second.find(event);
+            if (cached != events->second.end())
+            {
+                cached->second.validIn = validIn;
+            }
+        }
+    }
+
+    CharacterDatabase.PExecute("UPDATE `ai_playerbot_random_bots` SET `validIn` = '%u' WHERE `event` = '%s' AND `bot` = '%u'",
+            validIn, event.c_str(), bot);
+}
+
+void RandomPlayerbotMgr::ResetEventCache()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, eventCacheLock);
+    eventCacheLoaded = false;
+    eventCache.clear();
+}
+
+uint32 RandomPlayerbotMgr::GetEventValue(uint32 bot, string event)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, eventCacheLock, 0);
+    LoadEventCache();
+
+    map<uint32, BotEventMap>::const_iterator events = eventCache.find(bot);
+    if (events == eventCache.end())
+    {
+        return 0;
+    }
+
+    BotEventMap::const_iterator cached = events->second.find(event);
+    if (cached == events->second.end())
+    {
+        return 0;
+    }
+
+    if ((time(0) - cached->second.lastChangeTime) >= cached->second.validIn)
+    {
+        return 0;
+    }
+
+    return cached->second.value;
 }
 
 uint32 RandomPlayerbotMgr::SetEventValue(uint32 bot, string event, uint32 value, uint32 validIn)
 {
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, eventCacheLock, value);
+        LoadEventCache();
+
+        if (value)
+        {
+            CachedEvent& cached = eventCache[bot][event];
+            cached.value = value;
+            cached.lastChangeTime = (uint32)time(0);
+            cached.validIn = validIn;
+        }
+        else
+        {
+            map<uint32, BotEventMap>::iterator events = eventCache.find(bot);
+            if (events != eventCache.end())
+            {
+                events->second.erase(event);
+                if (events->second.empty())
+                {
+                    eventCache.erase(events);
+                }
+            }
+        }
+    }
+
     CharacterDatabase.PExecute("DELETE FROM `ai_playerbot_random_bots` WHERE `owner` = 0 and `bot` = '%u' and `event` = '%s'",
             bot, event.c_str());
     if (value)
@@ -633,6 +787,7 @@ bool ChatHandler::HandlePlayerbotConsoleCommand(char* args)
     if (cmd == "reset")
     {
         CharacterDatabase.PExecute("DELETE FROM `ai_playerbot_random_bots`");
+        sRandomPlayerbotMgr.ResetEventCache();
         sLog.outBasic("Random bots were reset for all players");
         return true;
     }
@@ -678,10 +833,8 @@ bool ChatHandler::HandlePlayerbotConsoleCommand(char* args)
                         sRandomPlayerbotMgr.IncreaseLevel(bot);
                     }
                     uint32 randomTime = urand(sPlayerbotAIConfig.minRandomBotRandomizeTime, sPlayerbotAIConfig.maxRandomBotRandomizeTime);
-                    CharacterDatabase.PExecute("UPDATE `ai_playerbot_random_bots` SET `validIn` = '%u' WHERE `event` = 'randomize' AND `bot` = '%u'",
-                            randomTime, bot->GetGUIDLow());
-                    CharacterDatabase.PExecute("UPDATE `ai_playerbot_random_bots` SET `validIn` = '%u' WHERE `event` = 'logout' AND `bot` = '%u'",
-                            sPlayerbotAIConfig.maxRandomBotInWorldTime, bot->GetGUIDLow());
+                    sRandomPlayerbotMgr.SetEventValidIn(bot->GetGUIDLow(), "randomize", randomTime);
+                    sRandomPlayerbotMgr.SetEventValidIn(bot->GetGUIDLow(), "logout", sPlayerbotAIConfig.maxRandomBotInWorldTime);
                 } while (results->NextRow());
 
                 delete results;
@@ -803,9 +956,16 @@ void RandomPlayerbotMgr::PrintStats()
     }
 
     int dps = 0, heal = 0, tank = 0;
+    uint64 valueHits = 0, valueCalculations = 0, triggerHits = 0, triggerChecks = 0;
     for (PlayerBotMap::iterator i = playerBots.begin(); i != playerBots.end(); ++i)
     {
         Player* bot = i->second;
+        if (PlayerbotAI* ai = bot->GetPlayerbotAI())
+        {
+            ai->GetAiObjectContext()->GetValueCacheStats(valueHits, valueCalculations);
+            ai->GetAiObjectContext()->GetTriggerCacheStats(triggerHits, triggerChecks);
+        }
+
         if (IsAlliance(bot->getRace()))
         {
             alliance[bot->getLevel() / 10]++;
@@ -917,6 +1077,11 @@ void RandomPlayerbotMgr::PrintStats()
     sLog.outString("    tank: %d", tank);
     sLog.outString("    heal: %d", heal);
     sLog.outString("    dps: %d", dps);
+    sLog.outString("AI caches:");
+    sLog.outString("    values: " UI64FMTD " cached, " UI64FMTD " calculated (%.1f%% hit rate)", valueHits, valueCalculations,
+        valueHits + valueCalculations ? valueHits * 100.0 / (valueHits + valueCalculations) : 0.0);
+    sLog.outString("    triggers: " UI64FMTD " shared, " UI64FMTD " checked (%.1f%% hit rate)", triggerHits, triggerChecks,
+        triggerHits + triggerChecks ? triggerHits * 100.0 / (triggerHits + triggerChecks) : 0.0);
 }
 
 double RandomPlayerbotMgr::GetBuyMultiplier(Player* bot)
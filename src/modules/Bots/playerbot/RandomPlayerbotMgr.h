@@ -19,6 +19,7 @@ class MANGOS_DLL_SPEC RandomPlayerbotMgr : public PlayerbotHolder
         RandomPlayerbotMgr();
         virtual ~RandomPlayerbotMgr();
 
+        virtual void UpdateAI(uint32 elapsed);
         virtual void UpdateAIInternal(uint32 elapsed);
 
     public:
@@ -39,9 +40,13 @@ class MANGOS_DLL_SPEC RandomPlayerbotMgr : public PlayerbotHolder
         void SetLootAmount(Player* bot, uint32 value);
         uint32 GetTradeDiscount(Player* bot);
         void Refresh(Player* bot);
+        // Changes the validity of an event without restarting its timer
+        void SetEventValidIn(uint32 bot, string event, uint32 validIn);
+        // Drops the cached ai_playerbot_random_bots rows after the table was changed directly
+        void ResetEventCache();
 
     protected:
-        virtual void OnBotLoginInternal(Player * const bot) {}
+        virtual void OnBotLoginInternal(Player * const bot);
 
     private:
         uint32 GetEventValue(uint32 bot, string event);
@@ -55,10 +60,33 @@ class MANGOS_DLL_SPEC RandomPlayerbotMgr : public PlayerbotHolder
         void RandomTeleportForLevel(Player* bot);
         void RandomTeleport(Player* bot, vector<WorldLocation> &locs);
         uint32 GetZoneLevel(uint32 mapId, float teleX, float teleY, float teleZ);
+        void LoadEventCache();
+        void QueueLogin(uint32 bot);
+        void ProcessLoginQueue();
 
     private:
         vector<Player*> players;
         int processTicks;
+
+        struct CachedEvent
+        {
+            uint32 value;
+            uint32 lastChangeTime;
+            uint32 validIn;
+        };
+        typedef map<string, CachedEvent> BotEventMap;
+
+        // ai_playerbot_random_bots rows of owner 0, read once instead of one query per event check
+        map<uint32, BotEventMap> eventCache;
+        bool eventCacheLoaded;
+        ACE_Thread_Mutex eventCacheLock;                    // values are also read by the bot AI on the map threads
+
+        // bots waiting to log in, started a few at a time by ProcessLoginQueue
+        list<uint32> loginQueue;
+        set<uint32> queuedLogins;
+        map<uint32, time_t> loginsInFlight;                 // login query holder sent, start time
+        // bots due for randomization, handled while no bot is logging in
+        list<uint32> randomizeQueue;
 };
 
 #define sRandomPlayerbotMgr MaNGOS::Singleton<RandomPlayerbotMgr>::Instance()
@@ -13,7 +13,7 @@
 
 using namespace ai;
 
-AiObjectContext::AiObjectContext(PlayerbotAI* ai) : PlayerbotAIAware(ai)
+AiObjectContext::AiObjectContext(PlayerbotAI* ai) : PlayerbotAIAware(ai), triggerChecks(0), triggerCacheHits(0)
 {
     strategyContexts.Add(new StrategyContext());
     strategyContexts.Add(new MovementStrategyContext());
@@ -40,6 +40,34 @@ namespace ai
             return GetValue<T>(name, out.str());
         }
 
+        // Drops the cached result of a calculated value, for actions that change what it depends on
+        void InvalidateValue(string name)
+        {
+            UntypedValue* value = GetUntypedValue(name);
+            if (value)
+            {
+                value->Invalidate();
+            }
+        }
+
+        void GetValueCacheStats(uint64& hits, uint64& calculations)
+        {
+            set<string> names = valueContexts.GetCreated();
+            for (set<string>::iterator i = names.begin(); i != names.end(); ++i)
+            {
+                UntypedValue* value = GetUntypedValue(*i);
+                if (value)
+                {
+                    hits += value->GetCacheHits();
+                    calculations += value->GetCalculations();
+                }
+            }
+        }
+
+        // A trigger listed by several strategies is only checked once per AI tick, see Engine::ProcessTriggers
+        void RecordTriggerCheck(bool cached) { ++(cached ? triggerCacheHits : triggerChecks); }
+        void GetTriggerCacheStats(uint64& hits, uint64& checks) { hits += triggerCacheHits; checks += triggerChecks; }
+
         set<string> GetSupportedStrategies()
         {
             return strategyContexts.supports();
@@ -81,5 +109,7 @@ namespace ai
         NamedObjectContextList<Action> actionContexts;
         NamedObjectContextList<Trigger> triggerContexts;
         NamedObjectContextList<UntypedValue> valueContexts;
+        uint32 triggerChecks;
+        uint32 triggerCacheHits;
     };
 }
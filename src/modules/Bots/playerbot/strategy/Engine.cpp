@@ -394,6 +394,9 @@ bool Engine::HasStrategy(string name)
 
 void Engine::ProcessTriggers()
 {
+    // strategies share trigger objects by name, each one is checked once per tick
+    map<Trigger*, Event> checked;
+
     for (list<TriggerNode*>::iterator i = triggers.begin(); i != triggers.end(); i++)
     {
         TriggerNode* node = *i;
@@ -414,9 +417,20 @@ void Engine::ProcessTriggers()
             continue;
         }
 
-        if (testMode || trigger->needCheck())
+        map<Trigger*, Event>::iterator found = checked.find(trigger);
+        if (found != checked.end())
+        {
+            aiObjectContext->RecordTriggerCheck(true);
+        }
+        else if (testMode || trigger->needCheck())
+        {
+            aiObjectContext->RecordTriggerCheck(false);
+            found = checked.insert(make_pair(trigger, trigger->Check())).first;
+        }
+
+        if (found != checked.end())
         {
-            Event event = trigger->Check();
+            Event event = found->second;
             if (!event)
             {
                 continue;
@@ -9,10 +9,19 @@ namespace ai
     class UntypedValue : public AiNamedObject
     {
     public:
-        UntypedValue(PlayerbotAI* ai, string name) : AiNamedObject(ai, name) {}
+        UntypedValue(PlayerbotAI* ai, string name) : AiNamedObject(ai, name), cacheHits(0), calculations(0) {}
         virtual void Update() {}
         virtual void Reset() {}
+        // Forces the next Get to calculate the value again
+        virtual void Invalidate() {}
         virtual string Format() { return "?"; }
+
+        uint32 GetCacheHits() const { return cacheHits; }
+        uint32 GetCalculations() const { return calculations; }
+
+    protected:
+        uint32 cacheHits;
+        uint32 calculations;
     };
 
     template<class T>
@@ -41,10 +50,17 @@ namespace ai
                 ticksElapsed = 0;
             }
                 value = Calculate();
+                ++calculations;
+            }
+            else
+            {
+                ++cacheHits;
             }
             return value;
         }
         virtual void Set(T value) { this->value = value; }
+        virtual void Reset() { Invalidate(); }
+        virtual void Invalidate() { ticksElapsed = checkInterval; }
         virtual void Update()
         {
             if (ticksElapsed < checkInterval) {
@@ -8,6 +8,7 @@
 #define _BINDING_MAP_H
 
 #include <memory>
+#include <atomic>
 #include "Common.h"
 #include "ElunaUtility.h"
 #include <type_traits>
@@ -29,16 +30,34 @@ private:
     lua_State* L;
     uint64 maxBindingID;
 
+    /*
+     * Number of bindings per event ID and per key hash slot, readable without the lock.
+     *
+     * Hooks are called from all map threads, this lets `HasBindingsFor`
+     *   answer for events and entries without any script binding without taking the lock.
+     * Keys sharing a slot only cost a locked lookup, they can't hide a binding.
+     */
+    static const uint32 MAX_COUNTED_EVENTS = 128;
+    static const uint32 KEY_FILTER_SIZE = 4096;
+    std::atomic<uint32> eventBindingCounts[MAX_COUNTED_EVENTS];
+    std::atomic<uint32> keyBindingCounts[KEY_FILTER_SIZE];
+
+    static uint32 GetKeySlot(const K& key) { return uint32(std::hash<K>()(key) % KEY_FILTER_SIZE); }
+
     struct Binding
     {
         uint64 id;
         lua_State* L;
+        uint32 eventId;
+        uint32 keySlot;
         uint32 remainingShots;
         int functionReference;
 
-        Binding(lua_State* L, uint64 id, int functionReference, uint32 remainingShots) :
+        Binding(lua_State* L, uint64 id, uint32 eventId, uint32 keySlot, int functionReference, uint32 remainingShots) :
             id(id),
             L(L),
+            eventId(eventId),
+            keySlot(keySlot),
             remainingShots(remainingShots),
             functionReference(functionReference)
         { }
@@ -64,11 +83,35 @@ private:
      */
     std::unordered_map<uint64, BindingList*> id_lookup_table;
 
+    void CountBinding(const Binding& binding)
+    {
+        if (binding.eventId < MAX_COUNTED_EVENTS)
+            ++eventBindingCounts[binding.eventId];
+        ++keyBindingCounts[binding.keySlot];
+    }
+
+    void UncountBinding(const Binding& binding)
+    {
+        if (binding.eventId < MAX_COUNTED_EVENTS)
+            --eventBindingCounts[binding.eventId];
+        --keyBindingCounts[binding.keySlot];
+    }
+
+    void ResetCounts()
+    {
+        for (uint32 i = 0; i < MAX_COUNTED_EVENTS; ++i)
+            eventBindingCounts[i].store(0);
+        for (uint32 i = 0; i < KEY_FILTER_SIZE; ++i)
+            keyBindingCounts[i].store(0);
+    }
+
 public:
     BindingMap(lua_State* L) :
         L(L),
         maxBindingID(0)
-    { }
+    {
+        ResetCounts();
+    }
 
     /*
      * Insert a new binding from `key` to `ref`, which lasts for `shots`-many pushes.
@@ -82,8 +125,9 @@ public:
 
         uint64 id = (++maxBindingID);
         BindingList& list = bindings[key];
-        list.push_back(std::unique_ptr<Binding>(new Binding(L, id, ref, shots)));
+        list.push_back(std::unique_ptr<Binding>(new Binding(L, id, uint32(key.event_id), GetKeySlot(key), ref, shots)));
         id_lookup_table[id] = &list;
+        CountBinding(*list.back());
         return id;
     }
 
@@ -108,6 +152,7 @@ public:
         {
             std::unique_ptr<Binding>& binding = *i;
             id_lookup_table.erase(binding->id);
+            UncountBinding(*binding);
         }
 
         bindings.erase(key);
@@ -125,6 +170,7 @@ public:
 
         id_lookup_table.clear();
         bindings.clear();
+        ResetCounts();
     }
 
     /*
@@ -151,7 +197,10 @@ public:
         }
 
         if (i != list->end())
+        {
+            UncountBinding(**i);
             list->erase(i);
+        }
 
         // Unconditionally erase the ID in the lookup table because
         //   it was either already invalid, or it's no longer valid.
@@ -163,6 +212,13 @@ public:
      */
     bool HasBindingsFor(const K& key)
     {
+        uint32 eventId = uint32(key.event_id);
+        if (eventId < MAX_COUNTED_EVENTS && !eventBindingCounts[eventId].load(std::memory_order_relaxed))
+            return false;
+
+        if (!keyBindingCounts[GetKeySlot(key)].load(std::memory_order_relaxed))
+            return false;
+
         Guard guard(GetLock());
 
         if (bindings.empty())
@@ -205,6 +261,7 @@ public:
                 if (binding->remainingShots == 0)
                 {
                     id_lookup_table.erase(binding->id);
+                    UncountBinding(*binding);
                     list.erase(i_prev);
                 }
             }
@@ -44,6 +44,9 @@
 #include <ace/OS_NS_sys_stat.h>
 #endif
 
+#include <chrono>
+#include <sstream>
+
 extern "C"
 {
 // Base lua libraries
@@ -153,6 +156,11 @@ Eluna::Eluna() :
 event_level(0),
 push_counter(0),
 enabled(false),
+stateId(0),
+profiling(false),
+profileLogInterval(0),
+profileLogTimer(0),
+allocatedBytes(0),
 
 L(NULL),
 eventMgr(NULL),
@@ -211,6 +219,9 @@ void Eluna::CloseLua()
 
     instanceDataRefs.clear();
     continentDataRefs.clear();
+
+    // The keys are addresses inside the closed state
+    profileEntries.clear();
 }
 
 void Eluna::OpenLua()
@@ -222,7 +233,16 @@ void Eluna::OpenLua()
         return;
     }
 
-    L = luaL_newstate();
+    profiling = eConfigMgr->GetBoolDefault("Eluna.Profiling", false);
+    profileLogInterval = eConfigMgr->GetIntDefault("Eluna.ProfilingLogInterval", 300) * IN_MILLISECONDS;
+    profileLogTimer = 0;
+    allocatedBytes = 0;
+
+    // Same as luaL_newstate, but with an allocator that counts the allocated bytes for the profiler
+    L = lua_newstate(&LuaAlloc, this);
+    if (L)
+        lua_atpanic(L, &Panic);
+    ++stateId;
 
     lua_pushlightuserdata(L, this);
     lua_setfield(L, LUA_REGISTRYINDEX, ELUNA_STATE_PTR);
@@ -496,7 +516,7 @@ void Eluna::RunScripts()
         }
         // Stack: package, modules, filefunc
         // luaL_loadfile成功后，会入栈函数对象，这里是执行函数(跟JS一样，一个文件相当于一个大的function)
-        if (ExecuteCall(0, 1))
+        if (ExecuteCall(0, 1, PROFILE_EVENT_SCRIPT_LOAD))
         {
             // Stack: package, modules, result
             if (lua_isnoneornil(L, -1) || (lua_isboolean(L, -1) && !lua_toboolean(L, -1)))
@@ -568,7 +588,30 @@ int Eluna::StackTrace(lua_State *_L)
     return 1;
 }
 
-bool Eluna::ExecuteCall(int params, int res)
+int Eluna::Panic(lua_State* _L)
+{
+    ELUNA_LOG_ERROR("[Eluna]: PANIC: unprotected error in call to Lua API (%s)", lua_tostring(_L, -1));
+    return 0;
+}
+
+void* Eluna::LuaAlloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+    if (nsize == 0)
+    {
+        free(ptr);
+        return NULL;
+    }
+
+    // For new blocks osize holds the type of the object, not a size
+    if (!ptr)
+        osize = 0;
+    if (nsize > osize)
+        static_cast<Eluna*>(ud)->allocatedBytes += nsize - osize;
+
+    return realloc(ptr, nsize);
+}
+
+bool Eluna::ExecuteCall(int params, int res, int profileEvent)
 {
     int top = lua_gettop(L);
     int base = top - params;
@@ -583,6 +626,20 @@ bool Eluna::ExecuteCall(int params, int res)
         ASSERT(false); // stack probably corrupt
     }
 
+    ProfileKey profileKey(lua_topointer(L, base), profileEvent);
+    if (profiling && profileEntries.find(profileKey) == profileEntries.end())
+    {
+        lua_Debug ar;
+        lua_pushvalue(L, base);
+        lua_getinfo(L, ">S", &ar);
+
+        std::ostringstream function;
+        function << ar.short_src << ":" << ar.linedefined;
+
+        ProfileEntry entry = { function.str(), profileEvent, 0, 0, 0, 0 };
+        profileEntries[profileKey] = entry;
+    }
+
     bool usetrace = eConfigMgr->GetBoolDefault("Eluna.TraceBack", false);
     if (usetrace)
     {
@@ -592,11 +649,30 @@ bool Eluna::ExecuteCall(int params, int res)
         // Stack: traceback, function, [parameters]
     }
 
+    uint64 allocatedBefore = allocatedBytes;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
     // Objects are invalidated when event_level hits 0
     ++event_level;
     int result = lua_pcall(L, params, res, usetrace ? base : 0);
     --event_level;
 
+    if (profiling)
+    {
+        // Looked up again, the call may have reset the profile
+        std::map<ProfileKey, ProfileEntry>::iterator itr = profileEntries.find(profileKey);
+        if (itr != profileEntries.end())
+        {
+            uint32 us = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+            ProfileEntry& entry = itr->second;
+            ++entry.calls;
+            entry.totalUs += us;
+            entry.maxUs = std::max(entry.maxUs, us);
+            entry.allocatedBytes += allocatedBytes - allocatedBefore;
+        }
+    }
+
     if (usetrace)
     {
         // Stack: traceback, [results or errmsg]
@@ -625,6 +701,59 @@ bool Eluna::ExecuteCall(int params, int res)
     return true;
 }
 
+void Eluna::GetProfileEntries(std::vector<ProfileEntry>& entries)
+{
+    LOCK_ELUNA;
+
+    entries.clear();
+    entries.reserve(profileEntries.size());
+    for (std::map<ProfileKey, ProfileEntry>::const_iterator itr = profileEntries.begin(); itr != profileEntries.end(); ++itr)
+        entries.push_back(itr->second);
+
+    std::sort(entries.begin(), entries.end(), [](ProfileEntry const& a, ProfileEntry const& b) { return a.totalUs > b.totalUs; });
+}
+
+void Eluna::ResetProfile()
+{
+    LOCK_ELUNA;
+    profileEntries.clear();
+}
+
+uint32 Eluna::GetMemoryUsage()
+{
+    LOCK_ELUNA;
+    return L ? uint32(lua_gc(L, LUA_GCCOUNT, 0)) : 0;
+}
+
+void Eluna::LogProfile(uint32 count)
+{
+    std::vector<ProfileEntry> entries;
+    GetProfileEntries(entries);
+
+    if (entries.size() > count)
+        entries.resize(count);
+
+    ELUNA_LOG_INFO("[Eluna]: Lua memory in use %u KB, " UI64FMTD " bytes allocated since load. Slowest %u functions (calls / total us / max us / allocated bytes):",
+        GetMemoryUsage(), allocatedBytes, uint32(entries.size()));
+
+    for (std::vector<ProfileEntry>::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
+        ELUNA_LOG_INFO("[Eluna]:   %s event %d: %u / " UI64FMTD " / %u / " UI64FMTD, itr->function.c_str(), itr->eventId,
+            itr->calls, itr->totalUs, itr->maxUs, itr->allocatedBytes);
+}
+
+void Eluna::UpdateProfileLog(uint32 diff)
+{
+    if (!profiling || !profileLogInterval)
+        return;
+
+    profileLogTimer += diff;
+    if (profileLogTimer < profileLogInterval)
+        return;
+
+    profileLogTimer = 0;
+    LogProfile(10);
+}
+
 void Eluna::Push(lua_State* luastate)
 {
     lua_pushnil(luastate);
@@ -1218,7 +1347,7 @@ int Eluna::CallOneFunction(int number_of_functions, int number_of_arguments, int
     }
     // Stack: event_id, [arguments], [functions], event_id, [arguments]
 
-    ExecuteCall(number_of_arguments, number_of_results);
+    ExecuteCall(number_of_arguments, number_of_results, int(lua_tointeger(L, first_argument_index)));
     --functions_top;
     // Stack: event_id, [arguments], [functions - 1], [results]
 
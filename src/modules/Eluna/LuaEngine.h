@@ -149,6 +149,24 @@ class ELUNA_GAME_API Eluna
 public:
     typedef std::list<LuaScript> ScriptList;
 
+    // Event ids of the profiled calls that are not made for a hook
+    enum ProfileEvent
+    {
+        PROFILE_EVENT_SCRIPT_LOAD   = 0,    // running the body of a script file
+        PROFILE_EVENT_TIMED         = -1,   // timed event registered with RegisterEvent
+        PROFILE_EVENT_QUERY         = -2    // callback of an async database query
+    };
+
+    struct ProfileEntry
+    {
+        std::string function;               // source:line of the function definition
+        int eventId;                        // hook event id or ProfileEvent
+        uint32 calls;
+        uint64 totalUs;
+        uint32 maxUs;
+        uint64 allocatedBytes;              // allocated by the Lua allocator during the calls
+    };
+
     typedef std::recursive_mutex LockType;
     typedef std::lock_guard<LockType> Guard;
 
@@ -179,6 +197,19 @@ private:
     //  this is used to keep track of how many arguments were pushed.
     uint8 push_counter;
     bool enabled;
+    // Incremented each time a Lua state is opened, async query callbacks of a closed state are dropped
+    uint32 stateId;
+
+    // Call statistics of the Lua functions, only recorded with Eluna.Profiling.
+    // Keyed by the function (its address in the Lua state) and the event id it was called for.
+    typedef std::pair<const void*, int> ProfileKey;
+    std::map<ProfileKey, ProfileEntry> profileEntries;
+    bool profiling;
+    // Milliseconds between two profile logs, 0 when only the GM command shows them
+    uint32 profileLogInterval;
+    uint32 profileLogTimer;
+    // Bytes handed out by the Lua allocator since the state was opened
+    uint64 allocatedBytes;
 
     // Map from instance ID -> Lua table ref
     std::unordered_map<uint32, int> instanceDataRefs;
@@ -197,7 +228,8 @@ private:
     void DestroyBindStores();
     void CreateBindStores();
     void InvalidateObjects();
-    bool ExecuteCall(int params, int res);
+    bool ExecuteCall(int params, int res, int profileEvent);
+    void UpdateProfileLog(uint32 diff);
 
     // Use ReloadEluna() to make eluna reload
     // This is called on world update to reload eluna
@@ -210,6 +242,8 @@ private:
     static void AddScriptPath(std::string filename, const std::string& fullpath);
 
     static int StackTrace(lua_State *_L);
+    static int Panic(lua_State* _L);
+    static void* LuaAlloc(void* ud, void* ptr, size_t osize, size_t nsize);
     static void Report(lua_State* _L);
 
     // Some helpers for hooks to call event handlers.
@@ -357,6 +391,16 @@ public:
     bool IsEnabled() const { return enabled && IsInitialized(); }
     bool HasLuaState() const { return L != NULL; }
     uint64 GetCallstackId() const { return callstackid; }
+    uint32 GetStateId() const { return stateId; }
+
+    bool IsProfiling() const { return profiling; }
+    // Fills `entries` with the profiled functions, highest total time first
+    void GetProfileEntries(std::vector<ProfileEntry>& entries);
+    void ResetProfile();
+    // Writes the `count` most expensive functions and the Lua memory use to the server log
+    void LogProfile(uint32 count);
+    // Kilobytes in use by the Lua state
+    uint32 GetMemoryUsage();
     int Register(lua_State* L, uint8 reg, uint32 entry, ObjectGuid guid, uint32 instanceId, uint32 event_id, int functionRef, uint32 shots);
 
     // Checks
@@ -377,6 +421,7 @@ public:
 
     /* Custom */
     void OnTimedEvent(int funcRef, uint32 delay, uint32 calls, WorldObject* obj);
+    void OnQueryResult(int funcRef, uint32 queryStateId, ElunaQuery* result);
     bool OnCommand(Player* player, const char* text);
     void OnWorldUpdate(uint32 diff);
     void OnLootItem(Player* pPlayer, Item* pItem, uint32 count, ObjectGuid guid);
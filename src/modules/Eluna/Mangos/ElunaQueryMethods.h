@@ -336,7 +336,11 @@ namespace LuaQuery
         }
     }
 #else
-            Eluna::Push(L, names[i]);
+            // results of async queries carry no column names, their columns are keyed by index
+            if (i < names.size())
+                Eluna::Push(L, names[i]);
+            else
+                Eluna::Push(L, i);
 
             const char* str = row[i].GetString();
             if (row[i].IsNULL() || !str)
@@ -1405,6 +1405,84 @@ namespace LuaGlobalFunctions
         return 0;
     }
 
+    void OnDBQueryAsyncResult(QueryResult* result, int functionRef, uint32 stateId)
+    {
+        if (!sEluna)
+        {
+            delete result;
+            return;
+        }
+
+        sEluna->OnQueryResult(functionRef, stateId, result ? new ElunaQuery(result, QueryFieldNames()) : NULL);
+    }
+
+    int DBQueryAsync(lua_State* L, Database& db)
+    {
+        const char* query = Eluna::CHECKVAL<const char*>(L, 1);
+        luaL_checktype(L, 2, LUA_TFUNCTION);
+
+        lua_pushvalue(L, 2);
+        int functionRef = luaL_ref(L, LUA_REGISTRYINDEX);
+        if (functionRef == LUA_REFNIL || functionRef == LUA_NOREF)
+            return 0;
+
+        if (!db.AsyncQuery(&OnDBQueryAsyncResult, functionRef, Eluna::GetEluna(L)->GetStateId(), query))
+        {
+            luaL_unref(L, LUA_REGISTRYINDEX, functionRef);
+            return luaL_error(L, "async queries are not available on this database");
+        }
+        return 0;
+    }
+
+    /**
+     * Executes a SQL query on the world database without waiting for it, the result is passed to `callback`.
+     *
+     * The callback is called from the world update after the query has finished, with an [ElunaQuery]
+     *   or nil if no rows were found. Its columns have no names, so [ElunaQuery:GetRow] keys them by index.
+     * The callback is dropped if Eluna is reloaded before the result arrives.
+     *
+     *     WorldDBQueryAsync("SELECT entry, name FROM creature_template LIMIT 10", function(Q)
+     *         if Q then
+     *             repeat
+     *                 print(Q:GetUInt32(0), Q:GetString(1))
+     *             until not Q:NextRow()
+     *         end
+     *     end)
+     *
+     * @param string sql : query to execute
+     * @param function callback : function called with the [ElunaQuery] results or nil
+     */
+    int WorldDBQueryAsync(lua_State* L)
+    {
+        return DBQueryAsync(L, WorldDatabase);
+    }
+
+    /**
+     * Executes a SQL query on the character database without waiting for it, the result is passed to `callback`.
+     *
+     * For details and an example see [Global:WorldDBQueryAsync].
+     *
+     * @param string sql : query to execute
+     * @param function callback : function called with the [ElunaQuery] results or nil
+     */
+    int CharDBQueryAsync(lua_State* L)
+    {
+        return DBQueryAsync(L, CharacterDatabase);
+    }
+
+    /**
+     * Executes a SQL query on the login database without waiting for it, the result is passed to `callback`.
+     *
+     * For details and an example see [Global:WorldDBQueryAsync].
+     *
+     * @param string sql : query to execute
+     * @param function callback : function called with the [ElunaQuery] results or nil
+     */
+    int AuthDBQueryAsync(lua_State* L)
+    {
+        return DBQueryAsync(L, LoginDatabase);
+    }
+
     /**
      * Registers a global timed event.
      *
@@ -3357,10 +3435,13 @@ namespace LuaGlobalFunctions
         { "RunCommand", &LuaGlobalFunctions::RunCommand },
         { "SendWorldMessage", &LuaGlobalFunctions::SendWorldMessage },
         { "WorldDBQuery", &LuaGlobalFunctions::WorldDBQuery },
+        { "WorldDBQueryAsync", &LuaGlobalFunctions::WorldDBQueryAsync },
         { "WorldDBExecute", &LuaGlobalFunctions::WorldDBExecute },
         { "CharDBQuery", &LuaGlobalFunctions::CharDBQuery },
+        { "CharDBQueryAsync", &LuaGlobalFunctions::CharDBQueryAsync },
         { "CharDBExecute", &LuaGlobalFunctions::CharDBExecute },
         { "AuthDBQuery", &LuaGlobalFunctions::AuthDBQuery },
+        { "AuthDBQueryAsync", &LuaGlobalFunctions::AuthDBQueryAsync },
         { "AuthDBExecute", &LuaGlobalFunctions::AuthDBExecute },
         { "CreateLuaEvent", &LuaGlobalFunctions::CreateLuaEvent },
         { "RemoveEventById", &LuaGlobalFunctions::RemoveEventById },
@@ -79,7 +79,37 @@ void Eluna::OnTimedEvent(int funcRef, uint32 delay, uint32 calls, WorldObject* o
     Push(L, obj);
 
     // Call function
-    ExecuteCall(4, 0);
+    ExecuteCall(4, 0, PROFILE_EVENT_TIMED);
+
+    ASSERT(!event_level);
+    InvalidateObjects();
+}
+
+void Eluna::OnQueryResult(int funcRef, uint32 queryStateId, ElunaQuery* result)
+{
+    LOCK_ELUNA;
+
+    // The function belongs to a Lua state closed by a reload
+    if (!L || queryStateId != stateId)
+    {
+        delete result;
+        return;
+    }
+
+    ASSERT(!event_level);
+
+    // Get function, the query only calls it once
+    lua_rawgeti(L, LUA_REGISTRYINDEX, funcRef);
+    luaL_unref(L, LUA_REGISTRYINDEX, funcRef);
+
+    // Push parameters
+    if (result)
+        Push(L, result);
+    else
+        Push(L);
+
+    // Call function
+    ExecuteCall(1, 0, PROFILE_EVENT_QUERY);
 
     ASSERT(!event_level);
     InvalidateObjects();
@@ -322,6 +352,8 @@ void Eluna::OnWorldUpdate(uint32 diff)
 
     eventMgr->globalProcessor->Update(diff);
 
+    UpdateProfileLog(diff);
+
     START_HOOK(WORLD_EVENT_ON_UPDATE);
     Push(diff);
     CallAllFunctions(ServerEventBindings, key);
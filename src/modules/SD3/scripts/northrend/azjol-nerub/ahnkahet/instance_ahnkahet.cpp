@@ -471,7 +471,7 @@ struct is_ahnkahet : public InstanceScript
         void HandleInsanitySwitch(Player* pPlayer)
         {
             // Get the phase aura id
-            std::list<Aura*> lAuraList = pPlayer->GetAurasByType(SPELL_AURA_PHASE);
+            Unit::AuraList const& lAuraList = pPlayer->GetAurasByType(SPELL_AURA_PHASE);
             if (lAuraList.empty())
             {
                 return;
@@ -509,7 +509,7 @@ struct is_ahnkahet : public InstanceScript
             Player* pNewPlayer = vOtherPhasePlayers[urand(0, vOtherPhasePlayers.size() - 1)];
 
             // Get the phase aura id
-            std::list<Aura*> lNewAuraList = pNewPlayer->GetAurasByType(SPELL_AURA_PHASE);
+            Unit::AuraList const& lNewAuraList = pNewPlayer->GetAurasByType(SPELL_AURA_PHASE);
             if (lNewAuraList.empty())
             {
                 return;
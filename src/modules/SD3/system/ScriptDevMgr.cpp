@@ -172,6 +172,31 @@ void Script::RegisterSelf(bool bReportError)
 //************************************
 //*** Functions to be used by core ***
 
+// m_scripts is indexed by script id, hooks a script turned out not to implement are skipped without the virtual call
+static CreatureScript* GetCreatureScript(uint32 scriptId, ScriptHook hook)
+{
+    Script* pScript = m_scripts[scriptId];
+    return pScript && pScript->HasHook(hook) ? pScript->ToCreatureScript() : nullptr;
+}
+
+static GameObjectScript* GetGameObjectScript(uint32 scriptId, ScriptHook hook)
+{
+    Script* pScript = m_scripts[scriptId];
+    return pScript && pScript->HasHook(hook) ? pScript->ToGameObjectScript() : nullptr;
+}
+
+static ItemScript* GetItemScript(uint32 scriptId, ScriptHook hook)
+{
+    Script* pScript = m_scripts[scriptId];
+    return pScript && pScript->HasHook(hook) ? pScript->ToItemScript() : nullptr;
+}
+
+static AreaTriggerScript* GetAreaTriggerScript(uint32 scriptId, ScriptHook hook)
+{
+    Script* pScript = m_scripts[scriptId];
+    return pScript && pScript->HasHook(hook) ? pScript->ToAreaTriggerScript() : nullptr;
+}
+
 void SD3::FreeScriptLibrary()
 {
     // Free Spell Summary
@@ -239,37 +264,37 @@ char const* SD3::GetScriptLibraryVersion()
 
 bool SD3::GossipHello(Player* pPlayer, Creature* pCreature)
 {
-    Script* pTempScript = m_scripts[pCreature->GetScriptId()];
+    CreatureScript* pTempScript = GetCreatureScript(pCreature->GetScriptId(), SCRIPT_HOOK_GOSSIP_HELLO);
 
-    if (!pTempScript || !pTempScript->ToCreatureScript())
+    if (!pTempScript)
     {
         return false;
     }
 
     //pPlayer->PlayerTalkClass->ClearMenus();
 
-    return pTempScript->ToCreatureScript()->OnGossipHello(pPlayer, pCreature);
+    return pTempScript->OnGossipHello(pPlayer, pCreature);
 }
 
 bool SD3::GOGossipHello(Player* pPlayer, GameObject* pGo)
 {
-    Script* pTempScript = m_scripts[pGo->GetScriptId()];
+    GameObjectScript* pTempScript = GetGameObjectScript(pGo->GetScriptId(), SCRIPT_HOOK_GOSSIP_HELLO);
 
-    if (!pTempScript || !pTempScript->ToGameObjectScript())
+    if (!pTempScript)
     {
         return false;
     }
 
     //pPlayer->PlayerTalkClass->ClearMenus();
 
-    return pTempScript->ToGameObjectScript()->OnGossipHello(pPlayer, pGo);
+    return pTempScript->OnGossipHello(pPlayer, pGo);
 }
 
 bool SD3::ItemGossipHello(Player* pPlayer, Item* pItem)
 {
-    Script* pTempScript = m_scripts[pItem->GetScriptId()];
+    ItemScript* pTempScript = GetItemScript(pItem->GetScriptId(), SCRIPT_HOOK_GOSSIP_HELLO);
 
-    if (!pTempScript || !pTempScript->ToItemScript())
+    if (!pTempScript)
     {
         return false;
     }
@@ -277,7 +302,7 @@ bool SD3::ItemGossipHello(Player* pPlayer, Item* pItem)
     // Clear menus
     pPlayer->PlayerTalkClass->ClearMenus();
 
-    return pTempScript->ToItemScript()->OnGossipHello(pPlayer, pItem);
+    return pTempScript->OnGossipHello(pPlayer, pItem);
 }
 
 
@@ -285,218 +310,218 @@ bool SD3::GossipSelect(Player* pPlayer, Creature* pCreature, uint32 uiSender, ui
 {
     debug_log("[SD3]: Gossip selection, sender: %u, action: %u", uiSender, uiAction);
 
-    Script* pTempScript = m_scripts[pCreature->GetScriptId()];
+    CreatureScript* pTempScript = GetCreatureScript(pCreature->GetScriptId(), SCRIPT_HOOK_GOSSIP_SELECT);
 
-    if (!pTempScript || !pTempScript->ToCreatureScript())
+    if (!pTempScript)
     {
         return false;
     }
 
-    return pTempScript->ToCreatureScript()->OnGossipSelect(pPlayer, pCreature, uiSender, uiAction);
+    return pTempScript->OnGossipSelect(pPlayer, pCreature, uiSender, uiAction);
 }
 
 bool SD3::GOGossipSelect(Player* pPlayer, GameObject* pGo, uint32 uiSender, uint32 uiAction)
 {
     debug_log("[SD3]: GO Gossip selection, sender: %u, action: %u", uiSender, uiAction);
 
-    Script* pTempScript = m_scripts[pGo->GetScriptId()];
+    GameObjectScript* pTempScript = GetGameObjectScript(pGo->GetScriptId(), SCRIPT_HOOK_GOSSIP_SELECT);
 
-    if (!pTempScript || !pTempScript->ToGameObjectScript())
+    if (!pTempScript)
     {
         return false;
     }
 
-    return pTempScript->ToGameObjectScript()->OnGossipSelect(pPlayer, pGo, uiSender, uiAction);
+    return pTempScript->OnGossipSelect(pPlayer, pGo, uiSender, uiAction);
 }
 
 bool SD3::ItemGossipSelect(Player* pPlayer, Item* pItem, uint32 uiSender, uint32 uiAction)
 {
     debug_log("[SD3]: ITEM Gossip selection, sender: %u, action: %u", uiSender, uiAction);
 
-    Script* pTempScript = m_scripts[pItem->GetScriptId()];
+    ItemScript* pTempScript = GetItemScript(pItem->GetScriptId(), SCRIPT_HOOK_GOSSIP_SELECT);
 
-    if (!pTempScript || !pTempScript->ToItemScript())
+    if (!pTempScript)
     {
         return false;
     }
 
-    return pTempScript->ToItemScript()->OnGossipSelect(pPlayer, pItem, uiSender, uiAction);
+    return pTempScript->OnGossipSelect(pPlayer, pItem, uiSender, uiAction);
 }
 
 bool SD3::GossipSelectWithCode(Player* pPlayer, Creature* pCreature, uint32 uiSender, uint32 uiAction, const char* sCode)
 {
     debug_log("[SD3]: Gossip selection with code, sender: %u, action: %u", uiSender, uiAction);
 
-    Script* pTempScript = m_scripts[pCreature->GetScriptId()];
+    CreatureScript* pTempScript = GetCreatureScript(pCreature->GetScriptId(), SCRIPT_HOOK_GOSSIP_SELECT_CODE);
 
-    if (!pTempScript || !pTempScript->ToCreatureScript())
+    if (!pTempScript)
     {
         return false;
     }
 
-    return pTempScript->ToCreatureScript()->OnGossipSelectWithCode(pPlayer, pCreature, uiSender, uiAction, sCode);
+    return pTempScript->OnGossipSelectWithCode(pPlayer, pCreature, uiSender, uiAction, sCode);
 }
 
 bool SD3::GOGossipSelectWithCode(Player* pPlayer, GameObject* pGo, uint32 uiSender, uint32 uiAction, const char* sCode)
 {
     debug_log("[SD3]: GO Gossip selection with code, sender: %u, action: %u", uiSender, uiAction);
 
-    Script* pTempScript = m_scripts[pGo->GetScriptId()];
+    GameObjectScript* pTempScript = GetGameObjectScript(pGo->GetScriptId(), SCRIPT_HOOK_GOSSIP_SELECT_CODE);
 
-    if (!pTempScript || !pTempScript->ToGameObjectScript())
+    if (!pTempScript)
     {
         return false;
     }
 
-    return pTempScript->ToGameObjectScript()->OnGossipSelectWithCode(pPlayer, pGo, uiSender, uiAction, sCode);
+    return pTempScript->OnGossipSelectWithCode(pPlayer, pGo, uiSender, uiAction, sCode);
 }
 
 bool SD3::ItemGossipSelectWithCode(Player* pPlayer, Item* pItem, uint32 uiSender, uint32 uiAction, const char* sCode)
 {
     debug_log("[SD3]: ITEM Gossip selection with code, sender: %u, action: %u, code : %s", uiSender, uiAction, sCode);
 
-    Script* pTempScript = m_scripts[pItem->GetScriptId()];
+    ItemScript* pTempScript = GetItemScript(pItem->GetScriptId(), SCRIPT_HOOK_GOSSIP_SELECT_CODE);
 
-    if (!pTempScript || !pTempScript->ToItemScript())
+    if (!pTempScript)
     {
         return false;
     }
 
-    return pTempScript->ToItemScript()->OnGossipSelectWithCode(pPlayer, pItem, uiSender, uiAction, sCode);
+    return pTempScript->OnGossipSelectWithCode(pPlayer, pItem, uiSender, uiAction, sCode);
 }
 
 bool SD3::QuestAccept(Player* pPlayer, Creature* pCreature, const Quest* pQuest)
 {
-    Script* pTempScript = m_scripts[pCreature->GetScriptId()];
+    CreatureScript* pTempScript = GetCreatureScript(pCreature->GetScriptId(), SCRIPT_HOOK_QUEST_ACCEPT);
 
-    if (!pTempScript || !pTempScript->ToCreatureScript())
+    if (!pTempScript)
     {
         return false;
     }
 
     //pPlayer->PlayerTalkClass->ClearMenus();
 
-    return pTempScript->ToCreatureScript()->OnQuestAccept(pPlayer, pCreature, pQuest);
+    return pTempScript->OnQuestAccept(pPlayer, pCreature, pQuest);
 }
 
 bool SD3::QuestRewarded(Player* pPlayer, Creature* pCreature, Quest const* pQuest)
 {
-    Script* pTempScript = m_scripts[pCreature->GetScriptId()];
+    CreatureScript* pTempScript = GetCreatureScript(pCreature->GetScriptId(), SCRIPT_HOOK_QUEST_REWARDED);
 
-    if (!pTempScript || !pTempScript->ToCreatureScript())
+    if (!pTempScript)
     {
         return false;
     }
 
     //pPlayer->PlayerTalkClass->ClearMenus();
 
-    return pTempScript->ToCreatureScript()->OnQuestRewarded(pPlayer, pCreature, pQuest);
+    return pTempScript->OnQuestRewarded(pPlayer, pCreature, pQuest);
 }
 
 uint32 SD3::GetNPCDialogStatus(Player* pPlayer, Creature* pCreature)
 {
-    Script* pTempScript = m_scripts[pCreature->GetScriptId()];
+    CreatureScript* pTempScript = GetCreatureScript(pCreature->GetScriptId(), SCRIPT_HOOK_DIALOG_STATUS);
 
-    if (!pTempScript || !pTempScript->ToCreatureScript())
+    if (!pTempScript)
     {
         return DIALOG_STATUS_UNDEFINED;
     }
 
     //pPlayer->PlayerTalkClass->ClearMenus();
 
-    return pTempScript->ToCreatureScript()->OnDialogEnd(pPlayer, pCreature);
+    return pTempScript->OnDialogEnd(pPlayer, pCreature);
 }
 
 uint32 SD3::GetGODialogStatus(Player* pPlayer, GameObject* pGo)
 {
-    Script* pTempScript = m_scripts[pGo->GetScriptId()];
+    GameObjectScript* pTempScript = GetGameObjectScript(pGo->GetScriptId(), SCRIPT_HOOK_DIALOG_STATUS);
 
-    if (!pTempScript || !pTempScript->ToGameObjectScript())
+    if (!pTempScript)
     {
         return DIALOG_STATUS_UNDEFINED;
     }
 
     //pPlayer->PlayerTalkClass->ClearMenus();
 
-    return pTempScript->ToGameObjectScript()->OnDialogEnd(pPlayer, pGo);
+    return pTempScript->OnDialogEnd(pPlayer, pGo);
 }
 
 bool SD3::ItemQuestAccept(Player* pPlayer, Item* pItem, Quest const* pQuest)
 {
-    Script* pTempScript = m_scripts[pItem->GetScriptId()];
+    ItemScript* pTempScript = GetItemScript(pItem->GetScriptId(), SCRIPT_HOOK_QUEST_ACCEPT);
 
-    if (!pTempScript || !pTempScript->ToItemScript())
+    if (!pTempScript)
     {
         return false;
     }
 
     //pPlayer->PlayerTalkClass->ClearMenus();
 
-    return pTempScript->ToItemScript()->OnQuestAccept(pPlayer, pItem, pQuest);
+    return pTempScript->OnQuestAccept(pPlayer, pItem, pQuest);
 }
 
 bool SD3::GOUse(Player* pPlayer, GameObject* pGo)
 {
-    Script* pTempScript = m_scripts[pGo->GetScriptId()];
+    GameObjectScript* pTempScript = GetGameObjectScript(pGo->GetScriptId(), SCRIPT_HOOK_USE);
 
-    if (!pTempScript || !pTempScript->ToGameObjectScript())
+    if (!pTempScript)
     {
         return false;
     }
 
-    return pTempScript->ToGameObjectScript()->OnUse(pPlayer, pGo);
+    return pTempScript->OnUse(pPlayer, pGo);
 }
 
 bool SD3::GOUse(Unit* pUnit, GameObject* pGo)
 {
-    Script* pTempScript = m_scripts[pGo->GetScriptId()];
+    GameObjectScript* pTempScript = GetGameObjectScript(pGo->GetScriptId(), SCRIPT_HOOK_USE_BY_UNIT);
 
-    if (!pTempScript || !pTempScript->ToGameObjectScript())
+    if (!pTempScript)
     {
         return false;
     }
 
-    return pTempScript->ToGameObjectScript()->OnUse(pUnit, pGo);
+    return pTempScript->OnUse(pUnit, pGo);
 }
 
 bool SD3::GOQuestAccept(Player* pPlayer, GameObject* pGo, const Quest* pQuest)
 {
-    Script* pTempScript = m_scripts[pGo->GetScriptId()];
+    GameObjectScript* pTempScript = GetGameObjectScript(pGo->GetScriptId(), SCRIPT_HOOK_QUEST_ACCEPT);
 
-    if (!pTempScript || !pTempScript->ToGameObjectScript())
+    if (!pTempScript)
     {
         return false;
     }
 
     //pPlayer->PlayerTalkClass->ClearMenus();
 
-    return pTempScript->ToGameObjectScript()->OnQuestAccept(pPlayer, pGo, pQuest);
+    return pTempScript->OnQuestAccept(pPlayer, pGo, pQuest);
 }
 
 bool SD3::GOQuestRewarded(Player* pPlayer, GameObject* pGo, Quest const* pQuest)
 {
-    Script* pTempScript = m_scripts[pGo->GetScriptId()];
+    GameObjectScript* pTempScript = GetGameObjectScript(pGo->GetScriptId(), SCRIPT_HOOK_QUEST_REWARDED);
 
-    if (!pTempScript || !pTempScript->ToGameObjectScript())
+    if (!pTempScript)
     {
         return false;
     }
 
     //pPlayer->PlayerTalkClass->ClearMenus();
 
-    return pTempScript->ToGameObjectScript()->OnQuestRewarded(pPlayer, pGo, pQuest);
+    return pTempScript->OnQuestRewarded(pPlayer, pGo, pQuest);
 }
 
 bool SD3::AreaTrigger(Player* pPlayer, AreaTriggerEntry const* atEntry)
 {
-    Script* pTempScript = m_scripts[sScriptMgr.GetBoundScriptId(SCRIPTED_AREATRIGGER, atEntry->id)];
+    AreaTriggerScript* pTempScript = GetAreaTriggerScript(sScriptMgr.GetBoundScriptId(SCRIPTED_AREATRIGGER, atEntry->id), SCRIPT_HOOK_TRIGGER);
 
-    if (!pTempScript || !pTempScript->ToAreaTriggerScript())
+    if (!pTempScript)
     {
         return false;
     }
 
-    return pTempScript->ToAreaTriggerScript()->OnTrigger(pPlayer, atEntry);
+    return pTempScript->OnTrigger(pPlayer, atEntry);
 }
 
 bool SD3::NpcSpellClick(Player* pPlayer, Creature* pClickedCreature, uint32 uiSpellId)
@@ -527,14 +552,14 @@ bool SD3::ProcessEvent(uint32 uiEventId, Object* pSource, Object* pTarget, bool
 
 CreatureAI* SD3::GetCreatureAI(Creature* pCreature)
 {
-    Script* pTempScript = m_scripts[pCreature->GetScriptId()];
+    CreatureScript* pTempScript = GetCreatureScript(pCreature->GetScriptId(), SCRIPT_HOOK_GET_AI);
 
-    if (!pTempScript || !pTempScript->ToCreatureScript())
+    if (!pTempScript)
     {
         return nullptr;
     }
 
-    CreatureAI* ai = pTempScript->ToCreatureScript()->GetAI(pCreature);
+    CreatureAI* ai = pTempScript->GetAI(pCreature);
     if (ai)
     {
         ai->Reset();
@@ -545,28 +570,28 @@ CreatureAI* SD3::GetCreatureAI(Creature* pCreature)
 
 GameObjectAI* SD3::GetGameObjectAI(GameObject* pGo)
 {
-    Script* pTempScript = m_scripts[pGo->GetScriptId()];
+    GameObjectScript* pTempScript = GetGameObjectScript(pGo->GetScriptId(), SCRIPT_HOOK_GET_AI);
 
-    if (!pTempScript || !pTempScript->ToGameObjectScript())
+    if (!pTempScript)
     {
         return nullptr;
     }
 
-    GameObjectAI * goAI = pTempScript->ToGameObjectScript()->GetAI(pGo);
+    GameObjectAI * goAI = pTempScript->GetAI(pGo);
 
     return goAI;
 }
 
 bool SD3::ItemUse(Player* pPlayer, Item* pItem, SpellCastTargets const& targets)
 {
-    Script* pTempScript = m_scripts[pItem->GetScriptId()];
+    ItemScript* pTempScript = GetItemScript(pItem->GetScriptId(), SCRIPT_HOOK_USE);
 
-    if (!pTempScript || !pTempScript->ToItemScript())
+    if (!pTempScript)
     {
         return false;
     }
 
-    return pTempScript->ToItemScript()->OnUse(pPlayer, pItem, targets);
+    return pTempScript->OnUse(pPlayer, pItem, targets);
 }
 
 bool SD3::ItemEquip(Player* pPlayer, Item* pItem, bool on)
@@ -27,6 +27,8 @@
 #ifndef SC_SCRIPTMGR_H
 #define SC_SCRIPTMGR_H
 
+#include <atomic>
+
 #include "Common.h"
 #include "DBCStructure.h"
 #include "ScriptMgr.h"
@@ -149,10 +151,26 @@ struct AuraScript;
 struct ConditionScript;
 struct AchievementScript;
 
+// Hooks the core calls often, a script whose base implementation got called does not implement it and is skipped afterwards
+enum ScriptHook
+{
+    SCRIPT_HOOK_GOSSIP_HELLO            = 0,
+    SCRIPT_HOOK_GOSSIP_SELECT           = 1,
+    SCRIPT_HOOK_GOSSIP_SELECT_CODE      = 2,
+    SCRIPT_HOOK_QUEST_ACCEPT            = 3,
+    SCRIPT_HOOK_QUEST_REWARDED          = 4,
+    SCRIPT_HOOK_DIALOG_STATUS           = 5,
+    SCRIPT_HOOK_USE                     = 6,
+    SCRIPT_HOOK_USE_BY_UNIT             = 7,
+    SCRIPT_HOOK_TRIGGER                 = 8,
+    SCRIPT_HOOK_GET_AI                  = 9,
+};
+
 struct Script
 {
     std::string Name;
     ScriptedObjectType Type;
+    std::atomic<uint32> UnusedHooks;
 
     /**
      * @brief 注册自身的指针到脚本管理器
@@ -161,8 +179,11 @@ struct Script
     void RegisterSelf(bool bReportError = true);
     virtual bool IsValid() { return true; }
 
-    Script() : Name(""), Type(SCRIPTED_MAX_TYPE) {}
-    Script(ScriptedObjectType type, const char* name) : Name(name), Type(type) {}
+    bool HasHook(ScriptHook hook) const { return !(UnusedHooks.load(std::memory_order_relaxed) & (1 << hook)); }
+    void MarkHookUnused(ScriptHook hook) { UnusedHooks.fetch_or(1 << hook, std::memory_order_relaxed); }
+
+    Script() : Name(""), Type(SCRIPTED_MAX_TYPE), UnusedHooks(0) {}
+    Script(ScriptedObjectType type, const char* name) : Name(name), Type(type), UnusedHooks(0) {}
 
     CreatureScript* ToCreatureScript() { return Type == SCRIPTED_UNIT && IsValid() ? (CreatureScript*)this : nullptr; }
     GameObjectScript* ToGameObjectScript() { return Type == SCRIPTED_GAMEOBJECT && IsValid() ? (GameObjectScript*)this : nullptr; }
@@ -183,10 +204,10 @@ struct CreatureScript : public Script
 {
     CreatureScript(const char* name) : Script(SCRIPTED_UNIT, name) {}
 
-    virtual bool OnGossipHello(Player*, Creature*) { return false; }
-    virtual bool OnGossipSelect(Player*, Creature*, uint32, uint32) { return false; }
-    virtual bool OnGossipSelectWithCode(Player*, Creature*, uint32, uint32, const char*) { return false; }
-    virtual uint32 OnDialogEnd(Player*, Creature*) { return DIALOG_STATUS_UNDEFINED; }
+    virtual bool OnGossipHello(Player*, Creature*) { MarkHookUnused(SCRIPT_HOOK_GOSSIP_HELLO); return false; }
+    virtual bool OnGossipSelect(Player*, Creature*, uint32, uint32) { MarkHookUnused(SCRIPT_HOOK_GOSSIP_SELECT); return false; }
+    virtual bool OnGossipSelectWithCode(Player*, Creature*, uint32, uint32, const char*) { MarkHookUnused(SCRIPT_HOOK_GOSSIP_SELECT_CODE); return false; }
+    virtual uint32 OnDialogEnd(Player*, Creature*) { MarkHookUnused(SCRIPT_HOOK_DIALOG_STATUS); return DIALOG_STATUS_UNDEFINED; }
     /**
      * @brief 玩家接受任务时回调
      * @param 接受任务的玩家
@@ -194,7 +215,7 @@ struct CreatureScript : public Script
      * @param 任务数据
      * @return 
      */
-    virtual bool OnQuestAccept(Player*, Creature*, Quest const*) { return false; }
+    virtual bool OnQuestAccept(Player*, Creature*, Quest const*) { MarkHookUnused(SCRIPT_HOOK_QUEST_ACCEPT); return false; }
     /**
      * @brief 接受任务奖励时回调
      * @param  奖励玩家
@@ -202,7 +223,7 @@ struct CreatureScript : public Script
      * @param  任务数据
      * @return 
      */
-    virtual bool OnQuestRewarded(Player*, Creature*, Quest const*) { return false; }
+    virtual bool OnQuestRewarded(Player*, Creature*, Quest const*) { MarkHookUnused(SCRIPT_HOOK_QUEST_REWARDED); return false; }
     virtual bool OnSpellClick(Player*, Creature*, uint32) { return false; }
 
     /**
@@ -210,43 +231,43 @@ struct CreatureScript : public Script
      * @param  
      * @return 
      */
-    virtual CreatureAI* GetAI(Creature*) { return nullptr; }
+    virtual CreatureAI* GetAI(Creature*) { MarkHookUnused(SCRIPT_HOOK_GET_AI); return nullptr; }
 };
 
 struct GameObjectScript : public Script
 {
     GameObjectScript(const char* name) : Script(SCRIPTED_GAMEOBJECT, name) {}
 
-    virtual bool OnGossipHello(Player*, GameObject*) { return false; }
-    virtual bool OnGossipSelect(Player*, GameObject*, uint32, uint32) { return false; }
-    virtual bool OnGossipSelectWithCode(Player*, GameObject*, uint32, uint32, const char*) { return false; }
-    virtual uint32 OnDialogEnd(Player*, GameObject*) { return DIALOG_STATUS_UNDEFINED; }
-    virtual bool OnQuestAccept(Player*, GameObject*, Quest const*) { return false; }
-    virtual bool OnQuestRewarded(Player*, GameObject*, Quest const*) { return false; }
-    virtual bool OnUse(Player*, GameObject*) { return false; }
-    virtual bool OnUse(Unit*, GameObject*) { return false; }
+    virtual bool OnGossipHello(Player*, GameObject*) { MarkHookUnused(SCRIPT_HOOK_GOSSIP_HELLO); return false; }
+    virtual bool OnGossipSelect(Player*, GameObject*, uint32, uint32) { MarkHookUnused(SCRIPT_HOOK_GOSSIP_SELECT); return false; }
+    virtual bool OnGossipSelectWithCode(Player*, GameObject*, uint32, uint32, const char*) { MarkHookUnused(SCRIPT_HOOK_GOSSIP_SELECT_CODE); return false; }
+    virtual uint32 OnDialogEnd(Player*, GameObject*) { MarkHookUnused(SCRIPT_HOOK_DIALOG_STATUS); return DIALOG_STATUS_UNDEFINED; }
+    virtual bool OnQuestAccept(Player*, GameObject*, Quest const*) { MarkHookUnused(SCRIPT_HOOK_QUEST_ACCEPT); return false; }
+    virtual bool OnQuestRewarded(Player*, GameObject*, Quest const*) { MarkHookUnused(SCRIPT_HOOK_QUEST_REWARDED); return false; }
+    virtual bool OnUse(Player*, GameObject*) { MarkHookUnused(SCRIPT_HOOK_USE); return false; }
+    virtual bool OnUse(Unit*, GameObject*) { MarkHookUnused(SCRIPT_HOOK_USE_BY_UNIT); return false; }
 
-    virtual GameObjectAI* GetAI(GameObject*) { return nullptr; }
+    virtual GameObjectAI* GetAI(GameObject*) { MarkHookUnused(SCRIPT_HOOK_GET_AI); return nullptr; }
 };
 
 struct ItemScript : public Script
 {
     ItemScript(const char* name) : Script(SCRIPTED_ITEM, name) {}
 
-    virtual bool OnQuestAccept(Player*, Item*, Quest const*) { return false; }
-    virtual bool OnUse(Player*, Item*, SpellCastTargets const&) { return false; }
+    virtual bool OnQuestAccept(Player*, Item*, Quest const*) { MarkHookUnused(SCRIPT_HOOK_QUEST_ACCEPT); return false; }
+    virtual bool OnUse(Player*, Item*, SpellCastTargets const&) { MarkHookUnused(SCRIPT_HOOK_USE); return false; }
     virtual bool OnEquip(Player*, Item*, bool on) { return false; }
     virtual bool OnDelete(Player*, Item*) { return false; }
-    virtual bool OnGossipHello(Player*, Item*) { return false; }
-    virtual bool OnGossipSelect(Player*, Item*, uint32, uint32) { return false; }
-    virtual bool OnGossipSelectWithCode(Player*, Item*, uint32, uint32, const char*) { return false; }
+    virtual bool OnGossipHello(Player*, Item*) { MarkHookUnused(SCRIPT_HOOK_GOSSIP_HELLO); return false; }
+    virtual bool OnGossipSelect(Player*, Item*, uint32, uint32) { MarkHookUnused(SCRIPT_HOOK_GOSSIP_SELECT); return false; }
+    virtual bool OnGossipSelectWithCode(Player*, Item*, uint32, uint32, const char*) { MarkHookUnused(SCRIPT_HOOK_GOSSIP_SELECT_CODE); return false; }
 };
 
 struct AreaTriggerScript : public Script
 {
     AreaTriggerScript(const char* name) : Script(SCRIPTED_AREATRIGGER, name) {}
 
-    virtual bool OnTrigger(Player*, AreaTriggerEntry const*) { return false; }
+    virtual bool OnTrigger(Player*, AreaTriggerEntry const*) { MarkHookUnused(SCRIPT_HOOK_TRIGGER); return false; }
 };
 
 struct MapEventScript : public Script
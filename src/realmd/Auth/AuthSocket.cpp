@@ -33,6 +33,7 @@
 #include "Realm/RealmList.h"
 #include "AuthSocket.h"
 #include "AuthCodes.h"
+#include "AuthWorkerPool.h"
 #include "Patch/PatchHandler.h"
 
 #include <openssl/md5.h>
@@ -142,7 +143,8 @@ typedef struct AuthHandler
 
 
 /// Constructor - set the N and g values for SRP6
-AuthSocket::AuthSocket() : _status(STATUS_CHALLENGE), _accountSecurityLevel(SEC_PLAYER), _build(0), patch_(ACE_INVALID_HANDLE)
+AuthSocket::AuthSocket() : _status(STATUS_CHALLENGE), _accountSecurityLevel(SEC_PLAYER), _build(0), patch_(ACE_INVALID_HANDLE),
+    _pendingWork(NULL), _destroyPending(false)
 {
     N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
     g.SetDword(7);
@@ -183,6 +185,12 @@ void AuthSocket::OnRead()
 
     while (1)
     {
+        // the rest of the input waits for the reply of the logon workers
+        if (_pendingWork)
+        {
+            return;
+        }
+
         if (!recv_soft((char*)&_cmd, 1))
         {
             return;
@@ -221,6 +229,68 @@ void AuthSocket::OnRead()
     }
 }
 
+void AuthSocket::destroy()
+{
+    {
+        ACE_GUARD(LockType, guard, lock_);
+        if (_pendingWork)
+        {
+            _destroyPending = true;
+            return;
+        }
+    }
+
+    BufferedSocket::destroy();
+}
+
+void AuthSocket::QueueWork(PendingWork work)
+{
+    _pendingWork = work;
+    _pendingReply.clear();
+
+    sAuthWorkerPool.Enqueue(this);
+}
+
+void AuthSocket::RunPendingWork()
+{
+    (this->*_pendingWork)();
+}
+
+void AuthSocket::CompletePendingWork(bool async)
+{
+    {
+        // another network thread may be in handle_input or destroy() of this socket
+        ACE_GUARD(LockType, guard, lock_);
+
+        _pendingWork = NULL;
+        _pendingRequest.clear();
+
+        if (!_destroyPending)
+        {
+            if (!_pendingReply.empty())
+            {
+                send((char const*)_pendingReply.contents(), _pendingReply.size());
+                _pendingReply.clear();
+            }
+
+            // with inline work OnRead still runs and goes on by itself
+            if (async)
+            {
+                OnRead();
+            }
+            return;
+        }
+    }
+
+    // the guard is released before the socket is gone
+    BufferedSocket::destroy();
+}
+
+void AuthSocket::QueueReply(const char* buf, size_t len)
+{
+    _pendingReply.append(buf, len);
+}
+
 /// Make the SRP6 calculation from hash in dB
 void AuthSocket::_SetVSFields(const std::string& rI)
 {
@@ -269,7 +339,7 @@ void AuthSocket::SendProof(Sha1Hash sha)
             proof.error = 0;
             proof.unk2 = 0x00;
 
-            send((char*)&proof, sizeof(proof));
+            QueueReply((char*)&proof, sizeof(proof));
             break;
         }
         case 8606:                                          // 2.4.3
@@ -291,7 +361,7 @@ void AuthSocket::SendProof(Sha1Hash sha)
             proof.surveyId = 0x00000000;
             proof.unkFlags = 0x0000;
 
-            send((char*)&proof, sizeof(proof));
+            QueueReply((char*)&proof, sizeof(proof));
             break;
         }
     }
@@ -347,8 +417,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
     _os = (const char*)ch->os;
@@ -369,6 +437,22 @@ bool AuthSocket::_HandleLogonChallenge()
     _safelogin = _login;
     LoginDatabase.escape_string(_safelogin);
 
+    _localizationName.resize(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        _localizationName[i] = ch->country[4 - i - 1];
+    }
+
+    ///- Account lookups and the SRP6 calculation are done by the logon workers
+    QueueWork(&AuthSocket::_LogonChallengeWork);
+    return true;
+}
+
+/// Logon Challenge lookups and SRP6 calculation, run by a logon worker
+void AuthSocket::_LogonChallengeWork()
+{
+    ByteBuffer pkt;
+
     pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
     pkt << (uint8) 0x00;
 
@@ -507,13 +591,7 @@ bool AuthSocket::_HandleLogonChallenge()
                     uint8 secLevel = (*result)[4].GetUInt8();
                     _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
 
-                    _localizationName.resize(4);
-                    for (int i = 0; i < 4; ++i)
-                    {
-                        _localizationName[i] = ch->country[4 - i - 1];
-                    }
-
-                    BASIC_LOG("[AuthChallenge] account %s is using '%c%c%c%c' locale (%u)", _login.c_str(), ch->country[3], ch->country[2], ch->country[1], ch->country[0], GetLocaleByName(_localizationName));
+                    BASIC_LOG("[AuthChallenge] account %s is using '%s' locale (%u)", _login.c_str(), _localizationName.c_str(), GetLocaleByName(_localizationName));
 
                     _status = STATUS_LOGON_PROOF;
                 }
@@ -525,8 +603,7 @@ bool AuthSocket::_HandleLogonChallenge()
             pkt << (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
         }
     }
-    send((char const*)pkt.contents(), pkt.size());
-    return true;
+    QueueReply((char const*)pkt.contents(), pkt.size());
 }
 
 /// Logon Proof command handler
@@ -610,6 +687,17 @@ bool AuthSocket::_HandleLogonProof()
     }
     /// </ul>
 
+    ///- The SRP6 calculation is continued by the logon workers
+    _pendingRequest.assign((uint8 const*)&lp, (uint8 const*)&lp + sizeof(lp));
+    QueueWork(&AuthSocket::_LogonProofWork);
+    return true;
+}
+
+/// Logon Proof SRP6 calculation and account update, run by a logon worker
+void AuthSocket::_LogonProofWork()
+{
+    sAuthLogonProof_C const& lp = *(sAuthLogonProof_C const*)&_pendingRequest[0];
+
     ///- Continue the SRP6 calculation based on data received from the client
     BigNumber A;
 
@@ -618,7 +706,7 @@ bool AuthSocket::_HandleLogonProof()
     // SRP safeguard: abort if A==0
     if ((A % N).isZero())
     {
-        return false;
+        return;
     }
 
     Sha1Hash sha;
@@ -712,13 +800,13 @@ bool AuthSocket::_HandleLogonProof()
         if (_build > 6005)                                  // > 1.12.2
         {
             char data[4] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT, 3, 0};
-            send(data, sizeof(data));
+            QueueReply(data, sizeof(data));
         }
         else
         {
             // 1.x not react incorrectly at 4-byte message use 3 as real error
             char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT};
-            send(data, sizeof(data));
+            QueueReply(data, sizeof(data));
         }
         BASIC_LOG("[AuthChallenge] account %s tried to login with wrong password!", _login.c_str());
 
@@ -760,7 +848,6 @@ bool AuthSocket::_HandleLogonProof()
             }
         }
     }
-    return true;
 }
 
 /// Reconnect Challenge command handler
@@ -948,12 +1035,17 @@ bool AuthSocket::_HandleRealmList()
     std::string rI = (*result)[1].GetCppString();
     delete result;
 
-    ///- Update realm list if need
-    sRealmList.UpdateIfNeed();
-
-    ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
     ByteBuffer pkt;
-    LoadRealmlist(pkt, id);
+    {
+        // the realm list and the cached character counts are shared by all network threads
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, sRealmList.GetLock(), false);
+
+        ///- Update realm list if need
+        sRealmList.UpdateIfNeed();
+
+        ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
+        LoadRealmlist(pkt, id);
+    }
 
     ByteBuffer hdr;
     hdr << (uint8) CMD_REALM_LIST;
@@ -966,9 +1058,8 @@ bool AuthSocket::_HandleRealmList()
 
 void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
 {
-    RealmList::RealmListIterators iters;
-    iters = sRealmList.GetIteratorsForBuild(_build);
-    uint32 numRealms = sRealmList.NumRealmsForBuild(_build);
+    RealmList::RealmListEntries const& entries = sRealmList.GetEntriesForBuild(_build);
+    RealmList::RealmCharacterCounts const& charCounts = sRealmList.GetCharacterCounts(acctid);
 
     ACE_INET_Addr clientAddr;
     peer().get_remote_addr(clientAddr);
@@ -980,58 +1071,31 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
         case 6141:                                          // 1.12.3
         {
             pkt << uint32(0);                               // unused value
-            pkt << uint8(numRealms);
+            pkt << uint8(entries.size());
 
-            for (RealmList::RealmStlList::const_iterator itr = iters.first; itr != iters.second; ++itr)
+            for (RealmList::RealmListEntries::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
             {
-                clientAddr.set_port_number((*itr)->ExternalAddress.get_port_number());
-                uint8 AmountOfCharacters;
+                Realm const& realm = *itr->realm;
+                clientAddr.set_port_number(realm.ExternalAddress.get_port_number());
 
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT `numchars` FROM `realmcharacters` WHERE `realmid` = '%d' AND `acctid`='%u'", (*itr)->m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                {
-                    AmountOfCharacters = 0;
-                }
+                RealmList::RealmCharacterCounts::const_iterator count = charCounts.find(realm.m_ID);
+                uint8 AmountOfCharacters = count != charCounts.end() ? count->second : 0;
 
-                bool ok_build = std::find((*itr)->realmbuilds.begin(), (*itr)->realmbuilds.end(), _build) != (*itr)->realmbuilds.end();
+                RealmFlags realmflags = itr->realmflags;
 
-                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : NULL;
-                if (!buildInfo)
-                {
-                    buildInfo = &(*itr)->realmBuildInfo;
-                }
-
-                RealmFlags realmflags = (*itr)->realmflags;
-
-                // 1.x clients not support explicitly REALM_FLAG_SPECIFYBUILD, so manually form similar name as show in more recent clients
-                std::string name = (*itr)->name;
-                if (realmflags & REALM_FLAG_SPECIFYBUILD)
-                {
-                    char buf[20];
-                    snprintf(buf, 20, " (%u,%u,%u)", buildInfo->major_version, buildInfo->minor_version, buildInfo->bugfix_version);
-                    name += buf;
-                }
-
-                // Show offline state for unsupported client builds and locked realms (1.x clients not support locked state show)
-                if (!ok_build || ((*itr)->allowedSecurityLevel > _accountSecurityLevel))
+                // Show offline state for locked realms (1.x clients not support locked state show)
+                if (realm.allowedSecurityLevel > _accountSecurityLevel)
                 {
                     realmflags = RealmFlags(realmflags | REALM_FLAG_OFFLINE);
                 }
 
-                pkt << uint32((*itr)->icon);                                        // realm type
+                pkt << uint32(realm.icon);                                          // realm type
                 pkt << uint8(realmflags);                                           // realmflags
-                pkt << name;                                                        // name
-                pkt << GetAddressString(GetAddressForClient((**itr), clientAddr));  // address
-                pkt << float((*itr)->populationLevel);
+                pkt << itr->name;                                                   // name
+                pkt << GetAddressString(GetAddressForClient(realm, clientAddr));    // address
+                pkt << float(realm.populationLevel);
                 pkt << uint8(AmountOfCharacters);
-                pkt << uint8((*itr)->timezone);                                     // realm category
+                pkt << uint8(realm.timezone);                                       // realm category
                 pkt << uint8(0x00);                                                 // unk, may be realm number/id?
             }
 
@@ -1050,66 +1114,35 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
         case 40000:                                         // 9.0.0
         default:                                            // and later
         {
-            uint16 tempRealm = uint16(numRealms);           // Force the cast here to prevent a compile fail in VS2017/32Bit
+            uint16 tempRealm = uint16(entries.size());      // Force the cast here to prevent a compile fail in VS2017/32Bit
             pkt << uint32(0);                               // unused value
             pkt << tempRealm;
 
-            for (RealmList::RealmStlList::const_iterator itr = iters.first; itr != iters.second; ++itr)
+            for (RealmList::RealmListEntries::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
             {
-                clientAddr.set_port_number((*itr)->ExternalAddress.get_port_number());
-                uint8 AmountOfCharacters;
+                Realm const& realm = *itr->realm;
+                clientAddr.set_port_number(realm.ExternalAddress.get_port_number());
 
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT `numchars` FROM `realmcharacters` WHERE `realmid` = '%d' AND `acctid`='%u'", (*itr)->m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                {
-                    AmountOfCharacters = 0;
-                }
+                RealmList::RealmCharacterCounts::const_iterator count = charCounts.find(realm.m_ID);
+                uint8 AmountOfCharacters = count != charCounts.end() ? count->second : 0;
 
-                bool ok_build = std::find((*itr)->realmbuilds.begin(), (*itr)->realmbuilds.end(), _build) != (*itr)->realmbuilds.end();
-
-                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : NULL;
-                if (!buildInfo)
-                {
-                    buildInfo = &(*itr)->realmBuildInfo;
-                }
-
-                uint8 lock = ((*itr)->allowedSecurityLevel > _accountSecurityLevel) ? 1 : 0;
-
-                RealmFlags realmFlags = (*itr)->realmflags;
-
-                // Show offline state for unsupported client builds
-                if (!ok_build)
-                {
-                    realmFlags = RealmFlags(realmFlags | REALM_FLAG_OFFLINE);
-                }
-
-                if (!buildInfo)
-                {
-                    realmFlags = RealmFlags(realmFlags & ~REALM_FLAG_SPECIFYBUILD);
-                }
+                uint8 lock = (realm.allowedSecurityLevel > _accountSecurityLevel) ? 1 : 0;
 
-                pkt << uint8((*itr)->icon);                                         // realm type (this is second column in Cfg_Configs.dbc)
+                pkt << uint8(realm.icon);                                           // realm type (this is second column in Cfg_Configs.dbc)
                 pkt << uint8(lock);                                                 // flags, if 0x01, then realm locked
-                pkt << uint8(realmFlags);                                           // see enum RealmFlags
-                pkt << (*itr)->name;                                                // name
-                pkt << GetAddressString(GetAddressForClient((**itr), clientAddr));  // address
-                pkt << float((*itr)->populationLevel);
+                pkt << uint8(itr->realmflags);                                      // see enum RealmFlags
+                pkt << realm.name;                                                  // name
+                pkt << GetAddressString(GetAddressForClient(realm, clientAddr));    // address
+                pkt << float(realm.populationLevel);
                 pkt << uint8(AmountOfCharacters);
-                pkt << uint8((*itr)->timezone);                                     // realm category (Cfg_Categories.dbc)
+                pkt << uint8(realm.timezone);                                       // realm category (Cfg_Categories.dbc)
                 pkt << uint8(0x2C);                                                 // unk, may be realm number/id?
 
-                if (realmFlags & REALM_FLAG_SPECIFYBUILD)
+                if (itr->realmflags & REALM_FLAG_SPECIFYBUILD)
                 {
-                    pkt << uint8(buildInfo->major_version);
-                    pkt << uint8(buildInfo->minor_version);
-                    pkt << uint8(buildInfo->bugfix_version);
+                    pkt << uint8(itr->buildInfo->major_version);
+                    pkt << uint8(itr->buildInfo->minor_version);
+                    pkt << uint8(itr->buildInfo->bugfix_version);
                     pkt << uint16(_build);
                 }
             }
@@ -70,12 +70,36 @@ class AuthSocket: public BufferedSocket
          *
          */
         void OnRead() override;
+        /**
+         * @brief Deferred while a logon worker still runs the pending work of the socket
+         *
+         */
+        void destroy() override;
+
+        /**
+         * @brief Runs the queued work of the socket, called by a logon worker thread
+         *
+         */
+        void RunPendingWork();
+        /**
+         * @brief Sends the reply of the work and continues with the buffered input, called by the reactor thread
+         *
+         * @param async true when the work was run by a worker thread
+         */
+        void CompletePendingWork(bool async);
         /**
          * @brief
          *
          * @param sha
          */
         void SendProof(Sha1Hash sha);
+        /**
+         * @brief Adds data to the reply sent when the pending work completes
+         *
+         * @param buf
+         * @param len
+         */
+        void QueueReply(const char* buf, size_t len);
         /**
          * @brief
          *
@@ -144,6 +168,18 @@ class AuthSocket: public BufferedSocket
         void _SetVSFields(const std::string& rI);
 
     private:
+        typedef void (AuthSocket::*PendingWork)();
+
+        /**
+         * @brief Hands the database lookups and SRP6 math of a logon command to the logon workers
+         *
+         * @param work part of the command handler not touching the socket itself
+         */
+        void QueueWork(PendingWork work);
+
+        void _LogonChallengeWork();
+        void _LogonProofWork();
+
         enum eStatus
         {
             STATUS_CHALLENGE,
@@ -171,6 +207,11 @@ class AuthSocket: public BufferedSocket
 
         ACE_HANDLE patch_; /**< TODO */
 
+        PendingWork _pendingWork;                           ///< Work queued to the logon workers, input is not processed meanwhile
+        bool _destroyPending;                               ///< Socket was closed while the work was running
+        std::vector<uint8> _pendingRequest;                 ///< Client packet the pending work needs
+        ByteBuffer _pendingReply;                           ///< Reply written by the pending work
+
         /**
          * @brief
          *
@@ -0,0 +1,188 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "AuthWorkerPool.h"
+#include "AuthSocket.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+
+#include <ace/Reactor.h>
+
+extern DatabaseType LoginDatabase;
+
+AuthWorkerPool::AuthWorkerPool() : m_threads(0), m_stop(false), m_condition(m_lock), m_queued(0), m_peakQueued(0), m_completed(0)
+{
+}
+
+AuthWorkerPool::~AuthWorkerPool()
+{
+    Stop();
+}
+
+AuthWorkerPool& AuthWorkerPool::Instance()
+{
+    static AuthWorkerPool pool;
+    return pool;
+}
+
+bool AuthWorkerPool::Start(uint32 threads, ACE_Reactor* reactor)
+{
+    if (!threads)
+    {
+        return true;
+    }
+
+    this->reactor(reactor);
+    m_stop = false;
+
+    if (activate(THR_NEW_LWP | THR_JOINABLE, threads) == -1)
+    {
+        sLog.outError("AuthWorkerPool: can not start %u logon worker threads", threads);
+        return false;
+    }
+
+    m_threads = threads;
+    sLog.outString("Using %u logon worker threads", threads);
+    return true;
+}
+
+void AuthWorkerPool::Stop()
+{
+    if (!m_threads)
+    {
+        return;
+    }
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        m_stop = true;
+        m_condition.broadcast();
+    }
+
+    wait();
+
+    // sockets still waiting are closed together with the process
+    m_pending.clear();
+    m_done.clear();
+    m_threads = 0;
+}
+
+void AuthWorkerPool::Enqueue(AuthSocket* socket)
+{
+    long queued = ++m_queued;
+    if (queued > m_peakQueued.value())
+    {
+        m_peakQueued = queued;
+    }
+
+    if (!m_threads)
+    {
+        socket->RunPendingWork();
+        --m_queued;
+        ++m_completed;
+        socket->CompletePendingWork(false);
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+    m_pending.push_back(socket);
+    m_condition.signal();
+}
+
+void AuthWorkerPool::GetAndResetStats(uint32& peakQueued, uint32& completed)
+{
+    peakQueued = uint32(m_peakQueued.value());
+    completed = uint32(m_completed.value());
+
+    m_peakQueued = m_queued.value();
+    m_completed = 0;
+}
+
+int AuthWorkerPool::svc()
+{
+    LoginDatabase.ThreadStart();
+
+    for (;;)
+    {
+        AuthSocket* socket = NULL;
+
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, -1);
+
+            while (!m_stop && m_pending.empty())
+            {
+                m_condition.wait();
+            }
+
+            if (m_stop)
+            {
+                break;
+            }
+
+            socket = m_pending.front();
+            m_pending.pop_front();
+        }
+
+        socket->RunPendingWork();
+
+        bool notify;
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, -1);
+            // one notification drains everything completed until the reactor gets to it
+            notify = m_done.empty();
+            m_done.push_back(socket);
+        }
+
+        if (notify)
+        {
+            reactor()->notify(this, ACE_Event_Handler::EXCEPT_MASK);
+        }
+    }
+
+    LoginDatabase.ThreadEnd();
+    return 0;
+}
+
+int AuthWorkerPool::handle_exception(ACE_HANDLE /*= ACE_INVALID_HANDLE*/)
+{
+    std::vector<AuthSocket*> done;
+
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, 0);
+        done.swap(m_done);
+    }
+
+    for (std::vector<AuthSocket*>::const_iterator itr = done.begin(); itr != done.end(); ++itr)
+    {
+        --m_queued;
+        ++m_completed;
+        (*itr)->CompletePendingWork(true);
+    }
+
+    return 0;
+}
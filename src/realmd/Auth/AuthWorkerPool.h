@@ -0,0 +1,116 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef MANGOS_H_AUTHWORKERPOOL
+#define MANGOS_H_AUTHWORKERPOOL
+
+#include <ace/Task.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+
+#include "Common.h"
+
+#include <deque>
+#include <vector>
+
+class AuthSocket;
+
+/**
+ * @brief Runs the SRP6 math and the database lookups of the logon handshakes
+ *
+ * AuthSocket queues itself once it has read a logon command completely. A worker
+ * thread then runs the pending work of the socket, which writes its answer into a
+ * reply buffer instead of the socket, and the reactor thread is notified to send
+ * the reply and go on with the input of the socket.
+ */
+class AuthWorkerPool : public ACE_Task_Base
+{
+    public:
+        AuthWorkerPool();
+        ~AuthWorkerPool();
+
+        static AuthWorkerPool& Instance();
+
+        /**
+         * @brief Starts the worker threads, with 0 threads all work is done inline
+         *
+         * @param threads number of worker threads
+         * @param reactor reactor of the sockets, the completions are run by it
+         * @return bool false if the threads could not be started
+         */
+        bool Start(uint32 threads, ACE_Reactor* reactor);
+        /**
+         * @brief Stops the worker threads, work not done yet is dropped
+         *
+         */
+        void Stop();
+
+        bool IsAsync() const { return m_threads != 0; }
+
+        /**
+         * @brief Hands the pending work of the socket to a worker
+         *
+         * @param socket socket with pending work, it is not destroyed until the work completes
+         */
+        void Enqueue(AuthSocket* socket);
+
+        /**
+         * @brief Handshakes queued or running right now
+         *
+         */
+        uint32 GetQueuedCount() const { return uint32(m_queued.value()); }
+        /**
+         * @brief Returns the highest queued count and the number of completed handshakes since the last call
+         *
+         */
+        void GetAndResetStats(uint32& peakQueued, uint32& completed);
+
+        int svc() override;
+        int handle_exception(ACE_HANDLE = ACE_INVALID_HANDLE) override;
+
+    private:
+        typedef std::deque<AuthSocket*> SocketQueue;
+
+        uint32 m_threads;
+        bool m_stop;
+
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_condition;
+        SocketQueue m_pending;
+        std::vector<AuthSocket*> m_done;
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_queued;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_peakQueued;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_completed;
+};
+
+#define sAuthWorkerPool AuthWorkerPool::Instance()
+
+#endif
+/// @}
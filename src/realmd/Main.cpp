@@ -34,6 +34,8 @@
 #include "GitRevision.h"
 #include "Log.h"
 #include "Auth/AuthSocket.h"
+#include "Auth/AuthWorkerPool.h"
+#include "SocketBuffer/NetworkThreadPool.h"
 #include "SystemConfig.h"
 #include "revision_data.h"
 #include "Util.h"
@@ -202,6 +204,7 @@ extern int main(int argc, char** argv)
 #endif
 
     sLog.Initialize();
+    sLog.StartAsyncWriter();
 
     sLog.outString("%s [realm-daemon]", GitRevision::GetProjectRevision());
     sLog.outString("%s", GitRevision::GetFullRevision());
@@ -229,11 +232,18 @@ extern int main(int argc, char** argv)
 
     DETAIL_LOG("Using ACE: %s", ACE_VERSION);
 
+    // more than one network thread needs the thread pool reactor, it hands every socket to one thread at a time
+    uint32 networkThreads = sConfig.GetIntDefault("NetworkThreads", 1);
 #if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
-    ACE_Reactor::instance(new ACE_Reactor(new ACE_Dev_Poll_Reactor(ACE::max_handles(), 1), 1), true);
-#else
-    ACE_Reactor::instance(new ACE_Reactor(new ACE_TP_Reactor(), true), true);
+    if (networkThreads <= 1)
+    {
+        ACE_Reactor::instance(new ACE_Reactor(new ACE_Dev_Poll_Reactor(ACE::max_handles(), 1), 1), true);
+    }
+    else
 #endif
+    {
+        ACE_Reactor::instance(new ACE_Reactor(new ACE_TP_Reactor(), true), true);
+    }
 
     sLog.outBasic("Max allowed open files is %d", ACE::max_handles());
 
@@ -275,6 +285,13 @@ extern int main(int argc, char** argv)
     LoginDatabase.Execute("DELETE FROM `ip_banned` WHERE `unbandate`<=UNIX_TIMESTAMP() AND `unbandate`<>`bandate`");
     LoginDatabase.CommitTransaction();
 
+    ///- Start the threads doing the logon handshake work
+    if (!sAuthWorkerPool.Start(sConfig.GetIntDefault("LogonWorkerThreads", 0), ACE_Reactor::instance()))
+    {
+        Log::WaitBeforeContinueIfNeed();
+        return 1;
+    }
+
     ///- Launch the listening network socket
     ACE_Acceptor<AuthSocket, ACE_SOCK_Acceptor> acceptor;
 
@@ -290,6 +307,14 @@ extern int main(int argc, char** argv)
         return 1;
     }
 
+    ///- Start the network threads besides the main thread
+    NetworkThreadPool networkThreadPool;
+    if (networkThreads > 1 && !networkThreadPool.Start(networkThreads - 1, ACE_Reactor::instance()))
+    {
+        Log::WaitBeforeContinueIfNeed();
+        return 1;
+    }
+
     ///- Catch termination signals
     HookSignals();
 
@@ -351,6 +376,10 @@ extern int main(int argc, char** argv)
     uint32 numLoops = (sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000000 / 100000));
     uint32 loopCounter = 0;
 
+    // logon handshake statistics once per minute
+    uint32 numStatLoops = MINUTE * 1000000 / 100000;
+    uint32 statLoopCounter = 0;
+
 #ifndef WIN32
     detachDaemon();
 #endif
@@ -371,6 +400,18 @@ extern int main(int argc, char** argv)
             DETAIL_LOG("Ping MySQL to keep connection alive");
             LoginDatabase.Ping();
         }
+
+        if ((++statLoopCounter) == numStatLoops)
+        {
+            statLoopCounter = 0;
+
+            uint32 peakQueued, completed;
+            sAuthWorkerPool.GetAndResetStats(peakQueued, completed);
+            if (completed || peakQueued)
+            {
+                DETAIL_LOG("Logon handshakes: %u completed, %u queued (peak %u)", completed, sAuthWorkerPool.GetQueuedCount(), peakQueued);
+            }
+        }
 #ifdef WIN32
         if (m_ServiceStatus == 0)
         {
@@ -380,12 +421,17 @@ extern int main(int argc, char** argv)
 #endif
     }
 
+    ///- Stop the network threads, then the logon workers before the database goes away
+    networkThreadPool.Stop();
+    sAuthWorkerPool.Stop();
+
     ///- Wait for the delay thread to exit
     LoginDatabase.HaltDelayThread();
 
     ///- Remove signal handling before leaving
     UnhookSignals();
 
+    sLog.StopAsyncWriter();
     sLog.outString("Halting process...");
     return 0;
 }
@@ -420,9 +466,23 @@ bool StartDB()
         return false;
     }
 
-    sLog.outString("Login Database total connections: %i", 1 + 1);
+    // every logon worker gets its own query connection, the reactor thread shares them
+    int nConnections = sConfig.GetIntDefault("LogonWorkerThreads", 0);
+    if (nConnections < 1)
+    {
+        nConnections = 1;
+    }
+
+    // and so does every additional network thread
+    int networkThreads = sConfig.GetIntDefault("NetworkThreads", 1);
+    if (networkThreads > 1)
+    {
+        nConnections += networkThreads - 1;
+    }
+
+    sLog.outString("Login Database total connections: %i", nConnections + 1);
 
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
     {
         sLog.outError("Can not connect to database");
         return false;
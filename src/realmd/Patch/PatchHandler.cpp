@@ -188,13 +188,21 @@ void PatchCache::LoadPatchMD5(const char* szFileName)
 
     fclose(pPatch);
 
-    // Store the result in the internal patch hash map
-    patches_[path] = new PATCH_INFO;
-    MD5_Final((ACE_UINT8*) & patches_[path]->md5, &ctx);
+    ACE_GUARD(ACE_Thread_Mutex, guard, lock_);
+
+    // Store the result in the internal patch hash map, another thread may have been first
+    PATCH_INFO*& info = patches_[path];
+    if (!info)
+    {
+        info = new PATCH_INFO;
+    }
+    MD5_Final((ACE_UINT8*) & info->md5, &ctx);
 }
 
 bool PatchCache::GetHash(const char* pat, ACE_UINT8 mymd5[MD5_DIGEST_LENGTH])
 {
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, lock_, false);
+
     for (Patches::iterator i = patches_.begin(); i != patches_.end(); ++i)
         if (!stricmp(pat, i->first.c_str()))
         {
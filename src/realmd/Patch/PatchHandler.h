@@ -35,6 +35,7 @@
 #include <ace/SOCK_Stream.h>
 #include <ace/Message_Block.h>
 #include <ace/Auto_Ptr.h>
+#include <ace/Thread_Mutex.h>
 #include <map>
 
 #include <openssl/bn.h>
@@ -122,6 +123,7 @@ class PatchCache
          */
         void LoadPatchesInfo();
         Patches patches_; /**< TODO */
+        ACE_Thread_Mutex lock_; /**< patches are added while the network threads look up hashes */
 };
 
 /**
@@ -134,6 +134,84 @@ uint32 RealmList::NumRealmsForBuild(uint32 build) const
     return m_realmsByVersion[BelongsToVersion(build)].size();
 }
 
+RealmList::RealmListEntries const& RealmList::GetEntriesForBuild(uint32 build)
+{
+    RealmListEntriesMap::const_iterator found = m_entriesByBuild.find(build);
+    if (found != m_entriesByBuild.end())
+    {
+        return found->second;
+    }
+
+    RealmListEntries& entries = m_entriesByBuild[build];
+    RealmListIterators iters = GetIteratorsForBuild(build);
+
+    for (RealmStlList::const_iterator itr = iters.first; itr != iters.second; ++itr)
+    {
+        RealmListEntry entry;
+        entry.realm = *itr;
+        entry.name = (*itr)->name;
+        entry.realmflags = (*itr)->realmflags;
+
+        bool ok_build = (*itr)->realmbuilds.find(build) != (*itr)->realmbuilds.end();
+
+        entry.buildInfo = ok_build ? FindBuildInfo(build) : NULL;
+        if (!entry.buildInfo)
+        {
+            entry.buildInfo = &(*itr)->realmBuildInfo;
+        }
+
+        // 1.x clients not support explicitly REALM_FLAG_SPECIFYBUILD, so manually form similar name as show in more recent clients
+        bool vanilla_build = build == 5875 || build == 6005 || build == 6141;
+        if (vanilla_build && (entry.realmflags & REALM_FLAG_SPECIFYBUILD))
+        {
+            char buf[20];
+            snprintf(buf, 20, " (%u,%u,%u)", entry.buildInfo->major_version, entry.buildInfo->minor_version, entry.buildInfo->bugfix_version);
+            entry.name += buf;
+        }
+
+        // Show offline state for unsupported client builds
+        if (!ok_build)
+        {
+            entry.realmflags = RealmFlags(entry.realmflags | REALM_FLAG_OFFLINE);
+        }
+
+        entries.push_back(entry);
+    }
+
+    return entries;
+}
+
+RealmList::RealmCharacterCounts const& RealmList::GetCharacterCounts(uint32 accountId)
+{
+    // without periodic updates nothing would ever refresh the cached counts
+    if (!m_UpdateInterval)
+    {
+        m_characterCounts.clear();
+    }
+
+    AccountCharacterCountsMap::const_iterator found = m_characterCounts.find(accountId);
+    if (found != m_characterCounts.end())
+    {
+        return found->second;
+    }
+
+    RealmCharacterCounts& counts = m_characterCounts[accountId];
+
+    QueryResult* result = LoginDatabase.PQuery("SELECT `realmid`, `numchars` FROM `realmcharacters` WHERE `acctid` = '%u'", accountId);
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            counts[fields[0].GetUInt32()] = fields[1].GetUInt8();
+        }
+        while (result->NextRow());
+        delete result;
+    }
+
+    return counts;
+}
+
 void RealmList::AddRealmToBuildList(const Realm& realm)
 {
     RealmBuilds builds = realm.realmbuilds;
@@ -227,7 +305,9 @@ void RealmList::UpdateIfNeed()
 
     m_NextUpdateTime = time(NULL) + m_UpdateInterval;
 
-    // Clears Realm list
+    // Clears Realm list and everything built from it
+    m_entriesByBuild.clear();
+    m_characterCounts.clear();
     m_realms.clear();
     for (int i = 0; i < REALM_VERSION_COUNT; ++i)
     {
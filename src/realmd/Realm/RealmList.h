@@ -31,6 +31,7 @@
 
 #include <ace/Singleton.h>
 #include <ace/Null_Mutex.h>
+#include <ace/Thread_Mutex.h>
 #include <ace/INET_Addr.h>
 #include "Common.h"
 
@@ -96,6 +97,18 @@ struct Realm
     RealmBuildInfo realmBuildInfo;                          // build info for show version in list
 };
 
+/**
+ * @brief Client build dependent part of a realm list entry, prebuilt once per build
+ *
+ */
+struct RealmListEntry
+{
+    Realm const* realm;
+    std::string name;                                       // name as shown to the build (1.x clients get the version appended)
+    RealmFlags realmflags;                                  // realmflags with offline state for unsupported builds
+    RealmBuildInfo const* buildInfo;                        // build info for show version in list
+};
+
 /**
  * @brief Storage object for the list of realms on the server
  *
@@ -111,6 +124,10 @@ class RealmList
         typedef std::list<const Realm*> RealmStlList;
         typedef std::pair<RealmStlList::const_iterator, RealmStlList::const_iterator> RealmListIterators;
         typedef std::map<uint32, RealmVersion> RealmBuildVersionMap;
+        typedef std::vector<RealmListEntry> RealmListEntries;
+        typedef std::map<uint32, RealmListEntries> RealmListEntriesMap;
+        typedef std::map<uint32, uint8> RealmCharacterCounts;
+        typedef std::map<uint32, RealmCharacterCounts> AccountCharacterCountsMap;
 
         static RealmList& Instance();
 
@@ -144,11 +161,30 @@ class RealmList
          */
         uint32 NumRealmsForBuild(uint32 build) const;
 
+        /**
+         * Returns the realm list entries for the given build, built on first request
+         * and kept until the next realm list update
+         * @param build the build of the client asking for the realm list
+         * @return the entries of all realms available for the version of the build
+         */
+        RealmListEntries const& GetEntriesForBuild(uint32 build);
+
+        /**
+         * Returns the number of characters the account has on each realm (by realm id),
+         * read in one query and kept until the next realm list update
+         * @param accountId the account to get the character counts for
+         * @return the amount of characters per realm id, realms without characters may be missing
+         */
+        RealmCharacterCounts const& GetCharacterCounts(uint32 accountId);
+
         /**
          * @return the total number of realms available
          * \see RealmList::NumRealmsForBuild
          */
         uint32 size() const { return m_realms.size(); };
+
+        // held around UpdateIfNeed() and the use of the returned entries and counts
+        ACE_Thread_Mutex& GetLock() { return m_lock; }
     private:
         /**
          * Checks what version (ie, vanilla, tbc) a certain build number belongs to
@@ -197,8 +233,11 @@ class RealmList
         RealmMap m_realms;                                    ///< Internal map of realms
         RealmStlList m_realmsByVersion[REALM_VERSION_COUNT]; ///< This sorts the realms by their supported build
         RealmBuildVersionMap m_buildToVersion;
+        RealmListEntriesMap m_entriesByBuild;                 ///< Prebuilt realm list entries per client build
+        AccountCharacterCountsMap m_characterCounts;          ///< Character counts of the accounts that asked since the last update
         uint32   m_UpdateInterval;
         time_t   m_NextUpdateTime;
+        ACE_Thread_Mutex m_lock;                              ///< Network threads share the list
 };
 
 #define sRealmList RealmList::Instance()
@@ -209,6 +209,8 @@ bool BufferedSocket::send(const char* buf, size_t len)
 
 /*virtual*/ int BufferedSocket::handle_output(ACE_HANDLE /*= ACE_INVALID_HANDLE*/)
 {
+    ACE_GUARD_RETURN(LockType, guard, lock_, -1);
+
     ACE_Message_Block* mb = 0;
 
     if (this->msg_queue()->is_empty())
@@ -253,6 +255,8 @@ bool BufferedSocket::send(const char* buf, size_t len)
 
 /*virtual*/ int BufferedSocket::handle_input(ACE_HANDLE /*= ACE_INVALID_HANDLE*/)
 {
+    ACE_GUARD_RETURN(LockType, guard, lock_, -1);
+
     const ssize_t space = this->input_buffer_.space();
 
     ssize_t n = this->peer().recv(this->input_buffer_.wr_ptr(), space);
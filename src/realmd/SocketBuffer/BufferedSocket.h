@@ -34,6 +34,7 @@
 #include <ace/Svc_Handler.h>
 #include <ace/SOCK_Stream.h>
 #include <ace/Message_Block.h>
+#include <ace/Recursive_Thread_Mutex.h>
 #include <ace/Basic_Types.h>
 
 #include <string>
@@ -51,6 +52,14 @@ class BufferedSocket: public ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH>
          */
         typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> Base;
 
+        /**
+         * @brief Serializes the handlers of the socket with work completed outside them
+         *
+         * With several network threads the input, output and notification handlers of
+         * one socket can run at the same time, the buffers are only touched under it.
+         */
+        typedef ACE_Recursive_Thread_Mutex LockType;
+
         /**
          * @brief
          *
@@ -159,6 +168,7 @@ class BufferedSocket: public ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH>
 
     protected:
         std::string remote_address_; /**< TODO */
+        LockType lock_; /**< held by handle_input, handle_output and the completion of queued work */
 };
 
 #endif /* _BUFFEREDSOCKET_H_ */
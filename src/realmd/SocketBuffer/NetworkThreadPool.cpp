@@ -0,0 +1,87 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "NetworkThreadPool.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+
+#include <ace/Reactor.h>
+
+extern DatabaseType LoginDatabase;
+
+NetworkThreadPool::NetworkThreadPool() : m_threads(0)
+{
+}
+
+NetworkThreadPool::~NetworkThreadPool()
+{
+    Stop();
+}
+
+bool NetworkThreadPool::Start(uint32 threads, ACE_Reactor* reactor)
+{
+    if (!threads)
+    {
+        return true;
+    }
+
+    this->reactor(reactor);
+
+    if (activate(THR_NEW_LWP | THR_JOINABLE, threads) == -1)
+    {
+        sLog.outError("NetworkThreadPool: can not start %u network threads", threads);
+        return false;
+    }
+
+    m_threads = threads;
+    sLog.outString("Using %u network threads", threads + 1);
+    return true;
+}
+
+void NetworkThreadPool::Stop()
+{
+    if (!m_threads)
+    {
+        return;
+    }
+
+    reactor()->end_reactor_event_loop();
+    wait();
+    m_threads = 0;
+}
+
+int NetworkThreadPool::svc()
+{
+    // command handlers run their database queries on the calling thread
+    LoginDatabase.ThreadStart();
+
+    reactor()->run_reactor_event_loop();
+
+    LoginDatabase.ThreadEnd();
+    return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef MANGOS_H_NETWORKTHREADPOOL
+#define MANGOS_H_NETWORKTHREADPOOL
+
+#include <ace/Task.h>
+
+#include "Common.h"
+
+/**
+ * @brief Additional threads running the event loop of the reactor
+ *
+ * Only used with a reactor able to dispatch from several threads (ACE_TP_Reactor),
+ * it hands each socket to one thread at a time. The main thread keeps running the
+ * event loop as well, so N network threads means N - 1 threads started here.
+ */
+class NetworkThreadPool : public ACE_Task_Base
+{
+    public:
+        NetworkThreadPool();
+        ~NetworkThreadPool();
+
+        /**
+         * @brief Starts the threads, with 0 threads only the main thread runs the reactor
+         *
+         * @param threads number of threads besides the main thread
+         * @param reactor reactor of the sockets
+         * @return bool false if the threads could not be started
+         */
+        bool Start(uint32 threads, ACE_Reactor* reactor);
+        /**
+         * @brief Ends the event loop of the reactor and waits for the threads
+         *
+         */
+        void Stop();
+
+        int svc() override;
+
+    private:
+        uint32 m_threads;
+};
+
+#endif
+/// @}
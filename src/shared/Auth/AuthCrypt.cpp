@@ -33,6 +33,8 @@ const static size_t CRYPTED_RECV_LEN = 6;
 AuthCrypt::AuthCrypt()
 {
     _initialized = false;
+    _sendLen = CRYPTED_SEND_LEN;
+    _recvLen = CRYPTED_RECV_LEN;
 }
 
 void AuthCrypt::DecryptRecv(uint8* data, size_t len)
@@ -41,12 +43,12 @@ void AuthCrypt::DecryptRecv(uint8* data, size_t len)
     {
         return;
     }
-    if (len < CRYPTED_RECV_LEN)
+    if (len < _recvLen)
     {
         return;
     }
 
-    for (size_t t = 0; t < CRYPTED_RECV_LEN; t++)
+    for (size_t t = 0; t < _recvLen; t++)
     {
         _recv_i %= _key.size();
         uint8 x = (data[t] - _recv_j) ^ _key[_recv_i];
@@ -63,12 +65,12 @@ void AuthCrypt::EncryptSend(uint8* data, size_t len)
         return;
     }
 
-    if (len < CRYPTED_SEND_LEN)
+    if (len < _sendLen)
     {
         return;
     }
 
-    for (size_t t = 0; t < CRYPTED_SEND_LEN; t++)
+    for (size_t t = 0; t < _sendLen; t++)
     {
         _send_i %= _key.size();
         uint8 x = (data[t] ^ _key[_send_i]) + _send_j;
@@ -80,9 +82,20 @@ void AuthCrypt::EncryptSend(uint8* data, size_t len)
 void AuthCrypt::Init()
 {
     _send_i = _send_j = _recv_i = _recv_j = 0;
+    _sendLen = CRYPTED_SEND_LEN;
+    _recvLen = CRYPTED_RECV_LEN;
     _initialized = true;
 }
 
+void AuthCrypt::InitClient()
+{
+    Init();
+
+    // the client sends the long headers and receives the short ones
+    _sendLen = CRYPTED_RECV_LEN;
+    _recvLen = CRYPTED_SEND_LEN;
+}
+
 void AuthCrypt::SetKey(uint8* key, size_t len)
 {
     _key.resize(len);
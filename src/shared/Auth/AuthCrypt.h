@@ -54,6 +54,12 @@ class AuthCrypt
          */
         void Init();
 
+        /**
+         * @brief same as Init, for the client end of a world connection
+         *
+         */
+        void InitClient();
+
         /**
         * @brief
         *
@@ -87,6 +93,7 @@ class AuthCrypt
     private:
         std::vector<uint8> _key; /**< TODO */
         uint8 _send_i, _send_j, _recv_i, _recv_j; /**< TODO */
+        size_t _sendLen, _recvLen;                  /**< header bytes crypted in each direction */
         bool _initialized; /**< TODO */
 };
 #endif
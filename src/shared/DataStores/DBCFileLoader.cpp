@@ -26,18 +26,27 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <ace/Mem_Map.h>
+
 #include "DBCFileLoader.h"
 
 DBCFileLoader::DBCFileLoader()
 {
     data = NULL;
     fieldsOffset = NULL;
+    mapping = NULL;
 }
 
 bool DBCFileLoader::Load(const char* filename, const char* fmt)
 {
     uint32 header;
-    delete[] data;
+    Unload();
+
+    if (LoadMapped(filename))
+    {
+        SetFieldOffsets(fmt);
+        return true;
+    }
 
     FILE* f = fopen(filename, "rb");
     if (!f)
@@ -90,6 +99,69 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
 
     EndianConvert(stringSize);
 
+    SetFieldOffsets(fmt);
+
+    data = new unsigned char[recordSize * recordCount + stringSize];
+    stringTable = data + recordSize * recordCount;
+
+    if (fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
+    {
+        fclose(f);
+        return false;
+    }
+
+    fclose(f);
+    return true;
+}
+
+bool DBCFileLoader::LoadMapped(const char* filename)
+{
+    // private and writable: pages stay shared with the page cache (and other processes) until written to
+    ACE_Mem_Map* map = new ACE_Mem_Map();
+    if (map->map(ACE_TEXT_CHAR_TO_TCHAR(filename), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_RDWR, ACE_MAP_PRIVATE) != 0)
+    {
+        delete map;
+        return false;
+    }
+
+    const uint32 headerSize = 5 * sizeof(uint32);
+    unsigned char* file = static_cast<unsigned char*>(map->addr());
+
+    uint32 header[5];
+    if (map->size() < headerSize)
+    {
+        delete map;
+        return false;
+    }
+
+    memcpy(header, file, headerSize);
+    for (int i = 0; i < 5; ++i)
+    {
+        EndianConvert(header[i]);
+    }
+
+    if (header[0] != 0x43424457 ||                          //'WDBC'
+            map->size() < headerSize + size_t(header[1]) * header[3] + header[4])
+    {
+        delete map;
+        return false;
+    }
+
+    recordCount = header[1];
+    fieldCount = header[2];
+    recordSize = header[3];
+    stringSize = header[4];
+
+    mapping = map;
+    data = file + headerSize;
+    stringTable = data + recordSize * recordCount;
+    return true;
+}
+
+void DBCFileLoader::SetFieldOffsets(const char* fmt)
+{
+    delete[] fieldsOffset;
+
     fieldsOffset = new uint32[fieldCount];
     fieldsOffset[0] = 0;
     for (uint32 i = 1; i < fieldCount; ++i)
@@ -104,26 +176,109 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
             fieldsOffset[i] += 4;
         }
     }
+}
 
-    data = new unsigned char[recordSize * recordCount + stringSize];
-    stringTable = data + recordSize * recordCount;
-
-    if (fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
+void DBCFileLoader::Unload()
+{
+    if (mapping)
     {
-        fclose(f);
-        return false;
+        delete mapping;                                     // unmaps the file
+        mapping = NULL;
+    }
+    else
+    {
+        delete[] data;
     }
 
-    fclose(f);
-    return true;
+    data = NULL;
 }
 
 DBCFileLoader::~DBCFileLoader()
 {
-    delete[] data;
+    Unload();
     delete[] fieldsOffset;
 }
 
+bool DBCFileLoader::IsInPlaceFormat(const char* format)
+{
+#if MANGOS_ENDIAN == MANGOS_LITTLEENDIAN
+    // 4 byte fields matching the struct members one to one, unused fields only at the end
+    size_t x = 0;
+    bool index = false;
+    for (; format[x] == DBC_FF_INT || format[x] == DBC_FF_FLOAT || format[x] == DBC_FF_IND; ++x)
+    {
+        if (format[x] == DBC_FF_IND)
+        {
+            if (index)
+            {
+                return false;
+            }
+
+            index = true;
+        }
+    }
+
+    if (!x)
+    {
+        return false;
+    }
+
+    for (; format[x] == DBC_FF_NA; ++x)
+    {
+    }
+
+    return !format[x];
+#else
+    // records are stored little endian
+    return false;
+#endif
+}
+
+char** DBCFileLoader::ProduceIndexTable(const char* format, uint32& records)
+{
+    typedef char* ptr;
+    if (strlen(format) != fieldCount || !IsInPlaceFormat(format))
+    {
+        return NULL;
+    }
+
+    int32 i;
+    GetFormatRecordSize(format, &i);
+
+    ptr* indexTable;
+
+    if (i >= 0)
+    {
+        uint32 maxi = 0;
+        // find max index
+        for (uint32 y = 0; y < recordCount; ++y)
+        {
+            uint32 ind = getRecord(y).getUInt(i);
+            if (ind > maxi)
+            {
+                maxi = ind;
+            }
+        }
+
+        ++maxi;
+        records = maxi;
+        indexTable = new ptr[maxi];
+        memset(indexTable, 0, maxi * sizeof(ptr));
+    }
+    else
+    {
+        records = recordCount;
+        indexTable = new ptr[recordCount];
+    }
+
+    for (uint32 y = 0; y < recordCount; ++y)
+    {
+        indexTable[i >= 0 ? getRecord(y).getUInt(i) : y] = reinterpret_cast<ptr>(data + y * recordSize);
+    }
+
+    return indexTable;
+}
+
 DBCFileLoader::Record DBCFileLoader::getRecord(size_t id)
 {
     assert(data);
@@ -284,8 +439,15 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
         return NULL;
     }
 
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
+    // mapped files keep their string block, the strings are used from there
+    char* stringPool = NULL;
+    char* strings = reinterpret_cast<char*>(stringTable);
+    if (!mapping)
+    {
+        stringPool = new char[stringSize];
+        memcpy(stringPool, stringTable, stringSize);
+        strings = stringPool;
+    }
 
     uint32 offset = 0;
 
@@ -312,7 +474,7 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
                     if (!*slot || !** slot)
                     {
                         const char* st = getRecord(y).getString(x);
-                        *slot = stringPool + (st - (const char*)stringTable);
+                        *slot = strings + (st - (const char*)stringTable);
                     }
                     offset += sizeof(char*);
                     break;
@@ -29,6 +29,8 @@
 #include "Utilities/ByteConverter.h"
 #include <cassert>
 
+class ACE_Mem_Map;
+
 /**
  * @brief
  *
@@ -181,6 +183,15 @@ class DBCFileLoader
          * @return bool
          */
         bool IsLoaded() const {return (data != NULL);}
+        /**
+         * @brief whether the file is mapped into memory instead of read into a buffer
+         *
+         * Data produced from a mapped file may point into the mapping, the loader
+         * then has to live as long as that data.
+         *
+         * @return bool
+         */
+        bool IsMapped() const { return mapping != NULL; }
         /**
          * @brief
          *
@@ -195,9 +206,27 @@ class DBCFileLoader
          *
          * @param fmt
          * @param dataTable
-         * @return char
+         * @return char string pool to delete[], NULL for a mapped file whose strings are used in place
          */
         char* AutoProduceStrings(const char* fmt, char* dataTable);
+        /**
+         * @brief index table pointing to the file records themselves, see IsInPlaceFormat
+         *
+         * @param fmt
+         * @param count
+         * @return char** NULL if the format does not allow to use the records in place
+         */
+        char** ProduceIndexTable(const char* fmt, uint32& count);
+        /**
+         * @brief whether the struct of a format has the layout of the file records
+         *
+         * That is the case for formats with only 4 byte int and float fields,
+         * optionally followed by unused fields, on little endian hosts.
+         *
+         * @param format
+         * @return bool
+         */
+        static bool IsInPlaceFormat(const char* format);
         /**
          * Calculate and return the total amount of memory required by the types specified within the format string
          *
@@ -215,5 +244,10 @@ class DBCFileLoader
         uint32* fieldsOffset; /**< TODO */
         unsigned char* data; /**< TODO */
         unsigned char* stringTable; /**< TODO */
+        ACE_Mem_Map* mapping; /**< file mapping holding data, NULL if data was read into a buffer */
+
+        bool LoadMapped(const char* filename);
+        void SetFieldOffsets(const char* fmt);
+        void Unload();
 };
 #endif
@@ -39,6 +39,11 @@ class DBCStorage
          *
          */
         typedef std::list<char*> StringPoolList;
+        /**
+         * @brief mapped files whose records or strings are in use
+         *
+         */
+        typedef std::list<DBCFileLoader*> LoaderList;
     public:
         /**
          * @brief
@@ -53,12 +58,11 @@ class DBCStorage
         ~DBCStorage() { Clear(); }
 
         /**
-        * @brief
-        *
-        * @return uint32
-        */
-        //uint32  GetNumRows() const { return nCount; }
-        uint32  GetNumRows() const { return loaded ? data.size() : nCount; }
+         * @brief
+         *
+         * @return uint32
+         */
+        uint32  GetNumRows() const { return nCount; }
         /**
          * @brief
          *
@@ -73,24 +77,12 @@ class DBCStorage
         uint32 GetFieldCount() const { return fieldCount; }
 
         /**
-        * @brief
-        *
-        * @param id
-        * @return const T
-        */
-        //T const* LookupEntry(uint32 id) const { return (id >= nCount) ? NULL : indexTable[id]; }
-        T const* LookupEntry(uint32 id) const
-        {
-            if (loaded)
-            {
-                typename std::map<uint32, T const*>::const_iterator it = data.find(id);
-                if (it != data.end())
-                {
-                    return it->second;
-                }
-            }
-            return (id >= nCount) ? NULL : indexTable[id];
-        }
+         * @brief
+         *
+         * @param id
+         * @return const T
+         */
+        T const* LookupEntry(uint32 id) const { return (id >= nCount) ? NULL : indexTable[id]; }
         /**
          * @brief
          *
@@ -99,41 +91,58 @@ class DBCStorage
          */
         bool Load(char const* fn)
         {
-            DBCFileLoader dbc;
+            DBCFileLoader* dbc = new DBCFileLoader;
             // Check if load was sucessful, only then continue
-            if (!dbc.Load(fn, fmt))
+            if (!dbc->Load(fn, fmt))
             {
+                delete dbc;
                 return false;
             }
 
-            fieldCount = dbc.GetCols();
+            fieldCount = dbc->GetCols();
+
+            // records of a mapped file with the struct layout are used where they are
+            if (dbc->IsMapped() && (indexTable = (T**)dbc->ProduceIndexTable(fmt, nCount)))
+            {
+                m_loaderList.push_back(dbc);
+                return true;
+            }
 
             // load raw non-string data
-            m_dataTable = (T*)dbc.AutoProduceData(fmt, nCount, (char**&)indexTable);
+            m_dataTable = (T*)dbc->AutoProduceData(fmt, nCount, (char**&)indexTable);
 
             // load strings from dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            m_stringPoolList.push_back(dbc->AutoProduceStrings(fmt, (char*)m_dataTable));
+
+            KeepOrDelete(dbc);
 
             // error in dbc file at loading if NULL
             return indexTable != NULL;
         }
 
-        void SetEntry(uint32 id, T* t) // Cryptic they say..
+        /**
+         * @brief add or replace an entry, growing the index table for ids past the end
+         *
+         * @param id
+         * @param t
+         */
+        void SetEntry(uint32 id, T* t)
         {
-            if (!loaded)
+            if (id >= nCount)
             {
-                for (uint32 i = 0; i < nCount; ++i)
+                T** newTable = (T**)new char*[id + 1];
+                memset(newTable, 0, (id + 1) * sizeof(T*));
+                if (indexTable)
                 {
-                    T const* node = LookupEntry(i);
-                    if (!node)
-                    {
-                        continue;
-                    }
-                    data[i] = node;
+                    memcpy(newTable, indexTable, nCount * sizeof(T*));
+                    delete[]((char*)indexTable);
                 }
-                loaded = true;
+
+                indexTable = newTable;
+                nCount = id + 1;
             }
-            data[id] = t;
+
+            indexTable[id] = t;
         }
 
         /**
@@ -150,15 +159,24 @@ class DBCStorage
                 return false;
             }
 
-            DBCFileLoader dbc;
+            // records used in place have no strings
+            if (!m_dataTable)
+            {
+                return true;
+            }
+
+            DBCFileLoader* dbc = new DBCFileLoader;
             // Check if load was successful, only then continue
-            if (!dbc.Load(fn, fmt))
+            if (!dbc->Load(fn, fmt))
             {
+                delete dbc;
                 return false;
             }
 
             // load strings from another locale dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            m_stringPoolList.push_back(dbc->AutoProduceStrings(fmt, (char*)m_dataTable));
+
+            KeepOrDelete(dbc);
 
             return true;
         }
@@ -169,12 +187,6 @@ class DBCStorage
          */
         void Clear()
         {
-            if (loaded)
-            {
-                data.clear();
-                loaded = false;
-            }
-
             if (!indexTable)
             {
                 return;
@@ -190,6 +202,12 @@ class DBCStorage
                 delete[] m_stringPoolList.front();
                 m_stringPoolList.pop_front();
             }
+
+            while (!m_loaderList.empty())
+            {
+                delete m_loaderList.front();
+                m_loaderList.pop_front();
+            }
             nCount = 0;
         }
 
@@ -208,14 +226,30 @@ class DBCStorage
         void InsertEntry(T* entry, uint32 id) { assert(id < nCount && "Entry to be inserted must be in bounds!"); indexTable[id] = entry; }
 
     private:
+        /**
+         * @brief keeps a mapped file alive while the strings point into it
+         *
+         * @param dbc
+         */
+        void KeepOrDelete(DBCFileLoader* dbc)
+        {
+            if (dbc->IsMapped() && strchr(fmt, DBC_FF_STRING))
+            {
+                m_loaderList.push_back(dbc);
+            }
+            else
+            {
+                delete dbc;
+            }
+        }
+
         uint32 nCount; /**< TODO */
         uint32 fieldCount; /**< TODO */
         char const* fmt; /**< TODO */
         T** indexTable; /**< TODO */
         T* m_dataTable; /**< TODO */
-        std::map<uint32, T const*> data;
-        bool loaded;
         StringPoolList m_stringPoolList; /**< TODO */
+        LoaderList m_loaderList; /**< TODO */
 };
 
 #endif
@@ -26,6 +26,8 @@
 #include "Config/Config.h"
 #include "Database/SqlOperations.h"
 #include "GitRevision.h"
+#include "Utilities/Util.h"
+#include "Utilities/Timer.h"
 
 #include <ctime>
 #include <iostream>
@@ -34,6 +36,7 @@
 
 #define MIN_CONNECTION_POOL_SIZE 1
 #define MAX_CONNECTION_POOL_SIZE 16
+#define MAX_FORMAT_STATEMENTS 4096
 
 struct DBVersion
 {
@@ -114,10 +117,19 @@ bool SqlConnection::ExecuteStmt(int nIndex, const SqlStmtParameters& id)
 
     // get prepared statement object
     SqlPreparedStatement* pStmt = GetStmt(nIndex);
+
+    SqlStatementTimer timer(m_db);
     // bind parameters
     pStmt->bind(id);
     // execute statement
-    return pStmt->execute();
+    bool result = pStmt->execute();
+
+    if (timer.IsEnabled())
+    {
+        m_db.RecordStatementTime(this, nIndex, id, timer.GetElapsed());
+    }
+
+    return result;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -126,7 +138,7 @@ Database::~Database()
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -143,6 +155,30 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
     // 获取Ping配置
     m_pingIntervallms = sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000);
 
+    // rows folded into one multi-row INSERT inside transactions, 0 or 1 executes every INSERT on its own
+    int insertBatchRows = sConfig.GetIntDefault("InsertBatchRows", 50);
+    m_insertBatchRows = insertBatchRows > 1 ? uint32(insertBatchRows) : 0;
+
+    // numeric columns of SELECT results are fetched as numbers instead of being parsed from text
+    m_binaryQueryResults = sConfig.GetBoolDefault("BinaryQueryResults", true);
+
+    // statement timing, see RecordStatementTime
+    m_slowStatementTime = sConfig.GetIntDefault("SqlSlowStatementTime", 0);
+    m_stmtTimings = sConfig.GetBoolDefault("SqlStatementTimings", false);
+
+    // PExecute format strings used this often are executed as prepared statements
+    int formatStmtThreshold = sConfig.GetIntDefault("SqlFormatStatementThreshold", 8);
+    m_formatStmtThreshold = formatStmtThreshold > 0 ? uint32(formatStmtThreshold) : 0;
+
+    // statements of ExecuteCoalesced wait this long for a later one replacing them
+    int writeBehindInterval = sConfig.GetIntDefault("SqlWriteBehindInterval", 1000);
+    m_writeBehindInterval = writeBehindInterval > 0 ? uint32(writeBehindInterval) : 0;
+    m_writeBehindFlushTime = getMSTime();
+
+    // connection names of the slow statement log start with the database name
+    Tokens tokens = StrSplit(infoString, ";");
+    std::string dbName = tokens.size() > 4 ? tokens[4] : "";
+
     // create DB connections
 
     // 设置连接池大小
@@ -169,15 +205,34 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
             return false;
         }
 
+        pConn->SetName(dbName + " query " + std::to_string(i));
         m_pQueryConnections.push_back(pConn);
     }
 
     // 创建处理异步任务的数据库连接
-    m_pAsyncConn = CreateConnection();
-    if (!m_pAsyncConn->Initialize(infoString))
+    if (nAsyncConns < MIN_CONNECTION_POOL_SIZE)
     {
-        return false;
+        nAsyncConns = MIN_CONNECTION_POOL_SIZE;
+    }
+    else if (nAsyncConns > MAX_CONNECTION_POOL_SIZE)
+    {
+        nAsyncConns = MAX_CONNECTION_POOL_SIZE;
     }
+
+    for (int i = 0; i < nAsyncConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        pConn->SetName(dbName + " async " + std::to_string(i));
+        m_pAsyncConns.push_back(pConn);
+    }
+
+    m_pAsyncConn = m_pAsyncConns[0];
     // 创建线程安全的队列
     m_pResultQueue = new SqlResultQueue;
     // 初始化延迟线程
@@ -190,10 +245,15 @@ void Database::StopServer()
     HaltDelayThread();
 
     delete m_pResultQueue;
-    delete m_pAsyncConn;
+
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
+    {
+        delete m_pAsyncConns[i];
+    }
 
     m_pResultQueue = NULL;
     m_pAsyncConn = NULL;
+    m_pAsyncConns.clear();
 
     for (size_t i = 0; i < m_pQueryConnections.size(); ++i)
     {
@@ -203,38 +263,338 @@ void Database::StopServer()
     m_pQueryConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn, bool pingDatabase)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(conn);
+    return new SqlDelayThread(this, conn, pingDatabase);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(m_delayThreads.empty());
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
     m_TransStorage = new ACE_TSS<Database::TransHelper>();
-    m_delayThread = new ACE_Based::Thread(m_threadBody);
+
+    // New delay thread for delay execute, one per async connection
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
+    {
+        // the first thread keeps all the other connections alive
+        SqlDelayThread* threadBody = CreateDelayThread(m_pAsyncConns[i], i == 0);   // will deleted at thread delete
+        m_threadBodies.push_back(threadBody);
+        m_delayThreads.push_back(new ACE_Based::Thread(threadBody));
+    }
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread)
+    if (m_threadBodies.empty() || m_delayThreads.empty())
     {
         return;
     }
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
+    // the delay threads execute everything queued before they stop
+    FlushCoalesced();
+
+    for (size_t i = 0; i < m_threadBodies.size(); ++i)
+    {
+        m_threadBodies[i]->Stop();                          // Stop event
+    }
+
+    for (size_t i = 0; i < m_delayThreads.size(); ++i)
+    {
+        m_delayThreads[i]->wait();                          // Wait for flush to DB
+        delete m_delayThreads[i];                           // This also deletes the thread body
+    }
+
     delete m_TransStorage;
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = NULL;
-    m_threadBody = NULL;
+    m_delayThreads.clear();
+    m_threadBodies.clear();
     m_TransStorage=NULL;
 }
 
+SqlDelayThread* Database::GetDelayThread() const
+{
+    return m_threadBodies[GetOrderingKey() % m_threadBodies.size()];
+}
+
+void Database::SetOrderingKey(uint32 key)
+{
+    if (m_TransStorage)
+    {
+        (*m_TransStorage)->SetOrderingKey(key);
+    }
+}
+
+uint32 Database::GetOrderingKey() const
+{
+    return m_TransStorage ? (*m_TransStorage)->GetOrderingKey() : 0;
+}
+
+void Database::RecordStatementTime(SqlConnection* conn, const char* sql, uint32 us)
+{
+    if (m_slowStatementTime && us >= m_slowStatementTime * 1000)
+    {
+        sLog.outError("SQL: slow statement (%u ms on %s): %s", us / 1000, conn->GetName(), sql);
+    }
+}
+
+void Database::RecordStatementTime(SqlConnection* conn, int nIndex, const SqlStmtParameters& params, uint32 us)
+{
+    if (m_stmtTimings)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_stmtTimingsLock);
+
+        if (m_stmtTimingList.size() <= size_t(nIndex))
+        {
+            StmtTiming empty = { 0, 0, 0, 0 };
+            m_stmtTimingList.resize(nIndex + 1, empty);
+        }
+
+        StmtTiming& timing = m_stmtTimingList[nIndex];
+        ++timing.calls;
+        timing.totalUs += us;
+        timing.maxUs = std::max(timing.maxUs, us);
+    }
+
+    if (m_slowStatementTime && us >= m_slowStatementTime * 1000)
+    {
+        // the parameters are shown bound into the statement text
+        SqlPlainPreparedStatement text(GetStmtString(nIndex), *conn);
+        text.bind(params);
+        sLog.outError("SQL: slow statement (%u ms on %s, prepared statement %i): %s", us / 1000, conn->GetName(), nIndex, text.plainRequest().c_str());
+    }
+}
+
+void Database::GetStmtTimings(std::vector<StmtTiming>& timings) const
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_stmtTimingsLock);
+
+    for (size_t i = 0; i < m_stmtTimingList.size(); ++i)
+    {
+        if (m_stmtTimingList[i].calls)
+        {
+            timings.push_back(m_stmtTimingList[i]);
+            timings.back().index = int(i);
+        }
+    }
+}
+
+void Database::ResetStmtTimings()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_stmtTimingsLock);
+    m_stmtTimingList.clear();
+}
+
+/**
+ * @brief convert a PExecute format string into prepared statement SQL
+ *
+ * Only INSERT, UPDATE, DELETE and REPLACE statements with plain numeric
+ * conversions (%d, %i, %u, %f and their l, ll, I64 variants) qualify. A conversion
+ * may be quoted on its own ('%u'), the quotes are dropped. %s arguments are passed
+ * already escaped by the callers, so formats using them stay plain SQL.
+ *
+ * @param format
+ * @param sql format with '?' for every argument
+ * @param types argument types in format order
+ * @return bool
+ */
+static bool ParseFormatStatement(const char* format, std::string& sql, std::vector<SqlStmtFieldType>& types)
+{
+    const char* start = format;
+    while (isspace(*start))
+    {
+        ++start;
+    }
+
+    if (strnicmp(start, "INSERT", 6) && strnicmp(start, "UPDATE", 6) && strnicmp(start, "DELETE", 6) && strnicmp(start, "REPLACE", 7))
+    {
+        return false;
+    }
+
+    char quote = 0;
+
+    for (const char* c = format; *c; ++c)
+    {
+        if (*c == '?')
+        {
+            return false;
+        }
+
+        if (*c != '%')
+        {
+            if (quote && *c == '\\' && c[1])
+            {
+                sql += *c++;
+            }
+            else if (*c == quote)
+            {
+                quote = 0;
+            }
+            else if (!quote && (*c == '\'' || *c == '"'))
+            {
+                quote = *c;
+            }
+
+            sql += *c;
+            continue;
+        }
+
+        ++c;
+
+        if (*c == '%')
+        {
+            sql += '%';
+            continue;
+        }
+
+        int longs = 0;
+        if (c[0] == 'I' && c[1] == '6' && c[2] == '4')
+        {
+            longs = 2;
+            c += 3;
+        }
+        else
+        {
+            for (; *c == 'l'; ++c)
+            {
+                ++longs;
+            }
+        }
+
+        bool wide = longs > 1 || (longs == 1 && sizeof(long) == sizeof(int64));
+
+        switch (*c)
+        {
+            case 'd':
+            case 'i':
+                types.push_back(wide ? FIELD_I64 : FIELD_I32);
+                break;
+            case 'u':
+                types.push_back(wide ? FIELD_UI64 : FIELD_UI32);
+                break;
+            case 'f':
+            case 'g':
+            case 'e':
+                if (longs)
+                {
+                    return false;
+                }
+                types.push_back(FIELD_DOUBLE);
+                break;
+            default:
+                // %s, %c, width, precision and flags
+                return false;
+        }
+
+        if (quote)
+        {
+            // only a conversion quoted on its own can be bound
+            if (sql.empty() || sql[sql.size() - 1] != quote || c[1] != quote)
+            {
+                return false;
+            }
+
+            sql.erase(sql.size() - 1);
+            quote = 0;
+            ++c;
+        }
+
+        sql += '?';
+    }
+
+    return !quote && !types.empty();
+}
+
+bool Database::ExecuteFormatStmt(const char* format, va_list ap, bool& result)
+{
+    SqlStatementID id;
+    std::vector<SqlStmtFieldType> types;
+
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_formatStmtLock, false);
+
+        FormatStmtMap::iterator itr = m_formatStmts.find(format);
+        if (itr == m_formatStmts.end())
+        {
+            // formats built at runtime each get their own address, do not let them grow the map forever
+            if (m_formatStmts.size() >= MAX_FORMAT_STATEMENTS)
+            {
+                return false;
+            }
+
+            itr = m_formatStmts.insert(FormatStmtMap::value_type(format, FormatStmt())).first;
+            itr->second.format = format;
+            itr->second.usable = ParseFormatStatement(format, itr->second.sql, itr->second.types);
+        }
+
+        FormatStmt& stmt = itr->second;
+
+        // the address of a reused buffer may hold another format now
+        if (!stmt.usable || stmt.format != format)
+        {
+            return false;
+        }
+
+        if (!stmt.id.initialized())
+        {
+            if (++stmt.uses < m_formatStmtThreshold)
+            {
+                return false;
+            }
+
+            CreateStatement(stmt.id, stmt.sql.c_str());
+        }
+
+        ++m_formatStmtHits;
+
+        id = stmt.id;
+        types = stmt.types;
+    }
+
+    SqlStmtParameters* params = new SqlStmtParameters(types.size());
+
+    for (std::vector<SqlStmtFieldType>::const_iterator itr = types.begin(); itr != types.end(); ++itr)
+    {
+        switch (*itr)
+        {
+            case FIELD_I32:    params->addParam(SqlStmtFieldData(int32(va_arg(ap, int)))); break;
+            case FIELD_UI32:   params->addParam(SqlStmtFieldData(uint32(va_arg(ap, unsigned int)))); break;
+            case FIELD_I64:    params->addParam(SqlStmtFieldData(int64(va_arg(ap, int64)))); break;
+            case FIELD_UI64:   params->addParam(SqlStmtFieldData(uint64(va_arg(ap, uint64)))); break;
+            default:           params->addParam(SqlStmtFieldData(va_arg(ap, double))); break;
+        }
+    }
+
+    result = ExecuteStmt(id, params);
+    return true;
+}
+
+void Database::GetFormatStmtStats(uint32& statements, uint64& hits) const
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_formatStmtLock);
+
+    statements = 0;
+    for (FormatStmtMap::const_iterator itr = m_formatStmts.begin(); itr != m_formatStmts.end(); ++itr)
+    {
+        if (itr->second.id.initialized())
+        {
+            ++statements;
+        }
+    }
+
+    hits = m_formatStmtHits;
+}
+
+void Database::GetAsyncQueueSizes(std::vector<uint32>& sizes) const
+{
+    sizes.clear();
+
+    for (size_t i = 0; i < m_threadBodies.size(); ++i)
+    {
+        sizes.push_back(m_threadBodies[i]->GetQueueSize());
+    }
+}
+
 void Database::ThreadStart()
 {
 }
@@ -249,6 +609,11 @@ void Database::ProcessResultQueue()
     {
         m_pResultQueue->Update();
     }
+
+    if (m_writeBehindInterval && getMSTimeDiff(m_writeBehindFlushTime, getMSTime()) >= m_writeBehindInterval)
+    {
+        FlushCoalesced();
+    }
 }
 
 void Database::escape_string(std::string& str)
@@ -365,6 +730,28 @@ QueryResult* Database::PQuery(const char* format, ...)
     return Query(szQuery);
 }
 
+QueryResult* Database::PQueryStream(const char* format, ...)
+{
+    if (!format)
+    {
+        return NULL;
+    }
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return NULL;
+    }
+
+    return QueryStream(szQuery);
+}
+
 QueryNamedResult* Database::PQueryNamed(const char* format, ...)
 {
     if (!format)
@@ -409,7 +796,7 @@ bool Database::Execute(const char* sql)
         }
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        GetDelayThread()->Delay(new SqlPlainRequest(sql));
     }
 
     return true;
@@ -423,6 +810,20 @@ bool Database::PExecute(const char* format, ...)
     }
 
     va_list ap;
+
+    if (m_formatStmtThreshold)
+    {
+        bool result = false;
+        va_start(ap, format);
+        bool prepared = ExecuteFormatStmt(format, ap, result);
+        va_end(ap);
+
+        if (prepared)
+        {
+            return result;
+        }
+    }
+
     char szQuery [MAX_QUERY_LEN];
     va_start(ap, format);
     int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
@@ -437,6 +838,85 @@ bool Database::PExecute(const char* format, ...)
     return Execute(szQuery);
 }
 
+bool Database::ExecuteCoalesced(const char* key, uint32 id, const char* sql)
+{
+    // statements of a transaction must stay in it
+    if (!m_writeBehindInterval || !m_bAllowAsyncTransactions || !m_TransStorage || (*m_TransStorage)->get())
+    {
+        return Execute(sql);
+    }
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_writeBehindLock, false);
+
+    CoalescedKey rowKey(key, id);
+
+    CoalescedIndex::iterator itr = m_writeBehindIndex.find(rowKey);
+    if (itr != m_writeBehindIndex.end())
+    {
+        // the replacing statement goes to the end, keeping the order of the latest calls
+        m_writeBehindList.erase(itr->second);
+        ++m_writeBehindCoalesced;
+    }
+
+    m_writeBehindIndex[rowKey] = m_writeBehindList.insert(m_writeBehindList.end(), CoalescedList::value_type(rowKey, sql));
+    return true;
+}
+
+bool Database::PExecuteCoalesced(const char* key, uint32 id, const char* format, ...)
+{
+    if (!format)
+    {
+        return false;
+    }
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return false;
+    }
+
+    return ExecuteCoalesced(key, id, szQuery);
+}
+
+void Database::FlushCoalesced()
+{
+    CoalescedList statements;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_writeBehindLock);
+        statements.swap(m_writeBehindList);
+        m_writeBehindIndex.clear();
+        m_writeBehindFlushTime = getMSTime();
+    }
+
+    if (statements.empty())
+    {
+        return;
+    }
+
+    BeginTransaction();
+
+    for (CoalescedList::const_iterator itr = statements.begin(); itr != statements.end(); ++itr)
+    {
+        Execute(itr->second.c_str());
+    }
+
+    CommitTransaction();
+}
+
+void Database::GetCoalescedStats(uint32& buffered, uint64& coalesced) const
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_writeBehindLock);
+    buffered = uint32(m_writeBehindList.size());
+    coalesced = m_writeBehindCoalesced;
+}
+
 bool Database::DirectPExecute(const char* format, ...)
 {
     if (!format)
@@ -492,10 +972,15 @@ bool Database::CommitTransaction()
     }
 
     // add SqlTransaction to the async queue
-    m_threadBody->Delay((*m_TransStorage)->detach());
+    GetDelayThread()->Delay((*m_TransStorage)->detach());
     return true;
 }
 
+bool Database::IsInTransaction()
+{
+    return m_pAsyncConn && (*m_TransStorage)->get();
+}
+
 bool Database::CommitTransactionDirect()
 {
     if (!m_pAsyncConn)
@@ -689,7 +1174,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
         }
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        GetDelayThread()->Delay(new SqlPreparedRequest(id.ID(), params));
     }
 
     return true;
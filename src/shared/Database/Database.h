@@ -34,6 +34,8 @@
 #include <ace/Atomic_Op.h>
 #include "SqlPreparedStatement.h"
 
+#include <chrono>
+
 class SqlTransaction;
 class SqlResultQueue;
 class SqlQueryHolder;
@@ -85,6 +87,15 @@ class SqlConnection
          * @return QueryNamedResult
          */
         virtual QueryNamedResult* QueryNamed(const char* sql) = 0;
+        /**
+         * @brief query whose rows are read from the server while they are fetched
+         *
+         * Drivers without streaming support buffer the result like Query().
+         *
+         * @param sql
+         * @return QueryResult
+         */
+        virtual QueryResult* QueryStream(const char* sql) { return Query(sql); }
 
         /**
          * @brief public methods for making requests
@@ -169,6 +180,19 @@ class SqlConnection
          */
         Database& DB() { return m_db; }
 
+        /**
+         * @brief name of the connection used by the slow statement log
+         *
+         * @return const char
+         */
+        const char* GetName() const { return m_name.c_str(); }
+        /**
+         * @brief
+         *
+         * @param name
+         */
+        void SetName(const std::string& name) { m_name = name; }
+
     protected:
         /**
          * @brief
@@ -193,6 +217,7 @@ class SqlConnection
         SqlPreparedStatement* GetStmt(uint32 nIndex);
 
         Database& m_db; /**< TODO */
+        std::string m_name; /**< e.g. "mangos query 0" */
 
         /**
          * @brief free prepared statements objects
@@ -201,6 +226,8 @@ class SqlConnection
         void FreePreparedStatements();
 
     private:
+        friend class QueryResultMysqlStream;                // keeps the connection locked while its rows are read
+
         /**
          * @brief
          *
@@ -233,9 +260,10 @@ class Database
          * @brief 初始化数据库
          * @param infoString 数据库信息
          * @param nConns 连接数量
+         * @param nAsyncConns number of async connections, each with its own delay thread
          * @return 
         */
-        virtual bool Initialize(const char* infoString, int nConns = 1);
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
         /**
          * @brief start worker thread for async DB request execution
          *
@@ -271,6 +299,24 @@ class Database
             return guard->QueryNamed(sql);
         }
 
+        /**
+         * @brief Synchronous DB query for bulk loads, the rows are not buffered on the client
+         *
+         * The rows are read from the server as NextRow() reaches them, so a big
+         * table never sits in memory twice. The query connection stays locked
+         * until the result is deleted: delete it on the calling thread and send
+         * no other query to this database before that. GetRowCount() of the
+         * result is 0, count the rows separately where needed.
+         *
+         * @param sql
+         * @return QueryResult
+         */
+        inline QueryResult* QueryStream(const char* sql)
+        {
+            SqlConnection::Lock guard(getQueryConnection());
+            return guard->QueryStream(sql);
+        }
+
         /**
          * @brief
          *
@@ -278,6 +324,13 @@ class Database
          * @return QueryResult
          */
         QueryResult* PQuery(const char* format, ...) ATTR_PRINTF(2, 3);
+        /**
+         * @brief
+         *
+         * @param format...
+         * @return QueryResult
+         */
+        QueryResult* PQueryStream(const char* format, ...) ATTR_PRINTF(2, 3);
         /**
          * @brief
          *
@@ -548,6 +601,35 @@ class Database
          */
         bool PExecuteLog(const char* format, ...) ATTR_PRINTF(2, 3);
 
+        /**
+         * @brief write-behind execution of a statement that overwrites one row
+         *
+         * The statement is kept for up to SqlWriteBehindInterval ms. A later statement
+         * with the same key and id replaces it, so only the latest one is executed.
+         * Buffered statements are executed in the order of their latest call, in one
+         * transaction per flush. Inside a transaction the statement is executed at once.
+         *
+         * @param key literal naming the row and columns written, e.g. "characters.online by account"
+         * @param id row id
+         * @param sql
+         * @return bool
+         */
+        bool ExecuteCoalesced(const char* key, uint32 id, const char* sql);
+        /**
+         * @brief
+         *
+         * @param key
+         * @param id
+         * @param format...
+         * @return bool
+         */
+        bool PExecuteCoalesced(const char* key, uint32 id, const char* format, ...) ATTR_PRINTF(4, 5);
+        /**
+         * @brief hand all buffered write-behind statements to the async connections
+         *
+         */
+        void FlushCoalesced();
+
         /**
          * @brief
          *
@@ -566,6 +648,12 @@ class Database
          * @return bool
          */
         bool RollbackTransaction();
+        /**
+         * @brief check for a transaction opened by the current thread
+         *
+         * @return bool
+         */
+        bool IsInTransaction();
         /**
          * @brief for sync transaction execution
          *
@@ -635,6 +723,19 @@ class Database
          */
         uint32 GetPingIntervall() { return m_pingIntervallms; }
 
+        /**
+         * @brief maximum rows folded into one multi-row INSERT inside a transaction
+         *
+         * @return uint32 0 if INSERTs are not folded
+         */
+        uint32 GetInsertBatchRows() const { return m_insertBatchRows; }
+        /**
+         * @brief whether SELECTs read their rows with the binary protocol
+         *
+         * @return bool
+         */
+        bool UseBinaryQueryResults() const { return m_binaryQueryResults; }
+
         /**
          * @brief function to ping database connections
          *
@@ -651,6 +752,94 @@ class Database
          */
         void AllowAsyncTransactions() { m_bAllowAsyncTransactions = true; }
 
+        /**
+         * @brief route the async requests of the calling thread by key
+         *
+         * Requests with the same key are executed in order by the same delay thread,
+         * requests with different keys may run in parallel. Key 0 (the default) is
+         * the delay thread of all requests not routed otherwise.
+         * \see SqlOrderingGuard
+         *
+         * @param key ordering key, e.g. the character guid or account id the requests write
+         */
+        void SetOrderingKey(uint32 key);
+        /**
+         * @brief ordering key of the calling thread
+         *
+         * @return uint32
+         */
+        uint32 GetOrderingKey() const;
+
+        /**
+         * @brief number of statements waiting for each delay thread
+         *
+         * @param sizes
+         */
+        void GetAsyncQueueSizes(std::vector<uint32>& sizes) const;
+
+        /**
+         * @brief collected execution times of one prepared statement
+         *
+         */
+        struct StmtTiming
+        {
+            int index;                                      ///< prepared statement id, see GetStmtString()
+            uint32 calls;
+            uint64 totalUs;
+            uint32 maxUs;
+        };
+
+        /**
+         * @brief whether the connections measure the time of their statements
+         *
+         * @return bool
+         */
+        bool IsTimingStatements() const { return m_slowStatementTime || m_stmtTimings; }
+        /**
+         * @brief called by a connection after a plain SQL statement
+         *
+         * @param conn
+         * @param sql
+         * @param us execution time in microseconds
+         */
+        void RecordStatementTime(SqlConnection* conn, const char* sql, uint32 us);
+        /**
+         * @brief called by a connection after a prepared statement
+         *
+         * @param conn
+         * @param nIndex
+         * @param params
+         * @param us execution time in microseconds
+         */
+        void RecordStatementTime(SqlConnection* conn, int nIndex, const SqlStmtParameters& params, uint32 us);
+        /**
+         * @brief execution times of all prepared statements executed since the last reset
+         *
+         * @param timings
+         */
+        void GetStmtTimings(std::vector<StmtTiming>& timings) const;
+        /**
+         * @brief
+         *
+         */
+        void ResetStmtTimings();
+
+        /**
+         * @brief usage of the PExecute format strings executed as prepared statements
+         *
+         * @param statements format strings turned into prepared statements
+         * @param hits PExecute calls executed through them
+         */
+        void GetFormatStmtStats(uint32& statements, uint64& hits) const;
+
+        /**
+         * @brief usage of the write-behind buffer
+         *
+         * @param buffered statements currently waiting for the flush
+         * @param coalesced statements replaced by a later one since start
+         */
+        void GetCoalescedStats(uint32& buffered, uint64& coalesced) const;
+
     protected:
         /**
          * @brief
@@ -658,8 +847,10 @@ class Database
          */
         Database() :
             m_TransStorage(NULL),m_nQueryConnPoolSize(1), m_pAsyncConn(NULL), m_pResultQueue(NULL),
-            m_threadBody(NULL), m_delayThread(NULL), m_bAllowAsyncTransactions(false),
-            m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
+            m_bAllowAsyncTransactions(false),
+            m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0), m_insertBatchRows(0), m_binaryQueryResults(false),
+            m_slowStatementTime(0), m_stmtTimings(false), m_formatStmtThreshold(0), m_formatStmtHits(0),
+            m_writeBehindInterval(0), m_writeBehindFlushTime(0), m_writeBehindCoalesced(0)
         {
             m_nQueryCounter = -1;
         }
@@ -679,9 +870,17 @@ class Database
         /**
          * @brief factory method to create SqlDelayThread objects
          *
+         * @param conn async connection used by the thread
+         * @param pingDatabase the thread also keeps the other connections alive
+         * @return SqlDelayThread
+         */
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn, bool pingDatabase);
+        /**
+         * @brief delay thread for the ordering key of the calling thread
+         *
          * @return SqlDelayThread
          */
-        virtual SqlDelayThread* CreateDelayThread();
+        SqlDelayThread* GetDelayThread() const;
 
         /**
          * @brief
@@ -694,7 +893,7 @@ class Database
                  * @brief
                  *
                  */
-                TransHelper() : m_pTrans(NULL) {}
+                TransHelper() : m_pTrans(NULL), m_orderingKey(0) {}
                 /**
                  * @brief
                  *
@@ -729,8 +928,16 @@ class Database
                  */
                 void reset();
 
+                /**
+                 * @brief ordering key of the async requests of this thread
+                 *
+                 */
+                uint32 GetOrderingKey() const { return m_orderingKey; }
+                void SetOrderingKey(uint32 key) { m_orderingKey = key; }
+
             private:
                 SqlTransaction* m_pTrans; /**< TODO */
+                uint32 m_orderingKey; /**< TODO */
         };
 
         /**
@@ -784,12 +991,13 @@ class Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections; /**< TODO */
 
-        // only one single DB connection for transactions
+        // DB connection for direct transactions, also used by the first delay thread
         SqlConnection* m_pAsyncConn; /**< TODO */
+        SqlConnectionContainer m_pAsyncConns;               /**< one connection per delay thread, m_pAsyncConn first */
 
         SqlResultQueue*     m_pResultQueue;                 /**< Transaction queues from diff. threads */
-        SqlDelayThread*     m_threadBody;                   /**< Pointer to delay sql executer (owned by m_delayThread) */
-        ACE_Based::Thread*  m_delayThread;                  /**< Pointer to executer thread */
+        std::vector<SqlDelayThread*> m_threadBodies;        /**< delay sql executers (owned by m_delayThreads) */
+        std::vector<ACE_Based::Thread*> m_delayThreads;     /**< executer threads */
 
         bool m_bAllowAsyncTransactions;                     /**< flag which specifies if async transactions are enabled */
 
@@ -821,5 +1029,95 @@ class Database
         bool m_logSQL; /**< TODO */
         std::string m_logsDir; /**< TODO */
         uint32 m_pingIntervallms; /**< TODO */
+        uint32 m_insertBatchRows; /**< max rows of a folded multi-row INSERT, 0 - disabled */
+        bool m_binaryQueryResults; /**< fetch SELECT results as native values through prepared statements */
+
+        uint32 m_slowStatementTime; /**< statements taking at least this long (in ms) are logged, 0 - disabled */
+        bool m_stmtTimings; /**< collect execution times per prepared statement */
+        mutable ACE_Thread_Mutex m_stmtTimingsLock; /**< guards m_stmtTimingList, the connections run in parallel */
+        std::vector<StmtTiming> m_stmtTimingList; /**< indexed by prepared statement id */
+
+        /**
+         * @brief PExecute format string, turned into a prepared statement once it was used often enough
+         *
+         */
+        struct FormatStmt
+        {
+            FormatStmt() : usable(false), uses(0) {}
+
+            std::string format;                             ///< copy of the format, the key is only its address
+            bool usable;                                    ///< format has only numeric arguments outside of string literals
+            std::string sql;                                ///< format with '?' for every argument
+            std::vector<SqlStmtFieldType> types;            ///< argument types in format order
+            uint32 uses;
+            SqlStatementID id;
+        };
+
+        /**
+         * @brief execute a PExecute call as prepared statement, if its format string is hot
+         *
+         * @param format
+         * @param ap arguments of the format, consumed only if the call returns true
+         * @param result result of the execution
+         * @return bool false if the request must be executed as plain SQL
+         */
+        bool ExecuteFormatStmt(const char* format, va_list ap, bool& result);
+
+        typedef UNORDERED_MAP<const char*, FormatStmt> FormatStmtMap;
+
+        uint32 m_formatStmtThreshold; /**< PExecute calls of a format string before it is prepared, 0 - disabled */
+        mutable ACE_Thread_Mutex m_formatStmtLock; /**< guards m_formatStmts and m_formatStmtHits */
+        FormatStmtMap m_formatStmts;
+        uint64 m_formatStmtHits;
+
+        typedef std::pair<const char*, uint32> CoalescedKey;
+        typedef std::list<std::pair<CoalescedKey, std::string> > CoalescedList;
+        typedef std::map<CoalescedKey, CoalescedList::iterator> CoalescedIndex;
+
+        uint32 m_writeBehindInterval; /**< ms a coalesced statement waits at most, 0 - disabled */
+        uint32 m_writeBehindFlushTime; /**< getMSTime() of the last flush */
+        mutable ACE_Thread_Mutex m_writeBehindLock; /**< guards the write-behind buffer */
+        CoalescedList m_writeBehindList; /**< statements in the order of their latest call */
+        CoalescedIndex m_writeBehindIndex;
+        uint64 m_writeBehindCoalesced;
+};
+
+/**
+ * @brief measures one statement if the database is timing its statements
+ *
+ */
+class SqlStatementTimer
+{
+    public:
+        explicit SqlStatementTimer(Database& db) : m_enabled(db.IsTimingStatements())
+        {
+            if (m_enabled)
+            {
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+
+        bool IsEnabled() const { return m_enabled; }
+        uint32 GetElapsed() const { return uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count()); }
+
+    private:
+        bool m_enabled;
+        std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief routes the async requests of the current thread by an ordering key while in scope
+ *
+ * \see Database::SetOrderingKey
+ */
+class SqlOrderingGuard
+{
+    public:
+        SqlOrderingGuard(Database& db, uint32 key) : m_db(db), m_prevKey(db.GetOrderingKey()) { m_db.SetOrderingKey(key); }
+        ~SqlOrderingGuard() { m_db.SetOrderingKey(m_prevKey); }
+
+    private:
+        Database& m_db;
+        uint32 m_prevKey;
 };
 #endif
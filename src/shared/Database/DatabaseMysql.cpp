@@ -200,7 +200,7 @@ bool MySQLConnection::Initialize(const char* infoString)
     return true;
 }
 
-bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount)
+bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount, bool stream)
 {
     if (!mMysql)
     {
@@ -208,6 +208,7 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
     }
 
     uint32 _s = getMSTime();
+    SqlStatementTimer timer(m_db);
 
     if (mysql_query(mMysql, sql))
     {
@@ -220,16 +221,22 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
         DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", getMSTimeDiff(_s, getMSTime()), sql);
     }
 
-    *pResult = mysql_store_result(mMysql);
-    *pRowCount = mysql_affected_rows(mMysql);
+    *pResult = stream ? mysql_use_result(mMysql) : mysql_store_result(mMysql);
+    *pRowCount = stream ? 0 : mysql_affected_rows(mMysql);
     *pFieldCount = mysql_field_count(mMysql);
 
+    if (timer.IsEnabled())
+    {
+        m_db.RecordStatementTime(this, sql, timer.GetElapsed());
+    }
+
     if (!*pResult)
     {
         return false;
     }
 
-    if (!*pRowCount)
+    // the row count of a streamed result is only known after the last row
+    if (!stream && !*pRowCount)
     {
         mysql_free_result(*pResult);
         return false;
@@ -239,8 +246,78 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
     return true;
 }
 
+QueryResult* MySQLConnection::_QueryStmt(const char* sql, bool& prepared)
+{
+    prepared = false;
+
+    if (!mMysql)
+    {
+        return NULL;
+    }
+
+    uint32 _s = getMSTime();
+    SqlStatementTimer timer(m_db);
+
+    MYSQL_STMT* stmt = mysql_stmt_init(mMysql);
+    if (!stmt)
+    {
+        return NULL;
+    }
+
+    // statements the server can't prepare are left to the text protocol, which reports the error
+    MYSQL_RES* metadata = NULL;
+    if (mysql_stmt_prepare(stmt, sql, strlen(sql)) || mysql_stmt_param_count(stmt) ||
+        !(metadata = mysql_stmt_result_metadata(stmt)))
+    {
+        mysql_stmt_close(stmt);
+        return NULL;
+    }
+
+    prepared = true;
+
+    if (mysql_stmt_execute(stmt))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_stmt_error(stmt));
+        mysql_free_result(metadata);
+        mysql_stmt_close(stmt);
+        return NULL;
+    }
+
+    QueryResultMysqlStmt* queryResult = new QueryResultMysqlStmt(stmt, metadata);
+
+    mysql_free_result(metadata);
+    mysql_stmt_close(stmt);
+
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", getMSTimeDiff(_s, getMSTime()), sql);
+
+    if (timer.IsEnabled())
+    {
+        m_db.RecordStatementTime(this, sql, timer.GetElapsed());
+    }
+
+    if (!queryResult->IsValid() || !queryResult->GetRowCount())
+    {
+        delete queryResult;
+        return NULL;
+    }
+
+    queryResult->NextRow();
+    return queryResult;
+}
+
 QueryResult* MySQLConnection::Query(const char* sql)
 {
+    if (m_db.UseBinaryQueryResults() && strnicmp(sql, "select", 6) == 0)
+    {
+        bool prepared;
+        QueryResult* queryResult = _QueryStmt(sql, prepared);
+        if (prepared)
+        {
+            return queryResult;
+        }
+    }
+
     MYSQL_RES* result = NULL;
     MYSQL_FIELD* fields = NULL;
     uint64 rowCount = 0;
@@ -257,6 +334,30 @@ QueryResult* MySQLConnection::Query(const char* sql)
     return queryResult;
 }
 
+QueryResult* MySQLConnection::QueryStream(const char* sql)
+{
+    MYSQL_RES* result = NULL;
+    MYSQL_FIELD* fields = NULL;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+
+    if (!_Query(sql, &result, &fields, &rowCount, &fieldCount, true))
+    {
+        return NULL;
+    }
+
+    QueryResultMysqlStream* queryResult = new QueryResultMysqlStream(*this, mMysql, result, fields, fieldCount);
+
+    // an empty result is only noticed at the first fetch
+    if (!queryResult->NextRow())
+    {
+        delete queryResult;
+        return NULL;
+    }
+
+    return queryResult;
+}
+
 QueryNamedResult* MySQLConnection::QueryNamed(const char* sql)
 {
     MYSQL_RES* result = NULL;
@@ -290,6 +391,7 @@ bool MySQLConnection::Execute(const char* sql)
 
     {
         uint32 _s = getMSTime();
+        SqlStatementTimer timer(m_db);
 
         if (mysql_query(mMysql, sql))
         {
@@ -301,6 +403,11 @@ bool MySQLConnection::Execute(const char* sql)
         {
             DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", getMSTimeDiff(_s, getMSTime()), sql);
         }
+
+        if (timer.IsEnabled())
+        {
+            m_db.RecordStatementTime(this, sql, timer.GetElapsed());
+        }
         // end guarded block
     }
 
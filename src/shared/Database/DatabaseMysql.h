@@ -153,6 +153,13 @@ class MySQLConnection : public SqlConnection
          * @return QueryNamedResult
          */
         QueryNamedResult* QueryNamed(const char* sql) override;
+        /**
+         * @brief text protocol query read with mysql_use_result
+         *
+         * @param sql
+         * @return QueryResult
+         */
+        QueryResult* QueryStream(const char* sql) override;
         /**
          * @brief
          *
@@ -215,9 +222,18 @@ class MySQLConnection : public SqlConnection
          * @param pFields
          * @param pRowCount
          * @param pFieldCount
+         * @param stream rows stay on the server until fetched, *pRowCount is then 0
          * @return bool
          */
-        bool _Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount);
+        bool _Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount, bool stream = false);
+        /**
+         * @brief run a query through a prepared statement and fetch its rows in binary form
+         *
+         * @param sql
+         * @param prepared false if the server could not prepare sql and the text protocol has to be used
+         * @return QueryResult
+         */
+        QueryResult* _QueryStmt(const char* sql, bool& prepared);
 
         MYSQL* mMysql; /**< TODO */
 };
@@ -53,14 +53,14 @@ class Field
          * @brief
          *
          */
-        Field() : mValue(NULL), mType(MYSQL_TYPE_NULL) {}
+        Field() : mValue(NULL), mType(MYSQL_TYPE_NULL), mNativeType(NATIVE_NONE) {}
         /**
          * @brief
          *
          * @param value
          * @param type
          */
-        Field(const char* value, enum_field_types type) : mValue(value), mType(type) {}
+        Field(const char* value, enum_field_types type) : mValue(value), mType(type), mNativeType(NATIVE_NONE) {}
 
         /**
          * @brief
@@ -79,14 +79,14 @@ class Field
          *
          * @return bool
          */
-        bool IsNULL() const { return mValue == NULL; }
+        bool IsNULL() const { return mValue == NULL && mNativeType == NATIVE_NONE; }
 
         /**
          * @brief
          *
          * @return const char
          */
-        const char* GetString() const { return mValue; }
+        const char* GetString() const { return mNativeType == NATIVE_NONE ? mValue : NativeToString(); }
         /**
          * @brief
          *
@@ -94,62 +94,103 @@ class Field
          */
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            const char* value = GetString();
+            return value ? value : "";                      // std::string s = 0 have undefine result in C++
         }
         /**
          * @brief
          *
          * @return float
          */
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
+        float GetFloat() const
+        {
+            if (mNativeType != NATIVE_NONE)
+            {
+                return static_cast<float>(GetNativeDouble());
+            }
+
+            return mValue ? static_cast<float>(atof(mValue)) : 0.0f;
+        }
         /**
          * @brief
          *
          * @return bool
          */
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
+        bool GetBool() const
+        {
+            if (mNativeType != NATIVE_NONE)
+            {
+                return static_cast<int32>(GetNativeInteger()) > 0;
+            }
+
+            return mValue ? atoi(mValue) > 0 : false;
+        }
         /**
         * @brief
         *
         * @return double
         */
-        double GetDouble() const { return mValue ? static_cast<double>(atof(mValue)) : 0.0f; }
+        double GetDouble() const
+        {
+            if (mNativeType != NATIVE_NONE)
+            {
+                return GetNativeDouble();
+            }
+
+            return mValue ? static_cast<double>(atof(mValue)) : 0.0f;
+        }
         /**
         * @brief
         *
         * @return int8
         */
-        int8 GetInt8() const { return mValue ? static_cast<int8>(atol(mValue)) : int8(0); }
+        int8 GetInt8() const { return static_cast<int8>(GetInt32()); }
         /**
          * @brief
          *
          * @return int32
          */
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
+        int32 GetInt32() const
+        {
+            if (mNativeType != NATIVE_NONE)
+            {
+                return static_cast<int32>(GetNativeInteger());
+            }
+
+            return mValue ? static_cast<int32>(atol(mValue)) : int32(0);
+        }
         /**
          * @brief
          *
          * @return uint8
          */
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
+        uint8 GetUInt8() const { return static_cast<uint8>(GetInt32()); }
         /**
          * @brief
          *
          * @return uint16
          */
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
+        uint16 GetUInt16() const { return static_cast<uint16>(GetInt32()); }
         /**
          * @brief
          *
          * @return int16
          */
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
+        int16 GetInt16() const { return static_cast<int16>(GetInt32()); }
         /**
          * @brief
          *
          * @return uint32
          */
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atol(mValue)) : uint32(0); }
+        uint32 GetUInt32() const
+        {
+            if (mNativeType != NATIVE_NONE)
+            {
+                return static_cast<uint32>(GetNativeInteger());
+            }
+
+            return mValue ? static_cast<uint32>(atol(mValue)) : uint32(0);
+        }
         /**
          * @brief
          *
@@ -157,6 +198,11 @@ class Field
          */
         uint64 GetUInt64() const
         {
+            if (mNativeType != NATIVE_NONE)
+            {
+                return static_cast<uint64>(GetNativeInteger());
+            }
+
             uint64 value = 0;
             if (!mValue || sscanf(mValue, UI64FMTD, &value) == -1)
             {
@@ -172,6 +218,11 @@ class Field
         */
         uint64 GetInt64() const
         {
+            if (mNativeType != NATIVE_NONE)
+            {
+                return static_cast<uint64>(GetNativeInteger());
+            }
+
             int64 value = 0;
             if (!mValue || sscanf(mValue, SI64FMTD, &value) == -1)
             {
@@ -195,9 +246,83 @@ class Field
          *
          * @param value
          */
-        void SetValue(const char* value) { mValue = value; }
+        void SetValue(const char* value) { mValue = value; mNativeType = NATIVE_NONE; }
+
+        /**
+         * @brief store an integer fetched in binary form, no string is parsed by the getters
+         *
+         * @param value
+         * @param isUnsigned
+         */
+        void SetNativeInteger(int64 value, bool isUnsigned)
+        {
+            mValue = NULL;
+            mNativeType = isUnsigned ? NATIVE_UNSIGNED : NATIVE_INTEGER;
+            mNative.i = value;
+        }
+
+        /**
+         * @brief store a floating point value fetched in binary form
+         *
+         * @param value
+         */
+        void SetNativeDouble(double value)
+        {
+            mValue = NULL;
+            mNativeType = NATIVE_DOUBLE;
+            mNative.d = value;
+        }
 
     private:
+        /**
+         * @brief kind of the value held in mNative, NATIVE_NONE if the field is a string (or NULL)
+         *
+         */
+        enum NativeTypes
+        {
+            NATIVE_NONE,
+            NATIVE_INTEGER,
+            NATIVE_UNSIGNED,
+            NATIVE_DOUBLE
+        };
+
+        /**
+         * @brief
+         *
+         * @return int64
+         */
+        int64 GetNativeInteger() const { return mNativeType == NATIVE_DOUBLE ? static_cast<int64>(mNative.d) : mNative.i; }
+        /**
+         * @brief
+         *
+         * @return double
+         */
+        double GetNativeDouble() const
+        {
+            switch (mNativeType)
+            {
+                case NATIVE_DOUBLE:   return mNative.d;
+                case NATIVE_UNSIGNED: return static_cast<double>(static_cast<uint64>(mNative.i));
+                default:              return static_cast<double>(mNative.i);
+            }
+        }
+        /**
+         * @brief text form of a binary value, only built when a caller asks for a string
+         *
+         * @return const char
+         */
+        const char* NativeToString() const
+        {
+            switch (mNativeType)
+            {
+                case NATIVE_INTEGER:  snprintf(mNativeText, sizeof(mNativeText), SI64FMTD, mNative.i); break;
+                case NATIVE_UNSIGNED: snprintf(mNativeText, sizeof(mNativeText), UI64FMTD, static_cast<uint64>(mNative.i)); break;
+                default:              snprintf(mNativeText, sizeof(mNativeText), mType == MYSQL_TYPE_FLOAT ? "%g" : "%.15g", mNative.d); break;
+            }
+
+            return mNativeText;
+        }
+
         /**
          * @brief
          *
@@ -214,5 +339,12 @@ class Field
 
         const char* mValue; /**< TODO */
         enum_field_types mType; /**< TODO */
+        NativeTypes mNativeType; /**< kind of mNative, set by the binary result sets */
+        union
+        {
+            int64 i;
+            double d;
+        } mNative; /**< value of a binary fetched numeric field */
+        mutable char mNativeText[32]; /**< buffer of NativeToString */
 };
 #endif
@@ -27,6 +27,8 @@
 #include "DatabaseEnv.h"
 #include "Utilities/Errors.h"
 
+#include <type_traits>
+
 QueryResultMysql::QueryResultMysql(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount) :
     QueryResult(rowCount, fieldCount), mResult(result)
 {
@@ -80,6 +82,35 @@ void QueryResultMysql::EndQuery()
     }
 }
 
+QueryResultMysqlStream::QueryResultMysqlStream(SqlConnection& conn, MYSQL* mysql, MYSQL_RES* result, MYSQL_FIELD* fields, uint32 fieldCount) :
+    QueryResultMysql(result, fields, 0, fieldCount), mConn(conn), mMysql(mysql)
+{
+    mConn.m_mutex.acquire();
+}
+
+QueryResultMysqlStream::~QueryResultMysqlStream()
+{
+    // unread rows are drained by mysql_free_result, still under the connection lock
+    EndQuery();
+    mConn.m_mutex.release();
+}
+
+bool QueryResultMysqlStream::NextRow()
+{
+    if (QueryResultMysql::NextRow())
+    {
+        return true;
+    }
+
+    // a streamed result learns about a lost connection only while reading
+    if (mysql_errno(mMysql))
+    {
+        sLog.outErrorDb("query ERROR while reading rows: %s", mysql_error(mMysql));
+    }
+
+    return false;
+}
+
 Field::SimpleDataTypes QueryResultMysql::GetSimpleType(enum_field_types type)
 {
     switch (type)
@@ -110,4 +141,157 @@ Field::SimpleDataTypes QueryResultMysql::GetSimpleType(enum_field_types type)
             return Field::DB_TYPE_UNKNOWN;
     }
 }
+
+QueryResultMysqlStmt::QueryResultMysqlStmt(MYSQL_STMT* stmt, MYSQL_RES* metadata) :
+    QueryResult(0, mysql_num_fields(metadata)), mNextRow(0), mValid(false)
+{
+    // my_bool of older client libraries, bool since MySQL 8.0
+    typedef std::remove_pointer<decltype(MYSQL_BIND::is_null)>::type BindFlag;
+
+    MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+
+    mCurrentRow = new Field[mFieldCount];
+    MANGOS_ASSERT(mCurrentRow);
+
+    std::vector<MYSQL_BIND> binds(mFieldCount);
+    std::vector<Cell> row(mFieldCount);
+    std::vector<unsigned long> lengths(mFieldCount);
+    std::vector<BindFlag> nulls(mFieldCount);
+    std::vector<BindFlag> errors(mFieldCount);
+    std::vector<std::vector<char> > buffers(mFieldCount);
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        mCurrentRow[i].SetType(fields[i].type);
+
+        MYSQL_BIND& bind = binds[i];
+        bind.length = &lengths[i];
+        bind.is_null = &nulls[i];
+        bind.error = &errors[i];
+
+        switch (fields[i].type)
+        {
+            case MYSQL_TYPE_TINY:
+            case MYSQL_TYPE_SHORT:
+            case MYSQL_TYPE_LONG:
+            case MYSQL_TYPE_INT24:
+            case MYSQL_TYPE_LONGLONG:
+            case MYSQL_TYPE_YEAR:
+                row[i].type = (fields[i].flags & UNSIGNED_FLAG) ? CELL_UNSIGNED : CELL_INTEGER;
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) != 0;
+                bind.buffer = &row[i].i;
+                break;
+            case MYSQL_TYPE_FLOAT:
+            case MYSQL_TYPE_DOUBLE:
+                row[i].type = CELL_DOUBLE;
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = &row[i].d;
+                break;
+            default:
+                // strings, decimals, dates and everything else arrive as text like in QueryResultMysql
+                row[i].type = CELL_STRING;
+                buffers[i].resize(64);
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = &buffers[i][0];
+                bind.buffer_length = buffers[i].size();
+                break;
+        }
+    }
+
+    if (mysql_stmt_bind_result(stmt, &binds[0]))
+    {
+        sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed: %s", mysql_stmt_error(stmt));
+        return;
+    }
+
+    for (;;)
+    {
+        int status = mysql_stmt_fetch(stmt);
+        if (status == MYSQL_NO_DATA)
+        {
+            break;
+        }
+
+        if (status != 0 && status != MYSQL_DATA_TRUNCATED)
+        {
+            sLog.outError("SQL ERROR: mysql_stmt_fetch() failed: %s", mysql_stmt_error(stmt));
+            return;
+        }
+
+        bool rebind = false;
+        for (uint32 i = 0; i < mFieldCount; ++i)
+        {
+            Cell cell = row[i];
+
+            if (nulls[i])
+            {
+                cell.type = CELL_NULL;
+            }
+            else if (cell.type == CELL_STRING)
+            {
+                // values longer than the column buffer are fetched again into a grown buffer
+                if (lengths[i] > buffers[i].size())
+                {
+                    buffers[i].resize(lengths[i]);
+                    binds[i].buffer = &buffers[i][0];
+                    binds[i].buffer_length = buffers[i].size();
+
+                    if (mysql_stmt_fetch_column(stmt, &binds[i], i, 0))
+                    {
+                        sLog.outError("SQL ERROR: mysql_stmt_fetch_column() failed: %s", mysql_stmt_error(stmt));
+                        return;
+                    }
+
+                    rebind = true;
+                }
+
+                cell.offset = mStrings.size();
+                mStrings.insert(mStrings.end(), buffers[i].begin(), buffers[i].begin() + lengths[i]);
+                mStrings.push_back('\0');
+            }
+
+            mCells.push_back(cell);
+        }
+
+        ++mRowCount;
+
+        if (rebind && mysql_stmt_bind_result(stmt, &binds[0]))
+        {
+            sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed: %s", mysql_stmt_error(stmt));
+            return;
+        }
+    }
+
+    mValid = true;
+}
+
+QueryResultMysqlStmt::~QueryResultMysqlStmt()
+{
+    delete[] mCurrentRow;
+}
+
+bool QueryResultMysqlStmt::NextRow()
+{
+    if (mNextRow >= mRowCount)
+    {
+        return false;
+    }
+
+    Cell const* cells = &mCells[mNextRow * mFieldCount];
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        switch (cells[i].type)
+        {
+            case CELL_NULL:     mCurrentRow[i].SetValue(NULL);                          break;
+            case CELL_INTEGER:  mCurrentRow[i].SetNativeInteger(cells[i].i, false);     break;
+            case CELL_UNSIGNED: mCurrentRow[i].SetNativeInteger(cells[i].i, true);      break;
+            case CELL_DOUBLE:   mCurrentRow[i].SetNativeDouble(cells[i].d);             break;
+            case CELL_STRING:   mCurrentRow[i].SetValue(&mStrings[cells[i].offset]);    break;
+        }
+    }
+
+    ++mNextRow;
+    return true;
+}
 #endif
@@ -35,6 +35,8 @@
 
 #include <mysql.h>
 
+class SqlConnection;
+
 /**
  * @brief
  *
@@ -73,15 +75,131 @@ class QueryResultMysql : public QueryResult
          */
         static Field::SimpleDataTypes GetSimpleType(enum_field_types type);
 
-    private:
+    protected:
         /**
          * @brief
          *
          */
         void EndQuery();
 
+    private:
         MYSQL_RES* mResult; /**< TODO */
 };
+
+/**
+ * @brief result set read from the server row by row (mysql_use_result)
+ *
+ * The connection is locked from the query until the result is deleted, no
+ * other statement may run on it while rows are pending. The row count is
+ * unknown and reported as 0.
+ *
+ */
+class QueryResultMysqlStream : public QueryResultMysql
+{
+    public:
+        /**
+         * @brief
+         *
+         * @param conn connection the query ran on, locked for the lifetime of the result
+         * @param mysql
+         * @param result
+         * @param fields
+         * @param fieldCount
+         */
+        QueryResultMysqlStream(SqlConnection& conn, MYSQL* mysql, MYSQL_RES* result, MYSQL_FIELD* fields, uint32 fieldCount);
+
+        /**
+         * @brief
+         *
+         */
+        ~QueryResultMysqlStream();
+
+        /**
+         * @brief
+         *
+         * @return bool
+         */
+        bool NextRow() override;
+
+    private:
+        SqlConnection& mConn; /**< TODO */
+        MYSQL* mMysql; /**< TODO */
+};
+
+/**
+ * @brief result set read with the binary protocol of a prepared statement
+ *
+ * All rows are fetched into natively typed cells while the connection is
+ * still locked, so the statement can be closed right away. Integer and
+ * floating point columns are handed to the Field objects as numbers and
+ * never go through a string, all other columns are kept as text.
+ *
+ */
+class QueryResultMysqlStmt : public QueryResult
+{
+    public:
+        /**
+         * @brief fetch all rows of an executed statement
+         *
+         * @param stmt executed statement, the caller closes it afterwards
+         * @param metadata result set metadata of stmt
+         */
+        QueryResultMysqlStmt(MYSQL_STMT* stmt, MYSQL_RES* metadata);
+
+        /**
+         * @brief
+         *
+         */
+        ~QueryResultMysqlStmt();
+
+        /**
+         * @brief
+         *
+         * @return bool
+         */
+        bool NextRow() override;
+
+        /**
+         * @brief false if fetching the rows failed
+         *
+         * @return bool
+         */
+        bool IsValid() const { return mValid; }
+
+    private:
+        /**
+         * @brief
+         *
+         */
+        enum CellTypes
+        {
+            CELL_NULL,
+            CELL_INTEGER,
+            CELL_UNSIGNED,
+            CELL_DOUBLE,
+            CELL_STRING
+        };
+
+        /**
+         * @brief one value of the result set, strings are offsets into mStrings
+         *
+         */
+        struct Cell
+        {
+            union
+            {
+                int64 i;
+                double d;
+                size_t offset;
+            };
+            CellTypes type;
+        };
+
+        std::vector<Cell> mCells; /**< mRowCount * mFieldCount values, row by row */
+        std::vector<char> mStrings; /**< zero terminated string values */
+        uint64 mNextRow; /**< index of the row NextRow() moves to */
+        bool mValid; /**< TODO */
+};
 #endif
 
 #endif
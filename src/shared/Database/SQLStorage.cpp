@@ -23,6 +23,8 @@
  */
 
 #include "SQLStorage.h"
+#include "Config/Config.h"
+#include "Log/Log.h"
 
 // -----------------------------------  SQLStorageBase  ---------------------------------------- //
 
@@ -71,6 +73,19 @@ void SQLStorageBase::prepareToLoad(uint32 maxEntry, uint32 recordCount, uint32 r
     m_recordCount = 0;
 }
 
+void SQLStorageBase::ReorderRecords(std::vector<uint32> const& order)
+{
+    char* data = new char[m_recordCount * m_recordSize];
+    for (uint32 i = 0; i < m_recordCount; ++i)
+    {
+        memcpy(data + i * m_recordSize, m_data + order[i] * m_recordSize, m_recordSize);
+    }
+
+    // the strings moved along with the records, only the old block goes
+    delete[] m_data;
+    m_data = data;
+}
+
 // Function to delete the data
 void SQLStorageBase::Free()
 {
@@ -222,7 +237,8 @@ void SQLMultiStorage::Load()
 void SQLMultiStorage::Free()
 {
     SQLStorageBase::Free();
-    m_indexMultiMap.clear();
+    m_keyRanges.clear();
+    m_recordKeys.clear();
 }
 
 void SQLMultiStorage::prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint32 recordSize)
@@ -231,11 +247,46 @@ void SQLMultiStorage::prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint
     Free();
 
     SQLStorageBase::prepareToLoad(maxRecordId, recordCount, recordSize);
+
+    m_recordKeys.reserve(recordCount);
+}
+
+void SQLMultiStorage::JustFinishedLoading()
+{
+    m_keyRanges.assign(GetMaxEntry(), KeyRange());
+
+    // count the records per key, the range of a key then starts after all smaller keys
+    for (std::vector<uint32>::const_iterator itr = m_recordKeys.begin(); itr != m_recordKeys.end(); ++itr)
+    {
+        ++m_keyRanges[*itr].last;
+    }
+
+    uint32 position = 0;
+    for (KeyRangeVector::iterator itr = m_keyRanges.begin(); itr != m_keyRanges.end(); ++itr)
+    {
+        itr->first = position;
+        position += itr->last;
+        itr->last = itr->first;
+    }
+
+    // records of a key keep their table order, like the multimap did
+    std::vector<uint32> order(m_recordKeys.size());
+    for (uint32 i = 0; i < m_recordKeys.size(); ++i)
+    {
+        order[m_keyRanges[m_recordKeys[i]].last++] = i;
+    }
+
+    ReorderRecords(order);
+
+    std::vector<uint32>().swap(m_recordKeys);
 }
 
 void SQLMultiStorage::EraseEntry(uint32 id)
 {
-    m_indexMultiMap.erase(id);
+    if (id < m_keyRanges.size())
+    {
+        m_keyRanges[id].last = m_keyRanges[id].first;
+    }
 }
 
 SQLMultiStorage::SQLMultiStorage(const char* fmt, const char* _entry_field, const char* sqlname)
@@ -247,3 +298,363 @@ SQLMultiStorage::SQLMultiStorage(const char* src_fmt, const char* dst_fmt, const
 {
     Initialize(sqlname, _entry_field, src_fmt, dst_fmt);
 }
+
+// -----------------------------------  SQLStorageSnapshot  ---------------------------------------- //
+
+// bump when the layout of the snapshot files changes
+#define SQL_STORAGE_SNAPSHOT_VERSION 1
+#define SQL_STORAGE_SNAPSHOT_MAGIC   0x534E5353             // 'SSNS'
+#define SQL_STORAGE_SNAPSHOT_NULL    0xFFFFFFFF             // string length of a NULL value
+
+SQLStorageSnapshot::SQLStorageSnapshot(const char* tableName, const char* srcFormat) :
+    m_srcFormat(srcFormat), m_readPos(0), m_rowCount(0)
+{
+    std::string dir = sConfig.GetStringDefault("StorageSnapshotDir", "");
+    if (dir.empty())
+    {
+        return;
+    }
+
+    if (dir.at(dir.length() - 1) != '/' && dir.at(dir.length() - 1) != '\\')
+    {
+        dir.append("/");
+    }
+
+    m_fileName = dir + tableName + ".snapshot";
+}
+
+bool SQLStorageSnapshot::Take(void* data, size_t size)
+{
+    if (m_readPos + size > m_data.size())
+    {
+        return false;
+    }
+
+    memcpy(data, &m_data[m_readPos], size);
+    m_readPos += size;
+    return true;
+}
+
+bool SQLStorageSnapshot::Read(uint64 checksum, uint32& maxRecordId, uint32& recordCount)
+{
+    if (!IsEnabled())
+    {
+        return false;
+    }
+
+    FILE* file = fopen(m_fileName.c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    m_data.resize(size > 0 ? size : 0);
+    bool read = !m_data.empty() && fread(&m_data[0], m_data.size(), 1, file) == 1;
+    fclose(file);
+
+    m_readPos = 0;
+
+    uint32 magic, version, formatLength;
+    uint64 fileChecksum;
+    if (!read || !Take(&magic, sizeof(magic)) || !Take(&version, sizeof(version)) ||
+        magic != SQL_STORAGE_SNAPSHOT_MAGIC || version != SQL_STORAGE_SNAPSHOT_VERSION ||
+        !Take(&formatLength, sizeof(formatLength)) || formatLength != strlen(m_srcFormat) ||
+        m_readPos + formatLength > m_data.size() || memcmp(&m_data[m_readPos], m_srcFormat, formatLength) != 0)
+    {
+        m_data.clear();
+        return false;
+    }
+
+    m_readPos += formatLength;
+
+    if (!Take(&fileChecksum, sizeof(fileChecksum)) || fileChecksum != checksum ||
+        !Take(&maxRecordId, sizeof(maxRecordId)) || !Take(&recordCount, sizeof(recordCount)) ||
+        !Take(&m_rowCount, sizeof(m_rowCount)))
+    {
+        m_data.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool SQLStorageSnapshot::NextRow(Field* fields)
+{
+    if (m_readPos >= m_data.size())
+    {
+        return false;
+    }
+
+    for (uint32 y = 0; m_srcFormat[y]; ++y)
+    {
+        switch (m_srcFormat[y])
+        {
+            case DBC_FF_LOGIC:
+            case DBC_FF_BYTE:
+            case DBC_FF_INT:
+            {
+                uint32 value;
+                if (!Take(&value, sizeof(value)))
+                {
+                    return false;
+                }
+
+                fields[y].SetNativeInteger(value, true);
+                break;
+            }
+            case DBC_FF_FLOAT:
+            {
+                float value;
+                if (!Take(&value, sizeof(value)))
+                {
+                    return false;
+                }
+
+                fields[y].SetNativeDouble(value);
+                break;
+            }
+            case DBC_FF_STRING:
+            {
+                uint32 length;
+                if (!Take(&length, sizeof(length)))
+                {
+                    return false;
+                }
+
+                if (length == SQL_STORAGE_SNAPSHOT_NULL)
+                {
+                    fields[y].SetValue(NULL);
+                    break;
+                }
+
+                // the terminating zero is part of the file, the value is used in place
+                if (m_readPos + length + 1 > m_data.size())
+                {
+                    return false;
+                }
+
+                fields[y].SetValue(&m_data[m_readPos]);
+                m_readPos += length + 1;
+                break;
+            }
+            default:
+                // ignored source columns are not stored
+                break;
+        }
+    }
+
+    return true;
+}
+
+void SQLStorageSnapshot::AddRow(Field const* fields)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    for (uint32 y = 0; m_srcFormat[y]; ++y)
+    {
+        switch (m_srcFormat[y])
+        {
+            case DBC_FF_LOGIC:
+            case DBC_FF_BYTE:
+            case DBC_FF_INT:
+            {
+                uint32 value = fields[y].GetUInt32();
+                Append(&value, sizeof(value));
+                break;
+            }
+            case DBC_FF_FLOAT:
+            {
+                float value = fields[y].GetFloat();
+                Append(&value, sizeof(value));
+                break;
+            }
+            case DBC_FF_STRING:
+            {
+                const char* value = fields[y].GetString();
+                uint32 length = value ? strlen(value) : SQL_STORAGE_SNAPSHOT_NULL;
+                Append(&length, sizeof(length));
+                if (value)
+                {
+                    Append(value, length + 1);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    ++m_rowCount;
+}
+
+void SQLStorageSnapshot::Write(uint64 checksum, uint32 maxRecordId, uint32 recordCount, bool keepRows)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    std::vector<char> rows;
+    rows.swap(m_data);
+
+    uint32 magic = SQL_STORAGE_SNAPSHOT_MAGIC;
+    uint32 version = SQL_STORAGE_SNAPSHOT_VERSION;
+    uint32 formatLength = strlen(m_srcFormat);
+
+    Append(&magic, sizeof(magic));
+    Append(&version, sizeof(version));
+    Append(&formatLength, sizeof(formatLength));
+    Append(m_srcFormat, formatLength);
+    Append(&checksum, sizeof(checksum));
+    Append(&maxRecordId, sizeof(maxRecordId));
+    Append(&recordCount, sizeof(recordCount));
+    Append(&m_rowCount, sizeof(m_rowCount));
+
+    // written to a temporary file first, so a crash never leaves a truncated snapshot behind
+    std::string tmpName = m_fileName + ".tmp";
+    FILE* file = fopen(tmpName.c_str(), "wb");
+    if (!file)
+    {
+        sLog.outError("Can't create storage snapshot %s", tmpName.c_str());
+        m_data.clear();
+        if (keepRows)
+        {
+            m_data.swap(rows);
+            m_readPos = 0;
+        }
+        return;
+    }
+
+    bool written = fwrite(&m_data[0], m_data.size(), 1, file) == 1 &&
+                   (rows.empty() || fwrite(&rows[0], rows.size(), 1, file) == 1);
+    written = fclose(file) == 0 && written;
+
+    m_data.clear();
+    if (keepRows)
+    {
+        m_data.swap(rows);
+        m_readPos = 0;
+    }
+
+    remove(m_fileName.c_str());
+    if (!written || rename(tmpName.c_str(), m_fileName.c_str()) != 0)
+    {
+        sLog.outError("Can't write storage snapshot %s", m_fileName.c_str());
+        remove(tmpName.c_str());
+    }
+}
+
+SnapshotQueryResult::SnapshotQueryResult(SQLStorageSnapshot* snapshot, uint32 fieldCount) :
+    QueryResult(snapshot->GetRowCount(), fieldCount), m_snapshot(snapshot)
+{
+    mCurrentRow = new Field[fieldCount];
+
+    // like the SQL results the first row is fetched right away
+    NextRow();
+}
+
+SnapshotQueryResult::~SnapshotQueryResult()
+{
+    delete[] mCurrentRow;
+    delete m_snapshot;
+}
+
+bool SnapshotQueryResult::NextRow()
+{
+    return m_snapshot->NextRow(mCurrentRow);
+}
+
+QueryResult* QueryWithSnapshot(Database& db, const char* name, const char* srcFormat, const char* tables, const char* sql)
+{
+    SQLStorageSnapshot* snapshot = new SQLStorageSnapshot(name, srcFormat);
+    if (!snapshot->IsEnabled())
+    {
+        delete snapshot;
+        return db.Query(sql);
+    }
+
+    // a changed query text must not replay rows of the old one
+    uint64 checksum = 14695981039346656037ULL;
+    for (const char* c = sql; *c; ++c)
+    {
+        checksum = (checksum ^ uint8(*c)) * 1099511628211ULL;
+    }
+
+    if (QueryResult* result = db.PQuery("CHECKSUM TABLE %s", tables))
+    {
+        do
+        {
+            // a missing table has a NULL checksum, the query then fails anyway
+            if ((*result)[1].IsNULL())
+            {
+                checksum = 0;
+                break;
+            }
+
+            checksum = (checksum ^ (*result)[1].GetUInt64()) * 1099511628211ULL;
+        }
+        while (result->NextRow());
+
+        delete result;
+    }
+    else
+    {
+        checksum = 0;
+    }
+
+    uint32 maxRecordId, recordCount;
+    if (checksum && snapshot->Read(checksum, maxRecordId, recordCount))
+    {
+        if (!snapshot->GetRowCount())
+        {
+            delete snapshot;
+            return NULL;
+        }
+
+        DETAIL_LOG("%s loaded from its snapshot", name);
+        return new SnapshotQueryResult(snapshot, strlen(srcFormat));
+    }
+
+    if (!checksum)
+    {
+        delete snapshot;
+        return db.Query(sql);
+    }
+
+    // the rows only pass through on their way into the snapshot, so they are not buffered
+    QueryResult* result = db.QueryStream(sql);
+    if (result && result->GetFieldCount() != strlen(srcFormat))
+    {
+        delete result;
+        delete snapshot;
+        return db.Query(sql);
+    }
+
+    if (result)
+    {
+        do
+        {
+            snapshot->AddRow(result->Fetch());
+        }
+        while (result->NextRow());
+
+        delete result;
+    }
+
+    // the rows were consumed to fill the snapshot, the caller reads them from there
+    snapshot->Write(checksum, 0, 0, true);
+    if (!snapshot->GetRowCount())
+    {
+        delete snapshot;
+        return NULL;
+    }
+
+    return new SnapshotQueryResult(snapshot, strlen(srcFormat));
+}
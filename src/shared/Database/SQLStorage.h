@@ -90,6 +90,12 @@ class SQLStorageBase
          * @return uint32
          */
         uint32 GetRecordCount() const { return m_recordCount; }
+        /**
+         * @brief bytes of the loaded records, without the strings they point to
+         *
+         * @return uint64
+         */
+        uint64 GetDataSize() const { return uint64(m_recordCount) * m_recordSize; }
 
         template<typename T>
         /**
@@ -206,6 +212,12 @@ class SQLStorageBase
          * @return uint32
          */
         uint32 GetRecordSize() const { return m_recordSize; }
+        /**
+         * @brief
+         *
+         * @return const char
+         */
+        char const* GetData() const { return m_data; }
 
         /**
          * @brief
@@ -222,12 +234,24 @@ class SQLStorageBase
          * @param record
          */
         virtual void JustCreatedRecord(uint32 recordId, char* record) = 0;
+        /**
+         * @brief called once all records of a load are created
+         *
+         */
+        virtual void JustFinishedLoading() {}
         /**
          * @brief
          *
          */
         virtual void Free();
 
+        /**
+         * @brief moves the records in memory, pointers to records are invalid after this
+         *
+         * @param order record at position i is the former record at order[i]
+         */
+        void ReorderRecords(std::vector<uint32> const& order);
+
     private:
         /**
          * @brief
@@ -461,7 +485,18 @@ class SQLMultiStorage : public SQLStorageBase
          * @brief
          *
          */
-        typedef std::multimap < uint32 /*recordId*/, char* /*record*/ > RecordMultiMap;
+        /**
+         * @brief records of one key, as positions in the record array
+         *
+         */
+        struct KeyRange
+        {
+            KeyRange() : first(0), last(0) {}
+            uint32 first; /**< TODO */
+            uint32 last; /**< TODO */
+        };
+
+        typedef std::vector<KeyRange> KeyRangeVector;
 
     public:
         /**
@@ -507,19 +542,19 @@ class SQLMultiStorage : public SQLStorageBase
                  *
                  * @return const T
                  */
-                T const* getValue() const { return reinterpret_cast<T const*>(citerator->second); }
+                T const* getValue() const { return reinterpret_cast<T const*>(pointer); }
                 /**
                  * @brief
                  *
                  * @return uint32
                  */
-                uint32 getKey() const { return citerator->first; }
+                uint32 getKey() const { return key; }
 
                 /**
                  * @brief
                  *
                  */
-                void operator ++() { ++citerator; }
+                void operator ++() { pointer += recordSize; }
                 /**
                  * @brief
                  *
@@ -538,23 +573,27 @@ class SQLMultiStorage : public SQLStorageBase
                  * @param r
                  * @return bool operator
                  */
-                bool operator !=(const SQLMultiSIterator& r) const { return citerator != r.citerator; }
+                bool operator !=(const SQLMultiSIterator& r) const { return pointer != r.pointer; }
                 /**
                  * @brief
                  *
                  * @param r
                  * @return bool operator
                  */
-                bool operator ==(const SQLMultiSIterator& r) const { return citerator == r.citerator; }
+                bool operator ==(const SQLMultiSIterator& r) const { return pointer == r.pointer; }
 
             private:
                 /**
                  * @brief
                  *
-                 * @param _itr
+                 * @param ptr
+                 * @param _recordSize
+                 * @param _key
                  */
-                SQLMultiSIterator(RecordMultiMap::const_iterator _itr) : citerator(_itr) {}
-                RecordMultiMap::const_iterator citerator; /**< TODO */
+                SQLMultiSIterator(char const* ptr, uint32 _recordSize, uint32 _key) : pointer(ptr), recordSize(_recordSize), key(_key) {}
+                char const* pointer; /**< TODO */
+                uint32 recordSize; /**< TODO */
+                uint32 key; /**< TODO */
         };
 
         template<typename T>
@@ -574,10 +613,10 @@ class SQLMultiStorage : public SQLStorageBase
                 /**
                  * @brief
                  *
-                 * @param std::pair<RecordMultiMap::const_iterator
-                 * @param pair
+                 * @param _first
+                 * @param _second
                  */
-                SQLMSIteratorBounds(std::pair<RecordMultiMap::const_iterator, RecordMultiMap::const_iterator> pair) : first(pair.first), second(pair.second) {}
+                SQLMSIteratorBounds(SQLMultiSIterator<T> const& _first, SQLMultiSIterator<T> const& _second) : first(_first), second(_second) {}
         };
 
         template<typename T>
@@ -587,7 +626,13 @@ class SQLMultiStorage : public SQLStorageBase
          * @param key
          * @return SQLMSIteratorBounds<T>
          */
-        SQLMSIteratorBounds<T> getBounds(uint32 key) const { return SQLMSIteratorBounds<T>(m_indexMultiMap.equal_range(key)); }
+        SQLMSIteratorBounds<T> getBounds(uint32 key) const
+        {
+            KeyRange range = key < m_keyRanges.size() ? m_keyRanges[key] : KeyRange();
+            char const* data = GetData();
+            return SQLMSIteratorBounds<T>(SQLMultiSIterator<T>(data + range.first * GetRecordSize(), GetRecordSize(), key),
+                                          SQLMultiSIterator<T>(data + range.last * GetRecordSize(), GetRecordSize(), key));
+        }
 
         /**
          * @brief
@@ -617,10 +662,15 @@ class SQLMultiStorage : public SQLStorageBase
          * @param recordId
          * @param record
          */
-        void JustCreatedRecord(uint32 recordId, char* record) override
+        void JustCreatedRecord(uint32 recordId, char* /*record*/) override
         {
-            m_indexMultiMap.insert(RecordMultiMap::value_type(recordId, record));
+            m_recordKeys.push_back(recordId);
         }
+        /**
+         * @brief sorts the records by key, so the records of a key are one range
+         *
+         */
+        void JustFinishedLoading() override;
 
         /**
          * @brief
@@ -629,9 +679,148 @@ class SQLMultiStorage : public SQLStorageBase
         void Free() override;
 
     private:
-        RecordMultiMap m_indexMultiMap; /**< TODO */
+        KeyRangeVector m_keyRanges; /**< indexed by key */
+        std::vector<uint32> m_recordKeys; /**< keys of the records while loading */
+};
+
+/**
+ * @brief on-disk copy of the source rows of a storage table
+ *
+ * The file holds the values the loader reads from the table in binary form,
+ * keyed by the CHECKSUM TABLE result of the table. As long as the table is
+ * unchanged the rows are read from the file with a single read and handed
+ * to the loader as Field objects, so they are converted into records the
+ * same way as when loading from SQL (including custom loader conversions).
+ *
+ */
+class SQLStorageSnapshot
+{
+    public:
+        /**
+         * @brief
+         *
+         * @param tableName
+         * @param srcFormat
+         */
+        SQLStorageSnapshot(const char* tableName, const char* srcFormat);
+
+        /**
+         * @brief whether a snapshot directory is configured
+         *
+         * @return bool
+         */
+        bool IsEnabled() const { return !m_fileName.empty(); }
+
+        /**
+         * @brief read the snapshot file if it was written for this table checksum
+         *
+         * @param checksum
+         * @param maxRecordId
+         * @param recordCount
+         * @return bool false if the table has to be loaded from SQL
+         */
+        bool Read(uint64 checksum, uint32& maxRecordId, uint32& recordCount);
+        /**
+         * @brief number of rows in the read snapshot
+         *
+         * @return uint32
+         */
+        uint32 GetRowCount() const { return m_rowCount; }
+        /**
+         * @brief fill fields with the next row of the read snapshot
+         *
+         * @param fields one Field per source column
+         * @return bool false at the end of the snapshot
+         */
+        bool NextRow(Field* fields);
+
+        /**
+         * @brief append a row loaded from SQL to the snapshot to write
+         *
+         * @param fields
+         */
+        void AddRow(Field const* fields);
+        /**
+         * @brief write the rows added by AddRow() to the snapshot file
+         *
+         * @param checksum
+         * @param maxRecordId
+         * @param recordCount
+         * @param keepRows keep the rows to be read by NextRow() afterwards
+         */
+        void Write(uint64 checksum, uint32 maxRecordId, uint32 recordCount, bool keepRows = false);
+
+    private:
+        /**
+         * @brief
+         *
+         * @param data
+         * @param size
+         */
+        void Append(const void* data, size_t size) { m_data.insert(m_data.end(), (const char*)data, (const char*)data + size); }
+        /**
+         * @brief
+         *
+         * @param data
+         * @param size
+         * @return bool false if the file is too short
+         */
+        bool Take(void* data, size_t size);
+
+        std::string m_fileName; /**< empty if snapshots are disabled */
+        const char* m_srcFormat; /**< TODO */
+        std::vector<char> m_data; /**< rows read from or to be written to the file */
+        size_t m_readPos; /**< TODO */
+        uint32 m_rowCount; /**< TODO */
 };
 
+/**
+ * @brief result of a query replayed from the rows of a SQLStorageSnapshot
+ *
+ */
+class SnapshotQueryResult : public QueryResult
+{
+    public:
+        /**
+         * @brief
+         *
+         * @param snapshot read snapshot, owned by the result
+         * @param fieldCount
+         */
+        SnapshotQueryResult(SQLStorageSnapshot* snapshot, uint32 fieldCount);
+        /**
+         * @brief
+         *
+         */
+        ~SnapshotQueryResult();
+
+        /**
+         * @brief
+         *
+         * @return bool
+         */
+        bool NextRow() override;
+
+    private:
+        SQLStorageSnapshot* m_snapshot; /**< TODO */
+};
+
+/**
+ * @brief run a query reading only the given tables, or replay it from its snapshot
+ *
+ * The snapshot is keyed by the query text and the CHECKSUM TABLE results of
+ * the tables, so it is used until any of them changes. Loaders that are not
+ * SQLStorage based use this for their big static tables.
+ *
+ * @param db
+ * @param name snapshot file name
+ * @param srcFormat one DBC_FF_* type per column of the query
+ * @param tables comma separated list of all tables the query reads
+ * @param sql
+ * @return QueryResult NULL if the query has no rows
+ */
+QueryResult* QueryWithSnapshot(Database& db, const char* name, const char* srcFormat, const char* tables, const char* sql);
+
 template <class DerivedLoader, class StorageClass>
 /**
  * @brief
@@ -752,6 +941,14 @@ class SQLStorageLoaderBase
          * @param offset
          */
         void storeValue(char* value, StorageClass& store, char* record, uint32 field_pos, uint32& offset);
+
+        /**
+         * @brief create the record of one source row
+         *
+         * @param store
+         * @param fields
+         */
+        void storeRecord(StorageClass& store, Field const* fields);
 };
 
 /**
@@ -257,6 +257,65 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::storeValue(char const* v
     }
 }
 
+template<class DerivedLoader, class StorageClass>
+/**
+ * @brief
+ *
+ * @param store
+ * @param fields
+ */
+void SQLStorageLoaderBase<DerivedLoader, StorageClass>::storeRecord(StorageClass& store, Field const* fields)
+{
+    char* record = store.createRecord(fields[0].GetUInt32());
+    uint32 offset = 0;
+
+    // dependend on dest-size
+    // iterate two indexes: x over dest, y over source
+    //                      y++ If and only If x != FT_NA*
+    //                      x++ If and only If a value is stored
+    for (uint32 x = 0, y = 0; x < store.GetDstFieldCount();)
+    {
+        switch (store.GetDstFormat(x))
+        {
+            // For default fill continue and do not increase y
+            case DBC_FF_NA:         storeValue((uint32)0, store, record, x, offset);         ++x; continue;
+            case DBC_FF_NA_BYTE:    storeValue((char)0, store, record, x, offset);           ++x; continue;
+            case DBC_FF_NA_FLOAT:   storeValue((float)0.0f, store, record, x, offset);       ++x; continue;
+            case DBC_FF_NA_POINTER: storeValue((char const*)NULL, store, record, x, offset); ++x; continue;
+            default:
+                break;
+        }
+
+        // It is required that the input has at least as many columns set as the output requires
+        if (y >= store.GetSrcFieldCount())
+        {
+            assert(false && "SQL storage has too few columns!");
+        }
+
+        switch (store.GetSrcFormat(y))
+        {
+            case DBC_FF_LOGIC:  storeValue((bool)(fields[y].GetUInt32() > 0), store, record, x, offset);  ++x; break;
+            case DBC_FF_BYTE:   storeValue((char)fields[y].GetUInt8(), store, record, x, offset);         ++x; break;
+            case DBC_FF_INT:    storeValue((uint32)fields[y].GetUInt32(), store, record, x, offset);      ++x; break;
+            case DBC_FF_FLOAT:  storeValue((float)fields[y].GetFloat(), store, record, x, offset);        ++x; break;
+            case DBC_FF_STRING: storeValue((char const*)fields[y].GetString(), store, record, x, offset); ++x; break;
+            case DBC_FF_NA:
+            case DBC_FF_NA_BYTE:
+            case DBC_FF_NA_FLOAT:
+                // Do Not increase x
+                break;
+            case DBC_FF_IND:
+            case DBC_FF_SORT:
+            case DBC_FF_NA_POINTER:
+                assert(false && "SQL storage not have sort or pointer field types");
+                break;
+            default:
+                assert(false && "unknown format character");
+        }
+        ++y;
+    }
+}
+
 template<class DerivedLoader, class StorageClass>
 /**
  * @brief
@@ -266,7 +325,78 @@ template<class DerivedLoader, class StorageClass>
  */
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store, bool error_at_empty /*= true*/)
 {
+    // get struct size
+    uint32 recordsize = 0;
+    for (uint32 x = 0; x < store.GetDstFieldCount(); ++x)
+    {
+        switch (store.GetDstFormat(x))
+        {
+            case DBC_FF_LOGIC:
+                recordsize += sizeof(bool);   break;
+            case DBC_FF_BYTE:
+                recordsize += sizeof(char);   break;
+            case DBC_FF_INT:
+                recordsize += sizeof(uint32); break;
+            case DBC_FF_FLOAT:
+                recordsize += sizeof(float);  break;
+            case DBC_FF_STRING:
+                recordsize += sizeof(char*);  break;
+            case DBC_FF_NA:
+                recordsize += sizeof(uint32); break;
+            case DBC_FF_NA_BYTE:
+                recordsize += sizeof(char);   break;
+            case DBC_FF_NA_FLOAT:
+                recordsize += sizeof(float);  break;
+            case DBC_FF_NA_POINTER:
+                recordsize += sizeof(char*);  break;
+            case DBC_FF_IND:
+            case DBC_FF_SORT:
+                assert(false && "SQL storage not have sort field types");
+                break;
+            default:
+                assert(false && "unknown format character");
+                break;
+        }
+    }
+
     Field* fields = NULL;
+    uint32 maxRecordId = 0;
+    uint32 recordCount = 0;
+    uint64 checksum = 0;
+
+    // an unchanged table is loaded from its snapshot without reading the rows from SQL
+    SQLStorageSnapshot snapshot(store.GetTableName(), store.GetSrcFormat());
+    if (snapshot.IsEnabled())
+    {
+        QueryResult* result = WorldDatabase.PQuery("CHECKSUM TABLE `%s`", store.GetTableName());
+        if (result)
+        {
+            checksum = (*result)[1].GetUInt64();
+            delete result;
+        }
+
+        if (checksum && snapshot.Read(checksum, maxRecordId, recordCount))
+        {
+            store.prepareToLoad(maxRecordId, recordCount, recordsize);
+
+            fields = new Field[store.GetSrcFieldCount()];
+
+            BarGoLink bar(snapshot.GetRowCount());
+            while (snapshot.NextRow(fields))
+            {
+                bar.step();
+                storeRecord(store, fields);
+            }
+
+            delete[] fields;
+
+            store.JustFinishedLoading();
+
+            DETAIL_LOG("%s loaded from its snapshot", store.GetTableName());
+            return;
+        }
+    }
+
     QueryResult* result  = WorldDatabase.PQuery("SELECT MAX(`%s`) FROM `%s`", store.EntryFieldName(), store.GetTableName());
     if (!result)
     {
@@ -275,9 +405,7 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         exit(1);                                            // Stop server at loading non existent table or inaccessible table
     }
 
-    uint32 maxRecordId = (*result)[0].GetUInt32() + 1;
-    uint32 recordCount = 0;
-    uint32 recordsize = 0;
+    maxRecordId = (*result)[0].GetUInt32() + 1;
     delete result;
 
     result = WorldDatabase.PQuery("SELECT COUNT(*) FROM `%s`", store.GetTableName());
@@ -288,7 +416,8 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         delete result;
     }
 
-    result = WorldDatabase.PQuery("SELECT * FROM `%s`", store.GetTableName());
+    // the rows are stored as they arrive instead of being buffered first, recordCount sizes the progress bar
+    result = WorldDatabase.PQueryStream("SELECT * FROM `%s`", store.GetTableName());
 
     if (!result)
     {
@@ -314,40 +443,6 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         exit(1);                                            // Stop server at loading broken or non-compatible table.
     }
 
-    // get struct size
-    uint32 offset = 0;
-    for (uint32 x = 0; x < store.GetDstFieldCount(); ++x)
-    {
-        switch (store.GetDstFormat(x))
-        {
-            case DBC_FF_LOGIC:
-                recordsize += sizeof(bool);   break;
-            case DBC_FF_BYTE:
-                recordsize += sizeof(char);   break;
-            case DBC_FF_INT:
-                recordsize += sizeof(uint32); break;
-            case DBC_FF_FLOAT:
-                recordsize += sizeof(float);  break;
-            case DBC_FF_STRING:
-                recordsize += sizeof(char*);  break;
-            case DBC_FF_NA:
-                recordsize += sizeof(uint32); break;
-            case DBC_FF_NA_BYTE:
-                recordsize += sizeof(char);   break;
-            case DBC_FF_NA_FLOAT:
-                recordsize += sizeof(float);  break;
-            case DBC_FF_NA_POINTER:
-                recordsize += sizeof(char*);  break;
-            case DBC_FF_IND:
-            case DBC_FF_SORT:
-                assert(false && "SQL storage not have sort field types");
-                break;
-            default:
-                assert(false && "unknown format character");
-                break;
-        }
-    }
-
     // Prepare data storage and lookup storage
     store.prepareToLoad(maxRecordId, recordCount, recordsize);
 
@@ -357,58 +452,22 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         fields = result->Fetch();
         bar.step();
 
-        char* record = store.createRecord(fields[0].GetUInt32());
-        offset = 0;
-
-        // dependend on dest-size
-        // iterate two indexes: x over dest, y over source
-        //                      y++ If and only If x != FT_NA*
-        //                      x++ If and only If a value is stored
-        for (uint32 x = 0, y = 0; x < store.GetDstFieldCount();)
+        storeRecord(store, fields);
+        if (checksum)
         {
-            switch (store.GetDstFormat(x))
-            {
-                // For default fill continue and do not increase y
-                case DBC_FF_NA:         storeValue((uint32)0, store, record, x, offset);         ++x; continue;
-                case DBC_FF_NA_BYTE:    storeValue((char)0, store, record, x, offset);           ++x; continue;
-                case DBC_FF_NA_FLOAT:   storeValue((float)0.0f, store, record, x, offset);       ++x; continue;
-                case DBC_FF_NA_POINTER: storeValue((char const*)NULL, store, record, x, offset); ++x; continue;
-                default:
-                    break;
-            }
-
-            // It is required that the input has at least as many columns set as the output requires
-            if (y >= store.GetSrcFieldCount())
-            {
-                assert(false && "SQL storage has too few columns!");
-            }
-
-            switch (store.GetSrcFormat(y))
-            {
-                case DBC_FF_LOGIC:  storeValue((bool)(fields[y].GetUInt32() > 0), store, record, x, offset);  ++x; break;
-                case DBC_FF_BYTE:   storeValue((char)fields[y].GetUInt8(), store, record, x, offset);         ++x; break;
-                case DBC_FF_INT:    storeValue((uint32)fields[y].GetUInt32(), store, record, x, offset);      ++x; break;
-                case DBC_FF_FLOAT:  storeValue((float)fields[y].GetFloat(), store, record, x, offset);        ++x; break;
-                case DBC_FF_STRING: storeValue((char const*)fields[y].GetString(), store, record, x, offset); ++x; break;
-                case DBC_FF_NA:
-                case DBC_FF_NA_BYTE:
-                case DBC_FF_NA_FLOAT:
-                    // Do Not increase x
-                    break;
-                case DBC_FF_IND:
-                case DBC_FF_SORT:
-                case DBC_FF_NA_POINTER:
-                    assert(false && "SQL storage not have sort or pointer field types");
-                    break;
-                default:
-                    assert(false && "unknown format character");
-            }
-            ++y;
+            snapshot.AddRow(fields);
         }
     }
     while (result->NextRow());
 
     delete result;
+
+    store.JustFinishedLoading();
+
+    if (checksum)
+    {
+        snapshot.Write(checksum, maxRecordId, recordCount);
+    }
 }
 
 #endif
@@ -25,8 +25,10 @@
 #include "Database/SqlDelayThread.h"
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
+#include "Config/Config.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase) : m_dbEngine(db), m_dbConnection(conn),
+    m_pingDatabase(pingDatabase), m_queueSize(0), m_running(true)
 {
 }
 
@@ -42,6 +44,12 @@ void SqlDelayThread::run()
     mysql_thread_init();
 #endif
 
+    std::string cpus = sConfig.GetStringDefault("ThreadAffinity.Database", "");
+    if (!ACE_Based::Thread::SetCurrentThreadAffinity(cpus))
+    {
+        sLog.outError("SqlDelayThread: can't run on CPUs %s", cpus.c_str());
+    }
+
     const uint32 loopSleepms = 10;
 
     const uint32 pingEveryLoop = m_dbEngine->GetPingIntervall() / loopSleepms;
@@ -58,7 +66,16 @@ void SqlDelayThread::run()
         if ((loopCounter++) >= pingEveryLoop)
         {
             loopCounter = 0;
-            m_dbEngine->Ping();
+
+            if (m_pingDatabase)
+            {
+                m_dbEngine->Ping();
+            }
+            else
+            {
+                SqlConnection::Lock guard(m_dbConnection);
+                delete guard->Query("SELECT 1");
+            }
         }
     }
 
@@ -80,5 +97,6 @@ void SqlDelayThread::ProcessRequests()
     {
         s->Execute(m_dbConnection);
         delete s;
+        --m_queueSize;
     }
 }
@@ -26,6 +26,7 @@
 #define MANGOS_H_SQLDELAYTHREAD
 
 #include <ace/Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
 #include "LockedQueue/LockedQueue.h"
 #include "Threading/Threading.h"
 
@@ -49,6 +50,8 @@ class SqlDelayThread : public ACE_Based::Runnable
         SqlQueue m_sqlQueue;                                /**< Queue of SQL statements */
         Database* m_dbEngine;                               /**< Pointer to used Database engine */
         SqlConnection* m_dbConnection;                      /**< Pointer to DB connection */
+        bool m_pingDatabase;                                /**< Pings all connections of the engine, else only its own */
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_queueSize;  /**< Statements queued and not executed yet */
         volatile bool m_running; /**< TODO */
 
         /**
@@ -63,8 +66,9 @@ class SqlDelayThread : public ACE_Based::Runnable
          *
          * @param db
          * @param conn
+         * @param pingDatabase
          */
-        SqlDelayThread(Database* db, SqlConnection* conn);
+        SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase = true);
         /**
          * @brief
          *
@@ -77,7 +81,14 @@ class SqlDelayThread : public ACE_Based::Runnable
          * @param sql
          * @return bool
          */
-        bool Delay(SqlOperation* sql) { m_sqlQueue.add(sql); return true; }
+        bool Delay(SqlOperation* sql) { ++m_queueSize; m_sqlQueue.add(sql); return true; }
+
+        /**
+         * @brief Number of statements waiting for this thread
+         *
+         * @return uint32
+         */
+        uint32 GetQueueSize() const { return uint32(m_queueSize.value()); }
 
         /**
          * @brief Stop event
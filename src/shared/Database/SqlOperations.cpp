@@ -29,6 +29,114 @@
 
 #define LOCK_DB_CONN(conn) SqlConnection::Lock guard(conn)
 
+/// folded INSERTs stay well below the default max_allowed_packet of the server
+#define MAX_INSERT_BATCH_LENGTH (512 * 1024)
+
+/// find the values of a single row "INSERT ... VALUES (...)", [valuesStart, valuesEnd) is the row including its parentheses
+static bool SplitSingleRowInsert(const char* sql, size_t& valuesStart, size_t& valuesEnd)
+{
+    if (strnicmp(sql, "INSERT", 6) != 0 && strnicmp(sql, "REPLACE", 7) != 0)
+    {
+        return false;
+    }
+
+    // table and column part must not hold any literal, so the keyword found is the real one
+    const char* values = NULL;
+    for (const char* p = sql; *p; ++p)
+    {
+        if (*p == '\'' || *p == '"' || *p == '?')
+        {
+            return false;
+        }
+
+        if ((p[0] == ' ' || p[0] == ')') && strnicmp(p + 1, "VALUES", 6) == 0)
+        {
+            values = p + 7;
+            break;
+        }
+    }
+
+    if (!values)
+    {
+        return false;
+    }
+
+    while (*values == ' ')
+    {
+        ++values;
+    }
+
+    if (*values != '(')
+    {
+        return false;
+    }
+
+    // walk to the parenthesis closing the row, skipping quoted strings
+    int depth = 0;
+    char quote = 0;
+    const char* p = values;
+    for (; *p; ++p)
+    {
+        if (quote)
+        {
+            if (*p == '\\' && p[1])
+            {
+                ++p;
+            }
+            else if (*p == quote)
+            {
+                quote = 0;
+            }
+        }
+        else if (*p == '\'' || *p == '"')
+        {
+            quote = *p;
+        }
+        else if (*p == '(')
+        {
+            ++depth;
+        }
+        else if (*p == ')' && --depth == 0)
+        {
+            break;
+        }
+    }
+
+    if (!*p)
+    {
+        return false;
+    }
+
+    valuesStart = values - sql;
+    valuesEnd = p + 1 - sql;
+
+    // anything but a terminator after the row (more rows, ON DUPLICATE KEY ...) can't be folded
+    for (++p; *p; ++p)
+    {
+        if (*p != ' ' && *p != ';' && *p != '\n' && *p != '\r')
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// floats would lose precision as plain SQL text, those rows keep their binary binding
+static bool HasFloatParams(const SqlStmtParameters& params)
+{
+    SqlStmtParameters::ParameterContainer const& args = params.params();
+    for (SqlStmtParameters::ParameterContainer::const_iterator itr = args.begin(); itr != args.end(); ++itr)
+    {
+        if (itr->type() == FIELD_FLOAT || itr->type() == FIELD_DOUBLE)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /// ---- ASYNC STATEMENTS / TRANSACTIONS ----
 
 bool SqlPlainRequest::Execute(SqlConnection* conn)
@@ -61,9 +169,13 @@ bool SqlTransaction::Execute(SqlConnection* conn)
     const int nItems = m_queue.size();
     for (int i = 0; i < nItems; ++i)
     {
-        SqlOperation* pStmt = m_queue[i];
+        bool result;
+        if (!ExecuteInsertBatch(conn, i, result))
+        {
+            result = m_queue[i]->Execute(conn);
+        }
 
-        if (!pStmt->Execute(conn))
+        if (!result)
         {
             conn->RollbackTransaction();
             return false;
@@ -73,6 +185,97 @@ bool SqlTransaction::Execute(SqlConnection* conn)
     return conn->CommitTransaction();
 }
 
+bool SqlTransaction::ExecuteInsertBatch(SqlConnection* conn, int& nItem, bool& result)
+{
+    const uint32 maxRows = conn->DB().GetInsertBatchRows();
+    const int nItems = m_queue.size();
+    if (maxRows < 2 || nItem + 1 >= nItems)
+    {
+        return false;
+    }
+
+    std::string sql;
+    size_t valuesStart, valuesEnd;
+    uint32 rows = 1;
+    int nLast = nItem;
+
+    if (SqlPlainRequest* first = dynamic_cast<SqlPlainRequest*>(m_queue[nItem]))
+    {
+        if (!SplitSingleRowInsert(first->GetSql(), valuesStart, valuesEnd))
+        {
+            return false;
+        }
+
+        sql.assign(first->GetSql(), valuesEnd);
+
+        for (int i = nItem + 1; i < nItems && rows < maxRows && sql.length() < MAX_INSERT_BATCH_LENGTH; ++i)
+        {
+            SqlPlainRequest* next = dynamic_cast<SqlPlainRequest*>(m_queue[i]);
+            size_t nextStart, nextEnd;
+            if (!next || !SplitSingleRowInsert(next->GetSql(), nextStart, nextEnd) ||
+                nextStart != valuesStart || strncmp(next->GetSql(), sql.c_str(), valuesStart) != 0)
+            {
+                break;
+            }
+
+            sql += ',';
+            sql.append(next->GetSql() + nextStart, nextEnd - nextStart);
+            ++rows;
+            nLast = i;
+        }
+    }
+    else if (SqlPreparedRequest* first = dynamic_cast<SqlPreparedRequest*>(m_queue[nItem]))
+    {
+        SqlPreparedRequest* second = dynamic_cast<SqlPreparedRequest*>(m_queue[nItem + 1]);
+        if (!second || second->GetIndex() != first->GetIndex())
+        {
+            return false;
+        }
+
+        std::string fmt = conn->DB().GetStmtString(first->GetIndex());
+        if (!SplitSingleRowInsert(fmt.c_str(), valuesStart, valuesEnd))
+        {
+            return false;
+        }
+
+        // every row is bound as plain SQL text into the values part of the statement
+        SqlPlainPreparedStatement row(fmt.substr(valuesStart, valuesEnd - valuesStart), *conn);
+        if (row.params() != first->GetParams().boundParams() || HasFloatParams(first->GetParams()))
+        {
+            return false;
+        }
+
+        row.bind(first->GetParams());
+        sql.assign(fmt, 0, valuesStart);
+        sql += row.plainRequest();
+
+        for (int i = nItem + 1; i < nItems && rows < maxRows && sql.length() < MAX_INSERT_BATCH_LENGTH; ++i)
+        {
+            SqlPreparedRequest* next = dynamic_cast<SqlPreparedRequest*>(m_queue[i]);
+            if (!next || next->GetIndex() != first->GetIndex() || next->GetParams().boundParams() != row.params() ||
+                HasFloatParams(next->GetParams()))
+            {
+                break;
+            }
+
+            row.bind(next->GetParams());
+            sql += ',';
+            sql += row.plainRequest();
+            ++rows;
+            nLast = i;
+        }
+    }
+
+    if (rows < 2)
+    {
+        return false;
+    }
+
+    nItem = nLast;
+    result = conn->Execute(sql.c_str());
+    return true;
+}
+
 SqlPreparedRequest::SqlPreparedRequest(int nIndex, SqlStmtParameters* arg) : m_nIndex(nIndex), m_param(arg)
 {
 }
@@ -94,6 +94,13 @@ class SqlPlainRequest : public SqlOperation
          * @return bool
          */
         bool Execute(SqlConnection* conn) override;
+
+        /**
+         * @brief SQL text of the request
+         *
+         * @return const char
+         */
+        const char* GetSql() const { return m_sql; }
 };
 
 /**
@@ -131,6 +138,21 @@ class SqlTransaction : public SqlOperation
          * @return bool
          */
         bool Execute(SqlConnection* conn) override;
+
+    private:
+        /**
+         * @brief execute a run of single row INSERTs starting at nItem as one multi-row INSERT
+         *
+         * Consecutive INSERTs into the same table and columns, either plain or of the
+         * same prepared statement, are folded into INSERT ... VALUES (...),(...) of at
+         * most Database::GetInsertBatchRows() rows.
+         *
+         * @param conn
+         * @param nItem first statement of the run, advanced to the last one folded
+         * @param result result of the executed statement
+         * @return bool false if nothing was folded and nItem still has to be executed
+         */
+        bool ExecuteInsertBatch(SqlConnection* conn, int& nItem, bool& result);
 };
 
 /**
@@ -161,6 +183,19 @@ class SqlPreparedRequest : public SqlOperation
          */
         bool Execute(SqlConnection* conn) override;
 
+        /**
+         * @brief index of the prepared statement
+         *
+         * @return int
+         */
+        int GetIndex() const { return m_nIndex; }
+        /**
+         * @brief parameters bound to the statement
+         *
+         * @return const SqlStmtParameters
+         */
+        const SqlStmtParameters& GetParams() const { return *m_param; }
+
     private:
         const int m_nIndex; /**< TODO */
         SqlStmtParameters* m_param; /**< TODO */
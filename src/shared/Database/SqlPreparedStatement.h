@@ -817,6 +817,13 @@ class SqlPlainPreparedStatement : public SqlPreparedStatement
          */
         virtual bool execute() override;
 
+        /**
+         * @brief SQL text produced by the last bind()
+         *
+         * @return const std::string
+         */
+        const std::string& plainRequest() const { return m_szPlainRequest; }
+
     protected:
         /**
          * @brief
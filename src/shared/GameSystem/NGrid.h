@@ -29,6 +29,7 @@
 #include "GameSystem/GridReference.h"
 #include "Timer.h"
 
+#include <atomic>
 #include <cassert>
 
 /**
@@ -140,8 +141,11 @@ uint32 N,
        class GRID_OBJECT_TYPES
        >
 /**
- * @brief
+ * @brief Grid of NxN cells, a cell is only allocated when the first object is added to it
  *
+ * Most cells of a loaded grid never hold an object, in instances even more so,
+ * so the cells without one are all represented by one shared empty cell that
+ * visits and const lookups read. The mutable accessors allocate the cell.
  */
 class NGrid
 {
@@ -166,11 +170,34 @@ class NGrid
             : i_gridId(id), i_x(x), i_y(y), i_cellstate(GRID_STATE_INVALID), i_GridObjectDataLoaded(false)
         {
             i_GridInfo = GridInfo(expiry, unload);
+
+            for (uint32 cx = 0; cx < N; ++cx)
+                for (uint32 cy = 0; cy < N; ++cy)
+                {
+                    i_cells[cx][cy] = NULL;
+                }
         }
 
         /**
          * @brief
          *
+         */
+        ~NGrid()
+        {
+            for (uint32 x = 0; x < N; ++x)
+                for (uint32 y = 0; y < N; ++y)
+                {
+                    if (i_cells[x][y])
+                    {
+                        delete i_cells[x][y];
+                        --CreatedCells();
+                    }
+                }
+        }
+
+        /**
+         * @brief the cell, the shared empty cell if it was never allocated
+         *
          * @param x
          * @param y
          * @return const GridType &operator
@@ -179,23 +206,42 @@ class NGrid
         {
             assert(x < N);
             assert(y < N);
-            return i_cells[x][y];
+            return i_cells[x][y] ? *i_cells[x][y] : EmptyCell();
         }
 
         /**
-         * @brief
+         * @brief the cell, allocated if it was not yet
          *
          * @param x
          * @param y
          * @return GridType &operator
          */
         GridType& operator()(uint32 x, uint32 y)
+        {
+            return getGridType(x, y);
+        }
+
+        /**
+         * @brief the cell if it was allocated, for walks that must not allocate empty cells
+         *
+         * @param x
+         * @param y
+         * @return GridType
+         */
+        GridType* getCellIfCreated(uint32 x, uint32 y)
         {
             assert(x < N);
             assert(y < N);
             return i_cells[x][y];
         }
 
+        /**
+         * @brief cells allocated by all grids of this type
+         *
+         * @return uint32
+         */
+        static uint32 GetCreatedCellCount() { return CreatedCells().load(std::memory_order_relaxed); }
+
         /**
          * @brief
          *
@@ -344,7 +390,10 @@ class NGrid
             for (uint32 x = 0; x < N; ++x)
                 for (uint32 y = 0; y < N; ++y)
                 {
-                    i_cells[x][y].Visit(visitor);
+                    if (i_cells[x][y])
+                    {
+                        i_cells[x][y]->Visit(visitor);
+                    }
                 }
         }
 
@@ -359,7 +408,10 @@ class NGrid
         template<class T, class TT>
         void Visit(const uint32& x, const uint32& y, TypeContainerVisitor<T, TT>& visitor)
         {
-            getGridType(x, y).Visit(visitor);
+            if (GridType* cell = getCellIfCreated(x, y))
+            {
+                cell->Visit(visitor);
+            }
         }
 
         /**
@@ -373,7 +425,10 @@ class NGrid
             for (uint32 x = 0; x < N; ++x)
                 for (uint32 y = 0; y < N; ++y)
                 {
-                    count += i_cells[x][y].ActiveObjectsInGrid();
+                    if (i_cells[x][y])
+                    {
+                        count += i_cells[x][y]->ActiveObjectsInGrid();
+                    }
                 }
 
             return count;
@@ -420,16 +475,46 @@ class NGrid
         {
             assert(x < N);
             assert(y < N);
-            return i_cells[x][y];
+            if (!i_cells[x][y])
+            {
+                i_cells[x][y] = new GridType;
+                ++CreatedCells();
+            }
+            return *i_cells[x][y];
+        }
+
+        /**
+         * @brief
+         *
+         * @return GridType
+         */
+        static const GridType& EmptyCell()
+        {
+            static GridType empty;
+            return empty;
+        }
+
+        /**
+         * @brief
+         *
+         * @return std::atomic<uint32>
+         */
+        static std::atomic<uint32>& CreatedCells()
+        {
+            static std::atomic<uint32> count(0);
+            return count;
         }
 
+        NGrid(const NGrid&);
+        NGrid& operator=(const NGrid&);
+
         uint32 i_gridId; /**< TODO */
         GridInfo i_GridInfo; /**< TODO */
         GridReference<NGrid<N, ACTIVE_OBJECT, WORLD_OBJECT_TYPES, GRID_OBJECT_TYPES> > i_Reference; /**< TODO */
         uint32 i_x; /**< TODO */
         uint32 i_y; /**< TODO */
         grid_state_t i_cellstate; /**< TODO */
-        GridType i_cells[N][N]; /**< TODO */
+        GridType* i_cells[N][N]; /**< NULL until the first object is added to the cell */
         bool i_GridObjectDataLoaded; /**< TODO */
 };
 
@@ -34,7 +34,9 @@
 
 #include <cstddef>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include "Platform/Define.h"
 #include "GameSystem/GridRefManager.h"
 
 
@@ -81,19 +83,79 @@ namespace Meta
   using Rename = typename Rename_Impl<A, B>::type;
   //----------------------------------------------------------------------------------------
 
+  // compile time visit filtering
+  //
+  // Users of the containers give each stored object type its own bit by specializing
+  // VisitTypeBit, a visitor declaring `static const uint32 VISIT_MASK` is then only
+  // handed the containers of the types in its mask. A visitor with a `bool IsDone() const`
+  // member stops the walk as soon as it returns true.
+  template<class T> struct VisitTypeBit
+  {
+    static const uint32 value = ~uint32(0);                 // unknown types are always visited
+  };
+
+  template<class> struct ToVoid { typedef void type; };
+
+  template<class V, class = void> struct VisitMask
+  {
+    static const uint32 value = ~uint32(0);
+  };
+
+  template<class V> struct VisitMask<V, typename ToVoid<decltype(V::VISIT_MASK)>::type>
+  {
+    static const uint32 value = V::VISIT_MASK;
+  };
+
+  template<class Tuple> struct TupleVisitMask;
+
+  template<> struct TupleVisitMask<std::tuple<>>
+  {
+    static const uint32 value = 0;
+  };
+
+  template<class T, class... Types> struct TupleVisitMask<std::tuple<T, Types...>>
+  {
+    static const uint32 value = VisitTypeBit<T>::value | TupleVisitMask<std::tuple<Types...>>::value;
+  };
+
+  template<class V, class = void> struct HasIsDone : std::false_type {};
+
+  template<class V> struct HasIsDone<V, typename ToVoid<decltype(std::declval<V const&>().IsDone())>::type> : std::true_type {};
+
+  template<class V> inline bool IsDone(V const& v, std::true_type) { return v.IsDone(); }
+  template<class V> inline bool IsDone(V const&, std::false_type) { return false; }
+  template<class V> inline bool IsDone(V const& v) { return IsDone(v, HasIsDone<V>()); }
+
+  template<class F, class T> inline void VisitElement(F& callback, GridRefManager<T>& element, std::true_type)
+  {
+    if (!IsDone(callback))
+    {
+      callback.Visit(element);
+    }
+  }
+
+  template<class F, class T> inline void VisitElement(F&, GridRefManager<T>&, std::false_type) {}
+
+  template<class F, class T> inline void VisitElement(F& callback, GridRefManager<T>& element)
+  {
+    typedef typename std::decay<F>::type Visitor;
+    VisitElement(callback, element, std::integral_constant<bool, (VisitMask<Visitor>::value & VisitTypeBit<T>::value) != 0>());
+  }
+  //----------------------------------------------------------------------------------------
+
   //tuple iteration
   template<size_t index, typename F, typename... Ts>
   struct iterate_tuple {
      void operator() (std::tuple<Ts...>&& t, F&& callback) {
          iterate_tuple<index - 1, F, Ts...>{}(std::forward<std::tuple<Ts...>>(t), std::forward<F>(callback));
-         callback.Visit(std::get<index>(t));
+         VisitElement(callback, std::get<index>(t));
      }
   };
 
   template<typename F, typename... Ts>
   struct iterate_tuple<0, F, Ts...> {
      void operator() (std::tuple<Ts...>&& t, F&& callback) {
-         callback.Visit(std::get<0>(t));
+         VisitElement(callback, std::get<0>(t));
      }
   };
 
@@ -153,6 +215,222 @@ class TypeUnorderedMapContainer
             }
         }
 
+        template <typename T>
+        size_t size(T*) const
+        {
+            return std::get<Meta::IndexOf<T,Tuple>::value>(i_container).size();
+        }
+
+    private:
+      Container i_container;
+};
+
+/**
+ * Direct lookup table from the 32 bit counter of a key to an object.
+ *
+ * The counter is split into four bytes, each indexing a page of 256 entries, so
+ * a lookup is four array reads without hashing. Pages are allocated on first use
+ * and released again once empty. The full key is kept beside the object and has
+ * to match, so a key that only shares the counter never resolves to the object.
+ */
+template<typename KEY_TYPE, typename T>
+class CounterSlotTable
+{
+    public:
+        CounterSlotTable() : m_root(), m_size(0) {}
+        ~CounterSlotTable() { freePage(&m_root, 0); }
+
+        bool insert(KEY_TYPE handle, T* object)
+        {
+            uint32 counter = handle.GetCounter();
+            InnerPage* page = &m_root;
+            void* child = nullptr;
+            for (uint32 level = 0; level < LEAF_LEVEL; ++level)
+            {
+                void*& entry = page->children[pageIndex(counter, level)];
+                if (!entry)
+                {
+                    entry = level + 1 < LEAF_LEVEL ? static_cast<void*>(new InnerPage()) : static_cast<void*>(new LeafPage());
+                    ++page->used;
+                }
+                child = entry;
+                page = static_cast<InnerPage*>(child);
+            }
+
+            LeafPage* leaf = static_cast<LeafPage*>(child);
+            Slot& slot = leaf->slots[counter & 0xFF];
+            if (slot.object)
+            {
+                assert(slot.key == handle && slot.object == object && "Object with certain key already in but objects are different!");
+                return false;
+            }
+
+            slot.key = handle;
+            slot.object = object;
+            ++leaf->used;
+            ++m_size;
+            return true;
+        }
+
+        bool erase(KEY_TYPE handle)
+        {
+            uint32 counter = handle.GetCounter();
+            InnerPage* path[LEAF_LEVEL];
+            void* child = &m_root;
+            for (uint32 level = 0; level < LEAF_LEVEL; ++level)
+            {
+                path[level] = static_cast<InnerPage*>(child);
+                child = path[level]->children[pageIndex(counter, level)];
+                if (!child)
+                {
+                    return true;
+                }
+            }
+
+            LeafPage* leaf = static_cast<LeafPage*>(child);
+            Slot& slot = leaf->slots[counter & 0xFF];
+            if (!slot.object || !(slot.key == handle))
+            {
+                return true;
+            }
+
+            slot.object = nullptr;
+            --m_size;
+            if (--leaf->used)
+            {
+                return true;
+            }
+
+            // release the emptied pages bottom up, the root stays
+            void* emptied = leaf;
+            for (int32 level = LEAF_LEVEL - 1; level >= 0; --level)
+            {
+                if (level + 1 == LEAF_LEVEL)
+                {
+                    delete static_cast<LeafPage*>(emptied);
+                }
+                else
+                {
+                    delete static_cast<InnerPage*>(emptied);
+                }
+
+                path[level]->children[pageIndex(counter, level)] = nullptr;
+                if (--path[level]->used || level == 0)
+                {
+                    break;
+                }
+                emptied = path[level];
+            }
+            return true;
+        }
+
+        T* find(KEY_TYPE handle) const
+        {
+            uint32 counter = handle.GetCounter();
+            void const* child = m_root.children[pageIndex(counter, 0)];
+            for (uint32 level = 1; child && level < LEAF_LEVEL; ++level)
+            {
+                child = static_cast<InnerPage const*>(child)->children[pageIndex(counter, level)];
+            }
+            if (!child)
+            {
+                return nullptr;
+            }
+
+            Slot const& slot = static_cast<LeafPage const*>(child)->slots[counter & 0xFF];
+            return slot.object && slot.key == handle ? slot.object : nullptr;
+        }
+
+        size_t size() const { return m_size; }
+
+    private:
+        static const uint32 LEAF_LEVEL = 3;                 // inner page levels above the leaf pages
+
+        struct Slot
+        {
+            KEY_TYPE key;
+            T* object;
+        };
+
+        struct LeafPage
+        {
+            Slot slots[256];
+            uint32 used;
+        };
+
+        struct InnerPage
+        {
+            void* children[256];
+            uint32 used;
+        };
+
+        static uint32 pageIndex(uint32 counter, uint32 level) { return (counter >> (24 - 8 * level)) & 0xFF; }
+
+        static void freePage(InnerPage* page, uint32 level)
+        {
+            for (uint32 i = 0; i < 256 && page->used; ++i)
+            {
+                if (!page->children[i])
+                {
+                    continue;
+                }
+
+                if (level + 1 == LEAF_LEVEL)
+                {
+                    delete static_cast<LeafPage*>(page->children[i]);
+                }
+                else
+                {
+                    InnerPage* child = static_cast<InnerPage*>(page->children[i]);
+                    freePage(child, level + 1);
+                    delete child;
+                }
+                page->children[i] = nullptr;
+                --page->used;
+            }
+        }
+
+        CounterSlotTable(CounterSlotTable const&);
+        CounterSlotTable& operator=(CounterSlotTable const&);
+
+        InnerPage m_root;
+        size_t m_size;
+};
+
+// Same interface as TypeUnorderedMapContainer, for keys with a unique 32 bit counter per stored type
+template<typename KEY_TYPE, typename TYPE_LIST>
+class TypeCounterSlotContainer
+{
+    using Tuple = Meta::Rename<TYPE_LIST,std::tuple>;
+    template <typename T> using add_wrap = CounterSlotTable<KEY_TYPE, T>;
+
+    using Container = Meta::Transform<add_wrap, Tuple>;
+
+    public:
+        template <typename T>
+        bool insert(KEY_TYPE handle, T* object)
+        {
+            return std::get<Meta::IndexOf<T,Tuple>::value>(i_container).insert(handle, object);
+        }
+
+        template <typename T>
+        bool erase(KEY_TYPE handle, T*)
+        {
+            return std::get<Meta::IndexOf<T,Tuple>::value>(i_container).erase(handle);
+        }
+
+        template <typename T>
+        T* find(KEY_TYPE handle, T*) const
+        {
+            return std::get<Meta::IndexOf<T,Tuple>::value>(i_container).find(handle);
+        }
+
+        template <typename T>
+        size_t size(T*) const
+        {
+            return std::get<Meta::IndexOf<T,Tuple>::value>(i_container).size();
+        }
+
     private:
       Container i_container;
 };
@@ -168,6 +446,9 @@ class TypeMapContainer
     using Container = Meta::Transform<add_wrap, Tuple>;
 
     public:
+        // bits of the stored types, visitors sharing none of them can skip the container
+        static const uint32 VISIT_TYPE_MASK = Meta::TupleVisitMask<Tuple>::value;
+
         template <typename T>
         size_t count(T*) const
         {
@@ -38,7 +38,14 @@ template<class VISITOR, class CONTAINER>
 class TypeContainerVisitor
 {
     public:
+        // false when the visitor takes none of the object types stored in CONTAINER
+        static const bool VISITS_CONTAINER = (Meta::VisitMask<VISITOR>::value & CONTAINER::VISIT_TYPE_MASK) != 0;
+
         TypeContainerVisitor(VISITOR& v) : i_visitor(v){}
+
+        // a searcher that already has its result does not need the remaining cells
+        bool IsDone() const { return Meta::IsDone(i_visitor); }
+
         void Visit(CONTAINER& c)
         {
             // accept
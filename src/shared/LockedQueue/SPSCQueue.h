@@ -0,0 +1,215 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace ACE_Based
+{
+    template < class T, size_t ChunkSize = 256 >
+    /**
+     * @brief Wait-free queue for exactly one producer and one consumer thread.
+     *
+     * Items are stored in a linked list of fixed size ring chunks. The producer
+     * only ever writes the tail chunk and the consumer only ever reads the head
+     * chunk, the two sides meet through one release/acquire counter per chunk,
+     * so neither side takes a lock or waits for the other. One drained chunk is
+     * kept aside and reused by the producer before a new one is allocated.
+     *
+     * Same interface as LockedQueue: add() may only be called by the producer,
+     * next() and empty() only by the consumer.
+     */
+    class SPSCQueue
+    {
+            struct Chunk
+            {
+                Chunk() : written(0), read(0), link(NULL) {}
+
+                T items[ChunkSize];
+                std::atomic<size_t> written;                /**< items published by the producer */
+                size_t read;                                /**< items taken by the consumer */
+                std::atomic<Chunk*> link;                   /**< next chunk, set once this one is full */
+            };
+
+            Chunk* _head; /**< consumer side */
+            Chunk* _tail; /**< producer side */
+            std::atomic<Chunk*> _spare; /**< drained chunk handed back to the producer */
+
+            SPSCQueue(SPSCQueue const&);
+            SPSCQueue& operator=(SPSCQueue const&);
+
+            /**
+             * @brief Returns the chunk holding the front item, NULL if the queue is empty.
+             *
+             */
+            Chunk* front()
+            {
+                for (;;)
+                {
+                    if (_head->read < _head->written.load(std::memory_order_acquire))
+                    {
+                        return _head;
+                    }
+
+                    if (_head->read < ChunkSize)
+                    {
+                        return NULL;
+                    }
+
+                    // fully consumed, the producer has moved on once link is set
+                    Chunk* nextChunk = _head->link.load(std::memory_order_acquire);
+                    if (!nextChunk)
+                    {
+                        return NULL;
+                    }
+
+                    recycle(_head);
+                    _head = nextChunk;
+                }
+            }
+
+            void recycle(Chunk* chunk)
+            {
+                chunk->written.store(0, std::memory_order_relaxed);
+                chunk->read = 0;
+                chunk->link.store(NULL, std::memory_order_relaxed);
+
+                delete _spare.exchange(chunk, std::memory_order_acq_rel);
+            }
+
+        public:
+
+            /**
+             * @brief Create a SPSCQueue.
+             *
+             */
+            SPSCQueue() : _head(new Chunk()), _tail(_head), _spare(NULL)
+            {
+            }
+
+            /**
+             * @brief Destroy a SPSCQueue, items still queued are not released.
+             *
+             */
+            ~SPSCQueue()
+            {
+                while (_head)
+                {
+                    Chunk* nextChunk = _head->link.load(std::memory_order_relaxed);
+                    delete _head;
+                    _head = nextChunk;
+                }
+
+                delete _spare.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Adds an item to the queue, producer thread only.
+             *
+             * @param item
+             */
+            void add(const T& item)
+            {
+                size_t pos = _tail->written.load(std::memory_order_relaxed);
+
+                if (pos < ChunkSize)
+                {
+                    _tail->items[pos] = item;
+                    _tail->written.store(pos + 1, std::memory_order_release);
+                    return;
+                }
+
+                Chunk* chunk = _spare.exchange(NULL, std::memory_order_acq_rel);
+                if (!chunk)
+                {
+                    chunk = new Chunk();
+                }
+
+                chunk->items[0] = item;
+                chunk->written.store(1, std::memory_order_relaxed);
+
+                // the consumer may free the old tail as soon as it sees the link
+                _tail->link.store(chunk, std::memory_order_release);
+                _tail = chunk;
+            }
+
+            /**
+             * @brief Gets the next result in the queue, if any. Consumer thread only.
+             *
+             * @param result
+             * @return bool
+             */
+            bool next(T& result)
+            {
+                Chunk* chunk = front();
+                if (!chunk)
+                {
+                    return false;
+                }
+
+                result = chunk->items[chunk->read++];
+                return true;
+            }
+
+            template<class Checker>
+            /**
+             * @brief Gets the next result if check.Process() accepts it, else leaves it queued.
+             *
+             * @param result
+             * @param check
+             * @return bool
+             */
+            bool next(T& result, Checker& check)
+            {
+                Chunk* chunk = front();
+                if (!chunk)
+                {
+                    return false;
+                }
+
+                result = chunk->items[chunk->read];
+                if (!check.Process(result))
+                {
+                    return false;
+                }
+
+                ++chunk->read;
+                return true;
+            }
+
+            /**
+             * @brief Checks if we're empty or not, consumer thread only.
+             *
+             * @return bool
+             */
+            bool empty()
+            {
+                return front() == NULL;
+            }
+    };
+}
+#endif
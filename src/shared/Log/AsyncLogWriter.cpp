@@ -0,0 +1,304 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include <ace/Guard_T.h>
+#include <ace/OS_NS_sys_time.h>
+#include <ace/OS_NS_Thread.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "AsyncLogWriter.h"
+
+AsyncLogWriter::AsyncLogWriter(uint32 queueSize, uint32 flushInterval, OverflowPolicy overflow)
+    : m_ring(NULL), m_mask(0), m_flushInterval(flushInterval ? flushInterval : 1), m_overflow(overflow),
+      m_enqueuePos(0), m_dequeuePos(0), m_written(0), m_dropped(0), m_waits(0), m_peak(0), m_wakeupPending(false),
+      m_wakeCondition(m_wakeLock), m_wakeRequested(false), m_stop(false), m_running(false)
+{
+    // the slot index is taken from the position with a mask
+    size_t capacity = 64;
+    while (capacity < queueSize)
+    {
+        capacity <<= 1;
+    }
+
+    m_ring = new Record[capacity];
+    m_mask = capacity - 1;
+
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        m_ring[i].sequence.store(i, std::memory_order_relaxed);
+        m_ring[i].heap = NULL;
+    }
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+    Stop();
+
+    for (size_t i = 0; i <= m_mask; ++i)
+    {
+        delete[] m_ring[i].heap;
+    }
+
+    delete[] m_ring;
+}
+
+bool AsyncLogWriter::Start()
+{
+    if (m_running)
+    {
+        return true;
+    }
+
+    m_stop = false;
+    if (activate(THR_NEW_LWP | THR_JOINABLE, 1) != 0)
+    {
+        return false;
+    }
+
+    m_running = true;
+    return true;
+}
+
+void AsyncLogWriter::Stop()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_wakeLock);
+        m_stop = true;
+        m_wakeCondition.signal();
+    }
+
+    wait();
+    m_running = false;
+}
+
+void AsyncLogWriter::Wakeup()
+{
+    // only one caller takes the lock until the writer picked the request up
+    if (m_wakeupPending.exchange(true, std::memory_order_acq_rel))
+    {
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_wakeLock);
+    m_wakeRequested = true;
+    m_wakeCondition.signal();
+}
+
+bool AsyncLogWriter::TryPush(FILE* file, char const* text, size_t length, bool urgent)
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Record* record;
+
+    for (;;)
+    {
+        record = &m_ring[pos & m_mask];
+        size_t sequence = record->sequence.load(std::memory_order_acquire);
+        ptrdiff_t diff = ptrdiff_t(sequence) - ptrdiff_t(pos);
+
+        if (diff == 0)
+        {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // the writer did not release this slot yet, ring is full
+            return false;
+        }
+        else
+        {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->file = file;
+    record->length = length;
+    record->urgent = urgent;
+
+    if (length <= RECORD_INLINE_SIZE)
+    {
+        memcpy(record->text, text, length);
+    }
+    else
+    {
+        record->heap = new char[length];
+        memcpy(record->heap, text, length);
+    }
+
+    record->sequence.store(pos + 1, std::memory_order_release);
+
+    uint32 fill = uint32(pos + 1 - m_dequeuePos.load(std::memory_order_relaxed));
+    uint32 peak = m_peak.load(std::memory_order_relaxed);
+    while (fill > peak && !m_peak.compare_exchange_weak(peak, fill, std::memory_order_relaxed))
+    {
+    }
+
+    // normal lines wait for the flush timer unless the ring gets crowded
+    if (urgent || fill > (m_mask + 1) / 2)
+    {
+        Wakeup();
+    }
+
+    return true;
+}
+
+bool AsyncLogWriter::Push(FILE* file, char const* text, size_t length, bool urgent)
+{
+    if (TryPush(file, text, length, urgent))
+    {
+        return true;
+    }
+
+    if (!urgent && m_overflow == OVERFLOW_DROP)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_waits.fetch_add(1, std::memory_order_relaxed);
+
+    do
+    {
+        Wakeup();
+        ACE_OS::thr_yield();
+    }
+    while (!TryPush(file, text, length, urgent));
+
+    return true;
+}
+
+bool AsyncLogWriter::Drain(std::vector<FILE*>& dirty, bool& urgent)
+{
+    bool any = false;
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        Record& record = m_ring[pos & m_mask];
+        if (record.sequence.load(std::memory_order_acquire) != pos + 1)
+        {
+            break;
+        }
+
+        if (record.heap)
+        {
+            fwrite(record.heap, 1, record.length, record.file);
+            delete[] record.heap;
+            record.heap = NULL;
+        }
+        else
+        {
+            fwrite(record.text, 1, record.length, record.file);
+        }
+
+        if (std::find(dirty.begin(), dirty.end(), record.file) == dirty.end())
+        {
+            dirty.push_back(record.file);
+        }
+
+        urgent |= record.urgent;
+        any = true;
+
+        // hand the slot back to the producers for the next lap of the ring
+        record.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_dequeuePos.store(++pos, std::memory_order_relaxed);
+        m_written.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return any;
+}
+
+int AsyncLogWriter::svc()
+{
+    std::vector<FILE*> dirty;
+    ACE_Time_Value interval(m_flushInterval / 1000, (m_flushInterval % 1000) * 1000);
+    ACE_Time_Value nextFlush = ACE_OS::gettimeofday() + interval;
+
+    for (;;)
+    {
+        m_wakeupPending.store(false, std::memory_order_release);
+
+        bool urgent = false;
+        bool any = Drain(dirty, urgent);
+
+        ACE_Time_Value now = ACE_OS::gettimeofday();
+        if (urgent || now >= nextFlush)
+        {
+            for (std::vector<FILE*>::const_iterator itr = dirty.begin(); itr != dirty.end(); ++itr)
+            {
+                fflush(*itr);
+            }
+
+            dirty.clear();
+            nextFlush = now + interval;
+        }
+
+        if (any)
+        {
+            continue;
+        }
+
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_wakeLock, -1);
+        if (m_stop)
+        {
+            break;
+        }
+
+        if (!m_wakeRequested)
+        {
+            m_wakeCondition.wait(&nextFlush);
+        }
+
+        m_wakeRequested = false;
+    }
+
+    // a line pushed right before the stop request is still written
+    bool urgent = false;
+    Drain(dirty, urgent);
+
+    for (std::vector<FILE*>::const_iterator itr = dirty.begin(); itr != dirty.end(); ++itr)
+    {
+        fflush(*itr);
+    }
+
+    return 0;
+}
+
+void AsyncLogWriter::GetStats(Stats& stats) const
+{
+    stats.written = m_written.load(std::memory_order_relaxed);
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    stats.waits = m_waits.load(std::memory_order_relaxed);
+    stats.peak = m_peak.load(std::memory_order_relaxed);
+}
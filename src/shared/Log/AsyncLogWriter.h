@@ -0,0 +1,128 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_H_ASYNCLOGWRITER
+#define MANGOS_H_ASYNCLOGWRITER
+
+#include <ace/Task.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+#include "Platform/Define.h"
+
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Background writer for the log files.
+ *
+ * Callers hand over fully formatted lines with Push(), which claims a slot of
+ * a bounded ring with a single compare-and-swap and returns right away. The
+ * writer thread drains the ring in batches, writes each line to its file and
+ * only flushes the touched files when the flush interval has passed or when
+ * an urgent (error) line was written, so map threads never wait on disk I/O.
+ *
+ * When the ring is full normal lines are either dropped or the caller waits
+ * for a free slot, depending on the overflow policy. Urgent lines always wait.
+ */
+class AsyncLogWriter : protected ACE_Task_Base
+{
+    public:
+
+        enum OverflowPolicy
+        {
+            OVERFLOW_DROP = 0,                              // drop the line and count it
+            OVERFLOW_WAIT = 1                               // wait until the writer made room
+        };
+
+        struct Stats
+        {
+            uint64 written;
+            uint64 dropped;
+            uint64 waits;
+            uint32 peak;
+        };
+
+        AsyncLogWriter(uint32 queueSize, uint32 flushInterval, OverflowPolicy overflow);
+        virtual ~AsyncLogWriter();
+
+        bool Start();
+
+        // writes and flushes everything still queued, then stops the thread
+        void Stop();
+
+        bool IsRunning() const { return m_running; }
+
+        // queue one line for file, false if it was dropped
+        bool Push(FILE* file, char const* text, size_t length, bool urgent);
+
+        void GetStats(Stats& stats) const;
+
+        virtual int svc();
+
+    private:
+
+        enum
+        {
+            RECORD_INLINE_SIZE = 232                        // longer lines are copied to the heap
+        };
+
+        struct Record
+        {
+            std::atomic<size_t> sequence;                   // ring position this slot is ready for
+            FILE* file;
+            size_t length;
+            char* heap;
+            bool urgent;
+            char text[RECORD_INLINE_SIZE];
+        };
+
+        bool TryPush(FILE* file, char const* text, size_t length, bool urgent);
+        bool Drain(std::vector<FILE*>& dirty, bool& urgent);
+        void Wakeup();
+
+        Record* m_ring;
+        size_t m_mask;
+        uint32 m_flushInterval;                             // in milliseconds
+        OverflowPolicy m_overflow;
+
+        std::atomic<size_t> m_enqueuePos;
+        std::atomic<size_t> m_dequeuePos;
+
+        std::atomic<uint64> m_written;
+        std::atomic<uint64> m_dropped;
+        std::atomic<uint64> m_waits;
+        std::atomic<uint32> m_peak;
+        std::atomic<bool> m_wakeupPending;
+
+        ACE_Thread_Mutex m_wakeLock;
+        ACE_Condition_Thread_Mutex m_wakeCondition;
+        bool m_wakeRequested;
+        bool m_stop;
+        bool m_running;
+};
+
+#endif
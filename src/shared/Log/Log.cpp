@@ -29,15 +29,107 @@
 #include "Utilities/Util.h"
 #include "Utilities/ByteBuffer.h"
 #include "Utilities/ProgressBar.h"
+#include "AsyncLogWriter.h"
 
 #include <stdarg.h>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 #include <ace/OS_NS_unistd.h>
+#include <ace/TSS_T.h>
 
 INSTANTIATE_SINGLETON_1(Log);
 
+/**
+ * @brief Per thread scratch buffer a log file line is formatted into
+ *
+ * Kept for the life of the thread, so formatting a line neither allocates
+ * nor takes a lock once the buffer has grown to the longest line seen.
+ */
+class LogLine
+{
+    public:
+        LogLine() : m_data(512), m_length(0) {}
+
+        void Clear() { m_length = 0; }
+
+        char const* Data() const { return &m_data[0]; }
+        size_t Length() const { return m_length; }
+
+        void Append(char const* str, size_t length)
+        {
+            Reserve(length);
+            memcpy(&m_data[m_length], str, length);
+            m_length += length;
+        }
+
+        void AppendTimestamp()
+        {
+            time_t tt = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+
+            std::tm aTm;
+            localtime_r(&tt, &aTm);
+            AppendFormat("%-4d-%02d-%02d %02d:%02d:%02d ", aTm.tm_year + 1900, aTm.tm_mon + 1, aTm.tm_mday, aTm.tm_hour, aTm.tm_min, aTm.tm_sec);
+        }
+
+        void AppendFormat(char const* format, ...) ATTR_PRINTF(2, 3)
+        {
+            va_list ap;
+            va_start(ap, format);
+            AppendFormat(format, &ap);
+            va_end(ap);
+        }
+
+        void AppendFormat(char const* format, va_list* ap)
+        {
+            va_list copy;
+            va_copy(copy, *ap);
+            int written = vsnprintf(&m_data[m_length], m_data.size() - m_length, format, copy);
+            va_end(copy);
+
+            if (written < 0)
+            {
+                return;
+            }
+
+            if (size_t(written) >= m_data.size() - m_length)
+            {
+                Reserve(size_t(written) + 1);
+
+                va_copy(copy, *ap);
+                vsnprintf(&m_data[m_length], m_data.size() - m_length, format, copy);
+                va_end(copy);
+            }
+
+            m_length += size_t(written);
+        }
+
+    private:
+        void Reserve(size_t extra)
+        {
+            if (m_length + extra > m_data.size())
+            {
+                m_data.resize(std::max(m_data.size() * 2, m_length + extra));
+            }
+        }
+
+        std::vector<char> m_data;
+        size_t m_length;
+};
+
+static LogLine& GetLogLine()
+{
+    // never destroyed, logging may still happen while static objects are torn down
+    static ACE_TSS<LogLine>* lines = new ACE_TSS<LogLine>();
+
+    LogLine* line = *lines;
+    line->Clear();
+    return *line;
+}
+
 LogFilterData logFilterData[LOG_FILTER_COUNT] =
 {
     { "transport_moves",     "LogFilter_TransportMoves",     true  },
@@ -78,7 +170,7 @@ Log::Log() :
 #endif /* ENABLE_ELUNA */
 
     eventAiErLogfile(NULL), scriptErrLogFile(NULL), worldLogfile(NULL), wardenLogfile(NULL), m_colored(false),
-    m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(NULL)
+    m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(NULL), m_asyncWriter(NULL)
 {
     Initialize();
 }
@@ -402,6 +494,80 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
+void Log::StartAsyncWriter()
+{
+    if (m_asyncWriter || !sConfig.GetBoolDefault("LogAsync", false))
+    {
+        return;
+    }
+
+    uint32 queueSize = sConfig.GetIntDefault("LogAsync.QueueSize", 8192);
+    uint32 flushInterval = sConfig.GetIntDefault("LogAsync.FlushInterval", 500);
+    AsyncLogWriter::OverflowPolicy overflow = sConfig.GetIntDefault("LogAsync.Overflow", 0) ? AsyncLogWriter::OVERFLOW_WAIT : AsyncLogWriter::OVERFLOW_DROP;
+
+    AsyncLogWriter* writer = new AsyncLogWriter(queueSize, flushInterval, overflow);
+    if (!writer->Start())
+    {
+        delete writer;
+        outError("Log: can't start the async log writer thread, log files are written directly.");
+        return;
+    }
+
+    m_asyncWriter = writer;
+    outString("Log: async log files enabled (queue %u lines, flush every %u ms).", queueSize, flushInterval);
+}
+
+void Log::StopAsyncWriter()
+{
+    if (!m_asyncWriter)
+    {
+        return;
+    }
+
+    // lines logged from now on are written directly again
+    AsyncLogWriter* writer = m_asyncWriter;
+    m_asyncWriter = NULL;
+    writer->Stop();
+
+    AsyncLogWriter::Stats stats;
+    writer->GetStats(stats);
+    delete writer;
+
+    outString("Log: async log writer stopped, " UI64FMTD " lines written, " UI64FMTD " dropped, " UI64FMTD " waits for a full queue, peak %u queued.",
+              stats.written, stats.dropped, stats.waits, stats.peak);
+}
+
+void Log::writeLogLine(FILE* file, LogLine const& line, bool urgent)
+{
+    if (m_asyncWriter)
+    {
+        m_asyncWriter->Push(file, line.Data(), line.Length(), urgent);
+        return;
+    }
+
+    fwrite(line.Data(), 1, line.Length(), file);
+    fflush(file);
+}
+
+void Log::outFile(FILE* file, char const* prefix, char const* str, va_list* ap, bool urgent)
+{
+    LogLine& line = GetLogLine();
+    line.AppendTimestamp();
+
+    if (prefix)
+    {
+        line.Append(prefix, strlen(prefix));
+    }
+
+    if (str)
+    {
+        line.AppendFormat(str, ap);
+    }
+
+    line.Append("\n", 1);
+    writeLogLine(file, line, urgent);
+}
+
 void Log::outString()
 {
     if (m_includeTime)
@@ -411,9 +577,7 @@ void Log::outString()
     printf("\n");
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        outFile(logfile, NULL, NULL, NULL, false);
     }
 
     fflush(stdout);
@@ -451,14 +615,9 @@ void Log::outString(const char* str, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        outFile(logfile, NULL, str, &ap, false);
         va_end(ap);
-
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -495,15 +654,9 @@ void Log::outError(const char* err, ...)
     fprintf(stderr, "\n");
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        outFile(logfile, "ERROR:", err, &ap, true);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     fflush(stderr);
@@ -520,16 +673,12 @@ void Log::outErrorDb()
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
+        outFile(logfile, "ERROR:", NULL, NULL, true);
     }
 
     if (dberLogfile)
     {
-        outTimestamp(dberLogfile);
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
+        outFile(dberLogfile, NULL, NULL, NULL, true);
     }
 
     fflush(stderr);
@@ -567,28 +716,16 @@ void Log::outErrorDb(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        outFile(logfile, "ERROR:", err, &ap, true);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (dberLogfile)
     {
-        outTimestamp(dberLogfile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
+        outFile(dberLogfile, NULL, err, &ap, true);
         va_end(ap);
-
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
     }
 
     fflush(stderr);
@@ -606,16 +743,12 @@ void Log::outErrorEluna()
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR Eluna\n");
-        fflush(logfile);
+        outFile(logfile, "ERROR Eluna", NULL, NULL, true);
     }
 
     if (elunaErrLogfile)
     {
-        outTimestamp(elunaErrLogfile);
-        fprintf(elunaErrLogfile, "\n");
-        fflush(elunaErrLogfile);
+        outFile(elunaErrLogfile, NULL, NULL, NULL, true);
     }
 
     fflush(stderr);
@@ -658,28 +791,16 @@ void Log::outErrorEluna(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR Eluna: ");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        outFile(logfile, "ERROR Eluna: ", err, &ap, true);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (elunaErrLogfile)
     {
-        outTimestamp(elunaErrLogfile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(elunaErrLogfile, err, ap);
+        outFile(elunaErrLogfile, NULL, err, &ap, true);
         va_end(ap);
-
-        fprintf(elunaErrLogfile, "\n");
-        fflush(elunaErrLogfile);
     }
 
     fflush(stderr);
@@ -700,16 +821,12 @@ void Log::outErrorEventAI()
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
+        outFile(logfile, "ERROR CreatureEventAI", NULL, NULL, true);
     }
 
     if (eventAiErLogfile)
     {
-        outTimestamp(eventAiErLogfile);
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
+        outFile(eventAiErLogfile, NULL, NULL, NULL, true);
     }
 
     fflush(stderr);
@@ -747,28 +864,16 @@ void Log::outErrorEventAI(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        outFile(logfile, "ERROR CreatureEventAI: ", err, &ap, true);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (eventAiErLogfile)
     {
-        outTimestamp(eventAiErLogfile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(eventAiErLogfile, err, ap);
+        outFile(eventAiErLogfile, NULL, err, &ap, true);
         va_end(ap);
-
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
     }
 
     fflush(stderr);
@@ -809,12 +914,9 @@ void Log::outBasic(const char* str, ...)
     if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
     {
         va_list ap;
-        outTimestamp(logfile);
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        outFile(logfile, NULL, str, &ap, false);
         va_end(ap);
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -854,15 +956,10 @@ void Log::outDetail(const char* str, ...)
 
     if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
-        outTimestamp(logfile);
-
         va_list ap;
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
+        outFile(logfile, NULL, str, &ap, false);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -902,15 +999,10 @@ void Log::outDebug(const char* str, ...)
 
     if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
     {
-        outTimestamp(logfile);
-
         va_list ap;
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
+        outFile(logfile, NULL, str, &ap, false);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -951,16 +1043,14 @@ void Log::outCommand(uint32 account, const char* str, ...)
     if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
         va_list ap;
-        outTimestamp(logfile);
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        outFile(logfile, NULL, str, &ap, false);
         va_end(ap);
-        fflush(logfile);
     }
 
     if (m_gmlog_per_account)
     {
+        // the file is closed right away, so this one is never queued
         if (FILE* per_file = openGmlogPerAccount(account))
         {
             va_list ap;
@@ -975,12 +1065,9 @@ void Log::outCommand(uint32 account, const char* str, ...)
     else if (gmLogfile)
     {
         va_list ap;
-        outTimestamp(gmLogfile);
         va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n");
+        outFile(gmLogfile, NULL, str, &ap, false);
         va_end(ap);
-        fflush(gmLogfile);
     }
 
     fflush(stdout);
@@ -995,9 +1082,7 @@ void Log::outWarden()
     printf("\n");
     if (wardenLogfile)
     {
-        outTimestamp(wardenLogfile);
-        fprintf(wardenLogfile, "\n");
-        fflush(wardenLogfile);
+        outFile(wardenLogfile, NULL, NULL, NULL, false);
     }
 
     fflush(stdout);
@@ -1038,16 +1123,9 @@ void Log::outWarden(const char* str, ...)
     if (wardenLogfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
         va_list ap;
-
-        outTimestamp(wardenLogfile);
-        fprintf(wardenLogfile, "[Warden]: ");
-
         va_start(ap, str);
-        vfprintf(wardenLogfile, str, ap);
-        fprintf(wardenLogfile, "\n");
+        outFile(wardenLogfile, "[Warden]: ", str, &ap, false);
         va_end(ap);
-
-        fflush(wardenLogfile);
     }
 
     fflush(stdout);
@@ -1063,12 +1141,9 @@ void Log::outChar(const char* str, ...)
     if (charLogfile)
     {
         va_list ap;
-        outTimestamp(charLogfile);
         va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n");
+        outFile(charLogfile, NULL, str, &ap, false);
         va_end(ap);
-        fflush(charLogfile);
     }
 }
 
@@ -1083,23 +1158,13 @@ void Log::outErrorScriptLib()
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-        {
-            fprintf(logfile, "<%s ERROR:> ", m_scriptLibName);
-        }
-        else
-        {
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        }
-        fflush(logfile);
+        std::string prefix = m_scriptLibName ? std::string("<") + m_scriptLibName + " ERROR>: " : "<Scripting Library ERROR>: ";
+        outFile(logfile, prefix.c_str(), NULL, NULL, true);
     }
 
     if (scriptErrLogFile)
     {
-        outTimestamp(scriptErrLogFile);
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
+        outFile(scriptErrLogFile, NULL, NULL, NULL, true);
     }
 
     fflush(stderr);
@@ -1137,35 +1202,17 @@ void Log::outErrorScriptLib(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-        {
-            fprintf(logfile, "<%s ERROR>: ", m_scriptLibName);
-        }
-        else
-        {
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        }
-
+        std::string prefix = m_scriptLibName ? std::string("<") + m_scriptLibName + " ERROR>: " : "<Scripting Library ERROR>: ";
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        outFile(logfile, prefix.c_str(), err, &ap, true);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (scriptErrLogFile)
     {
-        outTimestamp(scriptErrLogFile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(scriptErrLogFile, err, ap);
+        outFile(scriptErrLogFile, NULL, err, &ap, true);
         va_end(ap);
-
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
     }
 
     fflush(stderr);
@@ -1178,35 +1225,46 @@ void Log::outWorldPacketDump(uint32 socket, uint32 opcode, char const* opcodeNam
         return;
     }
 
-    ACE_GUARD(ACE_Thread_Mutex, GuardObj, m_worldLogMtx);
-
-    outTimestamp(worldLogfile);
+    static char const hexDigits[] = "0123456789ABCDEF";
 
-    fprintf(worldLogfile, "\n%s:\nSOCKET: %u\nLENGTH: " SIZEFMTD "\nOPCODE: %s (0x%.4X)\nDATA:\n",
-            incoming ? "CLIENT" : "SERVER",
-            socket, packet->size(), opcodeName, opcode);
+    // the whole dump is built first and written as one record, so dumps of different threads never interleave
+    LogLine& line = GetLogLine();
+    line.AppendTimestamp();
+    line.AppendFormat("\n%s:\nSOCKET: %u\nLENGTH: " SIZEFMTD "\nOPCODE: %s (0x%.4X)\nDATA:\n",
+                      incoming ? "CLIENT" : "SERVER",
+                      socket, packet->size(), opcodeName, opcode);
 
     size_t p = 0;
     while (p < packet->size())
     {
+        char hex[16 * 3 + 1];
+        size_t len = 0;
+
         for (size_t j = 0; j < 16 && p < packet->size(); ++j)
         {
-            fprintf(worldLogfile, "%.2X ", (*packet)[p++]);
+            uint8 value = (*packet)[p++];
+            hex[len++] = hexDigits[value >> 4];
+            hex[len++] = hexDigits[value & 0x0F];
+            hex[len++] = ' ';
         }
 
-        fprintf(worldLogfile, "\n");
+        hex[len++] = '\n';
+        line.Append(hex, len);
     }
 
-    fprintf(worldLogfile, "\n\n");
-    fflush(worldLogfile);
+    line.Append("\n\n", 2);
+    writeLogLine(worldLogfile, line, false);
 }
 
 void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
     if (charLogfile)
     {
-        fprintf(charLogfile, "== START DUMP == (account: %u guid: %u name: %s )\n%s\n== END DUMP ==\n", account_id, guid, name, str);
-        fflush(charLogfile);
+        LogLine& line = GetLogLine();
+        line.AppendFormat("== START DUMP == (account: %u guid: %u name: %s )\n", account_id, guid, name);
+        line.Append(str, strlen(str));
+        line.Append("\n== END DUMP ==\n", 16);
+        writeLogLine(charLogfile, line, false);
     }
 }
 
@@ -1220,12 +1278,9 @@ void Log::outRALog(const char* str, ...)
     if (raLogfile)
     {
         va_list ap;
-        outTimestamp(raLogfile);
         va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n");
+        outFile(raLogfile, NULL, str, &ap, false);
         va_end(ap);
-        fflush(raLogfile);
     }
 
     fflush(stdout);
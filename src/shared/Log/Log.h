@@ -30,6 +30,8 @@
 
 class Config;
 class ByteBuffer;
+class LogLine;
+class AsyncLogWriter;
 
 /**
  * @brief various levels for logging
@@ -129,6 +131,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
          */
         ~Log()
         {
+            StopAsyncWriter();
+
             if (logfile != NULL)
             {
                 fclose(logfile);
@@ -431,6 +435,19 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
          */
         void setScriptLibraryErrorFile(char const* fname, char const* libName);
 
+        /**
+         * @brief Hand the log file writes to a background thread if LogAsync is set
+         *
+         * Call once the process is done forking (daemon mode), the lines logged
+         * before are written directly.
+         */
+        void StartAsyncWriter();
+        /**
+         * @brief Write out the queued lines, stop the writer thread and log its counters
+         *
+         */
+        void StopAsyncWriter();
+
     private:
         /**
          * @brief
@@ -448,6 +465,24 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
          * @return FILE
          */
         FILE* openGmlogPerAccount(uint32 account);
+        /**
+         * @brief Write timestamp, prefix and the formatted text as one line of file
+         *
+         * @param file
+         * @param prefix may be NULL
+         * @param str may be NULL for an empty line
+         * @param ap arguments of str
+         * @param urgent flush right away also in async mode
+         */
+        void outFile(FILE* file, char const* prefix, char const* str, va_list* ap, bool urgent);
+        /**
+         * @brief Queue the line for the writer thread, or write and flush it directly
+         *
+         * @param file
+         * @param line
+         * @param urgent
+         */
+        void writeLogLine(FILE* file, LogLine const& line, bool urgent);
 
         FILE* raLogfile; /**< TODO */
         FILE* logfile; /**< TODO */
@@ -462,7 +497,6 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
         FILE* scriptErrLogFile; /**< TODO */
         FILE* worldLogfile; /**< TODO */
         FILE* wardenLogfile; /**< TODO */
-        ACE_Thread_Mutex m_worldLogMtx; /**< TODO */
 
         LogLevel m_logLevel; /**< log/console control */
         LogLevel m_logFileLevel; /**< TODO */
@@ -483,6 +517,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
         std::string m_gmlog_filename_format; /**< TODO */
 
         char const* m_scriptLibName; /**< TODO */
+
+        AsyncLogWriter* m_asyncWriter; /**< set while the log files are written by the background thread */
 };
 
 #define sLog MaNGOS::Singleton<Log>::Instance()
@@ -27,6 +27,7 @@
 #include <ace/Log_Msg.h>
 
 #include "DelayExecutor.h"
+#include "Threading.h"
 
 DelayExecutor* DelayExecutor::instance()
 {
@@ -59,6 +60,11 @@ int DelayExecutor::deactivate()
 
 int DelayExecutor::svc()
 {
+    if (!ACE_Based::Thread::SetCurrentThreadAffinity(affinity_))
+    {
+        ACE_ERROR((LM_ERROR, ACE_TEXT("(%t) DelayExecutor: can't run on CPUs %s\n"), affinity_.c_str()));
+    }
+
     for (;;)
     {
         ACE_Method_Request* rq = queue_.dequeue();
@@ -29,6 +29,8 @@
 #include <ace/Activation_Queue.h>
 #include <ace/Method_Request.h>
 
+#include <string>
+
 class DelayExecutor : protected ACE_Task_Base
 {
     public:
@@ -46,12 +48,16 @@ class DelayExecutor : protected ACE_Task_Base
 
         bool activated();
 
+        // CPUs the threads started by the next _activate() run on, see ACE_Based::Thread::SetCurrentThreadAffinity()
+        void set_affinity(std::string const& cpus) { affinity_ = cpus; }
+
         virtual int svc();
 
     private:
 
         ACE_Activation_Queue queue_;
         bool activated_;
+        std::string affinity_;
 
         void activated(bool s);
 };
@@ -27,6 +27,14 @@
 #include <ace/OS_NS_unistd.h>
 #include <ace/Sched_Params.h>
 #include <vector>
+#include <cstdlib>
+
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#elif defined(_WIN32)
+#  include <windows.h>
+#endif
 
 using namespace ACE_Based;
 
@@ -240,3 +248,101 @@ void Thread::Sleep(unsigned long msecs)
 {
     ACE_OS::sleep(ACE_Time_Value(0, 1000 * msecs));
 }
+
+bool Thread::ParseCpuList(std::string const& cpus, std::vector<unsigned int>& list)
+{
+    list.clear();
+
+    char const* pos = cpus.c_str();
+    while (*pos)
+    {
+        if (*pos == ' ' || *pos == ',')
+        {
+            ++pos;
+            continue;
+        }
+
+        char* end;
+        unsigned long first = strtoul(pos, &end, 10);
+        if (end == pos)
+        {
+            return false;
+        }
+
+        unsigned long last = first;
+        if (*end == '-')
+        {
+            pos = end + 1;
+            last = strtoul(pos, &end, 10);
+            if (end == pos || last < first)
+            {
+                return false;
+            }
+        }
+
+        // no more CPUs than any affinity API takes
+        if (last >= 1024)
+        {
+            return false;
+        }
+
+        for (unsigned long cpu = first; cpu <= last; ++cpu)
+        {
+            list.push_back((unsigned int)cpu);
+        }
+
+        pos = end;
+        if (*pos && *pos != ',' && *pos != ' ')
+        {
+            return false;
+        }
+    }
+
+    return !list.empty();
+}
+
+bool Thread::SetCurrentThreadAffinity(std::string const& cpus)
+{
+    if (cpus.empty())
+    {
+        return true;
+    }
+
+    std::vector<unsigned int> list;
+    if (!ParseCpuList(cpus, list))
+    {
+        return false;
+    }
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (std::vector<unsigned int>::const_iterator itr = list.begin(); itr != list.end(); ++itr)
+    {
+        if (*itr >= CPU_SETSIZE)
+        {
+            return false;
+        }
+
+        CPU_SET(*itr, &set);
+    }
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (std::vector<unsigned int>::const_iterator itr = list.begin(); itr != list.end(); ++itr)
+    {
+        // processor groups beyond the first are not supported
+        if (*itr >= sizeof(DWORD_PTR) * 8)
+        {
+            return false;
+        }
+
+        mask |= DWORD_PTR(1) << *itr;
+    }
+
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+    return false;
+#endif
+}
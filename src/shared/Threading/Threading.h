@@ -30,6 +30,9 @@
 #include <ace/Atomic_Op.h>
 #include <assert.h>
 
+#include <string>
+#include <vector>
+
 namespace ACE_Based
 {
     /**
@@ -178,6 +181,27 @@ namespace ACE_Based
              */
             static void Sleep(unsigned long msecs);
 
+            /**
+             * @brief Parses a CPU list like "0-7,16-23"
+             *
+             * @param cpus comma separated CPU numbers and ranges
+             * @param list the CPU numbers
+             * @return bool false if the list is malformed or empty
+             */
+            static bool ParseCpuList(std::string const& cpus, std::vector<unsigned int>& list);
+
+            /**
+             * @brief Restricts the calling thread to a set of CPUs
+             *
+             * Memory a thread touches first is placed by the OS on the NUMA node of
+             * the CPU it runs on, so a thread class pinned to the CPUs of one node
+             * keeps its data there as well.
+             *
+             * @param cpus CPU list as accepted by ParseCpuList(), empty for no restriction
+             * @return bool false if the list is malformed or the OS refused it
+             */
+            static bool SetCurrentThreadAffinity(std::string const& cpus);
+
         private:
             /**
              * @brief
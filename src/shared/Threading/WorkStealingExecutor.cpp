@@ -0,0 +1,291 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include <ace/Guard_T.h>
+#include <ace/Log_Msg.h>
+
+#include <algorithm>
+
+#include "WorkStealingExecutor.h"
+#include "Threading.h"
+
+WorkStealingExecutor::WorkStealingExecutor()
+    : m_sleepCondition(m_sleepLock), m_queued(0), m_nextWorker(0), m_nextTarget(0), m_stop(false), activated_(false)
+{
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    deactivate();
+}
+
+int WorkStealingExecutor::deactivate()
+{
+    if (!activated())
+    {
+        return -1;
+    }
+
+    activated_ = false;
+
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_sleepLock, -1);
+        m_stop = true;
+        m_sleepCondition.broadcast();
+    }
+
+    wait();
+
+    for (size_t i = 0; i < m_queues.size(); ++i)
+    {
+        for (std::deque<ACE_Method_Request*>::iterator itr = m_queues[i]->requests.begin(); itr != m_queues[i]->requests.end(); ++itr)
+        {
+            delete *itr;
+        }
+
+        delete m_queues[i];
+    }
+
+    m_queues.clear();
+
+    for (std::vector<PendingRequest>::iterator itr = m_batch.begin(); itr != m_batch.end(); ++itr)
+    {
+        delete itr->request;
+    }
+
+    m_batch.clear();
+
+    return 0;
+}
+
+int WorkStealingExecutor::svc()
+{
+    size_t self = size_t(++m_nextWorker - 1);
+
+    if (!ACE_Based::Thread::SetCurrentThreadAffinity(m_affinity))
+    {
+        ACE_ERROR((LM_ERROR, ACE_TEXT("(%t) WorkStealingExecutor: can't run on CPUs %s\n"), m_affinity.c_str()));
+    }
+
+    for (;;)
+    {
+        ACE_Method_Request* rq = NULL;
+
+        if (pop(self, rq) || steal(self, rq))
+        {
+            --m_queued;
+
+            rq->call();
+            delete rq;
+            continue;
+        }
+
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_sleepLock, -1);
+
+        while (!m_stop && m_queued.value() == 0)
+        {
+            m_sleepCondition.wait();
+        }
+
+        if (m_stop)
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+bool WorkStealingExecutor::pop(size_t worker, ACE_Method_Request*& rq)
+{
+    WorkerQueue& queue = *m_queues[worker];
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, queue.lock, false);
+
+    if (queue.requests.empty())
+    {
+        return false;
+    }
+
+    // own work is taken from the front, where the most expensive request is
+    rq = queue.requests.front();
+    queue.requests.pop_front();
+    return true;
+}
+
+bool WorkStealingExecutor::steal(size_t thief, ACE_Method_Request*& rq)
+{
+    size_t count = m_queues.size();
+
+    for (size_t i = 1; i < count; ++i)
+    {
+        WorkerQueue& victim = *m_queues[(thief + i) % count];
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, victim.lock, false);
+
+        if (victim.requests.empty())
+        {
+            continue;
+        }
+
+        // stolen work is taken from the back, the owner keeps its expensive requests
+        rq = victim.requests.back();
+        victim.requests.pop_back();
+        return true;
+    }
+
+    return false;
+}
+
+int WorkStealingExecutor::_activate(int num_threads)
+{
+    if (activated())
+    {
+        return -1;
+    }
+
+    if (num_threads < 1)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < num_threads; ++i)
+    {
+        m_queues.push_back(new WorkerQueue());
+    }
+
+    m_stop = false;
+    m_nextWorker = 0;
+
+    if (ACE_Task_Base::activate(THR_NEW_LWP | THR_JOINABLE | THR_INHERIT_SCHED, num_threads) == -1)
+    {
+        return -1;
+    }
+
+    activated_ = true;
+
+    return 0;
+}
+
+int WorkStealingExecutor::execute(ACE_Method_Request* new_req, uint32 cost, int worker)
+{
+    if (new_req == NULL)
+    {
+        return -1;
+    }
+
+    if (!activated())
+    {
+        delete new_req;
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%t) %p\n"), ACE_TEXT("WorkStealingExecutor::execute not activated")), -1);
+    }
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_batchLock, -1);
+    m_batch.push_back(PendingRequest(new_req, cost, worker));
+    return 0;
+}
+
+void WorkStealingExecutor::dispatch()
+{
+    std::vector<PendingRequest> batch;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_batchLock);
+        batch.swap(m_batch);
+    }
+
+    if (batch.empty())
+    {
+        return;
+    }
+
+    // most expensive first, each going to the currently least loaded worker
+    std::stable_sort(batch.begin(), batch.end());
+
+    std::vector<uint64> load(m_queues.size(), 0);
+
+    // the bound requests load their workers whatever their place in the order
+    for (std::vector<PendingRequest>::const_iterator itr = batch.begin(); itr != batch.end(); ++itr)
+    {
+        if (itr->worker >= 0)
+        {
+            load[size_t(itr->worker) % load.size()] += itr->cost + 1;
+        }
+    }
+
+    for (std::vector<PendingRequest>::const_iterator itr = batch.begin(); itr != batch.end(); ++itr)
+    {
+        size_t target;
+        if (itr->worker >= 0)
+        {
+            target = size_t(itr->worker) % load.size();
+        }
+        else
+        {
+            target = std::min_element(load.begin(), load.end()) - load.begin();
+            // count every request as at least 1 so zero-cost requests are still spread out
+            load[target] += itr->cost + 1;
+        }
+
+        // counted before it becomes visible so a worker never sees the counter below the real amount
+        ++m_queued;
+
+        WorkerQueue& queue = *m_queues[target];
+        ACE_GUARD(ACE_Thread_Mutex, guard, queue.lock);
+        queue.requests.push_back(itr->request);
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_sleepLock);
+    m_sleepCondition.broadcast();
+}
+
+int WorkStealingExecutor::execute_now(ACE_Method_Request* new_req)
+{
+    if (new_req == NULL)
+    {
+        return -1;
+    }
+
+    if (!activated())
+    {
+        delete new_req;
+        ACE_ERROR_RETURN((LM_ERROR, ACE_TEXT("(%t) %p\n"), ACE_TEXT("WorkStealingExecutor::execute_now not activated")), -1);
+    }
+
+    ++m_queued;
+
+    {
+        WorkerQueue& queue = *m_queues[size_t(++m_nextTarget) % m_queues.size()];
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, queue.lock, -1);
+        // cheap side work goes to the back where idle workers steal first
+        queue.requests.push_back(new_req);
+    }
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_sleepLock, -1);
+    m_sleepCondition.signal();
+    return 0;
+}
+
+bool WorkStealingExecutor::activated()
+{
+    return activated_;
+}
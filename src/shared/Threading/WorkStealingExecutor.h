@@ -0,0 +1,121 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef _M_WORK_STEALING_EXECUTOR_H
+#define _M_WORK_STEALING_EXECUTOR_H
+
+#include <ace/Task.h>
+#include <ace/Method_Request.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+
+#include "Platform/Define.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * Thread pool with one request deque per worker thread.
+ *
+ * Requests are collected with execute() and released with dispatch(). At
+ * dispatch time the batch is ordered by the estimated cost given for each
+ * request and spread over the workers so that every worker gets about the
+ * same amount of work, the most expensive requests first. A worker that runs
+ * out of work steals the cheapest pending request from the back of another
+ * worker's deque, so no single queue lock is shared by all threads.
+ *
+ * A request can be bound to a worker, it is then always queued there so that
+ * its data stays in that worker's caches, and only taken by another worker
+ * when it steals.
+ */
+class WorkStealingExecutor : protected ACE_Task_Base
+{
+    public:
+
+        WorkStealingExecutor();
+        virtual ~WorkStealingExecutor();
+
+        // queue a request for the next dispatch(), cost is an arbitrary estimate (e.g. last run time),
+        // worker the index of the worker to queue it at (modulo the thread count), -1 for the least loaded one
+        int execute(ACE_Method_Request* new_req, uint32 cost, int worker = -1);
+
+        // hand all requests queued since the previous call to the workers
+        void dispatch();
+
+        // hand a single request to the workers right away, bypassing the batch
+        int execute_now(ACE_Method_Request* new_req);
+
+        int _activate(int num_threads = 1);
+
+        int deactivate();
+
+        bool activated();
+
+        // CPUs the threads started by the next _activate() run on, see ACE_Based::Thread::SetCurrentThreadAffinity()
+        void set_affinity(std::string const& cpus) { m_affinity = cpus; }
+
+        virtual int svc();
+
+    private:
+
+        struct PendingRequest
+        {
+            PendingRequest(ACE_Method_Request* r, uint32 c, int w) : request(r), cost(c), worker(w) {}
+
+            bool operator<(PendingRequest const& other) const { return cost > other.cost; }
+
+            ACE_Method_Request* request;
+            uint32 cost;
+            int worker;
+        };
+
+        struct WorkerQueue
+        {
+            ACE_Thread_Mutex lock;
+            std::deque<ACE_Method_Request*> requests;
+        };
+
+        bool pop(size_t worker, ACE_Method_Request*& rq);
+        bool steal(size_t thief, ACE_Method_Request*& rq);
+
+        ACE_Thread_Mutex m_batchLock;
+        std::vector<PendingRequest> m_batch;
+
+        std::vector<WorkerQueue*> m_queues;
+
+        ACE_Thread_Mutex m_sleepLock;
+        ACE_Condition_Thread_Mutex m_sleepCondition;
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_queued;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nextWorker;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nextTarget;
+
+        bool m_stop;
+        bool activated_;
+        std::string m_affinity;
+};
+
+#endif // _M_WORK_STEALING_EXECUTOR_H
@@ -28,6 +28,7 @@
 #include "Common/Common.h"
 #include "Utilities/ByteConverter.h"
 #include "Utilities/Errors.h"
+#include "Utilities/PacketBufferPool.h"
 
 /**
  * @brief
@@ -76,6 +77,42 @@ struct Unused
     Unused() {}
 };
 
+/**
+ * @brief Non-owning window over bytes of a ByteBuffer.
+ *
+ * Returned by the ByteBuffer::Read*View() helpers so that packet handlers can
+ * inspect strings and blobs in place and only copy what they keep. A view is
+ * invalidated by any write to the buffer it was taken from.
+ */
+class ByteBufferView
+{
+    public:
+        ByteBufferView() : m_data(NULL), m_size(0) {}
+        ByteBufferView(char const* data, size_t size) : m_data(data), m_size(size) {}
+
+        char const* data() const { return m_data; }
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        /**
+         * @brief copies the viewed bytes out
+         *
+         * @return std::string
+         */
+        std::string str() const { return std::string(m_data, m_size); }
+
+        /**
+         * @brief copies the viewed bytes into an existing string, reusing its capacity
+         *
+         * @param value
+         */
+        void assignTo(std::string& value) const { value.assign(m_data, m_size); }
+
+    private:
+        char const* m_data; /**< first viewed byte, owned by the buffer */
+        size_t m_size; /**< number of viewed bytes */
+};
+
 /**
  * @brief
  *
@@ -419,16 +456,7 @@ class ByteBuffer
          */
         ByteBuffer& operator>>(std::string& value)
         {
-            value.clear();
-            while (rpos() < size())                         // prevent crash at wrong string format in packet
-            {
-                char c = read<char>();
-                if (c == 0)
-                {
-                    break;
-                }
-                value += c;
-            }
+            ReadCStringView().assignTo(value);
             return *this;
         }
 
@@ -573,6 +601,47 @@ class ByteBuffer
             _rpos += len;
         }
 
+        /**
+         * @brief reads a zero terminated string without copying it
+         *
+         * The terminator is consumed but not part of the view. A string running
+         * to the end of the buffer without terminator is accepted as is, like
+         * operator>>(std::string&) always did for malformed packets.
+         *
+         * @return ByteBufferView
+         */
+        ByteBufferView ReadCStringView()
+        {
+            if (_rpos >= size())
+            {
+                return ByteBufferView();
+            }
+
+            char const* start = reinterpret_cast<char const*>(&_storage[_rpos]);
+            size_t left = size() - _rpos;
+            char const* end = static_cast<char const*>(memchr(start, 0, left));
+            size_t len = end ? size_t(end - start) : left;
+            _rpos += end ? len + 1 : len;
+            return ByteBufferView(start, len);
+        }
+
+        /**
+         * @brief reads len raw bytes without copying them
+         *
+         * @param len
+         * @return ByteBufferView
+         */
+        ByteBufferView ReadBytesView(size_t len)
+        {
+            if (_rpos + len > size())
+            {
+                throw ByteBufferException(false, _rpos, len, size());
+            }
+            ByteBufferView view(len ? reinterpret_cast<char const*>(&_storage[_rpos]) : NULL, len);
+            _rpos += len;
+            return view;
+        }
+
         /**
          * @brief
          *
@@ -797,7 +866,7 @@ class ByteBuffer
 
     protected:
         size_t _rpos, _wpos; /**< TODO */
-        std::vector<uint8> _storage; /**< TODO */
+        std::vector<uint8, PacketBufferAllocator<uint8> > _storage; /**< small buffers come from PacketBufferPool */
 };
 
 template <typename T>
@@ -930,8 +999,7 @@ template<>
  */
 inline void ByteBuffer::read_skip<char*>()
 {
-    std::string temp;
-    *this >> temp;
+    ReadCStringView();
 }
 
 template<>
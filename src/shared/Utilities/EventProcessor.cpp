@@ -24,9 +24,49 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+#include <cstring>
+
+// m_due is kept in reverse execution order, so the next event can be popped from the back
+static bool ExecutesAfter(BasicEvent const* left, BasicEvent const* right)
+{
+    if (left->m_execTime != right->m_execTime)
+    {
+        return left->m_execTime > right->m_execTime;
+    }
+
+    return left->m_sequence > right->m_sequence;
+}
+
+static inline uint32 LowestSetBit(uint64 bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    uint32 index = 0;
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+EventProcessor::TimingWheel::TimingWheel()
+{
+    memset(slots, 0, sizeof(slots));
+    memset(occupied, 0, sizeof(occupied));
+}
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_wheelTime = 0;
+    m_sequence = 0;
+    m_wheel = NULL;
+    m_overflow = NULL;
+    m_count = 0;
     m_aborting = false;
 }
 
@@ -34,6 +74,7 @@ EventProcessor::~EventProcessor()
 {
     // 退出时强制清理所有Event
     KillAllEvents(true);
+    delete m_wheel;
 }
 
 void EventProcessor::Update(uint32 p_time)
@@ -41,30 +82,33 @@ void EventProcessor::Update(uint32 p_time)
     // 更新时间
     m_time += p_time;
 
-    // 循环队列，取出其中到期的Event
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    // 按触发时间与加入顺序取出到期的Event，执行中加入的到期Event也在本次执行
+    do
     {
-        // 获取Event并从队列中删除
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
-        // 如果Event不需要终止
-        if (!Event->to_Abort)
+        while (!m_due.empty())
         {
-            // 回调Execute函数后，删除Event
-            if (Event->Execute(m_time, p_time))
+            // 获取Event并从队列中删除
+            BasicEvent* Event = m_due.back();
+            m_due.pop_back();
+            // 如果Event不需要终止
+            if (!Event->to_Abort)
+            {
+                // 回调Execute函数后，删除Event
+                if (Event->Execute(m_time, p_time))
+                {
+                    // 如果回调Event的Execute函数返回true，删除该Event
+                    delete Event;
+                }
+            }
+            else
             {
-                // 如果回调Event的Execute函数返回true，删除该Event
+                // 回调Abort函数后删除Event
+                Event->Abort(m_time);
                 delete Event;
             }
         }
-        else
-        {
-            // 回调Abort函数后删除Event
-            Event->Abort(m_time);
-            delete Event;
-        }
     }
+    while (Advance(m_time));
 }
 
 void EventProcessor::KillAllEvents(bool force)
@@ -72,31 +116,77 @@ void EventProcessor::KillAllEvents(bool force)
     // 阻止插入Event
     m_aborting = true;
 
-    // 终止队列中的Event
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    // 终止已到期的Event，Abort中加入的Event不受影响
+    std::vector<BasicEvent*> due;
+    due.swap(m_due);
+
+    std::vector<BasicEvent*>::iterator kept = due.begin();
+    for (std::vector<BasicEvent*>::iterator i = due.begin(); i != due.end(); ++i)
     {
-        EventList::iterator i_old = i;
-        ++i;
         // 首先终止Event，并回调to_Abort函数
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
+        (*i)->to_Abort = true;
+        (*i)->Abort(m_time);
         // 如果使用了强制结束或者Event可以被删除
-        if (force || i_old->second->IsDeletable())
+        if (force || (*i)->IsDeletable())
+        {
+            delete *i;
+        }
+        else
         {
-            delete i_old->second;
+            *kept++ = *i;
+        }
+    }
+
+    if (kept != due.begin())
+    {
+        m_due.insert(m_due.end(), due.begin(), kept);
+        std::sort(m_due.begin(), m_due.end(), ExecutesAfter);
+    }
 
-            if (!force)                                     // need per-element cleanup
+    // 终止时间轮中的Event
+    if (m_wheel)
+    {
+        for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+        {
+            for (uint64 bits = m_wheel->occupied[level]; bits; bits &= bits - 1)
             {
-                m_events.erase(i_old);
+                uint32 slot = LowestSetBit(bits);
+                m_count -= KillList(m_wheel->slots[level][slot], force);
+
+                if (!m_wheel->slots[level][slot])
+                {
+                    m_wheel->occupied[level] &= ~(uint64(1) << slot);
+                }
             }
         }
     }
 
-    // fast clear event list (in force case)
-    if (force)
+    m_count -= KillList(m_overflow, force);
+}
+
+uint32 EventProcessor::KillList(BasicEvent*& head, bool force)
+{
+    uint32 killed = 0;
+
+    BasicEvent** link = &head;
+    while (BasicEvent* Event = *link)
     {
-        m_events.clear();
+        Event->to_Abort = true;
+        Event->Abort(m_time);
+
+        if (force || Event->IsDeletable())
+        {
+            *link = Event->m_nextEvent;
+            delete Event;
+            ++killed;
+        }
+        else
+        {
+            link = &Event->m_nextEvent;
+        }
     }
+
+    return killed;
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -107,7 +197,136 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
     }
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    Event->m_sequence = m_sequence++;
+    Schedule(Event);
+}
+
+void EventProcessor::Schedule(BasicEvent* Event)
+{
+    uint64 e_time = Event->m_execTime;
+
+    // 已到期的Event按触发时间与加入顺序插入m_due
+    if (e_time <= m_wheelTime)
+    {
+        m_due.insert(std::lower_bound(m_due.begin(), m_due.end(), Event, ExecutesAfter), Event);
+        return;
+    }
+
+    if (!m_wheel)
+    {
+        m_wheel = new TimingWheel();
+    }
+
+    ++m_count;
+
+    // 放入与当前时间同属一个上层区间的最低层
+    for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+    {
+        uint32 shift = level * EVENT_WHEEL_SLOT_BITS;
+        if ((e_time >> (shift + EVENT_WHEEL_SLOT_BITS)) == (m_wheelTime >> (shift + EVENT_WHEEL_SLOT_BITS)))
+        {
+            uint32 slot = uint32(e_time >> shift) & (EVENT_WHEEL_SLOTS - 1);
+            Event->m_nextEvent = m_wheel->slots[level][slot];
+            m_wheel->slots[level][slot] = Event;
+            m_wheel->occupied[level] |= uint64(1) << slot;
+            return;
+        }
+    }
+
+    Event->m_nextEvent = m_overflow;
+    m_overflow = Event;
+}
+
+bool EventProcessor::Advance(uint64 until)
+{
+    while (m_count && m_wheelTime < until)
+    {
+        uint64 blockEnd = m_wheelTime | (EVENT_WHEEL_SLOTS - 1);
+        uint64 limit = std::min(until, blockEnd);
+
+        // 当前区间内，已处理时间之后、limit之前有Event的槽位
+        uint64 pending = m_wheel->occupied[0];
+        pending &= (~uint64(0) << (m_wheelTime & (EVENT_WHEEL_SLOTS - 1))) << 1;
+        pending &= ~uint64(0) >> (EVENT_WHEEL_SLOTS - 1 - (limit & (EVENT_WHEEL_SLOTS - 1)));
+
+        if (pending)
+        {
+            uint32 slot = LowestSetBit(pending);
+            m_wheelTime = (m_wheelTime & ~uint64(EVENT_WHEEL_SLOTS - 1)) | slot;
+
+            // 第0层槽位中的Event触发时间都相同，按加入顺序执行
+            for (BasicEvent* Event = m_wheel->slots[0][slot]; Event; Event = Event->m_nextEvent)
+            {
+                m_due.push_back(Event);
+                --m_count;
+            }
+
+            m_wheel->slots[0][slot] = NULL;
+            m_wheel->occupied[0] &= ~(uint64(1) << slot);
+            std::sort(m_due.begin(), m_due.end(), ExecutesAfter);
+            return true;
+        }
+
+        if (limit == until)
+        {
+            break;
+        }
+
+        m_wheelTime = blockEnd + 1;
+        Cascade();
+
+        if (!m_due.empty())
+        {
+            return true;
+        }
+    }
+
+    m_wheelTime = std::max(m_wheelTime, until);
+    return false;
+}
+
+void EventProcessor::Cascade()
+{
+    BasicEvent* moved = NULL;
+
+    // 每个时间点只有其所在的上层槽位需要重新分配
+    uint32 level = 1;
+    for (; level < EVENT_WHEEL_LEVELS; ++level)
+    {
+        uint32 shift = level * EVENT_WHEEL_SLOT_BITS;
+        if (m_wheelTime & ((uint64(1) << shift) - 1))
+        {
+            break;
+        }
+
+        uint32 slot = uint32(m_wheelTime >> shift) & (EVENT_WHEEL_SLOTS - 1);
+        while (BasicEvent* Event = m_wheel->slots[level][slot])
+        {
+            m_wheel->slots[level][slot] = Event->m_nextEvent;
+            Event->m_nextEvent = moved;
+            moved = Event;
+        }
+
+        m_wheel->occupied[level] &= ~(uint64(1) << slot);
+    }
+
+    if (level == EVENT_WHEEL_LEVELS && !(m_wheelTime & ((uint64(1) << (EVENT_WHEEL_LEVELS * EVENT_WHEEL_SLOT_BITS)) - 1)))
+    {
+        // 进入新的时间轮周期，超出范围的Event重新分配
+        while (BasicEvent* Event = m_overflow)
+        {
+            m_overflow = Event->m_nextEvent;
+            Event->m_nextEvent = moved;
+            moved = Event;
+        }
+    }
+
+    while (BasicEvent* Event = moved)
+    {
+        moved = Event->m_nextEvent;
+        --m_count;
+        Schedule(Event);
+    }
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset)
@@ -27,7 +27,7 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <vector>
 
 /**
  * @brief 所有时间单位为毫秒
@@ -42,7 +42,7 @@ class BasicEvent
          *
          */
         BasicEvent()
-            : to_Abort(false)
+            : to_Abort(false), m_nextEvent(NULL), m_sequence(0)
         {
         }
 
@@ -91,17 +91,25 @@ class BasicEvent
          * @brief Event触发时间
         */
         uint64 m_execTime;
+        /**
+         * @brief 时间轮同一槽位中的下一个Event
+        */
+        BasicEvent* m_nextEvent;
+        /**
+         * @brief 加入顺序，触发时间相同的Event按加入顺序执行
+        */
+        uint64 m_sequence;
 };
 
-/**
- * @brief
- *
- */
-typedef std::multimap<uint64, BasicEvent*> EventList;
+#define EVENT_WHEEL_LEVELS      6                           // levels of the timing wheel, together they cover 2^36 ms
+#define EVENT_WHEEL_SLOT_BITS   6
+#define EVENT_WHEEL_SLOTS       (1 << EVENT_WHEEL_SLOT_BITS)
 
 /**
- * @brief
+ * @brief 分层时间轮，Event按触发时间放入槽位
  *
+ * 第0层每个槽位为1毫秒，每高一层槽位扩大64倍。时间前进到高层槽位时，
+ * 其中的Event重新分配到低层。已到期的Event按触发时间与加入顺序排列在m_due中。
  */
 class EventProcessor
 {
@@ -141,17 +149,71 @@ class EventProcessor
          * @return 当前时间+增加的时间
         */
         uint64 CalculateTime(uint64 t_offset);
+        /**
+         * @brief 是否没有待处理的Event
+        */
+        bool Empty() const { return m_due.empty() && !m_count; }
 
     protected:
 
+        /**
+         * @brief 时间轮的槽位，只在第一个未到期的Event加入时分配
+        */
+        struct TimingWheel
+        {
+            TimingWheel();
+
+            BasicEvent* slots[EVENT_WHEEL_LEVELS][EVENT_WHEEL_SLOTS];
+            uint64 occupied[EVENT_WHEEL_LEVELS];            // bit i is set while slots[level][i] is not empty
+        };
+
+        /**
+         * @brief 把Event放入时间轮，已到期的放入m_due
+        */
+        void Schedule(BasicEvent* Event);
+        /**
+         * @brief 把时间轮推进到下一个有Event的槽位，最多到until
+         * @return m_due中是否有到期的Event
+        */
+        bool Advance(uint64 until);
+        /**
+         * @brief 时间进入新的第0层区间时，重新分配高层槽位中的Event
+        */
+        void Cascade();
+        /**
+         * @brief 终止链表中的Event
+         * @return 删除的Event数量
+        */
+        uint32 KillList(BasicEvent*& head, bool force);
+
         /**
          * @brief 当前时间
         */
         uint64 m_time;
         /**
-         * @brief Event处理队列
+         * @brief 时间轮已处理到的时间
+        */
+        uint64 m_wheelTime;
+        /**
+         * @brief 下一个Event的加入顺序
+        */
+        uint64 m_sequence;
+        /**
+         * @brief 时间轮
+        */
+        TimingWheel* m_wheel;
+        /**
+         * @brief 超出时间轮范围的Event
+        */
+        BasicEvent* m_overflow;
+        /**
+         * @brief 时间轮与m_overflow中的Event数量
+        */
+        uint32 m_count;
+        /**
+         * @brief 已到期的Event，最先执行的在末尾
         */
-        EventList m_events;
+        std::vector<BasicEvent*> m_due;
         /**
          * @brief 是否阻止Event插入
         */
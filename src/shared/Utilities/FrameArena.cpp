@@ -0,0 +1,128 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "FrameArena.h"
+
+#include <ace/TSS_T.h>
+
+#include <cstdlib>
+
+// every block keeps this alignment, enough for anything stored in the game containers
+static const size_t FRAME_ARENA_ALIGN = 16;
+
+FrameArena::FrameArena() : m_chunk(0), m_offset(0), m_depth(0)
+{
+}
+
+FrameArena::~FrameArena()
+{
+    for (std::vector<char*>::iterator itr = m_chunks.begin(); itr != m_chunks.end(); ++itr)
+    {
+        free(*itr);
+    }
+}
+
+FrameArena& FrameArena::GetThreadArena()
+{
+    // leaked on purpose, the per thread arenas are destroyed by ACE when their thread exits
+    static ACE_TSS<FrameArena>* arenas = new ACE_TSS<FrameArena>();
+    return **arenas;
+}
+
+void* FrameArena::Allocate(size_t size)
+{
+    size = (size + FRAME_ARENA_ALIGN - 1) & ~(FRAME_ARENA_ALIGN - 1);
+
+    if (!m_depth || size > MAX_BLOCK_SIZE)
+    {
+        return ::operator new(size);
+    }
+
+    if (m_chunks.empty() || m_offset + size > CHUNK_SIZE)
+    {
+        if (!m_chunks.empty())
+        {
+            ++m_chunk;
+        }
+
+        if (m_chunk == m_chunks.size())
+        {
+            char* chunk = static_cast<char*>(malloc(CHUNK_SIZE));
+            if (!chunk)
+            {
+                throw std::bad_alloc();
+            }
+
+            m_chunks.push_back(chunk);
+        }
+
+        m_offset = 0;
+    }
+
+    void* ptr = m_chunks[m_chunk] + m_offset;
+    m_offset += size;
+    return ptr;
+}
+
+void FrameArena::Release(void* ptr)
+{
+    // arena blocks are reclaimed all at once at the end of the frame
+    if (ptr && !Owns(ptr))
+    {
+        ::operator delete(ptr);
+    }
+}
+
+void FrameArena::EndFrame()
+{
+    if (--m_depth)
+    {
+        return;
+    }
+
+    // a busy update may have needed many chunks, do not keep all of them forever
+    while (m_chunks.size() > MAX_KEPT_CHUNKS)
+    {
+        free(m_chunks.back());
+        m_chunks.pop_back();
+    }
+
+    m_chunk = 0;
+    m_offset = 0;
+}
+
+bool FrameArena::Owns(void const* ptr) const
+{
+    char const* p = static_cast<char const*>(ptr);
+    for (std::vector<char*>::const_iterator itr = m_chunks.begin(); itr != m_chunks.end(); ++itr)
+    {
+        if (p >= *itr && p < *itr + CHUNK_SIZE)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
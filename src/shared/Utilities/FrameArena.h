@@ -0,0 +1,132 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOSSERVER_FRAMEARENA_H
+#define MANGOSSERVER_FRAMEARENA_H
+
+#include "Platform/Define.h"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Per thread bump allocator for containers that only live during one update
+ *
+ * Memory handed out while a Frame is open on the calling thread is taken from
+ * a few large chunks and never freed one by one; closing the outermost Frame
+ * rewinds the arena so the next update reuses the same chunks. Outside of a
+ * Frame, and for big requests, the allocations go to the heap as usual, so a
+ * FrameAllocator container is always safe to use. It must not outlive the
+ * Frame it was filled in though, i.e. only use it for locals of the update.
+ */
+class FrameArena
+{
+    public:
+        static const size_t CHUNK_SIZE = 64 * 1024;     /**< size of one arena chunk */
+        static const size_t MAX_BLOCK_SIZE = 4 * 1024;  /**< bigger requests always use the heap */
+        static const uint32 MAX_KEPT_CHUNKS = 16;       /**< chunks beyond this are freed at the end of a frame */
+
+        /**
+         * @brief opens a frame on the arena of the calling thread for its scope, frames may nest
+         */
+        class Frame
+        {
+            public:
+                Frame() : m_arena(FrameArena::GetThreadArena()) { m_arena.BeginFrame(); }
+                ~Frame() { m_arena.EndFrame(); }
+
+            private:
+                Frame(Frame const&);
+                Frame& operator=(Frame const&);
+
+                FrameArena& m_arena;
+        };
+
+        FrameArena();
+        ~FrameArena();
+
+        static FrameArena& GetThreadArena();
+
+        void* Allocate(size_t size);
+        void Release(void* ptr);
+
+        bool InFrame() const { return m_depth > 0; }
+
+    private:
+        FrameArena(FrameArena const&);
+        FrameArena& operator=(FrameArena const&);
+
+        void BeginFrame() { ++m_depth; }
+        void EndFrame();
+        bool Owns(void const* ptr) const;
+
+        std::vector<char*> m_chunks;
+        size_t m_chunk;                                 // chunk allocations are taken from
+        size_t m_offset;                                // first free byte in that chunk
+        uint32 m_depth;
+};
+
+/**
+ * @brief STL allocator taking its memory from the FrameArena of the thread that created it
+ */
+template<class T>
+class FrameAllocator
+{
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef T const* const_pointer;
+        typedef T& reference;
+        typedef T const& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template<class U> struct rebind { typedef FrameAllocator<U> other; };
+
+        FrameAllocator() : m_arena(&FrameArena::GetThreadArena()) {}
+        template<class U> FrameAllocator(FrameAllocator<U> const& other) : m_arena(other.GetArena()) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(m_arena->Allocate(n * sizeof(T))); }
+        void deallocate(T* ptr, size_t /*n*/) { m_arena->Release(ptr); }
+
+        template<class U, class... Args> void construct(U* ptr, Args&&... args) { ::new((void*)ptr) U(std::forward<Args>(args)...); }
+        template<class U> void destroy(U* ptr) { ptr->~U(); }
+
+        size_t max_size() const { return size_t(-1) / sizeof(T); }
+
+        FrameArena* GetArena() const { return m_arena; }
+
+    private:
+        FrameArena* m_arena;
+};
+
+template<class T, class U>
+inline bool operator==(FrameAllocator<T> const& a, FrameAllocator<U> const& b) { return a.GetArena() == b.GetArena(); }
+template<class T, class U>
+inline bool operator!=(FrameAllocator<T> const& a, FrameAllocator<U> const& b) { return a.GetArena() != b.GetArena(); }
+
+#endif
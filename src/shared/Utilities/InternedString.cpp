@@ -0,0 +1,78 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "InternedString.h"
+#include "Utilities/UnorderedMapSet.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Thread_Mutex.h>
+
+namespace
+{
+    typedef UNORDERED_SET<std::string> StringPool;
+
+    // function statics, values can be interned while other statics are constructed
+    StringPool& GetPool()
+    {
+        static StringPool pool;
+        return pool;
+    }
+
+    ACE_Thread_Mutex& GetPoolLock()
+    {
+        static ACE_Thread_Mutex lock;
+        return lock;
+    }
+
+    size_t s_bytes = 0;
+}
+
+std::string const InternedString::s_empty;
+
+std::string const& InternedString::Intern(std::string const& value)
+{
+    if (value.empty())
+    {
+        return s_empty;
+    }
+
+    // loaders run in parallel at startup
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, GetPoolLock(), s_empty);
+
+    // set elements keep their address when the set grows
+    std::pair<StringPool::iterator, bool> result = GetPool().insert(value);
+    if (result.second)
+    {
+        s_bytes += value.size();
+    }
+
+    return *result.first;
+}
+
+void InternedString::GetStats(size_t& strings, size_t& bytes)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, GetPoolLock());
+    strings = GetPool().size();
+    bytes = s_bytes;
+}
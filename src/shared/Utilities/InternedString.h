@@ -0,0 +1,71 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOSSERVER_INTERNEDSTRING_H
+#define MANGOSSERVER_INTERNEDSTRING_H
+
+#include "Platform/Define.h"
+
+#include <string>
+
+/**
+ * @brief Immutable text shared by all equal values, for strings loaded from the DB
+ *
+ * Every distinct value is stored once in a process wide pool that never
+ * shrinks, so a handle stays valid for the lifetime of the process and is the
+ * size of a pointer. Assigning a std::string interns it; reading converts to
+ * std::string const& so the handle can be used where a std::string was.
+ */
+class InternedString
+{
+    public:
+        InternedString() : m_str(&s_empty) {}
+        InternedString(std::string const& value) : m_str(&Intern(value)) {}
+
+        InternedString& operator=(std::string const& value) { m_str = &Intern(value); return *this; }
+
+        operator std::string const& () const { return *m_str; }
+        std::string const& str() const { return *m_str; }
+        char const* c_str() const { return m_str->c_str(); }
+        bool empty() const { return m_str->empty(); }
+        size_t size() const { return m_str->size(); }
+        size_t length() const { return m_str->length(); }
+
+        bool operator==(InternedString const& other) const { return m_str == other.m_str; }
+        bool operator!=(InternedString const& other) const { return m_str != other.m_str; }
+
+        /**
+         * @brief distinct values and their bytes in the pool
+         */
+        static void GetStats(size_t& strings, size_t& bytes);
+
+    private:
+        static std::string const& Intern(std::string const& value);
+
+        static std::string const s_empty;
+
+        std::string const* m_str;
+};
+
+#endif
@@ -0,0 +1,219 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "Metrics.h"
+#include "Log/Log.h"
+
+#include <ace/Guard_T.h>
+
+#include <algorithm>
+#include <cstdio>
+
+INSTANTIATE_SINGLETON_1(Metrics);
+
+MetricHistogram::MetricHistogram(std::vector<double> const& bounds)
+    : m_bounds(bounds), m_buckets(new std::atomic<uint64>[bounds.size() + 1]), m_count(0), m_sum(0.0)
+{
+    std::sort(m_bounds.begin(), m_bounds.end());
+
+    for (size_t i = 0; i <= m_bounds.size(); ++i)
+    {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+MetricHistogram::~MetricHistogram()
+{
+    delete[] m_buckets;
+}
+
+void MetricHistogram::Observe(double value)
+{
+    size_t bucket = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin();
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+
+    double sum = m_sum.load(std::memory_order_relaxed);
+    while (!m_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed))
+    {
+    }
+}
+
+std::vector<double> const& Metrics::GetTickBuckets()
+{
+    static double const bounds[] = { 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 10.0 };
+    static std::vector<double> const buckets(bounds, bounds + countof(bounds));
+    return buckets;
+}
+
+Metrics::Series& Metrics::GetSeries(char const* name, char const* help, MetricType type, std::string const& labels)
+{
+    std::pair<std::map<std::string, Family>::iterator, bool> inserted = m_families.insert(std::make_pair(std::string(name), Family()));
+    Family& family = inserted.first->second;
+
+    if (inserted.second)
+    {
+        family.type = type;
+        family.help = help;
+    }
+    else if (family.type != type)
+    {
+        // still handed out so the caller keeps working, but never exported
+        sLog.outError("Metrics: %s registered again with a different type", name);
+    }
+
+    return family.series[labels];
+}
+
+MetricCounter& Metrics::GetCounter(char const* name, char const* help, std::string const& labels)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    Series& series = GetSeries(name, help, METRIC_COUNTER, labels);
+    if (!series.counter)
+    {
+        series.counter = new MetricCounter();
+    }
+
+    return *series.counter;
+}
+
+MetricGauge& Metrics::GetGauge(char const* name, char const* help, std::string const& labels)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    Series& series = GetSeries(name, help, METRIC_GAUGE, labels);
+    if (!series.gauge)
+    {
+        series.gauge = new MetricGauge();
+    }
+
+    return *series.gauge;
+}
+
+MetricHistogram& Metrics::GetHistogram(char const* name, char const* help, std::vector<double> const& bounds, std::string const& labels)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    Series& series = GetSeries(name, help, METRIC_HISTOGRAM, labels);
+    if (!series.histogram)
+    {
+        series.histogram = new MetricHistogram(bounds);
+    }
+
+    return *series.histogram;
+}
+
+static void AppendSample(std::string& out, std::string const& name, char const* suffix, std::string const& labels, char const* extraLabel, char const* value)
+{
+    out += name;
+    out += suffix;
+
+    if (!labels.empty() || extraLabel)
+    {
+        out += '{';
+        out += labels;
+        if (extraLabel)
+        {
+            if (!labels.empty())
+            {
+                out += ',';
+            }
+            out += extraLabel;
+        }
+        out += '}';
+    }
+
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+void Metrics::Render(std::string& out)
+{
+    static char const* const typeNames[] = { "counter", "gauge", "histogram" };
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    char value[64];
+    char bound[64];
+
+    for (std::map<std::string, Family>::const_iterator itr = m_families.begin(); itr != m_families.end(); ++itr)
+    {
+        std::string const& name = itr->first;
+        Family const& family = itr->second;
+
+        out += "# HELP " + name + " " + family.help + "\n";
+        out += "# TYPE " + name + " " + typeNames[family.type] + "\n";
+
+        for (std::map<std::string, Series>::const_iterator series = family.series.begin(); series != family.series.end(); ++series)
+        {
+            std::string const& labels = series->first;
+
+            switch (family.type)
+            {
+                case METRIC_COUNTER:
+                    if (series->second.counter)
+                    {
+                        snprintf(value, sizeof(value), UI64FMTD, series->second.counter->GetValue());
+                        AppendSample(out, name, "", labels, NULL, value);
+                    }
+                    break;
+                case METRIC_GAUGE:
+                    if (series->second.gauge)
+                    {
+                        snprintf(value, sizeof(value), SI64FMTD, series->second.gauge->GetValue());
+                        AppendSample(out, name, "", labels, NULL, value);
+                    }
+                    break;
+                case METRIC_HISTOGRAM:
+                    if (MetricHistogram const* histogram = series->second.histogram)
+                    {
+                        // the exported buckets are cumulative
+                        uint64 cumulative = 0;
+                        std::vector<double> const& bounds = histogram->GetBounds();
+                        for (size_t i = 0; i < bounds.size(); ++i)
+                        {
+                            cumulative += histogram->GetBucket(i);
+                            snprintf(bound, sizeof(bound), "le=\"%.9g\"", bounds[i]);
+                            snprintf(value, sizeof(value), UI64FMTD, cumulative);
+                            AppendSample(out, name, "_bucket", labels, bound, value);
+                        }
+
+                        cumulative += histogram->GetBucket(bounds.size());
+                        snprintf(value, sizeof(value), UI64FMTD, cumulative);
+                        AppendSample(out, name, "_bucket", labels, "le=\"+Inf\"", value);
+
+                        snprintf(value, sizeof(value), "%.9g", histogram->GetSum());
+                        AppendSample(out, name, "_sum", labels, NULL, value);
+
+                        snprintf(value, sizeof(value), UI64FMTD, cumulative);
+                        AppendSample(out, name, "_count", labels, NULL, value);
+                    }
+                    break;
+            }
+        }
+    }
+}
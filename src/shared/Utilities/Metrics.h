@@ -0,0 +1,156 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOSSERVER_METRICS_H
+#define MANGOSSERVER_METRICS_H
+
+#include "Common/Common.h"
+#include "Policies/Singleton.h"
+
+#include <ace/Thread_Mutex.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Monotonic count, e.g. of calls or of handled packets
+ */
+class MetricCounter
+{
+    public:
+        MetricCounter() : m_value(0) {}
+
+        void Inc(uint64 count = 1) { m_value.fetch_add(count, std::memory_order_relaxed); }
+        uint64 GetValue() const { return m_value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint64> m_value;
+};
+
+/**
+ * @brief Value that goes up and down, e.g. a queue depth, usually set by its owner once per tick
+ */
+class MetricGauge
+{
+    public:
+        MetricGauge() : m_value(0) {}
+
+        void Set(int64 value) { m_value.store(value, std::memory_order_relaxed); }
+        void Add(int64 value) { m_value.fetch_add(value, std::memory_order_relaxed); }
+        int64 GetValue() const { return m_value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<int64> m_value;
+};
+
+/**
+ * @brief Distribution of observed values over fixed buckets, e.g. tick durations in seconds
+ */
+class MetricHistogram
+{
+    public:
+        explicit MetricHistogram(std::vector<double> const& bounds);
+        ~MetricHistogram();
+
+        void Observe(double value);
+
+        std::vector<double> const& GetBounds() const { return m_bounds; }
+        // not cumulative, the last entry counts the values above every bound
+        uint64 GetBucket(size_t index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+        uint64 GetCount() const { return m_count.load(std::memory_order_relaxed); }
+        double GetSum() const { return m_sum.load(std::memory_order_relaxed); }
+
+    private:
+        MetricHistogram(MetricHistogram const&);
+        MetricHistogram& operator=(MetricHistogram const&);
+
+        std::vector<double> m_bounds;
+        std::atomic<uint64>* m_buckets;
+        std::atomic<uint64> m_count;
+        std::atomic<double> m_sum;
+};
+
+/**
+ * @brief Registry of the runtime metrics, exported in the Prometheus text format
+ *
+ * Metrics are registered by name from any thread and live until the process
+ * ends, so callers look one up once and keep the reference, e.g. in a
+ * function local static or a member. Updating a metric is a relaxed atomic
+ * operation and never takes a lock, only registering and Render() do.
+ *
+ * One name may be registered with several label sets (like map="0"), these
+ * share the help text and type of the first registration.
+ */
+class Metrics
+{
+    public:
+        /**
+         * @brief labels without braces, e.g. "map=\"0\"", empty for none
+         */
+        MetricCounter& GetCounter(char const* name, char const* help, std::string const& labels = "");
+        MetricGauge& GetGauge(char const* name, char const* help, std::string const& labels = "");
+        MetricHistogram& GetHistogram(char const* name, char const* help, std::vector<double> const& bounds, std::string const& labels = "");
+
+        // buckets fitting update durations in seconds, 1 ms to 10 s
+        static std::vector<double> const& GetTickBuckets();
+
+        // all metrics in the Prometheus text exposition format
+        void Render(std::string& out);
+
+    private:
+        enum MetricType
+        {
+            METRIC_COUNTER,
+            METRIC_GAUGE,
+            METRIC_HISTOGRAM
+        };
+
+        struct Series
+        {
+            Series() : counter(NULL), gauge(NULL), histogram(NULL) {}
+
+            MetricCounter* counter;
+            MetricGauge* gauge;
+            MetricHistogram* histogram;
+        };
+
+        struct Family
+        {
+            MetricType type;
+            std::string help;
+            std::map<std::string, Series> series;           // by labels
+        };
+
+        Series& GetSeries(char const* name, char const* help, MetricType type, std::string const& labels);
+
+        ACE_Thread_Mutex m_lock;
+        std::map<std::string, Family> m_families;           // by name, keeps the output sorted
+};
+
+#define sMetrics MaNGOS::Singleton<Metrics>::Instance()
+
+#endif
@@ -0,0 +1,208 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+#include "ObjectPool.h"
+
+#include <ace/Guard_T.h>
+
+#include <new>
+#include <vector>
+
+namespace
+{
+    const uint32 STATS_FLUSH_INTERVAL = 256;        // operations between flushes into the totals
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    ACE_Thread_Mutex& GetRegistryLock()
+    {
+        static ACE_Thread_Mutex* lock = new ACE_Thread_Mutex();
+        return *lock;
+    }
+
+    std::vector<ObjectPool const*>& GetRegistry()
+    {
+        static std::vector<ObjectPool const*>* pools = new std::vector<ObjectPool const*>();
+        return *pools;
+    }
+}
+
+class ObjectPoolCache
+{
+    public:
+        ObjectPoolCache() : m_pool(NULL), m_hits(0), m_misses(0), m_oversized(0), m_pending(0)
+        {
+        }
+
+        ~ObjectPoolCache()
+        {
+            for (size_t i = 0; i < m_free.size(); ++i)
+            {
+                while (FreeBlock* block = m_free[i])
+                {
+                    m_free[i] = block->next;
+                    ::operator delete(block);
+                }
+            }
+
+            FlushStats();
+        }
+
+        void* Allocate(size_t size)
+        {
+            if (size > m_pool->m_maxSize)
+            {
+                ++m_oversized;
+                CountOperation();
+                return ::operator new(size);
+            }
+
+            size_t index = m_pool->SizeClass(size);
+
+            if (FreeBlock* block = m_free[index])
+            {
+                m_free[index] = block->next;
+                --m_count[index];
+                ++m_hits;
+                CountOperation();
+                return block;
+            }
+
+            ++m_misses;
+            CountOperation();
+            return ::operator new((index + 1) * m_pool->m_sizeStep);
+        }
+
+        void Release(void* ptr, size_t size)
+        {
+            if (size > m_pool->m_maxSize)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+
+            size_t index = m_pool->SizeClass(size);
+
+            // a thread that only frees must not hoard blocks
+            if (m_count[index] >= m_pool->m_maxCached)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            block->next = m_free[index];
+            m_free[index] = block;
+            ++m_count[index];
+        }
+
+        void Bind(ObjectPool* pool)
+        {
+            m_pool = pool;
+            m_free.resize(pool->SizeClass(pool->m_maxSize) + 1, NULL);
+            m_count.resize(m_free.size(), 0);
+        }
+
+        ObjectPool* m_pool;                         // set at the first use of the cache
+
+    private:
+        void CountOperation()
+        {
+            if (++m_pending >= STATS_FLUSH_INTERVAL)
+            {
+                FlushStats();
+            }
+        }
+
+        void FlushStats()
+        {
+            if (m_pool)
+            {
+                m_pool->m_hits += m_hits;
+                m_pool->m_misses += m_misses;
+                m_pool->m_oversized += m_oversized;
+            }
+
+            m_hits = m_misses = m_oversized = 0;
+            m_pending = 0;
+        }
+
+        std::vector<FreeBlock*> m_free;
+        std::vector<uint32> m_count;
+
+        uint64 m_hits;
+        uint64 m_misses;
+        uint64 m_oversized;
+        uint32 m_pending;
+};
+
+ObjectPool::ObjectPool(char const* name, size_t maxSize, size_t sizeStep, uint32 maxCached)
+    : m_name(name), m_maxSize(maxSize), m_sizeStep(sizeStep), m_maxCached(maxCached),
+      m_caches(new ACE_TSS<ObjectPoolCache>()), m_hits(0), m_misses(0), m_oversized(0)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, GetRegistryLock());
+    GetRegistry().push_back(this);
+}
+
+ObjectPoolCache* ObjectPool::GetCache()
+{
+    // the per thread caches are destroyed by ACE when their thread exits
+    ObjectPoolCache* cache = *m_caches;
+    if (!cache->m_pool)
+    {
+        cache->Bind(this);
+    }
+
+    return cache;
+}
+
+void* ObjectPool::Allocate(size_t size)
+{
+    return GetCache()->Allocate(size);
+}
+
+void ObjectPool::Release(void* ptr, size_t size)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    GetCache()->Release(ptr, size);
+}
+
+void ObjectPool::GetStats(Stats& stats) const
+{
+    stats.hits = m_hits.value();
+    stats.misses = m_misses.value();
+    stats.oversized = m_oversized.value();
+}
+
+void ObjectPool::GetPools(std::vector<ObjectPool const*>& pools)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, GetRegistryLock());
+    pools = GetRegistry();
+}
@@ -0,0 +1,106 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+#ifndef MANGOSSERVER_OBJECTPOOL_H
+#define MANGOSSERVER_OBJECTPOOL_H
+
+#include "Platform/Define.h"
+
+#include <ace/TSS_T.h>
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+#include <cstddef>
+#include <vector>
+
+class ObjectPoolCache;
+
+/**
+ * @brief Per thread free lists for the instances of one class hierarchy
+ *
+ * Meant for class specific operator new/delete of objects that are created and
+ * destroyed at a high rate. Sizes are rounded up to the size step of the pool
+ * and every rounded size up to the limit given at construction has its own
+ * free list, so derived classes of different size can share a pool. The lists
+ * belong to the calling thread, i.e. to the map update threads for everything
+ * living in a map, and each keeps at most a fixed number of blocks. Freed
+ * objects are reused by the next allocation of the same size class, which
+ * keeps long living processes from fragmenting the heap with them.
+ */
+class ObjectPool
+{
+    public:
+        static const size_t DEFAULT_SIZE_STEP = 16; /**< granularity of the size classes */
+        static const uint32 DEFAULT_MAX_CACHED = 256; /**< blocks kept per size class and thread */
+
+        /**
+         * @brief totals over all threads, flushed by each thread in batches
+         */
+        struct Stats
+        {
+            uint64 hits;        /**< served from a free list */
+            uint64 misses;      /**< pooled size but the free list was empty */
+            uint64 oversized;   /**< above the limit of the pool, always from the heap */
+        };
+
+        /**
+         * @brief pools are never destroyed, objects may still be released after main() returns
+         * @param name shown in the statistics
+         * @param maxSize bigger objects are not pooled
+         * @param sizeStep granularity of the size classes, use a coarser one for big objects
+         * @param maxCached blocks kept per size class and thread, the rest goes back to the heap
+         */
+        ObjectPool(char const* name, size_t maxSize, size_t sizeStep = DEFAULT_SIZE_STEP, uint32 maxCached = DEFAULT_MAX_CACHED);
+
+        void* Allocate(size_t size);
+        void Release(void* ptr, size_t size);
+
+        char const* GetName() const { return m_name; }
+        size_t GetMaxSize() const { return m_maxSize; }
+        void GetStats(Stats& stats) const;
+
+        // all pools created so far, in creation order
+        static void GetPools(std::vector<ObjectPool const*>& pools);
+
+    private:
+        friend class ObjectPoolCache;
+
+        ObjectPool(ObjectPool const&);
+        ObjectPool& operator=(ObjectPool const&);
+
+        ObjectPoolCache* GetCache();
+
+        size_t SizeClass(size_t size) const { return size ? (size - 1) / m_sizeStep : 0; }
+
+        char const* m_name;
+        size_t m_maxSize;
+        size_t m_sizeStep;
+        uint32 m_maxCached;
+        ACE_TSS<ObjectPoolCache>* m_caches;
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, uint64> m_hits;
+        ACE_Atomic_Op<ACE_Thread_Mutex, uint64> m_misses;
+        ACE_Atomic_Op<ACE_Thread_Mutex, uint64> m_oversized;
+};
+
+#endif
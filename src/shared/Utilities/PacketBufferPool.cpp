@@ -0,0 +1,188 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "PacketBufferPool.h"
+
+#include <ace/TSS_T.h>
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+#include <new>
+
+namespace
+{
+    const size_t SIZE_CLASS_COUNT = 8;              // 32 .. 4096
+    const uint32 MAX_CACHED_BLOCKS = 128;           // per class and thread
+    const uint32 STATS_FLUSH_INTERVAL = 256;        // operations between flushes into the totals
+
+    ACE_Atomic_Op<ACE_Thread_Mutex, uint64> s_hits(0);
+    ACE_Atomic_Op<ACE_Thread_Mutex, uint64> s_misses(0);
+    ACE_Atomic_Op<ACE_Thread_Mutex, uint64> s_oversized(0);
+
+    size_t SizeClass(size_t size)
+    {
+        size_t index = 0;
+        for (size_t classSize = PacketBufferPool::MIN_POOLED_SIZE; classSize < size; classSize <<= 1)
+        {
+            ++index;
+        }
+        return index;
+    }
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    class PacketBufferCache
+    {
+        public:
+            PacketBufferCache() : m_hits(0), m_misses(0), m_oversized(0), m_pending(0)
+            {
+                for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+                {
+                    m_free[i] = NULL;
+                    m_count[i] = 0;
+                }
+            }
+
+            ~PacketBufferCache()
+            {
+                for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+                {
+                    while (FreeBlock* block = m_free[i])
+                    {
+                        m_free[i] = block->next;
+                        ::operator delete(block);
+                    }
+                }
+
+                FlushStats();
+            }
+
+            void* Allocate(size_t size)
+            {
+                if (size > PacketBufferPool::MAX_POOLED_SIZE)
+                {
+                    ++m_oversized;
+                    CountOperation();
+                    return ::operator new(size);
+                }
+
+                size_t index = SizeClass(size);
+
+                if (FreeBlock* block = m_free[index])
+                {
+                    m_free[index] = block->next;
+                    --m_count[index];
+                    ++m_hits;
+                    CountOperation();
+                    return block;
+                }
+
+                ++m_misses;
+                CountOperation();
+                return ::operator new(PacketBufferPool::MIN_POOLED_SIZE << index);
+            }
+
+            void Release(void* ptr, size_t size)
+            {
+                if (size > PacketBufferPool::MAX_POOLED_SIZE)
+                {
+                    ::operator delete(ptr);
+                    return;
+                }
+
+                size_t index = SizeClass(size);
+
+                // a thread that only frees (e.g. the socket threads) must not hoard blocks
+                if (m_count[index] >= MAX_CACHED_BLOCKS)
+                {
+                    ::operator delete(ptr);
+                    return;
+                }
+
+                FreeBlock* block = static_cast<FreeBlock*>(ptr);
+                block->next = m_free[index];
+                m_free[index] = block;
+                ++m_count[index];
+            }
+
+        private:
+            void CountOperation()
+            {
+                if (++m_pending >= STATS_FLUSH_INTERVAL)
+                {
+                    FlushStats();
+                }
+            }
+
+            void FlushStats()
+            {
+                s_hits += m_hits;
+                s_misses += m_misses;
+                s_oversized += m_oversized;
+                m_hits = m_misses = m_oversized = 0;
+                m_pending = 0;
+            }
+
+            FreeBlock* m_free[SIZE_CLASS_COUNT];
+            uint32 m_count[SIZE_CLASS_COUNT];
+
+            uint64 m_hits;
+            uint64 m_misses;
+            uint64 m_oversized;
+            uint32 m_pending;
+    };
+
+    PacketBufferCache* GetCache()
+    {
+        // never destroyed, buffers of static objects may still be released after main() returns;
+        // the per thread caches are destroyed by ACE when their thread exits
+        static ACE_TSS<PacketBufferCache>* cache = new ACE_TSS<PacketBufferCache>();
+        return *cache;
+    }
+}
+
+void* PacketBufferPool::Allocate(size_t size)
+{
+    return GetCache()->Allocate(size);
+}
+
+void PacketBufferPool::Release(void* ptr, size_t size)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    GetCache()->Release(ptr, size);
+}
+
+void PacketBufferPool::GetStats(Stats& stats)
+{
+    stats.hits = s_hits.value();
+    stats.misses = s_misses.value();
+    stats.oversized = s_oversized.value();
+}
@@ -0,0 +1,84 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOSSERVER_PACKETBUFFERPOOL_H
+#define MANGOSSERVER_PACKETBUFFERPOOL_H
+
+#include "Platform/Define.h"
+
+#include <cstddef>
+
+/**
+ * @brief Size classed, per thread cache for ByteBuffer storage
+ *
+ * Requests up to MAX_POOLED_SIZE bytes are rounded up to a power of two and
+ * served from a free list owned by the calling thread, larger ones go to the
+ * heap directly. Blocks released by a thread land in that thread's lists, each
+ * list keeps at most a fixed number of blocks and returns the rest to the heap.
+ */
+class PacketBufferPool
+{
+    public:
+        static const size_t MIN_POOLED_SIZE = 32;   /**< smallest size class */
+        static const size_t MAX_POOLED_SIZE = 4096; /**< largest size class, bigger requests are not pooled */
+
+        /**
+         * @brief totals over all threads, flushed by each thread in batches
+         */
+        struct Stats
+        {
+            uint64 hits;        /**< served from a free list */
+            uint64 misses;      /**< pooled size but the free list was empty */
+            uint64 oversized;   /**< above MAX_POOLED_SIZE, always from the heap */
+        };
+
+        static void* Allocate(size_t size);
+        static void Release(void* ptr, size_t size);
+
+        static void GetStats(Stats& stats);
+};
+
+/**
+ * @brief STL allocator routing container storage through PacketBufferPool
+ *
+ * Stateless, the size given to deallocate() selects the same class as the
+ * one given to allocate().
+ */
+template<class T>
+class PacketBufferAllocator
+{
+    public:
+        typedef T value_type;
+
+        PacketBufferAllocator() {}
+        template<class U> PacketBufferAllocator(PacketBufferAllocator<U> const&) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(PacketBufferPool::Allocate(n * sizeof(T))); }
+        void deallocate(T* p, size_t n) { PacketBufferPool::Release(p, n * sizeof(T)); }
+
+        template<class U> bool operator==(PacketBufferAllocator<U> const&) const { return true; }
+        template<class U> bool operator!=(PacketBufferAllocator<U> const&) const { return false; }
+};
+
+#endif
@@ -24,11 +24,17 @@
 
 #include <stdio.h>
 
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
 #include "ProgressBar.h"
 #include "Errors.h"
 
 bool BarGoLink::m_showOutput = true;
 
+// bars are also created by loaders running in parallel at startup
+static ACE_Atomic_Op<ACE_Thread_Mutex, long> s_totalRowCount(0);
+
 char const* const BarGoLink::empty = " ";
 #ifdef _WIN32
 char const* const BarGoLink::full  = "\x3D";
@@ -59,6 +65,8 @@ void BarGoLink::init(int row_count)
     indic_len = 50;
     num_rec   = row_count;
 
+    s_totalRowCount += row_count;
+
     if (!m_showOutput)
     {
         return;
@@ -132,3 +140,13 @@ void BarGoLink::SetOutputState(bool on)
 {
     m_showOutput = on;
 }
+
+bool BarGoLink::GetOutputState()
+{
+    return m_showOutput;
+}
+
+long BarGoLink::GetTotalRowCount()
+{
+    return s_totalRowCount.value();
+}
@@ -59,6 +59,18 @@ class BarGoLink
          * @param on
          */
         static void SetOutputState(bool on);
+        /**
+         * @brief
+         *
+         * @return bool
+         */
+        static bool GetOutputState();
+        /**
+         * @brief rows announced by all bars created so far, used by the startup profile
+         *
+         * @return long
+         */
+        static long GetTotalRowCount();
     private:
         /**
          * @brief
@@ -70,6 +70,12 @@ public:
         return dist(gen_);
     }
 
+    // restarts the sequence, the tick recorder makes the draws of a map update repeatable this way
+    void seed(uint32 value)
+    {
+        gen_.seed(value);
+    }
+
 private:
     std::mt19937 gen_;
 };
@@ -46,6 +46,39 @@ inline uint32 getMSTime()
     return uint32(duration_cast<milliseconds>(steady_clock::now() - GetApplicationStartTime()).count());
 }
 
+/*
+ * Tick time: getMSTime() as sampled by the calling thread at the start of its current
+ * update with RefreshTickMSTime(). Reading it costs no clock call, so code running many
+ * times per update (caches, coalescing windows) should use it; it does not advance during
+ * the update though, so measure durations and take precise timestamps with getMSTime().
+ * Threads that never refreshed their tick time get the precise time.
+ */
+struct TickClock
+{
+    uint32 msTime;
+    bool valid;
+};
+
+inline TickClock& GetThreadTickClock()
+{
+    static thread_local TickClock clock = { 0, false };
+    return clock;
+}
+
+inline uint32 RefreshTickMSTime()
+{
+    TickClock& clock = GetThreadTickClock();
+    clock.msTime = getMSTime();
+    clock.valid = true;
+    return clock.msTime;
+}
+
+inline uint32 getTickMSTime()
+{
+    TickClock const& clock = GetThreadTickClock();
+    return clock.valid ? clock.msTime : getMSTime();
+}
+
 inline uint32 getMSTimeDiff(uint32 oldMSTime, uint32 newMSTime)
 {
     // getMSTime() have limited data range and this is case when it overflow in this tick
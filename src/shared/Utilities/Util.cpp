@@ -72,6 +72,11 @@ float rand_chance_f(void)
     return RNG::instance()->rand_f(0.0, 100.0);
 }
 
+void seed_thread_rand(uint32 seed)
+{
+    RNG::instance()->seed(seed);
+}
+
 Tokens StrSplit(const std::string& src, const std::string& sep)
 {
     Tokens r;
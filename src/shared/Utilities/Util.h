@@ -216,6 +216,16 @@ uint32 rand32();
  */
  float rand_chance_f(void);
 
+/**
+ * @brief Restart the random sequence of the calling thread from the given seed.
+ *
+ * The same seed gives the same draws afterwards, which is what the tick
+ * recorder relies on to replay a map update.
+ *
+ * @param seed
+ */
+void seed_thread_rand(uint32 seed);
+
 /**
  * @brief Return true if a random roll gets above the given chance
  *
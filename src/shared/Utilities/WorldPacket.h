@@ -29,6 +29,8 @@
 #include "ByteBuffer.h"
 #include "Opcodes.h"
 
+#include <memory>
+
 // Note: m_opcode and size stored in platfom dependent format
 // ignore endianess until send, and converted at receive
 /**
@@ -96,4 +98,11 @@ class WorldPacket : public ByteBuffer
     protected:
         uint16 m_opcode; /**< TODO */
 };
+
+/**
+ * @brief immutable packet shared by every socket it is sent to, each socket only encrypts its own header
+ *
+ * Headers that only forward declare WorldPacket repeat this typedef.
+ */
+typedef std::shared_ptr<WorldPacket const> SharedWorldPacket;
 #endif
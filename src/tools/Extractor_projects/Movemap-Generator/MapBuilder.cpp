@@ -22,6 +22,8 @@
  * and lore are copyrighted by Blizzard Entertainment, Inc.
  */
 
+#include <algorithm>
+
 #include <DetourNavMeshBuilder.h>
 #include <DetourCommon.h>
 
@@ -36,8 +38,16 @@
 
 using namespace VMAP;
 
+#define CHECKPOINT_FILE "mmaps/tiles.checkpoint"
+#define MANIFEST_FILE "mmaps.manifest"
+
 namespace MMAP
 {
+    static bool compareTileCount(const pair<uint32, uint32>& a, const pair<uint32, uint32>& b)
+    {
+        return a.second > b.second;
+    }
+
     MapBuilder::MapBuilder(char const* magic, float maxWalkableAngle, bool skipLiquid,
                            bool skipContinents, bool skipJunkMaps, bool skipBattlegrounds,
                            bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath) :
@@ -51,13 +61,17 @@ namespace MMAP
         m_rcContext(NULL),
         m_offMeshFilePath(offMeshFilePath),
         m_magic(magic),
-        m_numThreads(-1), m_threadPool(NULL), m_poolActivated(false)
+        m_numThreads(-1), m_threadPool(NULL), m_poolActivated(false),
+        m_hasCheckpoint(false), m_checkpointFile(NULL),
+        m_manifest(MANIFEST_FILE), m_settingsHash(0)
     {
         m_terrainBuilder = new TerrainBuilder(skipLiquid);
 
         m_rcContext = new rcContext(false);
 
         discoverTiles();
+        loadCheckpoint();
+        hashSettings();
     }
 
     /**************************************************************************/
@@ -76,6 +90,101 @@ namespace MMAP
 
         delete m_terrainBuilder;
         delete m_rcContext;
+
+        if (m_checkpointFile)
+        {
+            fclose(m_checkpointFile);
+        }
+    }
+
+    /**************************************************************************/
+    void MapBuilder::loadCheckpoint()
+    {
+        if (FILE* file = fopen(CHECKPOINT_FILE, "r"))
+        {
+            m_hasCheckpoint = true;
+
+            uint32 mapID, tileX, tileY;
+            while (fscanf(file, "%u %u %u", &mapID, &tileX, &tileY) == 3)
+            {
+                m_doneTiles.insert(uint64(mapID) << 32 | StaticMapTree::packTileID(tileX, tileY));
+            }
+            fclose(file);
+
+            printf(" Resuming, %u tiles were finished by an earlier run.\n\n", uint32(m_doneTiles.size()));
+        }
+
+        m_checkpointFile = fopen(CHECKPOINT_FILE, "a");
+        if (!m_checkpointFile)
+        {
+            perror("Failed to open " CHECKPOINT_FILE " for writing, the build cannot be resumed");
+        }
+    }
+
+    /**************************************************************************/
+    void MapBuilder::hashSettings()
+    {
+        uint32 versions[3] = { MMAP_MAGIC, MMAP_VERSION, DT_NAVMESH_VERSION };
+        bool skipLiquid = !m_terrainBuilder->usesLiquids();
+
+        m_settingsHash = ExtractManifest::HashData(versions, sizeof(versions));
+        m_settingsHash = ExtractManifest::HashData(m_magic, strlen(m_magic), m_settingsHash);
+        m_settingsHash = ExtractManifest::HashData(&m_maxWalkableAngle, sizeof(m_maxWalkableAngle), m_settingsHash);
+        m_settingsHash = ExtractManifest::HashData(&m_bigBaseUnit, sizeof(m_bigBaseUnit), m_settingsHash);
+        m_settingsHash = ExtractManifest::HashData(&skipLiquid, sizeof(skipLiquid), m_settingsHash);
+        if (m_offMeshFilePath)
+        {
+            ExtractManifest::HashFile(m_offMeshFilePath, m_settingsHash);
+        }
+
+        // the tiles only name the models they place, a changed model changes all of them
+        vector<string> files;
+        getDirContents(files, "vmaps", "*.vmo");
+        sort(files.begin(), files.end());
+        for (uint32 i = 0; i < files.size(); ++i)
+        {
+            m_settingsHash = ExtractManifest::HashData(files[i].c_str(), files[i].size(), m_settingsHash);
+            ExtractManifest::HashFile("vmaps/" + files[i], m_settingsHash);
+        }
+    }
+
+    /**************************************************************************/
+    uint64 MapBuilder::getTileInputHash(int mapID, int tileX, int tileY)
+    {
+        uint64 hash = m_settingsHash;
+        char fileName[255];
+
+        // the terrain of the neighbour tiles is used for the borders
+        for (int y = tileY - 1; y <= tileY + 1; ++y)
+        {
+            for (int x = tileX - 1; x <= tileX + 1; ++x)
+            {
+                sprintf(fileName, "maps/%03u%02u%02u.map", mapID, y, x);
+                uint8 found = ExtractManifest::HashFile(fileName, hash);
+                hash = ExtractManifest::HashData(&found, sizeof(found), hash);
+            }
+        }
+
+        sprintf(fileName, "vmaps/%03u.vmtree", mapID);
+        ExtractManifest::HashFile(fileName, hash);
+        ExtractManifest::HashFile("vmaps/" + StaticMapTree::getTileFileName(mapID, tileY, tileX), hash);
+        return hash;
+    }
+
+    /**************************************************************************/
+    void MapBuilder::markTileDone(int mapID, int tileX, int tileY, uint64 inputHash)
+    {
+        char fileName[255];
+        sprintf(fileName, "mmaps/%03u%02i%02i.mmtile", mapID, tileY, tileX);
+        m_manifest.Update(fileName, inputHash);
+
+        ACE_Guard<ACE_Thread_Mutex> guard(m_checkpointLock);
+
+        if (m_checkpointFile)
+        {
+            fprintf(m_checkpointFile, "%u %u %u\n", mapID, tileX, tileY);
+            fflush(m_checkpointFile);
+        }
     }
 
     /**************************************************************************/
@@ -181,15 +290,28 @@ namespace MMAP
     /**************************************************************************/
     void MapBuilder::buildAllMaps()
     {
+        // all maps share the pool's queue, scheduling the largest first keeps the
+        // continents from being the only work left at the end
+        vector<pair<uint32, uint32> > maps;
         for (TileList::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
         {
             uint32 mapID = (*it).first;
             if (!shouldSkipMap(mapID,m_skipContinents,m_skipJunkMaps,m_skipBattlegrounds))
             {
-                buildMap(mapID, false);
+                maps.push_back(pair<uint32, uint32>(mapID, uint32((*it).second->size())));
             }
         }
 
+        if (activated())
+        {
+            stable_sort(maps.begin(), maps.end(), compareTileCount);
+        }
+
+        for (vector<pair<uint32, uint32> >::iterator it = maps.begin(); it != maps.end(); ++it)
+        {
+            buildMap((*it).first, false);
+        }
+
         if (activated())
         {
             Tile_Message_Block *finish_mb = new Tile_Message_Block(NULL);
@@ -253,7 +375,8 @@ namespace MMAP
             // unpack tile coords
             StaticMapTree::unpackTileID((*it), tileX, tileY);
 
-            if (shouldSkipTile(mapID, tileX, tileY))
+            uint64 inputHash = getTileInputHash(mapID, tileX, tileY);
+            if (shouldSkipTile(mapID, tileX, tileY, inputHash))
             {
                 continue;
             }
@@ -261,6 +384,7 @@ namespace MMAP
             if (!activated())
             {
                 buildTile(mapID, tileX, tileY, navMesh);
+                markTileDone(mapID, tileX, tileY, inputHash);
             }
             else
             {
@@ -268,7 +392,7 @@ namespace MMAP
                 buildNavMesh(mapID, mesh, meshParams); //meshParams is not null, so we get a new pointer to dtNavMesh
                 if (mesh)
                 {
-                    TileBuilder* tb = new TileBuilder(this, mapID, tileX, tileY, mesh);
+                    TileBuilder* tb = new TileBuilder(this, mapID, tileX, tileY, inputHash, mesh);
                     Tile_Message_Block *mb = new Tile_Message_Block(tb);
                     if (m_threadPool->putq(mb) == -1)
                     {
@@ -325,12 +449,17 @@ namespace MMAP
     void MapBuilder::buildTile(int mapID, int tileX, int tileY, dtNavMesh* navMesh)
     {
         MeshData meshData;
+        ExtractBenchmark::AddTiles();
 
         // get heightmap data
+        BenchmarkTimer terrainTimer("terrain_load");
         m_terrainBuilder->loadMap(mapID, tileX, tileY, meshData, m_magic);
+        terrainTimer.Stop();
 
         // get model data
+        BenchmarkTimer vmapTimer("vmap_load");
         m_terrainBuilder->loadVMap(mapID, tileY, tileX, meshData);
+        vmapTimer.Stop();
 
         // if there is no data, give up now
         if (!meshData.solidVerts.size() && !meshData.liquidVerts.size())
@@ -578,6 +707,7 @@ namespace MMAP
                 tbmax[1] = tileCfg.bmax[2];
 
                 // build heightfield
+                BenchmarkTimer rasterizeTimer("recast_rasterize");
                 tile.solid = rcAllocHeightfield();
                 if (!tile.solid || !rcCreateHeightfield(m_rcContext, *tile.solid, tileCfg.width, tileCfg.height, tileCfg.bmin, tileCfg.bmax, tileCfg.cs, tileCfg.ch))
                 {
@@ -598,7 +728,10 @@ namespace MMAP
 
                 rcRasterizeTriangles(m_rcContext, lVerts, lVertCount, lTris, lTriFlags, lTriCount, *tile.solid, config.walkableClimb);
 
+                rasterizeTimer.Stop();
+
                 // compact heightfield spans
+                BenchmarkTimer partitionTimer("recast_partition");
                 tile.chf = rcAllocCompactHeightfield();
                 if (!tile.chf || !rcBuildCompactHeightfield(m_rcContext, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid, *tile.chf))
                 {
@@ -632,7 +765,10 @@ namespace MMAP
                     continue;
                 }
 
+                partitionTimer.Stop();
+
                 // build polymesh
+                BenchmarkTimer polyMeshTimer("recast_polymesh");
                 tile.pmesh = rcAllocPolyMesh();
                 if (!tile.pmesh || !rcBuildPolyMesh(m_rcContext, *tile.cset, tileCfg.maxVertsPerPoly, *tile.pmesh))
                 {
@@ -660,6 +796,7 @@ namespace MMAP
         }
 
         // merge per tile poly and detail meshes
+        BenchmarkTimer mergeTimer("recast_merge");
         rcPolyMesh** pmmerge = new rcPolyMesh*[TILES_PER_MAP * TILES_PER_MAP];
         if (!pmmerge)
         {
@@ -719,6 +856,7 @@ namespace MMAP
         delete [] dmmerge;
 
         delete [] tiles;
+        mergeTimer.Stop();
 
 #if defined (CATA)
         // remove padding for extraction
@@ -814,6 +952,7 @@ namespace MMAP
                 continue;
             }
 
+            BenchmarkTimer detourTimer("detour_build");
             if (!dtCreateNavMeshData(&params, &navData, &navDataSize))
             {
                 printf(" Failed building navmesh tile - %s           \n", tileString);
@@ -830,7 +969,10 @@ namespace MMAP
                 continue;
             }
 
+            detourTimer.Stop();
+
             // file output
+            BenchmarkTimer writeTimer("write");
             char fileName[255];
             sprintf(fileName, "mmaps/%03u%02i%02i.mmtile", mapID, tileY, tileX);
             FILE* file = fopen(fileName, "wb");
@@ -895,10 +1037,23 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    bool MapBuilder::shouldSkipTile(int mapID, int tileX, int tileY)
+    bool MapBuilder::shouldSkipTile(int mapID, int tileX, int tileY, uint64 inputHash)
     {
         char fileName[255];
         sprintf(fileName, "mmaps/%03u%02i%02i.mmtile", mapID, tileY, tileX);
+
+        // a benchmark measures the whole build
+        if (ExtractBenchmark::IsEnabled())
+        {
+            return false;
+        }
+
+        // tiles built by this version are rebuilt exactly when their input changed
+        if (m_manifest.Contains(fileName))
+        {
+            return m_manifest.IsUpToDate(fileName, inputHash);
+        }
+
         FILE* file = fopen(fileName, "rb");
         if (!file)
         {
@@ -919,6 +1074,12 @@ namespace MMAP
             return false;
         }
 
+        // a run that was killed may have left this tile half written
+        if (m_hasCheckpoint && m_doneTiles.find(uint64(mapID) << 32 | StaticMapTree::packTileID(tileX, tileY)) == m_doneTiles.end())
+        {
+            return false;
+        }
+
         return true;
     }
 }
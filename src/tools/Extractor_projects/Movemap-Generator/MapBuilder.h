@@ -39,6 +39,8 @@
 #include "WorldModel.h"
 
 #include "TileThreadPool.h"
+#include "ace/Thread_Mutex.h"
+#include "ExtractorCommon.h"
 
 using namespace std;
 using namespace VMAP;
@@ -152,7 +154,39 @@ namespace MMAP
              */
             void buildTile(int mapID, int tileX, int tileY, dtNavMesh* navMesh);
 
+            /**
+             * @brief records a finished tile in the checkpoint file, so an interrupted run
+             * does not trust the half written tile it was working on
+             *
+             * @param mapID
+             * @param tileX
+             * @param tileY
+             */
+            void markTileDone(int mapID, int tileX, int tileY, uint64 inputHash);
+
         private:
+            /**
+             * @brief reads the tiles finished by earlier runs and opens the checkpoint for appending
+             *
+             */
+            void loadCheckpoint();
+
+            /**
+             * @brief hashes the options and the files shared by all tiles into m_settingsHash
+             *
+             */
+            void hashSettings();
+
+            /**
+             * @brief hash of the map and vmap files the tile is built from
+             *
+             * @param mapID
+             * @param tileX
+             * @param tileY
+             * @return uint64
+             */
+            uint64 getTileInputHash(int mapID, int tileX, int tileY);
+
             /**
              * @brief detect maps and tiles
              *
@@ -226,7 +260,7 @@ namespace MMAP
              * @param tileY
              * @return bool
              */
-            bool shouldSkipTile(int mapID, int tileX, int tileY);
+            bool shouldSkipTile(int mapID, int tileX, int tileY, uint64 inputHash);
 
             TerrainBuilder* m_terrainBuilder; /**< TODO */
             TileList m_tiles; /**< TODO */
@@ -246,6 +280,14 @@ namespace MMAP
             TileThreadPool* m_threadPool;
             bool            m_poolActivated;
 
+            set<uint64>      m_doneTiles;      /**< map id << 32 | tile id of finished tiles */
+            bool             m_hasCheckpoint;  /**< a checkpoint existed, only its tiles are complete */
+            FILE*            m_checkpointFile;
+            ACE_Thread_Mutex m_checkpointLock;
+
+            ExtractManifest  m_manifest;       /**< input hashes of the built tiles */
+            uint64           m_settingsHash;
+
             rcContext* m_rcContext; /**< build performance - not really used for now */
     };
 }
@@ -83,85 +83,53 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    bool TerrainBuilder::loadMap(uint32 mapID, uint32 tileX, uint32 tileY, MeshData& meshData, Spot portion,char const* MAP_VERSION_MAGIC)
+    bool TerrainBuilder::readMapTile(FILE* mapFile, const char* mapFileName, MapTileData& tile, char const* MAP_VERSION_MAGIC)
     {
-        char mapFileName[255];
-        sprintf(mapFileName, "maps/%03u%02u%02u.map", mapID, tileY, tileX);
-
-        FILE* mapFile = fopen(mapFileName, "rb");
-        if (!mapFile)
-        {
-            return false;
-        }
-
         GridMapFileHeader fheader;
-        size_t file_read = fread(&fheader, sizeof(GridMapFileHeader), 1, mapFile);
-
-        if (file_read <= 0)
+        if (fread(&fheader, sizeof(GridMapFileHeader), 1, mapFile) != 1)
         {
-            fclose(mapFile);
             printf("Could not read map data from %s.\n", mapFileName);
             return false;
         }
 
         if (fheader.versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC)))
         {
-            fclose(mapFile);
             printf("%s is the wrong version, please extract new .map files\n", mapFileName);
             return false;
         }
 
         GridMapHeightHeader hheader;
         fseek(mapFile, fheader.heightMapOffset, SEEK_SET);
-        file_read = fread(&hheader, sizeof(GridMapHeightHeader), 1, mapFile);
-
-        if (file_read <= 0)
+        if (fread(&hheader, sizeof(GridMapHeightHeader), 1, mapFile) != 1)
         {
-            fclose(mapFile);
             printf("Could not read map data from %s.\n", mapFileName);
             return false;
         }
 
-        bool haveTerrain = !(hheader.flags & MAP_HEIGHT_NO_HEIGHT);
-        bool haveLiquid = fheader.liquidMapOffset && !m_skipLiquid;
+        tile.haveTerrain = !(hheader.flags & MAP_HEIGHT_NO_HEIGHT);
+        tile.haveLiquid = fheader.liquidMapOffset && !m_skipLiquid;
 
         // no data in this map file
-        if (!haveTerrain && !haveLiquid)
+        if (!tile.haveTerrain && !tile.haveLiquid)
         {
-            fclose(mapFile);
             return false;
         }
 
-        // data used later
-        uint16 holes[16][16];
-        memset(holes, 0, sizeof(holes));
-        uint8 liquid_type[16][16];
-        memset(liquid_type, 0, sizeof(liquid_type));
-        G3D::Array<int> ltriangles;
-        G3D::Array<int> ttriangles;
+        memset(tile.holes, 0, sizeof(tile.holes));
+        memset(tile.liquid_type, 0, sizeof(tile.liquid_type));
 
         // terrain data
-        if (haveTerrain)
+        if (tile.haveTerrain)
         {
             int i;
             float heightMultiplier;
-            float V9[V9_SIZE_SQ], V8[V8_SIZE_SQ];
 
             if (hheader.flags & MAP_HEIGHT_AS_INT8)
             {
                 uint8 v9[V9_SIZE_SQ];
                 uint8 v8[V8_SIZE_SQ];
-                file_read = fread(v9, sizeof(uint8), V9_SIZE_SQ, mapFile);
-                if (file_read <= 0)
-                {
-                    fclose(mapFile);
-                    printf("Could not read map data from %s.\n", mapFileName);
-                    return false;
-                }
-                file_read = fread(v8, sizeof(uint8), V8_SIZE_SQ, mapFile);
-                if (file_read <= 0)
+                if (fread(v9, sizeof(uint8), V9_SIZE_SQ, mapFile) <= 0 || fread(v8, sizeof(uint8), V8_SIZE_SQ, mapFile) <= 0)
                 {
-                    fclose(mapFile);
                     printf("Could not read map data from %s.\n", mapFileName);
                     return false;
                 }
@@ -169,29 +137,20 @@ namespace MMAP
 
                 for (i = 0; i < V9_SIZE_SQ; ++i)
                 {
-                    V9[i] = (float)v9[i] * heightMultiplier + hheader.gridHeight;
+                    tile.V9[i] = (float)v9[i] * heightMultiplier + hheader.gridHeight;
                 }
 
                 for (i = 0; i < V8_SIZE_SQ; ++i)
                 {
-                    V8[i] = (float)v8[i] * heightMultiplier + hheader.gridHeight;
+                    tile.V8[i] = (float)v8[i] * heightMultiplier + hheader.gridHeight;
                 }
             }
             else if (hheader.flags & MAP_HEIGHT_AS_INT16)
             {
                 uint16 v9[V9_SIZE_SQ];
                 uint16 v8[V8_SIZE_SQ];
-                file_read = fread(v9, sizeof(uint16), V9_SIZE_SQ, mapFile);
-                if (file_read <= 0)
+                if (fread(v9, sizeof(uint16), V9_SIZE_SQ, mapFile) <= 0 || fread(v8, sizeof(uint16), V8_SIZE_SQ, mapFile) <= 0)
                 {
-                    fclose(mapFile);
-                    printf("Could not read map data from %s.\n", mapFileName);
-                    return false;
-                }
-                file_read = fread(v8, sizeof(uint16), V8_SIZE_SQ, mapFile);
-                if (file_read <= 0)
-                {
-                    fclose(mapFile);
                     printf("Could not read map data from %s.\n", mapFileName);
                     return false;
                 }
@@ -199,182 +158,218 @@ namespace MMAP
 
                 for (i = 0; i < V9_SIZE_SQ; ++i)
                 {
-                    V9[i] = (float)v9[i] * heightMultiplier + hheader.gridHeight;
+                    tile.V9[i] = (float)v9[i] * heightMultiplier + hheader.gridHeight;
                 }
 
                 for (i = 0; i < V8_SIZE_SQ; ++i)
                 {
-                    V8[i] = (float)v8[i] * heightMultiplier + hheader.gridHeight;
+                    tile.V8[i] = (float)v8[i] * heightMultiplier + hheader.gridHeight;
                 }
             }
-            else
+            else if (fread(tile.V9, sizeof(float), V9_SIZE_SQ, mapFile) <= 0 || fread(tile.V8, sizeof(float), V8_SIZE_SQ, mapFile) <= 0)
             {
-                file_read = fread(V9, sizeof(float), V9_SIZE_SQ, mapFile);
-                if (file_read <= 0)
-                {
-                    fclose(mapFile);
-                    printf("Could not read map data from %s.\n", mapFileName);
-                    return false;
-                }
-                file_read = fread(V8, sizeof(float), V8_SIZE_SQ, mapFile);
-                if (file_read <= 0)
-                {
-                    fclose(mapFile);
-                    printf("Could not read map data from %s.\n", mapFileName);
-                    return false;
-                }
+                printf("Could not read map data from %s.\n", mapFileName);
+                return false;
             }
 
             // hole data
-            memset(holes, 0, fheader.holesSize);
             fseek(mapFile, fheader.holesOffset, SEEK_SET);
-            file_read = fread(holes, fheader.holesSize, 1, mapFile);
-            if (file_read <= 0)
+            if (fread(tile.holes, fheader.holesSize, 1, mapFile) <= 0)
             {
-                fclose(mapFile);
                 printf("Could not read map data from %s.\n", mapFileName);
                 return false;
             }
-
-            int count = meshData.solidVerts.size() / 3;
-            float xoffset = (float(tileX) - 32) * GRID_SIZE;
-            float yoffset = (float(tileY) - 32) * GRID_SIZE;
-
-            float coord[3];
-
-            for (i = 0; i < V9_SIZE_SQ; ++i)
-            {
-                getHeightCoord(i, GRID_V9, xoffset, yoffset, coord, V9);
-                meshData.solidVerts.append(coord[0]);
-                meshData.solidVerts.append(coord[2]);
-                meshData.solidVerts.append(coord[1]);
-            }
-
-            for (i = 0; i < V8_SIZE_SQ; ++i)
-            {
-                getHeightCoord(i, GRID_V8, xoffset, yoffset, coord, V8);
-                meshData.solidVerts.append(coord[0]);
-                meshData.solidVerts.append(coord[2]);
-                meshData.solidVerts.append(coord[1]);
-            }
-
-            int j, indices[3], loopStart, loopEnd, loopInc;
-            getLoopVars(portion, loopStart, loopEnd, loopInc);
-            for (i = loopStart; i < loopEnd; i += loopInc)
-                for (j = TOP; j <= BOTTOM; j += 1)
-                {
-                    getHeightTriangle(i, Spot(j), indices);
-                    ttriangles.append(indices[2] + count);
-                    ttriangles.append(indices[1] + count);
-                    ttriangles.append(indices[0] + count);
-                }
         }
 
         // liquid data
-        if (haveLiquid)
+        if (tile.haveLiquid)
         {
-            GridMapLiquidHeader lheader;
             fseek(mapFile, fheader.liquidMapOffset, SEEK_SET);
-            file_read = fread(&lheader, sizeof(GridMapLiquidHeader), 1, mapFile);
-            if (file_read <= 0)
+            if (fread(&tile.lheader, sizeof(GridMapLiquidHeader), 1, mapFile) != 1)
             {
-                fclose(mapFile);
                 printf("Could not read map data from %s.\n", mapFileName);
                 return false;
             }
 
-            float* liquid_map = NULL;
+            if (!(tile.lheader.flags & MAP_LIQUID_NO_TYPE) && fread(tile.liquid_type, sizeof(tile.liquid_type), 1, mapFile) != 1)
+            {
+                printf("Could not read map data from %s.\n", mapFileName);
+                return false;
+            }
 
-            if (!(lheader.flags & MAP_LIQUID_NO_TYPE))
+            if (!(tile.lheader.flags & MAP_LIQUID_NO_HEIGHT))
             {
-                file_read = fread(liquid_type, sizeof(liquid_type), 1, mapFile);
-                if (file_read <= 0)
+                tile.liquid_map.resize(tile.lheader.width * tile.lheader.height);
+                if (fread(&tile.liquid_map[0], sizeof(float), tile.liquid_map.size(), mapFile) <= 0)
                 {
-                    fclose(mapFile);
                     printf("Could not read map data from %s.\n", mapFileName);
                     return false;
                 }
             }
+        }
 
-            if (!(lheader.flags & MAP_LIQUID_NO_HEIGHT))
+        return true;
+    }
+
+    /**************************************************************************/
+    std::shared_ptr<const MapTileData> TerrainBuilder::getMapTile(uint32 mapID, uint32 tileX, uint32 tileY, char const* MAP_VERSION_MAGIC)
+    {
+        // the callers step off the map at its borders
+        if (tileX >= 64 || tileY >= 64)
+        {
+            return std::shared_ptr<const MapTileData>();
+        }
+
+        uint32 key = mapID << 12 | tileX << 6 | tileY;
+        {
+            std::lock_guard<std::mutex> guard(m_mapTileLock);
+            MapTileCache::iterator itr = m_mapTiles.find(key);
+            if (itr != m_mapTiles.end())
             {
-                liquid_map = new float [lheader.width * lheader.height];
-                file_read = fread(liquid_map, sizeof(float), lheader.width * lheader.height, mapFile);
-                if (file_read <= 0)
+                if (std::shared_ptr<const MapTileData> tile = itr->second.lock())
                 {
-                    fclose(mapFile);
-                    delete [] liquid_map;
-                    printf("Could not read map data from %s.\n", mapFileName);
-                    return false;
+                    return tile;
                 }
             }
+        }
+
+        char mapFileName[255];
+        sprintf(mapFileName, "maps/%03u%02u%02u.map", mapID, tileY, tileX);
+
+        FILE* mapFile = fopen(mapFileName, "rb");
+        if (!mapFile)
+        {
+            return std::shared_ptr<const MapTileData>();
+        }
 
-            if (liquid_type && liquid_map)
+        std::shared_ptr<MapTileData> tile(new MapTileData());
+        bool loaded = readMapTile(mapFile, mapFileName, *tile, MAP_VERSION_MAGIC);
+        fclose(mapFile);
+
+        if (!loaded)
+        {
+            return std::shared_ptr<const MapTileData>();
+        }
+
+        std::lock_guard<std::mutex> guard(m_mapTileLock);
+
+        // forget the tiles no worker uses any more
+        for (MapTileCache::iterator itr = m_mapTiles.begin(); itr != m_mapTiles.end();)
+        {
+            if (itr->second.expired())
             {
-                int count = meshData.liquidVerts.size() / 3;
-                float xoffset = (float(tileX) - 32) * GRID_SIZE;
-                float yoffset = (float(tileY) - 32) * GRID_SIZE;
+                m_mapTiles.erase(itr++);
+            }
+            else
+            {
+                ++itr;
+            }
+        }
 
-                float coord[3];
-                int row, col;
+        // another worker may have read it meanwhile, share its copy
+        std::weak_ptr<const MapTileData>& cached = m_mapTiles[key];
+        if (std::shared_ptr<const MapTileData> other = cached.lock())
+        {
+            return other;
+        }
 
-                // generate coordinates
-                if (!(lheader.flags & MAP_LIQUID_NO_HEIGHT))
-                {
-                    int j = 0;
-                    for (int i = 0; i < V9_SIZE_SQ; ++i)
-                    {
-                        row = i / V9_SIZE;
-                        col = i % V9_SIZE;
+        cached = tile;
+        return tile;
+    }
 
-                        if (row < lheader.offsetY || row >= lheader.offsetY + lheader.height ||
-                            col < lheader.offsetX || col >= lheader.offsetX + lheader.width)
-                        {
-                            // dummy vert using invalid height
-                            meshData.liquidVerts.append((xoffset + col * GRID_PART_SIZE) * -1, INVALID_MAP_LIQ_HEIGHT, (yoffset + row * GRID_PART_SIZE) * -1);
-                            continue;
-                        }
+    /**************************************************************************/
+    bool TerrainBuilder::loadMap(uint32 mapID, uint32 tileX, uint32 tileY, MeshData& meshData, Spot portion, char const* MAP_VERSION_MAGIC)
+    {
+        std::shared_ptr<const MapTileData> tile = getMapTile(mapID, tileX, tileY, MAP_VERSION_MAGIC);
+        if (!tile)
+        {
+            return false;
+        }
 
-                        getLiquidCoord(i, j, xoffset, yoffset, coord, liquid_map);
-                        meshData.liquidVerts.append(coord[0]);
-                        meshData.liquidVerts.append(coord[2]);
-                        meshData.liquidVerts.append(coord[1]);
-                        j++;
-                    }
-                }
-                else
+        G3D::Array<int> ltriangles;
+        G3D::Array<int> ttriangles;
+
+        // only the vertices used by the triangles of the portion are added, borders take a single row
+        vector<int> vertexIndex;
+        int indices[3], loopStart, loopEnd, loopInc;
+        getLoopVars(portion, loopStart, loopEnd, loopInc);
+
+        float xoffset = (float(tileX) - 32) * GRID_SIZE;
+        float yoffset = (float(tileY) - 32) * GRID_SIZE;
+        float coord[3];
+
+        // terrain data
+        if (tile->haveTerrain)
+        {
+            vertexIndex.assign(V9_SIZE_SQ + V8_SIZE_SQ, -1);
+
+            for (int i = loopStart; i < loopEnd; i += loopInc)
+                for (int j = TOP; j <= BOTTOM; j += 1)
                 {
-                    for (int i = 0; i < V9_SIZE_SQ; ++i)
+                    getHeightTriangle(i, Spot(j), indices);
+                    for (int k = 2; k >= 0; --k)
                     {
-                        row = i / V9_SIZE;
-                        col = i % V9_SIZE;
-                        meshData.liquidVerts.append((xoffset + col * GRID_PART_SIZE) * -1, lheader.liquidLevel, (yoffset + row * GRID_PART_SIZE) * -1);
+                        int& vertex = vertexIndex[indices[k]];
+                        if (vertex < 0)
+                        {
+                            vertex = meshData.solidVerts.size() / 3;
+                            if (indices[k] < V9_SIZE_SQ)
+                            {
+                                getHeightCoord(indices[k], GRID_V9, xoffset, yoffset, coord, tile->V9);
+                            }
+                            else
+                            {
+                                getHeightCoord(indices[k] - V9_SIZE_SQ, GRID_V8, xoffset, yoffset, coord, tile->V8);
+                            }
+                            meshData.solidVerts.append(coord[0], coord[2], coord[1]);
+                        }
+                        ttriangles.append(vertex);
                     }
                 }
+        }
 
-                delete [] liquid_map;
-
-                int indices[3], loopStart, loopEnd, loopInc, triInc;
-                getLoopVars(portion, loopStart, loopEnd, loopInc);
-                triInc = BOTTOM - TOP;
+        // liquid data
+        int liquidStart = meshData.liquidVerts.size() / 3;
+        if (tile->haveLiquid && !tile->liquid_map.empty())
+        {
+            const GridMapLiquidHeader& lheader = tile->lheader;
+            vertexIndex.assign(V9_SIZE_SQ, -1);
 
-                // generate triangles
-                for (int i = loopStart; i < loopEnd; i += loopInc)
-                    for (int j = TOP; j <= BOTTOM; j += triInc)
+            int triInc = BOTTOM - TOP;
+            for (int i = loopStart; i < loopEnd; i += loopInc)
+                for (int j = TOP; j <= BOTTOM; j += triInc)
+                {
+                    getHeightTriangle(i, Spot(j), indices, true);
+                    for (int k = 2; k >= 0; --k)
                     {
-                        getHeightTriangle(i, Spot(j), indices, true);
-                        ltriangles.append(indices[2] + count);
-                        ltriangles.append(indices[1] + count);
-                        ltriangles.append(indices[0] + count);
+                        int& vertex = vertexIndex[indices[k]];
+                        if (vertex < 0)
+                        {
+                            vertex = meshData.liquidVerts.size() / 3;
+
+                            int row = indices[k] / V9_SIZE;
+                            int col = indices[k] % V9_SIZE;
+                            if (row < lheader.offsetY || row >= lheader.offsetY + lheader.height ||
+                                col < lheader.offsetX || col >= lheader.offsetX + lheader.width)
+                            {
+                                // dummy vert using invalid height
+                                meshData.liquidVerts.append((xoffset + col * GRID_PART_SIZE) * -1, INVALID_MAP_LIQ_HEIGHT, (yoffset + row * GRID_PART_SIZE) * -1);
+                            }
+                            else
+                            {
+                                int heightIndex = (row - lheader.offsetY) * lheader.width + col - lheader.offsetX;
+                                getLiquidCoord(indices[k], heightIndex, xoffset, yoffset, coord, &tile->liquid_map[0]);
+                                meshData.liquidVerts.append(coord[0], coord[2], coord[1]);
+                            }
+                        }
+                        ltriangles.append(vertex);
                     }
-            }
+                }
         }
 
-        fclose(mapFile);
-
         // now that we have gathered the data, we can figure out which parts to keep:
         // liquid above ground, ground above liquid
-        int loopStart, loopEnd, loopInc, tTriCount = 4;
+        int tTriCount = 4;
         bool useTerrain, useLiquid;
 
         float* lverts = meshData.liquidVerts.getCArray();
@@ -388,14 +383,9 @@ namespace MMAP
             return false;
         }
 
-        // make a copy of liquid vertices
+        // make a copy of this tile's liquid vertices
         // used to pad right-bottom frame due to lost vertex data at extraction
-        float* lverts_copy = NULL;
-        if (meshData.liquidVerts.size())
-        {
-            lverts_copy = new float[meshData.liquidVerts.size()];
-            memcpy(lverts_copy, lverts, sizeof(float)*meshData.liquidVerts.size());
-        }
+        vector<float> lverts_copy(lverts + liquidStart * 3, lverts + meshData.liquidVerts.size());
 
         getLoopVars(portion, loopStart, loopEnd, loopInc);
         for (int i = loopStart; i < loopEnd; i += loopInc)
@@ -408,13 +398,13 @@ namespace MMAP
                 uint8 liquidType = MAP_LIQUID_TYPE_NO_WATER;
 
                 // if there is no liquid, don't use liquid
-                if (!liquid_type || !meshData.liquidVerts.size() || !ltriangles.size())
+                if (!meshData.liquidVerts.size() || !ltriangles.size())
                 {
                     useLiquid = false;
                 }
                 else
                 {
-                    liquidType = getLiquidType(i, liquid_type);
+                    liquidType = getLiquidType(i, tile->liquid_type);
                     switch (liquidType)
                     {
                         default:
@@ -453,7 +443,7 @@ namespace MMAP
                     uint32 validCount = 0;
                     for (uint32 idx = 0; idx < 3; idx++)
                     {
-                        float h = lverts_copy[ltris[idx] * 3 + 1];
+                        float h = lverts_copy[(ltris[idx] - liquidStart) * 3 + 1];
                         if (h != INVALID_MAP_LIQ_HEIGHT && h < INVALID_MAP_LIQ_HEIGHT_MAX)
                         {
                             quadHeight += h;
@@ -485,7 +475,7 @@ namespace MMAP
                 // if there is a hole here, don't use the terrain
                 if (useTerrain)
                 {
-                    useTerrain = !isHole(i, holes);
+                    useTerrain = !isHole(i, tile->holes);
                 }
 
                 // we use only one terrain kind per quad - pick higher one
@@ -558,16 +548,11 @@ namespace MMAP
             }
         }
 
-        if (lverts_copy)
-        {
-            delete [] lverts_copy;
-        }
-
         return meshData.solidTris.size() || meshData.liquidTris.size();
     }
 
     /**************************************************************************/
-    void TerrainBuilder::getHeightCoord(int index, Grid grid, float xOffset, float yOffset, float* coord, float* v)
+    void TerrainBuilder::getHeightCoord(int index, Grid grid, float xOffset, float yOffset, float* coord, const float* v)
     {
         // wow coords: x, y, height
         // coord is mirroed about the horizontal axes
@@ -635,7 +620,7 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    void TerrainBuilder::getLiquidCoord(int index, int index2, float xOffset, float yOffset, float* coord, float* v)
+    void TerrainBuilder::getLiquidCoord(int index, int index2, float xOffset, float yOffset, float* coord, const float* v)
     {
         // wow coords: x, y, height
         // coord is mirroed about the horizontal axes
@@ -35,6 +35,10 @@
 #include "G3D/Vector3.h"
 #include "G3D/Matrix3.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 using namespace MaNGOS;
 
 namespace MMAP
@@ -97,6 +101,22 @@ namespace MMAP
         G3D::Array<unsigned short> offMeshConnectionsFlags; /**< TODO */
     };
 
+    /**
+     * @brief decoded contents of a .map file, shared by the tiles building it as center or border
+     *
+     */
+    struct MapTileData
+    {
+        bool haveTerrain;
+        bool haveLiquid;
+        float V9[V9_SIZE_SQ];
+        float V8[V8_SIZE_SQ];
+        uint16 holes[16][16];
+        uint8 liquid_type[16][16];
+        GridMapLiquidHeader lheader;
+        vector<float> liquid_map;   /**< empty without liquid heights */
+    };
+
     /**
      * @brief
      *
@@ -220,6 +240,30 @@ namespace MMAP
 
             bool m_skipLiquid; /**< Controls whether liquids are loaded */
 
+            /**
+             * @brief the decoded map file, read once while any worker still uses it
+             *
+             * @param mapID
+             * @param tileX
+             * @param tileY
+             * @return std::shared_ptr<const MapTileData> NULL if there is no usable data
+             */
+            std::shared_ptr<const MapTileData> getMapTile(uint32 mapID, uint32 tileX, uint32 tileY, char const* MAP_VERSION_MAGIC);
+
+            /**
+             * @brief reads and decodes the terrain and liquid of a map file
+             *
+             * @param mapFile
+             * @param mapFileName
+             * @param tile
+             * @return bool
+             */
+            bool readMapTile(FILE* mapFile, const char* mapFileName, MapTileData& tile, char const* MAP_VERSION_MAGIC);
+
+            typedef std::map<uint32, std::weak_ptr<const MapTileData> > MapTileCache;
+            MapTileCache m_mapTiles;        /**< map id << 12 | x << 6 | y, expired entries are dropped */
+            std::mutex   m_mapTileLock;
+
             /**
              * @brief Load the map terrain from file
              *
@@ -243,7 +287,7 @@ namespace MMAP
              * @param coord
              * @param v
              */
-            void getHeightCoord(int index, Grid grid, float xOffset, float yOffset, float* coord, float* v);
+            void getHeightCoord(int index, Grid grid, float xOffset, float yOffset, float* coord, const float* v);
 
             /**
              * @brief Get the triangle's vector indices for a specific position
@@ -274,7 +318,7 @@ namespace MMAP
              * @param coord
              * @param v
              */
-            void getLiquidCoord(int index, int index2, float xOffset, float yOffset, float* coord, float* v);
+            void getLiquidCoord(int index, int index2, float xOffset, float yOffset, float* coord, const float* v);
 
             /**
              * @brief Get the liquid type for a specific position
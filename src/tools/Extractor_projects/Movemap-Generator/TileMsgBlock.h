@@ -31,14 +31,19 @@
 class TileBuilder
 {
     public:
-        TileBuilder(MMAP::MapBuilder* builder, int mapID, int tileX, int tileY, dtNavMesh* mesh) :
-            m_navMesh(mesh), m_tileY(tileY), m_tileX(tileX), m_mapID(mapID), m_builder(builder) {}
+        TileBuilder(MMAP::MapBuilder* builder, int mapID, int tileX, int tileY, uint64 inputHash, dtNavMesh* mesh) :
+            m_navMesh(mesh), m_inputHash(inputHash), m_tileY(tileY), m_tileX(tileX), m_mapID(mapID), m_builder(builder) {}
         ~TileBuilder() { delete m_navMesh; }
-        void Work() { m_builder->buildTile(m_mapID, m_tileX, m_tileY, m_navMesh); }
+        void Work()
+        {
+            m_builder->buildTile(m_mapID, m_tileX, m_tileY, m_navMesh);
+            m_builder->markTileDone(m_mapID, m_tileX, m_tileY, m_inputHash);
+        }
     private:
         int m_mapID;
         int m_tileX;
         int m_tileY;
+        uint64 m_inputHash;
         MMAP::MapBuilder* m_builder;
         dtNavMesh* m_navMesh;
 };
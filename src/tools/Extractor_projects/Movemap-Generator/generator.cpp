@@ -85,6 +85,9 @@ void printUsage(char* prg)
     printf("   --debugOutput [true|false]        create debugging files for use with\n");
     printf("                                     RecastDemo.\n");
     printf("   --silent                          No questions asked.\n");
+    printf("   --benchmark [file]                rebuild the selected map or tile and write\n");
+    printf("                                     the time spent in each stage, tiles per\n");
+    printf("                                     second and the peak memory as JSON.\n");
     printf("   [#]                               Build only the map specified by #.\n");
     printf("\n");
     printf(" Examples:\n");
@@ -110,7 +113,8 @@ bool handleArgs(int argc, char** argv,
                 bool& silent,
                 bool& bigBaseUnit,
                 int& num_threads,
-                char*& offMeshInputPath)
+                char*& offMeshInputPath,
+                char*& benchmarkFile)
 {
     char* param = NULL;
     for (int i = 1; i < argc; ++i)
@@ -329,6 +333,16 @@ bool handleArgs(int argc, char** argv,
 
             offMeshInputPath = param;
         }
+        else if (strcmp(argv[i], "--benchmark") == 0)
+        {
+            param = argv[++i];
+            if (!param)
+            {
+                return false;
+            }
+
+            benchmarkFile = param;
+        }
         else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
         {
             printUsage(argv[0]);
@@ -376,11 +390,12 @@ int main(int argc, char** argv)
          bigBaseUnit = false;
     int num_threads = 0;
     char* offMeshInputPath = NULL;
+    char* benchmarkFile = NULL;
 
     bool validParam = handleArgs(argc, argv, input_path, mapnum,
                                  tileX, tileY, maxAngle,
                                  skipLiquid, skipContinents, skipJunkMaps, skipBattlegrounds,
-                                 debugOutput, silent, bigBaseUnit, num_threads, offMeshInputPath);
+                                 debugOutput, silent, bigBaseUnit, num_threads, offMeshInputPath, benchmarkFile);
 
     if (!validParam)
     {
@@ -414,6 +429,11 @@ int main(int argc, char** argv)
         return silent ? -3 : finish(" Press any key to close...", -3);
     }
 
+    if (benchmarkFile)
+    {
+        ExtractBenchmark::Enable("movemap-generator", benchmarkFile);
+    }
+
     MapBuilder builder(map_magic, maxAngle, skipLiquid, skipContinents, skipJunkMaps,
                        skipBattlegrounds, debugOutput, bigBaseUnit, offMeshInputPath);
 
@@ -453,5 +473,7 @@ int main(int argc, char** argv)
     timer.elapsed_time(elapsed);
     printf(" \n Total build time: %ld seconds\n\n", elapsed.sec());
 
+    ExtractBenchmark::WriteReport();
+
     return silent ? 1 : finish(" Movemap build is complete! Press enter to exit\n", 1);
 }
@@ -24,6 +24,11 @@
 
 #include <stdio.h>
 #include <set>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 #include "dbcfile.h"
 #include <mpq.h>
@@ -65,6 +70,9 @@ uint16* LiqType;                    /**< TODO */
 char output_path[128] = ".";        /**< TODO */
 char input_path[128] = ".";         /**< TODO */
 uint32 maxAreaId = 0;               /**< TODO */
+uint32 maxLiqTypeId = 0;            /**< TODO */
+ExtractManifest* adtManifest = NULL; /**< hashes the map files were converted from, NULL converts all */
+uint64 convertSettingsHash = 0;     /**< DBC data and options all map files depend on */
 int iCoreNumber = 0;
 /**
  * @brief Data types which can be extracted
@@ -85,6 +93,9 @@ float CONF_float_to_int8_limit     = 2.0f;      /**< Max accuracy = val/256 */
 float CONF_float_to_int16_limit    = 2048.0f;   /**< Max accuracy = val/65536 */
 float CONF_flat_height_delta_limit = 0.005f;    /**< If max - min less this value - surface is flat */
 float CONF_flat_liquid_delta_limit = 0.001f;    /**< If max - min less this value - liquid surface is flat */
+int   CONF_threads                 = 1;         /**< Number of threads converting ADT files */
+int   CONF_map                     = -1;        /**< Only convert this map, -1 converts all */
+std::set<std::pair<uint32, uint32> > CONF_tiles; /**< Only convert these x, y tiles, empty converts all */
 
 int MAP_LIQUID_TYPE_NO_WATER = 0x00;
 int MAP_LIQUID_TYPE_MAGMA    = 0x01;
@@ -177,6 +188,12 @@ void Usage(char* prg)
     printf("                         size, but also accuracy\n");
     printf("   -e, --extract #       extract specified client data. 1 = maps, 2 = DBCs,\n");
     printf("                         3 = both. Defaults to extracting both.\n");
+    printf("   -t, --threads #       number of threads converting map files (default 1)\n");
+    printf("   -m, --map #           only convert the map with this id\n");
+    printf("       --tile x,y        only convert this tile, can be repeated\n");
+    printf("   -b, --benchmark <file> convert everything again and write the time spent\n");
+    printf("                         in each stage, tiles per second and the peak memory\n");
+    printf("                         to the file as JSON\n");
     printf("\n");
     printf(" Example:\n");
     printf(" - use input path and do not flatten maps:\n");
@@ -249,6 +266,56 @@ bool HandleArgs(int argc, char** argv)
                 Usage(argv[0]);
             }
         }
+        else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0)
+        {
+            param = argv[++i];
+            if (!param)
+            {
+                return false;
+            }
+
+            int threads = atoi(param);
+            if (threads > 0)
+            {
+                CONF_threads = threads;
+            }
+            else
+            {
+                printf("invalid option for '--threads', using single threaded conversion\n");
+            }
+        }
+        else if (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--map") == 0)
+        {
+            param = argv[++i];
+            if (!param)
+            {
+                return false;
+            }
+
+            CONF_map = atoi(param);
+        }
+        else if (strcmp(argv[i], "--tile") == 0)
+        {
+            param = argv[++i];
+            uint32 tileX, tileY;
+            if (!param || sscanf(param, "%u,%u", &tileX, &tileY) != 2 || tileX >= WDT_MAP_SIZE || tileY >= WDT_MAP_SIZE)
+            {
+                printf("invalid option for '--tile', should be [tileX],[tileY]\n");
+                return false;
+            }
+
+            CONF_tiles.insert(std::pair<uint32, uint32>(tileX, tileY));
+        }
+        else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--benchmark") == 0)
+        {
+            param = argv[++i];
+            if (!param)
+            {
+                return false;
+            }
+
+            ExtractBenchmark::Enable("map-extractor", param);
+        }
         else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
         {
             Usage(argv[0]);
@@ -402,6 +469,8 @@ void ReadLiquidTypeTableDBC()
         LiqType[dbc.getRecord(x).getUInt(0)] = dbc.getRecord(x).getUInt(3);
     }
 
+    maxLiqTypeId = LiqType_maxid;
+
     printf(" Success! %zu liquid types loaded.\n", LiqType_count);
 }
 
@@ -511,37 +580,59 @@ float selectUInt16StepStore(float maxDiff)
     return 65535 / maxDiff;
 }
 
-uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];      /**< Temporary grid data store */
-
-float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                         /**< TODO */
-float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];                 /**< TODO */
-uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                 /**< TODO */
-uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];         /**< TODO */
-uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                  /**< TODO */
-uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];          /**< TODO */
-
-uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];    /**< TODO */
-uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];     /**< TODO */
-bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];                /**< TODO */
-float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];      /**< TODO */
+/**
+ * @brief Temporary grid data store, one per converting thread
+ *
+ */
+struct ADTConvertBuffers
+{
+    uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];      /**< TODO */
+
+    float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                         /**< TODO */
+    float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];                 /**< TODO */
+    uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                 /**< TODO */
+    uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];         /**< TODO */
+    uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                  /**< TODO */
+    uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];          /**< TODO */
+
+    uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];    /**< TODO */
+    uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];     /**< TODO */
+    bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];                /**< TODO */
+    float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];      /**< TODO */
+};
 
 /**
  * @brief
  *
+ * @param adt the loaded file
  * @param filename
  * @param filename2
  * @param build
+ * @param buffers
  * @return bool
  */
-bool ConvertADT(char* filename, char* filename2, uint32 build)
+bool ConvertADT(ADT_file& adt, char* filename, char* filename2, uint32 build, ADTConvertBuffers& buffers)
 {
-    ADT_file adt;
-
-    if (!adt.loadFile(filename))
+    uint16 (&area_flags)[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID] = buffers.area_flags;
+    float (&V8)[ADT_GRID_SIZE][ADT_GRID_SIZE] = buffers.V8;
+    float (&V9)[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1] = buffers.V9;
+    uint16 (&uint16_V8)[ADT_GRID_SIZE][ADT_GRID_SIZE] = buffers.uint16_V8;
+    uint16 (&uint16_V9)[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1] = buffers.uint16_V9;
+    uint8 (&uint8_V8)[ADT_GRID_SIZE][ADT_GRID_SIZE] = buffers.uint8_V8;
+    uint8 (&uint8_V9)[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1] = buffers.uint8_V9;
+    uint16 (&liquid_entry)[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID] = buffers.liquid_entry;
+    uint8 (&liquid_flags)[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID] = buffers.liquid_flags;
+    bool (&liquid_show)[ADT_GRID_SIZE][ADT_GRID_SIZE] = buffers.liquid_show;
+    float (&liquid_height)[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1] = buffers.liquid_height;
+
+    uint64 hash = ExtractManifest::HashData(adt.GetData(), adt.GetDataSize(), convertSettingsHash);
+    if (adtManifest && adtManifest->IsUpToDate(filename2, hash))
     {
-        return false;
+        return true;
     }
 
+    BenchmarkTimer convert("convert");
+
     adt_MCIN* cells = adt.a_grid->getMCIN();
     if (!cells)
     {
@@ -1113,7 +1204,10 @@ bool ConvertADT(char* filename, char* filename2, uint32 build)
         }
     }
 
+    convert.Stop();
+
     // Ok all data prepared - store it
+    BenchmarkTimer write("write");
     FILE* output = fopen(filename2, "wb");
     if (!output)
     {
@@ -1172,17 +1266,126 @@ bool ConvertADT(char* filename, char* filename2, uint32 build)
 
     fclose(output);
 
+    if (adtManifest)
+    {
+        adtManifest->Update(filename2, hash);
+    }
+
     return true;
 }
 
 /**
- * @brief
+ * @brief ADT files of one map, shared by the threads converting them
  *
+ * The archives are only read by ReadADTFiles, which stays up to window files ahead
+ * of the converting threads so they do not wait for the decompression.
  */
-void ExtractMapsFromMpq(uint32 build)
+struct ADTConvertQueue
+{
+    map_id const* map;
+    uint32 build;
+    std::vector<std::pair<uint32, uint32> > tiles;  /**< x, y */
+    std::vector<ADT_file*> files;                   /**< read tiles not taken yet, NULL if the file could not be loaded */
+    uint32 read;                                    /**< tiles before this one are in files */
+    uint32 next;                                    /**< next tile a converting thread takes */
+    uint32 window;
+    std::mutex lock;                                /**< guards files, read and next */
+    std::condition_variable changed;
+    std::atomic<uint32> done;
+};
+
+/**
+ * @brief reads the ADT files of the queue in order
+ *
+ * @param queue
+ */
+void ReadADTFiles(ADTConvertQueue* queue)
+{
+    char mpq_filename[1024];
+    uint32 count = uint32(queue->tiles.size());
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        {
+            std::unique_lock<std::mutex> guard(queue->lock);
+            queue->changed.wait(guard, [queue, i]() { return i < queue->next + queue->window; });
+        }
+
+        sprintf(mpq_filename, "World\\Maps\\%s\\%s_%u_%u.adt", queue->map->name, queue->map->name, queue->tiles[i].first, queue->tiles[i].second);
+
+        ADT_file* adt = new ADT_file();
+        {
+            BenchmarkTimer read("mpq_read");
+            if (!adt->loadFile(mpq_filename))
+            {
+                delete adt;
+                adt = NULL;
+            }
+        }
+
+        std::lock_guard<std::mutex> guard(queue->lock);
+        queue->files[i] = adt;
+        queue->read = i + 1;
+        queue->changed.notify_all();
+    }
+}
+
+/**
+ * @brief converts tiles taken from the queue until it is empty, each tile
+ * is a separate output file so the order does not change the result
+ *
+ * @param queue
+ */
+void ConvertADTWorker(ADTConvertQueue* queue)
 {
     char mpq_filename[1024];
     char output_filename[1024];
+    ADTConvertBuffers* buffers = new ADTConvertBuffers();
+    uint32 count = uint32(queue->tiles.size());
+
+    for (;;)
+    {
+        uint32 i;
+        ADT_file* adt;
+        {
+            std::unique_lock<std::mutex> guard(queue->lock);
+            if (queue->next >= count)
+            {
+                break;
+            }
+
+            i = queue->next++;
+            queue->changed.notify_all();                    // the reader may go on
+            queue->changed.wait(guard, [queue, i]() { return i < queue->read; });
+
+            adt = queue->files[i];
+            queue->files[i] = NULL;
+        }
+
+        uint32 x = queue->tiles[i].first;
+        uint32 y = queue->tiles[i].second;
+        sprintf(mpq_filename, "World\\Maps\\%s\\%s_%u_%u.adt", queue->map->name, queue->map->name, x, y);
+        sprintf(output_filename, "%s/maps/%03u%02u%02u.map", output_path, queue->map->id, y, x);
+        if (adt)
+        {
+            ConvertADT(*adt, mpq_filename, output_filename, queue->build, *buffers);
+            delete adt;
+        }
+        ExtractBenchmark::AddTiles();
+
+        // draw progress bar
+        printf(" Processing........................%d%%\r", (100 * ++queue->done) / count);
+    }
+
+    delete buffers;
+}
+
+/**
+ * @brief
+ *
+ */
+void ExtractMapsFromMpq(uint32 build)
+{
     char mpq_map_name[1024];
 
     printf("\n Extracting maps...\n");
@@ -1196,9 +1399,31 @@ void ExtractMapsFromMpq(uint32 build)
     path += "/maps/";
     CreateDir(path);
 
+    // unchanged ADT files are only converted again when something else that ends up in the map files changed
+    convertSettingsHash = ExtractManifest::HashData(&build, sizeof(build));
+    convertSettingsHash = ExtractManifest::HashData(MAP_VERSION_MAGIC, sizeof(MAP_VERSION_MAGIC), convertSettingsHash);
+    convertSettingsHash = ExtractManifest::HashData(&CONF_allow_height_limit, sizeof(CONF_allow_height_limit), convertSettingsHash);
+    convertSettingsHash = ExtractManifest::HashData(&CONF_use_minHeight, sizeof(CONF_use_minHeight), convertSettingsHash);
+    convertSettingsHash = ExtractManifest::HashData(&CONF_allow_float_to_int, sizeof(CONF_allow_float_to_int), convertSettingsHash);
+    convertSettingsHash = ExtractManifest::HashData(&CONF_float_to_int8_limit, sizeof(CONF_float_to_int8_limit), convertSettingsHash);
+    convertSettingsHash = ExtractManifest::HashData(&CONF_float_to_int16_limit, sizeof(CONF_float_to_int16_limit), convertSettingsHash);
+    convertSettingsHash = ExtractManifest::HashData(&CONF_flat_height_delta_limit, sizeof(CONF_flat_height_delta_limit), convertSettingsHash);
+    convertSettingsHash = ExtractManifest::HashData(&CONF_flat_liquid_delta_limit, sizeof(CONF_flat_liquid_delta_limit), convertSettingsHash);
+    convertSettingsHash = ExtractManifest::HashData(areas, (maxAreaId + 1) * sizeof(uint16), convertSettingsHash);
+    convertSettingsHash = ExtractManifest::HashData(LiqType, (maxLiqTypeId + 1) * sizeof(uint16), convertSettingsHash);
+
+    // a benchmark converts everything, the manifest would skip it all the second time
+    ExtractManifest manifest(std::string(output_path) + "/maps.manifest");
+    adtManifest = ExtractBenchmark::IsEnabled() ? NULL : &manifest;
+
     printf("\n Converting map files\n");
     for (uint32 z = 0; z < map_count; ++z)
     {
+        if (CONF_map >= 0 && map_ids[z].id != uint32(CONF_map))
+        {
+            continue;
+        }
+
         printf(" Extract %s (%d/%d)                      \n", map_ids[z].name, z + 1, map_count);
         // Loadup map grid data
         sprintf(mpq_map_name, "World\\Maps\\%s\\%s.wdt", map_ids[z].name, map_ids[z].name);
@@ -1209,22 +1434,43 @@ void ExtractMapsFromMpq(uint32 build)
             continue;
         }
 
+        ADTConvertQueue queue;
+        queue.map = &map_ids[z];
+        queue.build = build;
+        queue.read = 0;
+        queue.next = 0;
+        queue.window = 2 * CONF_threads;
+        queue.done = 0;
+
         for (uint32 y = 0; y < WDT_MAP_SIZE; ++y)
         {
             for (uint32 x = 0; x < WDT_MAP_SIZE; ++x)
             {
-                if (!wdt.main->adt_list[y][x].exist)
+                if (wdt.main->adt_list[y][x].exist && (CONF_tiles.empty() || CONF_tiles.count(std::pair<uint32, uint32>(x, y))))
                 {
-                    continue;
+                    queue.tiles.push_back(std::pair<uint32, uint32>(x, y));
                 }
-                sprintf(mpq_filename, "World\\Maps\\%s\\%s_%u_%u.adt", map_ids[z].name, map_ids[z].name, x, y);
-                sprintf(output_filename, "%s/maps/%03u%02u%02u.map", output_path, map_ids[z].id, y, x);
-                ConvertADT(mpq_filename, output_filename, build);// , y, x);
             }
-            // draw progress bar
-            printf(" Processing........................%d%%\r", (100 * (y + 1)) / WDT_MAP_SIZE);
+        }
+
+        queue.files.resize(queue.tiles.size(), NULL);
+
+        // the calling thread converts too
+        std::vector<std::thread> threads;
+        threads.push_back(std::thread(ReadADTFiles, &queue));
+        for (int i = 1; i < CONF_threads && i < int(queue.tiles.size()); ++i)
+        {
+            threads.push_back(std::thread(ConvertADTWorker, &queue));
+        }
+
+        ConvertADTWorker(&queue);
+
+        for (uint32 i = 0; i < threads.size(); ++i)
+        {
+            threads[i].join();
         }
     }
+    adtManifest = NULL;
     delete [] areas;
     delete [] map_ids;
 }
@@ -1670,5 +1916,7 @@ int main(int argc, char** argv)
             }
             break;
     }
+
+    ExtractBenchmark::WriteReport();
     return 0;
 }
@@ -31,8 +31,11 @@
 
 #ifdef WIN32
 #include <direct.h>
+#include <windows.h>
+#include <psapi.h>
 #else
 #include <sys/stat.h>
+#include <sys/resource.h>
 #endif
 
 #include <fcntl.h>
@@ -456,6 +459,210 @@ bool ClientFileExists(const char* sFileName)
     return false;
 }
 
+/**************************************************************************/
+ExtractManifest::ExtractManifest(const std::string& path) : m_path(path), m_file(NULL)
+{
+    if (FILE* file = fopen(path.c_str(), "r"))
+    {
+        char line[1024];
+        unsigned long long hash;
+        int nameStart;
+        while (fgets(line, sizeof(line), file))
+        {
+            line[strcspn(line, "\r\n")] = 0;
+            if (sscanf(line, "%llx %n", &hash, &nameStart) == 1 && line[nameStart])
+            {
+                m_hashes[line + nameStart] = hash;          // later lines replace earlier ones
+            }
+        }
+        fclose(file);
+    }
+
+    // rewrite it compacted, then append the changes of this run
+    m_file = fopen(path.c_str(), "w");
+    if (!m_file)
+    {
+        printf("Can not write %s, the next run will rebuild everything\n", path.c_str());
+        return;
+    }
+
+    for (std::map<std::string, uint64>::const_iterator itr = m_hashes.begin(); itr != m_hashes.end(); ++itr)
+    {
+        fprintf(m_file, "%016llx %s\n", (unsigned long long)itr->second, itr->first.c_str());
+    }
+    fflush(m_file);
+}
+
+ExtractManifest::~ExtractManifest()
+{
+    if (m_file)
+    {
+        fclose(m_file);
+    }
+}
+
+bool ExtractManifest::IsUpToDate(const std::string& output, uint64 hash)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        std::map<std::string, uint64>::const_iterator itr = m_hashes.find(output);
+        if (itr == m_hashes.end() || itr->second != hash)
+        {
+            return false;
+        }
+    }
+
+    return ClientFileExists(output.c_str());
+}
+
+bool ExtractManifest::Contains(const std::string& output)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_hashes.find(output) != m_hashes.end();
+}
+
+void ExtractManifest::Update(const std::string& output, uint64 hash)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_hashes[output] = hash;
+
+    if (m_file)
+    {
+        fprintf(m_file, "%016llx %s\n", (unsigned long long)hash, output.c_str());
+        fflush(m_file);
+    }
+}
+
+uint64 ExtractManifest::HashData(const void* data, size_t size, uint64 hash)
+{
+    // FNV-1a, only used to notice changes
+    const uint8* bytes = static_cast<const uint8*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool ExtractManifest::HashFile(const std::string& filename, uint64& hash)
+{
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    uint8 buffer[64 * 1024];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        hash = HashData(buffer, count, hash);
+    }
+    fclose(file);
+    return true;
+}
+
+/**************************************************************************/
+bool ExtractBenchmark::s_enabled = false;
+std::string ExtractBenchmark::s_tool;
+std::string ExtractBenchmark::s_reportFile;
+std::chrono::steady_clock::time_point ExtractBenchmark::s_start;
+std::map<std::string, ExtractBenchmark::StageTime> ExtractBenchmark::s_stages;
+uint64 ExtractBenchmark::s_tiles = 0;
+std::mutex ExtractBenchmark::s_lock;
+
+void ExtractBenchmark::Enable(const char* tool, const char* reportFile)
+{
+    s_tool = tool;
+    s_reportFile = reportFile;
+    s_start = std::chrono::steady_clock::now();
+    s_enabled = true;
+}
+
+void ExtractBenchmark::AddTime(const char* stage, double seconds)
+{
+    if (!s_enabled)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(s_lock);
+    StageTime& time = s_stages[stage];
+    time.seconds += seconds;
+    ++time.calls;
+}
+
+void ExtractBenchmark::AddTiles(uint32 count)
+{
+    if (!s_enabled)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(s_lock);
+    s_tiles += count;
+}
+
+bool ExtractBenchmark::WriteReport()
+{
+    if (!s_enabled)
+    {
+        return true;
+    }
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - s_start).count();
+
+    FILE* report = fopen(s_reportFile.c_str(), "w");
+    if (!report)
+    {
+        printf("Can not write the benchmark report %s\n", s_reportFile.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(s_lock);
+
+    fprintf(report, "{\n");
+    fprintf(report, "    \"tool\": \"%s\",\n", s_tool.c_str());
+    fprintf(report, "    \"wall_seconds\": %.3f,\n", wall);
+    fprintf(report, "    \"tiles\": %llu,\n", (unsigned long long)s_tiles);
+    fprintf(report, "    \"tiles_per_second\": %.3f,\n", wall > 0.0 ? s_tiles / wall : 0.0);
+    fprintf(report, "    \"peak_rss_kb\": %llu,\n", (unsigned long long)GetPeakRSS());
+    fprintf(report, "    \"stages\": {");
+    for (std::map<std::string, StageTime>::const_iterator itr = s_stages.begin(); itr != s_stages.end(); ++itr)
+    {
+        fprintf(report, "%s\n        \"%s\": { \"seconds\": %.3f, \"calls\": %llu }", itr == s_stages.begin() ? "" : ",",
+                itr->first.c_str(), itr->second.seconds, (unsigned long long)itr->second.calls);
+    }
+    fprintf(report, "\n    }\n}\n");
+    fclose(report);
+
+    printf(" Benchmark report written to %s\n", s_reportFile.c_str());
+    return true;
+}
+
+uint64 ExtractBenchmark::GetPeakRSS()
+{
+#if defined(WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.PeakWorkingSetSize / 1024;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;                          // bytes on OS X
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
 /**************************************************************************/
 bool isTransportMap(int mapID)
 {
@@ -22,10 +22,16 @@
  * and lore are copyrighted by Blizzard Entertainment, Inc.
  */
 
+#ifndef MANGOS_H_EXTRACTOR_COMMON
+#define MANGOS_H_EXTRACTOR_COMMON
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <iostream>
 #include <sstream>
+#include <map>
+#include <mutex>
+#include <chrono>
 #include "loadlib.h"
 
 FILE* openWoWExe(char const* path = NULL);
@@ -58,4 +64,121 @@ enum CoreNumber
     CLIENT_MOP = 4,
     CLIENT_WOD = 5,
     CLIENT_LEGION = 6
-};
\ No newline at end of file
+};
+
+/**
+ * @brief Content hash of the inputs each output file of a tool was built from,
+ * so a later run only rebuilds the outputs whose inputs changed
+ *
+ * Updates are appended to the file right away, an interrupted run keeps what it finished.
+ */
+class ExtractManifest
+{
+    public:
+        explicit ExtractManifest(const std::string& path);
+        ~ExtractManifest();
+
+        /**
+         * @brief the output exists and was built from inputs with this hash
+         */
+        bool IsUpToDate(const std::string& output, uint64 hash);
+        /**
+         * @brief an earlier run recorded a hash for the output
+         */
+        bool Contains(const std::string& output);
+        /**
+         * @brief records the hash the output was just built from, thread safe
+         */
+        void Update(const std::string& output, uint64 hash);
+
+        static uint64 HashData(const void* data, size_t size, uint64 hash = 14695981039346656037ULL);
+        /**
+         * @brief hashes the file into hash, a missing file leaves it unchanged
+         *
+         * @return bool false if the file could not be read
+         */
+        static bool HashFile(const std::string& filename, uint64& hash);
+
+    private:
+        std::string m_path;
+        std::map<std::string, uint64> m_hashes;
+        FILE* m_file;
+        std::mutex m_lock;
+};
+
+/**
+ * @brief Sums the time spent in each stage of a benchmark run and writes it with
+ * the processed tiles and the peak memory as JSON
+ *
+ * Nothing is collected unless Enable() was called. Stage times of several threads
+ * add up, compare them against wall_seconds with that in mind.
+ */
+class ExtractBenchmark
+{
+    public:
+        static void Enable(const char* tool, const char* reportFile);
+        static bool IsEnabled() { return s_enabled; }
+
+        static void AddTime(const char* stage, double seconds);
+        static void AddTiles(uint32 count = 1);
+
+        /**
+         * @brief writes the report if benchmarking was enabled
+         *
+         * @return bool false if the report could not be written
+         */
+        static bool WriteReport();
+
+        /**
+         * @brief peak resident set size of the process in kB, 0 when unknown
+         */
+        static uint64 GetPeakRSS();
+
+    private:
+        struct StageTime
+        {
+            StageTime() : seconds(0.0), calls(0) {}
+            double seconds;
+            uint64 calls;
+        };
+
+        static bool s_enabled;
+        static std::string s_tool;
+        static std::string s_reportFile;
+        static std::chrono::steady_clock::time_point s_start;
+        static std::map<std::string, StageTime> s_stages;
+        static uint64 s_tiles;
+        static std::mutex s_lock;
+};
+
+/**
+ * @brief Adds the time until Stop() or the end of its scope to a benchmark stage
+ */
+class BenchmarkTimer
+{
+    public:
+        explicit BenchmarkTimer(const char* stage) : m_stage(stage), m_running(ExtractBenchmark::IsEnabled())
+        {
+            if (m_running)
+            {
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+        ~BenchmarkTimer() { Stop(); }
+
+        void Stop()
+        {
+            if (m_running)
+            {
+                m_running = false;
+                ExtractBenchmark::AddTime(m_stage, std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count());
+            }
+        }
+
+    private:
+        const char* m_stage;
+        bool m_running;
+        std::chrono::steady_clock::time_point m_start;
+};
+
+#endif
\ No newline at end of file
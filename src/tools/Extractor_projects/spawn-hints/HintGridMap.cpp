@@ -0,0 +1,302 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "HintGridMap.h"
+
+static char const* MAP_MAGIC         = "MAPS";
+static char const* MAP_AREA_MAGIC    = "AREA";
+static char const* MAP_HEIGHT_MAGIC  = "MHGT";
+static char const* MAP_LIQUID_MAGIC  = "MLIQ";
+
+static uint16 holetab_h[4] = { 0x1111, 0x2222, 0x4444, 0x8888 };
+static uint16 holetab_v[4] = { 0x000F, 0x00F0, 0x0F00, 0xF000 };
+
+template<typename T>
+static T* readArray(FILE* in, size_t count)
+{
+    T* data = new T[count];
+    if (fread(data, sizeof(T), count, in) != count)
+    {
+        delete[] data;
+        return NULL;
+    }
+    return data;
+}
+
+// integer heights are steps between the lowest and highest point of the grid
+template<typename T>
+static float* readIntHeights(FILE* in, size_t count, float base, float multiplier)
+{
+    T* values = readArray<T>(in, count);
+    if (!values)
+    {
+        return NULL;
+    }
+
+    float* heights = new float[count];
+    for (size_t i = 0; i < count; ++i)
+    {
+        heights[i] = values[i] * multiplier + base;
+    }
+    delete[] values;
+    return heights;
+}
+
+HintGridMap::HintGridMap() : m_gridArea(0), m_area_map(NULL), m_gridHeight(INVALID_HEIGHT_VALUE), m_floatHeights(false), m_V9(NULL), m_V8(NULL),
+    m_liquidType(0), m_liquid_offX(0), m_liquid_offY(0), m_liquid_width(0), m_liquid_height(0),
+    m_liquidLevel(INVALID_HEIGHT_VALUE), m_liquidEntry(NULL), m_liquidFlags(NULL), m_liquid_map(NULL)
+{
+    memset(m_holes, 0, sizeof(m_holes));
+}
+
+HintGridMap::~HintGridMap()
+{
+    delete[] m_area_map;
+    delete[] m_V9;
+    delete[] m_V8;
+    delete[] m_liquidEntry;
+    delete[] m_liquidFlags;
+    delete[] m_liquid_map;
+}
+
+bool HintGridMap::loadData(char const* filename, uint32& versionMagic)
+{
+    FILE* in = fopen(filename, "rb");
+    if (!in)
+    {
+        return true;
+    }
+
+    GridMapFileHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 || header.mapMagic != *((uint32 const*)(MAP_MAGIC)))
+    {
+        fclose(in);
+        return false;
+    }
+
+    versionMagic = header.versionMagic;
+    bool ok = true;
+
+    if (header.areaMapOffset)
+    {
+        GridMapAreaHeader areaHeader;
+        ok = fseek(in, header.areaMapOffset, SEEK_SET) == 0 && fread(&areaHeader, sizeof(areaHeader), 1, in) == 1 &&
+             areaHeader.fourcc == *((uint32 const*)(MAP_AREA_MAGIC));
+        if (ok)
+        {
+            m_gridArea = areaHeader.gridArea;
+            if (!(areaHeader.flags & MAP_AREA_NO_AREA))
+            {
+                ok = (m_area_map = readArray<uint16>(in, 16 * 16)) != NULL;
+            }
+        }
+    }
+
+    if (ok && header.holesOffset)
+    {
+        ok = fseek(in, header.holesOffset, SEEK_SET) == 0 && fread(&m_holes, sizeof(m_holes), 1, in) == 1;
+    }
+
+    if (ok && header.heightMapOffset)
+    {
+        GridMapHeightHeader heightHeader;
+        ok = fseek(in, header.heightMapOffset, SEEK_SET) == 0 && fread(&heightHeader, sizeof(heightHeader), 1, in) == 1 &&
+             heightHeader.fourcc == *((uint32 const*)(MAP_HEIGHT_MAGIC));
+        if (ok)
+        {
+            m_gridHeight = heightHeader.gridHeight;
+            if (heightHeader.flags & MAP_HEIGHT_NO_HEIGHT)
+            {
+                // flat grid
+            }
+            else if (heightHeader.flags & MAP_HEIGHT_AS_INT16)
+            {
+                float multiplier = (heightHeader.gridMaxHeight - heightHeader.gridHeight) / 65535;
+                m_V9 = readIntHeights<uint16>(in, 129 * 129, m_gridHeight, multiplier);
+                m_V8 = readIntHeights<uint16>(in, 128 * 128, m_gridHeight, multiplier);
+                ok = m_V9 && m_V8;
+            }
+            else if (heightHeader.flags & MAP_HEIGHT_AS_INT8)
+            {
+                float multiplier = (heightHeader.gridMaxHeight - heightHeader.gridHeight) / 255;
+                m_V9 = readIntHeights<uint8>(in, 129 * 129, m_gridHeight, multiplier);
+                m_V8 = readIntHeights<uint8>(in, 128 * 128, m_gridHeight, multiplier);
+                ok = m_V9 && m_V8;
+            }
+            else
+            {
+                m_V9 = readArray<float>(in, 129 * 129);
+                m_V8 = readArray<float>(in, 128 * 128);
+                m_floatHeights = true;
+                ok = m_V9 && m_V8;
+            }
+        }
+    }
+
+    if (ok && header.liquidMapOffset)
+    {
+        GridMapLiquidHeader liquidHeader;
+        ok = fseek(in, header.liquidMapOffset, SEEK_SET) == 0 && fread(&liquidHeader, sizeof(liquidHeader), 1, in) == 1 &&
+             liquidHeader.fourcc == *((uint32 const*)(MAP_LIQUID_MAGIC));
+        if (ok)
+        {
+            m_liquidType    = liquidHeader.liquidType;
+            m_liquid_offX   = liquidHeader.offsetX;
+            m_liquid_offY   = liquidHeader.offsetY;
+            m_liquid_width  = liquidHeader.width;
+            m_liquid_height = liquidHeader.height;
+            m_liquidLevel   = liquidHeader.liquidLevel;
+
+            if (!(liquidHeader.flags & MAP_LIQUID_NO_TYPE))
+            {
+                m_liquidEntry = readArray<uint16>(in, 16 * 16);
+                m_liquidFlags = readArray<uint8>(in, 16 * 16);
+                ok = m_liquidEntry && m_liquidFlags;
+            }
+
+            if (ok && !(liquidHeader.flags & MAP_LIQUID_NO_HEIGHT))
+            {
+                ok = (m_liquid_map = readArray<float>(in, m_liquid_width * m_liquid_height)) != NULL;
+            }
+        }
+    }
+
+    fclose(in);
+    return ok;
+}
+
+uint16 HintGridMap::getArea(float x, float y) const
+{
+    if (!m_area_map)
+    {
+        return m_gridArea;
+    }
+
+    x = 16 * (32 - x / SIZE_OF_GRIDS);
+    y = 16 * (32 - y / SIZE_OF_GRIDS);
+    int lx = (int)x & 15;
+    int ly = (int)y & 15;
+    return m_area_map[lx * 16 + ly];
+}
+
+bool HintGridMap::isHole(int row, int col) const
+{
+    int cellRow = row / 8;     // 8 squares per cell
+    int cellCol = col / 8;
+    int holeRow = row % 8 / 2;
+    int holeCol = (col - (cellCol * 8)) / 2;
+
+    uint16 hole = m_holes[cellRow][cellCol];
+
+    return (hole & holetab_h[holeCol] & holetab_v[holeRow]) != 0;
+}
+
+float HintGridMap::getHeight(float x, float y) const
+{
+    if (!m_V8 || !m_V9)
+    {
+        return m_gridHeight;
+    }
+
+    x = MAP_RESOLUTION * (32 - x / SIZE_OF_GRIDS);
+    y = MAP_RESOLUTION * (32 - y / SIZE_OF_GRIDS);
+
+    int x_int = (int)x;
+    int y_int = (int)y;
+    x -= x_int;
+    y -= y_int;
+    x_int &= (MAP_RESOLUTION - 1);
+    y_int &= (MAP_RESOLUTION - 1);
+
+    if (m_floatHeights && isHole(x_int, y_int))
+    {
+        return INVALID_HEIGHT_VALUE;
+    }
+
+    // see GridMap::getHeightFromFloat for the triangles, h5 is the v8 point in the middle
+    float h1 = m_V9[x_int * 129 + y_int];
+    float h2 = m_V9[(x_int + 1) * 129 + y_int];
+    float h3 = m_V9[x_int * 129 + y_int + 1];
+    float h4 = m_V9[(x_int + 1) * 129 + y_int + 1];
+    float h5 = 2 * m_V8[x_int * 128 + y_int];
+
+    if (x + y < 1)
+    {
+        if (x > y)
+        {
+            return (h2 - h1) * x + (h5 - h1 - h2) * y + h1;
+        }
+        return (h5 - h1 - h3) * x + (h3 - h1) * y + h1;
+    }
+
+    if (x > y)
+    {
+        return (h2 + h4 - h5) * x + (h4 - h2) * y + h5 - h4;
+    }
+    return (h4 - h3) * x + (h3 + h4 - h5) * y + h5 - h4;
+}
+
+bool HintGridMap::getLiquid(float x, float y, float z, float& level, float& ground) const
+{
+    if (!m_liquidFlags && !m_liquidType)
+    {
+        return false;
+    }
+
+    float cx = MAP_RESOLUTION * (32 - x / SIZE_OF_GRIDS);
+    float cy = MAP_RESOLUTION * (32 - y / SIZE_OF_GRIDS);
+
+    int x_int = (int)cx & (MAP_RESOLUTION - 1);
+    int y_int = (int)cy & (MAP_RESOLUTION - 1);
+
+    // the server replaces the type by the one of the LiquidType.dbc entry, which is
+    // always one of the basic liquids, so any entry counts as liquid here
+    int idx = (x_int >> 3) * 16 + (y_int >> 3);
+    uint8 type = m_liquidFlags ? m_liquidFlags[idx] : 1 << m_liquidType;
+    if (!(type & MAP_ALL_LIQUIDS) && !(m_liquidEntry && m_liquidEntry[idx]))
+    {
+        return false;
+    }
+
+    int lx_int = x_int - m_liquid_offY;
+    if (lx_int < 0 || lx_int >= m_liquid_height)
+    {
+        return false;
+    }
+
+    int ly_int = y_int - m_liquid_offX;
+    if (ly_int < 0 || ly_int >= m_liquid_width)
+    {
+        return false;
+    }
+
+    level = m_liquid_map ? m_liquid_map[lx_int * m_liquid_width + ly_int] : m_liquidLevel;
+    ground = getHeight(x, y);
+
+    return level >= ground && z >= ground - 2;
+}
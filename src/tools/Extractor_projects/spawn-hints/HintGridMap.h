@@ -0,0 +1,142 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_H_SPAWN_HINTS_GRIDMAP
+#define MANGOS_H_SPAWN_HINTS_GRIDMAP
+
+#include "Platform/Define.h"
+
+// following is copied from src/game/WorldHandlers/GridMap.h (too many useless includes there to use original file)
+#define MAX_NUMBER_OF_GRIDS       64
+#define SIZE_OF_GRIDS             533.33333f
+#define MAP_RESOLUTION            128
+
+#define INVALID_HEIGHT            -100000.0f
+#define INVALID_HEIGHT_VALUE      -200000.0f
+#define DEFAULT_HEIGHT_SEARCH     10.0f
+#define DEFAULT_WATER_SEARCH      50.0f
+
+struct GridMapFileHeader
+{
+    uint32 mapMagic;
+    uint32 versionMagic;
+    uint32 buildMagic;
+    uint32 areaMapOffset;
+    uint32 areaMapSize;
+    uint32 heightMapOffset;
+    uint32 heightMapSize;
+    uint32 liquidMapOffset;
+    uint32 liquidMapSize;
+    uint32 holesOffset;
+    uint32 holesSize;
+};
+
+#define MAP_AREA_NO_AREA      0x0001
+
+struct GridMapAreaHeader
+{
+    uint32 fourcc;
+    uint16 flags;
+    uint16 gridArea;
+};
+
+#define MAP_HEIGHT_NO_HEIGHT  0x0001
+#define MAP_HEIGHT_AS_INT16   0x0002
+#define MAP_HEIGHT_AS_INT8    0x0004
+
+struct GridMapHeightHeader
+{
+    uint32 fourcc;
+    uint32 flags;
+    float gridHeight;
+    float gridMaxHeight;
+};
+
+#define MAP_LIQUID_NO_TYPE    0x0001
+#define MAP_LIQUID_NO_HEIGHT  0x0002
+
+struct GridMapLiquidHeader
+{
+    uint32 fourcc;
+    uint16 flags;
+    uint16 liquidType;
+    uint8 offsetX;
+    uint8 offsetY;
+    uint8 width;
+    uint8 height;
+    float liquidLevel;
+};
+
+#define MAP_LIQUID_TYPE_MAGMA       0x01
+#define MAP_LIQUID_TYPE_OCEAN       0x02
+#define MAP_LIQUID_TYPE_SLIME       0x04
+#define MAP_LIQUID_TYPE_WATER       0x08
+
+#define MAP_ALL_LIQUIDS   (MAP_LIQUID_TYPE_WATER | MAP_LIQUID_TYPE_MAGMA | MAP_LIQUID_TYPE_OCEAN | MAP_LIQUID_TYPE_SLIME)
+
+/**
+ * @brief the parts of the server's GridMap the spawn hints need, integer heights are
+ * expanded to floats on load
+ *
+ */
+class HintGridMap
+{
+    public:
+        HintGridMap();
+        ~HintGridMap();
+
+        /// a missing file leaves an empty grid like on the server, false for broken files
+        bool loadData(char const* filename, uint32& versionMagic);
+
+        uint16 getArea(float x, float y) const;
+        float getHeight(float x, float y) const;
+        /// liquid level and the ground below it, false when the point is not in liquid
+        bool getLiquid(float x, float y, float z, float& level, float& ground) const;
+
+    private:
+        bool isHole(int row, int col) const;
+
+        uint16 m_holes[16][16];
+
+        uint16 m_gridArea;
+        uint16* m_area_map;
+
+        float m_gridHeight;
+        bool m_floatHeights;                                // only float height maps honour holes on the server
+        float* m_V9;
+        float* m_V8;
+
+        uint16 m_liquidType;
+        uint8 m_liquid_offX;
+        uint8 m_liquid_offY;
+        uint8 m_liquid_width;
+        uint8 m_liquid_height;
+        float m_liquidLevel;
+        uint16* m_liquidEntry;
+        uint8* m_liquidFlags;
+        float* m_liquid_map;
+};
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_H_SPAWN_HINTS
+#define MANGOS_H_SPAWN_HINTS
+
+#include "Platform/Define.h"
+
+// must match the reader in ObjectMgr::LoadCreatureSpawnHints()
+#define SPAWN_HINTS_MAGIC           "SPHT"
+#define SPAWN_HINTS_VERSION_MAGIC   "h1.0"
+
+struct SpawnHintsFileHeader
+{
+    uint32 magic;
+    uint32 versionMagic;
+    uint32 mapVersionMagic;                                 // of the .map files the hints were computed from
+    uint32 count;
+};
+
+#define SPAWN_HINT_AREA_INFO        0x0001                  // inside a WMO, the area comes from WMOAreaTable
+#define SPAWN_HINT_LIQUID           0x0002
+
+struct SpawnHintRecord
+{
+    uint32 guid;
+    uint32 mapId;
+    float x;                                                // position the hint was computed for
+    float y;
+    float z;
+    float groundZ;                                          // .map height, GetHeightStatic() without vmaps
+    float liquidLevel;                                      // liquid the spawn point is in, with SPAWN_HINT_LIQUID
+    float liquidGround;
+    uint32 mogpFlags;                                       // WMO group the spawn point is in, with SPAWN_HINT_AREA_INFO
+    int32 adtId;
+    int32 rootId;
+    int32 groupId;
+    uint16 gridArea;                                        // area flag of the .map file
+    uint16 flags;
+};
+
+#endif
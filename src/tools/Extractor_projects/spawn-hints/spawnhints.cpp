@@ -0,0 +1,354 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "VMapManager2.h"
+#include "HintGridMap.h"
+#include "SpawnHints.h"
+
+struct Spawn
+{
+    uint32 guid;
+    uint32 mapId;
+    float x;
+    float y;
+    float z;
+    uint32 grid;
+
+    bool operator<(Spawn const& other) const
+    {
+        return mapId != other.mapId ? mapId < other.mapId : grid < other.grid;
+    }
+};
+
+// the server applies its vmap disables when loading the hints
+static bool NoVMapDisabled(uint32 /*entry*/, uint8 /*flags*/)
+{
+    return false;
+}
+
+void printUsage(char* prg)
+{
+    printf(" Usage: %s [OPTION]\n\n", prg);
+    printf(" Precompute ground height, area and liquid of creature spawns for the server.\n");
+    printf("   -h, --help                        show the usage\n");
+    printf("   -i, --input <file>                spawn list, one 'guid map x y z' per line\n");
+    printf("                                     (default creature_spawns.txt)\n");
+    printf("   -o, --output <file>               hints file (default spawnhints.dat)\n");
+    printf("   -d, --data <path>                 folder with the maps and vmaps folders\n");
+    printf("                                     (default .)\n");
+    printf("\n");
+    printf(" Example:\n");
+    printf("   mysql -N -B -e \"SELECT guid, map, position_x, position_y, position_z FROM creature\" mangos0 > creature_spawns.txt\n");
+    printf("   %s -i creature_spawns.txt\n", prg);
+}
+
+bool handleArgs(int argc, char** argv, char const*& input, char const*& output, std::string& dataPath)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) && i + 1 < argc)
+        {
+            input = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--data") == 0) && i + 1 < argc)
+        {
+            dataPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+        {
+            printUsage(argv[0]);
+            exit(1);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if (!dataPath.empty() && dataPath[dataPath.size() - 1] != '/' && dataPath[dataPath.size() - 1] != '\\')
+    {
+        dataPath += '/';
+    }
+    return true;
+}
+
+bool readSpawns(char const* input, std::vector<Spawn>& spawns)
+{
+    FILE* in = fopen(input, "r");
+    if (!in)
+    {
+        printf(" Can't open the spawn list %s\n", input);
+        return false;
+    }
+
+    char line[256];
+    uint32 lineNumber = 0;
+    while (fgets(line, sizeof(line), in))
+    {
+        ++lineNumber;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+        {
+            continue;
+        }
+
+        Spawn spawn;
+        if (sscanf(line, "%u %u %f %f %f", &spawn.guid, &spawn.mapId, &spawn.x, &spawn.y, &spawn.z) != 5)
+        {
+            printf(" Skipping malformed line %u of %s\n", lineNumber, input);
+            continue;
+        }
+
+        int gx = int(32 - spawn.x / SIZE_OF_GRIDS);
+        int gy = int(32 - spawn.y / SIZE_OF_GRIDS);
+        if (gx < 0 || gx >= MAX_NUMBER_OF_GRIDS || gy < 0 || gy >= MAX_NUMBER_OF_GRIDS)
+        {
+            printf(" Skipping spawn %u outside of the map\n", spawn.guid);
+            continue;
+        }
+
+        spawn.grid = uint32(gx * MAX_NUMBER_OF_GRIDS + gy);
+        spawns.push_back(spawn);
+    }
+
+    fclose(in);
+    return true;
+}
+
+// same as TerrainInfo::SelectStaticHeight() with vmap height enabled
+float selectStaticHeight(VMAP::VMapManager2& vmgr, uint32 mapId, float x, float y, float z, float mapHeight, float maxSearchDist)
+{
+    float z2 = z + 2.f;
+
+    if (mapHeight > INVALID_HEIGHT && z2 - mapHeight > maxSearchDist)
+    {
+        maxSearchDist = z2 - mapHeight + 1.0f;
+    }
+
+    float vmapHeight = vmgr.getHeight(mapId, x, y, z2, maxSearchDist);
+    if (vmapHeight <= INVALID_HEIGHT)
+    {
+        vmapHeight = vmgr.getHeight(mapId, x, y, z2, 10000.0f);
+    }
+
+    if (vmapHeight <= INVALID_HEIGHT && mapHeight > INVALID_HEIGHT && z2 < mapHeight)
+    {
+        vmapHeight = vmgr.getHeight(mapId, x, y, mapHeight + 2.0f, DEFAULT_HEIGHT_SEARCH);
+    }
+
+    if (vmapHeight > INVALID_HEIGHT)
+    {
+        if (mapHeight > INVALID_HEIGHT && z >= mapHeight && vmapHeight <= mapHeight)
+        {
+            return mapHeight;
+        }
+        return vmapHeight;
+    }
+
+    return mapHeight;
+}
+
+// the terrain queries Creature::LoadFromDB() and Creature::Create() make at the spawn point
+void computeHint(VMAP::VMapManager2& vmgr, HintGridMap const& grid, Spawn const& spawn, SpawnHintRecord& hint)
+{
+    memset(&hint, 0, sizeof(hint));
+    hint.guid = spawn.guid;
+    hint.mapId = spawn.mapId;
+    hint.x = spawn.x;
+    hint.y = spawn.y;
+    hint.z = spawn.z;
+
+    float mapHeight = grid.getHeight(spawn.x, spawn.y);
+    hint.groundZ = mapHeight;
+    hint.gridArea = grid.getArea(spawn.x, spawn.y);
+
+    // TerrainInfo::GetAreaInfo()
+    float vmapZ = spawn.z;
+    if (vmgr.getAreaInfo(spawn.mapId, spawn.x, spawn.y, vmapZ, hint.mogpFlags, hint.adtId, hint.rootId, hint.groupId) &&
+        !(spawn.z + 2.0f > mapHeight && mapHeight > vmapZ))
+    {
+        hint.flags |= SPAWN_HINT_AREA_INFO;
+    }
+    else
+    {
+        hint.mogpFlags = 0;
+        hint.adtId = hint.rootId = hint.groupId = 0;
+    }
+
+    // TerrainInfo::getLiquidStatus()
+    float ground = selectStaticHeight(vmgr, spawn.mapId, spawn.x, spawn.y, spawn.z, mapHeight, DEFAULT_WATER_SEARCH);
+    float level = INVALID_HEIGHT_VALUE;
+    uint32 liquidType = 0;
+    if (vmgr.GetLiquidLevel(spawn.mapId, spawn.x, spawn.y, spawn.z, MAP_ALL_LIQUIDS, level, ground, liquidType))
+    {
+        if (level > ground && spawn.z > ground - 2)
+        {
+            hint.flags |= SPAWN_HINT_LIQUID;
+            hint.liquidLevel = level;
+            hint.liquidGround = ground;
+        }
+    }
+    else
+    {
+        float mapLevel, mapGround;
+        if (grid.getLiquid(spawn.x, spawn.y, spawn.z, mapLevel, mapGround) && mapLevel > ground)
+        {
+            hint.flags |= SPAWN_HINT_LIQUID;
+            hint.liquidLevel = mapLevel;
+            hint.liquidGround = mapGround;
+        }
+    }
+}
+
+bool writeHints(char const* output, std::vector<SpawnHintRecord> const& hints, uint32 mapVersionMagic)
+{
+    FILE* out = fopen(output, "wb");
+    if (!out)
+    {
+        printf(" Can't create %s\n", output);
+        return false;
+    }
+
+    SpawnHintsFileHeader header;
+    header.magic = *((uint32 const*)(SPAWN_HINTS_MAGIC));
+    header.versionMagic = *((uint32 const*)(SPAWN_HINTS_VERSION_MAGIC));
+    header.mapVersionMagic = mapVersionMagic;
+    header.count = uint32(hints.size());
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              (hints.empty() || fwrite(&hints[0], sizeof(SpawnHintRecord), hints.size(), out) == hints.size());
+    fclose(out);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    char const* input = "creature_spawns.txt";
+    char const* output = "spawnhints.dat";
+    std::string dataPath;
+
+    if (!handleArgs(argc, argv, input, output, dataPath))
+    {
+        printf(" You have specified invalid parameters (use -h for more help)\n");
+        return -1;
+    }
+
+    std::vector<Spawn> spawns;
+    if (!readSpawns(input, spawns))
+    {
+        return -2;
+    }
+
+    std::sort(spawns.begin(), spawns.end());
+
+    VMAP::VMapManager2 vmgr;
+    vmgr.IsVMAPDisabledForPtr = &NoVMapDisabled;
+    vmgr.setEnableHeightCalc(true);
+
+    std::string vmapPath = dataPath + "vmaps";
+    std::vector<SpawnHintRecord> hints;
+    hints.reserve(spawns.size());
+    uint32 mapVersionMagic = 0;
+
+    for (size_t begin = 0; begin < spawns.size();)
+    {
+        uint32 mapId = spawns[begin].mapId;
+        uint32 grid = spawns[begin].grid;
+        size_t end = begin + 1;
+        while (end < spawns.size() && spawns[end].mapId == mapId && spawns[end].grid == grid)
+        {
+            ++end;
+        }
+
+        uint32 gx = grid / MAX_NUMBER_OF_GRIDS;
+        uint32 gy = grid % MAX_NUMBER_OF_GRIDS;
+
+        char filename[1024];
+        snprintf(filename, sizeof(filename), "%smaps/%03u%02u%02u.map", dataPath.c_str(), mapId, gx, gy);
+
+        HintGridMap gridMap;
+        uint32 versionMagic = 0;
+        if (!gridMap.loadData(filename, versionMagic))
+        {
+            printf(" Broken map file %s, skipping %u spawns\n", filename, uint32(end - begin));
+            begin = end;
+            continue;
+        }
+
+        if (versionMagic)
+        {
+            if (mapVersionMagic && versionMagic != mapVersionMagic)
+            {
+                printf(" Map file %s comes from another map-extractor version\n", filename);
+                return -3;
+            }
+            mapVersionMagic = versionMagic;
+        }
+
+        vmgr.loadMap(vmapPath.c_str(), mapId, gx, gy);
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            SpawnHintRecord hint;
+            computeHint(vmgr, gridMap, spawns[i], hint);
+            hints.push_back(hint);
+        }
+
+        vmgr.unloadMap(mapId, gx, gy);
+
+        if (end == spawns.size() || spawns[end].mapId != mapId)
+        {
+            printf(" Map %03u done, %u hints so far\n", mapId, uint32(hints.size()));
+        }
+        begin = end;
+    }
+
+    if (!mapVersionMagic)
+    {
+        printf(" No map files found in %smaps\n", dataPath.c_str());
+        return -3;
+    }
+
+    // the server looks the hints up by guid
+    std::sort(hints.begin(), hints.end(), [](SpawnHintRecord const& a, SpawnHintRecord const& b) { return a.guid < b.guid; });
+
+    if (!writeHints(output, hints, mapVersionMagic))
+    {
+        return -4;
+    }
+
+    printf(" Wrote %u spawn hints to %s\n", uint32(hints.size()), output);
+    return 0;
+}
@@ -23,18 +23,24 @@
  */
 
 #include "TileAssembler.h"
+#include "ExtractorCommon.h"
 #include <string>
 
-bool AssembleVMAP(std::string src, std::string dest, const char* szMagic)
+bool AssembleVMAP(std::string src, std::string dest, const char* szMagic, bool packFiles, unsigned int threads)
 {
     bool success = true;
     VMAP::TileAssembler* ta = new VMAP::TileAssembler(src, dest);
+    ta->setPackFiles(packFiles);
+    ta->setThreads(threads);
 
     if (!ta->convertWorld2(szMagic))
     {
         success = false;
     }
 
+    ExtractBenchmark::AddTime("bih_build", ta->getMapTreeSeconds());
+    ExtractBenchmark::AddTime("model_convert", ta->getModelSeconds());
+
     delete ta;
     return success;
 }
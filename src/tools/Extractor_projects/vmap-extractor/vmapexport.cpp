@@ -69,7 +69,7 @@
 #define MPQ_BLOCK_SIZE 0x1000
 //-----------------------------------------------------------------------------
 
-bool AssembleVMAP(std::string src, std::string dest, const char* szMagic);
+bool AssembleVMAP(std::string src, std::string dest, const char* szMagic, bool packFiles, unsigned int threads);
 extern ArchiveSet gOpenArchives;
 
 typedef struct
@@ -85,6 +85,9 @@ char output_path[128] = ".";
 char input_path[1024] = ".";
 bool hasInputPathParam = false;
 bool preciseVectorData = true;
+bool packVMapFiles = false;
+unsigned int assembleThreads = 1;
+int onlyMapId = -1;                 // -1 extracts the models placed on all maps
 int iCoreNumber;
 typedef std::pair < std::string /*full_filename*/, char const* /*locale_prefix*/ > UpdatesPair;
 typedef std::map < int /*build*/, UpdatesPair > Updates;
@@ -267,6 +270,11 @@ void ParseMapFiles(int iCoreNumber)
     printf("\n");
     for (unsigned int i = 0; i < map_count; ++i)
     {
+        if (onlyMapId >= 0 && map_ids[i].id != unsigned(onlyMapId))
+        {
+            continue;
+        }
+
         sprintf(id, "%03u", map_ids[i].id);
         sprintf(fn, "World\\Maps\\%s\\%s.wdt", map_ids[i].name, map_ids[i].name);
 
@@ -290,6 +298,7 @@ void ParseMapFiles(int iCoreNumber)
                         //sprintf(id_filename,"%02u %02u %03u",x,y,map_ids[i].id);//!!!!!!!!!
                         ADT->init(map_ids[i].id, x, y, failedPaths, iCoreNumber, szRawVMAPMagic);
                         delete ADT;
+                        ExtractBenchmark::AddTiles();
                     }
                 }
                 printf("#");
@@ -592,6 +601,12 @@ void Usage(char* prg)
     printf("   -i, --input <path>     search path for game client archives\n");
     printf("   -s, --small           extract smaller vmaps by optimizing data. Reduces\n");
     printf("                         size by ~ 500MB\n");
+    printf("   -c, --compress        write compressed vmap files, the server reads both\n");
+    printf("                         the compressed and the plain format\n");
+    printf("   -t, --threads #       number of threads converting models (default 1)\n");
+    printf("   -m, --map #           only extract the models placed on this map\n");
+    printf("   -b, --benchmark <file> write the time spent in each stage, tiles per\n");
+    printf("                         second and the peak memory to the file as JSON\n");
     printf("\n");
     printf(" Example:\n");
     printf(" - use data path and create larger vmaps:\n");
@@ -614,6 +629,47 @@ bool processArgv(int argc, char** argv)
         {
             result = true;
         }
+        else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--compress") == 0 )
+        {
+            result = true;
+            packVMapFiles = true;
+        }
+        else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0 )
+        {
+            param = argv[++i];
+            if (!param || atoi(param) <= 0)
+            {
+                result = false;
+                break;
+            }
+
+            result = true;
+            assembleThreads = atoi(param);
+        }
+        else if (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--map") == 0 )
+        {
+            param = argv[++i];
+            if (!param)
+            {
+                result = false;
+                break;
+            }
+
+            result = true;
+            onlyMapId = atoi(param);
+        }
+        else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--benchmark") == 0 )
+        {
+            param = argv[++i];
+            if (!param)
+            {
+                result = false;
+                break;
+            }
+
+            result = true;
+            ExtractBenchmark::Enable("vmap-extractor", param);
+        }
         else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0 )
         {
             param = argv[++i];
@@ -714,6 +770,7 @@ int main(int argc, char** argv)
     // extract data
     if (success)
     {
+        BenchmarkTimer timer("wmo_extract");
         success = ExtractWmo(iCoreNumber, szRawVMAPMagic);
     }
 
@@ -747,10 +804,13 @@ int main(int argc, char** argv)
         }
 
 
+        BenchmarkTimer parseTimer("adt_models");
         ParseMapFiles(iCoreNumber);
+        parseTimer.Stop();
         delete [] map_ids;
         //nError = ERROR_SUCCESS;
         // Extract models, listed in DameObjectDisplayInfo.dbc
+        BenchmarkTimer gameobjectTimer("gameobject_models");
         ExtractGameobjectModels(iCoreNumber, szRawVMAPMagic);
     }
 
@@ -763,7 +823,7 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    success = AssembleVMAP(std::string(szWorkDirWmo), outDir, szRawVMAPMagic);
+    success = AssembleVMAP(std::string(szWorkDirWmo), outDir, szRawVMAPMagic, packVMapFiles, assembleThreads);
 
     if (!success)
     {
@@ -775,5 +835,6 @@ int main(int argc, char** argv)
     printf("\n");
     printf(" VMAP building complete. No errors.\n");
 
+    ExtractBenchmark::WriteReport();
     return 0;
 }
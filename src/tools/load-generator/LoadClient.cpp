@@ -0,0 +1,984 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "LoadClient.h"
+#include "Auth/Sha1.h"
+#include "SharedDefines.h"
+#include "Util.h"
+
+#include <ace/INET_Addr.h>
+#include <ace/SOCK_Connector.h>
+#include <ace/os_include/netinet/os_tcp.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// realmd commands, see eAuthCmd in realmd/Auth/AuthCodes.h
+#define LOAD_CMD_AUTH_LOGON_CHALLENGE   0x00
+#define LOAD_CMD_AUTH_LOGON_PROOF       0x01
+#define LOAD_CMD_REALM_LIST             0x10
+
+#define LOAD_MOVEFLAG_FORWARD           0x00000001          // MOVEFLAG_FORWARD of Unit.h
+
+static const uint32 LOGIN_RETRY_DELAY = 2000;
+static const uint32 LOGIN_MAX_RETRIES = 3;
+static const uint32 MOVE_WAYPOINTS = 8;
+
+LoadClient::LoadClient(LoadSettings const& settings, uint32 index) : m_settings(settings), m_index(index),
+    m_state(STATE_IDLE), m_stateTime(0), m_retries(0), m_outputPos(0), m_haveHeader(false), m_packetSize(0), m_packetOpcode(0),
+    m_guid(0), m_mapId(0), m_x(0.0f), m_y(0.0f), m_z(0.0f), m_orientation(0.0f), m_centerX(0.0f), m_centerY(0.0f),
+    m_waypoint(0), m_lastStep(0), m_moving(false), m_teleportIndex(index)
+{
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%s%u", settings.accountPrefix.c_str(), settings.firstAccount + index);
+    m_account = buffer;
+    for (std::string::iterator itr = m_account.begin(); itr != m_account.end(); ++itr)
+    {
+        *itr = toupper(*itr);
+    }
+
+    // character names only take letters, so the index is spelled with them
+    m_name = settings.namePrefix;
+    uint32 number = settings.firstAccount + index;
+    do
+    {
+        m_name += char('a' + number % 26);
+        number /= 26;
+    }
+    while (number);
+
+    for (int i = 0; i < MAX_LOAD_ACTIONS; ++i)
+    {
+        m_nextAction[i] = 0;
+        m_sentTime[i] = 0;
+        m_waiting[i] = false;
+    }
+}
+
+LoadClient::~LoadClient()
+{
+    Disconnect();
+}
+
+void LoadClient::Start(uint32 now, LoadStats& stats)
+{
+    m_retries = 0;
+    BeginLogin(now, stats);
+}
+
+void LoadClient::BeginLogin(uint32 now, LoadStats& stats)
+{
+    m_stateTime = now;
+    m_input.clear();
+    m_output.clear();
+    m_outputPos = 0;
+    m_haveHeader = false;
+    m_crypt = AuthCrypt();
+
+    ++stats.requests[LOAD_ACTION_LOGIN];
+
+    if (!Connect(m_settings.realmAddress, m_settings.realmPort))
+    {
+        Fail(now, stats, "cannot connect to realmd");
+        return;
+    }
+
+    SendLogonChallenge();
+    m_state = STATE_REALM_CHALLENGE;
+}
+
+bool LoadClient::Connect(std::string const& address, uint16 port)
+{
+    Disconnect();
+
+    ACE_INET_Addr addr(port, address.c_str());
+    ACE_SOCK_Connector connector;
+    ACE_Time_Value timeout(5);
+
+    if (connector.connect(m_socket, addr, &timeout) == -1)
+    {
+        return false;
+    }
+
+    int nodelay = 1;
+    m_socket.set_option(ACE_IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    m_socket.enable(ACE_NONBLOCK);
+    return true;
+}
+
+void LoadClient::Disconnect()
+{
+    if (m_socket.get_handle() != ACE_INVALID_HANDLE)
+    {
+        m_socket.close();
+    }
+}
+
+void LoadClient::Fail(uint32 now, LoadStats& stats, char const* reason)
+{
+    Disconnect();
+
+    if (m_state == STATE_IN_WORLD)
+    {
+        ++stats.disconnects;
+        m_retries = 0;
+    }
+
+    if (++m_retries > LOGIN_MAX_RETRIES)
+    {
+        printf(" %s: %s, giving up\n", m_account.c_str(), reason);
+        ++stats.loginFailures;
+        m_state = STATE_FAILED;
+        return;
+    }
+
+    m_state = STATE_RETRY;
+    m_stateTime = now;
+}
+
+void LoadClient::Update(uint32 now, LoadStats& stats)
+{
+    switch (m_state)
+    {
+        case STATE_IDLE:
+        case STATE_FAILED:
+            return;
+        case STATE_RETRY:
+            if (getMSTimeDiff(m_stateTime, now) >= LOGIN_RETRY_DELAY)
+            {
+                BeginLogin(now, stats);
+            }
+            return;
+        default:
+            break;
+    }
+
+    if (!Receive(stats))
+    {
+        Fail(now, stats, "connection closed by the server");
+        return;
+    }
+
+    switch (m_state)
+    {
+        case STATE_REALM_CHALLENGE:
+            if (!HandleLogonChallenge(now, stats))
+            {
+                break;
+            }
+            // no break, the proof may already be there
+        case STATE_REALM_PROOF:
+            if (m_state != STATE_REALM_PROOF || !HandleLogonProof(now, stats))
+            {
+                break;
+            }
+            // no break
+        case STATE_REALM_LIST:
+            if (m_state == STATE_REALM_LIST)
+            {
+                HandleRealmList(now, stats);
+            }
+            break;
+        default:
+        {
+            WorldPacket packet;
+            while (m_state > STATE_REALM_LIST && m_state < STATE_RETRY && ReadWorldPacket(packet))
+            {
+                ++stats.packetsReceived;
+
+                try
+                {
+                    HandleWorldPacket(packet, now, stats);
+                }
+                catch (ByteBufferException&)
+                {
+                    // not the layout expected, the packet is of no use to the script
+                }
+            }
+            break;
+        }
+    }
+
+    if (m_state == STATE_IN_WORLD)
+    {
+        RunActions(now, stats);
+    }
+    else if (m_state < STATE_IN_WORLD && getMSTimeDiff(m_stateTime, now) > std::max<uint32>(m_settings.timeout * 3, 30000))
+    {
+        Fail(now, stats, "login timed out");
+        return;
+    }
+
+    if (m_state < STATE_RETRY)
+    {
+        Flush(stats);
+    }
+}
+
+bool LoadClient::Receive(LoadStats& stats)
+{
+    uint8 buffer[4096];
+
+    for (;;)
+    {
+        ssize_t received = m_socket.recv(buffer, sizeof(buffer));
+        if (received > 0)
+        {
+            m_input.insert(m_input.end(), buffer, buffer + received);
+            stats.bytesReceived += received;
+            continue;
+        }
+
+        return received < 0 && (errno == EWOULDBLOCK || errno == EAGAIN);
+    }
+}
+
+void LoadClient::Flush(LoadStats& stats)
+{
+    while (m_outputPos < m_output.size())
+    {
+        ssize_t sent = m_socket.send(&m_output[m_outputPos], m_output.size() - m_outputPos);
+        if (sent <= 0)
+        {
+            break;                                          // socket buffer full, retried on the next update
+        }
+
+        m_outputPos += size_t(sent);
+        stats.bytesSent += sent;
+    }
+
+    if (m_outputPos == m_output.size())
+    {
+        m_output.clear();
+        m_outputPos = 0;
+    }
+}
+
+void LoadClient::SendRaw(uint8 const* data, size_t size)
+{
+    m_output.insert(m_output.end(), data, data + size);
+}
+
+void LoadClient::SendPacket(WorldPacket const& packet, LoadStats& stats)
+{
+    uint16 size = uint16(packet.size() + 4);
+    uint32 opcode = packet.GetOpcode();
+
+    uint8 header[6];
+    header[0] = uint8(size >> 8);
+    header[1] = uint8(size);
+    header[2] = uint8(opcode);
+    header[3] = uint8(opcode >> 8);
+    header[4] = uint8(opcode >> 16);
+    header[5] = uint8(opcode >> 24);
+
+    m_crypt.EncryptSend(header, sizeof(header));
+    SendRaw(header, sizeof(header));
+
+    if (packet.size())
+    {
+        SendRaw(packet.contents(), packet.size());
+    }
+
+    ++stats.packetsSent;
+}
+
+void LoadClient::SendLogonChallenge()
+{
+    uint8 const gameName[4] = { 'W', 'o', 'W', 0 };
+    uint8 const platform[4] = { '6', '8', 'x', 0 };         // four character codes are sent reversed
+    uint8 const os[4] = { 'n', 'i', 'W', 0 };
+    uint8 const country[4] = { 'S', 'U', 'n', 'e' };
+
+    ByteBuffer pkt;
+    pkt << uint8(LOAD_CMD_AUTH_LOGON_CHALLENGE);
+    pkt << uint8(3);
+    pkt << uint16(30 + m_account.size());
+    pkt.append(gameName, 4);
+    pkt << uint8(1) << uint8(12) << uint8(1);
+    pkt << uint16(m_settings.clientBuild);
+    pkt.append(platform, 4);
+    pkt.append(os, 4);
+    pkt.append(country, 4);
+    pkt << uint32(0);                                       // timezone bias
+    pkt << uint32(0x0100007F);                              // ip
+    pkt << uint8(m_account.size());
+    pkt.append(m_account.c_str(), m_account.size());
+
+    SendRaw(pkt.contents(), pkt.size());
+}
+
+bool LoadClient::HandleLogonChallenge(uint32 now, LoadStats& stats)
+{
+    if (m_input.size() < 3)
+    {
+        return false;
+    }
+
+    if (m_input[2] != 0)
+    {
+        char reason[64];
+        snprintf(reason, sizeof(reason), "realmd refused the account (error %u)", m_input[2]);
+        Fail(now, stats, reason);
+        return false;
+    }
+
+    // B, g, N, s, a 16 byte random and the security flags
+    size_t gPos = 3 + 32;
+    if (m_input.size() < gPos + 1 || m_input.size() < gPos + 1 + m_input[gPos] + 1)
+    {
+        return false;
+    }
+
+    uint8 gLen = m_input[gPos];
+    size_t nPos = gPos + 1 + gLen;
+    uint8 nLen = m_input[nPos];
+    size_t sPos = nPos + 1 + nLen;
+    size_t size = sPos + 32 + 16 + 1;
+    if (m_input.size() < size)
+    {
+        return false;
+    }
+
+    if (m_input[size - 1] != 0)
+    {
+        Fail(now, stats, "the account asks for a PIN or a token");
+        return false;
+    }
+
+    BigNumber B, s;
+    B.SetBinary(&m_input[3], 32);
+    m_g.SetBinary(&m_input[gPos + 1], gLen);
+    m_N.SetBinary(&m_input[nPos + 1], nLen);
+    s.SetBinary(&m_input[sPos], 32);
+    m_input.erase(m_input.begin(), m_input.begin() + size);
+
+    if ((B % m_N).isZero())
+    {
+        Fail(now, stats, "invalid SRP6 parameters");
+        return false;
+    }
+
+    BigNumber a;
+    a.SetRand(19 * 8);
+    m_A = m_g.ModExp(a, m_N);
+
+    Sha1Hash sha;
+    sha.UpdateBigNumbers(&m_A, &B, NULL);
+    sha.Finalize();
+    BigNumber u;
+    u.SetBinary(sha.GetDigest(), 20);
+
+    // x = H(s, H(I:P)), the hash realmd keeps as sha_pass_hash
+    std::string password = m_settings.password;
+    for (std::string::iterator itr = password.begin(); itr != password.end(); ++itr)
+    {
+        *itr = toupper(*itr);
+    }
+
+    sha.Initialize();
+    sha.UpdateData(m_account + ":" + password);
+    sha.Finalize();
+    uint8 passHash[20];
+    memcpy(passHash, sha.GetDigest(), 20);
+
+    sha.Initialize();
+    sha.UpdateData(s.AsByteArray(), s.GetNumBytes());
+    sha.UpdateData(passHash, 20);
+    sha.Finalize();
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), 20);
+
+    // S = (B - 3 * g^x) ^ (a + u * x), kept positive by adding 3 * N first
+    BigNumber k(3);
+    BigNumber gx = m_g.ModExp(x, m_N);
+    BigNumber base = ((B + m_N * k) - gx * k) % m_N;
+    BigNumber S = base.ModExp(a + u * x, m_N);
+
+    uint8 t[32];
+    uint8 t1[16];
+    uint8 vK[40];
+    memcpy(t, S.AsByteArray(32), 32);
+    for (int i = 0; i < 16; ++i)
+    {
+        t1[i] = t[i * 2];
+    }
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+    {
+        vK[i * 2] = sha.GetDigest()[i];
+    }
+    for (int i = 0; i < 16; ++i)
+    {
+        t1[i] = t[i * 2 + 1];
+    }
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+    {
+        vK[i * 2 + 1] = sha.GetDigest()[i];
+    }
+    m_K.SetBinary(vK, 40);
+
+    uint8 hash[20];
+    sha.Initialize();
+    sha.UpdateBigNumbers(&m_N, NULL);
+    sha.Finalize();
+    memcpy(hash, sha.GetDigest(), 20);
+    sha.Initialize();
+    sha.UpdateBigNumbers(&m_g, NULL);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+    {
+        hash[i] ^= sha.GetDigest()[i];
+    }
+    BigNumber t3;
+    t3.SetBinary(hash, 20);
+
+    sha.Initialize();
+    sha.UpdateData(m_account);
+    sha.Finalize();
+    uint8 t4[20];
+    memcpy(t4, sha.GetDigest(), 20);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&t3, NULL);
+    sha.UpdateData(t4, 20);
+    sha.UpdateBigNumbers(&s, &m_A, &B, &m_K, NULL);
+    sha.Finalize();
+    m_M.SetBinary(sha.GetDigest(), 20);
+
+    uint8 const zero[20] = { 0 };
+
+    ByteBuffer pkt;
+    pkt << uint8(LOAD_CMD_AUTH_LOGON_PROOF);
+    pkt.append(m_A.AsByteArray(32), 32);
+    pkt.append(sha.GetDigest(), 20);
+    pkt.append(zero, 20);                                   // client files checksum, not checked
+    pkt << uint8(0);                                        // number of keys
+    pkt << uint8(0);                                        // security flags
+    SendRaw(pkt.contents(), pkt.size());
+
+    m_state = STATE_REALM_PROOF;
+    return true;
+}
+
+bool LoadClient::HandleLogonProof(uint32 now, LoadStats& stats)
+{
+    if (m_input.size() < 2)
+    {
+        return false;
+    }
+
+    if (m_input[1] != 0)
+    {
+        Fail(now, stats, "wrong password");
+        return false;
+    }
+
+    // 1.12 builds get the short proof
+    size_t size = m_settings.clientBuild <= 6141 ? 26 : 32;
+    if (m_input.size() < size)
+    {
+        return false;
+    }
+
+    Sha1Hash sha;
+    sha.UpdateBigNumbers(&m_A, &m_M, &m_K, NULL);
+    sha.Finalize();
+
+    bool valid = memcmp(sha.GetDigest(), &m_input[2], 20) == 0;
+    m_input.erase(m_input.begin(), m_input.begin() + size);
+
+    if (!valid)
+    {
+        Fail(now, stats, "realmd sent a wrong proof");
+        return false;
+    }
+
+    // ask for the realm list as the game does, the session key is stored meanwhile
+    ByteBuffer pkt;
+    pkt << uint8(LOAD_CMD_REALM_LIST);
+    pkt << uint32(0);
+    SendRaw(pkt.contents(), pkt.size());
+
+    m_state = STATE_REALM_LIST;
+    return true;
+}
+
+bool LoadClient::HandleRealmList(uint32 now, LoadStats& stats)
+{
+    if (m_input.size() < 3)
+    {
+        return false;
+    }
+
+    size_t size = 3 + (m_input[1] | (m_input[2] << 8));
+    if (m_input.size() < size)
+    {
+        return false;
+    }
+
+    // the world server to use comes from the settings, the list itself is not needed
+    m_input.clear();
+    Flush(stats);
+
+    if (!Connect(m_settings.worldAddress, m_settings.worldPort))
+    {
+        Fail(now, stats, "cannot connect to the world server");
+        return false;
+    }
+
+    m_output.clear();
+    m_outputPos = 0;
+    m_state = STATE_WORLD_CHALLENGE;
+    return true;
+}
+
+bool LoadClient::ReadWorldPacket(WorldPacket& packet)
+{
+    if (!m_haveHeader)
+    {
+        if (m_input.size() < 4)
+        {
+            return false;
+        }
+
+        m_crypt.DecryptRecv(&m_input[0], 4);
+        m_packetSize = uint16((m_input[0] << 8) | m_input[1]);
+        m_packetOpcode = uint16(m_input[2] | (m_input[3] << 8));
+        m_input.erase(m_input.begin(), m_input.begin() + 4);
+        m_haveHeader = true;
+    }
+
+    size_t size = m_packetSize > 2 ? m_packetSize - 2 : 0;
+    if (m_input.size() < size)
+    {
+        return false;
+    }
+
+    packet.Initialize(m_packetOpcode, size);
+    if (size)
+    {
+        packet.append(&m_input[0], size);
+        m_input.erase(m_input.begin(), m_input.begin() + size);
+    }
+
+    m_haveHeader = false;
+    return true;
+}
+
+void LoadClient::HandleWorldPacket(WorldPacket& packet, uint32 now, LoadStats& stats)
+{
+    switch (packet.GetOpcode())
+    {
+        case SMSG_AUTH_CHALLENGE:
+            HandleAuthChallenge(packet, stats);
+            break;
+        case SMSG_AUTH_RESPONSE:
+            HandleAuthResponse(packet, now, stats);
+            break;
+        case SMSG_CHAR_ENUM:
+            HandleCharEnum(packet, now, stats);
+            break;
+        case SMSG_CHAR_CREATE:
+        {
+            uint8 result;
+            packet >> result;
+            if (result != CHAR_CREATE_SUCCESS)
+            {
+                char reason[64];
+                snprintf(reason, sizeof(reason), "cannot create character %s (error %u)", m_name.c_str(), result);
+                Fail(now, stats, reason);
+                break;
+            }
+
+            SendPacket(WorldPacket(CMSG_CHAR_ENUM, 0), stats);
+            m_state = STATE_CHAR_ENUM;
+            break;
+        }
+        case SMSG_LOGIN_VERIFY_WORLD:
+            HandleLoginVerifyWorld(packet, now, stats);
+            break;
+        case SMSG_PONG:
+            Answered(LOAD_ACTION_PING, now, stats);
+            break;
+        case SMSG_QUERY_TIME_RESPONSE:
+            Answered(LOAD_ACTION_QUERY_TIME, now, stats);
+            break;
+        case SMSG_MESSAGECHAT:
+        {
+            uint8 type;
+            uint32 language;
+            uint64 sender;
+            packet >> type >> language >> sender;
+            if (type == CHAT_MSG_SAY && sender == m_guid)
+            {
+                Answered(LOAD_ACTION_CHAT, now, stats);
+            }
+            break;
+        }
+        case SMSG_CAST_FAILED:
+        {
+            uint32 spellId;
+            packet >> spellId;
+            if (spellId == m_settings.castSpell)
+            {
+                Answered(LOAD_ACTION_CAST, now, stats);
+            }
+            break;
+        }
+        case SMSG_AUCTION_LIST_RESULT:
+            Answered(LOAD_ACTION_AUCTION, now, stats);
+            break;
+        case MSG_MOVE_TELEPORT_ACK:
+        case SMSG_NEW_WORLD:
+            HandleTeleport(packet, now, stats);
+            break;
+        default:
+            break;
+    }
+}
+
+void LoadClient::HandleAuthChallenge(WorldPacket& packet, LoadStats& stats)
+{
+    uint32 serverSeed;
+    packet >> serverSeed;
+
+    uint32 clientSeed = urand(1, 0xFFFFFFFE);
+    uint32 zero = 0;
+
+    Sha1Hash sha;
+    sha.UpdateData(m_account);
+    sha.UpdateData((uint8*)&zero, 4);
+    sha.UpdateData((uint8*)&clientSeed, 4);
+    sha.UpdateData((uint8*)&serverSeed, 4);
+    sha.UpdateBigNumbers(&m_K, NULL);
+    sha.Finalize();
+
+    WorldPacket auth(CMSG_AUTH_SESSION, 4 + 4 + m_account.size() + 1 + 4 + 20);
+    auth << uint32(m_settings.clientBuild);
+    auth << uint32(0);
+    auth << m_account;
+    auth << clientSeed;
+    auth.append(sha.GetDigest(), 20);
+    SendPacket(auth, stats);
+
+    // everything after the session packet has its header crypted
+    m_crypt.SetKey(m_K.AsByteArray(40), 40);
+    m_crypt.InitClient();
+
+    m_state = STATE_WORLD_AUTH;
+}
+
+void LoadClient::HandleAuthResponse(WorldPacket& packet, uint32 now, LoadStats& stats)
+{
+    uint8 result;
+    packet >> result;
+
+    if (result == AUTH_WAIT_QUEUE)
+    {
+        m_stateTime = now;                                  // the queue is no login failure, keep waiting
+        return;
+    }
+
+    if (result != AUTH_OK)
+    {
+        char reason[64];
+        snprintf(reason, sizeof(reason), "world server refused the session (error %u)", result);
+        Fail(now, stats, reason);
+        return;
+    }
+
+    SendPacket(WorldPacket(CMSG_CHAR_ENUM, 0), stats);
+    m_state = STATE_CHAR_ENUM;
+}
+
+void LoadClient::HandleCharEnum(WorldPacket& packet, uint32 /*now*/, LoadStats& stats)
+{
+    uint8 count;
+    packet >> count;
+
+    if (!count)
+    {
+        SendCharCreate(stats);
+        m_state = STATE_CHAR_CREATE;
+        return;
+    }
+
+    // always the first character of the account
+    packet >> m_guid;
+
+    WorldPacket login(CMSG_PLAYER_LOGIN, 8);
+    login << m_guid;
+    SendPacket(login, stats);
+    m_state = STATE_LOGIN;
+}
+
+void LoadClient::SendCharCreate(LoadStats& stats)
+{
+    WorldPacket data(CMSG_CHAR_CREATE, m_name.size() + 1 + 9);
+    data << m_name;
+    data << uint8(m_settings.race);
+    data << uint8(m_settings.playerClass);
+    data << uint8(m_index % 2 ? GENDER_FEMALE : GENDER_MALE);
+    data << uint8(0) << uint8(0);                           // skin, face
+    data << uint8(0) << uint8(0);                           // hair style and color
+    data << uint8(0);                                       // facial hair
+    data << uint8(0);                                       // outfit
+    SendPacket(data, stats);
+}
+
+void LoadClient::HandleLoginVerifyWorld(WorldPacket& packet, uint32 now, LoadStats& stats)
+{
+    packet >> m_mapId >> m_x >> m_y >> m_z >> m_orientation;
+
+    stats.latency[LOAD_ACTION_LOGIN].Add(getMSTimeDiff(m_stateTime, now));
+    m_retries = 0;
+    m_state = STATE_IN_WORLD;
+    ScheduleActions(now);
+}
+
+void LoadClient::HandleTeleport(WorldPacket& packet, uint32 now, LoadStats& stats)
+{
+    if (packet.GetOpcode() == SMSG_NEW_WORLD)
+    {
+        packet >> m_mapId >> m_x >> m_y >> m_z >> m_orientation;
+        SendPacket(WorldPacket(MSG_MOVE_WORLDPORT_ACK, 0), stats);
+    }
+    else
+    {
+        packet.readPackGUID();
+        uint32 counter, moveFlags, time;
+        packet >> counter >> moveFlags >> time;
+        packet >> m_x >> m_y >> m_z >> m_orientation;
+
+        WorldPacket ack(MSG_MOVE_TELEPORT_ACK, 8 + 4 + 4);
+        ack << m_guid;
+        ack << counter;
+        ack << now;
+        SendPacket(ack, stats);
+    }
+
+    // the walk goes on around the new position
+    m_centerX = m_x;
+    m_centerY = m_y;
+    m_moving = false;
+    Answered(LOAD_ACTION_TELEPORT, now, stats);
+}
+
+void LoadClient::ScheduleActions(uint32 now)
+{
+    // spread the clients over the intervals so their actions do not come in waves
+    for (int i = 0; i < MAX_LOAD_ACTIONS; ++i)
+    {
+        m_nextAction[i] = now + (m_settings.interval[i] ? urand(0, m_settings.interval[i] - 1) : 0);
+        m_waiting[i] = false;
+    }
+
+    m_centerX = m_x;
+    m_centerY = m_y;
+    m_waypoint = 0;
+    m_lastStep = now;
+    m_moving = false;
+}
+
+void LoadClient::RunActions(uint32 now, LoadStats& stats)
+{
+    for (int i = 0; i < MAX_LOAD_ACTIONS; ++i)
+    {
+        if (m_waiting[i] && getMSTimeDiff(m_sentTime[i], now) > m_settings.timeout)
+        {
+            ++stats.lost[i];
+            m_waiting[i] = false;
+        }
+
+        if (!m_settings.interval[i] || int32(now - m_nextAction[i]) < 0)
+        {
+            continue;
+        }
+
+        m_nextAction[i] = now + m_settings.interval[i];
+
+        // one request of a kind at a time, a slow server gets less load rather than a backlog
+        if (!m_waiting[i])
+        {
+            DoAction(LoadAction(i), now, stats);
+        }
+    }
+}
+
+void LoadClient::DoAction(LoadAction action, uint32 now, LoadStats& stats)
+{
+    switch (action)
+    {
+        case LOAD_ACTION_PING:
+        {
+            WorldPacket data(CMSG_PING, 8);
+            data << uint32(stats.requests[LOAD_ACTION_PING]);
+            data << uint32(stats.latency[LOAD_ACTION_PING].GetMax());
+            SendPacket(data, stats);
+            break;
+        }
+        case LOAD_ACTION_QUERY_TIME:
+            SendPacket(WorldPacket(CMSG_QUERY_TIME, 0), stats);
+            break;
+        case LOAD_ACTION_MOVE:
+            if (!m_moving)
+            {
+                m_moving = true;
+                m_lastStep = now;
+                SendMovement(MSG_MOVE_START_FORWARD, now, stats);
+            }
+            else
+            {
+                StepMovement(now);
+                SendMovement(MSG_MOVE_HEARTBEAT, now, stats);
+            }
+            ++stats.requests[action];
+            return;                                         // nothing comes back
+        case LOAD_ACTION_CHAT:
+        {
+            bool alliance = m_settings.race == RACE_HUMAN || m_settings.race == RACE_DWARF ||
+                            m_settings.race == RACE_NIGHTELF || m_settings.race == RACE_GNOME;
+
+            char text[64];
+            snprintf(text, sizeof(text), "load test message %u", uint32(stats.requests[action]));
+
+            WorldPacket data(CMSG_MESSAGECHAT, 4 + 4 + strlen(text) + 1);
+            data << uint32(CHAT_MSG_SAY);
+            data << uint32(alliance ? LANG_COMMON : LANG_ORCISH);
+            data << text;
+            SendPacket(data, stats);
+            break;
+        }
+        case LOAD_ACTION_CAST:
+        {
+            WorldPacket data(CMSG_CAST_SPELL, 4 + 2);
+            data << uint32(m_settings.castSpell);
+            data << uint16(0);                              // TARGET_FLAG_SELF
+            SendPacket(data, stats);
+            break;
+        }
+        case LOAD_ACTION_AUCTION:
+        {
+            WorldPacket data(CMSG_AUCTION_LIST_ITEMS, 8 + 4 + 1 + 2 + 16 + 1);
+            data << m_settings.auctioneer;
+            data << uint32(0);                              // first item
+            data << "";                                     // any name
+            data << uint8(0) << uint8(0);                   // any level
+            data << uint32(0xFFFFFFFF);                     // any slot
+            data << uint32(0xFFFFFFFF);                     // any class
+            data << uint32(0xFFFFFFFF);                     // any subclass
+            data << uint32(0xFFFFFFFF);                     // any quality
+            data << uint8(0);                               // usable or not
+            SendPacket(data, stats);
+            break;
+        }
+        case LOAD_ACTION_TELEPORT:
+        {
+            LoadTeleport const& loc = m_settings.teleports[m_teleportIndex++ % m_settings.teleports.size()];
+
+            char command[96];
+            snprintf(command, sizeof(command), ".go xyz %.2f %.2f %.2f %u", loc.x, loc.y, loc.z, loc.mapId);
+
+            WorldPacket data(CMSG_MESSAGECHAT, 4 + 4 + strlen(command) + 1);
+            data << uint32(CHAT_MSG_SAY);
+            data << uint32(LANG_UNIVERSAL);
+            data << command;
+            SendPacket(data, stats);
+            break;
+        }
+        default:
+            return;
+    }
+
+    ++stats.requests[action];
+    m_sentTime[action] = now;
+    m_waiting[action] = true;
+}
+
+void LoadClient::SendMovement(uint16 opcode, uint32 now, LoadStats& stats)
+{
+    WorldPacket data(opcode, 4 + 4 + 4 * 4 + 4);
+    data << uint32(m_moving ? LOAD_MOVEFLAG_FORWARD : 0);
+    data << now;
+    data << m_x << m_y << m_z << m_orientation;
+    data << uint32(0);                                      // fall time
+    SendPacket(data, stats);
+}
+
+void LoadClient::StepMovement(uint32 now)
+{
+    float distance = m_settings.moveSpeed * getMSTimeDiff(m_lastStep, now) / 1000.0f;
+    m_lastStep = now;
+
+    while (distance > 0.0f)
+    {
+        float angle = 2.0f * M_PI_F * m_waypoint / MOVE_WAYPOINTS;
+        float dx = m_centerX + m_settings.moveRadius * cos(angle) - m_x;
+        float dy = m_centerY + m_settings.moveRadius * sin(angle) - m_y;
+        float left = sqrt(dx * dx + dy * dy);
+
+        m_orientation = atan2(dy, dx);
+        if (m_orientation < 0.0f)
+        {
+            m_orientation += 2.0f * M_PI_F;
+        }
+
+        if (left > distance)
+        {
+            m_x += dx / left * distance;
+            m_y += dy / left * distance;
+            break;
+        }
+
+        // waypoint reached, head for the next one
+        m_x += dx;
+        m_y += dy;
+        distance -= left;
+        m_waypoint = (m_waypoint + 1) % MOVE_WAYPOINTS;
+
+        if (left < 0.001f && m_settings.moveRadius <= 0.0f)
+        {
+            break;
+        }
+    }
+}
+
+void LoadClient::Answered(LoadAction action, uint32 now, LoadStats& stats)
+{
+    if (!m_waiting[action])
+    {
+        return;
+    }
+
+    stats.latency[action].Add(getMSTimeDiff(m_sentTime[action], now));
+    m_waiting[action] = false;
+}
@@ -0,0 +1,161 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_H_LOAD_CLIENT
+#define MANGOS_H_LOAD_CLIENT
+
+#include "LoadGenerator.h"
+#include "Auth/AuthCrypt.h"
+#include "Auth/BigNumber.h"
+#include "WorldPacket.h"
+
+#include <ace/SOCK_Stream.h>
+
+/**
+ * @brief One simulated game client
+ *
+ * Logs in through realmd with SRP6, enters the world with the session key, creates
+ * its character when the account has none, then runs the scripted actions of the
+ * settings. The sockets are non blocking, the worker thread owning the client polls
+ * the handle and calls Update whenever there is something to read or to do.
+ */
+class LoadClient
+{
+    public:
+        LoadClient(LoadSettings const& settings, uint32 index);
+        ~LoadClient();
+
+        /// starts the login, retried a few times when the realm or the world refuse it
+        void Start(uint32 now, LoadStats& stats);
+        /// handles the received data, the due actions and the lost requests
+        void Update(uint32 now, LoadStats& stats);
+
+        ACE_HANDLE GetHandle() const { return m_socket.get_handle(); }
+        bool HasOutput() const { return m_outputPos < m_output.size(); }
+        bool IsStarted() const { return m_state != STATE_IDLE; }
+        bool IsInWorld() const { return m_state == STATE_IN_WORLD; }
+        bool IsFailed() const { return m_state == STATE_FAILED; }
+
+    private:
+        enum State
+        {
+            STATE_IDLE,
+            STATE_REALM_CHALLENGE,                          // waiting for the SRP6 parameters
+            STATE_REALM_PROOF,                              // waiting for the server proof
+            STATE_REALM_LIST,                               // waiting for the realm list
+            STATE_WORLD_CHALLENGE,                          // waiting for SMSG_AUTH_CHALLENGE
+            STATE_WORLD_AUTH,                               // waiting for SMSG_AUTH_RESPONSE
+            STATE_CHAR_ENUM,
+            STATE_CHAR_CREATE,
+            STATE_LOGIN,                                    // waiting for SMSG_LOGIN_VERIFY_WORLD
+            STATE_IN_WORLD,
+            STATE_RETRY,                                    // connection lost or refused, starting over soon
+            STATE_FAILED
+        };
+
+        LoadClient(LoadClient const&);
+        LoadClient& operator=(LoadClient const&);
+
+        void BeginLogin(uint32 now, LoadStats& stats);
+        bool Connect(std::string const& address, uint16 port);
+        void Disconnect();
+        void Fail(uint32 now, LoadStats& stats, char const* reason);
+
+        bool Receive(LoadStats& stats);
+        void Flush(LoadStats& stats);
+        void SendRaw(uint8 const* data, size_t size);
+        void SendPacket(WorldPacket const& packet, LoadStats& stats);
+
+        // realmd
+        void SendLogonChallenge();
+        bool HandleLogonChallenge(uint32 now, LoadStats& stats);
+        bool HandleLogonProof(uint32 now, LoadStats& stats);
+        bool HandleRealmList(uint32 now, LoadStats& stats);
+
+        // world server
+        bool ReadWorldPacket(WorldPacket& packet);
+        void HandleWorldPacket(WorldPacket& packet, uint32 now, LoadStats& stats);
+        void HandleAuthChallenge(WorldPacket& packet, LoadStats& stats);
+        void HandleAuthResponse(WorldPacket& packet, uint32 now, LoadStats& stats);
+        void HandleCharEnum(WorldPacket& packet, uint32 now, LoadStats& stats);
+        void HandleLoginVerifyWorld(WorldPacket& packet, uint32 now, LoadStats& stats);
+        void HandleTeleport(WorldPacket& packet, uint32 now, LoadStats& stats);
+        void SendCharCreate(LoadStats& stats);
+
+        // scripted actions
+        void ScheduleActions(uint32 now);
+        void RunActions(uint32 now, LoadStats& stats);
+        void DoAction(LoadAction action, uint32 now, LoadStats& stats);
+        void SendMovement(uint16 opcode, uint32 now, LoadStats& stats);
+        void StepMovement(uint32 now);
+        void Answered(LoadAction action, uint32 now, LoadStats& stats);
+
+        LoadSettings const& m_settings;
+        uint32 m_index;
+        std::string m_account;
+        std::string m_name;
+
+        State m_state;
+        uint32 m_stateTime;                                 // when the current login attempt or the retry wait started
+        uint32 m_retries;
+
+        ACE_SOCK_Stream m_socket;
+        std::vector<uint8> m_input;
+        std::vector<uint8> m_output;
+        size_t m_outputPos;
+
+        // SRP6
+        BigNumber m_N;
+        BigNumber m_g;
+        BigNumber m_A;
+        BigNumber m_M;
+        BigNumber m_K;
+
+        AuthCrypt m_crypt;
+        bool m_haveHeader;                                  // header of the next world packet already decrypted
+        uint16 m_packetSize;
+        uint16 m_packetOpcode;
+
+        uint64 m_guid;
+        uint32 m_mapId;
+        float m_x;
+        float m_y;
+        float m_z;
+        float m_orientation;
+
+        // movement along the waypoints of a circle around the login position
+        float m_centerX;
+        float m_centerY;
+        uint32 m_waypoint;
+        uint32 m_lastStep;
+        bool m_moving;
+        uint32 m_teleportIndex;
+
+        uint32 m_nextAction[MAX_LOAD_ACTIONS];
+        uint32 m_sentTime[MAX_LOAD_ACTIONS];                // of the unanswered request
+        bool m_waiting[MAX_LOAD_ACTIONS];
+};
+
+#endif
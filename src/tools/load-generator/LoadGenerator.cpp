@@ -0,0 +1,130 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "LoadGenerator.h"
+
+#include <algorithm>
+
+char const* GetLoadActionName(LoadAction action)
+{
+    switch (action)
+    {
+        case LOAD_ACTION_LOGIN:         return "login";
+        case LOAD_ACTION_PING:          return "ping";
+        case LOAD_ACTION_QUERY_TIME:    return "query_time";
+        case LOAD_ACTION_MOVE:          return "move";
+        case LOAD_ACTION_CHAT:          return "chat";
+        case LOAD_ACTION_CAST:          return "cast";
+        case LOAD_ACTION_AUCTION:       return "auction";
+        case LOAD_ACTION_TELEPORT:      return "teleport";
+        default:                        return "unknown";
+    }
+}
+
+void LatencyHistogram::Add(uint32 ms)
+{
+    ++m_buckets[std::min(ms, MAX_TRACKED_MS)];
+    ++m_count;
+    m_sum += ms;
+    m_max = std::max(m_max, ms);
+}
+
+void LatencyHistogram::Merge(LatencyHistogram const& other)
+{
+    for (size_t i = 0; i < m_buckets.size(); ++i)
+    {
+        m_buckets[i] += other.m_buckets[i];
+    }
+
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_max = std::max(m_max, other.m_max);
+}
+
+void LatencyHistogram::Clear()
+{
+    std::fill(m_buckets.begin(), m_buckets.end(), 0);
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+}
+
+uint32 LatencyHistogram::GetPercentile(double fraction) const
+{
+    if (!m_count)
+    {
+        return 0;
+    }
+
+    // nearest rank, the smallest value with at least the fraction of the samples at or below it
+    uint64 rank = uint64(fraction * double(m_count) + 0.999999);
+    rank = std::max<uint64>(rank, 1);
+
+    uint64 seen = 0;
+    for (uint32 ms = 0; ms <= MAX_TRACKED_MS; ++ms)
+    {
+        seen += m_buckets[ms];
+        if (seen >= rank)
+        {
+            return ms == MAX_TRACKED_MS ? m_max : ms;
+        }
+    }
+
+    return m_max;
+}
+
+void LoadStats::Clear()
+{
+    for (int i = 0; i < MAX_LOAD_ACTIONS; ++i)
+    {
+        latency[i].Clear();
+        requests[i] = 0;
+        lost[i] = 0;
+    }
+
+    packetsSent = 0;
+    packetsReceived = 0;
+    bytesSent = 0;
+    bytesReceived = 0;
+    loginFailures = 0;
+    disconnects = 0;
+}
+
+void LoadStats::Merge(LoadStats const& other)
+{
+    for (int i = 0; i < MAX_LOAD_ACTIONS; ++i)
+    {
+        latency[i].Merge(other.latency[i]);
+        requests[i] += other.requests[i];
+        lost[i] += other.lost[i];
+    }
+
+    packetsSent += other.packetsSent;
+    packetsReceived += other.packetsReceived;
+    bytesSent += other.bytesSent;
+    bytesReceived += other.bytesReceived;
+    loginFailures += other.loginFailures;
+    disconnects += other.disconnects;
+}
@@ -0,0 +1,140 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_H_LOAD_GENERATOR
+#define MANGOS_H_LOAD_GENERATOR
+
+#include "Common.h"
+
+#include <string>
+#include <vector>
+
+/// What the simulated clients do, and the latency series reported for each of them
+enum LoadAction
+{
+    LOAD_ACTION_LOGIN           = 0,                        // realm connection to SMSG_LOGIN_VERIFY_WORLD
+    LOAD_ACTION_PING            = 1,                        // CMSG_PING / SMSG_PONG, answered by the network thread
+    LOAD_ACTION_QUERY_TIME      = 2,                        // CMSG_QUERY_TIME, answered during the map update
+    LOAD_ACTION_MOVE            = 3,                        // movement packets, not answered
+    LOAD_ACTION_CHAT            = 4,                        // say, until the client hears itself
+    LOAD_ACTION_CAST            = 5,                        // CMSG_CAST_SPELL / SMSG_CAST_FAILED
+    LOAD_ACTION_AUCTION         = 6,                        // CMSG_AUCTION_LIST_ITEMS / SMSG_AUCTION_LIST_RESULT
+    LOAD_ACTION_TELEPORT        = 7,                        // .go xyz until the teleport packet arrives
+    MAX_LOAD_ACTIONS
+};
+
+char const* GetLoadActionName(LoadAction action);
+
+struct LoadTeleport
+{
+    uint32 mapId;
+    float x;
+    float y;
+    float z;
+};
+
+/// Settings of a run, read from the configuration file and the scenario overriding it
+struct LoadSettings
+{
+    std::string realmAddress;
+    uint16 realmPort;
+    std::string worldAddress;
+    uint16 worldPort;
+    uint16 clientBuild;
+
+    std::string accountPrefix;
+    uint32 firstAccount;
+    std::string password;
+
+    uint8 race;
+    uint8 playerClass;
+    std::string namePrefix;
+
+    uint32 clients;
+    uint32 threads;
+    uint32 loginRate;                                       // new logins per second
+    uint32 duration;                                        // seconds measured once every client had its turn to log in
+    uint32 timeout;                                         // ms before an unanswered request counts as lost
+
+    uint32 interval[MAX_LOAD_ACTIONS];                      // ms between two actions of a client, 0 disables it
+    float moveRadius;
+    float moveSpeed;
+    uint32 castSpell;
+    uint64 auctioneer;
+    std::vector<LoadTeleport> teleports;
+
+    std::string metricsAddress;
+    uint16 metricsPort;
+
+    std::string scenario;
+    std::string reportFile;
+};
+
+/// Latency distribution with 1 ms resolution, cheap to fill and to merge between the worker threads
+class LatencyHistogram
+{
+    public:
+        static const uint32 MAX_TRACKED_MS = 10000;         // higher values are counted in the last bucket
+
+        LatencyHistogram() : m_buckets(MAX_TRACKED_MS + 1, 0), m_count(0), m_sum(0), m_max(0) {}
+
+        void Add(uint32 ms);
+        void Merge(LatencyHistogram const& other);
+        void Clear();
+
+        uint32 GetPercentile(double fraction) const;
+        uint64 GetCount() const { return m_count; }
+        double GetMean() const { return m_count ? double(m_sum) / double(m_count) : 0.0; }
+        uint32 GetMax() const { return m_max; }
+
+    private:
+        std::vector<uint32> m_buckets;
+        uint64 m_count;
+        uint64 m_sum;
+        uint32 m_max;
+};
+
+/// Counters of one worker thread, summed up for the report
+struct LoadStats
+{
+    LoadStats() { Clear(); }
+
+    void Clear();
+    void Merge(LoadStats const& other);
+
+    LatencyHistogram latency[MAX_LOAD_ACTIONS];
+    uint64 requests[MAX_LOAD_ACTIONS];
+    uint64 lost[MAX_LOAD_ACTIONS];                          // unanswered after the timeout
+
+    uint64 packetsSent;
+    uint64 packetsReceived;
+    uint64 bytesSent;
+    uint64 bytesReceived;
+
+    uint32 loginFailures;
+    uint32 disconnects;
+};
+
+#endif
@@ -0,0 +1,212 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "ServerMetrics.h"
+
+#include <ace/INET_Addr.h>
+#include <ace/SOCK_Connector.h>
+#include <ace/SOCK_Stream.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+TickHistogram TickHistogram::Since(TickHistogram const& older) const
+{
+    TickHistogram diff = *this;
+    if (older.buckets.size() != buckets.size())
+    {
+        return diff;                                        // server restarted meanwhile
+    }
+
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        diff.buckets[i] -= std::min(diff.buckets[i], older.buckets[i]);
+    }
+
+    diff.sum -= older.sum;
+    diff.count -= std::min(diff.count, older.count);
+    return diff;
+}
+
+double TickHistogram::GetPercentile(double fraction) const
+{
+    if (!count)
+    {
+        return 0.0;
+    }
+
+    double rank = fraction * double(count);
+    for (size_t i = 0; i < buckets.size() && i < bounds.size(); ++i)
+    {
+        if (double(buckets[i]) >= rank)
+        {
+            return bounds[i] * 1000.0;
+        }
+    }
+
+    // above the last bound, the mean of the run is the best guess left
+    return bounds.empty() ? GetMean() : bounds.back() * 1000.0;
+}
+
+// adds one sample line to the histogram, the buckets come in ascending order
+static void AddSample(TickHistogram& histogram, char const* suffix, char const* labels, double value)
+{
+    if (strcmp(suffix, "_sum") == 0)
+    {
+        histogram.sum += value;
+    }
+    else if (strcmp(suffix, "_count") == 0)
+    {
+        histogram.count += uint64(value);
+    }
+    else if (strcmp(suffix, "_bucket") == 0)
+    {
+        char const* le = labels ? strstr(labels, "le=\"") : NULL;
+        if (!le || strncmp(le + 4, "+Inf", 4) == 0)
+        {
+            return;
+        }
+
+        double bound = atof(le + 4);
+
+        // the map series share the bounds, so the same bound adds up to the same bucket
+        size_t i = 0;
+        while (i < histogram.bounds.size() && histogram.bounds[i] < bound)
+        {
+            ++i;
+        }
+
+        if (i == histogram.bounds.size() || histogram.bounds[i] != bound)
+        {
+            histogram.bounds.insert(histogram.bounds.begin() + i, bound);
+            histogram.buckets.insert(histogram.buckets.begin() + i, 0);
+        }
+
+        histogram.buckets[i] += uint64(value);
+    }
+}
+
+static void ParseMetrics(std::string const& text, ServerSnapshot& snapshot)
+{
+    static char const worldName[] = "mangos_world_tick_seconds";
+    static char const mapName[] = "mangos_map_tick_seconds";
+    static char const sessionsName[] = "mangos_sessions{state=\"active\"}";
+
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        size_t space = line.rfind(' ');
+        if (space == std::string::npos)
+        {
+            continue;
+        }
+
+        double value = atof(line.c_str() + space + 1);
+        line.resize(space);
+
+        if (line.compare(0, sizeof(sessionsName) - 1, sessionsName) == 0)
+        {
+            snapshot.sessions = int64(value);
+            continue;
+        }
+
+        TickHistogram* histogram = NULL;
+        size_t nameLength = 0;
+        if (line.compare(0, sizeof(worldName) - 1, worldName) == 0)
+        {
+            histogram = &snapshot.world;
+            nameLength = sizeof(worldName) - 1;
+        }
+        else if (line.compare(0, sizeof(mapName) - 1, mapName) == 0)
+        {
+            histogram = &snapshot.maps;
+            nameLength = sizeof(mapName) - 1;
+        }
+        else
+        {
+            continue;
+        }
+
+        size_t brace = line.find('{', nameLength);
+        std::string suffix = line.substr(nameLength, brace == std::string::npos ? std::string::npos : brace - nameLength);
+        AddSample(*histogram, suffix.c_str(), brace == std::string::npos ? NULL : line.c_str() + brace, value);
+    }
+}
+
+bool FetchServerSnapshot(std::string const& address, uint16 port, ServerSnapshot& snapshot)
+{
+    snapshot = ServerSnapshot();
+    snapshot.sessions = -1;
+
+    ACE_INET_Addr addr(port, address.c_str());
+    ACE_SOCK_Connector connector;
+    ACE_SOCK_Stream stream;
+    ACE_Time_Value timeout(5);
+
+    if (connector.connect(stream, addr, &timeout) == -1)
+    {
+        return false;
+    }
+
+    std::string request = "GET /metrics HTTP/1.0\r\nHost: " + address + "\r\nConnection: close\r\n\r\n";
+    if (stream.send_n(request.c_str(), request.size(), &timeout) != ssize_t(request.size()))
+    {
+        stream.close();
+        return false;
+    }
+
+    std::string response;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = stream.recv(buffer, sizeof(buffer), &timeout)) > 0)
+    {
+        response.append(buffer, received);
+    }
+    stream.close();
+
+    size_t body = response.find("\r\n\r\n");
+    if (response.compare(0, 12, "HTTP/1.0 200") != 0 && response.compare(0, 12, "HTTP/1.1 200") != 0)
+    {
+        return false;
+    }
+
+    ParseMetrics(body == std::string::npos ? std::string() : response.substr(body + 4), snapshot);
+    return true;
+}
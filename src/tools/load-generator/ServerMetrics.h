@@ -0,0 +1,62 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_H_LOAD_SERVER_METRICS
+#define MANGOS_H_LOAD_SERVER_METRICS
+
+#include "Common.h"
+
+#include <string>
+#include <vector>
+
+/// A tick duration histogram as exported on the metrics endpoint of mangosd, cumulative buckets in seconds
+struct TickHistogram
+{
+    TickHistogram() : sum(0.0), count(0) {}
+
+    /// what was recorded between an older snapshot and this one
+    TickHistogram Since(TickHistogram const& older) const;
+    /// estimated from the buckets, in ms, the upper bound of the bucket holding the rank
+    double GetPercentile(double fraction) const;
+    double GetMean() const { return count ? sum * 1000.0 / double(count) : 0.0; }
+
+    std::vector<double> bounds;
+    std::vector<uint64> buckets;
+    double sum;
+    uint64 count;
+};
+
+/// The server side of a run, world and map update durations read from Metrics.IP:Metrics.Port
+struct ServerSnapshot
+{
+    TickHistogram world;
+    TickHistogram maps;                                     // every map series summed up
+    int64 sessions;
+};
+
+/// Fetches /metrics, false when mangosd runs without Metrics.Enable or cannot be reached
+bool FetchServerSnapshot(std::string const& address, uint16 port, ServerSnapshot& snapshot);
+
+#endif
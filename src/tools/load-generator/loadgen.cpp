@@ -0,0 +1,562 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2023 MaNGOS <https://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "LoadClient.h"
+#include "ServerMetrics.h"
+#include "Config/Config.h"
+#include "SharedDefines.h"
+#include "Timer.h"
+
+#include <ace/OS_NS_poll.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+static const uint32 FULL_UPDATE_INTERVAL = 10;              // ms between two updates of the clients without news
+static const uint32 PROGRESS_INTERVAL = 10000;
+static const uint32 LOGIN_GRACE_TIME = 30000;               // for the last logins after the ramp up
+
+/// The clients of one thread, the thread holds the lock while updating them
+struct LoadWorker
+{
+    LoadWorker() : inWorld(0), failed(0) {}
+
+    std::vector<LoadClient*> clients;
+    std::vector<uint32> startTimes;
+    LoadStats stats;
+    std::mutex lock;
+    std::atomic<uint32> inWorld;
+    std::atomic<uint32> failed;
+};
+
+static std::atomic<bool> stopWorkers(false);
+
+void printUsage(char* prg)
+{
+    printf(" Usage: %s [OPTION]\n\n", prg);
+    printf(" Log simulated clients into realmd and mangosd and measure the answers.\n");
+    printf("   -h, --help                        show the usage\n");
+    printf("   -c, --config <file>               settings (default loadgen.conf)\n");
+    printf("   -s, --scenario <file>             scenario overriding some of the settings\n");
+    printf("\n");
+    printf(" Example:\n");
+    printf("   %s -c loadgen.conf -s scenarios/movement.conf\n", prg);
+}
+
+bool handleArgs(int argc, char** argv, char const*& configFile, char const*& scenarioFile)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--config") == 0) && i + 1 < argc)
+        {
+            configFile = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--scenario") == 0) && i + 1 < argc)
+        {
+            scenarioFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+        {
+            printUsage(argv[0]);
+            exit(1);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// the scenario wins over the base settings, which win over the default
+static std::string getString(Config& base, Config& scenario, char const* name, char const* def)
+{
+    std::string value = base.GetStringDefault(name, def);
+    return scenario.GetStringDefault(name, value.c_str());
+}
+
+static int32 getInt(Config& base, Config& scenario, char const* name, int32 def)
+{
+    return scenario.GetIntDefault(name, base.GetIntDefault(name, def));
+}
+
+static float getFloat(Config& base, Config& scenario, char const* name, float def)
+{
+    return scenario.GetFloatDefault(name, base.GetFloatDefault(name, def));
+}
+
+// "map x y z" separated by ';'
+static void readTeleports(std::string const& text, std::vector<LoadTeleport>& teleports)
+{
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find(';', start);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+
+        LoadTeleport loc;
+        if (sscanf(text.substr(start, end - start).c_str(), "%u %f %f %f", &loc.mapId, &loc.x, &loc.y, &loc.z) == 4)
+        {
+            teleports.push_back(loc);
+        }
+        else
+        {
+            printf(" Skipping malformed teleport location '%s'\n", text.substr(start, end - start).c_str());
+        }
+
+        start = end + 1;
+    }
+}
+
+void readSettings(Config& base, Config& scenario, LoadSettings& settings)
+{
+    settings.realmAddress = getString(base, scenario, "Realm.Address", "127.0.0.1");
+    settings.realmPort = uint16(getInt(base, scenario, "Realm.Port", 3724));
+    settings.worldAddress = getString(base, scenario, "World.Address", "127.0.0.1");
+    settings.worldPort = uint16(getInt(base, scenario, "World.Port", 8085));
+    settings.clientBuild = uint16(getInt(base, scenario, "ClientBuild", 5875));
+
+    settings.accountPrefix = getString(base, scenario, "Account.Prefix", "LOADTEST");
+    settings.firstAccount = uint32(getInt(base, scenario, "Account.First", 1));
+    settings.password = getString(base, scenario, "Account.Password", "loadtest");
+
+    settings.race = uint8(getInt(base, scenario, "Character.Race", RACE_HUMAN));
+    settings.playerClass = uint8(getInt(base, scenario, "Character.Class", CLASS_WARRIOR));
+    settings.namePrefix = getString(base, scenario, "Character.NamePrefix", "Loadtest");
+
+    settings.clients = uint32(std::max(getInt(base, scenario, "Clients", 100), 1));
+    settings.threads = uint32(std::max(getInt(base, scenario, "Threads", 2), 1));
+    settings.threads = std::min(settings.threads, settings.clients);
+    settings.loginRate = uint32(std::max(getInt(base, scenario, "LoginRate", 20), 1));
+    settings.duration = uint32(std::max(getInt(base, scenario, "Duration", 300), 1));
+    settings.timeout = uint32(std::max(getInt(base, scenario, "Timeout", 5000), 1));
+
+    settings.interval[LOAD_ACTION_LOGIN] = 0;
+    settings.interval[LOAD_ACTION_PING] = uint32(getInt(base, scenario, "Interval.Ping", 30000));
+    settings.interval[LOAD_ACTION_QUERY_TIME] = uint32(getInt(base, scenario, "Interval.QueryTime", 0));
+    settings.interval[LOAD_ACTION_MOVE] = uint32(getInt(base, scenario, "Interval.Move", 0));
+    settings.interval[LOAD_ACTION_CHAT] = uint32(getInt(base, scenario, "Interval.Chat", 0));
+    settings.interval[LOAD_ACTION_CAST] = uint32(getInt(base, scenario, "Interval.Cast", 0));
+    settings.interval[LOAD_ACTION_AUCTION] = uint32(getInt(base, scenario, "Interval.Auction", 0));
+    settings.interval[LOAD_ACTION_TELEPORT] = uint32(getInt(base, scenario, "Interval.Teleport", 0));
+
+    settings.moveRadius = getFloat(base, scenario, "Move.Radius", 20.0f);
+    settings.moveSpeed = getFloat(base, scenario, "Move.Speed", 7.0f);
+    settings.castSpell = uint32(getInt(base, scenario, "Cast.Spell", 0));
+    settings.auctioneer = strtoull(getString(base, scenario, "Auction.Auctioneer", "0").c_str(), NULL, 0);
+
+    settings.teleports.clear();
+    readTeleports(getString(base, scenario, "Teleport.Locations", ""), settings.teleports);
+
+    settings.metricsAddress = getString(base, scenario, "Metrics.Address", "127.0.0.1");
+    settings.metricsPort = uint16(getInt(base, scenario, "Metrics.Port", 9101));
+
+    settings.scenario = getString(base, scenario, "Scenario.Name", "default");
+    settings.reportFile = getString(base, scenario, "Report.File", "");
+
+    // actions which cannot work are turned off rather than counted as lost
+    if (!settings.castSpell)
+    {
+        settings.interval[LOAD_ACTION_CAST] = 0;
+    }
+    if (!settings.auctioneer)
+    {
+        settings.interval[LOAD_ACTION_AUCTION] = 0;
+    }
+    if (settings.teleports.empty())
+    {
+        settings.interval[LOAD_ACTION_TELEPORT] = 0;
+    }
+}
+
+void runWorker(LoadWorker* worker)
+{
+    std::vector<pollfd> fds;
+    std::vector<LoadClient*> polled;
+    uint32 lastFullUpdate = 0;
+
+    while (!stopWorkers)
+    {
+        fds.clear();
+        polled.clear();
+
+        for (size_t i = 0; i < worker->clients.size(); ++i)
+        {
+            LoadClient* client = worker->clients[i];
+            if (client->GetHandle() == ACE_INVALID_HANDLE)
+            {
+                continue;
+            }
+
+            pollfd fd;
+            fd.fd = client->GetHandle();
+            fd.events = POLLIN | (client->HasOutput() ? POLLOUT : 0);
+            fd.revents = 0;
+            fds.push_back(fd);
+            polled.push_back(client);
+        }
+
+        ACE_Time_Value wait(0, FULL_UPDATE_INTERVAL * 1000);
+        if (fds.empty())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(FULL_UPDATE_INTERVAL));
+        }
+        else
+        {
+            ACE_OS::poll(&fds[0], fds.size(), wait);
+        }
+
+        uint32 now = getMSTime();
+
+        std::lock_guard<std::mutex> guard(worker->lock);
+
+        // answers are handled at once so the latency is not rounded up to the update interval
+        for (size_t i = 0; i < fds.size(); ++i)
+        {
+            if (fds[i].revents)
+            {
+                polled[i]->Update(now, worker->stats);
+            }
+        }
+
+        if (getMSTimeDiff(lastFullUpdate, now) < FULL_UPDATE_INTERVAL)
+        {
+            continue;
+        }
+
+        lastFullUpdate = now;
+
+        uint32 inWorld = 0;
+        uint32 failed = 0;
+        for (size_t i = 0; i < worker->clients.size(); ++i)
+        {
+            LoadClient* client = worker->clients[i];
+            if (!client->IsStarted())
+            {
+                if (int32(now - worker->startTimes[i]) >= 0)
+                {
+                    client->Start(now, worker->stats);
+                }
+                continue;
+            }
+
+            client->Update(now, worker->stats);
+            inWorld += client->IsInWorld() ? 1 : 0;
+            failed += client->IsFailed() ? 1 : 0;
+        }
+
+        worker->inWorld = inWorld;
+        worker->failed = failed;
+    }
+}
+
+// merges the counters of the workers, and starts them over when asked
+static void collectStats(std::vector<LoadWorker*>& workers, LoadStats& total, bool clear)
+{
+    total.Clear();
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        std::lock_guard<std::mutex> guard(workers[i]->lock);
+        total.Merge(workers[i]->stats);
+        if (clear)
+        {
+            workers[i]->stats.Clear();
+        }
+    }
+}
+
+static void countClients(std::vector<LoadWorker*> const& workers, uint32& inWorld, uint32& failed)
+{
+    inWorld = 0;
+    failed = 0;
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        inWorld += workers[i]->inWorld;
+        failed += workers[i]->failed;
+    }
+}
+
+static void printTickLine(char const* name, TickHistogram const& tick, double seconds)
+{
+    if (!tick.count)
+    {
+        printf(" %-12s no updates recorded\n", name);
+        return;
+    }
+
+    printf(" %-12s %8.1f/s mean %7.2f p50 <= %7.2f p95 <= %7.2f p99 <= %7.2f ms\n", name, double(tick.count) / seconds,
+           tick.GetMean(), tick.GetPercentile(0.50), tick.GetPercentile(0.95), tick.GetPercentile(0.99));
+}
+
+void printReport(LoadSettings const& settings, LoadStats const& login, LoadStats const& stats, double seconds,
+                 bool haveServer, TickHistogram const& world, TickHistogram const& maps)
+{
+    printf("\n Scenario '%s', %u clients, %.0f s measured\n\n", settings.scenario.c_str(), settings.clients, seconds);
+    printf(" %-12s %10s %8s %9s %8s %8s %8s %8s\n", "action", "requests", "lost", "mean", "p50", "p95", "p99", "max");
+
+    for (int i = 0; i < MAX_LOAD_ACTIONS; ++i)
+    {
+        // logins are timed during the ramp up, the rest during the measured window
+        LoadStats const& source = i == LOAD_ACTION_LOGIN ? login : stats;
+        LatencyHistogram const& latency = source.latency[i];
+        if (!source.requests[i])
+        {
+            continue;
+        }
+
+        if (i == LOAD_ACTION_MOVE)
+        {
+            printf(" %-12s %10llu %8s %9s %8s %8s %8s %8s\n", GetLoadActionName(LoadAction(i)),
+                   (unsigned long long)source.requests[i], "-", "-", "-", "-", "-", "-");
+            continue;
+        }
+
+        printf(" %-12s %10llu %8llu %9.2f %8u %8u %8u %8u\n", GetLoadActionName(LoadAction(i)),
+               (unsigned long long)source.requests[i], (unsigned long long)source.lost[i], latency.GetMean(),
+               latency.GetPercentile(0.50), latency.GetPercentile(0.95), latency.GetPercentile(0.99), latency.GetMax());
+    }
+
+    printf("\n Client traffic: %.0f packets/s sent, %.0f packets/s received, %.1f kB/s sent, %.1f kB/s received\n",
+           stats.packetsSent / seconds, stats.packetsReceived / seconds, stats.bytesSent / seconds / 1024.0,
+           stats.bytesReceived / seconds / 1024.0);
+    printf(" Login failures: %u, disconnects: %u\n", login.loginFailures + stats.loginFailures, stats.disconnects);
+
+    printf("\n Server ticks:\n");
+    if (!haveServer)
+    {
+        printf(" not available, set Metrics.Enable = 1 in mangosd.conf\n");
+        return;
+    }
+
+    printTickLine("world", world, seconds);
+    printTickLine("maps", maps, seconds);
+}
+
+static void writeTickJson(FILE* out, char const* name, TickHistogram const& tick, double seconds, bool last)
+{
+    fprintf(out, "    \"%s\": { \"updates_per_second\": %.2f, \"mean_ms\": %.3f, \"p50_ms\": %.3f, \"p95_ms\": %.3f, \"p99_ms\": %.3f }%s\n",
+            name, tick.count / seconds, tick.GetMean(), tick.GetPercentile(0.50), tick.GetPercentile(0.95),
+            tick.GetPercentile(0.99), last ? "" : ",");
+}
+
+bool writeJsonReport(LoadSettings const& settings, LoadStats const& login, LoadStats const& stats, double seconds,
+                     bool haveServer, TickHistogram const& world, TickHistogram const& maps)
+{
+    FILE* out = fopen(settings.reportFile.c_str(), "w");
+    if (!out)
+    {
+        printf(" Can't write the report %s\n", settings.reportFile.c_str());
+        return false;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"scenario\": \"%s\",\n", settings.scenario.c_str());
+    fprintf(out, "  \"clients\": %u,\n", settings.clients);
+    fprintf(out, "  \"seconds\": %.1f,\n", seconds);
+    fprintf(out, "  \"login_failures\": %u,\n", login.loginFailures + stats.loginFailures);
+    fprintf(out, "  \"disconnects\": %u,\n", stats.disconnects);
+    fprintf(out, "  \"packets_sent\": %llu,\n", (unsigned long long)stats.packetsSent);
+    fprintf(out, "  \"packets_received\": %llu,\n", (unsigned long long)stats.packetsReceived);
+    fprintf(out, "  \"actions\": {\n");
+
+    bool first = true;
+    for (int i = 0; i < MAX_LOAD_ACTIONS; ++i)
+    {
+        LoadStats const& source = i == LOAD_ACTION_LOGIN ? login : stats;
+        LatencyHistogram const& latency = source.latency[i];
+        if (!source.requests[i])
+        {
+            continue;
+        }
+
+        fprintf(out, "%s    \"%s\": { \"requests\": %llu, \"lost\": %llu, \"mean_ms\": %.3f, \"p50_ms\": %u, \"p95_ms\": %u, \"p99_ms\": %u, \"max_ms\": %u }",
+                first ? "" : ",\n", GetLoadActionName(LoadAction(i)), (unsigned long long)source.requests[i],
+                (unsigned long long)source.lost[i], latency.GetMean(), latency.GetPercentile(0.50),
+                latency.GetPercentile(0.95), latency.GetPercentile(0.99), latency.GetMax());
+        first = false;
+    }
+
+    fprintf(out, "\n  }");
+    if (haveServer)
+    {
+        fprintf(out, ",\n  \"server\": {\n");
+        writeTickJson(out, "world_tick", world, seconds, false);
+        writeTickJson(out, "map_tick", maps, seconds, true);
+        fprintf(out, "  }");
+    }
+    fprintf(out, "\n}\n");
+
+    fclose(out);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    char const* configFile = "loadgen.conf";
+    char const* scenarioFile = NULL;
+
+    if (!handleArgs(argc, argv, configFile, scenarioFile))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Config base;
+    Config scenario;
+    if (!base.SetSource(configFile))
+    {
+        printf(" Can't read the settings %s\n", configFile);
+        return 1;
+    }
+    if (scenarioFile && !scenario.SetSource(scenarioFile))
+    {
+        printf(" Can't read the scenario %s\n", scenarioFile);
+        return 1;
+    }
+
+    LoadSettings settings;
+    readSettings(base, scenario, settings);
+
+    std::vector<LoadWorker*> workers;
+    for (uint32 i = 0; i < settings.threads; ++i)
+    {
+        workers.push_back(new LoadWorker());
+    }
+
+    // logins are spread over the threads in turn, so every thread ramps up at the same pace
+    uint32 start = getMSTime() + 1000;
+    for (uint32 i = 0; i < settings.clients; ++i)
+    {
+        LoadWorker* worker = workers[i % settings.threads];
+        worker->clients.push_back(new LoadClient(settings, i));
+        worker->startTimes.push_back(start + uint32(uint64(i) * 1000 / settings.loginRate));
+    }
+
+    printf(" Logging in %u clients as %s%u.. at %u per second on %u threads\n", settings.clients,
+           settings.accountPrefix.c_str(), settings.firstAccount, settings.loginRate, settings.threads);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        threads.push_back(std::thread(runWorker, workers[i]));
+    }
+
+    // ramp up, the window starts when every client is in the world or gave up
+    uint32 rampEnd = start + uint32(uint64(settings.clients) * 1000 / settings.loginRate);
+    uint32 inWorld = 0;
+    uint32 failed = 0;
+    uint32 lastProgress = getMSTime();
+    for (;;)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        uint32 now = getMSTime();
+        countClients(workers, inWorld, failed);
+
+        if (inWorld + failed >= settings.clients || (int32(now - rampEnd) > 0 && getMSTimeDiff(rampEnd, now) > LOGIN_GRACE_TIME))
+        {
+            break;
+        }
+
+        if (getMSTimeDiff(lastProgress, now) >= PROGRESS_INTERVAL)
+        {
+            lastProgress = now;
+            printf(" %u of %u clients in the world, %u failed\n", inWorld, settings.clients, failed);
+        }
+    }
+
+    printf(" %u of %u clients in the world, %u failed, measuring for %u seconds\n", inWorld, settings.clients, failed, settings.duration);
+
+    LoadStats login;
+    collectStats(workers, login, true);
+
+    ServerSnapshot serverStart;
+    bool haveServer = FetchServerSnapshot(settings.metricsAddress, settings.metricsPort, serverStart);
+
+    uint32 windowStart = getMSTime();
+    lastProgress = windowStart;
+    uint64 lastPackets = 0;
+    LoadStats progress;
+    while (getMSTimeDiff(windowStart, getMSTime()) < settings.duration * 1000)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        uint32 now = getMSTime();
+        if (getMSTimeDiff(lastProgress, now) < PROGRESS_INTERVAL)
+        {
+            continue;
+        }
+
+        collectStats(workers, progress, false);
+        countClients(workers, inWorld, failed);
+        printf(" %3u s: %u clients in the world, %.0f packets/s sent\n", getMSTimeDiff(windowStart, now) / 1000, inWorld,
+               (progress.packetsSent - lastPackets) * 1000.0 / getMSTimeDiff(lastProgress, now));
+        lastPackets = progress.packetsSent;
+        lastProgress = now;
+    }
+
+    double seconds = getMSTimeDiff(windowStart, getMSTime()) / 1000.0;
+
+    LoadStats stats;
+    collectStats(workers, stats, false);
+
+    ServerSnapshot serverEnd;
+    haveServer = haveServer && FetchServerSnapshot(settings.metricsAddress, settings.metricsPort, serverEnd);
+
+    stopWorkers = true;
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+
+    TickHistogram world = serverEnd.world.Since(serverStart.world);
+    TickHistogram maps = serverEnd.maps.Since(serverStart.maps);
+
+    printReport(settings, login, stats, seconds, haveServer, world, maps);
+    if (!settings.reportFile.empty() && writeJsonReport(settings, login, stats, seconds, haveServer, world, maps))
+    {
+        printf("\n Report written to %s\n", settings.reportFile.c_str());
+    }
+
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        for (size_t j = 0; j < workers[i]->clients.size(); ++j)
+        {
+            delete workers[i]->clients[j];
+        }
+        delete workers[i];
+    }
+
+    return 0;
+}